@@ -32,6 +32,7 @@
 
 #include "hashfuncs.h"
 #include "object.h"
+#include "slot_pool.h"
 #include "variant.h"
 #include "vector.h"
 
@@ -41,6 +42,8 @@ public:
 	Vector<Variant> array;
 };
 
+static SlotPool<ArrayPrivate> array_pool;
+
 void Array::_ref(const Array &p_from) const {
 
 	ArrayPrivate *_fp = p_from._p;
@@ -65,7 +68,7 @@ void Array::_unref() const {
 		return;
 
 	if (_p->refcount.unref()) {
-		memdelete(_p);
+		array_pool.free(_p);
 	}
 	_p = NULL;
 }
@@ -360,9 +363,14 @@ Array::Array(const Array &p_from) {
 	_p = NULL;
 	_ref(p_from);
 }
+uint32_t Array::get_heap_allocation_count() {
+
+	return array_pool.get_heap_allocation_count();
+}
+
 Array::Array() {
 
-	_p = memnew(ArrayPrivate);
+	_p = array_pool.alloc();
 	_p->refcount.init();
 }
 Array::~Array() {
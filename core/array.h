@@ -91,6 +91,9 @@ public:
 	Array duplicate(bool p_deep = false) const;
 
 	Array(const Array &p_from);
+	// blocks taken from the system allocator, the rest is reused from a pool
+	static uint32_t get_heap_allocation_count();
+
 	Array();
 	~Array();
 };
@@ -81,6 +81,28 @@ RES _ResourceLoader::load(const String &p_path, const String &p_type_hint, bool
 	return ret;
 }
 
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_high_priority) {
+
+	return ResourceLoader::load_threaded_request(p_path, p_type_hint, p_high_priority ? WorkerThreadPool::PRIORITY_HIGH : WorkerThreadPool::PRIORITY_NORMAL);
+}
+
+_ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path) {
+
+	return (ThreadLoadStatus)ResourceLoader::load_threaded_get_status(p_path);
+}
+
+RES _ResourceLoader::load_threaded_get(const String &p_path) {
+
+	Error err = OK;
+	RES ret = ResourceLoader::load_threaded_get(p_path, &err);
+
+	if (err != OK) {
+		ERR_EXPLAIN("Error loading resource: '" + p_path + "'");
+		ERR_FAIL_COND_V(err != OK, ret);
+	}
+	return ret;
+}
+
 PoolVector<String> _ResourceLoader::get_recognized_extensions_for_type(const String &p_type) {
 
 	List<String> exts;
@@ -126,6 +148,14 @@ void _ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_abort_on_missing_resources", "abort"), &_ResourceLoader::set_abort_on_missing_resources);
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &_ResourceLoader::get_dependencies);
 	ClassDB::bind_method(D_METHOD("has", "path"), &_ResourceLoader::has);
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "high_priority"), &_ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path"), &_ResourceLoader::load_threaded_get_status);
+	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &_ResourceLoader::load_threaded_get);
+
+	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_FAILED);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_LOADED);
 }
 
 _ResourceLoader::_ResourceLoader() {
@@ -843,6 +873,34 @@ void _OS::dump_memory_to_file(const String &p_file) {
 	OS::get_singleton()->dump_memory_to_file(p_file.utf8().get_data());
 }
 
+Array _OS::get_memory_allocation_sites() const {
+
+	Vector<Memory::AllocationSite> sites = OS::get_singleton()->get_memory_allocation_sites();
+
+	Array ret;
+	for (int i = 0; i < sites.size(); i++) {
+		Dictionary d;
+		d["site"] = String(sites[i].name);
+		d["live_bytes"] = sites[i].live_bytes;
+		d["live_count"] = sites[i].live_count;
+		d["total_bytes"] = sites[i].total_bytes;
+		d["total_count"] = sites[i].total_count;
+		ret.push_back(d);
+	}
+	return ret;
+}
+
+void _OS::set_memory_tracker_sample_interval(int p_bytes) {
+
+	ERR_FAIL_COND(p_bytes < 0);
+	Memory::set_tracker_sample_interval(p_bytes);
+}
+
+int _OS::get_memory_tracker_sample_interval() const {
+
+	return Memory::get_tracker_sample_interval();
+}
+
 struct _OSCoreBindImg {
 
 	String path;
@@ -1158,6 +1216,9 @@ void _OS::_bind_methods() {
 	//ClassDB::bind_method(D_METHOD("get_mouse_button_state"),&_OS::get_mouse_button_state);
 
 	ClassDB::bind_method(D_METHOD("dump_memory_to_file", "file"), &_OS::dump_memory_to_file);
+	ClassDB::bind_method(D_METHOD("get_memory_allocation_sites"), &_OS::get_memory_allocation_sites);
+	ClassDB::bind_method(D_METHOD("set_memory_tracker_sample_interval", "bytes"), &_OS::set_memory_tracker_sample_interval);
+	ClassDB::bind_method(D_METHOD("get_memory_tracker_sample_interval"), &_OS::get_memory_tracker_sample_interval);
 	ClassDB::bind_method(D_METHOD("dump_resources_to_file", "file"), &_OS::dump_resources_to_file);
 	ClassDB::bind_method(D_METHOD("has_virtual_keyboard"), &_OS::has_virtual_keyboard);
 	ClassDB::bind_method(D_METHOD("show_virtual_keyboard", "existing_text"), &_OS::show_virtual_keyboard, DEFVAL(""));
@@ -1425,6 +1486,47 @@ Vector<int> _Geometry::triangulate_polygon(const Vector<Vector2> &p_polygon) {
 	return Geometry::triangulate_polygon(p_polygon);
 }
 
+Vector<int> _Geometry::triangulate_polygon_with_holes(const Vector<Vector2> &p_outline, const Array &p_holes) {
+
+	Vector<Vector<Vector2> > holes;
+	holes.resize(p_holes.size());
+	for (int i = 0; i < p_holes.size(); i++) {
+		holes.write[i] = p_holes[i];
+	}
+
+	return Geometry::triangulate_polygon_with_holes(p_outline, holes);
+}
+
+Array _Geometry::triangulate_polygons(const Array &p_polygons) {
+
+	Vector<Vector<Vector2> > polygons;
+	polygons.resize(p_polygons.size());
+	for (int i = 0; i < p_polygons.size(); i++) {
+		polygons.write[i] = p_polygons[i];
+	}
+
+	Vector<Vector<int> > triangles = Geometry::triangulate_polygons(polygons);
+
+	Array ret;
+	ret.resize(triangles.size());
+	for (int i = 0; i < triangles.size(); i++) {
+		ret[i] = triangles[i];
+	}
+	return ret;
+}
+
+Array _Geometry::decompose_polygon_in_convex(const Vector<Vector2> &p_polygon) {
+
+	Vector<Vector<Vector2> > decomp = Geometry::decompose_polygon_in_convex(p_polygon);
+
+	Array ret;
+	ret.resize(decomp.size());
+	for (int i = 0; i < decomp.size(); i++) {
+		ret[i] = decomp[i];
+	}
+	return ret;
+}
+
 Vector<Point2> _Geometry::convex_hull_2d(const Vector<Point2> &p_points) {
 
 	return Geometry::convex_hull_2d(p_points);
@@ -1496,6 +1598,9 @@ void _Geometry::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("point_is_inside_triangle", "point", "a", "b", "c"), &_Geometry::point_is_inside_triangle);
 
 	ClassDB::bind_method(D_METHOD("triangulate_polygon", "polygon"), &_Geometry::triangulate_polygon);
+	ClassDB::bind_method(D_METHOD("triangulate_polygon_with_holes", "outline", "holes"), &_Geometry::triangulate_polygon_with_holes);
+	ClassDB::bind_method(D_METHOD("triangulate_polygons", "polygons"), &_Geometry::triangulate_polygons);
+	ClassDB::bind_method(D_METHOD("decompose_polygon_in_convex", "polygon"), &_Geometry::decompose_polygon_in_convex);
 	ClassDB::bind_method(D_METHOD("convex_hull_2d", "points"), &_Geometry::convex_hull_2d);
 	ClassDB::bind_method(D_METHOD("clip_polygon", "points", "plane"), &_Geometry::clip_polygon);
 
@@ -1832,9 +1937,16 @@ bool _File::file_exists(const String &p_name) const {
 	return FileAccess::exists(p_name);
 }
 
-void _File::store_var(const Variant &p_var) {
+void _File::store_var(const Variant &p_var, bool p_compact) {
 
 	ERR_FAIL_COND(!f);
+
+	if (p_compact) {
+		Error err = encode_variant_stream(p_var, f);
+		ERR_FAIL_COND(err != OK);
+		return;
+	}
+
 	int len;
 	Error err = encode_variant(p_var, NULL, len);
 	ERR_FAIL_COND(err != OK);
@@ -1855,6 +1967,18 @@ Variant _File::get_var() const {
 
 	ERR_FAIL_COND_V(!f, Variant());
 	uint32_t len = get_32();
+
+	if (len == VARIANT_STREAM_MAGIC) {
+		// stored with store_var(value, true)
+		f->seek(f->get_position() - 4);
+
+		Variant v;
+		Error err = decode_variant_stream(v, f);
+		ERR_FAIL_COND_V(err != OK, Variant());
+
+		return v;
+	}
+
 	PoolVector<uint8_t> buff = get_buffer(len);
 	ERR_FAIL_COND_V((uint32_t)buff.size() != len, Variant());
 
@@ -1916,7 +2040,7 @@ void _File::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("store_buffer", "buffer"), &_File::store_buffer);
 	ClassDB::bind_method(D_METHOD("store_line", "line"), &_File::store_line);
 	ClassDB::bind_method(D_METHOD("store_string", "string"), &_File::store_string);
-	ClassDB::bind_method(D_METHOD("store_var", "value"), &_File::store_var);
+	ClassDB::bind_method(D_METHOD("store_var", "value", "compact"), &_File::store_var, DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("store_pascal_string", "string"), &_File::store_pascal_string);
 	ClassDB::bind_method(D_METHOD("get_pascal_string"), &_File::get_pascal_string);
@@ -2751,6 +2875,10 @@ bool _Engine::is_in_physics_frame() const {
 	return Engine::get_singleton()->is_in_physics_frame();
 }
 
+float _Engine::get_physics_interpolation_fraction() const {
+	return Engine::get_singleton()->get_physics_interpolation_fraction();
+}
+
 bool _Engine::has_singleton(const String &p_name) const {
 
 	return Engine::get_singleton()->has_singleton(p_name);
@@ -2771,6 +2899,11 @@ bool _Engine::is_editor_hint() const {
 	return Engine::get_singleton()->is_editor_hint();
 }
 
+bool _Engine::is_headless() const {
+
+	return Engine::get_singleton()->is_headless();
+}
+
 void _Engine::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_iterations_per_second", "iterations_per_second"), &_Engine::set_iterations_per_second);
@@ -2796,6 +2929,7 @@ void _Engine::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_license_text"), &_Engine::get_license_text);
 
 	ClassDB::bind_method(D_METHOD("is_in_physics_frame"), &_Engine::is_in_physics_frame);
+	ClassDB::bind_method(D_METHOD("get_physics_interpolation_fraction"), &_Engine::get_physics_interpolation_fraction);
 
 	ClassDB::bind_method(D_METHOD("has_singleton", "name"), &_Engine::has_singleton);
 	ClassDB::bind_method(D_METHOD("get_singleton", "name"), &_Engine::get_singleton_object);
@@ -2803,6 +2937,8 @@ void _Engine::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_editor_hint", "enabled"), &_Engine::set_editor_hint);
 	ClassDB::bind_method(D_METHOD("is_editor_hint"), &_Engine::is_editor_hint);
 
+	ClassDB::bind_method(D_METHOD("is_headless"), &_Engine::is_headless);
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "editor_hint"), "set_editor_hint", "is_editor_hint");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "iterations_per_second"), "set_iterations_per_second", "get_iterations_per_second");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "target_fps"), "set_target_fps", "get_target_fps");
@@ -2821,6 +2957,7 @@ void JSONParseResult::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_error_string"), &JSONParseResult::get_error_string);
 	ClassDB::bind_method(D_METHOD("get_error_line"), &JSONParseResult::get_error_line);
 	ClassDB::bind_method(D_METHOD("get_result"), &JSONParseResult::get_result);
+	ClassDB::bind_method(D_METHOD("is_completed"), &JSONParseResult::is_completed);
 
 	ClassDB::bind_method(D_METHOD("set_error", "error"), &JSONParseResult::set_error);
 	ClassDB::bind_method(D_METHOD("set_error_string", "error_string"), &JSONParseResult::set_error_string);
@@ -2833,41 +2970,85 @@ void JSONParseResult::_bind_methods() {
 	ADD_PROPERTYNZ(PropertyInfo(Variant::NIL, "result", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NIL_IS_VARIANT), "set_result", "get_result");
 }
 
+void JSONParseResult::_parse_task(void *p_userdata, uint32_t p_index) {
+
+	JSONParseResult *self = (JSONParseResult *)p_userdata;
+	self->error = JSON::parse(self->source, self->result, self->error_string, self->error_line);
+	self->source = String();
+}
+
+void JSONParseResult::_wait() const {
+
+	if (parse_task != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(parse_task);
+		parse_task = WorkerThreadPool::INVALID_GROUP_ID;
+	}
+}
+
+bool JSONParseResult::is_completed() const {
+
+	if (parse_task == WorkerThreadPool::INVALID_GROUP_ID)
+		return true;
+
+	return WorkerThreadPool::get_singleton()->is_group_task_completed(parse_task);
+}
+
 void JSONParseResult::set_error(Error p_error) {
+	_wait();
 	error = p_error;
 }
 
 Error JSONParseResult::get_error() const {
+	_wait();
 	return error;
 }
 
 void JSONParseResult::set_error_string(const String &p_error_string) {
+	_wait();
 	error_string = p_error_string;
 }
 
 String JSONParseResult::get_error_string() const {
+	_wait();
 	return error_string;
 }
 
 void JSONParseResult::set_error_line(int p_error_line) {
+	_wait();
 	error_line = p_error_line;
 }
 
 int JSONParseResult::get_error_line() const {
+	_wait();
 	return error_line;
 }
 
 void JSONParseResult::set_result(const Variant &p_result) {
+	_wait();
 	result = p_result;
 }
 
 Variant JSONParseResult::get_result() const {
+	_wait();
 	return result;
 }
 
+JSONParseResult::JSONParseResult() {
+
+	error = OK;
+	error_line = 0;
+	parse_task = WorkerThreadPool::INVALID_GROUP_ID;
+}
+
+JSONParseResult::~JSONParseResult() {
+
+	_wait();
+}
+
 void _JSON::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("print", "value", "indent", "sort_keys"), &_JSON::print, DEFVAL(String()), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("parse", "json"), &_JSON::parse);
+	ClassDB::bind_method(D_METHOD("parse_async", "json"), &_JSON::parse_async);
 }
 
 String _JSON::print(const Variant &p_value, const String &p_indent, bool p_sort_keys) {
@@ -2883,6 +3064,22 @@ Ref<JSONParseResult> _JSON::parse(const String &p_json) {
 	return result;
 }
 
+Ref<JSONParseResult> _JSON::parse_async(const String &p_json) {
+	Ref<JSONParseResult> result;
+	result.instance();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (!pool || pool->get_thread_count() == 0) {
+		result->error = JSON::parse(p_json, result->result, result->error_string, result->error_line);
+		return result;
+	}
+
+	result->source = p_json;
+	result->parse_task = pool->add_task(JSONParseResult::_parse_task, result.ptr(), WorkerThreadPool::PRIORITY_LOW);
+
+	return result;
+}
+
 _JSON *_JSON::singleton = NULL;
 
 _JSON::_JSON() {
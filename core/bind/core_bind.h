@@ -40,6 +40,7 @@
 #include "os/os.h"
 #include "os/semaphore.h"
 #include "os/thread.h"
+#include "os/worker_thread_pool.h"
 
 class _ResourceLoader : public Object {
 	GDCLASS(_ResourceLoader, Object);
@@ -49,9 +50,19 @@ protected:
 	static _ResourceLoader *singleton;
 
 public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
+
 	static _ResourceLoader *get_singleton() { return singleton; }
 	Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "");
 	RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false);
+	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_high_priority = false);
+	ThreadLoadStatus load_threaded_get_status(const String &p_path);
+	RES load_threaded_get(const String &p_path);
 	PoolVector<String> get_recognized_extensions_for_type(const String &p_type);
 	void set_abort_on_missing_resources(bool p_abort);
 	PoolStringArray get_dependencies(const String &p_path);
@@ -60,6 +71,8 @@ public:
 	_ResourceLoader();
 };
 
+VARIANT_ENUM_CAST(_ResourceLoader::ThreadLoadStatus);
+
 class _ResourceSaver : public Object {
 	GDCLASS(_ResourceSaver, Object);
 
@@ -217,6 +230,9 @@ public:
 	String get_model_name() const;
 
 	void dump_memory_to_file(const String &p_file);
+	Array get_memory_allocation_sites() const;
+	void set_memory_tracker_sample_interval(int p_bytes);
+	int get_memory_tracker_sample_interval() const;
 	void dump_resources_to_file(const String &p_file);
 
 	bool has_virtual_keyboard() const;
@@ -383,6 +399,9 @@ public:
 	int get_uv84_normal_bit(const Vector3 &p_vector);
 
 	Vector<int> triangulate_polygon(const Vector<Vector2> &p_polygon);
+	Vector<int> triangulate_polygon_with_holes(const Vector<Vector2> &p_outline, const Array &p_holes);
+	Array triangulate_polygons(const Array &p_polygons);
+	Array decompose_polygon_in_convex(const Vector<Vector2> &p_polygon);
 	Vector<Point2> convex_hull_2d(const Vector<Point2> &p_points);
 	Vector<Vector3> clip_polygon(const Vector<Vector3> &p_points, const Plane &p_plane);
 
@@ -480,7 +499,7 @@ public:
 
 	void store_buffer(const PoolVector<uint8_t> &p_buffer); ///< store an array of bytes
 
-	void store_var(const Variant &p_var);
+	void store_var(const Variant &p_var, bool p_compact = false);
 
 	bool file_exists(const String &p_name) const; ///< return true if a file exists
 
@@ -700,6 +719,7 @@ public:
 	String get_license_text() const;
 
 	bool is_in_physics_frame() const;
+	float get_physics_interpolation_fraction() const;
 
 	bool has_singleton(const String &p_name) const;
 	Object *get_singleton_object(const String &p_name) const;
@@ -707,6 +727,8 @@ public:
 	void set_editor_hint(bool p_enabled);
 	bool is_editor_hint() const;
 
+	bool is_headless() const;
+
 	_Engine();
 };
 
@@ -723,10 +745,18 @@ class JSONParseResult : public Reference {
 
 	Variant result;
 
+	String source;
+	mutable WorkerThreadPool::GroupID parse_task;
+
+	static void _parse_task(void *p_userdata, uint32_t p_index);
+	void _wait() const;
+
 protected:
 	static void _bind_methods();
 
 public:
+	bool is_completed() const;
+
 	void set_error(Error p_error);
 	Error get_error() const;
 
@@ -738,6 +768,9 @@ public:
 
 	void set_result(const Variant &p_result);
 	Variant get_result() const;
+
+	JSONParseResult();
+	~JSONParseResult();
 };
 
 class _JSON : public Object {
@@ -752,6 +785,7 @@ public:
 
 	String print(const Variant &p_value, const String &p_indent = "", bool p_sort_keys = false);
 	Ref<JSONParseResult> parse(const String &p_json);
+	Ref<JSONParseResult> parse_async(const String &p_json);
 
 	_JSON();
 };
@@ -248,6 +248,20 @@ void ClassDB::set_current_api(APIType p_api) {
 	current_api = p_api;
 }
 
+bool ClassDB::lazy_binding = false;
+uint32_t ClassDB::pending_binds = 0;
+Mutex *ClassDB::bind_mutex = NULL;
+
+void ClassDB::set_lazy_binding(bool p_enable) {
+
+	lazy_binding = p_enable;
+}
+
+bool ClassDB::is_lazy_binding() {
+
+	return lazy_binding;
+}
+
 HashMap<StringName, ClassDB::ClassInfo> ClassDB::classes;
 HashMap<StringName, StringName> ClassDB::resource_base_extensions;
 HashMap<StringName, StringName> ClassDB::compat_classes;
@@ -259,6 +273,9 @@ ClassDB::ClassInfo::ClassInfo() {
 	inherits_ptr = NULL;
 	disabled = false;
 	exposed = false;
+	bind_func = NULL;
+	binding = false;
+	bound = true;
 }
 
 ClassDB::ClassInfo::~ClassInfo() {
@@ -337,6 +354,8 @@ ClassDB::APIType ClassDB::get_api_type(const StringName &p_class) {
 
 uint64_t ClassDB::get_api_hash(APIType p_api) {
 
+	bind_all_pending();
+
 	OBJTYPE_RLOCK;
 #ifdef DEBUG_METHODS_ENABLED
 
@@ -513,6 +532,10 @@ Object *ClassDB::instance(const StringName &p_class) {
 		ERR_FAIL_COND_V(!ti->creation_func, NULL);
 	}
 
+	if (!ti->bound) {
+		_bind_pending(ti);
+	}
+
 	return ti->creation_func();
 }
 bool ClassDB::can_instance(const StringName &p_class) {
@@ -548,8 +571,76 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 	}
 }
 
+void ClassDB::_add_class_bind(const StringName &p_class, void (*p_bind_func)()) {
+
+	if (!lazy_binding) {
+		p_bind_func();
+		return;
+	}
+
+	OBJTYPE_WLOCK;
+
+	ClassInfo *ti = classes.getptr(p_class);
+	ERR_FAIL_COND(!ti);
+
+	ti->bind_func = p_bind_func;
+	ti->bound = false;
+	pending_binds++;
+}
+
+void ClassDB::_bind_pending(ClassInfo *p_class) {
+
+	//recursive, so queries made by the class while binding itself don't lock up
+	MutexLock bind_lock(bind_mutex);
+
+	if (p_class->bound || p_class->binding) {
+		return; //bound by another thread meanwhile, or this is the bind in progress asking
+	}
+
+	p_class->binding = true;
+
+	//parent methods must exist before properties can use them as setters and getters
+	if (p_class->inherits_ptr && !p_class->inherits_ptr->bound) {
+		_bind_pending(p_class->inherits_ptr);
+	}
+
+	APIType prev_api = current_api;
+	current_api = p_class->api;
+	p_class->bind_func();
+	current_api = prev_api;
+
+	p_class->bind_func = NULL;
+	p_class->binding = false;
+	p_class->bound = true;
+	pending_binds--;
+}
+
+void ClassDB::bind_all_pending() {
+
+	if (!pending_binds)
+		return;
+
+	List<ClassInfo *> pending;
+	{
+		OBJTYPE_RLOCK;
+		const StringName *k = NULL;
+		while ((k = classes.next(k))) {
+			ClassInfo *ti = classes.getptr(*k);
+			if (!ti->bound) {
+				pending.push_back(ti);
+			}
+		}
+	}
+
+	for (List<ClassInfo *>::Element *E = pending.front(); E; E = E->next()) {
+		_bind_pending(E->get());
+	}
+}
+
 void ClassDB::get_method_list(StringName p_class, List<MethodInfo> *p_methods, bool p_no_inheritance, bool p_exclude_from_properties) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -623,6 +714,8 @@ void ClassDB::get_method_list(StringName p_class, List<MethodInfo> *p_methods, b
 
 MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -678,6 +771,8 @@ void ClassDB::bind_integer_constant(const StringName &p_class, const StringName
 
 void ClassDB::get_integer_constant_list(const StringName &p_class, List<String> *p_constants, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -704,6 +799,8 @@ void ClassDB::get_integer_constant_list(const StringName &p_class, List<String>
 
 int ClassDB::get_integer_constant(const StringName &p_class, const StringName &p_name, bool *p_success) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -729,6 +826,8 @@ int ClassDB::get_integer_constant(const StringName &p_class, const StringName &p
 
 StringName ClassDB::get_integer_constant_enum(const StringName &p_class, const StringName &p_name, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -755,6 +854,8 @@ StringName ClassDB::get_integer_constant_enum(const StringName &p_class, const S
 
 void ClassDB::get_enum_list(const StringName &p_class, List<StringName> *p_enums, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -775,6 +876,8 @@ void ClassDB::get_enum_list(const StringName &p_class, List<StringName> *p_enums
 
 void ClassDB::get_enum_constants(const StringName &p_class, const StringName &p_enum, List<StringName> *p_constants, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -821,6 +924,8 @@ void ClassDB::add_signal(StringName p_class, const MethodInfo &p_signal) {
 
 void ClassDB::get_signal_list(StringName p_class, List<MethodInfo> *p_signals, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -845,6 +950,8 @@ void ClassDB::get_signal_list(StringName p_class, List<MethodInfo> *p_signals, b
 
 bool ClassDB::has_signal(StringName p_class, StringName p_signal) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -859,6 +966,8 @@ bool ClassDB::has_signal(StringName p_class, StringName p_signal) {
 
 bool ClassDB::get_signal(StringName p_class, StringName p_signal, MethodInfo *r_signal) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -961,6 +1070,8 @@ void ClassDB::add_property(StringName p_class, const PropertyInfo &p_pinfo, cons
 
 void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list, bool p_no_inheritance, const Object *p_validator) {
 
+	_ensure_bound(p_class);
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -986,6 +1097,9 @@ void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list,
 bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
 
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
+	if (type && !type->bound) {
+		_bind_pending(type);
+	}
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
@@ -1032,6 +1146,9 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
+	if (type && !type->bound) {
+		_bind_pending(type);
+	}
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
@@ -1073,6 +1190,8 @@ bool ClassDB::get_property(Object *p_object, const StringName &p_property, Varia
 
 int ClassDB::get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid) {
 
+	_ensure_bound(p_class);
+
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	while (check) {
@@ -1095,6 +1214,8 @@ int ClassDB::get_property_index(const StringName &p_class, const StringName &p_p
 
 Variant::Type ClassDB::get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid) {
 
+	_ensure_bound(p_class);
+
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	while (check) {
@@ -1117,6 +1238,8 @@ Variant::Type ClassDB::get_property_type(const StringName &p_class, const String
 
 StringName ClassDB::get_property_setter(StringName p_class, const StringName p_property) {
 
+	_ensure_bound(p_class);
+
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	while (check) {
@@ -1134,6 +1257,8 @@ StringName ClassDB::get_property_setter(StringName p_class, const StringName p_p
 
 StringName ClassDB::get_property_getter(StringName p_class, const StringName p_property) {
 
+	_ensure_bound(p_class);
+
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	while (check) {
@@ -1151,6 +1276,8 @@ StringName ClassDB::get_property_getter(StringName p_class, const StringName p_p
 
 bool ClassDB::has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	while (check) {
@@ -1177,6 +1304,8 @@ void ClassDB::set_method_flags(StringName p_class, StringName p_method, int p_fl
 
 bool ClassDB::has_method(StringName p_class, StringName p_method, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	while (check) {
@@ -1270,6 +1399,8 @@ void ClassDB::add_virtual_method(const StringName &p_class, const MethodInfo &p_
 
 void ClassDB::get_virtual_methods(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance) {
 
+	_ensure_bound(p_class);
+
 	ERR_FAIL_COND(!classes.has(p_class));
 
 #ifdef DEBUG_METHODS_ENABLED
@@ -1324,6 +1455,8 @@ bool ClassDB::is_class_exposed(StringName p_class) {
 
 StringName ClassDB::get_category(const StringName &p_node) {
 
+	_ensure_bound(p_node);
+
 	ERR_FAIL_COND_V(!classes.has(p_node), StringName());
 #ifdef DEBUG_ENABLED
 	return classes[p_node].category;
@@ -1366,6 +1499,7 @@ RWLock *ClassDB::lock = NULL;
 void ClassDB::init() {
 
 	lock = RWLock::create();
+	bind_mutex = Mutex::create(true);
 }
 
 void ClassDB::cleanup() {
@@ -1389,6 +1523,7 @@ void ClassDB::cleanup() {
 	compat_classes.clear();
 
 	memdelete(lock);
+	memdelete(bind_mutex);
 }
 
 //
@@ -33,6 +33,7 @@
 
 #include "method_bind.h"
 #include "object.h"
+#include "os/mutex.h"
 #include "print_string.h"
 
 /**
@@ -133,6 +134,9 @@ public:
 		bool disabled;
 		bool exposed;
 		Object *(*creation_func)();
+		void (*bind_func)(); //set while binding is deferred
+		bool binding;
+		bool bound;
 		ClassInfo();
 		~ClassInfo();
 	};
@@ -155,7 +159,21 @@ public:
 
 	static APIType current_api;
 
+	static bool lazy_binding;
+	static uint32_t pending_binds;
+	static Mutex *bind_mutex;
+
 	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
+	static void _bind_pending(ClassInfo *p_class);
+
+	_FORCE_INLINE_ static void _ensure_bound(const StringName &p_class) {
+
+		if (!pending_binds)
+			return; //everything is bound, common case
+		ClassInfo *ti = classes.getptr(p_class);
+		if (ti && !ti->bound)
+			_bind_pending(ti);
+	}
 
 public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
@@ -165,6 +183,9 @@ public:
 		_add_class2(T::get_class_static(), T::get_parent_class_static());
 	}
 
+	// DO NOT USE THIS EITHER, binds the methods now or defers them until the class is first queried
+	static void _add_class_bind(const StringName &p_class, void (*p_bind_func)());
+
 	template <class T>
 	static void register_class() {
 
@@ -363,6 +384,9 @@ public:
 	static void init();
 
 	static void set_current_api(APIType p_api);
+	static void set_lazy_binding(bool p_enable);
+	static bool is_lazy_binding();
+	static void bind_all_pending();
 	static void cleanup();
 };
 
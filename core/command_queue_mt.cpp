@@ -32,6 +32,9 @@
 
 #include "os/os.h"
 
+uint64_t CommandQueueMT::total_command_count = 0;
+uint64_t CommandQueueMT::total_command_bytes = 0;
+
 void CommandQueueMT::lock() {
 
 	if (mutex)
@@ -60,7 +63,7 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 
 			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use = true;
+				sync_sems[i].in_use = 1;
 				idx = i;
 				break;
 			}
@@ -77,41 +80,99 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	return &sync_sems[idx];
 }
 
-bool CommandQueueMT::dealloc_one() {
-tryagain:
-	if (dealloc_ptr == write_ptr) {
-		// The queue is empty
-		return false;
+CommandQueueMT::Block *CommandQueueMT::_alloc_block() {
+
+	// called with the mutex held
+	Block *block;
+
+	if (free_blocks) {
+		block = free_blocks;
+		free_blocks = block->next;
+		free_block_count--;
+	} else {
+		block = (Block *)memalloc(COMMAND_BLOCK_HEADER_SIZE + COMMAND_BLOCK_SIZE);
 	}
 
-	uint32_t size = *(uint32_t *)&command_mem[dealloc_ptr];
+	block->next = NULL;
+	block->write_pos = 0;
+	return block;
+}
+
+int CommandQueueMT::_flush(int p_max) {
+
+	// only what was pushed until now is flushed, anything pushed while
+	// commands run is left for the next flush
+	lock();
+	Block *end_block = write_block;
+	uint32_t end_pos = write_block->write_pos;
+	unlock();
+
+	Block *done_blocks = NULL;
+	int flushed = 0;
+
+	while (p_max < 0 || flushed < p_max) {
+
+		if (read_block == end_block && read_pos >= end_pos) {
+			break;
+		}
+
+		if (read_block != end_block && read_pos >= read_block->write_pos) {
+			// block consumed, move to the next one
+			Block *done = read_block;
+			read_block = read_block->next;
+			read_pos = 0;
+
+			done->next = done_blocks;
+			done_blocks = done;
+			continue;
+		}
+
+		uint8_t *ptr = read_block->mem() + read_pos;
+		uint32_t size = *(uint32_t *)ptr;
+		CommandBase *cmd = reinterpret_cast<CommandBase *>(ptr + COMMAND_HEADER_SIZE);
+		read_pos += size;
 
-	if (size == 0) {
-		// End of command buffer wrap down
-		dealloc_ptr = 0;
-		goto tryagain;
+		cmd->call();
+		cmd->post();
+		cmd->~CommandBase();
+		flushed++;
 	}
 
-	if (size & 1) {
-		// Still used, nothing can be deallocated
-		return false;
+	if (done_blocks) {
+
+		lock();
+		while (done_blocks) {
+
+			Block *block = done_blocks;
+			done_blocks = block->next;
+
+			if (free_block_count < MAX_FREE_BLOCKS) {
+				block->next = free_blocks;
+				free_blocks = block;
+				free_block_count++;
+			} else {
+				memfree(block);
+			}
+		}
+		unlock();
 	}
 
-	dealloc_ptr += (size >> 1) + sizeof(uint32_t);
-	return true;
+	return flushed;
 }
 
 CommandQueueMT::CommandQueueMT(bool p_sync) {
 
-	read_ptr = 0;
-	write_ptr = 0;
-	dealloc_ptr = 0;
-	mutex = Mutex::create();
+	free_blocks = NULL;
+	free_block_count = 0;
+	write_block = _alloc_block();
+	read_block = write_block;
+	read_pos = 0;
+	mutex = Mutex::create(true, "CommandQueueMT");
 
 	for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 
 		sync_sems[i].sem = Semaphore::create();
-		sync_sems[i].in_use = false;
+		sync_sems[i].in_use = 0;
 	}
 	if (p_sync)
 		sync = Semaphore::create();
@@ -128,4 +189,16 @@ CommandQueueMT::~CommandQueueMT() {
 
 		memdelete(sync_sems[i].sem);
 	}
+
+	while (read_block) {
+		Block *block = read_block;
+		read_block = block->next;
+		memfree(block);
+	}
+
+	while (free_blocks) {
+		Block *block = free_blocks;
+		free_blocks = block->next;
+		memfree(block);
+	}
 }
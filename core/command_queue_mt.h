@@ -34,6 +34,7 @@
 #include "os/memory.h"
 #include "os/mutex.h"
 #include "os/semaphore.h"
+#include "safe_refcount.h"
 #include "simple_type.h"
 #include "typedefs.h"
 /**
@@ -279,7 +280,7 @@ class CommandQueueMT {
 	struct SyncSemaphore {
 
 		Semaphore *sem;
-		bool in_use;
+		uint32_t in_use; // set under the mutex, released without it when the command is done
 	};
 
 	struct CommandBase {
@@ -295,7 +296,7 @@ class CommandQueueMT {
 
 		virtual void post() {
 			sync_sem->sem->post();
-			sync_sem->in_use = false;
+			atomic_decrement(&sync_sem->in_use);
 		}
 	};
 
@@ -312,72 +313,63 @@ class CommandQueueMT {
 
 	/***** BASE *******/
 
+	// Commands are stored in a list of fixed size blocks that grows as needed, so pushing
+	// never has to wait for the consumer. The mutex only guards appending commands and the
+	// free block list; the consumer takes everything pushed so far at once and runs it
+	// without holding it, since producers never touch memory before the write position.
+
 	enum {
-		COMMAND_MEM_SIZE_KB = 256,
-		COMMAND_MEM_SIZE = COMMAND_MEM_SIZE_KB * 1024,
+		COMMAND_BLOCK_SIZE_KB = 64,
+		COMMAND_BLOCK_SIZE = COMMAND_BLOCK_SIZE_KB * 1024,
+		COMMAND_BLOCK_HEADER_SIZE = 16, // keeps commands 8 byte aligned
+		COMMAND_HEADER_SIZE = 8,
+		MAX_FREE_BLOCKS = 16,
 		SYNC_SEMAPHORES = 8
 	};
 
-	uint8_t command_mem[COMMAND_MEM_SIZE];
-	uint32_t read_ptr;
-	uint32_t write_ptr;
-	uint32_t dealloc_ptr;
+	struct Block {
+
+		Block *next;
+		uint32_t write_pos; // bytes used, final once the block is followed by another
+
+		_FORCE_INLINE_ uint8_t *mem() { return reinterpret_cast<uint8_t *>(this) + COMMAND_BLOCK_HEADER_SIZE; }
+	};
+
+	Block *write_block; // producer side, guarded by the mutex
+	Block *read_block; // consumer side
+	uint32_t read_pos;
+	Block *free_blocks;
+	int free_block_count;
+
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex *mutex;
 	Semaphore *sync;
 
+	static uint64_t total_command_count;
+	static uint64_t total_command_bytes;
+
 	template <class T>
 	T *allocate() {
 
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = sizeof(T) + sizeof(uint32_t);
-
-	tryagain:
-
-		if (write_ptr < dealloc_ptr) {
-			// behind dealloc_ptr, check that there is room
-			if ((dealloc_ptr - write_ptr) <= alloc_size) {
-
-				// There is no more room, try to deallocate something
-				if (dealloc_one()) {
-					goto tryagain;
-				}
-				return NULL;
-			}
-		} else if (write_ptr >= dealloc_ptr) {
-			// ahead of dealloc_ptr, check that there is room
-
-			if ((COMMAND_MEM_SIZE - write_ptr) < alloc_size + sizeof(uint32_t)) {
-				// no room at the end, wrap down;
-
-				if (dealloc_ptr == 0) { // don't want write_ptr to become dealloc_ptr
-
-					// There is no more room, try to deallocate something
-					if (dealloc_one()) {
-						goto tryagain;
-					}
-					return NULL;
-				}
-
-				// if this happens, it's a bug
-				ERR_FAIL_COND_V((COMMAND_MEM_SIZE - write_ptr) < sizeof(uint32_t), NULL);
-				// zero means, wrap to beginning
-
-				uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-				*p = 0;
-				write_ptr = 0;
-				goto tryagain;
-			}
+		// alloc size is header+T, rounded up to keep the next command aligned
+		uint32_t alloc_size = COMMAND_HEADER_SIZE + ((sizeof(T) + 7) & ~7);
+		CRASH_COND(alloc_size > COMMAND_BLOCK_SIZE);
+
+		if (write_block->write_pos + alloc_size > COMMAND_BLOCK_SIZE) {
+
+			Block *block = _alloc_block();
+			write_block->next = block;
+			write_block = block;
 		}
-		// Allocate the size and the 'in use' bit.
-		// First bit used to mark if command is still in use (1)
-		// or if it has been destroyed and can be deallocated (0).
-		uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-		*p = (sizeof(T) << 1) | 1;
-		write_ptr += sizeof(uint32_t);
-		// allocate the command
-		T *cmd = memnew_placement(&command_mem[write_ptr], T);
-		write_ptr += sizeof(T);
+
+		uint8_t *ptr = write_block->mem() + write_block->write_pos;
+		*(uint32_t *)ptr = alloc_size;
+		T *cmd = memnew_placement(ptr + COMMAND_HEADER_SIZE, T);
+		write_block->write_pos += alloc_size;
+
+		atomic_increment(&total_command_count);
+		atomic_add(&total_command_bytes, (uint64_t)alloc_size);
+
 		return cmd;
 	}
 
@@ -385,59 +377,16 @@ class CommandQueueMT {
 	T *allocate_and_lock() {
 
 		lock();
-		T *ret;
-
-		while ((ret = allocate<T>()) == NULL) {
-
-			unlock();
-			// sleep a little until fetch happened and some room is made
-			wait_for_flush();
-			lock();
-		}
-
-		return ret;
+		return allocate<T>();
 	}
 
-	bool flush_one(bool p_lock = true) {
-		if (p_lock) lock();
-	tryagain:
-
-		// tried to read an empty queue
-		if (read_ptr == write_ptr)
-			return false;
-
-		uint32_t size_ptr = read_ptr;
-		uint32_t size = *(uint32_t *)&command_mem[read_ptr] >> 1;
-
-		if (size == 0) {
-			//end of ringbuffer, wrap
-			read_ptr = 0;
-			goto tryagain;
-		}
-
-		read_ptr += sizeof(uint32_t);
-
-		CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
-
-		read_ptr += size;
-
-		if (p_lock) unlock();
-		cmd->call();
-		if (p_lock) lock();
-
-		cmd->post();
-		cmd->~CommandBase();
-		*(uint32_t *)&command_mem[size_ptr] &= ~1;
-
-		if (p_lock) unlock();
-		return true;
-	}
+	int _flush(int p_max);
 
 	void lock();
 	void unlock();
 	void wait_for_flush();
 	SyncSemaphore *_alloc_sync_sem();
-	bool dealloc_one();
+	Block *_alloc_block();
 
 public:
 	/* NORMAL PUSH COMMANDS */
@@ -455,18 +404,21 @@ public:
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
 		sync->wait();
-		flush_one();
+		_flush(1);
 	}
 
-	void flush_all() {
+	bool flush_one() {
+		return _flush(1) > 0;
+	}
 
-		//ERR_FAIL_COND(sync);
-		lock();
-		while (flush_one(false))
-			;
-		unlock();
+	void flush_all() {
+		_flush(-1);
 	}
 
+	// totals over all queues, for profiling
+	static uint64_t get_total_command_count() { return total_command_count; }
+	static uint64_t get_total_command_bytes() { return total_command_bytes; }
+
 	CommandQueueMT(bool p_sync);
 	~CommandQueueMT();
 };
@@ -215,7 +215,7 @@ void CowData<T>::_copy_on_write() {
 		/* in use by more than me */
 		uint32_t current_size = *_get_size();
 
-		uint32_t *mem_new = (uint32_t *)Memory::alloc_static(_get_alloc_size(current_size), true);
+		uint32_t *mem_new = (uint32_t *)Memory::alloc_static(_get_alloc_size(current_size), true, "CowData");
 
 		*(mem_new - 2) = 1; //refcount
 		*(mem_new - 1) = current_size; //size
@@ -258,7 +258,7 @@ Error CowData<T>::resize(int p_size) {
 
 		if (size() == 0) {
 			// alloc from scratch
-			uint32_t *ptr = (uint32_t *)Memory::alloc_static(alloc_size, true);
+			uint32_t *ptr = (uint32_t *)Memory::alloc_static(alloc_size, true, "CowData");
 			ERR_FAIL_COND_V(!ptr, ERR_OUT_OF_MEMORY);
 			*(ptr - 1) = 0; //size, currently none
 			*(ptr - 2) = 1; //refcount
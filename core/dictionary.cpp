@@ -32,6 +32,7 @@
 
 #include "ordered_hash_map.h"
 #include "safe_refcount.h"
+#include "slot_pool.h"
 #include "variant.h"
 
 struct DictionaryPrivate {
@@ -40,6 +41,8 @@ struct DictionaryPrivate {
 	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
 };
 
+static SlotPool<DictionaryPrivate> dictionary_pool;
+
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
 
 	if (_p->variant_map.empty())
@@ -175,7 +178,7 @@ void Dictionary::_unref() const {
 
 	ERR_FAIL_COND(!_p);
 	if (_p->refcount.unref()) {
-		memdelete(_p);
+		dictionary_pool.free(_p);
 	}
 	_p = NULL;
 }
@@ -266,9 +269,14 @@ Dictionary::Dictionary(const Dictionary &p_from) {
 	_ref(p_from);
 }
 
+uint32_t Dictionary::get_heap_allocation_count() {
+
+	return dictionary_pool.get_heap_allocation_count();
+}
+
 Dictionary::Dictionary() {
 
-	_p = memnew(DictionaryPrivate);
+	_p = dictionary_pool.alloc();
 	_p->refcount.init();
 }
 Dictionary::~Dictionary() {
@@ -80,6 +80,9 @@ public:
 
 	Dictionary duplicate(bool p_deep = false) const;
 
+	// blocks taken from the system allocator, the rest is reused from a pool
+	static uint32_t get_heap_allocation_count();
+
 	Dictionary(const Dictionary &p_from);
 	Dictionary();
 	~Dictionary();
@@ -30,20 +30,60 @@
 
 #include "dvector.h"
 
-Mutex *dvector_lock = NULL;
-
 PoolAllocator *MemoryPool::memory_pool = NULL;
 uint8_t *MemoryPool::pool_memory = NULL;
 size_t *MemoryPool::pool_size = NULL;
 
 MemoryPool::Alloc *MemoryPool::allocs = NULL;
-MemoryPool::Alloc *MemoryPool::free_list = NULL;
+volatile uint64_t MemoryPool::free_head = 0;
 uint32_t MemoryPool::alloc_count = 0;
 uint32_t MemoryPool::allocs_used = 0;
-Mutex *MemoryPool::alloc_mutex = NULL;
 
-size_t MemoryPool::total_memory = 0;
-size_t MemoryPool::max_memory = 0;
+uint64_t MemoryPool::total_memory = 0;
+uint64_t MemoryPool::max_memory = 0;
+
+#define FREE_HEAD_INDEX_MASK 0xFFFFFFFFULL
+#define FREE_HEAD_COUNTER_ONE (1ULL << 32)
+
+MemoryPool::Alloc *MemoryPool::alloc_acquire() {
+
+	while (true) {
+
+		uint64_t head = free_head;
+		uint32_t index = head & FREE_HEAD_INDEX_MASK;
+		if (index == 0) {
+			return NULL; //all in use
+		}
+
+		Alloc *alloc = &allocs[index - 1];
+		// next_free may be stale if another thread took this alloc meanwhile,
+		// the counter in the head makes the swap fail in that case.
+		uint64_t new_head = ((head & ~FREE_HEAD_INDEX_MASK) + FREE_HEAD_COUNTER_ONE) | alloc->next_free;
+
+		if (atomic_compare_and_swap(&free_head, head, new_head) == head) {
+			atomic_increment(&allocs_used);
+			return alloc;
+		}
+	}
+}
+
+void MemoryPool::alloc_release(Alloc *p_alloc) {
+
+	uint32_t index = (p_alloc - allocs) + 1;
+
+	while (true) {
+
+		uint64_t head = free_head;
+		p_alloc->next_free = head & FREE_HEAD_INDEX_MASK;
+		uint64_t new_head = ((head & ~FREE_HEAD_INDEX_MASK) + FREE_HEAD_COUNTER_ONE) | index;
+
+		if (atomic_compare_and_swap(&free_head, head, new_head) == head) {
+			break;
+		}
+	}
+
+	atomic_decrement(&allocs_used);
+}
 
 void MemoryPool::setup(uint32_t p_max_allocs) {
 
@@ -53,18 +93,15 @@ void MemoryPool::setup(uint32_t p_max_allocs) {
 
 	for (uint32_t i = 0; i < alloc_count - 1; i++) {
 
-		allocs[i].free_list = &allocs[i + 1];
+		allocs[i].next_free = i + 2;
 	}
 
-	free_list = &allocs[0];
-
-	alloc_mutex = Mutex::create();
+	free_head = 1;
 }
 
 void MemoryPool::cleanup() {
 
 	memdelete_arr(allocs);
-	memdelete(alloc_mutex);
 
 	ERR_EXPLAINC("There are still MemoryPool allocs in use at exit!");
 	ERR_FAIL_COND(allocs_used > 0);
@@ -54,24 +54,41 @@ struct MemoryPool {
 		PoolAllocator::ID pool_id;
 		size_t size;
 
-		Alloc *free_list;
+		uint32_t next_free; // index + 1 of the next free alloc, 0 terminates the list
 
 		Alloc() {
 			mem = NULL;
 			lock = 0;
 			pool_id = POOL_ALLOCATOR_INVALID_ID;
 			size = 0;
-			free_list = NULL;
+			next_free = 0;
 		}
 	};
 
 	static Alloc *allocs;
-	static Alloc *free_list;
+	// Head of the free list, the low 32 bits hold the index + 1 of the first
+	// free alloc and the high 32 bits a counter bumped on every change, so a
+	// compare and swap can't succeed on a head that was popped and pushed back.
+	static volatile uint64_t free_head;
 	static uint32_t alloc_count;
 	static uint32_t allocs_used;
-	static Mutex *alloc_mutex;
-	static size_t total_memory;
-	static size_t max_memory;
+	static uint64_t total_memory;
+	static uint64_t max_memory;
+
+	static Alloc *alloc_acquire();
+	static void alloc_release(Alloc *p_alloc);
+
+	_FORCE_INLINE_ static void memory_added(size_t p_size) {
+#ifdef DEBUG_ENABLED
+		atomic_exchange_if_greater(&max_memory, atomic_add(&total_memory, (uint64_t)p_size));
+#endif
+	}
+
+	_FORCE_INLINE_ static void memory_removed(size_t p_size) {
+#ifdef DEBUG_ENABLED
+		atomic_sub(&total_memory, (uint64_t)p_size);
+#endif
+	}
 
 	static void setup(uint32_t p_max_allocs = (1 << 16));
 	static void cleanup();
@@ -99,20 +116,14 @@ class PoolVector {
 
 		//must allocate something
 
-		MemoryPool::alloc_mutex->lock();
-		if (MemoryPool::allocs_used == MemoryPool::alloc_count) {
-			MemoryPool::alloc_mutex->unlock();
+		MemoryPool::Alloc *new_alloc = MemoryPool::alloc_acquire();
+		if (!new_alloc) {
 			ERR_EXPLAINC("All memory pool allocations are in use, can't COW.");
 			ERR_FAIL();
 		}
 
 		MemoryPool::Alloc *old_alloc = alloc;
-
-		//take one from the free list
-		alloc = MemoryPool::free_list;
-		MemoryPool::free_list = alloc->free_list;
-		//increment the used counter
-		MemoryPool::allocs_used++;
+		alloc = new_alloc;
 
 		//copy the alloc data
 		alloc->size = old_alloc->size;
@@ -120,14 +131,7 @@ class PoolVector {
 		alloc->pool_id = POOL_ALLOCATOR_INVALID_ID;
 		alloc->lock = 0;
 
-#ifdef DEBUG_ENABLED
-		MemoryPool::total_memory += alloc->size;
-		if (MemoryPool::total_memory > MemoryPool::max_memory) {
-			MemoryPool::max_memory = MemoryPool::total_memory;
-		}
-#endif
-
-		MemoryPool::alloc_mutex->unlock();
+		MemoryPool::memory_added(alloc->size);
 
 		if (MemoryPool::memory_pool) {
 
@@ -152,11 +156,7 @@ class PoolVector {
 		if (old_alloc->refcount.unref() == true) {
 			//this should never happen but..
 
-#ifdef DEBUG_ENABLED
-			MemoryPool::alloc_mutex->lock();
-			MemoryPool::total_memory -= old_alloc->size;
-			MemoryPool::alloc_mutex->unlock();
-#endif
+			MemoryPool::memory_removed(old_alloc->size);
 
 			{
 				Write w;
@@ -179,11 +179,7 @@ class PoolVector {
 				old_alloc->mem = NULL;
 				old_alloc->size = 0;
 
-				MemoryPool::alloc_mutex->lock();
-				old_alloc->free_list = MemoryPool::free_list;
-				MemoryPool::free_list = old_alloc;
-				MemoryPool::allocs_used--;
-				MemoryPool::alloc_mutex->unlock();
+				MemoryPool::alloc_release(old_alloc);
 			}
 		}
 	}
@@ -231,11 +227,7 @@ class PoolVector {
 			}
 		}
 
-#ifdef DEBUG_ENABLED
-		MemoryPool::alloc_mutex->lock();
-		MemoryPool::total_memory -= alloc->size;
-		MemoryPool::alloc_mutex->unlock();
-#endif
+		MemoryPool::memory_removed(alloc->size);
 
 		if (MemoryPool::memory_pool) {
 			//resize memory pool
@@ -247,11 +239,7 @@ class PoolVector {
 			alloc->mem = NULL;
 			alloc->size = 0;
 
-			MemoryPool::alloc_mutex->lock();
-			alloc->free_list = MemoryPool::free_list;
-			MemoryPool::free_list = alloc;
-			MemoryPool::allocs_used--;
-			MemoryPool::alloc_mutex->unlock();
+			MemoryPool::alloc_release(alloc);
 		}
 
 		alloc = NULL;
@@ -517,24 +505,16 @@ Error PoolVector<T>::resize(int p_size) {
 			return OK; //nothing to do here
 
 		//must allocate something
-		MemoryPool::alloc_mutex->lock();
-		if (MemoryPool::allocs_used == MemoryPool::alloc_count) {
-			MemoryPool::alloc_mutex->unlock();
+		alloc = MemoryPool::alloc_acquire();
+		if (!alloc) {
 			ERR_EXPLAINC("All memory pool allocations are in use.");
 			ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 		}
 
-		//take one from the free list
-		alloc = MemoryPool::free_list;
-		MemoryPool::free_list = alloc->free_list;
-		//increment the used counter
-		MemoryPool::allocs_used++;
-
 		//cleanup the alloc
 		alloc->size = 0;
 		alloc->refcount.init();
 		alloc->pool_id = POOL_ALLOCATOR_INVALID_ID;
-		MemoryPool::alloc_mutex->unlock();
 
 	} else {
 
@@ -553,15 +533,8 @@ Error PoolVector<T>::resize(int p_size) {
 
 	_copy_on_write(); // make it unique
 
-#ifdef DEBUG_ENABLED
-	MemoryPool::alloc_mutex->lock();
-	MemoryPool::total_memory -= alloc->size;
-	MemoryPool::total_memory += new_size;
-	if (MemoryPool::total_memory > MemoryPool::max_memory) {
-		MemoryPool::max_memory = MemoryPool::total_memory;
-	}
-	MemoryPool::alloc_mutex->unlock();
-#endif
+	MemoryPool::memory_removed(alloc->size);
+	MemoryPool::memory_added(new_size);
 
 	int cur_elements = alloc->size / sizeof(T);
 
@@ -610,11 +583,7 @@ Error PoolVector<T>::resize(int p_size) {
 				alloc->mem = NULL;
 				alloc->size = 0;
 
-				MemoryPool::alloc_mutex->lock();
-				alloc->free_list = MemoryPool::free_list;
-				MemoryPool::free_list = alloc;
-				MemoryPool::allocs_used--;
-				MemoryPool::alloc_mutex->unlock();
+				MemoryPool::alloc_release(alloc);
 
 			} else {
 				alloc->mem = memrealloc(alloc->mem, new_size);
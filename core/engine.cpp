@@ -231,7 +231,10 @@ Engine::Engine() {
 	_physics_frames = 0;
 	_idle_frames = 0;
 	_in_physics = false;
+	_physics_interpolation = false;
+	_physics_interpolation_fraction = 0;
 	_frame_ticks = 0;
 	_frame_step = 0;
 	editor_hint = false;
+	headless = false;
 }
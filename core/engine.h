@@ -66,11 +66,14 @@ private:
 
 	uint64_t _idle_frames;
 	bool _in_physics;
+	bool _physics_interpolation;
+	float _physics_interpolation_fraction;
 
 	List<Singleton> singletons;
 	Map<StringName, Object *> singleton_ptrs;
 
 	bool editor_hint;
+	bool headless;
 
 	static Engine *singleton;
 
@@ -95,6 +98,8 @@ public:
 	bool is_in_physics_frame() const { return _in_physics; }
 	uint64_t get_idle_frame_ticks() const { return _frame_ticks; }
 	float get_idle_frame_step() const { return _frame_step; }
+	bool is_physics_interpolation_enabled() const { return _physics_interpolation; }
+	float get_physics_interpolation_fraction() const { return _physics_interpolation_fraction; }
 
 	void set_time_scale(float p_scale);
 	float get_time_scale() const;
@@ -117,6 +122,10 @@ public:
 	_FORCE_INLINE_ bool is_editor_hint() const { return false; }
 #endif
 
+	// set by the server platform, GPU payloads and visual-only processing are dropped
+	_FORCE_INLINE_ void set_headless(bool p_enabled) { headless = p_enabled; }
+	_FORCE_INLINE_ bool is_headless() const { return headless; }
+
 	Dictionary get_version_info() const;
 	Dictionary get_author_info() const;
 	Array get_copyright_info() const;
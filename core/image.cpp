@@ -34,11 +34,23 @@
 #include "core/os/copymem.h"
 #include "hash_map.h"
 #include "math_funcs.h"
+#include "os/os.h"
+#include "os/worker_thread_pool.h"
 #include "print_string.h"
+#include "project_settings.h"
 
 #include "thirdparty/misc/hq2x.h"
 
 #include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IMAGE_NEON
+#endif
 
 const char *Image::format_names[Image::FORMAT_MAX] = {
 	"Lum8", //luminance
@@ -219,6 +231,16 @@ void Image::get_format_min_pixel_size(Format p_format, int &r_w, int &r_h) {
 	}
 }
 
+int Image::get_compress_thread_count() {
+
+	int threads = ProjectSettings::get_singleton() ? int(GLOBAL_GET("rendering/vram_compression/compress_threads")) : 0;
+	if (threads <= 0) {
+		threads = OS::get_singleton()->get_processor_count();
+	}
+
+	return MAX(1, threads);
+}
+
 int Image::get_format_pixel_rshift(Format p_format) {
 
 	if (p_format == FORMAT_DXT1 || p_format == FORMAT_RGTC_R || p_format == FORMAT_PVRTC4 || p_format == FORMAT_PVRTC4A || p_format == FORMAT_ETC || p_format == FORMAT_ETC2_R11 || p_format == FORMAT_ETC2_R11S || p_format == FORMAT_ETC2_RGB8 || p_format == FORMAT_ETC2_RGB8A1)
@@ -363,14 +385,64 @@ int Image::get_mipmap_count() const {
 		return 0;
 }
 
+//all the per-pixel kernels below write rows [p_from_row, p_to_row) of the destination, so big images can be split across threads
+typedef void (*ImageRowFunc)(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row);
+
+enum {
+	IMAGE_THREAD_MIN_PIXELS = 256 * 256,
+	IMAGE_THREAD_MIN_ROWS = 32
+};
+
+struct ImageRowJob {
+	ImageRowFunc func;
+	const uint8_t *src;
+	uint8_t *dst;
+	uint32_t src_width;
+	uint32_t src_height;
+	uint32_t dst_width;
+	uint32_t dst_height;
+	uint32_t splits;
+};
+
+static void _process_image_rows_split(void *p_userdata, uint32_t p_index) {
+
+	const ImageRowJob *job = (const ImageRowJob *)p_userdata;
+	uint32_t from = uint64_t(job->dst_height) * p_index / job->splits;
+	uint32_t to = uint64_t(job->dst_height) * (p_index + 1) / job->splits;
+	job->func(job->src, job->dst, job->src_width, job->src_height, job->dst_width, job->dst_height, from, to);
+}
+
+static void _process_image_rows(ImageRowFunc p_func, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	if (!pool || pool->get_thread_count() == 0 || p_dst_width * p_dst_height < IMAGE_THREAD_MIN_PIXELS || p_dst_height < IMAGE_THREAD_MIN_ROWS * 2) {
+		p_func(p_src, p_dst, p_src_width, p_src_height, p_dst_width, p_dst_height, 0, p_dst_height);
+		return;
+	}
+
+	ImageRowJob job;
+	job.func = p_func;
+	job.src = p_src;
+	job.dst = p_dst;
+	job.src_width = p_src_width;
+	job.src_height = p_src_height;
+	job.dst_width = p_dst_width;
+	job.dst_height = p_dst_height;
+	job.splits = MIN(uint32_t(pool->get_thread_count() + 1), p_dst_height / IMAGE_THREAD_MIN_ROWS);
+
+	WorkerThreadPool::GroupID group = pool->add_group_task(_process_image_rows_split, &job, job.splits, WorkerThreadPool::PRIORITY_HIGH);
+	pool->wait_for_group_task_completion(group);
+}
+
 //using template generates perfectly optimized code due to constant expression reduction and unused variable removal present in all compilers
 template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
-static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+static void _convert(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_width, uint32_t p_height, uint32_t, uint32_t, uint32_t p_from_row, uint32_t p_to_row) {
 
 	uint32_t max_bytes = MAX(read_bytes, write_bytes);
 
-	for (int y = 0; y < p_height; y++) {
-		for (int x = 0; x < p_width; x++) {
+	for (uint32_t y = p_from_row; y < p_to_row; y++) {
+		for (uint32_t x = 0; x < p_width; x++) {
 
 			const uint8_t *rofs = &p_src[((y * p_width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
 			uint8_t *wofs = &p_dst[((y * p_width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
@@ -461,36 +533,36 @@ void Image::convert(Format p_new_format) {
 
 	switch (conversion_type) {
 
-		case FORMAT_L8 | (FORMAT_LA8 << 8): _convert<1, false, 1, true, true, true>(width, height, rptr, wptr); break;
-		case FORMAT_L8 | (FORMAT_R8 << 8): _convert<1, false, 1, false, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_L8 | (FORMAT_RG8 << 8): _convert<1, false, 2, false, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_L8 | (FORMAT_RGB8 << 8): _convert<1, false, 3, false, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_L8 | (FORMAT_RGBA8 << 8): _convert<1, false, 3, true, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_LA8 | (FORMAT_L8 << 8): _convert<1, true, 1, false, true, true>(width, height, rptr, wptr); break;
-		case FORMAT_LA8 | (FORMAT_R8 << 8): _convert<1, true, 1, false, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_LA8 | (FORMAT_RG8 << 8): _convert<1, true, 2, false, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_LA8 | (FORMAT_RGB8 << 8): _convert<1, true, 3, false, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_LA8 | (FORMAT_RGBA8 << 8): _convert<1, true, 3, true, true, false>(width, height, rptr, wptr); break;
-		case FORMAT_R8 | (FORMAT_L8 << 8): _convert<1, false, 1, false, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_R8 | (FORMAT_LA8 << 8): _convert<1, false, 1, true, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_R8 | (FORMAT_RG8 << 8): _convert<1, false, 2, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_R8 | (FORMAT_RGB8 << 8): _convert<1, false, 3, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_R8 | (FORMAT_RGBA8 << 8): _convert<1, false, 3, true, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RG8 | (FORMAT_L8 << 8): _convert<2, false, 1, false, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_RG8 | (FORMAT_LA8 << 8): _convert<2, false, 1, true, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_RG8 | (FORMAT_R8 << 8): _convert<2, false, 1, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RG8 | (FORMAT_RGB8 << 8): _convert<2, false, 3, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RG8 | (FORMAT_RGBA8 << 8): _convert<2, false, 3, true, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RGB8 | (FORMAT_L8 << 8): _convert<3, false, 1, false, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_RGB8 | (FORMAT_LA8 << 8): _convert<3, false, 1, true, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_RGB8 | (FORMAT_R8 << 8): _convert<3, false, 1, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RGB8 | (FORMAT_RG8 << 8): _convert<3, false, 2, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RGB8 | (FORMAT_RGBA8 << 8): _convert<3, false, 3, true, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RGBA8 | (FORMAT_L8 << 8): _convert<3, true, 1, false, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_RGBA8 | (FORMAT_LA8 << 8): _convert<3, true, 1, true, false, true>(width, height, rptr, wptr); break;
-		case FORMAT_RGBA8 | (FORMAT_R8 << 8): _convert<3, true, 1, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RGBA8 | (FORMAT_RG8 << 8): _convert<3, true, 2, false, false, false>(width, height, rptr, wptr); break;
-		case FORMAT_RGBA8 | (FORMAT_RGB8 << 8): _convert<3, true, 3, false, false, false>(width, height, rptr, wptr); break;
+		case FORMAT_L8 | (FORMAT_LA8 << 8): _process_image_rows(_convert<1, false, 1, true, true, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_L8 | (FORMAT_R8 << 8): _process_image_rows(_convert<1, false, 1, false, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_L8 | (FORMAT_RG8 << 8): _process_image_rows(_convert<1, false, 2, false, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_L8 | (FORMAT_RGB8 << 8): _process_image_rows(_convert<1, false, 3, false, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_L8 | (FORMAT_RGBA8 << 8): _process_image_rows(_convert<1, false, 3, true, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_LA8 | (FORMAT_L8 << 8): _process_image_rows(_convert<1, true, 1, false, true, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_LA8 | (FORMAT_R8 << 8): _process_image_rows(_convert<1, true, 1, false, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_LA8 | (FORMAT_RG8 << 8): _process_image_rows(_convert<1, true, 2, false, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_LA8 | (FORMAT_RGB8 << 8): _process_image_rows(_convert<1, true, 3, false, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_LA8 | (FORMAT_RGBA8 << 8): _process_image_rows(_convert<1, true, 3, true, true, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_R8 | (FORMAT_L8 << 8): _process_image_rows(_convert<1, false, 1, false, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_R8 | (FORMAT_LA8 << 8): _process_image_rows(_convert<1, false, 1, true, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_R8 | (FORMAT_RG8 << 8): _process_image_rows(_convert<1, false, 2, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_R8 | (FORMAT_RGB8 << 8): _process_image_rows(_convert<1, false, 3, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_R8 | (FORMAT_RGBA8 << 8): _process_image_rows(_convert<1, false, 3, true, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RG8 | (FORMAT_L8 << 8): _process_image_rows(_convert<2, false, 1, false, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RG8 | (FORMAT_LA8 << 8): _process_image_rows(_convert<2, false, 1, true, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RG8 | (FORMAT_R8 << 8): _process_image_rows(_convert<2, false, 1, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RG8 | (FORMAT_RGB8 << 8): _process_image_rows(_convert<2, false, 3, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RG8 | (FORMAT_RGBA8 << 8): _process_image_rows(_convert<2, false, 3, true, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGB8 | (FORMAT_L8 << 8): _process_image_rows(_convert<3, false, 1, false, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGB8 | (FORMAT_LA8 << 8): _process_image_rows(_convert<3, false, 1, true, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGB8 | (FORMAT_R8 << 8): _process_image_rows(_convert<3, false, 1, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGB8 | (FORMAT_RG8 << 8): _process_image_rows(_convert<3, false, 2, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGB8 | (FORMAT_RGBA8 << 8): _process_image_rows(_convert<3, false, 3, true, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGBA8 | (FORMAT_L8 << 8): _process_image_rows(_convert<3, true, 1, false, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGBA8 | (FORMAT_LA8 << 8): _process_image_rows(_convert<3, true, 1, true, false, true>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGBA8 | (FORMAT_R8 << 8): _process_image_rows(_convert<3, true, 1, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGBA8 | (FORMAT_RG8 << 8): _process_image_rows(_convert<3, true, 2, false, false, false>, rptr, wptr, width, height, width, height); break;
+		case FORMAT_RGBA8 | (FORMAT_RGB8 << 8): _process_image_rows(_convert<3, true, 3, false, false, false>, rptr, wptr, width, height, width, height); break;
 	}
 
 	r = PoolVector<uint8_t>::Read();
@@ -526,7 +598,7 @@ static double _bicubic_interp_kernel(double x) {
 }
 
 template <int CC>
-static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 
 	// get source image size
 	int width = p_src_width;
@@ -542,7 +614,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	int xmax = width - 1;
 	// temporary pointer
 
-	for (uint32_t y = 0; y < p_dst_height; y++) {
+	for (uint32_t y = p_from_row; y < p_to_row; y++) {
 		// Y coordinates
 		oy = (double)y * yfac - 0.5f;
 		oy1 = (int)oy;
@@ -601,7 +673,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 }
 
 template <int CC>
-static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 
 	enum {
 		FRAC_BITS = 8,
@@ -610,7 +682,7 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 
 	};
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 
 		uint32_t src_yofs_up_fp = (i * p_src_height * FRAC_LEN / p_dst_height);
 		uint32_t src_yofs_frac = src_yofs_up_fp & FRAC_MASK;
@@ -638,6 +710,49 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 			src_xofs_left *= CC;
 			src_xofs_right *= CC;
 
+#if defined(IMAGE_SSE2) || defined(IMAGE_NEON)
+			if (CC == 4) {
+				// same result as below: the horizontal lerps are exact in 16 bits, the vertical one needs 32
+				uint32_t p00, p10, p01, p11;
+				memcpy(&p00, &p_src[y_ofs_up + src_xofs_left], 4);
+				memcpy(&p10, &p_src[y_ofs_up + src_xofs_right], 4);
+				memcpy(&p01, &p_src[y_ofs_down + src_xofs_left], 4);
+				memcpy(&p11, &p_src[y_ofs_down + src_xofs_right], 4);
+				uint32_t result;
+#if defined(IMAGE_SSE2)
+				__m128i zero = _mm_setzero_si128();
+				__m128i fx = _mm_set1_epi16(src_xofs_frac);
+				__m128i fx_inv = _mm_set1_epi16(FRAC_LEN - src_xofs_frac);
+				__m128i fy = _mm_set1_epi16(src_yofs_frac);
+				__m128i fy_inv = _mm_set1_epi16(FRAC_LEN - src_yofs_frac);
+
+				__m128i up = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p00), zero), fx_inv), _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p10), zero), fx));
+				__m128i down = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p01), zero), fx_inv), _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p11), zero), fx));
+
+				__m128i up32 = _mm_unpacklo_epi16(_mm_mullo_epi16(up, fy_inv), _mm_mulhi_epu16(up, fy_inv));
+				__m128i down32 = _mm_unpacklo_epi16(_mm_mullo_epi16(down, fy), _mm_mulhi_epu16(down, fy));
+				__m128i interp = _mm_srli_epi32(_mm_add_epi32(up32, down32), FRAC_BITS * 2);
+
+				interp = _mm_packs_epi32(interp, zero);
+				result = _mm_cvtsi128_si32(_mm_packus_epi16(interp, zero));
+#else
+				uint16x4_t v00 = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p00))));
+				uint16x4_t v10 = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p10))));
+				uint16x4_t v01 = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p01))));
+				uint16x4_t v11 = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p11))));
+
+				uint16x4_t up = vmla_n_u16(vmul_n_u16(v00, FRAC_LEN - src_xofs_frac), v10, src_xofs_frac);
+				uint16x4_t down = vmla_n_u16(vmul_n_u16(v01, FRAC_LEN - src_xofs_frac), v11, src_xofs_frac);
+
+				uint32x4_t interp = vshrq_n_u32(vmlal_n_u16(vmull_n_u16(up, FRAC_LEN - src_yofs_frac), down, src_yofs_frac), FRAC_BITS * 2);
+				uint16x4_t interp16 = vmovn_u32(interp);
+				result = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(interp16, interp16))), 0);
+#endif
+				memcpy(&p_dst[i * p_dst_width * CC + j * CC], &result, 4);
+				continue;
+			}
+#endif
+
 			for (uint32_t l = 0; l < CC; l++) {
 
 				uint32_t p00 = p_src[y_ofs_up + src_xofs_left + l] << FRAC_BITS;
@@ -656,9 +771,9 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 }
 
 template <int CC>
-static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 
 		uint32_t src_yofs = i * p_src_height / p_dst_height;
 		uint32_t y_ofs = src_yofs * p_src_width * CC;
@@ -767,10 +882,10 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 		case INTERPOLATE_NEAREST: {
 
 			switch (get_format_pixel_size(format)) {
-				case 1: _scale_nearest<1>(r_ptr, w_ptr, width, height, p_width, p_height); break;
-				case 2: _scale_nearest<2>(r_ptr, w_ptr, width, height, p_width, p_height); break;
-				case 3: _scale_nearest<3>(r_ptr, w_ptr, width, height, p_width, p_height); break;
-				case 4: _scale_nearest<4>(r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 1: _process_image_rows(_scale_nearest<1>, r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 2: _process_image_rows(_scale_nearest<2>, r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 3: _process_image_rows(_scale_nearest<3>, r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 4: _process_image_rows(_scale_nearest<4>, r_ptr, w_ptr, width, height, p_width, p_height); break;
 			}
 		} break;
 		case INTERPOLATE_BILINEAR:
@@ -813,10 +928,10 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 				}
 
 				switch (get_format_pixel_size(format)) {
-					case 1: _scale_bilinear<1>(src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
-					case 2: _scale_bilinear<2>(src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
-					case 3: _scale_bilinear<3>(src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
-					case 4: _scale_bilinear<4>(src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
+					case 1: _process_image_rows(_scale_bilinear<1>, src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
+					case 2: _process_image_rows(_scale_bilinear<2>, src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
+					case 3: _process_image_rows(_scale_bilinear<3>, src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
+					case 4: _process_image_rows(_scale_bilinear<4>, src_ptr, w_ptr, src_width, src_height, p_width, p_height); break;
 				}
 			}
 
@@ -830,10 +945,10 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 		case INTERPOLATE_CUBIC: {
 
 			switch (get_format_pixel_size(format)) {
-				case 1: _scale_cubic<1>(r_ptr, w_ptr, width, height, p_width, p_height); break;
-				case 2: _scale_cubic<2>(r_ptr, w_ptr, width, height, p_width, p_height); break;
-				case 3: _scale_cubic<3>(r_ptr, w_ptr, width, height, p_width, p_height); break;
-				case 4: _scale_cubic<4>(r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 1: _process_image_rows(_scale_cubic<1>, r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 2: _process_image_rows(_scale_cubic<2>, r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 3: _process_image_rows(_scale_cubic<3>, r_ptr, w_ptr, width, height, p_width, p_height); break;
+				case 4: _process_image_rows(_scale_cubic<4>, r_ptr, w_ptr, width, height, p_width, p_height); break;
 			}
 
 		} break;
@@ -1030,19 +1145,69 @@ bool Image::_can_modify(Format p_format) const {
 }
 
 template <int CC, bool renormalize>
-static void _generate_po2_mipmap(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_width, uint32_t p_height) {
+static void _generate_po2_mipmap(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_width, uint32_t p_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 
 	//fast power of 2 mipmap generation
 	uint32_t dst_w = p_width >> 1;
-	uint32_t dst_h = p_height >> 1;
 
-	for (uint32_t i = 0; i < dst_h; i++) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 
 		const uint8_t *rup_ptr = &p_src[i * 2 * p_width * CC];
 		const uint8_t *rdown_ptr = rup_ptr + p_width * CC;
 		uint8_t *dst_ptr = &p_dst[i * dst_w * CC];
 		uint32_t count = dst_w;
 
+#if defined(IMAGE_SSE2)
+		if (CC == 4 && !renormalize) {
+			//4 destination pixels at a time, truncating like the scalar version
+			__m128i zero = _mm_setzero_si128();
+			for (; count >= 4; count -= 4) {
+				__m128i up0 = _mm_loadu_si128((const __m128i *)rup_ptr);
+				__m128i up1 = _mm_loadu_si128((const __m128i *)(rup_ptr + 16));
+				__m128i down0 = _mm_loadu_si128((const __m128i *)rdown_ptr);
+				__m128i down1 = _mm_loadu_si128((const __m128i *)(rdown_ptr + 16));
+
+				__m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(up0, zero), _mm_unpacklo_epi8(down0, zero));
+				__m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(up0, zero), _mm_unpackhi_epi8(down0, zero));
+				__m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(up1, zero), _mm_unpacklo_epi8(down1, zero));
+				__m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(up1, zero), _mm_unpackhi_epi8(down1, zero));
+
+				//add the left and right pixel of each pair, which sit in the low and high halves
+				__m128i d01 = _mm_unpacklo_epi64(_mm_add_epi16(s0, _mm_srli_si128(s0, 8)), _mm_add_epi16(s1, _mm_srli_si128(s1, 8)));
+				__m128i d23 = _mm_unpacklo_epi64(_mm_add_epi16(s2, _mm_srli_si128(s2, 8)), _mm_add_epi16(s3, _mm_srli_si128(s3, 8)));
+
+				_mm_storeu_si128((__m128i *)dst_ptr, _mm_packus_epi16(_mm_srli_epi16(d01, 2), _mm_srli_epi16(d23, 2)));
+
+				rup_ptr += 32;
+				rdown_ptr += 32;
+				dst_ptr += 16;
+			}
+		}
+#elif defined(IMAGE_NEON)
+		if (CC == 4 && !renormalize) {
+			for (; count >= 4; count -= 4) {
+				uint8x16_t up0 = vld1q_u8(rup_ptr);
+				uint8x16_t up1 = vld1q_u8(rup_ptr + 16);
+				uint8x16_t down0 = vld1q_u8(rdown_ptr);
+				uint8x16_t down1 = vld1q_u8(rdown_ptr + 16);
+
+				uint16x8_t s0 = vaddl_u8(vget_low_u8(up0), vget_low_u8(down0));
+				uint16x8_t s1 = vaddl_u8(vget_high_u8(up0), vget_high_u8(down0));
+				uint16x8_t s2 = vaddl_u8(vget_low_u8(up1), vget_low_u8(down1));
+				uint16x8_t s3 = vaddl_u8(vget_high_u8(up1), vget_high_u8(down1));
+
+				uint16x8_t d01 = vcombine_u16(vadd_u16(vget_low_u16(s0), vget_high_u16(s0)), vadd_u16(vget_low_u16(s1), vget_high_u16(s1)));
+				uint16x8_t d23 = vcombine_u16(vadd_u16(vget_low_u16(s2), vget_high_u16(s2)), vadd_u16(vget_low_u16(s3), vget_high_u16(s3)));
+
+				vst1q_u8(dst_ptr, vcombine_u8(vshrn_n_u16(d01, 2), vshrn_n_u16(d23, 2)));
+
+				rup_ptr += 32;
+				rdown_ptr += 32;
+				dst_ptr += 16;
+			}
+		}
+#endif
+
 		while (count--) {
 
 			for (int j = 0; j < CC; j++) {
@@ -1150,11 +1315,11 @@ void Image::shrink_x2() {
 			switch (format) {
 
 				case FORMAT_L8:
-				case FORMAT_R8: _generate_po2_mipmap<1, false>(r.ptr(), w.ptr(), width, height); break;
-				case FORMAT_LA8: _generate_po2_mipmap<2, false>(r.ptr(), w.ptr(), width, height); break;
-				case FORMAT_RG8: _generate_po2_mipmap<2, false>(r.ptr(), w.ptr(), width, height); break;
-				case FORMAT_RGB8: _generate_po2_mipmap<3, false>(r.ptr(), w.ptr(), width, height); break;
-				case FORMAT_RGBA8: _generate_po2_mipmap<4, false>(r.ptr(), w.ptr(), width, height); break;
+				case FORMAT_R8: _process_image_rows(_generate_po2_mipmap<1, false>, r.ptr(), w.ptr(), width, height, width / 2, height / 2); break;
+				case FORMAT_LA8: _process_image_rows(_generate_po2_mipmap<2, false>, r.ptr(), w.ptr(), width, height, width / 2, height / 2); break;
+				case FORMAT_RG8: _process_image_rows(_generate_po2_mipmap<2, false>, r.ptr(), w.ptr(), width, height, width / 2, height / 2); break;
+				case FORMAT_RGB8: _process_image_rows(_generate_po2_mipmap<3, false>, r.ptr(), w.ptr(), width, height, width / 2, height / 2); break;
+				case FORMAT_RGBA8: _process_image_rows(_generate_po2_mipmap<4, false>, r.ptr(), w.ptr(), width, height, width / 2, height / 2); break;
 				default: {}
 			}
 		}
@@ -1224,21 +1389,21 @@ Error Image::generate_mipmaps(bool p_renormalize) {
 		switch (format) {
 
 			case FORMAT_L8:
-			case FORMAT_R8: _generate_po2_mipmap<1, false>(&wp[prev_ofs], &wp[ofs], prev_w, prev_h); break;
+			case FORMAT_R8: _process_image_rows(_generate_po2_mipmap<1, false>, &wp[prev_ofs], &wp[ofs], prev_w, prev_h, w, h); break;
 			case FORMAT_LA8:
-			case FORMAT_RG8: _generate_po2_mipmap<2, false>(&wp[prev_ofs], &wp[ofs], prev_w, prev_h); break;
+			case FORMAT_RG8: _process_image_rows(_generate_po2_mipmap<2, false>, &wp[prev_ofs], &wp[ofs], prev_w, prev_h, w, h); break;
 			case FORMAT_RGB8:
 				if (p_renormalize)
-					_generate_po2_mipmap<3, true>(&wp[prev_ofs], &wp[ofs], prev_w, prev_h);
+					_process_image_rows(_generate_po2_mipmap<3, true>, &wp[prev_ofs], &wp[ofs], prev_w, prev_h, w, h);
 				else
-					_generate_po2_mipmap<3, false>(&wp[prev_ofs], &wp[ofs], prev_w, prev_h);
+					_process_image_rows(_generate_po2_mipmap<3, false>, &wp[prev_ofs], &wp[ofs], prev_w, prev_h, w, h);
 
 				break;
 			case FORMAT_RGBA8:
 				if (p_renormalize)
-					_generate_po2_mipmap<4, true>(&wp[prev_ofs], &wp[ofs], prev_w, prev_h);
+					_process_image_rows(_generate_po2_mipmap<4, true>, &wp[prev_ofs], &wp[ofs], prev_w, prev_h, w, h);
 				else
-					_generate_po2_mipmap<4, false>(&wp[prev_ofs], &wp[ofs], prev_w, prev_h);
+					_process_image_rows(_generate_po2_mipmap<4, false>, &wp[prev_ofs], &wp[ofs], prev_w, prev_h, w, h);
 				break;
 			default: {}
 		}
@@ -1613,8 +1778,10 @@ bool Image::is_compressed() const {
 
 Error Image::decompress() {
 
-	if (format >= FORMAT_DXT1 && format <= FORMAT_BPTC_RGBFU && _image_decompress_bc)
+	if (format >= FORMAT_DXT1 && format <= FORMAT_RGTC_RG && _image_decompress_bc)
 		_image_decompress_bc(this);
+	else if (format >= FORMAT_BPTC_RGBA && format <= FORMAT_BPTC_RGBFU && _image_decompress_bptc)
+		_image_decompress_bptc(this);
 	else if (format >= FORMAT_PVRTC2 && format <= FORMAT_PVRTC4A && _image_decompress_pvrtc)
 		_image_decompress_pvrtc(this);
 	else if (format == FORMAT_ETC && _image_decompress_etc1)
@@ -1655,6 +1822,11 @@ Error Image::compress(CompressMode p_mode, CompressSource p_source, float p_loss
 			ERR_FAIL_COND_V(!_image_compress_etc2_func, ERR_UNAVAILABLE);
 			_image_compress_etc2_func(this, p_lossy_quality, p_source);
 		} break;
+		case COMPRESS_BPTC: {
+
+			ERR_FAIL_COND_V(!_image_compress_bptc_func, ERR_UNAVAILABLE);
+			_image_compress_bptc_func(this, p_lossy_quality, p_source);
+		} break;
 	}
 
 	return OK;
@@ -1996,10 +2168,12 @@ void (*Image::_image_compress_pvrtc2_func)(Image *) = NULL;
 void (*Image::_image_compress_pvrtc4_func)(Image *) = NULL;
 void (*Image::_image_compress_etc1_func)(Image *, float) = NULL;
 void (*Image::_image_compress_etc2_func)(Image *, float, Image::CompressSource) = NULL;
+void (*Image::_image_compress_bptc_func)(Image *, float, Image::CompressSource) = NULL;
 void (*Image::_image_decompress_pvrtc)(Image *) = NULL;
 void (*Image::_image_decompress_bc)(Image *) = NULL;
 void (*Image::_image_decompress_etc1)(Image *) = NULL;
 void (*Image::_image_decompress_etc2)(Image *) = NULL;
+void (*Image::_image_decompress_bptc)(Image *) = NULL;
 
 PoolVector<uint8_t> (*Image::lossy_packer)(const Ref<Image> &, float) = NULL;
 Ref<Image> (*Image::lossy_unpacker)(const PoolVector<uint8_t> &) = NULL;
@@ -2515,6 +2689,7 @@ void Image::_bind_methods() {
 	BIND_ENUM_CONSTANT(COMPRESS_PVRTC4);
 	BIND_ENUM_CONSTANT(COMPRESS_ETC);
 	BIND_ENUM_CONSTANT(COMPRESS_ETC2);
+	BIND_ENUM_CONSTANT(COMPRESS_BPTC);
 
 	BIND_ENUM_CONSTANT(COMPRESS_SOURCE_GENERIC);
 	BIND_ENUM_CONSTANT(COMPRESS_SOURCE_SRGB);
@@ -2817,3 +2992,123 @@ Image::~Image() {
 		unlock();
 	}
 }
+
+void ImageDecodeTask::_decode_task(void *p_userdata, uint32_t p_index) {
+
+	ImageDecodeTask *task = (ImageDecodeTask *)p_userdata;
+	task->_decode();
+	//emit from the main thread, so the image can be uploaded right away
+	task->call_deferred("_decode_completed");
+}
+
+void ImageDecodeTask::_decode() {
+
+	PoolVector<uint8_t>::Read r = buffer.read();
+
+	image = loader(r.ptr(), buffer.size());
+	error = image.is_valid() ? OK : ERR_PARSE_ERROR;
+}
+
+void ImageDecodeTask::_decode_completed() {
+
+	if (running) {
+		wait();
+	}
+
+	emit_signal("completed");
+}
+
+Error ImageDecodeTask::decode(const PoolVector<uint8_t> &p_buffer) {
+
+	ERR_FAIL_COND_V(running, ERR_BUSY);
+
+	int len = p_buffer.size();
+	ERR_FAIL_COND_V(len < 4, ERR_INVALID_PARAMETER);
+
+	ImageMemLoadFunc func = NULL;
+	{
+		//pick the decoder from the file signature
+		PoolVector<uint8_t>::Read r = p_buffer.read();
+		if (r[0] == 0x89 && r[1] == 'P' && r[2] == 'N' && r[3] == 'G') {
+			func = Image::_png_mem_loader_func;
+		} else if (r[0] == 0xFF && r[1] == 0xD8) {
+			func = Image::_jpg_mem_loader_func;
+		} else if (len >= 12 && r[0] == 'R' && r[1] == 'I' && r[2] == 'F' && r[3] == 'F' && r[8] == 'W' && r[9] == 'E' && r[10] == 'B' && r[11] == 'P') {
+			func = Image::_webp_mem_loader_func;
+		}
+	}
+	ERR_FAIL_COND_V(!func, ERR_FILE_UNRECOGNIZED);
+
+	buffer = p_buffer;
+	loader = func;
+	image = Ref<Image>();
+	error = OK;
+	running = true;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		group = pool->add_task(_decode_task, this, WorkerThreadPool::PRIORITY_LOW);
+	} else {
+		//no workers to pick it up, decode now but still report deferred
+		_decode_task(this, 0);
+		running = false;
+		buffer = PoolVector<uint8_t>();
+	}
+
+	return OK;
+}
+
+bool ImageDecodeTask::is_running() const {
+
+	return running && !WorkerThreadPool::get_singleton()->is_group_task_completed(group);
+}
+
+Error ImageDecodeTask::wait() {
+
+	if (running) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		running = false;
+		buffer = PoolVector<uint8_t>();
+	}
+
+	return error;
+}
+
+Ref<Image> ImageDecodeTask::get_image() const {
+
+	ERR_FAIL_COND_V(running, Ref<Image>());
+	return image;
+}
+
+Error ImageDecodeTask::get_error() const {
+
+	ERR_FAIL_COND_V(running, ERR_BUSY);
+	return error;
+}
+
+void ImageDecodeTask::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("decode", "buffer"), &ImageDecodeTask::decode);
+	ClassDB::bind_method(D_METHOD("is_running"), &ImageDecodeTask::is_running);
+	ClassDB::bind_method(D_METHOD("wait"), &ImageDecodeTask::wait);
+	ClassDB::bind_method(D_METHOD("get_image"), &ImageDecodeTask::get_image);
+	ClassDB::bind_method(D_METHOD("get_error"), &ImageDecodeTask::get_error);
+
+	ClassDB::bind_method(D_METHOD("_decode_completed"), &ImageDecodeTask::_decode_completed);
+
+	ADD_SIGNAL(MethodInfo("completed"));
+}
+
+ImageDecodeTask::ImageDecodeTask() {
+
+	loader = NULL;
+	error = OK;
+	group = 0;
+	running = false;
+}
+
+ImageDecodeTask::~ImageDecodeTask() {
+
+	//the worker still references this task
+	wait();
+}
@@ -34,6 +34,7 @@
 #include "color.h"
 #include "dvector.h"
 #include "math_2d.h"
+#include "os/worker_thread_pool.h"
 #include "resource.h"
 
 /**
@@ -131,11 +132,13 @@ public:
 	static void (*_image_compress_pvrtc4_func)(Image *);
 	static void (*_image_compress_etc1_func)(Image *, float);
 	static void (*_image_compress_etc2_func)(Image *, float, CompressSource p_source);
+	static void (*_image_compress_bptc_func)(Image *, float, CompressSource p_source);
 
 	static void (*_image_decompress_pvrtc)(Image *);
 	static void (*_image_decompress_bc)(Image *);
 	static void (*_image_decompress_etc1)(Image *);
 	static void (*_image_decompress_etc2)(Image *);
+	static void (*_image_decompress_bptc)(Image *);
 
 	static PoolVector<uint8_t> (*lossy_packer)(const Ref<Image> &p_image, float p_quality);
 	static Ref<Image> (*lossy_unpacker)(const PoolVector<uint8_t> &p_buffer);
@@ -275,6 +278,7 @@ public:
 
 	static int get_image_data_size(int p_width, int p_height, Format p_format, bool p_mipmaps = false);
 	static int get_image_required_mipmaps(int p_width, int p_height, Format p_format);
+	static int get_compress_thread_count();
 
 	enum CompressMode {
 		COMPRESS_S3TC,
@@ -282,6 +286,7 @@ public:
 		COMPRESS_PVRTC4,
 		COMPRESS_ETC,
 		COMPRESS_ETC2,
+		COMPRESS_BPTC,
 	};
 
 	Error compress(CompressMode p_mode = COMPRESS_S3TC, CompressSource p_source = COMPRESS_SOURCE_GENERIC, float p_lossy_quality = 0.7);
@@ -355,4 +360,41 @@ VARIANT_ENUM_CAST(Image::CompressMode)
 VARIANT_ENUM_CAST(Image::CompressSource)
 VARIANT_ENUM_CAST(Image::AlphaMode)
 
+/**
+ * Decodes a PNG, JPEG or WebP buffer on the worker pool, so loading many
+ * images does not stall the calling thread. "completed" is emitted on the
+ * main thread, where the image can be uploaded (ie, to an ImageTexture).
+ */
+
+class ImageDecodeTask : public Reference {
+	GDCLASS(ImageDecodeTask, Reference);
+
+	PoolVector<uint8_t> buffer;
+	ImageMemLoadFunc loader;
+	Ref<Image> image;
+	Error error;
+
+	WorkerThreadPool::GroupID group;
+	bool running;
+
+	static void _decode_task(void *p_userdata, uint32_t p_index);
+	void _decode();
+	void _decode_completed();
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error decode(const PoolVector<uint8_t> &p_buffer);
+
+	bool is_running() const;
+	Error wait();
+
+	Ref<Image> get_image() const;
+	Error get_error() const;
+
+	ImageDecodeTask();
+	~ImageDecodeTask();
+};
+
 #endif
@@ -62,12 +62,14 @@ void InputMap::add_action(const StringName &p_action, float p_deadzone) {
 	input_map[p_action].id = last_id;
 	input_map[p_action].deadzone = p_deadzone;
 	last_id++;
+	event_index_dirty = true;
 }
 
 void InputMap::erase_action(const StringName &p_action) {
 
 	ERR_FAIL_COND(!input_map.has(p_action));
 	input_map.erase(p_action);
+	event_index_dirty = true;
 }
 
 Array InputMap::_get_actions() {
@@ -139,6 +141,7 @@ void InputMap::action_add_event(const StringName &p_action, const Ref<InputEvent
 		return; //already gots
 
 	input_map[p_action].inputs.push_back(p_event);
+	event_index_dirty = true;
 }
 
 bool InputMap::action_has_event(const StringName &p_action, const Ref<InputEvent> &p_event) {
@@ -152,8 +155,10 @@ void InputMap::action_erase_event(const StringName &p_action, const Ref<InputEve
 	ERR_FAIL_COND(!input_map.has(p_action));
 
 	List<Ref<InputEvent> >::Element *E = _find_event(input_map[p_action], p_event);
-	if (E)
+	if (E) {
 		input_map[p_action].inputs.erase(E);
+		event_index_dirty = true;
+	}
 }
 
 void InputMap::action_erase_events(const StringName &p_action) {
@@ -161,6 +166,7 @@ void InputMap::action_erase_events(const StringName &p_action) {
 	ERR_FAIL_COND(!input_map.has(p_action));
 
 	input_map[p_action].inputs.clear();
+	event_index_dirty = true;
 }
 
 Array InputMap::_get_action_list(const StringName &p_action) {
@@ -216,6 +222,82 @@ bool InputMap::event_get_action_status(const Ref<InputEvent> &p_event, const Str
 	}
 }
 
+uint64_t InputMap::_get_event_index_key(const Ref<InputEvent> &p_event, int p_action_id) {
+
+	// must group events the same way action_match() does, device is checked later
+	Ref<InputEventKey> k = p_event;
+	if (k.is_valid())
+		return (uint64_t(1) << 32) | k->get_scancode();
+
+	Ref<InputEventMouseButton> mb = p_event;
+	if (mb.is_valid())
+		return (uint64_t(2) << 32) | mb->get_button_index();
+
+	Ref<InputEventJoypadButton> jb = p_event;
+	if (jb.is_valid())
+		return (uint64_t(3) << 32) | jb->get_button_index();
+
+	Ref<InputEventJoypadMotion> jm = p_event;
+	if (jm.is_valid())
+		return (uint64_t(4) << 32) | jm->get_axis();
+
+	Ref<InputEventAction> ia = p_event;
+	if (ia.is_valid())
+		return (uint64_t(5) << 32) | p_action_id;
+
+	return 0; // can't match any action
+}
+
+void InputMap::_update_event_index() const {
+
+	if (!event_index_dirty)
+		return;
+
+	event_index.clear();
+
+	for (const Map<StringName, Action>::Element *E = input_map.front(); E; E = E->next()) {
+
+		const Action &action = E->get();
+		event_index[(uint64_t(5) << 32) | action.id].push_back(E->key()); // InputEventAction
+
+		for (const List<Ref<InputEvent> >::Element *F = action.inputs.front(); F; F = F->next()) {
+
+			uint64_t key = _get_event_index_key(F->get());
+			if (key == 0)
+				continue;
+
+			Vector<StringName> &actions = event_index[key];
+			if (actions.empty() || actions[actions.size() - 1] != E->key()) {
+				actions.push_back(E->key());
+			}
+		}
+	}
+
+	event_index_dirty = false;
+}
+
+const Vector<StringName> *InputMap::get_event_action_candidates(const Ref<InputEvent> &p_event) const {
+
+	ERR_FAIL_COND_V(p_event.is_null(), NULL);
+
+	_update_event_index();
+
+	int action_id = 0;
+	Ref<InputEventAction> ia = p_event;
+	if (ia.is_valid()) {
+		const Map<StringName, Action>::Element *E = input_map.find(ia->get_action());
+		if (!E)
+			return NULL;
+		action_id = E->get().id;
+	}
+
+	uint64_t key = _get_event_index_key(p_event, action_id);
+	if (key == 0)
+		return NULL;
+
+	return event_index.getptr(key);
+}
+
 const Map<StringName, InputMap::Action> &InputMap::get_action_map() const {
 	return input_map;
 }
@@ -223,6 +305,7 @@ const Map<StringName, InputMap::Action> &InputMap::get_action_map() const {
 void InputMap::load_from_globals() {
 
 	input_map.clear();
+	event_index_dirty = true;
 
 	List<PropertyInfo> pinfo;
 	ProjectSettings::get_singleton()->get_property_list(&pinfo);
@@ -334,4 +417,5 @@ InputMap::InputMap() {
 
 	ERR_FAIL_COND(singleton);
 	singleton = this;
+	event_index_dirty = true;
 }
@@ -55,6 +55,13 @@ private:
 
 	mutable Map<StringName, Action> input_map;
 
+	// actions by the key, button or axis of their inputs, rebuilt lazily when actions change
+	mutable HashMap<uint64_t, Vector<StringName> > event_index;
+	mutable bool event_index_dirty;
+
+	static uint64_t _get_event_index_key(const Ref<InputEvent> &p_event, int p_action_id = 0);
+	void _update_event_index() const;
+
 	List<Ref<InputEvent> >::Element *_find_event(Action &p_action, const Ref<InputEvent> &p_event, bool *p_pressed = NULL, float *p_strength = NULL) const;
 
 	Array _get_action_list(const StringName &p_action);
@@ -80,6 +87,7 @@ public:
 	const List<Ref<InputEvent> > *get_action_list(const StringName &p_action);
 	bool event_is_action(const Ref<InputEvent> &p_event, const StringName &p_action) const;
 	bool event_get_action_status(const Ref<InputEvent> &p_event, const StringName &p_action, bool *p_pressed = NULL, float *p_strength = NULL) const;
+	const Vector<StringName> *get_event_action_candidates(const Ref<InputEvent> &p_event) const;
 
 	const Map<StringName, Action> &get_action_map() const;
 	void load_from_globals();
@@ -0,0 +1,191 @@
+/*************************************************************************/
+/*  buffered_file_reader.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "buffered_file_reader.h"
+
+const uint8_t *BufferedFileReader::_read_slow(int p_length) {
+
+	if (!file || eof || spanned || p_length > BUFFER_SIZE) {
+		// a span covers the rest of the file, so running out of it is the end
+		eof = true;
+		pos = data_size;
+		return NULL;
+	}
+
+	// keep what is left of the buffer, then refill after it
+	uint8_t *w = buffer.ptrw();
+	int left = data_size - pos;
+	if (left > 0 && pos > 0) {
+		memmove(w, &w[pos], left);
+	}
+	data_offset += pos;
+	pos = 0;
+	data_size = left + file->get_buffer(&w[left], BUFFER_SIZE - left);
+	data = w;
+
+	if (p_length > data_size) {
+		eof = true;
+		pos = data_size;
+		return NULL;
+	}
+
+	pos = p_length;
+	return data;
+}
+
+void BufferedFileReader::open(FileAccess *p_file) {
+
+	file = p_file;
+	pos = 0;
+	eof = false;
+	data_offset = file->get_position();
+
+	// memory-backed files can hand out everything up front
+	uint64_t remaining = file->get_len() - data_offset;
+	const uint8_t *span = remaining <= 0x7FFFFFFF ? file->get_span(remaining) : NULL;
+	if (span) {
+		data = span;
+		data_size = remaining;
+		spanned = true;
+		return;
+	}
+
+	if (buffer.size() != BUFFER_SIZE) {
+		buffer.resize(BUFFER_SIZE);
+	}
+	data = buffer.ptr();
+	data_size = 0;
+	spanned = false;
+}
+
+void BufferedFileReader::close() {
+
+	file = NULL;
+	data = NULL;
+	data_offset = 0;
+	data_size = 0;
+	pos = 0;
+	spanned = false;
+	eof = false;
+	buffer.clear();
+}
+
+int BufferedFileReader::get_buffer(uint8_t *p_dst, int p_length) {
+
+	ERR_FAIL_COND_V(p_length < 0, -1);
+
+	int left = data_size - pos;
+	if (p_length <= left) {
+		copymem(p_dst, &data[pos], p_length);
+		pos += p_length;
+		return p_length;
+	}
+
+	copymem(p_dst, &data[pos], left);
+	pos = data_size;
+
+	if (!file || spanned || eof) {
+		eof = true;
+		return left;
+	}
+
+	int read = left;
+	if (p_length - left >= BUFFER_SIZE / 2) {
+		// large reads skip the buffer
+		data_offset += data_size;
+		data_size = 0;
+		pos = 0;
+
+		int r = file->get_buffer(&p_dst[read], p_length - read);
+		data_offset += r;
+		read += r;
+	} else {
+		const uint8_t *r = _read(p_length - left);
+		if (r) {
+			copymem(&p_dst[read], r, p_length - left);
+			read = p_length;
+		} else {
+			// take whatever the last refill could still provide
+			int tail = MIN(data_size, p_length - left);
+			copymem(&p_dst[read], data, tail);
+			read += tail;
+		}
+	}
+
+	if (read < p_length) {
+		eof = true;
+	}
+	return read;
+}
+
+const uint8_t *BufferedFileReader::get_span(int p_length) {
+
+	ERR_FAIL_COND_V(p_length < 0, NULL);
+
+	if (!spanned && p_length > BUFFER_SIZE)
+		return NULL;
+
+	return _read(p_length);
+}
+
+void BufferedFileReader::seek(uint64_t p_position) {
+
+	ERR_FAIL_COND(!file);
+
+	eof = false;
+
+	if (p_position >= data_offset && p_position <= data_offset + data_size) {
+		pos = p_position - data_offset;
+		return;
+	}
+
+	// outside of what is loaded, continue buffering from the new position
+	if (buffer.size() != BUFFER_SIZE) {
+		buffer.resize(BUFFER_SIZE);
+	}
+	file->seek(p_position);
+	data = buffer.ptr();
+	data_offset = p_position;
+	data_size = 0;
+	pos = 0;
+	spanned = false;
+}
+
+BufferedFileReader::BufferedFileReader() {
+
+	file = NULL;
+	data = NULL;
+	data_offset = 0;
+	data_size = 0;
+	pos = 0;
+	spanned = false;
+	endian_swap = false;
+	eof = false;
+}
@@ -0,0 +1,144 @@
+/*************************************************************************/
+/*  buffered_file_reader.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BUFFERED_FILE_READER_H
+#define BUFFERED_FILE_READER_H
+
+#include "io/marshalls.h"
+#include "os/file_access.h"
+#include "vector.h"
+
+/**
+ * Sequential reader on top of a FileAccess, for loaders that decode many
+ * small values. Primitive reads are inlined and served from a local buffer
+ * (or straight from memory when the file exposes a span of its contents),
+ * so the virtual FileAccess is only called once per block.
+ * The reader does not own the file, and the file must not be read directly
+ * while the reader is in use.
+ */
+class BufferedFileReader {
+
+	enum {
+		BUFFER_SIZE = 65536
+	};
+
+	FileAccess *file;
+
+	Vector<uint8_t> buffer;
+	const uint8_t *data; // either the buffer or the file span
+	uint64_t data_offset; // file position of data[0]
+	int data_size;
+	int pos;
+
+	bool spanned;
+	bool endian_swap;
+	bool eof;
+
+	const uint8_t *_read_slow(int p_length);
+
+	_FORCE_INLINE_ const uint8_t *_read(int p_length) {
+
+		if (likely(p_length <= data_size - pos)) {
+			const uint8_t *r = &data[pos];
+			pos += p_length;
+			return r;
+		}
+		return _read_slow(p_length);
+	}
+
+public:
+	void open(FileAccess *p_file);
+	void close();
+
+	_FORCE_INLINE_ bool is_open() const { return file != NULL; }
+
+	_FORCE_INLINE_ void set_endian_swap(bool p_swap) { endian_swap = p_swap; }
+	_FORCE_INLINE_ bool get_endian_swap() const { return endian_swap; }
+
+	_FORCE_INLINE_ uint8_t get_8() {
+
+		const uint8_t *r = _read(1);
+		return r ? *r : 0;
+	}
+
+	_FORCE_INLINE_ uint16_t get_16() {
+
+		const uint8_t *r = _read(2);
+		if (!r)
+			return 0;
+		uint16_t v = decode_uint16(r);
+		return endian_swap ? BSWAP16(v) : v;
+	}
+
+	_FORCE_INLINE_ uint32_t get_32() {
+
+		const uint8_t *r = _read(4);
+		if (!r)
+			return 0;
+		uint32_t v = decode_uint32(r);
+		return endian_swap ? BSWAP32(v) : v;
+	}
+
+	_FORCE_INLINE_ uint64_t get_64() {
+
+		const uint8_t *r = _read(8);
+		if (!r)
+			return 0;
+		uint64_t v = decode_uint64(r);
+		return endian_swap ? BSWAP64(v) : v;
+	}
+
+	_FORCE_INLINE_ float get_float() {
+
+		MarshallFloat m;
+		m.i = get_32();
+		return m.f;
+	}
+
+	_FORCE_INLINE_ double get_double() {
+
+		MarshallDouble m;
+		m.l = get_64();
+		return m.d;
+	}
+
+	_FORCE_INLINE_ real_t get_real() { return get_float(); } // files store reals as 32 bits, like FileAccess::get_real()
+
+	int get_buffer(uint8_t *p_dst, int p_length);
+	const uint8_t *get_span(int p_length); ///< pointer to the next p_length bytes (then skipped), NULL if too large to buffer
+
+	void seek(uint64_t p_position);
+	_FORCE_INLINE_ uint64_t get_position() const { return data_offset + pos; }
+	_FORCE_INLINE_ bool eof_reached() const { return eof; }
+
+	BufferedFileReader();
+};
+
+#endif // BUFFERED_FILE_READER_H
@@ -189,3 +189,97 @@ int Compression::gzip_level = Z_DEFAULT_COMPRESSION;
 int Compression::zstd_level = 3;
 bool Compression::zstd_long_distance_matching = false;
 int Compression::zstd_window_log_size = 27;
+
+Error StreamDecompressor::start(Compression::Mode p_mode) {
+
+	ERR_FAIL_COND_V(p_mode != Compression::MODE_DEFLATE && p_mode != Compression::MODE_GZIP, ERR_UNAVAILABLE);
+
+	end();
+
+	int window_bits = p_mode == Compression::MODE_DEFLATE ? 15 : 15 + 16;
+
+	z_stream *strm = memnew(z_stream);
+	strm->zalloc = zipio_alloc;
+	strm->zfree = zipio_free;
+	strm->opaque = Z_NULL;
+	strm->avail_in = 0;
+	strm->next_in = Z_NULL;
+	int err = inflateInit2(strm, window_bits);
+	if (err != Z_OK) {
+		memdelete(strm);
+		ERR_FAIL_V(FAILED);
+	}
+
+	stream = strm;
+	finished = false;
+	total_out = 0;
+	return OK;
+}
+
+Error StreamDecompressor::decompress(const uint8_t *p_src, int p_src_size, PoolVector<uint8_t> &r_dst) {
+
+	ERR_FAIL_COND_V(!stream, ERR_UNCONFIGURED);
+
+	if (finished)
+		return OK; // anything after the end of the stream is ignored
+
+	const int out_step = 16384;
+
+	z_stream *strm = (z_stream *)stream;
+	strm->avail_in = p_src_size;
+	strm->next_in = (Bytef *)p_src;
+
+	while (true) {
+
+		int ofs = r_dst.size();
+		r_dst.resize(ofs + out_step);
+
+		int err;
+		{
+			PoolVector<uint8_t>::Write w = r_dst.write();
+			strm->avail_out = out_step;
+			strm->next_out = &w[ofs];
+			err = inflate(strm, Z_NO_FLUSH);
+		}
+
+		int produced = out_step - strm->avail_out;
+		r_dst.resize(ofs + produced);
+		total_out += produced;
+
+		if (err == Z_STREAM_END) {
+			finished = true;
+			break;
+		}
+
+		if (err != Z_OK && err != Z_BUF_ERROR)
+			return ERR_FILE_CORRUPT;
+
+		if (strm->avail_out != 0)
+			break; // all input consumed
+	}
+
+	return OK;
+}
+
+void StreamDecompressor::end() {
+
+	if (!stream)
+		return;
+
+	z_stream *strm = (z_stream *)stream;
+	inflateEnd(strm);
+	memdelete(strm);
+	stream = NULL;
+}
+
+StreamDecompressor::StreamDecompressor() {
+
+	stream = NULL;
+	finished = false;
+	total_out = 0;
+}
+
+StreamDecompressor::~StreamDecompressor() {
+
+	end();
+}
@@ -31,6 +31,7 @@
 #ifndef COMPRESSION_H
 #define COMPRESSION_H
 
+#include "dvector.h"
 #include "typedefs.h"
 
 class Compression {
@@ -56,4 +57,23 @@ public:
 	Compression();
 };
 
+// Incremental inflate for deflate and gzip data that arrives in pieces, like HTTP bodies
+class StreamDecompressor {
+
+	void *stream;
+	bool finished;
+	uint64_t total_out;
+
+public:
+	Error start(Compression::Mode p_mode);
+	Error decompress(const uint8_t *p_src, int p_src_size, PoolVector<uint8_t> &r_dst); // appends to r_dst
+	void end();
+
+	bool is_finished() const { return finished; }
+	uint64_t get_total_out() const { return total_out; }
+
+	StreamDecompressor();
+	~StreamDecompressor();
+};
+
 #endif // COMPRESSION_H
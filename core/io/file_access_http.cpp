@@ -0,0 +1,784 @@
+/*************************************************************************/
+/*  file_access_http.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_http.h"
+
+#include "os/copymem.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "project_settings.h"
+
+Mutex *FileAccessHTTPStream::streams_mutex = NULL;
+Map<String, FileAccessHTTPStream *> FileAccessHTTPStream::streams;
+
+bool FileAccessHTTPStream::is_url(const String &p_path) {
+
+	return p_path.begins_with("http://") || p_path.begins_with("https://");
+}
+
+Error FileAccessHTTPStream::_connect() {
+
+	if (client->get_status() == HTTPClient::STATUS_CONNECTED)
+		return OK;
+
+	client->close();
+	Error err = client->connect_to_host(host, port, ssl);
+	if (err != OK)
+		return err;
+
+	while (client->get_status() == HTTPClient::STATUS_RESOLVING || client->get_status() == HTTPClient::STATUS_CONNECTING) {
+		client->poll();
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	return client->get_status() == HTTPClient::STATUS_CONNECTED ? OK : ERR_CANT_CONNECT;
+}
+
+Error FileAccessHTTPStream::_request(uint64_t p_from, uint64_t p_to, Vector<uint8_t> &r_body, List<String> *r_headers) {
+
+	Error err = _connect();
+	if (err != OK)
+		return err;
+
+	Vector<String> headers;
+	headers.push_back("Range: bytes=" + itos(p_from) + "-" + itos(p_to));
+
+	err = client->request(HTTPClient::METHOD_GET, request_path, headers);
+	if (err != OK) {
+		client->close();
+		return err;
+	}
+
+	while (client->get_status() == HTTPClient::STATUS_REQUESTING) {
+		client->poll();
+		if (client->get_status() == HTTPClient::STATUS_REQUESTING) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+	}
+
+	if (!client->has_response()) {
+		client->close();
+		return ERR_CONNECTION_ERROR;
+	}
+
+	if (client->get_response_code() != HTTPClient::RESPONSE_PARTIAL_CONTENT) {
+		// a plain 200 means the server ignores ranges, there is no point in reading the whole file
+		ERR_PRINTS("Server did not answer a range request for " + url + " (response code " + itos(client->get_response_code()) + ").");
+		client->close();
+		return ERR_UNAVAILABLE;
+	}
+
+	if (r_headers) {
+		client->get_response_headers(r_headers);
+	}
+
+	r_body.resize(p_to - p_from + 1);
+	uint64_t received = 0;
+
+	while (client->get_status() == HTTPClient::STATUS_BODY) {
+
+		PoolByteArray chunk = client->read_response_body_chunk();
+		if (chunk.size() == 0) {
+			client->poll();
+			continue;
+		}
+
+		if (received + chunk.size() > (uint64_t)r_body.size()) {
+			client->close();
+			return ERR_FILE_CORRUPT;
+		}
+
+		copymem(r_body.ptrw() + received, chunk.read().ptr(), chunk.size());
+		received += chunk.size();
+	}
+
+	if (client->get_status() != HTTPClient::STATUS_CONNECTED && client->get_status() != HTTPClient::STATUS_DISCONNECTED) {
+		client->close();
+		return ERR_CONNECTION_ERROR;
+	}
+
+	r_body.resize(received);
+
+	return OK;
+}
+
+Error FileAccessHTTPStream::_open() {
+
+	// the first page is requested right away, the answer carries the file size and tells whether ranges work at all
+	Vector<uint8_t> first;
+	List<String> headers;
+	Error err = _request(0, page_size - 1, first, &headers);
+	if (err != OK) {
+		client->close();
+		return err;
+	}
+
+	total_size = 0;
+	String etag;
+	String last_modified;
+
+	for (List<String>::Element *E = headers.front(); E; E = E->next()) {
+
+		String header = E->get();
+		int sep = header.find(":");
+		if (sep == -1)
+			continue;
+		String name = header.substr(0, sep).strip_edges().to_lower();
+		String value = header.substr(sep + 1, header.length()).strip_edges();
+
+		if (name == "content-range") {
+			// bytes <from>-<to>/<total>
+			String total = value.get_slice("/", 1);
+			if (total != "*") {
+				total_size = total.to_int64();
+			}
+		} else if (name == "etag") {
+			etag = value;
+		} else if (name == "last-modified") {
+			last_modified = value;
+		}
+	}
+
+	ERR_EXPLAIN("Server did not report the size of " + url);
+	ERR_FAIL_COND_V(total_size == 0, ERR_FILE_CANT_OPEN);
+
+	validator = etag != "" ? etag : last_modified;
+
+	int page_count = ((total_size - 1) / page_size) + 1;
+	pages.resize(page_count);
+
+	_open_disk_cache();
+
+	if (first.size() == MIN((uint64_t)page_size, total_size)) {
+		_save_cached_page(0, first);
+		_set_page(0, first, false);
+	}
+
+	thread = Thread::create(_thread_func, this);
+
+	return OK;
+}
+
+void FileAccessHTTPStream::_open_disk_cache() {
+
+	if (!use_disk_cache)
+		return;
+
+	// absolute, user:// is not final yet while the main pack is opened
+	cache_dir = OS::get_singleton()->get_user_data_dir().plus_file("http_pack_cache").plus_file(url.md5_text());
+
+	// pages can only be trusted while the server reports the same file
+	String info = itos(total_size) + " " + itos(page_size) + " " + validator;
+	String info_path = cache_dir.plus_file("info");
+
+	FileAccess *f = FileAccess::open(info_path, FileAccess::READ);
+	if (f) {
+		bool valid = validator != "" && f->get_line() == info;
+		memdelete(f);
+		if (valid)
+			return;
+	}
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->change_dir(cache_dir) == OK) {
+
+		List<String> files;
+		da->list_dir_begin();
+		String file = da->get_next();
+		while (file != "") {
+			if (!da->current_is_dir()) {
+				files.push_back(file);
+			}
+			file = da->get_next();
+		}
+		da->list_dir_end();
+
+		for (List<String>::Element *E = files.front(); E; E = E->next()) {
+			da->remove(E->get());
+		}
+	} else if (da->make_dir_recursive(cache_dir) != OK) {
+		memdelete(da);
+		use_disk_cache = false;
+		return;
+	}
+	memdelete(da);
+
+	if (validator == "") {
+		// nothing to check the pages against on the next run
+		return;
+	}
+
+	f = FileAccess::open(info_path, FileAccess::WRITE);
+	if (!f) {
+		use_disk_cache = false;
+		return;
+	}
+	f->store_line(info);
+	memdelete(f);
+}
+
+bool FileAccessHTTPStream::_load_cached_page(int p_page, Vector<uint8_t> &r_buffer) {
+
+	if (!use_disk_cache)
+		return false;
+
+	FileAccess *f = FileAccess::open(cache_dir.plus_file(itos(p_page) + ".page"), FileAccess::READ);
+	if (!f)
+		return false;
+
+	int len = MIN((uint64_t)page_size, total_size - uint64_t(p_page) * page_size);
+	bool ok = f->get_len() == (size_t)len;
+	if (ok) {
+		r_buffer.resize(len);
+		ok = f->get_buffer(r_buffer.ptrw(), len) == len;
+	}
+	memdelete(f);
+
+	return ok;
+}
+
+void FileAccessHTTPStream::_save_cached_page(int p_page, const Vector<uint8_t> &p_buffer) {
+
+	if (!use_disk_cache)
+		return;
+
+	FileAccess *f = FileAccess::open(cache_dir.plus_file(itos(p_page) + ".page"), FileAccess::WRITE);
+	if (!f)
+		return;
+
+	f->store_buffer(p_buffer.ptr(), p_buffer.size());
+	memdelete(f);
+}
+
+void FileAccessHTTPStream::_queue_page(int p_page, bool p_urgent) {
+
+	// called with the mutex locked
+	if (p_page < 0 || p_page >= pages.size())
+		return;
+
+	Page &page = pages.write[p_page];
+	if (!page.buffer.empty() || page.loading)
+		return;
+
+	if (page.queued) {
+		// move it ahead of the read-ahead and prefetch requests, the stale entry is skipped later
+		if (p_urgent && (!queue.front() || queue.front()->get() != p_page)) {
+			queue.push_front(p_page);
+			request_sem->post();
+		}
+		return;
+	}
+
+	page.queued = true;
+	if (p_urgent) {
+		queue.push_front(p_page);
+	} else {
+		queue.push_back(p_page);
+	}
+	request_sem->post();
+}
+
+void FileAccessHTTPStream::_set_page(int p_page, const Vector<uint8_t> &p_buffer, bool p_failed) {
+
+	mutex->lock();
+
+	Page &page = pages.write[p_page];
+	page.buffer = p_buffer;
+	page.queued = false;
+	page.loading = false;
+	page.failed = p_failed;
+	page.activity = activity_counter;
+
+	if (!p_failed) {
+		loaded_pages.push_back(p_page);
+		_evict_pages();
+	}
+
+	int wake = waiting;
+	waiting = 0;
+
+	mutex->unlock();
+
+	// readers can wait on different pages, all of them check again
+	for (int i = 0; i < wake; i++) {
+		page_sem->post();
+	}
+}
+
+void FileAccessHTTPStream::_evict_pages() {
+
+	// called with the mutex locked
+	while (loaded_pages.size() > max_pages) {
+
+		int oldest = 0;
+		for (int i = 1; i < loaded_pages.size(); i++) {
+			if (pages[loaded_pages[i]].activity < pages[loaded_pages[oldest]].activity) {
+				oldest = i;
+			}
+		}
+
+		pages.write[loaded_pages[oldest]].buffer = Vector<uint8_t>();
+		loaded_pages.remove(oldest);
+	}
+}
+
+void FileAccessHTTPStream::_thread_func(void *p_userdata) {
+
+	((FileAccessHTTPStream *)p_userdata)->_thread_func();
+}
+
+void FileAccessHTTPStream::_thread_func() {
+
+	while (true) {
+
+		request_sem->wait();
+		if (exit_thread)
+			break;
+
+		mutex->lock();
+
+		int from = -1;
+		while (queue.size()) {
+			int p = queue.front()->get();
+			queue.pop_front();
+			if (pages[p].queued && !pages[p].loading && pages[p].buffer.empty()) {
+				from = p;
+				break;
+			}
+		}
+
+		// consecutive queued pages go in the same request
+		int to = from + 1;
+		if (from != -1) {
+			while (to < pages.size() && to - from < max_request_pages && pages[to].queued && !pages[to].loading && pages[to].buffer.empty()) {
+				to++;
+			}
+			for (int i = from; i < to; i++) {
+				pages.write[i].loading = true;
+			}
+		}
+
+		mutex->unlock();
+
+		if (from == -1)
+			continue;
+
+		Vector<uint8_t> buffer;
+		while (from < to && _load_cached_page(from, buffer)) {
+			_set_page(from, buffer, false);
+			from++;
+		}
+
+		if (from == to)
+			continue;
+
+		uint64_t ofs = uint64_t(from) * page_size;
+		uint64_t end = MIN(uint64_t(to) * page_size, total_size);
+
+		Vector<uint8_t> body;
+		Error err = ERR_CANT_CONNECT;
+		for (int attempt = 0; attempt < 3 && err != OK && !exit_thread; attempt++) {
+			err = _request(ofs, end - 1, body, NULL);
+			if (err == OK && (uint64_t)body.size() != end - ofs) {
+				err = ERR_FILE_CORRUPT;
+			}
+		}
+
+		if (err != OK) {
+			ERR_PRINTS("Failed reading " + url + " at offset " + itos(ofs) + ".");
+		}
+
+		for (int i = from; i < to; i++) {
+
+			if (err != OK) {
+				_set_page(i, Vector<uint8_t>(), true);
+				continue;
+			}
+
+			uint64_t page_ofs = uint64_t(i - from) * page_size;
+			int len = MIN((uint64_t)page_size, end - ofs - page_ofs);
+
+			Vector<uint8_t> page;
+			page.resize(len);
+			copymem(page.ptrw(), body.ptr() + page_ofs, len);
+
+			_save_cached_page(i, page);
+			_set_page(i, page, false);
+		}
+	}
+}
+
+bool FileAccessHTTPStream::get_page(int p_page, Vector<uint8_t> &r_buffer) {
+
+	ERR_FAIL_INDEX_V(p_page, pages.size(), false);
+
+	mutex->lock();
+
+	_queue_page(p_page, true);
+	for (int i = 1; i < read_ahead; i++) {
+		_queue_page(p_page + i, false);
+	}
+
+	while (pages[p_page].buffer.empty() && !pages[p_page].failed) {
+
+		waiting++;
+		mutex->unlock();
+		page_sem->wait();
+		mutex->lock();
+
+		// may have been evicted again before this thread woke up
+		_queue_page(p_page, true);
+	}
+
+	Page &page = pages.write[p_page];
+	bool ok = !page.failed;
+	if (ok) {
+		r_buffer = page.buffer;
+		page.activity = ++activity_counter;
+	} else {
+		page.failed = false; // reported once, the next read tries again
+	}
+
+	mutex->unlock();
+
+	return ok;
+}
+
+void FileAccessHTTPStream::prefetch(uint64_t p_offset, uint64_t p_size) {
+
+	if (p_size == 0 || p_offset >= total_size)
+		return;
+
+	int from = p_offset / page_size;
+	int to = MIN((p_offset + p_size - 1) / page_size, (uint64_t)pages.size() - 1);
+	// never ask for more than can be kept, it would evict what was just fetched
+	to = MIN(to, from + max_pages / 2);
+
+	mutex->lock();
+	for (int i = from; i <= to; i++) {
+		_queue_page(i, false);
+	}
+	mutex->unlock();
+}
+
+FileAccessHTTPStream *FileAccessHTTPStream::open(const String &p_url, Error *r_error) {
+
+	if (!streams_mutex) {
+		// first use is from the main thread, when a pack is added
+		streams_mutex = Mutex::create();
+	}
+
+	MutexLock lock(streams_mutex);
+
+	Map<String, FileAccessHTTPStream *>::Element *E = streams.find(p_url);
+	if (E) {
+		E->get()->refcount++;
+		if (r_error)
+			*r_error = OK;
+		return E->get();
+	}
+
+	FileAccessHTTPStream *stream = memnew(FileAccessHTTPStream(p_url));
+	Error err = stream->_open();
+	if (r_error)
+		*r_error = err;
+
+	if (err != OK) {
+		memdelete(stream);
+		return NULL;
+	}
+
+	streams[p_url] = stream;
+
+	return stream;
+}
+
+void FileAccessHTTPStream::close() {
+
+	MutexLock lock(streams_mutex);
+
+	refcount--;
+	if (refcount == 0) {
+		streams.erase(url);
+		memdelete(this);
+	}
+}
+
+void FileAccessHTTPStream::configure() {
+
+	GLOBAL_DEF("network/http_pack/page_size", 65536);
+	GLOBAL_DEF("network/http_pack/page_read_ahead", 8);
+	GLOBAL_DEF("network/http_pack/max_pages", 512);
+	GLOBAL_DEF("network/http_pack/max_request_pages", 32);
+	GLOBAL_DEF("network/http_pack/use_disk_cache", true);
+}
+
+void FileAccessHTTPStream::finish() {
+
+	ERR_FAIL_COND(streams.size());
+
+	if (streams_mutex) {
+		memdelete(streams_mutex);
+		streams_mutex = NULL;
+	}
+}
+
+FileAccessHTTPStream::FileAccessHTTPStream(const String &p_url) {
+
+	url = p_url;
+	ssl = url.begins_with("https://");
+	port = ssl ? 443 : 80;
+
+	String address = url.substr(ssl ? 8 : 7, url.length());
+	int slash = address.find("/");
+	host = slash == -1 ? address : address.substr(0, slash);
+	request_path = slash == -1 ? String("/") : address.substr(slash, address.length());
+
+	int colon = host.find_last(":");
+	if (colon != -1 && host.find_last("]") < colon) {
+		port = host.substr(colon + 1, host.length()).to_int();
+		host = host.substr(0, colon);
+	}
+
+	// packs can be added before the project settings are loaded, so defaults are defined here too
+	configure();
+	page_size = MAX(4096, int(GLOBAL_GET("network/http_pack/page_size")));
+	read_ahead = MAX(1, int(GLOBAL_GET("network/http_pack/page_read_ahead")));
+	max_pages = MAX(read_ahead * 2, int(GLOBAL_GET("network/http_pack/max_pages")));
+	max_request_pages = MAX(1, int(GLOBAL_GET("network/http_pack/max_request_pages")));
+	use_disk_cache = GLOBAL_GET("network/http_pack/use_disk_cache");
+
+	total_size = 0;
+	activity_counter = 0;
+	waiting = 0;
+	refcount = 1;
+
+	client.instance();
+	client->set_blocking_mode(true);
+
+	thread = NULL;
+	exit_thread = false;
+	mutex = Mutex::create();
+	request_sem = Semaphore::create();
+	page_sem = Semaphore::create();
+}
+
+FileAccessHTTPStream::~FileAccessHTTPStream() {
+
+	if (thread) {
+		exit_thread = true;
+		request_sem->post();
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+	}
+
+	client->close();
+
+	memdelete(mutex);
+	memdelete(request_sem);
+	memdelete(page_sem);
+}
+
+//////////////////////////////////////////////////////////////////
+
+Error FileAccessHTTP::_open(const String &p_path, int p_mode_flags) {
+
+	ERR_FAIL_COND_V(p_mode_flags != READ, ERR_UNAVAILABLE);
+
+	close();
+
+	Error err;
+	stream = FileAccessHTTPStream::open(p_path, &err);
+	if (!stream)
+		return err;
+
+	pos = 0;
+	eof = false;
+	failed = false;
+	current_page = -1;
+
+	return OK;
+}
+
+void FileAccessHTTP::close() {
+
+	if (!stream)
+		return;
+
+	current_buffer = Vector<uint8_t>();
+	current_page = -1;
+	stream->close();
+	stream = NULL;
+}
+
+bool FileAccessHTTP::is_open() const {
+
+	return stream != NULL;
+}
+
+void FileAccessHTTP::seek(size_t p_position) {
+
+	ERR_FAIL_COND(!stream);
+
+	eof = p_position > stream->get_len();
+	pos = MIN(p_position, stream->get_len());
+}
+
+void FileAccessHTTP::seek_end(int64_t p_position) {
+
+	ERR_FAIL_COND(!stream);
+
+	seek(stream->get_len() + p_position);
+}
+
+size_t FileAccessHTTP::get_position() const {
+
+	ERR_FAIL_COND_V(!stream, 0);
+	return pos;
+}
+
+size_t FileAccessHTTP::get_len() const {
+
+	ERR_FAIL_COND_V(!stream, 0);
+	return stream->get_len();
+}
+
+bool FileAccessHTTP::eof_reached() const {
+
+	ERR_FAIL_COND_V(!stream, false);
+	return eof;
+}
+
+uint8_t FileAccessHTTP::get_8() const {
+
+	uint8_t v = 0;
+	get_buffer(&v, 1);
+	return v;
+}
+
+int FileAccessHTTP::get_buffer(uint8_t *p_dst, int p_length) const {
+
+	ERR_FAIL_COND_V(!stream, -1);
+	ERR_FAIL_COND_V(p_length < 0, -1);
+
+	uint64_t len = stream->get_len();
+	if (pos + p_length > len) {
+		eof = true;
+		p_length = len - pos;
+	}
+
+	int page_size = stream->get_page_size();
+	int read = 0;
+
+	while (read < p_length) {
+
+		int page = pos / page_size;
+		if (page != current_page) {
+			if (!stream->get_page(page, current_buffer)) {
+				failed = true;
+				current_page = -1;
+				break;
+			}
+			current_page = page;
+		}
+
+		int ofs = pos - uint64_t(page) * page_size;
+		int count = MIN(p_length - read, current_buffer.size() - ofs);
+		copymem(p_dst + read, current_buffer.ptr() + ofs, count);
+
+		read += count;
+		pos += count;
+	}
+
+	return read;
+}
+
+Error FileAccessHTTP::get_error() const {
+
+	if (failed)
+		return ERR_FILE_CANT_READ;
+
+	return eof ? ERR_FILE_EOF : OK;
+}
+
+void FileAccessHTTP::flush() {
+
+	ERR_FAIL();
+}
+
+void FileAccessHTTP::store_8(uint8_t p_dest) {
+
+	ERR_FAIL();
+}
+
+bool FileAccessHTTP::file_exists(const String &p_path) {
+
+	FileAccessHTTPStream *s = FileAccessHTTPStream::open(p_path);
+	if (!s)
+		return false;
+
+	s->close();
+	return true;
+}
+
+void FileAccessHTTP::prefetch(uint64_t p_offset, uint64_t p_size) {
+
+	ERR_FAIL_COND(!stream);
+	stream->prefetch(p_offset, p_size);
+}
+
+FileAccess *FileAccessHTTP::open_url(const String &p_url, Error *r_error) {
+
+	FileAccessHTTP *f = memnew(FileAccessHTTP);
+	Error err = f->_open(p_url, READ);
+	if (r_error)
+		*r_error = err;
+
+	if (err != OK) {
+		memdelete(f);
+		return NULL;
+	}
+
+	return f;
+}
+
+FileAccessHTTP::FileAccessHTTP() {
+
+	stream = NULL;
+	pos = 0;
+	eof = false;
+	failed = false;
+	current_page = -1;
+}
+
+FileAccessHTTP::~FileAccessHTTP() {
+
+	close();
+}
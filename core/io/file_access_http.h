@@ -0,0 +1,181 @@
+/*************************************************************************/
+/*  file_access_http.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_HTTP_H
+#define FILE_ACCESS_HTTP_H
+
+#include "io/http_client.h"
+#include "list.h"
+#include "map.h"
+#include "os/file_access.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+
+/**
+ * Read-only access to a file on a web server, used to stream packs.
+ *
+ * The file is read in pages fetched with HTTP range requests by one thread
+ * per URL. Consecutive queued pages are merged into a single request. All
+ * handles to the same URL share the pages, which are also kept in user:// (backed
+ * by IndexedDB on HTML5) and reused as long as the server reports the same
+ * size and validator for the file.
+ */
+
+class FileAccessHTTPStream {
+
+	struct Page {
+		Vector<uint8_t> buffer;
+		uint64_t activity;
+		bool queued;
+		bool loading;
+		bool failed;
+		Page() {
+			activity = 0;
+			queued = false;
+			loading = false;
+			failed = false;
+		}
+	};
+
+	String url;
+	String host;
+	String request_path;
+	int port;
+	bool ssl;
+
+	uint64_t total_size;
+	String validator;
+
+	int page_size;
+	int read_ahead;
+	int max_pages;
+	int max_request_pages;
+
+	Vector<Page> pages;
+	Vector<int> loaded_pages;
+	List<int> queue;
+	uint64_t activity_counter;
+
+	String cache_dir;
+	bool use_disk_cache;
+
+	Ref<HTTPClient> client;
+	Thread *thread;
+	volatile bool exit_thread;
+
+	Mutex *mutex;
+	Semaphore *request_sem;
+	Semaphore *page_sem;
+	int waiting;
+
+	int refcount;
+
+	static Mutex *streams_mutex;
+	static Map<String, FileAccessHTTPStream *> streams;
+
+	Error _connect();
+	Error _request(uint64_t p_from, uint64_t p_to, Vector<uint8_t> &r_body, List<String> *r_headers);
+	Error _open();
+
+	void _open_disk_cache();
+	bool _load_cached_page(int p_page, Vector<uint8_t> &r_buffer);
+	void _save_cached_page(int p_page, const Vector<uint8_t> &p_buffer);
+
+	void _queue_page(int p_page, bool p_urgent);
+	void _set_page(int p_page, const Vector<uint8_t> &p_buffer, bool p_failed);
+	void _evict_pages();
+
+	static void _thread_func(void *p_userdata);
+	void _thread_func();
+
+public:
+	static bool is_url(const String &p_path);
+
+	static FileAccessHTTPStream *open(const String &p_url, Error *r_error = NULL);
+	void close();
+
+	_FORCE_INLINE_ uint64_t get_len() const { return total_size; }
+	_FORCE_INLINE_ int get_page_size() const { return page_size; }
+
+	bool get_page(int p_page, Vector<uint8_t> &r_buffer);
+	void prefetch(uint64_t p_offset, uint64_t p_size);
+
+	static void configure();
+	static void finish();
+
+	FileAccessHTTPStream(const String &p_url);
+	~FileAccessHTTPStream();
+};
+
+class FileAccessHTTP : public FileAccess {
+
+	FileAccessHTTPStream *stream;
+
+	mutable size_t pos;
+	mutable bool eof;
+	mutable bool failed;
+
+	mutable int current_page;
+	mutable Vector<uint8_t> current_buffer; // shared with the stream, stays valid if the page is evicted
+
+	virtual Error _open(const String &p_path, int p_mode_flags);
+	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
+
+public:
+	virtual void close();
+	virtual bool is_open() const;
+
+	virtual void seek(size_t p_position);
+	virtual void seek_end(int64_t p_position = 0);
+	virtual size_t get_position() const;
+	virtual size_t get_len() const;
+
+	virtual bool eof_reached() const;
+
+	virtual uint8_t get_8() const;
+	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+
+	virtual Error get_error() const;
+
+	virtual void flush();
+	virtual void store_8(uint8_t p_dest);
+
+	virtual bool file_exists(const String &p_path);
+
+	void prefetch(uint64_t p_offset, uint64_t p_size);
+
+	static FileAccess *open_url(const String &p_url, Error *r_error = NULL);
+
+	FileAccessHTTP();
+	~FileAccessHTTP();
+};
+
+#endif // FILE_ACCESS_HTTP_H
@@ -166,6 +166,19 @@ int FileAccessMemory::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessMemory::get_span(int p_length) const {
+
+	ERR_FAIL_COND_V(!data, NULL);
+
+	if (p_length > length - pos)
+		return NULL;
+
+	const uint8_t *span = &data[pos];
+	pos += p_length;
+
+	return span;
+}
+
 Error FileAccessMemory::get_error() const {
 
 	return pos >= length ? ERR_FILE_EOF : OK;
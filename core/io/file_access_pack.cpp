@@ -29,18 +29,24 @@
 /*************************************************************************/
 
 #include "file_access_pack.h"
+#include "io/compression.h"
+#include "io/file_access_http.h"
+#include "io/marshalls.h"
+#include "os/copymem.h"
+#include "os/worker_thread_pool.h"
 #include "version.h"
 
 #include <stdio.h>
 
-#define PACK_VERSION 1
-
 Error PackedData::add_pack(const String &p_path) {
 
 	for (int i = 0; i < sources.size(); i++) {
 
 		if (sources[i]->try_open_pack(p_path)) {
 
+			if (FileAccessHTTPStream::is_url(p_path)) {
+				remote_packs = true;
+			}
 			return OK;
 		};
 	};
@@ -48,7 +54,7 @@ Error PackedData::add_pack(const String &p_path) {
 	return ERR_FILE_UNRECOGNIZED;
 };
 
-void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src) {
+void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, uint32_t p_flags) {
 
 	PathMD5 pmd5(path.md5_buffer());
 	//printf("adding path %ls, %lli, %lli\n", path.c_str(), pmd5.a, pmd5.b);
@@ -59,6 +65,7 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	pf.pack = pkg_path;
 	pf.offset = ofs;
 	pf.size = size;
+	pf.flags = p_flags;
 	for (int i = 0; i < 16; i++)
 		pf.md5[i] = p_md5[i];
 	pf.src = p_src;
@@ -96,6 +103,18 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	}
 }
 
+void PackedData::prefetch_path(const String &p_path) {
+
+	if (!remote_packs || disabled)
+		return;
+
+	PackedFile *pf = files.getptr(PathMD5(p_path.md5_buffer()));
+	if (!pf || pf->offset == 0)
+		return;
+
+	pf->src->prefetch(pf);
+}
+
 void PackedData::add_pack_source(PackSource *p_source) {
 
 	if (p_source != NULL) {
@@ -111,6 +130,7 @@ PackedData::PackedData() {
 	root = memnew(PackedDir);
 	root->parent = NULL;
 	disabled = false;
+	remote_packs = false;
 
 	add_pack_source(memnew(PackedSourcePCK));
 }
@@ -132,9 +152,18 @@ PackedData::~PackedData() {
 
 //////////////////////////////////////////////////////////////////
 
+FileAccess *PackedSourcePCK::open_pack_file(const String &p_path) {
+
+	if (FileAccessHTTPStream::is_url(p_path)) {
+		return FileAccessHTTP::open_url(p_path);
+	}
+
+	return FileAccess::open(p_path, FileAccess::READ);
+}
+
 bool PackedSourcePCK::try_open_pack(const String &p_path) {
 
-	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	FileAccess *f = open_pack_file(p_path);
 	if (!f)
 		return false;
 
@@ -171,7 +200,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 	uint32_t ver_rev = f->get_32();
 
 	ERR_EXPLAIN("Pack version unsupported: " + itos(version));
-	ERR_FAIL_COND_V(version != PACK_VERSION, false);
+	ERR_FAIL_COND_V(version < 1 || version > PACK_FORMAT_VERSION, false);
 	ERR_EXPLAIN("Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + "." + itos(ver_rev));
 	ERR_FAIL_COND_V(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false);
 
@@ -197,17 +226,131 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		uint64_t size = f->get_64();
 		uint8_t md5[16];
 		f->get_buffer(md5, 16);
-		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
+		uint32_t flags = version >= 2 ? f->get_32() : 0;
+		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this, flags);
 	};
 
+	const uint8_t *data = f->map_read_only();
+	if (data) {
+		MappedPack mp;
+		mp.f = f;
+		mp.data = data;
+		mp.len = f->get_len();
+		mapped_packs[p_path] = mp;
+	} else if (FileAccessHTTPStream::is_url(p_path)) {
+		remote_packs[p_path] = f;
+	} else {
+		memdelete(f);
+	}
+
 	return true;
 };
 
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
 
+	Map<String, MappedPack>::Element *E = mapped_packs.find(p_file->pack);
+	if (E && p_file->offset < E->get().len && ((p_file->flags & PACK_FILE_COMPRESSED) || p_file->offset + p_file->size <= E->get().len)) {
+		return memnew(FileAccessPack(p_path, *p_file, E->get().data + p_file->offset));
+	}
+
 	return memnew(FileAccessPack(p_path, *p_file));
 };
 
+void PackedSourcePCK::prefetch(const PackedData::PackedFile *p_file) {
+
+	Map<String, FileAccess *>::Element *E = remote_packs.find(p_file->pack);
+	if (E) {
+		// compressed files are smaller than their size, reading a bit past them is harmless
+		static_cast<FileAccessHTTP *>(E->get())->prefetch(p_file->offset, p_file->size);
+	}
+}
+
+struct _PackBlockCompression {
+	const uint8_t *src;
+	uint64_t size;
+	Vector<uint8_t> *blocks;
+};
+
+static void _pack_compress_block(void *p_userdata, uint32_t p_index) {
+
+	_PackBlockCompression *bc = (_PackBlockCompression *)p_userdata;
+
+	uint64_t from = uint64_t(p_index) * PackedSourcePCK::COMPRESSION_BLOCK_SIZE;
+	int size = MIN(uint64_t(PackedSourcePCK::COMPRESSION_BLOCK_SIZE), bc->size - from);
+
+	Vector<uint8_t> &block = bc->blocks[p_index];
+	block.resize(Compression::get_max_compressed_buffer_size(size, Compression::MODE_ZSTD));
+	int csize = Compression::compress(block.ptrw(), bc->src + from, size, Compression::MODE_ZSTD);
+
+	if (csize <= 0 || csize >= size) {
+		// not worth it, a block of the uncompressed size is stored raw
+		block.resize(size);
+		copymem(block.ptrw(), bc->src + from, size);
+	} else {
+		block.resize(csize);
+	}
+}
+
+bool PackedSourcePCK::compress_file(const uint8_t *p_data, uint64_t p_size, Vector<uint8_t> &r_compressed) {
+
+	if (p_size == 0)
+		return false;
+
+	uint32_t block_count = (p_size + COMPRESSION_BLOCK_SIZE - 1) / COMPRESSION_BLOCK_SIZE;
+
+	Vector<Vector<uint8_t> > blocks;
+	blocks.resize(block_count);
+
+	_PackBlockCompression bc;
+	bc.src = p_data;
+	bc.size = p_size;
+	bc.blocks = blocks.ptrw();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool) {
+		pool->wait_for_group_task_completion(pool->add_group_task(_pack_compress_block, &bc, block_count));
+	} else {
+		for (uint32_t i = 0; i < block_count; i++) {
+			_pack_compress_block(&bc, i);
+		}
+	}
+
+	uint64_t total = 8 + block_count * 4;
+	for (uint32_t i = 0; i < block_count; i++) {
+		total += blocks[i].size();
+	}
+
+	if (total >= p_size)
+		return false;
+
+	r_compressed.resize(total);
+	uint8_t *w = r_compressed.ptrw();
+
+	encode_uint32(COMPRESSION_BLOCK_SIZE, w);
+	encode_uint32(block_count, w + 4);
+	w += 8;
+	for (uint32_t i = 0; i < block_count; i++) {
+		encode_uint32(blocks[i].size(), w);
+		w += 4;
+	}
+	for (uint32_t i = 0; i < block_count; i++) {
+		copymem(w, blocks[i].ptr(), blocks[i].size());
+		w += blocks[i].size();
+	}
+
+	return true;
+}
+
+PackedSourcePCK::~PackedSourcePCK() {
+
+	for (Map<String, MappedPack>::Element *E = mapped_packs.front(); E; E = E->next()) {
+		memdelete(E->get().f);
+	}
+	for (Map<String, FileAccess *>::Element *E = remote_packs.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -218,12 +361,16 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
-	f->close();
+	if (f)
+		f->close();
+	mapped = NULL;
 }
 
 bool FileAccessPack::is_open() const {
 
-	return f->is_open();
+	if (f)
+		return f->is_open();
+	return mapped != NULL;
 }
 
 void FileAccessPack::seek(size_t p_position) {
@@ -234,7 +381,8 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (f && block_offsets.empty())
+		f->seek(pf.offset + p_position);
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -262,6 +410,19 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (block_offsets.size()) {
+		if (!_cache_block(pos / block_size)) {
+			eof = true;
+			return 0;
+		}
+		uint8_t b = block_cache[pos % block_size];
+		pos++;
+		return b;
+	}
+
+	if (mapped)
+		return mapped[pos++];
+
 	pos++;
 	return f->get_8();
 }
@@ -277,18 +438,164 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
-	pos += p_length;
-
-	if (to_read <= 0)
+	if (to_read <= 0) {
+		pos += p_length;
 		return 0;
-	f->get_buffer(p_dst, to_read);
+	}
+
+	if (block_offsets.size())
+		to_read = _get_compressed_buffer(p_dst, to_read);
+	else if (mapped)
+		copymem(p_dst, mapped + pos, to_read);
+	else
+		f->get_buffer(p_dst, to_read);
+
+	pos += p_length;
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::_read_compressed(int p_from_block, int p_to_block) const {
+
+	if (mapped)
+		return mapped + block_offsets[p_from_block];
+
+	uint64_t len = block_offsets[p_to_block] - block_offsets[p_from_block];
+	if (uint64_t(read_buffer.size()) < len)
+		read_buffer.resize(len);
+
+	f->seek(pf.offset + block_offsets[p_from_block]);
+	if (uint64_t(f->get_buffer(read_buffer.ptrw(), len)) != len)
+		return NULL;
+
+	return read_buffer.ptr();
+}
+
+bool FileAccessPack::_decompress_block(int p_block, const uint8_t *p_src, uint8_t *p_dst) const {
+
+	int csize = block_offsets[p_block + 1] - block_offsets[p_block];
+	int size = MIN(uint64_t(block_size), pf.size - uint64_t(p_block) * block_size);
+
+	if (csize == size) {
+		copymem(p_dst, p_src, size); //stored raw
+		return true;
+	}
+
+	return Compression::decompress(p_dst, size, p_src, csize, Compression::MODE_ZSTD) == size;
+}
+
+bool FileAccessPack::_cache_block(int p_block) const {
+
+	if (cached_block == p_block)
+		return true;
+
+	const uint8_t *src = _read_compressed(p_block, p_block + 1);
+	ERR_FAIL_COND_V(!src, false);
+
+	block_cache.resize(block_size);
+	if (!_decompress_block(p_block, src, block_cache.ptrw())) {
+		cached_block = -1;
+		ERR_EXPLAIN("Corrupt compressed block in pack-referenced file: " + String(pf.pack));
+		ERR_FAIL_V(false);
+	}
+
+	cached_block = p_block;
+	return true;
+}
+
+void FileAccessPack::_decompress_block_task(void *p_userdata, uint32_t p_index) {
+
+	BlockDecompression *bd = (BlockDecompression *)p_userdata;
+	const FileAccessPack *pack = bd->pack;
+
+	int block = bd->first_block + p_index;
+	const uint8_t *src = bd->src + (pack->block_offsets[block] - pack->block_offsets[bd->first_block]);
+
+	if (!pack->_decompress_block(block, src, bd->dst + uint64_t(p_index) * pack->block_size)) {
+		bd->failed = true;
+	}
+}
+
+int FileAccessPack::_get_compressed_buffer(uint8_t *p_dst, int p_length) const {
+
+	int block_count = block_offsets.size() - 1;
+	uint64_t from = pos;
+	uint64_t end = pos + p_length;
+	uint8_t *w = p_dst;
+
+	while (from < end) {
+
+		int block = from / block_size;
+		uint64_t block_begin = uint64_t(block) * block_size;
+
+		// whole blocks are decompressed straight into the destination, in parallel when there are several
+		int to_block = block;
+		if (from == block_begin) {
+			while (to_block < block_count && MIN(uint64_t(to_block + 1) * block_size, pf.size) <= end) {
+				to_block++;
+			}
+		}
+
+		if (to_block > block) {
+
+			const uint8_t *src = _read_compressed(block, to_block);
+			ERR_FAIL_COND_V(!src, w - p_dst);
+
+			BlockDecompression bd;
+			bd.pack = this;
+			bd.src = src;
+			bd.dst = w;
+			bd.first_block = block;
+			bd.failed = false;
+
+			WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+			if (to_block - block > 1 && pool && pool->get_thread_count()) {
+				pool->wait_for_group_task_completion(pool->add_group_task(_decompress_block_task, &bd, to_block - block, WorkerThreadPool::PRIORITY_HIGH));
+			} else {
+				for (int i = 0; i < to_block - block; i++) {
+					_decompress_block_task(&bd, i);
+				}
+			}
+
+			if (bd.failed) {
+				ERR_EXPLAIN("Corrupt compressed block in pack-referenced file: " + String(pf.pack));
+				ERR_FAIL_V(w - p_dst);
+			}
+
+			uint64_t to = MIN(uint64_t(to_block) * block_size, pf.size);
+			w += to - from;
+			from = to;
+
+		} else {
+
+			if (!_cache_block(block))
+				return w - p_dst;
+
+			uint64_t to = MIN(block_begin + block_size, end);
+			copymem(w, block_cache.ptr() + (from - block_begin), to - from);
+			w += to - from;
+			from = to;
+		}
+	}
+
+	return p_length;
+}
+
+const uint8_t *FileAccessPack::get_span(int p_length) const {
+
+	if (!mapped || block_offsets.size() || eof || p_length < 0 || pos > pf.size || uint64_t(p_length) > pf.size - pos)
+		return NULL;
+
+	const uint8_t *span = mapped + pos;
+	pos += p_length;
+
+	return span;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f)
+		f->set_endian_swap(p_swap);
 }
 
 Error FileAccessPack::get_error() const {
@@ -318,16 +625,48 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
-	if (!f) {
-		ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
-		ERR_FAIL_COND(!f);
-	}
-	f->seek(pf.offset);
+		f(NULL),
+		mapped(p_mapped) {
 	pos = 0;
 	eof = false;
+	block_size = 0;
+	cached_block = -1;
+
+	if (!mapped) {
+		f = PackedSourcePCK::open_pack_file(pf.pack);
+		if (!f) {
+			ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
+			ERR_FAIL_COND(!f);
+		}
+		f->seek(pf.offset);
+	}
+
+	if (!(pf.flags & PACK_FILE_COMPRESSED))
+		return;
+
+	uint32_t block_count;
+	if (mapped) {
+		block_size = decode_uint32(mapped);
+		block_count = decode_uint32(mapped + 4);
+	} else {
+		block_size = f->get_32();
+		block_count = f->get_32();
+	}
+
+	if (block_size == 0 || block_count != (pf.size + block_size - 1) / block_size) {
+		ERR_EXPLAIN("Invalid compressed file header in pack: " + String(pf.pack));
+		ERR_FAIL();
+	}
+
+	block_offsets.resize(block_count + 1);
+	uint64_t ofs = 8 + block_count * 4;
+	for (uint32_t i = 0; i < block_count; i++) {
+		block_offsets.write[i] = ofs;
+		ofs += mapped ? decode_uint32(mapped + 8 + i * 4) : f->get_32();
+	}
+	block_offsets.write[block_count] = ofs;
 }
 
 FileAccessPack::~FileAccessPack() {
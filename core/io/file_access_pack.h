@@ -31,12 +31,23 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "hash_map.h"
 #include "list.h"
 #include "map.h"
 #include "os/dir_access.h"
 #include "os/file_access.h"
 #include "print_string.h"
 
+// Version 2 adds a flags field to every directory entry. Compressed files
+// start with a block table (block size, block count, compressed size of every
+// block) followed by the zstd compressed blocks, so they can be seeked and
+// decompressed in parallel.
+#define PACK_FORMAT_VERSION 2
+
+enum PackFileFlags {
+	PACK_FILE_COMPRESSED = 1
+};
+
 class PackSource;
 
 class PackedData {
@@ -49,7 +60,8 @@ public:
 
 		String pack;
 		uint64_t offset; //if offset is ZERO, the file was ERASED
-		uint64_t size;
+		uint64_t size; // uncompressed
+		uint32_t flags;
 		uint8_t md5[16];
 		PackSource *src;
 	};
@@ -88,7 +100,12 @@ private:
 		};
 	};
 
-	Map<PathMD5, PackedFile> files;
+	struct PathMD5Hasher {
+		// already a hash of the path
+		static _FORCE_INLINE_ uint32_t hash(const PathMD5 &p_md5) { return uint32_t(p_md5.a); }
+	};
+
+	HashMap<PathMD5, PackedFile, PathMD5Hasher> files;
 
 	Vector<PackSource *> sources;
 
@@ -97,12 +114,13 @@ private:
 
 	static PackedData *singleton;
 	bool disabled;
+	bool remote_packs;
 
 	void _free_packed_dirs(PackedDir *p_dir);
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
+	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, uint32_t p_flags = 0); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -110,6 +128,10 @@ public:
 	static PackedData *get_singleton() { return singleton; }
 	Error add_pack(const String &p_path);
 
+	// packs read over HTTP can be asked to fetch files that will be needed soon
+	_FORCE_INLINE_ bool has_remote_packs() const { return remote_packs; }
+	void prefetch_path(const String &p_path);
+
 	_FORCE_INLINE_ FileAccess *try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
 
@@ -122,14 +144,35 @@ class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path) = 0;
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file) = 0;
+	virtual void prefetch(const PackedData::PackedFile *p_file) {}
 	virtual ~PackSource() {}
 };
 
 class PackedSourcePCK : public PackSource {
 
+	// packs stay mapped for the lifetime of the source, so files can be read without syscalls
+	struct MappedPack {
+		FileAccess *f;
+		const uint8_t *data;
+		uint64_t len;
+	};
+
+	Map<String, MappedPack> mapped_packs;
+	Map<String, FileAccess *> remote_packs; // kept open so their pages stay cached between files
+
 public:
+	enum {
+		COMPRESSION_BLOCK_SIZE = 65536
+	};
+
 	virtual bool try_open_pack(const String &p_path);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+	virtual void prefetch(const PackedData::PackedFile *p_file);
+
+	static FileAccess *open_pack_file(const String &p_path);
+	static bool compress_file(const uint8_t *p_data, uint64_t p_size, Vector<uint8_t> &r_compressed);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -140,6 +183,30 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *mapped; // start of the file inside the mapped pack, reads are served from it when set
+
+	// compressed files
+	uint32_t block_size;
+	Vector<uint64_t> block_offsets; // relative to the file offset, one extra entry marks the end
+	mutable Vector<uint8_t> block_cache;
+	mutable int cached_block;
+	mutable Vector<uint8_t> read_buffer;
+
+	struct BlockDecompression {
+		const FileAccessPack *pack;
+		const uint8_t *src; // compressed data of first_block onwards
+		uint8_t *dst;
+		int first_block;
+		volatile bool failed;
+	};
+
+	static void _decompress_block_task(void *p_userdata, uint32_t p_index);
+
+	const uint8_t *_read_compressed(int p_from_block, int p_to_block) const;
+	bool _decompress_block(int p_block, const uint8_t *p_src, uint8_t *p_dst) const;
+	bool _cache_block(int p_block) const;
+	int _get_compressed_buffer(uint8_t *p_dst, int p_length) const;
+
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 
@@ -157,6 +224,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_span(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -169,7 +237,7 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped = NULL);
 	~FileAccessPack();
 };
 
@@ -177,13 +245,13 @@ FileAccess *PackedData::try_open_path(const String &p_path) {
 
 	//print_line("try open path " + p_path);
 	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E)
+	PackedFile *pf = files.getptr(pmd5);
+	if (!pf)
 		return NULL; //not found
-	if (E->get().offset == 0)
+	if (pf->offset == 0)
 		return NULL; //was erased
 
-	return E->get().src->get_file(p_path, &E->get());
+	return pf->src->get_file(p_path, pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
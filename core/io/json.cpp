@@ -29,20 +29,9 @@
 /*************************************************************************/
 
 #include "json.h"
-#include "print_string.h"
 
-const char *JSON::tk_name[TK_MAX] = {
-	"'{'",
-	"'}'",
-	"'['",
-	"']'",
-	"identifier",
-	"string",
-	"number",
-	"':'",
-	"','",
-	"EOF",
-};
+#include "os/copymem.h"
+#include "print_string.h"
 
 static String _make_indent(const String &p_indent, int p_size) {
 
@@ -122,206 +111,348 @@ String JSON::print(const Variant &p_var, const String &p_indent, bool p_sort_key
 	return _print_var(p_var, p_indent, 0, p_sort_keys);
 }
 
-Error JSON::_get_token(const CharType *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
+Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+
+	CharString utf8 = p_json.utf8();
+	return parse_utf8((const uint8_t *)utf8.get_data(), utf8.length(), r_ret, r_err_str, r_err_line);
+}
 
-	while (p_len > 0) {
-		switch (p_str[index]) {
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
 
-			case '\n': {
+	JSONParser parser;
+	Error err = parser.feed(p_utf8, p_len);
+	if (err == OK) {
+		err = parser.finish();
+	}
 
-				line++;
-				index++;
-				break;
-			};
-			case 0: {
-				r_token.type = TK_EOF;
-				return OK;
-			} break;
-			case '{': {
-
-				r_token.type = TK_CURLY_BRACKET_OPEN;
-				index++;
-				return OK;
-			};
-			case '}': {
-
-				r_token.type = TK_CURLY_BRACKET_CLOSE;
-				index++;
-				return OK;
-			};
-			case '[': {
-
-				r_token.type = TK_BRACKET_OPEN;
-				index++;
-				return OK;
-			};
-			case ']': {
-
-				r_token.type = TK_BRACKET_CLOSE;
-				index++;
-				return OK;
-			};
-			case ':': {
-
-				r_token.type = TK_COLON;
-				index++;
-				return OK;
-			};
-			case ',': {
-
-				r_token.type = TK_COMMA;
-				index++;
-				return OK;
-			};
-			case '"': {
-
-				index++;
-				String str;
-				while (true) {
-					if (p_str[index] == 0) {
-						r_err_str = "Unterminated String";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[index] == '"') {
-						index++;
+	r_err_line = parser.get_error_line();
+	if (err != OK) {
+		r_err_str = parser.get_error_string();
+		return err;
+	}
+
+	r_ret = parser.get_result();
+	return OK;
+}
+
+const char *JSONParser::tk_name[TK_MAX] = {
+	"'{'",
+	"'}'",
+	"'['",
+	"']'",
+	"identifier",
+	"string",
+	"number",
+	"':'",
+	"','",
+	"EOF",
+};
+
+// Checks eight bytes at once for anything that ends the plain part of a string:
+// a quote, a backslash or a control character.
+static _FORCE_INLINE_ bool _has_string_special(uint64_t p_word) {
+
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t highs = 0x8080808080808080ULL;
+
+	uint64_t quote = p_word ^ (ones * '"');
+	uint64_t backslash = p_word ^ (ones * '\\');
+
+	return (((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) | ((p_word - ones * 0x20) & ~p_word)) & highs;
+}
+
+static _FORCE_INLINE_ bool _is_number_char(uint8_t c) {
+
+	return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+static _FORCE_INLINE_ bool _is_identifier_char(uint8_t c) {
+
+	return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+JSONParser::TokenResult JSONParser::_get_token(const uint8_t *p_data, int p_len, int &r_pos, bool p_final, Token &r_token) {
+
+	int pos = r_pos;
+
+	// whitespace is consumed even if the token after it is incomplete
+	while (pos < p_len && p_data[pos] != 0 && p_data[pos] <= 32) {
+		if (p_data[pos] == '\n')
+			line++;
+		pos++;
+	}
+	r_pos = pos;
+
+	if (pos == p_len) {
+		if (!p_final)
+			return TOKEN_INCOMPLETE;
+		r_token.type = TK_EOF;
+		return TOKEN_OK;
+	}
+
+	switch (p_data[pos]) {
+
+		case 0: {
+			r_token.type = TK_EOF;
+			return TOKEN_OK;
+		} break;
+		case '{': {
+
+			r_token.type = TK_CURLY_BRACKET_OPEN;
+			r_pos++;
+			return TOKEN_OK;
+		};
+		case '}': {
+
+			r_token.type = TK_CURLY_BRACKET_CLOSE;
+			r_pos++;
+			return TOKEN_OK;
+		};
+		case '[': {
+
+			r_token.type = TK_BRACKET_OPEN;
+			r_pos++;
+			return TOKEN_OK;
+		};
+		case ']': {
+
+			r_token.type = TK_BRACKET_CLOSE;
+			r_pos++;
+			return TOKEN_OK;
+		};
+		case ':': {
+
+			r_token.type = TK_COLON;
+			r_pos++;
+			return TOKEN_OK;
+		};
+		case ',': {
+
+			r_token.type = TK_COMMA;
+			r_pos++;
+			return TOKEN_OK;
+		};
+		case '"': {
+
+			pos++;
+			int lines = 0;
+			int segment = pos;
+			String str;
+
+			while (true) {
+
+				// skip plain characters a word at a time, they are decoded as one segment
+				while (pos + 8 <= p_len) {
+					uint64_t word;
+					memcpy(&word, &p_data[pos], 8);
+					if (_has_string_special(word))
 						break;
-					} else if (p_str[index] == '\\') {
-						//escaped characters...
-						index++;
-						CharType next = p_str[index];
-						if (next == 0) {
-							r_err_str = "Unterminated String";
-							return ERR_PARSE_ERROR;
-						}
-						CharType res = 0;
-
-						switch (next) {
-
-							case 'b': res = 8; break;
-							case 't': res = 9; break;
-							case 'n': res = 10; break;
-							case 'f': res = 12; break;
-							case 'r': res = 13; break;
-							case 'u': {
-								//hexnumbarh - oct is deprecated
-
-								for (int j = 0; j < 4; j++) {
-									CharType c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated String";
-										return ERR_PARSE_ERROR;
-									}
-									if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									CharType v;
-									if (c >= '0' && c <= '9') {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("BUG");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
-								}
-								index += 4; //will add at the end anyway
-
-							} break;
-							//case '\"': res='\"'; break;
-							//case '\\': res='\\'; break;
-							//case '/': res='/'; break;
-							default: {
-								res = next;
-								//r_err_str="Invalid escape sequence";
-								//return ERR_PARSE_ERROR;
-							} break;
-						}
+					pos += 8;
+				}
 
-						str += res;
+				while (pos < p_len && p_data[pos] >= 0x20 && p_data[pos] != '"' && p_data[pos] != '\\') {
+					pos++;
+				}
 
-					} else {
-						if (p_str[index] == '\n')
-							line++;
-						str += p_str[index];
-					}
-					index++;
+				if (pos == p_len) {
+					if (!p_final)
+						return TOKEN_INCOMPLETE;
+					_set_error("Unterminated String");
+					return TOKEN_ERROR;
 				}
 
-				r_token.type = TK_STRING;
-				r_token.value = str;
-				return OK;
+				uint8_t c = p_data[pos];
+				if (c == 0) {
+					_set_error("Unterminated String");
+					return TOKEN_ERROR;
+				}
 
-			} break;
-			default: {
+				if (c == '"' && segment == r_pos + 1) {
+					// no escapes, the common case
+					str.parse_utf8((const char *)&p_data[segment], pos - segment);
+					pos++;
+					break;
+				}
+
+				if (pos > segment) {
+					String part;
+					part.parse_utf8((const char *)&p_data[segment], pos - segment);
+					str += part;
+				}
 
-				if (p_str[index] <= 32) {
-					index++;
+				if (c == '"') {
+					pos++;
 					break;
 				}
 
-				if (p_str[index] == '-' || (p_str[index] >= '0' && p_str[index] <= '9')) {
-					//a number
-					const CharType *rptr;
-					double number = String::to_double(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
-					r_token.type = TK_NUMBER;
-					r_token.value = number;
-					return OK;
+				if (c != '\\') {
+					// control characters are kept as they are
+					if (c == '\n')
+						lines++;
+					str += CharType(c);
+					pos++;
+					segment = pos;
+					continue;
+				}
+
+				//escaped characters...
+				pos++;
+				if (pos == p_len) {
+					if (!p_final)
+						return TOKEN_INCOMPLETE;
+					_set_error("Unterminated String");
+					return TOKEN_ERROR;
+				}
+
+				uint8_t next = p_data[pos];
+				if (next == 0) {
+					_set_error("Unterminated String");
+					return TOKEN_ERROR;
+				}
+				CharType res = 0;
+
+				switch (next) {
+
+					case 'b': res = 8; break;
+					case 't': res = 9; break;
+					case 'n': res = 10; break;
+					case 'f': res = 12; break;
+					case 'r': res = 13; break;
+					case 'u': {
+						//hexnumbarh - oct is deprecated
+
+						for (int j = 0; j < 4; j++) {
+							if (pos + j + 1 >= p_len) {
+								if (!p_final)
+									return TOKEN_INCOMPLETE;
+								_set_error("Unterminated String");
+								return TOKEN_ERROR;
+							}
+							uint8_t h = p_data[pos + j + 1];
+							if (h == 0) {
+								_set_error("Unterminated String");
+								return TOKEN_ERROR;
+							}
+							CharType v;
+							if (h >= '0' && h <= '9') {
+								v = h - '0';
+							} else if (h >= 'a' && h <= 'f') {
+								v = h - 'a';
+								v += 10;
+							} else if (h >= 'A' && h <= 'F') {
+								v = h - 'A';
+								v += 10;
+							} else {
+								_set_error("Malformed hex constant in string");
+								return TOKEN_ERROR;
+							}
+
+							res <<= 4;
+							res |= v;
+						}
+						pos += 4; //will add at the end anyway
 
-				} else if ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
+					} break;
+					default: {
+						res = next;
+					} break;
+				}
+
+				str += res;
+				pos++;
+				segment = pos;
+			}
 
-					String id;
+			line += lines;
+			r_pos = pos;
+			r_token.type = TK_STRING;
+			r_token.value = str;
+			return TOKEN_OK;
 
-					while ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
+		} break;
+		default: {
 
-						id += p_str[index];
-						index++;
-					}
+			uint8_t c = p_data[pos];
 
-					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
-					return OK;
+			if (c == '-' || (c >= '0' && c <= '9')) {
+				//a number
+				while (pos < p_len && _is_number_char(p_data[pos])) {
+					pos++;
+				}
+				if (pos == p_len && !p_final)
+					return TOKEN_INCOMPLETE;
+
+				int len = pos - r_pos;
+				char buf[64];
+				double number;
+				if (len < (int)sizeof(buf)) {
+					memcpy(buf, &p_data[r_pos], len);
+					buf[len] = 0;
+					number = String::to_double(buf);
 				} else {
-					r_err_str = "Unexpected character.";
-					return ERR_PARSE_ERROR;
+					String num;
+					num.parse_utf8((const char *)&p_data[r_pos], len);
+					number = num.to_double();
+				}
+
+				r_pos = pos;
+				r_token.type = TK_NUMBER;
+				r_token.value = number;
+				return TOKEN_OK;
+
+			} else if (_is_identifier_char(c)) {
+
+				while (pos < p_len && _is_identifier_char(p_data[pos])) {
+					pos++;
 				}
+				if (pos == p_len && !p_final)
+					return TOKEN_INCOMPLETE;
+
+				String id;
+				id.parse_utf8((const char *)&p_data[r_pos], pos - r_pos);
+
+				r_pos = pos;
+				r_token.type = TK_IDENTIFIER;
+				r_token.value = id;
+				return TOKEN_OK;
+			} else {
+				_set_error("Unexpected character.");
+				return TOKEN_ERROR;
 			}
 		}
 	}
 
-	return ERR_PARSE_ERROR;
+	return TOKEN_ERROR;
 }
 
-Error JSON::_parse_value(Variant &value, Token &token, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSONParser::_set_error(const String &p_error) {
 
-	if (token.type == TK_CURLY_BRACKET_OPEN) {
+	error = ERR_PARSE_ERROR;
+	error_string = p_error;
+	return error;
+}
 
-		Dictionary d;
-		Error err = _parse_object(d, p_str, index, p_len, line, r_err_str);
-		if (err)
-			return err;
-		value = d;
-		return OK;
-	} else if (token.type == TK_BRACKET_OPEN) {
+Error JSONParser::_add_value(const Token &p_token) {
 
-		Array a;
-		Error err = _parse_array(a, p_str, index, p_len, line, r_err_str);
-		if (err)
-			return err;
-		value = a;
-		return OK;
+	Variant value;
+	Frame frame;
+	bool push = false;
+
+	if (p_token.type == TK_CURLY_BRACKET_OPEN) {
+
+		frame.object = true;
+		frame.expecting = EXPECT_OBJECT_KEY;
+		value = frame.dictionary;
+		push = true;
+	} else if (p_token.type == TK_BRACKET_OPEN) {
 
-	} else if (token.type == TK_IDENTIFIER) {
+		frame.object = false;
+		frame.expecting = EXPECT_VALUE;
+		value = frame.array;
+		push = true;
+	} else if (p_token.type == TK_IDENTIFIER) {
 
-		String id = token.value;
+		String id = p_token.value;
 		if (id == "true")
 			value = true;
 		else if (id == "false")
@@ -329,148 +460,183 @@ Error JSON::_parse_value(Variant &value, Token &token, const CharType *p_str, in
 		else if (id == "null")
 			value = Variant();
 		else {
-			r_err_str = "Expected 'true','false' or 'null', got '" + id + "'.";
-			return ERR_PARSE_ERROR;
+			return _set_error("Expected 'true','false' or 'null', got '" + id + "'.");
 		}
-		return OK;
+	} else if (p_token.type == TK_NUMBER || p_token.type == TK_STRING) {
 
-	} else if (token.type == TK_NUMBER) {
-
-		value = token.value;
-		return OK;
-	} else if (token.type == TK_STRING) {
+		value = p_token.value;
+	} else {
+		return _set_error("Expected value, got " + String(tk_name[p_token.type]) + ".");
+	}
 
-		value = token.value;
-		return OK;
+	// containers are shared, so they can be filled after being added to their parent
+	if (stack.empty()) {
+		result = value;
+		done = !push;
 	} else {
-		r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
-		return ERR_PARSE_ERROR;
+		Frame &parent = stack.write[stack.size() - 1];
+		if (parent.object) {
+			parent.dictionary[parent.key] = value;
+		} else {
+			parent.array.push_back(value);
+		}
+		parent.expecting = EXPECT_COMMA;
 	}
 
-	return ERR_PARSE_ERROR;
-}
+	if (push) {
+		stack.push_back(frame);
+	}
 
-Error JSON::_parse_array(Array &array, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+	return OK;
+}
 
-	Token token;
-	bool need_comma = false;
+Error JSONParser::_process_token(const Token &p_token) {
 
-	while (index < p_len) {
+	if (stack.empty()) {
+		return _add_value(p_token);
+	}
 
-		Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-		if (err != OK)
-			return err;
+	Frame &frame = stack.write[stack.size() - 1];
+	TokenType close = frame.object ? TK_CURLY_BRACKET_CLOSE : TK_BRACKET_CLOSE;
 
-		if (token.type == TK_BRACKET_CLOSE) {
+	switch (frame.expecting) {
 
-			return OK;
-		}
+		case EXPECT_VALUE: {
 
-		if (need_comma) {
+			// a trailing comma before the closing bracket is accepted
+			if (p_token.type == TK_BRACKET_CLOSE)
+				break;
+			return _add_value(p_token);
+		} break;
+		case EXPECT_OBJECT_KEY: {
 
-			if (token.type != TK_COMMA) {
+			if (p_token.type == TK_CURLY_BRACKET_CLOSE)
+				break;
+			if (p_token.type != TK_STRING)
+				return _set_error("Expected key");
+			frame.key = p_token.value;
+			frame.expecting = EXPECT_COLON;
+			return OK;
+		} break;
+		case EXPECT_COLON: {
 
-				r_err_str = "Expected ','";
-				return ERR_PARSE_ERROR;
-			} else {
-				need_comma = false;
-				continue;
-			}
-		}
+			if (p_token.type != TK_COLON)
+				return _set_error("Expected ':'");
+			frame.expecting = EXPECT_OBJECT_VALUE;
+			return OK;
+		} break;
+		case EXPECT_OBJECT_VALUE: {
 
-		Variant v;
-		err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
-		if (err)
-			return err;
+			return _add_value(p_token);
+		} break;
+		case EXPECT_COMMA: {
 
-		array.push_back(v);
-		need_comma = true;
+			if (p_token.type == close)
+				break;
+			if (p_token.type != TK_COMMA)
+				return _set_error(frame.object ? "Expected '}' or ','" : "Expected ','");
+			frame.expecting = frame.object ? EXPECT_OBJECT_KEY : EXPECT_VALUE;
+			return OK;
+		} break;
 	}
 
-	return ERR_PARSE_ERROR;
+	// container closed
+	stack.resize(stack.size() - 1);
+	if (stack.empty()) {
+		done = true;
+	}
+	return OK;
 }
 
-Error JSON::_parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSONParser::_parse(const uint8_t *p_data, int p_len, int &r_pos, bool p_final) {
 
-	bool at_key = true;
-	String key;
 	Token token;
-	bool need_comma = false;
 
-	while (index < p_len) {
+	// anything after the first complete value is ignored
+	while (!done) {
 
-		if (at_key) {
+		TokenResult res = _get_token(p_data, p_len, r_pos, p_final, token);
+		if (res == TOKEN_INCOMPLETE)
+			return OK;
+		if (res == TOKEN_ERROR)
+			return error;
 
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
+		Error err = _process_token(token);
+		if (err != OK)
+			return err;
 
-			if (token.type == TK_CURLY_BRACKET_CLOSE) {
+		if (token.type == TK_EOF)
+			break;
+	}
 
-				return OK;
-			}
+	return OK;
+}
 
-			if (need_comma) {
+Error JSONParser::feed(const uint8_t *p_data, int p_len) {
 
-				if (token.type != TK_COMMA) {
+	if (error != OK || done)
+		return error;
 
-					r_err_str = "Expected '}' or ','";
-					return ERR_PARSE_ERROR;
-				} else {
-					need_comma = false;
-					continue;
-				}
-			}
+	int pos = 0;
 
-			if (token.type != TK_STRING) {
+	if (pending.empty()) {
 
-				r_err_str = "Expected key";
-				return ERR_PARSE_ERROR;
-			}
+		Error err = _parse(p_data, p_len, pos, false);
+		if (err != OK)
+			return err;
+
+		// keep the unfinished token for the next chunk
+		if (!done && pos < p_len) {
+			pending.resize(p_len - pos);
+			copymem(pending.ptrw(), &p_data[pos], p_len - pos);
+		}
+	} else {
 
-			key = token.value;
-			err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
-			if (token.type != TK_COLON) {
+		int from = pending.size();
+		pending.resize(from + p_len);
+		copymem(pending.ptrw() + from, p_data, p_len);
 
-				r_err_str = "Expected ':'";
-				return ERR_PARSE_ERROR;
-			}
-			at_key = false;
-		} else {
+		Error err = _parse(pending.ptr(), pending.size(), pos, false);
+		if (err != OK)
+			return err;
 
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
-
-			Variant v;
-			err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
-			if (err)
-				return err;
-			object[key] = v;
-			need_comma = true;
-			at_key = true;
+		if (done || pos == pending.size()) {
+			pending.clear();
+		} else if (pos > 0) {
+			int left = pending.size() - pos;
+			movemem(pending.ptrw(), pending.ptr() + pos, left);
+			pending.resize(left);
 		}
 	}
 
-	return ERR_PARSE_ERROR;
+	return OK;
 }
 
-Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+Error JSONParser::finish() {
 
-	const CharType *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
-	Token token;
-	r_err_line = 0;
-	String aux_key;
+	if (error != OK || done)
+		return error;
 
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
-	if (err)
-		return err;
+	int pos = 0;
+	Error err = _parse(pending.ptr(), pending.size(), pos, true);
+	pending.clear();
+	return err;
+}
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, r_err_str);
+void JSONParser::clear() {
 
-	return err;
+	pending.clear();
+	stack.clear();
+	result = Variant();
+	done = false;
+	error = OK;
+	error_string = String();
+	line = 0;
+}
+
+JSONParser::JSONParser() {
+
+	done = false;
+	error = OK;
+	line = 0;
 }
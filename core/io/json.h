@@ -35,6 +35,24 @@
 
 class JSON {
 
+	static String _print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys);
+
+public:
+	static String print(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
+	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
+};
+
+/**
+ * Incremental JSON parser working on UTF-8 bytes.
+ *
+ * Input can be fed in chunks of any size, a token split between chunks is
+ * kept until the rest of it arrives. Arrays and dictionaries are built in
+ * place as the tokens come in, so no intermediate representation is kept.
+ */
+
+class JSONParser {
+
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
 		TK_CURLY_BRACKET_CLOSE,
@@ -49,12 +67,18 @@ class JSON {
 		TK_MAX
 	};
 
-	enum Expecting {
+	enum TokenResult {
+		TOKEN_OK,
+		TOKEN_INCOMPLETE,
+		TOKEN_ERROR,
+	};
 
-		EXPECT_OBJECT,
+	enum Expecting {
+		EXPECT_VALUE,
 		EXPECT_OBJECT_KEY,
 		EXPECT_COLON,
 		EXPECT_OBJECT_VALUE,
+		EXPECT_COMMA,
 	};
 
 	struct Token {
@@ -63,18 +87,45 @@ class JSON {
 		Variant value;
 	};
 
+	struct Frame {
+
+		bool object;
+		Expecting expecting;
+		Array array;
+		Dictionary dictionary;
+		String key;
+	};
+
 	static const char *tk_name[TK_MAX];
 
-	static String _print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys);
+	Vector<uint8_t> pending;
+	Vector<Frame> stack;
+	Variant result;
+	bool done;
+
+	Error error;
+	String error_string;
+	int line;
 
-	static Error _get_token(const CharType *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_array(Array &array, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
+	TokenResult _get_token(const uint8_t *p_data, int p_len, int &r_pos, bool p_final, Token &r_token);
+	Error _process_token(const Token &p_token);
+	Error _add_value(const Token &p_token);
+	Error _parse(const uint8_t *p_data, int p_len, int &r_pos, bool p_final);
+	Error _set_error(const String &p_error);
 
 public:
-	static String print(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
-	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	Error feed(const uint8_t *p_data, int p_len);
+	Error finish();
+
+	bool is_done() const { return done; }
+	Variant get_result() const { return result; }
+	Error get_error() const { return error; }
+	String get_error_string() const { return error_string; }
+	int get_error_line() const { return line; }
+
+	void clear();
+
+	JSONParser();
 };
 
 #endif // JSON_H
@@ -175,10 +175,11 @@ void RotatedFileLogger::rotate_file() {
 	file = FileAccess::open(base_path, FileAccess::WRITE);
 }
 
-RotatedFileLogger::RotatedFileLogger(const String &p_base_path, int p_max_files) {
+RotatedFileLogger::RotatedFileLogger(const String &p_base_path, int p_max_files, bool p_json_lines) {
 	file = NULL;
 	base_path = p_base_path.simplify_path();
 	max_files = p_max_files > 0 ? p_max_files : 1;
+	json_lines = p_json_lines;
 
 	rotate_file();
 }
@@ -200,7 +201,18 @@ void RotatedFileLogger::logv(const char *p_format, va_list p_list, bool p_err) {
 			vsnprintf(buf, len + 1, p_format, list_copy);
 		}
 		va_end(list_copy);
-		file->store_buffer((uint8_t *)buf, len);
+		if (json_lines) {
+			// one object per message, so log processors don't have to parse free text
+			String message = String::utf8(buf, len);
+			if (message.ends_with("\n")) {
+				message = message.substr(0, message.length() - 1);
+			}
+			String line = "{\"time\":" + itos(OS::get_singleton()->get_unix_time()) + ",\"msec\":" + itos(OS::get_singleton()->get_ticks_msec()) + ",\"error\":" + (p_err ? "true" : "false") + ",\"message\":\"" + message.json_escape() + "\"}\n";
+			CharString utf8 = line.utf8();
+			file->store_buffer((const uint8_t *)utf8.get_data(), utf8.length());
+		} else {
+			file->store_buffer((uint8_t *)buf, len);
+		}
 		if (len >= static_buf_size) {
 			Memory::free_static(buf);
 		}
@@ -236,6 +248,127 @@ void StdLogger::logv(const char *p_format, va_list p_list, bool p_err) {
 
 StdLogger::~StdLogger() {}
 
+void AsyncLogger::_thread_func(void *p_user) {
+
+	AsyncLogger *al = (AsyncLogger *)p_user;
+
+	while (true) {
+		al->semaphore->wait();
+		al->_flush_pending();
+		if (al->exit_thread) {
+			break;
+		}
+	}
+}
+
+void AsyncLogger::_flush_pending() {
+
+	mutex->lock();
+	List<Message> messages = pending;
+	pending.clear();
+	uint32_t dropped_count = dropped;
+	pending_bytes = 0;
+	dropped = 0;
+	mutex->unlock();
+
+	// the wrapped logger is only ever used from here, the lock is not held while writing
+	for (List<Message>::Element *E = messages.front(); E; E = E->next()) {
+		if (E->get().err) {
+			logger->logf_error("%s", E->get().text.get_data());
+		} else {
+			logger->logf("%s", E->get().text.get_data());
+		}
+	}
+
+	if (dropped_count) {
+		logger->logf_error("AsyncLogger: %u messages were dropped, logging faster than they could be written.\n", dropped_count);
+	}
+}
+
+AsyncLogger::AsyncLogger(Logger *p_logger, int p_max_pending_bytes) {
+
+	logger = p_logger;
+	max_pending_bytes = p_max_pending_bytes;
+	pending_bytes = 0;
+	dropped = 0;
+	exit_thread = false;
+
+	mutex = Mutex::create();
+	semaphore = Semaphore::create();
+	thread = NULL;
+	if (mutex && semaphore) {
+		Thread::Settings settings;
+		settings.name = "Logger";
+		settings.priority = Thread::PRIORITY_LOW;
+		settings.core_type = Thread::CORE_TYPE_EFFICIENCY;
+		thread = Thread::create(_thread_func, this, settings);
+	}
+}
+
+void AsyncLogger::logv(const char *p_format, va_list p_list, bool p_err) {
+	if (!should_log(p_err)) {
+		return;
+	}
+
+	if (!thread) {
+		// no threads, write directly
+		logger->logv(p_format, p_list, p_err);
+		return;
+	}
+
+	Message message;
+	{
+		const int static_buf_size = 512;
+		char static_buf[static_buf_size];
+		va_list list_copy;
+		va_copy(list_copy, p_list);
+		int len = vsnprintf(static_buf, static_buf_size, p_format, p_list);
+		if (len < 0) {
+			va_end(list_copy);
+			return;
+		}
+		message.text.resize(len + 1);
+		if (len < static_buf_size) {
+			memcpy(message.text.ptrw(), static_buf, len + 1);
+		} else {
+			vsnprintf(message.text.ptrw(), len + 1, p_format, list_copy);
+		}
+		va_end(list_copy);
+	}
+	message.err = p_err;
+
+	mutex->lock();
+	if (pending_bytes + message.text.size() > max_pending_bytes) {
+		dropped++;
+		mutex->unlock();
+		return;
+	}
+	pending_bytes += message.text.size();
+	pending.push_back(message);
+	mutex->unlock();
+
+	semaphore->post();
+}
+
+AsyncLogger::~AsyncLogger() {
+
+	if (thread) {
+		exit_thread = true;
+		semaphore->post();
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+	}
+
+	if (semaphore) {
+		memdelete(semaphore);
+	}
+	if (mutex) {
+		memdelete(mutex);
+	}
+
+	memdelete(logger);
+}
+
 CompositeLogger::CompositeLogger(Vector<Logger *> p_loggers) {
 	loggers = p_loggers;
 }
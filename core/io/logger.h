@@ -31,7 +31,11 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include "list.h"
 #include "os/file_access.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
 #include "ustring.h"
 #include "vector.h"
 #include <stdarg.h>
@@ -76,6 +80,7 @@ public:
 class RotatedFileLogger : public Logger {
 	String base_path;
 	int max_files;
+	bool json_lines;
 
 	FileAccess *file;
 
@@ -85,13 +90,49 @@ class RotatedFileLogger : public Logger {
 	void rotate_file();
 
 public:
-	RotatedFileLogger(const String &p_base_path, int p_max_files = 10);
+	RotatedFileLogger(const String &p_base_path, int p_max_files = 10, bool p_json_lines = false);
 
 	virtual void logv(const char *p_format, va_list p_list, bool p_err);
 
 	virtual ~RotatedFileLogger();
 };
 
+/**
+ * Formats messages on the calling thread and passes them to the wrapped logger from a
+ * background thread, so slow outputs don't stall the caller. Pending messages are limited
+ * to a fixed amount of memory, messages that don't fit are dropped and their count is
+ * reported once there is room again.
+ */
+class AsyncLogger : public Logger {
+
+	struct Message {
+		CharString text;
+		bool err;
+	};
+
+	Logger *logger;
+	int max_pending_bytes;
+
+	Mutex *mutex;
+	Semaphore *semaphore;
+	Thread *thread;
+	volatile bool exit_thread;
+
+	List<Message> pending;
+	int pending_bytes;
+	uint32_t dropped;
+
+	static void _thread_func(void *p_user);
+	void _flush_pending();
+
+public:
+	AsyncLogger(Logger *p_logger, int p_max_pending_bytes = 1024 * 1024);
+
+	virtual void logv(const char *p_format, va_list p_list, bool p_err);
+
+	virtual ~AsyncLogger();
+};
+
 class CompositeLogger : public Logger {
 	Vector<Logger *> loggers;
 
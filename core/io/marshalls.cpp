@@ -29,6 +29,8 @@
 /*************************************************************************/
 
 #include "marshalls.h"
+#include "hash_map.h"
+#include "os/file_access.h"
 #include "os/keyboard.h"
 #include "print_string.h"
 #include "reference.h"
@@ -62,6 +64,54 @@ EncodedObjectAsID::EncodedObjectAsID() {
 #define ENCODE_FLAG_64 1 << 16
 #define ENCODE_FLAG_OBJECT_AS_ID 1 << 16
 
+// 32 bit elements of pool arrays are stored little endian, so on most hosts a
+// whole array can be copied as a block
+
+static inline void _encode_uint32_block(const uint32_t *p_src, uint8_t *p_dst, int p_count) {
+
+#ifdef BIG_ENDIAN_ENABLED
+	for (int i = 0; i < p_count; i++) {
+		encode_uint32(p_src[i], &p_dst[i * 4]);
+	}
+#else
+	copymem(p_dst, p_src, p_count * 4);
+#endif
+}
+
+static inline void _decode_uint32_block(const uint8_t *p_src, uint32_t *p_dst, int p_count) {
+
+#ifdef BIG_ENDIAN_ENABLED
+	for (int i = 0; i < p_count; i++) {
+		p_dst[i] = decode_uint32(&p_src[i * 4]);
+	}
+#else
+	copymem(p_dst, p_src, p_count * 4);
+#endif
+}
+
+// reals are always stored as floats
+static inline void _encode_real_block(const real_t *p_src, uint8_t *p_dst, int p_count) {
+
+#ifdef REAL_T_IS_DOUBLE
+	for (int i = 0; i < p_count; i++) {
+		encode_float(p_src[i], &p_dst[i * 4]);
+	}
+#else
+	_encode_uint32_block((const uint32_t *)p_src, p_dst, p_count);
+#endif
+}
+
+static inline void _decode_real_block(const uint8_t *p_src, real_t *p_dst, int p_count) {
+
+#ifdef REAL_T_IS_DOUBLE
+	for (int i = 0; i < p_count; i++) {
+		p_dst[i] = decode_float(&p_src[i * 4]);
+	}
+#else
+	_decode_uint32_block(p_src, (uint32_t *)p_dst, p_count);
+#endif
+}
+
 static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r_string) {
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
 
@@ -586,10 +636,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				PoolVector<int>::Write w = data.write();
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i] = decode_uint32(&buf[i * 4]);
-				}
+				_decode_uint32_block(buf, (uint32_t *)w.ptr(), count);
 
 				w = PoolVector<int>::Write();
 			}
@@ -608,18 +655,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_MUL_OF(count, 4, ERR_INVALID_DATA);
 			ERR_FAIL_COND_V(count < 0 || count * 4 > len, ERR_INVALID_DATA);
 
-			PoolVector<float> data;
+			PoolVector<real_t> data;
 
 			if (count) {
-				//const float*rbuf=(const float*)buf;
 				data.resize(count);
-				PoolVector<float>::Write w = data.write();
-				for (int32_t i = 0; i < count; i++) {
+				PoolVector<real_t>::Write w = data.write();
+				_decode_real_block(buf, w.ptr(), count);
 
-					w[i] = decode_float(&buf[i * 4]);
-				}
-
-				w = PoolVector<float>::Write();
+				w = PoolVector<real_t>::Write();
 			}
 			r_variant = data;
 
@@ -672,12 +715,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				varray.resize(count);
 				PoolVector<Vector2>::Write w = varray.write();
-
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i].x = decode_float(buf + i * 4 * 2 + 4 * 0);
-					w[i].y = decode_float(buf + i * 4 * 2 + 4 * 1);
-				}
+				_decode_real_block(buf, (real_t *)w.ptr(), count * 2);
 
 				int adv = 4 * 2 * count;
 
@@ -709,13 +747,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				varray.resize(count);
 				PoolVector<Vector3>::Write w = varray.write();
-
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i].x = decode_float(buf + i * 4 * 3 + 4 * 0);
-					w[i].y = decode_float(buf + i * 4 * 3 + 4 * 1);
-					w[i].z = decode_float(buf + i * 4 * 3 + 4 * 2);
-				}
+				_decode_real_block(buf, (real_t *)w.ptr(), count * 3);
 
 				int adv = 4 * 3 * count;
 
@@ -747,14 +779,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				carray.resize(count);
 				PoolVector<Color>::Write w = carray.write();
-
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
-					w[i].g = decode_float(buf + i * 4 * 4 + 4 * 1);
-					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
-					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
-				}
+				_decode_uint32_block(buf, (uint32_t *)w.ptr(), count * 4);
 
 				int adv = 4 * 4 * count;
 
@@ -1247,8 +1272,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				PoolVector<int>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_uint32(r[i], &buf[i * datasize]);
+				_encode_uint32_block((const uint32_t *)r.ptr(), buf, datalen);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1258,14 +1282,13 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			PoolVector<real_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(real_t);
+			int datasize = sizeof(float);
 
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				PoolVector<real_t>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_float(r[i], &buf[i * datasize]);
+				_encode_real_block(r.ptr(), buf, datalen);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1317,14 +1340,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			if (buf) {
 
-				for (int i = 0; i < len; i++) {
-
-					Vector2 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					buf += 4 * 2;
-				}
+				PoolVector<Vector2>::Read r = data.read();
+				_encode_real_block((const real_t *)r.ptr(), buf, len * 2);
+				buf += 4 * 2 * len;
 			}
 
 			r_len += 4 * 2 * len;
@@ -1344,15 +1362,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			if (buf) {
 
-				for (int i = 0; i < len; i++) {
-
-					Vector3 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					encode_float(v.z, &buf[8]);
-					buf += 4 * 3;
-				}
+				PoolVector<Vector3>::Read r = data.read();
+				_encode_real_block((const real_t *)r.ptr(), buf, len * 3);
+				buf += 4 * 3 * len;
 			}
 
 			r_len += 4 * 3 * len;
@@ -1372,16 +1384,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			if (buf) {
 
-				for (int i = 0; i < len; i++) {
-
-					Color c = data.get(i);
-
-					encode_float(c.r, &buf[0]);
-					encode_float(c.g, &buf[4]);
-					encode_float(c.b, &buf[8]);
-					encode_float(c.a, &buf[12]);
-					buf += 4 * 4;
-				}
+				PoolVector<Color>::Read r = data.read();
+				_encode_uint32_block((const uint32_t *)r.ptr(), buf, len * 4);
+				buf += 4 * 4 * len;
 			}
 
 			r_len += 4 * 4 * len;
@@ -1392,3 +1397,929 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 	return OK;
 }
+
+// Variant streams: a one byte header per value with the type and a flag, then
+// the value. Counts and integers are varints, strings are interned, pool
+// arrays are stored as blocks of little endian elements.
+
+enum {
+	STREAM_TYPE_MASK = 0x3F,
+	STREAM_FLAG = 0x40, // value of a bool, 64 bits for int/real, object as id
+	STREAM_BUFFER_SIZE = 65536,
+};
+
+class VariantStreamEncoder {
+
+	FileAccess *f;
+	bool object_as_id;
+
+	Vector<uint8_t> buffer;
+	int pos;
+
+	HashMap<String, uint32_t> strings;
+
+	void _flush() {
+
+		if (pos) {
+			f->store_buffer(buffer.ptr(), pos);
+			pos = 0;
+		}
+	}
+
+	_FORCE_INLINE_ uint8_t *_reserve(int p_len) {
+
+		if (pos + p_len > STREAM_BUFFER_SIZE) {
+			_flush();
+		}
+		uint8_t *ptr = &buffer.write[pos];
+		pos += p_len;
+		return ptr;
+	}
+
+	void _put_u8(uint8_t p_value) {
+
+		*_reserve(1) = p_value;
+	}
+
+	void _put_varint(uint64_t p_value) {
+
+		uint8_t *ptr = _reserve(10);
+		int len = 0;
+		do {
+			uint8_t byte = p_value & 0x7F;
+			p_value >>= 7;
+			if (p_value)
+				byte |= 0x80;
+			ptr[len++] = byte;
+		} while (p_value);
+		pos -= 10 - len;
+	}
+
+	void _put_block(const void *p_data, int p_len) {
+
+		if (p_len > STREAM_BUFFER_SIZE / 2) {
+			// big enough to skip the buffer
+			_flush();
+			f->store_buffer((const uint8_t *)p_data, p_len);
+			return;
+		}
+		copymem(_reserve(p_len), p_data, p_len);
+	}
+
+	void _put_uint32_block(const uint32_t *p_data, int p_count) {
+
+#ifdef BIG_ENDIAN_ENABLED
+		for (int i = 0; i < p_count; i++) {
+			encode_uint32(p_data[i], _reserve(4));
+		}
+#else
+		_put_block(p_data, p_count * 4);
+#endif
+	}
+
+	void _put_real_block(const real_t *p_data, int p_count) {
+
+#ifdef REAL_T_IS_DOUBLE
+		for (int i = 0; i < p_count; i++) {
+			encode_float(p_data[i], _reserve(4));
+		}
+#else
+		_put_uint32_block((const uint32_t *)p_data, p_count);
+#endif
+	}
+
+	void _put_reals(const real_t *p_data, int p_count) {
+
+		uint8_t *ptr = _reserve(p_count * 4);
+		for (int i = 0; i < p_count; i++) {
+			encode_float(p_data[i], &ptr[i * 4]);
+		}
+	}
+
+	void _put_string(const String &p_string) {
+
+		// 0 starts a new string, anything else is an index into the table plus one
+		const uint32_t *idx = strings.getptr(p_string);
+		if (idx) {
+			_put_varint(*idx + 1);
+			return;
+		}
+
+		uint32_t index = strings.size();
+		strings[p_string] = index;
+
+		CharString utf8 = p_string.utf8();
+		_put_varint(0);
+		_put_varint(utf8.length());
+		_put_block(utf8.get_data(), utf8.length());
+	}
+
+public:
+	Error encode(const Variant &p_variant) {
+
+		Variant::Type type = p_variant.get_type();
+
+		switch (type) {
+
+			case Variant::NIL:
+			case Variant::_RID: {
+
+				_put_u8(type);
+			} break;
+			case Variant::BOOL: {
+
+				_put_u8(type | (p_variant.operator bool() ? STREAM_FLAG : 0));
+			} break;
+			case Variant::INT: {
+
+				int64_t val = p_variant;
+				_put_u8(type);
+				_put_varint((uint64_t(val) << 1) ^ uint64_t(val >> 63));
+			} break;
+			case Variant::REAL: {
+
+				double d = p_variant;
+				float fl = d;
+				if (double(fl) != d) {
+					_put_u8(type | STREAM_FLAG);
+					encode_double(d, _reserve(8));
+				} else {
+					_put_u8(type);
+					encode_float(fl, _reserve(4));
+				}
+			} break;
+			case Variant::STRING: {
+
+				_put_u8(type);
+				_put_string(p_variant);
+			} break;
+			case Variant::NODE_PATH: {
+
+				NodePath np = p_variant;
+				_put_u8(type | (np.is_absolute() ? STREAM_FLAG : 0));
+				_put_varint(np.get_name_count());
+				_put_varint(np.get_subname_count());
+				for (int i = 0; i < np.get_name_count(); i++) {
+					_put_string(np.get_name(i));
+				}
+				for (int i = 0; i < np.get_subname_count(); i++) {
+					_put_string(np.get_subname(i));
+				}
+			} break;
+			case Variant::VECTOR2: {
+
+				Vector2 v = p_variant;
+				_put_u8(type);
+				_put_reals(&v.x, 2);
+			} break;
+			case Variant::RECT2: {
+
+				Rect2 r = p_variant;
+				_put_u8(type);
+				_put_reals(&r.position.x, 2);
+				_put_reals(&r.size.x, 2);
+			} break;
+			case Variant::VECTOR3: {
+
+				Vector3 v = p_variant;
+				_put_u8(type);
+				_put_reals(v.coord, 3);
+			} break;
+			case Variant::TRANSFORM2D: {
+
+				Transform2D t = p_variant;
+				_put_u8(type);
+				for (int i = 0; i < 3; i++) {
+					_put_reals(&t.elements[i].x, 2);
+				}
+			} break;
+			case Variant::PLANE: {
+
+				Plane p = p_variant;
+				_put_u8(type);
+				_put_reals(p.normal.coord, 3);
+				_put_reals(&p.d, 1);
+			} break;
+			case Variant::QUAT: {
+
+				Quat q = p_variant;
+				_put_u8(type);
+				_put_reals(&q.x, 1);
+				_put_reals(&q.y, 1);
+				_put_reals(&q.z, 1);
+				_put_reals(&q.w, 1);
+			} break;
+			case Variant::AABB: {
+
+				AABB aabb = p_variant;
+				_put_u8(type);
+				_put_reals(aabb.position.coord, 3);
+				_put_reals(aabb.size.coord, 3);
+			} break;
+			case Variant::BASIS: {
+
+				Basis b = p_variant;
+				_put_u8(type);
+				for (int i = 0; i < 3; i++) {
+					_put_reals(b.elements[i].coord, 3);
+				}
+			} break;
+			case Variant::TRANSFORM: {
+
+				Transform t = p_variant;
+				_put_u8(type);
+				for (int i = 0; i < 3; i++) {
+					_put_reals(t.basis.elements[i].coord, 3);
+				}
+				_put_reals(t.origin.coord, 3);
+			} break;
+			case Variant::COLOR: {
+
+				Color c = p_variant;
+				_put_u8(type);
+				_put_uint32_block((const uint32_t *)c.components, 4);
+			} break;
+			case Variant::OBJECT: {
+
+				Object *obj = p_variant;
+
+				if (object_as_id) {
+
+					ObjectID id = 0;
+					if (obj && ObjectDB::instance_validate(obj)) {
+						id = obj->get_instance_id();
+					}
+					_put_u8(type | STREAM_FLAG);
+					encode_uint64(id, _reserve(8));
+					break;
+				}
+
+				_put_u8(type);
+
+				if (!obj) {
+					_put_string(String());
+					break;
+				}
+
+				_put_string(obj->get_class());
+
+				List<PropertyInfo> props;
+				obj->get_property_list(&props);
+
+				List<StringName> names;
+				for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
+					if (E->get().usage & PROPERTY_USAGE_STORAGE) {
+						names.push_back(E->get().name);
+					}
+				}
+
+				_put_varint(names.size());
+				for (List<StringName>::Element *E = names.front(); E; E = E->next()) {
+					_put_string(E->get());
+					Error err = encode(obj->get(E->get()));
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+			} break;
+			case Variant::DICTIONARY: {
+
+				Dictionary d = p_variant;
+				_put_u8(type);
+				_put_varint(d.size());
+
+				const Variant *K = NULL;
+				while ((K = d.next(K))) {
+					Error err = encode(*K);
+					ERR_FAIL_COND_V(err != OK, err);
+					err = encode(*d.getptr(*K));
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+			} break;
+			case Variant::ARRAY: {
+
+				Array a = p_variant;
+				_put_u8(type);
+				_put_varint(a.size());
+
+				for (int i = 0; i < a.size(); i++) {
+					Error err = encode(a[i]);
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+			} break;
+			case Variant::POOL_BYTE_ARRAY: {
+
+				PoolVector<uint8_t> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<uint8_t>::Read r = data.read();
+					_put_block(r.ptr(), data.size());
+				}
+			} break;
+			case Variant::POOL_INT_ARRAY: {
+
+				PoolVector<int> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<int>::Read r = data.read();
+					_put_uint32_block((const uint32_t *)r.ptr(), data.size());
+				}
+			} break;
+			case Variant::POOL_REAL_ARRAY: {
+
+				PoolVector<real_t> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<real_t>::Read r = data.read();
+					_put_real_block(r.ptr(), data.size());
+				}
+			} break;
+			case Variant::POOL_STRING_ARRAY: {
+
+				PoolVector<String> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<String>::Read r = data.read();
+					for (int i = 0; i < data.size(); i++) {
+						_put_string(r[i]);
+					}
+				}
+			} break;
+			case Variant::POOL_VECTOR2_ARRAY: {
+
+				PoolVector<Vector2> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<Vector2>::Read r = data.read();
+					_put_real_block((const real_t *)r.ptr(), data.size() * 2);
+				}
+			} break;
+			case Variant::POOL_VECTOR3_ARRAY: {
+
+				PoolVector<Vector3> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<Vector3>::Read r = data.read();
+					_put_real_block((const real_t *)r.ptr(), data.size() * 3);
+				}
+			} break;
+			case Variant::POOL_COLOR_ARRAY: {
+
+				PoolVector<Color> data = p_variant;
+				_put_u8(type);
+				_put_varint(data.size());
+				if (data.size()) {
+					PoolVector<Color>::Read r = data.read();
+					_put_uint32_block((const uint32_t *)r.ptr(), data.size() * 4);
+				}
+			} break;
+			default: { ERR_FAIL_V(ERR_BUG); }
+		}
+
+		return OK;
+	}
+
+	void finish() {
+
+		_flush();
+	}
+
+	VariantStreamEncoder(FileAccess *p_file, bool p_object_as_id) {
+
+		f = p_file;
+		object_as_id = p_object_as_id;
+		buffer.resize(STREAM_BUFFER_SIZE);
+		pos = 0;
+	}
+};
+
+class VariantStreamDecoder {
+
+	FileAccess *f;
+	bool allow_objects;
+
+	Vector<uint8_t> buffer;
+	int pos;
+	int size;
+
+	Vector<String> strings;
+
+	// make sure p_len bytes are buffered, p_len must not exceed the buffer
+	Error _fill(int p_len) {
+
+		if (size - pos >= p_len) {
+			return OK;
+		}
+
+		int left = size - pos;
+		if (left) {
+			movemem(buffer.ptrw(), &buffer[pos], left);
+		}
+		pos = 0;
+		size = left;
+		size += f->get_buffer(&buffer.write[size], STREAM_BUFFER_SIZE - size);
+
+		ERR_FAIL_COND_V(size < p_len, ERR_FILE_EOF);
+		return OK;
+	}
+
+	Error _get_u8(uint8_t &r_value) {
+
+		Error err = _fill(1);
+		ERR_FAIL_COND_V(err != OK, err);
+		r_value = buffer[pos++];
+		return OK;
+	}
+
+	Error _get_varint(uint64_t &r_value) {
+
+		r_value = 0;
+		for (int i = 0; i < 10; i++) {
+
+			uint8_t byte;
+			Error err = _get_u8(byte);
+			ERR_FAIL_COND_V(err != OK, err);
+
+			r_value |= uint64_t(byte & 0x7F) << (7 * i);
+			if (!(byte & 0x80)) {
+				return OK;
+			}
+		}
+
+		ERR_FAIL_V(ERR_INVALID_DATA);
+	}
+
+	// counts are checked against what is left in the file before allocating
+	Error _get_count(int &r_count, int p_element_size) {
+
+		uint64_t count;
+		Error err = _get_varint(count);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		uint64_t remaining = f->get_len() - f->get_position() + (size - pos);
+		ERR_FAIL_COND_V(count * p_element_size > remaining || count > INT_MAX, ERR_INVALID_DATA);
+		r_count = count;
+		return OK;
+	}
+
+	Error _get_block(void *r_data, int p_len) {
+
+		uint8_t *dst = (uint8_t *)r_data;
+
+		int buffered = MIN(size - pos, p_len);
+		copymem(dst, &buffer[pos], buffered);
+		pos += buffered;
+
+		if (buffered < p_len) {
+			// read the rest straight into the destination
+			int read = f->get_buffer(dst + buffered, p_len - buffered);
+			ERR_FAIL_COND_V(read != p_len - buffered, ERR_FILE_EOF);
+		}
+		return OK;
+	}
+
+	Error _get_uint32_block(uint32_t *r_data, int p_count) {
+
+		Error err = _get_block(r_data, p_count * 4);
+		ERR_FAIL_COND_V(err != OK, err);
+#ifdef BIG_ENDIAN_ENABLED
+		for (int i = 0; i < p_count; i++) {
+			r_data[i] = BSWAP32(r_data[i]);
+		}
+#endif
+		return OK;
+	}
+
+	Error _get_real_block(real_t *r_data, int p_count) {
+
+#ifdef REAL_T_IS_DOUBLE
+		for (int i = 0; i < p_count; i++) {
+			Error err = _fill(4);
+			ERR_FAIL_COND_V(err != OK, err);
+			r_data[i] = decode_float(&buffer[pos]);
+			pos += 4;
+		}
+		return OK;
+#else
+		return _get_uint32_block((uint32_t *)r_data, p_count);
+#endif
+	}
+
+	Error _get_reals(real_t *r_data, int p_count) {
+
+		Error err = _fill(p_count * 4);
+		ERR_FAIL_COND_V(err != OK, err);
+		for (int i = 0; i < p_count; i++) {
+			r_data[i] = decode_float(&buffer[pos + i * 4]);
+		}
+		pos += p_count * 4;
+		return OK;
+	}
+
+	Error _get_string(String &r_string) {
+
+		uint64_t idx;
+		Error err = _get_varint(idx);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		if (idx) {
+			ERR_FAIL_COND_V(idx > uint64_t(strings.size()), ERR_INVALID_DATA);
+			r_string = strings[idx - 1];
+			return OK;
+		}
+
+		int len;
+		err = _get_count(len, 1);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		if (len <= STREAM_BUFFER_SIZE) {
+			err = _fill(len);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(r_string.parse_utf8((const char *)&buffer[pos], len), ERR_INVALID_DATA);
+			pos += len;
+		} else {
+			Vector<uint8_t> utf8;
+			utf8.resize(len);
+			err = _get_block(utf8.ptrw(), len);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(r_string.parse_utf8((const char *)utf8.ptr(), len), ERR_INVALID_DATA);
+		}
+
+		strings.push_back(r_string);
+		return OK;
+	}
+
+#define STREAM_GET(m_call)                  \
+	{                                       \
+		Error err = m_call;                 \
+		ERR_FAIL_COND_V(err != OK, err);    \
+	}
+
+public:
+	Error decode(Variant &r_variant) {
+
+		uint8_t header;
+		STREAM_GET(_get_u8(header));
+
+		bool flag = header & STREAM_FLAG;
+		int type = header & STREAM_TYPE_MASK;
+		ERR_FAIL_COND_V(type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+
+		switch (type) {
+
+			case Variant::NIL: {
+
+				r_variant = Variant();
+			} break;
+			case Variant::_RID: {
+
+				r_variant = RID();
+			} break;
+			case Variant::BOOL: {
+
+				r_variant = flag;
+			} break;
+			case Variant::INT: {
+
+				uint64_t zz;
+				STREAM_GET(_get_varint(zz));
+				r_variant = int64_t(zz >> 1) ^ -int64_t(zz & 1);
+			} break;
+			case Variant::REAL: {
+
+				if (flag) {
+					STREAM_GET(_fill(8));
+					r_variant = decode_double(&buffer[pos]);
+					pos += 8;
+				} else {
+					STREAM_GET(_fill(4));
+					r_variant = decode_float(&buffer[pos]);
+					pos += 4;
+				}
+			} break;
+			case Variant::STRING: {
+
+				String str;
+				STREAM_GET(_get_string(str));
+				r_variant = str;
+			} break;
+			case Variant::NODE_PATH: {
+
+				int name_count, subname_count;
+				STREAM_GET(_get_count(name_count, 1));
+				STREAM_GET(_get_count(subname_count, 1));
+
+				Vector<StringName> names;
+				Vector<StringName> subnames;
+				for (int i = 0; i < name_count; i++) {
+					String str;
+					STREAM_GET(_get_string(str));
+					names.push_back(str);
+				}
+				for (int i = 0; i < subname_count; i++) {
+					String str;
+					STREAM_GET(_get_string(str));
+					subnames.push_back(str);
+				}
+
+				r_variant = NodePath(names, subnames, flag);
+			} break;
+			case Variant::VECTOR2: {
+
+				Vector2 v;
+				STREAM_GET(_get_reals(&v.x, 2));
+				r_variant = v;
+			} break;
+			case Variant::RECT2: {
+
+				Rect2 r;
+				STREAM_GET(_get_reals(&r.position.x, 2));
+				STREAM_GET(_get_reals(&r.size.x, 2));
+				r_variant = r;
+			} break;
+			case Variant::VECTOR3: {
+
+				Vector3 v;
+				STREAM_GET(_get_reals(v.coord, 3));
+				r_variant = v;
+			} break;
+			case Variant::TRANSFORM2D: {
+
+				Transform2D t;
+				for (int i = 0; i < 3; i++) {
+					STREAM_GET(_get_reals(&t.elements[i].x, 2));
+				}
+				r_variant = t;
+			} break;
+			case Variant::PLANE: {
+
+				Plane p;
+				STREAM_GET(_get_reals(p.normal.coord, 3));
+				STREAM_GET(_get_reals(&p.d, 1));
+				r_variant = p;
+			} break;
+			case Variant::QUAT: {
+
+				Quat q;
+				STREAM_GET(_get_reals(&q.x, 1));
+				STREAM_GET(_get_reals(&q.y, 1));
+				STREAM_GET(_get_reals(&q.z, 1));
+				STREAM_GET(_get_reals(&q.w, 1));
+				r_variant = q;
+			} break;
+			case Variant::AABB: {
+
+				AABB aabb;
+				STREAM_GET(_get_reals(aabb.position.coord, 3));
+				STREAM_GET(_get_reals(aabb.size.coord, 3));
+				r_variant = aabb;
+			} break;
+			case Variant::BASIS: {
+
+				Basis b;
+				for (int i = 0; i < 3; i++) {
+					STREAM_GET(_get_reals(b.elements[i].coord, 3));
+				}
+				r_variant = b;
+			} break;
+			case Variant::TRANSFORM: {
+
+				Transform t;
+				for (int i = 0; i < 3; i++) {
+					STREAM_GET(_get_reals(t.basis.elements[i].coord, 3));
+				}
+				STREAM_GET(_get_reals(t.origin.coord, 3));
+				r_variant = t;
+			} break;
+			case Variant::COLOR: {
+
+				Color c;
+				STREAM_GET(_get_uint32_block((uint32_t *)c.components, 4));
+				r_variant = c;
+			} break;
+			case Variant::OBJECT: {
+
+				if (flag) {
+
+					STREAM_GET(_fill(8));
+					ObjectID id = decode_uint64(&buffer[pos]);
+					pos += 8;
+
+					if (id == 0) {
+						r_variant = (Object *)NULL;
+					} else {
+						Ref<EncodedObjectAsID> obj_as_id;
+						obj_as_id.instance();
+						obj_as_id->set_object_id(id);
+						r_variant = obj_as_id;
+					}
+					break;
+				}
+
+				ERR_FAIL_COND_V(!allow_objects, ERR_UNAUTHORIZED);
+
+				String class_name;
+				STREAM_GET(_get_string(class_name));
+
+				if (class_name == String()) {
+					r_variant = (Object *)NULL;
+					break;
+				}
+
+				Object *obj = ClassDB::instance(class_name);
+				ERR_FAIL_COND_V(!obj, ERR_UNAVAILABLE);
+
+				// hold references right away, so errors below don't leak the object
+				Reference *ref = Object::cast_to<Reference>(obj);
+				if (ref) {
+					r_variant = REF(ref);
+				} else {
+					r_variant = obj;
+				}
+
+				int count;
+				STREAM_GET(_get_count(count, 2));
+				for (int i = 0; i < count; i++) {
+
+					String name;
+					STREAM_GET(_get_string(name));
+					Variant value;
+					STREAM_GET(decode(value));
+					obj->set(name, value);
+				}
+			} break;
+			case Variant::DICTIONARY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 2));
+
+				Dictionary d;
+				for (int i = 0; i < count; i++) {
+
+					Variant key, value;
+					STREAM_GET(decode(key));
+					STREAM_GET(decode(value));
+					d[key] = value;
+				}
+				r_variant = d;
+			} break;
+			case Variant::ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 1));
+
+				Array a;
+				a.resize(count);
+				for (int i = 0; i < count; i++) {
+					STREAM_GET(decode(a[i]));
+				}
+				r_variant = a;
+			} break;
+			case Variant::POOL_BYTE_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 1));
+
+				PoolVector<uint8_t> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<uint8_t>::Write w = data.write();
+					STREAM_GET(_get_block(w.ptr(), count));
+				}
+				r_variant = data;
+			} break;
+			case Variant::POOL_INT_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 4));
+
+				PoolVector<int> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<int>::Write w = data.write();
+					STREAM_GET(_get_uint32_block((uint32_t *)w.ptr(), count));
+				}
+				r_variant = data;
+			} break;
+			case Variant::POOL_REAL_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 4));
+
+				PoolVector<real_t> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<real_t>::Write w = data.write();
+					STREAM_GET(_get_real_block(w.ptr(), count));
+				}
+				r_variant = data;
+			} break;
+			case Variant::POOL_STRING_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 1));
+
+				PoolVector<String> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<String>::Write w = data.write();
+					for (int i = 0; i < count; i++) {
+						STREAM_GET(_get_string(w[i]));
+					}
+				}
+				r_variant = data;
+			} break;
+			case Variant::POOL_VECTOR2_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 4 * 2));
+
+				PoolVector<Vector2> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<Vector2>::Write w = data.write();
+					STREAM_GET(_get_real_block((real_t *)w.ptr(), count * 2));
+				}
+				r_variant = data;
+			} break;
+			case Variant::POOL_VECTOR3_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 4 * 3));
+
+				PoolVector<Vector3> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<Vector3>::Write w = data.write();
+					STREAM_GET(_get_real_block((real_t *)w.ptr(), count * 3));
+				}
+				r_variant = data;
+			} break;
+			case Variant::POOL_COLOR_ARRAY: {
+
+				int count;
+				STREAM_GET(_get_count(count, 4 * 4));
+
+				PoolVector<Color> data;
+				if (count) {
+					data.resize(count);
+					PoolVector<Color>::Write w = data.write();
+					STREAM_GET(_get_uint32_block((uint32_t *)w.ptr(), count * 4));
+				}
+				r_variant = data;
+			} break;
+			default: { ERR_FAIL_V(ERR_INVALID_DATA); }
+		}
+
+		return OK;
+	}
+
+#undef STREAM_GET
+
+	void finish() {
+
+		// give back what was read ahead, so the file is right after the value
+		if (size - pos) {
+			f->seek(f->get_position() - (size - pos));
+		}
+		pos = size = 0;
+	}
+
+	VariantStreamDecoder(FileAccess *p_file, bool p_allow_objects) {
+
+		f = p_file;
+		allow_objects = p_allow_objects;
+		buffer.resize(STREAM_BUFFER_SIZE);
+		pos = 0;
+		size = 0;
+	}
+};
+
+Error encode_variant_stream(const Variant &p_variant, FileAccess *p_file, bool p_object_as_id) {
+
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+
+	p_file->store_32(VARIANT_STREAM_MAGIC);
+
+	VariantStreamEncoder encoder(p_file, p_object_as_id);
+	Error err = encoder.encode(p_variant);
+	encoder.finish();
+
+	return err;
+}
+
+Error decode_variant_stream(Variant &r_variant, FileAccess *p_file, bool p_allow_objects) {
+
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_file->get_32() != VARIANT_STREAM_MAGIC, ERR_FILE_UNRECOGNIZED);
+
+	VariantStreamDecoder decoder(p_file, p_allow_objects);
+	Error err = decoder.decode(r_variant);
+	decoder.finish();
+
+	return err;
+}
@@ -184,6 +184,8 @@ static inline double decode_double(const uint8_t *p_arr) {
 	return md.d;
 }
 
+class FileAccess;
+
 class EncodedObjectAsID : public Reference {
 	GDCLASS(EncodedObjectAsID, Reference);
 
@@ -202,4 +204,18 @@ public:
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id = false);
 
+/**
+  * Streamed encoding for bulk data such as save games. The value is written to
+  * the file as it is visited instead of being measured and copied to a buffer
+  * first. Strings are interned per stream, and pool arrays are stored as
+  * blocks. The stream starts with VARIANT_STREAM_MAGIC.
+  */
+
+enum {
+	VARIANT_STREAM_MAGIC = 0x53564447 // "GDVS"
+};
+
+Error encode_variant_stream(const Variant &p_variant, FileAccess *p_file, bool p_object_as_id = false);
+Error decode_variant_stream(Variant &r_variant, FileAccess *p_file, bool p_allow_objects = true);
+
 #endif
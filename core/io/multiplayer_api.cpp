@@ -30,6 +30,7 @@
 
 #include "core/io/multiplayer_api.h"
 #include "core/io/marshalls.h"
+#include "core/os/os.h"
 #include "scene/main/node.h"
 
 _FORCE_INLINE_ bool _should_call_local(MultiplayerAPI::RPCMode mode, bool is_master, bool &r_skip_rpc) {
@@ -108,6 +109,8 @@ void MultiplayerAPI::poll() {
 			ERR_PRINT("Error getting packet!");
 		}
 
+		window_incoming_bytes += len;
+
 		rpc_sender_id = sender;
 		_process_packet(sender, packet, len);
 		rpc_sender_id = 0;
@@ -116,6 +119,47 @@ void MultiplayerAPI::poll() {
 			break; //it's also possible that a packet or RPC caused a disconnection, so also check here
 		}
 	}
+
+	if (replicated_nodes.size() && network_peer.is_valid() && network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED) {
+
+		uint64_t now = OS::get_singleton()->get_ticks_usec();
+		if (now - last_replication_usec >= uint64_t(replication_interval * 1000000)) {
+			last_replication_usec = now;
+			_send_snapshots();
+		}
+	}
+
+	if (rpc_batch_mode == RPC_BATCH_FLUSH_ON_POLL && network_peer.is_valid()) {
+		flush_rpc_batches();
+	}
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+	if (now - stats_window_usec >= 1000000 && network_peer.is_valid()) {
+		_update_network_stats(now);
+	}
+}
+
+void MultiplayerAPI::_update_network_stats(uint64_t p_now) {
+
+	float elapsed = (p_now - stats_window_usec) / 1000000.0;
+	incoming_bandwidth = window_incoming_bytes / elapsed;
+	outgoing_bandwidth = window_outgoing_bytes / elapsed;
+	window_incoming_bytes = 0;
+	window_outgoing_bytes = 0;
+	stats_window_usec = p_now;
+
+	// latency is only known by the transport, and only for the peers it talks to directly
+	float rtt_total = 0;
+	int rtt_count = 0;
+	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+
+		Dictionary stats = network_peer->get_peer_statistics(E->get());
+		if (stats.has("round_trip_time")) {
+			rtt_total += float(stats["round_trip_time"]);
+			rtt_count++;
+		}
+	}
+	average_round_trip_time = rtt_count ? rtt_total / rtt_count : 0;
 }
 
 void MultiplayerAPI::clear() {
@@ -123,6 +167,15 @@ void MultiplayerAPI::clear() {
 	path_get_cache.clear();
 	path_send_cache.clear();
 	last_send_cache_id = 1;
+	replication_peers.clear();
+	last_snapshot_id = 0;
+	rpc_batches.clear();
+	stats_window_usec = OS::get_singleton()->get_ticks_usec();
+	window_incoming_bytes = 0;
+	window_outgoing_bytes = 0;
+	incoming_bandwidth = 0;
+	outgoing_bandwidth = 0;
+	average_round_trip_time = 0;
 }
 
 void MultiplayerAPI::set_root_node(Node *p_node) {
@@ -158,12 +211,249 @@ Ref<NetworkedMultiplayerPeer> MultiplayerAPI::get_network_peer() const {
 	return network_peer;
 }
 
+// Compact encoding for RPC arguments: a one byte header with the type, then the
+// value. Integers are zigzag varints and strings are not padded; types without
+// a compact form fall back to encode_variant.
+
+enum {
+	RPC_ARG_TYPE_MASK = 0x3F,
+	RPC_ARG_FLAG = 0x40, // value of a bool, or double precision for a float
+	RPC_ARG_FALLBACK = 0x80
+};
+
+static int _encode_varint(uint64_t p_value, uint8_t *p_buf) {
+
+	int len = 0;
+	do {
+		uint8_t byte = p_value & 0x7F;
+		p_value >>= 7;
+		if (p_value)
+			byte |= 0x80;
+		if (p_buf)
+			p_buf[len] = byte;
+		len++;
+	} while (p_value);
+
+	return len;
+}
+
+static Error _decode_varint(uint64_t &r_value, const uint8_t *p_buf, int p_len, int *r_len) {
+
+	r_value = 0;
+	for (int i = 0; i < p_len && i < 10; i++) {
+
+		r_value |= uint64_t(p_buf[i] & 0x7F) << (7 * i);
+		if (!(p_buf[i] & 0x80)) {
+			*r_len = i + 1;
+			return OK;
+		}
+	}
+
+	ERR_FAIL_V(ERR_INVALID_DATA);
+}
+
+static Error _encode_rpc_arg(const Variant &p_arg, uint8_t *r_buf, int &r_len) {
+
+	uint8_t header = p_arg.get_type();
+	uint8_t *buf = r_buf ? r_buf + 1 : NULL;
+	r_len = 1;
+
+	switch (p_arg.get_type()) {
+
+		case Variant::NIL: {
+		} break;
+		case Variant::BOOL: {
+
+			if (p_arg.operator bool())
+				header |= RPC_ARG_FLAG;
+		} break;
+		case Variant::INT: {
+
+			int64_t val = p_arg;
+			r_len += _encode_varint((uint64_t(val) << 1) ^ uint64_t(val >> 63), buf);
+		} break;
+		case Variant::REAL: {
+
+			double d = p_arg;
+			float f = d;
+			if (double(f) != d) {
+				header |= RPC_ARG_FLAG;
+				if (buf)
+					encode_double(d, buf);
+				r_len += 8;
+			} else {
+				if (buf)
+					encode_float(f, buf);
+				r_len += 4;
+			}
+		} break;
+		case Variant::STRING: {
+
+			CharString utf8 = p_arg.operator String().utf8();
+			int len = utf8.length();
+			int len_size = _encode_varint(len, buf);
+			if (buf)
+				copymem(buf + len_size, utf8.get_data(), len);
+			r_len += len_size + len;
+		} break;
+		case Variant::VECTOR2: {
+
+			if (buf) {
+				Vector2 v = p_arg;
+				encode_float(v.x, &buf[0]);
+				encode_float(v.y, &buf[4]);
+			}
+			r_len += 4 * 2;
+		} break;
+		case Variant::VECTOR3: {
+
+			if (buf) {
+				Vector3 v = p_arg;
+				encode_float(v.x, &buf[0]);
+				encode_float(v.y, &buf[4]);
+				encode_float(v.z, &buf[8]);
+			}
+			r_len += 4 * 3;
+		} break;
+		case Variant::QUAT: {
+
+			if (buf) {
+				Quat q = p_arg;
+				encode_float(q.x, &buf[0]);
+				encode_float(q.y, &buf[4]);
+				encode_float(q.z, &buf[8]);
+				encode_float(q.w, &buf[12]);
+			}
+			r_len += 4 * 4;
+		} break;
+		case Variant::COLOR: {
+
+			if (buf) {
+				Color c = p_arg;
+				encode_float(c.r, &buf[0]);
+				encode_float(c.g, &buf[4]);
+				encode_float(c.b, &buf[8]);
+				encode_float(c.a, &buf[12]);
+			}
+			r_len += 4 * 4;
+		} break;
+		default: {
+
+			header = RPC_ARG_FALLBACK;
+			int len;
+			Error err = encode_variant(p_arg, buf, len);
+			ERR_FAIL_COND_V(err != OK, err);
+			r_len += len;
+		}
+	}
+
+	if (r_buf)
+		r_buf[0] = header;
+
+	return OK;
+}
+
+static Error _decode_rpc_arg(Variant &r_arg, const uint8_t *p_buf, int p_len, int *r_len) {
+
+	ERR_FAIL_COND_V(p_len < 1, ERR_INVALID_DATA);
+
+	uint8_t header = p_buf[0];
+	const uint8_t *buf = p_buf + 1;
+	int len = p_len - 1;
+
+	if (header & RPC_ARG_FALLBACK) {
+
+		int vlen;
+		Error err = decode_variant(r_arg, buf, len, &vlen);
+		ERR_FAIL_COND_V(err != OK, err);
+		*r_len = 1 + vlen;
+		return OK;
+	}
+
+	*r_len = 1;
+
+	switch (header & RPC_ARG_TYPE_MASK) {
+
+		case Variant::NIL: {
+
+			r_arg = Variant();
+		} break;
+		case Variant::BOOL: {
+
+			r_arg = bool(header & RPC_ARG_FLAG);
+		} break;
+		case Variant::INT: {
+
+			uint64_t zz;
+			int vlen;
+			Error err = _decode_varint(zz, buf, len, &vlen);
+			ERR_FAIL_COND_V(err != OK, err);
+			r_arg = int64_t(zz >> 1) ^ -int64_t(zz & 1);
+			*r_len += vlen;
+		} break;
+		case Variant::REAL: {
+
+			if (header & RPC_ARG_FLAG) {
+				ERR_FAIL_COND_V(len < 8, ERR_INVALID_DATA);
+				r_arg = decode_double(buf);
+				*r_len += 8;
+			} else {
+				ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
+				r_arg = decode_float(buf);
+				*r_len += 4;
+			}
+		} break;
+		case Variant::STRING: {
+
+			uint64_t str_len;
+			int vlen;
+			Error err = _decode_varint(str_len, buf, len, &vlen);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(str_len > uint64_t(len - vlen), ERR_INVALID_DATA);
+
+			String str;
+			str.parse_utf8((const char *)buf + vlen, str_len);
+			r_arg = str;
+			*r_len += vlen + str_len;
+		} break;
+		case Variant::VECTOR2: {
+
+			ERR_FAIL_COND_V(len < 4 * 2, ERR_INVALID_DATA);
+			r_arg = Vector2(decode_float(&buf[0]), decode_float(&buf[4]));
+			*r_len += 4 * 2;
+		} break;
+		case Variant::VECTOR3: {
+
+			ERR_FAIL_COND_V(len < 4 * 3, ERR_INVALID_DATA);
+			r_arg = Vector3(decode_float(&buf[0]), decode_float(&buf[4]), decode_float(&buf[8]));
+			*r_len += 4 * 3;
+		} break;
+		case Variant::QUAT: {
+
+			ERR_FAIL_COND_V(len < 4 * 4, ERR_INVALID_DATA);
+			r_arg = Quat(decode_float(&buf[0]), decode_float(&buf[4]), decode_float(&buf[8]), decode_float(&buf[12]));
+			*r_len += 4 * 4;
+		} break;
+		case Variant::COLOR: {
+
+			ERR_FAIL_COND_V(len < 4 * 4, ERR_INVALID_DATA);
+			r_arg = Color(decode_float(&buf[0]), decode_float(&buf[4]), decode_float(&buf[8]), decode_float(&buf[12]));
+			*r_len += 4 * 4;
+		} break;
+		default: {
+			ERR_FAIL_V(ERR_INVALID_DATA);
+		}
+	}
+
+	return OK;
+}
+
 void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_packet_len) {
 
 	ERR_FAIL_COND(root_node == NULL);
 	ERR_FAIL_COND(p_packet_len < 1);
 
-	uint8_t packet_type = p_packet[0];
+	uint8_t packet_type = p_packet[0] & NETWORK_COMMAND_MASK;
 
 	switch (packet_type) {
 
@@ -182,29 +472,45 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 
 			ERR_FAIL_COND(p_packet_len < 6);
 
-			Node *node = _process_get_node(p_from, p_packet, p_packet_len);
+			StringName name;
+			Node *node = _process_get_node(p_from, p_packet, p_packet_len, name);
 
 			ERR_FAIL_COND(node == NULL);
 
-			//detect cstring end
-			int len_end = 5;
-			for (; len_end < p_packet_len; len_end++) {
-				if (p_packet[len_end] == 0) {
-					break;
+			int ofs = 5;
+
+			if (p_packet[0] & NETWORK_COMMAND_FLAG_NAME) {
+				// name was not cached with the path, it follows as a string
+
+				//detect cstring end
+				int len_end = 5;
+				for (; len_end < p_packet_len; len_end++) {
+					if (p_packet[len_end] == 0) {
+						break;
+					}
 				}
+
+				ERR_FAIL_COND(len_end >= p_packet_len);
+
+				name = String::utf8((const char *)&p_packet[5]);
+				ofs = len_end + 1;
 			}
 
-			ERR_FAIL_COND(len_end >= p_packet_len);
+			ERR_FAIL_COND(name == StringName());
 
-			StringName name = String::utf8((const char *)&p_packet[5]);
+#ifdef DEBUG_ENABLED
+			if (profiling) {
+				_profile_message(node, name, packet_type == NETWORK_COMMAND_REMOTE_SET, true, p_packet_len);
+			}
+#endif
 
 			if (packet_type == NETWORK_COMMAND_REMOTE_CALL) {
 
-				_process_rpc(node, name, p_from, p_packet, p_packet_len, len_end + 1);
+				_process_rpc(node, name, p_from, p_packet, p_packet_len, ofs);
 
 			} else {
 
-				_process_rset(node, name, p_from, p_packet, p_packet_len, len_end + 1);
+				_process_rset(node, name, p_from, p_packet, p_packet_len, ofs);
 			}
 
 		} break;
@@ -213,10 +519,25 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 
 			_process_raw(p_from, p_packet, p_packet_len);
 		} break;
+
+		case NETWORK_COMMAND_SNAPSHOT: {
+
+			_process_snapshot(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_SNAPSHOT_ACK: {
+
+			_process_snapshot_ack(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_BATCH: {
+
+			_process_batch(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
-Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len) {
+Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len, StringName &r_name) {
 
 	uint32_t target = decode_uint32(&p_packet[1]);
 	Node *node = NULL;
@@ -236,6 +557,9 @@ Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int
 
 		if (!node)
 			ERR_PRINTS("Failed to get path from RPC: " + String(np));
+
+		if (np.get_subname_count())
+			r_name = np.get_subname(0);
 	} else {
 		//use cached path
 		int id = target;
@@ -252,6 +576,9 @@ Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int
 		node = root_node->get_node(ni->path);
 		if (!node)
 			ERR_PRINTS("Failed to get cached path from RPC: " + String(ni->path));
+
+		if (ni->path.get_subname_count())
+			r_name = ni->path.get_subname(0);
 	}
 	return node;
 }
@@ -282,7 +609,7 @@ void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_
 
 		ERR_FAIL_COND(p_offset >= p_packet_len);
 		int vlen;
-		Error err = decode_variant(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen);
+		Error err = _decode_rpc_arg(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen);
 		ERR_FAIL_COND(err != OK);
 		//args[i]=p_packet[3+i];
 		argp.write[i] = &args[i];
@@ -314,7 +641,9 @@ void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p
 	ERR_FAIL_COND(!_can_call_mode(p_node, rset_mode, p_from));
 
 	Variant value;
-	decode_variant(value, &p_packet[p_offset], p_packet_len - p_offset);
+	int vlen;
+	Error err = _decode_rpc_arg(value, &p_packet[p_offset], p_packet_len - p_offset, &vlen);
+	ERR_FAIL_COND(err != OK);
 
 	bool valid;
 
@@ -359,7 +688,7 @@ void MultiplayerAPI::_process_simplify_path(int p_from, const uint8_t *p_packet,
 
 	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
 	network_peer->set_target_peer(p_from);
-	network_peer->put_packet(packet.ptr(), packet.size());
+	_put_packet(packet.ptr(), packet.size());
 }
 
 void MultiplayerAPI::_process_confirm_path(int p_from, const uint8_t *p_packet, int p_packet_len) {
@@ -421,7 +750,7 @@ bool MultiplayerAPI::_send_confirm_path(NodePath p_path, PathSentCache *psc, int
 
 		network_peer->set_target_peer(E->get()); //to all of you
 		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
-		network_peer->put_packet(packet.ptr(), packet.size());
+		_put_packet(packet.ptr(), packet.size());
 
 		psc->confirmed_peers.insert(E->get(), false); //insert into confirmed, but as false since it was not confirmed
 	}
@@ -464,6 +793,16 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 	NodePath from_path = (root_node->get_path()).rel_path_to(p_from->get_path());
 	ERR_FAIL_COND(from_path.is_empty());
 
+	// the method or property name is cached along with the path as its subname,
+	// so once the path is confirmed neither is sent again
+	String name_str = p_name;
+	bool name_in_path = name_str.find("/") == -1 && name_str.find(":") == -1;
+	if (name_in_path) {
+		Vector<StringName> subnames;
+		subnames.push_back(p_name);
+		from_path = NodePath(from_path.get_names(), subnames, from_path.is_absolute());
+	}
+
 	//see if the path is cached
 	PathSentCache *psc = path_send_cache.getptr(from_path);
 	if (!psc) {
@@ -482,7 +821,7 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 
 	//encode type
 	MAKE_ROOM(1);
-	packet_cache.write[0] = p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL;
+	packet_cache.write[0] = (p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL) | (name_in_path ? 0 : NETWORK_COMMAND_FLAG_NAME);
 	ofs += 1;
 
 	//encode ID
@@ -490,19 +829,23 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 	encode_uint32(psc->id, &(packet_cache.write[ofs]));
 	ofs += 4;
 
-	//encode function name
-	CharString name = String(p_name).utf8();
-	int len = encode_cstring(name.get_data(), NULL);
-	MAKE_ROOM(ofs + len);
-	encode_cstring(name.get_data(), &(packet_cache.write[ofs]));
-	ofs += len;
+	int len;
+
+	if (!name_in_path) {
+		//encode function name
+		CharString name = name_str.utf8();
+		len = encode_cstring(name.get_data(), NULL);
+		MAKE_ROOM(ofs + len);
+		encode_cstring(name.get_data(), &(packet_cache.write[ofs]));
+		ofs += len;
+	}
 
 	if (p_set) {
 		//set argument
-		Error err = encode_variant(*p_arg[0], NULL, len);
+		Error err = _encode_rpc_arg(*p_arg[0], NULL, len);
 		ERR_FAIL_COND(err != OK);
 		MAKE_ROOM(ofs + len);
-		encode_variant(*p_arg[0], &(packet_cache.write[ofs]), len);
+		_encode_rpc_arg(*p_arg[0], &(packet_cache.write[ofs]), len);
 		ofs += len;
 
 	} else {
@@ -511,25 +854,27 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 		packet_cache.write[ofs] = p_argcount;
 		ofs += 1;
 		for (int i = 0; i < p_argcount; i++) {
-			Error err = encode_variant(*p_arg[i], NULL, len);
+			Error err = _encode_rpc_arg(*p_arg[i], NULL, len);
 			ERR_FAIL_COND(err != OK);
 			MAKE_ROOM(ofs + len);
-			encode_variant(*p_arg[i], &(packet_cache.write[ofs]), len);
+			_encode_rpc_arg(*p_arg[i], &(packet_cache.write[ofs]), len);
 			ofs += len;
 		}
 	}
 
+#ifdef DEBUG_ENABLED
+	if (profiling) {
+		_profile_message(p_from, p_name, p_set, false, ofs);
+	}
+#endif
+
 	//see if all peers have cached path (is so, call can be fast)
 	bool has_all_peers = _send_confirm_path(from_path, psc, p_to);
 
-	//take chance and set transfer mode, since all send methods will use it
-	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
-
 	if (has_all_peers) {
 
 		//they all have verified paths, so send fast
-		network_peer->set_target_peer(p_to); //to all of you
-		network_peer->put_packet(packet_cache.ptr(), ofs); //a message with love
+		_put_rpc_packet(p_to, p_unreliable, packet_cache.ptr(), ofs); //a message with love
 	} else {
 		//not all verified path, so send one by one
 
@@ -550,19 +895,101 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 			Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
 			ERR_CONTINUE(!F); //should never happen
 
-			network_peer->set_target_peer(E->get()); //to this one specifically
-
+			//to this one specifically
 			if (F->get() == true) {
 				//this one confirmed path, so use id
 				encode_uint32(psc->id, &(packet_cache.write[1]));
-				network_peer->put_packet(packet_cache.ptr(), ofs);
+				_put_rpc_packet(E->get(), p_unreliable, packet_cache.ptr(), ofs);
 			} else {
 				//this one did not confirm path yet, so use entire path (sorry!)
 				encode_uint32(0x80000000 | ofs, &(packet_cache.write[1])); //offset to path and flag
-				network_peer->put_packet(packet_cache.ptr(), ofs + path_len);
+				_put_rpc_packet(E->get(), p_unreliable, packet_cache.ptr(), ofs + path_len);
+			}
+		}
+	}
+}
+
+Error MultiplayerAPI::_put_packet(const uint8_t *p_packet, int p_packet_len) {
+
+	window_outgoing_bytes += p_packet_len;
+	return network_peer->put_packet(p_packet, p_packet_len);
+}
+
+void MultiplayerAPI::_put_rpc_packet(int p_to, bool p_unreliable, const uint8_t *p_packet, int p_packet_len) {
+
+	if (p_unreliable && rpc_batch_mode != RPC_BATCH_DISABLED && 1 + 5 + p_packet_len <= rpc_batch_max_size) {
+
+		// coalesce with other unreliable messages for the same target, sent on flush
+		Vector<uint8_t> &batch = rpc_batches[p_to];
+		int entry_len = _encode_varint(p_packet_len, NULL) + p_packet_len;
+
+		if (batch.size() && batch.size() + entry_len > rpc_batch_max_size) {
+			_flush_rpc_batch(p_to, batch);
+		}
+
+		if (batch.size() == 0) {
+			batch.push_back(NETWORK_COMMAND_BATCH);
+		}
+
+		int ofs = batch.size();
+		batch.resize(ofs + entry_len);
+		ofs += _encode_varint(p_packet_len, &batch.write[ofs]);
+		copymem(&batch.write[ofs], p_packet, p_packet_len);
+		return;
+	}
+
+	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+	network_peer->set_target_peer(p_to);
+	_put_packet(p_packet, p_packet_len);
+}
+
+void MultiplayerAPI::_flush_rpc_batch(int p_to, Vector<uint8_t> &r_batch) {
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->set_target_peer(p_to);
+	_put_packet(r_batch.ptr(), r_batch.size());
+	r_batch.resize(0);
+}
+
+void MultiplayerAPI::flush_rpc_batches() {
+
+	if (rpc_batches.empty())
+		return;
+
+	if (network_peer.is_valid() && network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED) {
+
+		for (Map<int, Vector<uint8_t> >::Element *E = rpc_batches.front(); E; E = E->next()) {
+			if (E->get().size()) {
+				_flush_rpc_batch(E->key(), E->get());
 			}
 		}
 	}
+
+	rpc_batches.clear();
+}
+
+void MultiplayerAPI::set_rpc_batch_mode(RPCBatchMode p_mode) {
+
+	rpc_batch_mode = p_mode;
+	if (rpc_batch_mode == RPC_BATCH_DISABLED) {
+		flush_rpc_batches();
+	}
+}
+
+MultiplayerAPI::RPCBatchMode MultiplayerAPI::get_rpc_batch_mode() const {
+
+	return rpc_batch_mode;
+}
+
+void MultiplayerAPI::set_rpc_batch_max_size(int p_size) {
+
+	ERR_FAIL_COND(p_size < 64);
+	rpc_batch_max_size = p_size;
+}
+
+int MultiplayerAPI::get_rpc_batch_max_size() const {
+
+	return rpc_batch_max_size;
 }
 
 void MultiplayerAPI::_add_peer(int p_id) {
@@ -574,6 +1001,7 @@ void MultiplayerAPI::_add_peer(int p_id) {
 void MultiplayerAPI::_del_peer(int p_id) {
 	connected_peers.erase(p_id);
 	path_get_cache.erase(p_id); //I no longer need your cache, sorry
+	replication_peers.erase(p_id);
 	emit_signal("network_peer_disconnected", p_id);
 }
 
@@ -718,7 +1146,30 @@ Error MultiplayerAPI::send_bytes(PoolVector<uint8_t> p_data, int p_to, Networked
 	network_peer->set_target_peer(p_to);
 	network_peer->set_transfer_mode(p_mode);
 
-	return network_peer->put_packet(packet_cache.ptr(), p_data.size() + 1);
+	return _put_packet(packet_cache.ptr(), p_data.size() + 1);
+}
+
+void MultiplayerAPI::_process_batch(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	int ofs = 1;
+
+	while (ofs < p_packet_len) {
+
+		uint64_t len;
+		int len_size;
+		Error err = _decode_varint(len, &p_packet[ofs], p_packet_len - ofs, &len_size);
+		ERR_FAIL_COND(err != OK);
+		ofs += len_size;
+
+		ERR_FAIL_COND(len < 1 || len > uint64_t(p_packet_len - ofs));
+		ERR_FAIL_COND(p_packet[ofs] == NETWORK_COMMAND_BATCH); //no nesting
+
+		_process_packet(p_from, &p_packet[ofs], len);
+		ofs += len;
+
+		if (!network_peer.is_valid())
+			return; //an RPC caused a disconnection
+	}
 }
 
 void MultiplayerAPI::_process_raw(int p_from, const uint8_t *p_packet, int p_packet_len) {
@@ -735,6 +1186,415 @@ void MultiplayerAPI::_process_raw(int p_from, const uint8_t *p_packet, int p_pac
 	emit_signal("network_peer_packet", p_from, out);
 }
 
+void MultiplayerAPI::replication_add(Object *p_node, const PoolStringArray &p_properties) {
+
+	Node *node = Object::cast_to<Node>(p_node);
+	ERR_FAIL_COND(!node);
+	ERR_FAIL_COND(p_properties.size() == 0 || p_properties.size() > 255);
+
+	ReplicatedNode rn;
+	rn.properties.resize(p_properties.size());
+	for (int i = 0; i < p_properties.size(); i++) {
+		rn.properties.write[i] = p_properties[i];
+	}
+
+	replicated_nodes[node->get_instance_id()] = rn;
+}
+
+void MultiplayerAPI::replication_remove(Object *p_node) {
+
+	ERR_FAIL_COND(!p_node);
+	replicated_nodes.erase(p_node->get_instance_id());
+}
+
+void MultiplayerAPI::replication_set_peer_visibility(Object *p_node, int p_peer, bool p_visible) {
+
+	ERR_FAIL_COND(!p_node);
+	Map<ObjectID, ReplicatedNode>::Element *E = replicated_nodes.find(p_node->get_instance_id());
+	ERR_FAIL_COND(!E);
+
+	if (p_visible) {
+		E->get().hidden_peers.erase(p_peer);
+	} else {
+		E->get().hidden_peers.insert(p_peer);
+	}
+}
+
+void MultiplayerAPI::replication_set_peer_origin(int p_peer, const Vector3 &p_origin) {
+
+	ReplicationPeer &rp = replication_peers[p_peer];
+	rp.origin = p_origin;
+	rp.has_origin = true;
+}
+
+void MultiplayerAPI::set_replication_interval(float p_interval) {
+
+	ERR_FAIL_COND(p_interval < 0);
+	replication_interval = p_interval;
+}
+
+float MultiplayerAPI::get_replication_interval() const {
+
+	return replication_interval;
+}
+
+void MultiplayerAPI::set_replication_max_distance(float p_distance) {
+
+	ERR_FAIL_COND(p_distance < 0);
+	replication_max_distance = p_distance;
+}
+
+float MultiplayerAPI::get_replication_max_distance() const {
+
+	return replication_max_distance;
+}
+
+static bool _values_equal(const Vector<Variant> &p_a, const Vector<Variant> &p_b) {
+
+	if (p_a.size() != p_b.size())
+		return false;
+
+	for (int i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i])
+			return false;
+	}
+
+	return true;
+}
+
+static void _put_varint(Vector<uint8_t> &r_packet, int &r_ofs, uint64_t p_value) {
+
+	int len = _encode_varint(p_value, NULL);
+	if (r_packet.size() < r_ofs + len)
+		r_packet.resize(r_ofs + len);
+	_encode_varint(p_value, &r_packet.write[r_ofs]);
+	r_ofs += len;
+}
+
+static void _put_rpc_arg(Vector<uint8_t> &r_packet, int &r_ofs, const Variant &p_value) {
+
+	int len;
+	Error err = _encode_rpc_arg(p_value, NULL, len);
+	ERR_FAIL_COND(err != OK);
+	if (r_packet.size() < r_ofs + len)
+		r_packet.resize(r_ofs + len);
+	_encode_rpc_arg(p_value, &r_packet.write[r_ofs], len);
+	r_ofs += len;
+}
+
+void MultiplayerAPI::_send_snapshots() {
+
+	// gather what this peer is master of, once for all peers
+	struct Gathered {
+		int path_id;
+		NodePath path;
+		const ReplicatedNode *rn;
+		Vector<Variant> values;
+		bool has_origin;
+		Vector3 origin;
+	};
+
+	Vector<Gathered> gathered;
+	List<ObjectID> dead;
+
+	for (Map<ObjectID, ReplicatedNode>::Element *E = replicated_nodes.front(); E; E = E->next()) {
+
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->key()));
+		if (!node) {
+			dead.push_back(E->key());
+			continue;
+		}
+
+		if (!node->is_inside_tree() || !node->is_network_master())
+			continue;
+
+		Gathered g;
+		g.path = root_node->get_path().rel_path_to(node->get_path());
+		g.rn = &E->get();
+
+		PathSentCache *psc = path_send_cache.getptr(g.path);
+		if (!psc) {
+			path_send_cache[g.path] = PathSentCache();
+			psc = path_send_cache.getptr(g.path);
+			psc->id = last_send_cache_id++;
+		}
+		g.path_id = psc->id;
+
+		g.values.resize(g.rn->properties.size());
+		for (int i = 0; i < g.rn->properties.size(); i++) {
+			g.values.write[i] = node->get(g.rn->properties[i]);
+		}
+
+		g.has_origin = false;
+		if (replication_max_distance > 0) {
+			Variant xform = node->get("global_transform");
+			if (xform.get_type() == Variant::TRANSFORM) {
+				g.origin = xform.operator Transform().origin;
+				g.has_origin = true;
+			} else if (xform.get_type() == Variant::TRANSFORM2D) {
+				Vector2 origin = xform.operator Transform2D().get_origin();
+				g.origin = Vector3(origin.x, origin.y, 0);
+				g.has_origin = true;
+			}
+		}
+
+		gathered.push_back(g);
+	}
+
+	for (List<ObjectID>::Element *E = dead.front(); E; E = E->next()) {
+		replicated_nodes.erase(E->get());
+	}
+
+	if (gathered.size() == 0)
+		return;
+
+	uint32_t snapshot_id = ++last_snapshot_id;
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+
+	for (Set<int>::Element *P = connected_peers.front(); P; P = P->next()) {
+
+		int peer = P->get();
+		ReplicationPeer &rp = replication_peers[peer];
+		const SnapshotState *base = rp.last_acked ? &rp.acked_state : NULL;
+
+		// the state this peer will have once it receives the snapshot, only relevant nodes are part of it
+		SnapshotState state;
+		Vector<int> relevant;
+
+		for (int i = 0; i < gathered.size(); i++) {
+
+			const Gathered &g = gathered[i];
+
+			if (g.rn->hidden_peers.has(peer))
+				continue;
+
+			if (g.has_origin && rp.has_origin && g.origin.distance_to(rp.origin) > replication_max_distance)
+				continue;
+
+			PathSentCache *psc = path_send_cache.getptr(g.path);
+			if (!_send_confirm_path(g.path, psc, peer))
+				continue; // path not known by the peer yet
+
+			state.set(g.path_id, g.values);
+			relevant.push_back(i);
+		}
+
+		int ofs = 0;
+		MAKE_ROOM(1 + 4 + 4);
+		packet_cache.write[0] = NETWORK_COMMAND_SNAPSHOT;
+		encode_uint32(snapshot_id, &packet_cache.write[1]);
+		encode_uint32(rp.last_acked, &packet_cache.write[5]);
+		ofs += 1 + 4 + 4;
+
+		// nodes the peer has in the baseline but no longer gets
+		Vector<int> removed;
+		if (base) {
+			const int *K = NULL;
+			while ((K = base->next(K))) {
+				if (!state.has(*K))
+					removed.push_back(*K);
+			}
+		}
+
+		_put_varint(packet_cache, ofs, removed.size());
+		for (int i = 0; i < removed.size(); i++) {
+			_put_varint(packet_cache, ofs, removed[i]);
+		}
+
+		// then only the properties that changed since the baseline
+		int count_ofs = ofs;
+		int changed_nodes = 0;
+		MAKE_ROOM(ofs + 4);
+		ofs += 4;
+
+		for (int i = 0; i < relevant.size(); i++) {
+
+			const Gathered &g = gathered[relevant[i]];
+			const Vector<Variant> *base_values = base ? base->getptr(g.path_id) : NULL;
+			if (base_values && base_values->size() != g.values.size())
+				base_values = NULL;
+
+			int changed = 0;
+			for (int j = 0; j < g.values.size(); j++) {
+				if (!base_values || (*base_values)[j] != g.values[j])
+					changed++;
+			}
+
+			if (changed == 0)
+				continue;
+
+			_put_varint(packet_cache, ofs, g.path_id);
+			_put_varint(packet_cache, ofs, changed);
+			for (int j = 0; j < g.values.size(); j++) {
+				if (!base_values || (*base_values)[j] != g.values[j]) {
+					_put_varint(packet_cache, ofs, j);
+					_put_rpc_arg(packet_cache, ofs, g.values[j]);
+				}
+			}
+
+			changed_nodes++;
+		}
+
+		if (changed_nodes == 0 && removed.size() == 0)
+			continue; // the peer already has all this
+
+		encode_uint32(changed_nodes, &packet_cache.write[count_ofs]);
+
+		network_peer->set_target_peer(peer);
+		_put_packet(packet_cache.ptr(), ofs);
+
+		rp.pending[snapshot_id] = state;
+		while (rp.pending.size() > MAX_PENDING_SNAPSHOTS) {
+			rp.pending.erase(rp.pending.front());
+		}
+	}
+}
+
+void MultiplayerAPI::_process_snapshot(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_FAIL_COND(p_packet_len < 9);
+
+	uint32_t snapshot_id = decode_uint32(&p_packet[1]);
+	uint32_t base_id = decode_uint32(&p_packet[5]);
+
+	ReplicationPeer &rp = replication_peers[p_from];
+	if (snapshot_id <= rp.last_received)
+		return; // older than what was applied, or a duplicate
+
+	SnapshotState state;
+	if (base_id) {
+		Map<uint32_t, SnapshotState>::Element *E = rp.received.find(base_id);
+		if (!E)
+			return; // baseline no longer known, wait for a newer snapshot
+		state = E->get();
+	}
+
+	int ofs = 9;
+	uint64_t value;
+	int len;
+
+	ERR_FAIL_COND(_decode_varint(value, &p_packet[ofs], p_packet_len - ofs, &len) != OK);
+	ofs += len;
+	int removed_count = value;
+
+	for (int i = 0; i < removed_count; i++) {
+		ERR_FAIL_COND(_decode_varint(value, &p_packet[ofs], p_packet_len - ofs, &len) != OK);
+		ofs += len;
+		state.erase(value);
+	}
+
+	ERR_FAIL_COND(ofs + 4 > p_packet_len);
+	int node_count = decode_uint32(&p_packet[ofs]);
+	ofs += 4;
+
+	Map<int, PathGetCache>::Element *PC = path_get_cache.find(p_from);
+	ERR_FAIL_COND(!PC);
+
+	for (int i = 0; i < node_count; i++) {
+
+		ERR_FAIL_COND(_decode_varint(value, &p_packet[ofs], p_packet_len - ofs, &len) != OK);
+		ofs += len;
+		int path_id = value;
+
+		ERR_FAIL_COND(_decode_varint(value, &p_packet[ofs], p_packet_len - ofs, &len) != OK);
+		ofs += len;
+		int changed = value;
+
+		Vector<Variant> values;
+		const Vector<Variant> *base_values = state.getptr(path_id);
+		if (base_values)
+			values = *base_values;
+
+		for (int j = 0; j < changed; j++) {
+
+			ERR_FAIL_COND(_decode_varint(value, &p_packet[ofs], p_packet_len - ofs, &len) != OK);
+			ofs += len;
+			int idx = value;
+			ERR_FAIL_COND(idx > 255);
+
+			Variant v;
+			ERR_FAIL_COND(_decode_rpc_arg(v, &p_packet[ofs], p_packet_len - ofs, &len) != OK);
+			ofs += len;
+
+			if (values.size() <= idx)
+				values.resize(idx + 1);
+			values.write[idx] = v;
+		}
+
+		state.set(path_id, values);
+	}
+
+	// apply whatever differs from what was last applied
+	const int *K = NULL;
+	while ((K = state.next(K))) {
+
+		const Vector<Variant> &values = *state.getptr(*K);
+		Vector<Variant> *applied = rp.applied.getptr(*K);
+		if (applied && _values_equal(*applied, values))
+			continue;
+
+		Map<int, PathGetCache::NodeInfo>::Element *F = PC->get().nodes.find(*K);
+		if (!F)
+			continue;
+
+		Node *node = root_node->get_node(F->get().path);
+		if (!node || node->get_network_master() != p_from)
+			continue;
+
+		Map<ObjectID, ReplicatedNode>::Element *E = replicated_nodes.find(node->get_instance_id());
+		if (!E)
+			continue;
+
+		const Vector<StringName> &properties = E->get().properties;
+		for (int i = 0; i < values.size() && i < properties.size(); i++) {
+			if (!applied || i >= applied->size() || (*applied)[i] != values[i]) {
+				node->set(properties[i], values[i]);
+			}
+		}
+
+		rp.applied.set(*K, values);
+	}
+
+	rp.received[snapshot_id] = state;
+	while (rp.received.size() > MAX_PENDING_SNAPSHOTS) {
+		rp.received.erase(rp.received.front());
+	}
+	rp.last_received = snapshot_id;
+
+	// acknowledge, so the sender can use it as the next baseline
+	uint8_t ack[5];
+	ack[0] = NETWORK_COMMAND_SNAPSHOT_ACK;
+	encode_uint32(snapshot_id, &ack[1]);
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->set_target_peer(p_from);
+	_put_packet(ack, 5);
+}
+
+void MultiplayerAPI::_process_snapshot_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_FAIL_COND(p_packet_len < 5);
+
+	uint32_t snapshot_id = decode_uint32(&p_packet[1]);
+
+	Map<int, ReplicationPeer>::Element *E = replication_peers.find(p_from);
+	if (!E || snapshot_id <= E->get().last_acked)
+		return;
+
+	ReplicationPeer &rp = E->get();
+	Map<uint32_t, SnapshotState>::Element *S = rp.pending.find(snapshot_id);
+	if (!S)
+		return;
+
+	rp.acked_state = S->get();
+	rp.last_acked = snapshot_id;
+
+	while (rp.pending.front() && rp.pending.front()->key() <= snapshot_id) {
+		rp.pending.erase(rp.pending.front());
+	}
+}
+
 int MultiplayerAPI::get_network_unique_id() const {
 
 	ERR_FAIL_COND_V(!network_peer.is_valid(), 0);
@@ -771,6 +1631,86 @@ Vector<int> MultiplayerAPI::get_network_connected_peers() const {
 	return ret;
 }
 
+int MultiplayerAPI::get_incoming_bandwidth_usage() const {
+
+	return incoming_bandwidth;
+}
+
+int MultiplayerAPI::get_outgoing_bandwidth_usage() const {
+
+	return outgoing_bandwidth;
+}
+
+float MultiplayerAPI::get_average_round_trip_time() const {
+
+	return average_round_trip_time;
+}
+
+void MultiplayerAPI::_profile_message(Node *p_node, const StringName &p_name, bool p_set, bool p_incoming, int p_bytes) {
+
+	Map<StringName, ProfilingInfo> &members = profiling_data[p_node->get_instance_id()];
+	Map<StringName, ProfilingInfo>::Element *E = members.find(p_name);
+
+	if (!E) {
+		ProfilingInfo info;
+		info.node = p_node->get_instance_id();
+		info.node_path = p_node->get_path();
+		info.name = p_name;
+		info.incoming_rpc = 0;
+		info.incoming_rset = 0;
+		info.outgoing_rpc = 0;
+		info.outgoing_rset = 0;
+		info.incoming_bytes = 0;
+		info.outgoing_bytes = 0;
+		E = members.insert(p_name, info);
+	}
+
+	ProfilingInfo &info = E->get();
+	if (p_incoming) {
+		if (p_set)
+			info.incoming_rset++;
+		else
+			info.incoming_rpc++;
+		info.incoming_bytes += p_bytes;
+	} else {
+		if (p_set)
+			info.outgoing_rset++;
+		else
+			info.outgoing_rpc++;
+		info.outgoing_bytes += p_bytes;
+	}
+}
+
+void MultiplayerAPI::profiling_start() {
+
+	profiling = true;
+	profiling_data.clear();
+}
+
+void MultiplayerAPI::profiling_end() {
+
+	profiling = false;
+	profiling_data.clear();
+}
+
+bool MultiplayerAPI::is_profiling() const {
+
+	return profiling;
+}
+
+void MultiplayerAPI::get_profiling_frame(Vector<ProfilingInfo> &r_info) {
+
+	r_info.clear();
+
+	for (Map<ObjectID, Map<StringName, ProfilingInfo> >::Element *E = profiling_data.front(); E; E = E->next()) {
+		for (Map<StringName, ProfilingInfo>::Element *F = E->get().front(); F; F = F->next()) {
+			r_info.push_back(F->get());
+		}
+	}
+
+	profiling_data.clear();
+}
+
 void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_node", "node"), &MultiplayerAPI::set_root_node);
 	ClassDB::bind_method(D_METHOD("send_bytes", "bytes", "id", "mode"), &MultiplayerAPI::send_bytes, DEFVAL(NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST), DEFVAL(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE));
@@ -791,7 +1731,27 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_network_connected_peers"), &MultiplayerAPI::get_network_connected_peers);
 	ClassDB::bind_method(D_METHOD("set_refuse_new_network_connections", "refuse"), &MultiplayerAPI::set_refuse_new_network_connections);
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
+	ClassDB::bind_method(D_METHOD("replication_add", "node", "properties"), &MultiplayerAPI::replication_add);
+	ClassDB::bind_method(D_METHOD("replication_remove", "node"), &MultiplayerAPI::replication_remove);
+	ClassDB::bind_method(D_METHOD("replication_set_peer_visibility", "node", "peer", "visible"), &MultiplayerAPI::replication_set_peer_visibility);
+	ClassDB::bind_method(D_METHOD("replication_set_peer_origin", "peer", "origin"), &MultiplayerAPI::replication_set_peer_origin);
+	ClassDB::bind_method(D_METHOD("set_replication_interval", "interval"), &MultiplayerAPI::set_replication_interval);
+	ClassDB::bind_method(D_METHOD("get_replication_interval"), &MultiplayerAPI::get_replication_interval);
+	ClassDB::bind_method(D_METHOD("set_replication_max_distance", "distance"), &MultiplayerAPI::set_replication_max_distance);
+	ClassDB::bind_method(D_METHOD("get_replication_max_distance"), &MultiplayerAPI::get_replication_max_distance);
+	ClassDB::bind_method(D_METHOD("set_rpc_batch_mode", "mode"), &MultiplayerAPI::set_rpc_batch_mode);
+	ClassDB::bind_method(D_METHOD("get_rpc_batch_mode"), &MultiplayerAPI::get_rpc_batch_mode);
+	ClassDB::bind_method(D_METHOD("set_rpc_batch_max_size", "size"), &MultiplayerAPI::set_rpc_batch_max_size);
+	ClassDB::bind_method(D_METHOD("get_rpc_batch_max_size"), &MultiplayerAPI::get_rpc_batch_max_size);
+	ClassDB::bind_method(D_METHOD("flush_rpc_batches"), &MultiplayerAPI::flush_rpc_batches);
+	ClassDB::bind_method(D_METHOD("get_incoming_bandwidth_usage"), &MultiplayerAPI::get_incoming_bandwidth_usage);
+	ClassDB::bind_method(D_METHOD("get_outgoing_bandwidth_usage"), &MultiplayerAPI::get_outgoing_bandwidth_usage);
+	ClassDB::bind_method(D_METHOD("get_average_round_trip_time"), &MultiplayerAPI::get_average_round_trip_time);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "replication_interval"), "set_replication_interval", "get_replication_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "replication_max_distance"), "set_replication_max_distance", "get_replication_max_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "rpc_batch_mode", PROPERTY_HINT_ENUM, "Disabled,Flush On Poll,Flush Manually"), "set_rpc_batch_mode", "get_rpc_batch_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "rpc_batch_max_size"), "set_rpc_batch_max_size", "get_rpc_batch_max_size");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
 
 	ADD_SIGNAL(MethodInfo("network_peer_connected", PropertyInfo(Variant::INT, "id")));
@@ -809,9 +1769,19 @@ void MultiplayerAPI::_bind_methods() {
 	BIND_ENUM_CONSTANT(RPC_MODE_REMOTESYNC);
 	BIND_ENUM_CONSTANT(RPC_MODE_MASTERSYNC);
 	BIND_ENUM_CONSTANT(RPC_MODE_SLAVESYNC);
+
+	BIND_ENUM_CONSTANT(RPC_BATCH_DISABLED);
+	BIND_ENUM_CONSTANT(RPC_BATCH_FLUSH_ON_POLL);
+	BIND_ENUM_CONSTANT(RPC_BATCH_FLUSH_MANUAL);
 }
 
 MultiplayerAPI::MultiplayerAPI() {
+	replication_interval = 0.05;
+	replication_max_distance = 0;
+	last_replication_usec = 0;
+	rpc_batch_mode = RPC_BATCH_DISABLED;
+	rpc_batch_max_size = 1200;
+	profiling = false;
 	clear();
 }
 
@@ -64,19 +64,71 @@ private:
 	Vector<uint8_t> packet_cache;
 	Node *root_node;
 
+	// snapshot replication, state is keyed by path cache id
+	typedef HashMap<int, Vector<Variant> > SnapshotState;
+
+	enum {
+		MAX_PENDING_SNAPSHOTS = 32
+	};
+
+	struct ReplicatedNode {
+		Vector<StringName> properties;
+		Set<int> hidden_peers;
+	};
+
+	struct ReplicationPeer {
+		// sending to the peer
+		uint32_t last_acked;
+		SnapshotState acked_state;
+		Map<uint32_t, SnapshotState> pending;
+		Vector3 origin;
+		bool has_origin;
+
+		// receiving from the peer
+		uint32_t last_received;
+		Map<uint32_t, SnapshotState> received;
+		SnapshotState applied;
+
+		ReplicationPeer() {
+			last_acked = 0;
+			has_origin = false;
+			last_received = 0;
+		}
+	};
+
+	Map<ObjectID, ReplicatedNode> replicated_nodes;
+	Map<int, ReplicationPeer> replication_peers;
+	uint32_t last_snapshot_id;
+	float replication_interval;
+	float replication_max_distance;
+	uint64_t last_replication_usec;
+
+	Map<int, Vector<uint8_t> > rpc_batches; // pending unreliable messages per target
+
 protected:
 	static void _bind_methods();
 
 	void _process_packet(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_simplify_path(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_confirm_path(int p_from, const uint8_t *p_packet, int p_packet_len);
-	Node *_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len);
+	Node *_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len, StringName &r_name);
 	void _process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_snapshot(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_snapshot_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+
+	void _send_snapshots();
+	void _process_batch(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _put_rpc_packet(int p_to, bool p_unreliable, const uint8_t *p_packet, int p_packet_len);
+	void _flush_rpc_batch(int p_to, Vector<uint8_t> &r_batch);
 
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(NodePath p_path, PathSentCache *psc, int p_from);
+	Error _put_packet(const uint8_t *p_packet, int p_packet_len);
+
+	void _update_network_stats(uint64_t p_now);
+	void _profile_message(Node *p_node, const StringName &p_name, bool p_set, bool p_incoming, int p_bytes);
 
 public:
 	enum NetworkCommands {
@@ -85,6 +137,14 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_SNAPSHOT,
+		NETWORK_COMMAND_SNAPSHOT_ACK,
+		NETWORK_COMMAND_BATCH,
+	};
+
+	enum {
+		NETWORK_COMMAND_MASK = 0x7F,
+		NETWORK_COMMAND_FLAG_NAME = 0x80 // Remote call/set carries the name as a string instead of in the cached path
 	};
 
 	enum RPCMode {
@@ -99,6 +159,42 @@ public:
 		RPC_MODE_SLAVESYNC, // Using rpc() on it will call method / set property in all slave peers and locally
 	};
 
+	enum RPCBatchMode {
+		RPC_BATCH_DISABLED,
+		RPC_BATCH_FLUSH_ON_POLL, // Unreliable messages are coalesced and sent at the end of poll()
+		RPC_BATCH_FLUSH_MANUAL, // Unreliable messages are coalesced until flush_rpc_batches() is called
+	};
+
+	// Remote calls and sets of a single method or property, as seen by the network profiler
+	struct ProfilingInfo {
+		ObjectID node;
+		String node_path;
+		StringName name;
+		int incoming_rpc;
+		int incoming_rset;
+		int outgoing_rpc;
+		int outgoing_rset;
+		int incoming_bytes;
+		int outgoing_bytes;
+	};
+
+private:
+	RPCBatchMode rpc_batch_mode;
+	int rpc_batch_max_size;
+
+	// traffic is measured over windows of one second
+	uint64_t stats_window_usec;
+	int window_incoming_bytes;
+	int window_outgoing_bytes;
+	int incoming_bandwidth;
+	int outgoing_bandwidth;
+	float average_round_trip_time;
+
+	bool profiling;
+	Map<ObjectID, Map<StringName, ProfilingInfo> > profiling_data;
+
+public:
+
 	void poll();
 	void clear();
 	void set_root_node(Node *p_node);
@@ -125,10 +221,35 @@ public:
 	void set_refuse_new_network_connections(bool p_refuse);
 	bool is_refusing_new_network_connections() const;
 
+	void replication_add(Object *p_node, const PoolStringArray &p_properties);
+	void replication_remove(Object *p_node);
+	void replication_set_peer_visibility(Object *p_node, int p_peer, bool p_visible);
+	void replication_set_peer_origin(int p_peer, const Vector3 &p_origin);
+	void set_replication_interval(float p_interval);
+	float get_replication_interval() const;
+	void set_replication_max_distance(float p_distance);
+	float get_replication_max_distance() const;
+
+	void set_rpc_batch_mode(RPCBatchMode p_mode);
+	RPCBatchMode get_rpc_batch_mode() const;
+	void set_rpc_batch_max_size(int p_size);
+	int get_rpc_batch_max_size() const;
+	void flush_rpc_batches();
+
+	int get_incoming_bandwidth_usage() const;
+	int get_outgoing_bandwidth_usage() const;
+	float get_average_round_trip_time() const;
+
+	void profiling_start();
+	void profiling_end();
+	bool is_profiling() const;
+	void get_profiling_frame(Vector<ProfilingInfo> &r_info); // Messages since the last call, the counters are reset
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
 
 VARIANT_ENUM_CAST(MultiplayerAPI::RPCMode);
+VARIANT_ENUM_CAST(MultiplayerAPI::RPCBatchMode);
 
 #endif // MULTIPLAYER_PROTOCOL_H
@@ -46,6 +46,8 @@ void NetworkedMultiplayerPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_refuse_new_connections", "enable"), &NetworkedMultiplayerPeer::set_refuse_new_connections);
 	ClassDB::bind_method(D_METHOD("is_refusing_new_connections"), &NetworkedMultiplayerPeer::is_refusing_new_connections);
 
+	ClassDB::bind_method(D_METHOD("get_peer_statistics", "id"), &NetworkedMultiplayerPeer::get_peer_statistics);
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_connections"), "set_refuse_new_connections", "is_refusing_new_connections");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "transfer_mode", PROPERTY_HINT_ENUM, "Unreliable,Unreliable Ordered,Reliable"), "set_transfer_mode", "get_transfer_mode");
 
@@ -67,5 +69,10 @@ void NetworkedMultiplayerPeer::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("connection_failed"));
 }
 
+Dictionary NetworkedMultiplayerPeer::get_peer_statistics(int p_peer_id) const {
+
+	return Dictionary();
+}
+
 NetworkedMultiplayerPeer::NetworkedMultiplayerPeer() {
 }
@@ -74,6 +74,9 @@ public:
 
 	virtual ConnectionStatus get_connection_status() const = 0;
 
+	// Transport level statistics of a directly connected peer, empty when not available
+	virtual Dictionary get_peer_statistics(int p_peer_id) const;
+
 	NetworkedMultiplayerPeer();
 };
 
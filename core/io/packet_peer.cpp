@@ -171,16 +171,23 @@ Error PacketPeerStream::_poll_buffer() const {
 
 	ERR_FAIL_COND_V(peer.is_null(), ERR_UNCONFIGURED);
 
-	int read = 0;
-	ERR_FAIL_COND_V(input_buffer.size() < ring_buffer.space_left(), ERR_UNAVAILABLE);
-	Error err = peer->get_partial_data(input_buffer.ptrw(), ring_buffer.space_left(), read);
-	if (err)
-		return err;
-	if (read == 0)
-		return OK;
+	// read straight into the ring buffer, the free space may wrap around its end
+	for (int i = 0; i < 2; i++) {
 
-	int w = ring_buffer.write(&input_buffer[0], read);
-	ERR_FAIL_COND_V(w != read, ERR_BUG);
+		uint8_t *w;
+		int space = ring_buffer.get_write_ptr(&w);
+		if (space == 0)
+			return OK;
+
+		int read = 0;
+		Error err = peer->get_partial_data(w, space, read);
+		if (err)
+			return err;
+
+		ring_buffer.advance_write(read);
+		if (read < space)
+			break;
+	}
 
 	return OK;
 }
@@ -189,9 +196,9 @@ int PacketPeerStream::get_available_packet_count() const {
 
 	_poll_buffer();
 
-	uint32_t remaining = ring_buffer.data_left();
+	uint32_t remaining = ring_buffer.data_left() - borrowed_bytes;
 
-	int ofs = 0;
+	int ofs = borrowed_bytes;
 	int count = 0;
 
 	while (remaining >= 4) {
@@ -214,6 +221,11 @@ int PacketPeerStream::get_available_packet_count() const {
 Error PacketPeerStream::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
 	ERR_FAIL_COND_V(peer.is_null(), ERR_UNCONFIGURED);
+
+	// release the packet lent by the previous call
+	ring_buffer.advance_read(borrowed_bytes);
+	borrowed_bytes = 0;
+
 	_poll_buffer();
 
 	int remaining = ring_buffer.data_left();
@@ -226,9 +238,17 @@ Error PacketPeerStream::get_packet(const uint8_t **r_buffer, int &r_buffer_size)
 
 	ERR_FAIL_COND_V(input_buffer.size() < len, ERR_UNAVAILABLE);
 	ring_buffer.read(lbuf, 4); //get rid of first 4 bytes
-	ring_buffer.read(input_buffer.ptrw(), len); // read packet
 
-	*r_buffer = &input_buffer[0];
+	const uint8_t *packet;
+	if (len && ring_buffer.get_read_ptr(&packet) >= (int)len) {
+		// contiguous, lend it from the ring buffer and keep it reserved until the next get_packet
+		borrowed_bytes = len;
+		*r_buffer = packet;
+	} else {
+		ring_buffer.read(input_buffer.ptrw(), len); // read packet
+		*r_buffer = &input_buffer[0];
+	}
+
 	r_buffer_size = len;
 	return OK;
 }
@@ -266,6 +286,7 @@ void PacketPeerStream::set_stream_peer(const Ref<StreamPeer> &p_peer) {
 
 	if (p_peer.ptr() != peer.ptr()) {
 		ring_buffer.advance_read(ring_buffer.data_left()); // reset the ring buffer
+		borrowed_bytes = 0;
 	};
 
 	peer = p_peer;
@@ -279,6 +300,8 @@ Ref<StreamPeer> PacketPeerStream::get_stream_peer() const {
 void PacketPeerStream::set_input_buffer_max_size(int p_max_size) {
 
 	//warning may lose packets
+	ring_buffer.advance_read(borrowed_bytes);
+	borrowed_bytes = 0;
 	ERR_EXPLAIN("Buffer in use, resizing would cause loss of data");
 	ERR_FAIL_COND(ring_buffer.data_left());
 	ring_buffer.resize(nearest_shift(p_max_size + 4));
@@ -307,4 +330,5 @@ PacketPeerStream::PacketPeerStream() {
 	ring_buffer.resize(rbsize);
 	input_buffer.resize(1 << rbsize);
 	output_buffer.resize(1 << rbsize);
+	borrowed_bytes = 0;
 }
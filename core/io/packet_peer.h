@@ -53,7 +53,7 @@ class PacketPeer : public Reference {
 
 public:
 	virtual int get_available_packet_count() const = 0;
-	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) = 0; ///< buffer is GONE after next get_packet
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) = 0; ///< buffer is borrowed, GONE after next get_packet or poll
 	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) = 0;
 
 	virtual int get_max_packet_size() const = 0;
@@ -83,6 +83,7 @@ class PacketPeerStream : public PacketPeer {
 	mutable RingBuffer<uint8_t> ring_buffer;
 	mutable Vector<uint8_t> input_buffer;
 	mutable Vector<uint8_t> output_buffer;
+	int borrowed_bytes; // packet lent from ring_buffer by get_packet
 
 	Error _poll_buffer() const;
 
@@ -58,6 +58,8 @@ public:
 	virtual int get_packet_port() const = 0;
 	virtual void set_dest_address(const IP_Address &p_address, int p_port) = 0;
 
+	virtual int get_socket_handle() const { return -1; }
+
 	static Ref<PacketPeerUDP> create_ref();
 	static PacketPeerUDP *create();
 
@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "pck_packer.h"
+#include "core/io/file_access_pack.h"
 #include "core/os/file_access.h"
 #include "version.h"
 
@@ -54,12 +55,12 @@ static void _pad(FileAccess *p_file, int p_bytes) {
 
 void PCKPacker::_bind_methods() {
 
-	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment"), &PCKPacker::pck_start);
+	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "compress"), &PCKPacker::pck_start, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path"), &PCKPacker::add_file);
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush);
 };
 
-Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
+Error PCKPacker::pck_start(const String &p_file, int p_alignment, bool p_compress) {
 
 	file = FileAccess::open(p_file, FileAccess::WRITE);
 	if (file == NULL) {
@@ -68,9 +69,10 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 	};
 
 	alignment = p_alignment;
+	compress = p_compress;
 
 	file->store_32(0x43504447); // MAGIC
-	file->store_32(1); // # version
+	file->store_32(PACK_FORMAT_VERSION); // # version
 	file->store_32(VERSION_MAJOR); // # major
 	file->store_32(VERSION_MINOR); // # minor
 	file->store_32(0); // # revision
@@ -129,6 +131,8 @@ Error PCKPacker::flush(bool p_verbose) {
 		file->store_32(0);
 		file->store_32(0);
 		file->store_32(0);
+
+		file->store_32(0); // flags
 	};
 
 	uint64_t ofs = file->get_position();
@@ -143,20 +147,38 @@ Error PCKPacker::flush(bool p_verbose) {
 	for (int i = 0; i < files.size(); i++) {
 
 		FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-		while (to_write > 0) {
-
-			int read = src->get_buffer(buf, MIN(to_write, buf_max));
-			file->store_buffer(buf, read);
-			to_write -= read;
-		};
+		uint32_t flags = 0;
+
+		Vector<uint8_t> data;
+		Vector<uint8_t> compressed;
+		if (compress) {
+			data.resize(files[i].size);
+			src->get_buffer(data.ptrw(), files[i].size);
+		}
+
+		if (compress && PackedSourcePCK::compress_file(data.ptr(), data.size(), compressed)) {
+			flags |= PACK_FILE_COMPRESSED;
+			file->store_buffer(compressed.ptr(), compressed.size());
+		} else if (compress) {
+			file->store_buffer(data.ptr(), data.size());
+		} else {
+			uint64_t to_write = files[i].size;
+			while (to_write > 0) {
+
+				int read = src->get_buffer(buf, MIN(to_write, buf_max));
+				file->store_buffer(buf, read);
+				to_write -= read;
+			};
+		}
 
 		uint64_t pos = file->get_position();
 		file->seek(files[i].offset_offset); // go back to store the file's offset
 		file->store_64(ofs);
+		file->seek(files[i].offset_offset + 8 + 8 + 16); // and flags
+		file->store_32(flags);
 		file->seek(pos);
 
-		ofs = _align(ofs + files[i].size, alignment);
+		ofs = _align(pos, alignment);
 		_pad(file, ofs - pos);
 
 		src->close();
@@ -182,6 +204,8 @@ Error PCKPacker::flush(bool p_verbose) {
 PCKPacker::PCKPacker() {
 
 	file = NULL;
+	alignment = 0;
+	compress = false;
 };
 
 PCKPacker::~PCKPacker() {
@@ -41,6 +41,7 @@ class PCKPacker : public Reference {
 
 	FileAccess *file;
 	int alignment;
+	bool compress;
 
 	static void _bind_methods();
 
@@ -54,7 +55,7 @@ class PCKPacker : public Reference {
 	Vector<File> files;
 
 public:
-	Error pck_start(const String &p_file, int p_alignment);
+	Error pck_start(const String &p_file, int p_alignment, bool p_compress = false);
 	Error add_file(const String &p_file, const String &p_src);
 	Error flush(bool p_verbose = false);
 
@@ -97,13 +97,13 @@ void ResourceInteractiveLoaderBinary::_advance_padding(uint32_t p_len) {
 	uint32_t extra = 4 - (p_len % 4);
 	if (extra < 4) {
 		for (uint32_t i = 0; i < extra; i++)
-			f->get_8(); //pad to 32
+			reader.get_8(); //pad to 32
 	}
 }
 
 StringName ResourceInteractiveLoaderBinary::_get_string() {
 
-	uint32_t id = f->get_32();
+	uint32_t id = reader.get_32();
 	if (id & 0x80000000) {
 		uint32_t len = id & 0x7FFFFFFF;
 		if (len > str_buf.size()) {
@@ -111,7 +111,13 @@ StringName ResourceInteractiveLoaderBinary::_get_string() {
 		}
 		if (len == 0)
 			return StringName();
-		f->get_buffer((uint8_t *)&str_buf[0], len);
+		const uint8_t *span = reader.get_span(len);
+		if (span) {
+			String s;
+			s.parse_utf8((const char *)span, len);
+			return s;
+		}
+		reader.get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
 		s.parse_utf8(&str_buf[0]);
 		return s;
@@ -122,7 +128,7 @@ StringName ResourceInteractiveLoaderBinary::_get_string() {
 
 Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 
-	uint32_t type = f->get_32();
+	uint32_t type = reader.get_32();
 	print_bl("find property of type: " + itos(type));
 
 	switch (type) {
@@ -133,23 +139,23 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_BOOL: {
 
-			r_v = bool(f->get_32());
+			r_v = bool(reader.get_32());
 		} break;
 		case VARIANT_INT: {
 
-			r_v = int(f->get_32());
+			r_v = int(reader.get_32());
 		} break;
 		case VARIANT_INT64: {
 
-			r_v = int64_t(f->get_64());
+			r_v = int64_t(reader.get_64());
 		} break;
 		case VARIANT_REAL: {
 
-			r_v = f->get_real();
+			r_v = reader.get_real();
 		} break;
 		case VARIANT_DOUBLE: {
 
-			r_v = f->get_double();
+			r_v = reader.get_double();
 		} break;
 		case VARIANT_STRING: {
 
@@ -158,110 +164,110 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		case VARIANT_VECTOR2: {
 
 			Vector2 v;
-			v.x = f->get_real();
-			v.y = f->get_real();
+			v.x = reader.get_real();
+			v.y = reader.get_real();
 			r_v = v;
 
 		} break;
 		case VARIANT_RECT2: {
 
 			Rect2 v;
-			v.position.x = f->get_real();
-			v.position.y = f->get_real();
-			v.size.x = f->get_real();
-			v.size.y = f->get_real();
+			v.position.x = reader.get_real();
+			v.position.y = reader.get_real();
+			v.size.x = reader.get_real();
+			v.size.y = reader.get_real();
 			r_v = v;
 
 		} break;
 		case VARIANT_VECTOR3: {
 
 			Vector3 v;
-			v.x = f->get_real();
-			v.y = f->get_real();
-			v.z = f->get_real();
+			v.x = reader.get_real();
+			v.y = reader.get_real();
+			v.z = reader.get_real();
 			r_v = v;
 		} break;
 		case VARIANT_PLANE: {
 
 			Plane v;
-			v.normal.x = f->get_real();
-			v.normal.y = f->get_real();
-			v.normal.z = f->get_real();
-			v.d = f->get_real();
+			v.normal.x = reader.get_real();
+			v.normal.y = reader.get_real();
+			v.normal.z = reader.get_real();
+			v.d = reader.get_real();
 			r_v = v;
 		} break;
 		case VARIANT_QUAT: {
 			Quat v;
-			v.x = f->get_real();
-			v.y = f->get_real();
-			v.z = f->get_real();
-			v.w = f->get_real();
+			v.x = reader.get_real();
+			v.y = reader.get_real();
+			v.z = reader.get_real();
+			v.w = reader.get_real();
 			r_v = v;
 
 		} break;
 		case VARIANT_AABB: {
 
 			AABB v;
-			v.position.x = f->get_real();
-			v.position.y = f->get_real();
-			v.position.z = f->get_real();
-			v.size.x = f->get_real();
-			v.size.y = f->get_real();
-			v.size.z = f->get_real();
+			v.position.x = reader.get_real();
+			v.position.y = reader.get_real();
+			v.position.z = reader.get_real();
+			v.size.x = reader.get_real();
+			v.size.y = reader.get_real();
+			v.size.z = reader.get_real();
 			r_v = v;
 
 		} break;
 		case VARIANT_MATRIX32: {
 
 			Transform2D v;
-			v.elements[0].x = f->get_real();
-			v.elements[0].y = f->get_real();
-			v.elements[1].x = f->get_real();
-			v.elements[1].y = f->get_real();
-			v.elements[2].x = f->get_real();
-			v.elements[2].y = f->get_real();
+			v.elements[0].x = reader.get_real();
+			v.elements[0].y = reader.get_real();
+			v.elements[1].x = reader.get_real();
+			v.elements[1].y = reader.get_real();
+			v.elements[2].x = reader.get_real();
+			v.elements[2].y = reader.get_real();
 			r_v = v;
 
 		} break;
 		case VARIANT_MATRIX3: {
 
 			Basis v;
-			v.elements[0].x = f->get_real();
-			v.elements[0].y = f->get_real();
-			v.elements[0].z = f->get_real();
-			v.elements[1].x = f->get_real();
-			v.elements[1].y = f->get_real();
-			v.elements[1].z = f->get_real();
-			v.elements[2].x = f->get_real();
-			v.elements[2].y = f->get_real();
-			v.elements[2].z = f->get_real();
+			v.elements[0].x = reader.get_real();
+			v.elements[0].y = reader.get_real();
+			v.elements[0].z = reader.get_real();
+			v.elements[1].x = reader.get_real();
+			v.elements[1].y = reader.get_real();
+			v.elements[1].z = reader.get_real();
+			v.elements[2].x = reader.get_real();
+			v.elements[2].y = reader.get_real();
+			v.elements[2].z = reader.get_real();
 			r_v = v;
 
 		} break;
 		case VARIANT_TRANSFORM: {
 
 			Transform v;
-			v.basis.elements[0].x = f->get_real();
-			v.basis.elements[0].y = f->get_real();
-			v.basis.elements[0].z = f->get_real();
-			v.basis.elements[1].x = f->get_real();
-			v.basis.elements[1].y = f->get_real();
-			v.basis.elements[1].z = f->get_real();
-			v.basis.elements[2].x = f->get_real();
-			v.basis.elements[2].y = f->get_real();
-			v.basis.elements[2].z = f->get_real();
-			v.origin.x = f->get_real();
-			v.origin.y = f->get_real();
-			v.origin.z = f->get_real();
+			v.basis.elements[0].x = reader.get_real();
+			v.basis.elements[0].y = reader.get_real();
+			v.basis.elements[0].z = reader.get_real();
+			v.basis.elements[1].x = reader.get_real();
+			v.basis.elements[1].y = reader.get_real();
+			v.basis.elements[1].z = reader.get_real();
+			v.basis.elements[2].x = reader.get_real();
+			v.basis.elements[2].y = reader.get_real();
+			v.basis.elements[2].z = reader.get_real();
+			v.origin.x = reader.get_real();
+			v.origin.y = reader.get_real();
+			v.origin.z = reader.get_real();
 			r_v = v;
 		} break;
 		case VARIANT_COLOR: {
 
 			Color v;
-			v.r = f->get_real();
-			v.g = f->get_real();
-			v.b = f->get_real();
-			v.a = f->get_real();
+			v.r = reader.get_real();
+			v.g = reader.get_real();
+			v.b = reader.get_real();
+			v.a = reader.get_real();
 			r_v = v;
 
 		} break;
@@ -272,8 +278,8 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<StringName> subnames;
 			bool absolute;
 
-			int name_count = f->get_16();
-			uint32_t subname_count = f->get_16();
+			int name_count = reader.get_16();
+			uint32_t subname_count = reader.get_16();
 			absolute = subname_count & 0x8000;
 			subname_count &= 0x7FFF;
 			if (ver_format < FORMAT_VERSION_NO_NODEPATH_PROPERTY) {
@@ -292,11 +298,11 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_RID: {
 
-			r_v = f->get_32();
+			r_v = reader.get_32();
 		} break;
 		case VARIANT_OBJECT: {
 
-			uint32_t type = f->get_32();
+			uint32_t type = reader.get_32();
 
 			switch (type) {
 
@@ -305,7 +311,7 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 
 				} break;
 				case OBJECT_INTERNAL_RESOURCE: {
-					uint32_t index = f->get_32();
+					uint32_t index = reader.get_32();
 					String path = res_path + "::" + itos(index);
 					RES res = ResourceLoader::load(path);
 					if (res.is_null()) {
@@ -339,7 +345,7 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE_INDEX: {
 					//new file format, just refers to an index in the external list
-					int erindex = f->get_32();
+					int erindex = reader.get_32();
 
 					if (erindex < 0 || erindex >= external_resources.size()) {
 						WARN_PRINT("Broken external resource! (index out of size");
@@ -372,7 +378,7 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_DICTIONARY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 			Dictionary d; //last bit means shared
 			len &= 0x7FFFFFFF;
 			for (uint32_t i = 0; i < len; i++) {
@@ -388,7 +394,7 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 			Array a; //last bit means shared
 			len &= 0x7FFFFFFF;
 			a.resize(len);
@@ -403,12 +409,12 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_RAW_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 
 			PoolVector<uint8_t> array;
 			array.resize(len);
 			PoolVector<uint8_t>::Write w = array.write();
-			f->get_buffer(w.ptr(), len);
+			reader.get_buffer(w.ptr(), len);
 			_advance_padding(len);
 			w = PoolVector<uint8_t>::Write();
 			r_v = array;
@@ -416,12 +422,12 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_INT_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 
 			PoolVector<int> array;
 			array.resize(len);
 			PoolVector<int>::Write w = array.write();
-			f->get_buffer((uint8_t *)w.ptr(), len * 4);
+			reader.get_buffer((uint8_t *)w.ptr(), len * 4);
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -437,12 +443,12 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_REAL_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 
 			PoolVector<real_t> array;
 			array.resize(len);
 			PoolVector<real_t>::Write w = array.write();
-			f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t));
+			reader.get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t));
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -459,7 +465,7 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_STRING_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 			PoolVector<String> array;
 			array.resize(len);
 			PoolVector<String>::Write w = array.write();
@@ -471,13 +477,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_VECTOR2_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 
 			PoolVector<Vector2> array;
 			array.resize(len);
 			PoolVector<Vector2>::Write w = array.write();
 			if (sizeof(Vector2) == 8) {
-				f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 2);
+				reader.get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 2);
 #ifdef BIG_ENDIAN_ENABLED
 				{
 					uint32_t *ptr = (uint32_t *)w.ptr();
@@ -499,13 +505,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_VECTOR3_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 
 			PoolVector<Vector3> array;
 			array.resize(len);
 			PoolVector<Vector3>::Write w = array.write();
 			if (sizeof(Vector3) == 12) {
-				f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 3);
+				reader.get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 3);
 #ifdef BIG_ENDIAN_ENABLED
 				{
 					uint32_t *ptr = (uint32_t *)w.ptr();
@@ -527,13 +533,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_COLOR_ARRAY: {
 
-			uint32_t len = f->get_32();
+			uint32_t len = reader.get_32();
 
 			PoolVector<Color> array;
 			array.resize(len);
 			PoolVector<Color>::Write w = array.write();
 			if (sizeof(Color) == 16) {
-				f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 4);
+				reader.get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 4);
 #ifdef BIG_ENDIAN_ENABLED
 				{
 					uint32_t *ptr = (uint32_t *)w.ptr();
@@ -554,15 +560,15 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 #ifndef DISABLE_DEPRECATED
 		case VARIANT_IMAGE: {
-			uint32_t encoding = f->get_32();
+			uint32_t encoding = reader.get_32();
 			if (encoding == IMAGE_ENCODING_EMPTY) {
 				r_v = Ref<Image>();
 				break;
 			} else if (encoding == IMAGE_ENCODING_RAW) {
-				uint32_t width = f->get_32();
-				uint32_t height = f->get_32();
-				uint32_t mipmaps = f->get_32();
-				uint32_t format = f->get_32();
+				uint32_t width = reader.get_32();
+				uint32_t height = reader.get_32();
+				uint32_t mipmaps = reader.get_32();
+				uint32_t format = reader.get_32();
 				const uint32_t format_version_shift = 24;
 				const uint32_t format_version_mask = format_version_shift - 1;
 
@@ -577,12 +583,12 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 
 				Image::Format fmt = Image::Format(format & format_version_mask); //if format changes, we can add a compatibility bit on top
 
-				uint32_t datalen = f->get_32();
+				uint32_t datalen = reader.get_32();
 
 				PoolVector<uint8_t> imgdata;
 				imgdata.resize(datalen);
 				PoolVector<uint8_t>::Write w = imgdata.write();
-				f->get_buffer(w.ptr(), datalen);
+				reader.get_buffer(w.ptr(), datalen);
 				_advance_padding(datalen);
 				w = PoolVector<uint8_t>::Write();
 
@@ -594,9 +600,9 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			} else {
 				//compressed
 				PoolVector<uint8_t> data;
-				data.resize(f->get_32());
+				data.resize(reader.get_32());
 				PoolVector<uint8_t>::Write w = data.write();
-				f->get_buffer(w.ptr(), data.size());
+				reader.get_buffer(w.ptr(), data.size());
 				w = PoolVector<uint8_t>::Write();
 
 				Ref<Image> image;
@@ -639,6 +645,22 @@ Error ResourceInteractiveLoaderBinary::poll() {
 
 	int s = stage;
 
+	if (s == 0 && external_resources.size()) {
+
+		// start loading every dependency in the background, the loads below then mostly hit the cache
+		Vector<String> paths;
+		Vector<String> types;
+		for (int i = 0; i < external_resources.size(); i++) {
+			String path = external_resources[i].path;
+			if (remaps.has(path)) {
+				path = remaps[path];
+			}
+			paths.push_back(path);
+			types.push_back(external_resources[i].type);
+		}
+		prefetch = ResourceLoader::prefetch_dependencies(local_path, paths, types);
+	}
+
 	if (s < external_resources.size()) {
 
 		String path = external_resources[s].path;
@@ -669,6 +691,11 @@ Error ResourceInteractiveLoaderBinary::poll() {
 
 	s -= external_resources.size();
 
+	if (prefetch) {
+		ResourceLoader::finish_prefetch(prefetch);
+		prefetch = NULL;
+	}
+
 	if (s >= internal_resources.size()) {
 
 		error = ERR_BUG;
@@ -704,7 +731,7 @@ Error ResourceInteractiveLoaderBinary::poll() {
 
 	uint64_t offset = internal_resources[s].offset;
 
-	f->seek(offset);
+	reader.seek(offset);
 
 	String t = get_unicode_string();
 
@@ -728,7 +755,7 @@ Error ResourceInteractiveLoaderBinary::poll() {
 	r->set_path(path);
 	r->set_subindex(subindex);
 
-	int pc = f->get_32();
+	int pc = reader.get_32();
 
 	//set properties
 
@@ -758,6 +785,7 @@ Error ResourceInteractiveLoaderBinary::poll() {
 
 	if (main) {
 
+		reader.close();
 		f->close();
 		resource = res;
 		resource->set_as_translation_remapped(translation_remapped);
@@ -803,13 +831,19 @@ static String get_ustring(FileAccess *f) {
 
 String ResourceInteractiveLoaderBinary::get_unicode_string() {
 
-	int len = f->get_32();
+	int len = reader.get_32();
 	if (len > str_buf.size()) {
 		str_buf.resize(len);
 	}
 	if (len == 0)
 		return String();
-	f->get_buffer((uint8_t *)&str_buf[0], len);
+	const uint8_t *span = reader.get_span(len);
+	if (span) {
+		String s;
+		s.parse_utf8((const char *)span, len);
+		return s;
+	}
+	reader.get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
 	s.parse_utf8(&str_buf[0]);
 	return s;
@@ -854,14 +888,16 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 		ERR_FAIL();
 	}
 
-	bool big_endian = f->get_32();
-	bool use_real64 = f->get_32();
+	reader.open(f);
 
-	f->set_endian_swap(big_endian != 0); //read big endian if saved as big endian
+	bool big_endian = reader.get_32();
+	bool use_real64 = reader.get_32();
 
-	uint32_t ver_major = f->get_32();
-	uint32_t ver_minor = f->get_32();
-	ver_format = f->get_32();
+	reader.set_endian_swap(big_endian != 0); //read big endian if saved as big endian
+
+	uint32_t ver_major = reader.get_32();
+	uint32_t ver_minor = reader.get_32();
+	ver_format = reader.get_32();
 
 	print_bl("big endian: " + itos(big_endian));
 #ifdef BIG_ENDIAN_ENABLED
@@ -876,6 +912,7 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 
 	if (ver_format > FORMAT_VERSION || ver_major > VERSION_MAJOR) {
 
+		reader.close();
 		f->close();
 		ERR_EXPLAIN("File Format '" + itos(FORMAT_VERSION) + "." + itos(ver_major) + "." + itos(ver_minor) + "' is too new! Please upgrade to a new engine version: " + local_path);
 		ERR_FAIL();
@@ -885,11 +922,11 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 
 	print_bl("type: " + type);
 
-	importmd_ofs = f->get_64();
+	importmd_ofs = reader.get_64();
 	for (int i = 0; i < 14; i++)
-		f->get_32(); //skip a few reserved fields
+		reader.get_32(); //skip a few reserved fields
 
-	uint32_t string_table_size = f->get_32();
+	uint32_t string_table_size = reader.get_32();
 	string_map.resize(string_table_size);
 	for (uint32_t i = 0; i < string_table_size; i++) {
 
@@ -899,7 +936,7 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 
 	print_bl("strings: " + itos(string_table_size));
 
-	uint32_t ext_resources_size = f->get_32();
+	uint32_t ext_resources_size = reader.get_32();
 	for (uint32_t i = 0; i < ext_resources_size; i++) {
 
 		ExtResource er;
@@ -911,19 +948,19 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 	}
 
 	print_bl("ext resources: " + itos(ext_resources_size));
-	uint32_t int_resources_size = f->get_32();
+	uint32_t int_resources_size = reader.get_32();
 
 	for (uint32_t i = 0; i < int_resources_size; i++) {
 
 		IntResource ir;
 		ir.path = get_unicode_string();
-		ir.offset = f->get_64();
+		ir.offset = reader.get_64();
 		internal_resources.push_back(ir);
 	}
 
 	print_bl("int resources: " + itos(int_resources_size));
 
-	if (f->eof_reached()) {
+	if (reader.eof_reached()) {
 
 		error = ERR_FILE_CORRUPT;
 		ERR_EXPLAIN("Premature End Of File: " + local_path);
@@ -950,17 +987,20 @@ String ResourceInteractiveLoaderBinary::recognize(FileAccess *p_f) {
 		return "";
 	}
 
-	bool big_endian = f->get_32();
-	f->get_32(); // use_real64
+	reader.open(f);
 
-	f->set_endian_swap(big_endian != 0); //read big endian if saved as big endian
+	bool big_endian = reader.get_32();
+	reader.get_32(); // use_real64
 
-	uint32_t ver_major = f->get_32();
-	f->get_32(); // ver_minor
-	uint32_t ver_format = f->get_32();
+	reader.set_endian_swap(big_endian != 0); //read big endian if saved as big endian
+
+	uint32_t ver_major = reader.get_32();
+	reader.get_32(); // ver_minor
+	uint32_t ver_format = reader.get_32();
 
 	if (ver_format > FORMAT_VERSION || ver_major > VERSION_MAJOR) {
 
+		reader.close();
 		f->close();
 		return "";
 	}
@@ -974,12 +1014,15 @@ ResourceInteractiveLoaderBinary::ResourceInteractiveLoaderBinary() {
 
 	f = NULL;
 	stage = 0;
+	prefetch = NULL;
 	error = OK;
 	translation_remapped = false;
 }
 
 ResourceInteractiveLoaderBinary::~ResourceInteractiveLoaderBinary() {
 
+	if (prefetch)
+		ResourceLoader::finish_prefetch(prefetch);
 	if (f)
 		memdelete(f);
 }
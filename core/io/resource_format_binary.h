@@ -31,6 +31,7 @@
 #ifndef RESOURCE_FORMAT_BINARY_H
 #define RESOURCE_FORMAT_BINARY_H
 
+#include "io/buffered_file_reader.h"
 #include "io/resource_loader.h"
 #include "io/resource_saver.h"
 #include "os/file_access.h"
@@ -45,6 +46,7 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 	uint32_t ver_format;
 
 	FileAccess *f;
+	BufferedFileReader reader;
 
 	uint64_t importmd_ofs;
 
@@ -77,6 +79,7 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 	Error error;
 
 	int stage;
+	ResourceLoader::DependencyPrefetch *prefetch;
 
 	friend class ResourceFormatLoaderBinary;
 
@@ -86,6 +86,7 @@ public:
 	virtual String get_resource_type() const = 0;
 	virtual float get_priority() const { return 1.0; }
 	virtual int get_import_order() const { return 0; }
+	virtual bool can_import_threaded() const { return false; } //import() may run on worker threads, several files at a time
 
 	struct ImportOption {
 		PropertyInfo option;
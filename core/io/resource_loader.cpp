@@ -29,12 +29,15 @@
 /*************************************************************************/
 
 #include "resource_loader.h"
+#include "io/file_access_pack.h"
 #include "io/resource_import.h"
 #include "os/file_access.h"
 #include "os/os.h"
+#include "os/trace.h"
 #include "path_remap.h"
 #include "print_string.h"
 #include "project_settings.h"
+#include "safe_refcount.h"
 #include "translation.h"
 #include "variant_parser.h"
 ResourceFormatLoader *ResourceLoader::loader[MAX_LOADERS];
@@ -189,6 +192,9 @@ RES ResourceLoader::_load(const String &p_path, const String &p_original_path, c
 
 RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 
+	MemoryTagScope tag(Memory::TAG_RESOURCES);
+	TRACE_SCOPE("ResourceLoader::load");
+
 	if (r_error)
 		*r_error = ERR_CANT_OPEN;
 
@@ -204,7 +210,10 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 			print_line("load resource: " + local_path + " (cached)");
 		if (r_error)
 			*r_error = OK;
-		return RES(ResourceCache::get(local_path));
+		RES cached = RES(ResourceCache::get(local_path));
+		atomic_increment(&ResourceCache::hits);
+		ResourceCache::retain(cached);
+		return cached;
 	}
 
 	bool xl_remapped = false;
@@ -212,12 +221,31 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 
 	ERR_FAIL_COND_V(path == "", RES());
 
+	if (!p_no_cache) {
+		// If another thread is already loading this path, wait for it and share its result.
+		while (!_begin_loading(local_path)) {
+			if (ResourceCache::has(local_path)) {
+				if (r_error)
+					*r_error = OK;
+				RES cached = RES(ResourceCache::get(local_path));
+				atomic_increment(&ResourceCache::hits);
+				ResourceCache::retain(cached);
+				return cached;
+			}
+		}
+	}
+
 	if (OS::get_singleton()->is_stdout_verbose())
 		print_line("load resource: " + path);
 
+	if (!p_no_cache)
+		atomic_increment(&ResourceCache::misses);
+
 	RES res = _load(path, local_path, p_type_hint, p_no_cache, r_error);
 
 	if (res.is_null()) {
+		if (!p_no_cache)
+			_end_loading(local_path);
 		return RES();
 	}
 	if (!p_no_cache)
@@ -236,6 +264,304 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 	}
 #endif
 
+	if (!p_no_cache) {
+		_end_loading(local_path);
+		ResourceCache::retain(res);
+	}
+
+	return res;
+}
+
+bool ResourceLoader::_begin_loading(const String &p_local_path) {
+
+	if (!thread_load_mutex)
+		return true;
+
+	Thread::ID caller = Thread::get_caller_id();
+
+	thread_load_mutex->lock();
+
+	Map<String, LoadingPath *>::Element *E = loading_paths.find(p_local_path);
+	if (!E) {
+		LoadingPath *lp = memnew(LoadingPath);
+		lp->thread = caller;
+		lp->depth = 1;
+		lp->waiters = 0;
+		lp->semaphore = NULL;
+		loading_paths[p_local_path] = lp;
+		thread_load_mutex->unlock();
+		return true;
+	}
+
+	LoadingPath *lp = E->get();
+
+	// Waiting would deadlock if the owner is (transitively) waiting on this thread,
+	// this only happens with cyclic resources, so let the loader report it instead.
+	Thread::ID owner = lp->thread;
+	while (owner != caller) {
+		Map<Thread::ID, String>::Element *W = waiting_threads.find(owner);
+		if (!W)
+			break;
+		Map<String, LoadingPath *>::Element *O = loading_paths.find(W->get());
+		if (!O)
+			break; //about to wake up
+		owner = O->get()->thread;
+	}
+
+	if (owner == caller) {
+		lp->depth++;
+		thread_load_mutex->unlock();
+		return true;
+	}
+
+	if (!lp->semaphore)
+		lp->semaphore = Semaphore::create();
+	lp->waiters++;
+	waiting_threads[caller] = p_local_path;
+	thread_load_mutex->unlock();
+
+	lp->semaphore->wait();
+
+	thread_load_mutex->lock();
+	waiting_threads.erase(caller);
+	lp->waiters--;
+	if (lp->waiters == 0) {
+		// the owner is done with it already, last waiter frees it
+		memdelete(lp->semaphore);
+		memdelete(lp);
+	}
+	thread_load_mutex->unlock();
+
+	return false;
+}
+
+void ResourceLoader::_end_loading(const String &p_local_path) {
+
+	if (!thread_load_mutex)
+		return;
+
+	MutexLock lock(thread_load_mutex);
+
+	Map<String, LoadingPath *>::Element *E = loading_paths.find(p_local_path);
+	ERR_FAIL_COND(!E);
+
+	LoadingPath *lp = E->get();
+	lp->depth--;
+	if (lp->depth > 0)
+		return;
+
+	loading_paths.erase(E);
+
+	if (lp->waiters == 0) {
+		if (lp->semaphore)
+			memdelete(lp->semaphore);
+		memdelete(lp);
+		return;
+	}
+
+	for (int i = 0; i < lp->waiters; i++) {
+		lp->semaphore->post();
+	}
+}
+
+static String _get_local_path(const String &p_path) {
+
+	if (p_path.is_rel_path())
+		return "res://" + p_path;
+	return ProjectSettings::get_singleton()->localize_path(p_path);
+}
+
+RES ResourceLoader::_load_with_dependencies(const String &p_path, const String &p_type_hint, const Set<String> &p_ancestors, WorkerThreadPool::Priority p_priority, Error *r_error) {
+
+	String local_path = _get_local_path(p_path);
+
+	if (!ResourceCache::has(local_path)) {
+
+		// Load the dependencies that are not in memory yet in parallel, the
+		// resource itself will then find them in the cache.
+		List<String> dependencies;
+		get_dependencies(local_path, &dependencies, true);
+
+		ThreadLoadDependencies ld;
+		ld.ancestors = p_ancestors;
+		ld.ancestors.insert(local_path);
+		ld.priority = p_priority;
+
+		for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+
+			String dep = E->get();
+			String type;
+			int sep = dep.find("::");
+			if (sep != -1) {
+				type = dep.substr(sep + 2, dep.length());
+				dep = dep.substr(0, sep);
+			}
+			dep = _get_local_path(dep);
+
+			if (ld.ancestors.has(dep) || ResourceCache::has(dep))
+				continue;
+
+			ld.paths.push_back(dep);
+			ld.types.push_back(type);
+		}
+
+		if (ld.paths.size()) {
+			_prefetch_pack_data(ld.paths);
+
+			ld.resources.resize(ld.paths.size());
+			ld.results = ld.resources.ptrw();
+
+			WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+			pool->wait_for_group_task_completion(pool->add_group_task(_thread_load_dependency, &ld, ld.paths.size(), p_priority));
+		}
+	}
+
+	return load(local_path, p_type_hint, false, r_error);
+}
+
+void ResourceLoader::_thread_load_dependency(void *p_userdata, uint32_t p_index) {
+
+	ThreadLoadDependencies *ld = (ThreadLoadDependencies *)p_userdata;
+
+	// keep the result referenced until the dependant resource is loaded
+	Error err;
+	ld->results[p_index] = _load_with_dependencies(ld->paths[p_index], ld->types[p_index], ld->ancestors, ld->priority, &err);
+}
+
+void ResourceLoader::_thread_load_function(void *p_userdata, uint32_t p_index) {
+
+	ThreadLoadTask *task = (ThreadLoadTask *)p_userdata;
+
+	task->resource = _load_with_dependencies(task->local_path, task->type_hint, Set<String>(), task->priority, &task->error);
+}
+
+struct ResourceLoader::DependencyPrefetch : public ResourceLoader::ThreadLoadDependencies {
+	WorkerThreadPool::GroupID group;
+};
+
+ResourceLoader::DependencyPrefetch *ResourceLoader::prefetch_dependencies(const String &p_path, const Vector<String> &p_dependencies, const Vector<String> &p_types) {
+
+	ERR_FAIL_COND_V(p_dependencies.size() != p_types.size(), NULL);
+
+	if (!thread_load_mutex || !GLOBAL_GET("application/run/prefetch_dependencies"))
+		return NULL;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool->get_thread_count() == 0)
+		return NULL;
+
+	String local_path = _get_local_path(p_path);
+
+	DependencyPrefetch *prefetch = memnew(DependencyPrefetch);
+	prefetch->ancestors.insert(local_path);
+	prefetch->priority = WorkerThreadPool::PRIORITY_NORMAL;
+
+	for (int i = 0; i < p_dependencies.size(); i++) {
+
+		String dep = _get_local_path(p_dependencies[i]);
+		if (dep == local_path || ResourceCache::has(dep))
+			continue;
+		// scripts compile against global state, leave them to the calling thread
+		if (p_types[i] != String() && ClassDB::is_parent_class(p_types[i], "Script"))
+			continue;
+
+		prefetch->paths.push_back(dep);
+		prefetch->types.push_back(p_types[i]);
+	}
+
+	if (prefetch->paths.empty()) {
+		memdelete(prefetch);
+		return NULL;
+	}
+
+	_prefetch_pack_data(prefetch->paths);
+
+	prefetch->resources.resize(prefetch->paths.size());
+	prefetch->results = prefetch->resources.ptrw();
+	prefetch->group = pool->add_group_task(_thread_load_dependency, prefetch, prefetch->paths.size(), prefetch->priority);
+
+	return prefetch;
+}
+
+void ResourceLoader::finish_prefetch(DependencyPrefetch *p_prefetch) {
+
+	ERR_FAIL_COND(!p_prefetch);
+
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(p_prefetch->group);
+	memdelete(p_prefetch);
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, WorkerThreadPool::Priority p_priority) {
+
+	ERR_FAIL_COND_V(!thread_load_mutex, ERR_UNCONFIGURED);
+
+	String local_path = _get_local_path(p_path);
+
+	MutexLock lock(thread_load_mutex);
+
+	if (thread_load_tasks.has(local_path))
+		return OK; //already requested
+
+	ThreadLoadTask *task = memnew(ThreadLoadTask);
+	task->local_path = local_path;
+	task->type_hint = p_type_hint;
+	task->priority = p_priority;
+	task->error = ERR_BUSY;
+	task->group = WorkerThreadPool::get_singleton()->add_task(_thread_load_function, task, p_priority);
+
+	thread_load_tasks[local_path] = task;
+
+	return OK;
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path) {
+
+	ERR_FAIL_COND_V(!thread_load_mutex, THREAD_LOAD_INVALID_RESOURCE);
+
+	String local_path = _get_local_path(p_path);
+
+	MutexLock lock(thread_load_mutex);
+
+	Map<String, ThreadLoadTask *>::Element *E = thread_load_tasks.find(local_path);
+	if (!E)
+		return THREAD_LOAD_INVALID_RESOURCE;
+
+	ThreadLoadTask *task = E->get();
+	if (!WorkerThreadPool::get_singleton()->is_group_task_completed(task->group))
+		return THREAD_LOAD_IN_PROGRESS;
+
+	return task->resource.is_valid() ? THREAD_LOAD_LOADED : THREAD_LOAD_FAILED;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
+
+	if (r_error)
+		*r_error = ERR_INVALID_PARAMETER;
+
+	ERR_FAIL_COND_V(!thread_load_mutex, RES());
+
+	String local_path = _get_local_path(p_path);
+
+	ThreadLoadTask *task;
+	{
+		MutexLock lock(thread_load_mutex);
+
+		Map<String, ThreadLoadTask *>::Element *E = thread_load_tasks.find(local_path);
+		ERR_EXPLAIN("Resource was not requested for threaded loading: " + local_path);
+		ERR_FAIL_COND_V(!E, RES());
+
+		task = E->get();
+		thread_load_tasks.erase(E);
+	}
+
+	// blocks if still in progress, helping with the load meanwhile
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(task->group);
+
+	RES res = task->resource;
+	if (r_error)
+		*r_error = task->error;
+	memdelete(task);
+
 	return res;
 }
 
@@ -503,6 +829,31 @@ String ResourceLoader::_path_remap(const String &p_path, bool *r_translation_rem
 	return new_path;
 }
 
+void ResourceLoader::_prefetch_pack_data(const Vector<String> &p_local_paths) {
+
+	PackedData *packs = PackedData::get_singleton();
+	if (!packs || !packs->has_remote_packs())
+		return;
+
+	// let packs read over HTTP fetch every dependency at once instead of one after the other.
+	// imported resources live in the internal path from their .import file, which is needed first
+	Vector<String> imported;
+	for (int i = 0; i < p_local_paths.size(); i++) {
+
+		String path = _path_remap(p_local_paths[i]);
+		packs->prefetch_path(path);
+
+		if (ResourceFormatImporter::get_singleton()->recognize_path(path)) {
+			packs->prefetch_path(path + ".import");
+			imported.push_back(path);
+		}
+	}
+
+	for (int i = 0; i < imported.size(); i++) {
+		packs->prefetch_path(import_remap(imported[i]));
+	}
+}
+
 String ResourceLoader::import_remap(const String &p_path) {
 
 	if (ResourceFormatImporter::get_singleton()->recognize_path(p_path)) {
@@ -583,6 +934,34 @@ void ResourceLoader::load_path_remaps() {
 	}
 }
 
+void ResourceLoader::initialize() {
+
+	thread_load_mutex = Mutex::create(true, "ResourceLoader");
+}
+
+void ResourceLoader::clear_thread_load_tasks() {
+
+	// finish outstanding threaded loads, nobody will pick them up anymore
+	while (true) {
+		String path;
+		{
+			MutexLock lock(thread_load_mutex);
+			if (thread_load_tasks.empty())
+				break;
+			path = thread_load_tasks.front()->key();
+		}
+		load_threaded_get(path);
+	}
+}
+
+void ResourceLoader::finalize() {
+
+	clear_thread_load_tasks();
+
+	memdelete(thread_load_mutex);
+	thread_load_mutex = NULL;
+}
+
 void ResourceLoader::clear_path_remaps() {
 
 	path_remaps.clear();
@@ -600,3 +979,8 @@ bool ResourceLoader::timestamp_on_load = false;
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String> > ResourceLoader::translation_remaps;
 HashMap<String, String> ResourceLoader::path_remaps;
+
+Mutex *ResourceLoader::thread_load_mutex = NULL;
+Map<String, ResourceLoader::LoadingPath *> ResourceLoader::loading_paths;
+Map<Thread::ID, String> ResourceLoader::waiting_threads;
+Map<String, ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_tasks;
@@ -31,7 +31,12 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "os/worker_thread_pool.h"
 #include "resource.h"
+#include "set.h"
 
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
@@ -77,7 +82,15 @@ typedef void (*ResourceLoadErrorNotify)(void *p_ud, const String &p_text);
 typedef void (*DependencyErrorNotify)(void *p_ud, const String &p_loading, const String &p_which, const String &p_type);
 
 class ResourceLoader {
+public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
 
+private:
 	enum {
 		MAX_LOADERS = 64
 	};
@@ -95,6 +108,7 @@ class ResourceLoader {
 	static HashMap<String, String> path_remaps;
 
 	static String _path_remap(const String &p_path, bool *r_translation_remapped = NULL);
+	static void _prefetch_pack_data(const Vector<String> &p_local_paths);
 	friend class Resource;
 
 	static SelfList<Resource>::List remapped_list;
@@ -103,10 +117,57 @@ class ResourceLoader {
 	//internal load function
 	static RES _load(const String &p_path, const String &p_original_path, const String &p_type_hint, bool p_no_cache, Error *r_error);
 
+	// paths currently being loaded, so concurrent loads of the same path wait instead of loading twice
+	struct LoadingPath {
+		Thread::ID thread;
+		int depth;
+		int waiters;
+		Semaphore *semaphore;
+	};
+
+	struct ThreadLoadTask {
+		String local_path;
+		String type_hint;
+		WorkerThreadPool::Priority priority;
+		WorkerThreadPool::GroupID group;
+		Error error;
+		RES resource;
+	};
+
+	struct ThreadLoadDependencies {
+		Vector<String> paths;
+		Vector<String> types;
+		Vector<RES> resources;
+		RES *results;
+		Set<String> ancestors;
+		WorkerThreadPool::Priority priority;
+	};
+
+	static Mutex *thread_load_mutex;
+	static Map<String, LoadingPath *> loading_paths;
+	static Map<Thread::ID, String> waiting_threads;
+	static Map<String, ThreadLoadTask *> thread_load_tasks;
+
+	static bool _begin_loading(const String &p_local_path);
+	static void _end_loading(const String &p_local_path);
+
+	static RES _load_with_dependencies(const String &p_path, const String &p_type_hint, const Set<String> &p_ancestors, WorkerThreadPool::Priority p_priority, Error *r_error);
+	static void _thread_load_dependency(void *p_userdata, uint32_t p_index);
+	static void _thread_load_function(void *p_userdata, uint32_t p_index);
+
 public:
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", WorkerThreadPool::Priority p_priority = WorkerThreadPool::PRIORITY_NORMAL);
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path);
+	static RES load_threaded_get(const String &p_path, Error *r_error = NULL);
+	static void clear_thread_load_tasks();
+
+	struct DependencyPrefetch;
+	static DependencyPrefetch *prefetch_dependencies(const String &p_path, const Vector<String> &p_dependencies, const Vector<String> &p_types);
+	static void finish_prefetch(DependencyPrefetch *p_prefetch);
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(ResourceFormatLoader *p_format_loader, bool p_at_front = false);
 	static String get_resource_type(const String &p_path);
@@ -145,6 +206,9 @@ public:
 	static void reload_translation_remaps();
 	static void load_translation_remaps();
 	static void clear_translation_remaps();
+
+	static void initialize();
+	static void finalize();
 };
 
 #endif
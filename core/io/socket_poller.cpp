@@ -0,0 +1,237 @@
+/*************************************************************************/
+/*  socket_poller.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "socket_poller.h"
+
+#include "io/packet_peer_udp.h"
+#include "io/stream_peer_tcp.h"
+#include "io/tcp_server.h"
+
+SocketPoller *(*SocketPoller::_create)() = NULL;
+
+int SocketPoller::_get_socket_handle(const Ref<Reference> &p_socket) {
+
+	if (p_socket.is_null())
+		return -1;
+
+	if (const TCP_Server *server = Object::cast_to<TCP_Server>(p_socket.ptr()))
+		return server->get_socket_handle();
+	if (const StreamPeerTCP *stream = Object::cast_to<StreamPeerTCP>(p_socket.ptr()))
+		return stream->get_socket_handle();
+	if (const PacketPeerUDP *udp = Object::cast_to<PacketPeerUDP>(p_socket.ptr()))
+		return udp->get_socket_handle();
+
+	return -1;
+}
+
+Map<int, SocketPoller::Entry>::Element *SocketPoller::_find_entry(const Ref<Reference> &p_socket) {
+
+	// the handle changes when a socket is closed or reopened, so fall back to a linear search
+	Map<int, Entry>::Element *E = entries.find(_get_socket_handle(p_socket));
+	if (E && E->get().socket == p_socket)
+		return E;
+
+	for (E = entries.front(); E; E = E->next()) {
+		if (E->get().socket == p_socket)
+			return E;
+	}
+
+	return NULL;
+}
+
+Error SocketPoller::add(const Ref<Reference> &p_socket, int p_events) {
+
+	ERR_FAIL_COND_V(p_socket.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!(p_events & (EVENT_READ | EVENT_WRITE)), ERR_INVALID_PARAMETER);
+
+	int handle = _get_socket_handle(p_socket);
+	ERR_FAIL_COND_V(handle < 0, ERR_UNCONFIGURED);
+
+	Map<int, Entry>::Element *E = entries.find(handle);
+	if (E) {
+		ERR_FAIL_COND_V(E->get().socket == p_socket, ERR_ALREADY_EXISTS);
+
+		// the previous owner of this handle was closed without being removed
+		_update_handle(handle, E->get().events, 0);
+		entries.erase(E);
+	}
+
+	Error err = _update_handle(handle, 0, p_events & (EVENT_READ | EVENT_WRITE));
+	ERR_FAIL_COND_V(err != OK, err);
+
+	Entry entry;
+	entry.socket = p_socket;
+	entry.events = p_events & (EVENT_READ | EVENT_WRITE);
+	entries[handle] = entry;
+
+	return OK;
+}
+
+Error SocketPoller::modify(const Ref<Reference> &p_socket, int p_events) {
+
+	ERR_FAIL_COND_V(!(p_events & (EVENT_READ | EVENT_WRITE)), ERR_INVALID_PARAMETER);
+
+	Map<int, Entry>::Element *E = _find_entry(p_socket);
+	ERR_FAIL_COND_V(!E, ERR_DOES_NOT_EXIST);
+
+	int events = p_events & (EVENT_READ | EVENT_WRITE);
+	if (E->get().events == events)
+		return OK;
+
+	Error err = _update_handle(E->key(), E->get().events, events);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	E->get().events = events;
+	return OK;
+}
+
+void SocketPoller::remove(const Ref<Reference> &p_socket) {
+
+	Map<int, Entry>::Element *E = _find_entry(p_socket);
+	if (!E)
+		return;
+
+	_update_handle(E->key(), E->get().events, 0);
+	entries.erase(E);
+
+	for (int i = 0; i < ready.size(); i++) {
+		if (ready[i].socket == p_socket) {
+			ready.remove(i);
+			break;
+		}
+	}
+}
+
+bool SocketPoller::has(const Ref<Reference> &p_socket) const {
+
+	return const_cast<SocketPoller *>(this)->_find_entry(p_socket) != NULL;
+}
+
+void SocketPoller::clear() {
+
+	for (Map<int, Entry>::Element *E = entries.front(); E; E = E->next()) {
+		_update_handle(E->key(), E->get().events, 0);
+	}
+
+	entries.clear();
+	ready.clear();
+}
+
+int SocketPoller::get_socket_count() const {
+
+	return entries.size();
+}
+
+int SocketPoller::wait(int p_timeout_msec) {
+
+	ready.clear();
+
+	if (entries.empty())
+		return 0;
+
+	ready_handles.clear();
+	Error err = _wait(p_timeout_msec, ready_handles);
+	ERR_FAIL_COND_V(err != OK, 0);
+
+	for (int i = 0; i < ready_handles.size(); i++) {
+
+		const HandleEvent &he = ready_handles[i];
+
+		Map<int, Entry>::Element *E = entries.find(he.handle);
+		if (!E)
+			continue;
+
+		if (_get_socket_handle(E->get().socket) != he.handle) {
+			// socket was closed or reopened since it was added, drop it
+			_update_handle(he.handle, E->get().events, 0);
+			entries.erase(E);
+			continue;
+		}
+
+		Ready r;
+		r.socket = E->get().socket;
+		r.events = he.events;
+		ready.push_back(r);
+	}
+
+	return ready.size();
+}
+
+int SocketPoller::get_ready_count() const {
+
+	return ready.size();
+}
+
+Ref<Reference> SocketPoller::get_ready_socket(int p_idx) const {
+
+	ERR_FAIL_INDEX_V(p_idx, ready.size(), Ref<Reference>());
+	return ready[p_idx].socket;
+}
+
+int SocketPoller::get_ready_events(int p_idx) const {
+
+	ERR_FAIL_INDEX_V(p_idx, ready.size(), 0);
+	return ready[p_idx].events;
+}
+
+Ref<SocketPoller> SocketPoller::create_ref() {
+
+	if (!_create)
+		return NULL;
+	return Ref<SocketPoller>(_create());
+}
+
+SocketPoller *SocketPoller::create() {
+
+	if (!_create)
+		return NULL;
+	return _create();
+}
+
+void SocketPoller::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add", "socket", "events"), &SocketPoller::add, DEFVAL(EVENT_READ));
+	ClassDB::bind_method(D_METHOD("modify", "socket", "events"), &SocketPoller::modify);
+	ClassDB::bind_method(D_METHOD("remove", "socket"), &SocketPoller::remove);
+	ClassDB::bind_method(D_METHOD("has", "socket"), &SocketPoller::has);
+	ClassDB::bind_method(D_METHOD("clear"), &SocketPoller::clear);
+	ClassDB::bind_method(D_METHOD("get_socket_count"), &SocketPoller::get_socket_count);
+	ClassDB::bind_method(D_METHOD("wait", "timeout_msec"), &SocketPoller::wait, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_ready_count"), &SocketPoller::get_ready_count);
+	ClassDB::bind_method(D_METHOD("get_ready_socket", "idx"), &SocketPoller::get_ready_socket);
+	ClassDB::bind_method(D_METHOD("get_ready_events", "idx"), &SocketPoller::get_ready_events);
+
+	BIND_ENUM_CONSTANT(EVENT_READ);
+	BIND_ENUM_CONSTANT(EVENT_WRITE);
+	BIND_ENUM_CONSTANT(EVENT_ERROR);
+}
+
+SocketPoller::SocketPoller() {
+}
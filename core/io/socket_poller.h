@@ -0,0 +1,104 @@
+/*************************************************************************/
+/*  socket_poller.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SOCKET_POLLER_H
+#define SOCKET_POLLER_H
+
+#include "map.h"
+#include "reference.h"
+
+class SocketPoller : public Reference {
+
+	GDCLASS(SocketPoller, Reference);
+
+public:
+	enum Event {
+
+		EVENT_READ = 1,
+		EVENT_WRITE = 2,
+		EVENT_ERROR = 4,
+	};
+
+protected:
+	struct Entry {
+
+		Ref<Reference> socket;
+		int events;
+	};
+
+	struct HandleEvent {
+
+		int handle;
+		int events;
+	};
+
+	struct Ready {
+
+		Ref<Reference> socket;
+		int events;
+	};
+
+	Map<int, Entry> entries; // by socket handle
+	Vector<HandleEvent> ready_handles;
+	Vector<Ready> ready;
+
+	static SocketPoller *(*_create)();
+	static void _bind_methods();
+
+	static int _get_socket_handle(const Ref<Reference> &p_socket);
+	Map<int, Entry>::Element *_find_entry(const Ref<Reference> &p_socket);
+
+	// p_old_events is 0 when adding a handle, p_new_events is 0 when removing it
+	virtual Error _update_handle(int p_handle, int p_old_events, int p_new_events) = 0;
+	virtual Error _wait(int p_timeout_msec, Vector<HandleEvent> &r_ready) = 0;
+
+public:
+	Error add(const Ref<Reference> &p_socket, int p_events = EVENT_READ);
+	Error modify(const Ref<Reference> &p_socket, int p_events);
+	void remove(const Ref<Reference> &p_socket);
+	bool has(const Ref<Reference> &p_socket) const;
+	void clear();
+
+	int get_socket_count() const;
+
+	int wait(int p_timeout_msec = 0);
+	int get_ready_count() const;
+	Ref<Reference> get_ready_socket(int p_idx) const;
+	int get_ready_events(int p_idx) const;
+
+	static Ref<SocketPoller> create_ref();
+	static SocketPoller *create();
+
+	SocketPoller();
+};
+
+VARIANT_ENUM_CAST(SocketPoller::Event);
+
+#endif // SOCKET_POLLER_H
@@ -67,6 +67,8 @@ public:
 	virtual uint16_t get_connected_port() const = 0;
 	virtual void set_no_delay(bool p_enabled) = 0;
 
+	virtual int get_socket_handle() const { return -1; }
+
 	static Ref<StreamPeerTCP> create_ref();
 	static StreamPeerTCP *create();
 
@@ -52,6 +52,8 @@ public:
 
 	virtual void stop() = 0; //stop listening
 
+	virtual int get_socket_handle() const { return -1; }
+
 	static Ref<TCP_Server> create_ref();
 	static TCP_Server *create();
 
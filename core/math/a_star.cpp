@@ -32,14 +32,19 @@
 #include "geometry.h"
 #include "scene/scene_string_names.h"
 #include "script_language.h"
+#include "sort.h"
 
 int AStar::get_available_point_id() const {
 
-	if (points.empty()) {
-		return 1;
+	if (points.has(last_free_id)) {
+		int cur_new_id = last_free_id + 1;
+		while (points.has(cur_new_id)) {
+			cur_new_id++;
+		}
+		const_cast<int &>(last_free_id) = cur_new_id;
 	}
 
-	return points.back()->key() + 1;
+	return last_free_id;
 }
 
 void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
@@ -47,78 +52,108 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 	ERR_FAIL_COND(p_id < 0);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	if (!points.has(p_id)) {
+	Point *found_pt;
+	bool p_exists = points.lookup(p_id, found_pt);
+
+	if (!p_exists) {
 		Point *pt = memnew(Point);
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
 		pt->prev_point = NULL;
-		pt->last_pass = 0;
-		points[p_id] = pt;
+		pt->g_score = 0;
+		pt->open_pass = 0;
+		pt->closed_pass = 0;
+		points.set(p_id, pt);
 	} else {
-		points[p_id]->pos = p_pos;
-		points[p_id]->weight_scale = p_weight_scale;
+		found_pt->pos = p_pos;
+		found_pt->weight_scale = p_weight_scale;
 	}
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), Vector3());
+	Point *p;
+	bool p_exists = points.lookup(p_id, p);
+	ERR_FAIL_COND_V(!p_exists, Vector3());
 
-	return points[p_id]->pos;
+	return p->pos;
 }
 
 void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	Point *p;
+	bool p_exists = points.lookup(p_id, p);
+	ERR_FAIL_COND(!p_exists);
 
-	points[p_id]->pos = p_pos;
+	p->pos = p_pos;
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), 0);
+	Point *p;
+	bool p_exists = points.lookup(p_id, p);
+	ERR_FAIL_COND_V(!p_exists, 0);
 
-	return points[p_id]->weight_scale;
+	return p->weight_scale;
 }
 
 void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	Point *p;
+	bool p_exists = points.lookup(p_id, p);
+	ERR_FAIL_COND(!p_exists);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	points[p_id]->weight_scale = p_weight_scale;
+	p->weight_scale = p_weight_scale;
 }
 
 void AStar::remove_point(int p_id) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	Point *p;
+	bool p_exists = points.lookup(p_id, p);
+	ERR_FAIL_COND(!p_exists);
+
+	for (int i = 0; i < p->neighbours.size(); i++) {
 
-	Point *p = points[p_id];
+		Point *n = p->neighbours[i];
+		segments.erase(Segment(p_id, n->id));
+		n->incoming_neighbours.erase(p);
+	}
 
-	for (Set<Point *>::Element *E = p->neighbours.front(); E; E = E->next()) {
+	for (int i = 0; i < p->incoming_neighbours.size(); i++) {
 
-		Segment s(p_id, E->get()->id);
-		segments.erase(s);
-		E->get()->neighbours.erase(p);
+		Point *n = p->incoming_neighbours[i];
+		segments.erase(Segment(p_id, n->id));
+		n->neighbours.erase(p);
 	}
 
 	memdelete(p);
-	points.erase(p_id);
+	points.remove(p_id);
+	last_free_id = p_id;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 
-	ERR_FAIL_COND(!points.has(p_id));
-	ERR_FAIL_COND(!points.has(p_with_id));
 	ERR_FAIL_COND(p_id == p_with_id);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.insert(b);
+	Point *a;
+	bool from_exists = points.lookup(p_id, a);
+	ERR_FAIL_COND(!from_exists);
+
+	Point *b;
+	bool to_exists = points.lookup(p_with_id, b);
+	ERR_FAIL_COND(!to_exists);
 
-	if (bidirectional)
-		b->neighbours.insert(a);
+	if (a->neighbours.find(b) == -1) {
+		a->neighbours.push_back(b);
+		b->incoming_neighbours.push_back(a);
+	}
+
+	if (bidirectional && b->neighbours.find(a) == -1) {
+		b->neighbours.push_back(a);
+		a->incoming_neighbours.push_back(b);
+	}
 
 	Segment s(p_id, p_with_id);
 	if (s.from == p_id) {
@@ -138,10 +173,15 @@ void AStar::disconnect_points(int p_id, int p_with_id) {
 
 	segments.erase(s);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
+	Point *a;
+	points.lookup(p_id, a);
+	Point *b;
+	points.lookup(p_with_id, b);
+
 	a->neighbours.erase(b);
+	a->incoming_neighbours.erase(b);
 	b->neighbours.erase(a);
+	b->incoming_neighbours.erase(a);
 }
 
 bool AStar::has_point(int p_id) const {
@@ -153,8 +193,8 @@ Array AStar::get_points() {
 
 	Array point_list;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
-		point_list.push_back(E->key());
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		point_list.push_back(*(it.key));
 	}
 
 	return point_list;
@@ -162,14 +202,14 @@ Array AStar::get_points() {
 
 PoolVector<int> AStar::get_point_connections(int p_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_id), PoolVector<int>());
+	Point *p;
+	bool p_exists = points.lookup(p_id, p);
+	ERR_FAIL_COND_V(!p_exists, PoolVector<int>());
 
 	PoolVector<int> point_list;
 
-	Point *p = points[p_id];
-
-	for (Set<Point *>::Element *E = p->neighbours.front(); E; E = E->next()) {
-		point_list.push_back(E->get()->id);
+	for (int i = 0; i < p->neighbours.size(); i++) {
+		point_list.push_back(p->neighbours[i]->id);
 	}
 
 	return point_list;
@@ -183,9 +223,9 @@ bool AStar::are_points_connected(int p_id, int p_with_id) const {
 
 void AStar::clear() {
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
-
-		memdelete(E->get());
+	last_free_id = 0;
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		memdelete(*(it.value));
 	}
 	segments.clear();
 	points.clear();
@@ -196,12 +236,12 @@ int AStar::get_closest_point(const Vector3 &p_point) const {
 	int closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 
-		real_t d = p_point.distance_squared_to(E->get()->pos);
+		real_t d = p_point.distance_squared_to((*it.value)->pos);
 		if (closest_id < 0 || d < closest_dist) {
 			closest_dist = d;
-			closest_id = E->key();
+			closest_id = *(it.key);
 		}
 	}
 
@@ -234,98 +274,132 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
+void AStar::_open_push(Point *p_point, real_t p_f_score) {
+
+	if (open_count == open_list.size()) {
+		open_list.resize(MAX(16, open_count * 2));
+	}
+
+	OpenPoint op;
+	op.f_score = p_f_score;
+	op.point = p_point;
+
+	SortArray<OpenPoint, OpenPointComparator> sorter;
+	sorter.push_heap(0, open_count, 0, op, open_list.ptrw());
+	open_count++;
+}
+
+AStar::Point *AStar::_open_pop() {
+
+	OpenPoint *heap = open_list.ptrw();
+	Point *p = heap[0].point;
+
+	SortArray<OpenPoint, OpenPointComparator> sorter;
+	sorter.pop_heap(0, open_count, heap);
+	open_count--;
+
+	return p;
+}
+
 bool AStar::_solve(Point *begin_point, Point *end_point) {
 
 	pass++;
-
-	SelfList<Point>::List open_list;
+	open_count = 0;
 
 	bool found_route = false;
 
-	for (Set<Point *>::Element *E = begin_point->neighbours.front(); E; E = E->next()) {
+	begin_point->g_score = 0;
+	begin_point->prev_point = NULL;
+	begin_point->open_pass = pass;
+	_open_push(begin_point, _estimate_cost(begin_point->id, end_point->id));
+
+	while (open_count) {
 
-		Point *n = E->get();
-		n->prev_point = begin_point;
-		n->distance = _compute_cost(begin_point->id, n->id) * n->weight_scale;
-		n->last_pass = pass;
-		open_list.add(&n->list);
+		Point *p = _open_pop();
+
+		if (p->closed_pass == pass) {
+			// A cheaper entry for this point was already processed.
+			continue;
+		}
 
-		if (end_point == n) {
+		if (p == end_point) {
 			found_route = true;
 			break;
 		}
-	}
 
-	while (!found_route) {
+		p->closed_pass = pass;
 
-		if (open_list.first() == NULL) {
-			// No path found
-			break;
-		}
-		// Check open list
+		for (int i = 0; i < p->neighbours.size(); i++) {
 
-		SelfList<Point> *least_cost_point = NULL;
-		real_t least_cost = 1e30;
+			Point *e = p->neighbours[i];
 
-		// TODO: Cache previous results
-		for (SelfList<Point> *E = open_list.first(); E; E = E->next()) {
+			if (e->closed_pass == pass)
+				continue;
 
-			Point *p = E->self();
+			real_t g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
-			real_t cost = p->distance;
-			cost += _estimate_cost(p->id, end_point->id);
+			if (e->open_pass == pass && g_score >= e->g_score)
+				continue; // Already reached through a cheaper path
 
-			if (cost < least_cost) {
+			e->prev_point = p;
+			e->g_score = g_score;
+			e->open_pass = pass;
 
-				least_cost_point = E;
-				least_cost = cost;
-			}
+			// Instead of updating the existing heap entry, add a new one; the old one is skipped when popped.
+			_open_push(e, g_score + _estimate_cost(e->id, end_point->id));
 		}
+	}
 
-		Point *p = least_cost_point->self();
+	return found_route;
+}
 
-		for (Set<Point *>::Element *E = p->neighbours.front(); E; E = E->next()) {
+void AStar::_solve_to(Point *end_point, const Vector<Point *> &p_begin_points) {
 
-			Point *e = E->get();
+	// Searches backwards from the end point until every begin point is reached, so prev_point
+	// ends up pointing to the next point towards end_point rather than back to the start.
 
-			real_t distance = _compute_cost(p->id, e->id) * e->weight_scale + p->distance;
+	pass++;
+	open_count = 0;
 
-			if (e->last_pass == pass) {
-				// Already visited, is this cheaper?
+	Set<Point *> pending;
+	for (int i = 0; i < p_begin_points.size(); i++) {
+		pending.insert(p_begin_points[i]);
+	}
 
-				if (e->distance > distance) {
+	end_point->g_score = 0;
+	end_point->prev_point = NULL;
+	end_point->open_pass = pass;
+	_open_push(end_point, 0);
 
-					e->prev_point = p;
-					e->distance = distance;
-				}
-			} else {
-				// Add to open neighbours
+	while (open_count && pending.size()) {
 
-				e->prev_point = p;
-				e->distance = distance;
-				e->last_pass = pass; // Mark as used
-				open_list.add(&e->list);
+		Point *p = _open_pop();
 
-				if (e == end_point) {
-					// End reached; stop algorithm
-					found_route = true;
-					break;
-				}
-			}
-		}
+		if (p->closed_pass == pass)
+			continue;
 
-		if (found_route)
-			break;
+		p->closed_pass = pass;
+		pending.erase(p);
 
-		open_list.remove(least_cost_point);
-	}
+		for (int i = 0; i < p->incoming_neighbours.size(); i++) {
 
-	// Clear the openf list
-	while (open_list.first()) {
-		open_list.remove(open_list.first());
-	}
+			Point *e = p->incoming_neighbours[i];
 
-	return found_route;
+			if (e->closed_pass == pass)
+				continue;
+
+			real_t g_score = p->g_score + _compute_cost(e->id, p->id) * p->weight_scale;
+
+			if (e->open_pass == pass && g_score >= e->g_score)
+				continue;
+
+			e->prev_point = p;
+			e->g_score = g_score;
+			e->open_pass = pass;
+
+			_open_push(e, g_score);
+		}
+	}
 }
 
 float AStar::_estimate_cost(int p_from_id, int p_to_id) {
@@ -333,7 +407,15 @@ float AStar::_estimate_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_estimate_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_estimate_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	Point *from_point;
+	bool from_exists = points.lookup(p_from_id, from_point);
+	ERR_FAIL_COND_V(!from_exists, 0);
+
+	Point *to_point;
+	bool to_exists = points.lookup(p_to_id, to_point);
+	ERR_FAIL_COND_V(!to_exists, 0);
+
+	return from_point->pos.distance_to(to_point->pos);
 }
 
 float AStar::_compute_cost(int p_from_id, int p_to_id) {
@@ -341,18 +423,26 @@ float AStar::_compute_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_compute_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_compute_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	Point *from_point;
+	bool from_exists = points.lookup(p_from_id, from_point);
+	ERR_FAIL_COND_V(!from_exists, 0);
+
+	Point *to_point;
+	bool to_exists = points.lookup(p_to_id, to_point);
+	ERR_FAIL_COND_V(!to_exists, 0);
+
+	return from_point->pos.distance_to(to_point->pos);
 }
 
 PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<Vector3>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<Vector3>());
+	Point *a;
+	bool from_exists = points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V(!from_exists, PoolVector<Vector3>());
 
-	pass++;
-
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
+	Point *b;
+	bool to_exists = points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V(!to_exists, PoolVector<Vector3>());
 
 	if (a == b) {
 		PoolVector<Vector3> ret;
@@ -397,13 +487,13 @@ PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 
 PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<int>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<int>());
+	Point *a;
+	bool from_exists = points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V(!from_exists, PoolVector<int>());
 
-	pass++;
-
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
+	Point *b;
+	bool to_exists = points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V(!to_exists, PoolVector<int>());
 
 	if (a == b) {
 		PoolVector<int> ret;
@@ -446,6 +536,73 @@ PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 	return path;
 }
 
+Array AStar::get_id_paths(const PoolVector<int> &p_from_ids, int p_to_id) {
+
+	Point *end_point;
+	bool to_exists = points.lookup(p_to_id, end_point);
+	ERR_FAIL_COND_V(!to_exists, Array());
+
+	Vector<Point *> begin_points;
+	begin_points.resize(p_from_ids.size());
+
+	{
+		PoolVector<int>::Read r = p_from_ids.read();
+		for (int i = 0; i < p_from_ids.size(); i++) {
+			Point *p = NULL;
+			bool from_exists = points.lookup(r[i], p);
+			ERR_CONTINUE(!from_exists);
+			begin_points.write[i] = p;
+		}
+	}
+
+	// One backwards search serves every begin point heading to the same end point.
+	Vector<Point *> valid_points;
+	for (int i = 0; i < begin_points.size(); i++) {
+		if (begin_points[i])
+			valid_points.push_back(begin_points[i]);
+	}
+	_solve_to(end_point, valid_points);
+
+	Array paths;
+	paths.resize(begin_points.size());
+
+	for (int i = 0; i < begin_points.size(); i++) {
+
+		Point *begin_point = begin_points[i];
+		if (!begin_point || begin_point->closed_pass != pass) {
+			paths[i] = PoolVector<int>(); // Invalid point, or no path found
+			continue;
+		}
+
+		int pc = 1;
+		Point *p = begin_point;
+		while (p != end_point) {
+			pc++;
+			p = p->prev_point;
+		}
+
+		PoolVector<int> path;
+		path.resize(pc);
+
+		{
+			PoolVector<int>::Write w = path.write();
+
+			p = begin_point;
+			int idx = 0;
+			while (p != end_point) {
+				w[idx++] = p->id;
+				p = p->prev_point;
+			}
+
+			w[idx] = p->id; // Assign last
+		}
+
+		paths[i] = path;
+	}
+
+	return paths;
+}
+
 void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar::get_available_point_id);
@@ -471,6 +628,7 @@ void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_id"), &AStar::get_id_paths);
 
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
@@ -479,6 +637,8 @@ void AStar::_bind_methods() {
 AStar::AStar() {
 
 	pass = 1;
+	last_free_id = 0;
+	open_count = 0;
 }
 
 AStar::~AStar() {
@@ -31,8 +31,9 @@
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "oa_hash_map.h"
 #include "reference.h"
-#include "self_list.h"
+
 /**
 	A* pathfinding algorithm
 
@@ -47,24 +48,37 @@ class AStar : public Reference {
 
 	struct Point {
 
-		SelfList<Point> list;
-
 		int id;
 		Vector3 pos;
 		real_t weight_scale;
-		uint64_t last_pass;
 
-		Set<Point *> neighbours;
+		Vector<Point *> neighbours; // points this one connects to
+		Vector<Point *> incoming_neighbours; // points connecting to this one
 
 		// Used for pathfinding
 		Point *prev_point;
-		real_t distance;
+		real_t g_score;
+		uint64_t open_pass;
+		uint64_t closed_pass;
+	};
 
-		Point() :
-				list(this) {}
+	struct OpenPoint {
+
+		real_t f_score;
+		Point *point;
 	};
 
-	Map<int, Point *> points;
+	struct OpenPointComparator {
+
+		_FORCE_INLINE_ bool operator()(const OpenPoint &A, const OpenPoint &B) const { return A.f_score > B.f_score; } // min-heap
+	};
+
+	OAHashMap<int, Point *> points;
+	int last_free_id;
+
+	// Binary heap, kept between searches to avoid reallocating it every time.
+	Vector<OpenPoint> open_list;
+	int open_count;
 
 	struct Segment {
 		union {
@@ -92,7 +106,11 @@ class AStar : public Reference {
 
 	Set<Segment> segments;
 
+	void _open_push(Point *p_point, real_t p_f_score);
+	Point *_open_pop();
+
 	bool _solve(Point *begin_point, Point *end_point);
+	void _solve_to(Point *end_point, const Vector<Point *> &p_begin_points);
 
 protected:
 	static void _bind_methods();
@@ -124,6 +142,7 @@ public:
 
 	PoolVector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	PoolVector<int> get_id_path(int p_from_id, int p_to_id);
+	Array get_id_paths(const PoolVector<int> &p_from_ids, int p_to_id);
 
 	AStar();
 	~AStar();
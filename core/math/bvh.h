@@ -0,0 +1,981 @@
+/*************************************************************************/
+/*  bvh.h                                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BVH_H
+#define BVH_H
+
+#include "aabb.h"
+#include "hash_map.h"
+#include "vector.h"
+
+/**
+ * Dynamic AABB tree with the same element, pairing and culling API as
+ * Octree<T, true>, meant for scenes where many elements move every frame.
+ *
+ * Leaves store a slightly enlarged AABB, so small moves only update the
+ * element. Larger moves refit the ancestors, and elements that left their
+ * old bounds entirely are reinserted. Pairable and non pairable elements
+ * live in separate trees, so non pairable elements (geometry) are only
+ * paired against the pairable ones (lights, probes).
+ * Nodes, elements and pairs are kept in pools and reused.
+ */
+
+typedef uint32_t BVHElementID;
+
+#define BVH_ELEMENT_INVALID_ID 0
+
+template <class T>
+class BVH {
+public:
+	typedef void *(*PairCallback)(void *, BVHElementID, T *, int, BVHElementID, T *, int);
+	typedef void (*UnpairCallback)(void *, BVHElementID, T *, int, BVHElementID, T *, int, void *);
+
+private:
+	enum {
+		TREE_ELEMENTS,
+		TREE_PAIRABLE,
+		TREE_MAX
+	};
+
+	enum {
+		NODE_NULL = -1,
+		STACK_SIZE = 128 // trees are kept balanced, this is far more than their height
+	};
+
+	struct Node {
+
+		AABB aabb; // enlarged for leaves
+		int parent; // next free node when not used
+		int children[2];
+		int height; // 0 for leaves
+		uint32_t element; // leaves only
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == NODE_NULL; }
+	};
+
+	struct Element {
+
+		T *userdata;
+		int subindex;
+		bool pairable;
+		uint32_t pairable_type;
+		uint32_t pairable_mask;
+		AABB aabb;
+
+		bool used;
+		int tree;
+		int leaf; // NODE_NULL if not in a tree (empty aabb)
+		Vector<uint32_t> pairs; // indices in the pair pool
+
+		Element() {
+			userdata = NULL;
+			subindex = 0;
+			pairable = false;
+			pairable_type = 0;
+			pairable_mask = 0;
+			used = false;
+			tree = TREE_ELEMENTS;
+			leaf = NODE_NULL;
+		}
+	};
+
+	struct Pair {
+
+		BVHElementID A;
+		BVHElementID B;
+		void *ud;
+	};
+
+	Vector<Node> nodes;
+	int free_node;
+	int root[TREE_MAX];
+
+	Vector<Element> elements;
+	Vector<uint32_t> free_elements;
+
+	Vector<Pair> pairs;
+	Vector<uint32_t> free_pairs;
+	HashMap<uint64_t, uint32_t> pair_map;
+	int pair_count;
+
+	PairCallback pair_callback;
+	UnpairCallback unpair_callback;
+	void *pair_callback_userdata;
+	void *unpair_callback_userdata;
+
+	static _FORCE_INLINE_ real_t _get_cost(const AABB &p_aabb) {
+		// half the surface area, the chance of being hit by a random query
+		return p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x;
+	}
+
+	static _FORCE_INLINE_ AABB _get_fat_aabb(const AABB &p_aabb) {
+		return p_aabb.grow(MAX(p_aabb.get_longest_axis_size() * 0.1, 0.05));
+	}
+
+	static _FORCE_INLINE_ uint64_t _get_pair_key(BVHElementID p_A, BVHElementID p_B) {
+		return p_A < p_B ? (uint64_t(p_A) << 32) | p_B : (uint64_t(p_B) << 32) | p_A;
+	}
+
+	_FORCE_INLINE_ bool _can_pair(BVHElementID p_A, const Element &p_a, BVHElementID p_B, const Element &p_b) const {
+
+		if (p_A == p_B || (p_a.userdata == p_b.userdata && p_a.userdata))
+			return false;
+		if (!p_a.pairable && !p_b.pairable)
+			return false;
+		return (p_a.pairable_type & p_b.pairable_mask) || (p_b.pairable_type & p_a.pairable_mask);
+	}
+
+	int _alloc_node();
+	void _free_node(int p_node);
+	int _balance(int p_tree, int p_node);
+	void _insert_leaf(int p_tree, int p_leaf);
+	void _remove_leaf(int p_tree, int p_leaf);
+	void _refit_leaf(int p_tree, int p_leaf, const AABB &p_aabb);
+
+	void _add_pair(BVHElementID p_A, BVHElementID p_B);
+	void _remove_pair(uint32_t p_pair);
+	void _update_pairs(BVHElementID p_id);
+
+	_FORCE_INLINE_ bool _check_aabb(const AABB &p_aabb) const {
+
+		ERR_FAIL_COND_V(p_aabb.position.x > 1e15 || p_aabb.position.x < -1e15, false);
+		ERR_FAIL_COND_V(p_aabb.position.y > 1e15 || p_aabb.position.y < -1e15, false);
+		ERR_FAIL_COND_V(p_aabb.position.z > 1e15 || p_aabb.position.z < -1e15, false);
+		ERR_FAIL_COND_V(p_aabb.size.x > 1e15 || p_aabb.size.x < 0.0, false);
+		ERR_FAIL_COND_V(p_aabb.size.y > 1e15 || p_aabb.size.y < 0.0, false);
+		ERR_FAIL_COND_V(p_aabb.size.z > 1e15 || p_aabb.size.z < 0.0, false);
+		ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.x), false);
+		ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.y), false);
+		ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.z), false);
+		return true;
+	}
+
+public:
+	BVHElementID create(T *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1);
+	void move(BVHElementID p_id, const AABB &p_aabb);
+	void set_pairable(BVHElementID p_id, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1);
+	void erase(BVHElementID p_id);
+
+	bool is_pairable(BVHElementID p_id) const;
+	T *get(BVHElementID p_id) const;
+	int get_subindex(BVHElementID p_id) const;
+
+	// culling does not modify the tree, so several threads can cull at once while it is not being modified
+	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF, bool *r_truncated = NULL) const;
+	int cull_convex_shared(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF, bool *r_truncated = NULL) const { return cull_convex(p_convex, p_result_array, p_result_max, p_mask, r_truncated); }
+	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_point(const Vector3 &p_point, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) const;
+
+	void set_pair_callback(PairCallback p_callback, void *p_userdata);
+	void set_unpair_callback(UnpairCallback p_callback, void *p_userdata);
+
+	int get_pair_count() const { return pair_count; }
+	int get_node_count() const;
+	int get_height() const;
+
+	BVH();
+};
+
+/* NODES */
+
+template <class T>
+int BVH<T>::_alloc_node() {
+
+	int index;
+	if (free_node != NODE_NULL) {
+		index = free_node;
+		free_node = nodes[index].parent;
+	} else {
+		index = nodes.size();
+		nodes.resize(index + 1);
+	}
+
+	Node &n = nodes.write[index];
+	n.parent = NODE_NULL;
+	n.children[0] = NODE_NULL;
+	n.children[1] = NODE_NULL;
+	n.height = 0;
+	n.element = 0;
+	return index;
+}
+
+template <class T>
+void BVH<T>::_free_node(int p_node) {
+
+	Node &n = nodes.write[p_node];
+	n.parent = free_node;
+	n.height = -1;
+	free_node = p_node;
+}
+
+// rotates the subtree at p_node if it is unbalanced, returns the new subtree root
+template <class T>
+int BVH<T>::_balance(int p_tree, int p_node) {
+
+	Node *n = nodes.ptrw();
+
+	int iA = p_node;
+	Node *A = &n[iA];
+	if (A->is_leaf() || A->height < 2)
+		return iA;
+
+	int iB = A->children[0];
+	int iC = A->children[1];
+	Node *B = &n[iB];
+	Node *C = &n[iC];
+
+	int balance = C->height - B->height;
+
+	if (balance > 1 || balance < -1) {
+
+		// rotate the taller child up
+		bool rotate_c = balance > 1;
+		int iUp = rotate_c ? iC : iB;
+		int iOther = rotate_c ? iB : iC;
+		Node *Up = &n[iUp];
+		Node *Other = &n[iOther];
+
+		int iF = Up->children[0];
+		int iG = Up->children[1];
+		Node *F = &n[iF];
+		Node *G = &n[iG];
+
+		Up->children[0] = iA;
+		Up->parent = A->parent;
+		A->parent = iUp;
+
+		if (Up->parent != NODE_NULL) {
+			Node *P = &n[Up->parent];
+			if (P->children[0] == iA) {
+				P->children[0] = iUp;
+			} else {
+				P->children[1] = iUp;
+			}
+		} else {
+			root[p_tree] = iUp;
+		}
+
+		// the taller grandchild stays with Up, the other one replaces Up under A
+		int iKeep = F->height > G->height ? iF : iG;
+		int iMove = F->height > G->height ? iG : iF;
+		Node *Keep = &n[iKeep];
+		Node *Move = &n[iMove];
+
+		Up->children[1] = iKeep;
+		A->children[0] = iOther;
+		A->children[1] = iMove;
+		Move->parent = iA;
+
+		A->aabb = Other->aabb.merge(Move->aabb);
+		Up->aabb = A->aabb.merge(Keep->aabb);
+		A->height = 1 + MAX(Other->height, Move->height);
+		Up->height = 1 + MAX(A->height, Keep->height);
+
+		return iUp;
+	}
+
+	return iA;
+}
+
+template <class T>
+void BVH<T>::_insert_leaf(int p_tree, int p_leaf) {
+
+	if (root[p_tree] == NODE_NULL) {
+		root[p_tree] = p_leaf;
+		nodes.write[p_leaf].parent = NODE_NULL;
+		return;
+	}
+
+	int new_parent = _alloc_node();
+	Node *n = nodes.ptrw();
+
+	// find the best sibling, by the area added to the tree
+	AABB leaf_aabb = n[p_leaf].aabb;
+	int index = root[p_tree];
+	while (!n[index].is_leaf()) {
+
+		int child0 = n[index].children[0];
+		int child1 = n[index].children[1];
+
+		real_t area = _get_cost(n[index].aabb);
+		real_t combined_area = _get_cost(n[index].aabb.merge(leaf_aabb));
+
+		real_t cost = 2.0 * combined_area;
+		real_t inheritance_cost = 2.0 * (combined_area - area);
+
+		real_t cost0 = _get_cost(n[child0].aabb.merge(leaf_aabb)) + inheritance_cost;
+		if (!n[child0].is_leaf()) {
+			cost0 -= _get_cost(n[child0].aabb);
+		}
+		real_t cost1 = _get_cost(n[child1].aabb.merge(leaf_aabb)) + inheritance_cost;
+		if (!n[child1].is_leaf()) {
+			cost1 -= _get_cost(n[child1].aabb);
+		}
+
+		if (cost < cost0 && cost < cost1)
+			break;
+
+		index = cost0 < cost1 ? child0 : child1;
+	}
+
+	int sibling = index;
+	int old_parent = n[sibling].parent;
+
+	n[new_parent].parent = old_parent;
+	n[new_parent].aabb = leaf_aabb.merge(n[sibling].aabb);
+	n[new_parent].height = n[sibling].height + 1;
+	n[new_parent].children[0] = sibling;
+	n[new_parent].children[1] = p_leaf;
+	n[sibling].parent = new_parent;
+	n[p_leaf].parent = new_parent;
+
+	if (old_parent != NODE_NULL) {
+		if (n[old_parent].children[0] == sibling) {
+			n[old_parent].children[0] = new_parent;
+		} else {
+			n[old_parent].children[1] = new_parent;
+		}
+	} else {
+		root[p_tree] = new_parent;
+	}
+
+	// fix heights and bounds on the way up
+	index = n[p_leaf].parent;
+	while (index != NODE_NULL) {
+
+		index = _balance(p_tree, index);
+
+		int child0 = n[index].children[0];
+		int child1 = n[index].children[1];
+		n[index].height = 1 + MAX(n[child0].height, n[child1].height);
+		n[index].aabb = n[child0].aabb.merge(n[child1].aabb);
+
+		index = n[index].parent;
+	}
+}
+
+template <class T>
+void BVH<T>::_remove_leaf(int p_tree, int p_leaf) {
+
+	if (p_leaf == root[p_tree]) {
+		root[p_tree] = NODE_NULL;
+		return;
+	}
+
+	Node *n = nodes.ptrw();
+
+	int parent = n[p_leaf].parent;
+	int grand_parent = n[parent].parent;
+	int sibling = n[parent].children[0] == p_leaf ? n[parent].children[1] : n[parent].children[0];
+
+	if (grand_parent != NODE_NULL) {
+
+		if (n[grand_parent].children[0] == parent) {
+			n[grand_parent].children[0] = sibling;
+		} else {
+			n[grand_parent].children[1] = sibling;
+		}
+		n[sibling].parent = grand_parent;
+		_free_node(parent);
+
+		int index = grand_parent;
+		while (index != NODE_NULL) {
+
+			index = _balance(p_tree, index);
+
+			int child0 = n[index].children[0];
+			int child1 = n[index].children[1];
+			n[index].aabb = n[child0].aabb.merge(n[child1].aabb);
+			n[index].height = 1 + MAX(n[child0].height, n[child1].height);
+
+			index = n[index].parent;
+		}
+	} else {
+
+		root[p_tree] = sibling;
+		n[sibling].parent = NODE_NULL;
+		_free_node(parent);
+	}
+}
+
+template <class T>
+void BVH<T>::_refit_leaf(int p_tree, int p_leaf, const AABB &p_aabb) {
+
+	Node *n = nodes.ptrw();
+
+	if (n[p_leaf].aabb.encloses(p_aabb))
+		return; // still inside the enlarged bounds
+
+	AABB fat_aabb = _get_fat_aabb(p_aabb);
+
+	if (!fat_aabb.intersects(n[p_leaf].aabb)) {
+		// moved away entirely, refitting would make the tree worse over time
+		_remove_leaf(p_tree, p_leaf);
+		nodes.write[p_leaf].aabb = fat_aabb;
+		_insert_leaf(p_tree, p_leaf);
+		return;
+	}
+
+	n[p_leaf].aabb = fat_aabb;
+
+	// grow the ancestors until one already contains the new bounds
+	int index = n[p_leaf].parent;
+	while (index != NODE_NULL && !n[index].aabb.encloses(fat_aabb)) {
+
+		n[index].aabb = n[n[index].children[0]].aabb.merge(n[n[index].children[1]].aabb);
+		index = n[index].parent;
+	}
+}
+
+/* PAIRS */
+
+template <class T>
+void BVH<T>::_add_pair(BVHElementID p_A, BVHElementID p_B) {
+
+	uint64_t key = _get_pair_key(p_A, p_B);
+	if (pair_map.has(key))
+		return;
+
+	uint32_t index;
+	if (free_pairs.size()) {
+		index = free_pairs[free_pairs.size() - 1];
+		free_pairs.resize(free_pairs.size() - 1);
+	} else {
+		index = pairs.size();
+		pairs.resize(index + 1);
+	}
+
+	Element &a = elements.write[p_A - 1];
+	Element &b = elements.write[p_B - 1];
+
+	Pair &pair = pairs.write[index];
+	pair.A = p_A;
+	pair.B = p_B;
+	pair.ud = NULL;
+	if (pair_callback) {
+		pair.ud = pair_callback(pair_callback_userdata, p_A, a.userdata, a.subindex, p_B, b.userdata, b.subindex);
+	}
+
+	pair_map[key] = index;
+	a.pairs.push_back(index);
+	b.pairs.push_back(index);
+	pair_count++;
+}
+
+template <class T>
+void BVH<T>::_remove_pair(uint32_t p_pair) {
+
+	Pair pair = pairs[p_pair];
+	Element &a = elements.write[pair.A - 1];
+	Element &b = elements.write[pair.B - 1];
+
+	if (unpair_callback) {
+		unpair_callback(unpair_callback_userdata, pair.A, a.userdata, a.subindex, pair.B, b.userdata, b.subindex, pair.ud);
+	}
+
+	for (int l = 0; l < 2; l++) {
+
+		Vector<uint32_t> &list = l == 0 ? a.pairs : b.pairs;
+		int count = list.size();
+		uint32_t *w = list.ptrw();
+		for (int i = 0; i < count; i++) {
+			if (w[i] == p_pair) {
+				w[i] = w[count - 1];
+				list.resize(count - 1);
+				break;
+			}
+		}
+	}
+
+	pair_map.erase(_get_pair_key(pair.A, pair.B));
+	free_pairs.push_back(p_pair);
+	pair_count--;
+}
+
+template <class T>
+void BVH<T>::_update_pairs(BVHElementID p_id) {
+
+	// drop pairs that stopped overlapping
+	{
+		const Element &e = elements[p_id - 1];
+		for (int i = e.pairs.size() - 1; i >= 0; i--) {
+
+			uint32_t pair_index = e.pairs[i];
+			const Pair &pair = pairs[pair_index];
+			BVHElementID other_id = pair.A == p_id ? pair.B : pair.A;
+			const Element &other = elements[other_id - 1];
+
+			if (e.leaf == NODE_NULL || other.leaf == NODE_NULL || !e.aabb.intersects_inclusive(other.aabb) || !_can_pair(p_id, e, other_id, other)) {
+				_remove_pair(pair_index);
+			}
+		}
+	}
+
+	const Element &e = elements[p_id - 1];
+	if (e.leaf == NODE_NULL)
+		return;
+
+	AABB aabb = e.aabb;
+	bool pairable = e.pairable;
+
+	// find new ones, elements which are not pairable only need the pairable tree
+	for (int t = pairable ? 0 : TREE_PAIRABLE; t < TREE_MAX; t++) {
+
+		if (root[t] == NODE_NULL)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = root[t];
+
+		while (stack_size) {
+
+			const Node &node = nodes[stack[--stack_size]];
+			if (!node.aabb.intersects_inclusive(aabb))
+				continue;
+
+			if (node.is_leaf()) {
+
+				BVHElementID other_id = node.element + 1;
+				const Element &other = elements[node.element];
+				if (other.aabb.intersects_inclusive(aabb) && _can_pair(p_id, elements[p_id - 1], other_id, other)) {
+					_add_pair(p_id, other_id);
+				}
+			} else {
+
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = node.children[0];
+				stack[stack_size++] = node.children[1];
+			}
+		}
+	}
+}
+
+/* ELEMENTS */
+
+template <class T>
+BVHElementID BVH<T>::create(T *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	if (!_check_aabb(p_aabb))
+		return BVH_ELEMENT_INVALID_ID;
+
+	uint32_t index;
+	if (free_elements.size()) {
+		index = free_elements[free_elements.size() - 1];
+		free_elements.resize(free_elements.size() - 1);
+	} else {
+		index = elements.size();
+		elements.resize(index + 1);
+	}
+
+	BVHElementID id = index + 1;
+
+	Element &e = elements.write[index];
+	e.userdata = p_userdata;
+	e.subindex = p_subindex;
+	e.pairable = p_pairable;
+	e.pairable_type = p_pairable_type;
+	e.pairable_mask = p_pairable_mask;
+	e.aabb = p_aabb;
+	e.used = true;
+	e.tree = p_pairable ? TREE_PAIRABLE : TREE_ELEMENTS;
+	e.leaf = NODE_NULL;
+
+	if (!p_aabb.has_no_surface()) {
+
+		int leaf = _alloc_node();
+		Node &n = nodes.write[leaf];
+		n.aabb = _get_fat_aabb(p_aabb);
+		n.element = index;
+		elements.write[index].leaf = leaf;
+		_insert_leaf(elements[index].tree, leaf);
+	}
+
+	_update_pairs(id);
+
+	return id;
+}
+
+template <class T>
+void BVH<T>::move(BVHElementID p_id, const AABB &p_aabb) {
+
+	ERR_FAIL_COND(p_id == BVH_ELEMENT_INVALID_ID || p_id > (uint32_t)elements.size() || !elements[p_id - 1].used);
+
+	if (!_check_aabb(p_aabb))
+		return;
+
+	Element &e = elements.write[p_id - 1];
+	if (e.aabb == p_aabb)
+		return;
+
+	e.aabb = p_aabb;
+
+	if (p_aabb.has_no_surface()) {
+
+		if (e.leaf != NODE_NULL) {
+			_remove_leaf(e.tree, e.leaf);
+			_free_node(e.leaf);
+			e.leaf = NODE_NULL;
+		}
+	} else if (e.leaf == NODE_NULL) {
+
+		int leaf = _alloc_node();
+		Node &n = nodes.write[leaf];
+		n.aabb = _get_fat_aabb(p_aabb);
+		n.element = p_id - 1;
+		e.leaf = leaf;
+		_insert_leaf(e.tree, leaf);
+	} else {
+
+		_refit_leaf(e.tree, e.leaf, p_aabb);
+	}
+
+	_update_pairs(p_id);
+}
+
+template <class T>
+void BVH<T>::set_pairable(BVHElementID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	ERR_FAIL_COND(p_id == BVH_ELEMENT_INVALID_ID || p_id > (uint32_t)elements.size() || !elements[p_id - 1].used);
+
+	Element &e = elements.write[p_id - 1];
+	e.pairable = p_pairable;
+	e.pairable_type = p_pairable_type;
+	e.pairable_mask = p_pairable_mask;
+
+	int tree = p_pairable ? TREE_PAIRABLE : TREE_ELEMENTS;
+	if (tree != e.tree) {
+		if (e.leaf != NODE_NULL) {
+			_remove_leaf(e.tree, e.leaf);
+			_insert_leaf(tree, e.leaf);
+		}
+		e.tree = tree;
+	}
+
+	_update_pairs(p_id);
+}
+
+template <class T>
+void BVH<T>::erase(BVHElementID p_id) {
+
+	ERR_FAIL_COND(p_id == BVH_ELEMENT_INVALID_ID || p_id > (uint32_t)elements.size() || !elements[p_id - 1].used);
+
+	while (elements[p_id - 1].pairs.size()) {
+		_remove_pair(elements[p_id - 1].pairs[0]);
+	}
+
+	Element &e = elements.write[p_id - 1];
+	if (e.leaf != NODE_NULL) {
+		_remove_leaf(e.tree, e.leaf);
+		_free_node(e.leaf);
+	}
+
+	e = Element();
+	free_elements.push_back(p_id - 1);
+}
+
+template <class T>
+bool BVH<T>::is_pairable(BVHElementID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == BVH_ELEMENT_INVALID_ID || p_id > (uint32_t)elements.size() || !elements[p_id - 1].used, false);
+	return elements[p_id - 1].pairable;
+}
+
+template <class T>
+T *BVH<T>::get(BVHElementID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == BVH_ELEMENT_INVALID_ID || p_id > (uint32_t)elements.size() || !elements[p_id - 1].used, NULL);
+	return elements[p_id - 1].userdata;
+}
+
+template <class T>
+int BVH<T>::get_subindex(BVHElementID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == BVH_ELEMENT_INVALID_ID || p_id > (uint32_t)elements.size() || !elements[p_id - 1].used, -1);
+	return elements[p_id - 1].subindex;
+}
+
+/* CULLING */
+
+template <class T>
+int BVH<T>::cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask, bool *r_truncated) const {
+
+	if (r_truncated)
+		*r_truncated = false;
+
+	if (p_result_max <= 0)
+		return 0;
+
+	const Node *n = nodes.ptr();
+	const Element *el = elements.ptr();
+	const Plane *planes = p_convex.ptr();
+	int plane_count = p_convex.size();
+
+	int result_count = 0;
+
+	for (int t = 0; t < TREE_MAX; t++) {
+
+		if (root[t] == NODE_NULL)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = root[t];
+
+		while (stack_size) {
+
+			const Node &node = n[stack[--stack_size]];
+			if (!node.aabb.intersects_convex_shape(planes, plane_count))
+				continue;
+
+			if (node.is_leaf()) {
+
+				const Element &e = el[node.element];
+				if (!(e.pairable_type & p_mask) || !e.aabb.intersects_convex_shape(planes, plane_count))
+					continue;
+
+				p_result_array[result_count++] = e.userdata;
+				if (result_count == p_result_max) {
+					if (r_truncated)
+						*r_truncated = true;
+					return result_count;
+				}
+			} else {
+
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = node.children[0];
+				stack[stack_size++] = node.children[1];
+			}
+		}
+	}
+
+	return result_count;
+}
+
+template <class T>
+int BVH<T>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (p_result_max <= 0)
+		return 0;
+
+	const Node *n = nodes.ptr();
+	const Element *el = elements.ptr();
+
+	int result_count = 0;
+
+	for (int t = 0; t < TREE_MAX; t++) {
+
+		if (root[t] == NODE_NULL)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = root[t];
+
+		while (stack_size) {
+
+			const Node &node = n[stack[--stack_size]];
+			if (!p_aabb.intersects_inclusive(node.aabb))
+				continue;
+
+			if (node.is_leaf()) {
+
+				const Element &e = el[node.element];
+				if (!(e.pairable_type & p_mask) || !p_aabb.intersects_inclusive(e.aabb))
+					continue;
+
+				if (p_subindex_array)
+					p_subindex_array[result_count] = e.subindex;
+				p_result_array[result_count++] = e.userdata;
+				if (result_count == p_result_max)
+					return result_count;
+			} else {
+
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = node.children[0];
+				stack[stack_size++] = node.children[1];
+			}
+		}
+	}
+
+	return result_count;
+}
+
+template <class T>
+int BVH<T>::cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (p_result_max <= 0)
+		return 0;
+
+	const Node *n = nodes.ptr();
+	const Element *el = elements.ptr();
+
+	int result_count = 0;
+
+	for (int t = 0; t < TREE_MAX; t++) {
+
+		if (root[t] == NODE_NULL)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = root[t];
+
+		while (stack_size) {
+
+			const Node &node = n[stack[--stack_size]];
+			if (!node.aabb.intersects_segment(p_from, p_to))
+				continue;
+
+			if (node.is_leaf()) {
+
+				const Element &e = el[node.element];
+				if (!(e.pairable_type & p_mask) || !e.aabb.intersects_segment(p_from, p_to))
+					continue;
+
+				if (p_subindex_array)
+					p_subindex_array[result_count] = e.subindex;
+				p_result_array[result_count++] = e.userdata;
+				if (result_count == p_result_max)
+					return result_count;
+			} else {
+
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = node.children[0];
+				stack[stack_size++] = node.children[1];
+			}
+		}
+	}
+
+	return result_count;
+}
+
+template <class T>
+int BVH<T>::cull_point(const Vector3 &p_point, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (p_result_max <= 0)
+		return 0;
+
+	const Node *n = nodes.ptr();
+	const Element *el = elements.ptr();
+
+	int result_count = 0;
+
+	for (int t = 0; t < TREE_MAX; t++) {
+
+		if (root[t] == NODE_NULL)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = root[t];
+
+		while (stack_size) {
+
+			const Node &node = n[stack[--stack_size]];
+			if (!node.aabb.has_point(p_point))
+				continue;
+
+			if (node.is_leaf()) {
+
+				const Element &e = el[node.element];
+				if (!(e.pairable_type & p_mask) || !e.aabb.has_point(p_point))
+					continue;
+
+				if (p_subindex_array)
+					p_subindex_array[result_count] = e.subindex;
+				p_result_array[result_count++] = e.userdata;
+				if (result_count == p_result_max)
+					return result_count;
+			} else {
+
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = node.children[0];
+				stack[stack_size++] = node.children[1];
+			}
+		}
+	}
+
+	return result_count;
+}
+
+template <class T>
+void BVH<T>::set_pair_callback(PairCallback p_callback, void *p_userdata) {
+
+	pair_callback = p_callback;
+	pair_callback_userdata = p_userdata;
+}
+
+template <class T>
+void BVH<T>::set_unpair_callback(UnpairCallback p_callback, void *p_userdata) {
+
+	unpair_callback = p_callback;
+	unpair_callback_userdata = p_userdata;
+}
+
+template <class T>
+int BVH<T>::get_node_count() const {
+
+	int count = 0;
+	for (int i = 0; i < nodes.size(); i++) {
+		if (nodes[i].height >= 0)
+			count++;
+	}
+	return count;
+}
+
+template <class T>
+int BVH<T>::get_height() const {
+
+	int height = 0;
+	for (int t = 0; t < TREE_MAX; t++) {
+		if (root[t] != NODE_NULL)
+			height = MAX(height, nodes[root[t]].height);
+	}
+	return height;
+}
+
+template <class T>
+BVH<T>::BVH() {
+
+	free_node = NODE_NULL;
+	for (int t = 0; t < TREE_MAX; t++) {
+		root[t] = NODE_NULL;
+	}
+	pair_count = 0;
+
+	pair_callback = NULL;
+	unpair_callback = NULL;
+	pair_callback_userdata = NULL;
+	unpair_callback_userdata = NULL;
+}
+
+#endif // BVH_H
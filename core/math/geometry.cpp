@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "geometry.h"
+#include "os/worker_thread_pool.h"
 #include "print_string.h"
 
 bool Geometry::is_point_in_polygon(const Vector2 &p_point, const Vector<Vector2> &p_polygon) {
@@ -91,6 +92,96 @@ void Geometry::MeshData::optimize_vertices() {
 
 Vector<Vector<Vector2> > (*Geometry::_decompose_func)(const Vector<Vector2> &p_polygon) = NULL;
 
+Vector<Vector<Vector2> > Geometry::decompose_polygon_in_convex(const Vector<Vector2> &p_polygon) {
+
+	Vector<Vector<Vector2> > decomp;
+
+	Vector<int> triangles;
+	if (!Triangulate::triangulate_monotone(p_polygon, Vector<Vector<Vector2> >(), triangles)) {
+		triangles.clear();
+		if (!Triangulate::triangulate(p_polygon, triangles))
+			return decomp; //fail
+	}
+
+	Vector<Vector<int> > polygons;
+	Triangulate::merge_convex(p_polygon, triangles, polygons);
+
+	decomp.resize(polygons.size());
+	for (int i = 0; i < polygons.size(); i++) {
+
+		const Vector<int> &indices = polygons[i];
+		Vector<Vector2> &convex = decomp.write[i];
+		convex.resize(indices.size());
+		for (int j = 0; j < indices.size(); j++) {
+			convex.write[j] = p_polygon[indices[j]];
+		}
+	}
+
+	return decomp;
+}
+
+struct _PolygonBatch {
+
+	const Vector<Vector2> *polygons;
+	Vector<int> *triangles;
+	Vector<Vector<Vector2> > *convex;
+};
+
+static void _triangulate_polygon_task(void *p_userdata, uint32_t p_index) {
+
+	_PolygonBatch *batch = (_PolygonBatch *)p_userdata;
+	batch->triangles[p_index] = Geometry::triangulate_polygon(batch->polygons[p_index]);
+}
+
+static void _decompose_polygon_task(void *p_userdata, uint32_t p_index) {
+
+	_PolygonBatch *batch = (_PolygonBatch *)p_userdata;
+	batch->convex[p_index] = Geometry::decompose_polygon_in_convex(batch->polygons[p_index]);
+}
+
+static void _run_polygon_batch(void (*p_task)(void *, uint32_t), _PolygonBatch *p_batch, int p_count) {
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	if (!pool || p_count < 2) {
+		for (int i = 0; i < p_count; i++) {
+			p_task(p_batch, i);
+		}
+		return;
+	}
+
+	WorkerThreadPool::GroupID group = pool->add_group_task(p_task, p_batch, p_count);
+	pool->wait_for_group_task_completion(group);
+}
+
+Vector<Vector<int> > Geometry::triangulate_polygons(const Vector<Vector<Vector2> > &p_polygons) {
+
+	Vector<Vector<int> > results;
+	results.resize(p_polygons.size());
+
+	_PolygonBatch batch;
+	batch.polygons = p_polygons.ptr();
+	batch.triangles = results.ptrw();
+	batch.convex = NULL;
+	_run_polygon_batch(_triangulate_polygon_task, &batch, p_polygons.size());
+
+	return results;
+}
+
+Vector<Vector<Vector<Vector2> > > Geometry::decompose_polygons_in_convex(const Vector<Vector<Vector2> > &p_polygons) {
+
+	Vector<Vector<Vector<Vector2> > > results;
+	results.resize(p_polygons.size());
+
+	_PolygonBatch batch;
+	batch.polygons = p_polygons.ptr();
+	batch.triangles = NULL;
+	batch.convex = results.ptrw();
+	_run_polygon_batch(_decompose_polygon_task, &batch, p_polygons.size());
+
+	return results;
+}
+
 struct _FaceClassify {
 
 	struct _Link {
@@ -782,21 +782,44 @@ public:
 		return clipped;
 	}
 
+	enum {
+		TRIANGULATE_MONOTONE_MIN_POINTS = 64 // below this, ear clipping is as fast and gives nicer triangles
+	};
+
 	static Vector<int> triangulate_polygon(const Vector<Vector2> &p_polygon) {
 
 		Vector<int> triangles;
+		if (p_polygon.size() >= TRIANGULATE_MONOTONE_MIN_POINTS && Triangulate::triangulate_monotone(p_polygon, Vector<Vector<Vector2> >(), triangles))
+			return triangles;
+
+		triangles.clear();
 		if (!Triangulate::triangulate(p_polygon, triangles))
 			return Vector<int>(); //fail
 		return triangles;
 	}
 
+	// indices refer to the outline points followed by the points of each hole
+	static Vector<int> triangulate_polygon_with_holes(const Vector<Vector2> &p_outline, const Vector<Vector<Vector2> > &p_holes) {
+
+		Vector<int> triangles;
+		if (!Triangulate::triangulate_monotone(p_outline, p_holes, triangles))
+			return Vector<int>(); //fail
+		return triangles;
+	}
+
+	static Vector<Vector<Vector2> > decompose_polygon_in_convex(const Vector<Vector2> &p_polygon);
+
+	// batched versions, polygons are processed in parallel on the worker pool
+	static Vector<Vector<int> > triangulate_polygons(const Vector<Vector<Vector2> > &p_polygons);
+	static Vector<Vector<Vector<Vector2> > > decompose_polygons_in_convex(const Vector<Vector<Vector2> > &p_polygons);
+
 	static Vector<Vector<Vector2> > (*_decompose_func)(const Vector<Vector2> &p_polygon);
 	static Vector<Vector<Vector2> > decompose_polygon(const Vector<Vector2> &p_polygon) {
 
 		if (_decompose_func)
 			return _decompose_func(p_polygon);
 
-		return Vector<Vector<Vector2> >();
+		return decompose_polygon_in_convex(p_polygon);
 	}
 
 	static PoolVector<PoolVector<Face3> > separate_objects(PoolVector<Face3> p_array);
@@ -757,6 +757,7 @@ struct Transform2D {
 	_FORCE_INLINE_ Vector2 basis_xform_inv(const Vector2 &p_vec) const;
 	_FORCE_INLINE_ Vector2 xform(const Vector2 &p_vec) const;
 	_FORCE_INLINE_ Vector2 xform_inv(const Vector2 &p_vec) const;
+	_FORCE_INLINE_ void xform_array(const Vector2 *p_src, Vector2 *r_dst, int p_count) const;
 	_FORCE_INLINE_ Rect2 xform(const Rect2 &p_rect) const;
 	_FORCE_INLINE_ Rect2 xform_inv(const Rect2 &p_rect) const;
 
@@ -951,6 +952,20 @@ Vector2 Transform2D::xform(const Vector2 &p_vec) const {
 				   tdoty(p_vec)) +
 		   elements[2];
 }
+void Transform2D::xform_array(const Vector2 *p_src, Vector2 *r_dst, int p_count) const {
+
+	// matrix is copied to locals so the compiler can keep it in registers and vectorize the loop
+	const real_t xx = elements[0][0], xy = elements[1][0];
+	const real_t yx = elements[0][1], yy = elements[1][1];
+	const real_t ox = elements[2][0], oy = elements[2][1];
+
+	for (int i = 0; i < p_count; i++) {
+
+		const real_t x = p_src[i].x, y = p_src[i].y;
+		r_dst[i].x = xx * x + xy * y + ox;
+		r_dst[i].y = yx * x + yy * y + oy;
+	}
+}
 Vector2 Transform2D::xform_inv(const Vector2 &p_vec) const {
 
 	Vector2 v = p_vec - elements[2];
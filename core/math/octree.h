@@ -35,6 +35,7 @@
 #include "list.h"
 #include "map.h"
 #include "print_string.h"
+#include "sort.h"
 #include "variant.h"
 #include "vector3.h"
 
@@ -352,6 +353,7 @@ private:
 	};
 
 	void _cull_convex(Octant *p_octant, _CullConvexData *p_cull);
+	void _cull_convex_shared(const Octant *p_octant, _CullConvexData *p_cull) const;
 	void _cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_segment(Octant *p_octant, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_point(Octant *p_octant, const Vector3 &p_point, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
@@ -381,6 +383,9 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	// Same as cull_convex(), but elements are not tagged with the pass, so several threads can cull at once
+	// while the octree is not being modified. r_truncated is set if the result array filled up.
+	int cull_convex_shared(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF, bool *r_truncated = NULL) const;
 	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -1072,6 +1077,44 @@ void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p
 	}
 }
 
+template <class T, bool use_pairs, class AL>
+void Octree<T, use_pairs, AL>::_cull_convex_shared(const Octant *p_octant, _CullConvexData *p_cull) const {
+
+	if (*p_cull->result_idx == p_cull->result_max)
+		return; //pointless
+
+	for (int l = 0; l < (use_pairs ? 2 : 1); l++) {
+
+		const List<Element *, AL> &elements = l == 0 ? p_octant->elements : p_octant->pairable_elements;
+
+		for (const typename List<Element *, AL>::Element *I = elements.front(); I; I = I->next()) {
+
+			const Element *e = I->get();
+
+			if (use_pairs && !(e->pairable_type & p_cull->mask))
+				continue;
+
+			if (e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count)) {
+
+				if (*p_cull->result_idx < p_cull->result_max) {
+					p_cull->result_array[*p_cull->result_idx] = e->userdata;
+					(*p_cull->result_idx)++;
+				} else {
+
+					return; // pointless to continue
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < 8; i++) {
+
+		if (p_octant->children[i] && p_octant->children[i]->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count)) {
+			_cull_convex_shared(p_octant->children[i], p_cull);
+		}
+	}
+}
+
 template <class T, bool use_pairs, class AL>
 void Octree<T, use_pairs, AL>::_cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -1313,6 +1356,46 @@ int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_r
 	return result_count;
 }
 
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_shared(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask, bool *r_truncated) const {
+
+	if (r_truncated)
+		*r_truncated = false;
+
+	if (!root)
+		return 0;
+
+	int result_count = 0;
+	_CullConvexData cdata;
+	cdata.planes = &p_convex[0];
+	cdata.plane_count = p_convex.size();
+	cdata.result_array = p_result_array;
+	cdata.result_max = p_result_max;
+	cdata.result_idx = &result_count;
+	cdata.mask = p_mask;
+
+	_cull_convex_shared(root, &cdata);
+
+	if (r_truncated && result_count == p_result_max)
+		*r_truncated = true;
+
+	// elements spanning several octants were found once per octant
+	if (result_count > 1) {
+
+		SortArray<T *> sorter;
+		sorter.sort(p_result_array, result_count);
+
+		int unique = 1;
+		for (int i = 1; i < result_count; i++) {
+			if (p_result_array[i] != p_result_array[unique - 1])
+				p_result_array[unique++] = p_result_array[i];
+		}
+		result_count = unique;
+	}
+
+	return result_count;
+}
+
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -30,6 +30,7 @@
 
 #include "quick_hull.h"
 #include "map.h"
+#include "os/threaded_array_processor.h"
 
 uint32_t QuickHull::debug_stop_after = 0xFFFFFFFF;
 
@@ -55,7 +56,7 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 
 	Vector<bool> valid_points;
 	valid_points.resize(p_points.size());
-	Set<Vector3> valid_cache;
+	HashMap<Vector3, bool, PointHasher> valid_cache;
 
 	for (int i = 0; i < p_points.size(); i++) {
 
@@ -65,7 +66,7 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 			//print_line("INVALIDATED: "+itos(i));
 		} else {
 			valid_points.write[i] = true;
-			valid_cache.insert(sp);
+			valid_cache.set(sp, true);
 		}
 	}
 
@@ -218,6 +219,8 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 
 	uint32_t debug_stop = debug_stop_after;
 
+	HashMap<Edge, FaceConnect, EdgeHasher> lit_edges; //reused for every iteration
+
 	while (debug_stop > 0 && faces.back()->get().points_over.size()) {
 
 		debug_stop--;
@@ -244,7 +247,7 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 		//find lit faces and lit edges
 		List<List<Face>::Element *> lit_faces; //lit face is a death sentence
 
-		Map<Edge, FaceConnect> lit_edges; //create this on the flight, should not be that bad for performance and simplifies code a lot
+		lit_edges.clear();
 
 		for (List<Face>::Element *E = faces.front(); E; E = E->next()) {
 
@@ -257,16 +260,13 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 					uint32_t b = E->get().vertices[(i + 1) % 3];
 					Edge e(a, b);
 
-					Map<Edge, FaceConnect>::Element *F = lit_edges.find(e);
-					if (!F) {
-						F = lit_edges.insert(e, FaceConnect());
-					}
+					FaceConnect &F = lit_edges[e]; //inserted if missing
 					if (e.vertices[0] == a) {
 						//left
-						F->get().left = E;
+						F.left = E;
 					} else {
 
-						F->get().right = E;
+						F.right = E;
 					}
 				}
 			}
@@ -275,9 +275,10 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 		//create new faces from horizon edges
 		List<List<Face>::Element *> new_faces; //new faces
 
-		for (Map<Edge, FaceConnect>::Element *E = lit_edges.front(); E; E = E->next()) {
+		const Edge *K = NULL;
+		while ((K = lit_edges.next(K))) {
 
-			FaceConnect &fc = E->get();
+			FaceConnect &fc = lit_edges[*K];
 			if (fc.left && fc.right) {
 				continue; //edge is uninteresting, not on horizont
 			}
@@ -286,8 +287,8 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 
 			Face face;
 			face.vertices[0] = f.points_over[next];
-			face.vertices[1] = E->key().vertices[0];
-			face.vertices[2] = E->key().vertices[1];
+			face.vertices[1] = K->vertices[0];
+			face.vertices[2] = K->vertices[1];
 
 			Plane p(p_points[face.vertices[0]], p_points[face.vertices[1]], p_points[face.vertices[2]]);
 
@@ -475,3 +476,31 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry::MeshData &r_me
 
 	return OK;
 }
+
+void QuickHull::BatchBuild::build(uint32_t p_index, void *p_userdata) {
+
+	Error err = QuickHull::build(points[p_index], meshes[p_index]);
+	if (errors) {
+		errors[p_index] = err;
+	}
+}
+
+void QuickHull::build_batch(const Vector<Vector<Vector3> > &p_point_sets, Vector<Geometry::MeshData> &r_meshes, Vector<Error> *r_errors) {
+
+	r_meshes.resize(p_point_sets.size());
+	if (r_errors) {
+		r_errors->resize(p_point_sets.size());
+	}
+
+	if (p_point_sets.empty()) {
+		return;
+	}
+
+	// hulls are independent, build them on the worker threads
+	BatchBuild batch;
+	batch.points = p_point_sets.ptr();
+	batch.meshes = r_meshes.ptrw();
+	batch.errors = r_errors ? r_errors->ptrw() : NULL;
+
+	thread_process_array(p_point_sets.size(), &batch, &BatchBuild::build, (void *)NULL);
+}
@@ -33,6 +33,7 @@
 
 #include "aabb.h"
 #include "geometry.h"
+#include "hash_map.h"
 #include "list.h"
 #include "set.h"
 
@@ -50,6 +51,10 @@ public:
 			return id < p_edge.id;
 		}
 
+		bool operator==(const Edge &p_edge) const {
+			return id == p_edge.id;
+		}
+
 		Edge(int p_vtx_a = 0, int p_vtx_b = 0) {
 
 			if (p_vtx_a > p_vtx_b) {
@@ -74,6 +79,26 @@ public:
 	};
 
 private:
+	struct EdgeHasher {
+		static _FORCE_INLINE_ uint32_t hash(const Edge &p_edge) { return hash_one_uint64(p_edge.id); }
+	};
+
+	struct PointHasher {
+		static _FORCE_INLINE_ uint32_t hash(const Vector3 &p_point) {
+			uint32_t h = hash_djb2_one_float(p_point.x);
+			h = hash_djb2_one_float(p_point.y, h);
+			return hash_djb2_one_float(p_point.z, h);
+		}
+	};
+
+	struct BatchBuild {
+		const Vector<Vector3> *points;
+		Geometry::MeshData *meshes;
+		Error *errors;
+
+		void build(uint32_t p_index, void *p_userdata);
+	};
+
 	struct FaceConnect {
 		List<Face>::Element *left, *right;
 		FaceConnect() {
@@ -92,6 +117,7 @@ private:
 public:
 	static uint32_t debug_stop_after;
 	static Error build(const Vector<Vector3> &p_points, Geometry::MeshData &r_mesh);
+	static void build_batch(const Vector<Vector<Vector3> > &p_point_sets, Vector<Geometry::MeshData> &r_meshes, Vector<Error> *r_errors = NULL);
 };
 
 #endif // QUICK_HULL_H
@@ -77,6 +77,7 @@ public:
 
 	_FORCE_INLINE_ Vector3 xform(const Vector3 &p_vector) const;
 	_FORCE_INLINE_ Vector3 xform_inv(const Vector3 &p_vector) const;
+	_FORCE_INLINE_ void xform_array(const Vector3 *p_src, Vector3 *r_dst, int p_count) const;
 
 	_FORCE_INLINE_ Plane xform(const Plane &p_plane) const;
 	_FORCE_INLINE_ Plane xform_inv(const Plane &p_plane) const;
@@ -117,6 +118,22 @@ _FORCE_INLINE_ Vector3 Transform::xform(const Vector3 &p_vector) const {
 			basis[1].dot(p_vector) + origin.y,
 			basis[2].dot(p_vector) + origin.z);
 }
+_FORCE_INLINE_ void Transform::xform_array(const Vector3 *p_src, Vector3 *r_dst, int p_count) const {
+
+	// matrix is copied to locals so the compiler can keep it in registers and vectorize the loop
+	const real_t xx = basis.elements[0][0], xy = basis.elements[0][1], xz = basis.elements[0][2];
+	const real_t yx = basis.elements[1][0], yy = basis.elements[1][1], yz = basis.elements[1][2];
+	const real_t zx = basis.elements[2][0], zy = basis.elements[2][1], zz = basis.elements[2][2];
+	const real_t ox = origin.x, oy = origin.y, oz = origin.z;
+
+	for (int i = 0; i < p_count; i++) {
+
+		const real_t x = p_src[i].x, y = p_src[i].y, z = p_src[i].z;
+		r_dst[i].x = xx * x + xy * y + xz * z + ox;
+		r_dst[i].y = yx * x + yy * y + yz * z + oy;
+		r_dst[i].z = zx * x + zy * y + zz * z + oz;
+	}
+}
 _FORCE_INLINE_ Vector3 Transform::xform_inv(const Vector3 &p_vector) const {
 
 	Vector3 v = p_vector - origin;
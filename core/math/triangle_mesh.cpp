@@ -29,9 +29,16 @@
 /*************************************************************************/
 
 #include "triangle_mesh.h"
+#include "core/os/worker_thread_pool.h"
 #include "sort.h"
 
-int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc) {
+static _FORCE_INLINE_ real_t _bvh_surface_area(const AABB &p_aabb) {
+
+	const Vector3 &s = p_aabb.size;
+	return s.x * s.y + s.y * s.z + s.z * s.x;
+}
+
+int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int p_alloc_from, Vector<BuildTask> *r_tasks, int p_task_size) {
 
 	if (p_depth > max_depth) {
 		max_depth = p_depth;
@@ -45,39 +52,148 @@ int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, in
 		return -1;
 	}
 
-	AABB aabb;
-	aabb = p_bb[p_from]->aabb;
+	//a subtree with n faces always uses n - 1 internal nodes, laid out in post order
+	//starting at p_alloc_from, so subtrees can be built independently of each other
+	int index = p_alloc_from + p_size - 2;
+
+	if (r_tasks && p_size <= p_task_size) {
+
+		BuildTask task;
+		task.from = p_from;
+		task.size = p_size;
+		task.depth = p_depth;
+		task.alloc_from = p_alloc_from;
+		task.max_depth = p_depth;
+		r_tasks->push_back(task);
+		return index;
+	}
+
+	AABB aabb = p_bb[p_from]->aabb;
+	AABB centers(p_bb[p_from]->center, Vector3());
 	for (int i = 1; i < p_size; i++) {
 
 		aabb.merge_with(p_bb[p_from + i]->aabb);
+		centers.expand_to(p_bb[p_from + i]->center);
 	}
 
-	int li = aabb.get_longest_axis_index();
-
-	switch (li) {
-
-		case Vector3::AXIS_X: {
-			SortArray<BVH *, BVHCmpX> sort_x;
-			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_x.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Y: {
-			SortArray<BVH *, BVHCmpY> sort_y;
-			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_y.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Z: {
-			SortArray<BVH *, BVHCmpZ> sort_z;
-			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_z.sort(&p_bb[p_from],p_size);
-
-		} break;
+	int axis = centers.get_longest_axis_index();
+	real_t extent = centers.size[axis];
+
+	int split = p_size / 2;
+
+	if (p_depth > SAH_MAX_DEPTH || extent <= CMP_EPSILON) {
+
+		//median split keeps degenerate inputs from building very deep trees,
+		//and if all centers are in the same spot any even split is as good as another
+		switch (axis) {
+
+			case Vector3::AXIS_X: {
+				SortArray<BVH *, BVHCmpX> sort_x;
+				sort_x.nth_element(0, p_size, split, &p_bb[p_from]);
+			} break;
+			case Vector3::AXIS_Y: {
+				SortArray<BVH *, BVHCmpY> sort_y;
+				sort_y.nth_element(0, p_size, split, &p_bb[p_from]);
+			} break;
+			case Vector3::AXIS_Z: {
+				SortArray<BVH *, BVHCmpZ> sort_z;
+				sort_z.nth_element(0, p_size, split, &p_bb[p_from]);
+			} break;
+		}
+
+	} else {
+
+		//binned surface area heuristic, on the axis where face centers spread the most
+		enum {
+			BIN_COUNT = 16
+		};
+
+		int bin_count[BIN_COUNT];
+		AABB bin_aabb[BIN_COUNT];
+		for (int i = 0; i < BIN_COUNT; i++) {
+			bin_count[i] = 0;
+		}
+
+		real_t bin_scale = BIN_COUNT / extent;
+		real_t bin_origin = centers.position[axis];
+
+		for (int i = 0; i < p_size; i++) {
+
+			const BVH *b = p_bb[p_from + i];
+			int bin = MIN(int((b->center[axis] - bin_origin) * bin_scale), BIN_COUNT - 1);
+			if (bin_count[bin] == 0) {
+				bin_aabb[bin] = b->aabb;
+			} else {
+				bin_aabb[bin].merge_with(b->aabb);
+			}
+			bin_count[bin]++;
+		}
+
+		real_t right_area[BIN_COUNT];
+		int right_count[BIN_COUNT];
+		{
+			AABB accum;
+			int count = 0;
+			for (int i = BIN_COUNT - 1; i > 0; i--) {
+				if (bin_count[i]) {
+					if (count == 0) {
+						accum = bin_aabb[i];
+					} else {
+						accum.merge_with(bin_aabb[i]);
+					}
+					count += bin_count[i];
+				}
+				right_count[i] = count;
+				right_area[i] = count ? _bvh_surface_area(accum) : 0;
+			}
+		}
+
+		int best_bin = -1;
+		real_t best_cost = 0;
+		{
+			AABB accum;
+			int count = 0;
+			for (int i = 1; i < BIN_COUNT; i++) {
+				if (bin_count[i - 1]) {
+					if (count == 0) {
+						accum = bin_aabb[i - 1];
+					} else {
+						accum.merge_with(bin_aabb[i - 1]);
+					}
+					count += bin_count[i - 1];
+				}
+
+				if (count == 0 || right_count[i] == 0) {
+					continue;
+				}
+
+				real_t cost = _bvh_surface_area(accum) * count + right_area[i] * right_count[i];
+				if (best_bin == -1 || cost < best_cost) {
+					best_bin = i;
+					best_cost = cost;
+				}
+			}
+		}
+
+		if (best_bin != -1) {
+
+			int l = p_from;
+			int r = p_from + p_size - 1;
+			while (l <= r) {
+				if (int((p_bb[l]->center[axis] - bin_origin) * bin_scale) < best_bin) {
+					l++;
+				} else {
+					SWAP(p_bb[l], p_bb[r]);
+					r--;
+				}
+			}
+			split = l - p_from;
+		}
 	}
 
-	int left = _create_bvh(p_bvh, p_bb, p_from, p_size / 2, p_depth + 1, max_depth, max_alloc);
-	int right = _create_bvh(p_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, p_depth + 1, max_depth, max_alloc);
+	int left = _create_bvh(p_bvh, p_bb, p_from, split, p_depth + 1, max_depth, p_alloc_from, r_tasks, p_task_size);
+	int right = _create_bvh(p_bvh, p_bb, p_from + split, p_size - split, p_depth + 1, max_depth, p_alloc_from + split - 1, r_tasks, p_task_size);
 
-	int index = max_alloc++;
 	BVH *_new = &p_bvh[index];
 	_new->aabb = aabb;
 	_new->center = aabb.position + aabb.size * 0.5;
@@ -88,6 +204,14 @@ int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, in
 	return index;
 }
 
+void TriangleMesh::_build_task(void *p_userdata, uint32_t p_index) {
+
+	BuildData *data = (BuildData *)p_userdata;
+	BuildTask &task = data->tasks.write[p_index];
+	task.max_depth = task.depth;
+	_create_bvh(data->bvh, data->bb, task.from, task.size, task.depth, task.max_depth, task.alloc_from, NULL, 0);
+}
+
 void TriangleMesh::get_indices(PoolVector<int> *r_triangles_indices) const {
 
 	if (!valid)
@@ -117,7 +241,7 @@ void TriangleMesh::create(const PoolVector<Vector3> &p_faces) {
 	fc /= 3;
 	triangles.resize(fc);
 
-	bvh.resize(fc * 3); //will never be larger than this (todo make better)
+	bvh.resize(fc * 2 - 1); //faces are the leaves, then one internal node per split
 	PoolVector<BVH>::Write bw = bvh.write();
 
 	{
@@ -178,11 +302,29 @@ void TriangleMesh::create(const PoolVector<Vector3> &p_faces) {
 	}
 
 	max_depth = 0;
-	int max_alloc = fc;
-	_create_bvh(bw.ptr(), bwp.ptr(), 0, fc, 1, max_depth, max_alloc);
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	if (fc >= PARALLEL_BUILD_THRESHOLD && pool && !pool->is_worker_thread()) {
+
+		//split the top of the tree here, then build the subtrees underneath in parallel
+		BuildData data;
+		data.bvh = bw.ptr();
+		data.bb = bwp.ptr();
+		_create_bvh(bw.ptr(), bwp.ptr(), 0, fc, 1, max_depth, fc, &data.tasks, MAX(fc / 64, PARALLEL_BUILD_THRESHOLD / 8));
+
+		WorkerThreadPool::GroupID group = pool->add_group_task(_build_task, &data, data.tasks.size());
+		pool->wait_for_group_task_completion(group);
+
+		for (int i = 0; i < data.tasks.size(); i++) {
+			max_depth = MAX(max_depth, data.tasks[i].max_depth);
+		}
+	} else {
+
+		_create_bvh(bw.ptr(), bwp.ptr(), 0, fc, 1, max_depth, fc, NULL, 0);
+	}
 
 	bw = PoolVector<BVH>::Write(); //clearup
-	bvh.resize(max_alloc); //resize back
 
 	valid = true;
 }
@@ -282,26 +424,39 @@ Vector3 TriangleMesh::get_area_normal(const AABB &p_aabb) const {
 	return n;
 }
 
-bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
+static _FORCE_INLINE_ bool _bvh_ray_hits_aabb(const AABB &p_aabb, const Vector3 &p_from, const Vector3 &p_inv_dir, real_t p_max_t, real_t &r_t) {
 
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
+	//slab test against the precomputed inverse direction, no divisions or branches per axis
+	real_t tx0 = (p_aabb.position.x - p_from.x) * p_inv_dir.x;
+	real_t tx1 = (p_aabb.position.x + p_aabb.size.x - p_from.x) * p_inv_dir.x;
+	real_t ty0 = (p_aabb.position.y - p_from.y) * p_inv_dir.y;
+	real_t ty1 = (p_aabb.position.y + p_aabb.size.y - p_from.y) * p_inv_dir.y;
+	real_t tz0 = (p_aabb.position.z - p_from.z) * p_inv_dir.z;
+	real_t tz1 = (p_aabb.position.z + p_aabb.size.z - p_from.z) * p_inv_dir.z;
 
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
+	real_t tmin = MAX(MAX(MIN(tx0, tx1), MIN(ty0, ty1)), MAX(MIN(tz0, tz1), (real_t)0));
+	real_t tmax = MIN(MIN(MAX(tx0, tx1), MAX(ty0, ty1)), MIN(MAX(tz0, tz1), p_max_t));
+
+	r_t = tmin;
+	return tmin <= tmax;
+}
+
+int TriangleMesh::_intersect_nearest(const Vector3 &p_from, const Vector3 &p_dir, real_t p_min_t, real_t p_max_t, real_t &r_t) const {
 
+	if (!valid)
+		return -1;
+
+	struct StackEntry {
+		int node;
+		real_t t;
 	};
 
-	Vector3 n = (p_end - p_begin).normalized();
-	real_t d = 1e10;
-	bool inters = false;
+	StackEntry *stack = (StackEntry *)alloca(sizeof(StackEntry) * (max_depth + 1));
 
-	int level = 0;
+	Vector3 inv_dir;
+	for (int i = 0; i < 3; i++) {
+		inv_dir[i] = p_dir[i] != 0 ? 1.0 / p_dir[i] : 1e32;
+	}
 
 	PoolVector<Triangle>::Read trianglesr = triangles.read();
 	PoolVector<Vector3>::Read verticesr = vertices.read();
@@ -309,205 +464,171 @@ bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_en
 
 	const Triangle *triangleptr = trianglesr.ptr();
 	const Vector3 *vertexptr = verticesr.ptr();
-	int pos = bvh.size() - 1;
 	const BVH *bvhptr = bvhr.ptr();
+	int root = bvh.size() - 1;
 
-	stack[0] = pos;
-	while (true) {
-
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
-
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-
-				bool valid = b.aabb.intersects_segment(p_begin, p_end);
-				//bool valid = b.aabb.intersects(ray_aabb);
-
-				if (!valid) {
-
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-				} else {
-
-					if (b.face_index >= 0) {
-
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
+	int face = -1;
+	real_t best_t = p_max_t;
 
-						Vector3 res;
+	int level = 0;
+	real_t root_t;
+	if (_bvh_ray_hits_aabb(bvhptr[root].aabb, p_from, inv_dir, best_t, root_t)) {
+		stack[0].node = root;
+		stack[0].t = root_t;
+		level = 1;
+	}
 
-						if (f3.intersects_segment(p_begin, p_end, &res)) {
+	while (level > 0) {
 
-							real_t nd = n.dot(res);
-							if (nd < d) {
+		level--;
+		if (stack[level].t > best_t) {
+			continue; //something closer was already found
+		}
 
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								inters = true;
-							}
-						}
+		const BVH &b = bvhptr[stack[level].node];
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+		if (b.face_index >= 0) {
 
-					} else {
+			const Triangle &s = triangleptr[b.face_index];
+			const Vector3 &v0 = vertexptr[s.indices[0]];
+			Vector3 e1 = vertexptr[s.indices[1]] - v0;
+			Vector3 e2 = vertexptr[s.indices[2]] - v0;
 
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
+			//same test as Geometry::ray_intersects_triangle, but keeping the distance
+			Vector3 h = p_dir.cross(e2);
+			real_t a = e1.dot(h);
+			if (a > -CMP_EPSILON && a < CMP_EPSILON)
 				continue;
-			}
-			case VISIT_LEFT_BIT: {
 
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
+			real_t f = 1.0 / a;
+			Vector3 sv = p_from - v0;
+			real_t u = f * sv.dot(h);
+			if (u < 0.0 || u > 1.0)
 				continue;
-			}
-			case VISIT_RIGHT_BIT: {
 
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
+			Vector3 q = sv.cross(e1);
+			real_t v = f * p_dir.dot(q);
+			if (v < 0.0 || u + v > 1.0)
 				continue;
-			}
-			case VISIT_DONE_BIT: {
 
-				if (level == 0) {
-					done = true;
-					break;
-				} else
-					level--;
-				continue;
+			real_t t = f * e2.dot(q);
+			if (t > p_min_t && t <= p_max_t && (face == -1 || t < best_t)) {
+				face = b.face_index;
+				best_t = t;
 			}
+			continue;
 		}
 
-		if (done)
-			break;
-	}
-
-	if (inters) {
-
-		if (n.dot(r_normal) > 0)
-			r_normal = -r_normal;
+		real_t left_t, right_t;
+		bool left = _bvh_ray_hits_aabb(bvhptr[b.left].aabb, p_from, inv_dir, best_t, left_t);
+		bool right = _bvh_ray_hits_aabb(bvhptr[b.right].aabb, p_from, inv_dir, best_t, right_t);
+
+		//push the farthest child first, so the nearest one is visited next and can prune it
+		if (left && right) {
+			if (left_t < right_t) {
+				stack[level].node = b.right;
+				stack[level].t = right_t;
+				stack[level + 1].node = b.left;
+				stack[level + 1].t = left_t;
+			} else {
+				stack[level].node = b.left;
+				stack[level].t = left_t;
+				stack[level + 1].node = b.right;
+				stack[level + 1].t = right_t;
+			}
+			level += 2;
+		} else if (left) {
+			stack[level].node = b.left;
+			stack[level].t = left_t;
+			level++;
+		} else if (right) {
+			stack[level].node = b.right;
+			stack[level].t = right_t;
+			level++;
+		}
 	}
 
-	return inters;
+	r_t = best_t;
+	return face;
 }
 
-bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal) const {
-
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	Vector3 n = p_dir;
-	real_t d = 1e20;
-	bool inters = false;
-
-	int level = 0;
+Vector3 TriangleMesh::_get_face_normal(int p_face) const {
 
 	PoolVector<Triangle>::Read trianglesr = triangles.read();
 	PoolVector<Vector3>::Read verticesr = vertices.read();
-	PoolVector<BVH>::Read bvhr = bvh.read();
 
-	const Triangle *triangleptr = trianglesr.ptr();
-	const Vector3 *vertexptr = verticesr.ptr();
-	int pos = bvh.size() - 1;
-	const BVH *bvhptr = bvhr.ptr();
+	const Triangle &s = trianglesr[p_face];
+	return Face3(verticesr[s.indices[0]], verticesr[s.indices[1]], verticesr[s.indices[2]]).get_plane().get_normal();
+}
 
-	stack[0] = pos;
-	while (true) {
+bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
 
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+	Vector3 rel = p_end - p_begin;
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
+	real_t t;
+	int face = _intersect_nearest(p_begin, rel, CMP_EPSILON, 1.0, t);
+	if (face < 0)
+		return false;
 
-				bool valid = b.aabb.intersects_ray(p_begin, p_dir);
-				if (!valid) {
+	r_point = p_begin + rel * t;
+	r_normal = _get_face_normal(face);
 
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+	if (rel.dot(r_normal) > 0)
+		r_normal = -r_normal;
 
-				} else {
+	return true;
+}
 
-					if (b.face_index >= 0) {
+bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal) const {
 
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
+	real_t t;
+	int face = _intersect_nearest(p_begin, p_dir, 0.00001, 1e20, t);
+	if (face < 0)
+		return false;
 
-						Vector3 res;
+	r_point = p_begin + p_dir * t;
+	r_normal = _get_face_normal(face);
 
-						if (f3.intersects_ray(p_begin, p_dir, &res)) {
+	return true;
+}
 
-							real_t nd = n.dot(res);
-							if (nd < d) {
+void TriangleMesh::_intersect_rays_task(void *p_userdata, uint32_t p_index) {
 
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								inters = true;
-							}
-						}
+	RayBatch *batch = (RayBatch *)p_userdata;
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+	int from = p_index * RAY_BATCH_SIZE;
+	int to = MIN(from + RAY_BATCH_SIZE, batch->count);
 
-					} else {
+	for (int i = from; i < to; i++) {
+		RayResult &r = batch->results[i];
+		r.hit = batch->mesh->intersect_ray(batch->from[i], batch->dir[i], r.point, r.normal);
+	}
+}
 
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
+void TriangleMesh::intersect_rays(const Vector3 *p_from, const Vector3 *p_dir, RayResult *r_results, int p_count, bool p_parallel) const {
 
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
+	RayBatch batch;
+	batch.mesh = this;
+	batch.from = p_from;
+	batch.dir = p_dir;
+	batch.results = r_results;
+	batch.count = p_count;
 
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
+	int batches = (p_count + RAY_BATCH_SIZE - 1) / RAY_BATCH_SIZE;
 
-				if (level == 0) {
-					done = true;
-					break;
-				} else
-					level--;
-				continue;
-			}
-		}
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
 
-		if (done)
-			break;
-	}
+	//callers already running on the pool (such as bakers splitting work per pixel) keep their rays on the same thread
+	if (p_parallel && batches > 1 && pool && !pool->is_worker_thread()) {
 
-	if (inters) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_intersect_rays_task, &batch, batches);
+		pool->wait_for_group_task_completion(group);
+	} else {
 
-		if (n.dot(r_normal) > 0)
-			r_normal = -r_normal;
+		for (int i = 0; i < batches; i++) {
+			_intersect_rays_task(&batch, i);
+		}
 	}
-
-	return inters;
 }
 
 bool TriangleMesh::intersect_convex_shape(const Plane *p_planes, int p_plane_count) const {
@@ -37,6 +37,21 @@ class TriangleMesh : public Reference {
 
 	GDCLASS(TriangleMesh, Reference);
 
+public:
+	struct RayResult {
+
+		Vector3 point;
+		Vector3 normal;
+		bool hit;
+	};
+
+private:
+	enum {
+		SAH_MAX_DEPTH = 48, //past this, split at the median so depth stays bounded
+		PARALLEL_BUILD_THRESHOLD = 8192,
+		RAY_BATCH_SIZE = 256,
+	};
+
 	struct Triangle {
 
 		Vector3 normal;
@@ -79,7 +94,37 @@ class TriangleMesh : public Reference {
 		}
 	};
 
-	int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc);
+	struct BuildTask {
+
+		int from;
+		int size;
+		int depth;
+		int alloc_from;
+		int max_depth;
+	};
+
+	struct BuildData {
+
+		BVH *bvh;
+		BVH **bb;
+		Vector<BuildTask> tasks;
+	};
+
+	struct RayBatch {
+
+		const TriangleMesh *mesh;
+		const Vector3 *from;
+		const Vector3 *dir;
+		RayResult *results;
+		int count;
+	};
+
+	static int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int p_alloc_from, Vector<BuildTask> *r_tasks, int p_task_size);
+	static void _build_task(void *p_userdata, uint32_t p_index);
+
+	int _intersect_nearest(const Vector3 &p_from, const Vector3 &p_dir, real_t p_min_t, real_t p_max_t, real_t &r_t) const;
+	Vector3 _get_face_normal(int p_face) const;
+	static void _intersect_rays_task(void *p_userdata, uint32_t p_index);
 
 	PoolVector<BVH> bvh;
 	int max_depth;
@@ -89,6 +134,7 @@ public:
 	bool is_valid() const;
 	bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const;
 	bool intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal) const;
+	void intersect_rays(const Vector3 *p_from, const Vector3 *p_dir, RayResult *r_results, int p_count, bool p_parallel = true) const;
 	bool intersect_convex_shape(const Plane *p_planes, int p_plane_count) const;
 	bool inside_convex_shape(const Plane *p_planes, int p_plane_count, Vector3 p_scale = Vector3(1, 1, 1)) const;
 	Vector3 get_area_normal(const AABB &p_aabb) const;
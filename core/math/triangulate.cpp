@@ -30,6 +30,10 @@
 
 #include "triangulate.h"
 
+#include "hash_map.h"
+#include "pair.h"
+#include "thirdparty/misc/triangulator.h"
+
 real_t Triangulate::get_area(const Vector<Vector2> &contour) {
 
 	int n = contour.size();
@@ -193,3 +197,187 @@ bool Triangulate::triangulate(const Vector<Vector2> &contour, Vector<int> &resul
 
 	return true;
 }
+
+struct _TriangulatePointHasher {
+
+	static _FORCE_INLINE_ uint32_t hash(const Vector2 &p_point) {
+		uint32_t h = hash_djb2_one_float(p_point.x);
+		return hash_djb2_one_float(p_point.y, h);
+	}
+};
+
+bool Triangulate::triangulate_monotone(const Vector<Vector2> &p_outline, const Vector<Vector<Vector2> > &p_holes, Vector<int> &r_result) {
+
+	if (p_outline.size() < 3)
+		return false;
+
+	// the triangulator works on positions, remember where each one came from
+	HashMap<Vector2, int, _TriangulatePointHasher> indices;
+	List<TriangulatorPoly> in_poly, out_poly;
+
+	int base = 0;
+	for (int i = -1; i < p_holes.size(); i++) {
+
+		const Vector<Vector2> &points = i < 0 ? p_outline : p_holes[i];
+		int point_count = points.size();
+
+		if (point_count >= 3) {
+
+			TriangulatorPoly tp;
+			tp.Init(point_count);
+			for (int j = 0; j < point_count; j++) {
+				tp[j] = points[j];
+				if (!indices.has(points[j])) {
+					indices.set(points[j], base + j);
+				}
+			}
+
+			if (i < 0) {
+				tp.SetOrientation(TRIANGULATOR_CCW);
+			} else {
+				tp.SetOrientation(TRIANGULATOR_CW);
+				tp.SetHole(true);
+			}
+
+			in_poly.push_back(tp);
+		}
+
+		base += point_count;
+	}
+
+	TriangulatorPartition tpart;
+	if (tpart.Triangulate_MONO(&in_poly, &out_poly) == 0)
+		return false;
+
+	r_result.resize(out_poly.size() * 3);
+	int *w = r_result.ptrw();
+
+	for (List<TriangulatorPoly>::Element *I = out_poly.front(); I; I = I->next()) {
+
+		TriangulatorPoly &tp = I->get();
+		ERR_FAIL_COND_V(tp.GetNumPoints() != 3, false);
+
+		for (int i = 0; i < 3; i++) {
+			const int *idx = indices.getptr(tp[i]);
+			ERR_FAIL_COND_V(!idx, false);
+			*w++ = *idx;
+		}
+	}
+
+	return true;
+}
+
+void Triangulate::merge_convex(const Vector<Vector2> &p_points, const Vector<int> &p_triangles, Vector<Vector<int> > &r_polygons) {
+
+	int tri_count = p_triangles.size() / 3;
+
+	Vector<Vector<int> > polygons;
+	polygons.resize(tri_count);
+
+	// shared edge -> the two polygons on each side of it
+	HashMap<uint64_t, Pair<int, int> > edges;
+	Vector<uint64_t> diagonals;
+
+	for (int i = 0; i < tri_count; i++) {
+
+		Vector<int> &poly = polygons.write[i];
+		poly.resize(3);
+
+		for (int j = 0; j < 3; j++) {
+
+			int a = p_triangles[i * 3 + j];
+			int b = p_triangles[i * 3 + (j + 1) % 3];
+			poly.write[j] = a;
+
+			uint64_t key = (uint64_t(MIN(a, b)) << 32) | uint64_t(MAX(a, b));
+			Pair<int, int> *E = edges.getptr(key);
+			if (E) {
+				E->second = i;
+				diagonals.push_back(key);
+			} else {
+				edges.set(key, Pair<int, int>(i, -1));
+			}
+		}
+	}
+
+	const Vector2 *points = p_points.ptr();
+
+	for (int i = 0; i < diagonals.size(); i++) {
+
+		uint64_t key = diagonals[i];
+		const Pair<int, int> &E = edges[key];
+		if (E.second < 0 || E.first == E.second)
+			continue;
+
+		const Vector<int> &poly_A = polygons[E.first];
+		const Vector<int> &poly_B = polygons[E.second];
+
+		// find the edge in both polygons, A walks a->b and B walks b->a
+		int a = key >> 32;
+		int b = key & 0xFFFFFFFF;
+
+		int pos_A = poly_A.find(a);
+		if (poly_A[(pos_A + 1) % poly_A.size()] != b) {
+			SWAP(a, b);
+			pos_A = poly_A.find(a);
+		}
+		int pos_B = poly_B.find(b);
+		ERR_CONTINUE(pos_A < 0 || pos_B < 0 || poly_B[(pos_B + 1) % poly_B.size()] != a);
+
+		// merged: A from b around to a, then B from the vertex after a to the one before b
+		Vector<int> merged;
+		merged.resize(poly_A.size() + poly_B.size() - 2);
+		int *mw = merged.ptrw();
+		int count = 0;
+		for (int j = 0; j < poly_A.size(); j++) {
+			mw[count++] = poly_A[(pos_A + 1 + j) % poly_A.size()];
+		}
+		for (int j = 2; j < poly_B.size(); j++) {
+			mw[count++] = poly_B[(pos_B + j) % poly_B.size()];
+		}
+
+		// only the vertices of the removed diagonal can turn concave
+		bool convex = true;
+		int merged_size = merged.size();
+		int corners[2] = { 0, poly_A.size() - 1 };
+		for (int j = 0; j < 2; j++) {
+			int c = corners[j];
+			const Vector2 &prev = points[merged[(c + merged_size - 1) % merged_size]];
+			const Vector2 &cur = points[merged[c]];
+			const Vector2 &next = points[merged[(c + 1) % merged_size]];
+			if ((cur - prev).cross(next - cur) < -CMP_EPSILON) {
+				convex = false;
+				break;
+			}
+		}
+
+		if (!convex)
+			continue;
+
+		// B goes away, its other edges now border A
+		int removed = E.second;
+		int kept = E.first;
+		const Vector<int> &old_B = polygons[removed];
+		for (int j = 0; j < old_B.size(); j++) {
+			int ea = old_B[j];
+			int eb = old_B[(j + 1) % old_B.size()];
+			Pair<int, int> *O = edges.getptr((uint64_t(MIN(ea, eb)) << 32) | uint64_t(MAX(ea, eb)));
+			if (!O)
+				continue;
+			if (O->first == removed)
+				O->first = kept;
+			if (O->second == removed)
+				O->second = kept;
+		}
+
+		polygons.write[kept] = merged;
+		polygons.write[removed].clear();
+	}
+
+	r_polygons.clear();
+	for (int i = 0; i < polygons.size(); i++) {
+		if (polygons[i].size()) {
+			r_polygons.push_back(polygons[i]);
+		}
+	}
+}
@@ -43,6 +43,14 @@ public:
 	// as series of triangles.
 	static bool triangulate(const Vector<Vector2> &contour, Vector<int> &result);
 
+	// triangulate an outline with holes through monotone pieces in O(n log n),
+	// indices refer to the outline points followed by the points of each hole.
+	static bool triangulate_monotone(const Vector<Vector2> &p_outline, const Vector<Vector<Vector2> > &p_holes, Vector<int> &r_result);
+
+	// merge the triangles of a triangulation into convex polygons (Hertel-Mehlhorn),
+	// all triangles are expected to be counter-clockwise.
+	static void merge_convex(const Vector<Vector2> &p_points, const Vector<int> &p_triangles, Vector<Vector<int> > &r_polygons);
+
 	// compute area of a contour/polygon
 	static real_t get_area(const Vector<Vector2> &contour);
 
@@ -30,7 +30,9 @@
 
 #include "message_queue.h"
 
+#include "os/thread.h"
 #include "project_settings.h"
+#include "safe_refcount.h"
 #include "script_language.h"
 
 MessageQueue *MessageQueue::singleton = NULL;
@@ -40,23 +42,71 @@ MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+MessageQueue::Message *MessageQueue::_allocate_message(uint32_t p_args_size, Node **r_node) {
+
+	if (Thread::get_caller_id() == Thread::get_main_id() && (buffer_end + sizeof(Message) + p_args_size) < buffer_size) {
+
+		Message *msg = memnew_placement(&buffer[buffer_end], Message);
+		msg->sequence = atomic_increment(&sequence);
+		buffer_end += sizeof(Message) + p_args_size;
+		*r_node = NULL;
+		return msg;
+	}
+
+	Node *node = (Node *)memalloc(sizeof(Node) + p_args_size);
+	ERR_FAIL_COND_V(!node, NULL);
+	memnew_placement(&node->message, Message);
+	node->message.sequence = atomic_increment(&sequence);
+	*r_node = node;
+	return &node->message;
+}
+
+void MessageQueue::_publish_node(Node *p_node) {
 
-	_THREAD_SAFE_METHOD_
+	if (!p_node)
+		return;
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	while (true) {
+		Node *head = pending;
+		p_node->next = head;
+		if (atomic_compare_and_swap_ptr((void *volatile *)&pending, head, p_node) == head)
+			break;
+	}
+}
+
+void MessageQueue::_take_pending() {
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed method: " + type + ":" + p_method + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	if (!pending)
+		return;
+
+	Node *list;
+	do {
+		list = pending;
+	} while (atomic_compare_and_swap_ptr((void *volatile *)&pending, list, NULL) != list);
+
+	// the list was built newest first
+	Node *first = NULL;
+	Node *last = list;
+	while (list) {
+		Node *next = list->next;
+		list->next = first;
+		first = list;
+		list = next;
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	if (pending_last)
+		pending_last->next = first;
+	else
+		pending_first = first;
+	pending_last = last;
+}
+
+Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+
+	Node *node;
+	Message *msg = _allocate_message(sizeof(Variant) * p_argcount, &node);
+	ERR_FAIL_COND_V(!msg, ERR_OUT_OF_MEMORY);
+
 	msg->args = p_argcount;
 	msg->instance_ID = p_id;
 	msg->target = p_method;
@@ -64,15 +114,16 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 	if (p_show_error)
 		msg->type |= FLAG_SHOW_ERROR;
 
-	buffer_end += sizeof(Message);
+	Variant *args = (Variant *)(msg + 1);
 
 	for (int i = 0; i < p_argcount; i++) {
 
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	_publish_node(node);
+
 	return OK;
 }
 
@@ -93,61 +144,37 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
 
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
-	}
+	Node *node;
+	Message *msg = _allocate_message(sizeof(Variant), &node);
+	ERR_FAIL_COND_V(!msg, ERR_OUT_OF_MEMORY);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
 	msg->args = 1;
 	msg->instance_ID = p_id;
 	msg->target = p_prop;
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement((Variant *)(msg + 1), Variant);
 	*v = p_value;
 
+	_publish_node(node);
+
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Node *node;
+	Message *msg = _allocate_message(0, &node);
+	ERR_FAIL_COND_V(!msg, ERR_OUT_OF_MEMORY);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->instance_ID = p_id;
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_publish_node(node);
 
 	return OK;
 }
@@ -222,8 +249,14 @@ void MessageQueue::statistics() {
 			read_pos += sizeof(Variant) * message->args;
 	}
 
+	int node_count = 0;
+	for (Node *node = pending_first; node; node = node->next) {
+		node_count++;
+	}
+
 	print_line("TOTAL BYTES: " + itos(buffer_end));
 	print_line("NULL count: " + itos(null_count));
+	print_line("NODE count: " + itos(node_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
 
@@ -273,23 +306,37 @@ void MessageQueue::flush() {
 
 	uint32_t read_pos = 0;
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+	while (true) {
 
-	while (read_pos < buffer_end) {
+		// checked on each iteration, so a call can re-add itself to the message queue
+		_take_pending();
 
-		//lock on each iteration, so a call can re-add itself to the message queue
+		Message *message = NULL;
+		Node *node = NULL;
 
-		Message *message = (Message *)&buffer[read_pos];
+		if (read_pos < buffer_end)
+			message = (Message *)&buffer[read_pos];
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			advance += sizeof(Variant) * message->args;
+		if (pending_first && (!message || int32_t(pending_first->message.sequence - message->sequence) < 0)) {
+
+			node = pending_first;
+			pending_first = node->next;
+			if (!pending_first)
+				pending_last = NULL;
+			message = &node->message;
+
+		} else if (message) {
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+			uint32_t advance = sizeof(Message);
+			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
+				advance += sizeof(Variant) * message->args;
 
-		_THREAD_SAFE_UNLOCK_
+			//pre-advance so this function is reentrant
+			read_pos += advance;
+
+		} else {
+			break;
+		}
 
 		Object *target = ObjectDB::get_instance(message->instance_ID);
 
@@ -304,10 +351,6 @@ void MessageQueue::flush() {
 
 					_call_function(target, message->target, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-					for (int i = 0; i < message->args; i++) {
-						args[i].~Variant();
-					}
-
 				} break;
 				case TYPE_NOTIFICATION: {
 
@@ -321,18 +364,24 @@ void MessageQueue::flush() {
 					// messages don't expect a return value
 					target->set(message->target, *arg);
 
-					arg->~Variant();
 				} break;
 			}
 		}
 
+		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+			Variant *args = (Variant *)(message + 1);
+			for (int i = 0; i < message->args; i++) {
+				args[i].~Variant();
+			}
+		}
+
 		message->~Message();
 
-		_THREAD_SAFE_LOCK_
+		if (node)
+			memfree(node);
 	}
 
 	buffer_end = 0; // reset buffer
-	_THREAD_SAFE_UNLOCK_
 }
 
 MessageQueue::MessageQueue() {
@@ -345,6 +394,11 @@ MessageQueue::MessageQueue() {
 	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	buffer_size *= 1024;
 	buffer = memnew_arr(uint8_t, buffer_size);
+
+	pending = NULL;
+	pending_first = NULL;
+	pending_last = NULL;
+	sequence = 0;
 }
 
 MessageQueue::~MessageQueue() {
@@ -367,6 +421,23 @@ MessageQueue::~MessageQueue() {
 			read_pos += sizeof(Variant) * message->args;
 	}
 
+	_take_pending();
+
+	while (pending_first) {
+
+		Node *node = pending_first;
+		pending_first = node->next;
+
+		Message *message = &node->message;
+		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+			Variant *args = (Variant *)(message + 1);
+			for (int i = 0; i < message->args; i++)
+				args[i].~Variant();
+		}
+		message->~Message();
+		memfree(node);
+	}
+
 	singleton = NULL;
 	memdelete_arr(buffer);
 }
@@ -32,20 +32,14 @@
 #define MESSAGE_QUEUE_H
 
 #include "object.h"
-#include "os/mutex.h"
-#include "os/thread_safe.h"
 
 class MessageQueue {
 
-	_THREAD_SAFE_CLASS_
-
 	enum {
 
 		DEFAULT_QUEUE_SIZE_KB = 1024
 	};
 
-	Mutex *mutex;
-
 	enum {
 		TYPE_CALL,
 		TYPE_NOTIFICATION,
@@ -64,6 +58,16 @@ class MessageQueue {
 			int16_t notification;
 			int16_t args;
 		};
+		uint32_t sequence;
+	};
+
+	// The main thread writes messages into the buffer. Other threads (and the main thread,
+	// once the buffer is full) allocate a node per message and push it to a lock-free list
+	// instead, flush() merges both back in push order using the sequence numbers.
+	struct Node {
+
+		Node *next;
+		Message message; // followed by its arguments
 	};
 
 	uint8_t *buffer;
@@ -71,6 +75,15 @@ class MessageQueue {
 	uint32_t buffer_max_used;
 	uint32_t buffer_size;
 
+	Node *volatile pending; // newest first
+	Node *pending_first; // taken by flush(), oldest first
+	Node *pending_last;
+	uint32_t sequence;
+
+	Message *_allocate_message(uint32_t p_args_size, Node **r_node);
+	void _publish_node(Node *p_node);
+	void _take_pending();
+
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
@@ -44,6 +44,10 @@
  *
  * The entries are stored inplace, so huge keys or values might fill cache lines
  * a lot faster.
+ *
+ * The capacity is always a power of two, so probing only needs a mask. Hashes
+ * are mixed before use, which keeps sequential or strided integer keys from
+ * clustering.
  */
 template <class TKey, class TValue,
 		class Hasher = HashMapHasherDefault,
@@ -60,26 +64,27 @@ private:
 	uint32_t num_elements;
 
 	static const uint32_t EMPTY_HASH = 0;
-	static const uint32_t DELETED_HASH_BIT = 1 << 31;
 
-	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) {
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
 		uint32_t hash = Hasher::hash(p_key);
 
+		// murmur3 finalizer
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6b;
+		hash ^= hash >> 13;
+		hash *= 0xc2b2ae35;
+		hash ^= hash >> 16;
+
 		if (hash == EMPTY_HASH) {
 			hash = EMPTY_HASH + 1;
-		} else if (hash & DELETED_HASH_BIT) {
-			hash &= ~DELETED_HASH_BIT;
 		}
 
 		return hash;
 	}
 
-	_FORCE_INLINE_ uint32_t _get_probe_length(uint32_t p_pos, uint32_t p_hash) {
-		p_hash = p_hash & ~DELETED_HASH_BIT; // we don't care if it was deleted or not
-
-		uint32_t original_pos = p_hash % capacity;
+	_FORCE_INLINE_ uint32_t _get_probe_length(uint32_t p_pos, uint32_t p_hash) const {
 
-		return p_pos - original_pos;
+		return (p_pos - p_hash) & (capacity - 1); // probing wraps around the end of the table
 	}
 
 	_FORCE_INLINE_ void _construct(uint32_t p_pos, uint32_t p_hash, const TKey &p_key, const TValue &p_value) {
@@ -90,26 +95,62 @@ private:
 		num_elements++;
 	}
 
-	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) {
+	_FORCE_INLINE_ void _destruct(uint32_t p_pos) {
+		values[p_pos].~TValue();
+		keys[p_pos].~TKey();
+		hashes[p_pos] = EMPTY_HASH;
+	}
+
+	// keys and values are raw memory, only the slots with a hash hold constructed objects
+	void _allocate(uint32_t p_capacity) {
+
+		capacity = p_capacity;
+		keys = (TKey *)memalloc(sizeof(TKey) * capacity);
+		values = (TValue *)memalloc(sizeof(TValue) * capacity);
+		hashes = (uint32_t *)memalloc(sizeof(uint32_t) * capacity);
+
+		for (uint32_t i = 0; i < capacity; i++) {
+			hashes[i] = EMPTY_HASH;
+		}
+	}
+
+	void _free() {
+
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (hashes[i] != EMPTY_HASH) {
+				values[i].~TValue();
+				keys[i].~TKey();
+			}
+		}
+
+		memfree(keys);
+		memfree(values);
+		memfree(hashes);
+	}
+
+	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
 		uint32_t hash = _hash(p_key);
-		uint32_t pos = hash % capacity;
+		uint32_t mask = capacity - 1;
+		uint32_t pos = hash & mask;
 		uint32_t distance = 0;
 
 		while (42) {
-			if (hashes[pos] == EMPTY_HASH) {
+			uint32_t existing = hashes[pos];
+
+			if (existing == EMPTY_HASH) {
 				return false;
 			}
 
-			if (distance > _get_probe_length(pos, hashes[pos])) {
+			if (distance > _get_probe_length(pos, existing)) {
 				return false;
 			}
 
-			if (hashes[pos] == hash && Comparator::compare(keys[pos], p_key)) {
+			if (existing == hash && Comparator::compare(keys[pos], p_key)) {
 				r_pos = pos;
 				return true;
 			}
 
-			pos = (pos + 1) % capacity;
+			pos = (pos + 1) & mask;
 			distance++;
 		}
 	}
@@ -118,14 +159,32 @@ private:
 
 		uint32_t hash = p_hash;
 		uint32_t distance = 0;
-		uint32_t pos = hash % capacity;
+		uint32_t mask = capacity - 1;
+		uint32_t pos = hash & mask;
+
+		// the first pass only looks, the entry is copied once a richer slot is found
+		while (42) {
+			if (hashes[pos] == EMPTY_HASH) {
+				_construct(pos, hash, p_key, p_value);
+
+				return;
+			}
+
+			uint32_t existing_probe_len = _get_probe_length(pos, hashes[pos]);
+			if (existing_probe_len < distance) {
+				break;
+			}
+
+			pos = (pos + 1) & mask;
+			distance++;
+		}
 
 		TKey key = p_key;
 		TValue value = p_value;
 
 		while (42) {
 			if (hashes[pos] == EMPTY_HASH) {
-				_construct(pos, hash, p_key, p_value);
+				_construct(pos, hash, key, value);
 
 				return;
 			}
@@ -134,23 +193,17 @@ private:
 			uint32_t existing_probe_len = _get_probe_length(pos, hashes[pos]);
 			if (existing_probe_len < distance) {
 
-				if (hashes[pos] & DELETED_HASH_BIT) {
-					// we found a place where we can fit in!
-					_construct(pos, hash, p_key, p_value);
-
-					return;
-				}
-
 				SWAP(hash, hashes[pos]);
 				SWAP(key, keys[pos]);
 				SWAP(value, values[pos]);
 				distance = existing_probe_len;
 			}
 
-			pos = (pos + 1) % capacity;
+			pos = (pos + 1) & mask;
 			distance++;
 		}
 	}
+
 	void _resize_and_rehash() {
 
 		TKey *old_keys = keys;
@@ -159,31 +212,35 @@ private:
 
 		uint32_t old_capacity = capacity;
 
-		capacity = old_capacity * 2;
 		num_elements = 0;
-
-		keys = memnew_arr(TKey, capacity);
-		values = memnew_arr(TValue, capacity);
-		hashes = memnew_arr(uint32_t, capacity);
-
-		for (int i = 0; i < capacity; i++) {
-			hashes[i] = 0;
-		}
+		_allocate(old_capacity * 2);
 
 		for (uint32_t i = 0; i < old_capacity; i++) {
 			if (old_hashes[i] == EMPTY_HASH) {
 				continue;
 			}
-			if (old_hashes[i] & DELETED_HASH_BIT) {
-				continue;
-			}
 
 			_insert_with_hash(old_hashes[i], old_keys[i], old_values[i]);
+
+			old_values[i].~TValue();
+			old_keys[i].~TKey();
 		}
 
-		memdelete_arr(old_keys);
-		memdelete_arr(old_values);
-		memdelete_arr(old_hashes);
+		memfree(old_keys);
+		memfree(old_values);
+		memfree(old_hashes);
+	}
+
+	void _copy_from(const OAHashMap &p_other) {
+
+		_allocate(p_other.capacity);
+		num_elements = 0;
+
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (p_other.hashes[i] != EMPTY_HASH) {
+				_construct(i, p_other.hashes[i], p_other.keys[i], p_other.values[i]);
+			}
+		}
 	}
 
 public:
@@ -192,7 +249,8 @@ public:
 
 	void insert(const TKey &p_key, const TValue &p_value) {
 
-		if ((float)num_elements / (float)capacity > 0.9) {
+		// keep the load factor at or below 7/8
+		if ((uint64_t)(num_elements + 1) * 8 > (uint64_t)capacity * 7) {
 			_resize_and_rehash();
 		}
 
@@ -206,8 +264,7 @@ public:
 		bool exists = _lookup_pos(p_key, pos);
 
 		if (exists) {
-			values[pos].~TValue();
-			memnew_placement(&values[pos], TValue(p_data));
+			values[pos] = p_data;
 		} else {
 			insert(p_key, p_data);
 		}
@@ -219,24 +276,48 @@ public:
 	 * if r_data is not NULL then the value will be written to the object
 	 * it points to.
 	 */
-	bool lookup(const TKey &p_key, TValue &r_data) {
+	bool lookup(const TKey &p_key, TValue &r_data) const {
 		uint32_t pos = 0;
 		bool exists = _lookup_pos(p_key, pos);
 
 		if (exists) {
-			r_data.~TValue();
-			memnew_placement(&r_data, TValue(values[pos]));
+			r_data = values[pos];
 			return true;
 		}
 
 		return false;
 	}
 
-	_FORCE_INLINE_ bool has(const TKey &p_key) {
+	/**
+	 * returns a pointer to the value, or NULL if the key is not in the map.
+	 * the pointer is only valid until the map is modified.
+	 */
+	_FORCE_INLINE_ TValue *lookup_ptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		return _lookup_pos(p_key, pos) ? &values[pos] : NULL;
+	}
+
+	_FORCE_INLINE_ const TValue *lookup_ptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		return _lookup_pos(p_key, pos) ? &values[pos] : NULL;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
 		uint32_t _pos = 0;
 		return _lookup_pos(p_key, _pos);
 	}
 
+	void clear() {
+
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (hashes[i] != EMPTY_HASH) {
+				_destruct(i);
+			}
+		}
+
+		num_elements = 0;
+	}
+
 	void remove(const TKey &p_key) {
 		uint32_t pos = 0;
 		bool exists = _lookup_pos(p_key, pos);
@@ -245,10 +326,24 @@ public:
 			return;
 		}
 
-		hashes[pos] |= DELETED_HASH_BIT;
-		values[pos].~TValue();
-		keys[pos].~TKey();
+		_destruct(pos);
 		num_elements--;
+
+		// shift the following entries back instead of leaving a tombstone, tombstones are
+		// not counted by the load factor and would eventually fill the table
+		uint32_t mask = capacity - 1;
+		uint32_t next_pos = (pos + 1) & mask;
+		while (hashes[next_pos] != EMPTY_HASH && _get_probe_length(next_pos, hashes[next_pos]) != 0) {
+
+			memnew_placement(&keys[pos], TKey(keys[next_pos]));
+			memnew_placement(&values[pos], TValue(values[next_pos]));
+			hashes[pos] = hashes[next_pos];
+
+			_destruct(next_pos);
+
+			pos = next_pos;
+			next_pos = (next_pos + 1) & mask;
+		}
 	}
 
 	struct Iterator {
@@ -289,9 +384,6 @@ public:
 			if (hashes[i] == EMPTY_HASH) {
 				continue;
 			}
-			if (hashes[i] & DELETED_HASH_BIT) {
-				continue;
-			}
 
 			it.valid = true;
 			it.key = &keys[i];
@@ -302,25 +394,30 @@ public:
 		return it;
 	}
 
-	OAHashMap(uint32_t p_initial_capacity = 64) {
+	void operator=(const OAHashMap &p_other) {
 
-		capacity = p_initial_capacity;
-		num_elements = 0;
+		if (this == &p_other) {
+			return;
+		}
 
-		keys = memnew_arr(TKey, p_initial_capacity);
-		values = memnew_arr(TValue, p_initial_capacity);
-		hashes = memnew_arr(uint32_t, p_initial_capacity);
+		_free();
+		_copy_from(p_other);
+	}
 
-		for (int i = 0; i < p_initial_capacity; i++) {
-			hashes[i] = 0;
-		}
+	OAHashMap(const OAHashMap &p_other) {
+
+		_copy_from(p_other);
+	}
+
+	OAHashMap(uint32_t p_initial_capacity = 64) {
+
+		num_elements = 0;
+		_allocate(next_power_of_2(MAX(p_initial_capacity, 8u)));
 	}
 
 	~OAHashMap() {
 
-		memdelete_arr(keys);
-		memdelete_arr(values);
-		memdelete(hashes);
+		_free();
 	}
 };
 
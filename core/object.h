@@ -308,7 +308,7 @@ public:
 		m_inherits::initialize_class();                                                                                                 \
 		ClassDB::_add_class<m_class>();                                                                                                 \
 		if (m_class::_get_bind_methods() != m_inherits::_get_bind_methods())                                                            \
-			_bind_methods();                                                                                                            \
+			ClassDB::_add_class_bind(get_class_static(), m_class::_get_bind_methods());                                                 \
 		initialized = true;                                                                                                             \
 	}                                                                                                                                   \
                                                                                                                                         \
@@ -383,6 +383,7 @@ public:                                                        \
 private:
 
 class ScriptInstance;
+class MethodBind;
 typedef uint64_t ObjectID;
 
 class Object {
@@ -644,6 +645,7 @@ public:
 	void get_method_list(List<MethodInfo> *p_list) const;
 	Variant callv(const StringName &p_method, const Array &p_args);
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
+	Variant call_method_bind(MethodBind *p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error); // skips the script instance and method lookup, for callers that already resolved the bind
 	virtual void call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount);
 	virtual void call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount);
 	Variant call(const StringName &p_name, VARIANT_ARG_LIST); // C++ helper
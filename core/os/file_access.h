@@ -109,6 +109,8 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_span(int p_length) const { return NULL; } ///< memory-backed files only: pointer to the next p_length bytes (then skipped), NULL if not possible
+	virtual const uint8_t *map_read_only() { return NULL; } ///< map the whole file read-only, valid until closed. NULL if unsupported
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(String delim = ",") const;
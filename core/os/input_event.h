@@ -185,6 +185,8 @@ public:
 	virtual bool shortcut_match(const Ref<InputEvent> &p_event) const;
 	virtual bool is_action_type() const;
 
+	virtual bool accumulate(const Ref<InputEvent> &p_event);
+
 	InputEvent();
 };
 
@@ -350,6 +352,8 @@ public:
 	virtual Ref<InputEvent> xformed_by(const Transform2D &p_xform, const Vector2 &p_local_ofs = Vector2()) const;
 	virtual String as_text() const;
 
+	virtual bool accumulate(const Ref<InputEvent> &p_event);
+
 	InputEventMouseMotion();
 };
 
@@ -0,0 +1,191 @@
+/*************************************************************************/
+/*  lock_profiler.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "lock_profiler.h"
+
+#include "core/safe_refcount.h"
+#include "os/memory.h"
+#include "os/trace.h"
+
+#include <string.h>
+
+bool LockProfiler::enabled = false;
+LockProfiler::Site *volatile LockProfiler::sites = NULL;
+
+class MutexProfiled : public Mutex {
+
+	Mutex *mutex;
+	LockProfiler::Site *site;
+
+public:
+	virtual void lock() {
+
+		if (!LockProfiler::is_enabled() && !Trace::is_enabled()) {
+			mutex->lock();
+			return;
+		}
+
+		if (mutex->try_lock() == OK) {
+			LockProfiler::record_acquire(site);
+			return;
+		}
+
+		uint64_t begin = Trace::get_ticks_usec();
+		mutex->lock();
+		LockProfiler::record_wait(site, begin, Trace::get_ticks_usec());
+	}
+
+	virtual void unlock() {
+
+		mutex->unlock();
+	}
+
+	virtual Error try_lock() {
+
+		Error err = mutex->try_lock();
+		if (err == OK && LockProfiler::is_enabled()) {
+			LockProfiler::record_acquire(site);
+		}
+		return err;
+	}
+
+	MutexProfiled(Mutex *p_mutex, LockProfiler::Site *p_site) {
+		mutex = p_mutex;
+		site = p_site;
+	}
+
+	~MutexProfiled() {
+		memdelete(mutex);
+	}
+};
+
+void LockProfiler::set_enabled(bool p_enabled) {
+
+	enabled = p_enabled;
+}
+
+LockProfiler::Site *LockProfiler::get_site(const char *p_name) {
+
+	while (true) {
+
+		Site *head = sites;
+		for (Site *s = head; s; s = s->next) {
+			if (strcmp(s->name, p_name) == 0) {
+				return s;
+			}
+		}
+
+		// sites are never removed, so pushing to the front is enough to be lock-free
+		Site *site = memnew(Site);
+		site->name = p_name;
+		site->acquisitions = 0;
+		site->contentions = 0;
+		site->wait_usec = 0;
+		site->max_wait_usec = 0;
+		site->next = head;
+
+		if (atomic_compare_and_swap_ptr((void *volatile *)&sites, head, site) == head) {
+			return site;
+		}
+
+		memdelete(site); //somebody else added a site meanwhile, look again
+	}
+}
+
+void LockProfiler::record_acquire(Site *p_site) {
+
+	atomic_increment(&p_site->acquisitions);
+}
+
+void LockProfiler::record_wait(Site *p_site, uint64_t p_begin, uint64_t p_end) {
+
+	if (enabled) {
+		uint64_t wait = p_end - p_begin;
+		atomic_increment(&p_site->acquisitions);
+		atomic_increment(&p_site->contentions);
+		atomic_add(&p_site->wait_usec, wait);
+		atomic_exchange_if_greater(&p_site->max_wait_usec, wait);
+	}
+
+	if (Trace::is_enabled()) {
+		Trace::record(p_site->name, p_begin, p_end);
+	}
+}
+
+void LockProfiler::get_sites(List<Site> *r_sites) {
+
+	for (Site *s = sites; s; s = s->next) {
+		r_sites->push_back(*s);
+	}
+}
+
+uint64_t LockProfiler::get_total_contentions() {
+
+	uint64_t total = 0;
+	for (Site *s = sites; s; s = s->next) {
+		total += s->contentions;
+	}
+	return total;
+}
+
+uint64_t LockProfiler::get_total_wait_usec() {
+
+	uint64_t total = 0;
+	for (Site *s = sites; s; s = s->next) {
+		total += s->wait_usec;
+	}
+	return total;
+}
+
+void LockProfiler::reset() {
+
+	for (Site *s = sites; s; s = s->next) {
+		s->acquisitions = 0;
+		s->contentions = 0;
+		s->wait_usec = 0;
+		s->max_wait_usec = 0;
+	}
+}
+
+void LockProfiler::finish() {
+
+	enabled = false;
+	while (sites) {
+		Site *s = sites;
+		sites = s->next;
+		memdelete(s);
+	}
+}
+
+Mutex *LockProfiler::wrap(Mutex *p_mutex, const char *p_site) {
+
+	ERR_FAIL_COND_V(!p_mutex, NULL);
+	return memnew(MutexProfiled(p_mutex, get_site(p_site)));
+}
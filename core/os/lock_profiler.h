@@ -0,0 +1,81 @@
+/*************************************************************************/
+/*  lock_profiler.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+#include "list.h"
+#include "os/mutex.h"
+#include "ustring.h"
+
+/**
+ * Contention statistics for named lock sites.
+ *
+ * In debug builds, mutexes created with a site name are wrapped so every
+ * acquisition is counted and every wait on a held lock is timed, both in
+ * the site totals and, while a capture runs, as a Trace scope named after
+ * the site. Recording only happens while enabled, otherwise a wrapped lock
+ * costs a single branch. Site names must be string literals.
+ */
+
+class LockProfiler {
+public:
+	struct Site {
+		const char *name;
+		volatile uint64_t acquisitions;
+		volatile uint64_t contentions;
+		volatile uint64_t wait_usec;
+		volatile uint64_t max_wait_usec;
+		Site *next;
+	};
+
+private:
+	static bool enabled;
+	static Site *volatile sites;
+
+public:
+	_FORCE_INLINE_ static bool is_enabled() { return enabled; }
+	static void set_enabled(bool p_enabled);
+
+	static Site *get_site(const char *p_name);
+
+	static void record_acquire(Site *p_site);
+	static void record_wait(Site *p_site, uint64_t p_begin, uint64_t p_end);
+
+	static void get_sites(List<Site> *r_sites);
+	static uint64_t get_total_contentions();
+	static uint64_t get_total_wait_usec();
+	static void reset();
+
+	static Mutex *wrap(Mutex *p_mutex, const char *p_site);
+	static void finish();
+};
+
+#endif // LOCK_PROFILER_H
@@ -37,7 +37,7 @@
 
 void *operator new(size_t p_size, const char *p_description) {
 
-	return Memory::alloc_static(p_size, false);
+	return Memory::alloc_static(p_size, false, p_description);
 }
 
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)) {
@@ -72,31 +72,529 @@ uint64_t Memory::max_usage = 0;
 
 uint64_t Memory::alloc_count = 0;
 
-void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+
+#include <atomic>
+#include <string.h>
+
+/*
+ * Optional small object allocator (small_allocator=yes).
+ *
+ * Every block is prefixed by a SmallAllocHeader holding its size class and tag (the usual
+ * PAD_ALIGN prefix, if requested, goes after it). Blocks up to the largest size class come
+ * from per thread free lists, which are refilled from (and drained to) a global pool in
+ * batches, so the lock is only taken once every few dozen allocations. Slabs are never given
+ * back to the system. Bigger blocks go to malloc.
+ *
+ * Thread caches are plain TLS without destructors (memory is freed after threads and statics
+ * are gone), so the few blocks cached by an exiting thread are not reused.
+ */
+
+#define SMALL_ALLOC_HEADER 16
+#define SMALL_ALLOC_CLASS_COUNT 9
+#define SMALL_ALLOC_LARGE 0xFFFFFFFF
+#define SMALL_ALLOC_SLAB_SIZE (64 * 1024)
+#define SMALL_ALLOC_CACHE_MAX 128
+#define SMALL_ALLOC_TAG_FLUSH 256
+
+// block sizes including the header, all multiples of 16 to keep alignment
+static const uint32_t small_alloc_class_size[SMALL_ALLOC_CLASS_COUNT] = { 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+
+struct SmallAllocHeader {
+	uint32_t size_class;
+	uint32_t tag;
+	uint64_t bytes;
+};
+
+struct SmallAllocBlock {
+	SmallAllocBlock *next;
+};
+
+struct SmallAllocCache {
+	SmallAllocBlock *free_list[SMALL_ALLOC_CLASS_COUNT];
+	uint32_t count[SMALL_ALLOC_CLASS_COUNT];
+	int64_t tag_bytes[Memory::TAG_MAX];
+	uint32_t tag_ops;
+	uint32_t tag;
+};
+
+static thread_local SmallAllocCache small_alloc_cache;
+
+static std::atomic_flag small_alloc_lock = ATOMIC_FLAG_INIT;
+static SmallAllocBlock *small_alloc_pool[SMALL_ALLOC_CLASS_COUNT];
+static uint32_t small_alloc_pool_count[SMALL_ALLOC_CLASS_COUNT];
+static uint64_t small_alloc_tag_usage[Memory::TAG_MAX];
+
+static _FORCE_INLINE_ void _small_alloc_lock() {
+	while (small_alloc_lock.test_and_set(std::memory_order_acquire)) {
+	}
+}
 
-#ifdef DEBUG_ENABLED
+static _FORCE_INLINE_ void _small_alloc_unlock() {
+	small_alloc_lock.clear(std::memory_order_release);
+}
+
+static _FORCE_INLINE_ uint32_t _small_alloc_get_class(size_t p_size) {
+
+	uint32_t c = 0;
+	while (small_alloc_class_size[c] < p_size) {
+		c++;
+	}
+	return c;
+}
+
+static void _small_alloc_flush_tags(SmallAllocCache &p_cache) {
+
+	for (int i = 0; i < Memory::TAG_MAX; i++) {
+		if (p_cache.tag_bytes[i]) {
+			atomic_add(&small_alloc_tag_usage[i], (uint64_t)p_cache.tag_bytes[i]);
+			p_cache.tag_bytes[i] = 0;
+		}
+	}
+	p_cache.tag_ops = 0;
+}
+
+static _FORCE_INLINE_ void _small_alloc_account(SmallAllocCache &p_cache, uint32_t p_tag, int64_t p_bytes) {
+
+	// tag usage is kept per thread and published in batches, to keep atomics off the hot path
+	p_cache.tag_bytes[p_tag] += p_bytes;
+	if (++p_cache.tag_ops >= SMALL_ALLOC_TAG_FLUSH) {
+		_small_alloc_flush_tags(p_cache);
+	}
+}
+
+static void _small_alloc_refill(SmallAllocCache &p_cache, uint32_t p_class) {
+
+	_small_alloc_lock();
+	uint32_t take = MIN(small_alloc_pool_count[p_class], (uint32_t)SMALL_ALLOC_CACHE_MAX / 2);
+	for (uint32_t i = 0; i < take; i++) {
+		SmallAllocBlock *b = small_alloc_pool[p_class];
+		small_alloc_pool[p_class] = b->next;
+		b->next = p_cache.free_list[p_class];
+		p_cache.free_list[p_class] = b;
+	}
+	small_alloc_pool_count[p_class] -= take;
+	_small_alloc_unlock();
+
+	p_cache.count[p_class] += take;
+	if (take)
+		return;
+
+	// nothing left in the pool, carve a new slab
+	uint8_t *slab = (uint8_t *)malloc(SMALL_ALLOC_SLAB_SIZE);
+	if (!slab)
+		return;
+
+	uint32_t size = small_alloc_class_size[p_class];
+	uint32_t blocks = SMALL_ALLOC_SLAB_SIZE / size;
+	for (uint32_t i = 0; i < blocks; i++) {
+		SmallAllocBlock *b = (SmallAllocBlock *)(slab + i * size);
+		b->next = p_cache.free_list[p_class];
+		p_cache.free_list[p_class] = b;
+	}
+	p_cache.count[p_class] += blocks;
+}
+
+static void _small_alloc_drain(SmallAllocCache &p_cache, uint32_t p_class) {
+
+	// give back half of the cached blocks, so they can be used by other threads
+	uint32_t give = p_cache.count[p_class] / 2;
+
+	SmallAllocBlock *first = p_cache.free_list[p_class];
+	SmallAllocBlock *last = first;
+	for (uint32_t i = 1; i < give; i++) {
+		last = last->next;
+	}
+	p_cache.free_list[p_class] = last->next;
+	p_cache.count[p_class] -= give;
+
+	_small_alloc_lock();
+	last->next = small_alloc_pool[p_class];
+	small_alloc_pool[p_class] = first;
+	small_alloc_pool_count[p_class] += give;
+	_small_alloc_unlock();
+}
+
+static void *_mem_alloc(size_t p_bytes) {
+
+	SmallAllocCache &cache = small_alloc_cache;
+	size_t total = p_bytes + SMALL_ALLOC_HEADER;
+	SmallAllocHeader *h;
+
+	if (total <= small_alloc_class_size[SMALL_ALLOC_CLASS_COUNT - 1]) {
+
+		uint32_t c = _small_alloc_get_class(total);
+		if (!cache.free_list[c]) {
+			_small_alloc_refill(cache, c);
+			if (!cache.free_list[c])
+				return NULL;
+		}
+
+		SmallAllocBlock *b = cache.free_list[c];
+		cache.free_list[c] = b->next;
+		cache.count[c]--;
+
+		h = (SmallAllocHeader *)b;
+		h->size_class = c;
+	} else {
+
+		h = (SmallAllocHeader *)malloc(total);
+		if (!h)
+			return NULL;
+		h->size_class = SMALL_ALLOC_LARGE;
+	}
+
+	h->tag = cache.tag;
+	h->bytes = p_bytes;
+	_small_alloc_account(cache, h->tag, p_bytes);
+
+	return (uint8_t *)h + SMALL_ALLOC_HEADER;
+}
+
+static void _mem_free(void *p_ptr) {
+
+	SmallAllocCache &cache = small_alloc_cache;
+	SmallAllocHeader *h = (SmallAllocHeader *)((uint8_t *)p_ptr - SMALL_ALLOC_HEADER);
+
+	_small_alloc_account(cache, h->tag, -(int64_t)h->bytes);
+
+	uint32_t c = h->size_class;
+	if (c == SMALL_ALLOC_LARGE) {
+		free(h);
+		return;
+	}
+
+	SmallAllocBlock *b = (SmallAllocBlock *)h;
+	b->next = cache.free_list[c];
+	cache.free_list[c] = b;
+	cache.count[c]++;
+
+	if (cache.count[c] > SMALL_ALLOC_CACHE_MAX) {
+		_small_alloc_drain(cache, c);
+	}
+}
+
+static void *_mem_realloc(void *p_ptr, size_t p_bytes) {
+
+	if (!p_ptr)
+		return _mem_alloc(p_bytes);
+
+	if (p_bytes == 0) {
+		_mem_free(p_ptr);
+		return NULL;
+	}
+
+	SmallAllocCache &cache = small_alloc_cache;
+	SmallAllocHeader *h = (SmallAllocHeader *)((uint8_t *)p_ptr - SMALL_ALLOC_HEADER);
+	size_t total = p_bytes + SMALL_ALLOC_HEADER;
+	bool large = total > small_alloc_class_size[SMALL_ALLOC_CLASS_COUNT - 1];
+
+	if (h->size_class == SMALL_ALLOC_LARGE && large) {
+
+		SmallAllocHeader *nh = (SmallAllocHeader *)realloc(h, total);
+		if (!nh)
+			return NULL;
+
+		_small_alloc_account(cache, nh->tag, (int64_t)p_bytes - (int64_t)nh->bytes);
+		nh->bytes = p_bytes;
+		return (uint8_t *)nh + SMALL_ALLOC_HEADER;
+	}
+
+	if (h->size_class != SMALL_ALLOC_LARGE && !large && _small_alloc_get_class(total) == h->size_class) {
+
+		_small_alloc_account(cache, h->tag, (int64_t)p_bytes - (int64_t)h->bytes);
+		h->bytes = p_bytes;
+		return p_ptr;
+	}
+
+	// moving between size classes, or between the pools and malloc
+	void *mem = _mem_alloc(p_bytes);
+	if (!mem)
+		return NULL;
+
+	memcpy(mem, p_ptr, MIN((size_t)h->bytes, p_bytes));
+	_mem_free(p_ptr);
+	return mem;
+}
+
+Memory::Tag Memory::set_thread_tag(Tag p_tag) {
+
+	SmallAllocCache &cache = small_alloc_cache;
+	Tag prev = (Tag)cache.tag;
+	cache.tag = p_tag;
+	return prev;
+}
+
+uint64_t Memory::get_tag_usage(Tag p_tag) {
+
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+	// the calling thread publishes its pending usage, other threads do so in their next batch
+	_small_alloc_flush_tags(small_alloc_cache);
+	return small_alloc_tag_usage[p_tag];
+}
+
+#else
+
+static _FORCE_INLINE_ void *_mem_alloc(size_t p_bytes) {
+	return malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void *_mem_realloc(void *p_ptr, size_t p_bytes) {
+	return realloc(p_ptr, p_bytes);
+}
+
+static _FORCE_INLINE_ void _mem_free(void *p_ptr) {
+	free(p_ptr);
+}
+
+uint64_t Memory::get_tag_usage(Tag p_tag) {
+
+	return 0;
+}
+
+#endif
+
+const char *Memory::get_tag_name(Tag p_tag) {
+
+	static const char *names[TAG_MAX] = {
+		"General",
+		"Scene",
+		"Physics",
+		"Rendering",
+		"Audio",
+		"Resources"
+	};
+
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, "");
+	return names[p_tag];
+}
+
+#ifdef MEMORY_TRACKER_ENABLED
+
+#include <atomic>
+
+/*
+ * Optional allocation tracker (memory_tracker=yes).
+ *
+ * Every block gets an extra MemTrackHeader in front of the usual PAD_ALIGN prefix. Sampled
+ * blocks store the index of their callsite there, so frees and reallocs can be accounted to
+ * the same site. With an interval above 1, a block is sampled roughly every interval bytes and
+ * stands for interval / size allocations, which keeps the estimates unbiased while leaving
+ * most allocations with a single countdown per thread.
+ */
+
+#define MEM_TRACK_HEADER 16
+#define MEM_TRACK_MAX_SITES 4096
+#define MEM_TRACK_TABLE_SIZE (MEM_TRACK_MAX_SITES * 2)
+#define MEM_PREFIX (PAD_ALIGN + MEM_TRACK_HEADER)
+
+struct MemTrackHeader {
+	uint32_t site; // site index + 1, 0 if the block was not sampled
+	uint32_t scale; // allocations the sample stands for
+	uint64_t unused;
+};
+
+static Memory::AllocationSite mem_track_sites[MEM_TRACK_MAX_SITES];
+static uint16_t mem_track_table[MEM_TRACK_TABLE_SIZE];
+static uint32_t mem_track_site_count = 0;
+static uint64_t mem_track_total_count = 0;
+static uint64_t mem_track_interval = 0;
+static std::atomic_flag mem_track_lock = ATOMIC_FLAG_INIT;
+
+static thread_local int64_t mem_track_countdown = 0;
+static thread_local uint32_t mem_track_random = 0x9E3779B9;
+
+static _FORCE_INLINE_ void _mem_track_lock() {
+	while (mem_track_lock.test_and_set(std::memory_order_acquire)) {
+	}
+}
+
+static _FORCE_INLINE_ void _mem_track_unlock() {
+	mem_track_lock.clear(std::memory_order_release);
+}
+
+static uint32_t _mem_track_find_site(const char *p_site) {
+
+	// sites are string literals, so comparing pointers is enough
+	uint32_t pos = (uint32_t)(((uintptr_t)p_site >> 3) * 2654435761u) & (MEM_TRACK_TABLE_SIZE - 1);
+
+	while (true) {
+
+		uint16_t idx = mem_track_table[pos];
+		if (idx == 0) {
+			if (mem_track_site_count == MEM_TRACK_MAX_SITES - 1) {
+				// table is full, the last site gathers everything else
+				mem_track_sites[MEM_TRACK_MAX_SITES - 1].name = "(other)";
+				return MEM_TRACK_MAX_SITES - 1;
+			}
+			mem_track_sites[mem_track_site_count].name = p_site;
+			mem_track_table[pos] = ++mem_track_site_count;
+			return mem_track_site_count - 1;
+		}
+
+		if (mem_track_sites[idx - 1].name == p_site) {
+			return idx - 1;
+		}
+
+		pos = (pos + 1) & (MEM_TRACK_TABLE_SIZE - 1);
+	}
+}
+
+static _FORCE_INLINE_ uint32_t _mem_track_sample(size_t p_bytes) {
+
+	uint64_t interval = mem_track_interval;
+	if (interval <= 1) {
+		return interval;
+	}
+
+	mem_track_countdown -= p_bytes;
+	if (mem_track_countdown > 0) {
+		return 0;
+	}
+
+	// jitter the next sample, so periodic allocation patterns are not always missed or always hit
+	mem_track_random ^= mem_track_random << 13;
+	mem_track_random ^= mem_track_random >> 17;
+	mem_track_random ^= mem_track_random << 5;
+	mem_track_countdown = interval / 2 + mem_track_random % interval;
+
+	return p_bytes >= interval ? 1 : interval / MAX(p_bytes, (size_t)1);
+}
+
+static void _mem_track_alloc(MemTrackHeader *p_header, size_t p_bytes, const char *p_site) {
+
+	p_header->site = 0;
+	p_header->scale = _mem_track_sample(p_bytes);
+
+	if (!p_header->scale) {
+		return;
+	}
+
+	if (!p_site || !p_site[0]) {
+		p_site = "(unknown)";
+	}
+
+	_mem_track_lock();
+
+	uint32_t idx = _mem_track_find_site(p_site);
+	Memory::AllocationSite &site = mem_track_sites[idx];
+	site.live_bytes += p_bytes * p_header->scale;
+	site.live_count += p_header->scale;
+	site.total_bytes += p_bytes * p_header->scale;
+	site.total_count += p_header->scale;
+	mem_track_total_count += p_header->scale;
+
+	_mem_track_unlock();
+
+	p_header->site = idx + 1;
+}
+
+static void _mem_track_realloc(MemTrackHeader *p_header, size_t p_old_bytes, size_t p_bytes) {
+
+	if (!p_header->site) {
+		return;
+	}
+
+	_mem_track_lock();
+
+	Memory::AllocationSite &site = mem_track_sites[p_header->site - 1];
+	site.live_bytes += (int64_t)(p_bytes - p_old_bytes) * p_header->scale;
+	if (p_bytes > p_old_bytes) {
+		site.total_bytes += (p_bytes - p_old_bytes) * p_header->scale;
+	}
+	if (p_bytes == 0) {
+		site.live_count -= p_header->scale;
+	}
+
+	_mem_track_unlock();
+}
+
+void Memory::set_tracker_sample_interval(uint64_t p_bytes) {
+
+	mem_track_interval = p_bytes;
+}
+
+uint64_t Memory::get_tracker_sample_interval() {
+
+	return mem_track_interval;
+}
+
+int Memory::get_tracked_sites(AllocationSite *r_sites, int p_max) {
+
+	_mem_track_lock();
+
+	int count = MIN((int)mem_track_site_count, p_max);
+	for (int i = 0; i < count; i++) {
+		r_sites[i] = mem_track_sites[i];
+	}
+	if (count < p_max && mem_track_sites[MEM_TRACK_MAX_SITES - 1].name) {
+		r_sites[count++] = mem_track_sites[MEM_TRACK_MAX_SITES - 1];
+	}
+
+	_mem_track_unlock();
+
+	return count;
+}
+
+uint64_t Memory::get_tracked_allocation_count() {
+
+	return mem_track_total_count;
+}
+
+#else
+
+#define MEM_PREFIX PAD_ALIGN
+
+void Memory::set_tracker_sample_interval(uint64_t p_bytes) {
+}
+
+uint64_t Memory::get_tracker_sample_interval() {
+
+	return 0;
+}
+
+int Memory::get_tracked_sites(AllocationSite *r_sites, int p_max) {
+
+	return 0;
+}
+
+uint64_t Memory::get_tracked_allocation_count() {
+
+	return 0;
+}
+
+#endif
+
+void *Memory::alloc_static(size_t p_bytes, bool p_pad_align, const char *p_site) {
+
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TRACKER_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = _mem_alloc(p_bytes + (prepad ? MEM_PREFIX : 0));
 
 	ERR_FAIL_COND_V(!mem, NULL);
 
+#ifndef SMALL_ALLOCATOR_ENABLED
 	atomic_increment(&alloc_count);
+#endif
 
 	if (prepad) {
-		uint64_t *s = (uint64_t *)mem;
+		uint8_t *s8 = (uint8_t *)mem + MEM_PREFIX;
+		uint64_t *s = (uint64_t *)(s8 - PAD_ALIGN);
 		*s = p_bytes;
 
-		uint8_t *s8 = (uint8_t *)mem;
+#ifdef MEMORY_TRACKER_ENABLED
+		_mem_track_alloc((MemTrackHeader *)mem, p_bytes, p_site);
+#endif
 
 #ifdef DEBUG_ENABLED
 		atomic_add(&mem_usage, p_bytes);
 		atomic_exchange_if_greater(&max_usage, mem_usage);
 #endif
-		return s8 + PAD_ALIGN;
+		return s8;
 	} else {
 		return mem;
 	}
@@ -110,15 +608,19 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TRACKER_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
 	if (prepad) {
-		mem -= PAD_ALIGN;
-		uint64_t *s = (uint64_t *)mem;
+		mem -= MEM_PREFIX;
+		uint64_t *s = (uint64_t *)(mem + MEM_PREFIX - PAD_ALIGN);
+
+#ifdef MEMORY_TRACKER_ENABLED
+		_mem_track_realloc((MemTrackHeader *)mem, *s, p_bytes);
+#endif
 
 #ifdef DEBUG_ENABLED
 		if (p_bytes > *s) {
@@ -130,23 +632,21 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_mem_free(mem);
 			return NULL;
 		} else {
-			*s = p_bytes;
-
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_mem_realloc(mem, p_bytes + MEM_PREFIX);
 			ERR_FAIL_COND_V(!mem, NULL);
 
-			s = (uint64_t *)mem;
+			s = (uint64_t *)(mem + MEM_PREFIX - PAD_ALIGN);
 
 			*s = p_bytes;
 
-			return mem + PAD_ALIGN;
+			return mem + MEM_PREFIX;
 		}
 	} else {
 
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_mem_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == NULL && p_bytes > 0, NULL);
 
@@ -160,26 +660,32 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TRACKER_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
+#ifndef SMALL_ALLOCATOR_ENABLED
 	atomic_decrement(&alloc_count);
+#endif
 
 	if (prepad) {
-		mem -= PAD_ALIGN;
-		uint64_t *s = (uint64_t *)mem;
+		mem -= MEM_PREFIX;
+		uint64_t *s = (uint64_t *)(mem + MEM_PREFIX - PAD_ALIGN);
+
+#ifdef MEMORY_TRACKER_ENABLED
+		_mem_track_realloc((MemTrackHeader *)mem, *s, 0);
+#endif
 
 #ifdef DEBUG_ENABLED
 		atomic_sub(&mem_usage, *s);
 #endif
 
-		free(mem);
+		_mem_free(mem);
 	} else {
 
-		free(mem);
+		_mem_free(mem);
 	}
 }
 
@@ -53,13 +53,57 @@ class Memory {
 	static uint64_t alloc_count;
 
 public:
-	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
+	// subsystems allocations are accounted to, only tracked when built with small_allocator=yes
+	enum Tag {
+		TAG_GENERAL,
+		TAG_SCENE,
+		TAG_PHYSICS,
+		TAG_RENDERING,
+		TAG_AUDIO,
+		TAG_RESOURCES,
+		TAG_MAX
+	};
+
+	// callsite of an allocation, recorded by the allocation tracker (memory_tracker=yes)
+	struct AllocationSite {
+		const char *name;
+		uint64_t live_bytes;
+		uint64_t live_count;
+		uint64_t total_bytes;
+		uint64_t total_count;
+	};
+
+	static void *alloc_static(size_t p_bytes, bool p_pad_align = false, const char *p_site = NULL);
 	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
 	static void free_static(void *p_ptr, bool p_pad_align = false);
 
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+#ifdef SMALL_ALLOCATOR_ENABLED
+	static Tag set_thread_tag(Tag p_tag);
+#else
+	_FORCE_INLINE_ static Tag set_thread_tag(Tag p_tag) { return TAG_GENERAL; }
+#endif
+	static uint64_t get_tag_usage(Tag p_tag);
+	static const char *get_tag_name(Tag p_tag);
+
+	// 0 disables tracking, 1 records every allocation, otherwise about one allocation is sampled every p_bytes
+	static void set_tracker_sample_interval(uint64_t p_bytes);
+	static uint64_t get_tracker_sample_interval();
+	static int get_tracked_sites(AllocationSite *r_sites, int p_max);
+	static uint64_t get_tracked_allocation_count();
+};
+
+// accounts the allocations done by the current thread to a tag, until it goes out of scope
+class MemoryTagScope {
+
+	Memory::Tag prev_tag;
+
+public:
+	_FORCE_INLINE_ MemoryTagScope(Memory::Tag p_tag) { prev_tag = Memory::set_thread_tag(p_tag); }
+	_FORCE_INLINE_ ~MemoryTagScope() { Memory::set_thread_tag(prev_tag); }
 };
 
 class DefaultAllocator {
@@ -81,7 +125,13 @@ void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size));
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description);
 #endif
 
-#define memalloc(m_size) Memory::alloc_static(m_size)
+#ifdef MEMORY_TRACKER_ENABLED
+#define _MEM_SITE __FILE__ ":" _MKSTR(__LINE__)
+#else
+#define _MEM_SITE ""
+#endif
+
+#define memalloc(m_size) Memory::alloc_static(m_size, false, _MEM_SITE)
 #define memrealloc(m_mem, m_size) Memory::realloc_static(m_mem, m_size)
 #define memfree(m_size) Memory::free_static(m_size)
 
@@ -94,7 +144,7 @@ _ALWAYS_INLINE_ T *_post_initialize(T *p_obj) {
 	return p_obj;
 }
 
-#define memnew(m_class) _post_initialize(new ("") m_class)
+#define memnew(m_class) _post_initialize(new (_MEM_SITE) m_class)
 
 _ALWAYS_INLINE_ void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_description) {
 	//void *failptr=0;
@@ -133,7 +183,7 @@ void memdelete_allocator(T *p_class) {
 		if (m_v) memdelete(m_v); \
 	}
 
-#define memnew_arr(m_class, m_count) memnew_arr_template<m_class>(m_count)
+#define memnew_arr(m_class, m_count) memnew_arr_template<m_class>(m_count, _MEM_SITE)
 
 template <typename T>
 T *memnew_arr_template(size_t p_elements, const char *p_descr = "") {
@@ -144,7 +194,7 @@ T *memnew_arr_template(size_t p_elements, const char *p_descr = "") {
 	same strategy used by std::vector, and the PoolVector class, so it should be safe.*/
 
 	size_t len = sizeof(T) * p_elements;
-	uint64_t *mem = (uint64_t *)Memory::alloc_static(len, true);
+	uint64_t *mem = (uint64_t *)Memory::alloc_static(len, true, p_descr);
 	T *failptr = 0; //get rid of a warning
 	ERR_FAIL_COND_V(!mem, failptr);
 	*(mem - 1) = p_elements;
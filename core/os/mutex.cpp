@@ -30,14 +30,21 @@
 
 #include "mutex.h"
 #include "error_macros.h"
+#include "os/lock_profiler.h"
 #include <stddef.h>
 
 Mutex *(*Mutex::create_func)(bool) = 0;
 
-Mutex *Mutex::create(bool p_recursive) {
+Mutex *Mutex::create(bool p_recursive, const char *p_site) {
 
 	ERR_FAIL_COND_V(!create_func, 0);
 
+#ifdef DEBUG_ENABLED
+	if (p_site) {
+		return LockProfiler::wrap(create_func(p_recursive), p_site);
+	}
+#endif
+
 	return create_func(p_recursive);
 }
 
@@ -32,6 +32,7 @@
 #define MUTEX_H
 
 #include "error_list.h"
+#include "typedefs.h"
 
 /**
  * @class Mutex
@@ -51,7 +52,7 @@ public:
 	virtual void unlock() = 0; ///< Unlock the mutex, let other threads continue
 	virtual Error try_lock() = 0; ///< Attempt to lock the mutex, OK on success, ERROR means it can't lock.
 
-	static Mutex *create(bool p_recursive = true); ///< Create a mutex
+	static Mutex *create(bool p_recursive = true, const char *p_site = NULL); ///< Create a mutex, a site name (string literal) lets its contention be profiled in debug builds
 
 	virtual ~Mutex();
 };
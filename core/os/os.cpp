@@ -182,9 +182,42 @@ const char *OS::get_last_error() const {
 	return last_error ? last_error : "";
 }
 
+struct _AllocationSiteLiveSort {
+
+	_FORCE_INLINE_ bool operator()(const Memory::AllocationSite &p_a, const Memory::AllocationSite &p_b) const {
+		return p_a.live_bytes > p_b.live_bytes;
+	}
+};
+
+Vector<Memory::AllocationSite> OS::get_memory_allocation_sites() const {
+
+	// the buffer is allocated before taking the tracker lock, so it can't be filled while tracking itself
+	Vector<Memory::AllocationSite> sites;
+	sites.resize(4096);
+	sites.resize(Memory::get_tracked_sites(sites.ptrw(), sites.size()));
+	sites.sort_custom<_AllocationSiteLiveSort>();
+	return sites;
+}
+
 void OS::dump_memory_to_file(const char *p_file) {
 
-	//Memory::dump_static_mem_to_file(p_file);
+	Vector<Memory::AllocationSite> sites = get_memory_allocation_sites();
+	ERR_FAIL_COND(sites.empty());
+
+	FileAccess *f = FileAccess::open(String::utf8(p_file), FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	uint64_t interval = Memory::get_tracker_sample_interval();
+	f->store_line("# allocation sites, sample interval: " + (interval > 1 ? itos(interval) + " bytes (values are estimates)" : String(interval ? "every allocation" : "disabled")));
+	f->store_line("live_bytes\tlive_count\ttotal_bytes\ttotal_count\tsite");
+
+	for (int i = 0; i < sites.size(); i++) {
+		const Memory::AllocationSite &s = sites[i];
+		f->store_line(itos(s.live_bytes) + "\t" + itos(s.live_count) + "\t" + itos(s.total_bytes) + "\t" + itos(s.total_count) + "\t" + String(s.name));
+	}
+
+	f->close();
+	memdelete(f);
 }
 
 static FileAccess *_OSPRF = NULL;
@@ -373,6 +373,7 @@ public:
 
 	virtual bool get_swap_ok_cancel() { return false; }
 	virtual void dump_memory_to_file(const char *p_file);
+	Vector<Memory::AllocationSite> get_memory_allocation_sites() const; // sorted by live bytes, empty unless built with memory_tracker=yes
 	virtual void dump_resources_to_file(const char *p_file);
 	virtual void print_resources_in_use(bool p_short = false);
 	virtual void print_all_resources(String p_to_file = "");
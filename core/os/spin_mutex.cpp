@@ -0,0 +1,82 @@
+/*************************************************************************/
+/*  spin_mutex.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "spin_mutex.h"
+
+#include "os/os.h"
+#include "os/trace.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPIN_PAUSE() _mm_pause()
+#elif defined(__GNUC__) && (defined(__arm__) || defined(__aarch64__))
+#define SPIN_PAUSE() __asm__ __volatile__("yield")
+#else
+#define SPIN_PAUSE()
+#endif
+
+void SpinMutex::_lock_contended() {
+
+	bool profiled = site && (LockProfiler::is_enabled() || Trace::is_enabled());
+	uint64_t begin = profiled ? Trace::get_ticks_usec() : 0;
+
+	uint32_t max_spins = MIN(spin_estimate * 2, (uint32_t)SPIN_MAX);
+	uint32_t spins = 0;
+
+	while (true) {
+
+		// only attempt the atomic once the lock looks free, to keep the cache line shared meanwhile
+		if (locked == 0 && atomic_compare_and_swap(&locked, (uint64_t)0, (uint64_t)1) == 0)
+			break;
+
+		if (spins < max_spins) {
+			SPIN_PAUSE();
+			spins++;
+		} else {
+			OS::get_singleton()->delay_usec(0); //gives up the time slice on every platform
+		}
+	}
+
+	// move the estimate towards what this wait took, the estimate is only touched by the owner
+	int32_t estimate = spin_estimate;
+	estimate += (int32_t(MIN(spins, (uint32_t)SPIN_MAX)) - estimate) / 8;
+	spin_estimate = MAX(estimate, (int32_t)SPIN_MIN);
+
+	if (profiled) {
+		LockProfiler::record_wait(site, begin, Trace::get_ticks_usec());
+	}
+}
+
+void SpinMutex::set_profile_site(const char *p_site) {
+
+#ifdef DEBUG_ENABLED
+	site = p_site ? LockProfiler::get_site(p_site) : NULL;
+#endif
+}
@@ -0,0 +1,99 @@
+/*************************************************************************/
+/*  spin_mutex.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SPIN_MUTEX_H
+#define SPIN_MUTEX_H
+
+#include "core/safe_refcount.h"
+#include "os/lock_profiler.h"
+
+/**
+ * Non-recursive lock for short critical sections in hot paths.
+ *
+ * Unlike Mutex it needs no allocation and never enters the kernel when
+ * uncontended. A contended lock spins for about as long as the lock was
+ * recently held, then yields the thread, so it must not be held across
+ * anything that can block. Locking it twice from the same thread deadlocks.
+ */
+
+class SpinMutex {
+
+	enum {
+		SPIN_MIN = 16,
+		SPIN_MAX = 4096
+	};
+
+	volatile uint64_t locked;
+	uint32_t spin_estimate; // adapts to how long the lock is usually held
+	LockProfiler::Site *site;
+
+	void _lock_contended();
+
+public:
+	_FORCE_INLINE_ void lock() {
+		if (atomic_compare_and_swap(&locked, (uint64_t)0, (uint64_t)1) != 0) {
+			_lock_contended();
+		} else if (site && LockProfiler::is_enabled()) {
+			LockProfiler::record_acquire(site);
+		}
+	}
+
+	_FORCE_INLINE_ bool try_lock() {
+		return locked == 0 && atomic_compare_and_swap(&locked, (uint64_t)0, (uint64_t)1) == 0;
+	}
+
+	_FORCE_INLINE_ void unlock() {
+		atomic_compare_and_swap(&locked, (uint64_t)1, (uint64_t)0); // full barrier, so writes are visible to the next owner
+	}
+
+	void set_profile_site(const char *p_site); // string literal, only used in debug builds
+
+	SpinMutex() {
+		locked = 0;
+		spin_estimate = SPIN_MIN;
+		site = NULL;
+	}
+};
+
+class SpinMutexLock {
+
+	SpinMutex *mutex;
+
+public:
+	_FORCE_INLINE_ SpinMutexLock(SpinMutex *p_mutex) {
+		mutex = p_mutex;
+		mutex->lock();
+	}
+	_FORCE_INLINE_ ~SpinMutexLock() {
+		mutex->unlock();
+	}
+};
+
+#endif // SPIN_MUTEX_H
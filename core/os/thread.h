@@ -46,13 +46,30 @@ public:
 
 		PRIORITY_LOW,
 		PRIORITY_NORMAL,
-		PRIORITY_HIGH
+		PRIORITY_HIGH,
+		PRIORITY_REALTIME // real-time scheduling where permitted, for latency critical threads (ie, audio mixing)
+	};
+
+	// which kind of core a thread should run on, for asymmetric (big.LITTLE) CPUs
+	enum CoreType {
+
+		CORE_TYPE_ANY,
+		CORE_TYPE_PERFORMANCE,
+		CORE_TYPE_EFFICIENCY
 	};
 
 	struct Settings {
 
 		Priority priority;
-		Settings() { priority = PRIORITY_NORMAL; }
+		CoreType core_type;
+		uint64_t affinity_mask; // explicit set of cores (bit per core index), overrides core_type when not zero
+		String name;
+
+		Settings() {
+			priority = PRIORITY_NORMAL;
+			core_type = CORE_TYPE_ANY;
+			affinity_mask = 0;
+		}
 	};
 
 	typedef uint64_t ID;
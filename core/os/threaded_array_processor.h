@@ -31,16 +31,11 @@
 #ifndef THREADED_ARRAY_PROCESSOR_H
 #define THREADED_ARRAY_PROCESSOR_H
 
-#include "os/mutex.h"
-#include "os/os.h"
-#include "os/thread.h"
-#include "safe_refcount.h"
-#include "thread_safe.h"
+#include "os/worker_thread_pool.h"
 
 template <class C, class U>
 struct ThreadArrayProcessData {
 	uint32_t elements;
-	uint32_t index;
 	C *instance;
 	U userdata;
 	void (C::*method)(uint32_t, U);
@@ -53,15 +48,10 @@ struct ThreadArrayProcessData {
 #ifndef NO_THREADS
 
 template <class T>
-void process_array_thread(void *ud) {
+void process_array_thread(void *ud, uint32_t p_index) {
 
 	T &data = *(T *)ud;
-	while (true) {
-		uint32_t index = atomic_increment(&data.index);
-		if (index >= data.elements)
-			break;
-		data.process(index);
-	}
+	data.process(p_index);
 }
 
 template <class C, class M, class U>
@@ -71,22 +61,20 @@ void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_us
 	data.method = p_method;
 	data.instance = p_instance;
 	data.userdata = p_userdata;
-	data.index = 0;
 	data.elements = p_elements;
-	data.process(data.index); //process first, let threads increment for next
-
-	Vector<Thread *> threads;
 
-	threads.resize(OS::get_singleton()->get_processor_count());
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
 
-	for (int i = 0; i < threads.size(); i++) {
-		threads.write[i] = Thread::create(process_array_thread<ThreadArrayProcessData<C, U> >, &data);
+	if (!pool) {
+		//pool not up (yet), just do it here
+		for (uint32_t i = 0; i < p_elements; i++) {
+			data.process(i);
+		}
+		return;
 	}
 
-	for (int i = 0; i < threads.size(); i++) {
-		Thread::wait_to_finish(threads[i]);
-		memdelete(threads[i]);
-	}
+	WorkerThreadPool::GroupID group = pool->add_group_task(process_array_thread<ThreadArrayProcessData<C, U> >, &data, p_elements);
+	pool->wait_for_group_task_completion(group);
 }
 
 #else
@@ -98,7 +86,6 @@ void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_us
 	data.method = p_method;
 	data.instance = p_instance;
 	data.userdata = p_userdata;
-	data.index = 0;
 	data.elements = p_elements;
 	for (uint32_t i = 0; i < p_elements; i++) {
 		data.process(i);
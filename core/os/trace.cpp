@@ -0,0 +1,179 @@
+/*************************************************************************/
+/*  trace.cpp                                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "trace.h"
+
+#include "os/file_access.h"
+#include "os/os.h"
+
+bool Trace::enabled = false;
+uint32_t Trace::capacity = 0;
+uint64_t Trace::capture_begin = 0;
+Mutex *Trace::mutex = NULL;
+Trace::ThreadBuffer *Trace::buffers = NULL;
+thread_local Trace::ThreadBuffer *Trace::thread_buffer = NULL;
+
+Trace::ThreadBuffer *Trace::_get_thread_buffer() {
+
+	if (thread_buffer) {
+		return thread_buffer;
+	}
+
+	ThreadBuffer *tb = memnew(ThreadBuffer);
+	tb->thread_id = Thread::get_caller_id();
+	tb->events = memnew_arr(Event, capacity);
+	tb->written = 0;
+
+	mutex->lock();
+	tb->next = buffers;
+	buffers = tb;
+	mutex->unlock();
+
+	thread_buffer = tb;
+	return tb;
+}
+
+uint64_t Trace::get_ticks_usec() {
+
+	return OS::get_singleton()->get_ticks_usec();
+}
+
+void Trace::record(const char *p_name, uint64_t p_begin, uint64_t p_end) {
+
+	if (!enabled) {
+		return; // stopped while the scope was open
+	}
+
+	ThreadBuffer *tb = _get_thread_buffer();
+	Event &e = tb->events[tb->written & (capacity - 1)];
+	e.name = p_name;
+	e.begin = p_begin;
+	e.end = p_end;
+	tb->written++;
+}
+
+void Trace::start(uint32_t p_events_per_thread) {
+
+	ERR_FAIL_COND(enabled);
+	ERR_FAIL_COND(p_events_per_thread == 0);
+
+	if (!mutex) {
+		mutex = Mutex::create();
+	}
+
+	if (capacity == 0) {
+		// buffers are kept for the lifetime of their thread, so the first capture decides their size
+		capacity = next_power_of_2(p_events_per_thread);
+	}
+
+	mutex->lock();
+	for (ThreadBuffer *tb = buffers; tb; tb = tb->next) {
+		tb->written = 0;
+	}
+	mutex->unlock();
+
+	capture_begin = get_ticks_usec();
+	enabled = true;
+}
+
+void Trace::stop() {
+
+	enabled = false;
+}
+
+Error Trace::save_chrome_trace(const String &p_path) {
+
+	ERR_FAIL_COND_V(enabled, ERR_BUSY);
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, ERR_CANT_CREATE);
+
+	f->store_string("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	bool first = true;
+	int tid = 0;
+	if (mutex) {
+		mutex->lock();
+	}
+
+	for (ThreadBuffer *tb = buffers; tb; tb = tb->next) {
+
+		tid++;
+		String thread_name = tb->thread_id == Thread::get_main_id() ? String("Main") : "Thread " + itos(tid);
+		if (!first) {
+			f->store_string(",\n");
+		}
+		first = false;
+		f->store_string("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + itos(tid) + ",\"args\":{\"name\":\"" + thread_name + "\"}}");
+
+		uint32_t count = MIN(tb->written, capacity);
+		for (uint32_t i = tb->written - count; i != tb->written; i++) {
+
+			const Event &e = tb->events[i & (capacity - 1)];
+			if (e.begin < capture_begin) {
+				continue; // opened before the capture started
+			}
+
+			String line = ",\n{\"name\":\"" + String(e.name).json_escape() + "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + itos(tid);
+			line += ",\"ts\":" + itos(e.begin - capture_begin) + ",\"dur\":" + itos(e.end - e.begin) + "}";
+			f->store_string(line);
+		}
+	}
+
+	if (mutex) {
+		mutex->unlock();
+	}
+
+	f->store_string("\n]}\n");
+	f->close();
+	memdelete(f);
+
+	return OK;
+}
+
+void Trace::finish() {
+
+	enabled = false;
+
+	// buffers of threads still running would dangle, so only call this at exit
+	while (buffers) {
+		ThreadBuffer *tb = buffers;
+		buffers = tb->next;
+		memdelete_arr(tb->events);
+		memdelete(tb);
+	}
+	thread_buffer = NULL;
+
+	if (mutex) {
+		memdelete(mutex);
+		mutex = NULL;
+	}
+	capacity = 0;
+}
@@ -0,0 +1,109 @@
+/*************************************************************************/
+/*  trace.h                                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "os/mutex.h"
+#include "os/thread.h"
+#include "ustring.h"
+
+/**
+ * Lightweight capture of named CPU scopes, exported as Chrome trace JSON.
+ *
+ * Every thread records into its own ring buffer, so recording takes no locks
+ * and only the newest events are kept once a buffer wraps. Scope names must
+ * be string literals (or otherwise outlive the capture), as only the pointer
+ * is stored. When no capture is running a scope costs a single branch.
+ */
+
+class Trace {
+
+	struct Event {
+		const char *name;
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	struct ThreadBuffer {
+		Thread::ID thread_id;
+		Event *events;
+		uint32_t written;
+		ThreadBuffer *next;
+	};
+
+	static bool enabled;
+	static uint32_t capacity;
+	static uint64_t capture_begin;
+	static Mutex *mutex;
+	static ThreadBuffer *buffers;
+	static thread_local ThreadBuffer *thread_buffer;
+
+	static ThreadBuffer *_get_thread_buffer();
+
+public:
+	_FORCE_INLINE_ static bool is_enabled() { return enabled; }
+
+	static uint64_t get_ticks_usec();
+	static void record(const char *p_name, uint64_t p_begin, uint64_t p_end);
+
+	static void start(uint32_t p_events_per_thread = 65536);
+	static void stop();
+
+	static Error save_chrome_trace(const String &p_path); // load it in chrome://tracing or ui.perfetto.dev
+	static void finish();
+};
+
+class TraceScope {
+
+	const char *name;
+	uint64_t begin;
+
+public:
+	_FORCE_INLINE_ TraceScope(const char *p_name) {
+		name = Trace::is_enabled() ? p_name : NULL;
+		begin = name ? Trace::get_ticks_usec() : 0;
+	}
+	_FORCE_INLINE_ ~TraceScope() {
+		if (name) {
+			Trace::record(name, begin, Trace::get_ticks_usec());
+		}
+	}
+};
+
+#ifdef DEBUG_ENABLED
+#define _TRACE_SCOPE_NAME(m_line) _trace_scope_##m_line
+#define _TRACE_SCOPE_LINE(m_line) _TRACE_SCOPE_NAME(m_line)
+#define TRACE_SCOPE(m_name) TraceScope _TRACE_SCOPE_LINE(__LINE__)(m_name)
+#else
+#define TRACE_SCOPE(m_name)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,290 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "os/os.h"
+#include "safe_refcount.h"
+
+WorkerThreadPool *WorkerThreadPool::singleton = NULL;
+
+void WorkerThreadPool::_thread_func(void *p_user) {
+
+	WorkerThreadPool *pool = (WorkerThreadPool *)p_user;
+
+	Thread::set_name("WorkerThreadPool");
+
+	while (true) {
+
+		pool->work_semaphore->wait();
+
+		if (pool->exit_threads)
+			break;
+
+		while (pool->_process_next()) {
+			//keep going while there is work queued
+		}
+	}
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::_claim_batch(Group *p_only, uint32_t &r_from, uint32_t &r_to) {
+
+	MutexLock lock(mutex);
+
+	Group *group = NULL;
+
+	if (p_only) {
+		if (p_only->lane_element)
+			group = p_only;
+	} else {
+		for (int i = 0; i < PRIORITY_MAX; i++) {
+			if (lanes[i].front()) {
+				group = lanes[i].front()->get();
+				break;
+			}
+		}
+	}
+
+	if (!group)
+		return NULL;
+
+	r_from = group->next_index;
+	r_to = MIN(r_from + group->batch_size, group->elements);
+	group->next_index = r_to;
+
+	if (group->next_index == group->elements) {
+		//nothing left to hand out, the group leaves its lane but stays alive until waited for
+		lanes[group->priority].erase(group->lane_element);
+		group->lane_element = NULL;
+	}
+
+	return group;
+}
+
+void WorkerThreadPool::_process_batch(Group *p_group, uint32_t p_from, uint32_t p_to) {
+
+	for (uint32_t i = p_from; i < p_to; i++) {
+		p_group->func(p_group->userdata, i);
+	}
+
+	// Do not touch the group after the last batch is reported, the waiter may recycle it.
+	if (atomic_add(&p_group->completed, p_to - p_from) == p_group->elements) {
+		p_group->done->post();
+	}
+}
+
+bool WorkerThreadPool::_process_next(Group *p_only) {
+
+	uint32_t from, to;
+	Group *group = _claim_batch(p_only, from, to);
+	if (!group)
+		return false;
+
+	_process_batch(group, from, to);
+	return true;
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(TaskFunc p_func, void *p_userdata, uint32_t p_elements, Priority p_priority) {
+
+	ERR_FAIL_COND_V(!p_func, INVALID_GROUP_ID);
+	ERR_FAIL_INDEX_V(p_priority, PRIORITY_MAX, INVALID_GROUP_ID);
+
+	int batches;
+	GroupID id;
+
+	{
+		MutexLock lock(mutex);
+
+		Group *group;
+		if (group_pool.size()) {
+			group = group_pool[group_pool.size() - 1];
+			group_pool.resize(group_pool.size() - 1);
+		} else {
+			group = memnew(Group);
+			group->done = Semaphore::create();
+		}
+
+		id = ++last_id;
+
+		group->id = id;
+		group->func = p_func;
+		group->userdata = p_userdata;
+		group->elements = p_elements;
+		// Several batches per thread, so threads that finish early can take over work from slow ones.
+		group->batch_size = MAX(1, p_elements / ((threads.size() + 1) * 4));
+		group->next_index = 0;
+		group->completed = 0;
+		group->priority = p_priority;
+		group->lane_element = NULL;
+
+		groups.set(id, group);
+
+		if (p_elements == 0) {
+			group->done->post();
+			return id;
+		}
+
+		group->lane_element = lanes[p_priority].push_back(group);
+
+		batches = (p_elements + group->batch_size - 1) / group->batch_size;
+	}
+
+	int wake = MIN(batches, threads.size());
+	for (int i = 0; i < wake; i++) {
+		work_semaphore->post();
+	}
+
+	return id;
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_task(TaskFunc p_func, void *p_userdata, Priority p_priority) {
+
+	return add_group_task(p_func, p_userdata, 1, p_priority);
+}
+
+bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
+
+	MutexLock lock(mutex);
+
+	Group *const *group = groups.getptr(p_group);
+	if (!group)
+		return true; //already waited for
+
+	return (*group)->completed == (*group)->elements;
+}
+
+void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
+
+	Group *group;
+
+	{
+		MutexLock lock(mutex);
+
+		Group **groupp = groups.getptr(p_group);
+		ERR_EXPLAIN("Invalid group task ID, or it was already waited for.");
+		ERR_FAIL_COND(!groupp);
+
+		group = *groupp;
+		groups.erase(p_group);
+	}
+
+	// Rather than sleeping, help with whatever is left of this group.
+	while (_process_next(group)) {
+	}
+
+	// Then wait for the batches other threads are still working on.
+	group->done->wait();
+
+	MutexLock lock(mutex);
+	group_pool.push_back(group);
+}
+
+bool WorkerThreadPool::is_worker_thread() const {
+
+	return thread_ids.find(Thread::get_caller_id()) != -1;
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+
+	ERR_FAIL_COND(threads.size() > 0);
+
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#else
+	if (p_thread_count < 0) {
+		// The thread that waits on a group also processes it, so leave a core for it.
+		p_thread_count = MAX(1, OS::get_singleton()->get_processor_count() - 1);
+	}
+#endif
+
+	exit_threads = false;
+
+	Thread::Settings settings;
+	settings.name = "Worker";
+
+	for (int i = 0; i < p_thread_count; i++) {
+		Thread *thread = Thread::create(_thread_func, this, settings);
+		ERR_CONTINUE(!thread);
+		threads.push_back(thread);
+		thread_ids.push_back(thread->get_id());
+	}
+}
+
+void WorkerThreadPool::finish() {
+
+	exit_threads = true;
+
+	for (int i = 0; i < threads.size(); i++) {
+		work_semaphore->post();
+	}
+
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	threads.clear();
+	thread_ids.clear();
+
+	const GroupID *k = NULL;
+	while ((k = groups.next(k))) {
+		WARN_PRINT("Group task was never waited for.");
+		Group *group = groups[*k];
+		memdelete(group->done);
+		memdelete(group);
+	}
+	groups.clear();
+
+	for (int i = 0; i < PRIORITY_MAX; i++) {
+		lanes[i].clear();
+	}
+
+	for (int i = 0; i < group_pool.size(); i++) {
+		memdelete(group_pool[i]->done);
+		memdelete(group_pool[i]);
+	}
+	group_pool.clear();
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+
+	singleton = this;
+	mutex = Mutex::create(true, "WorkerThreadPool");
+	work_semaphore = Semaphore::create();
+	exit_threads = false;
+	last_id = 0;
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+
+	memdelete(work_semaphore);
+	memdelete(mutex);
+	singleton = NULL;
+}
@@ -0,0 +1,120 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "hash_map.h"
+#include "list.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "vector.h"
+
+/**
+ * Process-wide pool of persistent worker threads.
+ *
+ * Work is submitted as group tasks: a function that is called once for every
+ * index in [0, elements). Indices are claimed in small batches by whichever
+ * thread is free, so uneven work is balanced automatically. Every submitted
+ * group returns an ID that must be passed to wait_for_group_task_completion(),
+ * which also makes the waiting thread help process the group instead of
+ * sleeping.
+ */
+
+class WorkerThreadPool {
+public:
+	enum Priority {
+		PRIORITY_HIGH,
+		PRIORITY_NORMAL,
+		PRIORITY_LOW,
+		PRIORITY_MAX
+	};
+
+	typedef void (*TaskFunc)(void *p_userdata, uint32_t p_index);
+	typedef int64_t GroupID;
+
+	enum {
+		INVALID_GROUP_ID = -1
+	};
+
+private:
+	struct Group {
+		GroupID id;
+		TaskFunc func;
+		void *userdata;
+		uint32_t elements;
+		uint32_t batch_size;
+		uint32_t next_index; // protected by mutex
+		volatile uint32_t completed;
+		Priority priority;
+		List<Group *>::Element *lane_element; // non-null while indices are left to claim
+		Semaphore *done;
+	};
+
+	static WorkerThreadPool *singleton;
+
+	Mutex *mutex;
+	Semaphore *work_semaphore;
+	Vector<Thread *> threads;
+	Vector<Thread::ID> thread_ids;
+	volatile bool exit_threads;
+
+	List<Group *> lanes[PRIORITY_MAX];
+	HashMap<GroupID, Group *> groups;
+	Vector<Group *> group_pool;
+	GroupID last_id;
+
+	static void _thread_func(void *p_user);
+
+	Group *_claim_batch(Group *p_only, uint32_t &r_from, uint32_t &r_to);
+	void _process_batch(Group *p_group, uint32_t p_from, uint32_t p_to);
+	bool _process_next(Group *p_only = NULL);
+
+public:
+	_FORCE_INLINE_ static WorkerThreadPool *get_singleton() { return singleton; }
+
+	GroupID add_group_task(TaskFunc p_func, void *p_userdata, uint32_t p_elements, Priority p_priority = PRIORITY_NORMAL);
+	GroupID add_task(TaskFunc p_func, void *p_userdata, Priority p_priority = PRIORITY_NORMAL);
+
+	bool is_group_task_completed(GroupID p_group) const;
+	void wait_for_group_task_completion(GroupID p_group);
+
+	int get_thread_count() const { return threads.size(); }
+	bool is_worker_thread() const;
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
@@ -50,6 +50,7 @@
 #include "io/pck_packer.h"
 #include "io/resource_format_binary.h"
 #include "io/resource_import.h"
+#include "io/socket_poller.h"
 #include "io/stream_peer_ssl.h"
 #include "io/tcp_server.h"
 #include "io/translation_loader_po.h"
@@ -57,6 +58,7 @@
 #include "math/triangle_mesh.h"
 #include "os/input.h"
 #include "os/main_loop.h"
+#include "os/worker_thread_pool.h"
 #include "packed_data_container.h"
 #include "path_remap.h"
 #include "project_settings.h"
@@ -82,6 +84,8 @@ static IP *ip = NULL;
 
 static _Geometry *_geometry = NULL;
 
+static WorkerThreadPool *worker_thread_pool = NULL;
+
 extern Mutex *_global_mutex;
 
 extern void register_global_constants();
@@ -97,6 +101,11 @@ void register_core_types() {
 
 	_global_mutex = Mutex::create();
 
+	worker_thread_pool = memnew(WorkerThreadPool);
+	worker_thread_pool->init();
+
+	ResourceLoader::initialize();
+
 	StringName::setup();
 
 	register_global_constants();
@@ -126,6 +135,7 @@ void register_core_types() {
 	ClassDB::register_class<WeakRef>();
 	ClassDB::register_class<Resource>();
 	ClassDB::register_class<Image>();
+	ClassDB::register_class<ImageDecodeTask>();
 
 	ClassDB::register_virtual_class<InputEvent>();
 	ClassDB::register_virtual_class<InputEventWithModifiers>();
@@ -148,6 +158,7 @@ void register_core_types() {
 	ClassDB::register_custom_instance_class<StreamPeerTCP>();
 	ClassDB::register_custom_instance_class<TCP_Server>();
 	ClassDB::register_custom_instance_class<PacketPeerUDP>();
+	ClassDB::register_custom_instance_class<SocketPoller>();
 	ClassDB::register_custom_instance_class<StreamPeerSSL>();
 	ClassDB::register_virtual_class<IP>();
 	ClassDB::register_virtual_class<PacketPeer>();
@@ -268,6 +279,14 @@ void unregister_core_types() {
 	CoreStringNames::free();
 	StringName::cleanup();
 
+	ResourceLoader::finalize();
+
+	if (worker_thread_pool) {
+		worker_thread_pool->finish();
+		memdelete(worker_thread_pool);
+		worker_thread_pool = NULL;
+	}
+
 	if (_global_mutex) {
 		memdelete(_global_mutex);
 		_global_mutex = NULL; //still needed at a few places
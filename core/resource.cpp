@@ -412,17 +412,133 @@ HashMap<String, Resource *> ResourceCache::resources;
 
 RWLock *ResourceCache::lock = NULL;
 
+Mutex *ResourceCache::retain_mutex = NULL;
+List<ResourceCache::Retained> ResourceCache::retained;
+HashMap<ObjectID, List<ResourceCache::Retained>::Element *> ResourceCache::retained_map;
+uint64_t ResourceCache::retain_budget = 0;
+uint64_t ResourceCache::retained_memory[Resource::MEMORY_CATEGORY_MAX] = {};
+uint64_t ResourceCache::retained_total = 0;
+uint64_t ResourceCache::hits = 0;
+uint64_t ResourceCache::misses = 0;
+ResourceCache::EvictNotify ResourceCache::evict_notify = NULL;
+void *ResourceCache::evict_notify_ud = NULL;
+
 void ResourceCache::setup() {
 
 	lock = RWLock::create();
+	retain_mutex = Mutex::create(true, "ResourceCache");
 }
 
 void ResourceCache::clear() {
+
+	clear_retained();
+
 	if (resources.size())
 		ERR_PRINT("Resources Still in use at Exit!");
 
 	resources.clear();
 	memdelete(lock);
+	memdelete(retain_mutex);
+	retain_mutex = NULL;
+}
+
+void ResourceCache::_pop_retained(List<Ref<Resource> > *r_evicted, uint64_t p_budget) {
+
+	while (retained_total > p_budget && retained.size()) {
+
+		List<Retained>::Element *E = retained.back();
+		retained_memory[E->get().category] -= E->get().size;
+		retained_total -= E->get().size;
+		retained_map.erase(E->get().resource->get_instance_id());
+		r_evicted->push_back(E->get().resource);
+		retained.erase(E);
+	}
+}
+
+void ResourceCache::set_retain_budget(uint64_t p_bytes) {
+
+	List<Ref<Resource> > evicted;
+
+	retain_mutex->lock();
+	retain_budget = p_bytes;
+	_pop_retained(&evicted, retain_budget);
+	retain_mutex->unlock();
+
+	// released outside of the mutex, as freeing a resource needs the cache lock
+	for (List<Ref<Resource> >::Element *E = evicted.front(); E; E = E->next()) {
+		if (evict_notify)
+			evict_notify(evict_notify_ud, E->get());
+	}
+}
+
+uint64_t ResourceCache::get_retain_budget() {
+
+	return retain_budget;
+}
+
+void ResourceCache::retain(const Ref<Resource> &p_resource) {
+
+	if (retain_budget == 0 || p_resource.is_null() || p_resource->get_path() == "")
+		return;
+
+	List<Ref<Resource> > evicted;
+
+	retain_mutex->lock();
+
+	List<Retained>::Element **E = retained_map.getptr(p_resource->get_instance_id());
+	if (E) {
+		retained.move_to_front(*E);
+	} else {
+
+		Retained r;
+		r.resource = p_resource;
+		r.size = MAX(p_resource->get_memory_usage(), (uint64_t)RETAIN_MIN_SIZE);
+		r.category = p_resource->get_memory_category();
+
+		if (r.size <= retain_budget) {
+			retained_map[p_resource->get_instance_id()] = retained.push_front(r);
+			retained_memory[r.category] += r.size;
+			retained_total += r.size;
+			_pop_retained(&evicted, retain_budget);
+		}
+	}
+
+	retain_mutex->unlock();
+
+	for (List<Ref<Resource> >::Element *F = evicted.front(); F; F = F->next()) {
+		if (evict_notify)
+			evict_notify(evict_notify_ud, F->get());
+	}
+}
+
+void ResourceCache::clear_retained() {
+
+	if (!retain_mutex)
+		return;
+
+	List<Ref<Resource> > evicted;
+
+	retain_mutex->lock();
+	_pop_retained(&evicted, 0);
+	retain_mutex->unlock();
+}
+
+uint64_t ResourceCache::get_retained_memory(Resource::MemoryCategory p_category) {
+
+	if (p_category == Resource::MEMORY_CATEGORY_MAX)
+		return retained_total;
+
+	ERR_FAIL_INDEX_V(p_category, Resource::MEMORY_CATEGORY_MAX, 0);
+	return retained_memory[p_category];
+}
+
+int ResourceCache::get_retained_count() {
+
+	retain_mutex->lock();
+	int rc = retained.size();
+	retain_mutex->unlock();
+
+	return rc;
 }
 
 void ResourceCache::reload_externals() {
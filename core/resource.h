@@ -33,6 +33,7 @@
 
 #include "class_db.h"
 #include "object.h"
+#include "os/mutex.h"
 #include "ref_ptr.h"
 #include "reference.h"
 #include "safe_refcount.h"
@@ -90,6 +91,14 @@ protected:
 	void _take_over_path(const String &p_path);
 
 public:
+	enum MemoryCategory {
+		MEMORY_CATEGORY_OTHER,
+		MEMORY_CATEGORY_TEXTURE,
+		MEMORY_CATEGORY_MESH,
+		MEMORY_CATEGORY_AUDIO,
+		MEMORY_CATEGORY_MAX
+	};
+
 	static Node *(*_get_local_scene_func)(); //used by editor
 
 	virtual bool editor_can_reload_from_file();
@@ -137,6 +146,10 @@ public:
 
 	virtual RID get_rid() const; // some resources may offer conversion to RID
 
+	// approximate memory kept alive by this resource, used for ResourceCache budgets
+	virtual MemoryCategory get_memory_category() const { return MEMORY_CATEGORY_OTHER; }
+	virtual uint64_t get_memory_usage() const { return 0; }
+
 	Resource();
 	~Resource();
 };
@@ -144,6 +157,10 @@ public:
 typedef Ref<Resource> RES;
 
 class ResourceCache {
+public:
+	typedef void (*EvictNotify)(void *p_ud, const Ref<Resource> &p_resource);
+
+private:
 	friend class Resource;
 	friend class ResourceLoader; //need the lock
 	static RWLock *lock;
@@ -153,7 +170,48 @@ class ResourceCache {
 	friend void register_core_types();
 	static void setup();
 
+	enum {
+		RETAIN_MIN_SIZE = 1024 // so resources reporting no memory usage still count towards the budget
+	};
+
+	struct Retained {
+		Ref<Resource> resource;
+		uint64_t size;
+		Resource::MemoryCategory category;
+	};
+
+	// loaded resources kept referenced after their last user is gone, most recently used first
+	static Mutex *retain_mutex;
+	static List<Retained> retained;
+	static HashMap<ObjectID, List<Retained>::Element *> retained_map;
+	static uint64_t retain_budget;
+	static uint64_t retained_memory[Resource::MEMORY_CATEGORY_MAX];
+	static uint64_t retained_total;
+
+	static uint64_t hits;
+	static uint64_t misses;
+
+	static EvictNotify evict_notify;
+	static void *evict_notify_ud;
+
+	static void _pop_retained(List<Ref<Resource> > *r_evicted, uint64_t p_budget);
+
 public:
+	static void set_retain_budget(uint64_t p_bytes);
+	static uint64_t get_retain_budget();
+	static void retain(const Ref<Resource> &p_resource);
+	static void clear_retained();
+	static uint64_t get_retained_memory(Resource::MemoryCategory p_category = Resource::MEMORY_CATEGORY_MAX); // MAX returns the total
+	static int get_retained_count();
+
+	static uint64_t get_hit_count() { return hits; }
+	static uint64_t get_miss_count() { return misses; }
+
+	static void set_evict_notify_func(void *p_ud, EvictNotify p_notify) {
+		evict_notify = p_notify;
+		evict_notify_ud = p_ud;
+	}
+
 	static void reload_externals();
 	static bool has(const String &p_path);
 	static Resource *get(const String &p_path);
@@ -51,6 +51,7 @@ class RID_Data {
 	RID_OwnerBase *_owner;
 #endif
 	uint32_t _id;
+	uint32_t _slot; // only used by RID_Alloc
 
 public:
 	_FORCE_INLINE_ uint32_t get_id() const { return _id; }
@@ -102,11 +103,24 @@ protected:
 		p_rid._data = p_data;
 		refcount.ref();
 		p_data->_id = refcount.get();
+		p_data->_slot = 0xFFFFFFFF;
 #ifndef DEBUG_ENABLED
 		p_data->_owner = this;
 #endif
 	}
 
+	_FORCE_INLINE_ static void _set_ref(RID &p_rid, RID_Data *p_data) {
+		p_rid._data = p_data;
+	}
+
+	_FORCE_INLINE_ static void _set_slot(RID_Data *p_data, uint32_t p_slot) {
+		p_data->_slot = p_slot;
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_slot(const RID_Data *p_data) {
+		return p_data->_slot;
+	}
+
 #ifndef DEBUG_ENABLED
 
 	_FORCE_INLINE_ bool _is_owner(const RID &p_rid) const {
@@ -206,4 +220,172 @@ public:
 	}
 };
 
+/**
+ * Owner that also allocates the data it owns, in chunks of contiguous memory.
+ *
+ * Data is constructed by make_rid() and destroyed by free(), so servers can
+ * walk all their data in memory order with get_slot(). Chunks are kept until
+ * the owner is destroyed, which makes validating a RID a constant time check
+ * of its slot, in release builds too: a freed RID is rejected until its slot
+ * is reused.
+ */
+
+template <class T>
+class RID_Alloc : public RID_OwnerBase {
+
+	enum {
+		CHUNK_BYTES = 65536
+	};
+
+	T **chunks;
+	uint32_t *validators; // id of the data living in each slot, 0 if unused
+	uint32_t *free_list; // unused slots from alloc_count on
+	uint32_t elements_in_chunk;
+	uint32_t max_alloc;
+	uint32_t alloc_count;
+
+	_FORCE_INLINE_ T *_get_slot_ptr(uint32_t p_index) const {
+
+		return &chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
+	}
+
+	_FORCE_INLINE_ T *_get_alive(const RID &p_rid) const {
+
+		RID_Data *data = p_rid.get_data();
+		uint32_t idx = _get_slot(data);
+		if (idx >= max_alloc)
+			return NULL;
+
+		T *ptr = _get_slot_ptr(idx);
+		if (static_cast<RID_Data *>(ptr) != data || validators[idx] == 0 || validators[idx] != data->get_id())
+			return NULL;
+
+		return ptr;
+	}
+
+public:
+	RID make_rid() {
+
+		if (alloc_count == max_alloc) {
+
+			uint32_t chunk_count = max_alloc / elements_in_chunk;
+			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
+			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk);
+
+			validators = (uint32_t *)memrealloc(validators, sizeof(uint32_t) * (max_alloc + elements_in_chunk));
+			free_list = (uint32_t *)memrealloc(free_list, sizeof(uint32_t) * (max_alloc + elements_in_chunk));
+
+			for (uint32_t i = 0; i < elements_in_chunk; i++) {
+				validators[max_alloc + i] = 0;
+				free_list[max_alloc + i] = max_alloc + i;
+			}
+
+			max_alloc += elements_in_chunk;
+		}
+
+		uint32_t idx = free_list[alloc_count];
+		T *ptr = _get_slot_ptr(idx);
+		memnew_placement(ptr, T);
+
+		RID rid;
+		_set_data(rid, ptr);
+		_set_slot(ptr, idx);
+		validators[idx] = ptr->get_id();
+		alloc_count++;
+
+		return rid;
+	}
+
+	_FORCE_INLINE_ T *get(const RID &p_rid) {
+
+		ERR_FAIL_COND_V(!p_rid.is_valid(), NULL);
+		T *ptr = _get_alive(p_rid);
+		ERR_FAIL_COND_V(!ptr, NULL);
+		return ptr;
+	}
+
+	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
+
+		if (!p_rid.get_data())
+			return NULL;
+		T *ptr = _get_alive(p_rid);
+		ERR_FAIL_COND_V(!ptr, NULL);
+		return ptr;
+	}
+
+	_FORCE_INLINE_ T *getptr(const RID &p_rid) {
+
+		return static_cast<T *>(p_rid.get_data());
+	}
+
+	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
+
+		if (p_rid.get_data() == NULL)
+			return false;
+		return _get_alive(p_rid) != NULL;
+	}
+
+	void free(RID p_rid) {
+
+		T *ptr = getornull(p_rid);
+		ERR_FAIL_COND(!ptr);
+
+		uint32_t idx = _get_slot(ptr);
+		ptr->~T();
+		validators[idx] = 0;
+
+		alloc_count--;
+		free_list[alloc_count] = idx;
+	}
+
+	_FORCE_INLINE_ uint32_t get_rid_count() const { return alloc_count; }
+
+	// for iterating all data in memory order, returns NULL for unused slots
+	_FORCE_INLINE_ uint32_t get_slot_count() const { return max_alloc; }
+	_FORCE_INLINE_ T *get_slot(uint32_t p_index) {
+
+		ERR_FAIL_INDEX_V(p_index, max_alloc, NULL);
+		return validators[p_index] ? _get_slot_ptr(p_index) : NULL;
+	}
+
+	void get_owned_list(List<RID> *p_owned) {
+
+		for (uint32_t i = 0; i < max_alloc; i++) {
+			if (validators[i]) {
+				RID r;
+				_set_ref(r, _get_slot_ptr(i));
+				p_owned->push_back(r);
+			}
+		}
+	}
+
+	RID_Alloc() {
+
+		chunks = NULL;
+		validators = NULL;
+		free_list = NULL;
+		elements_in_chunk = sizeof(T) > CHUNK_BYTES ? 1 : CHUNK_BYTES / sizeof(T);
+		max_alloc = 0;
+		alloc_count = 0;
+	}
+
+	~RID_Alloc() {
+
+		if (alloc_count) {
+			// leaked data is not destroyed, as it may still reference other servers
+			ERR_PRINT("RID_Alloc: some RIDs were leaked at exit.");
+		}
+
+		for (uint32_t i = 0; i < max_alloc / elements_in_chunk; i++) {
+			memfree(chunks[i]);
+		}
+
+		if (chunks) {
+			memfree(chunks);
+			memfree(validators);
+			memfree(free_list);
+		}
+	}
+};
+
 #endif
@@ -135,6 +135,32 @@ public:
 		return p_n;
 	};
 
+	// contiguous readable block starting p_offset elements after the read position
+	int get_read_ptr(const T **r_ptr, int p_offset = 0) const {
+
+		int left = data_left() - p_offset;
+		if (left <= 0) {
+			*r_ptr = NULL;
+			return 0;
+		}
+		int pos = (read_pos + p_offset) & size_mask;
+		*r_ptr = &data.ptr()[pos];
+		return MIN(left, size() - pos);
+	};
+
+	// contiguous writable block at the write position, commit it with advance_write()
+	int get_write_ptr(T **r_ptr) {
+
+		*r_ptr = &data.ptrw()[write_pos];
+		return MIN(space_left(), size() - write_pos);
+	};
+
+	inline int advance_write(int p_n) {
+		p_n = MIN(p_n, space_left());
+		inc(write_pos, p_n);
+		return p_n;
+	};
+
 	Error write(const T &p_v) {
 		ERR_FAIL_COND_V(space_left() < 1, FAILED);
 		data.write[inc(write_pos, 1)] = p_v;
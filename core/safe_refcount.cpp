@@ -166,4 +166,12 @@ uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val) {
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val) {
 	return _atomic_exchange_if_greater_impl(pw, val);
 }
+
+uint64_t atomic_compare_and_swap(volatile uint64_t *pw, volatile uint64_t old_val, volatile uint64_t new_val) {
+	return InterlockedCompareExchange64((LONGLONG volatile *)pw, new_val, old_val);
+}
+
+void *atomic_compare_and_swap_ptr(void *volatile *pw, void *old_val, void *new_val) {
+	return InterlockedCompareExchangePointer(pw, new_val, old_val);
+}
 #endif
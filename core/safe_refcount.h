@@ -95,6 +95,25 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	return *pw;
 }
 
+static _ALWAYS_INLINE_ void *atomic_compare_and_swap_ptr(void *volatile *pw, void *old_val, void *new_val) {
+
+	void *tmp = *pw;
+	if (tmp == old_val)
+		*pw = new_val;
+
+	return tmp;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ T atomic_compare_and_swap(volatile T *pw, volatile V old_val, volatile V new_val) {
+
+	T tmp = *pw;
+	if (tmp == old_val)
+		*pw = new_val;
+
+	return tmp;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -150,6 +169,17 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	}
 }
 
+static _ALWAYS_INLINE_ void *atomic_compare_and_swap_ptr(void *volatile *pw, void *old_val, void *new_val) {
+
+	return __sync_val_compare_and_swap(pw, old_val, new_val);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ T atomic_compare_and_swap(volatile T *pw, volatile V old_val, volatile V new_val) {
+
+	return __sync_val_compare_and_swap(pw, old_val, new_val);
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -166,6 +196,9 @@ uint64_t atomic_increment(volatile uint64_t *pw);
 uint64_t atomic_sub(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val);
+uint64_t atomic_compare_and_swap(volatile uint64_t *pw, volatile uint64_t old_val, volatile uint64_t new_val);
+
+void *atomic_compare_and_swap_ptr(void *volatile *pw, void *old_val, void *new_val);
 
 #else
 //no threads supported?
@@ -762,6 +762,20 @@ void ScriptDebuggerRemote::_poll_events() {
 			profiling = false;
 			_send_profiling_data(false);
 			print_line("PROFILING END!");
+		} else if (command == "start_network_profiling") {
+
+			if (multiplayer.is_valid()) {
+				multiplayer->profiling_start();
+			}
+			network_profiling = true;
+			last_network_profile_time = 0;
+		} else if (command == "stop_network_profiling") {
+
+			if (multiplayer.is_valid()) {
+				_send_network_profiling_data();
+				multiplayer->profiling_end();
+			}
+			network_profiling = false;
 		} else if (command == "reload_scripts") {
 			reload_all_scripts = true;
 		} else if (command == "breakpoint") {
@@ -867,6 +881,57 @@ void ScriptDebuggerRemote::_send_profiling_data(bool p_for_frame) {
 	}
 }
 
+void ScriptDebuggerRemote::_send_network_profiling_data() {
+
+	ERR_FAIL_COND(multiplayer.is_null());
+
+	multiplayer->get_profiling_frame(network_profile_info);
+
+	if (network_profile_info.size()) {
+
+		Array arr;
+		arr.resize(network_profile_info.size() * 8);
+		for (int i = 0; i < network_profile_info.size(); i++) {
+
+			const MultiplayerAPI::ProfilingInfo &info = network_profile_info[i];
+			arr[i * 8 + 0] = info.node_path;
+			arr[i * 8 + 1] = info.name;
+			arr[i * 8 + 2] = info.incoming_rpc;
+			arr[i * 8 + 3] = info.incoming_rset;
+			arr[i * 8 + 4] = info.outgoing_rpc;
+			arr[i * 8 + 5] = info.outgoing_rset;
+			arr[i * 8 + 6] = info.incoming_bytes;
+			arr[i * 8 + 7] = info.outgoing_bytes;
+		}
+
+		packet_peer_stream->put_var("network_profile");
+		packet_peer_stream->put_var(1);
+		packet_peer_stream->put_var(arr);
+	}
+
+	// per peer transport statistics, keyed by peer id
+	Dictionary peers;
+	Ref<NetworkedMultiplayerPeer> network_peer = multiplayer->get_network_peer();
+	if (network_peer.is_valid()) {
+
+		Vector<int> ids = multiplayer->get_network_connected_peers();
+		for (int i = 0; i < ids.size(); i++) {
+			peers[ids[i]] = network_peer->get_peer_statistics(ids[i]);
+		}
+	}
+
+	Array stats;
+	stats.push_back(multiplayer->get_incoming_bandwidth_usage());
+	stats.push_back(multiplayer->get_outgoing_bandwidth_usage());
+	stats.push_back(peers);
+
+	packet_peer_stream->put_var("network_stats");
+	packet_peer_stream->put_var(stats.size());
+	for (int i = 0; i < stats.size(); i++) {
+		packet_peer_stream->put_var(stats[i]);
+	}
+}
+
 void ScriptDebuggerRemote::idle_poll() {
 
 	// this function is called every frame, except when there is a debugger break (::debug() in this class)
@@ -909,11 +974,22 @@ void ScriptDebuggerRemote::idle_poll() {
 		}
 	}
 
+	if (network_profiling && multiplayer.is_valid()) {
+
+		uint64_t pt = OS::get_singleton()->get_ticks_msec();
+		if (pt - last_network_profile_time > 100) {
+
+			last_network_profile_time = pt;
+			_send_network_profiling_data();
+		}
+	}
+
 	if (reload_all_scripts) {
 
 		for (int i = 0; i < ScriptServer::get_language_count(); i++) {
 			ScriptServer::get_language(i)->reload_all_scripts();
 		}
+		ScriptServer::increase_reload_version();
 		reload_all_scripts = false;
 	}
 
@@ -1074,6 +1150,19 @@ void ScriptDebuggerRemote::profiling_set_frame_times(float p_frame_time, float p
 	physics_frame_time = p_physics_frame_time;
 }
 
+void ScriptDebuggerRemote::set_multiplayer(Ref<MultiplayerAPI> p_multiplayer) {
+
+	if (network_profiling && multiplayer.is_valid()) {
+		multiplayer->profiling_end();
+	}
+
+	multiplayer = p_multiplayer;
+
+	if (network_profiling && multiplayer.is_valid()) {
+		multiplayer->profiling_start();
+	}
+}
+
 void ScriptDebuggerRemote::set_allow_focus_steal_pid(OS::ProcessID p_pid) {
 	allow_focus_steal_pid = p_pid;
 }
@@ -1085,6 +1174,8 @@ ScriptDebuggerRemote::ScriptDebuggerRemote() :
 		max_frame_functions(16),
 		skip_profile_frame(false),
 		reload_all_scripts(false),
+		network_profiling(false),
+		last_network_profile_time(0),
 		tcp_client(StreamPeerTCP::create_ref()),
 		packet_peer_stream(Ref<PacketPeerStream>(memnew(PacketPeerStream))),
 		last_perf_time(0),
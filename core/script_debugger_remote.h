@@ -63,6 +63,11 @@ class ScriptDebuggerRemote : public ScriptDebugger {
 	bool skip_profile_frame;
 	bool reload_all_scripts;
 
+	Ref<MultiplayerAPI> multiplayer;
+	Vector<MultiplayerAPI::ProfilingInfo> network_profile_info;
+	bool network_profiling;
+	uint64_t last_network_profile_time;
+
 	Ref<StreamPeerTCP> tcp_client;
 	Ref<PacketPeerStream> packet_peer_stream;
 
@@ -125,6 +130,7 @@ class ScriptDebuggerRemote : public ScriptDebugger {
 	static void _err_handler(void *, const char *, const char *, int p_line, const char *, const char *, ErrorHandlerType p_type);
 
 	void _send_profiling_data(bool p_for_frame);
+	void _send_network_profiling_data();
 
 	struct FrameData {
 
@@ -166,6 +172,7 @@ public:
 
 	virtual void set_request_scene_tree_message_func(RequestSceneTreeMessageFunc p_func, void *p_udata);
 	virtual void set_live_edit_funcs(LiveEditFuncs *p_funcs);
+	virtual void set_multiplayer(Ref<MultiplayerAPI> p_multiplayer);
 
 	virtual bool is_profiling() const;
 	virtual void add_profiling_frame_data(const StringName &p_name, const Array &p_data);
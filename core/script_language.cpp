@@ -36,6 +36,7 @@ int ScriptServer::_language_count = 0;
 
 bool ScriptServer::scripting_enabled = true;
 bool ScriptServer::reload_scripts_on_save = false;
+uint32_t ScriptServer::reload_version = 0;
 ScriptEditRequestFunction ScriptServer::edit_request_func = NULL;
 
 void Script::_notification(int p_what) {
@@ -141,6 +142,11 @@ bool ScriptServer::is_reload_scripts_on_save_enabled() {
 	return reload_scripts_on_save;
 }
 
+void ScriptServer::increase_reload_version() {
+
+	reload_version++;
+}
+
 void ScriptServer::thread_enter() {
 
 	for (int i = 0; i < _language_count; i++) {
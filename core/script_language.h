@@ -53,6 +53,7 @@ class ScriptServer {
 	static int _language_count;
 	static bool scripting_enabled;
 	static bool reload_scripts_on_save;
+	static uint32_t reload_version;
 
 	struct GlobalScriptClass {
 		StringName language;
@@ -75,6 +76,10 @@ public:
 	static void set_reload_scripts_on_save(bool p_enable);
 	static bool is_reload_scripts_on_save_enabled();
 
+	// changes whenever running scripts are reloaded, so anything cached about their methods can be refreshed
+	_FORCE_INLINE_ static uint32_t get_reload_version() { return reload_version; }
+	static void increase_reload_version();
+
 	static void thread_enter();
 	static void thread_exit();
 
@@ -153,6 +158,13 @@ public:
 	virtual void get_property_list(List<PropertyInfo> *p_properties) const = 0;
 	virtual Variant::Type get_property_type(const StringName &p_name, bool *r_is_valid = NULL) const = 0;
 
+	// handles let native code access the same member repeatedly without looking it up by name,
+	// they are only valid for this instance while get_member_handle_version() returns the same value
+	virtual int get_member_handle(const StringName &p_name) const { return -1; }
+	virtual uint64_t get_member_handle_version() const { return 0; }
+	virtual bool set_member(int p_handle, const Variant &p_value) { return false; }
+	virtual bool get_member(int p_handle, Variant &r_ret) const { return false; }
+
 	virtual Object *get_owner() { return NULL; }
 	virtual void get_property_state(List<Pair<StringName, Variant> > &state);
 
@@ -419,6 +431,7 @@ public:
 
 	virtual void set_request_scene_tree_message_func(RequestSceneTreeMessageFunc p_func, void *p_udata) {}
 	virtual void set_live_edit_funcs(LiveEditFuncs *p_funcs) {}
+	virtual void set_multiplayer(Ref<MultiplayerAPI> p_multiplayer) {}
 
 	virtual bool is_profiling() const = 0;
 	virtual void add_profiling_frame_data(const StringName &p_name, const Array &p_data) = 0;
@@ -0,0 +1,109 @@
+/*************************************************************************/
+/*  slot_pool.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SLOT_POOL_H
+#define SLOT_POOL_H
+
+#include "os/memory.h"
+#include "safe_refcount.h"
+
+/**
+ * Keeps up to SLOTS freed blocks around, so short lived objects that are created all the
+ * time (like the shared data of Array and Dictionary) don't go through the allocator.
+ *
+ * A slot only ever changes between NULL and a free block with a compare-and-swap, so it
+ * works from any thread without a lock. If a slot is emptied and refilled with the same
+ * block while another thread is about to take it, that thread still gets a free block.
+ * SLOTS has to be a power of two.
+ */
+
+template <class T, int SLOTS = 32>
+class SlotPool {
+
+	void *volatile slots[SLOTS];
+	uint32_t hint; // only a starting point for the search, races on it are harmless
+	uint32_t heap_allocations;
+
+public:
+	T *alloc() {
+
+		uint32_t start = hint;
+		for (int i = 0; i < SLOTS; i++) {
+
+			uint32_t idx = (start - i) & (SLOTS - 1);
+			void *block = slots[idx];
+			if (block && atomic_compare_and_swap_ptr(&slots[idx], block, NULL) == block) {
+				hint = idx;
+				return memnew_placement(block, T);
+			}
+		}
+
+		atomic_increment(&heap_allocations);
+		return memnew_placement(memalloc(sizeof(T)), T);
+	}
+
+	void free(T *p_object) {
+
+		p_object->~T();
+
+		uint32_t start = hint;
+		for (int i = 0; i < SLOTS; i++) {
+
+			uint32_t idx = (start + i) & (SLOTS - 1);
+			if (!slots[idx] && atomic_compare_and_swap_ptr(&slots[idx], NULL, p_object) == NULL) {
+				hint = idx;
+				return;
+			}
+		}
+
+		memfree(p_object);
+	}
+
+	uint32_t get_heap_allocation_count() const { return heap_allocations; }
+
+	SlotPool() {
+
+		for (int i = 0; i < SLOTS; i++) {
+			slots[i] = NULL;
+		}
+		hint = 0;
+		heap_allocations = 0;
+	}
+
+	~SlotPool() {
+
+		for (int i = 0; i < SLOTS; i++) {
+			if (slots[i])
+				memfree(slots[i]);
+		}
+	}
+};
+
+#endif // SLOT_POOL_H
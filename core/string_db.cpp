@@ -46,24 +46,39 @@ StringName _scs_create(const char *p_chr) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
 }
 
+StringName::_Data *volatile StringName::_static_cache[STATIC_CACHE_LEN];
+
 bool StringName::configured = false;
-Mutex *StringName::lock = NULL;
+SpinMutex StringName::locks[LOCK_COUNT];
 
 void StringName::setup() {
 
-	lock = Mutex::create();
-
 	ERR_FAIL_COND(configured);
+	for (int i = 0; i < LOCK_COUNT; i++) {
+
+		locks[i].set_profile_site("StringName");
+	}
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
 
 		_table[i] = NULL;
 	}
+	for (int i = 0; i < STATIC_CACHE_LEN; i++) {
+
+		_static_cache[i] = NULL;
+	}
 	configured = true;
 }
 
 void StringName::cleanup() {
 
-	lock->lock();
+	// release the references held by the static cache, so they don't show up as lost
+	for (int i = 0; i < STATIC_CACHE_LEN; i++) {
+
+		if (_static_cache[i]) {
+			StringName cached(_static_cache[i]);
+			_static_cache[i] = NULL;
+		}
+	}
 
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
@@ -88,9 +103,6 @@ void StringName::cleanup() {
 	if (OS::get_singleton()->is_stdout_verbose() && lost_strings) {
 		print_line("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock->unlock();
-
-	memdelete(lock);
 }
 
 void StringName::unref() {
@@ -99,6 +111,7 @@ void StringName::unref() {
 
 	if (_data && _data->refcount.unref()) {
 
+		SpinMutex *lock = _get_lock(_data->idx);
 		lock->lock();
 
 		if (_data->prev) {
@@ -127,7 +140,7 @@ bool StringName::operator==(const String &p_name) const {
 		return (p_name.length() == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return (_data->equals(p_name));
 }
 
 bool StringName::operator==(const char *p_name) const {
@@ -137,7 +150,7 @@ bool StringName::operator==(const char *p_name) const {
 		return (p_name[0] == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return (_data->equals(p_name));
 }
 
 bool StringName::operator!=(const String &p_name) const {
@@ -185,18 +198,19 @@ StringName::StringName(const char *p_name) {
 	if (!p_name || p_name[0] == 0)
 		return; //empty, ignore
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	SpinMutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
 
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
+		if (_data->hash == hash && _data->equals(p_name))
 			break;
 		_data = _data->next;
 	}
@@ -233,18 +247,19 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	SpinMutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
 
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr)
+		if (_data->hash == hash && _data->equals(p_static_string.ptr))
 			break;
 		_data = _data->next;
 	}
@@ -282,17 +297,18 @@ StringName::StringName(const String &p_name) {
 	if (p_name == String())
 		return;
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	SpinMutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
 
-		if (_data->hash == hash && _data->get_name() == p_name)
+		if (_data->hash == hash && _data->equals(p_name))
 			break;
 		_data = _data->next;
 	}
@@ -329,18 +345,19 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	SpinMutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
 
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
+		if (_data->hash == hash && _data->equals(p_name))
 			break;
 		_data = _data->next;
 	}
@@ -363,18 +380,19 @@ StringName StringName::search(const CharType *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	SpinMutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
 
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
+		if (_data->hash == hash && _data->equals(p_name))
 			break;
 		_data = _data->next;
 	}
@@ -391,18 +409,19 @@ StringName StringName::search(const String &p_name) {
 
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	SpinMutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
 
 		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name())
+		if (_data->hash == hash && _data->equals(p_name))
 			break;
 		_data = _data->next;
 	}
@@ -416,6 +435,36 @@ StringName StringName::search(const String &p_name) {
 	return StringName(); //does not exist
 }
 
+StringName StringName::from_static(const char *p_name) {
+
+	ERR_FAIL_COND_V(!configured, StringName());
+
+	if (!p_name || !p_name[0])
+		return StringName();
+
+	// Static strings keep their address, so the slot is found from the pointer alone and
+	// no hashing or locking is needed. Slots are only ever filled once and keep a reference,
+	// so an entry read here can't be freed by another thread.
+	uint32_t slot = (uint32_t((uint64_t)p_name >> 2) * 2654435761U) >> (32 - STATIC_CACHE_BITS);
+
+	_Data *cached = _static_cache[slot];
+	if (cached && cached->cname == p_name) {
+		cached->refcount.ref();
+		return StringName(cached);
+	}
+
+	StringName sname = StringName(StaticCString::create(p_name));
+
+	if (!cached && sname._data && sname._data->cname == p_name && sname._data->refcount.ref()) {
+
+		if (atomic_compare_and_swap_ptr((void *volatile *)&_static_cache[slot], NULL, sname._data) != NULL) {
+			sname._data->refcount.unref(); // another thread filled the slot, sname still holds one
+		}
+	}
+
+	return sname;
+}
+
 StringName::StringName() {
 
 	_data = NULL;
@@ -31,7 +31,7 @@
 #ifndef STRING_DB_H
 #define STRING_DB_H
 
-#include "os/mutex.h"
+#include "os/spin_mutex.h"
 #include "safe_refcount.h"
 #include "ustring.h"
 /**
@@ -50,7 +50,12 @@ class StringName {
 
 		STRING_TABLE_BITS = 12,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		LOCK_BITS = 6,
+		LOCK_COUNT = 1 << LOCK_BITS,
+		LOCK_MASK = LOCK_COUNT - 1,
+		STATIC_CACHE_BITS = 11,
+		STATIC_CACHE_LEN = 1 << STATIC_CACHE_BITS
 	};
 
 	struct _Data {
@@ -59,6 +64,36 @@ class StringName {
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
+
+		// same as comparing get_name(), without building a String
+		_FORCE_INLINE_ bool equals(const char *p_name) const {
+
+			if (!cname)
+				return name == p_name;
+
+			const char *c = cname;
+			while (*c && *c == *p_name) {
+				c++;
+				p_name++;
+			}
+			return *c == *p_name;
+		}
+		_FORCE_INLINE_ bool equals(const CharType *p_name) const {
+
+			if (!cname)
+				return name == p_name;
+
+			const char *c = cname;
+			while (*c && CharType((uint8_t)*c) == *p_name) {
+				c++;
+				p_name++;
+			}
+			return *c == 0 && *p_name == 0;
+		}
+		_FORCE_INLINE_ bool equals(const String &p_name) const {
+
+			return cname ? p_name == cname : name == p_name;
+		}
 		int idx;
 		uint32_t hash;
 		_Data *prev;
@@ -72,6 +107,7 @@ class StringName {
 	};
 
 	static _Data *_table[STRING_TABLE_LEN];
+	static _Data *volatile _static_cache[STATIC_CACHE_LEN];
 
 	_Data *_data;
 
@@ -85,7 +121,10 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex *lock;
+	// buckets are spread over several locks, so threads only contend on the same shard
+	static SpinMutex locks[LOCK_COUNT];
+	_FORCE_INLINE_ static SpinMutex *_get_lock(uint32_t p_idx) { return &locks[p_idx & LOCK_MASK]; }
+
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -135,6 +174,9 @@ public:
 	static StringName search(const CharType *p_name);
 	static StringName search(const String &p_name);
 
+	// for names that are static strings (usually literals), see SNAME()
+	static StringName from_static(const char *p_name);
+
 	struct AlphCompare {
 
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
@@ -169,4 +211,8 @@ public:
 
 StringName _scs_create(const char *p_chr);
 
+// Lock-free lookup of a string literal, cached by its address. Use it on hot paths
+// instead of building a StringName from the literal every time.
+#define SNAME(m_arg) StringName::from_static(m_arg)
+
 #endif
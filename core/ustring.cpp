@@ -40,6 +40,7 @@
 #include "thirdparty/misc/md5.h"
 #include "thirdparty/misc/sha256.h"
 
+#include <string.h>
 #include <wchar.h>
 
 #ifndef NO_USE_STDLIB
@@ -1363,8 +1364,33 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		}
 	}
 
+	/* plain ASCII prefix, copied without decoding */
+	int ascii_size = 0;
+	if (p_len >= 0) {
+
+		while (ascii_size + 8 <= p_len) {
+			uint64_t word;
+			memcpy(&word, &p_utf8[ascii_size], 8);
+			// stop at any byte with the high bit set, or any zero byte
+			if ((word | ((word - 0x0101010101010101ULL) & ~word)) & 0x8080808080808080ULL)
+				break;
+			ascii_size += 8;
+		}
+		while (ascii_size < p_len && uint8_t(p_utf8[ascii_size] - 1) < 0x7f) {
+			ascii_size++;
+		}
+	} else {
+
+		while (uint8_t(p_utf8[ascii_size] - 1) < 0x7f) {
+			ascii_size++;
+		}
+	}
+
+	cstr_size = ascii_size;
+	str_size = ascii_size;
+
 	{
-		const char *ptrtmp = p_utf8;
+		const char *ptrtmp = &p_utf8[ascii_size];
 		const char *ptrtmp_limit = &p_utf8[p_len];
 		int skip = 0;
 		while (ptrtmp != ptrtmp_limit && *ptrtmp) {
@@ -1420,9 +1446,16 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	}
 
 	resize(str_size + 1);
-	CharType *dst = &operator[](0);
+	CharType *dst = ptrw();
 	dst[str_size] = 0;
 
+	for (int i = 0; i < ascii_size; i++) {
+		dst[i] = p_utf8[i];
+	}
+	dst += ascii_size;
+	p_utf8 += ascii_size;
+	cstr_size -= ascii_size;
+
 	while (cstr_size) {
 
 		int len = 0;
@@ -1501,6 +1534,24 @@ CharString String::utf8() const {
 		return CharString();
 
 	const CharType *d = &operator[](0);
+
+	// plain ASCII needs no counting or encoding
+	uint32_t bits = 0;
+	for (int i = 0; i < l; i++) {
+		bits |= d[i];
+	}
+	if (bits <= 0x7f) {
+
+		CharString ascii;
+		ascii.resize(l + 1);
+		char *adst = ascii.ptrw();
+		for (int i = 0; i < l; i++) {
+			adst[i] = d[i];
+		}
+		adst[l] = 0;
+		return ascii;
+	}
+
 	int fl = 0;
 	for (int i = 0; i < l; i++) {
 
@@ -2108,6 +2159,23 @@ String operator+(CharType p_chr, const String &p_str) {
 	return (String::chr(p_chr) + p_str);
 }
 
+// djb2 over four characters per step, h * 33^4 + c0 * 33^3 + c1 * 33^2 + c2 * 33 + c3,
+// which gives the same result with a shorter dependency chain
+template <class T>
+static _FORCE_INLINE_ uint32_t _hash_djb2(const T *p_str, int p_len) {
+
+	uint32_t hashv = 5381;
+	int i = 0;
+	for (; i + 4 <= p_len; i += 4) {
+		hashv = hashv * 1185921 + uint32_t(p_str[i]) * 35937 + uint32_t(p_str[i + 1]) * 1089 + uint32_t(p_str[i + 2]) * 33 + uint32_t(p_str[i + 3]);
+	}
+	for (; i < p_len; i++) {
+		hashv = ((hashv << 5) + hashv) + uint32_t(p_str[i]); /* hash * 33 + c */
+	}
+
+	return hashv;
+}
+
 uint32_t String::hash(const char *p_cstr) {
 
 	uint32_t hashv = 5381;
@@ -2121,20 +2189,12 @@ uint32_t String::hash(const char *p_cstr) {
 
 uint32_t String::hash(const char *p_cstr, int p_len) {
 
-	uint32_t hashv = 5381;
-	for (int i = 0; i < p_len; i++)
-		hashv = ((hashv << 5) + hashv) + p_cstr[i]; /* hash * 33 + c */
-
-	return hashv;
+	return _hash_djb2(p_cstr, p_len);
 }
 
 uint32_t String::hash(const CharType *p_cstr, int p_len) {
 
-	uint32_t hashv = 5381;
-	for (int i = 0; i < p_len; i++)
-		hashv = ((hashv << 5) + hashv) + p_cstr[i]; /* hash * 33 + c */
-
-	return hashv;
+	return _hash_djb2(p_cstr, p_len);
 }
 
 uint32_t String::hash(const CharType *p_cstr) {
@@ -2152,14 +2212,7 @@ uint32_t String::hash() const {
 
 	/* simple djb2 hashing */
 
-	const CharType *chr = c_str();
-	uint32_t hashv = 5381;
-	uint32_t c;
-
-	while ((c = *chr++))
-		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
-
-	return hashv;
+	return _hash_djb2(c_str(), length());
 }
 
 uint64_t String::hash64() const {
@@ -2297,27 +2350,19 @@ int String::find(const String &p_str, int p_from) const {
 	const CharType *src = c_str();
 	const CharType *str = p_str.c_str();
 
-	for (int i = p_from; i <= (len - src_len); i++) {
-
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			};
+	// wmemchr skips to the candidates, the C library vectorizes it
+	const int last = len - src_len;
+	int i = p_from;
+	while (i <= last) {
 
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
-		}
+		const CharType *candidate = wmemchr(&src[i], str[0], last - i + 1);
+		if (!candidate)
+			return -1;
 
-		if (found)
+		i = candidate - src;
+		if (memcmp(&src[i + 1], &str[1], (src_len - 1) * sizeof(CharType)) == 0)
 			return i;
+		i++;
 	}
 
 	return -1;
@@ -2822,23 +2867,53 @@ String String::format(const Variant &values, String placeholder) const {
 
 String String::replace(const String &p_key, const String &p_with) const {
 
-	String new_string;
+	const int key_len = p_key.length();
+	if (key_len == 0)
+		return *this;
+
+	// find all matches first, so the result is allocated once
+	Vector<int> matches;
 	int search_from = 0;
 	int result = 0;
 
 	while ((result = find(p_key, search_from)) >= 0) {
 
-		new_string += substr(search_from, result - search_from);
-		new_string += p_with;
-		search_from = result + p_key.length();
+		matches.push_back(result);
+		search_from = result + key_len;
 	}
 
-	if (search_from == 0) {
+	if (matches.empty()) {
 
 		return *this;
 	}
 
-	new_string += substr(search_from, length() - search_from);
+	const int len = length();
+	const int with_len = p_with.length();
+	const int new_len = len + matches.size() * (with_len - key_len);
+
+	if (new_len == 0)
+		return String();
+
+	String new_string;
+	new_string.resize(new_len + 1);
+
+	const CharType *src = c_str();
+	const CharType *with = p_with.c_str();
+	CharType *dst = new_string.ptrw();
+
+	int from = 0;
+	for (int i = 0; i < matches.size(); i++) {
+
+		int to = matches[i];
+		memcpy(dst, &src[from], (to - from) * sizeof(CharType));
+		dst += to - from;
+		memcpy(dst, with, with_len * sizeof(CharType));
+		dst += with_len;
+		from = to + key_len;
+	}
+
+	memcpy(dst, &src[from], (len - from) * sizeof(CharType));
+	dst[len - from] = 0;
 
 	return new_string;
 }
@@ -358,6 +358,12 @@ public:
 	};
 
 	void call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
+
+	// Opaque handle to a builtin type method, resolved once and valid for the lifetime of the engine.
+	// Only call it on a Variant of the type it was resolved for.
+	typedef const void *BuiltinMethod;
+	static BuiltinMethod get_builtin_method(Variant::Type p_type, const StringName &p_method);
+	void call_builtin(BuiltinMethod p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant &p_arg1 = Variant(), const Variant &p_arg2 = Variant(), const Variant &p_arg3 = Variant(), const Variant &p_arg4 = Variant(), const Variant &p_arg5 = Variant());
 
@@ -31,6 +31,7 @@
 #include "variant.h"
 
 #include "core_string_names.h"
+#include "hash_map.h"
 #include "io/compression.h"
 #include "object.h"
 #include "os/os.h"
@@ -53,6 +54,7 @@ struct _VariantCall {
 		Vector<Variant::Type> arg_types;
 		Vector<StringName> arg_names;
 		Variant::Type return_type;
+		Variant::Type self_type;
 
 		bool _const;
 		bool returns;
@@ -124,6 +126,8 @@ struct _VariantCall {
 	struct TypeFunc {
 
 		Map<StringName, FuncData> functions;
+		// points into functions, element addresses are stable so the pointers double as method handles
+		HashMap<StringName, FuncData *> function_lookup;
 	};
 
 	static TypeFunc *type_funcs;
@@ -154,6 +158,7 @@ struct _VariantCall {
 		funcdata.default_args = p_defaultarg;
 		funcdata._const = p_const;
 		funcdata.returns = p_has_return;
+		funcdata.self_type = p_type;
 #ifdef DEBUG_ENABLED
 		funcdata.return_type = p_return;
 #endif
@@ -204,7 +209,9 @@ struct _VariantCall {
 	end:
 
 		funcdata.arg_count = funcdata.arg_types.size();
-		type_funcs[p_type].functions[p_name] = funcdata;
+		FuncData &fd = type_funcs[p_type].functions[p_name];
+		fd = funcdata;
+		type_funcs[p_type].function_lookup[p_name] = &fd;
 	}
 
 #define VCALL_LOCALMEM0(m_type, m_method) \
@@ -636,6 +643,132 @@ struct _VariantCall {
 	VCALL_LOCALMEM1(PoolVector2Array, append_array);
 	VCALL_LOCALMEM0(PoolVector2Array, invert);
 
+	static void _call_PoolVector2Array_transformed(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector2Array *pa = reinterpret_cast<PoolVector2Array *>(p_self._data._mem);
+		Transform2D xform = *p_args[0];
+		int count = pa->size();
+
+		PoolVector2Array result;
+		result.resize(count);
+		if (count) {
+			xform.xform_array(pa->read().ptr(), result.write().ptr(), count);
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector2Array_translated(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector2Array *pa = reinterpret_cast<PoolVector2Array *>(p_self._data._mem);
+		Vector2 offset = *p_args[0];
+		int count = pa->size();
+
+		PoolVector2Array result;
+		result.resize(count);
+		if (count) {
+			PoolVector2Array::Read r = pa->read();
+			PoolVector2Array::Write w = result.write();
+			const Vector2 *src = r.ptr();
+			Vector2 *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i].x = src[i].x + offset.x;
+				dst[i].y = src[i].y + offset.y;
+			}
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector2Array_scaled(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector2Array *pa = reinterpret_cast<PoolVector2Array *>(p_self._data._mem);
+		Vector2 scale = *p_args[0];
+		int count = pa->size();
+
+		PoolVector2Array result;
+		result.resize(count);
+		if (count) {
+			PoolVector2Array::Read r = pa->read();
+			PoolVector2Array::Write w = result.write();
+			const Vector2 *src = r.ptr();
+			Vector2 *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i].x = src[i].x * scale.x;
+				dst[i].y = src[i].y * scale.y;
+			}
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector2Array_dot(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector2Array *pa = reinterpret_cast<PoolVector2Array *>(p_self._data._mem);
+		Vector2 with = *p_args[0];
+		int count = pa->size();
+
+		PoolRealArray result;
+		result.resize(count);
+		if (count) {
+			PoolVector2Array::Read r = pa->read();
+			PoolRealArray::Write w = result.write();
+			const Vector2 *src = r.ptr();
+			real_t *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i] = src[i].x * with.x + src[i].y * with.y;
+			}
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector2Array_get_bounds(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector2Array *pa = reinterpret_cast<PoolVector2Array *>(p_self._data._mem);
+		int count = pa->size();
+
+		Rect2 bounds;
+		if (count) {
+			PoolVector2Array::Read r = pa->read();
+			const Vector2 *src = r.ptr();
+			Vector2 min = src[0];
+			Vector2 max = src[0];
+			for (int i = 1; i < count; i++) {
+				min.x = MIN(min.x, src[i].x);
+				min.y = MIN(min.y, src[i].y);
+				max.x = MAX(max.x, src[i].x);
+				max.y = MAX(max.y, src[i].y);
+			}
+			bounds = Rect2(min, max - min);
+		}
+		r_ret = bounds;
+	}
+
+	static void _call_PoolVector2Array_linear_interpolate(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector2Array *pa = reinterpret_cast<PoolVector2Array *>(p_self._data._mem);
+		PoolVector2Array to = *p_args[0];
+		real_t weight = *p_args[1];
+		int count = pa->size();
+
+		r_ret = PoolVector2Array();
+		ERR_EXPLAIN("Arrays must have the same size to be interpolated");
+		ERR_FAIL_COND(to.size() != count);
+
+		PoolVector2Array result;
+		result.resize(count);
+		if (count) {
+			PoolVector2Array::Read r = pa->read();
+			PoolVector2Array::Read rt = to.read();
+			PoolVector2Array::Write w = result.write();
+			const Vector2 *src = r.ptr();
+			const Vector2 *to_src = rt.ptr();
+			Vector2 *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i].x = src[i].x + (to_src[i].x - src[i].x) * weight;
+				dst[i].y = src[i].y + (to_src[i].y - src[i].y) * weight;
+			}
+		}
+		r_ret = result;
+	}
+
 	VCALL_LOCALMEM0R(PoolVector3Array, size);
 	VCALL_LOCALMEM2(PoolVector3Array, set);
 	VCALL_LOCALMEM1R(PoolVector3Array, get);
@@ -647,6 +780,137 @@ struct _VariantCall {
 	VCALL_LOCALMEM1(PoolVector3Array, append_array);
 	VCALL_LOCALMEM0(PoolVector3Array, invert);
 
+	static void _call_PoolVector3Array_transformed(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector3Array *pa = reinterpret_cast<PoolVector3Array *>(p_self._data._mem);
+		Transform xform = *p_args[0];
+		int count = pa->size();
+
+		PoolVector3Array result;
+		result.resize(count);
+		if (count) {
+			xform.xform_array(pa->read().ptr(), result.write().ptr(), count);
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector3Array_translated(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector3Array *pa = reinterpret_cast<PoolVector3Array *>(p_self._data._mem);
+		Vector3 offset = *p_args[0];
+		int count = pa->size();
+
+		PoolVector3Array result;
+		result.resize(count);
+		if (count) {
+			PoolVector3Array::Read r = pa->read();
+			PoolVector3Array::Write w = result.write();
+			const Vector3 *src = r.ptr();
+			Vector3 *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i].x = src[i].x + offset.x;
+				dst[i].y = src[i].y + offset.y;
+				dst[i].z = src[i].z + offset.z;
+			}
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector3Array_scaled(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector3Array *pa = reinterpret_cast<PoolVector3Array *>(p_self._data._mem);
+		Vector3 scale = *p_args[0];
+		int count = pa->size();
+
+		PoolVector3Array result;
+		result.resize(count);
+		if (count) {
+			PoolVector3Array::Read r = pa->read();
+			PoolVector3Array::Write w = result.write();
+			const Vector3 *src = r.ptr();
+			Vector3 *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i].x = src[i].x * scale.x;
+				dst[i].y = src[i].y * scale.y;
+				dst[i].z = src[i].z * scale.z;
+			}
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector3Array_dot(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector3Array *pa = reinterpret_cast<PoolVector3Array *>(p_self._data._mem);
+		Vector3 with = *p_args[0];
+		int count = pa->size();
+
+		PoolRealArray result;
+		result.resize(count);
+		if (count) {
+			PoolVector3Array::Read r = pa->read();
+			PoolRealArray::Write w = result.write();
+			const Vector3 *src = r.ptr();
+			real_t *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i] = src[i].x * with.x + src[i].y * with.y + src[i].z * with.z;
+			}
+		}
+		r_ret = result;
+	}
+
+	static void _call_PoolVector3Array_get_aabb(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector3Array *pa = reinterpret_cast<PoolVector3Array *>(p_self._data._mem);
+		int count = pa->size();
+
+		AABB bounds;
+		if (count) {
+			PoolVector3Array::Read r = pa->read();
+			const Vector3 *src = r.ptr();
+			Vector3 min = src[0];
+			Vector3 max = src[0];
+			for (int i = 1; i < count; i++) {
+				min.x = MIN(min.x, src[i].x);
+				min.y = MIN(min.y, src[i].y);
+				min.z = MIN(min.z, src[i].z);
+				max.x = MAX(max.x, src[i].x);
+				max.y = MAX(max.y, src[i].y);
+				max.z = MAX(max.z, src[i].z);
+			}
+			bounds = AABB(min, max - min);
+		}
+		r_ret = bounds;
+	}
+
+	static void _call_PoolVector3Array_linear_interpolate(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		PoolVector3Array *pa = reinterpret_cast<PoolVector3Array *>(p_self._data._mem);
+		PoolVector3Array to = *p_args[0];
+		real_t weight = *p_args[1];
+		int count = pa->size();
+
+		r_ret = PoolVector3Array();
+		ERR_EXPLAIN("Arrays must have the same size to be interpolated");
+		ERR_FAIL_COND(to.size() != count);
+
+		PoolVector3Array result;
+		result.resize(count);
+		if (count) {
+			PoolVector3Array::Read r = pa->read();
+			PoolVector3Array::Read rt = to.read();
+			PoolVector3Array::Write w = result.write();
+			const Vector3 *src = r.ptr();
+			const Vector3 *to_src = rt.ptr();
+			Vector3 *dst = w.ptr();
+			for (int i = 0; i < count; i++) {
+				dst[i].x = src[i].x + (to_src[i].x - src[i].x) * weight;
+				dst[i].y = src[i].y + (to_src[i].y - src[i].y) * weight;
+				dst[i].z = src[i].z + (to_src[i].z - src[i].z) * weight;
+			}
+		}
+		r_ret = result;
+	}
+
 	VCALL_LOCALMEM0R(PoolColorArray, size);
 	VCALL_LOCALMEM2(PoolColorArray, set);
 	VCALL_LOCALMEM1R(PoolColorArray, get);
@@ -1043,21 +1307,49 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 
 		r_error.error = Variant::CallError::CALL_OK;
 
-		Map<StringName, _VariantCall::FuncData>::Element *E = _VariantCall::type_funcs[type].functions.find(p_method);
+		_VariantCall::FuncData *const *F = _VariantCall::type_funcs[type].function_lookup.getptr(p_method);
 #ifdef DEBUG_ENABLED
-		if (!E) {
+		if (!F) {
 			r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
 			return;
 		}
 #endif
-		_VariantCall::FuncData &funcdata = E->get();
-		funcdata.call(ret, *this, p_args, p_argcount, r_error);
+		(*F)->call(ret, *this, p_args, p_argcount, r_error);
 	}
 
 	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
 		*r_ret = ret;
 }
 
+Variant::BuiltinMethod Variant::get_builtin_method(Variant::Type p_type, const StringName &p_method) {
+
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, NULL);
+	if (p_type == OBJECT)
+		return NULL; // objects dispatch through ClassDB
+
+	_VariantCall::FuncData *const *F = _VariantCall::type_funcs[p_type].function_lookup.getptr(p_method);
+	return F ? *F : NULL;
+}
+
+void Variant::call_builtin(BuiltinMethod p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) {
+
+	r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
+	ERR_FAIL_COND(!p_method);
+
+	_VariantCall::FuncData *funcdata = (_VariantCall::FuncData *)p_method;
+#ifdef DEBUG_ENABLED
+	ERR_FAIL_COND(funcdata->self_type != type);
+#endif
+
+	r_error.error = Variant::CallError::CALL_OK;
+
+	Variant ret;
+	funcdata->call(ret, *this, p_args, p_argcount, r_error);
+
+	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
+		*r_ret = ret;
+}
+
 #define VCALL(m_type, m_method) _VariantCall::_call_##m_type##_##m_method
 
 Variant Variant::construct(const Variant::Type p_type, const Variant **p_args, int p_argcount, CallError &r_error, bool p_strict) {
@@ -1217,65 +1509,65 @@ bool Variant::has_method(const StringName &p_method) const {
 	}
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[type];
-	return fd.functions.has(p_method);
+	return fd.function_lookup.has(p_method);
 }
 
 Vector<Variant::Type> Variant::get_method_argument_types(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_lookup.getptr(p_method);
 	if (!E)
 		return Vector<Variant::Type>();
 
-	return E->get().arg_types;
+	return (*E)->arg_types;
 }
 
 bool Variant::is_method_const(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_lookup.getptr(p_method);
 	if (!E)
 		return false;
 
-	return E->get()._const;
+	return (*E)->_const;
 }
 
 Vector<StringName> Variant::get_method_argument_names(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_lookup.getptr(p_method);
 	if (!E)
 		return Vector<StringName>();
 
-	return E->get().arg_names;
+	return (*E)->arg_names;
 }
 
 Variant::Type Variant::get_method_return_type(Variant::Type p_type, const StringName &p_method, bool *r_has_return) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_lookup.getptr(p_method);
 	if (!E)
 		return Variant::NIL;
 
 	if (r_has_return)
-		*r_has_return = E->get().returns;
+		*r_has_return = (*E)->returns;
 
-	return E->get().return_type;
+	return (*E)->return_type;
 }
 
 Vector<Variant> Variant::get_method_default_arguments(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_lookup.getptr(p_method);
 	if (!E)
 		return Vector<Variant>();
 
-	return E->get().default_args;
+	return (*E)->default_args;
 }
 
 void Variant::get_method_list(List<MethodInfo> *p_list) const {
@@ -1739,6 +2031,12 @@ void register_variant_methods() {
 	ADDFUNC2R(POOL_VECTOR2_ARRAY, INT, PoolVector2Array, insert, INT, "idx", VECTOR2, "vector2", varray());
 	ADDFUNC1(POOL_VECTOR2_ARRAY, NIL, PoolVector2Array, resize, INT, "idx", varray());
 	ADDFUNC0(POOL_VECTOR2_ARRAY, NIL, PoolVector2Array, invert, varray());
+	ADDFUNC1R(POOL_VECTOR2_ARRAY, POOL_VECTOR2_ARRAY, PoolVector2Array, transformed, TRANSFORM2D, "transform", varray());
+	ADDFUNC1R(POOL_VECTOR2_ARRAY, POOL_VECTOR2_ARRAY, PoolVector2Array, translated, VECTOR2, "offset", varray());
+	ADDFUNC1R(POOL_VECTOR2_ARRAY, POOL_VECTOR2_ARRAY, PoolVector2Array, scaled, VECTOR2, "scale", varray());
+	ADDFUNC1R(POOL_VECTOR2_ARRAY, POOL_REAL_ARRAY, PoolVector2Array, dot, VECTOR2, "with", varray());
+	ADDFUNC0R(POOL_VECTOR2_ARRAY, RECT2, PoolVector2Array, get_bounds, varray());
+	ADDFUNC2R(POOL_VECTOR2_ARRAY, POOL_VECTOR2_ARRAY, PoolVector2Array, linear_interpolate, POOL_VECTOR2_ARRAY, "to", REAL, "weight", varray());
 
 	ADDFUNC0R(POOL_VECTOR3_ARRAY, INT, PoolVector3Array, size, varray());
 	ADDFUNC2(POOL_VECTOR3_ARRAY, NIL, PoolVector3Array, set, INT, "idx", VECTOR3, "vector3", varray());
@@ -1749,6 +2047,12 @@ void register_variant_methods() {
 	ADDFUNC2R(POOL_VECTOR3_ARRAY, INT, PoolVector3Array, insert, INT, "idx", VECTOR3, "vector3", varray());
 	ADDFUNC1(POOL_VECTOR3_ARRAY, NIL, PoolVector3Array, resize, INT, "idx", varray());
 	ADDFUNC0(POOL_VECTOR3_ARRAY, NIL, PoolVector3Array, invert, varray());
+	ADDFUNC1R(POOL_VECTOR3_ARRAY, POOL_VECTOR3_ARRAY, PoolVector3Array, transformed, TRANSFORM, "transform", varray());
+	ADDFUNC1R(POOL_VECTOR3_ARRAY, POOL_VECTOR3_ARRAY, PoolVector3Array, translated, VECTOR3, "offset", varray());
+	ADDFUNC1R(POOL_VECTOR3_ARRAY, POOL_VECTOR3_ARRAY, PoolVector3Array, scaled, VECTOR3, "scale", varray());
+	ADDFUNC1R(POOL_VECTOR3_ARRAY, POOL_REAL_ARRAY, PoolVector3Array, dot, VECTOR3, "with", varray());
+	ADDFUNC0R(POOL_VECTOR3_ARRAY, AABB, PoolVector3Array, get_aabb, varray());
+	ADDFUNC2R(POOL_VECTOR3_ARRAY, POOL_VECTOR3_ARRAY, PoolVector3Array, linear_interpolate, POOL_VECTOR3_ARRAY, "to", REAL, "weight", varray());
 
 	ADDFUNC0R(POOL_COLOR_ARRAY, INT, PoolColorArray, size, varray());
 	ADDFUNC2(POOL_COLOR_ARRAY, NIL, PoolColorArray, set, INT, "idx", COLOR, "color", varray());
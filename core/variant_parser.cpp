@@ -33,36 +33,57 @@
 #include "core/string_buffer.h"
 #include "io/resource_loader.h"
 #include "os/input_event.h"
+#include "os/copymem.h"
 #include "os/keyboard.h"
 
-CharType VariantParser::StreamFile::get_char() {
+CharType VariantParser::Stream::_fill_readahead() {
 
-	return f->get_8();
+	readahead_pointer = 0;
+	readahead_filled = _read_buffer(readahead_buffer, readahead_enabled ? READAHEAD_SIZE : 1);
+
+	if (readahead_filled == 0) {
+		eof = true;
+		return 0;
+	}
+
+	readahead_pointer = 1;
+	return readahead_buffer[0];
 }
 
-bool VariantParser::StreamFile::is_utf8() const {
+uint32_t VariantParser::StreamFile::_read_buffer(CharType *p_buffer, uint32_t p_num_chars) {
 
-	return true;
+	// read the bytes into the start of the buffer, then widen them back to front
+	uint8_t *bytes = (uint8_t *)p_buffer;
+	uint32_t read = f->get_buffer(bytes, p_num_chars);
+
+	for (int i = int(read) - 1; i >= 0; i--) {
+		p_buffer[i] = bytes[i];
+	}
+
+	return read;
 }
-bool VariantParser::StreamFile::is_eof() const {
 
-	return f->eof_reached();
+bool VariantParser::StreamFile::is_utf8() const {
+
+	return true;
 }
 
-CharType VariantParser::StreamString::get_char() {
+uint32_t VariantParser::StreamString::_read_buffer(CharType *p_buffer, uint32_t p_num_chars) {
 
-	if (pos >= s.length())
+	int available = s.length() - pos;
+	if (available <= 0)
 		return 0;
-	else
-		return s[pos++];
+
+	uint32_t read = MIN(uint32_t(available), p_num_chars);
+	copymem(p_buffer, s.ptr() + pos, read * sizeof(CharType));
+	pos += read;
+
+	return read;
 }
 
 bool VariantParser::StreamString::is_utf8() const {
 	return false;
 }
-bool VariantParser::StreamString::is_eof() const {
-	return pos > s.length();
-}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -200,7 +221,8 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 			};
 			case '"': {
 
-				String str;
+				StringBuffer<> str;
+				bool ascii = true;
 				while (true) {
 
 					CharType ch = p_stream->get_char();
@@ -273,20 +295,26 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 							} break;
 						}
 
+						if (res >= 0x80)
+							ascii = false;
 						str += res;
 
 					} else {
 						if (ch == '\n')
 							line++;
+						else if (ch >= 0x80)
+							ascii = false;
 						str += ch;
 					}
 				}
 
-				if (p_stream->is_utf8()) {
-					str.parse_utf8(str.ascii(true).get_data());
+				String s = str.as_string();
+				if (!ascii && p_stream->is_utf8()) {
+					CharString utf8 = s.ascii(true);
+					s.parse_utf8(utf8.get_data(), utf8.length());
 				}
 				r_token.type = TK_STRING;
-				r_token.value = str;
+				r_token.value = s;
 				return OK;
 
 			} break;
@@ -480,6 +508,73 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 	return OK;
 }
 
+static _FORCE_INLINE_ void _set_pool_element(uint8_t &r_elem, const uint8_t *p_c) { r_elem = p_c[0]; }
+static _FORCE_INLINE_ void _set_pool_element(int &r_elem, const int *p_c) { r_elem = p_c[0]; }
+static _FORCE_INLINE_ void _set_pool_element(float &r_elem, const float *p_c) { r_elem = p_c[0]; }
+static _FORCE_INLINE_ void _set_pool_element(Vector2 &r_elem, const float *p_c) { r_elem = Vector2(p_c[0], p_c[1]); }
+static _FORCE_INLINE_ void _set_pool_element(Vector3 &r_elem, const float *p_c) { r_elem = Vector3(p_c[0], p_c[1], p_c[2]); }
+static _FORCE_INLINE_ void _set_pool_element(Color &r_elem, const float *p_c) { r_elem = Color(p_c[0], p_c[1], p_c[2], p_c[3]); }
+
+template <class T, class C, int N>
+Error VariantParser::_parse_pool_construct(Stream *p_stream, PoolVector<T> &r_array, int &line, String &r_err_str) {
+
+	Token token;
+	get_token(p_stream, token, line, r_err_str);
+	if (token.type != TK_PARENTHESIS_OPEN) {
+		r_err_str = "Expected '(' in constructor";
+		return ERR_PARSE_ERROR;
+	}
+
+	// elements are written straight into the array, which grows by doubling and is trimmed at the end
+	C components[N];
+	int component = 0;
+	int count = 0;
+	typename PoolVector<T>::Write w;
+
+	bool first = true;
+	while (true) {
+
+		if (!first) {
+			get_token(p_stream, token, line, r_err_str);
+			if (token.type == TK_COMMA) {
+				//do none
+			} else if (token.type == TK_PARENTHESIS_CLOSE) {
+				break;
+			} else {
+				r_err_str = "Expected ',' or ')' in constructor";
+				return ERR_PARSE_ERROR;
+			}
+		}
+		get_token(p_stream, token, line, r_err_str);
+
+		if (first && token.type == TK_PARENTHESIS_CLOSE) {
+			break;
+		} else if (token.type != TK_NUMBER) {
+			r_err_str = "Expected float in constructor";
+			return ERR_PARSE_ERROR;
+		}
+
+		components[component++] = token.value;
+		if (component == N) {
+
+			if (count == r_array.size()) {
+				w = typename PoolVector<T>::Write();
+				r_array.resize(MAX(count * 2, 16));
+				w = r_array.write();
+			}
+
+			_set_pool_element(w[count++], components);
+			component = 0;
+		}
+		first = false;
+	}
+
+	w = typename PoolVector<T>::Write();
+	r_array.resize(count);
+
+	return OK;
+}
+
 Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser) {
 
 	/*	{
@@ -1060,63 +1155,33 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 #endif
 		} else if (id == "PoolByteArray" || id == "ByteArray") {
 
-			Vector<uint8_t> args;
-			Error err = _parse_construct<uint8_t>(p_stream, args, line, r_err_str);
+			PoolVector<uint8_t> arr;
+			Error err = _parse_pool_construct<uint8_t, uint8_t, 1>(p_stream, arr, line, r_err_str);
 			if (err)
 				return err;
 
-			PoolVector<uint8_t> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				PoolVector<uint8_t>::Write w = arr.write();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
 			value = arr;
 
 			return OK;
 
 		} else if (id == "PoolIntArray" || id == "IntArray") {
 
-			Vector<int> args;
-			Error err = _parse_construct<int>(p_stream, args, line, r_err_str);
+			PoolVector<int> arr;
+			Error err = _parse_pool_construct<int, int, 1>(p_stream, arr, line, r_err_str);
 			if (err)
 				return err;
 
-			PoolVector<int> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				PoolVector<int>::Write w = arr.write();
-				for (int i = 0; i < len; i++) {
-					w[i] = int(args[i]);
-				}
-			}
-
 			value = arr;
 
 			return OK;
 
 		} else if (id == "PoolRealArray" || id == "FloatArray") {
 
-			Vector<float> args;
-			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
+			PoolVector<float> arr;
+			Error err = _parse_pool_construct<float, float, 1>(p_stream, arr, line, r_err_str);
 			if (err)
 				return err;
 
-			PoolVector<float> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				PoolVector<float>::Write w = arr.write();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
 			value = arr;
 
 			return OK;
@@ -1173,63 +1238,33 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 
 		} else if (id == "PoolVector2Array" || id == "Vector2Array") {
 
-			Vector<float> args;
-			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
+			PoolVector<Vector2> arr;
+			Error err = _parse_pool_construct<Vector2, float, 2>(p_stream, arr, line, r_err_str);
 			if (err)
 				return err;
 
-			PoolVector<Vector2> arr;
-			{
-				int len = args.size() / 2;
-				arr.resize(len);
-				PoolVector<Vector2>::Write w = arr.write();
-				for (int i = 0; i < len; i++) {
-					w[i] = Vector2(args[i * 2 + 0], args[i * 2 + 1]);
-				}
-			}
-
 			value = arr;
 
 			return OK;
 
 		} else if (id == "PoolVector3Array" || id == "Vector3Array") {
 
-			Vector<float> args;
-			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
+			PoolVector<Vector3> arr;
+			Error err = _parse_pool_construct<Vector3, float, 3>(p_stream, arr, line, r_err_str);
 			if (err)
 				return err;
 
-			PoolVector<Vector3> arr;
-			{
-				int len = args.size() / 3;
-				arr.resize(len);
-				PoolVector<Vector3>::Write w = arr.write();
-				for (int i = 0; i < len; i++) {
-					w[i] = Vector3(args[i * 3 + 0], args[i * 3 + 1], args[i * 3 + 2]);
-				}
-			}
-
 			value = arr;
 
 			return OK;
 
 		} else if (id == "PoolColorArray" || id == "ColorArray") {
 
-			Vector<float> args;
-			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
+			PoolVector<Color> arr;
+			Error err = _parse_pool_construct<Color, float, 4>(p_stream, arr, line, r_err_str);
 			if (err)
 				return err;
 
-			PoolVector<Color> arr;
-			{
-				int len = args.size() / 4;
-				arr.resize(len);
-				PoolVector<Color>::Write w = arr.write();
-				for (int i = 0; i < len; i++) {
-					w[i] = Color(args[i * 4 + 0], args[i * 4 + 1], args[i * 4 + 2], args[i * 4 + 3]);
-				}
-			}
-
 			value = arr;
 
 			return OK;
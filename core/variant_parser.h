@@ -39,35 +39,70 @@ class VariantParser {
 public:
 	struct Stream {
 
-		virtual CharType get_char() = 0;
+	private:
+		enum {
+			READAHEAD_SIZE = 2048
+		};
+
+		CharType readahead_buffer[READAHEAD_SIZE];
+		uint32_t readahead_pointer;
+		uint32_t readahead_filled;
+		bool eof;
+
+		CharType _fill_readahead();
+
+	protected:
+		virtual uint32_t _read_buffer(CharType *p_buffer, uint32_t p_num_chars) = 0;
+
+	public:
+		// Characters are read in blocks, so the source is only accessed once per block.
+		// Disable this when the position of the underlying source must follow the parser.
+		bool readahead_enabled;
+
+		_FORCE_INLINE_ CharType get_char() {
+
+			if (readahead_pointer < readahead_filled)
+				return readahead_buffer[readahead_pointer++];
+			return _fill_readahead();
+		}
+		_FORCE_INLINE_ bool is_eof() const { return eof; }
 		virtual bool is_utf8() const = 0;
-		virtual bool is_eof() const = 0;
 
 		CharType saved;
 
-		Stream() { saved = 0; }
+		Stream() {
+			readahead_pointer = 0;
+			readahead_filled = 0;
+			eof = false;
+			readahead_enabled = true;
+			saved = 0;
+		}
 		virtual ~Stream() {}
 	};
 
 	struct StreamFile : public Stream {
 
+	protected:
+		virtual uint32_t _read_buffer(CharType *p_buffer, uint32_t p_num_chars);
+
+	public:
 		FileAccess *f;
 
-		virtual CharType get_char();
 		virtual bool is_utf8() const;
-		virtual bool is_eof() const;
 
 		StreamFile() { f = NULL; }
 	};
 
 	struct StreamString : public Stream {
 
+	protected:
+		virtual uint32_t _read_buffer(CharType *p_buffer, uint32_t p_num_chars);
+
+	public:
 		String s;
 		int pos;
 
-		virtual CharType get_char();
 		virtual bool is_utf8() const;
-		virtual bool is_eof() const;
 
 		StreamString() { pos = 0; }
 	};
@@ -127,6 +162,8 @@ private:
 
 	template <class T>
 	static Error _parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str);
+	template <class T, class C, int N>
+	static Error _parse_pool_construct(Stream *p_stream, PoolVector<T> &r_array, int &line, String &r_err_str);
 	static Error _parse_enginecfg(Stream *p_stream, Vector<String> &strings, int &line, String &r_err_str);
 	static Error _parse_dictionary(Dictionary &object, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser = NULL);
 	static Error _parse_array(Array &array, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser = NULL);
@@ -156,8 +156,12 @@ Error AudioDriverALSA::init() {
 
 	Error err = init_device();
 	if (err == OK) {
-		mutex = Mutex::create();
-		thread = Thread::create(AudioDriverALSA::thread_func, this);
+		mutex = Mutex::create(true, "AudioServer::lock");
+		Thread::Settings settings;
+		settings.name = "Audio Mix";
+		settings.priority = Thread::PRIORITY_REALTIME;
+		settings.core_type = Thread::CORE_TYPE_PERFORMANCE;
+		thread = Thread::create(AudioDriverALSA::thread_func, this, settings);
 	}
 
 	return err;
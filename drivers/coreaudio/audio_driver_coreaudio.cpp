@@ -53,7 +53,7 @@ OSStatus AudioDriverCoreAudio::output_device_address_cb(AudioObjectID inObjectID
 #endif
 
 Error AudioDriverCoreAudio::init() {
-	mutex = Mutex::create();
+	mutex = Mutex::create(true, "AudioServer::lock");
 
 	AudioComponentDescription desc;
 	zeromem(&desc, sizeof(desc));
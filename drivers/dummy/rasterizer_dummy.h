@@ -31,6 +31,7 @@
 #define RASTERIZER_DUMMY_H
 
 #include "camera_matrix.h"
+#include "core/engine.h"
 #include "scene/resources/mesh.h"
 #include "servers/visual/rasterizer.h"
 #include "servers/visual_server.h"
@@ -68,6 +69,7 @@ public:
 
 	void environment_set_ssr(RID p_env, bool p_enable, int p_max_steps, float p_fade_int, float p_fade_out, float p_depth_tolerance, bool p_roughness) {}
 	void environment_set_ssao(RID p_env, bool p_enable, float p_radius, float p_intensity, float p_radius2, float p_intensity2, float p_bias, float p_light_affect, float p_ao_channel_affect, const Color &p_color, VS::EnvironmentSSAOQuality p_quality, VS::EnvironmentSSAOBlur p_blur, float p_bilateral_sharpness) {}
+	void environment_set_ssao_resolution(RID p_env, VS::EnvironmentSSAOResolution p_resolution) {}
 
 	void environment_set_tonemap(RID p_env, VS::EnvironmentToneMapper p_tone_mapper, float p_exposure, float p_white, bool p_auto_exposure, float p_min_luminance, float p_max_luminance, float p_auto_exp_speed, float p_auto_exp_scale) {}
 
@@ -162,6 +164,10 @@ public:
 		t->height = p_height;
 		t->flags = p_flags;
 		t->format = p_format;
+		if (Engine::get_singleton()->is_headless()) {
+			t->image = Ref<Image>(); //size-only stub, pixels would never be read
+			return;
+		}
 		t->image = Ref<Image>(memnew(Image));
 		t->image->create(p_width, p_height, false, p_format);
 	}
@@ -171,6 +177,8 @@ public:
 		t->width = p_image->get_width();
 		t->height = p_image->get_height();
 		t->format = p_image->get_format();
+		if (t->image.is_null())
+			return;
 		t->image->create(t->width, t->height, false, t->format, p_image->get_data());
 	}
 
@@ -184,6 +192,9 @@ public:
 		ERR_FAIL_COND(src_x < 0 || src_y < 0 || src_x + src_w > p_image->get_width() || src_y + src_h > p_image->get_height());
 		ERR_FAIL_COND(dst_x < 0 || dst_y < 0 || dst_x + src_w > t->width || dst_y + src_h > t->height);
 
+		if (t->image.is_null())
+			return;
+
 		t->image->blit_rect(p_image, Rect2(src_x, src_y, src_w, src_h), Vector2(dst_x, dst_y));
 	}
 
@@ -235,6 +246,7 @@ public:
 	void texture_set_detect_3d_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) {}
 	void texture_set_detect_srgb_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) {}
 	void texture_set_detect_normal_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) {}
+	void texture_set_stream_request_callback(RID p_texture, VisualServer::TextureStreamRequestCallback p_callback, void *p_userdata) {}
 
 	void textures_keep_original(bool p_enable) {}
 
@@ -274,6 +286,7 @@ public:
 
 	bool material_is_animated(RID p_material) { return false; }
 	bool material_casts_shadows(RID p_material) { return false; }
+	void material_request_texture_size(RID p_material, int p_size) {}
 
 	void material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) {}
 	void material_remove_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) {}
@@ -303,6 +316,41 @@ public:
 		s->aabb = p_aabb;
 		s->blend_shapes = p_blend_shapes;
 		s->bone_aabbs = p_bone_aabbs;
+
+		if (Engine::get_singleton()->is_headless()) {
+			_strip_surface(s);
+		}
+	}
+
+	void _strip_surface(DummySurface *s) {
+
+		// only positions and indices are needed to build collision and navigation on a headless server
+		uint32_t keep = VS::ARRAY_FORMAT_VERTEX | VS::ARRAY_FORMAT_INDEX | VS::ARRAY_COMPRESS_VERTEX | VS::ARRAY_COMPRESS_INDEX | VS::ARRAY_FLAG_USE_2D_VERTICES;
+		uint32_t format = s->format & keep;
+
+		s->blend_shapes.clear();
+		s->bone_aabbs.clear();
+
+		if (format == s->format || !(s->format & VS::ARRAY_FORMAT_VERTEX))
+			return;
+
+		uint32_t offsets[VS::ARRAY_MAX];
+		int src_stride = VS::get_singleton()->mesh_surface_make_offsets_from_format(s->format, s->vertex_count, s->index_count, offsets);
+		int dst_stride = VS::get_singleton()->mesh_surface_make_offsets_from_format(format, s->vertex_count, s->index_count, offsets);
+
+		//position is always first in the interleaved vertex, so it just gets compacted
+		PoolVector<uint8_t> array;
+		array.resize(dst_stride * s->vertex_count);
+		{
+			PoolVector<uint8_t>::Read r = s->array.read();
+			PoolVector<uint8_t>::Write w = array.write();
+			for (int i = 0; i < s->vertex_count; i++) {
+				copymem(&w[i * dst_stride], &r[i * src_stride], dst_stride);
+			}
+		}
+
+		s->array = array;
+		s->format = format;
 	}
 
 	void mesh_set_blend_shape_count(RID p_mesh, int p_amount) {
@@ -459,6 +507,7 @@ public:
 	void skeleton_set_base_transform_2d(RID p_skeleton, const Transform2D &p_base_transform) {}
 	int skeleton_get_bone_count(RID p_skeleton) const { return 0; }
 	void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) {}
+	void skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms) {}
 	Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const { return Transform(); }
 	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) {}
 	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const { return Transform2D(); }
@@ -733,6 +782,10 @@ public:
 
 	void set_debug_generate_wireframes(bool p_generate) {}
 
+	void shader_variants_set_recording(bool p_enable) {}
+	Vector<String> shader_variants_get_recorded() { return Vector<String>(); }
+	void shader_variants_precompile(const Vector<String> &p_variants) {}
+
 	void render_info_begin_capture() {}
 	void render_info_end_capture() {}
 	int get_captured_render_info(VS::RenderInfo p_info) { return 0; }
@@ -751,6 +804,9 @@ public:
 	void light_internal_update(RID p_rid, Light *p_light) {}
 	void light_internal_free(RID p_rid) {}
 
+	PolygonID request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>()) { return 0; }
+	void free_polygon(PolygonID p_polygon) {}
+
 	void canvas_begin(){};
 	void canvas_end(){};
 
@@ -47,6 +47,14 @@ void RasterizerCanvasGLES2::light_internal_update(RID p_rid, Light *p_light) {
 void RasterizerCanvasGLES2::light_internal_free(RID p_rid) {
 }
 
+RasterizerCanvas::PolygonID RasterizerCanvasGLES2::request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights) {
+
+	return 0; // polygons are streamed from the command arrays
+}
+
+void RasterizerCanvasGLES2::free_polygon(PolygonID p_polygon) {
+}
+
 void RasterizerCanvasGLES2::_set_uniforms() {
 
 	state.canvas_shader.set_uniform(CanvasShaderGLES2::PROJECTION_MATRIX, state.uniforms.projection_matrix);
@@ -330,6 +338,168 @@ void RasterizerCanvasGLES2::_draw_gui_primitive(int p_points, const Vector2 *p_v
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+bool RasterizerCanvasGLES2::_batch_can_add(const RID &p_texture, const RID &p_normal_map, int p_vertex_count, int p_index_count) const {
+
+	if (state.batch_index_count == 0)
+		return true;
+
+	if (p_texture != state.batch_texture || p_normal_map != state.batch_normal_map)
+		return false;
+
+	int vertex_size = sizeof(Vector2) * 2 + sizeof(Color);
+
+	return (uint32_t)((state.batch_vertex_count + p_vertex_count) * vertex_size) <= data.polygon_buffer_size && (uint32_t)((state.batch_index_count + p_index_count) * sizeof(int)) <= data.polygon_index_buffer_size;
+}
+
+void RasterizerCanvasGLES2::_batch_add_rect(const Item::CommandRect *p_rect) {
+
+	if (state.batch_index_count == 0) {
+		state.batch_texture = p_rect->texture;
+		state.batch_normal_map = p_rect->normal_map;
+	}
+
+	RasterizerStorageGLES2::Texture *texture = storage->texture_owner.getornull(p_rect->texture);
+	if (texture) {
+		texture = texture->get_ptr();
+	}
+
+	// same as the texture rect path of the canvas shader, but on the CPU
+	Rect2 src_rect(0, 0, 1, 1);
+	bool transpose = false;
+
+	if (texture) {
+		Size2 texpixel_size(1.0 / texture->width, 1.0 / texture->height);
+
+		if (p_rect->flags & CANVAS_RECT_REGION) {
+			src_rect = Rect2(p_rect->source.position * texpixel_size, p_rect->source.size * texpixel_size);
+		}
+		if (p_rect->flags & CANVAS_RECT_FLIP_H) {
+			src_rect.size.x *= -1;
+		}
+		if (p_rect->flags & CANVAS_RECT_FLIP_V) {
+			src_rect.size.y *= -1;
+		}
+		transpose = p_rect->flags & CANVAS_RECT_TRANSPOSE;
+	}
+
+	Rect2 dst_rect = p_rect->rect.abs();
+
+	static const Vector2 corners[4] = {
+		Vector2(0, 0),
+		Vector2(0, 1),
+		Vector2(1, 1),
+		Vector2(1, 0)
+	};
+
+	int vofs = state.batch_vertex_count;
+	int iofs = state.batch_index_count;
+
+	if (state.batch_vertices.size() < vofs + 4) {
+		state.batch_vertices.resize(vofs + 4);
+		state.batch_uvs.resize(vofs + 4);
+		state.batch_colors.resize(vofs + 4);
+	}
+	if (state.batch_indices.size() < iofs + 6) {
+		state.batch_indices.resize(iofs + 6);
+	}
+
+	Vector2 *vertices = state.batch_vertices.ptrw();
+	Vector2 *uvs = state.batch_uvs.ptrw();
+	Color *colors = state.batch_colors.ptrw();
+	int *indices = state.batch_indices.ptrw();
+
+	for (int i = 0; i < 4; i++) {
+
+		Vector2 corner = corners[i];
+		Vector2 flipped(src_rect.size.x < 0 ? 1 - corner.x : corner.x, src_rect.size.y < 0 ? 1 - corner.y : corner.y);
+
+		vertices[vofs + i] = dst_rect.position + dst_rect.size * flipped;
+		uvs[vofs + i] = src_rect.position + src_rect.size.abs() * (transpose ? Vector2(corner.y, corner.x) : corner);
+		colors[vofs + i] = p_rect->modulate;
+	}
+
+	indices[iofs + 0] = vofs + 0;
+	indices[iofs + 1] = vofs + 1;
+	indices[iofs + 2] = vofs + 2;
+	indices[iofs + 3] = vofs + 2;
+	indices[iofs + 4] = vofs + 3;
+	indices[iofs + 5] = vofs + 0;
+
+	state.batch_vertex_count += 4;
+	state.batch_index_count += 6;
+}
+
+void RasterizerCanvasGLES2::_batch_add_polygon(const Item::CommandPolygon *p_polygon) {
+
+	if (state.batch_index_count == 0) {
+		state.batch_texture = p_polygon->texture;
+		state.batch_normal_map = p_polygon->normal_map;
+	}
+
+	int point_count = p_polygon->points.size();
+	int vofs = state.batch_vertex_count;
+	int iofs = state.batch_index_count;
+
+	if (state.batch_vertices.size() < vofs + point_count) {
+		state.batch_vertices.resize(vofs + point_count);
+		state.batch_uvs.resize(vofs + point_count);
+		state.batch_colors.resize(vofs + point_count);
+	}
+	if (state.batch_indices.size() < iofs + p_polygon->count) {
+		state.batch_indices.resize(iofs + p_polygon->count);
+	}
+
+	Vector2 *vertices = state.batch_vertices.ptrw();
+	Vector2 *uvs = state.batch_uvs.ptrw();
+	Color *colors = state.batch_colors.ptrw();
+	int *indices = state.batch_indices.ptrw();
+
+	const Vector2 *points = p_polygon->points.ptr();
+	const Vector2 *src_uvs = p_polygon->uvs.size() == point_count ? p_polygon->uvs.ptr() : NULL;
+	const Color *src_colors = p_polygon->colors.ptr();
+	int color_count = p_polygon->colors.size();
+
+	for (int i = 0; i < point_count; i++) {
+		vertices[vofs + i] = points[i];
+		uvs[vofs + i] = src_uvs ? src_uvs[i] : Vector2();
+		colors[vofs + i] = color_count == point_count ? src_colors[i] : (color_count ? src_colors[0] : Color(1, 1, 1, 1));
+	}
+
+	const int *src_indices = p_polygon->indices.ptr();
+	for (int i = 0; i < p_polygon->count; i++) {
+		indices[iofs + i] = vofs + src_indices[i];
+	}
+
+	state.batch_vertex_count += point_count;
+	state.batch_index_count += p_polygon->count;
+}
+
+void RasterizerCanvasGLES2::_batch_flush(RasterizerStorageGLES2::Material *p_material) {
+
+	if (state.batch_index_count == 0)
+		return;
+
+	state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_TEXTURE_RECT, false);
+	state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_UV_ATTRIBUTE, true);
+
+	if (state.canvas_shader.bind()) {
+		_set_uniforms();
+		state.canvas_shader.use_material((void *)p_material);
+	}
+
+	RasterizerStorageGLES2::Texture *texture = _bind_canvas_texture(state.batch_texture, state.batch_normal_map);
+
+	if (texture) {
+		Size2 texpixel_size(1.0 / texture->width, 1.0 / texture->height);
+		state.canvas_shader.set_uniform(CanvasShaderGLES2::COLOR_TEXPIXEL_SIZE, texpixel_size);
+	}
+
+	_draw_polygon(state.batch_indices.ptr(), state.batch_index_count, state.batch_vertex_count, state.batch_vertices.ptr(), state.batch_uvs.ptr(), state.batch_colors.ptr(), false);
+
+	state.batch_vertex_count = 0;
+	state.batch_index_count = 0;
+}
+
 void RasterizerCanvasGLES2::_canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, RasterizerStorageGLES2::Material *p_material) {
 
 	int command_count = p_item->commands.size();
@@ -339,6 +509,37 @@ void RasterizerCanvasGLES2::_canvas_item_render_commands(Item *p_item, Item *cur
 
 		Item::Command *command = commands[i];
 
+		if (state.use_batching) {
+
+			if (command->type == Item::Command::TYPE_RECT) {
+
+				Item::CommandRect *r = static_cast<Item::CommandRect *>(command);
+
+				// tiled rects need the wrap mode changed on the texture, keep them on their own
+				if (!(r->flags & CANVAS_RECT_TILE)) {
+					if (!_batch_can_add(r->texture, r->normal_map, 4, 6)) {
+						_batch_flush(p_material);
+					}
+					_batch_add_rect(r);
+					continue;
+				}
+
+			} else if (command->type == Item::Command::TYPE_POLYGON) {
+
+				Item::CommandPolygon *polygon = static_cast<Item::CommandPolygon *>(command);
+
+				if (!_batch_can_add(polygon->texture, polygon->normal_map, polygon->points.size(), polygon->count)) {
+					_batch_flush(p_material);
+				}
+				if (_batch_can_add(polygon->texture, polygon->normal_map, polygon->points.size(), polygon->count)) {
+					_batch_add_polygon(polygon);
+					continue;
+				}
+			}
+
+			_batch_flush(p_material);
+		}
+
 		switch (command->type) {
 
 			case Item::Command::TYPE_LINE: {
@@ -792,6 +993,8 @@ void RasterizerCanvasGLES2::_canvas_item_render_commands(Item *p_item, Item *cur
 			} break;
 		}
 	}
+
+	_batch_flush(p_material);
 }
 
 void RasterizerCanvasGLES2::_copy_texscreen(const Rect2 &p_rect) {
@@ -1088,8 +1291,14 @@ void RasterizerCanvasGLES2::initialize() {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.polygon_index_buffer);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size, NULL, GL_DYNAMIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+		data.polygon_index_buffer_size = index_size;
 	}
 
+	state.use_batching = GLOBAL_DEF("rendering/quality/2d/use_batching", true);
+	state.batch_vertex_count = 0;
+	state.batch_index_count = 0;
+
 	// ninepatch buffers
 	{
 		// array buffer
@@ -59,6 +59,7 @@ public:
 		GLuint polygon_index_buffer;
 
 		uint32_t polygon_buffer_size;
+		uint32_t polygon_index_buffer_size;
 
 		GLuint ninepatch_vertices;
 		GLuint ninepatch_elements;
@@ -80,6 +81,17 @@ public:
 
 		Transform vp;
 
+		// rects and polygons sharing a texture are collected here and drawn in a single call
+		bool use_batching;
+		RID batch_texture;
+		RID batch_normal_map;
+		Vector<Vector2> batch_vertices;
+		Vector<Vector2> batch_uvs;
+		Vector<Color> batch_colors;
+		Vector<int> batch_indices;
+		int batch_vertex_count;
+		int batch_index_count;
+
 	} state;
 
 	typedef void Texture;
@@ -92,6 +104,9 @@ public:
 	virtual void light_internal_update(RID p_rid, Light *p_light);
 	virtual void light_internal_free(RID p_rid);
 
+	virtual PolygonID request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>());
+	virtual void free_polygon(PolygonID p_polygon);
+
 	void _set_uniforms();
 
 	virtual void canvas_begin();
@@ -103,6 +118,11 @@ public:
 	_FORCE_INLINE_ void _draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 	_FORCE_INLINE_ void _draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 
+	_FORCE_INLINE_ bool _batch_can_add(const RID &p_texture, const RID &p_normal_map, int p_vertex_count, int p_index_count) const;
+	_FORCE_INLINE_ void _batch_add_rect(const Item::CommandRect *p_rect);
+	_FORCE_INLINE_ void _batch_add_polygon(const Item::CommandPolygon *p_polygon);
+	_FORCE_INLINE_ void _batch_flush(RasterizerStorageGLES2::Material *p_material);
+
 	_FORCE_INLINE_ void _canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, RasterizerStorageGLES2::Material *p_material);
 	_FORCE_INLINE_ void _copy_texscreen(const Rect2 &p_rect);
 
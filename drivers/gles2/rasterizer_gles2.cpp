@@ -295,6 +295,27 @@ void RasterizerGLES2::clear_render_target(const Color &p_color) {
 	storage->frame.clear_request_color = p_color;
 }
 
+bool RasterizerGLES2::clear_render_target_rect(const Rect2 &p_rect, const Color &p_color) {
+
+	ERR_FAIL_COND_V(!storage->frame.current_rt, false);
+
+	RasterizerStorageGLES2::RenderTarget *rt = storage->frame.current_rt;
+	storage->frame.clear_request = false;
+
+	int y = rt->height - (p_rect.position.y + p_rect.size.y);
+	if (rt->flags[RasterizerStorage::RENDER_TARGET_VFLIP])
+		y = p_rect.position.y;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, rt->fbo);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(p_rect.position.x, y, p_rect.size.x, p_rect.size.y);
+	glClearColor(p_color.r, p_color.g, p_color.b, p_color.a);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+
+	return true;
+}
+
 void RasterizerGLES2::set_boot_image(const Ref<Image> &p_image, const Color &p_color, bool p_scale) {
 
 	if (p_image.is_null() || p_image->empty())
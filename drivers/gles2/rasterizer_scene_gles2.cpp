@@ -551,6 +551,11 @@ void RasterizerSceneGLES2::environment_set_ssao(RID p_env, bool p_enable, float
 	ERR_FAIL_COND(!env);
 }
 
+void RasterizerSceneGLES2::environment_set_ssao_resolution(RID p_env, VS::EnvironmentSSAOResolution p_resolution) {
+	Environment *env = environment_owner.getornull(p_env);
+	ERR_FAIL_COND(!env);
+}
+
 void RasterizerSceneGLES2::environment_set_tonemap(RID p_env, VS::EnvironmentToneMapper p_tone_mapper, float p_exposure, float p_white, bool p_auto_exposure, float p_min_luminance, float p_max_luminance, float p_auto_exp_speed, float p_auto_exp_scale) {
 	Environment *env = environment_owner.getornull(p_env);
 	ERR_FAIL_COND(!env);
@@ -902,6 +907,28 @@ void RasterizerSceneGLES2::_setup_material(RasterizerStorageGLES2::Material *p_m
 	state.scene_shader.use_material((void *)p_material);
 }
 
+void RasterizerSceneGLES2::_setup_vertex_decode(RasterizerStorageGLES2::Geometry *p_geometry) {
+
+	uint32_t format = 0;
+	AABB aabb;
+
+	if (p_geometry->type == RasterizerStorageGLES2::Geometry::GEOMETRY_SURFACE) {
+		RasterizerStorageGLES2::Surface *s = static_cast<RasterizerStorageGLES2::Surface *>(p_geometry);
+		format = s->format;
+		aabb = s->aabb;
+	}
+
+	if ((format & VS::ARRAY_COMPRESS_VERTEX) && (format & VS::ARRAY_FLAG_USE_QUANTIZED_VERTICES)) {
+		state.scene_shader.set_uniform(SceneShaderGLES2::VERTEX_DECODE_OFFSET, aabb.position);
+		state.scene_shader.set_uniform(SceneShaderGLES2::VERTEX_DECODE_SCALE, aabb.size);
+	} else {
+		state.scene_shader.set_uniform(SceneShaderGLES2::VERTEX_DECODE_OFFSET, Vector3());
+		state.scene_shader.set_uniform(SceneShaderGLES2::VERTEX_DECODE_SCALE, Vector3(1, 1, 1));
+	}
+
+	state.scene_shader.set_uniform(SceneShaderGLES2::OCTAHEDRAL_COMPRESSION, (format & VS::ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION) ? 1.0 : 0.0);
+}
+
 void RasterizerSceneGLES2::_setup_geometry(RenderList::Element *p_element, RasterizerStorageGLES2::Skeleton *p_skeleton) {
 
 	state.scene_shader.set_conditional(SceneShaderGLES2::USE_SKELETON, p_skeleton != NULL);
@@ -1267,6 +1294,85 @@ void RasterizerSceneGLES2::_render_geometry(RenderList::Element *p_element) {
 	}
 }
 
+bool RasterizerSceneGLES2::_light_uses_single_pass(LightInstance *p_light, ShadowAtlas *p_shadow_atlas) const {
+
+	RasterizerStorageGLES2::Light *light_ptr = p_light->light_ptr;
+
+	if (!light_ptr->shadow) {
+		return true;
+	}
+
+	// shadowed lights keep their own pass, as each of them needs its own shadow lookup
+	if (light_ptr->type == VS::LIGHT_DIRECTIONAL) {
+		return !directional_shadow.depth;
+	}
+
+	return !p_shadow_atlas || !p_shadow_atlas->shadow_owners.has(p_light->self);
+}
+
+void RasterizerSceneGLES2::_setup_light_arrays(LightInstance **p_lights, int p_light_count, const Transform &p_view_inverse) {
+
+	GLfloat position_range[MAX_LIGHTS_PER_PASS * 4];
+	GLfloat direction_type[MAX_LIGHTS_PER_PASS * 4];
+	GLfloat color_specular[MAX_LIGHTS_PER_PASS * 4];
+	GLfloat attenuation[MAX_LIGHTS_PER_PASS * 4];
+
+	for (int i = 0; i < p_light_count; i++) {
+
+		LightInstance *light = p_lights[i];
+		RasterizerStorageGLES2::Light *light_ptr = light->light_ptr;
+
+		Vector3 position = p_view_inverse.xform(light->transform.origin);
+		Vector3 direction = p_view_inverse.basis.xform(light->transform.basis.xform(Vector3(0, 0, -1))).normalized();
+
+		float energy = light_ptr->param[VS::LIGHT_PARAM_ENERGY];
+		Color color = light_ptr->color.to_linear();
+		float type = 0.0;
+
+		switch (light_ptr->type) {
+			case VS::LIGHT_DIRECTIONAL: {
+				// same scale as the color uploaded by the directional pass
+				float sign = light_ptr->negative ? -1 : 1;
+				for (int c = 0; c < 3; c++)
+					color[c] *= sign * energy * Math_PI;
+			} break;
+			case VS::LIGHT_OMNI: {
+				type = 1.0;
+			} break;
+			case VS::LIGHT_SPOT: {
+				type = 2.0;
+			} break;
+		}
+
+		position_range[i * 4 + 0] = position.x;
+		position_range[i * 4 + 1] = position.y;
+		position_range[i * 4 + 2] = position.z;
+		position_range[i * 4 + 3] = light_ptr->param[VS::LIGHT_PARAM_RANGE];
+
+		direction_type[i * 4 + 0] = direction.x;
+		direction_type[i * 4 + 1] = direction.y;
+		direction_type[i * 4 + 2] = direction.z;
+		direction_type[i * 4 + 3] = type;
+
+		color_specular[i * 4 + 0] = color.r * energy;
+		color_specular[i * 4 + 1] = color.g * energy;
+		color_specular[i * 4 + 2] = color.b * energy;
+		color_specular[i * 4 + 3] = light_ptr->param[VS::LIGHT_PARAM_SPECULAR];
+
+		attenuation[i * 4 + 0] = light_ptr->param[VS::LIGHT_PARAM_ATTENUATION];
+		attenuation[i * 4 + 1] = light_ptr->param[VS::LIGHT_PARAM_SPOT_ATTENUATION];
+		attenuation[i * 4 + 2] = Math::cos(Math::deg2rad(light_ptr->param[VS::LIGHT_PARAM_SPOT_ANGLE]));
+		attenuation[i * 4 + 3] = 0.0;
+	}
+
+	state.scene_shader.set_uniform(SceneShaderGLES2::LIGHT_ARRAY_COUNT, p_light_count);
+
+	glUniform4fv(state.scene_shader.get_uniform(SceneShaderGLES2::LIGHT_ARRAY_POSITION_RANGE), p_light_count, position_range);
+	glUniform4fv(state.scene_shader.get_uniform(SceneShaderGLES2::LIGHT_ARRAY_DIRECTION_TYPE), p_light_count, direction_type);
+	glUniform4fv(state.scene_shader.get_uniform(SceneShaderGLES2::LIGHT_ARRAY_COLOR_SPECULAR), p_light_count, color_specular);
+	glUniform4fv(state.scene_shader.get_uniform(SceneShaderGLES2::LIGHT_ARRAY_ATTENUATION), p_light_count, attenuation);
+}
+
 void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements, int p_element_count, const RID *p_directional_lights, int p_directional_light_count, const Transform &p_view_transform, const CameraMatrix &p_projection, RID p_shadow_atlas, Environment *p_env, GLuint p_base_env, float p_shadow_bias, float p_shadow_normal_bias, bool p_reverse_cull, bool p_alpha_pass, bool p_shadow, bool p_directional_add) {
 
 	ShadowAtlas *shadow_atlas = shadow_atlas_owner.getornull(p_shadow_atlas);
@@ -1278,6 +1384,7 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 	bool use_radiance_map = false;
 
 	VMap<RID, Vector<RenderList::Element *> > lit_objects;
+	Vector<RenderList::Element *> single_pass_objects;
 
 	for (int i = 0; i < p_element_count; i++) {
 		RenderList::Element *e = p_elements[i];
@@ -1390,6 +1497,7 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 
 		state.scene_shader.set_uniform(SceneShaderGLES2::SCREEN_PIXEL_SIZE, screen_pixel_size);
 		state.scene_shader.set_uniform(SceneShaderGLES2::NORMAL_MULT, 1.0); // TODO mirror?
+		_setup_vertex_decode(e->geometry);
 		state.scene_shader.set_uniform(SceneShaderGLES2::WORLD_TRANSFORM, e->instance->transform);
 
 		_render_geometry(e);
@@ -1400,10 +1508,20 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 		if (p_shadow)
 			continue;
 
+		bool single_pass = material->shader->spatial.uses_single_pass_lights;
+
+		if (single_pass) {
+			single_pass_objects.push_back(e);
+		}
+
 		for (int light = 0; light < e->instance->light_instances.size(); light++) {
 
 			RID light_instance = e->instance->light_instances[light];
 
+			if (single_pass && _light_uses_single_pass(light_instance_owner.getornull(light_instance), shadow_atlas)) {
+				continue; // shaded together with the other unshadowed lights below
+			}
+
 			lit_objects[light_instance].push_back(e);
 		}
 	}
@@ -1456,6 +1574,7 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 
 				state.scene_shader.set_uniform(SceneShaderGLES2::SCREEN_PIXEL_SIZE, screen_pixel_size);
 				state.scene_shader.set_uniform(SceneShaderGLES2::NORMAL_MULT, 1.0); // TODO mirror?
+				_setup_vertex_decode(e->geometry);
 				state.scene_shader.set_uniform(SceneShaderGLES2::WORLD_TRANSFORM, e->instance->transform);
 			}
 
@@ -1602,6 +1721,78 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 		}
 	}
 
+	if (single_pass_objects.size()) {
+
+		state.scene_shader.set_conditional(SceneShaderGLES2::USE_LIGHT_ARRAYS, true);
+
+		Transform view_inverse = p_view_transform.inverse();
+
+		for (int i = 0; i < single_pass_objects.size(); i++) {
+
+			RenderList::Element *e = single_pass_objects[i];
+			RasterizerStorageGLES2::Material *material = e->material;
+
+			RasterizerStorageGLES2::Skeleton *skeleton = storage->skeleton_owner.getornull(e->instance->skeleton);
+
+			// directional lights first, then the omni and spot lights affecting this instance
+			int total_light_count = p_directional_light_count + e->instance->light_instances.size();
+
+			LightInstance *lights[MAX_LIGHTS_PER_PASS];
+			int light_count = 0;
+			bool setup = false;
+
+			// one extra iteration flushes the lights left over at the end of the list
+			for (int j = 0; j <= total_light_count; j++) {
+
+				if (j < total_light_count) {
+
+					RID light_rid = j < p_directional_light_count ? p_directional_lights[j] : e->instance->light_instances[j - p_directional_light_count];
+					LightInstance *light = light_instance_owner.getornull(light_rid);
+
+					if (!_light_uses_single_pass(light, shadow_atlas)) {
+						continue;
+					}
+
+					lights[light_count++] = light;
+
+					if (light_count < MAX_LIGHTS_PER_PASS) {
+						continue;
+					}
+				} else if (!light_count) {
+					break;
+				}
+
+				if (!setup) {
+					_setup_geometry(e, skeleton);
+
+					_setup_material(material, p_reverse_cull, Size2i(skeleton ? skeleton->size * 3 : 0, 0));
+
+					state.scene_shader.set_uniform(SceneShaderGLES2::CAMERA_MATRIX, view_inverse);
+					state.scene_shader.set_uniform(SceneShaderGLES2::CAMERA_INVERSE_MATRIX, p_view_transform);
+					state.scene_shader.set_uniform(SceneShaderGLES2::PROJECTION_MATRIX, p_projection);
+					state.scene_shader.set_uniform(SceneShaderGLES2::PROJECTION_INVERSE_MATRIX, p_projection.inverse());
+
+					state.scene_shader.set_uniform(SceneShaderGLES2::TIME, storage->frame.time[0]);
+
+					state.scene_shader.set_uniform(SceneShaderGLES2::SCREEN_PIXEL_SIZE, screen_pixel_size);
+					state.scene_shader.set_uniform(SceneShaderGLES2::NORMAL_MULT, 1.0); // TODO mirror?
+					_setup_vertex_decode(e->geometry);
+					state.scene_shader.set_uniform(SceneShaderGLES2::WORLD_TRANSFORM, e->instance->transform);
+
+					setup = true;
+				}
+
+				_setup_light_arrays(lights, light_count, view_inverse);
+
+				_render_geometry(e);
+
+				light_count = 0;
+			}
+		}
+
+		state.scene_shader.set_conditional(SceneShaderGLES2::USE_LIGHT_ARRAYS, false);
+	}
+
 	for (int dl = 0; dl < p_directional_light_count; dl++) {
 		RID light_rid = p_directional_lights[dl];
 		LightInstance *light = light_instance_owner.getornull(light_rid);
@@ -1629,6 +1820,10 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 			RasterizerStorageGLES2::Material *material = e->material;
 			RasterizerStorageGLES2::Skeleton *skeleton = storage->skeleton_owner.getornull(e->instance->skeleton);
 
+			if (material->shader->spatial.uses_single_pass_lights && _light_uses_single_pass(light, shadow_atlas)) {
+				continue; // already shaded in the single pass
+			}
+
 			{
 				_setup_material(material, p_reverse_cull, Size2i(skeleton ? skeleton->size * 3 : 0, 0));
 
@@ -1646,6 +1841,7 @@ void RasterizerSceneGLES2::_render_render_list(RenderList::Element **p_elements,
 
 				state.scene_shader.set_uniform(SceneShaderGLES2::SCREEN_PIXEL_SIZE, screen_pixel_size);
 				state.scene_shader.set_uniform(SceneShaderGLES2::NORMAL_MULT, 1.0); // TODO mirror?
+				_setup_vertex_decode(e->geometry);
 				state.scene_shader.set_uniform(SceneShaderGLES2::WORLD_TRANSFORM, e->instance->transform);
 			}
 			state.scene_shader.set_uniform(SceneShaderGLES2::LIGHT_TYPE, (int)0);
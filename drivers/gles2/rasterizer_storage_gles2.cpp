@@ -827,6 +827,14 @@ void RasterizerStorageGLES2::texture_set_detect_normal_callback(RID p_texture, V
 	texture->detect_normal_ud = p_userdata;
 }
 
+void RasterizerStorageGLES2::texture_set_stream_request_callback(RID p_texture, VisualServer::TextureStreamRequestCallback p_callback, void *p_userdata) {
+	Texture *texture = texture_owner.get(p_texture);
+	ERR_FAIL_COND(!texture);
+
+	texture->stream_request = p_callback;
+	texture->stream_request_ud = p_userdata;
+}
+
 RID RasterizerStorageGLES2::texture_create_radiance_cubemap(RID p_source, int p_resolution) const {
 
 	return RID();
@@ -1099,6 +1107,7 @@ void RasterizerStorageGLES2::_update_shader(Shader *p_shader) const {
 			p_shader->spatial.uses_vertex = false;
 			p_shader->spatial.writes_modelview_or_projection = false;
 			p_shader->spatial.uses_world_coordinates = false;
+			p_shader->spatial.uses_single_pass_lights = false;
 
 			shaders.actions_scene.render_mode_values["blend_add"] = Pair<int *, int>(&p_shader->spatial.blend_mode, Shader::Spatial::BLEND_MODE_ADD);
 			shaders.actions_scene.render_mode_values["blend_mix"] = Pair<int *, int>(&p_shader->spatial.blend_mode, Shader::Spatial::BLEND_MODE_MIX);
@@ -1121,6 +1130,8 @@ void RasterizerStorageGLES2::_update_shader(Shader *p_shader) const {
 
 			shaders.actions_scene.render_mode_flags["world_vertex_coords"] = &p_shader->spatial.uses_world_coordinates;
 
+			shaders.actions_scene.render_mode_flags["lights_single_pass"] = &p_shader->spatial.uses_single_pass_lights;
+
 			shaders.actions_scene.usage_flag_pointers["ALPHA"] = &p_shader->spatial.uses_alpha;
 			shaders.actions_scene.usage_flag_pointers["ALPHA_SCISSOR"] = &p_shader->spatial.uses_alpha_scissor;
 
@@ -1446,6 +1457,27 @@ bool RasterizerStorageGLES2::material_casts_shadows(RID p_material) {
 	return casts_shadows;
 }
 
+void RasterizerStorageGLES2::material_request_texture_size(RID p_material, int p_size) {
+
+	Material *material = material_owner.getornull(p_material);
+	ERR_FAIL_COND(!material);
+	if (material->dirty_list.in_list()) {
+		_update_material(material);
+	}
+
+	for (int i = 0; i < material->textures.size(); i++) {
+
+		Texture *texture = texture_owner.getornull(material->textures[i].second);
+		if (texture && texture->stream_request) {
+			texture->stream_request(texture->stream_request_ud, p_size);
+		}
+	}
+
+	if (material->next_pass.is_valid()) {
+		material_request_texture_size(material->next_pass, p_size);
+	}
+}
+
 void RasterizerStorageGLES2::material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) {
 
 	Material *material = material_owner.getornull(p_material);
@@ -1654,7 +1686,14 @@ void RasterizerStorageGLES2::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 					attribs[i].size = (p_format & VS::ARRAY_COMPRESS_VERTEX) ? 4 : 3;
 				}
 
-				if (p_format & VS::ARRAY_COMPRESS_VERTEX) {
+				attribs[i].normalized = GL_FALSE;
+
+				if ((p_format & VS::ARRAY_COMPRESS_VERTEX) && (p_format & VS::ARRAY_FLAG_USE_QUANTIZED_VERTICES)) {
+					//relative to the surface AABB, decoded in the shader
+					attribs[i].type = GL_UNSIGNED_SHORT;
+					attribs[i].normalized = GL_TRUE;
+					stride += attribs[i].size * 2;
+				} else if (p_format & VS::ARRAY_COMPRESS_VERTEX) {
 					attribs[i].type = _GL_HALF_FLOAT_OES;
 					stride += attribs[i].size * 2;
 				} else {
@@ -1662,14 +1701,17 @@ void RasterizerStorageGLES2::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 					stride += attribs[i].size * 4;
 				}
 
-				attribs[i].normalized = GL_FALSE;
-
 			} break;
 			case VS::ARRAY_NORMAL: {
 
 				attribs[i].size = 3;
 
-				if (p_format & VS::ARRAY_COMPRESS_NORMAL) {
+				if ((p_format & VS::ARRAY_COMPRESS_NORMAL) && (p_format & VS::ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+					attribs[i].size = 2;
+					attribs[i].type = GL_SHORT;
+					stride += 4;
+					attribs[i].normalized = GL_TRUE;
+				} else if (p_format & VS::ARRAY_COMPRESS_NORMAL) {
 					attribs[i].type = GL_BYTE;
 					stride += 4; //pad extra byte
 					attribs[i].normalized = GL_TRUE;
@@ -1684,7 +1726,12 @@ void RasterizerStorageGLES2::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 
 				attribs[i].size = 4;
 
-				if (p_format & VS::ARRAY_COMPRESS_TANGENT) {
+				if ((p_format & VS::ARRAY_COMPRESS_TANGENT) && (p_format & VS::ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+					attribs[i].size = 2;
+					attribs[i].type = GL_SHORT;
+					stride += 4;
+					attribs[i].normalized = GL_TRUE;
+				} else if (p_format & VS::ARRAY_COMPRESS_TANGENT) {
 					attribs[i].type = GL_BYTE;
 					stride += 4;
 					attribs[i].normalized = GL_TRUE;
@@ -1728,15 +1775,19 @@ void RasterizerStorageGLES2::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 			case VS::ARRAY_TEX_UV2: {
 
 				attribs[i].size = 2;
+				attribs[i].normalized = GL_FALSE;
 
-				if (p_format & VS::ARRAY_COMPRESS_TEX_UV2) {
+				if ((p_format & VS::ARRAY_COMPRESS_TEX_UV2) && (p_format & VS::ARRAY_FLAG_USE_16_BIT_TEX_UV2)) {
+					attribs[i].type = GL_UNSIGNED_SHORT;
+					attribs[i].normalized = GL_TRUE;
+					stride += 4;
+				} else if (p_format & VS::ARRAY_COMPRESS_TEX_UV2) {
 					attribs[i].type = _GL_HALF_FLOAT_OES;
 					stride += 4;
 				} else {
 					attribs[i].type = GL_FLOAT;
 					stride += 8;
 				}
-				attribs[i].normalized = GL_FALSE;
 
 			} break;
 			case VS::ARRAY_BONES: {
@@ -2803,6 +2854,21 @@ void RasterizerStorageGLES2::skeleton_bone_set_transform(RID p_skeleton, int p_b
 	}
 }
 
+void RasterizerStorageGLES2::skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms) {
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+	ERR_FAIL_COND(!skeleton);
+
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_transforms.size() != skeleton->size * 12);
+
+	PoolVector<float>::Read r = p_transforms.read();
+	copymem(skeleton->bone_data.ptrw(), r.ptr(), skeleton->size * 12 * sizeof(float));
+
+	if (!skeleton->update_list.in_list()) {
+		skeleton_update_list.add(&skeleton->update_list);
+	}
+}
+
 Transform RasterizerStorageGLES2::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
 	ERR_FAIL_COND_V(!skeleton, Transform());
@@ -3925,6 +3991,16 @@ bool RasterizerStorageGLES2::has_os_feature(const String &p_feature) const {
 void RasterizerStorageGLES2::set_debug_generate_wireframes(bool p_generate) {
 }
 
+void RasterizerStorageGLES2::shader_variants_set_recording(bool p_enable) {
+}
+
+Vector<String> RasterizerStorageGLES2::shader_variants_get_recorded() {
+	return Vector<String>();
+}
+
+void RasterizerStorageGLES2::shader_variants_precompile(const Vector<String> &p_variants) {
+}
+
 void RasterizerStorageGLES2::render_info_begin_capture() {
 }
 
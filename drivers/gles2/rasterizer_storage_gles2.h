@@ -271,6 +271,9 @@ public:
 		VisualServer::TextureDetectCallback detect_normal;
 		void *detect_normal_ud;
 
+		VisualServer::TextureStreamRequestCallback stream_request;
+		void *stream_request_ud;
+
 		Texture() {
 			flags = 0;
 			width = 0;
@@ -295,6 +298,9 @@ public:
 
 			proxy = NULL;
 
+			stream_request = NULL;
+			stream_request_ud = NULL;
+
 			render_target = NULL;
 
 			redraw_if_visible = false;
@@ -358,6 +364,7 @@ public:
 	virtual void texture_set_detect_3d_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata);
 	virtual void texture_set_detect_srgb_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata);
 	virtual void texture_set_detect_normal_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata);
+	virtual void texture_set_stream_request_callback(RID p_texture, VisualServer::TextureStreamRequestCallback p_callback, void *p_userdata);
 
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable);
 
@@ -473,6 +480,7 @@ public:
 			bool writes_modelview_or_projection;
 			bool uses_vertex_lighting;
 			bool uses_world_coordinates;
+			bool uses_single_pass_lights;
 
 		} spatial;
 
@@ -568,6 +576,7 @@ public:
 
 	virtual bool material_is_animated(RID p_material);
 	virtual bool material_casts_shadows(RID p_material);
+	virtual void material_request_texture_size(RID p_material, int p_size);
 
 	virtual void material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance);
 	virtual void material_remove_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance);
@@ -846,6 +855,7 @@ public:
 	virtual void skeleton_allocate(RID p_skeleton, int p_bones, bool p_2d_skeleton = false);
 	virtual int skeleton_get_bone_count(RID p_skeleton) const;
 	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform);
+	virtual void skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms);
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform);
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const;
@@ -1152,6 +1162,10 @@ public:
 
 	virtual void set_debug_generate_wireframes(bool p_generate);
 
+	virtual void shader_variants_set_recording(bool p_enable);
+	virtual Vector<String> shader_variants_get_recorded();
+	virtual void shader_variants_precompile(const Vector<String> &p_variants);
+
 	virtual void render_info_begin_capture();
 	virtual void render_info_end_capture();
 	virtual int get_captured_render_info(VS::RenderInfo p_info);
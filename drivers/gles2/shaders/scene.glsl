@@ -83,6 +83,19 @@ uniform highp float time;
 
 uniform float normal_mult;
 
+// quantized vertices are relative to the surface AABB, otherwise offset is zero and scale one
+uniform highp vec3 vertex_decode_offset;
+uniform highp vec3 vertex_decode_scale;
+// 1.0 when compressed normals and tangents are octahedral
+uniform float octahedral_compression;
+
+vec3 oct_to_vec3(vec2 e) {
+	vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.xy += t * -sign(v.xy);
+	return normalize(v);
+}
+
 #ifdef RENDER_DEPTH
 uniform float light_bias;
 uniform float light_normal_bias;
@@ -119,6 +132,7 @@ VERTEX_SHADER_GLOBALS
 void main() {
 
 	highp vec4 vertex = vertex_attrib;
+	vertex.xyz = vertex.xyz * vertex_decode_scale + vertex_decode_offset;
 
 	mat4 world_matrix = world_transform;
 
@@ -132,12 +146,21 @@ void main() {
 	}
 #endif
 
-	vec3 normal = normal_attrib * normal_mult;
+	vec3 normal = octahedral_compression > 0.5 ? oct_to_vec3(normal_attrib.xy) : normal_attrib;
+	normal *= normal_mult;
 
 #if defined(ENABLE_TANGENT_INTERP) || defined(ENABLE_NORMALMAP)
-	vec3 tangent = tangent_attrib.xyz;
+	vec3 tangent;
+	float binormalf;
+	if (octahedral_compression > 0.5) {
+		//the binormal direction is the sign of y
+		tangent = oct_to_vec3(vec2(tangent_attrib.x, abs(tangent_attrib.y) * 2.0 - 1.0));
+		binormalf = sign(tangent_attrib.y);
+	} else {
+		tangent = tangent_attrib.xyz;
+		binormalf = tangent_attrib.a;
+	}
 	tangent *= normal_mult;
-	float binormalf = tangent_attrib.a;
 	vec3 binormal = normalize(cross(normal, tangent) * binormalf);
 #endif
 
@@ -360,6 +383,25 @@ uniform mat4 light_shadow_matrix1;
 uniform mat4 light_shadow_matrix2;
 uniform mat4 light_shadow_matrix3;
 uniform mat4 light_shadow_matrix4;
+
+#ifdef USE_LIGHT_ARRAYS
+
+// must match RasterizerSceneGLES2::MAX_LIGHTS_PER_PASS
+#define MAX_LIGHTS_PER_PASS 4
+
+// unshadowed lights shaded together in a single pass
+uniform int light_array_count;
+
+// xyz: position (view space), w: range
+uniform vec4 light_array_position_range[MAX_LIGHTS_PER_PASS];
+// xyz: direction (view space), w: light type
+uniform vec4 light_array_direction_type[MAX_LIGHTS_PER_PASS];
+// rgb: color multiplied by energy, a: specular
+uniform vec4 light_array_color_specular[MAX_LIGHTS_PER_PASS];
+// x: attenuation, y: spot attenuation, z: cosine of the spot angle
+uniform vec4 light_array_attenuation[MAX_LIGHTS_PER_PASS];
+
+#endif
 #endif
 
 
@@ -556,6 +598,64 @@ FRAGMENT_SHADER_CODE
 //
 #ifdef LIGHT_PASS
 
+#ifdef USE_LIGHT_ARRAYS
+
+	for (int i = 0; i < MAX_LIGHTS_PER_PASS; i++) {
+
+		if (i >= light_array_count) {
+			break;
+		}
+
+		vec4 position_range = light_array_position_range[i];
+		vec4 direction_type = light_array_direction_type[i];
+		vec4 light_params = light_array_attenuation[i];
+
+		vec3 light_vec;
+		vec3 attenuation = vec3(1.0);
+
+		if (direction_type.w < 0.5) {
+			// directional
+			light_vec = -direction_type.xyz;
+		} else {
+			light_vec = position_range.xyz - vertex;
+
+			float normalized_distance = length(light_vec) / position_range.w;
+			attenuation *= pow(max(1.0 - normalized_distance, 0.0), light_params.x);
+
+			if (direction_type.w > 1.5) {
+				// spot
+				float spot_cutoff = light_params.z;
+
+				float scos = max(dot(-normalize(light_vec), direction_type.xyz), spot_cutoff);
+				float spot_rim = max(0.0001, (1.0 - scos) / (1.0 - spot_cutoff));
+
+				attenuation *= 1.0 - pow(spot_rim, light_params.y);
+			}
+		}
+
+		light_compute(normal,
+		              normalize(light_vec),
+		              eye_position,
+		              binormal,
+		              tangent,
+		              light_array_color_specular[i].rgb,
+		              attenuation,
+		              albedo,
+		              transmission,
+		              specular * light_array_color_specular[i].a,
+		              roughness,
+		              metallic,
+		              rim,
+		              rim_tint,
+		              clearcoat,
+		              clearcoat_gloss,
+		              anisotropy,
+		              diffuse_light,
+		              specular_light);
+	}
+
+#else
+
 	if (light_type == LIGHT_TYPE_OMNI) {
 		vec3 light_vec = light_position - vertex;
 		float light_length = length(light_vec);
@@ -809,6 +909,8 @@ FRAGMENT_SHADER_CODE
 		              specular_light);
 	}
 
+#endif // USE_LIGHT_ARRAYS
+
 	gl_FragColor = vec4(ambient_light + diffuse_light + specular_light, alpha);
 #else
 
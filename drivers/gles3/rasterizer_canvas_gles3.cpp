@@ -140,6 +140,100 @@ void RasterizerCanvasGLES3::light_internal_free(RID p_rid) {
 	memdelete(li);
 }
 
+RasterizerCanvas::PolygonID RasterizerCanvasGLES3::request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights) {
+
+	int vertex_count = p_points.size();
+	ERR_FAIL_COND_V(vertex_count == 0, 0);
+
+	PolygonBuffer pb;
+	pb.use_colors = p_colors.size() > 1 && p_colors.size() == vertex_count;
+	pb.use_skeleton = p_bones.size() == vertex_count * 4 && p_weights.size() == vertex_count * 4;
+	pb.color = p_colors.size() == 1 ? p_colors[0] : Color(1, 1, 1, 1);
+	bool use_uvs = p_uvs.size() == vertex_count;
+
+	uint32_t buffer_size = sizeof(Vector2) * vertex_count;
+	if (pb.use_colors) {
+		buffer_size += sizeof(Color) * vertex_count;
+	}
+	if (use_uvs) {
+		buffer_size += sizeof(Vector2) * vertex_count;
+	}
+	if (pb.use_skeleton) {
+		buffer_size += (sizeof(int) + sizeof(float)) * 4 * vertex_count;
+	}
+
+	glGenVertexArrays(1, &pb.vertex_array);
+	glBindVertexArray(pb.vertex_array);
+
+	glGenBuffers(1, &pb.vertex_buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, pb.vertex_buffer);
+	glBufferData(GL_ARRAY_BUFFER, buffer_size, NULL, GL_STATIC_DRAW);
+
+	uint32_t buffer_ofs = 0;
+
+	//same layout as _draw_polygon() streams, but uploaded only once
+	glBufferSubData(GL_ARRAY_BUFFER, buffer_ofs, sizeof(Vector2) * vertex_count, p_points.ptr());
+	glEnableVertexAttribArray(VS::ARRAY_VERTEX);
+	glVertexAttribPointer(VS::ARRAY_VERTEX, 2, GL_FLOAT, false, sizeof(Vector2), ((uint8_t *)0) + buffer_ofs);
+	buffer_ofs += sizeof(Vector2) * vertex_count;
+
+	if (pb.use_colors) {
+		glBufferSubData(GL_ARRAY_BUFFER, buffer_ofs, sizeof(Color) * vertex_count, p_colors.ptr());
+		glEnableVertexAttribArray(VS::ARRAY_COLOR);
+		glVertexAttribPointer(VS::ARRAY_COLOR, 4, GL_FLOAT, false, sizeof(Color), ((uint8_t *)0) + buffer_ofs);
+		buffer_ofs += sizeof(Color) * vertex_count;
+	}
+
+	if (use_uvs) {
+		glBufferSubData(GL_ARRAY_BUFFER, buffer_ofs, sizeof(Vector2) * vertex_count, p_uvs.ptr());
+		glEnableVertexAttribArray(VS::ARRAY_TEX_UV);
+		glVertexAttribPointer(VS::ARRAY_TEX_UV, 2, GL_FLOAT, false, sizeof(Vector2), ((uint8_t *)0) + buffer_ofs);
+		buffer_ofs += sizeof(Vector2) * vertex_count;
+	}
+
+	if (pb.use_skeleton) {
+		glBufferSubData(GL_ARRAY_BUFFER, buffer_ofs, sizeof(int) * 4 * vertex_count, p_bones.ptr());
+		glEnableVertexAttribArray(VS::ARRAY_BONES);
+		glVertexAttribIPointer(VS::ARRAY_BONES, 4, GL_UNSIGNED_INT, sizeof(int) * 4, ((uint8_t *)0) + buffer_ofs);
+		buffer_ofs += sizeof(int) * 4 * vertex_count;
+
+		glBufferSubData(GL_ARRAY_BUFFER, buffer_ofs, sizeof(float) * 4 * vertex_count, p_weights.ptr());
+		glEnableVertexAttribArray(VS::ARRAY_WEIGHTS);
+		glVertexAttribPointer(VS::ARRAY_WEIGHTS, 4, GL_FLOAT, false, sizeof(float) * 4, ((uint8_t *)0) + buffer_ofs);
+		buffer_ofs += sizeof(float) * 4 * vertex_count;
+	}
+
+	pb.index_buffer = 0;
+	if (p_indices.size()) {
+		glGenBuffers(1, &pb.index_buffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pb.index_buffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(int) * p_indices.size(), p_indices.ptr(), GL_STATIC_DRAW);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	PolygonID id = ++polygon_buffer_last_id;
+	polygon_buffers[id] = pb;
+
+	return id;
+}
+
+void RasterizerCanvasGLES3::free_polygon(PolygonID p_polygon) {
+
+	PolygonBuffer *pb = polygon_buffers.getptr(p_polygon);
+	ERR_FAIL_COND(!pb);
+
+	glDeleteVertexArrays(1, &pb->vertex_array);
+	glDeleteBuffers(1, &pb->vertex_buffer);
+	if (pb->index_buffer) {
+		glDeleteBuffers(1, &pb->index_buffer);
+	}
+
+	polygon_buffers.erase(p_polygon);
+}
+
 void RasterizerCanvasGLES3::canvas_begin() {
 
 	if (storage->frame.current_rt && storage->frame.clear_request) {
@@ -391,6 +485,7 @@ void RasterizerCanvasGLES3::_draw_polygon(const int *p_indices, int p_index_coun
 	glDrawElements(GL_TRIANGLES, p_index_count, GL_UNSIGNED_INT, 0);
 
 	storage->frame.canvas_draw_commands++;
+	storage->info.render.draw_call_count++;
 
 	if (p_bones && p_weights) {
 		//not used so often, so disable when used
@@ -401,6 +496,34 @@ void RasterizerCanvasGLES3::_draw_polygon(const int *p_indices, int p_index_coun
 	glBindVertexArray(0);
 }
 
+void RasterizerCanvasGLES3::_draw_polygon_buffer(PolygonID p_polygon, int p_count) {
+
+	const PolygonBuffer *pb = polygon_buffers.getptr(p_polygon);
+	ERR_FAIL_COND(!pb);
+
+	glBindVertexArray(pb->vertex_array);
+
+	if (!pb->use_colors) {
+		glVertexAttrib4f(VS::ARRAY_COLOR, pb->color.r, pb->color.g, pb->color.b, pb->color.a);
+	}
+
+	if (!pb->use_skeleton && state.using_skeleton) {
+		glVertexAttribI4ui(VS::ARRAY_BONES, 0, 0, 0, 0);
+		glVertexAttrib4f(VS::ARRAY_WEIGHTS, 0, 0, 0, 0);
+	}
+
+	if (pb->index_buffer) {
+		glDrawElements(GL_TRIANGLES, p_count, GL_UNSIGNED_INT, 0);
+	} else {
+		glDrawArrays(GL_TRIANGLES, 0, p_count);
+	}
+
+	storage->frame.canvas_draw_commands++;
+	storage->info.render.draw_call_count++;
+
+	glBindVertexArray(0);
+}
+
 void RasterizerCanvasGLES3::_draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor) {
 
 	glBindVertexArray(data.polygon_buffer_pointer_array);
@@ -444,6 +567,7 @@ void RasterizerCanvasGLES3::_draw_generic(GLuint p_primitive, int p_vertex_count
 	glDrawArrays(p_primitive, 0, p_vertex_count);
 
 	storage->frame.canvas_draw_commands++;
+	storage->info.render.draw_call_count++;
 
 	glBindVertexArray(0);
 }
@@ -504,6 +628,105 @@ void RasterizerCanvasGLES3::_draw_gui_primitive(int p_points, const Vector2 *p_v
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	storage->frame.canvas_draw_commands++;
+	storage->info.render.draw_call_count++;
+}
+
+bool RasterizerCanvasGLES3::_is_rect_batchable(const Item::Command *p_command, const Item::CommandRect *p_first) const {
+
+	if (p_command->type != Item::Command::TYPE_RECT)
+		return false;
+
+	const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(p_command);
+
+	// tiling changes the texture wrap and clipping needs the rect in the shader, draw those on their own
+	if (rect->flags & (CANVAS_RECT_TILE | CANVAS_RECT_CLIP_UV))
+		return false;
+
+	return !p_first || (rect->texture == p_first->texture && rect->normal_map == p_first->normal_map);
+}
+
+void RasterizerCanvasGLES3::_draw_rect_batch(Item::Command *const *p_commands, int p_count) {
+
+	const Item::CommandRect *first = static_cast<const Item::CommandRect *>(p_commands[0]);
+
+	_set_texture_rect_mode(false);
+
+	RasterizerStorageGLES3::Texture *texture = _bind_canvas_texture(first->texture, first->normal_map);
+
+	Size2 texpixel_size(1, 1);
+	if (texture) {
+		texpixel_size = Size2(1.0 / texture->width, 1.0 / texture->height);
+		state.canvas_shader.set_uniform(CanvasShaderGLES3::COLOR_TEXPIXEL_SIZE, texpixel_size);
+	}
+
+	int vertex_size = sizeof(Vector2) * 2 + sizeof(Color);
+	int max_rects = MIN(data.polygon_buffer_size / (vertex_size * 4), data.polygon_index_buffer_size / (sizeof(int) * 6));
+
+	static const Vector2 corners[4] = {
+		Vector2(0, 0),
+		Vector2(0, 1),
+		Vector2(1, 1),
+		Vector2(1, 0)
+	};
+
+	int from = 0;
+	while (from < p_count) {
+
+		int count = MIN(p_count - from, max_rects);
+
+		state.batch_vertices.resize(count * 4);
+		state.batch_uvs.resize(count * 4);
+		state.batch_colors.resize(count * 4);
+		state.batch_indices.resize(count * 6);
+
+		Vector2 *vertices = state.batch_vertices.ptrw();
+		Vector2 *uvs = state.batch_uvs.ptrw();
+		Color *colors = state.batch_colors.ptrw();
+		int *indices = state.batch_indices.ptrw();
+
+		for (int i = 0; i < count; i++) {
+
+			const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(p_commands[from + i]);
+
+			// same as the texture rect path of the canvas shader, but on the CPU
+			Rect2 src_rect(0, 0, 1, 1);
+			if (texture) {
+				if (rect->flags & CANVAS_RECT_REGION) {
+					src_rect = Rect2(rect->source.position * texpixel_size, rect->source.size * texpixel_size);
+				}
+				if (rect->flags & CANVAS_RECT_FLIP_H) {
+					src_rect.size.x *= -1;
+				}
+				if (rect->flags & CANVAS_RECT_FLIP_V) {
+					src_rect.size.y *= -1;
+				}
+			}
+
+			Rect2 dst_rect = rect->rect.abs();
+			bool transpose = texture && (rect->flags & CANVAS_RECT_TRANSPOSE);
+
+			for (int j = 0; j < 4; j++) {
+
+				Vector2 corner = corners[j];
+				Vector2 flipped(src_rect.size.x < 0 ? 1 - corner.x : corner.x, src_rect.size.y < 0 ? 1 - corner.y : corner.y);
+
+				vertices[i * 4 + j] = dst_rect.position + dst_rect.size * flipped;
+				uvs[i * 4 + j] = src_rect.position + src_rect.size.abs() * (transpose ? Vector2(corner.y, corner.x) : corner);
+				colors[i * 4 + j] = rect->modulate;
+			}
+
+			indices[i * 6 + 0] = i * 4 + 0;
+			indices[i * 6 + 1] = i * 4 + 1;
+			indices[i * 6 + 2] = i * 4 + 2;
+			indices[i * 6 + 3] = i * 4 + 2;
+			indices[i * 6 + 4] = i * 4 + 3;
+			indices[i * 6 + 5] = i * 4 + 0;
+		}
+
+		_draw_polygon(indices, count * 6, count * 4, vertices, uvs, colors, false, NULL, NULL);
+
+		from += count;
+	}
 }
 
 static const GLenum gl_primitive[] = {
@@ -636,6 +859,20 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 
 				Item::CommandRect *rect = static_cast<Item::CommandRect *>(c);
 
+				if (state.use_batching && _is_rect_batchable(c, NULL)) {
+
+					int batch_count = 1;
+					while (i + batch_count < cc && _is_rect_batchable(commands[i + batch_count], rect)) {
+						batch_count++;
+					}
+
+					if (batch_count > 1) {
+						_draw_rect_batch(&commands[i], batch_count);
+						i += batch_count - 1;
+						break;
+					}
+				}
+
 				_set_texture_rect_mode(true);
 
 				//set color
@@ -710,6 +947,7 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 				}
 
 				storage->frame.canvas_draw_commands++;
+				storage->info.render.draw_call_count++;
 
 			} break;
 
@@ -753,6 +991,7 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 				glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
 				storage->frame.canvas_draw_commands++;
+				storage->info.render.draw_call_count++;
 			} break;
 
 			case Item::Command::TYPE_PRIMITIVE: {
@@ -792,7 +1031,11 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 					state.canvas_shader.set_uniform(CanvasShaderGLES3::COLOR_TEXPIXEL_SIZE, texpixel_size);
 				}
 
-				_draw_polygon(polygon->indices.ptr(), polygon->count, polygon->points.size(), polygon->points.ptr(), polygon->uvs.ptr(), polygon->colors.ptr(), polygon->colors.size() == 1, polygon->bones.ptr(), polygon->weights.ptr());
+				if (polygon->polygon_id) {
+					_draw_polygon_buffer(polygon->polygon_id, polygon->count);
+				} else {
+					_draw_polygon(polygon->indices.ptr(), polygon->count, polygon->points.size(), polygon->points.ptr(), polygon->uvs.ptr(), polygon->colors.ptr(), polygon->colors.size() == 1, polygon->bones.ptr(), polygon->weights.ptr());
+				}
 #ifdef GLES_OVER_GL
 				if (polygon->antialiased) {
 					glEnable(GL_LINE_SMOOTH);
@@ -827,6 +1070,7 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 						} else {
 							glDrawArrays(gl_primitive[s->primitive], 0, s->array_len);
 						}
+						storage->info.render.draw_call_count++;
 
 						glBindVertexArray(0);
 					}
@@ -906,6 +1150,7 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 					glVertexAttribDivisor(12, 1);
 
 					glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, amount);
+					storage->info.render.draw_call_count++;
 				} else {
 					//split
 
@@ -930,6 +1175,7 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 						glVertexAttribDivisor(12, 1);
 
 						glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, amount - split);
+						storage->info.render.draw_call_count++;
 					}
 
 					if (split > 0) {
@@ -950,6 +1196,7 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 						glVertexAttribDivisor(12, 1);
 
 						glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, split);
+						storage->info.render.draw_call_count++;
 					}
 				}
 
@@ -1109,6 +1356,8 @@ void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, cons
 
 	Size2 rt_size = Size2(storage->frame.current_rt->width, storage->frame.current_rt->height);
 
+	storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_CANVAS);
+
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_DISTANCE_FIELD, false);
 
 	glBindBuffer(GL_UNIFORM_BUFFER, state.canvas_item_ubo);
@@ -1239,7 +1488,7 @@ void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, cons
 				}
 
 				if (material_ptr->ubo_id) {
-					glBindBufferBase(GL_UNIFORM_BUFFER, 2, material_ptr->ubo_id);
+					storage->material_bind_ubo(material_ptr, 2);
 				}
 
 				int tc = material_ptr->textures.size();
@@ -1544,6 +1793,8 @@ void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, cons
 	if (current_clip) {
 		glDisable(GL_SCISSOR_TEST);
 	}
+
+	storage->gpu_timer_end();
 }
 
 void RasterizerCanvasGLES3::canvas_debug_viewport_shadows(Light *p_lights_with_shadow) {
@@ -1948,6 +2199,7 @@ void RasterizerCanvasGLES3::initialize() {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.polygon_index_buffer);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size, NULL, GL_DYNAMIC_DRAW); //allocate max size
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		data.polygon_index_buffer_size = index_size;
 	}
 
 	store_transform(Transform(), state.canvas_item_ubo_data.projection_matrix);
@@ -1965,6 +2217,8 @@ void RasterizerCanvasGLES3::initialize() {
 	state.canvas_shadow_shader.set_conditional(CanvasShadowShaderGLES3::USE_RGBA_SHADOWS, storage->config.use_rgba_2d_shadows);
 
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_PIXEL_SNAP, GLOBAL_DEF("rendering/quality/2d/use_pixel_snap", false));
+
+	state.use_batching = GLOBAL_DEF("rendering/quality/2d/use_batching", true);
 }
 
 void RasterizerCanvasGLES3::finalize() {
@@ -1979,4 +2233,6 @@ void RasterizerCanvasGLES3::finalize() {
 }
 
 RasterizerCanvasGLES3::RasterizerCanvasGLES3() {
+
+	polygon_buffer_last_id = 0;
 }
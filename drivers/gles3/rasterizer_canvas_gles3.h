@@ -62,6 +62,7 @@ public:
 		GLuint particle_quad_array;
 
 		uint32_t polygon_buffer_size;
+		uint32_t polygon_index_buffer_size;
 
 	} data;
 
@@ -88,6 +89,13 @@ public:
 		Transform2D skeleton_transform;
 		Transform2D skeleton_transform_inverse;
 
+		// consecutive rects with the same textures are merged into a single polygon draw
+		bool use_batching;
+		Vector<Vector2> batch_vertices;
+		Vector<Vector2> batch_uvs;
+		Vector<Color> batch_colors;
+		Vector<int> batch_indices;
+
 	} state;
 
 	RasterizerStorageGLES3 *storage;
@@ -119,6 +127,22 @@ public:
 	virtual void light_internal_update(RID p_rid, Light *p_light);
 	virtual void light_internal_free(RID p_rid);
 
+	struct PolygonBuffer {
+
+		GLuint vertex_array;
+		GLuint vertex_buffer;
+		GLuint index_buffer;
+		bool use_colors;
+		bool use_skeleton;
+		Color color; //used when there are no per vertex colors
+	};
+
+	HashMap<PolygonID, PolygonBuffer> polygon_buffers;
+	PolygonID polygon_buffer_last_id;
+
+	virtual PolygonID request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>());
+	virtual void free_polygon(PolygonID p_polygon);
+
 	virtual void canvas_begin();
 	virtual void canvas_end();
 
@@ -127,8 +151,12 @@ public:
 
 	_FORCE_INLINE_ void _draw_gui_primitive(int p_points, const Vector2 *p_vertices, const Color *p_colors, const Vector2 *p_uvs);
 	_FORCE_INLINE_ void _draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor, const int *p_bones, const float *p_weights);
+	_FORCE_INLINE_ void _draw_polygon_buffer(PolygonID p_polygon, int p_count);
 	_FORCE_INLINE_ void _draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 
+	_FORCE_INLINE_ bool _is_rect_batchable(const Item::Command *p_command, const Item::CommandRect *p_first) const;
+	_FORCE_INLINE_ void _draw_rect_batch(Item::Command *const *p_commands, int p_count);
+
 	_FORCE_INLINE_ void _canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip);
 	_FORCE_INLINE_ void _copy_texscreen(const Rect2 &p_rect);
 
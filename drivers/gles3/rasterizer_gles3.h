@@ -58,6 +58,7 @@ public:
 	virtual void set_current_render_target(RID p_render_target);
 	virtual void restore_render_target();
 	virtual void clear_render_target(const Color &p_color);
+	virtual bool clear_render_target_rect(const Rect2 &p_rect, const Color &p_color);
 	virtual void blit_render_target_to_screen(RID p_render_target, const Rect2 &p_screen_rect, int p_screen = 0);
 	virtual void end_frame(bool p_swap_buffers);
 	virtual void finalize();
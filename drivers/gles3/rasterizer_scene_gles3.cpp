@@ -31,6 +31,7 @@
 #include "rasterizer_scene_gles3.h"
 #include "math_funcs.h"
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
 #include "project_settings.h"
 #include "rasterizer_canvas_gles3.h"
 #include "servers/visual/visual_server_raster.h"
@@ -915,6 +916,14 @@ void RasterizerSceneGLES3::environment_set_ssao(RID p_env, bool p_enable, float
 	env->ssao_bilateral_sharpness = p_bilateral_sharpness;
 }
 
+void RasterizerSceneGLES3::environment_set_ssao_resolution(RID p_env, VS::EnvironmentSSAOResolution p_resolution) {
+
+	Environment *env = environment_owner.getornull(p_env);
+	ERR_FAIL_COND(!env);
+
+	env->ssao_resolution = p_resolution;
+}
+
 void RasterizerSceneGLES3::environment_set_tonemap(RID p_env, VS::EnvironmentToneMapper p_tone_mapper, float p_exposure, float p_white, bool p_auto_exposure, float p_min_luminance, float p_max_luminance, float p_auto_exp_speed, float p_auto_exp_scale) {
 
 	Environment *env = environment_owner.getornull(p_env);
@@ -1184,7 +1193,7 @@ bool RasterizerSceneGLES3::_setup_material(RasterizerStorageGLES3::Material *p_m
 
 	if (p_material->ubo_id) {
 
-		glBindBufferBase(GL_UNIFORM_BUFFER, 1, p_material->ubo_id);
+		storage->material_bind_ubo(p_material, 1);
 	}
 
 	int tc = p_material->textures.size();
@@ -1334,6 +1343,28 @@ struct RasterizerGLES3ParticleSort {
 	}
 };
 
+void RasterizerSceneGLES3::_setup_vertex_decode(RasterizerStorageGLES3::Geometry *p_geometry) {
+
+	uint32_t format = 0;
+	AABB aabb;
+
+	if (p_geometry->type == RasterizerStorageGLES3::Geometry::GEOMETRY_SURFACE) {
+		RasterizerStorageGLES3::Surface *s = static_cast<RasterizerStorageGLES3::Surface *>(p_geometry);
+		format = s->format;
+		aabb = s->aabb;
+	}
+
+	if ((format & VS::ARRAY_COMPRESS_VERTEX) && (format & VS::ARRAY_FLAG_USE_QUANTIZED_VERTICES)) {
+		state.scene_shader.set_uniform(SceneShaderGLES3::VERTEX_DECODE_OFFSET, aabb.position);
+		state.scene_shader.set_uniform(SceneShaderGLES3::VERTEX_DECODE_SCALE, aabb.size);
+	} else {
+		state.scene_shader.set_uniform(SceneShaderGLES3::VERTEX_DECODE_OFFSET, Vector3());
+		state.scene_shader.set_uniform(SceneShaderGLES3::VERTEX_DECODE_SCALE, Vector3(1, 1, 1));
+	}
+
+	state.scene_shader.set_uniform(SceneShaderGLES3::OCTAHEDRAL_COMPRESSION, (format & VS::ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION) ? 1.0 : 0.0);
+}
+
 void RasterizerSceneGLES3::_setup_geometry(RenderList::Element *e, const Transform &p_view_transform) {
 
 	switch (e->instance->base_type) {
@@ -1371,70 +1402,7 @@ void RasterizerSceneGLES3::_setup_geometry(RenderList::Element *e, const Transfo
 				glBindVertexArray(s->instancing_array_id); // use the instancing array ID
 			}
 
-			glBindBuffer(GL_ARRAY_BUFFER, multi_mesh->buffer); //modify the buffer
-
-			int stride = (multi_mesh->xform_floats + multi_mesh->color_floats + multi_mesh->custom_data_floats) * 4;
-			glEnableVertexAttribArray(8);
-			glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 0);
-			glVertexAttribDivisor(8, 1);
-			glEnableVertexAttribArray(9);
-			glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 4 * 4);
-			glVertexAttribDivisor(9, 1);
-
-			int color_ofs;
-
-			if (multi_mesh->transform_format == VS::MULTIMESH_TRANSFORM_3D) {
-				glEnableVertexAttribArray(10);
-				glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 8 * 4);
-				glVertexAttribDivisor(10, 1);
-				color_ofs = 12 * 4;
-			} else {
-				glDisableVertexAttribArray(10);
-				glVertexAttrib4f(10, 0, 0, 1, 0);
-				color_ofs = 8 * 4;
-			}
-
-			int custom_data_ofs = color_ofs;
-
-			switch (multi_mesh->color_format) {
-
-				case VS::MULTIMESH_COLOR_NONE: {
-					glDisableVertexAttribArray(11);
-					glVertexAttrib4f(11, 1, 1, 1, 1);
-				} break;
-				case VS::MULTIMESH_COLOR_8BIT: {
-					glEnableVertexAttribArray(11);
-					glVertexAttribPointer(11, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, ((uint8_t *)NULL) + color_ofs);
-					glVertexAttribDivisor(11, 1);
-					custom_data_ofs += 4;
-
-				} break;
-				case VS::MULTIMESH_COLOR_FLOAT: {
-					glEnableVertexAttribArray(11);
-					glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + color_ofs);
-					glVertexAttribDivisor(11, 1);
-					custom_data_ofs += 4 * 4;
-				} break;
-			}
-
-			switch (multi_mesh->custom_data_format) {
-
-				case VS::MULTIMESH_CUSTOM_DATA_NONE: {
-					glDisableVertexAttribArray(12);
-					glVertexAttrib4f(12, 1, 1, 1, 1);
-				} break;
-				case VS::MULTIMESH_CUSTOM_DATA_8BIT: {
-					glEnableVertexAttribArray(12);
-					glVertexAttribPointer(12, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, ((uint8_t *)NULL) + custom_data_ofs);
-					glVertexAttribDivisor(12, 1);
-
-				} break;
-				case VS::MULTIMESH_CUSTOM_DATA_FLOAT: {
-					glEnableVertexAttribArray(12);
-					glVertexAttribPointer(12, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + custom_data_ofs);
-					glVertexAttribDivisor(12, 1);
-				} break;
-			}
+			_setup_multimesh_instances(multi_mesh, 0);
 
 		} break;
 		case VS::INSTANCE_PARTICLES: {
@@ -1518,6 +1486,267 @@ static const GLenum gl_primitive[] = {
 	GL_TRIANGLE_FAN
 };
 
+void RasterizerSceneGLES3::_setup_multimesh_instances(const RasterizerStorageGLES3::MultiMesh *p_multimesh, int p_from) {
+
+	glBindBuffer(GL_ARRAY_BUFFER, p_multimesh->buffer); //modify the buffer
+
+	int stride = (p_multimesh->xform_floats + p_multimesh->color_floats + p_multimesh->custom_data_floats) * 4;
+	uint8_t *base = ((uint8_t *)NULL) + p_from * stride;
+
+	glEnableVertexAttribArray(8);
+	glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride, base);
+	glVertexAttribDivisor(8, 1);
+	glEnableVertexAttribArray(9);
+	glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride, base + 4 * 4);
+	glVertexAttribDivisor(9, 1);
+
+	int color_ofs;
+
+	if (p_multimesh->transform_format == VS::MULTIMESH_TRANSFORM_3D) {
+		glEnableVertexAttribArray(10);
+		glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, stride, base + 8 * 4);
+		glVertexAttribDivisor(10, 1);
+		color_ofs = 12 * 4;
+	} else {
+		glDisableVertexAttribArray(10);
+		glVertexAttrib4f(10, 0, 0, 1, 0);
+		color_ofs = 8 * 4;
+	}
+
+	int custom_data_ofs = color_ofs;
+
+	switch (p_multimesh->color_format) {
+
+		case VS::MULTIMESH_COLOR_NONE: {
+			glDisableVertexAttribArray(11);
+			glVertexAttrib4f(11, 1, 1, 1, 1);
+		} break;
+		case VS::MULTIMESH_COLOR_8BIT: {
+			glEnableVertexAttribArray(11);
+			glVertexAttribPointer(11, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, base + color_ofs);
+			glVertexAttribDivisor(11, 1);
+			custom_data_ofs += 4;
+
+		} break;
+		case VS::MULTIMESH_COLOR_FLOAT: {
+			glEnableVertexAttribArray(11);
+			glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, stride, base + color_ofs);
+			glVertexAttribDivisor(11, 1);
+			custom_data_ofs += 4 * 4;
+		} break;
+	}
+
+	switch (p_multimesh->custom_data_format) {
+
+		case VS::MULTIMESH_CUSTOM_DATA_NONE: {
+			glDisableVertexAttribArray(12);
+			glVertexAttrib4f(12, 1, 1, 1, 1);
+		} break;
+		case VS::MULTIMESH_CUSTOM_DATA_8BIT: {
+			glEnableVertexAttribArray(12);
+			glVertexAttribPointer(12, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, base + custom_data_ofs);
+			glVertexAttribDivisor(12, 1);
+
+		} break;
+		case VS::MULTIMESH_CUSTOM_DATA_FLOAT: {
+			glEnableVertexAttribArray(12);
+			glVertexAttribPointer(12, 4, GL_FLOAT, GL_FALSE, stride, base + custom_data_ofs);
+			glVertexAttribDivisor(12, 1);
+		} break;
+	}
+}
+
+void RasterizerSceneGLES3::_draw_multimesh_instances(const RasterizerStorageGLES3::Surface *s, int p_amount) {
+
+#ifdef DEBUG_ENABLED
+
+	if (state.debug_draw == VS::VIEWPORT_DEBUG_DRAW_WIREFRAME && s->array_wireframe_id) {
+
+		glDrawElementsInstanced(GL_LINES, s->index_wireframe_len, GL_UNSIGNED_INT, 0, p_amount);
+		storage->info.render.vertices_count += s->index_array_len * p_amount;
+	} else
+#endif
+			if (s->index_array_len > 0) {
+
+		glDrawElementsInstanced(gl_primitive[s->primitive], s->index_array_len, (s->array_len >= (1 << 16)) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT, 0, p_amount);
+
+		storage->info.render.vertices_count += s->index_array_len * p_amount;
+
+	} else {
+
+		glDrawArraysInstanced(gl_primitive[s->primitive], 0, s->array_len, p_amount);
+
+		storage->info.render.vertices_count += s->array_len * p_amount;
+	}
+}
+
+bool RasterizerSceneGLES3::_is_multimesh_chunk_visible(const InstanceBase *p_instance, const AABB &p_aabb) const {
+
+	AABB aabb = p_instance->transform.xform(p_aabb);
+
+	if (!aabb.intersects_convex_shape(state.multimesh_cull_planes.ptr(), state.multimesh_cull_planes.size())) {
+		return false;
+	}
+
+	if (p_instance->lod_begin > 0 || p_instance->lod_end > 0) {
+		float d = state.multimesh_cull_origin.distance_to(aabb.position + aabb.size * 0.5);
+		if (d < p_instance->lod_begin || (p_instance->lod_end > 0 && d > p_instance->lod_end)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool RasterizerSceneGLES3::_can_auto_instance(const RenderList::Element *e) const {
+
+	if (e->instance->base_type != VS::INSTANCE_MESH || e->instance->skeleton.is_valid()) {
+		return false;
+	}
+
+	const RasterizerStorageGLES3::Surface *s = static_cast<const RasterizerStorageGLES3::Surface *>(e->geometry);
+	if (s->blend_shapes.size() && e->instance->blend_values.size()) {
+		return false; //transform feedback is done per instance
+	}
+
+	if (e->instance->lightmap.is_valid() || !e->instance->lightmap_capture_data.empty()) {
+		return false; //baked lighting is per instance
+	}
+
+	if (e->material->shader && e->material->shader->spatial.uses_world_matrix_or_instance_id) {
+		return false; //world transform is not available as uniform when instancing
+	}
+
+	return true;
+}
+
+static _FORCE_INLINE_ bool _rid_vectors_equal(const Vector<RID> &p_a, const Vector<RID> &p_b) {
+
+	int size = p_a.size();
+	if (size != p_b.size()) {
+		return false;
+	}
+
+	const RID *a = p_a.ptr();
+	const RID *b = p_b.ptr();
+	if (a == b) {
+		return true;
+	}
+
+	for (int i = 0; i < size; i++) {
+		if (a[i] != b[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool RasterizerSceneGLES3::_can_auto_instance_with(const RenderList::Element *e, const RenderList::Element *p_other) const {
+
+	if (p_other->geometry != e->geometry || p_other->material != e->material || p_other->owner != e->owner || p_other->sort_key != e->sort_key) {
+		return false;
+	}
+
+	const RasterizerScene::InstanceBase *a = e->instance;
+	const RasterizerScene::InstanceBase *b = p_other->instance;
+
+	if (b->base_type != a->base_type || b->skeleton.is_valid() || b->mirror != a->mirror || b->layer_mask != a->layer_mask || b->baked_light != a->baked_light) {
+		return false;
+	}
+
+	if (b->blend_values.size() || b->lightmap.is_valid() || !b->lightmap_capture_data.empty()) {
+		return false;
+	}
+
+	//lights, probes and gi are set up once for the whole batch, so they must match exactly
+	return _rid_vectors_equal(a->light_instances, b->light_instances) && _rid_vectors_equal(a->reflection_probe_instances, b->reflection_probe_instances) && _rid_vectors_equal(a->gi_probe_instances, b->gi_probe_instances);
+}
+
+void RasterizerSceneGLES3::_setup_auto_instancing(RenderList::Element **p_elements, int p_count) {
+
+	RasterizerStorageGLES3::Surface *s = static_cast<RasterizerStorageGLES3::Surface *>(p_elements[0]->geometry);
+
+	float *dataptr = state.auto_instancing_tmp;
+
+	for (int i = 0; i < p_count; i++) {
+
+		const Transform &xform = p_elements[i]->instance->transform;
+
+		dataptr[0] = xform.basis.elements[0][0];
+		dataptr[1] = xform.basis.elements[0][1];
+		dataptr[2] = xform.basis.elements[0][2];
+		dataptr[3] = xform.origin.x;
+		dataptr[4] = xform.basis.elements[1][0];
+		dataptr[5] = xform.basis.elements[1][1];
+		dataptr[6] = xform.basis.elements[1][2];
+		dataptr[7] = xform.origin.y;
+		dataptr[8] = xform.basis.elements[2][0];
+		dataptr[9] = xform.basis.elements[2][1];
+		dataptr[10] = xform.basis.elements[2][2];
+		dataptr[11] = xform.origin.z;
+		dataptr += 12;
+	}
+
+#ifdef DEBUG_ENABLED
+	if (state.debug_draw == VS::VIEWPORT_DEBUG_DRAW_WIREFRAME && s->instancing_array_wireframe_id) {
+
+		glBindVertexArray(s->instancing_array_wireframe_id); // use the instancing array ID
+	} else
+#endif
+	{
+		glBindVertexArray(s->instancing_array_id); // use the instancing array ID
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, state.auto_instancing_buffer);
+	//orphan the previous contents, so the driver does not stall on draws still using them
+	glBufferData(GL_ARRAY_BUFFER, state.auto_instancing_buffer_size, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, p_count * sizeof(float) * 12, state.auto_instancing_tmp);
+
+	int stride = sizeof(float) * 12;
+
+	glEnableVertexAttribArray(8);
+	glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 0);
+	glVertexAttribDivisor(8, 1);
+	glEnableVertexAttribArray(9);
+	glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 4 * 4);
+	glVertexAttribDivisor(9, 1);
+	glEnableVertexAttribArray(10);
+	glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 8 * 4);
+	glVertexAttribDivisor(10, 1);
+
+	glDisableVertexAttribArray(11);
+	glVertexAttrib4f(11, 1, 1, 1, 1);
+	glDisableVertexAttribArray(12);
+	glVertexAttrib4f(12, 0, 0, 0, 0);
+}
+
+void RasterizerSceneGLES3::_render_auto_instancing(RenderList::Element *e, int p_count) {
+
+	RasterizerStorageGLES3::Surface *s = static_cast<RasterizerStorageGLES3::Surface *>(e->geometry);
+
+#ifdef DEBUG_ENABLED
+
+	if (state.debug_draw == VS::VIEWPORT_DEBUG_DRAW_WIREFRAME && s->array_wireframe_id) {
+
+		glDrawElementsInstanced(GL_LINES, s->index_wireframe_len, GL_UNSIGNED_INT, 0, p_count);
+		storage->info.render.vertices_count += s->index_array_len * p_count;
+	} else
+#endif
+			if (s->index_array_len > 0) {
+
+		glDrawElementsInstanced(gl_primitive[s->primitive], s->index_array_len, (s->array_len >= (1 << 16)) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT, 0, p_count);
+
+		storage->info.render.vertices_count += s->index_array_len * p_count;
+
+	} else {
+
+		glDrawArraysInstanced(gl_primitive[s->primitive], 0, s->array_len, p_count);
+
+		storage->info.render.vertices_count += s->array_len * p_count;
+	}
+}
+
 void RasterizerSceneGLES3::_render_geometry(RenderList::Element *e) {
 
 	switch (e->instance->base_type) {
@@ -1555,25 +1784,45 @@ void RasterizerSceneGLES3::_render_geometry(RenderList::Element *e) {
 
 			int amount = MAX(multi_mesh->size, multi_mesh->visible_instances);
 
-#ifdef DEBUG_ENABLED
+			if (state.multimesh_cull_planes.size() && multi_mesh->chunk_aabbs.size() > 1) {
 
-			if (state.debug_draw == VS::VIEWPORT_DEBUG_DRAW_WIREFRAME && s->array_wireframe_id) {
+				// only draw the runs of consecutive chunks that are in view and in the draw range,
+				// GLES3 has no base instance so the instance attributes are offset instead
+				const AABB *chunk_aabbs = multi_mesh->chunk_aabbs.ptr();
+				int chunk_count = multi_mesh->chunk_aabbs.size();
+				int chunk_size = RasterizerStorageGLES3::MultiMesh::CULL_CHUNK_SIZE;
+				int run_from = -1;
+				int bound_from = 0;
 
-				glDrawElementsInstanced(GL_LINES, s->index_wireframe_len, GL_UNSIGNED_INT, 0, amount);
-				storage->info.render.vertices_count += s->index_array_len * amount;
-			} else
-#endif
-					if (s->index_array_len > 0) {
+				for (int i = 0; i <= chunk_count; i++) {
+
+					if (i < chunk_count && i * chunk_size < amount && _is_multimesh_chunk_visible(e->instance, chunk_aabbs[i])) {
+						if (run_from < 0) {
+							run_from = i * chunk_size;
+						}
+						continue;
+					}
+
+					if (run_from < 0) {
+						continue;
+					}
 
-				glDrawElementsInstanced(gl_primitive[s->primitive], s->index_array_len, (s->array_len >= (1 << 16)) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT, 0, amount);
+					if (run_from != bound_from) {
+						_setup_multimesh_instances(multi_mesh, run_from);
+						bound_from = run_from;
+					}
 
-				storage->info.render.vertices_count += s->index_array_len * amount;
+					_draw_multimesh_instances(s, MIN(i * chunk_size, amount) - run_from);
+					run_from = -1;
+				}
 
-			} else {
+				if (bound_from != 0) {
+					_setup_multimesh_instances(multi_mesh, 0);
+				}
 
-				glDrawArraysInstanced(gl_primitive[s->primitive], 0, s->array_len, amount);
+			} else {
 
-				storage->info.render.vertices_count += s->array_len * amount;
+				_draw_multimesh_instances(s, amount);
 			}
 
 		} break;
@@ -1996,6 +2245,11 @@ void RasterizerSceneGLES3::_render_list(RenderList::Element **p_elements, int p_
 		state.scene_shader.set_conditional(SceneShaderGLES3::USE_RADIANCE_MAP_ARRAY, false);
 	}
 
+	if (state.use_light_clusters && !p_shadow && !p_directional_add) {
+		glActiveTexture(GL_TEXTURE0 + storage->config.max_texture_image_units - 6);
+		glBindTexture(GL_TEXTURE_2D, state.light_cluster_texture);
+	}
+
 	state.cull_front = false;
 	state.cull_disabled = false;
 	glCullFace(GL_BACK);
@@ -2171,7 +2425,17 @@ void RasterizerSceneGLES3::_render_list(RenderList::Element **p_elements, int p_
 			rebind = true;
 		}
 
-		bool use_instancing = e->instance->base_type == VS::INSTANCE_MULTIMESH || e->instance->base_type == VS::INSTANCE_PARTICLES;
+		//merge the following elements that only differ in transform into a single instanced draw
+		int instance_count = 1;
+
+		if (state.use_auto_instancing && i + 1 < p_element_count && _can_auto_instance(e)) {
+
+			while (i + instance_count < p_element_count && instance_count < state.max_auto_instances && _can_auto_instance_with(e, p_elements[i + instance_count])) {
+				instance_count++;
+			}
+		}
+
+		bool use_instancing = e->instance->base_type == VS::INSTANCE_MULTIMESH || e->instance->base_type == VS::INSTANCE_PARTICLES || instance_count > 1;
 
 		if (use_instancing != prev_use_instancing) {
 			state.scene_shader.set_conditional(SceneShaderGLES3::USE_INSTANCING, use_instancing);
@@ -2206,7 +2470,12 @@ void RasterizerSceneGLES3::_render_list(RenderList::Element **p_elements, int p_
 			_setup_light(e, p_view_transform);
 		}
 
-		if (e->owner != prev_owner || prev_base_type != e->instance->base_type || prev_geometry != e->geometry) {
+		if (instance_count > 1) {
+
+			_setup_auto_instancing(&p_elements[i], instance_count);
+			storage->info.render.surface_switch_count++;
+
+		} else if (e->owner != prev_owner || prev_base_type != e->instance->base_type || prev_geometry != e->geometry) {
 
 			_setup_geometry(e, p_view_transform);
 			storage->info.render.surface_switch_count++;
@@ -2215,13 +2484,33 @@ void RasterizerSceneGLES3::_render_list(RenderList::Element **p_elements, int p_
 		_set_cull(e->sort_key & RenderList::SORT_KEY_MIRROR_FLAG, e->sort_key & RenderList::SORT_KEY_CULL_DISABLED_FLAG, p_reverse_cull);
 
 		state.scene_shader.set_uniform(SceneShaderGLES3::NORMAL_MULT, e->instance->mirror ? -1.0 : 1.0);
-		state.scene_shader.set_uniform(SceneShaderGLES3::WORLD_TRANSFORM, e->instance->transform);
+		_setup_vertex_decode(e->geometry);
+
+		if (state.use_light_clusters) {
+			//clusters hold every light, so the light cull mask is checked per pixel
+			state.scene_shader.set_uniform(SceneShaderGLES3::INSTANCE_LAYER_MASK, int(e->instance->layer_mask));
+		}
+
+		if (instance_count > 1) {
+
+			//transforms come from the instance buffer
+			state.scene_shader.set_uniform(SceneShaderGLES3::WORLD_TRANSFORM, Transform());
+
+			_render_auto_instancing(e, instance_count);
+
+			storage->info.render.draw_call_count -= instance_count - 1;
+			storage->info.render.instanced_draw_calls_saved += instance_count - 1;
+			i += instance_count - 1;
+		} else {
 
-		_render_geometry(e);
+			state.scene_shader.set_uniform(SceneShaderGLES3::WORLD_TRANSFORM, e->instance->transform);
+
+			_render_geometry(e);
+		}
 
 		prev_material = material;
 		prev_base_type = e->instance->base_type;
-		prev_geometry = e->geometry;
+		prev_geometry = instance_count > 1 ? NULL : e->geometry; //the instancing array is bound, force setup for the next element
 		prev_owner = e->owner;
 		prev_shading = shading;
 		prev_skeleton = skeleton;
@@ -2252,7 +2541,7 @@ void RasterizerSceneGLES3::_render_list(RenderList::Element **p_elements, int p_
 	state.scene_shader.set_conditional(SceneShaderGLES3::USE_OPAQUE_PREPASS, false);
 }
 
-void RasterizerSceneGLES3::_add_geometry(RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, int p_material, bool p_depth_pass, bool p_shadow_pass) {
+void RasterizerSceneGLES3::_add_geometry(RenderListFillChunk *p_chunk, RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, int p_material, bool p_depth_pass, bool p_shadow_pass) {
 
 	RasterizerStorageGLES3::Material *m = NULL;
 	RID m_src = p_instance->material_override.is_valid() ? p_instance->material_override : (p_material >= 0 ? p_instance->materials[p_material] : p_geometry->material);
@@ -2284,17 +2573,17 @@ void RasterizerSceneGLES3::_add_geometry(RasterizerStorageGLES3::Geometry *p_geo
 
 	ERR_FAIL_COND(!m);
 
-	_add_geometry_with_material(p_geometry, p_instance, p_owner, m, p_depth_pass, p_shadow_pass);
+	_add_geometry_with_material(p_chunk, p_geometry, p_instance, p_owner, m, p_depth_pass, p_shadow_pass);
 
 	while (m->next_pass.is_valid()) {
 		m = storage->material_owner.getornull(m->next_pass);
 		if (!m || !m->shader || !m->shader->valid)
 			break;
-		_add_geometry_with_material(p_geometry, p_instance, p_owner, m, p_depth_pass, p_shadow_pass);
+		_add_geometry_with_material(p_chunk, p_geometry, p_instance, p_owner, m, p_depth_pass, p_shadow_pass);
 	}
 }
 
-void RasterizerSceneGLES3::_add_geometry_with_material(RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, RasterizerStorageGLES3::Material *p_material, bool p_depth_pass, bool p_shadow_pass) {
+void RasterizerSceneGLES3::_add_geometry_with_material(RenderListFillChunk *p_chunk, RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, RasterizerStorageGLES3::Material *p_material, bool p_depth_pass, bool p_shadow_pass) {
 
 	bool has_base_alpha = (p_material->shader->spatial.uses_alpha && !p_material->shader->spatial.uses_alpha_scissor) || p_material->shader->spatial.uses_screen_texture || p_material->shader->spatial.uses_depth_texture;
 	bool has_blend_alpha = p_material->shader->spatial.blend_mode != RasterizerStorageGLES3::Shader::Spatial::BLEND_MODE_MIX;
@@ -2311,11 +2600,11 @@ void RasterizerSceneGLES3::_add_geometry_with_material(RasterizerStorageGLES3::G
 	}
 
 	if (p_material->shader->spatial.uses_sss) {
-		state.used_sss = true;
+		p_chunk->used_sss = true;
 	}
 
 	if (p_material->shader->spatial.uses_screen_texture) {
-		state.used_screen_texture = true;
+		p_chunk->used_screen_texture = true;
 	}
 
 	if (p_depth_pass) {
@@ -2337,38 +2626,23 @@ void RasterizerSceneGLES3::_add_geometry_with_material(RasterizerStorageGLES3::G
 		has_alpha = false;
 	}
 
-	RenderList::Element *e = has_alpha ? render_list.add_alpha_element() : render_list.add_element();
-
-	if (!e)
-		return;
+	RenderListFillItem *e = p_chunk->add_item();
 
 	e->geometry = p_geometry;
 	e->material = p_material;
 	e->instance = p_instance;
 	e->owner = p_owner;
 	e->sort_key = 0;
-
-	if (e->geometry->last_pass != render_pass) {
-		e->geometry->last_pass = render_pass;
-		e->geometry->index = current_geometry_index++;
-	}
+	e->alpha = has_alpha;
 
 	if (!p_depth_pass && directional_light && (directional_light->light_ptr->cull_mask & e->instance->layer_mask) == 0) {
 		e->sort_key |= SORT_KEY_NO_DIRECTIONAL_FLAG;
 	}
 
-	e->sort_key |= uint64_t(e->geometry->index) << RenderList::SORT_KEY_GEOMETRY_INDEX_SHIFT;
 	e->sort_key |= uint64_t(e->instance->base_type) << RenderList::SORT_KEY_GEOMETRY_TYPE_SHIFT;
 
 	if (!p_depth_pass) {
 
-		if (e->material->last_pass != render_pass) {
-			e->material->last_pass = render_pass;
-			e->material->index = current_material_index++;
-		}
-
-		e->sort_key |= uint64_t(e->material->index) << RenderList::SORT_KEY_MATERIAL_INDEX_SHIFT;
-
 		if (e->instance->gi_probe_instances.size()) {
 			e->sort_key |= SORT_KEY_GI_PROBES_FLAG;
 		}
@@ -2384,7 +2658,6 @@ void RasterizerSceneGLES3::_add_geometry_with_material(RasterizerStorageGLES3::G
 		e->sort_key |= uint64_t(p_material->render_priority + 128) << RenderList::SORT_KEY_PRIORITY_SHIFT;
 	} else {
 		e->sort_key |= uint64_t(e->instance->depth_layer) << RenderList::SORT_KEY_OPAQUE_DEPTH_LAYER_SHIFT;
-		e->sort_key |= uint64_t(e->material->index) << RenderList::SORT_KEY_MATERIAL_INDEX_SHIFT;
 	}
 
 	/*
@@ -2416,7 +2689,7 @@ void RasterizerSceneGLES3::_add_geometry_with_material(RasterizerStorageGLES3::G
 	}
 
 	if (p_material->shader->spatial.uses_time) {
-		VisualServerRaster::redraw_request();
+		p_chunk->uses_time = true;
 	}
 }
 
@@ -2542,6 +2815,16 @@ void RasterizerSceneGLES3::_setup_environment(Environment *env, const CameraMatr
 	state.ubo_data.time = storage->frame.time[0];
 
 	state.ubo_data.z_far = p_cam_projection.get_z_far();
+
+	//light cluster slices, exponential in depth for perspective and linear for orthogonal
+	if (p_cam_projection.is_orthogonal()) {
+		state.ubo_data.light_cluster_z_near = p_cam_projection.get_z_near();
+		state.ubo_data.light_cluster_z_scale = -LIGHT_CLUSTER_DEPTH / MAX(0.001, state.ubo_data.z_far - state.ubo_data.light_cluster_z_near);
+	} else {
+		state.ubo_data.light_cluster_z_near = MAX(0.001, p_cam_projection.get_z_near());
+		state.ubo_data.light_cluster_z_scale = LIGHT_CLUSTER_DEPTH / Math::log(MAX(1.001, state.ubo_data.z_far / state.ubo_data.light_cluster_z_near));
+	}
+
 	//bg and ambient
 	if (env) {
 		state.ubo_data.bg_energy = env->bg_energy;
@@ -2985,6 +3268,171 @@ void RasterizerSceneGLES3::_setup_lights(RID *p_light_cull_result, int p_light_c
 	}
 
 	glBindBufferBase(GL_UNIFORM_BUFFER, 5, state.spot_array_ubo);
+
+	if (state.use_light_clusters) {
+		_setup_light_clusters(p_light_cull_result, p_light_cull_count, p_camera_inverse_transform, p_camera_projection);
+	}
+}
+
+static _FORCE_INLINE_ int _get_light_cluster_slice(float p_depth, float p_z_near, float p_z_scale) {
+
+	float slice;
+	if (p_z_scale < 0) {
+		slice = (p_depth - p_z_near) * -p_z_scale;
+	} else {
+		slice = Math::log(MAX(p_depth, p_z_near) / p_z_near) * p_z_scale;
+	}
+
+	return CLAMP(int(slice), 0, RasterizerSceneGLES3::LIGHT_CLUSTER_DEPTH - 1);
+}
+
+void RasterizerSceneGLES3::_setup_light_clusters(RID *p_light_cull_result, int p_light_cull_count, const Transform &p_camera_inverse_transform, const CameraMatrix &p_camera_projection) {
+
+	const int row_size = LIGHT_CLUSTER_WIDTH * LIGHT_CLUSTER_HEIGHT;
+
+	float z_near = state.ubo_data.light_cluster_z_near;
+	float z_scale = state.ubo_data.light_cluster_z_scale;
+
+	zeromem(state.light_cluster_omni_count, sizeof(uint16_t) * LIGHT_CLUSTER_COUNT);
+	zeromem(state.light_cluster_spot_count, sizeof(uint16_t) * LIGHT_CLUSTER_COUNT);
+
+	//find the range of clusters touched by the bounding sphere of every omni and spot light
+
+	int range_count = 0;
+
+	for (int i = 0; i < p_light_cull_count && i < RenderList::MAX_LIGHTS; i++) {
+
+		LightInstance *li = light_instance_owner.getptr(p_light_cull_result[i]);
+
+		if (li->light_ptr->type == VS::LIGHT_DIRECTIONAL || li->light_index >= state.max_ubo_lights) {
+			continue;
+		}
+
+		float radius = li->light_ptr->param[VS::LIGHT_PARAM_RANGE];
+		Vector3 center = p_camera_inverse_transform.xform(li->transform.origin);
+
+		float min_depth = -center.z - radius;
+		float max_depth = -center.z + radius;
+
+		if (max_depth < z_near) {
+			continue; //behind the camera
+		}
+
+		LightClusterRange &range = state.light_cluster_ranges[range_count];
+
+		range.from[0] = 0;
+		range.from[1] = 0;
+		range.to[0] = LIGHT_CLUSTER_WIDTH - 1;
+		range.to[1] = LIGHT_CLUSTER_HEIGHT - 1;
+
+		if (min_depth > z_near) {
+			//fully in front of the near plane, so the box corners can be projected safely
+
+			Vector2 min_ndc(1e20, 1e20);
+			Vector2 max_ndc(-1e20, -1e20);
+
+			for (int j = 0; j < 8; j++) {
+
+				Vector3 corner = center + Vector3(j & 1 ? radius : -radius, j & 2 ? radius : -radius, j & 4 ? radius : -radius);
+				Vector3 ndc = p_camera_projection.xform(corner);
+
+				min_ndc.x = MIN(min_ndc.x, ndc.x);
+				min_ndc.y = MIN(min_ndc.y, ndc.y);
+				max_ndc.x = MAX(max_ndc.x, ndc.x);
+				max_ndc.y = MAX(max_ndc.y, ndc.y);
+			}
+
+			if (max_ndc.x < -1 || max_ndc.y < -1 || min_ndc.x > 1 || min_ndc.y > 1) {
+				continue; //off screen
+			}
+
+			range.from[0] = CLAMP(int(Math::floor((min_ndc.x * 0.5 + 0.5) * LIGHT_CLUSTER_WIDTH)), 0, LIGHT_CLUSTER_WIDTH - 1);
+			range.from[1] = CLAMP(int(Math::floor((min_ndc.y * 0.5 + 0.5) * LIGHT_CLUSTER_HEIGHT)), 0, LIGHT_CLUSTER_HEIGHT - 1);
+			range.to[0] = CLAMP(int(Math::floor((max_ndc.x * 0.5 + 0.5) * LIGHT_CLUSTER_WIDTH)), 0, LIGHT_CLUSTER_WIDTH - 1);
+			range.to[1] = CLAMP(int(Math::floor((max_ndc.y * 0.5 + 0.5) * LIGHT_CLUSTER_HEIGHT)), 0, LIGHT_CLUSTER_HEIGHT - 1);
+		}
+
+		range.from[2] = _get_light_cluster_slice(min_depth, z_near, z_scale);
+		range.to[2] = _get_light_cluster_slice(max_depth, z_near, z_scale);
+
+		range.index = li->light_index;
+		range.cull_mask = li->light_ptr->cull_mask;
+		range.spot = li->light_ptr->type == VS::LIGHT_SPOT;
+
+		uint16_t *counts = range.spot ? state.light_cluster_spot_count : state.light_cluster_omni_count;
+
+		for (int z = range.from[2]; z <= range.to[2]; z++) {
+			for (int y = range.from[1]; y <= range.to[1]; y++) {
+				for (int x = range.from[0]; x <= range.to[0]; x++) {
+					counts[z * row_size + y * LIGHT_CLUSTER_WIDTH + x]++;
+				}
+			}
+		}
+
+		range_count++;
+	}
+
+	//lay out the item lists, omni lights first, then spot lights
+
+	uint32_t *data = state.light_cluster_data;
+	int item_count = 0;
+
+	for (int i = 0; i < LIGHT_CLUSTER_COUNT; i++) {
+
+		int available = LIGHT_CLUSTER_MAX_ITEMS - item_count;
+		int omni_count = MIN(int(state.light_cluster_omni_count[i]), available);
+		int spot_count = MIN(int(state.light_cluster_spot_count[i]), available - omni_count);
+
+		data[i * 2 + 0] = item_count;
+		data[i * 2 + 1] = uint32_t(omni_count) | (uint32_t(spot_count) << 16);
+
+		state.light_cluster_omni_cursor[i] = item_count;
+		state.light_cluster_spot_cursor[i] = item_count + omni_count;
+		item_count += omni_count + spot_count;
+	}
+
+	for (int i = 0; i < range_count; i++) {
+
+		const LightClusterRange &range = state.light_cluster_ranges[i];
+
+		for (int z = range.from[2]; z <= range.to[2]; z++) {
+			for (int y = range.from[1]; y <= range.to[1]; y++) {
+				for (int x = range.from[0]; x <= range.to[0]; x++) {
+
+					int cluster = z * row_size + y * LIGHT_CLUSTER_WIDTH + x;
+					uint32_t begin = data[cluster * 2 + 0];
+					uint32_t omni_count = data[cluster * 2 + 1] & 0xFFFF;
+					uint32_t spot_count = data[cluster * 2 + 1] >> 16;
+
+					uint32_t *cursor;
+					uint32_t end;
+
+					if (range.spot) {
+						cursor = &state.light_cluster_spot_cursor[cluster];
+						end = begin + omni_count + spot_count;
+					} else {
+						cursor = &state.light_cluster_omni_cursor[cluster];
+						end = begin + omni_count;
+					}
+
+					if (*cursor >= end) {
+						continue; //item list is full
+					}
+
+					uint32_t *item = &data[(LIGHT_CLUSTER_COUNT + *cursor) * 2];
+					item[0] = range.index;
+					item[1] = range.cull_mask;
+					(*cursor)++;
+				}
+			}
+		}
+	}
+
+	int rows = LIGHT_CLUSTER_DEPTH + (item_count + row_size - 1) / row_size;
+
+	glBindTexture(GL_TEXTURE_2D, state.light_cluster_texture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, row_size, rows, GL_RG_INTEGER, GL_UNSIGNED_INT, data);
+	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void RasterizerSceneGLES3::_setup_reflections(RID *p_reflection_probe_cull_result, int p_reflection_probe_cull_count, const Transform &p_camera_inverse_transform, const CameraMatrix &p_camera_projection, RID p_reflection_atlas, Environment *p_env) {
@@ -3155,18 +3603,25 @@ void RasterizerSceneGLES3::_copy_texture_to_front_buffer(GLuint p_texture) {
 	storage->shaders.copy.set_conditional(CopyShaderGLES3::DISABLE_ALPHA, false);
 }
 
-void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p_cull_count, bool p_depth_pass, bool p_shadow_pass) {
+void RasterizerSceneGLES3::_fill_render_list_chunk(void *p_userdata, uint32_t p_index) {
 
-	current_geometry_index = 0;
-	current_material_index = 0;
-	state.used_sss = false;
-	state.used_screen_texture = false;
+	RasterizerSceneGLES3 *self = (RasterizerSceneGLES3 *)p_userdata;
+	RenderListFillChunk *chunk = &self->fill_chunks.write[p_index];
+	RasterizerStorageGLES3 *storage = self->storage;
+	bool depth_pass = self->fill_depth_pass;
+	bool shadow_pass = self->fill_shadow_pass;
 
-	//fill list
+	chunk->item_count = 0;
+	chunk->used_sss = false;
+	chunk->used_screen_texture = false;
+	chunk->uses_time = false;
 
-	for (int i = 0; i < p_cull_count; i++) {
+	int from = p_index * FILL_CHUNK_INSTANCES;
+	int to = MIN(from + FILL_CHUNK_INSTANCES, self->fill_cull_count);
 
-		InstanceBase *inst = p_cull_result[i];
+	for (int i = from; i < to; i++) {
+
+		InstanceBase *inst = self->fill_cull_result[i];
 		switch (inst->base_type) {
 
 			case VS::INSTANCE_MESH: {
@@ -3180,7 +3635,7 @@ void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p
 
 					int mat_idx = inst->materials[i].is_valid() ? i : -1;
 					RasterizerStorageGLES3::Surface *s = mesh->surfaces[i];
-					_add_geometry(s, inst, NULL, mat_idx, p_depth_pass, p_shadow_pass);
+					self->_add_geometry(chunk, s, inst, NULL, mat_idx, depth_pass, shadow_pass);
 				}
 
 				//mesh->last_pass=frame;
@@ -3203,7 +3658,7 @@ void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p
 				for (int i = 0; i < ssize; i++) {
 
 					RasterizerStorageGLES3::Surface *s = mesh->surfaces[i];
-					_add_geometry(s, inst, multi_mesh, -1, p_depth_pass, p_shadow_pass);
+					self->_add_geometry(chunk, s, inst, multi_mesh, -1, depth_pass, shadow_pass);
 				}
 
 			} break;
@@ -3212,7 +3667,7 @@ void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p
 				RasterizerStorageGLES3::Immediate *immediate = storage->immediate_owner.getptr(inst->base);
 				ERR_CONTINUE(!immediate);
 
-				_add_geometry(immediate, inst, NULL, -1, p_depth_pass, p_shadow_pass);
+				self->_add_geometry(chunk, immediate, inst, NULL, -1, depth_pass, shadow_pass);
 
 			} break;
 			case VS::INSTANCE_PARTICLES: {
@@ -3234,7 +3689,7 @@ void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p
 					for (int j = 0; j < ssize; j++) {
 
 						RasterizerStorageGLES3::Surface *s = mesh->surfaces[j];
-						_add_geometry(s, inst, particles, -1, p_depth_pass, p_shadow_pass);
+						self->_add_geometry(chunk, s, inst, particles, -1, depth_pass, shadow_pass);
 					}
 				}
 
@@ -3243,6 +3698,90 @@ void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p
 	}
 }
 
+void RasterizerSceneGLES3::_fill_render_list(InstanceBase **p_cull_result, int p_cull_count, bool p_depth_pass, bool p_shadow_pass) {
+
+	current_geometry_index = 0;
+	current_material_index = 0;
+	state.used_sss = false;
+	state.used_screen_texture = false;
+
+	int chunk_count = (p_cull_count + FILL_CHUNK_INSTANCES - 1) / FILL_CHUNK_INSTANCES;
+	if (chunk_count == 0)
+		return;
+
+	if (fill_chunks.size() < chunk_count) {
+		fill_chunks.resize(chunk_count);
+	}
+
+	fill_cull_result = p_cull_result;
+	fill_cull_count = p_cull_count;
+	fill_depth_pass = p_depth_pass;
+	fill_shadow_pass = p_shadow_pass;
+
+	// Chunks only read instance, storage and scene state, so they can be processed
+	// at the same time. Everything shared is written by the merge below.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && chunk_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_fill_render_list_chunk, this, chunk_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < chunk_count; i++) {
+			_fill_render_list_chunk(this, i);
+		}
+	}
+
+	fill_cull_result = NULL;
+
+	//merge in cull order, so indices and sorting are the same as a serial fill
+
+	for (int i = 0; i < chunk_count; i++) {
+
+		const RenderListFillChunk &chunk = fill_chunks[i];
+
+		if (chunk.used_sss) {
+			state.used_sss = true;
+		}
+
+		if (chunk.used_screen_texture) {
+			state.used_screen_texture = true;
+		}
+
+		if (chunk.uses_time) {
+			VisualServerRaster::redraw_request();
+		}
+
+		const RenderListFillItem *items = chunk.items.ptr();
+
+		for (int j = 0; j < chunk.item_count; j++) {
+
+			const RenderListFillItem &item = items[j];
+			RenderList::Element *e = item.alpha ? render_list.add_alpha_element() : render_list.add_element();
+
+			if (!e)
+				return;
+
+			e->geometry = item.geometry;
+			e->material = item.material;
+			e->instance = item.instance;
+			e->owner = item.owner;
+			e->sort_key = item.sort_key;
+
+			if (e->geometry->last_pass != render_pass) {
+				e->geometry->last_pass = render_pass;
+				e->geometry->index = current_geometry_index++;
+			}
+
+			if (!p_depth_pass && e->material->last_pass != render_pass) {
+				e->material->last_pass = render_pass;
+				e->material->index = current_material_index++;
+			}
+
+			e->sort_key |= uint64_t(e->geometry->index) << RenderList::SORT_KEY_GEOMETRY_INDEX_SHIFT;
+			e->sort_key |= uint64_t(e->material->index) << RenderList::SORT_KEY_MATERIAL_INDEX_SHIFT;
+		}
+	}
+}
+
 void RasterizerSceneGLES3::_blur_effect_buffer() {
 
 	//blur diffuse into effect mipmaps using separatable convolution
@@ -3293,6 +3832,9 @@ void RasterizerSceneGLES3::_render_mrts(Environment *env, const CameraMatrix &p_
 	}
 
 	if (env->ssao_enabled) {
+
+		storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_SSAO);
+
 		//copy diffuse to front buffer
 		glBindFramebuffer(GL_READ_FRAMEBUFFER, storage->frame.current_rt->buffers.fbo);
 		glReadBuffer(GL_COLOR_ATTACHMENT0);
@@ -3334,10 +3876,23 @@ void RasterizerSceneGLES3::_render_mrts(Environment *env, const CameraMatrix &p_
 		ss[0] = storage->frame.current_rt->width;
 		ss[1] = storage->frame.current_rt->height;
 
-		glViewport(0, 0, ss[0], ss[1]);
+		// at reduced resolution, SSAO and its blur only fill the bottom-left corner of the buffers
+		int ssao_shift = 0;
+		if (env->ssao_resolution == VS::ENV_SSAO_RESOLUTION_HALF) {
+			ssao_shift = 1;
+		} else if (env->ssao_resolution == VS::ENV_SSAO_RESOLUTION_QUARTER) {
+			ssao_shift = 2;
+		}
 
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc(GL_GREATER);
+		GLint ssao_ss[2] = { MAX(1, ss[0] >> ssao_shift), MAX(1, ss[1] >> ssao_shift) };
+
+		glViewport(0, 0, ssao_ss[0], ssao_ss[1]);
+
+		if (ssao_shift == 0) {
+			//depth buffer matches, use it to skip the sky
+			glEnable(GL_DEPTH_TEST);
+			glDepthFunc(GL_GREATER);
+		}
 		// do SSAO!
 		state.ssao_shader.set_conditional(SsaoShaderGLES3::ENABLE_RADIUS2, env->ssao_radius2 > 0.001);
 		state.ssao_shader.set_conditional(SsaoShaderGLES3::USE_ORTHOGONAL_PROJECTION, p_cam_projection.is_orthogonal());
@@ -3347,6 +3902,7 @@ void RasterizerSceneGLES3::_render_mrts(Environment *env, const CameraMatrix &p_
 		state.ssao_shader.set_uniform(SsaoShaderGLES3::CAMERA_Z_FAR, p_cam_projection.get_z_far());
 		state.ssao_shader.set_uniform(SsaoShaderGLES3::CAMERA_Z_NEAR, p_cam_projection.get_z_near());
 		glUniform2iv(state.ssao_shader.get_uniform(SsaoShaderGLES3::SCREEN_SIZE), 1, ss);
+		state.ssao_shader.set_uniform(SsaoShaderGLES3::RESOLUTION_SHIFT, ssao_shift);
 		float radius = env->ssao_radius;
 		state.ssao_shader.set_uniform(SsaoShaderGLES3::RADIUS, radius);
 		float intensity = env->ssao_intensity;
@@ -3400,7 +3956,8 @@ void RasterizerSceneGLES3::_render_mrts(Environment *env, const CameraMatrix &p_
 
 				GLint axis[2] = { i, 1 - i };
 				glUniform2iv(state.ssao_blur_shader.get_uniform(SsaoBlurShaderGLES3::AXIS), 1, axis);
-				glUniform2iv(state.ssao_blur_shader.get_uniform(SsaoBlurShaderGLES3::SCREEN_SIZE), 1, ss);
+				glUniform2iv(state.ssao_blur_shader.get_uniform(SsaoBlurShaderGLES3::SCREEN_SIZE), 1, ssao_ss);
+				state.ssao_blur_shader.set_uniform(SsaoBlurShaderGLES3::RESOLUTION_SHIFT, ssao_shift);
 
 				glActiveTexture(GL_TEXTURE0);
 				glBindTexture(GL_TEXTURE_2D, storage->frame.current_rt->effects.ssao.blur_red[i]);
@@ -3419,11 +3976,23 @@ void RasterizerSceneGLES3::_render_mrts(Environment *env, const CameraMatrix &p_
 		glDisable(GL_DEPTH_TEST);
 		glDepthFunc(GL_LEQUAL);
 
+		glViewport(0, 0, ss[0], ss[1]);
+
 		// just copy diffuse while applying SSAO
 
 		state.effect_blur_shader.set_conditional(EffectBlurShaderGLES3::SSAO_MERGE, true);
+		state.effect_blur_shader.set_conditional(EffectBlurShaderGLES3::SSAO_MERGE_UPSCALE, ssao_shift > 0);
+		state.effect_blur_shader.set_conditional(EffectBlurShaderGLES3::USE_ORTHOGONAL_PROJECTION, ssao_shift > 0 && p_cam_projection.is_orthogonal());
 		state.effect_blur_shader.bind();
 		state.effect_blur_shader.set_uniform(EffectBlurShaderGLES3::SSAO_COLOR, env->ssao_color);
+		if (ssao_shift > 0) {
+			state.effect_blur_shader.set_uniform(EffectBlurShaderGLES3::CAMERA_Z_FAR, p_cam_projection.get_z_far());
+			state.effect_blur_shader.set_uniform(EffectBlurShaderGLES3::CAMERA_Z_NEAR, p_cam_projection.get_z_near());
+			state.effect_blur_shader.set_uniform(EffectBlurShaderGLES3::SSAO_RESOLUTION_SHIFT, ssao_shift);
+			glUniform2iv(state.effect_blur_shader.get_uniform(EffectBlurShaderGLES3::SSAO_SIZE), 1, ssao_ss);
+			glActiveTexture(GL_TEXTURE2);
+			glBindTexture(GL_TEXTURE_2D, storage->frame.current_rt->depth);
+		}
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, storage->frame.current_rt->color); //previous level, since mipmaps[0] starts one level bigger
 		glActiveTexture(GL_TEXTURE1);
@@ -3431,6 +4000,10 @@ void RasterizerSceneGLES3::_render_mrts(Environment *env, const CameraMatrix &p_
 		glBindFramebuffer(GL_FRAMEBUFFER, storage->frame.current_rt->effects.mip_maps[0].sizes[0].fbo); // copy to base level
 		_copy_screen(true);
 		state.effect_blur_shader.set_conditional(EffectBlurShaderGLES3::SSAO_MERGE, false);
+		state.effect_blur_shader.set_conditional(EffectBlurShaderGLES3::SSAO_MERGE_UPSCALE, false);
+		state.effect_blur_shader.set_conditional(EffectBlurShaderGLES3::USE_ORTHOGONAL_PROJECTION, false);
+
+		storage->gpu_timer_end();
 
 	} else {
 
@@ -3893,6 +4466,8 @@ void RasterizerSceneGLES3::_post_process(Environment *env, const CameraMatrix &p
 
 	if (env->glow_enabled) {
 
+		storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_GLOW);
+
 		for (int i = 0; i < VS::MAX_GLOW_LEVELS; i++) {
 			if (env->glow_levels & (1 << i)) {
 
@@ -3966,6 +4541,8 @@ void RasterizerSceneGLES3::_post_process(Environment *env, const CameraMatrix &p
 		}
 
 		glViewport(0, 0, storage->frame.current_rt->width, storage->frame.current_rt->height);
+
+		storage->gpu_timer_end();
 	}
 
 	glBindFramebuffer(GL_FRAMEBUFFER, storage->frame.current_rt->fbo);
@@ -4031,6 +4608,8 @@ void RasterizerSceneGLES3::_post_process(Environment *env, const CameraMatrix &p
 	state.tonemap_shader.set_conditional(TonemapShaderGLES3::V_FLIP, storage->frame.current_rt->flags[RasterizerStorage::RENDER_TARGET_VFLIP]);
 	state.tonemap_shader.bind();
 
+	storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_TONEMAP);
+
 	state.tonemap_shader.set_uniform(TonemapShaderGLES3::EXPOSURE, env->tone_mapper_exposure);
 	state.tonemap_shader.set_uniform(TonemapShaderGLES3::WHITE, env->tone_mapper_exposure_white);
 
@@ -4058,6 +4637,8 @@ void RasterizerSceneGLES3::_post_process(Environment *env, const CameraMatrix &p
 
 	_copy_screen(true, true);
 
+	storage->gpu_timer_end();
+
 	//turn off everything used
 	state.tonemap_shader.set_conditional(TonemapShaderGLES3::USE_AUTO_EXPOSURE, false);
 	state.tonemap_shader.set_conditional(TonemapShaderGLES3::USE_FILMIC_TONEMAPPER, false);
@@ -4084,10 +4665,18 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 	//first of all, make a new render pass
 	render_pass++;
 
+	// the second eye of a stereo frame draws the lists the first one built for the same cull result
+	bool reuse_lists = stereo_pass == STEREO_PASS_SECOND_EYE && stereo_lists_valid && stereo_cull_result == p_cull_result && stereo_cull_count == p_cull_count && !p_reflection_probe.is_valid();
+	bool keep_lists = stereo_pass == STEREO_PASS_FIRST_EYE && !p_reflection_probe.is_valid();
+	stereo_lists_valid = false;
+
 	//fill up ubo
 
 	storage->info.render.object_count += p_cull_count;
 
+	state.multimesh_cull_planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	state.multimesh_cull_origin = p_cam_transform.origin;
+
 	Environment *env = environment_owner.getornull(p_environment);
 	ShadowAtlas *shadow_atlas = shadow_atlas_owner.getornull(p_shadow_atlas);
 	ReflectionAtlas *reflection_atlas = reflection_atlas_owner.getornull(p_reflection_atlas);
@@ -4135,6 +4724,8 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 
 	state.used_contact_shadows = true;
 
+	storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_OPAQUE);
+
 	if (!storage->config.no_depth_prepass && storage->frame.current_rt && state.debug_draw != VS::VIEWPORT_DEBUG_DRAW_OVERDRAW) { //detect with state.used_contact_shadows too
 		//pre z pass
 
@@ -4151,11 +4742,33 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 		glClearDepth(1.0f);
 		glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-		render_list.clear();
-		_fill_render_list(p_cull_result, p_cull_count, true, false);
-		render_list.sort_by_key(false);
+		RenderList::Element **depth_elements = render_list.elements;
+		int depth_element_count = 0;
+
+		if (reuse_lists) {
+			depth_elements = stereo_depth_list.ptrw();
+			depth_element_count = stereo_depth_list.size();
+		} else {
+			render_list.clear();
+			_fill_render_list(p_cull_result, p_cull_count, true, false);
+			render_list.sort_by_key(false);
+			depth_element_count = render_list.element_count;
+
+			if (keep_lists) {
+				// the main pass refills render_list, so keep a copy of the depth list
+				stereo_depth_elements.resize(depth_element_count);
+				stereo_depth_list.resize(depth_element_count);
+				RenderList::Element *ew = stereo_depth_elements.ptrw();
+				RenderList::Element **lw = stereo_depth_list.ptrw();
+				for (int i = 0; i < depth_element_count; i++) {
+					ew[i] = *render_list.elements[i];
+					lw[i] = &ew[i];
+				}
+			}
+		}
+
 		state.scene_shader.set_conditional(SceneShaderGLES3::RENDER_DEPTH, true);
-		_render_list(render_list.elements, render_list.element_count, p_cam_transform, p_cam_projection, 0, false, false, true, false, false);
+		_render_list(depth_elements, depth_element_count, p_cam_transform, p_cam_projection, 0, false, false, true, false, false);
 		state.scene_shader.set_conditional(SceneShaderGLES3::RENDER_DEPTH, false);
 
 		glColorMask(1, 1, 1, 1);
@@ -4185,8 +4798,10 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 
 	bool use_mrt = false;
 
-	render_list.clear();
-	_fill_render_list(p_cull_result, p_cull_count, false, false);
+	if (!reuse_lists) {
+		render_list.clear();
+		_fill_render_list(p_cull_result, p_cull_count, false, false);
+	}
 	//
 
 	glEnable(GL_BLEND);
@@ -4378,7 +4993,9 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 		glDisable(GL_BLEND);
 	}
 
-	render_list.sort_by_key(false);
+	if (!reuse_lists) {
+		render_list.sort_by_key(false);
+	}
 
 	if (state.directional_light_count == 0) {
 		directional_light = NULL;
@@ -4417,6 +5034,8 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 
 	//state.scene_shader.set_conditional( SceneShaderGLES3::USE_FOG,false);
 
+	storage->gpu_timer_end();
+
 	if (use_mrt) {
 		_render_mrts(env, p_cam_projection);
 	} else {
@@ -4445,7 +5064,18 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 	glEnable(GL_DEPTH_TEST);
 	glDisable(GL_SCISSOR_TEST);
 
-	render_list.sort_by_reverse_depth_and_priority(true);
+	if (!reuse_lists) {
+		// instance depths come from the culling camera, so the order is the same for both eyes
+		render_list.sort_by_reverse_depth_and_priority(true);
+	}
+
+	if (keep_lists) {
+		stereo_lists_valid = true;
+		stereo_cull_result = p_cull_result;
+		stereo_cull_count = p_cull_count;
+	}
+
+	storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_TRANSPARENT);
 
 	if (state.directional_light_count == 0) {
 		directional_light = NULL;
@@ -4458,6 +5088,8 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 		}
 	}
 
+	storage->gpu_timer_end();
+
 	if (probe) {
 		//rendering a probe, do no more!
 		return;
@@ -4523,9 +5155,14 @@ void RasterizerSceneGLES3::render_scene(const Transform &p_cam_transform, const
 void RasterizerSceneGLES3::render_shadow(RID p_light, RID p_shadow_atlas, int p_pass, InstanceBase **p_cull_result, int p_cull_count) {
 
 	render_pass++;
+	stereo_lists_valid = false; //render_list is reused below
 
 	directional_light = NULL;
 
+	state.multimesh_cull_planes.clear(); //casters out of view still cast
+
+	storage->gpu_timer_begin(RasterizerStorageGLES3::GPU_TIMER_SHADOWS);
+
 	LightInstance *light_instance = light_instance_owner.getornull(p_light);
 	ERR_FAIL_COND(!light_instance);
 	RasterizerStorageGLES3::Light *light = storage->light_owner.getornull(light_instance->light);
@@ -4790,12 +5427,18 @@ void RasterizerSceneGLES3::render_shadow(RID p_light, RID p_shadow_atlas, int p_
 	}
 
 	glColorMask(1, 1, 1, 1);
+
+	storage->gpu_timer_end();
 }
 
 void RasterizerSceneGLES3::set_scene_pass(uint64_t p_pass) {
 	scene_pass = p_pass;
 }
 
+void RasterizerSceneGLES3::set_stereo_pass(StereoPass p_pass) {
+	stereo_pass = p_pass;
+}
+
 bool RasterizerSceneGLES3::free(RID p_rid) {
 
 	if (light_instance_owner.owns(p_rid)) {
@@ -4853,6 +5496,11 @@ void RasterizerSceneGLES3::initialize() {
 
 	render_pass = 0;
 
+	stereo_pass = STEREO_PASS_NONE;
+	stereo_lists_valid = false;
+	stereo_cull_result = NULL;
+	stereo_cull_count = 0;
+
 	state.scene_shader.init();
 
 	{
@@ -5112,6 +5760,52 @@ void RasterizerSceneGLES3::initialize() {
 		glGenVertexArrays(1, &state.immediate_array);
 	}
 
+	{
+		//texel rows for cluster headers, followed by rows for the light items they point to
+		state.use_light_clusters = GLOBAL_GET("rendering/quality/shading/use_light_clusters");
+
+		int row_size = LIGHT_CLUSTER_WIDTH * LIGHT_CLUSTER_HEIGHT;
+		int rows = LIGHT_CLUSTER_DEPTH + LIGHT_CLUSTER_MAX_ITEMS / row_size;
+
+		state.light_cluster_data = (uint32_t *)memalloc(sizeof(uint32_t) * 2 * row_size * rows);
+		state.light_cluster_omni_count = (uint16_t *)memalloc(sizeof(uint16_t) * LIGHT_CLUSTER_COUNT);
+		state.light_cluster_spot_count = (uint16_t *)memalloc(sizeof(uint16_t) * LIGHT_CLUSTER_COUNT);
+		state.light_cluster_omni_cursor = (uint32_t *)memalloc(sizeof(uint32_t) * LIGHT_CLUSTER_COUNT);
+		state.light_cluster_spot_cursor = (uint32_t *)memalloc(sizeof(uint32_t) * LIGHT_CLUSTER_COUNT);
+		state.light_cluster_ranges = (LightClusterRange *)memalloc(sizeof(LightClusterRange) * RenderList::MAX_LIGHTS);
+
+		glGenTextures(1, &state.light_cluster_texture);
+		glBindTexture(GL_TEXTURE_2D, state.light_cluster_texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, row_size, rows, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		if (state.use_light_clusters) {
+			state.scene_shader.add_custom_define("#define USE_LIGHT_CLUSTERS\n");
+		}
+		state.scene_shader.add_custom_define("#define LIGHT_CLUSTER_WIDTH " + itos(LIGHT_CLUSTER_WIDTH) + "\n");
+		state.scene_shader.add_custom_define("#define LIGHT_CLUSTER_HEIGHT " + itos(LIGHT_CLUSTER_HEIGHT) + "\n");
+		state.scene_shader.add_custom_define("#define LIGHT_CLUSTER_DEPTH " + itos(LIGHT_CLUSTER_DEPTH) + "\n");
+	}
+
+	{
+		//per instance transforms (3 rows of 4 floats) for merging identical meshes into one instanced draw
+		state.use_auto_instancing = GLOBAL_DEF("rendering/quality/auto_instancing/enable", true);
+		uint32_t auto_instancing_buffer_size = GLOBAL_DEF("rendering/limits/buffers/auto_instancing_buffer_size_kb", 48);
+
+		state.auto_instancing_buffer_size = auto_instancing_buffer_size * 1024;
+		state.max_auto_instances = MAX(1, int(state.auto_instancing_buffer_size / (sizeof(float) * 12)));
+		state.auto_instancing_tmp = (float *)memalloc(state.max_auto_instances * sizeof(float) * 12);
+
+		glGenBuffers(1, &state.auto_instancing_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, state.auto_instancing_buffer);
+		glBufferData(GL_ARRAY_BUFFER, state.auto_instancing_buffer_size, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
 #ifdef GLES_OVER_GL
 	//"desktop" opengl needs this.
 	glEnable(GL_PROGRAM_POINT_SIZE);
@@ -5210,4 +5904,12 @@ RasterizerSceneGLES3::~RasterizerSceneGLES3() {
 	memfree(state.spot_array_tmp);
 	memfree(state.omni_array_tmp);
 	memfree(state.reflection_array_tmp);
+	memfree(state.auto_instancing_tmp);
+
+	memfree(state.light_cluster_data);
+	memfree(state.light_cluster_omni_count);
+	memfree(state.light_cluster_spot_count);
+	memfree(state.light_cluster_omni_cursor);
+	memfree(state.light_cluster_spot_cursor);
+	memfree(state.light_cluster_ranges);
 }
@@ -92,6 +92,22 @@ public:
 	Vector<RasterizerStorageGLES3::RenderTarget::Exposure> exposure_shrink;
 	int exposure_shrink_size;
 
+	enum {
+		LIGHT_CLUSTER_WIDTH = 16,
+		LIGHT_CLUSTER_HEIGHT = 8,
+		LIGHT_CLUSTER_DEPTH = 24,
+		LIGHT_CLUSTER_COUNT = LIGHT_CLUSTER_WIDTH * LIGHT_CLUSTER_HEIGHT * LIGHT_CLUSTER_DEPTH,
+		LIGHT_CLUSTER_MAX_ITEMS = 32768, //must be a multiple of LIGHT_CLUSTER_WIDTH * LIGHT_CLUSTER_HEIGHT
+	};
+
+	struct LightClusterRange {
+		uint32_t index;
+		uint32_t cull_mask;
+		bool spot;
+		int from[3];
+		int to[3];
+	};
+
 	struct State {
 
 		bool texscreen_copied;
@@ -152,8 +168,9 @@ public:
 			float fog_height_min;
 			float fog_height_max;
 			float fog_height_curve;
-			// make sure this struct is padded to be a multiple of 16 bytes for webgl
-			float pad[2];
+			// these two also pad the struct to be a multiple of 16 bytes for webgl
+			float light_cluster_z_near;
+			float light_cluster_z_scale; //negative for linear (orthogonal) slicing
 
 		} ubo_data;
 
@@ -181,11 +198,29 @@ public:
 		GLuint immediate_buffer;
 		GLuint immediate_array;
 
+		bool use_auto_instancing;
+		GLuint auto_instancing_buffer;
+		uint32_t auto_instancing_buffer_size;
+		int max_auto_instances;
+		float *auto_instancing_tmp;
+
+		Vector<Plane> multimesh_cull_planes; //world space, empty when multimesh chunks are not culled
+		Vector3 multimesh_cull_origin;
+
 		uint32_t ubo_light_size;
 		uint8_t *spot_array_tmp;
 		uint8_t *omni_array_tmp;
 		uint8_t *reflection_array_tmp;
 
+		bool use_light_clusters;
+		GLuint light_cluster_texture;
+		uint32_t *light_cluster_data; //cluster headers followed by light items, two values per texel
+		uint16_t *light_cluster_omni_count;
+		uint16_t *light_cluster_spot_count;
+		uint32_t *light_cluster_omni_cursor;
+		uint32_t *light_cluster_spot_cursor;
+		LightClusterRange *light_cluster_ranges;
+
 		int max_ubo_lights;
 		int max_forward_lights_per_object;
 		int max_ubo_reflections;
@@ -393,6 +428,7 @@ public:
 		VS::EnvironmentSSAOQuality ssao_quality;
 		float ssao_bilateral_sharpness;
 		VS::EnvironmentSSAOBlur ssao_filter;
+		VS::EnvironmentSSAOResolution ssao_resolution;
 
 		bool glow_enabled;
 		int glow_levels;
@@ -473,6 +509,7 @@ public:
 			ssao_filter = VS::ENV_SSAO_BLUR_3x3;
 			ssao_quality = VS::ENV_SSAO_QUALITY_LOW;
 			ssao_bilateral_sharpness = 4;
+			ssao_resolution = VS::ENV_SSAO_RESOLUTION_FULL;
 
 			tone_mapper = VS::ENV_TONE_MAPPER_LINEAR;
 			tone_mapper_exposure = 1.0;
@@ -549,6 +586,7 @@ public:
 
 	virtual void environment_set_ssr(RID p_env, bool p_enable, int p_max_steps, float p_fade_in, float p_fade_out, float p_depth_tolerance, bool p_roughness);
 	virtual void environment_set_ssao(RID p_env, bool p_enable, float p_radius, float p_intensity, float p_radius2, float p_intensity2, float p_bias, float p_light_affect, float p_ao_channel_affect, const Color &p_color, VS::EnvironmentSSAOQuality p_quality, VS::EnvironmentSSAOBlur p_blur, float p_bilateral_sharpness);
+	virtual void environment_set_ssao_resolution(RID p_env, VS::EnvironmentSSAOResolution p_resolution);
 
 	virtual void environment_set_tonemap(RID p_env, VS::EnvironmentToneMapper p_tone_mapper, float p_exposure, float p_white, bool p_auto_exposure, float p_min_luminance, float p_max_luminance, float p_auto_exp_speed, float p_auto_exp_scale);
 
@@ -713,7 +751,74 @@ public:
 			alpha_element_count = 0;
 		}
 
-		//should eventually be replaced by radix
+		// Opaque and shadow lists are sorted by a 64 bits key (material, geometry,
+		// or the depth bits), which radix sorts much faster than comparing Element
+		// pointers. Small lists keep using the comparison sort.
+
+		enum {
+			RADIX_SORT_THRESHOLD = 256
+		};
+
+		struct SortPair {
+			uint64_t key;
+			Element *element;
+		};
+
+		SortPair *sort_pairs;
+		SortPair *sort_pairs_tmp;
+
+		static _FORCE_INLINE_ uint64_t _get_depth_sort_key(float p_depth) {
+
+			// flip the float bits so unsigned order matches float order
+			union {
+				float f;
+				uint32_t u;
+			} depth;
+			depth.f = p_depth;
+			return (depth.u & 0x80000000) ? ~depth.u : (depth.u | 0x80000000);
+		}
+
+		void _radix_sort(Element **p_elements, int p_count) {
+
+			// expects sort_pairs to be filled, stable LSD sort with 8 bit digits
+			uint32_t histogram[8][256];
+			memset(histogram, 0, sizeof(histogram));
+
+			for (int i = 0; i < p_count; i++) {
+				uint64_t key = sort_pairs[i].key;
+				for (int j = 0; j < 8; j++) {
+					histogram[j][(key >> (j * 8)) & 0xFF]++;
+				}
+			}
+
+			SortPair *src = sort_pairs;
+			SortPair *dst = sort_pairs_tmp;
+
+			for (int j = 0; j < 8; j++) {
+
+				uint32_t *h = histogram[j];
+				if (h[(src[0].key >> (j * 8)) & 0xFF] == uint32_t(p_count))
+					continue; //all keys share this digit, nothing to do
+
+				uint32_t offset = 0;
+				for (int k = 0; k < 256; k++) {
+					uint32_t c = h[k];
+					h[k] = offset;
+					offset += c;
+				}
+
+				for (int i = 0; i < p_count; i++) {
+					const SortPair &pair = src[i];
+					dst[h[(pair.key >> (j * 8)) & 0xFF]++] = pair;
+				}
+
+				SWAP(src, dst);
+			}
+
+			for (int i = 0; i < p_count; i++) {
+				p_elements[i] = src[i].element;
+			}
+		}
 
 		struct SortByKey {
 
@@ -724,12 +829,20 @@ public:
 
 		void sort_by_key(bool p_alpha) {
 
-			SortArray<Element *, SortByKey> sorter;
-			if (p_alpha) {
-				sorter.sort(&elements[max_elements - alpha_element_count], alpha_element_count);
-			} else {
-				sorter.sort(elements, element_count);
+			Element **list = p_alpha ? &elements[max_elements - alpha_element_count] : elements;
+			int count = p_alpha ? alpha_element_count : element_count;
+
+			if (count < RADIX_SORT_THRESHOLD) {
+				SortArray<Element *, SortByKey> sorter;
+				sorter.sort(list, count);
+				return;
 			}
+
+			for (int i = 0; i < count; i++) {
+				sort_pairs[i].key = list[i]->sort_key;
+				sort_pairs[i].element = list[i];
+			}
+			_radix_sort(list, count);
 		}
 
 		struct SortByDepth {
@@ -741,12 +854,20 @@ public:
 
 		void sort_by_depth(bool p_alpha) { //used for shadows
 
-			SortArray<Element *, SortByDepth> sorter;
-			if (p_alpha) {
-				sorter.sort(&elements[max_elements - alpha_element_count], alpha_element_count);
-			} else {
-				sorter.sort(elements, element_count);
+			Element **list = p_alpha ? &elements[max_elements - alpha_element_count] : elements;
+			int count = p_alpha ? alpha_element_count : element_count;
+
+			if (count < RADIX_SORT_THRESHOLD) {
+				SortArray<Element *, SortByDepth> sorter;
+				sorter.sort(list, count);
+				return;
+			}
+
+			for (int i = 0; i < count; i++) {
+				sort_pairs[i].key = _get_depth_sort_key(list[i]->instance->depth);
+				sort_pairs[i].element = list[i];
 			}
+			_radix_sort(list, count);
 		}
 
 		struct SortByReverseDepthAndPriority {
@@ -796,6 +917,8 @@ public:
 			alpha_element_count = 0;
 			elements = memnew_arr(Element *, max_elements);
 			base_elements = memnew_arr(Element, max_elements);
+			sort_pairs = memnew_arr(SortPair, max_elements);
+			sort_pairs_tmp = memnew_arr(SortPair, max_elements);
 			for (int i = 0; i < max_elements; i++)
 				elements[i] = &base_elements[i]; // assign elements
 		}
@@ -808,6 +931,8 @@ public:
 		~RenderList() {
 			memdelete_arr(elements);
 			memdelete_arr(base_elements);
+			memdelete_arr(sort_pairs);
+			memdelete_arr(sort_pairs_tmp);
 		}
 	};
 
@@ -816,30 +941,98 @@ public:
 
 	RenderList render_list;
 
+	// render lists of the first eye, kept for the second one
+	StereoPass stereo_pass;
+	bool stereo_lists_valid;
+	InstanceBase **stereo_cull_result;
+	int stereo_cull_count;
+	Vector<RenderList::Element> stereo_depth_elements;
+	Vector<RenderList::Element *> stereo_depth_list;
+
 	_FORCE_INLINE_ void _set_cull(bool p_front, bool p_disabled, bool p_reverse_cull);
 
 	_FORCE_INLINE_ bool _setup_material(RasterizerStorageGLES3::Material *p_material, bool p_alpha_pass);
 	_FORCE_INLINE_ void _setup_geometry(RenderList::Element *e, const Transform &p_view_transform);
+	_FORCE_INLINE_ void _setup_vertex_decode(RasterizerStorageGLES3::Geometry *p_geometry);
 	_FORCE_INLINE_ void _render_geometry(RenderList::Element *e);
+
+	void _setup_multimesh_instances(const RasterizerStorageGLES3::MultiMesh *p_multimesh, int p_from);
+	void _draw_multimesh_instances(const RasterizerStorageGLES3::Surface *s, int p_amount);
+	_FORCE_INLINE_ bool _is_multimesh_chunk_visible(const InstanceBase *p_instance, const AABB &p_aabb) const;
+
+	_FORCE_INLINE_ bool _can_auto_instance(const RenderList::Element *e) const;
+	_FORCE_INLINE_ bool _can_auto_instance_with(const RenderList::Element *e, const RenderList::Element *p_other) const;
+	_FORCE_INLINE_ void _setup_auto_instancing(RenderList::Element **p_elements, int p_count);
+	_FORCE_INLINE_ void _render_auto_instancing(RenderList::Element *e, int p_count);
 	_FORCE_INLINE_ void _setup_light(RenderList::Element *e, const Transform &p_view_transform);
 
 	void _render_list(RenderList::Element **p_elements, int p_element_count, const Transform &p_view_transform, const CameraMatrix &p_projection, GLuint p_base_env, bool p_reverse_cull, bool p_alpha_pass, bool p_shadow, bool p_directional_add, bool p_directional_shadows);
 
-	_FORCE_INLINE_ void _add_geometry(RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, int p_material, bool p_depth_pass, bool p_shadow_pass);
+	// The render list is filled in two steps: culled instances are split in
+	// chunks that resolve materials and sort keys in parallel, then the chunks
+	// are merged in order, assigning the geometry and material indices.
+
+	enum {
+		FILL_CHUNK_INSTANCES = 128
+	};
+
+	struct RenderListFillItem {
+
+		RasterizerStorageGLES3::Geometry *geometry;
+		RasterizerStorageGLES3::Material *material;
+		InstanceBase *instance;
+		RasterizerStorageGLES3::GeometryOwner *owner;
+		uint64_t sort_key; //without geometry and material indices
+		bool alpha;
+	};
+
+	struct RenderListFillChunk {
+
+		Vector<RenderListFillItem> items;
+		int item_count;
+		bool used_sss;
+		bool used_screen_texture;
+		bool uses_time;
+
+		_FORCE_INLINE_ RenderListFillItem *add_item() {
+
+			if (item_count == items.size()) {
+				items.resize(MAX(64, item_count * 2));
+			}
+			return &items.write[item_count++];
+		}
+
+		RenderListFillChunk() {
+			item_count = 0;
+			used_sss = false;
+			used_screen_texture = false;
+			uses_time = false;
+		}
+	};
+
+	Vector<RenderListFillChunk> fill_chunks;
+	InstanceBase **fill_cull_result;
+	int fill_cull_count;
+	bool fill_depth_pass;
+	bool fill_shadow_pass;
+
+	_FORCE_INLINE_ void _add_geometry(RenderListFillChunk *p_chunk, RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, int p_material, bool p_depth_pass, bool p_shadow_pass);
 
-	_FORCE_INLINE_ void _add_geometry_with_material(RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, RasterizerStorageGLES3::Material *p_material, bool p_depth_pass, bool p_shadow_pass);
+	_FORCE_INLINE_ void _add_geometry_with_material(RenderListFillChunk *p_chunk, RasterizerStorageGLES3::Geometry *p_geometry, InstanceBase *p_instance, RasterizerStorageGLES3::GeometryOwner *p_owner, RasterizerStorageGLES3::Material *p_material, bool p_depth_pass, bool p_shadow_pass);
 
 	void _draw_sky(RasterizerStorageGLES3::Sky *p_sky, const CameraMatrix &p_projection, const Transform &p_transform, bool p_vflip, float p_custom_fov, float p_energy);
 
 	void _setup_environment(Environment *env, const CameraMatrix &p_cam_projection, const Transform &p_cam_transform);
 	void _setup_directional_light(int p_index, const Transform &p_camera_inverse_transform, bool p_use_shadows);
 	void _setup_lights(RID *p_light_cull_result, int p_light_cull_count, const Transform &p_camera_inverse_transform, const CameraMatrix &p_camera_projection, RID p_shadow_atlas);
+	void _setup_light_clusters(RID *p_light_cull_result, int p_light_cull_count, const Transform &p_camera_inverse_transform, const CameraMatrix &p_camera_projection);
 	void _setup_reflections(RID *p_reflection_probe_cull_result, int p_reflection_probe_cull_count, const Transform &p_camera_inverse_transform, const CameraMatrix &p_camera_projection, RID p_reflection_atlas, Environment *p_env);
 
 	void _copy_screen(bool p_invalidate_color = false, bool p_invalidate_depth = false);
 	void _copy_to_front_buffer(Environment *env);
 	void _copy_texture_to_front_buffer(GLuint p_texture); //used for debug
 
+	static void _fill_render_list_chunk(void *p_userdata, uint32_t p_index);
 	void _fill_render_list(InstanceBase **p_cull_result, int p_cull_count, bool p_depth_pass, bool p_shadow_pass);
 
 	void _blur_effect_buffer();
@@ -852,6 +1045,7 @@ public:
 
 	virtual void set_scene_pass(uint64_t p_pass);
 	virtual void set_debug_draw_mode(VS::ViewportDebugDraw p_debug_draw);
+	virtual void set_stereo_pass(StereoPass p_pass);
 
 	void iteration();
 	void initialize();
@@ -33,6 +33,7 @@
 #include "project_settings.h"
 #include "rasterizer_canvas_gles3.h"
 #include "rasterizer_scene_gles3.h"
+#include "script_language.h"
 
 /* TEXTURE API */
 
@@ -1303,6 +1304,14 @@ void RasterizerStorageGLES3::texture_set_detect_normal_callback(RID p_texture, V
 	texture->detect_normal_ud = p_userdata;
 }
 
+void RasterizerStorageGLES3::texture_set_stream_request_callback(RID p_texture, VisualServer::TextureStreamRequestCallback p_callback, void *p_userdata) {
+	Texture *texture = texture_owner.get(p_texture);
+	ERR_FAIL_COND(!texture);
+
+	texture->stream_request = p_callback;
+	texture->stream_request_ud = p_userdata;
+}
+
 RID RasterizerStorageGLES3::texture_create_radiance_cubemap(RID p_source, int p_resolution) const {
 
 	Texture *texture = texture_owner.get(p_source);
@@ -1848,6 +1857,7 @@ void RasterizerStorageGLES3::_update_shader(Shader *p_shader) const {
 			p_shader->spatial.uses_vertex = false;
 			p_shader->spatial.writes_modelview_or_projection = false;
 			p_shader->spatial.uses_world_coordinates = false;
+			p_shader->spatial.uses_world_matrix_or_instance_id = false;
 
 			shaders.actions_scene.render_mode_values["blend_add"] = Pair<int *, int>(&p_shader->spatial.blend_mode, Shader::Spatial::BLEND_MODE_ADD);
 			shaders.actions_scene.render_mode_values["blend_mix"] = Pair<int *, int>(&p_shader->spatial.blend_mode, Shader::Spatial::BLEND_MODE_MIX);
@@ -1878,6 +1888,8 @@ void RasterizerStorageGLES3::_update_shader(Shader *p_shader) const {
 			shaders.actions_scene.usage_flag_pointers["SCREEN_TEXTURE"] = &p_shader->spatial.uses_screen_texture;
 			shaders.actions_scene.usage_flag_pointers["DEPTH_TEXTURE"] = &p_shader->spatial.uses_depth_texture;
 			shaders.actions_scene.usage_flag_pointers["TIME"] = &p_shader->spatial.uses_time;
+			shaders.actions_scene.usage_flag_pointers["WORLD_MATRIX"] = &p_shader->spatial.uses_world_matrix_or_instance_id;
+			shaders.actions_scene.usage_flag_pointers["INSTANCE_ID"] = &p_shader->spatial.uses_world_matrix_or_instance_id;
 
 			shaders.actions_scene.write_flag_pointers["MODELVIEW_MATRIX"] = &p_shader->spatial.writes_modelview_or_projection;
 			shaders.actions_scene.write_flag_pointers["PROJECTION_MATRIX"] = &p_shader->spatial.writes_modelview_or_projection;
@@ -2176,6 +2188,27 @@ bool RasterizerStorageGLES3::material_casts_shadows(RID p_material) {
 	return casts_shadows;
 }
 
+void RasterizerStorageGLES3::material_request_texture_size(RID p_material, int p_size) {
+
+	Material *material = material_owner.getornull(p_material);
+	ERR_FAIL_COND(!material);
+	if (material->dirty_list.in_list()) {
+		_update_material(material);
+	}
+
+	for (int i = 0; i < material->textures.size(); i++) {
+
+		Texture *texture = texture_owner.getornull(material->textures[i]);
+		if (texture && texture->stream_request) {
+			texture->stream_request(texture->stream_request_ud, p_size);
+		}
+	}
+
+	if (material->next_pass.is_valid()) {
+		material_request_texture_size(material->next_pass, p_size);
+	}
+}
+
 void RasterizerStorageGLES3::material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) {
 
 	Material *material = material_owner.get(p_material);
@@ -2788,9 +2821,25 @@ void RasterizerStorageGLES3::_update_material(Material *material) {
 			}
 		}
 
-		glBindBuffer(GL_UNIFORM_BUFFER, material->ubo_id);
-		glBufferSubData(GL_UNIFORM_BUFFER, 0, material->ubo_size, local_ubo);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		// updated in the previous frame too, so probably animated, upload it with the rest of the frame data when bound
+		bool dynamic = ubo_ring.buffer && material->ubo_update_frame && frame.count - material->ubo_update_frame <= 1;
+		material->ubo_update_frame = frame.count;
+
+		if (dynamic) {
+			material->ubo_data.resize(material->ubo_size);
+			copymem(material->ubo_data.ptrw(), local_ubo, material->ubo_size);
+			material->ubo_ring_frame = 0;
+			material->ubo_dynamic = true;
+		} else {
+			glBindBuffer(GL_UNIFORM_BUFFER, material->ubo_id);
+			glBufferSubData(GL_UNIFORM_BUFFER, 0, material->ubo_size, local_ubo);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			material->ubo_data.clear();
+			material->ubo_dynamic = false;
+		}
+	} else {
+		material->ubo_data.clear();
+		material->ubo_dynamic = false;
 	}
 
 	//set up the texture array, for easy access when it needs to be drawn
@@ -2930,7 +2979,14 @@ void RasterizerStorageGLES3::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 					attribs[i].size = (p_format & VS::ARRAY_COMPRESS_VERTEX) ? 4 : 3;
 				}
 
-				if (p_format & VS::ARRAY_COMPRESS_VERTEX) {
+				attribs[i].normalized = GL_FALSE;
+
+				if ((p_format & VS::ARRAY_COMPRESS_VERTEX) && (p_format & VS::ARRAY_FLAG_USE_QUANTIZED_VERTICES)) {
+					//relative to the surface AABB, decoded in the shader
+					attribs[i].type = GL_UNSIGNED_SHORT;
+					attribs[i].normalized = GL_TRUE;
+					stride += attribs[i].size * 2;
+				} else if (p_format & VS::ARRAY_COMPRESS_VERTEX) {
 					attribs[i].type = GL_HALF_FLOAT;
 					stride += attribs[i].size * 2;
 				} else {
@@ -2938,14 +2994,17 @@ void RasterizerStorageGLES3::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 					stride += attribs[i].size * 4;
 				}
 
-				attribs[i].normalized = GL_FALSE;
-
 			} break;
 			case VS::ARRAY_NORMAL: {
 
 				attribs[i].size = 3;
 
-				if (p_format & VS::ARRAY_COMPRESS_NORMAL) {
+				if ((p_format & VS::ARRAY_COMPRESS_NORMAL) && (p_format & VS::ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+					attribs[i].size = 2;
+					attribs[i].type = GL_SHORT;
+					stride += 4;
+					attribs[i].normalized = GL_TRUE;
+				} else if (p_format & VS::ARRAY_COMPRESS_NORMAL) {
 					attribs[i].type = GL_BYTE;
 					stride += 4; //pad extra byte
 					attribs[i].normalized = GL_TRUE;
@@ -2960,7 +3019,12 @@ void RasterizerStorageGLES3::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 
 				attribs[i].size = 4;
 
-				if (p_format & VS::ARRAY_COMPRESS_TANGENT) {
+				if ((p_format & VS::ARRAY_COMPRESS_TANGENT) && (p_format & VS::ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+					attribs[i].size = 2;
+					attribs[i].type = GL_SHORT;
+					stride += 4;
+					attribs[i].normalized = GL_TRUE;
+				} else if (p_format & VS::ARRAY_COMPRESS_TANGENT) {
 					attribs[i].type = GL_BYTE;
 					stride += 4;
 					attribs[i].normalized = GL_TRUE;
@@ -3004,15 +3068,19 @@ void RasterizerStorageGLES3::mesh_add_surface(RID p_mesh, uint32_t p_format, VS:
 			case VS::ARRAY_TEX_UV2: {
 
 				attribs[i].size = 2;
+				attribs[i].normalized = GL_FALSE;
 
-				if (p_format & VS::ARRAY_COMPRESS_TEX_UV2) {
+				if ((p_format & VS::ARRAY_COMPRESS_TEX_UV2) && (p_format & VS::ARRAY_FLAG_USE_16_BIT_TEX_UV2)) {
+					attribs[i].type = GL_UNSIGNED_SHORT;
+					attribs[i].normalized = GL_TRUE;
+					stride += 4;
+				} else if (p_format & VS::ARRAY_COMPRESS_TEX_UV2) {
 					attribs[i].type = GL_HALF_FLOAT;
 					stride += 4;
 				} else {
 					attribs[i].type = GL_FLOAT;
 					stride += 8;
 				}
-				attribs[i].normalized = GL_FALSE;
 
 			} break;
 			case VS::ARRAY_BONES: {
@@ -4003,6 +4071,10 @@ void RasterizerStorageGLES3::multimesh_allocate(RID p_multimesh, int p_instances
 	multimesh->color_format = p_color_format;
 	multimesh->custom_data_format = p_data_format;
 
+	int chunk_count = (p_instances + MultiMesh::CULL_CHUNK_SIZE - 1) / MultiMesh::CULL_CHUNK_SIZE;
+	multimesh->chunk_aabbs.resize(chunk_count);
+	multimesh->dirty_chunks.resize(chunk_count);
+
 	if (multimesh->size) {
 
 		if (multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D) {
@@ -4111,12 +4183,7 @@ void RasterizerStorageGLES3::multimesh_allocate(RID p_multimesh, int p_instances
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
-	multimesh->dirty_data = true;
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, -1, true, true);
 }
 
 int RasterizerStorageGLES3::multimesh_get_instance_count(RID p_multimesh) const {
@@ -4148,11 +4215,7 @@ void RasterizerStorageGLES3::multimesh_set_mesh(RID p_multimesh, RID p_mesh) {
 		}
 	}
 
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, -1, false, true);
 }
 
 void RasterizerStorageGLES3::multimesh_instance_set_transform(RID p_multimesh, int p_index, const Transform &p_transform) {
@@ -4178,12 +4241,7 @@ void RasterizerStorageGLES3::multimesh_instance_set_transform(RID p_multimesh, i
 	dataptr[10] = p_transform.basis.elements[2][2];
 	dataptr[11] = p_transform.origin.z;
 
-	multimesh->dirty_data = true;
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, p_index, true, true);
 }
 
 void RasterizerStorageGLES3::multimesh_instance_set_transform_2d(RID p_multimesh, int p_index, const Transform2D &p_transform) {
@@ -4205,12 +4263,7 @@ void RasterizerStorageGLES3::multimesh_instance_set_transform_2d(RID p_multimesh
 	dataptr[6] = 0;
 	dataptr[7] = p_transform.elements[2][1];
 
-	multimesh->dirty_data = true;
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, p_index, true, true);
 }
 void RasterizerStorageGLES3::multimesh_instance_set_color(RID p_multimesh, int p_index, const Color &p_color) {
 
@@ -4237,12 +4290,7 @@ void RasterizerStorageGLES3::multimesh_instance_set_color(RID p_multimesh, int p
 		dataptr[3] = p_color.a;
 	}
 
-	multimesh->dirty_data = true;
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, p_index, true, false);
 }
 
 void RasterizerStorageGLES3::multimesh_instance_set_custom_data(RID p_multimesh, int p_index, const Color &p_custom_data) {
@@ -4270,12 +4318,7 @@ void RasterizerStorageGLES3::multimesh_instance_set_custom_data(RID p_multimesh,
 		dataptr[3] = p_custom_data.a;
 	}
 
-	multimesh->dirty_data = true;
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, p_index, true, false);
 }
 RID RasterizerStorageGLES3::multimesh_get_mesh(RID p_multimesh) const {
 
@@ -4412,12 +4455,7 @@ void RasterizerStorageGLES3::multimesh_set_as_bulk_array(RID p_multimesh, const
 	PoolVector<float>::Read r = p_array.read();
 	copymem(multimesh->data.ptrw(), r.ptr(), dsize * sizeof(float));
 
-	multimesh->dirty_data = true;
-	multimesh->dirty_aabb = true;
-
-	if (!multimesh->update_list.in_list()) {
-		multimesh_update_list.add(&multimesh->update_list);
-	}
+	_multimesh_make_dirty(multimesh, -1, true, true);
 }
 
 void RasterizerStorageGLES3::multimesh_set_visible_instances(RID p_multimesh, int p_visible) {
@@ -4445,16 +4483,62 @@ AABB RasterizerStorageGLES3::multimesh_get_aabb(RID p_multimesh) const {
 	return multimesh->aabb;
 }
 
+void RasterizerStorageGLES3::_multimesh_make_dirty(MultiMesh *p_multimesh, int p_index, bool p_data, bool p_aabb) {
+
+	if (p_index < 0) {
+		for (int i = 0; i < p_multimesh->dirty_chunks.size(); i++) {
+			p_multimesh->dirty_chunks.write[i] = 1;
+		}
+	} else {
+		p_multimesh->dirty_chunks.write[p_index / MultiMesh::CULL_CHUNK_SIZE] = 1;
+	}
+
+	if (p_data) {
+		p_multimesh->dirty_data = true;
+	}
+	if (p_aabb) {
+		p_multimesh->dirty_aabb = true;
+	}
+
+	if (!p_multimesh->update_list.in_list()) {
+		multimesh_update_list.add(&p_multimesh->update_list);
+	}
+}
+
 void RasterizerStorageGLES3::update_dirty_multimeshes() {
 
 	while (multimesh_update_list.first()) {
 
 		MultiMesh *multimesh = multimesh_update_list.first()->self();
 
+		int stride = multimesh->color_floats + multimesh->xform_floats + multimesh->custom_data_floats;
+		int chunk_count = multimesh->dirty_chunks.size();
+		const uint8_t *dirty_chunks = multimesh->dirty_chunks.ptr();
+		const float *data = multimesh->data.ptr();
+
 		if (multimesh->size && multimesh->dirty_data) {
 
+			//only upload the runs of chunks that changed, so setting a few instances does not send the whole buffer
+			int chunk_floats = stride * MultiMesh::CULL_CHUNK_SIZE;
+
 			glBindBuffer(GL_ARRAY_BUFFER, multimesh->buffer);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, multimesh->data.size() * sizeof(float), multimesh->data.ptr());
+
+			for (int i = 0; i < chunk_count;) {
+
+				if (!dirty_chunks[i]) {
+					i++;
+					continue;
+				}
+
+				int from = i * chunk_floats;
+				while (i < chunk_count && dirty_chunks[i]) {
+					i++;
+				}
+				int to = MIN(i * chunk_floats, multimesh->data.size());
+
+				glBufferSubData(GL_ARRAY_BUFFER, from * sizeof(float), (to - from) * sizeof(float), &data[from]);
+			}
+
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 
@@ -4468,61 +4552,66 @@ void RasterizerStorageGLES3::update_dirty_multimeshes() {
 				mesh_aabb.size += Vector3(0.001, 0.001, 0.001);
 			}
 
-			int stride = multimesh->color_floats + multimesh->xform_floats + multimesh->custom_data_floats;
-			int count = multimesh->data.size();
-			float *data = multimesh->data.ptrw();
+			AABB *chunk_aabbs = multimesh->chunk_aabbs.ptrw();
 
-			AABB aabb;
+			//recompute the bounds of the changed chunks only, then merge all of them
+			for (int c = 0; c < chunk_count; c++) {
 
-			if (multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D) {
+				if (!dirty_chunks[c]) {
+					continue;
+				}
 
-				for (int i = 0; i < count; i += stride) {
+				int from = c * MultiMesh::CULL_CHUNK_SIZE;
+				int to = MIN(from + MultiMesh::CULL_CHUNK_SIZE, multimesh->size);
 
-					float *dataptr = &data[i];
-					Transform xform;
-					xform.basis[0][0] = dataptr[0];
-					xform.basis[0][1] = dataptr[1];
-					xform.origin[0] = dataptr[3];
-					xform.basis[1][0] = dataptr[4];
-					xform.basis[1][1] = dataptr[5];
-					xform.origin[1] = dataptr[7];
+				for (int i = from; i < to; i++) {
 
-					AABB laabb = xform.xform(mesh_aabb);
-					if (i == 0)
-						aabb = laabb;
-					else
-						aabb.merge_with(laabb);
-				}
-			} else {
+					const float *dataptr = &data[i * stride];
+					Transform xform;
 
-				for (int i = 0; i < count; i += stride) {
+					if (multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D) {
 
-					float *dataptr = &data[i];
-					Transform xform;
+						xform.basis[0][0] = dataptr[0];
+						xform.basis[0][1] = dataptr[1];
+						xform.origin[0] = dataptr[3];
+						xform.basis[1][0] = dataptr[4];
+						xform.basis[1][1] = dataptr[5];
+						xform.origin[1] = dataptr[7];
+					} else {
 
-					xform.basis.elements[0][0] = dataptr[0];
-					xform.basis.elements[0][1] = dataptr[1];
-					xform.basis.elements[0][2] = dataptr[2];
-					xform.origin.x = dataptr[3];
-					xform.basis.elements[1][0] = dataptr[4];
-					xform.basis.elements[1][1] = dataptr[5];
-					xform.basis.elements[1][2] = dataptr[6];
-					xform.origin.y = dataptr[7];
-					xform.basis.elements[2][0] = dataptr[8];
-					xform.basis.elements[2][1] = dataptr[9];
-					xform.basis.elements[2][2] = dataptr[10];
-					xform.origin.z = dataptr[11];
+						xform.basis.elements[0][0] = dataptr[0];
+						xform.basis.elements[0][1] = dataptr[1];
+						xform.basis.elements[0][2] = dataptr[2];
+						xform.origin.x = dataptr[3];
+						xform.basis.elements[1][0] = dataptr[4];
+						xform.basis.elements[1][1] = dataptr[5];
+						xform.basis.elements[1][2] = dataptr[6];
+						xform.origin.y = dataptr[7];
+						xform.basis.elements[2][0] = dataptr[8];
+						xform.basis.elements[2][1] = dataptr[9];
+						xform.basis.elements[2][2] = dataptr[10];
+						xform.origin.z = dataptr[11];
+					}
 
 					AABB laabb = xform.xform(mesh_aabb);
-					if (i == 0)
-						aabb = laabb;
+					if (i == from)
+						chunk_aabbs[c] = laabb;
 					else
-						aabb.merge_with(laabb);
+						chunk_aabbs[c].merge_with(laabb);
 				}
 			}
 
+			AABB aabb = chunk_aabbs[0];
+			for (int c = 1; c < chunk_count; c++) {
+				aabb.merge_with(chunk_aabbs[c]);
+			}
+
 			multimesh->aabb = aabb;
 		}
+
+		if (chunk_count) {
+			zeromem(multimesh->dirty_chunks.ptrw(), chunk_count);
+		}
 		multimesh->dirty_aabb = false;
 		multimesh->dirty_data = false;
 
@@ -4758,6 +4847,34 @@ void RasterizerStorageGLES3::skeleton_bone_set_transform(RID p_skeleton, int p_b
 	}
 }
 
+void RasterizerStorageGLES3::skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms) {
+
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_transforms.size() != skeleton->size * 12);
+
+	PoolVector<float>::Read r = p_transforms.read();
+	const float *src = r.ptr();
+	float *texture = skeleton->skel_texture.ptrw();
+
+	// the texture keeps each row of the bones in a separate texture row
+	for (int i = 0; i < skeleton->size; i++) {
+
+		int base_ofs = ((i / 256) * 256) * 3 * 4 + (i % 256) * 4;
+
+		for (int j = 0; j < 3; j++) {
+			copymem(&texture[base_ofs], &src[i * 12 + j * 4], 4 * sizeof(float));
+			base_ofs += 256 * 4;
+		}
+	}
+
+	if (!skeleton->update_list.in_list()) {
+		skeleton_update_list.add(&skeleton->update_list);
+	}
+}
+
 Transform RasterizerStorageGLES3::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
 
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
@@ -6151,7 +6268,7 @@ void RasterizerStorageGLES3::update_particles() {
 
 			if (material->ubo_id) {
 
-				glBindBufferBase(GL_UNIFORM_BUFFER, 0, material->ubo_id);
+				material_bind_ubo(material, 0);
 			}
 
 			int tc = material->textures.size();
@@ -7254,12 +7371,9 @@ bool RasterizerStorageGLES3::free(RID p_rid) {
 		while (mesh->multimeshes.first()) {
 			MultiMesh *multimesh = mesh->multimeshes.first()->self();
 			multimesh->mesh = RID();
-			multimesh->dirty_aabb = true;
 			mesh->multimeshes.remove(mesh->multimeshes.first());
 
-			if (!multimesh->update_list.in_list()) {
-				multimesh_update_list.add(&multimesh->update_list);
-			}
+			_multimesh_make_dirty(multimesh, -1, false, true);
 		}
 
 		mesh_owner.free(p_rid);
@@ -7368,6 +7482,9 @@ bool RasterizerStorageGLES3::free(RID p_rid) {
 
 bool RasterizerStorageGLES3::has_os_feature(const String &p_feature) const {
 
+	if (p_feature == "bptc")
+		return config.bptc_supported;
+
 	if (p_feature == "s3tc")
 		return config.s3tc_supported;
 
@@ -7390,6 +7507,23 @@ void RasterizerStorageGLES3::set_debug_generate_wireframes(bool p_generate) {
 	config.generate_wireframes = p_generate;
 }
 
+void RasterizerStorageGLES3::shader_variants_set_recording(bool p_enable) {
+
+	ShaderGLES3::set_variant_recording(p_enable);
+}
+
+Vector<String> RasterizerStorageGLES3::shader_variants_get_recorded() {
+
+	return ShaderGLES3::get_recorded_variants();
+}
+
+void RasterizerStorageGLES3::shader_variants_precompile(const Vector<String> &p_variants) {
+
+	//material code must be up to date, else the variants can't be matched to it
+	update_dirty_shaders();
+	ShaderGLES3::precompile_variants(p_variants);
+}
+
 void RasterizerStorageGLES3::render_info_begin_capture() {
 
 	info.snap = info.render;
@@ -7403,6 +7537,7 @@ void RasterizerStorageGLES3::render_info_end_capture() {
 	info.snap.surface_switch_count = info.render.surface_switch_count - info.snap.surface_switch_count;
 	info.snap.shader_rebind_count = info.render.shader_rebind_count - info.snap.shader_rebind_count;
 	info.snap.vertices_count = info.render.vertices_count - info.snap.vertices_count;
+	info.snap.instanced_draw_calls_saved = info.render.instanced_draw_calls_saved - info.snap.instanced_draw_calls_saved;
 }
 
 int RasterizerStorageGLES3::get_captured_render_info(VS::RenderInfo p_info) {
@@ -7428,6 +7563,9 @@ int RasterizerStorageGLES3::get_captured_render_info(VS::RenderInfo p_info) {
 		case VS::INFO_DRAW_CALLS_IN_FRAME: {
 			return info.snap.draw_call_count;
 		} break;
+		case VS::INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME: {
+			return info.snap.instanced_draw_calls_saved;
+		} break;
 		default: {
 			return get_render_info(p_info);
 		}
@@ -7457,11 +7595,138 @@ int RasterizerStorageGLES3::get_render_info(VS::RenderInfo p_info) {
 			return info.texture_mem;
 		case VS::INFO_VERTEX_MEM_USED:
 			return info.vertex_mem;
+		case VS::INFO_SHADER_COMPILES_PENDING:
+			return ShaderGLES3::get_pending_compile_count();
+		case VS::INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME:
+			return info.render_final.instanced_draw_calls_saved;
+		case VS::INFO_GPU_TIME_SHADOWS_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_SHADOWS];
+		case VS::INFO_GPU_TIME_OPAQUE_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_OPAQUE];
+		case VS::INFO_GPU_TIME_TRANSPARENT_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_TRANSPARENT];
+		case VS::INFO_GPU_TIME_SSAO_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_SSAO];
+		case VS::INFO_GPU_TIME_GLOW_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_GLOW];
+		case VS::INFO_GPU_TIME_TONEMAP_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_TONEMAP];
+		case VS::INFO_GPU_TIME_CANVAS_USEC:
+			return gpu_timers.elapsed_usec[GPU_TIMER_CANVAS];
 		default:
 			return 0; //no idea either
 	}
 }
 
+#ifdef GLES_OVER_GL
+
+void RasterizerStorageGLES3::gpu_timer_begin(GPUTimer p_timer) {
+
+	if (!gpu_timers.enabled) {
+		return;
+	}
+
+	if (gpu_timers.active != -1) {
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	GPUTimers::Frame &f = gpu_timers.frames[gpu_timers.current_frame];
+	if (f.used == f.queries.size()) {
+		GLuint query;
+		glGenQueries(1, &query);
+		f.queries.push_back(query);
+		f.timers.push_back(0);
+	}
+
+	f.timers.write[f.used] = p_timer;
+	glBeginQuery(GL_TIME_ELAPSED, f.queries[f.used]);
+	f.used++;
+
+	gpu_timers.active = p_timer;
+}
+
+void RasterizerStorageGLES3::gpu_timer_end() {
+
+	if (gpu_timers.active == -1) {
+		return;
+	}
+
+	glEndQuery(GL_TIME_ELAPSED);
+	gpu_timers.active = -1;
+}
+
+void RasterizerStorageGLES3::gpu_timers_begin_frame() {
+
+	if (!gpu_timers.enabled) {
+		return;
+	}
+
+	gpu_timer_end();
+
+	gpu_timers.current_frame = (gpu_timers.current_frame + 1) % GPUTimers::FRAME_LATENCY;
+	GPUTimers::Frame &f = gpu_timers.frames[gpu_timers.current_frame];
+
+	if (f.used == 0) {
+		return;
+	}
+
+	// the oldest frame is about to be reused, collect it if the GPU is done with it, otherwise keep the previous results
+	GLint available = 0;
+	glGetQueryObjectiv(f.queries[f.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+	if (available) {
+
+		uint64_t elapsed_nsec[GPU_TIMER_MAX] = {};
+
+		for (int i = 0; i < f.used; i++) {
+			GLuint64 nsec = 0;
+			glGetQueryObjectui64v(f.queries[i], GL_QUERY_RESULT, &nsec);
+			elapsed_nsec[f.timers[i]] += nsec;
+		}
+
+		for (int i = 0; i < GPU_TIMER_MAX; i++) {
+			gpu_timers.elapsed_usec[i] = elapsed_nsec[i] / 1000;
+		}
+
+		if (ScriptDebugger::get_singleton() && ScriptDebugger::get_singleton()->is_profiling()) {
+
+			static const char *timer_name[GPU_TIMER_MAX] = {
+				"shadows",
+				"opaque",
+				"transparent",
+				"ssao",
+				"glow",
+				"tonemap",
+				"canvas"
+			};
+
+			Array values;
+			values.resize(GPU_TIMER_MAX * 2);
+			for (int i = 0; i < GPU_TIMER_MAX; i++) {
+				values[i * 2 + 0] = timer_name[i];
+				values[i * 2 + 1] = USEC_TO_SEC(gpu_timers.elapsed_usec[i]);
+			}
+
+			ScriptDebugger::get_singleton()->add_profiling_frame_data("gpu", values);
+		}
+	}
+
+	f.used = 0;
+}
+
+#else
+
+void RasterizerStorageGLES3::gpu_timer_begin(GPUTimer p_timer) {
+}
+
+void RasterizerStorageGLES3::gpu_timer_end() {
+}
+
+void RasterizerStorageGLES3::gpu_timers_begin_frame() {
+}
+
+#endif
+
 void RasterizerStorageGLES3::initialize() {
 
 	RasterizerStorageGLES3::system_fbo = 0;
@@ -7648,6 +7913,31 @@ void RasterizerStorageGLES3::initialize() {
 		glGenVertexArrays(1, &resources.transform_feedback_array);
 	}
 
+	{
+		//ring for dynamic material uniforms
+		uint32_t ring_size = GLOBAL_DEF_RST("rendering/limits/buffers/material_ubo_ring_size_kb", 256);
+		ProjectSettings::get_singleton()->set_custom_property_info("rendering/limits/buffers/material_ubo_ring_size_kb", PropertyInfo(Variant::INT, "rendering/limits/buffers/material_ubo_ring_size_kb", PROPERTY_HINT_RANGE, "0,16384,1,or_greater"));
+
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+		ubo_ring.buffer = 0;
+		ubo_ring.alignment = MAX(alignment, 16);
+		ubo_ring.segment_size = (ring_size * 1024 / UBORing::SEGMENTS) / ubo_ring.alignment * ubo_ring.alignment;
+		ubo_ring.offset = 0;
+		ubo_ring.segment = 0;
+		for (int i = 0; i < UBORing::SEGMENTS; i++) {
+			ubo_ring.fences[i] = 0;
+		}
+
+		if (ubo_ring.segment_size) {
+			glGenBuffers(1, &ubo_ring.buffer);
+			glBindBuffer(GL_UNIFORM_BUFFER, ubo_ring.buffer);
+			glBufferData(GL_UNIFORM_BUFFER, ubo_ring.segment_size * UBORing::SEGMENTS, NULL, GL_STREAM_DRAW);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		}
+	}
+
 	shaders.cubemap_filter.init();
 	bool ggx_hq = GLOBAL_GET("rendering/quality/reflections/high_quality_ggx.mobile");
 	shaders.cubemap_filter.set_conditional(CubemapFilterShaderGLES3::LOW_QUALITY, !ggx_hq);
@@ -7660,12 +7950,44 @@ void RasterizerStorageGLES3::initialize() {
 	frame.count = 0;
 	frame.delta = 0;
 	frame.current_rt = NULL;
+
+#ifdef GLES_OVER_GL
+	gpu_timers.enabled = GLOBAL_GET("debug/settings/profiler/gpu_pass_timers");
+#else
+	gpu_timers.enabled = false; // GL_TIME_ELAPSED needs EXT_disjoint_timer_query on GLES
+#endif
+	gpu_timers.current_frame = 0;
+	gpu_timers.active = -1;
+	for (int i = 0; i < GPU_TIMER_MAX; i++) {
+		gpu_timers.elapsed_usec[i] = 0;
+	}
+	for (int i = 0; i < GPUTimers::FRAME_LATENCY; i++) {
+		gpu_timers.frames[i].used = 0;
+	}
 	config.keep_original_textures = false;
 	config.generate_wireframes = false;
 	config.use_texture_array_environment = GLOBAL_GET("rendering/quality/reflections/texture_array_reflections");
 
 	config.force_vertex_shading = GLOBAL_GET("rendering/quality/shading/force_vertex_shading");
 
+	config.async_shader_compile = GLOBAL_GET("rendering/quality/shaders/async_compile") && (config.extensions.has("GL_KHR_parallel_shader_compile") || config.extensions.has("GL_ARB_parallel_shader_compile"));
+	ShaderGLES3::set_async_compile(config.async_shader_compile);
+
+#ifdef JAVASCRIPT_ENABLED
+	config.program_binary_supported = false;
+#else
+	{
+		GLint binary_formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binary_formats);
+#ifdef GLES_OVER_GL
+		config.program_binary_supported = binary_formats > 0 && config.extensions.has("GL_ARB_get_program_binary");
+#else
+		config.program_binary_supported = binary_formats > 0;
+#endif
+	}
+#endif
+	ShaderGLES3::set_program_cache_enabled(config.program_binary_supported && bool(GLOBAL_GET("rendering/quality/shaders/cache_program_binaries")));
+
 	String renderer = (const char *)glGetString(GL_RENDERER);
 
 	config.no_depth_prepass = !bool(GLOBAL_GET("rendering/quality/depth_prepass/enable"));
@@ -7690,6 +8012,91 @@ void RasterizerStorageGLES3::finalize() {
 	glDeleteTextures(1, &resources.white_tex);
 	glDeleteTextures(1, &resources.black_tex);
 	glDeleteTextures(1, &resources.normal_tex);
+
+	gpu_timer_end();
+	for (int i = 0; i < GPUTimers::FRAME_LATENCY; i++) {
+		if (gpu_timers.frames[i].queries.size()) {
+			glDeleteQueries(gpu_timers.frames[i].queries.size(), gpu_timers.frames[i].queries.ptr());
+		}
+	}
+
+	for (int i = 0; i < UBORing::SEGMENTS; i++) {
+		if (ubo_ring.fences[i]) {
+			glDeleteSync(ubo_ring.fences[i]);
+		}
+	}
+	if (ubo_ring.buffer) {
+		glDeleteBuffers(1, &ubo_ring.buffer);
+	}
+}
+
+void RasterizerStorageGLES3::ubo_ring_begin_frame() {
+
+	if (!ubo_ring.buffer)
+		return;
+
+	if (ubo_ring.offset) {
+		// the GPU is done with this segment once it gets past everything drawn until now
+		ubo_ring.fences[ubo_ring.segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	ubo_ring.segment = (ubo_ring.segment + 1) % UBORing::SEGMENTS;
+	ubo_ring.offset = 0;
+
+	GLsync &fence = ubo_ring.fences[ubo_ring.segment];
+	if (fence) {
+		// only waits when the GPU is more frames behind than there are segments
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		glDeleteSync(fence);
+		fence = 0;
+	}
+}
+
+bool RasterizerStorageGLES3::ubo_ring_upload(const uint8_t *p_data, uint32_t p_size, uint32_t *r_offset) {
+
+	if (!ubo_ring.buffer || ubo_ring.offset + p_size > ubo_ring.segment_size)
+		return false;
+
+	uint32_t offset = ubo_ring.segment * ubo_ring.segment_size + ubo_ring.offset;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo_ring.buffer);
+	void *ptr = glMapBufferRange(GL_UNIFORM_BUFFER, offset, p_size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (!ptr) {
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		return false;
+	}
+	copymem(ptr, p_data, p_size);
+	glUnmapBuffer(GL_UNIFORM_BUFFER);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	ubo_ring.offset += (p_size + ubo_ring.alignment - 1) / ubo_ring.alignment * ubo_ring.alignment;
+	*r_offset = offset;
+	return true;
+}
+
+void RasterizerStorageGLES3::material_bind_ubo(Material *p_material, GLuint p_index) {
+
+	Material *material = p_material;
+
+	if (material->ubo_dynamic) {
+
+		// stopped changing, or the ring is full, keep the values in the material UBO again
+		if (frame.count - material->ubo_update_frame > 60 || (material->ubo_ring_frame != frame.count && !ubo_ring_upload(material->ubo_data.ptr(), material->ubo_size, &material->ubo_ring_offset))) {
+
+			glBindBuffer(GL_UNIFORM_BUFFER, material->ubo_id);
+			glBufferSubData(GL_UNIFORM_BUFFER, 0, material->ubo_size, material->ubo_data.ptr());
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			material->ubo_data.clear();
+			material->ubo_dynamic = false;
+		} else {
+
+			material->ubo_ring_frame = frame.count;
+			glBindBufferRange(GL_UNIFORM_BUFFER, p_index, ubo_ring.buffer, material->ubo_ring_offset, material->ubo_size);
+			return;
+		}
+	}
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, p_index, material->ubo_id);
 }
 
 void RasterizerStorageGLES3::update_dirty_resources() {
@@ -97,6 +97,8 @@ public:
 
 		bool no_depth_prepass;
 		bool force_vertex_shading;
+		bool async_shader_compile;
+		bool program_binary_supported;
 	} config;
 
 	mutable struct Shaders {
@@ -145,6 +147,7 @@ public:
 			uint32_t surface_switch_count;
 			uint32_t shader_rebind_count;
 			uint32_t vertices_count;
+			uint32_t instanced_draw_calls_saved;
 
 			void reset() {
 				object_count = 0;
@@ -153,6 +156,7 @@ public:
 				surface_switch_count = 0;
 				shader_rebind_count = 0;
 				vertices_count = 0;
+				instanced_draw_calls_saved = 0;
 			}
 		} render, render_final, snap;
 
@@ -288,6 +292,9 @@ public:
 		VisualServer::TextureDetectCallback detect_normal;
 		void *detect_normal_ud;
 
+		VisualServer::TextureStreamRequestCallback stream_request;
+		void *stream_request_ud;
+
 		Texture() {
 
 			using_srgb = false;
@@ -309,6 +316,8 @@ public:
 			detect_srgb_ud = NULL;
 			detect_normal = NULL;
 			detect_normal_ud = NULL;
+			stream_request = NULL;
+			stream_request_ud = NULL;
 			proxy = NULL;
 			redraw_if_visible = false;
 		}
@@ -371,6 +380,7 @@ public:
 	virtual void texture_set_detect_3d_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata);
 	virtual void texture_set_detect_srgb_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata);
 	virtual void texture_set_detect_normal_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata);
+	virtual void texture_set_stream_request_callback(RID p_texture, VisualServer::TextureStreamRequestCallback p_callback, void *p_userdata);
 
 	virtual void texture_set_proxy(RID p_texture, RID p_proxy);
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable);
@@ -489,6 +499,7 @@ public:
 			bool writes_modelview_or_projection;
 			bool uses_vertex_lighting;
 			bool uses_world_coordinates;
+			bool uses_world_matrix_or_instance_id;
 
 		} spatial;
 
@@ -554,9 +565,20 @@ public:
 		bool can_cast_shadow_cache;
 		bool is_animated_cache;
 
+		// uniforms updated in consecutive frames go through the UBO ring, from a copy kept here
+		bool ubo_dynamic;
+		Vector<uint8_t> ubo_data;
+		uint64_t ubo_update_frame;
+		uint64_t ubo_ring_frame;
+		uint32_t ubo_ring_offset;
+
 		Material() :
 				list(this),
 				dirty_list(this) {
+			ubo_dynamic = false;
+			ubo_update_frame = 0;
+			ubo_ring_frame = 0;
+			ubo_ring_offset = 0;
 			can_cast_shadow_cache = false;
 			is_animated_cache = false;
 			shader = NULL;
@@ -588,6 +610,7 @@ public:
 
 	virtual bool material_is_animated(RID p_material);
 	virtual bool material_casts_shadows(RID p_material);
+	virtual void material_request_texture_size(RID p_material, int p_size);
 
 	virtual void material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance);
 	virtual void material_remove_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance);
@@ -768,6 +791,8 @@ public:
 		VS::MultimeshCustomDataFormat custom_data_format;
 		Vector<float> data;
 		AABB aabb;
+		Vector<AABB> chunk_aabbs; //local bounds of every CULL_CHUNK_SIZE consecutive instances, so the scene can cull them
+		Vector<uint8_t> dirty_chunks; //chunks changed since the last update, only those are uploaded and have their bounds recomputed
 		SelfList<MultiMesh> update_list;
 		SelfList<MultiMesh> mesh_list;
 		GLuint buffer;
@@ -780,6 +805,10 @@ public:
 		bool dirty_aabb;
 		bool dirty_data;
 
+		enum {
+			CULL_CHUNK_SIZE = 256
+		};
+
 		MultiMesh() :
 				update_list(this),
 				mesh_list(this) {
@@ -801,6 +830,7 @@ public:
 
 	SelfList<MultiMesh>::List multimesh_update_list;
 
+	void _multimesh_make_dirty(MultiMesh *p_multimesh, int p_index, bool p_data, bool p_aabb); //p_index -1 marks every chunk
 	void update_dirty_multimeshes();
 
 	virtual RID multimesh_create();
@@ -908,6 +938,7 @@ public:
 	virtual void skeleton_allocate(RID p_skeleton, int p_bones, bool p_2d_skeleton = false);
 	virtual int skeleton_get_bone_count(RID p_skeleton) const;
 	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform);
+	virtual void skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms);
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform);
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const;
@@ -1438,6 +1469,63 @@ public:
 
 	} frame;
 
+	enum GPUTimer {
+		GPU_TIMER_SHADOWS,
+		GPU_TIMER_OPAQUE,
+		GPU_TIMER_TRANSPARENT,
+		GPU_TIMER_SSAO,
+		GPU_TIMER_GLOW,
+		GPU_TIMER_TONEMAP,
+		GPU_TIMER_CANVAS,
+		GPU_TIMER_MAX
+	};
+
+	// GL_TIME_ELAPSED queries around render passes, read back FRAME_LATENCY frames later so the CPU never waits on them
+	struct GPUTimers {
+
+		enum {
+			FRAME_LATENCY = 3
+		};
+
+		struct Frame {
+			Vector<GLuint> queries;
+			Vector<uint8_t> timers;
+			int used;
+		};
+
+		bool enabled;
+		Frame frames[FRAME_LATENCY];
+		int current_frame;
+		int active; // timer with an open query, -1 if none
+		uint64_t elapsed_usec[GPU_TIMER_MAX];
+
+	} gpu_timers;
+
+	void gpu_timer_begin(GPUTimer p_timer); // ends the open timer if any, only one query can be active at a time
+	void gpu_timer_end();
+	void gpu_timers_begin_frame();
+
+	// materials whose parameters change every frame write them here instead of into their own UBO,
+	// each frame writes to its own segment and fences it, so nothing the GPU may still read is overwritten
+	struct UBORing {
+
+		enum {
+			SEGMENTS = 3
+		};
+
+		GLuint buffer;
+		uint32_t segment_size;
+		uint32_t alignment;
+		uint32_t offset; // in the current segment
+		int segment;
+		GLsync fences[SEGMENTS];
+
+	} ubo_ring;
+
+	void ubo_ring_begin_frame();
+	bool ubo_ring_upload(const uint8_t *p_data, uint32_t p_size, uint32_t *r_offset);
+	void material_bind_ubo(Material *p_material, GLuint p_index);
+
 	void initialize();
 	void finalize();
 
@@ -1447,6 +1535,10 @@ public:
 
 	virtual void set_debug_generate_wireframes(bool p_generate);
 
+	virtual void shader_variants_set_recording(bool p_enable);
+	virtual Vector<String> shader_variants_get_recorded();
+	virtual void shader_variants_precompile(const Vector<String> &p_variants);
+
 	virtual void render_info_begin_capture();
 	virtual void render_info_end_capture();
 	virtual int get_captured_render_info(VS::RenderInfo p_info);
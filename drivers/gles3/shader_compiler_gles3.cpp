@@ -550,6 +550,7 @@ String ShaderCompilerGLES3::_dump_node_code(SL::Node *p_node, int p_level, Gener
 
 			if (p_assigning && p_actions.write_flag_pointers.has(vnode->name)) {
 				*p_actions.write_flag_pointers[vnode->name] = true;
+				used_write_flag_pointers.insert(vnode->name);
 			}
 
 			if (p_default_actions.usage_defines.has(vnode->name) && !used_name_defines.has(vnode->name)) {
@@ -727,8 +728,46 @@ String ShaderCompilerGLES3::_dump_node_code(SL::Node *p_node, int p_level, Gener
 	return code;
 }
 
+void ShaderCompilerGLES3::_apply_cached_actions(const CachedCode &p_cached, IdentifierActions *p_actions) {
+
+	for (int i = 0; i < p_cached.render_modes.size(); i++) {
+
+		if (p_actions->render_mode_flags.has(p_cached.render_modes[i])) {
+			*p_actions->render_mode_flags[p_cached.render_modes[i]] = true;
+		}
+
+		if (p_actions->render_mode_values.has(p_cached.render_modes[i])) {
+			Pair<int *, int> &p = p_actions->render_mode_values[p_cached.render_modes[i]];
+			*p.first = p.second;
+		}
+	}
+
+	for (int i = 0; i < p_cached.usage_flags.size(); i++) {
+		if (p_actions->usage_flag_pointers.has(p_cached.usage_flags[i])) {
+			*p_actions->usage_flag_pointers[p_cached.usage_flags[i]] = true;
+		}
+	}
+
+	for (int i = 0; i < p_cached.write_flags.size(); i++) {
+		if (p_actions->write_flag_pointers.has(p_cached.write_flags[i])) {
+			*p_actions->write_flag_pointers[p_cached.write_flags[i]] = true;
+		}
+	}
+
+	for (const Map<StringName, ShaderLanguage::ShaderNode::Uniform>::Element *E = p_cached.uniforms.front(); E; E = E->next()) {
+		p_actions->uniforms->insert(E->key(), E->get());
+	}
+}
+
 Error ShaderCompilerGLES3::compile(VS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
 
+	const CachedCode *cached = code_cache[p_mode].getptr(p_code);
+	if (cached) {
+		r_gen_code = cached->gen_code;
+		_apply_cached_actions(*cached, p_actions);
+		return OK;
+	}
+
 	Error err = parser.compile(p_code, ShaderTypes::get_singleton()->get_functions(p_mode), ShaderTypes::get_singleton()->get_modes(p_mode), ShaderTypes::get_singleton()->get_types());
 
 	if (err != OK) {
@@ -754,6 +793,7 @@ Error ShaderCompilerGLES3::compile(VS::ShaderMode p_mode, const String &p_code,
 	used_name_defines.clear();
 	used_rmode_defines.clear();
 	used_flag_pointers.clear();
+	used_write_flag_pointers.clear();
 
 	_dump_node_code(parser.get_shader(), 1, r_gen_code, *p_actions, actions[p_mode], false);
 
@@ -765,6 +805,21 @@ Error ShaderCompilerGLES3::compile(VS::ShaderMode p_mode, const String &p_code,
 		r_gen_code.uniform_total_size += md; //pad just in case
 	}
 
+	if (code_cache[p_mode].size() >= MAX_CACHED_CODES) {
+		code_cache[p_mode].clear(); //mostly happens when editing, start over
+	}
+
+	CachedCode &cache = code_cache[p_mode][p_code];
+	cache.gen_code = r_gen_code;
+	cache.render_modes = parser.get_shader()->render_modes;
+	for (Set<StringName>::Element *E = used_flag_pointers.front(); E; E = E->next()) {
+		cache.usage_flags.push_back(E->get());
+	}
+	for (Set<StringName>::Element *E = used_write_flag_pointers.front(); E; E = E->next()) {
+		cache.write_flags.push_back(E->get());
+	}
+	cache.uniforms = parser.get_shader()->uniforms;
+
 	return OK;
 }
 
@@ -31,6 +31,7 @@
 #ifndef SHADERCOMPILERGLES3_H
 #define SHADERCOMPILERGLES3_H
 
+#include "hash_map.h"
 #include "pair.h"
 #include "servers/visual/shader_language.h"
 #include "servers/visual/shader_types.h"
@@ -89,11 +90,31 @@ private:
 
 	Set<StringName> used_name_defines;
 	Set<StringName> used_flag_pointers;
+	Set<StringName> used_write_flag_pointers;
 	Set<StringName> used_rmode_defines;
 	Set<StringName> internal_functions;
 
 	DefaultIdentifierActions actions[VS::SHADER_MAX];
 
+	// results of previous compilations, keyed by code, so shaders sharing the same code skip parsing and generation
+
+	enum {
+		MAX_CACHED_CODES = 256
+	};
+
+	struct CachedCode {
+
+		GeneratedCode gen_code;
+		Vector<StringName> render_modes;
+		Vector<StringName> usage_flags;
+		Vector<StringName> write_flags;
+		Map<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+	};
+
+	HashMap<String, CachedCode> code_cache[VS::SHADER_MAX];
+
+	void _apply_cached_actions(const CachedCode &p_cached, IdentifierActions *p_actions);
+
 public:
 	Error compile(VS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
 
@@ -30,7 +30,10 @@
 
 #include "shader_gles3.h"
 
+#include "os/dir_access.h"
+#include "os/file_access.h"
 #include "print_string.h"
+#include "thirdparty/misc/sha256.h"
 
 //#define DEBUG_OPENGL
 
@@ -49,7 +52,21 @@
 
 #endif
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#define PROGRAM_CACHE_PATH "user://shader_cache"
+#define PROGRAM_CACHE_FORMAT_VERSION 1
+
 ShaderGLES3 *ShaderGLES3::active = NULL;
+bool ShaderGLES3::async_compile = false;
+int ShaderGLES3::pending_compiles = 0;
+bool ShaderGLES3::program_cache = false;
+uint64_t ShaderGLES3::program_cache_driver = 0;
+bool ShaderGLES3::record_variants = false;
+Set<String> ShaderGLES3::recorded_variants;
+Vector<ShaderGLES3 *> ShaderGLES3::instances;
 
 //#define DEBUG_SHADER
 
@@ -112,8 +129,9 @@ GLint ShaderGLES3::get_uniform_location(int p_index) const {
 
 bool ShaderGLES3::bind() {
 
-	if (active != this || !version || new_conditional_version.key != conditional_version.key) {
+	if (active != this || !version || version_is_fallback || new_conditional_version.key != conditional_version.key) {
 		conditional_version = new_conditional_version;
+		version_is_fallback = false;
 		version = get_current_version();
 	} else {
 
@@ -168,18 +186,284 @@ static void _display_error_with_code(const String &p_error, const Vector<const c
 	ERR_PRINTS(p_error);
 }
 
+static String _get_info_log(GLuint p_id, bool p_program) {
+
+	GLsizei iloglen = 0;
+	if (p_program) {
+		glGetProgramiv(p_id, GL_INFO_LOG_LENGTH, &iloglen);
+	} else {
+		glGetShaderiv(p_id, GL_INFO_LOG_LENGTH, &iloglen);
+	}
+
+	if (iloglen <= 0) {
+		iloglen = 4096; //buggy driver (Adreno 220+....)
+	}
+
+	char *ilogmem = (char *)memalloc(iloglen + 1);
+	ilogmem[iloglen] = 0;
+	if (p_program) {
+		glGetProgramInfoLog(p_id, iloglen, &iloglen, ilogmem);
+	} else {
+		glGetShaderInfoLog(p_id, iloglen, &iloglen, ilogmem);
+	}
+
+	String log = ilogmem;
+	memfree(ilogmem);
+	return log;
+}
+
+ShaderGLES3::Version *ShaderGLES3::_get_fallback_version() {
+
+	//draw with the same conditionals but no custom code while the real version compiles
+	VersionKey key = conditional_version;
+	conditional_version.code_version = 0;
+	Version *fallback = get_current_version();
+	conditional_version = key;
+
+	version_is_fallback = true;
+	return fallback;
+}
+
+bool ShaderGLES3::_check_async_version(Version &v) {
+
+	GLint status;
+	glGetProgramiv(v.id, GL_LINK_STATUS, &status);
+	if (status == GL_TRUE) {
+		return true;
+	}
+
+	//compile errors were not checked when submitting, find out which stage failed
+	String err_string;
+	glGetShaderiv(v.vert_id, GL_COMPILE_STATUS, &status);
+	if (status == GL_FALSE) {
+		err_string = get_shader_name() + ": Vertex Program Compilation Failed:\n" + _get_info_log(v.vert_id, false);
+	} else {
+		glGetShaderiv(v.frag_id, GL_COMPILE_STATUS, &status);
+		if (status == GL_FALSE) {
+			err_string = get_shader_name() + ": Fragment Program Compilation Failed:\n" + _get_info_log(v.frag_id, false);
+		} else {
+			err_string = get_shader_name() + ": Program LINK FAILED:\n" + _get_info_log(v.id, true);
+		}
+	}
+
+	ERR_PRINTS(err_string);
+	glDeleteShader(v.frag_id);
+	glDeleteShader(v.vert_id);
+	glDeleteProgram(v.id);
+	v.id = 0;
+	return false;
+}
+
+void ShaderGLES3::_cancel_compile(Version &v) {
+
+	if (!v.compiling)
+		return;
+
+	glDeleteShader(v.vert_id);
+	glDeleteShader(v.frag_id);
+	glDeleteProgram(v.id);
+	v.id = 0;
+	v.compiling = false;
+	pending_compiles--;
+}
+
+static void _hash_cstr(sha256_context *p_ctx, const char *p_str) {
+
+	//include the terminator so consecutive strings can't be confused
+	sha256_hash(p_ctx, (uint8_t *)p_str, strlen(p_str) + 1);
+}
+
+static void _hash_string(sha256_context *p_ctx, const String &p_str) {
+
+	CharString cs = p_str.utf8();
+	_hash_cstr(p_ctx, cs.get_data());
+}
+
+String ShaderGLES3::_get_version_cache_name(CustomCode *cc) const {
+
+	//everything that ends up in the source strings for this version
+	sha256_context ctx;
+	sha256_init(&ctx);
+
+	uint32_t header[2] = { PROGRAM_CACHE_FORMAT_VERSION, conditional_version.version };
+	sha256_hash(&ctx, (uint8_t *)header, sizeof(header));
+	_hash_string(&ctx, get_shader_name());
+
+	for (int i = 0; i < custom_defines.size(); i++) {
+		_hash_cstr(&ctx, custom_defines[i].get_data());
+	}
+
+	for (int j = 0; j < conditional_count; j++) {
+		_hash_cstr(&ctx, conditional_defines[j]);
+	}
+
+	const CharString *chunks[9] = { &vertex_code0, &vertex_code1, &vertex_code2, &vertex_code3, &fragment_code0, &fragment_code1, &fragment_code2, &fragment_code3, &fragment_code4 };
+	for (int i = 0; i < 9; i++) {
+		_hash_cstr(&ctx, chunks[i]->get_data() ? chunks[i]->get_data() : "");
+	}
+
+	if (cc) {
+		_hash_string(&ctx, cc->code_hash);
+	}
+
+	uint8_t hash[32];
+	sha256_done(&ctx, hash);
+
+	return String::hex_encode_buffer(hash, 16);
+}
+
+bool ShaderGLES3::_load_program_binary(Version &v) {
+
+#ifndef JAVASCRIPT_ENABLED
+	FileAccess *f = FileAccess::open(String(PROGRAM_CACHE_PATH).plus_file(v.cache_name + ".bin"), FileAccess::READ);
+	if (!f)
+		return false;
+
+	uint8_t magic[4];
+	f->get_buffer(magic, 4);
+	uint32_t format_version = f->get_32();
+	uint64_t driver = f->get_64();
+	GLenum binary_format = f->get_32();
+	uint32_t len = f->get_32();
+
+	if (magic[0] != 'G' || magic[1] != 'S' || magic[2] != 'P' || magic[3] != 'B' || format_version != PROGRAM_CACHE_FORMAT_VERSION || driver != program_cache_driver || len == 0 || len > f->get_len()) {
+		memdelete(f);
+		return false;
+	}
+
+	Vector<uint8_t> binary;
+	binary.resize(len);
+	uint32_t read = f->get_buffer(binary.ptrw(), len);
+	memdelete(f);
+
+	if (read != len)
+		return false;
+
+	glProgramBinary(v.id, binary_format, binary.ptr(), len);
+
+	GLint status;
+	glGetProgramiv(v.id, GL_LINK_STATUS, &status);
+	//the driver may refuse binaries it produced itself (eg. after an update), just compile again
+	return status == GL_TRUE;
+#else
+	return false;
+#endif
+}
+
+void ShaderGLES3::_save_program_binary(Version &v) {
+
+#ifndef JAVASCRIPT_ENABLED
+	GLint len = 0;
+	glGetProgramiv(v.id, GL_PROGRAM_BINARY_LENGTH, &len);
+	if (len <= 0)
+		return;
+
+	Vector<uint8_t> binary;
+	binary.resize(len);
+	GLenum binary_format = 0;
+	glGetProgramBinary(v.id, len, &len, &binary_format, binary.ptrw());
+	if (len <= 0)
+		return;
+
+	FileAccess *f = FileAccess::open(String(PROGRAM_CACHE_PATH).plus_file(v.cache_name + ".bin"), FileAccess::WRITE);
+	if (!f)
+		return;
+
+	f->store_buffer((const uint8_t *)"GSPB", 4);
+	f->store_32(PROGRAM_CACHE_FORMAT_VERSION);
+	f->store_64(program_cache_driver);
+	f->store_32(binary_format);
+	f->store_32(len);
+	f->store_buffer(binary.ptr(), len);
+	memdelete(f);
+#endif
+}
+
+void ShaderGLES3::set_program_cache_enabled(bool p_enable) {
+
+	program_cache = false;
+	if (!p_enable)
+		return;
+
+	String driver = String((const char *)glGetString(GL_VENDOR)) + "|" + String((const char *)glGetString(GL_RENDERER)) + "|" + String((const char *)glGetString(GL_VERSION));
+	program_cache_driver = driver.hash64();
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	Error err = da->make_dir_recursive(PROGRAM_CACHE_PATH);
+	if (err != OK || da->change_dir(PROGRAM_CACHE_PATH) != OK) {
+		memdelete(da);
+		ERR_EXPLAIN("Can't create the shader cache directory, program binaries won't be cached");
+		ERR_FAIL();
+	}
+
+	//binaries from another GPU or driver version are useless, remove them instead of letting them pile up
+	String driver_id = String::num_uint64(program_cache_driver, 16);
+	String driver_file = String(PROGRAM_CACHE_PATH).plus_file("driver");
+
+	FileAccess *f = FileAccess::open(driver_file, FileAccess::READ);
+	String stored_id = f ? f->get_line() : String();
+	if (f)
+		memdelete(f);
+
+	if (stored_id != driver_id) {
+
+		da->list_dir_begin();
+		String n = da->get_next();
+		while (n != String()) {
+			if (!da->current_is_dir() && n.get_extension() == "bin") {
+				da->remove(n);
+			}
+			n = da->get_next();
+		}
+		da->list_dir_end();
+
+		f = FileAccess::open(driver_file, FileAccess::WRITE);
+		if (f) {
+			f->store_line(driver_id);
+			memdelete(f);
+		}
+	}
+
+	memdelete(da);
+	program_cache = true;
+}
+
 ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 
 	Version *_v = version_map.getptr(conditional_version);
 
 	if (_v) {
 
+		bool up_to_date = true;
+		CustomCode *cc = NULL;
 		if (conditional_version.code_version != 0) {
-			CustomCode *cc = custom_code_map.getptr(conditional_version.code_version);
+			cc = custom_code_map.getptr(conditional_version.code_version);
 			ERR_FAIL_COND_V(!cc, _v);
-			if (cc->version == _v->code_version)
+			up_to_date = cc->version == _v->code_version;
+		}
+
+		if (up_to_date) {
+
+			if (!_v->compiling)
 				return _v;
-		} else {
+
+			GLint done = GL_FALSE;
+			glGetProgramiv(_v->id, GL_COMPLETION_STATUS_KHR, &done);
+			if (done == GL_FALSE)
+				return _get_fallback_version();
+
+			_v->compiling = false;
+			pending_compiles--;
+
+			if (!_check_async_version(*_v)) {
+				ERR_FAIL_V(NULL);
+			}
+
+			if (program_cache) {
+				_save_program_binary(*_v);
+			}
+
+			_setup_version(*_v, cc);
 			return _v;
 		}
 	}
@@ -200,6 +484,8 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 			glDeleteShader(v.frag_id);
 			glDeleteProgram(v.id);
 			v.id = 0;
+		} else {
+			_cancel_compile(v);
 		}
 	}
 
@@ -253,12 +539,35 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 		define_line_ofs += 2;
 	}
 
+	//only material shaders compile in the background, there is a generic version to fall back to
+	bool async = async_compile && cc && feedback_count == 0;
+
 	/* CREATE PROGRAM */
 
 	v.id = glCreateProgram();
 
 	ERR_FAIL_COND_V(v.id == 0, NULL);
 
+	if (record_variants) {
+		recorded_variants.insert(get_shader_name() + ":" + String::num_uint64(conditional_version.version, 16) + ":" + (cc ? cc->code_hash : String()));
+	}
+
+	if (program_cache) {
+
+		v.cache_name = _get_version_cache_name(cc);
+		if (_load_program_binary(v)) {
+			//linked straight from the cache, no shader objects needed
+			v.vert_id = 0;
+			v.frag_id = 0;
+			_setup_version(v, cc);
+			return &v;
+		}
+
+#ifndef JAVASCRIPT_ENABLED
+		glProgramParameteri(v.id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+	}
+
 	/* VERTEX SHADER */
 
 	if (cc) {
@@ -317,7 +626,11 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 
 	GLint status;
 
-	glGetShaderiv(v.vert_id, GL_COMPILE_STATUS, &status);
+	if (async) {
+		status = GL_TRUE; //checked once the program is linked
+	} else {
+		glGetShaderiv(v.vert_id, GL_COMPILE_STATUS, &status);
+	}
 	if (status == GL_FALSE) {
 		// error compiling
 		GLsizei iloglen;
@@ -410,7 +723,11 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 	glShaderSource(v.frag_id, strings.size(), &strings[0], NULL);
 	glCompileShader(v.frag_id);
 
-	glGetShaderiv(v.frag_id, GL_COMPILE_STATUS, &status);
+	if (async) {
+		status = GL_TRUE;
+	} else {
+		glGetShaderiv(v.frag_id, GL_COMPILE_STATUS, &status);
+	}
 	if (status == GL_FALSE) {
 		// error compiling
 		GLsizei iloglen;
@@ -477,6 +794,13 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 
 	glLinkProgram(v.id);
 
+	if (async) {
+		//the driver compiles and links on its own threads, poll for completion on later binds
+		v.compiling = true;
+		pending_compiles++;
+		return _get_fallback_version();
+	}
+
 	glGetProgramiv(v.id, GL_LINK_STATUS, &status);
 
 	if (status == GL_FALSE) {
@@ -516,6 +840,17 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 		ERR_FAIL_V(NULL);
 	}
 
+	if (program_cache) {
+		_save_program_binary(v);
+	}
+
+	_setup_version(v, cc);
+
+	return &v;
+}
+
+void ShaderGLES3::_setup_version(Version &v, CustomCode *cc) {
+
 	/* UNIFORMS */
 
 	glUseProgram(v.id);
@@ -562,8 +897,6 @@ ShaderGLES3::Version *ShaderGLES3::get_current_version() {
 	glUseProgram(0);
 
 	v.ok = true;
-
-	return &v;
 }
 
 GLint ShaderGLES3::get_uniform_location(const String &p_name) const {
@@ -686,9 +1019,13 @@ void ShaderGLES3::finish() {
 	while ((V = version_map.next(V))) {
 
 		Version &v = version_map[*V];
-		glDeleteShader(v.vert_id);
-		glDeleteShader(v.frag_id);
-		glDeleteProgram(v.id);
+		if (v.compiling) {
+			_cancel_compile(v);
+		} else {
+			glDeleteShader(v.vert_id);
+			glDeleteShader(v.frag_id);
+			glDeleteProgram(v.id);
+		}
 		memdelete_arr(v.uniform_location);
 	}
 }
@@ -699,9 +1036,13 @@ void ShaderGLES3::clear_caches() {
 	while ((V = version_map.next(V))) {
 
 		Version &v = version_map[*V];
-		glDeleteShader(v.vert_id);
-		glDeleteShader(v.frag_id);
-		glDeleteProgram(v.id);
+		if (v.compiling) {
+			_cancel_compile(v);
+		} else {
+			glDeleteShader(v.vert_id);
+			glDeleteShader(v.frag_id);
+			glDeleteProgram(v.id);
+		}
 		memdelete_arr(v.uniform_location);
 	}
 
@@ -734,6 +1075,23 @@ void ShaderGLES3::set_custom_shader_code(uint32_t p_code_id, const String &p_ver
 	cc->uniforms = p_uniforms;
 	cc->custom_defines = p_custom_defines;
 	cc->version++;
+
+	//identifies the code across runs, unlike the id
+	sha256_context ctx;
+	sha256_init(&ctx);
+	for (int i = 0; i < cc->custom_defines.size(); i++) {
+		_hash_cstr(&ctx, cc->custom_defines[i].get_data());
+	}
+	_hash_string(&ctx, cc->uniforms);
+	_hash_string(&ctx, cc->vertex_globals);
+	_hash_string(&ctx, cc->vertex);
+	_hash_string(&ctx, cc->fragment_globals);
+	_hash_string(&ctx, cc->light);
+	_hash_string(&ctx, cc->fragment);
+
+	uint8_t hash[32];
+	sha256_done(&ctx, hash);
+	cc->code_hash = String::hex_encode_buffer(hash, 16);
 }
 
 void ShaderGLES3::set_custom_shader(uint32_t p_code_id) {
@@ -754,6 +1112,14 @@ void ShaderGLES3::free_custom_shader(uint32_t p_code_id) {
 	if (conditional_version.code_version == p_code_id)
 		conditional_version.code_version = 0; //bye
 
+	//nothing will poll versions of this code anymore
+	const VersionKey *V = NULL;
+	while ((V = version_map.next(V))) {
+		if (V->code_version == p_code_id) {
+			_cancel_compile(version_map[*V]);
+		}
+	}
+
 	custom_code_map.erase(p_code_id);
 }
 
@@ -762,14 +1128,83 @@ void ShaderGLES3::set_base_material_tex_index(int p_idx) {
 	base_material_tex_index = p_idx;
 }
 
+void ShaderGLES3::set_variant_recording(bool p_enable) {
+
+	record_variants = p_enable;
+}
+
+Vector<String> ShaderGLES3::get_recorded_variants() {
+
+	Vector<String> variants;
+	for (Set<String>::Element *E = recorded_variants.front(); E; E = E->next()) {
+		variants.push_back(E->get());
+	}
+
+	return variants;
+}
+
+void ShaderGLES3::_precompile_variant(uint32_t p_version, uint32_t p_code_id) {
+
+	VersionKey prev_version = conditional_version;
+	bool prev_fallback = version_is_fallback;
+
+	conditional_version.version = p_version;
+	conditional_version.code_version = p_code_id;
+	get_current_version();
+
+	conditional_version = prev_version;
+	version_is_fallback = prev_fallback;
+}
+
+void ShaderGLES3::precompile_variants(const Vector<String> &p_variants) {
+
+	for (int i = 0; i < instances.size(); i++) {
+
+		ShaderGLES3 *shader = instances[i];
+		String name = shader->get_shader_name();
+
+		//custom code ids change every run, entries refer to the code they contained instead
+		HashMap<String, uint32_t> code_ids;
+		const uint32_t *K = NULL;
+		while ((K = shader->custom_code_map.next(K))) {
+			code_ids[shader->custom_code_map[*K].code_hash] = *K;
+		}
+
+		for (int j = 0; j < p_variants.size(); j++) {
+
+			Vector<String> parts = p_variants[j].split(":");
+			if (parts.size() != 3 || parts[0] != name)
+				continue;
+
+			uint32_t code_id = 0;
+			if (parts[2] != String()) {
+				const uint32_t *id = code_ids.getptr(parts[2]);
+				if (!id)
+					continue; //material not loaded right now
+				code_id = *id;
+			}
+
+			shader->_precompile_variant(parts[1].hex_to_int64(false), code_id);
+		}
+	}
+
+	//compiling leaves no program in use, restore the bound one
+	if (active && active->version) {
+		glUseProgram(active->version->id);
+	}
+}
+
 ShaderGLES3::ShaderGLES3() {
 	version = NULL;
+	version_is_fallback = false;
 	last_custom_code = 1;
 	uniforms_dirty = true;
 	base_material_tex_index = 0;
+	instances.push_back(this);
 }
 
 ShaderGLES3::~ShaderGLES3() {
 
 	finish();
+	instances.erase(this);
 }
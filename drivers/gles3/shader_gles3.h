@@ -43,6 +43,7 @@
 #include "camera_matrix.h"
 #include "hash_map.h"
 #include "map.h"
+#include "set.h"
 #include "variant.h"
 
 /**
@@ -117,6 +118,7 @@ private:
 		uint32_t version;
 		Vector<StringName> texture_uniforms;
 		Vector<CharString> custom_defines;
+		String code_hash;
 	};
 
 	struct Version {
@@ -128,14 +130,18 @@ private:
 		Vector<GLint> texture_uniform_locations;
 		uint32_t code_version;
 		bool ok;
+		bool compiling;
+		String cache_name;
 		Version() {
 			code_version = 0;
 			ok = false;
+			compiling = false;
 			uniform_location = NULL;
 		}
 	};
 
 	Version *version;
+	bool version_is_fallback;
 
 	union VersionKey {
 
@@ -188,8 +194,26 @@ private:
 	int base_material_tex_index;
 
 	Version *get_current_version();
+	Version *_get_fallback_version();
+	bool _check_async_version(Version &v);
+	void _setup_version(Version &v, CustomCode *cc);
+	void _cancel_compile(Version &v);
+
+	String _get_version_cache_name(CustomCode *cc) const;
+	bool _load_program_binary(Version &v);
+	void _save_program_binary(Version &v);
 
 	static ShaderGLES3 *active;
+	static bool async_compile;
+	static int pending_compiles;
+	static bool program_cache;
+	static uint64_t program_cache_driver;
+
+	static bool record_variants;
+	static Set<String> recorded_variants;
+	static Vector<ShaderGLES3 *> instances;
+
+	void _precompile_variant(uint32_t p_version, uint32_t p_code_id);
 
 	int max_image_units;
 
@@ -310,6 +334,13 @@ public:
 	GLint get_uniform_location(int p_index) const;
 
 	static _FORCE_INLINE_ ShaderGLES3 *get_active() { return active; };
+	static void set_async_compile(bool p_enable) { async_compile = p_enable; }
+	static int get_pending_compile_count() { return pending_compiles; }
+	static void set_program_cache_enabled(bool p_enable);
+
+	static void set_variant_recording(bool p_enable);
+	static Vector<String> get_recorded_variants();
+	static void precompile_variants(const Vector<String> &p_variants);
 	bool bind();
 	void unbind();
 	void bind_uniforms();
@@ -46,6 +46,14 @@ layout(location = 0) out vec4 frag_color;
 
 uniform vec4 ssao_color;
 
+#ifdef SSAO_MERGE_UPSCALE
+
+uniform sampler2D source_ssao_depth; //texunit:2
+uniform ivec2 ssao_size;
+uniform int ssao_resolution_shift;
+
+#endif
+
 #endif
 
 #if defined (GLOW_GAUSSIAN_HORIZONTAL) || defined(GLOW_GAUSSIAN_VERTICAL)
@@ -291,7 +299,49 @@ void main() {
 #ifdef SSAO_MERGE
 
 	vec4 color =textureLod( source_color,  uv_interp,0.0);
+
+#ifdef SSAO_MERGE_UPSCALE
+
+	// SSAO was rendered at reduced resolution, upscale it weighting the four
+	// nearest samples by how close their depth is to the depth of this pixel
+	ivec2 ssC = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(source_ssao_depth, ssC, 0).r * 2.0 - 1.0;
+#ifdef USE_ORTHOGONAL_PROJECTION
+	depth = ((depth + (camera_z_far + camera_z_near)/(camera_z_far - camera_z_near)) * (camera_z_far - camera_z_near))/2.0;
+#else
+	depth = 2.0 * camera_z_near * camera_z_far / (camera_z_far + camera_z_near - depth * (camera_z_far - camera_z_near));
+#endif
+
+	vec2 ssao_pos = (vec2(ssC) + 0.5) / float(1 << ssao_resolution_shift) - 0.5;
+	ivec2 ssao_base = ivec2(floor(ssao_pos));
+	vec2 ssao_frac = ssao_pos - vec2(ssao_base);
+
+	float ssao_sum = 0.0;
+	float ssao_weight = 0.0;
+
+	for (int i = 0; i < 4; i++) {
+
+		ivec2 ofs = ivec2(i & 1, i >> 1);
+		ivec2 tap = clamp(ssao_base + ofs, ivec2(0), ssao_size - ivec2(1));
+
+		float tap_depth = texelFetch(source_ssao_depth, tap << ssao_resolution_shift, 0).r * 2.0 - 1.0;
+#ifdef USE_ORTHOGONAL_PROJECTION
+		tap_depth = ((tap_depth + (camera_z_far + camera_z_near)/(camera_z_far - camera_z_near)) * (camera_z_far - camera_z_near))/2.0;
+#else
+		tap_depth = 2.0 * camera_z_near * camera_z_far / (camera_z_far + camera_z_near - tap_depth * (camera_z_far - camera_z_near));
+#endif
+
+		vec2 bilinear = mix(vec2(1.0) - ssao_frac, ssao_frac, vec2(ofs));
+		float weight = bilinear.x * bilinear.y / (abs(tap_depth - depth) / max(depth, 0.0001) + 0.001);
+
+		ssao_sum += texelFetch(source_ssao, tap, 0).r * weight;
+		ssao_weight += weight;
+	}
+
+	float ssao = ssao_sum / max(ssao_weight, 0.0001);
+#else
 	float ssao =textureLod( source_ssao,  uv_interp,0.0).r;
+#endif
 
 	frag_color = vec4( mix(color.rgb,color.rgb*mix(ssao_color.rgb,vec3(1.0),ssao),color.a), 1.0 );
 
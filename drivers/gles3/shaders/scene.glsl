@@ -41,6 +41,19 @@ layout(location=5) in vec2 uv2_attrib;
 
 uniform float normal_mult;
 
+// quantized vertices are relative to the surface AABB, otherwise offset is zero and scale one
+uniform highp vec3 vertex_decode_offset;
+uniform highp vec3 vertex_decode_scale;
+// 1.0 when compressed normals and tangents are octahedral
+uniform float octahedral_compression;
+
+vec3 oct_to_vec3(vec2 e) {
+	vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.xy += t * -sign(v.xy);
+	return normalize(v);
+}
+
 #ifdef USE_SKELETON
 layout(location=6) in uvec4 bone_indices; // attrib:6
 layout(location=7) in vec4 bone_weights; // attrib:7
@@ -102,6 +115,8 @@ layout(std140) uniform SceneData { //ubo:0
 	highp float fog_height_min;
 	highp float fog_height_max;
 	highp float fog_height_curve;
+	highp float light_cluster_z_near;
+	highp float light_cluster_z_scale;
 
 };
 
@@ -269,6 +284,7 @@ out highp vec4 position_interp;
 void main() {
 
 	highp vec4 vertex = vertex_attrib; // vec4(vertex_attrib.xyz * data_attrib.x,1.0);
+	vertex.xyz = vertex.xyz * vertex_decode_scale + vertex_decode_offset;
 
 	mat4 world_matrix = world_transform;
 
@@ -281,13 +297,22 @@ void main() {
 	}
 #endif
 
-	vec3 normal = normal_attrib * normal_mult;
+	vec3 normal = octahedral_compression > 0.5 ? oct_to_vec3(normal_attrib.xy) : normal_attrib;
+	normal *= normal_mult;
 
 
 #if defined(ENABLE_TANGENT_INTERP) || defined(ENABLE_NORMALMAP) || defined(LIGHT_USE_ANISOTROPY)
-	vec3 tangent = tangent_attrib.xyz;
+	vec3 tangent;
+	float binormalf;
+	if (octahedral_compression > 0.5) {
+		//the binormal direction is the sign of y
+		tangent = oct_to_vec3(vec2(tangent_attrib.x, abs(tangent_attrib.y) * 2.0 - 1.0));
+		binormalf = sign(tangent_attrib.y);
+	} else {
+		tangent = tangent_attrib.xyz;
+		binormalf = tangent_attrib.a;
+	}
 	tangent*=normal_mult;
-	float binormalf = tangent_attrib.a;
 #endif
 
 #if defined(ENABLE_COLOR_INTERP)
@@ -691,6 +716,8 @@ layout(std140) uniform SceneData {
 	highp float fog_height_min;
 	highp float fog_height_max;
 	highp float fog_height_curve;
+	highp float light_cluster_z_near;
+	highp float light_cluster_z_scale;
 };
 
 //directional light data
@@ -779,6 +806,13 @@ uniform int spot_light_count;
 uniform int reflection_indices[MAX_FORWARD_LIGHTS];
 uniform int reflection_count;
 
+#if defined(USE_LIGHT_CLUSTERS)
+
+uniform highp usampler2D light_clusters; //texunit:-6
+uniform int instance_layer_mask;
+
+#endif
+
 #endif
 
 
@@ -2031,6 +2065,44 @@ FRAGMENT_SHADER_CODE
 	diffuse_light*=albedo;
 #else
 
+#if defined(USE_LIGHT_CLUSTERS)
+
+	{
+		//find the cluster of this pixel, headers are stored by slice, light items follow them
+		highp float depth = max(-vertex.z,light_cluster_z_near);
+		highp float slice = light_cluster_z_scale > 0.0 ? log(depth / light_cluster_z_near) * light_cluster_z_scale : (depth - light_cluster_z_near) * -light_cluster_z_scale;
+
+		ivec2 tile = clamp(ivec2(gl_FragCoord.xy * screen_pixel_size * vec2(float(LIGHT_CLUSTER_WIDTH),float(LIGHT_CLUSTER_HEIGHT))),ivec2(0),ivec2(LIGHT_CLUSTER_WIDTH-1,LIGHT_CLUSTER_HEIGHT-1));
+		int tile_z = clamp(int(slice),0,LIGHT_CLUSTER_DEPTH-1);
+
+		uvec2 cluster = texelFetch(light_clusters,ivec2(tile.x + tile.y * LIGHT_CLUSTER_WIDTH,tile_z),0).xy;
+
+		const int row_size = LIGHT_CLUSTER_WIDTH * LIGHT_CLUSTER_HEIGHT;
+		int item = int(cluster.x);
+		int omni_count = int(cluster.y & 0xFFFFu);
+		int spot_count = int(cluster.y >> 16);
+
+		for(int i=0;i<omni_count;i++) {
+			uvec2 light = texelFetch(light_clusters,ivec2(item % row_size,LIGHT_CLUSTER_DEPTH + item / row_size),0).xy;
+			item++;
+			if ((light.y & uint(instance_layer_mask)) == 0u) {
+				continue;
+			}
+			light_process_omni(int(light.x),vertex,eye_vec,normal,binormal,tangent,albedo,transmission,roughness,metallic,rim,rim_tint,clearcoat,clearcoat_gloss,anisotropy,specular_blob_intensity,diffuse_light,specular_light);
+		}
+
+		for(int i=0;i<spot_count;i++) {
+			uvec2 light = texelFetch(light_clusters,ivec2(item % row_size,LIGHT_CLUSTER_DEPTH + item / row_size),0).xy;
+			item++;
+			if ((light.y & uint(instance_layer_mask)) == 0u) {
+				continue;
+			}
+			light_process_spot(int(light.x),vertex,eye_vec,normal,binormal,tangent,albedo,transmission,roughness,metallic,rim,rim_tint,clearcoat,clearcoat_gloss,anisotropy,specular_blob_intensity,diffuse_light,specular_light);
+		}
+	}
+
+#else
+
 	for(int i=0;i<omni_light_count;i++) {
 		light_process_omni(omni_light_indices[i],vertex,eye_vec,normal,binormal,tangent,albedo,transmission,roughness,metallic,rim,rim_tint,clearcoat,clearcoat_gloss,anisotropy,specular_blob_intensity,diffuse_light,specular_light);
 	}
@@ -2039,6 +2111,8 @@ FRAGMENT_SHADER_CODE
 		light_process_spot(spot_light_indices[i],vertex,eye_vec,normal,binormal,tangent,albedo,transmission,roughness,metallic,rim,rim_tint,clearcoat,clearcoat_gloss,anisotropy,specular_blob_intensity,diffuse_light,specular_light);
 	}
 
+#endif //USE_LIGHT_CLUSTERS
+
 #endif //USE_VERTEX_LIGHTING
 
 #endif
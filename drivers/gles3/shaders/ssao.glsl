@@ -62,6 +62,7 @@ uniform highp usampler2D source_depth_mipmaps; //texunit:1
 uniform sampler2D source_normal; //texunit:2
 
 uniform ivec2 screen_size;
+uniform int resolution_shift;
 uniform float camera_z_far;
 uniform float camera_z_near;
 
@@ -214,8 +215,9 @@ float sampleAO(in ivec2 ssC, in vec3 C, in vec3 n_C, in float ssDiskRadius,in fl
 void main() {
 
 
-	// Pixel being shaded
-	ivec2 ssC = ivec2(gl_FragCoord.xy);
+	// Pixel being shaded, ssC is in full resolution coordinates when rendering at reduced resolution
+	ivec2 fragC = ivec2(gl_FragCoord.xy);
+	ivec2 ssC = fragC << resolution_shift;
 
 	// World space point being shaded
 	vec3 C = getPosition(ssC);
@@ -236,7 +238,7 @@ void main() {
 #endif
 
 	// Hash function used in the HPG12 AlchemyAO paper
-	float randomPatternRotationAngle = mod(float((3 * ssC.x ^ ssC.y + ssC.x * ssC.y) * 10), TWO_PI);
+	float randomPatternRotationAngle = mod(float((3 * fragC.x ^ fragC.y + fragC.x * fragC.y) * 10), TWO_PI);
 
 	// Reconstruct normals from positions. These will lead to 1-pixel black lines
 	// at depth discontinuities, however the blur will wipe those out so they are not visible
@@ -259,7 +261,7 @@ void main() {
 #ifdef ENABLE_RADIUS2
 
 	//go again for radius2
-	randomPatternRotationAngle = mod(float((5 * ssC.x ^ ssC.y + ssC.x * ssC.y) * 11), TWO_PI);
+	randomPatternRotationAngle = mod(float((5 * fragC.x ^ fragC.y + fragC.x * fragC.y) * 11), TWO_PI);
 
 	// Reconstruct normals from positions. These will lead to 1-pixel black lines
 	// at depth discontinuities, however the blur will wipe those out so they are not visible
@@ -279,10 +281,15 @@ void main() {
 	// Bilateral box-filter over a quad for free, respecting depth edges
 	// (the difference that this makes is subtle)
 	if (abs(dFdx(C.z)) < 0.02) {
-		A -= dFdx(A) * (float(ssC.x & 1) - 0.5);
+		A -= dFdx(A) * (float(fragC.x & 1) - 0.5);
 	}
 	if (abs(dFdy(C.z)) < 0.02) {
-		A -= dFdy(A) * (float(ssC.y & 1) - 0.5);
+		A -= dFdy(A) * (float(fragC.y & 1) - 0.5);
+	}
+
+	if (resolution_shift > 0 && C.z <= -camera_z_far * 0.999) {
+		// We're on the skybox, the depth test can't mask it out at reduced resolution
+		A = 1.0;
 	}
 
 	visibility = A;
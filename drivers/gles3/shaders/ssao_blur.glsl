@@ -59,12 +59,13 @@ uniform float camera_z_far;
 uniform float camera_z_near;
 
 uniform ivec2 screen_size;
+uniform int resolution_shift;
 
 void main() {
 
 	ivec2 ssC = ivec2(gl_FragCoord.xy);
 
-	float depth = texelFetch(source_depth, ssC, 0).r;
+	float depth = texelFetch(source_depth, ssC << resolution_shift, 0).r;
 	//vec3 normal = texelFetch(source_normal,ssC,0).rgb * 2.0 - 1.0;
 
 	depth = depth * 2.0 - 1.0;
@@ -98,7 +99,7 @@ void main() {
 			ivec2 ppos = ssC + axis * (r * filter_scale);
 			float value = texelFetch(source_ssao, clamp(ppos,ivec2(0),clamp_limit), 0).r;
 			ivec2 rpos = clamp(ppos,ivec2(0),clamp_limit);
-			float temp_depth = texelFetch(source_depth, rpos, 0).r;
+			float temp_depth = texelFetch(source_depth, rpos << resolution_shift, 0).r;
 			//vec3 temp_normal = texelFetch(source_normal, rpos, 0).rgb * 2.0 - 1.0;
 
 			temp_depth = temp_depth * 2.0 - 1.0;
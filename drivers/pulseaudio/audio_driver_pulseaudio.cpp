@@ -251,8 +251,12 @@ Error AudioDriverPulseAudio::init() {
 
 	Error err = init_device();
 	if (err == OK) {
-		mutex = Mutex::create();
-		thread = Thread::create(AudioDriverPulseAudio::thread_func, this);
+		mutex = Mutex::create(true, "AudioServer::lock");
+		Thread::Settings settings;
+		settings.name = "Audio Mix";
+		settings.priority = Thread::PRIORITY_REALTIME;
+		settings.core_type = Thread::CORE_TYPE_PERFORMANCE;
+		thread = Thread::create(AudioDriverPulseAudio::thread_func, this, settings);
 	}
 
 	return OK;
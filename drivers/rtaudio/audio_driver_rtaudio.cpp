@@ -80,7 +80,7 @@ int AudioDriverRtAudio::callback(void *outputBuffer, void *inputBuffer, unsigned
 Error AudioDriverRtAudio::init() {
 
 	active = false;
-	mutex = Mutex::create(true);
+	mutex = Mutex::create(true, "AudioServer::lock");
 	dac = memnew(RtAudio);
 
 	ERR_EXPLAIN("Cannot initialize RtAudio audio driver: No devices present.")
@@ -38,6 +38,7 @@
 #include <sys/types.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -65,6 +66,14 @@ void FileAccessUnix::check_errors() const {
 
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_len);
+		mapped = NULL;
+		mapped_len = 0;
+	}
+#endif
+
 	if (f)
 		fclose(f);
 	f = NULL;
@@ -126,6 +135,14 @@ void FileAccessUnix::close() {
 	if (!f)
 		return;
 
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_len);
+		mapped = NULL;
+		mapped_len = 0;
+	}
+#endif
+
 	fclose(f);
 	f = NULL;
 
@@ -230,6 +247,31 @@ int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 };
 
+const uint8_t *FileAccessUnix::map_read_only() {
+
+	ERR_FAIL_COND_V(!f, NULL);
+	ERR_FAIL_COND_V(flags != READ, NULL);
+
+#if defined(UNIX_ENABLED)
+	if (mapped)
+		return mapped;
+
+	size_t len = get_len();
+	if (len == 0)
+		return NULL;
+
+	void *ptr = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (ptr == MAP_FAILED)
+		return NULL;
+
+	mapped = (uint8_t *)ptr;
+	mapped_len = len;
+	return mapped;
+#else
+	return NULL;
+#endif
+}
+
 Error FileAccessUnix::get_error() const {
 
 	return last_error;
@@ -317,6 +359,8 @@ FileAccessUnix::FileAccessUnix() {
 
 	f = NULL;
 	flags = 0;
+	mapped = NULL;
+	mapped_len = 0;
 	last_error = OK;
 }
 
@@ -47,6 +47,8 @@ class FileAccessUnix : public FileAccess {
 
 	FILE *f;
 	int flags;
+	uint8_t *mapped;
+	size_t mapped_len;
 	void check_errors() const;
 	mutable Error last_error;
 	String save_path;
@@ -74,6 +76,7 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *map_read_only();
 
 	virtual Error get_error() const; ///< get last error
 
@@ -44,6 +44,7 @@
 #include "dir_access_unix.h"
 #include "file_access_unix.h"
 #include "packet_peer_udp_posix.h"
+#include "socket_poller_posix.h"
 #include "stream_peer_tcp_posix.h"
 #include "tcp_server_posix.h"
 
@@ -129,6 +130,7 @@ void OS_Unix::initialize_core() {
 	TCPServerPosix::make_default();
 	StreamPeerTCPPosix::make_default();
 	PacketPeerUDPPosix::make_default();
+	SocketPollerPosix::make_default();
 	IP_Unix::make_default();
 #endif
 
@@ -78,6 +78,8 @@ public:
 
 	virtual void set_dest_address(const IP_Address &p_address, int p_port);
 
+	virtual int get_socket_handle() const { return sockfd; }
+
 	static void make_default();
 
 	PacketPeerUDPPosix();
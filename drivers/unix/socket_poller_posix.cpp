@@ -0,0 +1,284 @@
+/*************************************************************************/
+/*  socket_poller_posix.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "socket_poller_posix.h"
+
+#ifdef UNIX_ENABLED
+
+#include <errno.h>
+#include <unistd.h>
+
+#if defined(SOCKET_POLLER_EPOLL)
+#include <sys/epoll.h>
+#elif defined(SOCKET_POLLER_KQUEUE)
+#include <sys/event.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#else
+#include <poll.h>
+#endif
+
+SocketPoller *SocketPollerPosix::_create() {
+
+	return memnew(SocketPollerPosix);
+}
+
+void SocketPollerPosix::make_default() {
+
+	SocketPoller::_create = SocketPollerPosix::_create;
+}
+
+#if defined(SOCKET_POLLER_EPOLL)
+
+Error SocketPollerPosix::_update_handle(int p_handle, int p_old_events, int p_new_events) {
+
+	ERR_FAIL_COND_V(queue_fd == -1, ERR_UNCONFIGURED);
+
+	struct epoll_event ev;
+	ev.events = 0;
+	if (p_new_events & EVENT_READ)
+		ev.events |= EPOLLIN;
+	if (p_new_events & EVENT_WRITE)
+		ev.events |= EPOLLOUT;
+	ev.data.fd = p_handle;
+
+	if (p_new_events == 0) {
+		// closed descriptors are dropped by the kernel already, so ignore failures
+		epoll_ctl(queue_fd, EPOLL_CTL_DEL, p_handle, &ev);
+		return OK;
+	}
+
+	int op = p_old_events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+	if (epoll_ctl(queue_fd, op, p_handle, &ev) != 0) {
+		ERR_PRINTS("epoll_ctl failed with error: " + itos(errno));
+		return FAILED;
+	}
+
+	return OK;
+}
+
+Error SocketPollerPosix::_wait(int p_timeout_msec, Vector<HandleEvent> &r_ready) {
+
+	ERR_FAIL_COND_V(queue_fd == -1, ERR_UNCONFIGURED);
+
+	int max_events = entries.size();
+	event_buffer.resize(max_events * sizeof(struct epoll_event));
+	struct epoll_event *events = (struct epoll_event *)event_buffer.ptrw();
+
+	int count = epoll_wait(queue_fd, events, max_events, p_timeout_msec);
+	if (count < 0) {
+		if (errno == EINTR)
+			return OK;
+		ERR_PRINTS("epoll_wait failed with error: " + itos(errno));
+		return FAILED;
+	}
+
+	for (int i = 0; i < count; i++) {
+
+		HandleEvent he;
+		he.handle = events[i].data.fd;
+		he.events = 0;
+		if (events[i].events & EPOLLIN)
+			he.events |= EVENT_READ;
+		if (events[i].events & EPOLLOUT)
+			he.events |= EVENT_WRITE;
+		if (events[i].events & (EPOLLERR | EPOLLHUP))
+			he.events |= EVENT_ERROR;
+		r_ready.push_back(he);
+	}
+
+	return OK;
+}
+
+#elif defined(SOCKET_POLLER_KQUEUE)
+
+Error SocketPollerPosix::_update_handle(int p_handle, int p_old_events, int p_new_events) {
+
+	ERR_FAIL_COND_V(queue_fd == -1, ERR_UNCONFIGURED);
+
+	// kqueue keeps read and write interest as separate filters
+	struct kevent changes[2];
+	int change_count = 0;
+
+	if ((p_new_events & EVENT_READ) != (p_old_events & EVENT_READ)) {
+		EV_SET(&changes[change_count++], p_handle, EVFILT_READ, (p_new_events & EVENT_READ) ? EV_ADD : EV_DELETE, 0, 0, NULL);
+	}
+	if ((p_new_events & EVENT_WRITE) != (p_old_events & EVENT_WRITE)) {
+		EV_SET(&changes[change_count++], p_handle, EVFILT_WRITE, (p_new_events & EVENT_WRITE) ? EV_ADD : EV_DELETE, 0, 0, NULL);
+	}
+
+	if (change_count == 0)
+		return OK;
+
+	if (kevent(queue_fd, changes, change_count, NULL, 0, NULL) < 0 && p_new_events != 0) {
+		// closed descriptors are dropped by the kernel already, so only adding can fail
+		ERR_PRINTS("kevent failed with error: " + itos(errno));
+		return FAILED;
+	}
+
+	return OK;
+}
+
+Error SocketPollerPosix::_wait(int p_timeout_msec, Vector<HandleEvent> &r_ready) {
+
+	ERR_FAIL_COND_V(queue_fd == -1, ERR_UNCONFIGURED);
+
+	// each socket can report a read and a write filter
+	int max_events = entries.size() * 2;
+	event_buffer.resize(max_events * sizeof(struct kevent));
+	struct kevent *events = (struct kevent *)event_buffer.ptrw();
+
+	struct timespec ts;
+	ts.tv_sec = p_timeout_msec / 1000;
+	ts.tv_nsec = (p_timeout_msec % 1000) * 1000000;
+
+	int count = kevent(queue_fd, NULL, 0, events, max_events, p_timeout_msec < 0 ? NULL : &ts);
+	if (count < 0) {
+		if (errno == EINTR)
+			return OK;
+		ERR_PRINTS("kevent failed with error: " + itos(errno));
+		return FAILED;
+	}
+
+	int from = r_ready.size();
+	for (int i = 0; i < count; i++) {
+
+		int handle = events[i].ident;
+		int ev = 0;
+		if (events[i].filter == EVFILT_READ)
+			ev |= EVENT_READ;
+		if (events[i].filter == EVFILT_WRITE)
+			ev |= EVENT_WRITE;
+		if (events[i].flags & (EV_ERROR | EV_EOF))
+			ev |= EVENT_ERROR;
+
+		// merge read and write filters of the same socket
+		bool merged = false;
+		for (int j = from; j < r_ready.size(); j++) {
+			if (r_ready[j].handle == handle) {
+				r_ready.write[j].events |= ev;
+				merged = true;
+				break;
+			}
+		}
+
+		if (!merged) {
+			HandleEvent he;
+			he.handle = handle;
+			he.events = ev;
+			r_ready.push_back(he);
+		}
+	}
+
+	return OK;
+}
+
+#else
+
+Error SocketPollerPosix::_update_handle(int p_handle, int p_old_events, int p_new_events) {
+
+	// interest is rebuilt from the entries on every wait
+	return OK;
+}
+
+Error SocketPollerPosix::_wait(int p_timeout_msec, Vector<HandleEvent> &r_ready) {
+
+	int max_events = entries.size();
+	event_buffer.resize(max_events * sizeof(struct pollfd));
+	struct pollfd *fds = (struct pollfd *)event_buffer.ptrw();
+
+	int idx = 0;
+	for (Map<int, Entry>::Element *E = entries.front(); E; E = E->next()) {
+
+		fds[idx].fd = E->key();
+		fds[idx].events = 0;
+		fds[idx].revents = 0;
+		if (E->get().events & EVENT_READ)
+			fds[idx].events |= POLLIN;
+		if (E->get().events & EVENT_WRITE)
+			fds[idx].events |= POLLOUT;
+		idx++;
+	}
+
+	int count = poll(fds, max_events, p_timeout_msec);
+	if (count < 0) {
+		if (errno == EINTR)
+			return OK;
+		ERR_PRINTS("poll failed with error: " + itos(errno));
+		return FAILED;
+	}
+
+	for (int i = 0; i < max_events && count > 0; i++) {
+
+		if (fds[i].revents == 0)
+			continue;
+		count--;
+
+		HandleEvent he;
+		he.handle = fds[i].fd;
+		he.events = 0;
+		if (fds[i].revents & POLLIN)
+			he.events |= EVENT_READ;
+		if (fds[i].revents & POLLOUT)
+			he.events |= EVENT_WRITE;
+		if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+			he.events |= EVENT_ERROR;
+		r_ready.push_back(he);
+	}
+
+	return OK;
+}
+
+#endif
+
+SocketPollerPosix::SocketPollerPosix() {
+
+#if defined(SOCKET_POLLER_EPOLL)
+	queue_fd = epoll_create(1);
+#elif defined(SOCKET_POLLER_KQUEUE)
+	queue_fd = kqueue();
+#endif
+
+#if defined(SOCKET_POLLER_EPOLL) || defined(SOCKET_POLLER_KQUEUE)
+	if (queue_fd == -1) {
+		ERR_PRINTS("Failed to create socket poller queue, error: " + itos(errno));
+	}
+#endif
+}
+
+SocketPollerPosix::~SocketPollerPosix() {
+
+#if defined(SOCKET_POLLER_EPOLL) || defined(SOCKET_POLLER_KQUEUE)
+	if (queue_fd != -1)
+		close(queue_fd);
+#endif
+}
+
+#endif // UNIX_ENABLED
@@ -0,0 +1,66 @@
+/*************************************************************************/
+/*  socket_poller_posix.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SOCKET_POLLER_POSIX_H
+#define SOCKET_POLLER_POSIX_H
+
+#ifdef UNIX_ENABLED
+
+#include "core/io/socket_poller.h"
+
+#if defined(__linux__)
+#define SOCKET_POLLER_EPOLL
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__DragonFly__)
+#define SOCKET_POLLER_KQUEUE
+#endif
+
+class SocketPollerPosix : public SocketPoller {
+
+#if defined(SOCKET_POLLER_EPOLL) || defined(SOCKET_POLLER_KQUEUE)
+	int queue_fd;
+#endif
+	Vector<uint8_t> event_buffer;
+
+	static SocketPoller *_create();
+
+protected:
+	virtual Error _update_handle(int p_handle, int p_old_events, int p_new_events);
+	virtual Error _wait(int p_timeout_msec, Vector<HandleEvent> &r_ready);
+
+public:
+	static void make_default();
+
+	SocketPollerPosix();
+	~SocketPollerPosix();
+};
+
+#endif // UNIX_ENABLED
+
+#endif // SOCKET_POLLER_POSIX_H
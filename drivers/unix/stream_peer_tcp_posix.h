@@ -79,6 +79,8 @@ public:
 
 	virtual void set_no_delay(bool p_enabled);
 
+	virtual int get_socket_handle() const { return sockfd; }
+
 	static void make_default();
 
 	StreamPeerTCPPosix();
@@ -48,6 +48,8 @@ public:
 
 	virtual void stop();
 
+	virtual int get_socket_handle() const { return listen_sockfd; }
+
 	static void make_default();
 
 	TCPServerPosix();
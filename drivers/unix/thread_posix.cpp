@@ -37,6 +37,17 @@
 #include <pthread_np.h>
 #endif
 
+#include <sched.h>
+
+#if defined(__linux__)
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread/qos.h>
+#endif
+
 #include "core/safe_refcount.h"
 #include "os/memory.h"
 
@@ -48,6 +59,7 @@ static pthread_key_t _create_thread_id_key() {
 
 pthread_key_t ThreadPosix::thread_id_key = _create_thread_id_key();
 Thread::ID ThreadPosix::next_thread_id = 0;
+uint64_t ThreadPosix::core_type_masks[CORE_TYPE_EFFICIENCY + 1] = { 0, 0, 0 };
 
 Thread::ID ThreadPosix::get_id() const {
 
@@ -65,6 +77,8 @@ void *ThreadPosix::thread_callback(void *userdata) {
 	t->id = atomic_increment(&next_thread_id);
 	pthread_setspecific(thread_id_key, (void *)t->id);
 
+	_apply_settings(t->settings);
+
 	ScriptServer::thread_enter(); //scripts may need to attach a stack
 
 	t->callback(t->user);
@@ -74,11 +88,122 @@ void *ThreadPosix::thread_callback(void *userdata) {
 	return NULL;
 }
 
-Thread *ThreadPosix::create_func_posix(ThreadCreateCallback p_callback, void *p_user, const Settings &) {
+void ThreadPosix::_detect_core_types() {
+
+#if defined(__linux__)
+	// asymmetric CPUs expose different maximum frequencies per core,
+	// the fastest cores are taken as performance cores and the slowest as efficiency ones
+	int count = MIN(sysconf(_SC_NPROCESSORS_CONF), 64);
+	uint64_t freqs[64];
+	uint64_t max_freq = 0;
+	uint64_t min_freq = 0;
+
+	for (int i = 0; i < count; i++) {
+
+		freqs[i] = 0;
+
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
+		FILE *f = fopen(path, "r");
+		if (!f)
+			continue;
+
+		unsigned long long freq = 0;
+		if (fscanf(f, "%llu", &freq) == 1) {
+			freqs[i] = freq;
+		}
+		fclose(f);
+
+		if (freqs[i] == 0)
+			continue;
+
+		max_freq = MAX(max_freq, freqs[i]);
+		min_freq = min_freq == 0 ? freqs[i] : MIN(min_freq, freqs[i]);
+	}
+
+	if (max_freq == min_freq)
+		return; //symmetric, or unknown
+
+	for (int i = 0; i < count; i++) {
+
+		if (freqs[i] == max_freq) {
+			core_type_masks[CORE_TYPE_PERFORMANCE] |= uint64_t(1) << i;
+		} else if (freqs[i] == min_freq) {
+			core_type_masks[CORE_TYPE_EFFICIENCY] |= uint64_t(1) << i;
+		}
+	}
+#endif
+}
+
+void ThreadPosix::_apply_settings(const Settings &p_settings) {
+
+	if (p_settings.name != String()) {
+		set_name_func_posix(p_settings.name);
+	}
+
+	// failures are ignored, the thread simply keeps the default scheduling
+
+#if defined(__APPLE__)
+	qos_class_t qos = QOS_CLASS_DEFAULT;
+	switch (p_settings.priority) {
+		case PRIORITY_LOW: qos = QOS_CLASS_UTILITY; break;
+		case PRIORITY_NORMAL: qos = QOS_CLASS_DEFAULT; break;
+		case PRIORITY_HIGH: qos = QOS_CLASS_USER_INITIATED; break;
+		case PRIORITY_REALTIME: qos = QOS_CLASS_USER_INTERACTIVE; break;
+	}
+	pthread_set_qos_class_self_np(qos, 0);
+#else
+	bool scheduled = false;
+	if (p_settings.priority == PRIORITY_REALTIME) {
+		sched_param param;
+		int min_prio = sched_get_priority_min(SCHED_FIFO);
+		int max_prio = sched_get_priority_max(SCHED_FIFO);
+		param.sched_priority = (min_prio + max_prio) / 2;
+		scheduled = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+	}
+
+	if (!scheduled && p_settings.priority != PRIORITY_NORMAL) {
+#if defined(__linux__)
+		// normal threads have a single static priority on Linux, but nice values are per thread
+		int nice_value = p_settings.priority == PRIORITY_LOW ? 5 : -5;
+		if (p_settings.priority == PRIORITY_REALTIME) {
+			nice_value = -10;
+		}
+		setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice_value);
+#else
+		sched_param param;
+		int policy;
+		if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+			int min_prio = sched_get_priority_min(policy);
+			int max_prio = sched_get_priority_max(policy);
+			param.sched_priority = p_settings.priority == PRIORITY_LOW ? min_prio : max_prio;
+			pthread_setschedparam(pthread_self(), policy, &param);
+		}
+#endif
+	}
+#endif
+
+#if defined(__linux__)
+	uint64_t mask = p_settings.affinity_mask ? p_settings.affinity_mask : core_type_masks[p_settings.core_type];
+	if (mask) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int i = 0; i < 64; i++) {
+			if (mask & (uint64_t(1) << i)) {
+				CPU_SET(i, &set);
+			}
+		}
+		sched_setaffinity(0, sizeof(set), &set);
+	}
+#endif
+}
+
+Thread *ThreadPosix::create_func_posix(ThreadCreateCallback p_callback, void *p_user, const Settings &p_settings) {
 
 	ThreadPosix *tr = memnew(ThreadPosix);
 	tr->callback = p_callback;
 	tr->user = p_user;
+	tr->settings = p_settings;
 	pthread_attr_init(&tr->pthread_attr);
 	pthread_attr_setdetachstate(&tr->pthread_attr, PTHREAD_CREATE_JOINABLE);
 	pthread_attr_setstacksize(&tr->pthread_attr, 256 * 1024);
@@ -137,6 +262,8 @@ void ThreadPosix::make_default() {
 	get_thread_id_func = get_thread_id_func_posix;
 	wait_to_finish_func = wait_to_finish_func_posix;
 	set_name_func = set_name_func_posix;
+
+	_detect_core_types();
 }
 
 ThreadPosix::ThreadPosix() {
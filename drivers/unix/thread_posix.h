@@ -51,9 +51,15 @@ class ThreadPosix : public Thread {
 	ThreadCreateCallback callback;
 	void *user;
 	ID id;
+	Settings settings;
+
+	static uint64_t core_type_masks[CORE_TYPE_EFFICIENCY + 1];
 
 	static Thread *create_thread_posix();
 
+	static void _detect_core_types();
+	static void _apply_settings(const Settings &p_settings);
+
 	static void *thread_callback(void *userdata);
 
 	static Thread *create_func_posix(ThreadCreateCallback p_callback, void *, const Settings &);
@@ -329,8 +329,12 @@ Error AudioDriverWASAPI::init() {
 	exit_thread = false;
 	thread_exited = false;
 
-	mutex = Mutex::create(true);
-	thread = Thread::create(thread_func, this);
+	mutex = Mutex::create(true, "AudioServer::lock");
+	Thread::Settings settings;
+	settings.name = "Audio Mix";
+	settings.priority = Thread::PRIORITY_REALTIME;
+	settings.core_type = Thread::CORE_TYPE_PERFORMANCE;
+	thread = Thread::create(thread_func, this, settings);
 
 	return OK;
 }
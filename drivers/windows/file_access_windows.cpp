@@ -36,6 +36,7 @@
 #include <windows.h>
 
 #include "print_string.h"
+#include <io.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <tchar.h>
@@ -128,6 +129,13 @@ void FileAccessWindows::close() {
 	if (!f)
 		return;
 
+	if (mapped) {
+		UnmapViewOfFile(mapped);
+		CloseHandle((HANDLE)mapping);
+		mapped = NULL;
+		mapping = NULL;
+	}
+
 	fclose(f);
 	f = NULL;
 
@@ -254,6 +262,40 @@ int FileAccessWindows::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 };
 
+const uint8_t *FileAccessWindows::map_read_only() {
+
+	ERR_FAIL_COND_V(!f, NULL);
+	ERR_FAIL_COND_V(flags != READ, NULL);
+
+#ifdef UWP_ENABLED
+	return NULL;
+#else
+	if (mapped)
+		return mapped;
+
+	if (get_len() == 0)
+		return NULL;
+
+	HANDLE file = (HANDLE)_get_osfhandle(_fileno(f));
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	HANDLE map = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!map)
+		return NULL;
+
+	void *ptr = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+	if (!ptr) {
+		CloseHandle(map);
+		return NULL;
+	}
+
+	mapping = map;
+	mapped = (uint8_t *)ptr;
+	return mapped;
+#endif
+}
+
 Error FileAccessWindows::get_error() const {
 
 	return last_error;
@@ -315,6 +357,8 @@ FileAccessWindows::FileAccessWindows() {
 
 	f = NULL;
 	flags = 0;
+	mapping = NULL;
+	mapped = NULL;
 	last_error = OK;
 }
 FileAccessWindows::~FileAccessWindows() {
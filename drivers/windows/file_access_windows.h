@@ -44,6 +44,8 @@ class FileAccessWindows : public FileAccess {
 
 	FILE *f;
 	int flags;
+	void *mapping; // HANDLE of the file mapping, if mapped
+	uint8_t *mapped;
 	void check_errors() const;
 	mutable Error last_error;
 	String path;
@@ -67,6 +69,7 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *map_read_only();
 
 	virtual Error get_error() const; ///< get last error
 
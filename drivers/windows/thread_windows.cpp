@@ -51,6 +51,7 @@ DWORD ThreadWindows::thread_callback(LPVOID userdata) {
 	ScriptServer::thread_enter(); //scripts may need to attach a stack
 
 	t->id = (ID)GetCurrentThreadId(); // must implement
+	_apply_settings(t->settings);
 	t->callback(t->user);
 
 	ScriptServer::thread_exit();
@@ -58,11 +59,33 @@ DWORD ThreadWindows::thread_callback(LPVOID userdata) {
 	return 0;
 }
 
-Thread *ThreadWindows::create_func_windows(ThreadCreateCallback p_callback, void *p_user, const Settings &) {
+void ThreadWindows::_apply_settings(const Settings &p_settings) {
+
+	if (p_settings.name != String()) {
+		set_name_func_windows(p_settings.name);
+	}
+
+	int priority = THREAD_PRIORITY_NORMAL;
+	switch (p_settings.priority) {
+		case PRIORITY_LOW: priority = THREAD_PRIORITY_BELOW_NORMAL; break;
+		case PRIORITY_NORMAL: priority = THREAD_PRIORITY_NORMAL; break;
+		case PRIORITY_HIGH: priority = THREAD_PRIORITY_ABOVE_NORMAL; break;
+		case PRIORITY_REALTIME: priority = THREAD_PRIORITY_TIME_CRITICAL; break;
+	}
+	SetThreadPriority(GetCurrentThread(), priority);
+
+	// core types are not queried here, only explicit masks are supported
+	if (p_settings.affinity_mask) {
+		SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)p_settings.affinity_mask);
+	}
+}
+
+Thread *ThreadWindows::create_func_windows(ThreadCreateCallback p_callback, void *p_user, const Settings &p_settings) {
 
 	ThreadWindows *tr = memnew(ThreadWindows);
 	tr->callback = p_callback;
 	tr->user = p_user;
+	tr->settings = p_settings;
 	tr->handle = CreateThread(
 			NULL, // default security attributes
 			0, // use default stack size
@@ -86,11 +109,24 @@ void ThreadWindows::wait_to_finish_func_windows(Thread *p_thread) {
 	//`memdelete(tp);
 }
 
+typedef HRESULT(WINAPI *SetThreadDescriptionPtr)(HANDLE, PCWSTR);
+
+Error ThreadWindows::set_name_func_windows(const String &p_name) {
+
+	// only available since Windows 10 1607, so look it up at runtime
+	static SetThreadDescriptionPtr set_thread_description = (SetThreadDescriptionPtr)GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription");
+	if (!set_thread_description)
+		return ERR_UNAVAILABLE;
+
+	return SUCCEEDED(set_thread_description(GetCurrentThread(), p_name.c_str())) ? OK : ERR_INVALID_PARAMETER;
+}
+
 void ThreadWindows::make_default() {
 
 	create_func = create_func_windows;
 	get_thread_id_func = get_thread_id_func_windows;
 	wait_to_finish_func = wait_to_finish_func_windows;
+	set_name_func = set_name_func_windows;
 }
 
 ThreadWindows::ThreadWindows() {
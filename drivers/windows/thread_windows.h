@@ -47,15 +47,20 @@ class ThreadWindows : public Thread {
 	void *user;
 	ID id;
 	HANDLE handle;
+	Settings settings;
 
 	static Thread *create_thread_windows();
 
+	static void _apply_settings(const Settings &p_settings);
+
 	static DWORD WINAPI thread_callback(LPVOID userdata);
 
 	static Thread *create_func_windows(ThreadCreateCallback p_callback, void *, const Settings &);
 	static ID get_thread_id_func_windows();
 	static void wait_to_finish_func_windows(Thread *p_thread);
 
+	static Error set_name_func_windows(const String &p_name);
+
 	ThreadWindows();
 
 public:
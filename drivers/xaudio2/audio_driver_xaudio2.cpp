@@ -87,8 +87,12 @@ Error AudioDriverXAudio2::init() {
 		ERR_FAIL_V(ERR_UNAVAILABLE);
 	}
 
-	mutex = Mutex::create();
-	thread = Thread::create(AudioDriverXAudio2::thread_func, this);
+	mutex = Mutex::create(true, "AudioServer::lock");
+	Thread::Settings settings;
+	settings.name = "Audio Mix";
+	settings.priority = Thread::PRIORITY_REALTIME;
+	settings.core_type = Thread::CORE_TYPE_PERFORMANCE;
+	thread = Thread::create(AudioDriverXAudio2::thread_func, this, settings);
 
 	return OK;
 };
@@ -35,10 +35,12 @@
 #include "editor_node.h"
 #include "editor_settings.h"
 #include "io/config_file.h"
+#include "io/file_access_pack.h"
 #include "io/resource_loader.h"
 #include "io/resource_saver.h"
 #include "io/zip_io.h"
 #include "os/file_access.h"
+#include "os/worker_thread_pool.h"
 #include "project_settings.h"
 #include "scene/resources/scene_format_text.h"
 #include "script_language.h"
@@ -273,39 +275,191 @@ void EditorExportPlatform::gen_debug_flags(Vector<String> &r_flags, int p_flags)
 	}
 }
 
-Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total) {
+#define PACK_BATCH_SIZE (64 * 1024 * 1024)
+#define PACK_BATCH_FILES 256
+
+void EditorExportPlatform::_prepare_pack_file(void *p_userdata, uint32_t p_index) {
 
 	PackData *pd = (PackData *)p_userdata;
+	PendingPackFile &pf = pd->pending.write[p_index];
+
+	MD5_CTX ctx;
+	MD5Init(&ctx);
+	MD5Update(&ctx, (unsigned char *)pf.data.ptr(), pf.data.size());
+	MD5Final(&ctx);
+	pf.sd.md5.resize(16);
+	for (int i = 0; i < 16; i++) {
+		pf.sd.md5.write[i] = ctx.digest[i];
+	}
+
+	if (!pd->compress)
+		return;
+
+	const PreviousPackFile *previous = pd->previous_files.getptr(String::utf8(pf.sd.path_utf8.get_data()));
+	if (previous && previous->size == pf.sd.size && memcmp(previous->md5, ctx.digest, 16) == 0) {
+		pf.previous = previous; // same contents as last time, its compressed blocks are copied instead
+		return;
+	}
+
+	if (PackedSourcePCK::compress_file(pf.data.ptr(), pf.data.size(), pf.compressed)) {
+		pf.sd.flags |= PACK_FILE_COMPRESSED;
+	}
+}
+
+bool EditorExportPlatform::_copy_previous_pack_file(PackData *p_pd, const PreviousPackFile &p_file) {
+
+	FileAccess *src = p_pd->previous_pack;
+
+	// compressed files start with their block table, which gives the stored size
+	src->seek(p_file.ofs);
+	uint32_t block_size = src->get_32();
+	uint32_t block_count = src->get_32();
+	if (block_size != PackedSourcePCK::COMPRESSION_BLOCK_SIZE || block_count != (p_file.size + block_size - 1) / block_size) {
+		return false;
+	}
+
+	uint64_t stored = 8 + uint64_t(block_count) * 4;
+	for (uint32_t i = 0; i < block_count; i++) {
+		stored += src->get_32();
+	}
+	if (p_file.ofs + stored > src->get_len()) {
+		return false;
+	}
+
+	src->seek(p_file.ofs);
 
-	SavedData sd;
-	sd.path_utf8 = p_path.utf8();
-	sd.ofs = pd->f->get_position();
-	sd.size = p_data.size();
-
-	pd->f->store_buffer(p_data.ptr(), p_data.size());
-	int pad = _get_pad(PCK_PADDING, sd.size);
-	for (int i = 0; i < pad; i++) {
-		pd->f->store_8(0);
-	}
-
-	{
-		MD5_CTX ctx;
-		MD5Init(&ctx);
-		MD5Update(&ctx, (unsigned char *)p_data.ptr(), p_data.size());
-		MD5Final(&ctx);
-		sd.md5.resize(16);
-		for (int i = 0; i < 16; i++) {
-			sd.md5.write[i] = ctx.digest[i];
+	const int bufsize = 65536;
+	uint8_t buf[bufsize];
+	while (stored > 0) {
+		int got = src->get_buffer(buf, MIN(uint64_t(bufsize), stored));
+		if (got <= 0)
+			return false;
+		p_pd->f->store_buffer(buf, got);
+		stored -= got;
+	}
+
+	return true;
+}
+
+void EditorExportPlatform::_flush_pack_files(PackData *p_pd) {
+
+	if (p_pd->pending.empty())
+		return;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	pool->wait_for_group_task_completion(pool->add_group_task(_prepare_pack_file, p_pd, p_pd->pending.size(), WorkerThreadPool::PRIORITY_HIGH));
+
+	for (int i = 0; i < p_pd->pending.size(); i++) {
+
+		PendingPackFile &pf = p_pd->pending.write[i];
+		SavedData &sd = pf.sd;
+		sd.ofs = p_pd->f->get_position();
+
+		if (pf.previous) {
+			if (_copy_previous_pack_file(p_pd, *pf.previous)) {
+				sd.flags |= PACK_FILE_COMPRESSED;
+				p_pd->reused_files++;
+			} else {
+				// previous pack is not what its header says, compress again
+				p_pd->f->seek(sd.ofs);
+				if (PackedSourcePCK::compress_file(pf.data.ptr(), pf.data.size(), pf.compressed)) {
+					sd.flags |= PACK_FILE_COMPRESSED;
+				}
+			}
 		}
+
+		if (!(sd.flags & PACK_FILE_COMPRESSED)) {
+			p_pd->f->store_buffer(pf.data.ptr(), pf.data.size());
+		} else if (!pf.compressed.empty()) {
+			p_pd->f->store_buffer(pf.compressed.ptr(), pf.compressed.size());
+		}
+
+		int pad = _get_pad(PCK_PADDING, p_pd->f->get_position() - sd.ofs);
+		for (int j = 0; j < pad; j++) {
+			p_pd->f->store_8(0);
+		}
+
+		p_pd->file_ofs.push_back(sd);
 	}
 
-	pd->file_ofs.push_back(sd);
+	p_pd->pending.clear();
+	p_pd->pending_size = 0;
+}
+
+Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total) {
+
+	PackData *pd = (PackData *)p_userdata;
+
+	PendingPackFile pf;
+	pf.sd.path_utf8 = p_path.utf8();
+	pf.sd.ofs = 0;
+	pf.sd.size = p_data.size();
+	pf.sd.flags = 0;
+	pf.data = p_data;
+	pf.previous = NULL;
+
+	pd->pending.push_back(pf);
+	pd->pending_size += p_data.size();
+
+	if (pd->pending_size >= PACK_BATCH_SIZE || pd->pending.size() >= PACK_BATCH_FILES) {
+		_flush_pack_files(pd);
+	}
 
 	pd->ep->step(TTR("Storing File:") + " " + p_path, 2 + p_file * 100 / p_total, false);
 
 	return OK;
 }
 
+void EditorExportPlatform::_load_previous_pack(const String &p_path, PackData *p_pd) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	if (!f)
+		return;
+
+	// only packs written with the same layout by this version can donate their files
+	if (f->get_32() != 0x43504447 || f->get_32() != PACK_FORMAT_VERSION || f->get_32() != VERSION_MAJOR || f->get_32() != VERSION_MINOR) {
+		memdelete(f);
+		return;
+	}
+
+	f->get_32(); // revision
+	for (int i = 0; i < 16; i++) {
+		//reserved
+		f->get_32();
+	}
+
+	uint32_t file_count = f->get_32();
+	for (uint32_t i = 0; i < file_count && !f->eof_reached(); i++) {
+
+		uint32_t sl = f->get_32();
+		CharString cs;
+		cs.resize(sl + 1);
+		f->get_buffer((uint8_t *)cs.ptrw(), sl);
+		cs[sl] = 0;
+
+		String path;
+		path.parse_utf8(cs.ptr());
+
+		PreviousPackFile pf;
+		pf.ofs = f->get_64();
+		pf.size = f->get_64();
+		f->get_buffer(pf.md5, 16);
+		uint32_t flags = f->get_32();
+
+		if (flags & PACK_FILE_COMPRESSED) {
+			p_pd->previous_files[path] = pf;
+		}
+	}
+
+	if (f->eof_reached() || p_pd->previous_files.empty()) {
+		p_pd->previous_files.clear();
+		memdelete(f);
+		return;
+	}
+
+	p_pd->previous_pack = f;
+}
+
 Error EditorExportPlatform::_save_zip_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total) {
 
 	String path = p_path.replace_first("res://", "");
@@ -804,12 +958,28 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	PackData pd;
 	pd.ep = &ep;
 	pd.f = ftmp;
+	pd.compress = GLOBAL_GET("editor/compress_exported_pack");
 	pd.so_files = p_so_files;
+	pd.pending_size = 0;
+	pd.previous_pack = NULL;
+	pd.reused_files = 0;
+
+	if (pd.compress && GLOBAL_GET("editor/incremental_pack_export")) {
+		_load_previous_pack(p_path, &pd);
+	}
 
 	Error err = export_project_files(p_preset, _save_pack_file, &pd, _add_shared_object);
+	if (err == OK) {
+		_flush_pack_files(&pd);
+	}
 
 	memdelete(ftmp); //close tmp file
 
+	if (pd.previous_pack) {
+		memdelete(pd.previous_pack); //must be closed before it's overwritten
+		print_line("Reused " + itos(pd.reused_files) + " unchanged files from the previous pack.");
+	}
+
 	if (err)
 		return err;
 
@@ -818,7 +988,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
 	ERR_FAIL_COND_V(!f, ERR_CANT_CREATE)
 	f->store_32(0x43504447); //GDPK
-	f->store_32(1); //pack version
+	f->store_32(PACK_FORMAT_VERSION); //pack version
 	f->store_32(VERSION_MAJOR);
 	f->store_32(VERSION_MINOR);
 	f->store_32(0); //hmph
@@ -840,6 +1010,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 		header_size += 8; // offset to file _with_ header size included
 		header_size += 8; // size of file
 		header_size += 16; // md5
+		header_size += 4; // flags
 	}
 
 	size_t header_padding = _get_pad(PCK_PADDING, header_size);
@@ -858,6 +1029,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 		f->store_64(pd.file_ofs[i].ofs + header_padding + header_size);
 		f->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
 		f->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
+		f->store_32(pd.file_ofs[i].flags);
 	}
 
 	for (uint32_t j = 0; j < header_padding; j++) {
@@ -1220,6 +1392,9 @@ EditorExport::EditorExport() {
 	save_timer->connect("timeout", this, "_save");
 	block_save = false;
 
+	GLOBAL_DEF("editor/compress_exported_pack", false);
+	GLOBAL_DEF("editor/incremental_pack_export", false);
+
 	singleton = this;
 }
 
@@ -1230,6 +1405,9 @@ EditorExport::~EditorExport() {
 
 void EditorExportPlatformPC::get_preset_features(const Ref<EditorExportPreset> &p_preset, List<String> *r_features) {
 
+	if (p_preset->get("texture_format/bptc")) {
+		r_features->push_back("bptc");
+	}
 	if (p_preset->get("texture_format/s3tc")) {
 		r_features->push_back("s3tc");
 	}
@@ -1249,6 +1427,7 @@ void EditorExportPlatformPC::get_preset_features(const Ref<EditorExportPreset> &
 
 void EditorExportPlatformPC::get_export_options(List<ExportOption> *r_options) {
 
+	r_options->push_back(ExportOption(PropertyInfo(Variant::BOOL, "texture_format/bptc"), false));
 	r_options->push_back(ExportOption(PropertyInfo(Variant::BOOL, "texture_format/s3tc"), true));
 	r_options->push_back(ExportOption(PropertyInfo(Variant::BOOL, "texture_format/etc"), false));
 	r_options->push_back(ExportOption(PropertyInfo(Variant::BOOL, "texture_format/etc2"), false));
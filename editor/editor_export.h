@@ -144,6 +144,7 @@ private:
 
 		uint64_t ofs;
 		uint64_t size;
+		uint32_t flags;
 		Vector<uint8_t> md5;
 		CharString path_utf8;
 
@@ -152,12 +153,37 @@ private:
 		}
 	};
 
+	// compressed entries of the pack being replaced, reused when a file did not change
+	struct PreviousPackFile {
+
+		uint64_t ofs;
+		uint64_t size;
+		uint8_t md5[16];
+	};
+
+	struct PendingPackFile {
+
+		SavedData sd;
+		Vector<uint8_t> data;
+		Vector<uint8_t> compressed;
+		const PreviousPackFile *previous;
+	};
+
 	struct PackData {
 
 		FileAccess *f;
 		Vector<SavedData> file_ofs;
+		bool compress;
 		EditorProgress *ep;
 		Vector<SharedObject> *so_files;
+
+		// files are hashed and compressed in parallel batches, then written in order
+		Vector<PendingPackFile> pending;
+		uint64_t pending_size;
+
+		FileAccess *previous_pack;
+		HashMap<String, PreviousPackFile> previous_files;
+		int reused_files;
 	};
 
 	struct ZipData {
@@ -176,6 +202,10 @@ private:
 
 	void gen_debug_flags(Vector<String> &r_flags, int p_flags);
 	static Error _save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total);
+	static void _prepare_pack_file(void *p_userdata, uint32_t p_index);
+	static bool _copy_previous_pack_file(PackData *p_pd, const PreviousPackFile &p_file);
+	static void _flush_pack_files(PackData *p_pd);
+	static void _load_previous_pack(const String &p_path, PackData *p_pd);
 	static Error _save_zip_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total);
 
 	void _edit_files_with_filter(DirAccess *da, const Vector<String> &p_filters, Set<String> &r_list, bool exclude);
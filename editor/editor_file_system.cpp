@@ -38,6 +38,7 @@
 #include "io/resource_saver.h"
 #include "os/file_access.h"
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
 #include "project_settings.h"
 #include "variant_parser.h"
 
@@ -202,6 +203,8 @@ void EditorFileSystem::_scan_filesystem() {
 	String fscache = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("filesystem_cache4");
 	FileAccess *f = FileAccess::open(fscache, FileAccess::READ);
 
+	uint64_t cached_import_dir_mtime = 0;
+
 	if (f) {
 		//read the disk cache
 		while (!f->eof_reached()) {
@@ -210,7 +213,9 @@ void EditorFileSystem::_scan_filesystem() {
 			if (l == String())
 				continue;
 
-			if (l.begins_with("::")) {
+			if (l.begins_with("#import_dir::")) {
+				cached_import_dir_mtime = l.get_slice("::", 1).to_int64();
+			} else if (l.begins_with("::")) {
 				Vector<String> split = l.split("::");
 				ERR_CONTINUE(split.size() != 3);
 				String name = split[1];
@@ -268,6 +273,9 @@ void EditorFileSystem::_scan_filesystem() {
 		d->remove(update_cache); //bye bye update cache
 	}
 
+	uint64_t import_dir_mtime = _get_import_dir_modified_time();
+	import_dir_unchanged = import_dir_mtime != 0 && import_dir_mtime == cached_import_dir_mtime;
+
 	EditorProgressBG scan_progress("efs", "ScanFS", 1000);
 
 	ScanProgress sp;
@@ -283,6 +291,7 @@ void EditorFileSystem::_scan_filesystem() {
 	_scan_new_dir(new_filesystem, d, sp);
 
 	file_cache.clear(); //clear caches, no longer needed
+	import_dir_unchanged = false;
 
 	memdelete(d);
 
@@ -290,6 +299,7 @@ void EditorFileSystem::_scan_filesystem() {
 	if (f == NULL) {
 		ERR_PRINTS("Error writing fscache: " + fscache);
 	} else {
+		f->store_line("#import_dir::" + itos(import_dir_mtime));
 		_save_filesystem_cache(new_filesystem, f);
 		f->close();
 		memdelete(f);
@@ -305,6 +315,7 @@ void EditorFileSystem::_save_filesystem_cache() {
 	if (f == NULL) {
 		ERR_PRINTS("Error writing fscache: " + fscache);
 	} else {
+		f->store_line("#import_dir::" + itos(_get_import_dir_modified_time()));
 		_save_filesystem_cache(filesystem, f);
 		f->close();
 		memdelete(f);
@@ -317,6 +328,15 @@ void EditorFileSystem::_thread_func(void *_userdata) {
 	sd->_scan_filesystem();
 }
 
+uint64_t EditorFileSystem::_get_import_dir_modified_time() const {
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	if (!da->dir_exists("res://.import"))
+		return 0;
+
+	return FileAccess::get_modified_time("res://.import");
+}
+
 bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_imported_files) {
 
 	if (!reimport_on_missing_imported_files && p_only_imported_files)
@@ -712,7 +732,8 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 				import_mt = FileAccess::get_modified_time(path + ".import");
 			}
 
-			if (fc && fc->modification_time == mt && fc->import_modification_time == import_mt && !_test_for_reimport(path, true)) {
+			//parsing the .import and .md5 files of every source is what makes large projects slow to open, skip it when nothing could have changed
+			if (fc && fc->modification_time == mt && fc->import_modification_time == import_mt && ((import_dir_unchanged && fc->import_valid) || !_test_for_reimport(path, true))) {
 
 				fi->type = fc->type;
 				fi->deps = fc->deps;
@@ -1449,12 +1470,12 @@ void EditorFileSystem::update_file(const String &p_file) {
 	_queue_update_script_classes();
 }
 
-void EditorFileSystem::_reimport_file(const String &p_file) {
+bool EditorFileSystem::_reimport_prepare(const String &p_file, ReimportData &r_data) {
 
 	EditorFileSystemDirectory *fs = NULL;
 	int cpos = -1;
 	bool found = _find_file(p_file, &fs, cpos);
-	ERR_FAIL_COND(!found);
+	ERR_FAIL_COND_V(!found, false);
 
 	//try to obtain existing params
 
@@ -1492,7 +1513,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		load_default = true;
 		if (importer.is_null()) {
 			ERR_PRINT("BUG: File queued for import, but can't be imported!");
-			ERR_FAIL();
+			ERR_FAIL_V(false);
 		}
 	}
 
@@ -1517,21 +1538,38 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 	}
 
-	//finally, perform import!!
-	String base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_file);
+	r_data.path = p_file;
+	r_data.fs = fs;
+	r_data.cpos = cpos;
+	r_data.importer = importer;
+	r_data.opts = opts;
+	r_data.params = params;
+	r_data.base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_file);
+	r_data.err = OK;
+
+	return true;
+}
 
-	List<String> import_variants;
-	List<String> gen_files;
+void EditorFileSystem::_reimport_finish(ReimportData &p_data) {
 
-	Error err = importer->import(p_file, base_path, params, &import_variants, &gen_files);
+	const String &file = p_data.path;
+	const String &base_path = p_data.base_path;
+	const Ref<ResourceImporter> &importer = p_data.importer;
+	const List<ResourceImporter::ImportOption> &opts = p_data.opts;
+	Map<StringName, Variant> &params = p_data.params;
+	List<String> &import_variants = p_data.import_variants;
+	List<String> &gen_files = p_data.gen_files;
+	EditorFileSystemDirectory *fs = p_data.fs;
+	int cpos = p_data.cpos;
+	Error err = p_data.err;
 
 	if (err != OK) {
-		ERR_PRINTS("Error importing: " + p_file);
+		ERR_PRINTS("Error importing: " + file);
 	}
 
 	//as import is complete, save the .import file
 
-	FileAccess *f = FileAccess::open(p_file + ".import", FileAccess::WRITE);
+	FileAccess *f = FileAccess::open(file + ".import", FileAccess::WRITE);
 	ERR_FAIL_COND(!f);
 
 	//write manually, as order matters ([remap] has to go first for performance).
@@ -1585,7 +1623,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		f->store_line("");
 	}
 
-	f->store_line("source_file=" + Variant(p_file).get_construct_string());
+	f->store_line("source_file=" + Variant(file).get_construct_string());
 
 	if (dest_paths.size()) {
 		Array dp;
@@ -1600,7 +1638,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 
 	//store options in provided order, to avoid file changing. Order is also important because first match is accepted first.
 
-	for (List<ResourceImporter::ImportOption>::Element *E = opts.front(); E; E = E->next()) {
+	for (const List<ResourceImporter::ImportOption>::Element *E = opts.front(); E; E = E->next()) {
 
 		String base = E->get().option.name;
 		String value;
@@ -1614,7 +1652,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	// Store the md5's of the various files. These are stored separately so that the .import files can be version controlled.
 	FileAccess *md5s = FileAccess::open(base_path + ".md5", FileAccess::WRITE);
 	ERR_FAIL_COND(!md5s);
-	md5s->store_line("source_md5=\"" + FileAccess::get_md5(p_file) + "\"");
+	md5s->store_line("source_md5=\"" + FileAccess::get_md5(file) + "\"");
 	if (dest_paths.size()) {
 		md5s->store_line("dest_md5=\"" + FileAccess::get_multiple_md5(dest_paths) + "\"\n");
 	}
@@ -1622,27 +1660,48 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	memdelete(md5s);
 
 	//update modified times, to avoid reimport
-	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
-	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
-	fs->files[cpos]->deps = _get_dependencies(p_file);
+	fs->files[cpos]->modified_time = FileAccess::get_modified_time(file);
+	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(file + ".import");
+	fs->files[cpos]->deps = _get_dependencies(file);
 	fs->files[cpos]->type = importer->get_resource_type();
-	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(p_file);
+	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(file);
 
 	//if file is currently up, maybe the source it was loaded from changed, so import math must be updated for it
 	//to reload properly
-	if (ResourceCache::has(p_file)) {
+	if (ResourceCache::has(file)) {
 
-		Resource *r = ResourceCache::get(p_file);
+		Resource *r = ResourceCache::get(file);
 
 		if (r->get_import_path() != String()) {
 
-			String dst_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(p_file);
+			String dst_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(file);
 			r->set_import_path(dst_path);
 			r->set_import_last_modified_time(0);
 		}
 	}
 
-	EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
+	EditorResourcePreview::get_singleton()->check_for_invalidation(file);
+}
+
+void EditorFileSystem::_reimport_thread(void *p_userdata, uint32_t p_index) {
+
+	ReimportThreadData *rd = (ReimportThreadData *)p_userdata;
+	ReimportData &data = rd->files[p_index];
+
+	data.err = data.importer->import(data.path, data.base_path, data.params, &data.import_variants, &data.gen_files);
+	atomic_increment(&rd->done);
+}
+
+void EditorFileSystem::_reimport_file(const String &p_file) {
+
+	ReimportData data;
+	if (!_reimport_prepare(p_file, data))
+		return;
+
+	//finally, perform import!!
+	data.err = data.importer->import(data.path, data.base_path, data.params, &data.import_variants, &data.gen_files);
+
+	_reimport_finish(data);
 }
 
 void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
@@ -1674,10 +1733,67 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	files.sort();
 
-	for (int i = 0; i < files.size(); i++) {
-		pr.step(files[i].path.get_file(), i);
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	bool use_threads = pool && pool->get_thread_count() > 0;
+
+	//files sharing an import order don't depend on each other (scenes are ordered after the textures they use),
+	//so within each order the ones whose importer allows it are imported in parallel
+	int step = 0;
+	int from = 0;
+	while (from < files.size()) {
+
+		int to = from + 1;
+		while (to < files.size() && files[to].order == files[from].order) {
+			to++;
+		}
+
+		Vector<ReimportData> threaded;
+
+		for (int i = from; i < to; i++) {
+
+			ReimportData data;
+			if (!_reimport_prepare(files[i].path, data)) {
+				pr.step(files[i].path.get_file(), step++);
+				continue;
+			}
+
+			if (use_threads && data.importer->can_import_threaded()) {
+				threaded.push_back(data);
+				continue;
+			}
+
+			pr.step(files[i].path.get_file(), step++);
+			data.err = data.importer->import(data.path, data.base_path, data.params, &data.import_variants, &data.gen_files);
+			_reimport_finish(data);
+		}
+
+		if (threaded.size()) {
+
+			ReimportThreadData rd;
+			rd.files = threaded.ptrw();
+			rd.done = 0;
+
+			WorkerThreadPool::GroupID group = pool->add_group_task(&EditorFileSystem::_reimport_thread, &rd, threaded.size());
+
+			uint32_t shown = 0;
+			pr.step(threaded[0].path.get_file(), step);
+			while (!pool->is_group_task_completed(group)) {
+				if (rd.done != shown) {
+					shown = rd.done;
+					pr.step(threaded[MIN(shown, (uint32_t)threaded.size() - 1)].path.get_file(), step + shown);
+				}
+				OS::get_singleton()->delay_usec(10000);
+			}
+			pool->wait_for_group_task_completion(group);
+			step += threaded.size();
+
+			//the rest touches the filesystem tree and resource cache, so it's done here, in order
+			for (int i = 0; i < threaded.size(); i++) {
+				_reimport_finish(threaded.write[i]);
+			}
+		}
 
-		_reimport_file(files[i].path);
+		from = to;
 	}
 
 	_save_filesystem_cache();
@@ -1729,6 +1845,7 @@ void EditorFileSystem::_update_extensions() {
 EditorFileSystem::EditorFileSystem() {
 
 	reimport_on_missing_imported_files = GLOBAL_DEF("editor/reimport_missing_imported_files", true);
+	import_dir_unchanged = false;
 
 	singleton = this;
 	filesystem = memnew(EditorFileSystemDirectory); //like, empty
@@ -31,6 +31,7 @@
 #ifndef EDITOR_FILE_SYSTEM_H
 #define EDITOR_FILE_SYSTEM_H
 
+#include "io/resource_import.h"
 #include "os/dir_access.h"
 #include "os/thread.h"
 #include "os/thread_safe.h"
@@ -167,6 +168,11 @@ class EditorFileSystem : public Node {
 
 	HashMap<String, FileCache> file_cache;
 
+	// res://.import only changes its modification time when imported files are added or removed,
+	// so while it matches the cached one the imported files of unchanged sources can't be missing
+	bool import_dir_unchanged;
+	uint64_t _get_import_dir_modified_time() const;
+
 	struct ScanProgress {
 
 		float low;
@@ -205,6 +211,27 @@ class EditorFileSystem : public Node {
 
 	void _update_extensions();
 
+	struct ReimportData {
+		String path;
+		EditorFileSystemDirectory *fs;
+		int cpos;
+		Ref<ResourceImporter> importer;
+		List<ResourceImporter::ImportOption> opts;
+		Map<StringName, Variant> params;
+		String base_path;
+		List<String> import_variants;
+		List<String> gen_files;
+		Error err;
+	};
+
+	struct ReimportThreadData {
+		ReimportData *files;
+		volatile uint32_t done;
+	};
+
+	bool _reimport_prepare(const String &p_file, ReimportData &r_data);
+	void _reimport_finish(ReimportData &p_data);
+	static void _reimport_thread(void *p_userdata, uint32_t p_index);
 	void _reimport_file(const String &p_file);
 
 	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
@@ -0,0 +1,282 @@
+/*************************************************************************/
+/*  editor_network_profiler.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "editor_network_profiler.h"
+
+#include "editor_scale.h"
+
+void EditorNetworkProfiler::_activate_pressed() {
+
+	if (activate->is_pressed()) {
+		activate->set_icon(get_icon("Stop", "EditorIcons"));
+		activate->set_text(TTR("Stop"));
+	} else {
+		activate->set_icon(get_icon("Play", "EditorIcons"));
+		activate->set_text(TTR("Start"));
+	}
+	emit_signal("enable_profiling", activate->is_pressed());
+}
+
+void EditorNetworkProfiler::_clear_pressed() {
+
+	clear();
+}
+
+void EditorNetworkProfiler::_notification(int p_what) {
+
+	if (p_what == NOTIFICATION_ENTER_TREE) {
+		activate->set_icon(get_icon("Play", "EditorIcons"));
+		clear_button->set_icon(get_icon("Clear", "EditorIcons"));
+	}
+
+	if (p_what == NOTIFICATION_PROCESS) {
+		// batch tree updates, profile data can arrive many times per second
+		if (dirty) {
+			_update_members();
+		}
+	}
+}
+
+String EditorNetworkProfiler::_format_bytes(int p_bytes) const {
+
+	if (p_bytes > 1048576) {
+		return String::num(p_bytes / 1048576.0, 2) + " MB";
+	} else if (p_bytes > 1024) {
+		return String::num(p_bytes / 1024.0, 2) + " KB";
+	}
+	return itos(p_bytes) + " B";
+}
+
+void EditorNetworkProfiler::_update_members() {
+
+	dirty = false;
+	members_tree->clear();
+
+	TreeItem *root = members_tree->create_item();
+
+	for (Map<String, MemberInfo>::Element *E = members.front(); E; E = E->next()) {
+
+		const MemberInfo &info = E->get();
+
+		TreeItem *item = members_tree->create_item(root);
+		item->set_text(0, info.node_path);
+		item->set_tooltip(0, info.node_path);
+		item->set_text(1, info.name);
+		item->set_text(2, itos(info.incoming_rpc));
+		item->set_text(3, itos(info.incoming_rset));
+		item->set_text(4, itos(info.outgoing_rpc));
+		item->set_text(5, itos(info.outgoing_rset));
+		item->set_text(6, _format_bytes(info.incoming_bytes));
+		item->set_text(7, _format_bytes(info.outgoing_bytes));
+	}
+}
+
+void EditorNetworkProfiler::add_profile_data(const Array &p_data) {
+
+	ERR_FAIL_COND(p_data.size() % 8);
+
+	for (int i = 0; i < p_data.size(); i += 8) {
+
+		String node_path = p_data[i + 0];
+		String name = p_data[i + 1];
+		String key = node_path + "::" + name;
+
+		Map<String, MemberInfo>::Element *E = members.find(key);
+		if (!E) {
+			MemberInfo info;
+			info.node_path = node_path;
+			info.name = name;
+			info.incoming_rpc = 0;
+			info.incoming_rset = 0;
+			info.outgoing_rpc = 0;
+			info.outgoing_rset = 0;
+			info.incoming_bytes = 0;
+			info.outgoing_bytes = 0;
+			E = members.insert(key, info);
+		}
+
+		MemberInfo &info = E->get();
+		info.incoming_rpc += int(p_data[i + 2]);
+		info.incoming_rset += int(p_data[i + 3]);
+		info.outgoing_rpc += int(p_data[i + 4]);
+		info.outgoing_rset += int(p_data[i + 5]);
+		info.incoming_bytes += int(p_data[i + 6]);
+		info.outgoing_bytes += int(p_data[i + 7]);
+	}
+
+	dirty = true;
+}
+
+void EditorNetworkProfiler::set_stats(int p_incoming_bandwidth, int p_outgoing_bandwidth, const Dictionary &p_peers) {
+
+	incoming_bandwidth_text->set_text(_format_bytes(p_incoming_bandwidth) + "/s");
+	outgoing_bandwidth_text->set_text(_format_bytes(p_outgoing_bandwidth) + "/s");
+
+	peers_tree->clear();
+	TreeItem *root = peers_tree->create_item();
+
+	Array ids = p_peers.keys();
+	for (int i = 0; i < ids.size(); i++) {
+
+		Dictionary stats = p_peers[ids[i]];
+
+		TreeItem *item = peers_tree->create_item(root);
+		item->set_text(0, itos(ids[i]));
+
+		if (stats.has("round_trip_time")) {
+			item->set_text(1, itos(Math::round(float(stats["round_trip_time"]) * 1000)) + " ms");
+		} else {
+			item->set_text(1, "-");
+		}
+		if (stats.has("packet_loss")) {
+			item->set_text(2, String::num(float(stats["packet_loss"]) * 100, 1) + " %");
+		} else {
+			item->set_text(2, "-");
+		}
+		if (stats.has("incoming_bytes")) {
+			item->set_text(3, _format_bytes(stats["incoming_bytes"]) + "/s");
+		} else {
+			item->set_text(3, "-");
+		}
+		if (stats.has("outgoing_bytes")) {
+			item->set_text(4, _format_bytes(stats["outgoing_bytes"]) + "/s");
+		} else {
+			item->set_text(4, "-");
+		}
+	}
+}
+
+void EditorNetworkProfiler::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("_activate_pressed"), &EditorNetworkProfiler::_activate_pressed);
+	ClassDB::bind_method(D_METHOD("_clear_pressed"), &EditorNetworkProfiler::_clear_pressed);
+
+	ADD_SIGNAL(MethodInfo("enable_profiling", PropertyInfo(Variant::BOOL, "enable")));
+}
+
+void EditorNetworkProfiler::set_enabled(bool p_enable) {
+
+	activate->set_disabled(!p_enable);
+}
+
+bool EditorNetworkProfiler::is_profiling() {
+
+	return activate->is_pressed();
+}
+
+void EditorNetworkProfiler::clear() {
+
+	members.clear();
+	members_tree->clear();
+	peers_tree->clear();
+	incoming_bandwidth_text->set_text("-");
+	outgoing_bandwidth_text->set_text("-");
+	dirty = false;
+}
+
+EditorNetworkProfiler::EditorNetworkProfiler() {
+
+	HBoxContainer *hb = memnew(HBoxContainer);
+	add_child(hb);
+
+	activate = memnew(Button);
+	activate->set_toggle_mode(true);
+	activate->set_text(TTR("Start"));
+	activate->connect("pressed", this, "_activate_pressed");
+	hb->add_child(activate);
+
+	clear_button = memnew(Button);
+	clear_button->set_text(TTR("Clear"));
+	clear_button->connect("pressed", this, "_clear_pressed");
+	hb->add_child(clear_button);
+
+	hb->add_spacer();
+
+	hb->add_child(memnew(Label(TTR("Down:"))));
+	incoming_bandwidth_text = memnew(Label);
+	incoming_bandwidth_text->set_text("-");
+	hb->add_child(incoming_bandwidth_text);
+
+	hb->add_child(memnew(Label(TTR("Up:"))));
+	outgoing_bandwidth_text = memnew(Label);
+	outgoing_bandwidth_text->set_text("-");
+	hb->add_child(outgoing_bandwidth_text);
+
+	hb->add_constant_override("separation", 8 * EDSCALE);
+
+	HSplitContainer *h_split = memnew(HSplitContainer);
+	add_child(h_split);
+	h_split->set_v_size_flags(SIZE_EXPAND_FILL);
+
+	members_tree = memnew(Tree);
+	members_tree->set_hide_folding(true);
+	members_tree->set_hide_root(true);
+	members_tree->set_h_size_flags(SIZE_EXPAND_FILL);
+	members_tree->set_columns(8);
+	members_tree->set_column_titles_visible(true);
+	members_tree->set_column_title(0, TTR("Node"));
+	members_tree->set_column_expand(0, true);
+	members_tree->set_column_min_width(0, 100 * EDSCALE);
+	members_tree->set_column_title(1, TTR("Member"));
+	members_tree->set_column_expand(1, true);
+	members_tree->set_column_min_width(1, 60 * EDSCALE);
+	members_tree->set_column_title(2, TTR("Incoming RPC"));
+	members_tree->set_column_title(3, TTR("Incoming RSET"));
+	members_tree->set_column_title(4, TTR("Outgoing RPC"));
+	members_tree->set_column_title(5, TTR("Outgoing RSET"));
+	members_tree->set_column_title(6, TTR("Incoming"));
+	members_tree->set_column_title(7, TTR("Outgoing"));
+	for (int i = 2; i < 8; i++) {
+		members_tree->set_column_expand(i, false);
+		members_tree->set_column_min_width(i, 90 * EDSCALE);
+	}
+	h_split->add_child(members_tree);
+
+	peers_tree = memnew(Tree);
+	peers_tree->set_hide_folding(true);
+	peers_tree->set_hide_root(true);
+	peers_tree->set_custom_minimum_size(Size2(300, 0) * EDSCALE);
+	peers_tree->set_columns(5);
+	peers_tree->set_column_titles_visible(true);
+	peers_tree->set_column_title(0, TTR("Peer"));
+	peers_tree->set_column_expand(0, true);
+	peers_tree->set_column_title(1, TTR("RTT"));
+	peers_tree->set_column_title(2, TTR("Loss"));
+	peers_tree->set_column_title(3, TTR("Incoming"));
+	peers_tree->set_column_title(4, TTR("Outgoing"));
+	for (int i = 1; i < 5; i++) {
+		peers_tree->set_column_expand(i, false);
+		peers_tree->set_column_min_width(i, 70 * EDSCALE);
+	}
+	h_split->add_child(peers_tree);
+
+	dirty = false;
+	set_process(true);
+}
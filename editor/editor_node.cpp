@@ -67,6 +67,7 @@
 #include "editor/import/resource_importer_obj.h"
 #include "editor/import/resource_importer_scene.h"
 #include "editor/import/resource_importer_texture.h"
+#include "editor/import/resource_importer_texture_atlas.h"
 #include "editor/import/resource_importer_wav.h"
 #include "editor/plugins/animation_blend_space_1d_editor.h"
 #include "editor/plugins/animation_blend_space_2d_editor.h"
@@ -1314,8 +1315,22 @@ void EditorNode::_dialog_action(String p_file) {
 	}
 }
 
+void EditorNode::_create_lazy_editor_plugins(Object *p_object) {
+
+	for (int i = 0; i < lazy_editor_plugins.size(); i++) {
+
+		if (!p_object->is_class(lazy_editor_plugins[i].edited_class))
+			continue;
+
+		add_editor_plugin(lazy_editor_plugins[i].create_func(this));
+		lazy_editor_plugins.remove(i);
+		i--;
+	}
+}
+
 bool EditorNode::item_has_editor(Object *p_object) {
 
+	_create_lazy_editor_plugins(p_object);
 	return editor_data.get_subeditors(p_object).size() > 0;
 }
 
@@ -1324,6 +1339,7 @@ void EditorNode::edit_item(Object *p_object) {
 	Vector<EditorPlugin *> sub_plugins;
 
 	if (p_object) {
+		_create_lazy_editor_plugins(p_object);
 		sub_plugins = editor_data.get_subeditors(p_object);
 	}
 
@@ -1499,6 +1515,8 @@ void EditorNode::_edit_current() {
 
 	if (!inspector_only) {
 
+		_create_lazy_editor_plugins(current_obj);
+
 		EditorPlugin *main_plugin = editor_data.get_editor(current_obj);
 
 		if (main_plugin) {
@@ -4718,6 +4736,10 @@ EditorNode::EditorNode() {
 		Ref<ResourceImporterBitMap> import_bitmap;
 		import_bitmap.instance();
 		ResourceFormatImporter::get_singleton()->add_importer(import_bitmap);
+
+		Ref<ResourceImporterTextureAtlas> import_texture_atlas;
+		import_texture_atlas.instance();
+		ResourceFormatImporter::get_singleton()->add_importer(import_texture_atlas);
 	}
 
 	{
@@ -5574,17 +5596,10 @@ EditorNode::EditorNode() {
 	add_editor_plugin(memnew(AnimationNodeBlendSpace2DEditorPlugin(this)));
 	add_editor_plugin(memnew(AnimationNodeStateMachineEditorPlugin(this)));
 
-	add_editor_plugin(memnew(CameraEditorPlugin(this)));
 	add_editor_plugin(memnew(ThemeEditorPlugin(this)));
-	add_editor_plugin(memnew(MultiMeshEditorPlugin(this)));
-	add_editor_plugin(memnew(MeshInstanceEditorPlugin(this)));
 	add_editor_plugin(memnew(AnimationTreeEditorPlugin(this)));
 	add_editor_plugin(memnew(MeshLibraryEditorPlugin(this)));
 	add_editor_plugin(memnew(StyleBoxEditorPlugin(this)));
-	add_editor_plugin(memnew(SpriteEditorPlugin(this)));
-	add_editor_plugin(memnew(Skeleton2DEditorPlugin(this)));
-	add_editor_plugin(memnew(ParticlesEditorPlugin(this)));
-	add_editor_plugin(memnew(CPUParticlesEditorPlugin(this)));
 	add_editor_plugin(memnew(ResourcePreloaderEditorPlugin(this)));
 	add_editor_plugin(memnew(ItemListEditorPlugin(this)));
 	add_editor_plugin(memnew(Polygon3DEditorPlugin(this)));
@@ -5593,26 +5608,34 @@ EditorNode::EditorNode() {
 	add_editor_plugin(memnew(TileMapEditorPlugin(this)));
 	add_editor_plugin(memnew(SpriteFramesEditorPlugin(this)));
 	add_editor_plugin(memnew(TextureRegionEditorPlugin(this)));
-	add_editor_plugin(memnew(Particles2DEditorPlugin(this)));
-	add_editor_plugin(memnew(GIProbeEditorPlugin(this)));
-	add_editor_plugin(memnew(BakedLightmapEditorPlugin(this)));
-	add_editor_plugin(memnew(Path2DEditorPlugin(this)));
 	add_editor_plugin(memnew(PathEditorPlugin(this)));
 	add_editor_plugin(memnew(Line2DEditorPlugin(this)));
 	add_editor_plugin(memnew(Polygon2DEditorPlugin(this)));
-	add_editor_plugin(memnew(LightOccluder2DEditorPlugin(this)));
 	add_editor_plugin(memnew(NavigationPolygonEditorPlugin(this)));
 	add_editor_plugin(memnew(GradientEditorPlugin(this)));
-	add_editor_plugin(memnew(CollisionShape2DEditorPlugin(this)));
 	add_editor_plugin(memnew(CurveEditorPlugin(this)));
 	add_editor_plugin(memnew(TextureEditorPlugin(this)));
 	add_editor_plugin(memnew(AudioStreamEditorPlugin(this)));
 	add_editor_plugin(memnew(AudioBusesEditorPlugin(audio_bus_editor)));
 	add_editor_plugin(memnew(AudioBusesEditorPlugin(audio_bus_editor)));
-	add_editor_plugin(memnew(SkeletonEditorPlugin(this)));
-	add_editor_plugin(memnew(SkeletonIKEditorPlugin(this)));
 	add_editor_plugin(memnew(PhysicalBonePlugin(this)));
 
+	_add_lazy_editor_plugin<CameraEditorPlugin>("Camera");
+	_add_lazy_editor_plugin<MultiMeshEditorPlugin>("MultiMeshInstance");
+	_add_lazy_editor_plugin<MeshInstanceEditorPlugin>("MeshInstance");
+	_add_lazy_editor_plugin<SpriteEditorPlugin>("Sprite");
+	_add_lazy_editor_plugin<Skeleton2DEditorPlugin>("Skeleton2D");
+	_add_lazy_editor_plugin<ParticlesEditorPlugin>("Particles");
+	_add_lazy_editor_plugin<CPUParticlesEditorPlugin>("CPUParticles");
+	_add_lazy_editor_plugin<Particles2DEditorPlugin>("Particles2D");
+	_add_lazy_editor_plugin<GIProbeEditorPlugin>("GIProbe");
+	_add_lazy_editor_plugin<BakedLightmapEditorPlugin>("BakedLightmap");
+	_add_lazy_editor_plugin<Path2DEditorPlugin>("Path2D");
+	_add_lazy_editor_plugin<LightOccluder2DEditorPlugin>("LightOccluder2D");
+	_add_lazy_editor_plugin<CollisionShape2DEditorPlugin>("CollisionShape2D");
+	_add_lazy_editor_plugin<SkeletonEditorPlugin>("Skeleton");
+	_add_lazy_editor_plugin<SkeletonIKEditorPlugin>("SkeletonIK");
+
 	// FIXME: Disabled as (according to reduz) users were complaining that it gets in the way
 	// Waiting for PropertyEditor rewrite (planned for 3.1) to be refactored.
 	//add_editor_plugin(memnew(MaterialEditorPlugin(this)));
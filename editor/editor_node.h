@@ -444,6 +444,29 @@ private:
 	void _set_top_editors(Vector<EditorPlugin *> p_editor_plugins_over);
 	void _set_editing_top_editors(Object *p_current_object);
 
+	// plugins that only act on one type of object are created the first time such an object is edited
+	struct LazyEditorPlugin {
+		StringName edited_class;
+		EditorPluginCreateFunc create_func;
+	};
+
+	Vector<LazyEditorPlugin> lazy_editor_plugins;
+
+	template <class T>
+	static EditorPlugin *_create_editor_plugin(EditorNode *p_editor) {
+		return memnew(T(p_editor));
+	}
+
+	template <class T>
+	void _add_lazy_editor_plugin(const StringName &p_edited_class) {
+		LazyEditorPlugin lep;
+		lep.edited_class = p_edited_class;
+		lep.create_func = _create_editor_plugin<T>;
+		lazy_editor_plugins.push_back(lep);
+	}
+
+	void _create_lazy_editor_plugins(Object *p_object);
+
 	void _quick_opened();
 	void _quick_run();
 
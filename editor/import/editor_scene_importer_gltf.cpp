@@ -60,13 +60,11 @@ Error EditorSceneImporterGLTF::_parse_json(const String &p_path, GLTFState &stat
 	Vector<uint8_t> array;
 	array.resize(f->get_len());
 	f->get_buffer(array.ptrw(), array.size());
-	String text;
-	text.parse_utf8((const char *)array.ptr(), array.size());
 
 	String err_txt;
 	int err_line;
 	Variant v;
-	err = JSON::parse(text, v, err_txt, err_line);
+	err = JSON::parse_utf8(array.ptr(), array.size(), v, err_txt, err_line);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), err_line, err_txt.utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -98,13 +96,10 @@ Error EditorSceneImporterGLTF::_parse_glb(const String &p_path, GLTFState &state
 	uint32_t len = f->get_buffer(json_data.ptrw(), chunk_length);
 	ERR_FAIL_COND_V(len != chunk_length, ERR_FILE_CORRUPT);
 
-	String text;
-	text.parse_utf8((const char *)json_data.ptr(), json_data.size());
-
 	String err_txt;
 	int err_line;
 	Variant v;
-	err = JSON::parse(text, v, err_txt, err_line);
+	err = JSON::parse_utf8(json_data.ptr(), json_data.size(), v, err_txt, err_line);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), err_line, err_txt.utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -1068,7 +1063,7 @@ Error EditorSceneImporterGLTF::_parse_meshes(GLTFState &state) {
 			}
 
 			//just add it
-			mesh.mesh->add_surface_from_arrays(primitive, array, morphs);
+			mesh.mesh->add_surface_from_arrays(primitive, array, morphs, state.mesh_compression_flags);
 
 			if (p.has("material")) {
 				int material = p["material"];
@@ -2104,6 +2099,7 @@ Spatial *EditorSceneImporterGLTF::_generate_scene(GLTFState &state, int p_bake_f
 Node *EditorSceneImporterGLTF::import_scene(const String &p_path, uint32_t p_flags, int p_bake_fps, List<String> *r_missing_deps, Error *r_err) {
 
 	GLTFState state;
+	state.mesh_compression_flags = get_mesh_compression_flags(p_flags);
 
 	if (p_path.to_lower().ends_with("glb")) {
 		//binary file
@@ -276,8 +276,14 @@ class EditorSceneImporterGLTF : public EditorSceneImporter {
 
 		Map<int, Vector<int> > skeleton_nodes;
 
+		uint32_t mesh_compression_flags;
+
 		//Map<int, Vector<int> > skin_users; //cache skin users
 
+		GLTFState() {
+			mesh_compression_flags = 0;
+		}
+
 		~GLTFState() {
 			for (int i = 0; i < nodes.size(); i++) {
 				memdelete(nodes[i]);
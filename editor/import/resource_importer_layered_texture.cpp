@@ -227,6 +227,12 @@ Error ResourceImporterLayeredTexture::import(const String &p_source_file, const
 
 		bool ok_on_pc = false;
 
+		if (ProjectSettings::get_singleton()->get("rendering/vram_compression/import_bptc")) {
+
+			_save_tex(slices, p_save_path + ".bptc." + extension, compress_mode, Image::COMPRESS_BPTC, mipmaps, tex_flags);
+			r_platform_variants->push_back("bptc");
+		}
+
 		if (ProjectSettings::get_singleton()->get("rendering/vram_compression/import_s3tc")) {
 
 			_save_tex(slices, p_save_path + ".s3tc." + extension, compress_mode, Image::COMPRESS_S3TC, mipmaps, tex_flags);
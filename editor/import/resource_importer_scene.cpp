@@ -31,7 +31,10 @@
 #include "resource_importer_scene.h"
 
 #include "editor/editor_node.h"
+#include "editor/editor_settings.h"
 #include "io/resource_saver.h"
+#include "os/file_access.h"
+#include "os/worker_thread_pool.h"
 #include "scene/resources/packed_scene.h"
 
 #include "scene/3d/collision_shape.h"
@@ -48,6 +51,18 @@
 #include "scene/resources/ray_shape.h"
 #include "scene/resources/scene_format_text.h"
 #include "scene/resources/sphere_shape.h"
+#include "scene/resources/surface_tool.h"
+#include "thirdparty/misc/md5.h"
+
+uint32_t EditorSceneImporter::get_mesh_compression_flags(uint32_t p_import_flags) {
+
+	if (!(p_import_flags & IMPORT_USE_COMPRESSION)) {
+		return 0;
+	}
+
+	//imported geometry is static, so positions and lightmap UVs can be quantized as well
+	return Mesh::ARRAY_COMPRESS_DEFAULT | Mesh::ARRAY_COMPRESS_VERTEX | Mesh::ARRAY_FLAG_USE_QUANTIZED_VERTICES | Mesh::ARRAY_FLAG_USE_16_BIT_TEX_UV2;
+}
 
 uint32_t EditorSceneImporter::get_import_flags() const {
 
@@ -211,6 +226,10 @@ bool ResourceImporterScene::get_option_visibility(const String &p_option, const
 		return false;
 	}
 
+	if (p_option == "meshes/lod_distance" && int(p_options["meshes/lod_count"]) == 0) {
+		return false;
+	}
+
 	if (p_option == "meshes/lightmap_texel_size" && int(p_options["meshes/light_baking"]) < 2) {
 		return false;
 	}
@@ -863,6 +882,24 @@ void ResourceImporterScene::_optimize_animations(Node *scene, float p_max_lin_er
 	}
 }
 
+void ResourceImporterScene::_compress_animations(Node *scene) {
+
+	if (!scene->has_node(String("AnimationPlayer")))
+		return;
+	Node *n = scene->get_node(String("AnimationPlayer"));
+	ERR_FAIL_COND(!n);
+	AnimationPlayer *anim = Object::cast_to<AnimationPlayer>(n);
+	ERR_FAIL_COND(!anim);
+
+	List<StringName> anim_names;
+	anim->get_animation_list(&anim_names);
+	for (List<StringName>::Element *E = anim_names.front(); E; E = E->next()) {
+
+		Ref<Animation> a = anim->get_animation(E->get());
+		a->compress();
+	}
+}
+
 static String _make_extname(const String &p_str) {
 
 	String ext_name = p_str.replace(".", "_");
@@ -909,6 +946,498 @@ void ResourceImporterScene::_find_meshes(Node *p_node, Map<Ref<ArrayMesh>, Trans
 	}
 }
 
+struct _OptimizeSurface {
+
+	Ref<ArrayMesh> mesh;
+	Mesh::PrimitiveType primitive;
+	Array arrays;
+	Array blend_shapes;
+	uint32_t flags;
+	Ref<Material> material;
+	String name;
+	bool optimize;
+};
+
+static void _optimize_surface_task(void *p_userdata, uint32_t p_index) {
+
+	_OptimizeSurface &surface = ((_OptimizeSurface *)p_userdata)[p_index];
+	surface.arrays = SurfaceTool::optimize_triangle_arrays(surface.arrays, &surface.blend_shapes);
+}
+
+void ResourceImporterScene::_optimize_meshes(const Map<Ref<ArrayMesh>, Transform> &p_meshes) {
+
+	Vector<_OptimizeSurface> surfaces;
+	Vector<uint32_t> to_optimize;
+
+	for (const Map<Ref<ArrayMesh>, Transform>::Element *E = p_meshes.front(); E; E = E->next()) {
+
+		Ref<ArrayMesh> mesh = E->key();
+
+		for (int i = 0; i < mesh->get_surface_count(); i++) {
+
+			_OptimizeSurface surface;
+			surface.mesh = mesh;
+			surface.primitive = mesh->surface_get_primitive_type(i);
+			surface.arrays = mesh->surface_get_arrays(i);
+			surface.blend_shapes = mesh->surface_get_blend_shape_arrays(i);
+			//keep compression and the other flags, the array format is taken from the arrays again
+			surface.flags = mesh->surface_get_format(i) & ~((1 << Mesh::ARRAY_COMPRESS_BASE) - 1);
+			surface.material = mesh->surface_get_material(i);
+			surface.name = mesh->surface_get_name(i);
+			surface.optimize = surface.primitive == Mesh::PRIMITIVE_TRIANGLES && mesh->surface_get_array_index_len(i) > 0;
+
+			if (surface.optimize) {
+				to_optimize.push_back(surfaces.size());
+			}
+			surfaces.push_back(surface);
+		}
+	}
+
+	if (to_optimize.empty()) {
+		return;
+	}
+
+	//surfaces are independent from each other, so optimize them all at the same time
+	Vector<_OptimizeSurface> work;
+	work.resize(to_optimize.size());
+	for (int i = 0; i < to_optimize.size(); i++) {
+		work.write[i] = surfaces[to_optimize[i]];
+	}
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_group_task(_optimize_surface_task, work.ptrw(), work.size(), WorkerThreadPool::PRIORITY_HIGH);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	for (int i = 0; i < to_optimize.size(); i++) {
+		surfaces.write[to_optimize[i]] = work[i];
+	}
+
+	//rebuilding the surfaces touches the visual server, do it from here
+	Ref<ArrayMesh> current;
+	for (int i = 0; i < surfaces.size(); i++) {
+
+		const _OptimizeSurface &surface = surfaces[i];
+		Ref<ArrayMesh> mesh = surface.mesh;
+
+		if (mesh != current) {
+			while (mesh->get_surface_count()) {
+				mesh->surface_remove(0);
+			}
+			current = mesh;
+		}
+
+		mesh->add_surface_from_arrays(surface.primitive, surface.arrays, surface.blend_shapes, surface.flags);
+		int idx = mesh->get_surface_count() - 1;
+		mesh->surface_set_material(idx, surface.material);
+		mesh->surface_set_name(idx, surface.name);
+	}
+}
+
+struct _LightmapUnwrapJob {
+
+	Ref<ArrayMesh> mesh;
+	ArrayMesh::LightmapUnwrap unwrap;
+	String hash;
+	Error err;
+};
+
+struct _LightmapUnwrapThreadData {
+
+	_LightmapUnwrapJob *jobs;
+	const uint32_t *to_unwrap;
+	volatile uint32_t done;
+};
+
+static void _lightmap_unwrap_task(void *p_userdata, uint32_t p_index) {
+
+	_LightmapUnwrapThreadData *td = (_LightmapUnwrapThreadData *)p_userdata;
+	_LightmapUnwrapJob &job = td->jobs[td->to_unwrap[p_index]];
+
+	job.err = ArrayMesh::lightmap_unwrap_generate(job.unwrap);
+	atomic_increment(&td->done);
+}
+
+static String _get_lightmap_unwrap_hash(const ArrayMesh::LightmapUnwrap &p_unwrap) {
+
+	MD5_CTX md5;
+	MD5Init(&md5);
+
+	float texel_size = p_unwrap.texel_size;
+	MD5Update(&md5, (unsigned char *)&texel_size, sizeof(float));
+	MD5Update(&md5, (unsigned char *)p_unwrap.vertices.ptr(), p_unwrap.vertices.size() * sizeof(float));
+	MD5Update(&md5, (unsigned char *)p_unwrap.normals.ptr(), p_unwrap.normals.size() * sizeof(float));
+	MD5Update(&md5, (unsigned char *)p_unwrap.indices.ptr(), p_unwrap.indices.size() * sizeof(int));
+	MD5Update(&md5, (unsigned char *)p_unwrap.face_materials.ptr(), p_unwrap.face_materials.size() * sizeof(int));
+	MD5Final(&md5);
+
+	return String::md5(md5.digest);
+}
+
+#define LIGHTMAP_CACHE_VERSION 1
+
+void ResourceImporterScene::_load_lightmap_cache() {
+
+	if (lightmap_cache_loaded) {
+		return;
+	}
+	lightmap_cache_loaded = true;
+
+	String path = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("lightmap_unwrap_cache");
+	FileAccess *f = FileAccess::open(path, FileAccess::READ);
+	if (!f) {
+		return;
+	}
+
+	uint8_t header[4];
+	f->get_buffer(header, 4);
+	if (header[0] != 'L' || header[1] != 'M' || header[2] != 'U' || header[3] != 'C' || f->get_32() != LIGHTMAP_CACHE_VERSION) {
+		memdelete(f);
+		return;
+	}
+
+	uint32_t count = f->get_32();
+	for (uint32_t i = 0; i < count && !f->eof_reached(); i++) {
+
+		String hash = f->get_pascal_string();
+
+		LightmapCacheEntry entry;
+		entry.size_hint.x = f->get_float();
+		entry.size_hint.y = f->get_float();
+
+		uint32_t uv_count = f->get_32();
+		uint32_t vertex_count = f->get_32();
+		uint32_t index_count = f->get_32();
+
+		uint64_t needed = (uint64_t(uv_count) + vertex_count + index_count) * 4;
+		if (f->eof_reached() || f->get_position() + needed > f->get_len()) {
+			break; //truncated, keep what was read so far
+		}
+
+		entry.uvs.resize(uv_count);
+		entry.gen_vertices.resize(vertex_count);
+		entry.gen_indices.resize(index_count);
+		f->get_buffer((uint8_t *)entry.uvs.ptrw(), uv_count * sizeof(float));
+		f->get_buffer((uint8_t *)entry.gen_vertices.ptrw(), vertex_count * sizeof(int));
+		f->get_buffer((uint8_t *)entry.gen_indices.ptrw(), index_count * sizeof(int));
+
+		lightmap_cache[hash] = entry;
+	}
+
+	memdelete(f);
+}
+
+void ResourceImporterScene::_save_lightmap_cache() {
+
+	String path = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("lightmap_unwrap_cache");
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	f->store_buffer((const uint8_t *)"LMUC", 4);
+	f->store_32(LIGHTMAP_CACHE_VERSION);
+	f->store_32(lightmap_cache.size());
+
+	const String *K = NULL;
+	while ((K = lightmap_cache.next(K))) {
+
+		const LightmapCacheEntry &entry = lightmap_cache[*K];
+
+		f->store_pascal_string(*K);
+		f->store_float(entry.size_hint.x);
+		f->store_float(entry.size_hint.y);
+		f->store_32(entry.uvs.size());
+		f->store_32(entry.gen_vertices.size());
+		f->store_32(entry.gen_indices.size());
+		f->store_buffer((const uint8_t *)entry.uvs.ptr(), entry.uvs.size() * sizeof(float));
+		f->store_buffer((const uint8_t *)entry.gen_vertices.ptr(), entry.gen_vertices.size() * sizeof(int));
+		f->store_buffer((const uint8_t *)entry.gen_indices.ptr(), entry.gen_indices.size() * sizeof(int));
+	}
+
+	memdelete(f);
+}
+
+void ResourceImporterScene::_generate_lightmap_uv2(const Map<Ref<ArrayMesh>, Transform> &p_meshes, float p_texel_size) {
+
+	_load_lightmap_cache();
+
+	EditorProgress progress("gen_lightmaps", TTR("Generating Lightmaps"), p_meshes.size());
+
+	Vector<_LightmapUnwrapJob> jobs;
+	Vector<uint32_t> to_unwrap;
+
+	for (const Map<Ref<ArrayMesh>, Transform>::Element *E = p_meshes.front(); E; E = E->next()) {
+
+		_LightmapUnwrapJob job;
+		job.mesh = E->key();
+		job.err = job.mesh->lightmap_unwrap_prepare(E->get(), p_texel_size, job.unwrap);
+
+		if (job.err == OK) {
+			job.hash = _get_lightmap_unwrap_hash(job.unwrap);
+
+			const LightmapCacheEntry *cached = lightmap_cache.getptr(job.hash);
+			if (cached) {
+				job.unwrap.uvs = cached->uvs;
+				job.unwrap.gen_vertices = cached->gen_vertices;
+				job.unwrap.gen_indices = cached->gen_indices;
+				job.unwrap.size_hint = cached->size_hint;
+			} else {
+				to_unwrap.push_back(jobs.size());
+			}
+		}
+
+		jobs.push_back(job);
+	}
+
+	//unwrapping only reads the gathered arrays, so every mesh goes to the pool at once
+	if (to_unwrap.size()) {
+
+		_LightmapUnwrapThreadData td;
+		td.jobs = jobs.ptrw();
+		td.to_unwrap = to_unwrap.ptr();
+		td.done = 0;
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		WorkerThreadPool::GroupID group = pool->add_group_task(_lightmap_unwrap_task, &td, to_unwrap.size(), WorkerThreadPool::PRIORITY_HIGH);
+
+		int cached = jobs.size() - to_unwrap.size();
+		uint32_t shown = 0;
+		progress.step(TTR("Unwrapping Meshes..."), cached);
+		if (pool->get_thread_count() > 0) {
+			while (!pool->is_group_task_completed(group)) {
+				if (td.done != shown) {
+					shown = td.done;
+					progress.step(TTR("Unwrapping Meshes...") + " (" + itos(shown) + "/" + itos(to_unwrap.size()) + ")", cached + shown);
+				}
+				OS::get_singleton()->delay_usec(10000);
+			}
+		}
+		pool->wait_for_group_task_completion(group);
+	}
+
+	//rebuilding the surfaces touches the visual server, do it from here
+	bool cache_changed = false;
+	for (int i = 0; i < jobs.size(); i++) {
+
+		_LightmapUnwrapJob &job = jobs.write[i];
+
+		String name = job.mesh->get_name();
+		if (name == "") { //should not happen but..
+			name = "Mesh " + itos(i);
+		}
+
+		progress.step(TTR("Generating for Mesh: ") + name + " (" + itos(i) + "/" + itos(jobs.size()) + ")", i);
+
+		if (job.err == OK) {
+			job.err = job.mesh->lightmap_unwrap_apply(job.unwrap);
+		}
+
+		if (job.err != OK) {
+			if (lightmap_cache.erase(job.hash)) {
+				cache_changed = true; //stale or broken entry
+			}
+			EditorNode::add_io_error("Mesh '" + name + "' failed lightmap generation. Please fix geometry.");
+			continue;
+		}
+
+		if (!lightmap_cache.has(job.hash)) {
+			LightmapCacheEntry entry;
+			entry.uvs = job.unwrap.uvs;
+			entry.gen_vertices = job.unwrap.gen_vertices;
+			entry.gen_indices = job.unwrap.gen_indices;
+			entry.size_hint = job.unwrap.size_hint;
+			lightmap_cache[job.hash] = entry;
+			cache_changed = true;
+		}
+	}
+
+	if (cache_changed) {
+		_save_lightmap_cache();
+	}
+}
+
+struct _LODSurface {
+
+	Array arrays;
+	float ratio;
+	float max_error;
+	Array result;
+	int result_index_count;
+};
+
+static void _lod_surface_task(void *p_userdata, uint32_t p_index) {
+
+	_LODSurface &surface = ((_LODSurface *)p_userdata)[p_index];
+
+	PoolVector<int> indices = surface.arrays[Mesh::ARRAY_INDEX];
+	PoolVector<Vector3> vertices = surface.arrays[Mesh::ARRAY_VERTEX];
+
+	int target = int(indices.size() / 3 * surface.ratio) * 3;
+	PoolVector<int> simplified = SurfaceTool::simplify_indices(indices, vertices, target, surface.max_error);
+
+	Array arrays = surface.arrays;
+	arrays[Mesh::ARRAY_INDEX] = simplified;
+
+	//drops the vertices no longer referenced
+	surface.result = SurfaceTool::optimize_triangle_arrays(arrays);
+	surface.result_index_count = simplified.size();
+}
+
+static void _find_lod_mesh_instances(Node *p_node, List<MeshInstance *> &r_instances) {
+
+	MeshInstance *mi = Object::cast_to<MeshInstance>(p_node);
+	if (mi) {
+		Ref<ArrayMesh> mesh = mi->get_mesh();
+		//blend shapes are animated by node path, which the LOD instances would not follow
+		if (mesh.is_valid() && mesh->get_blend_shape_count() == 0 && mi->get_lod_max_distance() <= 0) {
+			r_instances.push_back(mi);
+		}
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_find_lod_mesh_instances(p_node->get_child(i), r_instances);
+	}
+}
+
+void ResourceImporterScene::_generate_lods(Node *p_scene, int p_lod_count, float p_lod_distance) {
+
+	List<MeshInstance *> instances;
+	_find_lod_mesh_instances(p_scene, instances);
+
+	if (instances.empty()) {
+		return;
+	}
+
+	// simplify every triangle surface of every mesh for all levels at once,
+	// each level halves the triangles of the original and may deviate twice as much as the previous one
+
+	Map<Ref<ArrayMesh>, int> mesh_jobs; //first job of each mesh
+	Vector<_LODSurface> jobs;
+
+	for (List<MeshInstance *>::Element *E = instances.front(); E; E = E->next()) {
+
+		Ref<ArrayMesh> mesh = E->get()->get_mesh();
+		if (mesh_jobs.has(mesh)) {
+			continue;
+		}
+
+		bool valid = mesh->get_surface_count() > 0;
+		for (int i = 0; i < mesh->get_surface_count(); i++) {
+			if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES || mesh->surface_get_array_index_len(i) <= 0) {
+				valid = false;
+			}
+		}
+
+		if (!valid) {
+			mesh_jobs[mesh] = -1;
+			continue;
+		}
+
+		mesh_jobs[mesh] = jobs.size();
+
+		for (int l = 1; l <= p_lod_count; l++) {
+			for (int i = 0; i < mesh->get_surface_count(); i++) {
+
+				_LODSurface job;
+				job.arrays = mesh->surface_get_arrays(i);
+				job.ratio = Math::pow(0.5, (double)l);
+				job.max_error = 0.01 * (1 << (l - 1));
+				job.result_index_count = 0;
+				jobs.push_back(job);
+			}
+		}
+	}
+
+	if (jobs.empty()) {
+		return;
+	}
+
+	EditorProgress progress("gen_lods", TTR("Generating LODs"), 1);
+	progress.step(TTR("Simplifying Meshes..."), 0);
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_group_task(_lod_surface_task, jobs.ptrw(), jobs.size(), WorkerThreadPool::PRIORITY_HIGH);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	//build the meshes, levels that don't remove enough are skipped together with the ones after them
+	Map<Ref<ArrayMesh>, Vector<Ref<ArrayMesh> > > lod_meshes;
+
+	for (Map<Ref<ArrayMesh>, int>::Element *E = mesh_jobs.front(); E; E = E->next()) {
+
+		Ref<ArrayMesh> mesh = E->key();
+		Vector<Ref<ArrayMesh> > &lods = lod_meshes[mesh];
+
+		if (E->get() < 0) {
+			continue;
+		}
+
+		int surface_count = mesh->get_surface_count();
+		int prev_index_count = 0;
+		for (int i = 0; i < surface_count; i++) {
+			prev_index_count += mesh->surface_get_array_index_len(i);
+		}
+
+		for (int l = 0; l < p_lod_count; l++) {
+
+			const _LODSurface *level = &jobs[E->get() + l * surface_count];
+
+			int index_count = 0;
+			for (int i = 0; i < surface_count; i++) {
+				index_count += level[i].result_index_count;
+			}
+
+			if (index_count == 0 || index_count > prev_index_count * 0.9) {
+				break;
+			}
+			prev_index_count = index_count;
+
+			Ref<ArrayMesh> lod;
+			lod.instance();
+			lod->set_name(mesh->get_name() + "_lod" + itos(l + 1));
+			for (int i = 0; i < surface_count; i++) {
+				uint32_t flags = mesh->surface_get_format(i) & ~((1 << Mesh::ARRAY_COMPRESS_BASE) - 1);
+				lod->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, level[i].result, Array(), flags);
+				lod->surface_set_material(i, mesh->surface_get_material(i));
+				lod->surface_set_name(i, mesh->surface_get_name(i));
+			}
+			lods.push_back(lod);
+		}
+	}
+
+	//each level is a sibling instance drawn in its own distance range, doubling every level
+	for (List<MeshInstance *>::Element *E = instances.front(); E; E = E->next()) {
+
+		MeshInstance *mi = E->get();
+		const Vector<Ref<ArrayMesh> > &lods = lod_meshes[mi->get_mesh()];
+		if (lods.empty() || !mi->get_parent()) {
+			continue;
+		}
+
+		mi->set_lod_max_distance(p_lod_distance);
+
+		float begin = p_lod_distance;
+		Node *prev = mi;
+		for (int i = 0; i < lods.size(); i++) {
+
+			MeshInstance *lod_mi = memnew(MeshInstance);
+			lod_mi->set_name(String(mi->get_name()) + "_lod" + itos(i + 1));
+			lod_mi->set_mesh(lods[i]);
+			lod_mi->set_transform(mi->get_transform());
+			lod_mi->set_skeleton_path(mi->get_skeleton_path());
+			lod_mi->set_layer_mask(mi->get_layer_mask());
+			lod_mi->set_cast_shadows_setting(mi->get_cast_shadows_setting());
+			lod_mi->set_material_override(mi->get_material_override());
+			for (int j = 0; j < lods[i]->get_surface_count(); j++) {
+				lod_mi->set_surface_material(j, mi->get_surface_material(j));
+			}
+
+			lod_mi->set_lod_min_distance(begin);
+			begin *= 2.0;
+			lod_mi->set_lod_max_distance(i == lods.size() - 1 ? 0 : begin);
+
+			mi->get_parent()->add_child_below_node(prev, lod_mi);
+			lod_mi->set_owner(p_scene);
+			prev = lod_mi;
+		}
+	}
+}
+
 void ResourceImporterScene::_make_external_resources(Node *p_node, const String &p_base_path, bool p_make_animations, bool p_keep_animations, bool p_make_materials, bool p_keep_materials, bool p_make_meshes, Map<Ref<Animation>, Ref<Animation> > &p_animations, Map<Ref<Material>, Ref<Material> > &p_materials, Map<Ref<ArrayMesh>, Ref<ArrayMesh> > &p_meshes) {
 
 	List<PropertyInfo> pi;
@@ -1088,6 +1617,9 @@ void ResourceImporterScene::get_import_options(List<ImportOption> *r_options, in
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "materials/keep_on_reimport"), materials_out ? true : false));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/compress"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/ensure_tangents"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/optimize"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/lod_count", PROPERTY_HINT_RANGE, "0,8,1", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "meshes/lod_distance", PROPERTY_HINT_RANGE, "0.01,4096,0.01"), 20.0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/storage", PROPERTY_HINT_ENUM, "Built-In,Files"), meshes_out ? 1 : 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/light_baking", PROPERTY_HINT_ENUM, "Disabled,Enable,Gen Lightmaps", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "meshes/lightmap_texel_size", PROPERTY_HINT_RANGE, "0.001,100,0.001"), 0.1));
@@ -1102,6 +1634,7 @@ void ResourceImporterScene::get_import_options(List<ImportOption> *r_options, in
 	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "animation/optimizer/max_angular_error"), 0.01));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "animation/optimizer/max_angle"), 22));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "animation/optimizer/remove_unused_tracks"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "animation/compression/enabled"), false));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "animation/clips/amount", PROPERTY_HINT_RANGE, "0,256,1", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
 	for (int i = 0; i < 256; i++) {
 		r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "animation/clip_" + itos(i + 1) + "/name"), ""));
@@ -1303,6 +1836,10 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 		_filter_tracks(scene, animation_filter);
 	}
 
+	if (bool(p_options["animation/compression/enabled"])) {
+		_compress_animations(scene);
+	}
+
 	bool external_animations = int(p_options["animation/storage"]) == 1;
 	bool keep_custom_tracks = p_options["animation/keep_custom_tracks"];
 	bool external_materials = p_options["materials/storage"];
@@ -1334,25 +1871,23 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 			float texel_size = p_options["meshes/lightmap_texel_size"];
 			texel_size = MAX(0.001, texel_size);
 
-			EditorProgress progress("gen_lightmaps", TTR("Generating Lightmaps"), meshes.size());
-			int step = 0;
-			for (Map<Ref<ArrayMesh>, Transform>::Element *E = meshes.front(); E; E = E->next()) {
+			_generate_lightmap_uv2(meshes, texel_size);
+		}
+	}
 
-				Ref<ArrayMesh> mesh = E->key();
-				String name = mesh->get_name();
-				if (name == "") { //should not happen but..
-					name = "Mesh " + itos(step);
-				}
+	if (bool(p_options["meshes/optimize"])) {
+
+		Map<Ref<ArrayMesh>, Transform> meshes;
+		_find_meshes(scene, meshes);
 
-				progress.step(TTR("Generating for Mesh: ") + name + " (" + itos(step) + "/" + itos(meshes.size()) + ")", step);
+		_optimize_meshes(meshes);
+	}
 
-				Error err = mesh->lightmap_unwrap(E->get(), texel_size);
-				if (err != OK) {
-					EditorNode::add_io_error("Mesh '" + name + "' failed lightmap generation. Please fix geometry.");
-				}
-				step++;
-			}
-		}
+	int lod_count = p_options["meshes/lod_count"];
+	if (lod_count > 0) {
+
+		float lod_distance = p_options["meshes/lod_distance"];
+		_generate_lods(scene, lod_count, MAX(0.01, lod_distance));
 	}
 
 	if (external_animations || external_materials || external_meshes) {
@@ -1437,6 +1972,7 @@ ResourceImporterScene *ResourceImporterScene::singleton = NULL;
 
 ResourceImporterScene::ResourceImporterScene() {
 	singleton = this;
+	lightmap_cache_loaded = false;
 }
 ///////////////////////////////////////
 
@@ -63,6 +63,8 @@ public:
 
 	};
 
+	static uint32_t get_mesh_compression_flags(uint32_t p_import_flags);
+
 	virtual uint32_t get_import_flags() const;
 	virtual void get_extensions(List<String> *r_extensions) const;
 	virtual Node *import_scene(const String &p_path, uint32_t p_flags, int p_bake_fps, List<String> *r_missing_deps, Error *r_err = NULL);
@@ -121,6 +123,20 @@ class ResourceImporterScene : public ResourceImporter {
 
 	void _replace_owner(Node *p_node, Node *p_scene, Node *p_new_owner);
 
+	//unwrap results by input hash, so meshes that did not change are not unwrapped again on reimport
+	struct LightmapCacheEntry {
+		Vector<float> uvs;
+		Vector<int> gen_vertices;
+		Vector<int> gen_indices;
+		Size2 size_hint;
+	};
+
+	HashMap<String, LightmapCacheEntry> lightmap_cache;
+	bool lightmap_cache_loaded;
+
+	void _load_lightmap_cache();
+	void _save_lightmap_cache();
+
 public:
 	static ResourceImporterScene *get_singleton() { return singleton; }
 
@@ -143,6 +159,9 @@ public:
 	virtual int get_import_order() const { return 100; } //after everything
 
 	void _find_meshes(Node *p_node, Map<Ref<ArrayMesh>, Transform> &meshes);
+	void _optimize_meshes(const Map<Ref<ArrayMesh>, Transform> &p_meshes);
+	void _generate_lightmap_uv2(const Map<Ref<ArrayMesh>, Transform> &p_meshes, float p_texel_size);
+	void _generate_lods(Node *p_scene, int p_lod_count, float p_lod_distance);
 
 	void _make_external_resources(Node *p_node, const String &p_base_path, bool p_make_animations, bool p_keep_animations, bool p_make_materials, bool p_keep_materials, bool p_make_meshes, Map<Ref<Animation>, Ref<Animation> > &p_animations, Map<Ref<Material>, Ref<Material> > &p_materials, Map<Ref<ArrayMesh>, Ref<ArrayMesh> > &p_meshes);
 
@@ -152,6 +171,7 @@ public:
 	void _filter_anim_tracks(Ref<Animation> anim, Set<String> &keep);
 	void _filter_tracks(Node *scene, const String &p_text);
 	void _optimize_animations(Node *scene, float p_max_lin_error, float p_max_ang_error, float p_max_angle);
+	void _compress_animations(Node *scene);
 
 	virtual Error import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = NULL);
 
@@ -0,0 +1,322 @@
+/*************************************************************************/
+/*  resource_importer_texture_atlas.cpp                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "resource_importer_texture_atlas.h"
+
+#include "editor/import/resource_importer_texture.h"
+#include "io/config_file.h"
+#include "io/image_loader.h"
+#include "io/resource_saver.h"
+#include "os/dir_access.h"
+#include "scene/resources/texture.h"
+
+String ResourceImporterTextureAtlas::get_importer_name() const {
+
+	return "texture_atlas";
+}
+
+String ResourceImporterTextureAtlas::get_visible_name() const {
+
+	return "TextureAtlas";
+}
+void ResourceImporterTextureAtlas::get_recognized_extensions(List<String> *p_extensions) const {
+
+	ImageLoader::get_recognized_extensions(p_extensions);
+}
+String ResourceImporterTextureAtlas::get_save_extension() const {
+	return "res";
+}
+
+String ResourceImporterTextureAtlas::get_resource_type() const {
+
+	return "AtlasTexture";
+}
+
+bool ResourceImporterTextureAtlas::get_option_visibility(const String &p_option, const Map<StringName, Variant> &p_options) const {
+
+	return true;
+}
+
+int ResourceImporterTextureAtlas::get_preset_count() const {
+	return 0;
+}
+String ResourceImporterTextureAtlas::get_preset_name(int p_idx) const {
+
+	return String();
+}
+
+void ResourceImporterTextureAtlas::get_import_options(List<ImportOption> *r_options, int p_preset) const {
+
+	r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "atlas/group"), ""));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "atlas/margin", PROPERTY_HINT_RANGE, "0,16,1"), 2));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "atlas/max_size", PROPERTY_HINT_RANGE, "256,16384,1"), 4096));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "compress/mode", PROPERTY_HINT_ENUM, "Lossless,Uncompressed"), 0));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "flags/filter"), true));
+}
+
+bool ResourceImporterTextureAtlas::MemberHeightComparator::operator()(const Member &p_a, const Member &p_b) const {
+
+	if (p_a.image->get_height() != p_b.image->get_height())
+		return p_a.image->get_height() > p_b.image->get_height();
+
+	return p_a.path < p_b.path; //keep the packing stable, no matter which member is imported
+}
+
+void ResourceImporterTextureAtlas::_find_group_members(const String &p_source_file, const String &p_group, List<String> *r_members) const {
+
+	// members are the files next to this one that are imported as atlas textures of the same group
+	String base_dir = p_source_file.get_base_dir();
+
+	DirAccess *da = DirAccess::open(base_dir);
+	ERR_FAIL_COND(!da);
+
+	List<String> extensions;
+	get_recognized_extensions(&extensions);
+
+	da->list_dir_begin();
+	String f = da->get_next();
+	while (f != "") {
+
+		String path = base_dir.plus_file(f);
+		if (!da->current_is_dir() && path != p_source_file && extensions.find(f.get_extension().to_lower()) && FileAccess::exists(path + ".import")) {
+
+			Ref<ConfigFile> cf;
+			cf.instance();
+			if (cf->load(path + ".import") == OK && String(cf->get_value("remap", "importer", "")) == get_importer_name() && String(cf->get_value("params", "atlas/group", "")) == p_group) {
+				r_members->push_back(path);
+			}
+		}
+
+		f = da->get_next();
+	}
+	da->list_dir_end();
+
+	memdelete(da);
+}
+
+String ResourceImporterTextureAtlas::_get_page_path(const String &p_source_file, const String &p_group, int p_page) const {
+
+	String group_path = p_source_file.get_base_dir().plus_file(p_group == String() ? "atlas" : "atlas_" + p_group);
+	return ResourceFormatImporter::get_singleton()->get_import_base_path(group_path) + "-page" + itos(p_page) + ".stex";
+}
+
+int ResourceImporterTextureAtlas::_pack_members(Vector<Member> &r_members, int p_margin, int p_max_size, Vector<Size2i> *r_page_sizes) const {
+
+	// shelf packing, tallest first
+	r_members.sort_custom<MemberHeightComparator>();
+
+	int total_area = 0;
+	int widest = 0;
+	for (int i = 0; i < r_members.size(); i++) {
+		int w = r_members[i].image->get_width() + p_margin * 2;
+		int h = r_members[i].image->get_height() + p_margin * 2;
+		total_area += w * h;
+		widest = MAX(widest, w);
+	}
+
+	int page_width = next_power_of_2(Math::ceil(Math::sqrt((float)total_area)));
+	page_width = MAX(MIN(page_width, p_max_size), widest);
+
+	int page = 0;
+	int x = 0;
+	int y = 0;
+	int shelf_height = 0;
+	r_page_sizes->push_back(Size2i());
+
+	for (int i = 0; i < r_members.size(); i++) {
+
+		int w = r_members[i].image->get_width() + p_margin * 2;
+		int h = r_members[i].image->get_height() + p_margin * 2;
+
+		if (x + w > page_width) {
+			y += shelf_height;
+			x = 0;
+			shelf_height = 0;
+		}
+
+		if (y + h > p_max_size && y > 0) {
+			page++;
+			r_page_sizes->push_back(Size2i());
+			x = 0;
+			y = 0;
+			shelf_height = 0;
+		}
+
+		r_members.write[i].page = page;
+		r_members.write[i].position = Point2i(x + p_margin, y + p_margin);
+
+		x += w;
+		shelf_height = MAX(shelf_height, h);
+
+		Size2i &page_size = r_page_sizes->write[page];
+		page_size.width = MAX(page_size.width, x);
+		page_size.height = MAX(page_size.height, y + h);
+	}
+
+	return page + 1;
+}
+
+void ResourceImporterTextureAtlas::_blit_with_margin(const Ref<Image> &p_src, Ref<Image> &p_dst, const Point2i &p_pos, int p_margin) const {
+
+	int w = p_src->get_width();
+	int h = p_src->get_height();
+
+	p_dst->blit_rect(p_src, Rect2(0, 0, w, h), p_pos);
+
+	if (p_margin == 0)
+		return;
+
+	// repeat the edge pixels into the margin, so filtering never picks up a neighbor
+	Ref<Image> src = p_src;
+	src->lock();
+	p_dst->lock();
+
+	for (int y = -p_margin; y < h + p_margin; y++) {
+		for (int x = -p_margin; x < w + p_margin; x++) {
+
+			if (y >= 0 && y < h && x == 0) {
+				x = w - 1; //inside the image, skip to the right margin
+				continue;
+			}
+
+			p_dst->set_pixel(p_pos.x + x, p_pos.y + y, src->get_pixel(CLAMP(x, 0, w - 1), CLAMP(y, 0, h - 1)));
+		}
+	}
+
+	p_dst->unlock();
+	src->unlock();
+}
+
+Error ResourceImporterTextureAtlas::import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files) {
+
+	String group = p_options["atlas/group"];
+	int margin = p_options["atlas/margin"];
+	int max_size = p_options["atlas/max_size"];
+	int compress_mode = p_options["compress/mode"];
+	bool filter = p_options["flags/filter"];
+
+	// the whole group is packed on every import, so the pages and all members stay consistent
+	List<String> paths;
+	_find_group_members(p_source_file, group, &paths);
+
+	Vector<Member> members;
+
+	Member self;
+	self.path = p_source_file;
+	self.save_path = p_save_path + ".res";
+	self.image.instance();
+	Error err = ImageLoader::load_image(p_source_file, self.image);
+	if (err != OK)
+		return err;
+	members.push_back(self);
+
+	for (List<String>::Element *E = paths.front(); E; E = E->next()) {
+
+		Member m;
+		m.path = E->get();
+		m.save_path = ResourceFormatImporter::get_singleton()->get_import_base_path(m.path) + ".res";
+		m.image.instance();
+		if (ImageLoader::load_image(m.path, m.image) != OK) {
+			WARN_PRINTS("Can't load image for atlas: " + m.path);
+			continue;
+		}
+		members.push_back(m);
+	}
+
+	for (int i = 0; i < members.size(); i++) {
+		Ref<Image> image = members[i].image;
+		if (image->is_compressed()) {
+			image->decompress();
+		}
+		image->convert(Image::FORMAT_RGBA8);
+	}
+
+	Vector<Size2i> page_sizes;
+	int page_count = _pack_members(members, margin, max_size, &page_sizes);
+
+	int flags = filter ? int(Texture::FLAG_FILTER) : 0;
+
+	for (int i = 0; i < page_count; i++) {
+
+		Ref<Image> page;
+		page.instance();
+		page->create(page_sizes[i].width, page_sizes[i].height, false, Image::FORMAT_RGBA8);
+
+		for (int j = 0; j < members.size(); j++) {
+			if (members[j].page == i) {
+				_blit_with_margin(members[j].image, page, members[j].position, margin);
+			}
+		}
+
+		String page_path = _get_page_path(p_source_file, group, i);
+		ResourceImporterTexture::get_singleton()->_save_stex(page, page_path, compress_mode == COMPRESS_LOSSLESS ? ResourceImporterTexture::COMPRESS_LOSSLESS : ResourceImporterTexture::COMPRESS_UNCOMPRESSED, 0.7, Image::COMPRESS_S3TC, false, flags, false, false, false, false, false, false);
+
+		if (ResourceCache::has(page_path)) {
+			ResourceCache::get(page_path)->reload_from_file(); //update what is already being used
+		}
+
+		if (r_gen_files) {
+			r_gen_files->push_back(page_path);
+		}
+	}
+
+	// every member points to its page, references to the source images load these transparently
+	for (int i = 0; i < members.size(); i++) {
+
+		const Member &m = members[i];
+
+		Ref<Texture> page = ResourceLoader::load(_get_page_path(p_source_file, group, m.page));
+		ERR_FAIL_COND_V(page.is_null(), ERR_CANT_CREATE);
+
+		Ref<AtlasTexture> atlas;
+		if (ResourceCache::has(m.save_path)) {
+			atlas = Ref<AtlasTexture>(Object::cast_to<AtlasTexture>(ResourceCache::get(m.save_path)));
+		}
+		if (atlas.is_null()) {
+			atlas.instance();
+		}
+
+		atlas->set_atlas(page);
+		atlas->set_region(Rect2(m.position, Size2(m.image->get_width(), m.image->get_height())));
+		atlas->set_filter_clip(filter);
+
+		err = ResourceSaver::save(m.save_path, atlas);
+		if (err != OK) {
+			if (m.path == p_source_file)
+				return err;
+			WARN_PRINTS("Can't save atlas texture for: " + m.path);
+		}
+	}
+
+	return OK;
+}
+
+ResourceImporterTextureAtlas::ResourceImporterTextureAtlas() {
+}
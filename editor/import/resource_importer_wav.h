@@ -161,6 +161,7 @@ public:
 		}
 	}
 
+	virtual bool can_import_threaded() const { return true; }
 	virtual Error import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = NULL);
 
 	ResourceImporterWAV();
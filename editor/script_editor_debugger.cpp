@@ -31,6 +31,7 @@
 #include "script_editor_debugger.h"
 
 #include "editor_node.h"
+#include "editor_network_profiler.h"
 #include "editor_profiler.h"
 #include "editor_settings.h"
 #include "main/performance.h"
@@ -854,6 +855,14 @@ void ScriptEditorDebugger::_parse_message(const String &p_msg, const Array &p_da
 		else
 			profiler->add_frame_metric(metric, true);
 
+	} else if (p_msg == "network_profile") {
+
+		network_profiler->add_profile_data(p_data[0]);
+
+	} else if (p_msg == "network_stats") {
+
+		network_profiler->set_stats(p_data[0], p_data[1], p_data[2]);
+
 	} else if (p_msg == "kill_me") {
 
 		editor->call_deferred("stop_child_process");
@@ -1047,6 +1056,7 @@ void ScriptEditorDebugger::_notification(int p_what) {
 
 					_set_reason_text(TTR("Child Process Connected"), MESSAGE_SUCCESS);
 					profiler->clear();
+					network_profiler->clear();
 
 					inspect_scene_tree->clear();
 					le_set->set_disabled(true);
@@ -1064,6 +1074,9 @@ void ScriptEditorDebugger::_notification(int p_what) {
 					if (profiler->is_profiling()) {
 						_profiler_activate(true);
 					}
+					if (network_profiler->is_profiling()) {
+						_network_profiler_activate(true);
+					}
 
 				} else {
 
@@ -1284,6 +1297,16 @@ void ScriptEditorDebugger::_profiler_activate(bool p_enable) {
 	}
 }
 
+void ScriptEditorDebugger::_network_profiler_activate(bool p_enable) {
+
+	if (!connection.is_valid())
+		return;
+
+	Array msg;
+	msg.push_back(p_enable ? "start_network_profiling" : "stop_network_profiling");
+	ppeer->put_var(msg);
+}
+
 void ScriptEditorDebugger::_profiler_seeked() {
 
 	if (!connection.is_valid() || !connection->is_connected_to_host())
@@ -1822,6 +1845,7 @@ void ScriptEditorDebugger::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_error_stack_selected"), &ScriptEditorDebugger::_error_stack_selected);
 	ClassDB::bind_method(D_METHOD("_profiler_activate"), &ScriptEditorDebugger::_profiler_activate);
 	ClassDB::bind_method(D_METHOD("_profiler_seeked"), &ScriptEditorDebugger::_profiler_seeked);
+	ClassDB::bind_method(D_METHOD("_network_profiler_activate"), &ScriptEditorDebugger::_network_profiler_activate);
 	ClassDB::bind_method(D_METHOD("_clear_errors_list"), &ScriptEditorDebugger::_clear_errors_list);
 
 	ClassDB::bind_method(D_METHOD("_error_list_item_rmb_selected"), &ScriptEditorDebugger::_error_list_item_rmb_selected);
@@ -2031,6 +2055,13 @@ ScriptEditorDebugger::ScriptEditorDebugger(EditorNode *p_editor) {
 		profiler->connect("break_request", this, "_profiler_seeked");
 	}
 
+	{ //network profiler
+		network_profiler = memnew(EditorNetworkProfiler);
+		network_profiler->set_name(TTR("Network Profiler"));
+		tabs->add_child(network_profiler);
+		network_profiler->connect("enable_profiling", this, "_network_profiler_activate");
+	}
+
 	{ //monitors
 
 		HSplitContainer *hsp = memnew(HSplitContainer);
@@ -256,9 +256,53 @@ Vector3 InputDefault::get_gyroscope() const {
 
 void InputDefault::parse_input_event(const Ref<InputEvent> &p_event) {
 
+	_THREAD_SAFE_METHOD_
+
+	if (use_accumulated_input) {
+
+		if (accumulated_event.is_valid() && accumulated_event->accumulate(p_event))
+			return;
+
+		// keep the order of events, anything that can't be merged flushes what is pending
+		flush_accumulated_events();
+
+		Ref<InputEventMouseMotion> mm = p_event;
+		if (mm.is_valid()) {
+			accumulated_event = mm->duplicate();
+			return;
+		}
+	}
+
 	_parse_input_event_impl(p_event, false);
 }
 
+void InputDefault::flush_accumulated_events() {
+
+	_THREAD_SAFE_METHOD_
+
+	if (accumulated_event.is_null())
+		return;
+
+	Ref<InputEvent> event = accumulated_event;
+	accumulated_event.unref();
+	_parse_input_event_impl(event, false);
+}
+
+void InputDefault::set_use_accumulated_input(bool p_enable) {
+
+	_THREAD_SAFE_METHOD_
+
+	use_accumulated_input = p_enable;
+	if (!use_accumulated_input) {
+		flush_accumulated_events();
+	}
+}
+
+bool InputDefault::is_using_accumulated_input() const {
+
+	return use_accumulated_input;
+}
+
 void InputDefault::_parse_input_event_impl(const Ref<InputEvent> &p_event, bool p_is_emulated) {
 
 	_THREAD_SAFE_METHOD_
@@ -398,18 +442,21 @@ void InputDefault::_parse_input_event_impl(const Ref<InputEvent> &p_event, bool
 		}
 	}
 
-	for (const Map<StringName, InputMap::Action>::Element *E = InputMap::get_singleton()->get_action_map().front(); E; E = E->next()) {
-		if (InputMap::get_singleton()->event_is_action(p_event, E->key())) {
+	// only actions bound to the same key, button or axis can match
+	const Vector<StringName> *candidates = InputMap::get_singleton()->get_event_action_candidates(p_event);
+	for (int i = 0; candidates && i < candidates->size(); i++) {
+		const StringName &action_name = (*candidates)[i];
+		if (InputMap::get_singleton()->event_is_action(p_event, action_name)) {
 
 			// Save the action's state
-			if (!p_event->is_echo() && is_action_pressed(E->key()) != p_event->is_action_pressed(E->key())) {
+			if (!p_event->is_echo() && is_action_pressed(action_name) != p_event->is_action_pressed(action_name)) {
 				Action action;
 				action.physics_frame = Engine::get_singleton()->get_physics_frames();
 				action.idle_frame = Engine::get_singleton()->get_idle_frames();
-				action.pressed = p_event->is_action_pressed(E->key());
-				action_state[E->key()] = action;
+				action.pressed = p_event->is_action_pressed(action_name);
+				action_state[action_name] = action;
 			}
-			action_state[E->key()].strength = p_event->get_action_strength(E->key());
+			action_state[action_name].strength = p_event->get_action_strength(action_name);
 		}
 	}
 
@@ -633,6 +680,7 @@ InputDefault::InputDefault() {
 	emulate_mouse_from_touch = false;
 	mouse_from_touch_index = -1;
 	main_loop = NULL;
+	use_accumulated_input = true;
 
 	hat_map_default[HAT_UP].type = TYPE_BUTTON;
 	hat_map_default[HAT_UP].index = JOY_DPAD_UP;
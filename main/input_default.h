@@ -181,6 +181,10 @@ private:
 
 	void _parse_input_event_impl(const Ref<InputEvent> &p_event, bool p_is_emulated);
 
+	// mouse motion received between frames is merged, so the scene only sees one per frame
+	bool use_accumulated_input;
+	Ref<InputEvent> accumulated_event;
+
 public:
 	virtual bool is_key_pressed(int p_scancode) const;
 	virtual bool is_mouse_button_pressed(int p_button) const;
@@ -212,6 +216,9 @@ public:
 	virtual Point2i warp_mouse_motion(const Ref<InputEventMouseMotion> &p_motion, const Rect2 &p_rect);
 
 	virtual void parse_input_event(const Ref<InputEvent> &p_event);
+	virtual void flush_accumulated_events();
+	virtual void set_use_accumulated_input(bool p_enable);
+	virtual bool is_using_accumulated_input() const;
 
 	void set_gravity(const Vector3 &p_gravity);
 	void set_accelerometer(const Vector3 &p_accel);
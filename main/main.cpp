@@ -36,6 +36,8 @@
 #include "message_queue.h"
 #include "modules/register_module_types.h"
 #include "os/os.h"
+#include "os/lock_profiler.h"
+#include "os/trace.h"
 #include "platform/register_platform_apis.h"
 #include "project_settings.h"
 #include "scene/register_scene_types.h"
@@ -69,6 +71,7 @@
 #include "editor/project_manager.h"
 #endif
 
+#include "io/file_access_http.h"
 #include "io/file_access_network.h"
 #include "servers/physics_2d_server.h"
 
@@ -130,6 +133,8 @@ static int fixed_fps = -1;
 static bool auto_build_solutions = false;
 static bool auto_quit = false;
 static bool print_fps = false;
+static String shader_variants_path;
+static String trace_path;
 
 static OS::ProcessID allow_focus_steal_pid = 0;
 
@@ -259,6 +264,11 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  --disable-crash-handler          Disable crash handler when supported by the platform code.\n");
 	OS::get_singleton()->print("  --fixed-fps <fps>                Force a fixed number of frames per second. This setting disables real-time synchronization.\n");
 	OS::get_singleton()->print("  --print-fps                      Print the frames per second to the stdout.\n");
+	OS::get_singleton()->print("  --record-shader-variants <file>  Write the shader variants compiled while running to <file>, to be precompiled with VisualServer.shader_variants_load().\n");
+#ifdef DEBUG_ENABLED
+	OS::get_singleton()->print("  --trace <file>                   Record the engine's CPU scopes while running and write them to <file> as a Chrome trace.\n");
+	OS::get_singleton()->print("  --profile-locks                  Record wait times of the engine's named locks, see Performance.get_lock_profile().\n");
+#endif
 	OS::get_singleton()->print("\n");
 
 	OS::get_singleton()->print("Standalone tools:\n");
@@ -282,6 +292,10 @@ void Main::print_help(const char *p_binary) {
 		comma = ", ";
 	}
 	OS::get_singleton()->print(").\n");
+	OS::get_singleton()->print("  --benchmark                      Run the engine microbenchmarks, same as '--test benchmark'.\n");
+	OS::get_singleton()->print("  --benchmark-filter <pattern>     Only run the benchmarks whose name matches the pattern (e.g. 'string/*').\n");
+	OS::get_singleton()->print("  --benchmark-json <file>          Write the benchmark results to <file> in JSON format.\n");
+	OS::get_singleton()->print("  --benchmark-samples <n>          Number of timed batches per benchmark (default 5).\n");
 #endif
 }
 
@@ -673,6 +687,24 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			}
 		} else if (I->get() == "--print-fps") {
 			print_fps = true;
+		} else if (I->get() == "--record-shader-variants") {
+			if (I->next()) {
+				shader_variants_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing shader variants file argument, aborting.\n");
+				goto error;
+			}
+		} else if (I->get() == "--trace") {
+			if (I->next()) {
+				trace_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing trace file argument, aborting.\n");
+				goto error;
+			}
+		} else if (I->get() == "--profile-locks") {
+			LockProfiler::set_enabled(true);
 		} else if (I->get() == "--disable-crash-handler") {
 			OS::get_singleton()->disable_crash_handler();
 		} else {
@@ -724,6 +756,7 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	}
 
 	FileAccessNetwork::configure();
+	FileAccessHTTPStream::configure();
 
 	if (remotefs != "") {
 
@@ -772,10 +805,18 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	GLOBAL_DEF("logging/file_logging/enable_file_logging", false);
 	GLOBAL_DEF("logging/file_logging/log_path", "user://logs/log.txt");
 	GLOBAL_DEF("logging/file_logging/max_log_files", 10);
+	GLOBAL_DEF("logging/file_logging/json_lines", false);
+	GLOBAL_DEF("logging/file_logging/async", false);
+	GLOBAL_DEF("logging/file_logging/async_buffer_size_kb", 1024);
 	if (FileAccess::get_create_func(FileAccess::ACCESS_USERDATA) && GLOBAL_GET("logging/file_logging/enable_file_logging")) {
 		String base_path = GLOBAL_GET("logging/file_logging/log_path");
 		int max_files = GLOBAL_GET("logging/file_logging/max_log_files");
-		OS::get_singleton()->add_logger(memnew(RotatedFileLogger(base_path, max_files)));
+		Logger *file_logger = memnew(RotatedFileLogger(base_path, max_files, GLOBAL_GET("logging/file_logging/json_lines")));
+		if (GLOBAL_GET("logging/file_logging/async")) {
+			int buffer_size = GLOBAL_GET("logging/file_logging/async_buffer_size_kb");
+			file_logger = memnew(AsyncLogger(file_logger, MAX(buffer_size, 1) * 1024));
+		}
+		OS::get_singleton()->add_logger(file_logger);
 	}
 
 #ifdef TOOLS_ENABLED
@@ -883,10 +924,13 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	}
 
 	Engine::get_singleton()->_pixel_snap = GLOBAL_DEF("rendering/quality/2d/use_pixel_snap", false);
+	Engine::get_singleton()->_physics_interpolation = GLOBAL_DEF("physics/common/physics_interpolation", false);
 	OS::get_singleton()->_keep_screen_on = GLOBAL_DEF("display/window/energy_saving/keep_screen_on", true);
 	if (rtm == -1) {
 		rtm = GLOBAL_DEF("rendering/threads/thread_model", OS::RENDER_THREAD_SAFE);
 	}
+	GLOBAL_DEF("rendering/threads/max_queued_frames", 1);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/threads/max_queued_frames", PropertyInfo(Variant::INT, "rendering/threads/max_queued_frames", PROPERTY_HINT_RANGE, "1,3,1"));
 
 	if (rtm >= 0 && rtm < 3) {
 		if (editor) {
@@ -958,6 +1002,8 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	GLOBAL_DEF("debug/settings/stdout/print_fps", false);
 
+	Memory::set_tracker_sample_interval((int)GLOBAL_GET("debug/settings/memory/tracker_sample_interval"));
+
 	if (!OS::get_singleton()->_verbose_stdout) //overridden
 		OS::get_singleton()->_verbose_stdout = GLOBAL_DEF("debug/settings/stdout/verbose_stdout", false);
 
@@ -1007,6 +1053,7 @@ error:
 		memdelete(packed_data);
 	if (file_access_network_client)
 		memdelete(file_access_network_client);
+	FileAccessHTTPStream::finish();
 
 	// Note 1: *zip_packed_data live into *packed_data
 	// Note 2: PackedData::~PackedData destroy this.
@@ -1036,6 +1083,10 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 		Thread::_main_thread_id = p_main_tid_override;
 	}
 
+	if (trace_path != String()) {
+		Trace::start();
+	}
+
 	Error err = OS::get_singleton()->initialize(video_mode, video_driver_idx, audio_driver_idx);
 	if (err != OK) {
 		return err;
@@ -1044,6 +1095,10 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 		OS::get_singleton()->set_window_position(init_custom_pos);
 	}
 
+	if (shader_variants_path != String()) {
+		VisualServer::get_singleton()->shader_variants_set_recording(true);
+	}
+
 	// right moment to create and initialize the audio server
 
 	audio_server = memnew(AudioServer);
@@ -1076,6 +1131,9 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 		OS::get_singleton()->set_window_always_on_top(true);
 	}
 
+	// the editor inspects every class right away, so only defer method binding when running a project
+	ClassDB::set_lazy_binding(!editor && !project_manager && bool(GLOBAL_DEF("application/run/lazy_class_binding", true)));
+
 	register_server_types();
 
 	MAIN_PRINT("Main: Load Remaps");
@@ -1204,6 +1262,12 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 
 	ResourceLoader::load_path_remaps();
 
+	int retain_budget_mb = GLOBAL_DEF("memory/limits/resource_cache/retain_budget_mb", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/resource_cache/retain_budget_mb", PropertyInfo(Variant::INT, "memory/limits/resource_cache/retain_budget_mb", PROPERTY_HINT_RANGE, "0,16384,1,or_greater"));
+	if (!editor) {
+		ResourceCache::set_retain_budget(uint64_t(MAX(retain_budget_mb, 0)) * 1024 * 1024);
+	}
+
 	audio_server->load_default_bus_layout();
 
 	if (use_debug_profiler && script_debugger) {
@@ -1259,6 +1323,8 @@ bool Main::start() {
 			game_path = args[i];
 		} else if (args[i] == "--check-only") {
 			check_only = true;
+		} else if (args[i] == "--benchmark") {
+			test = "benchmark";
 		}
 		//parameters that have an argument to the right
 		else if (i < (args.size() - 1)) {
@@ -1724,6 +1790,11 @@ static uint64_t idle_process_max = 0;
 
 bool Main::iteration() {
 
+	TRACE_SCOPE("Main::iteration");
+
+	// deliver mouse motion merged since the last frame before anything else runs
+	Input::get_singleton()->flush_accumulated_events();
+
 	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -1766,25 +1837,37 @@ bool Main::iteration() {
 
 	for (int iters = 0; iters < advance.physics_steps; ++iters) {
 
+		TRACE_SCOPE("Main::physics_step");
+
 		uint64_t physics_begin = OS::get_singleton()->get_ticks_usec();
 
+		if (Engine::get_singleton()->is_physics_interpolation_enabled()) {
+			VisualServer::get_singleton()->tick(); //transforms set from now on belong to the new tick
+		}
+
 		PhysicsServer::get_singleton()->sync();
 		PhysicsServer::get_singleton()->flush_queries();
 
 		Physics2DServer::get_singleton()->sync();
 		Physics2DServer::get_singleton()->flush_queries();
 
-		if (OS::get_singleton()->get_main_loop()->iteration(frame_slice * time_scale)) {
-			exit = true;
-			break;
-		}
+		{
+			MemoryTagScope tag(Memory::TAG_SCENE);
+			if (OS::get_singleton()->get_main_loop()->iteration(frame_slice * time_scale)) {
+				exit = true;
+				break;
+			}
 
-		message_queue->flush();
+			message_queue->flush();
+		}
 
-		PhysicsServer::get_singleton()->step(frame_slice * time_scale);
+		{
+			MemoryTagScope tag(Memory::TAG_PHYSICS);
+			PhysicsServer::get_singleton()->step(frame_slice * time_scale);
 
-		Physics2DServer::get_singleton()->end_sync();
-		Physics2DServer::get_singleton()->step(frame_slice * time_scale);
+			Physics2DServer::get_singleton()->end_sync();
+			Physics2DServer::get_singleton()->step(frame_slice * time_scale);
+		}
 
 		message_queue->flush();
 
@@ -1794,16 +1877,26 @@ bool Main::iteration() {
 	}
 
 	Engine::get_singleton()->_in_physics = false;
+	Engine::get_singleton()->_physics_interpolation_fraction = advance.interpolation_fraction;
+	if (Engine::get_singleton()->is_physics_interpolation_enabled()) {
+		VisualServer::get_singleton()->set_physics_interpolation_fraction(advance.interpolation_fraction);
+	}
 
 	uint64_t idle_begin = OS::get_singleton()->get_ticks_usec();
 
-	OS::get_singleton()->get_main_loop()->idle(step * time_scale);
-	message_queue->flush();
+	{
+		MemoryTagScope tag(Memory::TAG_SCENE);
+		OS::get_singleton()->get_main_loop()->idle(step * time_scale);
+		message_queue->flush();
+	}
 
 	VisualServer::get_singleton()->sync(); //sync if still drawing from previous frames.
 
 	if (OS::get_singleton()->can_draw() && !disable_render_loop) {
 
+		MemoryTagScope tag(Memory::TAG_RENDERING);
+		TRACE_SCOPE("Main::draw");
+
 		if ((!force_redraw_requested) && OS::get_singleton()->is_in_low_processor_usage_mode()) {
 			if (VisualServer::get_singleton()->has_changed()) {
 				VisualServer::get_singleton()->draw(true, scaled_step); // flush visual commands
@@ -1911,10 +2004,23 @@ void Main::cleanup() {
 
 	OS::get_singleton()->delete_main_loop();
 
+	if (shader_variants_path != String()) {
+		VisualServer::get_singleton()->shader_variants_save(shader_variants_path);
+	}
+
+	if (trace_path != String()) {
+		Trace::stop();
+		if (Trace::save_chrome_trace(trace_path) != OK) {
+			ERR_PRINTS("Can't save trace to: " + trace_path);
+		}
+	}
+
 	OS::get_singleton()->_cmdline.clear();
 	OS::get_singleton()->_execpath = "";
 	OS::get_singleton()->_local_clipboard = "";
 
+	ResourceLoader::clear_thread_load_tasks();
+	ResourceCache::clear_retained();
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
@@ -1947,6 +2053,7 @@ void Main::cleanup() {
 		memdelete(packed_data);
 	if (file_access_network_client)
 		memdelete(file_access_network_client);
+	FileAccessHTTPStream::finish();
 	if (performance)
 		memdelete(performance);
 	if (input_map)
@@ -1970,6 +2077,9 @@ void Main::cleanup() {
 	unregister_core_driver_types();
 	unregister_core_types();
 
+	Trace::finish();
+	LockProfiler::finish();
+
 	OS::get_singleton()->clear_last_error();
 	OS::get_singleton()->finalize_core();
 }
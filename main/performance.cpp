@@ -29,7 +29,9 @@
 /*************************************************************************/
 
 #include "performance.h"
+#include "command_queue_mt.h"
 #include "message_queue.h"
+#include "os/lock_profiler.h"
 #include "os/os.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
@@ -42,6 +44,11 @@ void Performance::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &Performance::get_monitor);
 
+	ClassDB::bind_method(D_METHOD("set_lock_profiling_enabled", "enabled"), &Performance::set_lock_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("is_lock_profiling_enabled"), &Performance::is_lock_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("get_lock_profile"), &Performance::get_lock_profile);
+	ClassDB::bind_method(D_METHOD("reset_lock_profile"), &Performance::reset_lock_profile);
+
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
 	BIND_ENUM_CONSTANT(TIME_PHYSICS_PROCESS);
@@ -70,6 +77,29 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MEMORY_ARRAY_ALLOCATIONS);
+	BIND_ENUM_CONSTANT(MEMORY_DICTIONARY_ALLOCATIONS);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_SOLVER_ITERATIONS);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_SOLVE_TIME);
+	BIND_ENUM_CONSTANT(COMMAND_QUEUE_COMMANDS_IN_FRAME);
+	BIND_ENUM_CONSTANT(COMMAND_QUEUE_BYTES_IN_FRAME);
+	BIND_ENUM_CONSTANT(NETWORK_INCOMING_BANDWIDTH);
+	BIND_ENUM_CONSTANT(NETWORK_OUTGOING_BANDWIDTH);
+	BIND_ENUM_CONSTANT(NETWORK_ROUND_TRIP_TIME);
+	BIND_ENUM_CONSTANT(RENDER_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_SHADOWS);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_OPAQUE);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_TRANSPARENT);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_SSAO);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_GLOW);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_TONEMAP);
+	BIND_ENUM_CONSTANT(RENDER_GPU_TIME_CANVAS);
+	BIND_ENUM_CONSTANT(MEMORY_ALLOCATIONS_PER_SECOND);
+	BIND_ENUM_CONSTANT(MEMORY_RESOURCE_CACHE_RETAINED);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_HITS);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_MISSES);
+	BIND_ENUM_CONSTANT(THREAD_LOCK_CONTENTIONS_PER_SECOND);
+	BIND_ENUM_CONSTANT(THREAD_LOCK_WAIT_TIME_PER_SECOND);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -107,6 +137,29 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"memory/array_allocs",
+		"memory/dictionary_allocs",
+		"physics_2d/solver_iterations",
+		"physics_2d/solve_time",
+		"command_queue/commands",
+		"command_queue/bytes",
+		"network/incoming_bandwidth",
+		"network/outgoing_bandwidth",
+		"network/round_trip_time",
+		"raster/instanced_draw_calls_saved",
+		"gpu/shadows",
+		"gpu/opaque",
+		"gpu/transparent",
+		"gpu/ssao",
+		"gpu/glow",
+		"gpu/tonemap",
+		"gpu/canvas",
+		"memory/allocs_per_second",
+		"memory/resource_cache_retained",
+		"object/resource_cache_hits",
+		"object/resource_cache_misses",
+		"threads/lock_contentions_per_second",
+		"threads/lock_wait_time_per_second",
 
 	};
 
@@ -140,10 +193,18 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case RENDER_SHADER_CHANGES_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_SHADER_CHANGES_IN_FRAME);
 		case RENDER_SURFACE_CHANGES_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_SURFACE_CHANGES_IN_FRAME);
 		case RENDER_DRAW_CALLS_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_DRAW_CALLS_IN_FRAME);
+		case RENDER_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME);
 		case RENDER_VIDEO_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_VIDEO_MEM_USED);
 		case RENDER_TEXTURE_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_TEXTURE_MEM_USED);
 		case RENDER_VERTEX_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_VERTEX_MEM_USED);
 		case RENDER_USAGE_VIDEO_MEM_TOTAL: return VS::get_singleton()->get_render_info(VS::INFO_USAGE_VIDEO_MEM_TOTAL);
+		case RENDER_GPU_TIME_SHADOWS: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_SHADOWS_USEC) / 1000000.0;
+		case RENDER_GPU_TIME_OPAQUE: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_OPAQUE_USEC) / 1000000.0;
+		case RENDER_GPU_TIME_TRANSPARENT: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_TRANSPARENT_USEC) / 1000000.0;
+		case RENDER_GPU_TIME_SSAO: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_SSAO_USEC) / 1000000.0;
+		case RENDER_GPU_TIME_GLOW: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_GLOW_USEC) / 1000000.0;
+		case RENDER_GPU_TIME_TONEMAP: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_TONEMAP_USEC) / 1000000.0;
+		case RENDER_GPU_TIME_CANVAS: return VS::get_singleton()->get_render_info(VS::INFO_GPU_TIME_CANVAS_USEC) / 1000000.0;
 		case PHYSICS_2D_ACTIVE_OBJECTS: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_ACTIVE_OBJECTS);
 		case PHYSICS_2D_COLLISION_PAIRS: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_2D_ISLAND_COUNT: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_ISLAND_COUNT);
@@ -151,6 +212,34 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY: return AudioServer::get_singleton()->get_output_latency();
+		case MEMORY_ARRAY_ALLOCATIONS: return Array::get_heap_allocation_count();
+		case MEMORY_DICTIONARY_ALLOCATIONS: return Dictionary::get_heap_allocation_count();
+		case PHYSICS_2D_SOLVER_ITERATIONS: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_SOLVER_ITERATIONS);
+		case PHYSICS_2D_SOLVE_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_SOLVE_TIME) / 1000000.0;
+		case COMMAND_QUEUE_COMMANDS_IN_FRAME: return _command_queue_frame_count;
+		case COMMAND_QUEUE_BYTES_IN_FRAME: return _command_queue_frame_bytes;
+		case MEMORY_ALLOCATIONS_PER_SECOND: return _allocations_per_second;
+		case MEMORY_RESOURCE_CACHE_RETAINED: return ResourceCache::get_retained_memory();
+		case RESOURCE_CACHE_HITS: return ResourceCache::get_hit_count();
+		case RESOURCE_CACHE_MISSES: return ResourceCache::get_miss_count();
+		case THREAD_LOCK_CONTENTIONS_PER_SECOND: return _lock_contentions_per_second;
+		case THREAD_LOCK_WAIT_TIME_PER_SECOND: return _lock_wait_time_per_second;
+		case NETWORK_INCOMING_BANDWIDTH:
+		case NETWORK_OUTGOING_BANDWIDTH:
+		case NETWORK_ROUND_TRIP_TIME: {
+
+			MainLoop *ml = OS::get_singleton()->get_main_loop();
+			SceneTree *sml = Object::cast_to<SceneTree>(ml);
+			if (!sml || !sml->get_multiplayer().is_valid())
+				return 0;
+
+			Ref<MultiplayerAPI> multiplayer = sml->get_multiplayer();
+			if (p_monitor == NETWORK_INCOMING_BANDWIDTH)
+				return multiplayer->get_incoming_bandwidth_usage();
+			if (p_monitor == NETWORK_OUTGOING_BANDWIDTH)
+				return multiplayer->get_outgoing_bandwidth_usage();
+			return multiplayer->get_average_round_trip_time();
+		};
 
 		default: {}
 	}
@@ -191,6 +280,29 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
 
 	};
 
@@ -200,6 +312,70 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 void Performance::set_process_time(float p_pt) {
 
 	_process_time = p_pt;
+
+	// called once per frame, so the queue totals can be turned into per frame values here
+	uint64_t count = CommandQueueMT::get_total_command_count();
+	uint64_t bytes = CommandQueueMT::get_total_command_bytes();
+	_command_queue_frame_count = count - _command_queue_last_count;
+	_command_queue_frame_bytes = bytes - _command_queue_last_bytes;
+	_command_queue_last_count = count;
+	_command_queue_last_bytes = bytes;
+
+	// allocations are only counted by the memory tracker, averaged over about a second
+	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+	if (ticks - _allocation_last_ticks >= 1000000) {
+		uint64_t allocations = Memory::get_tracked_allocation_count();
+		_allocations_per_second = (allocations - _allocation_last_count) * 1000000.0 / (ticks - _allocation_last_ticks);
+		_allocation_last_count = allocations;
+
+		// lock waits are only counted while lock profiling is enabled, over the same window
+		uint64_t contentions = LockProfiler::get_total_contentions();
+		uint64_t wait_usec = LockProfiler::get_total_wait_usec();
+		_lock_contentions_per_second = (contentions - _lock_last_contentions) * 1000000.0 / (ticks - _allocation_last_ticks);
+		_lock_wait_time_per_second = (wait_usec - _lock_last_wait_usec) / float(ticks - _allocation_last_ticks);
+		_lock_last_contentions = contentions;
+		_lock_last_wait_usec = wait_usec;
+
+		_allocation_last_ticks = ticks;
+	}
+}
+
+void Performance::set_lock_profiling_enabled(bool p_enabled) {
+
+	LockProfiler::set_enabled(p_enabled);
+}
+
+bool Performance::is_lock_profiling_enabled() const {
+
+	return LockProfiler::is_enabled();
+}
+
+Array Performance::get_lock_profile() const {
+
+	List<LockProfiler::Site> sites;
+	LockProfiler::get_sites(&sites);
+
+	Array ret;
+	for (List<LockProfiler::Site>::Element *E = sites.front(); E; E = E->next()) {
+
+		const LockProfiler::Site &s = E->get();
+		Dictionary d;
+		d["name"] = s.name;
+		d["acquisitions"] = s.acquisitions;
+		d["contentions"] = s.contentions;
+		d["wait_time"] = s.wait_usec / 1000000.0;
+		d["max_wait_time"] = s.max_wait_usec / 1000000.0;
+		ret.push_back(d);
+	}
+
+	return ret;
+}
+
+void Performance::reset_lock_profile() {
+
+	LockProfiler::reset();
+	_lock_last_contentions = 0;
+	_lock_last_wait_usec = 0;
 }
 
 void Performance::set_physics_process_time(float p_pt) {
@@ -211,5 +387,16 @@ Performance::Performance() {
 
 	_process_time = 0;
 	_physics_process_time = 0;
+	_command_queue_last_count = 0;
+	_command_queue_last_bytes = 0;
+	_command_queue_frame_count = 0;
+	_command_queue_frame_bytes = 0;
+	_allocation_last_count = 0;
+	_allocation_last_ticks = 0;
+	_allocations_per_second = 0;
+	_lock_last_contentions = 0;
+	_lock_last_wait_usec = 0;
+	_lock_contentions_per_second = 0;
+	_lock_wait_time_per_second = 0;
 	singleton = this;
 }
@@ -46,6 +46,20 @@ class Performance : public Object {
 	float _process_time;
 	float _physics_process_time;
 
+	uint64_t _command_queue_last_count;
+	uint64_t _command_queue_last_bytes;
+	uint64_t _command_queue_frame_count;
+	uint64_t _command_queue_frame_bytes;
+
+	uint64_t _allocation_last_count;
+	uint64_t _allocation_last_ticks;
+
+	uint64_t _lock_last_contentions;
+	uint64_t _lock_last_wait_usec;
+	float _lock_contentions_per_second;
+	float _lock_wait_time_per_second;
+	float _allocations_per_second;
+
 public:
 	enum Monitor {
 
@@ -78,6 +92,29 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MEMORY_ARRAY_ALLOCATIONS,
+		MEMORY_DICTIONARY_ALLOCATIONS,
+		PHYSICS_2D_SOLVER_ITERATIONS,
+		PHYSICS_2D_SOLVE_TIME,
+		COMMAND_QUEUE_COMMANDS_IN_FRAME,
+		COMMAND_QUEUE_BYTES_IN_FRAME,
+		NETWORK_INCOMING_BANDWIDTH,
+		NETWORK_OUTGOING_BANDWIDTH,
+		NETWORK_ROUND_TRIP_TIME,
+		RENDER_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME,
+		RENDER_GPU_TIME_SHADOWS,
+		RENDER_GPU_TIME_OPAQUE,
+		RENDER_GPU_TIME_TRANSPARENT,
+		RENDER_GPU_TIME_SSAO,
+		RENDER_GPU_TIME_GLOW,
+		RENDER_GPU_TIME_TONEMAP,
+		RENDER_GPU_TIME_CANVAS,
+		MEMORY_ALLOCATIONS_PER_SECOND,
+		MEMORY_RESOURCE_CACHE_RETAINED,
+		RESOURCE_CACHE_HITS,
+		RESOURCE_CACHE_MISSES,
+		THREAD_LOCK_CONTENTIONS_PER_SECOND,
+		THREAD_LOCK_WAIT_TIME_PER_SECOND,
 		MONITOR_MAX
 	};
 
@@ -92,6 +129,11 @@ public:
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
 
+	void set_lock_profiling_enabled(bool p_enabled);
+	bool is_lock_profiling_enabled() const;
+	Array get_lock_profile() const;
+	void reset_lock_profile();
+
 	void set_process_time(float p_pt);
 	void set_physics_process_time(float p_pt);
 
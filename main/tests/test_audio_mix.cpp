@@ -0,0 +1,131 @@
+/*************************************************************************/
+/*  test_audio_mix.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_audio_mix.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+#include "core/vector.h"
+#include "servers/audio/audio_mix.h"
+
+namespace TestAudioMix {
+
+enum {
+	VOICES = 128,
+	BUFFER_FRAMES = 512,
+	ITERATIONS = 200
+};
+
+// one mix step done the way the players and the bus mixer used to do it
+static void mix_reference(const Vector<Vector<AudioFrame> > &p_voices, AudioFrame *p_bus) {
+
+	for (int j = 0; j < BUFFER_FRAMES; j++) {
+		p_bus[j] = AudioFrame(0, 0);
+	}
+
+	for (int i = 0; i < p_voices.size(); i++) {
+
+		const AudioFrame *src = p_voices[i].ptr();
+		AudioFrame vol = AudioFrame(0.5, 0.25);
+		AudioFrame vol_inc = AudioFrame(0.0001, 0.0002);
+
+		for (int j = 0; j < BUFFER_FRAMES; j++) {
+			p_bus[j] += src[j] * vol;
+			vol += vol_inc;
+		}
+	}
+
+	AudioFrame peak = AudioFrame(0, 0);
+	for (int j = 0; j < BUFFER_FRAMES; j++) {
+		p_bus[j] *= 0.5;
+		peak.l = MAX(peak.l, ABS(p_bus[j].l));
+		peak.r = MAX(peak.r, ABS(p_bus[j].r));
+	}
+}
+
+static void mix_optimized(const Vector<Vector<AudioFrame> > &p_voices, AudioFrame *p_bus) {
+
+	zeromem(p_bus, BUFFER_FRAMES * sizeof(AudioFrame));
+
+	for (int i = 0; i < p_voices.size(); i++) {
+		audio_mix_add_ramp(p_bus, p_voices[i].ptr(), BUFFER_FRAMES, AudioFrame(0.5, 0.25), AudioFrame(0.0001, 0.0002));
+	}
+
+	audio_mix_gain_peak(p_bus, BUFFER_FRAMES, 0.5);
+}
+
+MainLoop *test() {
+
+	OS::get_singleton()->print("\n\nAudio mix benchmark: %d voices, %d frames per buffer\n", VOICES, BUFFER_FRAMES);
+
+	Vector<Vector<AudioFrame> > voices;
+	voices.resize(VOICES);
+	for (int i = 0; i < VOICES; i++) {
+		voices.write[i].resize(BUFFER_FRAMES);
+		for (int j = 0; j < BUFFER_FRAMES; j++) {
+			float t = j * (i + 1) * 0.001;
+			voices.write[i].write[j] = AudioFrame(Math::sin(t), Math::cos(t));
+		}
+	}
+
+	Vector<AudioFrame> bus_reference;
+	Vector<AudioFrame> bus_optimized;
+	bus_reference.resize(BUFFER_FRAMES);
+	bus_optimized.resize(BUFFER_FRAMES);
+
+	mix_reference(voices, bus_reference.ptrw());
+	mix_optimized(voices, bus_optimized.ptrw());
+
+	float max_error = 0;
+	for (int j = 0; j < BUFFER_FRAMES; j++) {
+		max_error = MAX(max_error, ABS(bus_reference[j].l - bus_optimized[j].l));
+		max_error = MAX(max_error, ABS(bus_reference[j].r - bus_optimized[j].r));
+	}
+
+	OS::get_singleton()->print("max error: %f %s\n", max_error, max_error < 0.01 ? "OK" : "FAIL");
+
+	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		mix_reference(voices, bus_reference.ptrw());
+	}
+	uint64_t reference_usec = MAX(OS::get_singleton()->get_ticks_usec() - ticks, 1);
+
+	ticks = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		mix_optimized(voices, bus_optimized.ptrw());
+	}
+	uint64_t optimized_usec = MAX(OS::get_singleton()->get_ticks_usec() - ticks, 1);
+
+	OS::get_singleton()->print("reference: %f voices/ms\n", double(VOICES) * ITERATIONS * 1000.0 / reference_usec);
+	OS::get_singleton()->print("optimized: %f voices/ms\n", double(VOICES) * ITERATIONS * 1000.0 / optimized_usec);
+
+	return NULL;
+}
+} // namespace TestAudioMix
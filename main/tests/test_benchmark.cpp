@@ -0,0 +1,716 @@
+/*************************************************************************/
+/*  test_benchmark.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_benchmark.h"
+
+#include "core/engine.h"
+#include "core/hash_map.h"
+#include "core/io/json.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/map.h"
+#include "core/math/camera_matrix.h"
+#include "core/math/octree.h"
+#include "core/oa_hash_map.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "scene/resources/curve.h"
+#include "servers/physics_server.h"
+#include "servers/visual_server.h"
+
+namespace TestBenchmark {
+
+// results are accumulated here so the compiler can't drop the measured work
+static volatile uint32_t sink = 0;
+
+class Benchmark {
+public:
+	virtual const char *get_name() const = 0;
+
+	virtual void setup() {}
+	// runs the measured operation p_iterations times
+	virtual void run(int p_iterations) = 0;
+	virtual void teardown() {}
+
+	virtual ~Benchmark() {}
+};
+
+/* Variant */
+
+class BenchVariantAddInt : public Benchmark {
+public:
+	virtual const char *get_name() const { return "variant/add_int"; }
+
+	virtual void run(int p_iterations) {
+
+		Variant a = 1;
+		Variant b = 2;
+		Variant r;
+		bool valid;
+		for (int i = 0; i < p_iterations; i++) {
+			Variant::evaluate(Variant::OP_ADD, a, b, r, valid);
+			sink += int(r);
+		}
+	}
+};
+
+class BenchVariantMulVector3 : public Benchmark {
+public:
+	virtual const char *get_name() const { return "variant/mul_vector3_real"; }
+
+	virtual void run(int p_iterations) {
+
+		Variant a = Vector3(1, 2, 3);
+		Variant b = 0.5;
+		Variant r;
+		bool valid;
+		for (int i = 0; i < p_iterations; i++) {
+			Variant::evaluate(Variant::OP_MULTIPLY, a, b, r, valid);
+			sink += valid;
+		}
+	}
+};
+
+class BenchVariantCallBuiltin : public Benchmark {
+public:
+	virtual const char *get_name() const { return "variant/call_builtin"; }
+
+	virtual void run(int p_iterations) {
+
+		Variant v = Vector3(1, 2, 3);
+		StringName method = "normalized";
+		Variant::CallError ce;
+		for (int i = 0; i < p_iterations; i++) {
+			Variant r = v.call(method, NULL, 0, ce);
+			sink += ce.error;
+		}
+	}
+};
+
+class BenchVariantArray : public Benchmark {
+public:
+	virtual const char *get_name() const { return "variant/array_push_4"; }
+
+	virtual void run(int p_iterations) {
+
+		Variant s = "text";
+		for (int i = 0; i < p_iterations; i++) {
+			Array a;
+			a.push_back(i);
+			a.push_back(0.5);
+			a.push_back(s);
+			a.push_back(Vector2());
+			sink += a.size();
+		}
+	}
+};
+
+/* String */
+
+class BenchStringUTF8 : public Benchmark {
+
+	String text;
+
+public:
+	virtual const char *get_name() const { return "string/utf8_roundtrip_1k"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < 1024; i++) {
+			text += CharType('a' + i % 26);
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			CharString utf8 = text.utf8();
+			String back = String::utf8(utf8.get_data(), utf8.length());
+			sink += back.length();
+		}
+	}
+
+	virtual void teardown() { text = String(); }
+};
+
+class BenchStringFind : public Benchmark {
+
+	String text;
+
+public:
+	virtual const char *get_name() const { return "string/find_4k"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < 4096; i++) {
+			text += CharType('a' + i % 7);
+		}
+		text += "needle";
+	}
+
+	virtual void run(int p_iterations) {
+
+		String needle = "needle";
+		for (int i = 0; i < p_iterations; i++) {
+			sink += text.find(needle);
+		}
+	}
+
+	virtual void teardown() { text = String(); }
+};
+
+class BenchStringSplit : public Benchmark {
+
+	String text;
+
+public:
+	virtual const char *get_name() const { return "string/split_64"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < 64; i++) {
+			text += itos(i) + ",";
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			sink += text.split(",").size();
+		}
+	}
+
+	virtual void teardown() { text = String(); }
+};
+
+class BenchStringHash : public Benchmark {
+
+	String text;
+
+public:
+	virtual const char *get_name() const { return "string/hash_64"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < 64; i++) {
+			text += CharType('a' + i % 26);
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			sink += text.hash();
+		}
+	}
+
+	virtual void teardown() { text = String(); }
+};
+
+/* Containers, lookups in 10k int keys */
+
+enum {
+	CONTAINER_KEYS = 10000
+};
+
+class BenchHashMapLookup : public Benchmark {
+
+	HashMap<int, int> map;
+
+public:
+	virtual const char *get_name() const { return "container/hash_map_lookup"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < CONTAINER_KEYS; i++) {
+			map.set(i * 7, i);
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			const int *v = map.getptr((i % CONTAINER_KEYS) * 7);
+			sink += v ? *v : 0;
+		}
+	}
+
+	virtual void teardown() { map.clear(); }
+};
+
+class BenchOAHashMapLookup : public Benchmark {
+
+	OAHashMap<int, int> map;
+
+public:
+	virtual const char *get_name() const { return "container/oa_hash_map_lookup"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < CONTAINER_KEYS; i++) {
+			map.set(i * 7, i);
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			const int *v = map.lookup_ptr((i % CONTAINER_KEYS) * 7);
+			sink += v ? *v : 0;
+		}
+	}
+
+	virtual void teardown() { map.clear(); }
+};
+
+class BenchMapLookup : public Benchmark {
+
+	Map<int, int> map;
+
+public:
+	virtual const char *get_name() const { return "container/map_lookup"; }
+
+	virtual void setup() {
+
+		for (int i = 0; i < CONTAINER_KEYS; i++) {
+			map[i * 7] = i;
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			const Map<int, int>::Element *E = map.find((i % CONTAINER_KEYS) * 7);
+			sink += E ? E->get() : 0;
+		}
+	}
+
+	virtual void teardown() { map.clear(); }
+};
+
+class BenchVectorPushBack : public Benchmark {
+public:
+	virtual const char *get_name() const { return "container/vector_push_back"; }
+
+	virtual void run(int p_iterations) {
+
+		Vector<int> v;
+		for (int i = 0; i < p_iterations; i++) {
+			if (v.size() == CONTAINER_KEYS) {
+				v.clear();
+			}
+			v.push_back(i);
+		}
+		sink += v.size();
+	}
+};
+
+/* Object */
+
+class BenchObjectCall : public Benchmark {
+
+	Object *object;
+
+public:
+	virtual const char *get_name() const { return "object/call"; }
+
+	virtual void setup() { object = memnew(Object); }
+
+	virtual void run(int p_iterations) {
+
+		StringName method = "get_instance_id";
+		for (int i = 0; i < p_iterations; i++) {
+			Variant r = object->call(method);
+			sink += int(r);
+		}
+	}
+
+	virtual void teardown() { memdelete(object); }
+};
+
+class BenchObjectEmitSignal : public Benchmark {
+
+	Object *emitter;
+	Object *receiver;
+
+public:
+	virtual const char *get_name() const { return "object/emit_signal"; }
+
+	virtual void setup() {
+
+		emitter = memnew(Object);
+		receiver = memnew(Object);
+		emitter->add_user_signal(MethodInfo("benchmark"));
+		emitter->connect("benchmark", receiver, "get_instance_id");
+	}
+
+	virtual void run(int p_iterations) {
+
+		StringName signal = "benchmark";
+		for (int i = 0; i < p_iterations; i++) {
+			emitter->emit_signal(signal);
+		}
+	}
+
+	virtual void teardown() {
+
+		memdelete(emitter);
+		memdelete(receiver);
+	}
+};
+
+/* Resources */
+
+class BenchResourceLoadText : public Benchmark {
+
+	String path;
+
+public:
+	virtual const char *get_name() const { return "resource/load_tres_curve_256"; }
+
+	virtual void setup() {
+
+		Ref<Curve> curve;
+		curve.instance();
+		for (int i = 0; i < 256; i++) {
+			curve->add_point(Vector2(i / 256.0, Math::randf()));
+		}
+
+		path = "user://benchmark_curve.tres";
+		ResourceSaver::save(path, curve);
+	}
+
+	virtual void run(int p_iterations) {
+
+		for (int i = 0; i < p_iterations; i++) {
+			RES res = ResourceLoader::load(path, "", true);
+			sink += res.is_valid();
+		}
+	}
+
+	virtual void teardown() {
+
+		DirAccess *da = DirAccess::create_for_path(path);
+		if (da) {
+			da->remove(path);
+			memdelete(da);
+		}
+	}
+};
+
+/* Physics, one step of 100 boxes falling on a plane */
+
+class BenchPhysicsStep : public Benchmark {
+
+	RID space;
+	RID plane_shape;
+	RID box_shape;
+	RID ground;
+	Vector<RID> bodies;
+
+public:
+	virtual const char *get_name() const { return "physics/step_100_boxes"; }
+
+	virtual void setup() {
+
+		PhysicsServer *ps = PhysicsServer::get_singleton();
+
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+
+		plane_shape = ps->shape_create(PhysicsServer::SHAPE_PLANE);
+		ps->shape_set_data(plane_shape, Plane(Vector3(0, 1, 0), 0));
+		box_shape = ps->shape_create(PhysicsServer::SHAPE_BOX);
+		ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+		ground = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+		ps->body_set_space(ground, space);
+		ps->body_add_shape(ground, plane_shape);
+
+		for (int i = 0; i < 100; i++) {
+			RID body = ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+			ps->body_set_space(body, space);
+			ps->body_add_shape(body, box_shape);
+			ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3((i % 10) * 1.2, 1 + (i / 10) * 1.2, 0)));
+			bodies.push_back(body);
+		}
+	}
+
+	virtual void run(int p_iterations) {
+
+		PhysicsServer *ps = PhysicsServer::get_singleton();
+		for (int i = 0; i < p_iterations; i++) {
+			ps->sync();
+			ps->flush_queries();
+			ps->step(1.0 / 60.0);
+		}
+	}
+
+	virtual void teardown() {
+
+		PhysicsServer *ps = PhysicsServer::get_singleton();
+		for (int i = 0; i < bodies.size(); i++) {
+			ps->free(bodies[i]);
+		}
+		bodies.clear();
+		ps->free(ground);
+		ps->free(box_shape);
+		ps->free(plane_shape);
+		ps->free(space);
+	}
+};
+
+/* Culling, one frustum query against 10k instances in the octree the scene uses */
+
+class BenchOctreeCull : public Benchmark {
+
+	Octree<int, true> *octree;
+	Vector<int> ids;
+	Vector<Plane> planes;
+
+public:
+	virtual const char *get_name() const { return "culling/octree_frustum_10k"; }
+
+	virtual void setup() {
+
+		octree = memnew((Octree<int, true>));
+		ids.resize(10000);
+		for (int i = 0; i < ids.size(); i++) {
+			ids.write[i] = i;
+			Vector3 pos(Math::random(-500.0, 500.0), Math::random(-20.0, 20.0), Math::random(-500.0, 500.0));
+			octree->create(&ids.write[i], AABB(pos, Vector3(1, 1, 1)));
+		}
+
+		CameraMatrix cm;
+		cm.set_perspective(70, 16.0 / 9.0, 0.1, 200);
+		planes = cm.get_projection_planes(Transform());
+	}
+
+	virtual void run(int p_iterations) {
+
+		int *result[1024];
+		for (int i = 0; i < p_iterations; i++) {
+			sink += octree->cull_convex(planes, result, 1024);
+		}
+	}
+
+	virtual void teardown() {
+
+		memdelete(octree);
+		ids.clear();
+	}
+};
+
+/* Canvas, submitting 1000 rects to a canvas item */
+
+class BenchCanvasSubmit : public Benchmark {
+
+	RID canvas;
+	RID item;
+
+public:
+	virtual const char *get_name() const { return "canvas/submit_1000_rects"; }
+
+	virtual void setup() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+		canvas = vs->canvas_create();
+		item = vs->canvas_item_create();
+		vs->canvas_item_set_parent(item, canvas);
+	}
+
+	virtual void run(int p_iterations) {
+
+		VisualServer *vs = VisualServer::get_singleton();
+		for (int i = 0; i < p_iterations; i++) {
+			vs->canvas_item_clear(item);
+			for (int j = 0; j < 1000; j++) {
+				vs->canvas_item_add_rect(item, Rect2((j % 40) * 10, (j / 40) * 10, 8, 8), Color(1, 1, 1));
+			}
+		}
+		vs->sync();
+	}
+
+	virtual void teardown() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+		vs->free(item);
+		vs->free(canvas);
+	}
+};
+
+static Vector<Benchmark *> _create_benchmarks() {
+
+	Vector<Benchmark *> benchmarks;
+
+	benchmarks.push_back(memnew(BenchVariantAddInt));
+	benchmarks.push_back(memnew(BenchVariantMulVector3));
+	benchmarks.push_back(memnew(BenchVariantCallBuiltin));
+	benchmarks.push_back(memnew(BenchVariantArray));
+	benchmarks.push_back(memnew(BenchStringUTF8));
+	benchmarks.push_back(memnew(BenchStringFind));
+	benchmarks.push_back(memnew(BenchStringSplit));
+	benchmarks.push_back(memnew(BenchStringHash));
+	benchmarks.push_back(memnew(BenchHashMapLookup));
+	benchmarks.push_back(memnew(BenchOAHashMapLookup));
+	benchmarks.push_back(memnew(BenchMapLookup));
+	benchmarks.push_back(memnew(BenchVectorPushBack));
+	benchmarks.push_back(memnew(BenchObjectCall));
+	benchmarks.push_back(memnew(BenchObjectEmitSignal));
+	benchmarks.push_back(memnew(BenchResourceLoadText));
+	benchmarks.push_back(memnew(BenchPhysicsStep));
+	benchmarks.push_back(memnew(BenchOctreeCull));
+	benchmarks.push_back(memnew(BenchCanvasSubmit));
+
+	return benchmarks;
+}
+
+struct Result {
+
+	String name;
+	int warmup_iterations;
+	int iterations;
+	int samples;
+	double ns_per_op;
+	double min_ns_per_op;
+};
+
+static uint64_t _time_batch(Benchmark *p_benchmark, int p_iterations) {
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	p_benchmark->run(p_iterations);
+	return OS::get_singleton()->get_ticks_usec() - from;
+}
+
+static Result _measure(Benchmark *p_benchmark, int p_samples, uint64_t p_batch_usec) {
+
+	Result result;
+	result.name = p_benchmark->get_name();
+	result.warmup_iterations = 0;
+	result.samples = p_samples;
+
+	// warm up, doubling the batch until it takes long enough to time reliably
+	int iterations = 1;
+	while (true) {
+		uint64_t usec = _time_batch(p_benchmark, iterations);
+		result.warmup_iterations += iterations;
+		if (usec >= p_batch_usec || iterations >= (1 << 28))
+			break;
+		iterations *= 2;
+	}
+
+	double total = 0;
+	double best = 0;
+	for (int i = 0; i < p_samples; i++) {
+		double ns = _time_batch(p_benchmark, iterations) * 1000.0 / iterations;
+		total += ns;
+		if (i == 0 || ns < best)
+			best = ns;
+	}
+
+	result.iterations = iterations * p_samples;
+	result.ns_per_op = total / p_samples;
+	result.min_ns_per_op = best;
+
+	return result;
+}
+
+static String _get_arg(const List<String> &p_args, const String &p_name, const String &p_default) {
+
+	for (const List<String>::Element *E = p_args.front(); E; E = E->next()) {
+		if (E->get() == p_name && E->next()) {
+			return E->next()->get();
+		}
+	}
+	return p_default;
+}
+
+MainLoop *test(const List<String> &p_args) {
+
+	String filter = _get_arg(p_args, "--benchmark-filter", "*");
+	String json_path = _get_arg(p_args, "--benchmark-json", "");
+	int samples = MAX(1, _get_arg(p_args, "--benchmark-samples", "5").to_int());
+	uint64_t batch_usec = MAX(1, _get_arg(p_args, "--benchmark-batch-msec", "20").to_int()) * 1000;
+
+	Vector<Benchmark *> benchmarks = _create_benchmarks();
+	Array results;
+
+	OS::get_singleton()->print("%-32s %12s %12s %12s\n", "benchmark", "iterations", "ns/op", "min ns/op");
+
+	for (int i = 0; i < benchmarks.size(); i++) {
+
+		Benchmark *benchmark = benchmarks[i];
+		if (!String(benchmark->get_name()).match(filter)) {
+			continue;
+		}
+
+		benchmark->setup();
+		Result result = _measure(benchmark, samples, batch_usec);
+		benchmark->teardown();
+
+		OS::get_singleton()->print("%-32s %12d %12.1f %12.1f\n", result.name.utf8().get_data(), result.iterations, result.ns_per_op, result.min_ns_per_op);
+
+		Dictionary d;
+		d["name"] = result.name;
+		d["warmup_iterations"] = result.warmup_iterations;
+		d["iterations"] = result.iterations;
+		d["samples"] = result.samples;
+		d["ns_per_op"] = result.ns_per_op;
+		d["min_ns_per_op"] = result.min_ns_per_op;
+		results.push_back(d);
+	}
+
+	for (int i = 0; i < benchmarks.size(); i++) {
+		memdelete(benchmarks[i]);
+	}
+
+	if (json_path != "") {
+
+		Dictionary report;
+		report["engine"] = Engine::get_singleton()->get_version_info()["string"];
+		report["os"] = OS::get_singleton()->get_name();
+		report["processors"] = OS::get_singleton()->get_processor_count();
+		report["benchmarks"] = results;
+
+		FileAccess *f = FileAccess::open(json_path, FileAccess::WRITE);
+		if (f) {
+			f->store_string(JSON::print(report, "\t", false));
+			f->store_8('\n');
+			memdelete(f);
+			OS::get_singleton()->print("results written to %s\n", json_path.utf8().get_data());
+		} else {
+			OS::get_singleton()->printerr("can't write benchmark results to %s\n", json_path.utf8().get_data());
+		}
+	}
+
+	return NULL;
+}
+} // namespace TestBenchmark
@@ -30,40 +30,175 @@
 
 #include "test_image.h"
 
-#include "io/image_loader.h"
-#include "math_funcs.h"
-#include "os/main_loop.h"
-#include "print_string.h"
+#include "core/image.h"
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
 
 namespace TestImage {
 
-class TestMainLoop : public MainLoop {
+enum {
+	SRC_SIZE = 1024,
+	DST_WIDTH = 777,
+	DST_HEIGHT = 555,
+	ITERATIONS = 20
+};
+
+// RGBA8 bilinear scale done the way Image::resize used to do it, one channel at a time
+static void scale_bilinear_reference(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+
+	enum {
+		CC = 4,
+		FRAC_BITS = 8,
+		FRAC_LEN = (1 << FRAC_BITS),
+		FRAC_MASK = FRAC_LEN - 1
+	};
+
+	for (uint32_t i = 0; i < p_dst_height; i++) {
+
+		uint32_t src_yofs_up_fp = (i * p_src_height * FRAC_LEN / p_dst_height);
+		uint32_t src_yofs_frac = src_yofs_up_fp & FRAC_MASK;
+		uint32_t src_yofs_up = src_yofs_up_fp >> FRAC_BITS;
+
+		uint32_t src_yofs_down = (i + 1) * p_src_height / p_dst_height;
+		if (src_yofs_down >= p_src_height)
+			src_yofs_down = p_src_height - 1;
+
+		uint32_t y_ofs_up = src_yofs_up * p_src_width * CC;
+		uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
+
+		for (uint32_t j = 0; j < p_dst_width; j++) {
+
+			uint32_t src_xofs_left_fp = (j * p_src_width * FRAC_LEN / p_dst_width);
+			uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
+			uint32_t src_xofs_left = (src_xofs_left_fp >> FRAC_BITS) * CC;
+			uint32_t src_xofs_right = (j + 1) * p_src_width / p_dst_width;
+			if (src_xofs_right >= p_src_width)
+				src_xofs_right = p_src_width - 1;
+			src_xofs_right *= CC;
+
+			for (uint32_t l = 0; l < CC; l++) {
+
+				uint32_t p00 = p_src[y_ofs_up + src_xofs_left + l] << FRAC_BITS;
+				uint32_t p10 = p_src[y_ofs_up + src_xofs_right + l] << FRAC_BITS;
+				uint32_t p01 = p_src[y_ofs_down + src_xofs_left + l] << FRAC_BITS;
+				uint32_t p11 = p_src[y_ofs_down + src_xofs_right + l] << FRAC_BITS;
+
+				uint32_t interp_up = p00 + (((p10 - p00) * src_xofs_frac) >> FRAC_BITS);
+				uint32_t interp_down = p01 + (((p11 - p01) * src_xofs_frac) >> FRAC_BITS);
+				uint32_t interp = interp_up + (((interp_down - interp_up) * src_yofs_frac) >> FRAC_BITS);
+				interp >>= FRAC_BITS;
+				p_dst[i * p_dst_width * CC + j * CC + l] = interp;
+			}
+		}
+	}
+}
+
+// RGBA8 2x2 box filter, as the first generated mipmap level used to be computed
+static void mipmap_reference(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_width, uint32_t p_height) {
+
+	uint32_t dst_w = p_width >> 1;
+	uint32_t dst_h = p_height >> 1;
+
+	for (uint32_t i = 0; i < dst_h; i++) {
+
+		const uint8_t *rup_ptr = &p_src[i * 2 * p_width * 4];
+		const uint8_t *rdown_ptr = rup_ptr + p_width * 4;
+		uint8_t *dst_ptr = &p_dst[i * dst_w * 4];
+
+		for (uint32_t j = 0; j < dst_w; j++) {
+
+			for (int l = 0; l < 4; l++) {
+				dst_ptr[l] = (uint16_t(rup_ptr[l]) + uint16_t(rup_ptr[l + 4]) + uint16_t(rdown_ptr[l]) + uint16_t(rdown_ptr[l + 4])) >> 2;
+			}
 
-	bool quit;
+			dst_ptr += 4;
+			rup_ptr += 8;
+			rdown_ptr += 8;
+		}
+	}
+}
+
+static int max_difference(const uint8_t *p_a, const uint8_t *p_b, int p_len) {
+
+	int max_diff = 0;
+	for (int i = 0; i < p_len; i++) {
+		max_diff = MAX(max_diff, ABS(int(p_a[i]) - int(p_b[i])));
+	}
+	return max_diff;
+}
+
+MainLoop *test() {
 
-public:
-	virtual void input_event(const Ref<InputEvent> &p_event) {
+	OS::get_singleton()->print("\n\nImage benchmark: %dx%d RGBA8, bilinear scale to %dx%d and mipmap generation\n", SRC_SIZE, SRC_SIZE, DST_WIDTH, DST_HEIGHT);
+
+	PoolVector<uint8_t> src_data;
+	src_data.resize(SRC_SIZE * SRC_SIZE * 4);
+	{
+		PoolVector<uint8_t>::Write w = src_data.write();
+		for (int i = 0; i < src_data.size(); i++) {
+			w[i] = Math::rand() & 0xFF;
+		}
 	}
 
-	virtual void init() {
+	Vector<uint8_t> reference;
+
+	// bilinear scaling
 
-		quit = false;
+	reference.resize(DST_WIDTH * DST_HEIGHT * 4);
+	scale_bilinear_reference(src_data.read().ptr(), reference.ptrw(), SRC_SIZE, SRC_SIZE, DST_WIDTH, DST_HEIGHT);
+
+	Ref<Image> img;
+	img.instance();
+	img->create(SRC_SIZE, SRC_SIZE, false, Image::FORMAT_RGBA8, src_data);
+	img->resize(DST_WIDTH, DST_HEIGHT, Image::INTERPOLATE_BILINEAR);
+
+	int max_diff = max_difference(reference.ptr(), img->get_data().read().ptr(), reference.size());
+	OS::get_singleton()->print("resize max difference: %d %s\n", max_diff, max_diff == 0 ? "OK" : "FAIL");
+
+	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		scale_bilinear_reference(src_data.read().ptr(), reference.ptrw(), SRC_SIZE, SRC_SIZE, DST_WIDTH, DST_HEIGHT);
 	}
-	virtual bool iteration(float p_time) {
+	uint64_t reference_usec = MAX(OS::get_singleton()->get_ticks_usec() - ticks, 1);
 
-		return quit;
+	ticks = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		img->create(SRC_SIZE, SRC_SIZE, false, Image::FORMAT_RGBA8, src_data);
+		img->resize(DST_WIDTH, DST_HEIGHT, Image::INTERPOLATE_BILINEAR);
 	}
+	uint64_t optimized_usec = MAX(OS::get_singleton()->get_ticks_usec() - ticks, 1);
+
+	OS::get_singleton()->print("resize reference: %f ms\n", double(reference_usec) / (ITERATIONS * 1000.0));
+	OS::get_singleton()->print("resize optimized: %f ms\n", double(optimized_usec) / (ITERATIONS * 1000.0));
+
+	// mipmap generation, only the first level is compared
 
-	virtual bool idle(float p_time) {
-		return quit;
+	reference.resize((SRC_SIZE / 2) * (SRC_SIZE / 2) * 4);
+	mipmap_reference(src_data.read().ptr(), reference.ptrw(), SRC_SIZE, SRC_SIZE);
+
+	img->create(SRC_SIZE, SRC_SIZE, false, Image::FORMAT_RGBA8, src_data);
+	img->generate_mipmaps();
+
+	max_diff = max_difference(reference.ptr(), img->get_data().read().ptr() + img->get_mipmap_offset(1), reference.size());
+	OS::get_singleton()->print("mipmap max difference: %d %s\n", max_diff, max_diff == 0 ? "OK" : "FAIL");
+
+	ticks = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		mipmap_reference(src_data.read().ptr(), reference.ptrw(), SRC_SIZE, SRC_SIZE);
 	}
+	reference_usec = MAX(OS::get_singleton()->get_ticks_usec() - ticks, 1);
 
-	virtual void finish() {
+	ticks = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		img->create(SRC_SIZE, SRC_SIZE, false, Image::FORMAT_RGBA8, src_data);
+		img->generate_mipmaps();
 	}
-};
+	optimized_usec = MAX(OS::get_singleton()->get_ticks_usec() - ticks, 1);
 
-MainLoop *test() {
+	// the optimized timing includes the smaller levels, the reference only computes the first one
+	OS::get_singleton()->print("mipmap reference (first level): %f ms\n", double(reference_usec) / (ITERATIONS * 1000.0));
+	OS::get_singleton()->print("mipmap optimized (full chain): %f ms\n", double(optimized_usec) / (ITERATIONS * 1000.0));
 
-	return memnew(TestMainLoop);
+	return NULL;
 }
 } // namespace TestImage
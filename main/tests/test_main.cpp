@@ -33,6 +33,8 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_audio_mix.h"
+#include "test_benchmark.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
 #include "test_image.h"
@@ -53,6 +55,7 @@ const char **tests_get_names() {
 		"math",
 		"physics",
 		"physics_2d",
+		"physics_2d_bench",
 		"render",
 		"oa_hash_map",
 		"gui",
@@ -64,6 +67,8 @@ const char **tests_get_names() {
 		"gd_bytecode",
 		"image",
 		"ordered_hash_map",
+		"audio_mix",
+		"benchmark",
 		NULL
 	};
 
@@ -92,6 +97,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_bench") {
+
+		return TestPhysics2D::test_bench();
+	}
+
 	if (p_test == "render") {
 
 		return TestRender::test();
@@ -149,6 +159,16 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestOrderedHashMap::test();
 	}
 
+	if (p_test == "audio_mix") {
+
+		return TestAudioMix::test();
+	}
+
+	if (p_test == "benchmark") {
+
+		return TestBenchmark::test(p_args);
+	}
+
 	return NULL;
 }
 
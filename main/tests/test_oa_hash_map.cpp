@@ -32,6 +32,8 @@
 
 #include "core/os/os.h"
 
+#include "core/hash_map.h"
+#include "core/map.h"
 #include "core/oa_hash_map.h"
 
 namespace TestOAHashMap {
@@ -79,6 +81,29 @@ MainLoop *test() {
 		OS::get_singleton()->print("elements %d == %d.\n", map.get_num_elements(), num_elems);
 	}
 
+	// insertion and deletion churn, like ids that keep growing
+	{
+		OAHashMap<uint32_t, int> map;
+
+		uint32_t next_key = 0;
+		for (int i = 0; i < 10000; i++) {
+			map.set(next_key, i);
+			if (next_key >= 32) {
+				map.remove(next_key - 32);
+			}
+			next_key++;
+		}
+
+		uint32_t num_elems = 0;
+		for (uint32_t i = next_key - 32; i < next_key; i++) {
+			int tmp;
+			if (map.lookup(i, tmp) && tmp == (int)i)
+				num_elems++;
+		}
+
+		OS::get_singleton()->print("elements %d == %d, capacity %d.\n", map.get_num_elements(), num_elems, map.get_capacity());
+	}
+
 	// iteration
 	{
 		OAHashMap<String, int> map;
@@ -92,6 +117,78 @@ MainLoop *test() {
 		}
 	}
 
+	// copies are independent
+	{
+		OAHashMap<String, int> map;
+		map.set("Hello", 1);
+
+		OAHashMap<String, int> copy = map;
+		copy.set("Hello", 2);
+		copy.set("World", 3);
+
+		int a = 0, b = 0;
+		map.lookup("Hello", a);
+		copy.lookup("Hello", b);
+
+		OS::get_singleton()->print("copy: %d %d, elements %d %d\n", a, b, map.get_num_elements(), copy.get_num_elements());
+	}
+
+	// compare with HashMap and Map, keys are strided like packed coordinates
+	{
+		const int count = 100000;
+		const int stride = 1024;
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		{
+			OAHashMap<int, int> map;
+			for (int i = 0; i < count; i++) {
+				map.set(i * stride, i);
+			}
+			int found = 0;
+			for (int i = 0; i < count; i++) {
+				int *v = map.lookup_ptr(i * stride);
+				found += v ? 1 : 0;
+			}
+			for (int i = 0; i < count; i++) {
+				map.remove(i * stride);
+			}
+			OS::get_singleton()->print("OAHashMap: %d found, %d usec\n", found, int(OS::get_singleton()->get_ticks_usec() - t));
+		}
+
+		t = OS::get_singleton()->get_ticks_usec();
+		{
+			HashMap<int, int> map;
+			for (int i = 0; i < count; i++) {
+				map.set(i * stride, i);
+			}
+			int found = 0;
+			for (int i = 0; i < count; i++) {
+				int *v = map.getptr(i * stride);
+				found += v ? 1 : 0;
+			}
+			for (int i = 0; i < count; i++) {
+				map.erase(i * stride);
+			}
+			OS::get_singleton()->print("HashMap: %d found, %d usec\n", found, int(OS::get_singleton()->get_ticks_usec() - t));
+		}
+
+		t = OS::get_singleton()->get_ticks_usec();
+		{
+			Map<int, int> map;
+			for (int i = 0; i < count; i++) {
+				map[i * stride] = i;
+			}
+			int found = 0;
+			for (int i = 0; i < count; i++) {
+				found += map.has(i * stride) ? 1 : 0;
+			}
+			for (int i = 0; i < count; i++) {
+				map.erase(i * stride);
+			}
+			OS::get_singleton()->print("Map: %d found, %d usec\n", found, int(OS::get_singleton()->get_ticks_usec() - t));
+		}
+	}
+
 	return NULL;
 }
 } // namespace TestOAHashMap
@@ -192,7 +192,7 @@ protected:
 		PhysicsServer *ps = PhysicsServer::get_singleton();
 		RID trimesh_shape = ps->shape_create(PhysicsServer::SHAPE_CONCAVE_POLYGON);
 		ps->shape_set_data(trimesh_shape, p_faces);
-		p_faces = ps->shape_get_data(trimesh_shape); // optimized one
+		p_faces = Dictionary(ps->shape_get_data(trimesh_shape))["faces"]; // optimized one
 		Vector<Vector3> normals; // for drawing
 		for (int i = 0; i < p_faces.size() / 3; i++) {
 
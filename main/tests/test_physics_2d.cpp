@@ -426,10 +426,116 @@ public:
 	TestPhysics2DMainLoop() {}
 };
 
+class TestPhysics2DBenchMainLoop : public MainLoop {
+
+	GDCLASS(TestPhysics2DBenchMainLoop, MainLoop);
+
+	enum {
+		BODY_COUNT = 10000,
+		REPORT_FRAMES = 60,
+	};
+
+	RID space;
+	RID circle_shape;
+
+	uint64_t step_begin;
+	uint64_t step_usec;
+	int frames;
+
+	void _add_wall(const Vector2 &p_normal, real_t p_d) {
+
+		Physics2DServer *ps = Physics2DServer::get_singleton();
+
+		Array arr;
+		arr.push_back(p_normal);
+		arr.push_back(p_d);
+
+		RID plane = ps->line_shape_create();
+		ps->shape_set_data(plane, arr);
+
+		RID plane_body = ps->body_create();
+		ps->body_set_mode(plane_body, Physics2DServer::BODY_MODE_STATIC);
+		ps->body_set_space(plane_body, space);
+		ps->body_add_shape(plane_body, plane);
+	}
+
+public:
+	virtual void init() {
+
+		Physics2DServer *ps = Physics2DServer::get_singleton();
+
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+		ps->set_active(true);
+		ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY, 0);
+
+		circle_shape = ps->circle_shape_create();
+		ps->shape_set_data(circle_shape, 4);
+
+		// many small bodies moving around a closed box, so the broadphase is busy every step
+		const real_t size = 4000;
+
+		_add_wall(Vector2(0, 1), 0);
+		_add_wall(Vector2(1, 0), 0);
+		_add_wall(Vector2(0, -1), -size);
+		_add_wall(Vector2(-1, 0), -size);
+
+		for (int i = 0; i < BODY_COUNT; i++) {
+
+			RID body = ps->body_create();
+			ps->body_add_shape(body, circle_shape);
+			ps->body_set_space(body, space);
+			ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Point2(Math::randf() * size, Math::randf() * size)));
+			ps->body_set_state(body, Physics2DServer::BODY_STATE_LINEAR_VELOCITY, Vector2(Math::randf() - 0.5, Math::randf() - 0.5) * 200);
+		}
+
+		step_begin = 0;
+		step_usec = 0;
+		frames = 0;
+	}
+
+	virtual bool iteration(float p_time) {
+
+		// the physics step runs right after this returns
+		step_begin = OS::get_singleton()->get_ticks_usec();
+		return false;
+	}
+
+	virtual bool idle(float p_time) {
+
+		if (step_begin == 0)
+			return false;
+
+		step_usec += OS::get_singleton()->get_ticks_usec() - step_begin;
+		step_begin = 0;
+		frames++;
+
+		if (frames == REPORT_FRAMES) {
+
+			int pairs = Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_COLLISION_PAIRS);
+			print_line("bodies: " + itos(BODY_COUNT) + " step: " + rtos(step_usec / (double)frames / 1000.0) + " msec, pairs: " + itos(pairs));
+			step_usec = 0;
+			frames = 0;
+		}
+
+		return false;
+	}
+
+	virtual void finish() {
+	}
+
+	TestPhysics2DBenchMainLoop() {}
+};
+
 namespace TestPhysics2D {
 
 MainLoop *test() {
 
 	return memnew(TestPhysics2DMainLoop);
 }
+
+MainLoop *test_bench() {
+
+	return memnew(TestPhysics2DBenchMainLoop);
+}
 } // namespace TestPhysics2D
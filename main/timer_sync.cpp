@@ -175,6 +175,9 @@ MainFrameTime MainTimerSync::advance_checked(float p_frame_slice, int p_iteratio
 	// restore time_accum
 	time_accum = ret.idle_step - idle_minus_accum;
 
+	// what is left in time_accum is how far we are into the next physics tick
+	ret.interpolation_fraction = CLAMP(time_accum / p_frame_slice, 0.0f, 1.0f);
+
 	// track deficit
 	time_deficit = p_idle_step - ret.idle_step;
 
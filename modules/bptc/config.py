@@ -0,0 +1,5 @@
+def can_build(env, platform):
+    return env['tools']
+
+def configure(env):
+    pass
@@ -0,0 +1,774 @@
+/*************************************************************************/
+/*  image_compress_bptc.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "image_compress_bptc.h"
+
+#include "math_funcs.h"
+#include "os/copymem.h"
+#include "os/worker_thread_pool.h"
+#include "print_string.h"
+
+/*
+	BC7 blocks are written in mode 6 (one subset, RGBA endpoints with a p-bit each, 4 bit indices)
+	and BC6H blocks in mode 11 (one region, 10 bit unsigned endpoints, 4 bit indices). Endpoints come
+	from the principal axis of the block and are refined with least squares, which already beats DXT5
+	for color and RGBE for HDR. The decompressor only understands the modes written here.
+*/
+
+static const int bptc_weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct BPTCBitWriter {
+
+	uint8_t *data;
+	int pos;
+
+	void write(uint32_t p_value, int p_bits) {
+
+		for (int i = 0; i < p_bits; i++) {
+			if (p_value & (1 << i)) {
+				data[pos >> 3] |= 1 << (pos & 7);
+			}
+			pos++;
+		}
+	}
+};
+
+struct BPTCBitReader {
+
+	const uint8_t *data;
+	int pos;
+
+	uint32_t read(int p_bits) {
+
+		uint32_t value = 0;
+		for (int i = 0; i < p_bits; i++) {
+			if (data[pos >> 3] & (1 << (pos & 7))) {
+				value |= 1 << i;
+			}
+			pos++;
+		}
+		return value;
+	}
+};
+
+//endpoints are the extremes of the block projected on its principal axis
+static void _fit_endpoints(const float p_pixels[16][4], int p_channels, float r_e0[4], float r_e1[4]) {
+
+	float mean[4] = { 0, 0, 0, 0 };
+	float min[4] = { 1e20, 1e20, 1e20, 1e20 };
+	float max[4] = { -1e20, -1e20, -1e20, -1e20 };
+
+	for (int i = 0; i < 16; i++) {
+		for (int c = 0; c < p_channels; c++) {
+			mean[c] += p_pixels[i][c];
+			min[c] = MIN(min[c], p_pixels[i][c]);
+			max[c] = MAX(max[c], p_pixels[i][c]);
+		}
+	}
+
+	for (int c = 0; c < p_channels; c++) {
+		mean[c] /= 16.0;
+	}
+
+	float cov[4][4];
+	zeromem(cov, sizeof(cov));
+
+	for (int i = 0; i < 16; i++) {
+		for (int a = 0; a < p_channels; a++) {
+			for (int b = 0; b < p_channels; b++) {
+				cov[a][b] += (p_pixels[i][a] - mean[a]) * (p_pixels[i][b] - mean[b]);
+			}
+		}
+	}
+
+	float axis[4];
+	for (int c = 0; c < p_channels; c++) {
+		axis[c] = max[c] - min[c];
+	}
+
+	//power iteration, starting from the bounding box diagonal
+	for (int k = 0; k < 8; k++) {
+
+		float next[4];
+		float len = 0;
+		for (int a = 0; a < p_channels; a++) {
+			next[a] = 0;
+			for (int b = 0; b < p_channels; b++) {
+				next[a] += cov[a][b] * axis[b];
+			}
+			len = MAX(len, ABS(next[a]));
+		}
+
+		if (len < CMP_EPSILON)
+			break;
+
+		for (int a = 0; a < p_channels; a++) {
+			axis[a] = next[a] / len;
+		}
+	}
+
+	float axis_len = 0;
+	for (int c = 0; c < p_channels; c++) {
+		axis_len += axis[c] * axis[c];
+	}
+
+	if (axis_len < CMP_EPSILON) {
+		for (int c = 0; c < p_channels; c++) {
+			r_e0[c] = mean[c];
+			r_e1[c] = mean[c];
+		}
+		return;
+	}
+
+	float tmin = 1e20;
+	float tmax = -1e20;
+
+	for (int i = 0; i < 16; i++) {
+		float t = 0;
+		for (int c = 0; c < p_channels; c++) {
+			t += (p_pixels[i][c] - mean[c]) * axis[c];
+		}
+		t /= axis_len;
+		tmin = MIN(tmin, t);
+		tmax = MAX(tmax, t);
+	}
+
+	for (int c = 0; c < p_channels; c++) {
+		r_e0[c] = mean[c] + axis[c] * tmin;
+		r_e1[c] = mean[c] + axis[c] * tmax;
+	}
+}
+
+//least squares endpoints for the chosen indices
+static void _refine_endpoints(const float p_pixels[16][4], int p_channels, const uint8_t p_indices[16], float r_e0[4], float r_e1[4]) {
+
+	float a = 0, b = 0, c = 0;
+	float x0[4] = { 0, 0, 0, 0 };
+	float x1[4] = { 0, 0, 0, 0 };
+
+	for (int i = 0; i < 16; i++) {
+
+		float w = bptc_weights4[p_indices[i]] / 64.0;
+		float iw = 1.0 - w;
+
+		a += iw * iw;
+		b += iw * w;
+		c += w * w;
+
+		for (int ch = 0; ch < p_channels; ch++) {
+			x0[ch] += iw * p_pixels[i][ch];
+			x1[ch] += w * p_pixels[i][ch];
+		}
+	}
+
+	float det = a * c - b * b;
+	if (ABS(det) < CMP_EPSILON)
+		return; //all pixels use the same index
+
+	for (int ch = 0; ch < p_channels; ch++) {
+		r_e0[ch] = (c * x0[ch] - b * x1[ch]) / det;
+		r_e1[ch] = (a * x1[ch] - b * x0[ch]) / det;
+	}
+}
+
+struct BC7Mode6Block {
+
+	uint8_t endpoints[2][4]; //7 bits, the p-bit is appended on decode
+	uint8_t pbits[2];
+	uint8_t indices[16];
+};
+
+//quantize the endpoints with the given p-bits and pick the closest palette entry for each pixel, returns the squared error
+static float _bc7_mode6_quantize(const float p_pixels[16][4], const float p_e0[4], const float p_e1[4], int p_p0, int p_p1, BC7Mode6Block &r_block) {
+
+	int colors[2][4];
+
+	for (int c = 0; c < 4; c++) {
+
+		int q0 = CLAMP(int(Math::round((p_e0[c] - p_p0) * 0.5)), 0, 127);
+		int q1 = CLAMP(int(Math::round((p_e1[c] - p_p1) * 0.5)), 0, 127);
+		r_block.endpoints[0][c] = q0;
+		r_block.endpoints[1][c] = q1;
+		colors[0][c] = (q0 << 1) | p_p0;
+		colors[1][c] = (q1 << 1) | p_p1;
+	}
+
+	r_block.pbits[0] = p_p0;
+	r_block.pbits[1] = p_p1;
+
+	int palette[16][4];
+	for (int i = 0; i < 16; i++) {
+		int w = bptc_weights4[i];
+		for (int c = 0; c < 4; c++) {
+			palette[i][c] = ((64 - w) * colors[0][c] + w * colors[1][c] + 32) >> 6;
+		}
+	}
+
+	float error = 0;
+
+	for (int i = 0; i < 16; i++) {
+
+		float best = 1e20;
+		for (int k = 0; k < 16; k++) {
+
+			float err = 0;
+			for (int c = 0; c < 4; c++) {
+				float d = palette[k][c] - p_pixels[i][c];
+				err += d * d;
+			}
+
+			if (err < best) {
+				best = err;
+				r_block.indices[i] = k;
+			}
+		}
+
+		error += best;
+	}
+
+	return error;
+}
+
+static void _encode_bc7_block(const float p_pixels[16][4], int p_refine, uint8_t *r_dst) {
+
+	float e0[4], e1[4];
+	_fit_endpoints(p_pixels, 4, e0, e1);
+
+	BC7Mode6Block best;
+	float best_error = 1e20;
+
+	for (int pass = 0; pass <= p_refine; pass++) {
+
+		bool improved = false;
+
+		for (int p = 0; p < 4; p++) {
+
+			BC7Mode6Block block;
+			float error = _bc7_mode6_quantize(p_pixels, e0, e1, p & 1, p >> 1, block);
+			if (error < best_error) {
+				best_error = error;
+				best = block;
+				improved = true;
+			}
+		}
+
+		if (!improved || best_error == 0)
+			break;
+
+		_refine_endpoints(p_pixels, 4, best.indices, e0, e1);
+	}
+
+	//the most significant bit of the first index is implicit zero
+	if (best.indices[0] & 8) {
+		for (int c = 0; c < 4; c++) {
+			SWAP(best.endpoints[0][c], best.endpoints[1][c]);
+		}
+		SWAP(best.pbits[0], best.pbits[1]);
+		for (int i = 0; i < 16; i++) {
+			best.indices[i] = 15 - best.indices[i];
+		}
+	}
+
+	zeromem(r_dst, 16);
+	BPTCBitWriter bits = { r_dst, 0 };
+
+	bits.write(1 << 6, 7); //mode 6
+	for (int c = 0; c < 4; c++) {
+		bits.write(best.endpoints[0][c], 7);
+		bits.write(best.endpoints[1][c], 7);
+	}
+	bits.write(best.pbits[0], 1);
+	bits.write(best.pbits[1], 1);
+	for (int i = 0; i < 16; i++) {
+		bits.write(best.indices[i], i == 0 ? 3 : 4);
+	}
+}
+
+static bool _decode_bc7_block(const uint8_t *p_src, uint8_t r_pixels[16][4]) {
+
+	BPTCBitReader bits = { p_src, 0 };
+
+	int mode = 0;
+	while (mode < 8 && !bits.read(1)) {
+		mode++;
+	}
+
+	if (mode != 6) {
+		zeromem(r_pixels, 16 * 4);
+		return false;
+	}
+
+	int colors[2][4];
+	for (int c = 0; c < 4; c++) {
+		colors[0][c] = bits.read(7) << 1;
+		colors[1][c] = bits.read(7) << 1;
+	}
+
+	int p0 = bits.read(1);
+	int p1 = bits.read(1);
+	for (int c = 0; c < 4; c++) {
+		colors[0][c] |= p0;
+		colors[1][c] |= p1;
+	}
+
+	for (int i = 0; i < 16; i++) {
+
+		int w = bptc_weights4[bits.read(i == 0 ? 3 : 4)];
+		for (int c = 0; c < 4; c++) {
+			r_pixels[i][c] = ((64 - w) * colors[0][c] + w * colors[1][c] + 32) >> 6;
+		}
+	}
+
+	return true;
+}
+
+struct BC6HMode11Block {
+
+	uint16_t endpoints[2][3];
+	uint8_t indices[16];
+};
+
+static int _bc6h_unquantize(int p_comp) {
+
+	if (p_comp == 0)
+		return 0;
+	if (p_comp == 1023)
+		return 0xFFFF;
+	return ((p_comp << 16) + 0x8000) >> 10;
+}
+
+//same as the BC7 version, but pixels are half float bit patterns, which is the space the hardware interpolates in
+static float _bc6h_mode11_quantize(const float p_pixels[16][4], const float p_e0[4], const float p_e1[4], BC6HMode11Block &r_block) {
+
+	int colors[2][3];
+
+	for (int c = 0; c < 3; c++) {
+
+		//final values are unquantized * 31 / 64, unquantized is roughly comp * 64 + 32
+		int q0 = CLAMP(int(Math::round((p_e0[c] * 64.0 / 31.0 - 32.0) / 64.0)), 0, 1023);
+		int q1 = CLAMP(int(Math::round((p_e1[c] * 64.0 / 31.0 - 32.0) / 64.0)), 0, 1023);
+		r_block.endpoints[0][c] = q0;
+		r_block.endpoints[1][c] = q1;
+		colors[0][c] = _bc6h_unquantize(q0);
+		colors[1][c] = _bc6h_unquantize(q1);
+	}
+
+	int palette[16][3];
+	for (int i = 0; i < 16; i++) {
+		int w = bptc_weights4[i];
+		for (int c = 0; c < 3; c++) {
+			palette[i][c] = ((((64 - w) * colors[0][c] + w * colors[1][c] + 32) >> 6) * 31) >> 6;
+		}
+	}
+
+	float error = 0;
+
+	for (int i = 0; i < 16; i++) {
+
+		float best = 1e20;
+		for (int k = 0; k < 16; k++) {
+
+			float err = 0;
+			for (int c = 0; c < 3; c++) {
+				float d = palette[k][c] - p_pixels[i][c];
+				err += d * d;
+			}
+
+			if (err < best) {
+				best = err;
+				r_block.indices[i] = k;
+			}
+		}
+
+		error += best;
+	}
+
+	return error;
+}
+
+static void _encode_bc6h_block(const float p_pixels[16][4], int p_refine, uint8_t *r_dst) {
+
+	float e0[4], e1[4];
+	_fit_endpoints(p_pixels, 3, e0, e1);
+
+	BC6HMode11Block best;
+	float best_error = 1e20;
+
+	for (int pass = 0; pass <= p_refine; pass++) {
+
+		BC6HMode11Block block;
+		float error = _bc6h_mode11_quantize(p_pixels, e0, e1, block);
+		if (error >= best_error)
+			break;
+
+		best_error = error;
+		best = block;
+
+		if (best_error == 0)
+			break;
+
+		_refine_endpoints(p_pixels, 3, best.indices, e0, e1);
+	}
+
+	if (best.indices[0] & 8) {
+		for (int c = 0; c < 3; c++) {
+			SWAP(best.endpoints[0][c], best.endpoints[1][c]);
+		}
+		for (int i = 0; i < 16; i++) {
+			best.indices[i] = 15 - best.indices[i];
+		}
+	}
+
+	zeromem(r_dst, 16);
+	BPTCBitWriter bits = { r_dst, 0 };
+
+	bits.write(0x03, 5); //mode 11
+	for (int e = 0; e < 2; e++) {
+		for (int c = 0; c < 3; c++) {
+			bits.write(best.endpoints[e][c], 10);
+		}
+	}
+	for (int i = 0; i < 16; i++) {
+		bits.write(best.indices[i], i == 0 ? 3 : 4);
+	}
+}
+
+static bool _decode_bc6h_block(const uint8_t *p_src, uint16_t r_pixels[16][3]) {
+
+	BPTCBitReader bits = { p_src, 0 };
+
+	int mode = bits.read(2);
+	if (mode >= 2) {
+		mode |= bits.read(3) << 2;
+	}
+
+	if (mode != 0x03) {
+		zeromem(r_pixels, 16 * 3 * sizeof(uint16_t));
+		return false;
+	}
+
+	int colors[2][3];
+	for (int e = 0; e < 2; e++) {
+		for (int c = 0; c < 3; c++) {
+			colors[e][c] = _bc6h_unquantize(bits.read(10));
+		}
+	}
+
+	for (int i = 0; i < 16; i++) {
+
+		int w = bptc_weights4[bits.read(i == 0 ? 3 : 4)];
+		for (int c = 0; c < 3; c++) {
+			r_pixels[i][c] = ((((64 - w) * colors[0][c] + w * colors[1][c] + 32) >> 6) * 31) >> 6;
+		}
+	}
+
+	return true;
+}
+
+struct BPTCMipmap {
+
+	const uint8_t *src; //RGBA8
+	const float *src_hdr; //linear RGB
+	uint8_t *dst;
+	int w;
+	int h;
+};
+
+struct BPTCCompressData {
+
+	const BPTCMipmap *mipmaps;
+	int mipmap_count;
+	bool hdr;
+	int refine;
+	int splits;
+};
+
+//blocks don't depend on each other, so every split compresses its own range of block rows in each mipmap
+static void _compress_bptc_split(void *p_userdata, uint32_t p_index) {
+
+	const BPTCCompressData *cd = (const BPTCCompressData *)p_userdata;
+
+	for (int i = 0; i < cd->mipmap_count; i++) {
+
+		const BPTCMipmap &mm = cd->mipmaps[i];
+
+		int blocks_w = (mm.w + 3) / 4;
+		int block_rows = (mm.h + 3) / 4;
+		int from = block_rows * p_index / cd->splits;
+		int to = block_rows * (p_index + 1) / cd->splits;
+
+		for (int by = from; by < to; by++) {
+			for (int bx = 0; bx < blocks_w; bx++) {
+
+				float pixels[16][4];
+
+				for (int j = 0; j < 16; j++) {
+
+					//blocks past the edge repeat the last row and column
+					int x = MIN(bx * 4 + (j & 3), mm.w - 1);
+					int y = MIN(by * 4 + (j >> 2), mm.h - 1);
+
+					if (cd->hdr) {
+						const float *src = &mm.src_hdr[(y * mm.w + x) * 3];
+						for (int c = 0; c < 3; c++) {
+							pixels[j][c] = Math::make_half_float(CLAMP(src[c], 0.0f, 65504.0f));
+						}
+						pixels[j][3] = 0;
+					} else {
+						const uint8_t *src = &mm.src[(y * mm.w + x) * 4];
+						for (int c = 0; c < 4; c++) {
+							pixels[j][c] = src[c];
+						}
+					}
+				}
+
+				uint8_t *dst = &mm.dst[(by * blocks_w + bx) * 16];
+
+				if (cd->hdr) {
+					_encode_bc6h_block(pixels, cd->refine, dst);
+				} else {
+					_encode_bc7_block(pixels, cd->refine, dst);
+				}
+			}
+		}
+	}
+}
+
+void image_compress_bptc(Image *p_image, float p_lossy_quality, Image::CompressSource p_source) {
+
+	Image::Format format = p_image->get_format();
+
+	if (format >= Image::FORMAT_DXT1)
+		return; //do not compress, already compressed
+
+	bool hdr = format >= Image::FORMAT_RF && format <= Image::FORMAT_RGBE9995;
+
+	if (!hdr) {
+
+		Image::DetectChannels dc = p_source == Image::COMPRESS_SOURCE_GENERIC ? p_image->get_detected_channels() : Image::DETECTED_RGBA;
+
+		//normal maps and one or two channel images are just as good and half the size with RGTC
+		if ((p_source == Image::COMPRESS_SOURCE_NORMAL || dc == Image::DETECTED_R || dc == Image::DETECTED_RG) && Image::_image_compress_bc_func) {
+			Image::_image_compress_bc_func(p_image, p_source);
+			return;
+		}
+	}
+
+	int w = p_image->get_width();
+	int h = p_image->get_height();
+	bool mipmaps = p_image->has_mipmaps();
+
+	Image::Format target_format = hdr ? Image::FORMAT_BPTC_RGBFU : Image::FORMAT_BPTC_RGBA;
+
+	int mm_count = mipmaps ? Image::get_image_required_mipmaps(w, h, target_format) : 0;
+
+	Vector<Vector<float> > hdr_levels;
+
+	if (hdr) {
+
+		//float formats have no mipmaps generated, so build the chain here in linear space
+		hdr_levels.resize(mm_count + 1);
+
+		Vector<float> &base = hdr_levels.write[0];
+		base.resize(w * h * 3);
+
+		p_image->lock();
+		for (int y = 0; y < h; y++) {
+			for (int x = 0; x < w; x++) {
+				Color c = p_image->get_pixel(x, y);
+				base.write[(y * w + x) * 3 + 0] = c.r;
+				base.write[(y * w + x) * 3 + 1] = c.g;
+				base.write[(y * w + x) * 3 + 2] = c.b;
+			}
+		}
+		p_image->unlock();
+
+		int mw = w;
+		int mh = h;
+
+		for (int i = 1; i <= mm_count; i++) {
+
+			int nw = MAX(1, mw >> 1);
+			int nh = MAX(1, mh >> 1);
+
+			const float *prev = hdr_levels[i - 1].ptr();
+			Vector<float> &level = hdr_levels.write[i];
+			level.resize(nw * nh * 3);
+
+			for (int y = 0; y < nh; y++) {
+				for (int x = 0; x < nw; x++) {
+
+					int x0 = MIN(x * 2, mw - 1), x1 = MIN(x * 2 + 1, mw - 1);
+					int y0 = MIN(y * 2, mh - 1), y1 = MIN(y * 2 + 1, mh - 1);
+
+					for (int c = 0; c < 3; c++) {
+						level.write[(y * nw + x) * 3 + c] = (prev[(y0 * mw + x0) * 3 + c] + prev[(y0 * mw + x1) * 3 + c] + prev[(y1 * mw + x0) * 3 + c] + prev[(y1 * mw + x1) * 3 + c]) * 0.25;
+					}
+				}
+			}
+
+			mw = nw;
+			mh = nh;
+		}
+	} else {
+
+		p_image->convert(Image::FORMAT_RGBA8);
+	}
+
+	PoolVector<uint8_t> data;
+	data.resize(Image::get_image_data_size(w, h, target_format, mipmaps));
+
+	PoolVector<uint8_t>::Read rb = p_image->get_data().read();
+	PoolVector<uint8_t>::Write wb = data.write();
+
+	Vector<BPTCMipmap> mipmap_list;
+	mipmap_list.resize(mm_count + 1);
+
+	int mw = w;
+	int mh = h;
+	int dst_ofs = 0;
+
+	for (int i = 0; i <= mm_count; i++) {
+
+		BPTCMipmap &mm = mipmap_list.write[i];
+		mm.src = hdr ? NULL : rb.ptr() + p_image->get_mipmap_offset(i);
+		mm.src_hdr = hdr ? hdr_levels[i].ptr() : NULL;
+		mm.dst = wb.ptr() + dst_ofs;
+		mm.w = mw;
+		mm.h = mh;
+
+		dst_ofs += ((mw + 3) / 4) * ((mh + 3) / 4) * 16;
+		mw = MAX(1, mw >> 1);
+		mh = MAX(1, mh >> 1);
+	}
+
+	BPTCCompressData cd;
+	cd.mipmaps = mipmap_list.ptr();
+	cd.mipmap_count = mipmap_list.size();
+	cd.hdr = hdr;
+	cd.refine = CLAMP(int(p_lossy_quality * 4), 0, 3);
+	cd.splits = MIN(Image::get_compress_thread_count(), MAX(1, (h + 3) / 4 / 16)); //at least 16 block rows each
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	if (pool && pool->get_thread_count() > 0 && cd.splits > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_compress_bptc_split, &cd, cd.splits, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		cd.splits = 1;
+		_compress_bptc_split(&cd, 0);
+	}
+
+	rb = PoolVector<uint8_t>::Read();
+	wb = PoolVector<uint8_t>::Write();
+
+	p_image->create(w, h, mipmaps, target_format, data);
+}
+
+void image_decompress_bptc(Image *p_image) {
+
+	Image::Format target_format;
+
+	if (p_image->get_format() == Image::FORMAT_BPTC_RGBA) {
+		target_format = Image::FORMAT_RGBA8;
+	} else if (p_image->get_format() == Image::FORMAT_BPTC_RGBFU) {
+		target_format = Image::FORMAT_RGBH;
+	} else {
+		print_line("Can't decompress unknown format: " + itos(p_image->get_format()));
+		ERR_FAIL_COND(true);
+		return;
+	}
+
+	int w = p_image->get_width();
+	int h = p_image->get_height();
+	int mm_count = p_image->get_mipmap_count();
+	int pixel_size = Image::get_format_pixel_size(target_format);
+
+	PoolVector<uint8_t> data;
+	data.resize(Image::get_image_data_size(w, h, target_format, p_image->has_mipmaps()));
+
+	PoolVector<uint8_t>::Read rb = p_image->get_data().read();
+	PoolVector<uint8_t>::Write wb = data.write();
+
+	int mw = w;
+	int mh = h;
+	int dst_ofs = 0;
+	int unsupported_blocks = 0;
+
+	for (int i = 0; i <= mm_count; i++) {
+
+		const uint8_t *src = rb.ptr() + p_image->get_mipmap_offset(i);
+		uint8_t *dst = wb.ptr() + dst_ofs;
+
+		int blocks_w = (mw + 3) / 4;
+		int blocks_h = (mh + 3) / 4;
+
+		for (int by = 0; by < blocks_h; by++) {
+			for (int bx = 0; bx < blocks_w; bx++) {
+
+				const uint8_t *block = &src[(by * blocks_w + bx) * 16];
+				uint8_t pixels[16][4];
+				uint16_t pixels_hdr[16][3];
+
+				bool ok = target_format == Image::FORMAT_RGBA8 ? _decode_bc7_block(block, pixels) : _decode_bc6h_block(block, pixels_hdr);
+				if (!ok) {
+					unsupported_blocks++;
+				}
+
+				for (int j = 0; j < 16; j++) {
+
+					int x = bx * 4 + (j & 3);
+					int y = by * 4 + (j >> 2);
+					if (x >= mw || y >= mh)
+						continue;
+
+					if (target_format == Image::FORMAT_RGBA8) {
+						copymem(&dst[(y * mw + x) * pixel_size], pixels[j], 4);
+					} else {
+						copymem(&dst[(y * mw + x) * pixel_size], pixels_hdr[j], 6);
+					}
+				}
+			}
+		}
+
+		dst_ofs += mw * mh * pixel_size;
+		mw = MAX(1, mw >> 1);
+		mh = MAX(1, mh >> 1);
+	}
+
+	if (unsupported_blocks) {
+		ERR_PRINTS("BPTC decompression only supports the block modes written by the editor, " + itos(unsupported_blocks) + " blocks were left black.");
+	}
+
+	rb = PoolVector<uint8_t>::Read();
+	wb = PoolVector<uint8_t>::Write();
+
+	p_image->create(w, h, p_image->has_mipmaps(), target_format, data);
+}
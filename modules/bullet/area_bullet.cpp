@@ -54,7 +54,8 @@ AreaBullet::AreaBullet() :
 		spOv_gravityMag(10),
 		spOv_linearDump(0.1),
 		spOv_angularDump(1),
-		spOv_priority(0) {
+		spOv_priority(0),
+		monitorBatching(false) {
 
 	btGhost = bulletnew(btGhostObject);
 	btGhost->setCollisionShape(compoundShape);
@@ -85,20 +86,36 @@ void AreaBullet::dispatch_callbacks() {
 		switch (otherObj.state) {
 			case OVERLAP_STATE_ENTER:
 				otherObj.state = OVERLAP_STATE_INSIDE;
-				call_event(otherObj.object, PhysicsServer::AREA_BODY_ADDED);
+				if (monitorBatching)
+					queue_event(otherObj.object, PhysicsServer::AREA_BODY_ADDED);
+				else
+					call_event(otherObj.object, PhysicsServer::AREA_BODY_ADDED);
 				otherObj.object->on_enter_area(this);
 				break;
 			case OVERLAP_STATE_EXIT:
-				call_event(otherObj.object, PhysicsServer::AREA_BODY_REMOVED);
+				if (monitorBatching)
+					queue_event(otherObj.object, PhysicsServer::AREA_BODY_REMOVED);
+				else
+					call_event(otherObj.object, PhysicsServer::AREA_BODY_REMOVED);
 				otherObj.object->on_exit_area(this);
 				overlappingObjects.remove(i); // Remove after callback
 				break;
 		}
 	}
+
+	if (monitorBatching)
+		flush_events();
 }
 
 void AreaBullet::call_event(CollisionObjectBullet *p_otherObject, PhysicsServer::AreaBodyStatus p_status) {
 
+	if (monitorBatching) {
+		// Events outside of the dispatch are delivered right away as a batch of one
+		queue_event(p_otherObject, p_status);
+		flush_events();
+		return;
+	}
+
 	InOutEventCallback &event = eventsCallbacks[static_cast<int>(p_otherObject->getType())];
 	Object *areaGodoObject = ObjectDB::get_instance(event.event_callback_id);
 
@@ -117,6 +134,60 @@ void AreaBullet::call_event(CollisionObjectBullet *p_otherObject, PhysicsServer:
 	areaGodoObject->call(event.event_callback_method, (const Variant **)call_event_res_ptr, 5, outResp);
 }
 
+void AreaBullet::queue_event(CollisionObjectBullet *p_otherObject, PhysicsServer::AreaBodyStatus p_status) {
+
+	InOutEventCallback &event = eventsCallbacks[static_cast<int>(p_otherObject->getType())];
+	if (!event.event_callback_id)
+		return;
+
+	int pos = event.batch_events.size();
+	event.batch_events.resize(pos + PhysicsServer::AREA_MONITOR_EVENT_SIZE);
+
+	int *ev = &event.batch_events.write[pos];
+	ev[PhysicsServer::AREA_MONITOR_EVENT_STATUS] = p_status;
+	ev[PhysicsServer::AREA_MONITOR_EVENT_INSTANCE_ID] = p_otherObject->get_instance_id();
+	ev[PhysicsServer::AREA_MONITOR_EVENT_BODY_SHAPE] = 0; // other_body_shape ID
+	ev[PhysicsServer::AREA_MONITOR_EVENT_AREA_SHAPE] = 0; // self_shape ID
+}
+
+void AreaBullet::flush_events() {
+
+	for (int i = 0; i < 2; ++i) {
+		InOutEventCallback &event = eventsCallbacks[i];
+		if (event.batch_events.empty())
+			continue;
+
+		PoolIntArray events;
+		events.resize(event.batch_events.size());
+		{
+			PoolIntArray::Write w = events.write();
+			copymem(w.ptr(), event.batch_events.ptr(), event.batch_events.size() * sizeof(int));
+		}
+		event.batch_events.clear();
+
+		Object *areaGodoObject = ObjectDB::get_instance(event.event_callback_id);
+		if (!areaGodoObject) {
+			event.event_callback_id = 0;
+			continue;
+		}
+
+		Variant arg = events;
+		const Variant *argptr = &arg;
+		Variant::CallError outResp;
+		areaGodoObject->call(event.event_callback_method, &argptr, 1, outResp);
+	}
+}
+
+void AreaBullet::set_monitor_batching(bool p_enable) {
+	if (monitorBatching == p_enable)
+		return;
+
+	// Deliver what was queued with the previous convention
+	if (monitorBatching)
+		flush_events();
+	monitorBatching = p_enable;
+}
+
 void AreaBullet::scratch() {
 	if (isScratched)
 		return;
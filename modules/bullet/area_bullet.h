@@ -49,6 +49,7 @@ public:
 	struct InOutEventCallback {
 		ObjectID event_callback_id;
 		StringName event_callback_method;
+		Vector<int> batch_events;
 
 		InOutEventCallback() :
 				event_callback_id(0) {}
@@ -102,6 +103,7 @@ private:
 	bool isScratched;
 
 	InOutEventCallback eventsCallbacks[2];
+	bool monitorBatching;
 
 public:
 	AreaBullet();
@@ -147,6 +149,10 @@ public:
 
 	virtual void dispatch_callbacks();
 	void call_event(CollisionObjectBullet *p_otherObject, PhysicsServer::AreaBodyStatus p_status);
+	void queue_event(CollisionObjectBullet *p_otherObject, PhysicsServer::AreaBodyStatus p_status);
+	void flush_events();
+	void set_monitor_batching(bool p_enable);
+	_FORCE_INLINE_ bool is_monitor_batching() const { return monitorBatching; }
 	void set_on_state_change(ObjectID p_id, const StringName &p_method, const Variant &p_udata = Variant());
 	void scratch();
 
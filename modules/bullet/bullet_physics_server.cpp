@@ -36,8 +36,10 @@
 #include "core/error_macros.h"
 #include "core/ustring.h"
 #include "generic_6dof_joint_bullet.h"
+#include "godot_task_scheduler.h"
 #include "hinge_joint_bullet.h"
 #include "pin_joint_bullet.h"
+#include "project_settings.h"
 #include "shape_bullet.h"
 #include "slider_joint_bullet.h"
 
@@ -87,7 +89,8 @@ void BulletPhysicsServer::_bind_methods() {
 BulletPhysicsServer::BulletPhysicsServer() :
 		PhysicsServer(),
 		active(true),
-		active_spaces_count(0) {}
+		active_spaces_count(0),
+		task_scheduler(NULL) {}
 
 BulletPhysicsServer::~BulletPhysicsServer() {
 	bulletdelete(emptyShape);
@@ -434,6 +437,13 @@ void BulletPhysicsServer::area_set_area_monitor_callback(RID p_area, Object *p_r
 	area->set_event_callback(CollisionObjectBullet::TYPE_AREA, p_receiver ? p_receiver->get_instance_id() : 0, p_method);
 }
 
+void BulletPhysicsServer::area_set_monitor_batching(RID p_area, bool p_enable) {
+	AreaBullet *area = area_owner.get(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 void BulletPhysicsServer::area_set_ray_pickable(RID p_area, bool p_enable) {
 	AreaBullet *area = area_owner.get(p_area);
 	ERR_FAIL_COND(!area);
@@ -1525,6 +1535,12 @@ void BulletPhysicsServer::free(RID p_rid) {
 
 void BulletPhysicsServer::init() {
 	BulletPhysicsDirectBodyState::initSingleton();
+
+	if (GLOBAL_DEF("physics/3d/multithreaded_world", false)) {
+		// must be set from the thread that steps the spaces, before any space is created
+		task_scheduler = bulletnew(GodotTaskScheduler);
+		btSetTaskScheduler(task_scheduler);
+	}
 }
 
 void BulletPhysicsServer::step(float p_deltaTime) {
@@ -1547,6 +1563,11 @@ void BulletPhysicsServer::flush_queries() {
 
 void BulletPhysicsServer::finish() {
 	BulletPhysicsDirectBodyState::destroySingleton();
+
+	if (task_scheduler) {
+		btSetTaskScheduler(NULL);
+		bulletdelete(task_scheduler);
+	}
 }
 
 int BulletPhysicsServer::get_process_info(ProcessInfo p_info) {
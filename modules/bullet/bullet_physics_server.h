@@ -44,6 +44,8 @@
 	@author AndreaCatania
 */
 
+class GodotTaskScheduler;
+
 class BulletPhysicsServer : public PhysicsServer {
 	GDCLASS(BulletPhysicsServer, PhysicsServer)
 
@@ -60,6 +62,8 @@ class BulletPhysicsServer : public PhysicsServer {
 	mutable RID_Owner<SoftBodyBullet> soft_body_owner;
 	mutable RID_Owner<JointBullet> joint_owner;
 
+	GodotTaskScheduler *task_scheduler;
+
 private:
 	/// This is used when a collision shape is not active, so the bullet compound shapes index are always sync with godot index
 	static btEmptyShape *emptyShape;
@@ -165,6 +169,7 @@ public:
 	virtual void area_set_monitorable(RID p_area, bool p_monitorable);
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable);
 	virtual void area_set_ray_pickable(RID p_area, bool p_enable);
 	virtual bool area_is_ray_pickable(RID p_area) const;
 
@@ -0,0 +1,100 @@
+/*************************************************************************/
+/*  godot_task_scheduler.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "godot_task_scheduler.h"
+
+#include "os/worker_thread_pool.h"
+#include "typedefs.h"
+
+// defined in btThreads.cpp, the built-in schedulers use them to flag nested loops
+void btPushThreadsAreRunning();
+void btPopThreadsAreRunning();
+
+void GodotTaskScheduler::_parallel_for_task(void *p_userdata, uint32_t p_index) {
+
+	const ParallelFor *pf = (const ParallelFor *)p_userdata;
+
+	int from = pf->begin + p_index * pf->grain_size;
+	int to = MIN(from + pf->grain_size, pf->end);
+
+	pf->body->forLoop(from, to);
+}
+
+int GodotTaskScheduler::getMaxNumThreads() const {
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int threads = pool ? pool->get_thread_count() + 1 : 1; // the calling thread helps too
+	return MIN(threads, int(BT_MAX_THREAD_COUNT));
+}
+
+int GodotTaskScheduler::getNumThreads() const {
+
+	return num_threads;
+}
+
+void GodotTaskScheduler::setNumThreads(int p_num_threads) {
+
+	// the pool threads are owned by the engine, this only limits how finely loops are split
+	num_threads = CLAMP(p_num_threads, 1, getMaxNumThreads());
+}
+
+void GodotTaskScheduler::parallelFor(int p_begin, int p_end, int p_grain_size, const btIParallelForBody &p_body) {
+
+	int count = p_end - p_begin;
+	if (count <= 0)
+		return;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	if (!pool || pool->get_thread_count() == 0 || num_threads <= 1 || count <= p_grain_size || btThreadsAreRunning()) {
+		// not worth it, or called from within another parallel loop
+		p_body.forLoop(p_begin, p_end);
+		return;
+	}
+
+	ParallelFor pf;
+	pf.body = &p_body;
+	pf.begin = p_begin;
+	pf.end = p_end;
+	pf.grain_size = MAX(p_grain_size, 1);
+
+	int tasks = (count + pf.grain_size - 1) / pf.grain_size;
+
+	btPushThreadsAreRunning();
+	WorkerThreadPool::GroupID group = pool->add_group_task(_parallel_for_task, &pf, tasks, WorkerThreadPool::PRIORITY_HIGH);
+	pool->wait_for_group_task_completion(group);
+	btPopThreadsAreRunning();
+}
+
+GodotTaskScheduler::GodotTaskScheduler() :
+		btITaskScheduler("Godot") {
+
+	num_threads = getMaxNumThreads();
+}
@@ -33,6 +33,7 @@
 #include "bullet_physics_server.h"
 #include "class_db.h"
 #include "project_settings.h"
+#include "servers/physics/physics_server_wrap_mt.h"
 
 /**
 	@author AndreaCatania
@@ -40,7 +41,7 @@
 
 #ifndef _3D_DISABLED
 PhysicsServer *_createBulletPhysicsCallback() {
-	return memnew(BulletPhysicsServer);
+	return PhysicsServerWrapMT::init_server<BulletPhysicsServer>();
 }
 #endif
 
@@ -51,6 +52,9 @@ void register_bullet_types() {
 
 	GLOBAL_DEF("physics/3d/active_soft_world", true);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/active_soft_world", PropertyInfo(Variant::BOOL, "physics/3d/active_soft_world"));
+
+	GLOBAL_DEF("physics/3d/multithreaded_world", false);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/multithreaded_world", PropertyInfo(Variant::BOOL, "physics/3d/multithreaded_world"));
 #endif
 }
 
@@ -352,7 +352,12 @@ ConcavePolygonShapeBullet::~ConcavePolygonShapeBullet() {
 }
 
 void ConcavePolygonShapeBullet::set_data(const Variant &p_data) {
-	setup(p_data);
+	if (p_data.get_type() == Variant::DICTIONARY) {
+		// Faces saved along with a tree built by GodotPhysics, Bullet builds its own
+		setup(Dictionary(p_data)["faces"]);
+	} else {
+		setup(p_data);
+	}
 }
 
 Variant ConcavePolygonShapeBullet::get_data() const {
@@ -421,6 +426,44 @@ HeightMapShapeBullet::HeightMapShapeBullet() :
 void HeightMapShapeBullet::set_data(const Variant &p_data) {
 	ERR_FAIL_COND(p_data.get_type() != Variant::DICTIONARY);
 	Dictionary d = p_data;
+
+	if (d.has("region_x")) {
+		// Only part of the heights changed
+		int region_x = d["region_x"];
+		int region_z = d["region_z"];
+		int region_width = d["region_width"];
+		int region_depth = d["region_depth"];
+		PoolVector<real_t> region_heights = d["heights"];
+
+		ERR_FAIL_COND(region_x < 0 || region_z < 0 || region_width <= 0 || region_depth <= 0);
+		ERR_FAIL_COND(region_x + region_width > width || region_z + region_depth > depth);
+		ERR_FAIL_COND(region_heights.size() != (region_width * region_depth));
+
+		PoolVector<real_t> l_heights = heights;
+		{
+			PoolVector<real_t>::Read r = region_heights.read();
+			PoolVector<real_t>::Write w = l_heights.write();
+			for (int z = 0; z < region_depth; ++z) {
+				for (int x = 0; x < region_width; ++x) {
+					w[(region_z + z) * width + region_x + x] = r[z * region_width + x];
+				}
+			}
+		}
+
+		real_t l_min_height = 0.0;
+		real_t l_max_height = 0.0;
+		{
+			PoolVector<real_t>::Read r = l_heights.read();
+			for (int i = 0; i < l_heights.size(); ++i) {
+				l_min_height = MIN(l_min_height, r[i]);
+				l_max_height = MAX(l_max_height, r[i]);
+			}
+		}
+
+		setup(l_heights, width, depth, l_min_height, l_max_height);
+		return;
+	}
+
 	ERR_FAIL_COND(!d.has("width"));
 	ERR_FAIL_COND(!d.has("depth"));
 	ERR_FAIL_COND(!d.has("heights"));
@@ -447,8 +490,8 @@ void HeightMapShapeBullet::set_data(const Variant &p_data) {
 	// Compute min and max heights if not specified.
 	if (!d.has("min_height") && !d.has("max_height")) {
 
-		PoolVector<real_t>::Read r = heights.read();
-		int heights_size = heights.size();
+		PoolVector<real_t>::Read r = l_heights.read();
+		int heights_size = l_heights.size();
 
 		for (int i = 0; i < heights_size; ++i) {
 			real_t h = r[i];
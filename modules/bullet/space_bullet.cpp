@@ -47,6 +47,7 @@
 #include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
 #include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
 #include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 #include <BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h>
 #include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
 #include <btBulletDynamicsCommon.h>
@@ -339,7 +340,15 @@ SpaceBullet::SpaceBullet() :
 		gravityMagnitude(10),
 		contactDebugCount(0) {
 
-	create_empty_world(GLOBAL_DEF("physics/3d/active_soft_world", true));
+	bool soft_world = GLOBAL_DEF("physics/3d/active_soft_world", true);
+	bool multithreaded = GLOBAL_DEF("physics/3d/multithreaded_world", false) && btGetTaskScheduler();
+
+	if (soft_world && multithreaded) {
+		WARN_PRINT("Bullet has no multithreaded soft body world, disable physics/3d/active_soft_world to use physics/3d/multithreaded_world.");
+		multithreaded = false;
+	}
+
+	create_empty_world(soft_world, multithreaded);
 	direct_access = memnew(BulletPhysicsDirectSpaceState(this));
 }
 
@@ -562,7 +571,7 @@ btScalar calculateGodotCombinedFriction(const btCollisionObject *body0, const bt
 	return ABS(MIN(body0->getFriction(), body1->getFriction()));
 }
 
-void SpaceBullet::create_empty_world(bool p_create_soft_world) {
+void SpaceBullet::create_empty_world(bool p_create_soft_world, bool p_multithreaded) {
 
 	gjk_epa_pen_solver = bulletnew(btGjkEpaPenetrationDepthSolver);
 	gjk_simplex_solver = bulletnew(btVoronoiSimplexSolver);
@@ -571,6 +580,8 @@ void SpaceBullet::create_empty_world(bool p_create_soft_world) {
 	void *world_mem;
 	if (p_create_soft_world) {
 		world_mem = malloc(sizeof(btSoftRigidDynamicsWorld));
+	} else if (p_multithreaded) {
+		world_mem = malloc(sizeof(btDiscreteDynamicsWorldMt));
 	} else {
 		world_mem = malloc(sizeof(btDiscreteDynamicsWorld));
 	}
@@ -581,13 +592,22 @@ void SpaceBullet::create_empty_world(bool p_create_soft_world) {
 		collisionConfiguration = bulletnew(GodotCollisionConfiguration(static_cast<btDiscreteDynamicsWorld *>(world_mem)));
 	}
 
-	dispatcher = bulletnew(GodotCollisionDispatcher(collisionConfiguration));
 	broadphase = bulletnew(btDbvtBroadphase);
-	solver = bulletnew(btSequentialImpulseConstraintSolver);
+
+	if (p_multithreaded) {
+		// narrowphase pairs and simulation islands are processed through the GodotTaskScheduler
+		dispatcher = bulletnew(GodotCollisionDispatcherMt(collisionConfiguration));
+		solver = bulletnew(btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT));
+	} else {
+		dispatcher = bulletnew(GodotCollisionDispatcher(collisionConfiguration));
+		solver = bulletnew(btSequentialImpulseConstraintSolver);
+	}
 
 	if (p_create_soft_world) {
 		dynamicsWorld = new (world_mem) btSoftRigidDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration);
 		soft_body_world_info = bulletnew(btSoftBodyWorldInfo);
+	} else if (p_multithreaded) {
+		dynamicsWorld = new (world_mem) btDiscreteDynamicsWorldMt(dispatcher, broadphase, static_cast<btConstraintSolverPoolMt *>(solver), collisionConfiguration);
 	} else {
 		dynamicsWorld = new (world_mem) btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration);
 	}
@@ -177,7 +177,7 @@ public:
 	bool test_body_motion(RigidBodyBullet *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, PhysicsServer::MotionResult *r_result);
 
 private:
-	void create_empty_world(bool p_create_soft_world);
+	void create_empty_world(bool p_create_soft_world, bool p_multithreaded);
 	void destroy_world();
 	void check_ghost_overlaps();
 	void check_body_collision();
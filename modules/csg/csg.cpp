@@ -1181,6 +1181,35 @@ int CSGBrushOperation::MeshMerge::_bvh_count_intersections(BVH *bvhptr, int p_ma
 	return intersections;
 }
 
+void CSGBrushOperation::MeshMerge::_bvh_collect_faces(const BVH *bvhptr, int p_max_depth, int p_bvh_first, const AABB &p_aabb, Vector<int> &r_faces) {
+
+	int *stack = (int *)alloca(sizeof(int) * (p_max_depth + 2));
+
+	int level = 0;
+	stack[0] = p_bvh_first;
+
+	while (level >= 0) {
+
+		const BVH &b = bvhptr[stack[level--]];
+
+		if (b.face >= 0) {
+
+			//leaf, faces are chained through next
+			const BVH *bp = &b;
+			while (bp) {
+				if (p_aabb.intersects(bp->aabb)) {
+					r_faces.push_back(bp->face);
+				}
+				bp = bp->next != -1 ? &bvhptr[bp->next] : NULL;
+			}
+		} else if (p_aabb.intersects(b.aabb)) {
+
+			stack[++level] = b.right;
+			stack[++level] = b.left;
+		}
+	}
+}
+
 void CSGBrushOperation::MeshMerge::mark_inside_faces() {
 
 	// mark faces that are inside. This helps later do the boolean ops when merging.
@@ -1335,12 +1364,54 @@ void CSGBrushOperation::merge_brushes(Operation p_operation, const CSGBrush &p_A
 
 	//check intersections between faces. Use AABB to speed up precheck
 	//this generates list of buildpolys and clips them.
-	//this was originally BVH optimized, but its not really worth it.
-	for (int i = 0; i < p_A.faces.size(); i++) {
-		cd.face_a = i;
-		for (int j = 0; j < p_B.faces.size(); j++) {
-			if (p_A.faces[i].aabb.intersects(p_B.faces[j].aabb)) {
-				_collision_callback(&p_A, i, cd.build_polys_A, &p_B, j, cd.build_polys_B, mesh_merge);
+	//B faces go in a BVH, so every face of A only visits the faces its AABB can touch.
+	//Brushes accumulated over many merges get large, pairing every face with every face does not scale.
+	if (p_A.faces.size() && p_B.faces.size()) {
+
+		int face_count = p_B.faces.size();
+
+		Vector<MeshMerge::BVH> bvhvec;
+		bvhvec.resize(face_count * 3);
+		MeshMerge::BVH *bvh = bvhvec.ptrw();
+
+		Vector<MeshMerge::BVH *> bvhtrvec;
+		bvhtrvec.resize(face_count);
+		MeshMerge::BVH **bvhptr = bvhtrvec.ptrw();
+
+		AABB b_aabb = p_B.faces[0].aabb;
+
+		for (int i = 0; i < face_count; i++) {
+			bvh[i].left = -1;
+			bvh[i].right = -1;
+			bvh[i].face = i;
+			bvh[i].aabb = p_B.faces[i].aabb;
+			bvh[i].center = bvh[i].aabb.position + bvh[i].aabb.size * 0.5;
+			bvh[i].next = -1;
+			bvhptr[i] = &bvh[i];
+			b_aabb.merge_with(bvh[i].aabb);
+		}
+
+		int max_depth = 0;
+		int max_alloc = face_count;
+		int bvh_first = mesh_merge._create_bvh(bvh, bvhptr, 0, face_count, 1, max_depth, max_alloc);
+
+		Vector<int> hits;
+
+		for (int i = 0; i < p_A.faces.size(); i++) {
+
+			if (!b_aabb.intersects(p_A.faces[i].aabb))
+				continue;
+
+			hits.clear();
+			MeshMerge::_bvh_collect_faces(bvh, max_depth, bvh_first, p_A.faces[i].aabb, hits);
+			if (hits.size() == 0)
+				continue;
+
+			hits.sort(); //clip in the same order as the plain loop did, the result depends on it
+
+			cd.face_a = i;
+			for (int j = 0; j < hits.size(); j++) {
+				_collision_callback(&p_A, i, cd.build_polys_A, &p_B, hits[j], cd.build_polys_B, mesh_merge);
 			}
 		}
 	}
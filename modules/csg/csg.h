@@ -108,6 +108,7 @@ struct CSGBrushOperation {
 		};
 
 		int _bvh_count_intersections(BVH *bvhptr, int p_max_depth, int p_bvh_first, const Vector3 &p_begin, const Vector3 &p_end, int p_exclude) const;
+		static void _bvh_collect_faces(const BVH *bvhptr, int p_max_depth, int p_bvh_first, const AABB &p_aabb, Vector<int> &r_faces);
 		int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc);
 
 		struct VertexKey {
@@ -29,8 +29,46 @@
 /*************************************************************************/
 
 #include "csg_shape.h"
+#include "core/engine.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/3d/path.h"
 
+struct CSGShape::RebuildJob {
+
+	struct Input {
+		int entry; //index of the child entry when it is rebuilt by this job, -1 otherwise
+		const CSGBrush *brush;
+		ObjectID child;
+		uint32_t version;
+		Transform xform;
+		Operation operation;
+	};
+
+	struct Entry {
+		CSGShape *node;
+		float snap;
+		CSGBrush *self_brush;
+		bool self_rebuilt;
+		int keep_steps;
+		CSGBrush *start;
+		Vector<Input> inputs;
+		Vector<CSGBrush *> results;
+		CSGBrush *result;
+		AABB aabb;
+	};
+
+	Vector<Entry> entries;
+
+	bool build_mesh;
+	bool build_physics;
+	int root_entry;
+	const CSGBrush *root_brush;
+	Vector<ShapeUpdateSurface> surfaces;
+	PoolVector<Vector3> physics_faces;
+
+	WorkerThreadPool::GroupID task;
+};
+
 void CSGShape::set_use_collision(bool p_enable) {
 
 	if (use_collision == p_enable)
@@ -74,6 +112,14 @@ float CSGShape::get_snap() const {
 
 void CSGShape::_make_dirty() {
 
+	//the brush built by this node itself needs rebuilding, not only the merges
+	self_dirty = true;
+
+	_make_subtree_dirty();
+}
+
+void CSGShape::_make_subtree_dirty() {
+
 	if (!is_inside_tree())
 		return;
 
@@ -84,93 +130,280 @@ void CSGShape::_make_dirty() {
 	dirty = true;
 
 	if (parent) {
-		parent->_make_dirty();
+		parent->_make_subtree_dirty();
 	} else {
 		//only parent will do
 		call_deferred("_update_shape");
 	}
 }
 
-CSGBrush *CSGShape::_get_brush() {
+CSGShape *CSGShape::_get_root_shape() {
 
-	if (dirty) {
-		if (brush) {
-			memdelete(brush);
+	CSGShape *root = this;
+	while (root->parent) {
+		root = root->parent;
+	}
+	return root;
+}
+
+AABB CSGShape::_get_brush_aabb(const CSGBrush *p_brush) {
+
+	AABB aabb;
+	if (!p_brush) {
+		return aabb;
+	}
+
+	for (int i = 0; i < p_brush->faces.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			if (i == 0 && j == 0)
+				aabb.position = p_brush->faces[i].vertices[j];
+			else
+				aabb.expand_to(p_brush->faces[i].vertices[j]);
 		}
-		brush = NULL;
+	}
 
-		CSGBrush *n = _build_brush();
+	return aabb;
+}
 
-		for (int i = 0; i < get_child_count(); i++) {
+int CSGShape::_prepare_rebuild(RebuildJob *p_job) {
 
-			CSGShape *child = Object::cast_to<CSGShape>(get_child(i));
-			if (!child)
-				continue;
-			if (!child->is_visible_in_tree())
+	if (!dirty) {
+		return -1;
+	}
+
+	RebuildJob::Entry e;
+	e.node = this;
+	e.snap = snap;
+
+	//children first, so entries end up in an order where merges only depend on previous ones
+	for (int i = 0; i < get_child_count(); i++) {
+
+		CSGShape *child = Object::cast_to<CSGShape>(get_child(i));
+		if (!child)
+			continue;
+		if (!child->is_visible_in_tree())
+			continue;
+
+		RebuildJob::Input in;
+		in.entry = child->_prepare_rebuild(p_job);
+		in.brush = child->brush;
+		in.child = child->get_instance_id();
+		in.version = child->brush_version;
+		in.xform = child->get_transform();
+		in.operation = child->get_operation();
+		e.inputs.push_back(in);
+	}
+
+	if (self_dirty) {
+		e.self_brush = _build_brush();
+		e.self_rebuilt = true;
+		e.keep_steps = 0;
+	} else {
+		e.self_brush = self_brush;
+		e.self_rebuilt = false;
+
+		//merges whose inputs did not change since the last rebuild are kept as they are
+		e.keep_steps = 0;
+		while (e.keep_steps < e.inputs.size() && e.keep_steps < merge_steps.size()) {
+
+			const RebuildJob::Input &in = e.inputs[e.keep_steps];
+			const MergeStep &step = merge_steps[e.keep_steps];
+			if (in.entry >= 0 || in.child != step.child || in.version != step.version || in.operation != step.operation || in.xform != step.xform) {
+				break;
+			}
+			e.keep_steps++;
+		}
+	}
+
+	e.start = e.self_brush;
+	for (int i = e.keep_steps - 1; i >= 0; i--) {
+		if (merge_steps[i].result) {
+			e.start = merge_steps[i].result;
+			break;
+		}
+	}
+
+	dirty = false;
+	self_dirty = false;
+	brush_version++;
+
+	p_job->entries.push_back(e);
+	return p_job->entries.size() - 1;
+}
+
+void CSGShape::_execute_rebuild(RebuildJob *p_job) {
+
+	for (int i = 0; i < p_job->entries.size(); i++) {
+
+		RebuildJob::Entry &e = p_job->entries.write[i];
+		e.results.resize(e.inputs.size());
+
+		CSGBrush *n = e.start;
+
+		for (int j = 0; j < e.inputs.size(); j++) {
+
+			e.results.write[j] = NULL;
+			if (j < e.keep_steps) {
 				continue;
+			}
 
-			CSGBrush *n2 = child->_get_brush();
+			const RebuildJob::Input &in = e.inputs[j];
+			const CSGBrush *n2 = in.entry >= 0 ? p_job->entries[in.entry].result : in.brush;
 			if (!n2)
 				continue;
+
+			CSGBrush *nn = memnew(CSGBrush);
+
 			if (!n) {
-				n = memnew(CSGBrush);
 
-				n->copy_from(*n2, child->get_transform());
+				nn->copy_from(*n2, in.xform);
 
 			} else {
 
-				CSGBrush *nn = memnew(CSGBrush);
 				CSGBrush *nn2 = memnew(CSGBrush);
-				nn2->copy_from(*n2, child->get_transform());
+				nn2->copy_from(*n2, in.xform);
 
 				CSGBrushOperation bop;
 
-				switch (child->get_operation()) {
-					case CSGShape::OPERATION_UNION: bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, *n, *nn2, *nn, snap); break;
-					case CSGShape::OPERATION_INTERSECTION: bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, *n, *nn2, *nn, snap); break;
-					case CSGShape::OPERATION_SUBTRACTION: bop.merge_brushes(CSGBrushOperation::OPERATION_SUBSTRACTION, *n, *nn2, *nn, snap); break;
+				switch (in.operation) {
+					case CSGShape::OPERATION_UNION: bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, *n, *nn2, *nn, e.snap); break;
+					case CSGShape::OPERATION_INTERSECTION: bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, *n, *nn2, *nn, e.snap); break;
+					case CSGShape::OPERATION_SUBTRACTION: bop.merge_brushes(CSGBrushOperation::OPERATION_SUBSTRACTION, *n, *nn2, *nn, e.snap); break;
 				}
-				memdelete(n);
 				memdelete(nn2);
-				n = nn;
 			}
-		}
 
-		if (n) {
-			AABB aabb;
-			for (int i = 0; i < n->faces.size(); i++) {
-				for (int j = 0; j < 3; j++) {
-					if (i == 0 && j == 0)
-						aabb.position = n->faces[i].vertices[j];
-					else
-						aabb.expand_to(n->faces[i].vertices[j]);
-				}
-			}
-			node_aabb = aabb;
-		} else {
-			node_aabb = AABB();
+			e.results.write[j] = nn;
+			n = nn;
 		}
 
-		brush = n;
+		e.result = n;
+		e.aabb = _get_brush_aabb(n);
+	}
+
+	if (p_job->build_mesh) {
 
-		dirty = false;
+		const CSGBrush *n = p_job->root_entry >= 0 ? p_job->entries[p_job->root_entry].result : p_job->root_brush;
+		if (n) {
+			_build_surfaces(n, p_job->surfaces, p_job->build_physics ? &p_job->physics_faces : NULL);
+		}
 	}
+}
 
-	return brush;
+void CSGShape::_rebuild_task(void *p_userdata, uint32_t p_index) {
+
+	_execute_rebuild((RebuildJob *)p_userdata);
 }
 
-void CSGShape::_update_shape() {
+void CSGShape::_apply_rebuild(RebuildJob *p_job) {
 
-	//print_line("updating shape for " + String(get_path()));
+	for (int i = 0; i < p_job->entries.size(); i++) {
 
-	if (parent)
+		RebuildJob::Entry &e = p_job->entries.write[i];
+		CSGShape *node = e.node;
+
+		for (int j = e.keep_steps; j < node->merge_steps.size(); j++) {
+			if (node->merge_steps[j].result) {
+				memdelete(node->merge_steps[j].result);
+			}
+		}
+		node->merge_steps.resize(e.keep_steps);
+
+		for (int j = e.keep_steps; j < e.inputs.size(); j++) {
+
+			MergeStep step;
+			step.child = e.inputs[j].child;
+			step.version = e.inputs[j].version;
+			step.xform = e.inputs[j].xform;
+			step.operation = e.inputs[j].operation;
+			step.result = e.results[j];
+			node->merge_steps.push_back(step);
+		}
+
+		if (e.self_rebuilt) {
+			if (node->self_brush) {
+				memdelete(node->self_brush);
+			}
+			node->self_brush = e.self_brush;
+		}
+
+		node->brush = e.result;
+		node->node_aabb = e.aabb;
+		node->update_gizmo();
+	}
+
+	if (!p_job->build_mesh) {
 		return;
+	}
 
 	set_base(RID());
 	root_mesh.unref(); //byebye root mesh
 
-	CSGBrush *n = _get_brush();
-	ERR_FAIL_COND(!n);
+	ERR_FAIL_COND(!brush);
+
+	root_mesh.instance();
+	//create surfaces
+
+	for (int i = 0; i < p_job->surfaces.size(); i++) {
+
+		const ShapeUpdateSurface &surface = p_job->surfaces[i];
+
+		if (surface.last_added == 0)
+			continue;
+
+		Array array;
+		array.resize(Mesh::ARRAY_MAX);
+
+		array[Mesh::ARRAY_VERTEX] = surface.vertices;
+		array[Mesh::ARRAY_NORMAL] = surface.normals;
+		array[Mesh::ARRAY_TEX_UV] = surface.uvs;
+
+		int idx = root_mesh->get_surface_count();
+		root_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, array);
+		root_mesh->surface_set_material(idx, surface.material);
+	}
+
+	if (root_collision_shape.is_valid() && p_job->build_physics) {
+		root_collision_shape->set_faces(p_job->physics_faces);
+	}
+
+	set_base(root_mesh->get_rid());
+}
+
+void CSGShape::_finish_rebuild() {
+
+	if (!rebuild_job) {
+		return;
+	}
+
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(rebuild_job->task);
+	set_process_internal(false);
+
+	RebuildJob *job = rebuild_job;
+	rebuild_job = NULL;
+	_apply_rebuild(job);
+	memdelete(job);
+}
+
+CSGBrush *CSGShape::_get_brush() {
+
+	if (dirty && !_get_root_shape()->rebuild_job) {
+
+		//needed right away (gizmos, combiners), so evaluate this subtree here
+		RebuildJob job;
+		job.build_mesh = false;
+		job.build_physics = false;
+		job.root_entry = -1;
+		job.root_brush = NULL;
+		_prepare_rebuild(&job);
+		_execute_rebuild(&job);
+		_apply_rebuild(&job);
+	}
+
+	return brush;
+}
+
+void CSGShape::_build_surfaces(const CSGBrush *n, Vector<ShapeUpdateSurface> &surfaces, PoolVector<Vector3> *r_physics_faces) {
 
 	OAHashMap<Vector3, Vector3> vec_map;
 
@@ -179,7 +412,6 @@ void CSGShape::_update_shape() {
 	for (int i = 0; i < face_count.size(); i++) {
 		face_count.write[i] = 0;
 	}
-
 	for (int i = 0; i < n->faces.size(); i++) {
 		int mat = n->faces[i].material;
 		ERR_CONTINUE(mat < -1 || mat >= face_count.size());
@@ -203,8 +435,6 @@ void CSGShape::_update_shape() {
 		face_count.write[idx]++;
 	}
 
-	Vector<ShapeUpdateSurface> surfaces;
-
 	surfaces.resize(face_count.size());
 
 	//create arrays
@@ -225,10 +455,9 @@ void CSGShape::_update_shape() {
 	}
 
 	//fill arrays
-	PoolVector<Vector3> physics_faces;
 	bool fill_physics_faces = false;
-	if (root_collision_shape.is_valid()) {
-		physics_faces.resize(n->faces.size() * 3);
+	if (r_physics_faces) {
+		r_physics_faces->resize(n->faces.size() * 3);
 		fill_physics_faces = true;
 	}
 
@@ -236,7 +465,7 @@ void CSGShape::_update_shape() {
 		PoolVector<Vector3>::Write physicsw;
 
 		if (fill_physics_faces) {
-			physicsw = physics_faces.write();
+			physicsw = r_physics_faces->write();
 		}
 
 		for (int i = 0; i < n->faces.size(); i++) {
@@ -285,36 +514,45 @@ void CSGShape::_update_shape() {
 		}
 	}
 
-	root_mesh.instance();
-	//create surfaces
-
 	for (int i = 0; i < surfaces.size(); i++) {
 
 		surfaces.write[i].verticesw = PoolVector<Vector3>::Write();
 		surfaces.write[i].normalsw = PoolVector<Vector3>::Write();
 		surfaces.write[i].uvsw = PoolVector<Vector2>::Write();
+	}
+}
 
-		if (surfaces[i].last_added == 0)
-			continue;
+void CSGShape::_update_shape() {
 
-		Array array;
-		array.resize(Mesh::ARRAY_MAX);
+	//print_line("updating shape for " + String(get_path()));
 
-		array[Mesh::ARRAY_VERTEX] = surfaces[i].vertices;
-		array[Mesh::ARRAY_NORMAL] = surfaces[i].normals;
-		array[Mesh::ARRAY_TEX_UV] = surfaces[i].uvs;
+	if (parent)
+		return;
 
-		int idx = root_mesh->get_surface_count();
-		root_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, array);
-		root_mesh->surface_set_material(idx, surfaces[i].material);
+	if (rebuild_job) {
+		//still dirty when the running rebuild finishes, so it will start over then
+		return;
 	}
 
-	if (root_collision_shape.is_valid()) {
-		root_collision_shape->set_faces(physics_faces);
+	RebuildJob *job = memnew(RebuildJob);
+	job->build_mesh = true;
+	job->build_physics = root_collision_shape.is_valid();
+	job->root_entry = _prepare_rebuild(job);
+	job->root_brush = brush;
+
+	if (is_inside_tree() && Engine::get_singleton()->is_editor_hint()) {
+		//don't stall the editor while the tree is being merged, keep showing the previous result
+		rebuild_job = job;
+		job->task = WorkerThreadPool::get_singleton()->add_task(_rebuild_task, job, WorkerThreadPool::PRIORITY_LOW);
+		set_process_internal(true);
+		return;
 	}
 
-	set_base(root_mesh->get_rid());
+	_execute_rebuild(job);
+	_apply_rebuild(job);
+	memdelete(job);
 }
+
 AABB CSGShape::get_aabb() const {
 	return node_aabb;
 }
@@ -367,6 +605,7 @@ void CSGShape::_notification(int p_what) {
 			PhysicsServer::get_singleton()->body_set_space(root_collision_instance, get_world()->get_space());
 		}
 
+		dirty = false; //always let the parent know
 		_make_dirty();
 	}
 
@@ -374,14 +613,27 @@ void CSGShape::_notification(int p_what) {
 
 		//print_line("local xform changed");
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_subtree_dirty();
+		}
+	}
+
+	if (p_what == NOTIFICATION_INTERNAL_PROCESS) {
+
+		if (rebuild_job && WorkerThreadPool::get_singleton()->is_group_task_completed(rebuild_job->task)) {
+			_finish_rebuild();
+			if (dirty) {
+				_update_shape();
+			}
 		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 
+		//brushes of this subtree may be in use by a rebuild running in the background
+		_get_root_shape()->_finish_rebuild();
+
 		if (parent)
-			parent->_make_dirty();
+			parent->_make_subtree_dirty();
 		parent = NULL;
 
 		if (use_collision && is_root_shape()) {
@@ -396,7 +648,9 @@ void CSGShape::_notification(int p_what) {
 void CSGShape::set_operation(Operation p_operation) {
 
 	operation = p_operation;
-	_make_dirty();
+	if (parent) {
+		parent->_make_subtree_dirty(); //only affects how the parent merges this node
+	}
 }
 
 CSGShape::Operation CSGShape::get_operation() const {
@@ -435,8 +689,12 @@ void CSGShape::_bind_methods() {
 
 CSGShape::CSGShape() {
 	brush = NULL;
+	self_brush = NULL;
+	brush_version = 0;
+	rebuild_job = NULL;
 	set_notify_local_transform(true);
 	dirty = false;
+	self_dirty = true;
 	parent = NULL;
 	use_collision = false;
 	operation = OPERATION_UNION;
@@ -444,10 +702,21 @@ CSGShape::CSGShape() {
 }
 
 CSGShape::~CSGShape() {
-	if (brush) {
-		memdelete(brush);
-		brush = NULL;
+
+	_finish_rebuild();
+
+	for (int i = 0; i < merge_steps.size(); i++) {
+		if (merge_steps[i].result) {
+			memdelete(merge_steps[i].result);
+		}
+	}
+	merge_steps.clear();
+
+	if (self_brush) {
+		memdelete(self_brush);
+		self_brush = NULL;
 	}
+	brush = NULL;
 }
 //////////////////////////////////
 
@@ -52,11 +52,25 @@ private:
 	Operation operation;
 	CSGShape *parent;
 
-	CSGBrush *brush;
+	CSGBrush *brush; //result of the whole subtree, either self_brush or the last merge result
+	CSGBrush *self_brush;
+	uint32_t brush_version;
+
+	struct MergeStep {
+		ObjectID child;
+		uint32_t version;
+		Transform xform;
+		Operation operation;
+		CSGBrush *result; //NULL when nothing was merged yet
+	};
+
+	//merges of each child into the brush, kept so only the ones after a change are redone
+	Vector<MergeStep> merge_steps;
 
 	AABB node_aabb;
 
 	bool dirty;
+	bool self_dirty;
 	float snap;
 
 	bool use_collision;
@@ -86,6 +100,20 @@ private:
 		PoolVector<Vector2>::Write uvsw;
 	};
 
+	struct RebuildJob;
+	RebuildJob *rebuild_job;
+
+	CSGShape *_get_root_shape();
+	static AABB _get_brush_aabb(const CSGBrush *p_brush);
+	static void _build_surfaces(const CSGBrush *n, Vector<ShapeUpdateSurface> &surfaces, PoolVector<Vector3> *r_physics_faces);
+
+	int _prepare_rebuild(RebuildJob *p_job);
+	static void _execute_rebuild(RebuildJob *p_job);
+	static void _rebuild_task(void *p_userdata, uint32_t p_index);
+	void _apply_rebuild(RebuildJob *p_job);
+	void _finish_rebuild();
+
+	void _make_subtree_dirty();
 	void _update_shape();
 
 protected:
@@ -111,6 +111,7 @@ Error NetworkedMultiplayerENet::create_server(int p_port, int p_max_clients, int
 	refuse_connections = false;
 	unique_id = 1;
 	connection_status = CONNECTION_CONNECTED;
+	_start_thread();
 	return OK;
 }
 Error NetworkedMultiplayerENet::create_client(const String &p_address, int p_port, int p_in_bandwidth, int p_out_bandwidth, int p_client_port) {
@@ -196,6 +197,7 @@ Error NetworkedMultiplayerENet::create_client(const String &p_address, int p_por
 	active = true;
 	server = false;
 	refuse_connections = false;
+	_start_thread();
 
 	return OK;
 }
@@ -206,6 +208,12 @@ void NetworkedMultiplayerENet::poll() {
 
 	_pop_current_packet();
 
+	if (thread_running) {
+		// the network thread services the host, only pick up what it received
+		_flush_thread_events();
+		return;
+	}
+
 	ENetEvent event;
 	/* Wait up to 1000 milliseconds for an event. */
 	while (true) {
@@ -222,199 +230,350 @@ void NetworkedMultiplayerENet::poll() {
 			break;
 		}
 
-		switch (event.type) {
-			case ENET_EVENT_TYPE_CONNECT: {
-				// Store any relevant client information here.
+		_handle_event(event);
+	}
+}
 
-				if (server && refuse_connections) {
-					enet_peer_reset(event.peer);
-					break;
-				}
+void NetworkedMultiplayerENet::_handle_event(const ENetEvent &event) {
+
+	switch (event.type) {
+		case ENET_EVENT_TYPE_CONNECT: {
+			// Store any relevant client information here.
+
+			if (server && refuse_connections) {
+				enet_peer_reset(event.peer);
+				break;
+			}
+
+			int *new_id = memnew(int);
+			*new_id = event.data;
+
+			if (*new_id == 0) { // Data zero is sent by server (enet won't let you configure this). Server is always 1.
+				*new_id = 1;
+			}
+
+			event.peer->data = new_id;
+
+			peer_map[*new_id] = event.peer;
+
+			_notify(EVENT_PEER_CONNECTED, *new_id);
 
-				int *new_id = memnew(int);
-				*new_id = event.data;
+			if (server) {
+				// Someone connected, notify all the peers available
+				for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
 
-				if (*new_id == 0) { // Data zero is sent by server (enet won't let you configure this). Server is always 1.
-					*new_id = 1;
+					if (E->key() == *new_id)
+						continue;
+					// Send existing peers to new peer
+					ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
+					encode_uint32(E->key(), &packet->data[4]);
+					enet_peer_send(event.peer, SYSCH_CONFIG, packet);
+					// Send the new peer to existing peers
+					packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
+					encode_uint32(*new_id, &packet->data[4]);
+					enet_peer_send(E->get(), SYSCH_CONFIG, packet);
 				}
+			} else {
 
-				event.peer->data = new_id;
+				_notify(EVENT_CONNECTION_SUCCEEDED, 0);
+			}
+
+		} break;
+		case ENET_EVENT_TYPE_DISCONNECT: {
 
-				peer_map[*new_id] = event.peer;
+			// Reset the peer's client information.
 
-				connection_status = CONNECTION_CONNECTED; // If connecting, this means it connected to something!
+			int *id = (int *)event.peer->data;
 
-				emit_signal("peer_connected", *new_id);
+			if (!id) {
+				if (!server) {
+					_notify(EVENT_CONNECTION_FAILED, 0);
+				}
+			} else {
 
 				if (server) {
-					// Someone connected, notify all the peers available
+					// Someone disconnected, notify everyone else
 					for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
 
-						if (E->key() == *new_id)
+						if (E->key() == *id)
 							continue;
-						// Send existing peers to new peer
+
 						ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
-						encode_uint32(E->key(), &packet->data[4]);
-						enet_peer_send(event.peer, SYSCH_CONFIG, packet);
-						// Send the new peer to existing peers
-						packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
-						encode_uint32(*new_id, &packet->data[4]);
+						encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
+						encode_uint32(*id, &packet->data[4]);
 						enet_peer_send(E->get(), SYSCH_CONFIG, packet);
 					}
-				} else {
+				} else if (!server) {
+					_notify(EVENT_SERVER_DISCONNECTED, 0);
+					return;
+				}
+
+				_notify(EVENT_PEER_DISCONNECTED, *id);
+				peer_map.erase(*id);
+				memdelete(id);
+			}
+
+		} break;
+		case ENET_EVENT_TYPE_RECEIVE: {
+
+			if (event.channelID == SYSCH_CONFIG) {
+				// Some config message
+				ERR_FAIL_COND(event.packet->dataLength < 8);
+
+				// Only server can send config messages
+				ERR_FAIL_COND(server);
+
+				int msg = decode_uint32(&event.packet->data[0]);
+				int id = decode_uint32(&event.packet->data[4]);
 
-					emit_signal("connection_succeeded");
+				switch (msg) {
+					case SYSMSG_ADD_PEER: {
+
+						peer_map[id] = NULL;
+						_notify(EVENT_PEER_CONNECTED, id);
+
+					} break;
+					case SYSMSG_REMOVE_PEER: {
+
+						peer_map.erase(id);
+						_notify(EVENT_PEER_DISCONNECTED, id);
+					} break;
 				}
 
-			} break;
-			case ENET_EVENT_TYPE_DISCONNECT: {
+				enet_packet_destroy(event.packet);
+			} else if (event.channelID < channel_count) {
 
-				// Reset the peer's client information.
+				Packet packet;
+				packet.packet = event.packet;
 
-				int *id = (int *)event.peer->data;
+				uint32_t *id = (uint32_t *)event.peer->data;
 
-				if (!id) {
-					if (!server) {
-						emit_signal("connection_failed");
-					}
-				} else {
+				ERR_FAIL_COND(event.packet->dataLength < 12)
+
+				uint32_t source = decode_uint32(&event.packet->data[0]);
+				int target = decode_uint32(&event.packet->data[4]);
+				uint32_t flags = decode_uint32(&event.packet->data[8]);
+
+				packet.from = source;
+				packet.channel = event.channelID;
 
-					if (server) {
-						// Someone disconnected, notify everyone else
+				if (server) {
+					// Someone is cheating and trying to fake the source!
+					ERR_FAIL_COND(source != *id);
+
+					packet.from = *id;
+
+					if (target == 0) {
+						// Re-send to everyone but sender :|
+
+						_queue_packet(packet);
+						// And make copies for sending
 						for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
 
-							if (E->key() == *id)
+							if (uint32_t(E->key()) == source) // Do not resend to self
 								continue;
 
-							ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
-							encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
-							encode_uint32(*id, &packet->data[4]);
-							enet_peer_send(E->get(), SYSCH_CONFIG, packet);
+							ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+
+							enet_peer_send(E->get(), event.channelID, packet2);
 						}
-					} else if (!server) {
-						emit_signal("server_disconnected");
-						close_connection();
-						return;
+
+					} else if (target < 0) {
+						// To all but one
+
+						// And make copies for sending
+						for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+
+							if (uint32_t(E->key()) == source || E->key() == -target) // Do not resend to self, also do not send to excluded
+								continue;
+
+							ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+
+							enet_peer_send(E->get(), event.channelID, packet2);
+						}
+
+						if (-target != 1) {
+							// Server is not excluded
+							_queue_packet(packet);
+						} else {
+							// Server is excluded, erase packet
+							enet_packet_destroy(packet.packet);
+						}
+
+					} else if (target == 1) {
+						// To myself and only myself
+						_queue_packet(packet);
+					} else {
+						// To someone else, specifically
+						ERR_FAIL_COND(!peer_map.has(target));
+						enet_peer_send(peer_map[target], event.channelID, packet.packet);
 					}
+				} else {
 
-					emit_signal("peer_disconnected", *id);
-					peer_map.erase(*id);
-					memdelete(id);
+					_queue_packet(packet);
 				}
 
-			} break;
-			case ENET_EVENT_TYPE_RECEIVE: {
+				// Destroy packet later
+			} else {
+				ERR_FAIL();
+			}
 
-				if (event.channelID == SYSCH_CONFIG) {
-					// Some config message
-					ERR_CONTINUE(event.packet->dataLength < 8);
+		} break;
+		case ENET_EVENT_TYPE_NONE: {
+			// Do nothing
+		} break;
+	}
+}
 
-					// Only server can send config messages
-					ERR_CONTINUE(server);
+void NetworkedMultiplayerENet::_notify(int p_event, int p_id) {
 
-					int msg = decode_uint32(&event.packet->data[0]);
-					int id = decode_uint32(&event.packet->data[4]);
+	if (!thread_running) {
+		_emit_event(p_event, p_id);
+		return;
+	}
 
-					switch (msg) {
-						case SYSMSG_ADD_PEER: {
+	ThreadEvent ev;
+	ev.type = p_event;
+	ev.id = p_id;
+	ev.packet.packet = NULL;
 
-							peer_map[id] = NULL;
-							emit_signal("peer_connected", id);
+	event_mutex->lock();
+	thread_events.push_back(ev);
+	event_mutex->unlock();
+}
 
-						} break;
-						case SYSMSG_REMOVE_PEER: {
+void NetworkedMultiplayerENet::_queue_packet(const Packet &p_packet) {
 
-							peer_map.erase(id);
-							emit_signal("peer_disconnected", id);
-						} break;
-					}
+	if (!thread_running) {
+		incoming_packets.push_back(p_packet);
+		return;
+	}
 
-					enet_packet_destroy(event.packet);
-				} else if (event.channelID < channel_count) {
+	// packets go through the same queue as notifications, to keep their order
+	ThreadEvent ev;
+	ev.type = EVENT_PACKET;
+	ev.id = 0;
+	ev.packet = p_packet;
 
-					Packet packet;
-					packet.packet = event.packet;
+	event_mutex->lock();
+	thread_events.push_back(ev);
+	event_mutex->unlock();
+}
 
-					uint32_t *id = (uint32_t *)event.peer->data;
+void NetworkedMultiplayerENet::_emit_event(int p_event, int p_id) {
 
-					ERR_CONTINUE(event.packet->dataLength < 12)
+	switch (p_event) {
+		case EVENT_PEER_CONNECTED: {
 
-					uint32_t source = decode_uint32(&event.packet->data[0]);
-					int target = decode_uint32(&event.packet->data[4]);
-					uint32_t flags = decode_uint32(&event.packet->data[8]);
+			connection_status = CONNECTION_CONNECTED; // If connecting, this means it connected to something!
+			emit_signal("peer_connected", p_id);
+		} break;
+		case EVENT_PEER_DISCONNECTED: {
 
-					packet.from = source;
-					packet.channel = event.channelID;
+			emit_signal("peer_disconnected", p_id);
+		} break;
+		case EVENT_CONNECTION_SUCCEEDED: {
 
-					if (server) {
-						// Someone is cheating and trying to fake the source!
-						ERR_CONTINUE(source != *id);
+			emit_signal("connection_succeeded");
+		} break;
+		case EVENT_CONNECTION_FAILED: {
 
-						packet.from = *id;
+			emit_signal("connection_failed");
+		} break;
+		case EVENT_SERVER_DISCONNECTED: {
 
-						if (target == 0) {
-							// Re-send to everyone but sender :|
+			emit_signal("server_disconnected");
+			close_connection();
+		} break;
+	}
+}
 
-							incoming_packets.push_back(packet);
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+void NetworkedMultiplayerENet::_flush_thread_events() {
 
-								if (uint32_t(E->key()) == source) // Do not resend to self
-									continue;
+	event_mutex->lock();
+	Vector<ThreadEvent> events = thread_events;
+	thread_events.clear();
+	event_mutex->unlock();
 
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+	for (int i = 0; i < events.size(); i++) {
 
-								enet_peer_send(E->get(), event.channelID, packet2);
-							}
+		const ThreadEvent &ev = events[i];
 
-						} else if (target < 0) {
-							// To all but one
+		if (!active) {
+			// Disconnected while emitting a notification, drop the rest
+			if (ev.packet.packet) {
+				enet_packet_destroy(ev.packet.packet);
+			}
+			continue;
+		}
 
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+		if (ev.type == EVENT_PACKET) {
+			incoming_packets.push_back(ev.packet);
+		} else {
+			_emit_event(ev.type, ev.id);
+		}
+	}
+}
 
-								if (uint32_t(E->key()) == source || E->key() == -target) // Do not resend to self, also do not send to excluded
-									continue;
+void NetworkedMultiplayerENet::_thread_func(void *p_ud) {
 
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+	NetworkedMultiplayerENet *enet = (NetworkedMultiplayerENet *)p_ud;
 
-								enet_peer_send(E->get(), event.channelID, packet2);
-							}
+	while (!enet->thread_exit) {
 
-							if (-target != 1) {
-								// Server is not excluded
-								incoming_packets.push_back(packet);
-							} else {
-								// Server is excluded, erase packet
-								enet_packet_destroy(packet.packet);
-							}
+		int processed = 0;
 
-						} else if (target == 1) {
-							// To myself and only myself
-							incoming_packets.push_back(packet);
-						} else {
-							// To someone else, specifically
-							ERR_CONTINUE(!peer_map.has(target));
-							enet_peer_send(peer_map[target], event.channelID, packet.packet);
-						}
-					} else {
+		enet->host_mutex->lock();
+		ENetEvent event;
+		while (!enet->thread_exit && enet_host_service(enet->host, &event, 0) > 0) {
+			enet->_handle_event(event);
+			processed++;
+		}
+		enet->host_mutex->unlock();
 
-						incoming_packets.push_back(packet);
-					}
+		if (processed == 0) {
+			// the socket layer can't block until data arrives, so just sleep a little
+			OS::get_singleton()->delay_usec(enet->thread_poll_usec);
+		}
+	}
+}
 
-					// Destroy packet later
-				} else {
-					ERR_CONTINUE(true);
-				}
+void NetworkedMultiplayerENet::_start_thread() {
+
+	if (!use_thread)
+		return;
+
+	host_mutex = Mutex::create();
+	event_mutex = Mutex::create();
+	thread_exit = false;
+	thread_running = true; // before the thread starts handling events
+	thread = Thread::create(_thread_func, this);
+}
+
+void NetworkedMultiplayerENet::_stop_thread() {
+
+	if (!thread)
+		return;
+
+	thread_exit = true;
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = NULL;
+	thread_running = false;
 
-			} break;
-			case ENET_EVENT_TYPE_NONE: {
-				// Do nothing
-			} break;
+	for (int i = 0; i < thread_events.size(); i++) {
+		if (thread_events[i].packet.packet) {
+			enet_packet_destroy(thread_events[i].packet.packet);
 		}
 	}
+	thread_events.clear();
+
+	memdelete(host_mutex);
+	host_mutex = NULL;
+	memdelete(event_mutex);
+	event_mutex = NULL;
 }
 
 bool NetworkedMultiplayerENet::is_server() const {
@@ -428,6 +587,7 @@ void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 	ERR_FAIL_COND(!active);
 	ERR_FAIL_COND(wait_usec < 0);
 
+	_stop_thread();
 	_pop_current_packet();
 
 	bool peers_disconnected = false;
@@ -457,6 +617,8 @@ void NetworkedMultiplayerENet::disconnect_peer(int p_peer, bool now) {
 
 	ERR_FAIL_COND(!active);
 	ERR_FAIL_COND(!is_server());
+
+	MutexLock lock(host_mutex);
 	ERR_FAIL_COND(!peer_map.has(p_peer))
 
 	if (now) {
@@ -532,6 +694,8 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 	if (transfer_channel > SYSCH_CONFIG)
 		channel = transfer_channel;
 
+	MutexLock lock(host_mutex);
+
 	Map<int, ENetPeer *>::Element *E = NULL;
 
 	if (target_peer != 0) {
@@ -757,6 +921,7 @@ void NetworkedMultiplayerENet::enet_compressor_destroy(void *context) {
 
 IP_Address NetworkedMultiplayerENet::get_peer_address(int p_peer_id) const {
 
+	MutexLock lock(host_mutex);
 	ERR_FAIL_COND_V(!peer_map.has(p_peer_id), IP_Address());
 	ERR_FAIL_COND_V(!is_server() && p_peer_id != 1, IP_Address());
 	ERR_FAIL_COND_V(peer_map[p_peer_id] == NULL, IP_Address());
@@ -773,6 +938,7 @@ IP_Address NetworkedMultiplayerENet::get_peer_address(int p_peer_id) const {
 
 int NetworkedMultiplayerENet::get_peer_port(int p_peer_id) const {
 
+	MutexLock lock(host_mutex);
 	ERR_FAIL_COND_V(!peer_map.has(p_peer_id), 0);
 	ERR_FAIL_COND_V(!is_server() && p_peer_id != 1, 0);
 	ERR_FAIL_COND_V(peer_map[p_peer_id] == NULL, 0);
@@ -783,6 +949,27 @@ int NetworkedMultiplayerENet::get_peer_port(int p_peer_id) const {
 #endif
 }
 
+Dictionary NetworkedMultiplayerENet::get_peer_statistics(int p_peer_id) const {
+
+	MutexLock lock(host_mutex);
+
+	Dictionary stats;
+	const Map<int, ENetPeer *>::Element *E = peer_map.find(p_peer_id);
+	if (!E || !E->get()) {
+		return stats; // not connected, or only known through the server
+	}
+
+	const ENetPeer *enet_peer = E->get();
+	stats["round_trip_time"] = enet_peer->roundTripTime / 1000.0;
+	stats["round_trip_time_variance"] = enet_peer->roundTripTimeVariance / 1000.0;
+	stats["packet_loss"] = enet_peer->packetLoss / float(ENET_PEER_PACKET_LOSS_SCALE);
+	// totals are reset by the host on every bandwidth throttle interval, about a second
+	stats["incoming_bytes"] = enet_peer->incomingDataTotal;
+	stats["outgoing_bytes"] = enet_peer->outgoingDataTotal;
+
+	return stats;
+}
+
 void NetworkedMultiplayerENet::set_transfer_channel(int p_channel) {
 
 	ERR_FAIL_COND(p_channel < -1 || p_channel >= channel_count);
@@ -817,6 +1004,16 @@ bool NetworkedMultiplayerENet::is_always_ordered() const {
 	return always_ordered;
 }
 
+void NetworkedMultiplayerENet::set_use_thread(bool p_enable) {
+
+	ERR_FAIL_COND(active);
+	use_thread = p_enable;
+}
+
+bool NetworkedMultiplayerENet::is_using_thread() const {
+	return use_thread;
+}
+
 void NetworkedMultiplayerENet::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("create_server", "port", "max_clients", "in_bandwidth", "out_bandwidth"), &NetworkedMultiplayerENet::create_server, DEFVAL(32), DEFVAL(0), DEFVAL(0));
@@ -837,11 +1034,14 @@ void NetworkedMultiplayerENet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_channel_count"), &NetworkedMultiplayerENet::get_channel_count);
 	ClassDB::bind_method(D_METHOD("set_always_ordered", "ordered"), &NetworkedMultiplayerENet::set_always_ordered);
 	ClassDB::bind_method(D_METHOD("is_always_ordered"), &NetworkedMultiplayerENet::is_always_ordered);
+	ClassDB::bind_method(D_METHOD("set_use_thread", "enable"), &NetworkedMultiplayerENet::set_use_thread);
+	ClassDB::bind_method(D_METHOD("is_using_thread"), &NetworkedMultiplayerENet::is_using_thread);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "compression_mode", PROPERTY_HINT_ENUM, "None,Range Coder,FastLZ,ZLib,ZStd"), "set_compression_mode", "get_compression_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "transfer_channel"), "set_transfer_channel", "get_transfer_channel");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "channel_count"), "set_channel_count", "get_channel_count");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "always_ordered"), "set_always_ordered", "is_always_ordered");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_thread"), "set_use_thread", "is_using_thread");
 
 	BIND_ENUM_CONSTANT(COMPRESS_NONE);
 	BIND_ENUM_CONSTANT(COMPRESS_RANGE_CODER);
@@ -864,6 +1064,13 @@ NetworkedMultiplayerENet::NetworkedMultiplayerENet() {
 	always_ordered = false;
 	connection_status = CONNECTION_DISCONNECTED;
 	compression_mode = COMPRESS_NONE;
+	use_thread = false;
+	thread = NULL;
+	host_mutex = NULL;
+	event_mutex = NULL;
+	thread_exit = false;
+	thread_running = false;
+	thread_poll_usec = 1000;
 	enet_compressor.context = this;
 	enet_compressor.compress = enet_compress;
 	enet_compressor.decompress = enet_decompress;
@@ -33,6 +33,8 @@
 
 #include "io/compression.h"
 #include "io/networked_multiplayer_peer.h"
+#include "os/mutex.h"
+#include "os/thread.h"
 
 #include <enet/enet.h>
 
@@ -54,6 +56,15 @@ private:
 		SYSMSG_REMOVE_PEER
 	};
 
+	enum {
+		EVENT_PEER_CONNECTED,
+		EVENT_PEER_DISCONNECTED,
+		EVENT_CONNECTION_SUCCEEDED,
+		EVENT_CONNECTION_FAILED,
+		EVENT_SERVER_DISCONNECTED,
+		EVENT_PACKET
+	};
+
 	enum {
 		SYSCH_CONFIG,
 		SYSCH_RELIABLE,
@@ -98,6 +109,35 @@ private:
 	uint32_t _gen_unique_id() const;
 	void _pop_current_packet();
 
+	void _handle_event(const ENetEvent &event);
+	void _notify(int p_event, int p_id);
+	void _queue_packet(const Packet &p_packet);
+	void _emit_event(int p_event, int p_id);
+
+	// With use_thread, a thread services the host and relays packets. The host and
+	// peer_map are then only touched with host_mutex held, and whatever needs to
+	// reach the main thread goes through thread_events in arrival order.
+	struct ThreadEvent {
+
+		int type;
+		int id;
+		Packet packet;
+	};
+
+	bool use_thread;
+	Thread *thread;
+	Mutex *host_mutex;
+	Mutex *event_mutex;
+	volatile bool thread_exit;
+	bool thread_running;
+	int thread_poll_usec;
+	Vector<ThreadEvent> thread_events;
+
+	static void _thread_func(void *p_ud);
+	void _start_thread();
+	void _stop_thread();
+	void _flush_thread_events();
+
 	Vector<uint8_t> src_compressor_mem;
 	Vector<uint8_t> dst_compressor_mem;
 
@@ -121,6 +161,7 @@ public:
 
 	virtual IP_Address get_peer_address(int p_peer_id) const;
 	virtual int get_peer_port(int p_peer_id) const;
+	virtual Dictionary get_peer_statistics(int p_peer_id) const;
 
 	Error create_server(int p_port, int p_max_clients = 32, int p_in_bandwidth = 0, int p_out_bandwidth = 0);
 	Error create_client(const String &p_address, int p_port, int p_in_bandwidth = 0, int p_out_bandwidth = 0, int p_client_port = 0);
@@ -157,6 +198,8 @@ public:
 	int get_channel_count() const;
 	void set_always_ordered(bool p_ordered);
 	bool is_always_ordered() const;
+	void set_use_thread(bool p_enable);
+	bool is_using_thread() const;
 
 	NetworkedMultiplayerENet();
 	~NetworkedMultiplayerENet();
@@ -69,6 +69,24 @@ void GDAPI godot_method_bind_ptrcall(godot_method_bind *p_method_bind, godot_obj
 	mb->ptrcall(o, p_args, p_ret);
 }
 
+void GDAPI godot_method_bind_ptrcall_batch(godot_method_bind *p_method_bind, godot_object **p_instances, const int p_instance_stride, const void **p_args, const int p_args_stride, void *p_rets, const int p_rets_stride, const int p_count) {
+
+	MethodBind *mb = (MethodBind *)p_method_bind;
+	ERR_FAIL_COND(!mb);
+	ERR_FAIL_COND(!p_instances);
+
+	Object **instances = (Object **)p_instances;
+	uint8_t *rets = (uint8_t *)p_rets;
+
+	for (int i = 0; i < p_count; i++) {
+
+		Object *o = instances[i * p_instance_stride];
+		ERR_CONTINUE(!o);
+
+		mb->ptrcall(o, p_args ? p_args + i * p_args_stride : NULL, rets ? rets + i * p_rets_stride : NULL);
+	}
+}
+
 godot_variant GDAPI godot_method_bind_call(godot_method_bind *p_method_bind, godot_object *p_instance, const godot_variant **p_args, const int p_arg_count, godot_variant_call_error *p_call_error) {
 	MethodBind *mb = (MethodBind *)p_method_bind;
 	Object *o = (Object *)p_instance;
@@ -11,17 +11,48 @@ def _spaced(e):
     return e if e[-1] == '*' else e + ' '
 
 
+def _core_versions(api):
+    # core API versions newer than 1.0, chained through the 'next' pointer of the core struct
+    versions = []
+    core = api['core']['next']
+    while core:
+        versions.append(core)
+        core = core['next']
+    return versions
+
+
+def _core_struct_name(core):
+    return 'godot_gdnative_core_{0}_{1}_api_struct'.format(core['version']['major'], core['version']['minor'])
+
+
+def _core_wrapper_name(core):
+    return '_gdnative_wrapper_api_{0}_{1}_struct'.format(core['version']['major'], core['version']['minor'])
+
+
 def _build_gdnative_api_struct_header(api):
     gdnative_api_init_macro = [
         '\textern const godot_gdnative_core_api_struct *_gdnative_wrapper_api_struct;'
     ]
 
+    for core in _core_versions(api):
+        gdnative_api_init_macro.append(
+            '\textern const {0} *{1};'.format(_core_struct_name(core), _core_wrapper_name(core)))
+
     for ext in api['extensions']:
         name = ext['name']
         gdnative_api_init_macro.append(
             '\textern const godot_gdnative_ext_{0}_api_struct *_gdnative_wrapper_{0}_api_struct;'.format(name))
 
     gdnative_api_init_macro.append('\t_gdnative_wrapper_api_struct = options->api_struct;')
+
+    if _core_versions(api):
+        gdnative_api_init_macro.append('\tfor (const godot_gdnative_api_struct *core = _gdnative_wrapper_api_struct->next; core; core = core->next) { ')
+        for core in _core_versions(api):
+            gdnative_api_init_macro.append(
+                '\t\tif (core->version.major == {0} && core->version.minor == {1})'.format(core['version']['major'], core['version']['minor']))
+            gdnative_api_init_macro.append(
+                '\t\t\t{0} = (const {1} *)core;'.format(_core_wrapper_name(core), _core_struct_name(core)))
+        gdnative_api_init_macro.append('\t}')
     gdnative_api_init_macro.append('\tfor (unsigned int i = 0; i < _gdnative_wrapper_api_struct->num_extensions; i++) { ')
     gdnative_api_init_macro.append('\t\tswitch (_gdnative_wrapper_api_struct->extensions[i]->type) {')
 
@@ -86,6 +117,20 @@ def _build_gdnative_api_struct_header(api):
         name = ext['name']
         out += generate_extension_struct(name, ext, False)
 
+    for core in _core_versions(api):
+        out += [
+            'typedef struct ' + _core_struct_name(core) + ' {',
+            '\tunsigned int type;',
+            '\tgodot_gdnative_api_version version;',
+            '\tconst godot_gdnative_api_struct *next;'
+        ]
+
+        for funcdef in core['api']:
+            args = ', '.join(['%s%s' % (_spaced(t), n) for t, n in funcdef['arguments']])
+            out.append('\t%s(*%s)(%s);' % (_spaced(funcdef['return_type']), funcdef['name'], args))
+
+        out += ['} ' + _core_struct_name(core) + ';', '']
+
     out += [
         'typedef struct godot_gdnative_core_api_struct {',
         '\tunsigned int type;',
@@ -159,11 +204,31 @@ def _build_gdnative_api_struct_source(api):
 
     out += ['};\n']
 
+    def get_core_struct_instance_name(core):
+        return 'api_{0}_{1}'.format(core['version']['major'], core['version']['minor'])
+
+    def get_core_next_pointer(core):
+        return 'NULL' if not core['next'] else ('(const godot_gdnative_api_struct *)&' + get_core_struct_instance_name(core['next']))
+
+    # newest versions first, each one is referenced by the previous version's next pointer
+    for core in reversed(_core_versions(api)):
+        out += [
+            'extern const ' + _core_struct_name(core) + ' ' + get_core_struct_instance_name(core) + ' = {',
+            '\tGDNATIVE_' + core['type'] + ',',
+            '\t{' + str(core['version']['major']) + ', ' + str(core['version']['minor']) + '},',
+            '\t' + get_core_next_pointer(core) + ','
+        ]
+
+        for funcdef in core['api']:
+            out.append('\t%s,' % funcdef['name'])
+
+        out += ['};\n']
+
     out += [
         'extern const godot_gdnative_core_api_struct api_struct = {',
         '\tGDNATIVE_' + api['core']['type'] + ',',
         '\t{' + str(api['core']['version']['major']) + ', ' + str(api['core']['version']['minor']) + '},',
-        '\tNULL,',
+        '\t' + get_core_next_pointer(api['core']) + ',',
         '\t' + str(len(api['extensions'])) + ',',
         '\tgdnative_extensions_pointers,',
     ]
@@ -205,6 +270,9 @@ def _build_gdnative_wrapper_code(api):
         'godot_gdnative_core_api_struct *_gdnative_wrapper_api_struct = 0;',
     ]
 
+    for core in _core_versions(api):
+        out.append(_core_struct_name(core) + ' *' + _core_wrapper_name(core) + ' = 0;')
+
     for ext in api['extensions']:
         name = ext['name']
         out.append('godot_gdnative_ext_' + name + '_api_struct *_gdnative_wrapper_' + name + '_api_struct = 0;')
@@ -224,6 +292,20 @@ def _build_gdnative_wrapper_code(api):
         out.append('}')
         out.append('')
 
+    for core in _core_versions(api):
+        for funcdef in core['api']:
+            args = ', '.join(['%s%s' % (_spaced(t), n) for t, n in funcdef['arguments']])
+            out.append('%s%s(%s) {' % (_spaced(funcdef['return_type']), funcdef['name'], args))
+
+            args = ', '.join(['%s' % n for t, n in funcdef['arguments']])
+
+            return_line = '\treturn ' if funcdef['return_type'] != 'void' else '\t'
+            return_line += _core_wrapper_name(core) + '->' + funcdef['name'] + '(' + args + ');'
+
+            out.append(return_line)
+            out.append('}')
+            out.append('')
+
     for ext in api['extensions']:
         name = ext['name']
         for funcdef in ext['api']:
@@ -221,6 +221,10 @@ typedef struct {
 
 godot_method_bind GDAPI *godot_method_bind_get_method(const char *p_classname, const char *p_methodname);
 void GDAPI godot_method_bind_ptrcall(godot_method_bind *p_method_bind, godot_object *p_instance, const void **p_args, void *p_ret);
+// Performs p_count ptrcalls in one go. Call i uses p_instances[i * p_instance_stride], the argument pointers starting
+// at p_args[i * p_args_stride] and writes its return value at (uint8_t *)p_rets + i * p_rets_stride. A stride of 0 reuses
+// the same instance or arguments for every call, e.g. to drive a server singleton such as VisualServer directly.
+void GDAPI godot_method_bind_ptrcall_batch(godot_method_bind *p_method_bind, godot_object **p_instances, const int p_instance_stride, const void **p_args, const int p_args_stride, void *p_rets, const int p_rets_stride, const int p_count);
 godot_variant GDAPI godot_method_bind_call(godot_method_bind *p_method_bind, godot_object *p_instance, const godot_variant **p_args, const int p_arg_count, godot_variant_call_error *p_call_error);
 ////// Script API
 
@@ -80,6 +80,9 @@ typedef struct {
 /* Binds a PacketPeerGDNative to the provided interface */
 void GDAPI godot_net_bind_packet_peer(godot_object *p_obj, const godot_net_packet_peer *);
 
+/* Borrows the next packet of any PacketPeer without copying it, valid until the next get_packet or poll */
+godot_error GDAPI godot_net_packet_peer_get_packet(godot_object *p_obj, const uint8_t **r_buffer, godot_int *r_buffer_size);
+
 typedef struct {
 	godot_gdnative_api_version version; /* version of our API */
 
@@ -70,4 +70,15 @@ void GDAPI godot_net_bind_packet_peer(godot_object *p_obj, const godot_net_packe
 
 	((PacketPeerGDNative *)p_obj)->set_native_packet_peer(p_impl);
 }
+
+godot_error GDAPI godot_net_packet_peer_get_packet(godot_object *p_obj, const uint8_t **r_buffer, godot_int *r_buffer_size) {
+
+	PacketPeer *peer = Object::cast_to<PacketPeer>((Object *)p_obj);
+	ERR_FAIL_COND_V(!peer, GODOT_ERR_INVALID_PARAMETER);
+
+	int size = 0;
+	Error err = peer->get_packet(r_buffer, size);
+	*r_buffer_size = size;
+	return (godot_error)err;
+}
 }
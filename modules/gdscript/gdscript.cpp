@@ -31,7 +31,9 @@
 #include "gdscript.h"
 
 #include "engine.h"
+#include "gdscript_compiled_code.h"
 #include "gdscript_compiler.h"
+#include "gdscript_sampler.h"
 #include "global_constants.h"
 #include "io/file_access_encrypted.h"
 #include "os/file_access.h"
@@ -778,6 +780,27 @@ Error GDScript::load_byte_code(const String &p_path) {
 	return OK;
 }
 
+Error GDScript::load_compiled_code(const String &p_path) {
+
+	Vector<uint8_t> data = FileAccess::get_file_as_array(p_path);
+	ERR_FAIL_COND_V(data.size() == 0, ERR_FILE_CANT_READ);
+	path = p_path;
+
+	valid = false;
+	Error err = GDScriptCompiledCode::load(this, data);
+	if (err)
+		return err;
+
+	valid = true;
+
+	for (Map<StringName, Ref<GDScript> >::Element *E = subclasses.front(); E; E = E->next()) {
+
+		_set_subclass_path(E->get(), path);
+	}
+
+	return OK;
+}
+
 Error GDScript::load_source_code(const String &p_path) {
 
 	PoolVector<uint8_t> sourcef;
@@ -1021,6 +1044,33 @@ bool GDScriptInstance::get(const StringName &p_name, Variant &r_ret) const {
 	return false;
 }
 
+int GDScriptInstance::get_member_handle(const StringName &p_name) const {
+
+	const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(p_name);
+	if (!E)
+		return -1;
+
+	// setget and typed members need the checks done by set()/get()
+	if (E->get().setter || E->get().getter || E->get().data_type.has_type)
+		return -1;
+
+	return E->get().index;
+}
+
+bool GDScriptInstance::set_member(int p_handle, const Variant &p_value) {
+
+	ERR_FAIL_INDEX_V(p_handle, members.size(), false);
+	members.write[p_handle] = p_value;
+	return true;
+}
+
+bool GDScriptInstance::get_member(int p_handle, Variant &r_ret) const {
+
+	ERR_FAIL_INDEX_V(p_handle, members.size(), false);
+	r_ret = members[p_handle];
+	return true;
+}
+
 Variant::Type GDScriptInstance::get_property_type(const StringName &p_name, bool *r_is_valid) const {
 
 	const GDScript *sptr = script.ptr();
@@ -1284,12 +1334,17 @@ void GDScriptInstance::reload_members() {
 		member_indices_cache[E->key()] = E->get().index;
 	}
 
+	member_handle_version = atomic_increment(&last_member_handle_version);
+
 #endif
 }
 
+volatile uint64_t GDScriptInstance::last_member_handle_version = 0;
+
 GDScriptInstance::GDScriptInstance() {
 	owner = NULL;
 	base_ref = false;
+	member_handle_version = atomic_increment(&last_member_handle_version);
 }
 
 GDScriptInstance::~GDScriptInstance() {
@@ -1381,6 +1436,14 @@ void GDScriptLanguage::init() {
 
 		_add_global(E->get().name, E->get().ptr);
 	}
+
+#ifndef NO_THREADS
+	// started before any script is compiled, release builds only emit line opcodes for it
+	if (GLOBAL_DEF("debug/settings/profiler/gdscript_sampling", false)) {
+		int interval = GLOBAL_DEF("debug/settings/profiler/gdscript_sampling_interval_usec", 1000);
+		GDScriptSampler::start(interval);
+	}
+#endif
 }
 
 String GDScriptLanguage::get_type() const {
@@ -1397,6 +1460,14 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 	return OK;
 }
 void GDScriptLanguage::finish() {
+
+	if (GDScriptSampler::get_singleton()) {
+		String path = GLOBAL_DEF("debug/settings/profiler/gdscript_sampling_output", "user://gdscript_samples.txt");
+		Error err = GDScriptSampler::get_singleton()->save(path);
+		if (err == OK)
+			print_line("GDScript sampling profiler: " + itos(GDScriptSampler::get_singleton()->get_total_samples()) + " samples saved to '" + path + "'.");
+		GDScriptSampler::stop();
+	}
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -1932,7 +2003,19 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 
 		script->set_script_path(p_original_path); // script needs this.
 		script->set_path(p_original_path);
-		Error err = script->load_byte_code(p_path);
+		Error err = ERR_FILE_NOT_FOUND;
+
+		// Exported projects may ship the compiler output next to the tokens, it carries
+		// no debug info so it's only used when no debugger is attached.
+		String compiled_path = p_path.get_basename() + ".gdo";
+		if (p_path.ends_with(".gdc") && !ScriptDebugger::get_singleton() && FileAccess::exists(compiled_path)) {
+			err = script->load_compiled_code(compiled_path);
+			if (err != OK && OS::get_singleton()->is_stdout_verbose())
+				print_line("Can't use compiled code for '" + p_path + "', compiling the script instead.");
+		}
+
+		if (err != OK)
+			err = script->load_byte_code(p_path);
 
 		if (err != OK) {
 
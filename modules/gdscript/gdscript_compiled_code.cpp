@@ -0,0 +1,931 @@
+/*************************************************************************/
+/*  gdscript_compiled_code.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_compiled_code.h"
+
+#include "gdscript_functions.h"
+#include "io/marshalls.h"
+#include "io/resource_loader.h"
+#include "version.h"
+
+#define COMPILED_CODE_VERSION 1
+
+enum {
+	VALUE_PLAIN,
+	VALUE_ARRAY,
+	VALUE_DICTIONARY,
+	VALUE_NATIVE_CLASS,
+	VALUE_SCRIPT,
+	VALUE_RESOURCE,
+};
+
+struct GDScriptCompiledCode::Writer {
+
+	Vector<uint8_t> data;
+	const GDScript *root;
+	Vector<StringName> global_names; // reverse of the global map
+
+	void put_32(uint32_t p_value) {
+
+		int ofs = data.size();
+		data.resize(ofs + 4);
+		encode_uint32(p_value, &data.write[ofs]);
+	}
+
+	void put_string(const String &p_string) {
+
+		CharString utf8 = p_string.utf8();
+		put_32(utf8.length());
+		int ofs = data.size();
+		data.resize(ofs + utf8.length());
+		if (utf8.length())
+			copymem(&data.write[ofs], utf8.get_data(), utf8.length());
+	}
+
+	bool put_variant(const Variant &p_value) {
+
+		int len;
+		if (encode_variant(p_value, NULL, len) != OK)
+			return false;
+		int ofs = data.size();
+		data.resize(ofs + len);
+		encode_variant(p_value, &data.write[ofs], len);
+		return true;
+	}
+};
+
+struct GDScriptCompiledCode::Reader {
+
+	const uint8_t *ptr;
+	int size;
+	int pos;
+	bool error;
+	LoadState *state;
+
+	uint32_t get_32() {
+
+		if (error || pos + 4 > size) {
+			error = true;
+			return 0;
+		}
+		uint32_t value = decode_uint32(&ptr[pos]);
+		pos += 4;
+		return value;
+	}
+
+	String get_string() {
+
+		uint32_t len = get_32();
+		if (error || len > uint32_t(size - pos)) {
+			error = true;
+			return String();
+		}
+		String string;
+		string.parse_utf8((const char *)&ptr[pos], len);
+		pos += len;
+		return string;
+	}
+
+	Variant get_variant() {
+
+		Variant value;
+		int len;
+		if (error || decode_variant(value, &ptr[pos], size - pos, &len, false) != OK) {
+			error = true;
+			return Variant();
+		}
+		pos += len;
+		return value;
+	}
+
+	Reader(const uint8_t *p_ptr, int p_size, LoadState *p_state) {
+
+		ptr = p_ptr;
+		size = p_size;
+		pos = 0;
+		error = false;
+		state = p_state;
+	}
+};
+
+struct GDScriptCompiledCode::LoadState {
+
+	const uint8_t *data;
+	Vector<GDScript *> classes;
+	Vector<Ref<GDScript> > inner_refs; // keeps inner classes alive until their owner is loaded
+	Vector<int> owners;
+	Vector<StringName> names;
+	Vector<int> offsets;
+	Vector<int> sizes;
+	Vector<int> status;
+
+	enum {
+		STATUS_PENDING,
+		STATUS_LOADING,
+		STATUS_LOADED,
+	};
+};
+
+void GDScriptCompiledCode::_collect_classes(GDScript *p_script, int p_owner, Vector<GDScript *> &r_classes, Vector<int> &r_owners) {
+
+	int index = r_classes.size();
+	r_classes.push_back(p_script);
+	r_owners.push_back(p_owner);
+
+	for (Map<StringName, Ref<GDScript> >::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		_collect_classes(E->get().ptr(), index, r_classes, r_owners);
+	}
+}
+
+bool GDScriptCompiledCode::_write_value(Writer &w, const Variant &p_value) {
+
+	switch (p_value.get_type()) {
+
+		case Variant::OBJECT: {
+
+			Object *obj = p_value;
+			if (!obj) {
+				w.put_32(VALUE_PLAIN);
+				return w.put_variant(Variant());
+			}
+
+			GDScriptNativeClass *native = Object::cast_to<GDScriptNativeClass>(obj);
+			if (native) {
+				w.put_32(VALUE_NATIVE_CLASS);
+				w.put_string(native->get_name());
+				return true;
+			}
+
+			GDScript *script = Object::cast_to<GDScript>(obj);
+			if (script) {
+				// inner classes are referenced through the script file that declares them
+				Vector<String> chain;
+				GDScript *top = script;
+				while (top->_owner) {
+					chain.push_back(top->name);
+					top = top->_owner;
+				}
+
+				String path;
+				if (top != w.root) {
+					path = top->get_path();
+					if (path == String() || path.find("::") != -1)
+						return false;
+					if (path == w.root->get_path())
+						path = String(); // a different instance of the script being saved
+				}
+
+				w.put_32(VALUE_SCRIPT);
+				w.put_string(path);
+				w.put_32(chain.size());
+				for (int i = chain.size() - 1; i >= 0; i--) {
+					w.put_string(chain[i]);
+				}
+				return true;
+			}
+
+			Resource *res = Object::cast_to<Resource>(obj);
+			if (res && res->get_path() != String() && res->get_path().find("::") == -1) {
+				w.put_32(VALUE_RESOURCE);
+				w.put_string(res->get_path());
+				return true;
+			}
+
+			// built-in resources and other objects can't be referenced from the cache
+			return false;
+		} break;
+		case Variant::ARRAY: {
+
+			Array array = p_value;
+			w.put_32(VALUE_ARRAY);
+			w.put_32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				if (!_write_value(w, array[i]))
+					return false;
+			}
+			return true;
+		} break;
+		case Variant::DICTIONARY: {
+
+			Dictionary dict = p_value;
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+			w.put_32(VALUE_DICTIONARY);
+			w.put_32(keys.size());
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				if (!_write_value(w, E->get()) || !_write_value(w, dict[E->get()]))
+					return false;
+			}
+			return true;
+		} break;
+		default: {
+
+			w.put_32(VALUE_PLAIN);
+			return w.put_variant(p_value);
+		}
+	}
+
+	return false;
+}
+
+bool GDScriptCompiledCode::_read_value(Reader &r, Variant &r_value) {
+
+	switch (r.get_32()) {
+
+		case VALUE_PLAIN: {
+
+			r_value = r.get_variant();
+		} break;
+		case VALUE_ARRAY: {
+
+			uint32_t count = r.get_32();
+			Array array;
+			for (uint32_t i = 0; i < count && !r.error; i++) {
+				Variant value;
+				if (!_read_value(r, value))
+					return false;
+				array.push_back(value);
+			}
+			r_value = array;
+		} break;
+		case VALUE_DICTIONARY: {
+
+			uint32_t count = r.get_32();
+			Dictionary dict;
+			for (uint32_t i = 0; i < count && !r.error; i++) {
+				Variant key, value;
+				if (!_read_value(r, key) || !_read_value(r, value))
+					return false;
+				dict[key] = value;
+			}
+			r_value = dict;
+		} break;
+		case VALUE_NATIVE_CLASS: {
+
+			StringName name = r.get_string();
+			const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+			if (!globals.has(name))
+				return false;
+			r_value = GDScriptLanguage::get_singleton()->get_global_array()[globals[name]];
+			if (!Object::cast_to<GDScriptNativeClass>(r_value.operator Object *()))
+				return false;
+		} break;
+		case VALUE_SCRIPT: {
+
+			String path = r.get_string();
+			uint32_t count = r.get_32();
+
+			if (path == String()) {
+
+				LoadState *state = r.state;
+				int index = 0;
+				for (uint32_t i = 0; i < count && !r.error; i++) {
+					StringName name = r.get_string();
+					int found = -1;
+					for (int j = 1; j < state->classes.size(); j++) {
+						if (state->owners[j] == index && state->names[j] == name) {
+							found = j;
+							break;
+						}
+					}
+					if (found == -1)
+						return false;
+					index = found;
+				}
+				r_value = Ref<GDScript>(state->classes[index]);
+			} else {
+
+				Ref<GDScript> script = ResourceLoader::load(path);
+				if (script.is_null())
+					return false;
+				for (uint32_t i = 0; i < count && !r.error; i++) {
+					StringName name = r.get_string();
+					if (!script->subclasses.has(name))
+						return false;
+					script = script->subclasses[name];
+				}
+				r_value = script;
+			}
+		} break;
+		case VALUE_RESOURCE: {
+
+			RES res = ResourceLoader::load(r.get_string());
+			if (res.is_null())
+				return false;
+			r_value = res;
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return !r.error;
+}
+
+bool GDScriptCompiledCode::_write_data_type(Writer &w, const GDScriptDataType &p_type) {
+
+	w.put_32(p_type.has_type);
+	if (!p_type.has_type)
+		return true;
+
+	w.put_32(p_type.kind);
+	w.put_32(p_type.builtin_type);
+	w.put_string(p_type.native_type);
+	return _write_value(w, p_type.script_type);
+}
+
+bool GDScriptCompiledCode::_read_data_type(Reader &r, GDScriptDataType &r_type) {
+
+	r_type = GDScriptDataType();
+	r_type.has_type = r.get_32();
+	if (!r_type.has_type)
+		return !r.error;
+
+	r_type.kind = GDScriptDataType::Kind(r.get_32());
+	r_type.builtin_type = Variant::Type(r.get_32());
+	r_type.native_type = r.get_string();
+
+	Variant script_type;
+	if (!_read_value(r, script_type))
+		return false;
+	r_type.script_type = script_type;
+	return true;
+}
+
+bool GDScriptCompiledCode::_write_function(Writer &w, const GDScriptFunction *p_function) {
+
+	w.put_string(p_function->name);
+	w.put_32(p_function->_static);
+	w.put_32(p_function->rpc_mode);
+	w.put_32(p_function->_argument_count);
+
+	w.put_32(p_function->argument_types.size());
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		if (!_write_data_type(w, p_function->argument_types[i]))
+			return false;
+	}
+	if (!_write_data_type(w, p_function->return_type))
+		return false;
+
+#ifdef TOOLS_ENABLED
+	w.put_32(p_function->arg_names.size());
+	for (int i = 0; i < p_function->arg_names.size(); i++) {
+		w.put_string(p_function->arg_names[i]);
+	}
+#else
+	w.put_32(0);
+#endif
+
+	w.put_32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		if (!_write_value(w, p_function->constants[i]))
+			return false;
+	}
+
+	w.put_32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		w.put_string(p_function->global_names[i]);
+	}
+
+	w.put_32(p_function->call_caches.size());
+
+	w.put_32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		w.put_32(p_function->default_arguments[i]);
+	}
+
+	w.put_32(p_function->_stack_size);
+	w.put_32(p_function->_call_size);
+	w.put_32(p_function->_initial_line);
+
+	// Operands that are not addresses (jumps, counts, lines, types) always stay well
+	// below 1 << ADDR_BITS, so only real global addresses carry the global type bits.
+	Vector<int> reloc_positions;
+	Vector<StringName> reloc_names;
+
+	w.put_32(p_function->code.size());
+	for (int i = 0; i < p_function->code.size(); i++) {
+
+		uint32_t word = p_function->code[i];
+		uint32_t type = word >> GDScriptFunction::ADDR_BITS;
+		uint32_t index = word & GDScriptFunction::ADDR_MASK;
+
+		if (type == GDScriptFunction::ADDR_TYPE_GLOBAL) {
+			if (index >= uint32_t(w.global_names.size()))
+				return false;
+			reloc_positions.push_back(i);
+			reloc_names.push_back(w.global_names[index]);
+			word = GDScriptFunction::ADDR_TYPE_NIL << GDScriptFunction::ADDR_BITS;
+		}
+#ifdef TOOLS_ENABLED
+		else if (type == GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL) {
+			if (index >= uint32_t(p_function->named_globals.size()))
+				return false;
+			reloc_positions.push_back(i);
+			reloc_names.push_back(p_function->named_globals[index]);
+			word = GDScriptFunction::ADDR_TYPE_NIL << GDScriptFunction::ADDR_BITS;
+		}
+#endif
+
+		w.put_32(word);
+	}
+
+	w.put_32(reloc_positions.size());
+	for (int i = 0; i < reloc_positions.size(); i++) {
+		w.put_32(reloc_positions[i]);
+		w.put_string(reloc_names[i]);
+	}
+
+	return true;
+}
+
+bool GDScriptCompiledCode::_read_function(Reader &r, GDScriptFunction *p_function, GDScript *p_script) {
+
+	p_function->name = r.get_string();
+	p_function->_static = r.get_32();
+	p_function->rpc_mode = MultiplayerAPI::RPCMode(r.get_32());
+	p_function->_argument_count = r.get_32();
+
+	uint32_t count = r.get_32();
+	if (r.error || count > uint32_t(r.size - r.pos))
+		return false;
+	p_function->argument_types.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		if (!_read_data_type(r, p_function->argument_types.write[i]))
+			return false;
+	}
+	if (!_read_data_type(r, p_function->return_type))
+		return false;
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		StringName arg_name = r.get_string();
+#ifdef TOOLS_ENABLED
+		p_function->arg_names.push_back(arg_name);
+#endif
+	}
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		Variant value;
+		if (!_read_value(r, value))
+			return false;
+		p_function->constants.push_back(value);
+	}
+	p_function->_constant_count = p_function->constants.size();
+	p_function->_constants_ptr = p_function->constants.size() ? p_function->constants.ptrw() : NULL;
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		p_function->global_names.push_back(r.get_string());
+	}
+	p_function->_global_names_count = p_function->global_names.size();
+	p_function->_global_names_ptr = p_function->global_names.size() ? p_function->global_names.ptr() : NULL;
+
+	count = r.get_32();
+	if (r.error || count > uint32_t(r.size))
+		return false;
+	p_function->call_caches.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		p_function->call_caches.write[i].class_name = NULL;
+		p_function->call_caches.write[i].method = NULL;
+		p_function->call_caches.write[i].builtin_type = Variant::VARIANT_MAX;
+		p_function->call_caches.write[i].builtin_method = NULL;
+	}
+	p_function->_call_cache_count = p_function->call_caches.size();
+	p_function->_call_caches_ptr = p_function->call_caches.size() ? p_function->call_caches.ptrw() : NULL;
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		p_function->default_arguments.push_back(r.get_32());
+	}
+	p_function->_default_arg_count = p_function->default_arguments.size() ? p_function->default_arguments.size() - 1 : 0;
+	p_function->_default_arg_ptr = p_function->default_arguments.size() ? p_function->default_arguments.ptr() : NULL;
+
+	p_function->_stack_size = r.get_32();
+	p_function->_call_size = r.get_32();
+	p_function->_initial_line = r.get_32();
+
+	count = r.get_32();
+	if (r.error || count > uint32_t(r.size - r.pos) / 4)
+		return false;
+	p_function->code.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		p_function->code.write[i] = r.get_32();
+	}
+
+	const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+
+		uint32_t pos = r.get_32();
+		StringName name = r.get_string();
+		if (pos >= uint32_t(p_function->code.size()))
+			return false;
+
+		if (globals.has(name)) {
+			p_function->code.write[pos] = globals[name] | (GDScriptFunction::ADDR_TYPE_GLOBAL << GDScriptFunction::ADDR_BITS);
+			continue;
+		}
+#ifdef TOOLS_ENABLED
+		if (GDScriptLanguage::get_singleton()->get_named_globals_map().has(name)) {
+			int idx = p_function->named_globals.find(name);
+			if (idx == -1) {
+				idx = p_function->named_globals.size();
+				p_function->named_globals.push_back(name);
+			}
+			p_function->code.write[pos] = idx | (GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL << GDScriptFunction::ADDR_BITS);
+			continue;
+		}
+#endif
+		// the global went away since the export (e.g. a removed autoload)
+		return false;
+	}
+
+#ifdef TOOLS_ENABLED
+	p_function->_named_globals_count = p_function->named_globals.size();
+	p_function->_named_globals_ptr = p_function->named_globals.size() ? p_function->named_globals.ptr() : NULL;
+#endif
+	p_function->_code_size = p_function->code.size();
+	p_function->_code_ptr = p_function->code.size() ? p_function->code.ptr() : NULL;
+
+	p_function->_script = p_script;
+	p_function->source = r.state->classes[0]->get_path();
+
+#ifdef DEBUG_ENABLED
+	p_function->func_cname = (String(p_function->source) + " - " + String(p_function->name)).utf8();
+	p_function->_func_cname = p_function->func_cname.get_data();
+#endif
+
+	return !r.error;
+}
+
+bool GDScriptCompiledCode::_write_class(Writer &w, const GDScript *p_script) {
+
+	w.put_string(p_script->name);
+	w.put_32(p_script->tool);
+	w.put_string(p_script->native.is_valid() ? String(p_script->native->get_name()) : String());
+
+	w.put_32(p_script->base.is_valid());
+	if (p_script->base.is_valid()) {
+		if (!_write_value(w, p_script->base))
+			return false;
+	}
+
+	// only the members declared here, the rest is copied from the base when loading
+	w.put_32(p_script->members.size());
+	for (Set<StringName>::Element *E = p_script->members.front(); E; E = E->next()) {
+
+		const GDScript::MemberInfo &minfo = p_script->member_indices[E->get()];
+		w.put_string(E->get());
+		w.put_32(minfo.index);
+		w.put_string(minfo.setter);
+		w.put_string(minfo.getter);
+		w.put_32(minfo.rpc_mode);
+		if (!_write_data_type(w, minfo.data_type))
+			return false;
+
+		const PropertyInfo &pinfo = p_script->member_info[E->get()];
+		w.put_32(pinfo.type);
+		w.put_string(pinfo.class_name);
+		w.put_32(pinfo.hint);
+		w.put_string(pinfo.hint_string);
+		w.put_32(pinfo.usage);
+
+#ifdef TOOLS_ENABLED
+		w.put_32(p_script->member_default_values.has(E->get()));
+		if (p_script->member_default_values.has(E->get())) {
+			if (!_write_value(w, p_script->member_default_values[E->get()]))
+				return false;
+		}
+#else
+		w.put_32(0);
+#endif
+	}
+
+	// subclasses are constants too, but they are rebuilt from the class tree
+	int constant_count = 0;
+	for (const Map<StringName, Variant>::Element *E = p_script->constants.front(); E; E = E->next()) {
+		if (!p_script->subclasses.has(E->key()))
+			constant_count++;
+	}
+	w.put_32(constant_count);
+	for (const Map<StringName, Variant>::Element *E = p_script->constants.front(); E; E = E->next()) {
+		if (p_script->subclasses.has(E->key()))
+			continue;
+		w.put_string(E->key());
+		if (!_write_value(w, E->get()))
+			return false;
+	}
+
+	w.put_32(p_script->_signals.size());
+	for (const Map<StringName, Vector<StringName> >::Element *E = p_script->_signals.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		w.put_32(E->get().size());
+		for (int i = 0; i < E->get().size(); i++) {
+			w.put_string(E->get()[i]);
+		}
+	}
+
+	w.put_32(p_script->member_functions.size());
+	for (const Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		if (!_write_function(w, E->get()))
+			return false;
+	}
+
+	w.put_string(p_script->initializer ? String(p_script->initializer->get_name()) : String());
+
+	return true;
+}
+
+bool GDScriptCompiledCode::_load_class(LoadState &p_state, int p_index) {
+
+	if (p_state.status[p_index] == LoadState::STATUS_LOADED)
+		return true;
+	if (p_state.status[p_index] == LoadState::STATUS_LOADING)
+		return false; // cyclic inheritance, the compiler should have caught it
+
+	p_state.status.write[p_index] = LoadState::STATUS_LOADING;
+
+	GDScript *script = p_state.classes[p_index];
+	Reader r(p_state.data + p_state.offsets[p_index], p_state.sizes[p_index], &p_state);
+
+	// same reset as the compiler does before parsing a class
+	script->native = Ref<GDScriptNativeClass>();
+	script->base = Ref<GDScript>();
+	script->_base = NULL;
+	script->members.clear();
+	script->constants.clear();
+	for (Map<StringName, GDScriptFunction *>::Element *E = script->member_functions.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+	script->member_functions.clear();
+	script->member_indices.clear();
+	script->member_info.clear();
+	script->_signals.clear();
+	script->initializer = NULL;
+	script->subclasses.clear();
+#ifdef TOOLS_ENABLED
+	script->member_default_values.clear();
+#endif
+
+	if (p_index > 0)
+		script->_owner = p_state.classes[p_state.owners[p_index]];
+
+	script->name = r.get_string();
+	script->tool = r.get_32();
+
+	StringName native_name = r.get_string();
+	if (native_name != StringName()) {
+		const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+		if (!globals.has(native_name))
+			return false;
+		script->native = GDScriptLanguage::get_singleton()->get_global_array()[globals[native_name]];
+		if (script->native.is_null())
+			return false;
+	}
+
+	if (r.get_32()) {
+
+		Variant base_value;
+		if (!_read_value(r, base_value))
+			return false;
+		Ref<GDScript> base = base_value;
+		if (base.is_null())
+			return false;
+
+		// a base declared in this same file has to be loaded first
+		for (int i = 0; i < p_state.classes.size(); i++) {
+			if (p_state.classes[i] == base.ptr() && !_load_class(p_state, i))
+				return false;
+		}
+
+		script->base = base;
+		script->_base = base.ptr();
+		script->member_indices = base->member_indices;
+	}
+
+	uint32_t count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+
+		StringName name = r.get_string();
+
+		GDScript::MemberInfo minfo;
+		minfo.index = r.get_32();
+		minfo.setter = r.get_string();
+		minfo.getter = r.get_string();
+		minfo.rpc_mode = MultiplayerAPI::RPCMode(r.get_32());
+		if (!_read_data_type(r, minfo.data_type))
+			return false;
+
+		PropertyInfo pinfo;
+		pinfo.name = name;
+		pinfo.type = Variant::Type(r.get_32());
+		pinfo.class_name = r.get_string();
+		pinfo.hint = PropertyHint(r.get_32());
+		pinfo.hint_string = r.get_string();
+		pinfo.usage = r.get_32();
+
+		if (r.get_32()) {
+			Variant default_value;
+			if (!_read_value(r, default_value))
+				return false;
+#ifdef TOOLS_ENABLED
+			script->member_default_values[name] = default_value;
+#endif
+		}
+
+		script->members.insert(name);
+		script->member_indices[name] = minfo;
+		script->member_info[name] = pinfo;
+	}
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		StringName name = r.get_string();
+		Variant value;
+		if (!_read_value(r, value))
+			return false;
+		script->constants[name] = value;
+	}
+
+	for (int i = 1; i < p_state.classes.size(); i++) {
+		if (p_state.owners[i] == p_index) {
+			script->subclasses.insert(p_state.names[i], p_state.inner_refs[i]);
+			script->constants.insert(p_state.names[i], p_state.inner_refs[i]);
+		}
+	}
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		StringName name = r.get_string();
+		uint32_t argc = r.get_32();
+		Vector<StringName> args;
+		for (uint32_t j = 0; j < argc && !r.error; j++) {
+			args.push_back(r.get_string());
+		}
+		script->_signals[name] = args;
+	}
+
+	count = r.get_32();
+	for (uint32_t i = 0; i < count && !r.error; i++) {
+		GDScriptFunction *function = memnew(GDScriptFunction);
+		if (!_read_function(r, function, script)) {
+			memdelete(function);
+			return false;
+		}
+		if (script->member_functions.has(function->get_name()))
+			memdelete(script->member_functions[function->get_name()]);
+		script->member_functions[function->get_name()] = function;
+	}
+
+	StringName initializer = r.get_string();
+	if (initializer != StringName()) {
+		if (!script->member_functions.has(initializer))
+			return false;
+		script->initializer = script->member_functions[initializer];
+	}
+
+	if (r.error || r.pos != r.size)
+		return false;
+
+	script->valid = true;
+	p_state.status.write[p_index] = LoadState::STATUS_LOADED;
+	return true;
+}
+
+Error GDScriptCompiledCode::save(const Ref<GDScript> &p_script, Vector<uint8_t> &r_data) {
+
+	ERR_FAIL_COND_V(p_script.is_null() || !p_script->is_valid(), ERR_INVALID_PARAMETER);
+
+	Writer w;
+	w.root = p_script.ptr();
+
+	const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+	w.global_names.resize(GDScriptLanguage::get_singleton()->get_global_array_size());
+	for (const Map<StringName, int>::Element *E = globals.front(); E; E = E->next()) {
+		if (E->get() < w.global_names.size())
+			w.global_names.write[E->get()] = E->key();
+	}
+
+	Vector<GDScript *> classes;
+	Vector<int> owners;
+	_collect_classes(const_cast<GDScript *>(p_script.ptr()), -1, classes, owners);
+
+	w.data.resize(4);
+	w.data.write[0] = 'G';
+	w.data.write[1] = 'D';
+	w.data.write[2] = 'S';
+	w.data.write[3] = 'O';
+	w.put_32(COMPILED_CODE_VERSION);
+	w.put_string(VERSION_FULL_CONFIG);
+	// the opcodes and built-in functions are stored as plain numbers
+	w.put_32(GDScriptFunction::OPCODE_END);
+	w.put_32(GDScriptFunctions::FUNC_MAX);
+
+	w.put_32(classes.size());
+	for (int i = 0; i < classes.size(); i++) {
+		w.put_32(owners[i]);
+		w.put_string(classes[i]->name);
+	}
+
+	for (int i = 0; i < classes.size(); i++) {
+
+		int size_ofs = w.data.size();
+		w.put_32(0);
+		if (!_write_class(w, classes[i]))
+			return ERR_UNAVAILABLE;
+		encode_uint32(w.data.size() - size_ofs - 4, &w.data.write[size_ofs]);
+	}
+
+	r_data = w.data;
+	return OK;
+}
+
+Error GDScriptCompiledCode::load(GDScript *p_script, const Vector<uint8_t> &p_data) {
+
+	ERR_FAIL_COND_V(!p_script, ERR_INVALID_PARAMETER);
+
+	if (p_data.size() < 4 || p_data[0] != 'G' || p_data[1] != 'D' || p_data[2] != 'S' || p_data[3] != 'O')
+		return ERR_FILE_UNRECOGNIZED;
+
+	LoadState state;
+	state.data = p_data.ptr();
+
+	Reader r(p_data.ptr(), p_data.size(), &state);
+	r.pos = 4;
+
+	if (r.get_32() != COMPILED_CODE_VERSION || r.get_string() != VERSION_FULL_CONFIG)
+		return ERR_FILE_UNRECOGNIZED;
+	if (r.get_32() != GDScriptFunction::OPCODE_END || r.get_32() != GDScriptFunctions::FUNC_MAX)
+		return ERR_FILE_UNRECOGNIZED;
+
+	uint32_t count = r.get_32();
+	if (r.error || count == 0 || count > uint32_t(p_data.size()))
+		return ERR_FILE_CORRUPT;
+
+	for (uint32_t i = 0; i < count; i++) {
+
+		int owner = int(r.get_32());
+		StringName name = r.get_string();
+		if (r.error || (i == 0 ? owner != -1 : (owner < 0 || owner >= int(i))))
+			return ERR_FILE_CORRUPT;
+
+		state.owners.push_back(owner);
+		state.names.push_back(name);
+		if (i == 0) {
+			state.classes.push_back(p_script);
+			state.inner_refs.push_back(Ref<GDScript>());
+		} else {
+			Ref<GDScript> inner;
+			inner.instance();
+			state.classes.push_back(inner.ptr());
+			state.inner_refs.push_back(inner);
+		}
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+
+		uint32_t size = r.get_32();
+		if (r.error || size > uint32_t(r.size - r.pos))
+			return ERR_FILE_CORRUPT;
+		state.offsets.push_back(r.pos);
+		state.sizes.push_back(size);
+		state.status.push_back(LoadState::STATUS_PENDING);
+		r.pos += size;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (!_load_class(state, i))
+			return ERR_FILE_CORRUPT;
+	}
+
+	return OK;
+}
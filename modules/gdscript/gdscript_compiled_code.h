@@ -0,0 +1,63 @@
+/*************************************************************************/
+/*  gdscript_compiled_code.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_COMPILED_CODE_H
+#define GDSCRIPT_COMPILED_CODE_H
+
+#include "gdscript.h"
+
+// Serialized form of the compiler output (classes, functions, constants and code) so
+// exported scripts can be loaded without running the parser and compiler again.
+// Global identifiers are stored by name and resolved again when loading, since the
+// global array layout differs between the editor and the export templates.
+
+class GDScriptCompiledCode {
+
+	struct Writer;
+	struct Reader;
+	struct LoadState;
+
+	static void _collect_classes(GDScript *p_script, int p_owner, Vector<GDScript *> &r_classes, Vector<int> &r_owners);
+
+	static bool _write_value(Writer &w, const Variant &p_value);
+	static bool _read_value(Reader &r, Variant &r_value);
+	static bool _write_data_type(Writer &w, const GDScriptDataType &p_type);
+	static bool _read_data_type(Reader &r, GDScriptDataType &r_type);
+	static bool _write_function(Writer &w, const GDScriptFunction *p_function);
+	static bool _read_function(Reader &r, GDScriptFunction *p_function, GDScript *p_script);
+	static bool _write_class(Writer &w, const GDScript *p_script);
+	static bool _load_class(LoadState &p_state, int p_index);
+
+public:
+	static Error save(const Ref<GDScript> &p_script, Vector<uint8_t> &r_data);
+	static Error load(GDScript *p_script, const Vector<uint8_t> &p_data);
+};
+
+#endif // GDSCRIPT_COMPILED_CODE_H
@@ -31,6 +31,7 @@
 #include "gdscript_compiler.h"
 
 #include "gdscript.h"
+#include "gdscript_sampler.h"
 
 bool GDScriptCompiler::_is_class_member_property(CodeGen &codegen, const StringName &p_name) {
 
@@ -74,6 +75,23 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+GDScriptFunction::Opcode GDScriptCompiler::_get_operator_opcode(const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) const {
+
+	// the typed opcodes still check the operand types at runtime, so a wrong guess here is only slower
+	if (!p_a.has_type || !p_b.has_type || p_a.is_meta_type || p_b.is_meta_type)
+		return GDScriptFunction::OPCODE_OPERATOR;
+
+	if (p_a.kind != GDScriptParser::DataType::BUILTIN || p_b.kind != GDScriptParser::DataType::BUILTIN || p_a.builtin_type != p_b.builtin_type)
+		return GDScriptFunction::OPCODE_OPERATOR;
+
+	switch (p_a.builtin_type) {
+		case Variant::INT: return GDScriptFunction::OPCODE_OPERATOR_INT;
+		case Variant::REAL: return GDScriptFunction::OPCODE_OPERATOR_REAL;
+		case Variant::VECTOR2: return GDScriptFunction::OPCODE_OPERATOR_VECTOR2;
+		default: return GDScriptFunction::OPCODE_OPERATOR;
+	}
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
@@ -104,7 +122,7 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 	if (src_address_b < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(_get_operator_opcode(on->arguments[0]->get_datatype(), on->arguments[1]->get_datatype())); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
@@ -665,6 +683,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 
 						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
 						codegen.opcodes.push_back(on->arguments.size() - 2);
+						codegen.opcodes.push_back(codegen.call_cache_count++); // method cache for this call site
 						codegen.alloc_call(on->arguments.size() - 2);
 						for (int i = 0; i < arguments.size(); i++)
 							codegen.opcodes.push_back(arguments[i]);
@@ -1279,6 +1298,16 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 	ERR_FAIL_V(-1); //unreachable code
 }
 
+static _FORCE_INLINE_ bool _emit_line_opcodes() {
+
+#ifdef DEBUG_ENABLED
+	return true;
+#else
+	// release builds only need them to attribute samples to lines
+	return GDScriptSampler::get_singleton() != NULL;
+#endif
+}
+
 Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::BlockNode *p_block, int p_stack_level, int p_break_addr, int p_continue_addr) {
 
 	codegen.push_stack_identifiers();
@@ -1291,12 +1320,12 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 		switch (s->type) {
 			case GDScriptParser::Node::TYPE_NEWLINE: {
-#ifdef DEBUG_ENABLED
-				const GDScriptParser::NewLineNode *nl = static_cast<const GDScriptParser::NewLineNode *>(s);
-				codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
-				codegen.opcodes.push_back(nl->line);
-				codegen.current_line = nl->line;
-#endif
+				if (_emit_line_opcodes()) {
+					const GDScriptParser::NewLineNode *nl = static_cast<const GDScriptParser::NewLineNode *>(s);
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
+					codegen.opcodes.push_back(nl->line);
+					codegen.current_line = nl->line;
+				}
 			} break;
 			case GDScriptParser::Node::TYPE_CONTROL_FLOW: {
 				// try subblocks
@@ -1370,11 +1399,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 					case GDScriptParser::ControlFlowNode::CF_IF: {
 
-#ifdef DEBUG_ENABLED
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
-						codegen.opcodes.push_back(cf->line);
-						codegen.current_line = cf->line;
-#endif
+						if (_emit_line_opcodes()) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
+							codegen.opcodes.push_back(cf->line);
+							codegen.current_line = cf->line;
+						}
 						int ret = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
 						if (ret < 0)
 							return ERR_PARSE_ERROR;
@@ -1588,6 +1617,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.call_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
 	Vector<StringName> argnames;
 
@@ -1735,6 +1765,24 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_global_names_count = 0;
 	}
 
+	//method call caches
+	if (codegen.call_cache_count) {
+
+		gdfunc->call_caches.resize(codegen.call_cache_count);
+		for (int i = 0; i < gdfunc->call_caches.size(); i++) {
+			gdfunc->call_caches.write[i].class_name = NULL;
+			gdfunc->call_caches.write[i].method = NULL;
+			gdfunc->call_caches.write[i].builtin_type = Variant::VARIANT_MAX;
+			gdfunc->call_caches.write[i].builtin_method = NULL;
+		}
+		gdfunc->_call_caches_ptr = gdfunc->call_caches.ptrw();
+		gdfunc->_call_cache_count = gdfunc->call_caches.size();
+
+	} else {
+		gdfunc->_call_caches_ptr = NULL;
+		gdfunc->_call_cache_count = 0;
+	}
+
 #ifdef TOOLS_ENABLED
 	// Named globals
 	if (codegen.named_globals.size()) {
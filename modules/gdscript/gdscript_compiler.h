@@ -133,6 +133,7 @@ class GDScriptCompiler {
 		int current_line;
 		int stack_max;
 		int call_max;
+		int call_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -141,6 +142,7 @@ class GDScriptCompiler {
 	void _set_error(const String &p_error, const GDScriptParser::Node *p_node);
 
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
+	GDScriptFunction::Opcode _get_operator_opcode(const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) const;
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false);
 
 	GDScriptDataType _gdtype_from_datatype(const GDScriptParser::DataType &p_datatype) const;
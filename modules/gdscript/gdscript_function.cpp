@@ -32,7 +32,9 @@
 
 #include "gdscript.h"
 #include "gdscript_functions.h"
+#include "gdscript_sampler.h"
 #include "os/os.h"
+#include "os/thread.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant *p_stack, String &r_error) const {
 
@@ -190,6 +192,9 @@ static String _get_var_type(const Variant *p_type) {
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_REAL,               \
+		&&OPCODE_OPERATOR_VECTOR2,            \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
@@ -378,6 +383,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	GDScriptSampler *sampler = GDScriptSampler::get_singleton();
+	if (unlikely(sampler != NULL)) {
+		if (Thread::get_caller_id() == Thread::get_main_id())
+			sampler->enter_function(this, &line);
+		else
+			sampler = NULL;
+	}
+
 #ifdef DEBUG_ENABLED
 
 	if (ScriptDebugger::get_singleton())
@@ -433,6 +446,132 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
 
+			// The typed operator opcodes are emitted when the compiler knows both operands
+			// are of the same type. They handle the common cases directly and fall through
+			// to the generic OPCODE_OPERATOR (which must follow them) for anything else.
+
+			OPCODE(OPCODE_OPERATOR_INT) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (a->get_type() == Variant::INT && b->get_type() == Variant::INT) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					int64_t va = *a;
+					int64_t vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_DIVIDE: {
+							// let the generic path report division by zero
+							handled = vb != 0;
+							if (handled)
+								*dst = va / vb;
+						} break;
+						case Variant::OP_MODULE: {
+							handled = vb != 0;
+							if (handled)
+								*dst = va % vb;
+						} break;
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						case Variant::OP_LESS: *dst = va < vb; break;
+						case Variant::OP_LESS_EQUAL: *dst = va <= vb; break;
+						case Variant::OP_GREATER: *dst = va > vb; break;
+						case Variant::OP_GREATER_EQUAL: *dst = va >= vb; break;
+						case Variant::OP_BIT_AND: *dst = va & vb; break;
+						case Variant::OP_BIT_OR: *dst = va | vb; break;
+						case Variant::OP_BIT_XOR: *dst = va ^ vb; break;
+						case Variant::OP_SHIFT_LEFT: *dst = va << vb; break;
+						case Variant::OP_SHIFT_RIGHT: *dst = va >> vb; break;
+						default: handled = false;
+					}
+
+					if (handled) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
+			OPCODE(OPCODE_OPERATOR_REAL) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (a->get_type() == Variant::REAL && b->get_type() == Variant::REAL) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					double va = *a;
+					double vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_DIVIDE: {
+							handled = vb != 0;
+							if (handled)
+								*dst = va / vb;
+						} break;
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						case Variant::OP_LESS: *dst = va < vb; break;
+						case Variant::OP_LESS_EQUAL: *dst = va <= vb; break;
+						case Variant::OP_GREATER: *dst = va > vb; break;
+						case Variant::OP_GREATER_EQUAL: *dst = va >= vb; break;
+						default: handled = false;
+					}
+
+					if (handled) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
+			OPCODE(OPCODE_OPERATOR_VECTOR2) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (a->get_type() == Variant::VECTOR2 && b->get_type() == Variant::VECTOR2) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					Vector2 va = *a;
+					Vector2 vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						default: handled = false;
+					}
+
+					if (handled) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
 			OPCODE(OPCODE_OPERATOR) {
 
 				CHECK_SPACE(5);
@@ -1018,18 +1157,20 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
-				GET_VARIANT_PTR(base, 2);
-				int nameg = _code_ptr[ip + 3];
+				int cache_index = _code_ptr[ip + 2];
+				GET_VARIANT_PTR(base, 3);
+				int nameg = _code_ptr[ip + 4];
 
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _call_cache_count);
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1047,14 +1188,85 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Variant::CallError err;
-				if (call_ret) {
 
-					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+				if (unlikely(sampler != NULL))
+					sampler->poll();
+
+				// Calls to native methods on objects without a script remember the method bind
+				// for the last class seen at this call site, which skips the ClassDB lookup.
+				// Calls on builtin types remember the resolved method for the last type seen.
+				// The caches are not synchronized, so only the main thread uses them.
+				Object *obj = base->get_type() == Variant::OBJECT ? (Object *)*base : NULL;
+#ifdef DEBUG_ENABLED
+				if (obj && ScriptDebugger::get_singleton() && !base->is_ref() && !ObjectDB::instance_validate(obj)) {
+					obj = NULL; // let call_ptr report it
+				}
+#endif
+				if (obj && !obj->get_script_instance() && Thread::get_caller_id() == Thread::get_main_id()) {
+
+					CallCache &cache = _call_caches_ptr[cache_index];
+					const StringName *class_name = &obj->get_class_name();
+
+					if (cache.class_name != class_name) {
+						cache.method = ClassDB::get_method(*class_name, *methodname);
+						cache.class_name = class_name;
+					}
+
+					if (cache.method) {
+
+						if (call_ret) {
+
+							GET_VARIANT_PTR(ret, argc);
+							Variant result = obj->call_method_bind(cache.method, (const Variant **)argptrs, argc, err);
+							if (err.error == Variant::CallError::CALL_OK) {
+								*ret = result;
+							}
+						} else {
+
+							obj->call_method_bind(cache.method, (const Variant **)argptrs, argc, err);
+						}
+					} else {
+						// not a bound method (free, or a missing one), use the regular path
+						obj = NULL;
+					}
 				} else {
+					obj = NULL;
+				}
+
+				if (!obj) {
+
+					Variant::BuiltinMethod builtin_method = NULL;
+					Variant::Type base_type = base->get_type();
+					if (base_type != Variant::OBJECT && Thread::get_caller_id() == Thread::get_main_id()) {
+
+						CallCache &cache = _call_caches_ptr[cache_index];
+						if (cache.builtin_type != base_type) {
+							cache.builtin_method = Variant::get_builtin_method(base_type, *methodname);
+							cache.builtin_type = base_type;
+						}
+						builtin_method = cache.builtin_method;
+					}
+
+					if (call_ret) {
+
+						GET_VARIANT_PTR(ret, argc);
+						if (builtin_method) {
+							base->call_builtin(builtin_method, (const Variant **)argptrs, argc, ret, err);
+						} else {
+							base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+						}
+					} else {
 
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+						if (builtin_method) {
+							base->call_builtin(builtin_method, (const Variant **)argptrs, argc, NULL, err);
+						} else {
+							base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+						}
+					}
 				}
+
+				if (unlikely(sampler != NULL))
+					sampler->poll_call(*base, *methodname);
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
 					function_call_time += OS::get_singleton()->get_ticks_usec() - call_time;
@@ -1117,8 +1329,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				Variant::CallError err;
 
+				if (unlikely(sampler != NULL))
+					sampler->poll();
+
 				GDScriptFunctions::call(func, (const Variant **)argptrs, argc, *dst, err);
 
+				if (unlikely(sampler != NULL))
+					sampler->poll_built_in(func);
+
 #ifdef DEBUG_ENABLED
 				if (err.error != Variant::CallError::CALL_OK) {
 
@@ -1474,6 +1692,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
+				if (unlikely(sampler != NULL))
+					sampler->poll(); // charge the line that just finished
+
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
@@ -1563,6 +1784,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		GDScriptLanguage::get_singleton()->exit_function();
 #endif
 
+	if (unlikely(sampler != NULL))
+		sampler->exit_function();
+
 	if (_stack_size) {
 		//free stack
 		for (int i = 0; i < _stack_size; i++)
@@ -1697,6 +1921,8 @@ GDScriptFunction::GDScriptFunction() :
 
 	_stack_size = 0;
 	_call_size = 0;
+	_call_caches_ptr = NULL;
+	_call_cache_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -44,7 +44,7 @@ class GDScript;
 
 struct GDScriptDataType {
 	bool has_type;
-	enum {
+	enum Kind {
 		BUILTIN,
 		NATIVE,
 		SCRIPT,
@@ -135,6 +135,9 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT,
+		OPCODE_OPERATOR_REAL,
+		OPCODE_OPERATOR_VECTOR2,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_SET,
 		OPCODE_GET,
@@ -201,6 +204,7 @@ public:
 
 private:
 	friend class GDScriptCompiler;
+	friend class GDScriptCompiledCode;
 
 	StringName source;
 
@@ -209,6 +213,14 @@ private:
 	int _constant_count;
 	const StringName *_global_names_ptr;
 	int _global_names_count;
+	struct CallCache {
+		const StringName *class_name;
+		MethodBind *method;
+		Variant::Type builtin_type;
+		Variant::BuiltinMethod builtin_method;
+	};
+	CallCache *_call_caches_ptr;
+	int _call_cache_count;
 #ifdef TOOLS_ENABLED
 	const StringName *_named_globals_ptr;
 	int _named_globals_count;
@@ -229,6 +241,7 @@ private:
 	StringName name;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
+	Vector<CallCache> call_caches;
 #ifdef TOOLS_ENABLED
 	Vector<StringName> named_globals;
 #endif
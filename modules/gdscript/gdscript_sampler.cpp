@@ -0,0 +1,166 @@
+/*************************************************************************/
+/*  gdscript_sampler.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampler.h"
+
+#include "gdscript.h"
+#include "gdscript_functions.h"
+#include "os/file_access.h"
+#include "os/os.h"
+#include "safe_refcount.h"
+#include "sort.h"
+
+GDScriptSampler *GDScriptSampler::singleton = NULL;
+
+void GDScriptSampler::_thread_func(void *p_userdata) {
+
+	GDScriptSampler *sampler = (GDScriptSampler *)p_userdata;
+
+	while (!sampler->exit_thread) {
+		OS::get_singleton()->delay_usec(sampler->interval_usec);
+		atomic_increment(&sampler->ticks);
+	}
+}
+
+String GDScriptSampler::_get_stack() const {
+
+	String stack;
+	int count = MIN(depth, (int)MAX_FRAMES);
+
+	for (int i = 0; i < count; i++) {
+
+		const GDScriptFunction *function = frames[i].function;
+		String path = function->get_script() ? function->get_script()->get_path() : String();
+		if (path == String())
+			path = "<built-in>";
+
+		if (i > 0)
+			stack += ";";
+		stack += path + ":" + String(function->get_name()) + ":" + itos(*frames[i].line);
+	}
+
+	return stack;
+}
+
+void GDScriptSampler::_record(const String &p_leaf) {
+
+	uint32_t current = ticks;
+	uint32_t count = current - ticks_seen;
+	ticks_seen = current;
+
+	if (depth == 0)
+		return;
+
+	String stack = _get_stack();
+	if (p_leaf != String())
+		stack += ";" + p_leaf;
+
+	uint64_t *value = samples.getptr(stack);
+	if (value)
+		*value += count;
+	else
+		samples[stack] = count;
+
+	total_samples += count;
+}
+
+void GDScriptSampler::_record_call(const Variant &p_base, const StringName &p_method) {
+
+	String type;
+	if (p_base.get_type() == Variant::OBJECT) {
+		// the call may have freed the object
+		Object *obj = p_base;
+		type = obj && ObjectDB::instance_validate(obj) ? obj->get_class() : String("Object");
+	} else {
+		type = Variant::get_type_name(p_base.get_type());
+	}
+
+	_record(type + "." + String(p_method));
+}
+
+void GDScriptSampler::_record_built_in(int p_function) {
+
+	_record(String("@GDScript.") + GDScriptFunctions::get_func_name(GDScriptFunctions::Function(p_function)));
+}
+
+Error GDScriptSampler::save(const String &p_path) const {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, ERR_CANT_CREATE);
+
+	// sorted so saved profiles can be compared with a regular diff
+	Vector<String> stacks;
+	const String *key = NULL;
+	while ((key = samples.next(key))) {
+		stacks.push_back(*key);
+	}
+	stacks.sort();
+
+	for (int i = 0; i < stacks.size(); i++) {
+		f->store_line(stacks[i] + " " + itos(samples[stacks[i]]));
+	}
+
+	memdelete(f);
+	return OK;
+}
+
+void GDScriptSampler::start(uint64_t p_interval_usec) {
+
+	ERR_FAIL_COND(singleton);
+	singleton = memnew(GDScriptSampler(p_interval_usec));
+}
+
+void GDScriptSampler::stop() {
+
+	if (singleton) {
+		memdelete(singleton);
+		singleton = NULL;
+	}
+}
+
+GDScriptSampler::GDScriptSampler(uint64_t p_interval_usec) {
+
+	depth = 0;
+	ticks = 0;
+	ticks_seen = 0;
+	total_samples = 0;
+	interval_usec = MAX(p_interval_usec, (uint64_t)50);
+	exit_thread = false;
+	thread = Thread::create(_thread_func, this);
+}
+
+GDScriptSampler::~GDScriptSampler() {
+
+	if (thread) {
+		exit_thread = true;
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+	}
+}
@@ -0,0 +1,132 @@
+/*************************************************************************/
+/*  gdscript_sampler.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLER_H
+#define GDSCRIPT_SAMPLER_H
+
+#include "hash_map.h"
+#include "os/thread.h"
+#include "ustring.h"
+#include "variant.h"
+
+class GDScriptFunction;
+
+// Sampling profiler for scripts running on the main thread. A timer thread only bumps
+// a tick counter, the interpreter checks it at line and call boundaries and charges the
+// elapsed ticks to the current script stack, so nothing is read across threads. Works
+// in release builds as well (the compiler keeps line opcodes while it's enabled).
+// Results are saved as collapsed stacks, the input format of most flame graph tools.
+
+class GDScriptSampler {
+
+	static GDScriptSampler *singleton;
+
+	enum {
+		MAX_FRAMES = 256
+	};
+
+	struct Frame {
+		const GDScriptFunction *function;
+		const int *line;
+	};
+
+	Frame frames[MAX_FRAMES];
+	int depth;
+
+	volatile uint32_t ticks;
+	uint32_t ticks_seen;
+
+	uint64_t interval_usec;
+	Thread *thread;
+	volatile bool exit_thread;
+
+	HashMap<String, uint64_t> samples;
+	uint64_t total_samples;
+
+	static void _thread_func(void *p_userdata);
+
+	String _get_stack() const;
+	void _record(const String &p_leaf);
+	void _record_call(const Variant &p_base, const StringName &p_method);
+	void _record_built_in(int p_function);
+
+public:
+	_FORCE_INLINE_ static GDScriptSampler *get_singleton() { return singleton; }
+
+	_FORCE_INLINE_ void enter_function(const GDScriptFunction *p_function, const int *p_line) {
+
+		if (depth == 0)
+			ticks_seen = ticks; // time spent outside of scripts is not charged
+		else
+			poll();
+
+		if (depth < MAX_FRAMES) {
+			frames[depth].function = p_function;
+			frames[depth].line = p_line;
+		}
+		depth++;
+	}
+
+	_FORCE_INLINE_ void exit_function() {
+
+		poll();
+		depth--;
+	}
+
+	_FORCE_INLINE_ void poll() {
+
+		if (unlikely(ticks != ticks_seen))
+			_record(String());
+	}
+
+	// called after a native call returns, ticks elapsed since the last poll went to the callee
+	_FORCE_INLINE_ void poll_call(const Variant &p_base, const StringName &p_method) {
+
+		if (unlikely(ticks != ticks_seen))
+			_record_call(p_base, p_method);
+	}
+
+	_FORCE_INLINE_ void poll_built_in(int p_function) {
+
+		if (unlikely(ticks != ticks_seen))
+			_record_built_in(p_function);
+	}
+
+	uint64_t get_total_samples() const { return total_samples; }
+	Error save(const String &p_path) const;
+
+	static void start(uint64_t p_interval_usec);
+	static void stop();
+
+	GDScriptSampler(uint64_t p_interval_usec);
+	~GDScriptSampler();
+};
+
+#endif // GDSCRIPT_SAMPLER_H
@@ -32,6 +32,7 @@
 
 #include "editor/gdscript_highlighter.h"
 #include "gdscript.h"
+#include "gdscript_compiled_code.h"
 #include "gdscript_tokenizer.h"
 #include "io/file_access_encrypted.h"
 #include "io/resource_loader.h"
@@ -68,6 +69,16 @@ public:
 			return;
 
 		add_file(p_path.get_basename() + ".gdc", file, true);
+
+		// Also store the compiler output, so the export doesn't need to compile the
+		// script again when loading it. The tokens are kept as a fallback.
+		Ref<GDScript> script = ResourceLoader::load(p_path);
+		if (script.is_null() || !script->is_valid())
+			return;
+
+		Vector<uint8_t> compiled;
+		if (GDScriptCompiledCode::save(script, compiled) == OK)
+			add_file(p_path.get_basename() + ".gdo", compiled, false);
 	}
 };
 
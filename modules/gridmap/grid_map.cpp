@@ -36,6 +36,7 @@
 
 #include "io/marshalls.h"
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
 #include "scene/resources/mesh_library.h"
 #include "scene/scene_string_names.h"
 
@@ -416,11 +417,9 @@ void GridMap::_octant_transform(const OctantKey &p_key) {
 	}
 }
 
-bool GridMap::_octant_update(const OctantKey &p_key) {
+bool GridMap::_octant_update_begin(const OctantKey &p_key) {
 	ERR_FAIL_COND_V(!octant_map.has(p_key), false);
 	Octant &g = *octant_map[p_key];
-	if (!g.dirty)
-		return false;
 
 	//erase body shapes
 	PhysicsServer::get_singleton()->body_clear_shapes(g.static_body);
@@ -454,7 +453,113 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 		return true;
 	}
 
-	PoolVector<Vector3> col_debug;
+	return false;
+}
+
+void GridMap::_cache_merge_sources(int p_item) {
+
+	if (merge_sources.has(p_item))
+		return;
+
+	Vector<MergeSurface> &surfaces = merge_sources[p_item];
+
+	Ref<Mesh> mesh = theme->get_item_mesh(p_item);
+	if (!mesh.is_valid())
+		return;
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES)
+			continue;
+
+		Array arrays = mesh->surface_get_arrays(i);
+		PoolVector<Vector3> vertices = arrays[VS::ARRAY_VERTEX];
+		if (vertices.size() == 0)
+			continue;
+
+		//copied into plain vectors, so the merging threads never touch pooled memory
+		MergeSurface s;
+		s.material = mesh->surface_get_material(i);
+		s.format = VS::ARRAY_FORMAT_VERTEX | VS::ARRAY_FORMAT_INDEX;
+
+		PoolVector<Vector3>::Read vr = vertices.read();
+		s.vertices.resize(vertices.size());
+		for (int j = 0; j < vertices.size(); j++) {
+			s.vertices.write[j] = vr[j];
+		}
+
+		PoolVector<Vector3> normals = arrays[VS::ARRAY_NORMAL];
+		if (normals.size() == vertices.size()) {
+			PoolVector<Vector3>::Read r = normals.read();
+			s.normals.resize(normals.size());
+			for (int j = 0; j < normals.size(); j++) {
+				s.normals.write[j] = r[j];
+			}
+			s.format |= VS::ARRAY_FORMAT_NORMAL;
+		}
+
+		PoolVector<real_t> tangents = arrays[VS::ARRAY_TANGENT];
+		if (tangents.size() == vertices.size() * 4) {
+			PoolVector<real_t>::Read r = tangents.read();
+			s.tangents.resize(tangents.size());
+			for (int j = 0; j < tangents.size(); j++) {
+				s.tangents.write[j] = r[j];
+			}
+			s.format |= VS::ARRAY_FORMAT_TANGENT;
+		}
+
+		PoolVector<Color> colors = arrays[VS::ARRAY_COLOR];
+		if (colors.size() == vertices.size()) {
+			PoolVector<Color>::Read r = colors.read();
+			s.colors.resize(colors.size());
+			for (int j = 0; j < colors.size(); j++) {
+				s.colors.write[j] = r[j];
+			}
+			s.format |= VS::ARRAY_FORMAT_COLOR;
+		}
+
+		PoolVector<Vector2> uvs = arrays[VS::ARRAY_TEX_UV];
+		if (uvs.size() == vertices.size()) {
+			PoolVector<Vector2>::Read r = uvs.read();
+			s.uvs.resize(uvs.size());
+			for (int j = 0; j < uvs.size(); j++) {
+				s.uvs.write[j] = r[j];
+			}
+			s.format |= VS::ARRAY_FORMAT_TEX_UV;
+		}
+
+		PoolVector<Vector2> uv2s = arrays[VS::ARRAY_TEX_UV2];
+		if (uv2s.size() == vertices.size()) {
+			PoolVector<Vector2>::Read r = uv2s.read();
+			s.uv2s.resize(uv2s.size());
+			for (int j = 0; j < uv2s.size(); j++) {
+				s.uv2s.write[j] = r[j];
+			}
+			s.format |= VS::ARRAY_FORMAT_TEX_UV2;
+		}
+
+		PoolVector<int> indices = arrays[VS::ARRAY_INDEX];
+		if (indices.size()) {
+			PoolVector<int>::Read r = indices.read();
+			s.indices.resize(indices.size());
+			for (int j = 0; j < indices.size(); j++) {
+				s.indices.write[j] = r[j];
+			}
+		} else {
+			s.indices.resize(vertices.size());
+			for (int j = 0; j < vertices.size(); j++) {
+				s.indices.write[j] = j;
+			}
+		}
+
+		surfaces.push_back(s);
+	}
+}
+
+void GridMap::_octant_update_build(OctantBuild &p_build) const {
+
+	//runs on worker threads, must not call into any server
+	const Octant &g = *p_build.octant;
 
 	/*
 	 * foreach item in this octant,
@@ -462,41 +567,102 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	 * and set said multimesh bounding box to one containing all cells which have this item
 	 */
 
-	Map<int, List<Pair<Transform, IndexKey> > > multimesh_items;
+	for (const Set<IndexKey>::Element *E = g.cells.front(); E; E = E->next()) {
 
-	for (Set<IndexKey>::Element *E = g.cells.front(); E; E = E->next()) {
-
-		ERR_CONTINUE(!cell_map.has(E->get()));
-		const Cell &c = cell_map[E->get()];
+		const Map<IndexKey, Cell>::Element *C = cell_map.find(E->get());
+		ERR_CONTINUE(!C);
+		const Cell &c = C->get();
 
 		if (!theme.is_valid() || !theme->has_item(c.item))
 			continue;
 
-		//print_line("OCTANT, CELLS: "+itos(ii.cells.size()));
-
 		Vector3 cellpos = Vector3(E->get().x, E->get().y, E->get().z);
 		Vector3 ofs = _get_offset();
 
 		Transform xform;
 
-		if (clip && ((clip_above && cellpos[clip_axis] > clip_floor) || (!clip_above && cellpos[clip_axis] < clip_floor))) {
-
-		} else {
-		}
-
 		xform.basis.set_orthogonal_index(c.rot);
 		xform.set_origin(cellpos * cell_size + ofs);
 		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
 		if (baked_meshes.size() == 0) {
-			if (theme->get_item_mesh(c.item).is_valid()) {
-				if (!multimesh_items.has(c.item)) {
-					multimesh_items[c.item] = List<Pair<Transform, IndexKey> >();
+			if (merge_meshes) {
+
+				const Map<int, Vector<MergeSurface> >::Element *S = merge_sources.find(c.item);
+				ERR_CONTINUE(!S);
+
+				for (int i = 0; i < S->get().size(); i++) {
+
+					const MergeSurface &src = S->get()[i];
+
+					int surface = -1;
+					for (int j = 0; j < p_build.merged_surfaces.size(); j++) {
+						if (p_build.merged_surfaces[j].material == src.material && p_build.merged_surfaces[j].format == src.format) {
+							surface = j;
+							break;
+						}
+					}
+
+					if (surface == -1) {
+						MergeSurface ms;
+						ms.material = src.material;
+						ms.format = src.format;
+						p_build.merged_surfaces.push_back(ms);
+						surface = p_build.merged_surfaces.size() - 1;
+					}
+
+					MergeSurface &dst = p_build.merged_surfaces.write[surface];
+					int base = dst.vertices.size();
+					int count = src.vertices.size();
+
+					dst.vertices.resize(base + count);
+					for (int j = 0; j < count; j++) {
+						dst.vertices.write[base + j] = xform.xform(src.vertices[j]);
+					}
+
+					if (src.format & VS::ARRAY_FORMAT_NORMAL) {
+						dst.normals.resize(base + count);
+						for (int j = 0; j < count; j++) {
+							dst.normals.write[base + j] = xform.basis.xform(src.normals[j]).normalized();
+						}
+					}
+
+					if (src.format & VS::ARRAY_FORMAT_TANGENT) {
+						dst.tangents.resize((base + count) * 4);
+						for (int j = 0; j < count; j++) {
+							Vector3 t = xform.basis.xform(Vector3(src.tangents[j * 4 + 0], src.tangents[j * 4 + 1], src.tangents[j * 4 + 2])).normalized();
+							dst.tangents.write[(base + j) * 4 + 0] = t.x;
+							dst.tangents.write[(base + j) * 4 + 1] = t.y;
+							dst.tangents.write[(base + j) * 4 + 2] = t.z;
+							dst.tangents.write[(base + j) * 4 + 3] = src.tangents[j * 4 + 3];
+						}
+					}
+
+					if (src.format & VS::ARRAY_FORMAT_COLOR) {
+						dst.colors.append_array(src.colors);
+					}
+					if (src.format & VS::ARRAY_FORMAT_TEX_UV) {
+						dst.uvs.append_array(src.uvs);
+					}
+					if (src.format & VS::ARRAY_FORMAT_TEX_UV2) {
+						dst.uv2s.append_array(src.uv2s);
+					}
+
+					int index_base = dst.indices.size();
+					dst.indices.resize(index_base + src.indices.size());
+					for (int j = 0; j < src.indices.size(); j++) {
+						dst.indices.write[index_base + j] = base + src.indices[j];
+					}
+				}
+
+			} else if (theme->get_item_mesh(c.item).is_valid()) {
+				if (!p_build.multimesh_items.has(c.item)) {
+					p_build.multimesh_items[c.item] = List<Pair<Transform, IndexKey> >();
 				}
 
 				Pair<Transform, IndexKey> p;
 				p.first = xform;
 				p.second = E->get();
-				multimesh_items[c.item].push_back(p);
+				p_build.multimesh_items[c.item].push_back(p);
 			}
 		}
 
@@ -506,33 +672,58 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 			// add the item's shape
 			if (!shapes[i].shape.is_valid())
 				continue;
-			PhysicsServer::get_singleton()->body_add_shape(g.static_body, shapes[i].shape->get_rid(), xform * shapes[i].local_transform);
-			if (g.collision_debug.is_valid()) {
-				shapes.write[i].shape->add_vertices_to_array(col_debug, xform * shapes[i].local_transform);
-			}
 
-			//print_line("PHIS x: "+xform);
+			OctantBuild::ShapeInstance si;
+			si.shape = shapes[i].shape;
+			si.xform = xform * shapes[i].local_transform;
+			p_build.shapes.push_back(si);
 		}
 
 		// add the item's navmesh at given xform to GridMap's Navigation ancestor
 		Ref<NavigationMesh> navmesh = theme->get_item_navmesh(c.item);
 		if (navmesh.is_valid()) {
-			Octant::NavMesh nm;
-			nm.xform = xform;
+			OctantBuild::NavMeshInstance ni;
+			ni.key = E->get();
+			ni.navmesh = navmesh;
+			ni.xform = xform;
+			p_build.navmeshes.push_back(ni);
+		}
+	}
+}
 
-			if (navigation) {
-				nm.id = navigation->navmesh_add(navmesh, xform, this);
-			} else {
-				nm.id = -1;
-			}
-			g.navmesh_ids[E->get()] = nm;
+void GridMap::_octant_update_end(OctantBuild &p_build) {
+
+	Octant &g = *p_build.octant;
+
+	PoolVector<Vector3> col_debug;
+
+	for (int i = 0; i < p_build.shapes.size(); i++) {
+
+		OctantBuild::ShapeInstance &si = p_build.shapes.write[i];
+		PhysicsServer::get_singleton()->body_add_shape(g.static_body, si.shape->get_rid(), si.xform);
+		if (g.collision_debug.is_valid()) {
+			si.shape->add_vertices_to_array(col_debug, si.xform);
 		}
 	}
 
+	for (int i = 0; i < p_build.navmeshes.size(); i++) {
+
+		const OctantBuild::NavMeshInstance &ni = p_build.navmeshes[i];
+		Octant::NavMesh nm;
+		nm.xform = ni.xform;
+
+		if (navigation) {
+			nm.id = navigation->navmesh_add(ni.navmesh, ni.xform, this);
+		} else {
+			nm.id = -1;
+		}
+		g.navmesh_ids[ni.key] = nm;
+	}
+
 	//update multimeshes, only if not baked
 	if (baked_meshes.size() == 0) {
 
-		for (Map<int, List<Pair<Transform, IndexKey> > >::Element *E = multimesh_items.front(); E; E = E->next()) {
+		for (Map<int, List<Pair<Transform, IndexKey> > >::Element *E = p_build.multimesh_items.front(); E; E = E->next()) {
 			Octant::MultimeshInstance mmi;
 
 			RID mm = VS::get_singleton()->multimesh_create();
@@ -567,6 +758,113 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 
 			g.multimesh_instances.push_back(mmi);
 		}
+
+		if (p_build.merged_surfaces.size()) {
+
+			RID mesh = VS::get_singleton()->mesh_create();
+
+			for (int i = 0; i < p_build.merged_surfaces.size(); i++) {
+
+				const MergeSurface &ms = p_build.merged_surfaces[i];
+
+				Array arr;
+				arr.resize(VS::ARRAY_MAX);
+
+				PoolVector<Vector3> vertices;
+				vertices.resize(ms.vertices.size());
+				{
+					PoolVector<Vector3>::Write w = vertices.write();
+					for (int j = 0; j < ms.vertices.size(); j++) {
+						w[j] = ms.vertices[j];
+					}
+				}
+				arr[VS::ARRAY_VERTEX] = vertices;
+
+				if (ms.format & VS::ARRAY_FORMAT_NORMAL) {
+					PoolVector<Vector3> normals;
+					normals.resize(ms.normals.size());
+					PoolVector<Vector3>::Write w = normals.write();
+					for (int j = 0; j < ms.normals.size(); j++) {
+						w[j] = ms.normals[j];
+					}
+					w = PoolVector<Vector3>::Write();
+					arr[VS::ARRAY_NORMAL] = normals;
+				}
+
+				if (ms.format & VS::ARRAY_FORMAT_TANGENT) {
+					PoolVector<real_t> tangents;
+					tangents.resize(ms.tangents.size());
+					PoolVector<real_t>::Write w = tangents.write();
+					for (int j = 0; j < ms.tangents.size(); j++) {
+						w[j] = ms.tangents[j];
+					}
+					w = PoolVector<real_t>::Write();
+					arr[VS::ARRAY_TANGENT] = tangents;
+				}
+
+				if (ms.format & VS::ARRAY_FORMAT_COLOR) {
+					PoolVector<Color> colors;
+					colors.resize(ms.colors.size());
+					PoolVector<Color>::Write w = colors.write();
+					for (int j = 0; j < ms.colors.size(); j++) {
+						w[j] = ms.colors[j];
+					}
+					w = PoolVector<Color>::Write();
+					arr[VS::ARRAY_COLOR] = colors;
+				}
+
+				if (ms.format & VS::ARRAY_FORMAT_TEX_UV) {
+					PoolVector<Vector2> uvs;
+					uvs.resize(ms.uvs.size());
+					PoolVector<Vector2>::Write w = uvs.write();
+					for (int j = 0; j < ms.uvs.size(); j++) {
+						w[j] = ms.uvs[j];
+					}
+					w = PoolVector<Vector2>::Write();
+					arr[VS::ARRAY_TEX_UV] = uvs;
+				}
+
+				if (ms.format & VS::ARRAY_FORMAT_TEX_UV2) {
+					PoolVector<Vector2> uv2s;
+					uv2s.resize(ms.uv2s.size());
+					PoolVector<Vector2>::Write w = uv2s.write();
+					for (int j = 0; j < ms.uv2s.size(); j++) {
+						w[j] = ms.uv2s[j];
+					}
+					w = PoolVector<Vector2>::Write();
+					arr[VS::ARRAY_TEX_UV2] = uv2s;
+				}
+
+				PoolVector<int> indices;
+				indices.resize(ms.indices.size());
+				{
+					PoolVector<int>::Write w = indices.write();
+					for (int j = 0; j < ms.indices.size(); j++) {
+						w[j] = ms.indices[j];
+					}
+				}
+				arr[VS::ARRAY_INDEX] = indices;
+
+				VS::get_singleton()->mesh_add_surface_from_arrays(mesh, VS::PRIMITIVE_TRIANGLES, arr);
+				if (ms.material.is_valid()) {
+					VS::get_singleton()->mesh_surface_set_material(mesh, i, ms.material->get_rid());
+				}
+			}
+
+			RID instance = VS::get_singleton()->instance_create();
+			VS::get_singleton()->instance_set_base(instance, mesh);
+
+			if (is_inside_tree()) {
+				VS::get_singleton()->instance_set_scenario(instance, get_world()->get_scenario());
+				VS::get_singleton()->instance_set_transform(instance, get_global_transform());
+			}
+
+			Octant::MultimeshInstance mmi;
+			mmi.multimesh = mesh;
+			mmi.instance = instance;
+
+			g.multimesh_instances.push_back(mmi);
+		}
 	}
 
 	if (col_debug.size()) {
@@ -583,8 +881,12 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	}
 
 	g.dirty = false;
+}
 
-	return false;
+void GridMap::_octant_build_task(void *p_userdata, uint32_t p_index) {
+
+	GridMap *gm = (GridMap *)p_userdata;
+	gm->_octant_update_build(gm->octant_builds.write[p_index]);
 }
 
 void GridMap::_reset_physic_bodies_collision_filters() {
@@ -818,11 +1120,48 @@ void GridMap::_update_octants_callback() {
 	List<OctantKey> to_delete;
 	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
 
-		if (_octant_update(E->key())) {
+		if (!E->get()->dirty)
+			continue;
+
+		if (_octant_update_begin(E->key())) {
 			to_delete.push_back(E->key());
+			continue;
+		}
+
+		OctantBuild build;
+		build.octant = E->get();
+		octant_builds.push_back(build);
+
+		if (merge_meshes && baked_meshes.size() == 0 && theme.is_valid()) {
+			for (Set<IndexKey>::Element *F = E->get()->cells.front(); F; F = F->next()) {
+				const Map<IndexKey, Cell>::Element *C = cell_map.find(F->get());
+				if (C && theme->has_item(C->get().item)) {
+					_cache_merge_sources(C->get().item);
+				}
+			}
+		}
+	}
+
+	// gather cell transforms, shapes and merged geometry in parallel, server calls stay on this thread
+	int build_count = octant_builds.size();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && build_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_octant_build_task, this, build_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < build_count; i++) {
+			_octant_update_build(octant_builds.write[i]);
 		}
 	}
 
+	for (int i = 0; i < build_count; i++) {
+		_octant_update_end(octant_builds.write[i]);
+	}
+
+	octant_builds.clear();
+	merge_sources.clear();
+
 	while (to_delete.front()) {
 		octant_map.erase(to_delete.front()->get());
 		to_delete.pop_back();
@@ -855,6 +1194,9 @@ void GridMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_cell_scale", "scale"), &GridMap::set_cell_scale);
 	ClassDB::bind_method(D_METHOD("get_cell_scale"), &GridMap::get_cell_scale);
 
+	ClassDB::bind_method(D_METHOD("set_merge_meshes", "enable"), &GridMap::set_merge_meshes);
+	ClassDB::bind_method(D_METHOD("get_merge_meshes"), &GridMap::get_merge_meshes);
+
 	ClassDB::bind_method(D_METHOD("set_octant_size", "size"), &GridMap::set_octant_size);
 	ClassDB::bind_method(D_METHOD("get_octant_size"), &GridMap::get_octant_size);
 
@@ -890,6 +1232,7 @@ void GridMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("make_baked_meshes", "gen_lightmap_uv", "lightmap_uv_texel_size"), &GridMap::make_baked_meshes, DEFVAL(false), DEFVAL(0.1));
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "theme", PROPERTY_HINT_RESOURCE_TYPE, "MeshLibrary"), "set_theme", "get_theme");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "merge_meshes"), "set_merge_meshes", "get_merge_meshes");
 	ADD_GROUP("Cell", "cell_");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "cell_size"), "set_cell_size", "get_cell_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_octant_size", PROPERTY_HINT_RANGE, "1,1024,1"), "set_octant_size", "get_octant_size");
@@ -937,6 +1280,20 @@ float GridMap::get_cell_scale() const {
 	return cell_scale;
 }
 
+void GridMap::set_merge_meshes(bool p_enable) {
+
+	if (merge_meshes == p_enable)
+		return;
+
+	merge_meshes = p_enable;
+	_recreate_octant_data();
+}
+
+bool GridMap::get_merge_meshes() const {
+
+	return merge_meshes;
+}
+
 Array GridMap::get_used_cells() const {
 
 	Array a;
@@ -1129,6 +1486,7 @@ GridMap::GridMap() {
 	clip_axis = Vector3::AXIS_Z;
 	clip_above = true;
 	cell_scale = 1.0;
+	merge_meshes = false;
 
 	navigation = NULL;
 	set_notify_transform(true);
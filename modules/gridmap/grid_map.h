@@ -97,7 +97,7 @@ class GridMap : public Spatial {
 
 		struct MultimeshInstance {
 			RID instance;
-			RID multimesh;
+			RID multimesh; //or the merged mesh of the octant, see merge_meshes
 			struct Item {
 				int index;
 				Transform transform;
@@ -162,6 +162,44 @@ class GridMap : public Spatial {
 	Map<OctantKey, Octant *> octant_map;
 	Map<IndexKey, Cell> cell_map;
 
+	bool merge_meshes;
+
+	struct MergeSurface {
+		Ref<Material> material;
+		uint32_t format;
+		Vector<Vector3> vertices;
+		Vector<Vector3> normals;
+		Vector<real_t> tangents;
+		Vector<Color> colors;
+		Vector<Vector2> uvs;
+		Vector<Vector2> uv2s;
+		Vector<int> indices;
+	};
+
+	// what a dirty octant needs, gathered off the main thread and applied on it
+	struct OctantBuild {
+
+		struct ShapeInstance {
+			Ref<Shape> shape;
+			Transform xform;
+		};
+
+		struct NavMeshInstance {
+			IndexKey key;
+			Ref<NavigationMesh> navmesh;
+			Transform xform;
+		};
+
+		Octant *octant;
+		Map<int, List<Pair<Transform, IndexKey> > > multimesh_items;
+		Vector<ShapeInstance> shapes;
+		Vector<NavMeshInstance> navmeshes;
+		Vector<MergeSurface> merged_surfaces;
+	};
+
+	Vector<OctantBuild> octant_builds;
+	Map<int, Vector<MergeSurface> > merge_sources; //item surfaces, fetched on the main thread before merging
+
 	void _recreate_octant_data();
 
 	struct BakeLight {
@@ -180,7 +218,11 @@ class GridMap : public Spatial {
 	void _reset_physic_bodies_collision_filters();
 	void _octant_enter_world(const OctantKey &p_key);
 	void _octant_exit_world(const OctantKey &p_key);
-	bool _octant_update(const OctantKey &p_key);
+	bool _octant_update_begin(const OctantKey &p_key);
+	void _octant_update_build(OctantBuild &p_build) const;
+	void _octant_update_end(OctantBuild &p_build);
+	void _cache_merge_sources(int p_item);
+	static void _octant_build_task(void *p_userdata, uint32_t p_index);
 	void _octant_clean_up(const OctantKey &p_key);
 	void _octant_transform(const OctantKey &p_key);
 	bool awaiting_update;
@@ -255,6 +297,9 @@ public:
 	void set_cell_scale(float p_scale);
 	float get_cell_scale() const;
 
+	void set_merge_meshes(bool p_enable);
+	bool get_merge_meshes() const;
+
 	Array get_used_cells() const;
 
 	Array get_meshes();
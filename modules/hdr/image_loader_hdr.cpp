@@ -30,6 +30,7 @@
 
 #include "image_loader_hdr.h"
 
+#include "io/buffered_file_reader.h"
 #include "os/os.h"
 #include "print_string.h"
 
@@ -78,17 +79,21 @@ Error ImageLoaderHDR::load_image(Ref<Image> p_image, FileAccess *f, bool p_force
 
 		uint8_t *ptr = (uint8_t *)w.ptr();
 
+		// scanlines are decoded a byte at a time, so read them through a buffer
+		BufferedFileReader reader;
+		reader.open(f);
+
 		if (width < 8 || width >= 32768) {
 			// Read flat data
 
-			f->get_buffer(ptr, width * height * 4);
+			reader.get_buffer(ptr, width * height * 4);
 		} else {
 			// Read RLE-encoded data
 
 			for (int j = 0; j < height; ++j) {
-				int c1 = f->get_8();
-				int c2 = f->get_8();
-				int len = f->get_8();
+				int c1 = reader.get_8();
+				int c2 = reader.get_8();
+				int len = reader.get_8();
 				if (c1 != 2 || c2 != 2 || (len & 0x80)) {
 					// not run-length encoded, so we have to actually use THIS data as a decoded
 					// pixel (note this can't be a valid pixel--one of RGB must be >= 128)
@@ -96,13 +101,13 @@ Error ImageLoaderHDR::load_image(Ref<Image> p_image, FileAccess *f, bool p_force
 					ptr[(j * width) * 4 + 0] = uint8_t(c1);
 					ptr[(j * width) * 4 + 1] = uint8_t(c2);
 					ptr[(j * width) * 4 + 2] = uint8_t(len);
-					ptr[(j * width) * 4 + 3] = f->get_8();
+					ptr[(j * width) * 4 + 3] = reader.get_8();
 
-					f->get_buffer(&ptr[(j * width + 1) * 4], (width - 1) * 4);
+					reader.get_buffer(&ptr[(j * width + 1) * 4], (width - 1) * 4);
 					continue;
 				}
 				len <<= 8;
-				len |= f->get_8();
+				len |= reader.get_8();
 
 				if (len != width) {
 					ERR_EXPLAIN("invalid decoded scanline length, corrupt HDR");
@@ -112,17 +117,17 @@ Error ImageLoaderHDR::load_image(Ref<Image> p_image, FileAccess *f, bool p_force
 				for (int k = 0; k < 4; ++k) {
 					int i = 0;
 					while (i < width) {
-						int count = f->get_8();
+						int count = reader.get_8();
 						if (count > 128) {
 							// Run
-							int value = f->get_8();
+							int value = reader.get_8();
 							count -= 128;
 							for (int z = 0; z < count; ++z)
 								ptr[(j * width + i++) * 4 + k] = uint8_t(value);
 						} else {
 							// Dump
 							for (int z = 0; z < count; ++z)
-								ptr[(j * width + i++) * 4 + k] = f->get_8();
+								ptr[(j * width + i++) * 4 + k] = reader.get_8();
 						}
 					}
 				}
@@ -5,6 +5,7 @@
 // file: core/variant_call.cpp
 // commit: 5ad9be4c24e9d7dc5672fdc42cea896622fe5685
 using System;
+using System.Runtime.InteropServices;
 #if REAL_T_IS_DOUBLE
 using real_t = System.Double;
 #else
@@ -13,6 +14,7 @@ using real_t = System.Single;
 
 namespace Godot
 {
+    [StructLayout(LayoutKind.Sequential)]
     public struct AABB : IEquatable<AABB>
     {
         private Vector3 position;
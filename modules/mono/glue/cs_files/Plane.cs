@@ -1,4 +1,5 @@
 using System;
+using System.Runtime.InteropServices;
 #if REAL_T_IS_DOUBLE
 using real_t = System.Double;
 #else
@@ -7,9 +8,11 @@ using real_t = System.Single;
 
 namespace Godot
 {
+    [StructLayout(LayoutKind.Sequential)]
     public struct Plane : IEquatable<Plane>
     {
         private Vector3 _normal;
+        private real_t _d;
 
         public Vector3 Normal
         {
@@ -53,7 +56,11 @@ namespace Godot
             }
         }
 
-        public real_t D { get; set; }
+        public real_t D
+        {
+            get { return _d; }
+            set { _d = value; }
+        }
 
         public Vector3 Center
         {
@@ -149,19 +156,19 @@ namespace Godot
         public Plane(real_t a, real_t b, real_t c, real_t d)
         {
             _normal = new Vector3(a, b, c);
-            this.D = d;
+            _d = d;
         }
         public Plane(Vector3 normal, real_t d)
         {
             this._normal = normal;
-            this.D = d;
+            _d = d;
         }
 
         public Plane(Vector3 v1, Vector3 v2, Vector3 v3)
         {
             _normal = (v1 - v3).Cross(v1 - v2);
             _normal.Normalize();
-            D = _normal.Dot(v1);
+            _d = _normal.Dot(v1);
         }
 
         public static Plane operator -(Plane plane)
@@ -143,7 +143,10 @@ PoolVector2Array mono_array_to_PoolVector2Array(MonoArray *p_array);
 MonoArray *PoolVector3Array_to_mono_array(const PoolVector3Array &p_array);
 PoolVector3Array mono_array_to_PoolVector3Array(MonoArray *p_array);
 
-#ifdef YOLO_COPY
+// The C# math structs have sequential layouts using the same real_t as the engine,
+// so they are blittable and can be passed by pointer without per-field copies.
+
+#ifndef MONO_MARSHAL_COPY_FIELDS
 #define MARSHALLED_OUT(m_t, m_in, m_out) m_t *m_out = (m_t *)&m_in;
 #define MARSHALLED_IN(m_t, m_in, m_out) m_t m_out = *reinterpret_cast<m_t *>(m_in);
 #else
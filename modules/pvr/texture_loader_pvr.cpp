@@ -32,6 +32,7 @@
 #include "PvrTcEncoder.h"
 #include "RgbaBitmap.h"
 #include "os/file_access.h"
+#include "os/worker_thread_pool.h"
 #include <string.h>
 
 static void _pvrtc_decompress(Image *p_img);
@@ -188,6 +189,33 @@ String ResourceFormatPVR::get_resource_type(const String &p_path) const {
 	return "";
 }
 
+struct PVRTCCompressData {
+	Image *src;
+	Image *dst;
+	const uint8_t *r;
+	uint8_t *w;
+};
+
+//blocks interpolate with their neighbours, so a level can't be split, but levels are independent
+static void _compress_pvrtc4_mipmap(void *p_userdata, uint32_t p_mipmap) {
+
+	PVRTCCompressData *cd = (PVRTCCompressData *)p_userdata;
+
+	int ofs, size, w, h;
+	cd->src->get_mipmap_offset_size_and_dimensions(p_mipmap, ofs, size, w, h);
+	Javelin::RgbaBitmap bm(w, h);
+	copymem(bm.GetData(), &cd->r[ofs], size);
+	{
+		Javelin::ColorRgba<unsigned char> *dp = bm.GetData();
+		for (int j = 0; j < size / 4; j++) {
+			SWAP(dp[j].r, dp[j].b);
+		}
+	}
+
+	cd->dst->get_mipmap_offset_size_and_dimensions(p_mipmap, ofs, size, w, h);
+	Javelin::PvrTcEncoder::EncodeRgba4Bpp(&cd->w[ofs], bm);
+}
+
 static void _compress_pvrtc4(Image *p_img) {
 
 	Ref<Image> img = p_img->duplicate();
@@ -212,21 +240,22 @@ static void _compress_pvrtc4(Image *p_img) {
 		PoolVector<uint8_t>::Write wr = data.write();
 		PoolVector<uint8_t>::Read r = img->get_data().read();
 
-		for (int i = 0; i <= new_img->get_mipmap_count(); i++) {
+		PVRTCCompressData cd;
+		cd.src = img.ptr();
+		cd.dst = new_img.ptr();
+		cd.r = r.ptr();
+		cd.w = wr.ptr();
 
-			int ofs, size, w, h;
-			img->get_mipmap_offset_size_and_dimensions(i, ofs, size, w, h);
-			Javelin::RgbaBitmap bm(w, h);
-			copymem(bm.GetData(), &r[ofs], size);
-			{
-				Javelin::ColorRgba<unsigned char> *dp = bm.GetData();
-				for (int j = 0; j < size / 4; j++) {
-					SWAP(dp[j].r, dp[j].b);
-				}
-			}
+		int mipmaps = new_img->get_mipmap_count() + 1;
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
 
-			new_img->get_mipmap_offset_size_and_dimensions(i, ofs, size, w, h);
-			Javelin::PvrTcEncoder::EncodeRgba4Bpp(&wr[ofs], bm);
+		if (pool && pool->get_thread_count() > 0 && Image::get_compress_thread_count() > 1) {
+			WorkerThreadPool::GroupID group = pool->add_group_task(_compress_pvrtc4_mipmap, &cd, mipmaps, WorkerThreadPool::PRIORITY_HIGH);
+			pool->wait_for_group_task_completion(group);
+		} else {
+			for (int i = 0; i < mipmaps; i++) {
+				_compress_pvrtc4_mipmap(&cd, i);
+			}
 		}
 	}
 
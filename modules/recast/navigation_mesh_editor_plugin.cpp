@@ -30,6 +30,8 @@
 
 #include "navigation_mesh_editor_plugin.h"
 
+#ifdef TOOLS_ENABLED
+
 #include "io/marshalls.h"
 #include "io/resource_saver.h"
 #include "scene/3d/mesh_instance.h"
@@ -64,8 +66,8 @@ void NavigationMeshEditor::_bake_pressed() {
 		return;
 	}
 
-	NavigationMeshGenerator::clear(node->get_navigation_mesh());
-	NavigationMeshGenerator::bake(node->get_navigation_mesh(), node);
+	NavigationMeshGenerator::get_singleton()->clear(node->get_navigation_mesh());
+	NavigationMeshGenerator::get_singleton()->bake(node->get_navigation_mesh(), node);
 
 	if (node) {
 		node->update_gizmo();
@@ -75,7 +77,7 @@ void NavigationMeshEditor::_bake_pressed() {
 void NavigationMeshEditor::_clear_pressed() {
 
 	if (node)
-		NavigationMeshGenerator::clear(node->get_navigation_mesh());
+		NavigationMeshGenerator::get_singleton()->clear(node->get_navigation_mesh());
 
 	button_bake->set_pressed(false);
 	bake_info->set_text("");
@@ -161,3 +163,5 @@ NavigationMeshEditorPlugin::NavigationMeshEditorPlugin(EditorNode *p_node) {
 
 NavigationMeshEditorPlugin::~NavigationMeshEditorPlugin() {
 }
+
+#endif // TOOLS_ENABLED
@@ -31,6 +31,8 @@
 #ifndef NAVIGATION_MESH_GENERATOR_PLUGIN_H
 #define NAVIGATION_MESH_GENERATOR_PLUGIN_H
 
+#ifdef TOOLS_ENABLED
+
 #include "editor/editor_node.h"
 #include "editor/editor_plugin.h"
 #include "navigation_mesh_generator.h"
@@ -81,4 +83,6 @@ public:
 	~NavigationMeshEditorPlugin();
 };
 
+#endif // TOOLS_ENABLED
+
 #endif // NAVIGATION_MESH_GENERATOR_PLUGIN_H
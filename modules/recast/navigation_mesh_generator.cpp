@@ -30,6 +30,16 @@
 
 #include "navigation_mesh_generator.h"
 
+#include "core/core_string_names.h"
+#include "core/engine.h"
+#include "core/message_queue.h"
+#include "core/safe_refcount.h"
+#include "core/set.h"
+
+#ifdef TOOLS_ENABLED
+#include "editor/editor_node.h"
+#endif
+
 void NavigationMeshGenerator::_add_vertex(const Vector3 &p_vec3, Vector<float> &p_verticies) {
 	p_verticies.push_back(p_vec3.x);
 	p_verticies.push_back(p_vec3.y);
@@ -91,214 +101,734 @@ void NavigationMeshGenerator::_add_mesh(const Ref<Mesh> &p_mesh, const Transform
 	}
 }
 
-void NavigationMeshGenerator::_parse_geometry(const Transform &p_base_inverse, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices) {
+void NavigationMeshGenerator::_parse_geometry(const Transform &p_base_inverse, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, const AABB *p_filter) {
 
 	if (Object::cast_to<MeshInstance>(p_node)) {
 
 		MeshInstance *mesh_instance = Object::cast_to<MeshInstance>(p_node);
 		Ref<Mesh> mesh = mesh_instance->get_mesh();
 		if (mesh.is_valid()) {
-			_add_mesh(mesh, p_base_inverse * mesh_instance->get_global_transform(), p_verticies, p_indices);
+			Transform xform = p_base_inverse * mesh_instance->get_global_transform();
+			if (!p_filter || p_filter->intersects(xform.xform(mesh->get_aabb()))) {
+				_add_mesh(mesh, xform, p_verticies, p_indices);
+			}
 		}
 	}
 
 	for (int i = 0; i < p_node->get_child_count(); i++) {
-		_parse_geometry(p_base_inverse, p_node->get_child(i), p_verticies, p_indices);
+		_parse_geometry(p_base_inverse, p_node->get_child(i), p_verticies, p_indices, p_filter);
 	}
 }
 
-void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh) {
+void NavigationMeshGenerator::_make_config(const Ref<NavigationMesh> &p_nav_mesh, rcConfig &r_cfg) {
+
+	Ref<NavigationMesh> nav_mesh = p_nav_mesh;
+
+	memset(&r_cfg, 0, sizeof(r_cfg));
+
+	r_cfg.cs = nav_mesh->get_cell_size();
+	r_cfg.ch = nav_mesh->get_cell_height();
+	r_cfg.walkableSlopeAngle = nav_mesh->get_agent_max_slope();
+	r_cfg.walkableHeight = (int)Math::ceil(nav_mesh->get_agent_height() / r_cfg.ch);
+	r_cfg.walkableClimb = (int)Math::floor(nav_mesh->get_agent_max_climb() / r_cfg.ch);
+	r_cfg.walkableRadius = (int)Math::ceil(nav_mesh->get_agent_radius() / r_cfg.cs);
+	r_cfg.maxEdgeLen = (int)(nav_mesh->get_edge_max_length() / nav_mesh->get_cell_size());
+	r_cfg.maxSimplificationError = nav_mesh->get_edge_max_error();
+	r_cfg.minRegionArea = (int)(nav_mesh->get_region_min_size() * nav_mesh->get_region_min_size());
+	r_cfg.mergeRegionArea = (int)(nav_mesh->get_region_merge_size() * nav_mesh->get_region_merge_size());
+	r_cfg.maxVertsPerPoly = (int)nav_mesh->get_verts_per_poly();
+	r_cfg.detailSampleDist = nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : nav_mesh->get_cell_size() * nav_mesh->get_detail_sample_distance();
+	r_cfg.detailSampleMaxError = nav_mesh->get_cell_height() * nav_mesh->get_detail_sample_max_error();
+
+	if (nav_mesh->get_tile_size() > 0) {
+		r_cfg.tileSize = nav_mesh->get_tile_size();
+		r_cfg.borderSize = r_cfg.walkableRadius + 3; // enough for the erosion and the region filters to see the neighbours
+	}
+}
+
+// Frees whatever a tile build allocated, however far it got.
+struct RecastTileBuild {
+	rcHeightfield *hf;
+	rcCompactHeightfield *chf;
+	rcContourSet *cset;
+	rcPolyMesh *poly_mesh;
+	rcPolyMeshDetail *detail_mesh;
+
+	RecastTileBuild() {
+		hf = NULL;
+		chf = NULL;
+		cset = NULL;
+		poly_mesh = NULL;
+		detail_mesh = NULL;
+	}
+
+	~RecastTileBuild() {
+		rcFreeHeightField(hf);
+		rcFreeCompactHeightfield(chf);
+		rcFreeContourSet(cset);
+		rcFreePolyMesh(poly_mesh);
+		rcFreePolyMeshDetail(detail_mesh);
+	}
+};
+
+bool NavigationMeshGenerator::_build_tile(const BakeJob *p_job, Tile *p_tile) {
+
+	if (p_tile->triangles.size() == 0)
+		return true; // nothing to walk on, the tile stays empty
+
+	rcContext ctx;
+	rcConfig cfg = p_job->cfg;
+
+	if (p_job->tile_size > 0) {
+		float tile_world_size = p_job->tile_size * cfg.cs;
+		float border_world_size = cfg.borderSize * cfg.cs;
+
+		cfg.bmin[0] = p_tile->x * tile_world_size - border_world_size;
+		cfg.bmin[2] = p_tile->z * tile_world_size - border_world_size;
+		cfg.bmax[0] = (p_tile->x + 1) * tile_world_size + border_world_size;
+		cfg.bmax[2] = (p_tile->z + 1) * tile_world_size + border_world_size;
+		cfg.width = cfg.tileSize + cfg.borderSize * 2;
+		cfg.height = cfg.tileSize + cfg.borderSize * 2;
+	} else {
+		rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+	}
+
+	const float *verts = p_job->vertices.ptr();
+	const int nverts = p_job->vertices.size() / 3;
+	const int ntris = p_tile->triangles.size();
+
+	Vector<int> tris;
+	tris.resize(ntris * 3);
+	{
+		const int *src = p_job->indices.ptr();
+		const int *tri = p_tile->triangles.ptr();
+		int *dst = tris.ptrw();
+		for (int i = 0; i < ntris; i++) {
+			dst[i * 3 + 0] = src[tri[i] * 3 + 0];
+			dst[i * 3 + 1] = src[tri[i] * 3 + 1];
+			dst[i * 3 + 2] = src[tri[i] * 3 + 2];
+		}
+	}
+
+	RecastTileBuild build;
+
+	build.hf = rcAllocHeightfield();
+	ERR_FAIL_COND_V(!build.hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&ctx, *build.hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch), false);
 
-	PoolVector<Vector3> nav_vertices;
+	{
+		Vector<unsigned char> tri_areas;
+		tri_areas.resize(ntris);
+
+		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris.ptr(), ntris, tri_areas.ptrw());
+
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&ctx, verts, nverts, tris.ptr(), tri_areas.ptr(), ntris, *build.hf, cfg.walkableClimb), false);
+	}
 
-	for (int i = 0; i < p_detail_mesh->nverts; i++) {
-		const float *v = &p_detail_mesh->verts[i * 3];
-		nav_vertices.append(Vector3(v[0], v[1], v[2]));
+	if (p_job->nav_mesh->get_filter_low_hanging_obstacles())
+		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *build.hf);
+	if (p_job->nav_mesh->get_filter_ledge_spans())
+		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *build.hf);
+	if (p_job->nav_mesh->get_filter_walkable_low_height_spans())
+		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *build.hf);
+
+	build.chf = rcAllocCompactHeightfield();
+	ERR_FAIL_COND_V(!build.chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *build.hf, *build.chf), false);
+
+	rcFreeHeightField(build.hf);
+	build.hf = NULL;
+
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *build.chf), false);
+
+	if (p_job->nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&ctx, *build.chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&ctx, *build.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
+	} else if (p_job->nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&ctx, *build.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
+	} else {
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&ctx, *build.chf, cfg.borderSize, cfg.minRegionArea), false);
 	}
-	p_nav_mesh->set_vertices(nav_vertices);
 
-	for (int i = 0; i < p_detail_mesh->nmeshes; i++) {
-		const unsigned int *m = &p_detail_mesh->meshes[i * 4];
+	build.cset = rcAllocContourSet();
+	ERR_FAIL_COND_V(!build.cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&ctx, *build.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *build.cset), false);
+
+	build.poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_COND_V(!build.poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&ctx, *build.cset, cfg.maxVertsPerPoly, *build.poly_mesh), false);
+
+	build.detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_COND_V(!build.detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&ctx, *build.poly_mesh, *build.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *build.detail_mesh), false);
+
+	const rcPolyMeshDetail *detail_mesh = build.detail_mesh;
+
+	p_tile->result_vertices.resize(detail_mesh->nverts);
+	{
+		PoolVector<Vector3>::Write w = p_tile->result_vertices.write();
+		for (int i = 0; i < detail_mesh->nverts; i++) {
+			const float *v = &detail_mesh->verts[i * 3];
+			w[i] = Vector3(v[0], v[1], v[2]);
+		}
+	}
+
+	for (int i = 0; i < detail_mesh->nmeshes; i++) {
+		const unsigned int *m = &detail_mesh->meshes[i * 4];
 		const unsigned int bverts = m[0];
 		const unsigned int btris = m[2];
 		const unsigned int ntris = m[3];
-		const unsigned char *tris = &p_detail_mesh->tris[btris * 4];
+		const unsigned char *tris = &detail_mesh->tris[btris * 4];
 		for (unsigned int j = 0; j < ntris; j++) {
-			Vector<int> nav_indices;
-			nav_indices.resize(3);
-			nav_indices.write[0] = ((int)(bverts + tris[j * 4 + 0]));
-			nav_indices.write[1] = ((int)(bverts + tris[j * 4 + 1]));
-			nav_indices.write[2] = ((int)(bverts + tris[j * 4 + 2]));
-			p_nav_mesh->add_polygon(nav_indices);
+			p_tile->result_indices.push_back((int)(bverts + tris[j * 4 + 0]));
+			p_tile->result_indices.push_back((int)(bverts + tris[j * 4 + 1]));
+			p_tile->result_indices.push_back((int)(bverts + tris[j * 4 + 2]));
 		}
 	}
+
+	return true;
 }
 
-void NavigationMeshGenerator::_build_recast_navigation_mesh(Ref<NavigationMesh> p_nav_mesh, EditorProgress *ep,
-		rcHeightfield *hf, rcCompactHeightfield *chf, rcContourSet *cset, rcPolyMesh *poly_mesh, rcPolyMeshDetail *detail_mesh,
-		Vector<float> &vertices, Vector<int> &indices) {
-	rcContext ctx;
-	ep->step(TTR("Setting up Configuration..."), 1);
-
-	const float *verts = vertices.ptr();
-	const int nverts = vertices.size() / 3;
-	const int *tris = indices.ptr();
-	const int ntris = indices.size() / 3;
-
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
-
-	rcConfig cfg;
-	memset(&cfg, 0, sizeof(cfg));
-
-	cfg.cs = p_nav_mesh->get_cell_size();
-	cfg.ch = p_nav_mesh->get_cell_height();
-	cfg.walkableSlopeAngle = p_nav_mesh->get_agent_max_slope();
-	cfg.walkableHeight = (int)Math::ceil(p_nav_mesh->get_agent_height() / cfg.ch);
-	cfg.walkableClimb = (int)Math::floor(p_nav_mesh->get_agent_max_climb() / cfg.ch);
-	cfg.walkableRadius = (int)Math::ceil(p_nav_mesh->get_agent_radius() / cfg.cs);
-	cfg.maxEdgeLen = (int)(p_nav_mesh->get_edge_max_length() / p_nav_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_nav_mesh->get_edge_max_error();
-	cfg.minRegionArea = (int)(p_nav_mesh->get_region_min_size() * p_nav_mesh->get_region_min_size());
-	cfg.mergeRegionArea = (int)(p_nav_mesh->get_region_merge_size() * p_nav_mesh->get_region_merge_size());
-	cfg.maxVertsPerPoly = (int)p_nav_mesh->get_verts_per_poly();
-	cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
-	cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
-
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
-
-	ep->step(TTR("Calculating grid size..."), 2);
-	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-
-	ep->step(TTR("Creating heightfield..."), 3);
-	hf = rcAllocHeightfield();
-
-	ERR_FAIL_COND(!hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
-
-	ep->step(TTR("Marking walkable triangles..."), 4);
-	{
-		Vector<unsigned char> tri_areas;
-		tri_areas.resize(ntris);
+void NavigationMeshGenerator::_bake_tile_task(void *p_userdata, uint32_t p_index) {
 
-		ERR_FAIL_COND(tri_areas.size() == 0);
+	BakeJob *job = (BakeJob *)p_userdata;
 
-		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
-		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
+	Tile *tile = &job->tiles_w[p_index];
+	if (!_build_tile(job, tile)) {
+		// a failed tile leaves a hole rather than failing the whole bake
+		tile->result_vertices = PoolVector<Vector3>();
+		tile->result_indices.clear();
+	}
 
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+	if (atomic_increment(&job->tiles_done) == (uint32_t)job->tiles.size() && job->async) {
+		MessageQueue::get_singleton()->push_call(singleton, "_job_finished");
 	}
+}
+
+NavigationMeshGenerator::BakeJob *NavigationMeshGenerator::_create_job(const Ref<NavigationMesh> &p_nav_mesh, Node *p_node, const AABB *p_region) {
 
-	if (p_nav_mesh->get_filter_low_hanging_obstacles())
-		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *hf);
-	if (p_nav_mesh->get_filter_ledge_spans())
-		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf);
-	if (p_nav_mesh->get_filter_walkable_low_height_spans())
-		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *hf);
+	Spatial *root = Object::cast_to<Spatial>(p_node);
+	ERR_FAIL_COND_V(!root, NULL);
 
-	ep->step(TTR("Constructing compact heightfield..."), 5);
+	Transform base_inverse = root->get_global_transform().affine_inverse();
 
-	chf = rcAllocCompactHeightfield();
+	BakeJob *job = memnew(BakeJob);
+	job->nav_mesh = p_nav_mesh;
+	_make_config(p_nav_mesh, job->cfg);
+	job->tile_size = job->cfg.tileSize;
+	job->replace_all = !p_region || job->tile_size <= 0;
+	job->async = false;
+	job->tiles_w = NULL;
+	job->tiles_done = 0;
+	job->group = WorkerThreadPool::INVALID_GROUP_ID;
 
-	ERR_FAIL_COND(!chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	float tile_world_size = job->tile_size * job->cfg.cs;
+	float border_world_size = job->cfg.borderSize * job->cfg.cs;
 
-	rcFreeHeightField(hf);
-	hf = 0;
+	int from_x = 0, from_z = 0, to_x = 0, to_z = 0;
 
-	ep->step(TTR("Eroding walkable area..."), 6);
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	if (job->replace_all) {
 
-	ep->step(TTR("Partitioning..."), 7);
-	if (p_nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else if (p_nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
+		_parse_geometry(base_inverse, p_node, job->vertices, job->indices, NULL);
 	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, 0, cfg.minRegionArea));
+
+		AABB region = base_inverse.xform(*p_region);
+		from_x = (int)Math::floor(region.position.x / tile_world_size);
+		from_z = (int)Math::floor(region.position.z / tile_world_size);
+		to_x = (int)Math::floor((region.position.x + region.size.x) / tile_world_size);
+		to_z = (int)Math::floor((region.position.z + region.size.z) / tile_world_size);
+
+		// only geometry that can reach the rebuilt tiles through their border matters, at any height
+		AABB filter;
+		filter.position = Vector3(from_x * tile_world_size - border_world_size, -1e10, from_z * tile_world_size - border_world_size);
+		filter.size = Vector3((to_x - from_x + 1) * tile_world_size + border_world_size * 2, 2e10, (to_z - from_z + 1) * tile_world_size + border_world_size * 2);
+
+		_parse_geometry(base_inverse, p_node, job->vertices, job->indices, &filter);
+	}
+
+	const int nverts = job->vertices.size() / 3;
+	const int ntris = job->indices.size() / 3;
+
+	if (nverts > 0 && ntris > 0) {
+		float bmin[3], bmax[3];
+		rcCalcBounds(job->vertices.ptr(), nverts, bmin, bmax);
+
+		// keep the voxel layers aligned between bakes, so rebuilt tiles match their neighbours
+		bmin[1] = Math::floor(bmin[1] / job->cfg.ch) * job->cfg.ch;
+
+		job->cfg.bmin[0] = bmin[0];
+		job->cfg.bmin[1] = bmin[1];
+		job->cfg.bmin[2] = bmin[2];
+		job->cfg.bmax[0] = bmax[0];
+		job->cfg.bmax[1] = bmax[1];
+		job->cfg.bmax[2] = bmax[2];
+
+		if (job->tile_size > 0 && job->replace_all) {
+			from_x = (int)Math::floor(bmin[0] / tile_world_size);
+			from_z = (int)Math::floor(bmin[2] / tile_world_size);
+			to_x = (int)Math::floor(bmax[0] / tile_world_size);
+			to_z = (int)Math::floor(bmax[2] / tile_world_size);
+		}
+	} else if (job->replace_all) {
+		return job; // no geometry at all, applying this clears the mesh
+	}
+
+	int width = to_x - from_x + 1;
+	int depth = to_z - from_z + 1;
+
+	job->tiles.resize(width * depth);
+	job->tiles_w = job->tiles.ptrw();
+	for (int z = 0; z < depth; z++) {
+		for (int x = 0; x < width; x++) {
+			Tile &tile = job->tiles_w[z * width + x];
+			tile.x = from_x + x;
+			tile.z = from_z + z;
+		}
+	}
+
+	// bucket every triangle into the tiles its bounds reach, including their borders
+	const float *verts = job->vertices.ptr();
+	const int *indices = job->indices.ptr();
+	for (int i = 0; i < ntris; i++) {
+
+		if (job->tile_size <= 0) {
+			job->tiles_w[0].triangles.push_back(i);
+			continue;
+		}
+
+		float min_x = 1e20, max_x = -1e20, min_z = 1e20, max_z = -1e20;
+		for (int j = 0; j < 3; j++) {
+			const float *v = &verts[indices[i * 3 + j] * 3];
+			min_x = MIN(min_x, v[0]);
+			max_x = MAX(max_x, v[0]);
+			min_z = MIN(min_z, v[2]);
+			max_z = MAX(max_z, v[2]);
+		}
+
+		int tx0 = MAX(from_x, (int)Math::floor((min_x - border_world_size) / tile_world_size));
+		int tx1 = MIN(to_x, (int)Math::floor((max_x + border_world_size) / tile_world_size));
+		int tz0 = MAX(from_z, (int)Math::floor((min_z - border_world_size) / tile_world_size));
+		int tz1 = MIN(to_z, (int)Math::floor((max_z + border_world_size) / tile_world_size));
+
+		for (int tz = tz0; tz <= tz1; tz++) {
+			for (int tx = tx0; tx <= tx1; tx++) {
+				job->tiles_w[(tz - from_z) * width + (tx - from_x)].triangles.push_back(i);
+			}
+		}
+	}
+
+	return job;
+}
+
+static _FORCE_INLINE_ bool _get_tile_line(const Vector3 &p_point, int p_axis, float p_tile_world_size, float p_epsilon, int &r_line) {
+
+	float t = p_point[p_axis] / p_tile_world_size;
+	float line = Math::round(t);
+	if (Math::abs(t - line) * p_tile_world_size > p_epsilon)
+		return false;
+
+	r_line = (int)line;
+	return true;
+}
+
+static _FORCE_INLINE_ bool _is_on_same_tile_line(const Vector3 &p_a, const Vector3 &p_b, float p_tile_world_size, float p_epsilon, int &r_axis, int &r_line) {
+
+	for (int axis = 0; axis <= 2; axis += 2) {
+		int line_a, line_b;
+		if (_get_tile_line(p_a, axis, p_tile_world_size, p_epsilon, line_a) && _get_tile_line(p_b, axis, p_tile_world_size, p_epsilon, line_b) && line_a == line_b) {
+			r_axis = axis;
+			r_line = line_a;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void NavigationMeshGenerator::_unstitch_polygons(const PoolVector<Vector3> &p_vertices, Vector<Vector<int> > &r_polygons, float p_tile_world_size, float p_epsilon) {
+
+	// baked polygons are triangles, anything bigger got seam vertices inserted by _stitch_polygons()
+	PoolVector<Vector3>::Read r = p_vertices.read();
+
+	for (int i = 0; i < r_polygons.size(); i++) {
+
+		Vector<int> &polygon = r_polygons.write[i];
+
+		bool removed = true;
+		while (polygon.size() > 3 && removed) {
+			removed = false;
+			int len = polygon.size();
+			for (int j = 0; j < len; j++) {
+				const Vector3 &prev = r[polygon[(j + len - 1) % len]];
+				const Vector3 &next = r[polygon[(j + 1) % len]];
+				int axis, line, axis_self, line_self;
+				if (_is_on_same_tile_line(prev, next, p_tile_world_size, p_epsilon, axis, line) && _is_on_same_tile_line(prev, r[polygon[j]], p_tile_world_size, p_epsilon, axis_self, line_self) && axis == axis_self && line == line_self) {
+					polygon.remove(j);
+					removed = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+struct NavSeamVertex {
+	float along;
+	float y;
+	int index;
+
+	bool operator<(const NavSeamVertex &p_other) const { return along == p_other.along ? y < p_other.y : along < p_other.along; }
+};
+
+void NavigationMeshGenerator::_stitch_polygons(PoolVector<Vector3> &r_vertices, Vector<Vector<int> > &r_polygons, float p_tile_world_size, float p_cell_size, float p_max_climb) {
+
+	// Navigation links polygons only through edges whose end points match exactly, but each tile
+	// simplifies its side of a seam on its own. Weld the seam vertices of both sides together and
+	// split seam edges at the vertices of the other side, so every seam edge has a twin.
+
+	float epsilon = p_cell_size * 0.1;
+
+	Map<int64_t, Vector<NavSeamVertex> > lines;
+
+	{
+		PoolVector<Vector3>::Read r = r_vertices.read();
+		for (int i = 0; i < r_vertices.size(); i++) {
+			for (int axis = 0; axis <= 2; axis += 2) {
+				int line;
+				if (!_get_tile_line(r[i], axis, p_tile_world_size, epsilon, line))
+					continue;
+
+				NavSeamVertex sv;
+				sv.along = r[i][2 - axis];
+				sv.y = r[i].y;
+				sv.index = i;
+				lines[int64_t(line) * 2 + (axis ? 1 : 0)].push_back(sv);
+			}
+		}
 	}
 
-	ep->step(TTR("Creating contours..."), 8);
+	for (Map<int64_t, Vector<NavSeamVertex> >::Element *E = lines.front(); E; E = E->next()) {
+
+		Vector<NavSeamVertex> &seam = E->get();
+		seam.sort();
 
-	cset = rcAllocContourSet();
+		int axis = (E->key() & 1) ? 2 : 0;
+		float line_pos = (E->key() >> 1) * p_tile_world_size;
 
-	ERR_FAIL_COND(!cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
+		// weld: vertices closer than half a cell along the seam, on the same floor, become one
+		PoolVector<Vector3>::Write w = r_vertices.write();
+		Vector<NavSeamVertex> unique;
+		for (int i = 0; i < seam.size(); i++) {
+
+			const NavSeamVertex &sv = seam[i];
+			int found = -1;
+			for (int j = unique.size() - 1; j >= 0 && sv.along - unique[j].along < p_cell_size * 0.5; j--) {
+				if (Math::abs(sv.y - unique[j].y) <= p_max_climb) {
+					found = j;
+					break;
+				}
+			}
+
+			if (found == -1) {
+				NavSeamVertex u = sv;
+				w[sv.index][axis] = line_pos;
+				unique.push_back(u);
+			} else {
+				w[sv.index] = w[unique[found].index];
+			}
+		}
+
+		seam = unique;
+	}
 
-	ep->step(TTR("Creating polymesh..."), 9);
+	PoolVector<Vector3>::Read r = r_vertices.read();
 
-	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_COND(!poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	for (int i = 0; i < r_polygons.size(); i++) {
 
-	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_COND(!detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
+		Vector<int> &polygon = r_polygons.write[i];
 
-	rcFreeCompactHeightfield(chf);
-	chf = 0;
-	rcFreeContourSet(cset);
-	cset = 0;
+		for (int j = 0; j < polygon.size(); j++) {
 
-	ep->step(TTR("Converting to native navigation mesh..."), 10);
+			const Vector3 a = r[polygon[j]];
+			const Vector3 b = r[polygon[(j + 1) % polygon.size()]];
 
-	_convert_detail_mesh_to_native_navigation_mesh(detail_mesh, p_nav_mesh);
+			int axis, line;
+			if (!_is_on_same_tile_line(a, b, p_tile_world_size, epsilon, axis, line))
+				continue;
 
-	rcFreePolyMesh(poly_mesh);
-	poly_mesh = 0;
-	rcFreePolyMeshDetail(detail_mesh);
-	detail_mesh = 0;
+			Map<int64_t, Vector<NavSeamVertex> >::Element *S = lines.find(int64_t(line) * 2 + (axis ? 1 : 0));
+			if (!S)
+				continue;
+			const Vector<NavSeamVertex> *seam = &S->get();
+
+			float along_a = a[2 - axis];
+			float along_b = b[2 - axis];
+			float from = MIN(along_a, along_b) + epsilon;
+			float to = MAX(along_a, along_b) - epsilon;
+			if (from >= to)
+				continue;
+
+			Vector<int> inserted;
+			for (int k = 0; k < seam->size(); k++) {
+				const NavSeamVertex &sv = (*seam)[k];
+				if (sv.along <= from)
+					continue;
+				if (sv.along >= to)
+					break;
+
+				float t = (sv.along - along_a) / (along_b - along_a);
+				if (Math::abs(sv.y - (a.y + (b.y - a.y) * t)) > p_max_climb)
+					continue; // a seam vertex of another floor
+
+				inserted.push_back(sv.index);
+			}
+
+			if (inserted.size() == 0)
+				continue;
+
+			if (along_a > along_b)
+				inserted.invert();
+
+			for (int k = 0; k < inserted.size(); k++) {
+				polygon.insert(j + 1 + k, inserted[k]);
+			}
+			j += inserted.size();
+		}
+	}
+}
+
+void NavigationMeshGenerator::_apply_job(BakeJob *p_job) {
+
+	Ref<NavigationMesh> nav_mesh = p_job->nav_mesh;
+
+	float tile_world_size = p_job->tile_size * p_job->cfg.cs;
+
+	PoolVector<Vector3> vertices;
+	Vector<Vector<int> > polygons;
+
+	if (!p_job->replace_all) {
+
+		vertices = nav_mesh->get_vertices();
+		for (int i = 0; i < nav_mesh->get_polygon_count(); i++) {
+			polygons.push_back(nav_mesh->get_polygon(i));
+		}
+		_unstitch_polygons(vertices, polygons, tile_world_size, p_job->cfg.cs * 0.1);
+
+		Set<int64_t> rebuilt;
+		for (int i = 0; i < p_job->tiles.size(); i++) {
+			rebuilt.insert((int64_t(p_job->tiles[i].x) << 32) | uint32_t(p_job->tiles[i].z));
+		}
+
+		// every polygon lies inside the tile it was built in, so its centroid tells which one
+		PoolVector<Vector3>::Read r = vertices.read();
+		for (int i = polygons.size() - 1; i >= 0; i--) {
+			const Vector<int> &polygon = polygons[i];
+			Vector3 centroid;
+			for (int j = 0; j < polygon.size(); j++) {
+				centroid += r[polygon[j]];
+			}
+			centroid /= MAX(1, polygon.size());
+
+			int x = (int)Math::floor(centroid.x / tile_world_size);
+			int z = (int)Math::floor(centroid.z / tile_world_size);
+			if (rebuilt.has((int64_t(x) << 32) | uint32_t(z))) {
+				polygons.remove(i);
+			}
+		}
+	}
+
+	for (int i = 0; i < p_job->tiles.size(); i++) {
+
+		const Tile &tile = p_job->tiles[i];
+		int from = vertices.size();
+		vertices.append_array(tile.result_vertices);
+
+		for (int j = 0; j < tile.result_indices.size(); j += 3) {
+			Vector<int> polygon;
+			polygon.resize(3);
+			polygon.write[0] = from + tile.result_indices[j + 0];
+			polygon.write[1] = from + tile.result_indices[j + 1];
+			polygon.write[2] = from + tile.result_indices[j + 2];
+			polygons.push_back(polygon);
+		}
+	}
+
+	if (p_job->tile_size > 0) {
+		_stitch_polygons(vertices, polygons, tile_world_size, p_job->cfg.cs, nav_mesh->get_agent_max_climb());
+	}
+
+	// drop the vertices only removed polygons used
+	Vector<int> remap;
+	remap.resize(vertices.size());
+	for (int i = 0; i < remap.size(); i++) {
+		remap.write[i] = -1;
+	}
+
+	PoolVector<Vector3> used_vertices;
+	{
+		PoolVector<Vector3>::Read r = vertices.read();
+		for (int i = 0; i < polygons.size(); i++) {
+			Vector<int> &polygon = polygons.write[i];
+			for (int j = 0; j < polygon.size(); j++) {
+				int idx = polygon[j];
+				if (remap[idx] == -1) {
+					remap.write[idx] = used_vertices.size();
+					used_vertices.push_back(r[idx]);
+				}
+				polygon.write[j] = remap[idx];
+			}
+		}
+	}
+
+	nav_mesh->clear_polygons();
+	nav_mesh->set_vertices(used_vertices);
+	for (int i = 0; i < polygons.size(); i++) {
+		nav_mesh->add_polygon(polygons[i]);
+	}
+
+	nav_mesh->emit_signal(CoreStringNames::get_singleton()->changed);
+}
+
+void NavigationMeshGenerator::_job_finished() {
+
+	List<BakeJob *>::Element *E = jobs.front();
+	while (E) {
+
+		List<BakeJob *>::Element *N = E->next();
+		BakeJob *job = E->get();
+
+		if (job->tiles_done == (uint32_t)job->tiles.size()) {
+
+			if (job->group != WorkerThreadPool::INVALID_GROUP_ID) {
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(job->group);
+			}
+
+			_apply_job(job);
+			emit_signal("region_baked", job->nav_mesh);
+
+			jobs.erase(E);
+			memdelete(job);
+		}
+
+		E = N;
+	}
+}
+
+NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
+
+	return singleton;
 }
 
 void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node) {
 
 	ERR_FAIL_COND(!p_nav_mesh.is_valid());
 
-	EditorProgress ep("bake", TTR("Navigation Mesh Generator Setup:"), 11);
-	ep.step(TTR("Parsing Geometry..."), 0);
+#ifdef TOOLS_ENABLED
+	EditorProgress *ep = NULL;
+	if (Engine::get_singleton()->is_editor_hint() && EditorNode::get_singleton()) {
+		ep = memnew(EditorProgress("bake", TTR("Navigation Mesh Generator Setup:"), 3));
+		ep->step(TTR("Parsing Geometry..."), 0);
+	}
+#endif
 
-	Vector<float> vertices;
-	Vector<int> indices;
+	BakeJob *job = _create_job(p_nav_mesh, p_node, NULL);
 
-	_parse_geometry(Object::cast_to<Spatial>(p_node)->get_global_transform().affine_inverse(), p_node, vertices, indices);
+	if (job) {
 
-	if (vertices.size() > 0 && indices.size() > 0) {
+#ifdef TOOLS_ENABLED
+		if (ep)
+			ep->step(TTR("Baking tiles..."), 1);
+#endif
 
-		rcHeightfield *hf = NULL;
-		rcCompactHeightfield *chf = NULL;
-		rcContourSet *cset = NULL;
-		rcPolyMesh *poly_mesh = NULL;
-		rcPolyMeshDetail *detail_mesh = NULL;
+		if (job->tiles.size()) {
+			job->group = WorkerThreadPool::get_singleton()->add_group_task(_bake_tile_task, job, job->tiles.size(), WorkerThreadPool::PRIORITY_HIGH);
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(job->group);
+		}
 
-		_build_recast_navigation_mesh(p_nav_mesh, &ep, hf, chf, cset, poly_mesh, detail_mesh, vertices, indices);
+#ifdef TOOLS_ENABLED
+		if (ep)
+			ep->step(TTR("Converting to native navigation mesh..."), 2);
+#endif
 
-		rcFreeHeightField(hf);
-		hf = 0;
+		_apply_job(job);
+		memdelete(job);
+	}
 
-		rcFreeCompactHeightfield(chf);
-		chf = 0;
+#ifdef TOOLS_ENABLED
+	if (ep) {
+		ep->step(TTR("Done!"), 3);
+		memdelete(ep);
+	}
+#endif
+}
 
-		rcFreeContourSet(cset);
-		cset = 0;
+void NavigationMeshGenerator::bake_region_async(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_region) {
 
-		rcFreePolyMesh(poly_mesh);
-		poly_mesh = 0;
+	ERR_FAIL_COND(!p_nav_mesh.is_valid());
 
-		rcFreePolyMeshDetail(detail_mesh);
-		detail_mesh = 0;
+	// the scene is only read here, rasterizing and building the tiles happens on the worker threads
+	BakeJob *job = _create_job(p_nav_mesh, p_node, &p_region);
+	ERR_FAIL_COND(!job);
+
+	job->async = true;
+	jobs.push_back(job);
+
+	if (job->tiles.size() == 0) {
+		MessageQueue::get_singleton()->push_call(this, "_job_finished");
+		return;
 	}
-	ep.step(TTR("Done!"), 11);
+
+	job->group = WorkerThreadPool::get_singleton()->add_group_task(_bake_tile_task, job, job->tiles.size(), WorkerThreadPool::PRIORITY_LOW);
+}
+
+bool NavigationMeshGenerator::is_baking(Ref<NavigationMesh> p_nav_mesh) const {
+
+	for (const List<BakeJob *>::Element *E = jobs.front(); E; E = E->next()) {
+		if (E->get()->nav_mesh == p_nav_mesh)
+			return true;
+	}
+
+	return false;
 }
 
 void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 	if (p_nav_mesh.is_valid()) {
 		p_nav_mesh->clear_polygons();
 		p_nav_mesh->set_vertices(PoolVector<Vector3>());
+		p_nav_mesh->emit_signal(CoreStringNames::get_singleton()->changed);
+	}
+}
+
+void NavigationMeshGenerator::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("bake", "nav_mesh", "root_node"), &NavigationMeshGenerator::bake);
+	ClassDB::bind_method(D_METHOD("bake_region_async", "nav_mesh", "root_node", "region"), &NavigationMeshGenerator::bake_region_async);
+	ClassDB::bind_method(D_METHOD("is_baking", "nav_mesh"), &NavigationMeshGenerator::is_baking);
+	ClassDB::bind_method(D_METHOD("clear", "nav_mesh"), &NavigationMeshGenerator::clear);
+
+	ClassDB::bind_method(D_METHOD("_job_finished"), &NavigationMeshGenerator::_job_finished);
+
+	ADD_SIGNAL(MethodInfo("region_baked", PropertyInfo(Variant::OBJECT, "nav_mesh", PROPERTY_HINT_RESOURCE_TYPE, "NavigationMesh")));
+}
+
+NavigationMeshGenerator *NavigationMeshGenerator::singleton = NULL;
+
+NavigationMeshGenerator::NavigationMeshGenerator() {
+
+	singleton = this;
+}
+
+NavigationMeshGenerator::~NavigationMeshGenerator() {
+
+	while (jobs.size()) {
+		BakeJob *job = jobs.front()->get();
+		if (job->group != WorkerThreadPool::INVALID_GROUP_ID) {
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(job->group);
+		}
+		memdelete(job);
+		jobs.pop_front();
 	}
+
+	singleton = NULL;
 }
@@ -31,29 +31,88 @@
 #ifndef NAVIGATION_MESH_GENERATOR_H
 #define NAVIGATION_MESH_GENERATOR_H
 
-#include "editor/editor_node.h"
-#include "editor/editor_settings.h"
-#include "os/thread.h"
+#include "os/worker_thread_pool.h"
 #include "scene/3d/mesh_instance.h"
 #include "scene/3d/navigation_mesh.h"
 #include "scene/resources/shape.h"
 
 #include <Recast.h>
 
-class NavigationMeshGenerator {
-protected:
+#ifdef TOOLS_ENABLED
+struct EditorProgress;
+#endif
+
+/**
+ * Bakes NavigationMesh resources with Recast.
+ *
+ * When the navigation mesh has a tile size, the geometry is split into a grid
+ * of tiles anchored at the origin of the baking root, and every tile is built
+ * as its own heightfield on the WorkerThreadPool. Tiles are identified by the
+ * centroid of their polygons, so a later bake_region_async() can replace only
+ * the tiles touched by changed geometry, even on a mesh baked in the editor.
+ */
+
+class NavigationMeshGenerator : public Object {
+
+	GDCLASS(NavigationMeshGenerator, Object);
+
+	static NavigationMeshGenerator *singleton;
+
+	struct Tile {
+		int x;
+		int z;
+		Vector<int> triangles; // indices into the job triangles which overlap the tile and its border
+
+		PoolVector<Vector3> result_vertices;
+		Vector<int> result_indices; // triangles
+	};
+
+	struct BakeJob {
+		Ref<NavigationMesh> nav_mesh;
+		rcConfig cfg; // shared settings, bounds are filled per tile
+		int tile_size;
+		bool replace_all;
+		bool async;
+
+		Vector<float> vertices;
+		Vector<int> indices;
+		Vector<Tile> tiles;
+		Tile *tiles_w; // written by the tile tasks, one element each
+
+		volatile uint32_t tiles_done;
+		WorkerThreadPool::GroupID group;
+	};
+
+	List<BakeJob *> jobs;
+
 	static void _add_vertex(const Vector3 &p_vec3, Vector<float> &p_verticies);
 	static void _add_mesh(const Ref<Mesh> &p_mesh, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices);
-	static void _parse_geometry(const Transform &p_base_inverse, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices);
+	static void _parse_geometry(const Transform &p_base_inverse, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, const AABB *p_filter);
+
+	static void _make_config(const Ref<NavigationMesh> &p_nav_mesh, rcConfig &r_cfg);
+	static bool _build_tile(const BakeJob *p_job, Tile *p_tile);
+	static void _bake_tile_task(void *p_userdata, uint32_t p_index);
+
+	BakeJob *_create_job(const Ref<NavigationMesh> &p_nav_mesh, Node *p_node, const AABB *p_region);
+	void _apply_job(BakeJob *p_job);
+	void _job_finished();
 
-	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh);
-	static void _build_recast_navigation_mesh(Ref<NavigationMesh> p_nav_mesh, EditorProgress *ep,
-			rcHeightfield *hf, rcCompactHeightfield *chf, rcContourSet *cset, rcPolyMesh *poly_mesh,
-			rcPolyMeshDetail *detail_mesh, Vector<float> &vertices, Vector<int> &indices);
+	static void _unstitch_polygons(const PoolVector<Vector3> &p_vertices, Vector<Vector<int> > &r_polygons, float p_tile_world_size, float p_epsilon);
+	static void _stitch_polygons(PoolVector<Vector3> &r_vertices, Vector<Vector<int> > &r_polygons, float p_tile_world_size, float p_cell_size, float p_max_climb);
+
+protected:
+	static void _bind_methods();
 
 public:
-	static void bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
-	static void clear(Ref<NavigationMesh> p_nav_mesh);
+	static NavigationMeshGenerator *get_singleton();
+
+	void bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
+	void bake_region_async(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_region);
+	bool is_baking(Ref<NavigationMesh> p_nav_mesh) const;
+	void clear(Ref<NavigationMesh> p_nav_mesh);
+
+	NavigationMeshGenerator();
+	~NavigationMeshGenerator();
 };
 
 #endif // NAVIGATION_MESH_GENERATOR_H
@@ -30,10 +30,29 @@
 
 #include "register_types.h"
 
+#include "core/engine.h"
+#include "navigation_mesh_generator.h"
+
+#ifdef TOOLS_ENABLED
 #include "navigation_mesh_editor_plugin.h"
+#endif
+
+static NavigationMeshGenerator *_nav_mesh_generator = NULL;
 
 void register_recast_types() {
+
+	_nav_mesh_generator = memnew(NavigationMeshGenerator);
+	ClassDB::register_class<NavigationMeshGenerator>();
+	Engine::get_singleton()->add_singleton(Engine::Singleton("NavigationMeshGenerator", NavigationMeshGenerator::get_singleton()));
+
+#ifdef TOOLS_ENABLED
 	EditorPlugins::add_by_type<NavigationMeshEditorPlugin>();
+#endif
 }
 
-void unregister_recast_types() {}
+void unregister_recast_types() {
+
+	if (_nav_mesh_generator) {
+		memdelete(_nav_mesh_generator);
+	}
+}
@@ -30,6 +30,7 @@
 
 #include "image_compress_squish.h"
 
+#include "os/worker_thread_pool.h"
 #include "print_string.h"
 
 #if defined(__SSE2__)
@@ -81,6 +82,46 @@ void image_decompress_squish(Image *p_image) {
 	p_image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
 }
 
+struct SquishMipmap {
+	int src_ofs;
+	int dst_ofs;
+	int w;
+	int h;
+};
+
+struct SquishCompressData {
+	const uint8_t *src;
+	uint8_t *dst;
+	const SquishMipmap *mipmaps;
+	int mipmap_count;
+	int flags;
+	int block_bytes;
+	int splits;
+};
+
+//blocks don't depend on each other, so every split compresses its own range of block rows in each mipmap
+static void _compress_squish_split(void *p_userdata, uint32_t p_index) {
+
+	const SquishCompressData *cd = (const SquishCompressData *)p_userdata;
+
+	for (int i = 0; i < cd->mipmap_count; i++) {
+
+		const SquishMipmap &mm = cd->mipmaps[i];
+
+		int block_rows = (mm.h + 3) / 4;
+		int from = block_rows * p_index / cd->splits;
+		int to = block_rows * (p_index + 1) / cd->splits;
+		if (from == to)
+			continue;
+
+		int blocks_w = (mm.w + 3) / 4;
+		int y = from * 4;
+		int rows = MIN(to * 4, mm.h) - y;
+
+		squish::CompressImage(&cd->src[mm.src_ofs + y * mm.w * 4], mm.w, rows, &cd->dst[mm.dst_ofs + from * blocks_w * cd->block_bytes], cd->flags);
+	}
+}
+
 void image_compress_squish(Image *p_image, Image::CompressSource p_source) {
 
 	if (p_image->get_format() >= Image::FORMAT_DXT1)
@@ -185,18 +226,44 @@ void image_compress_squish(Image *p_image, Image::CompressSource p_source) {
 
 		int dst_ofs = 0;
 
+		Vector<SquishMipmap> mipmaps;
+		mipmaps.resize(mm_count + 1);
+
 		for (int i = 0; i <= mm_count; i++) {
 
 			int bw = w % 4 != 0 ? w + (4 - w % 4) : w;
 			int bh = h % 4 != 0 ? h + (4 - h % 4) : h;
 
-			int src_ofs = p_image->get_mipmap_offset(i);
-			squish::CompressImage(&rb[src_ofs], w, h, &wb[dst_ofs], squish_comp);
+			SquishMipmap &mm = mipmaps.write[i];
+			mm.src_ofs = p_image->get_mipmap_offset(i);
+			mm.dst_ofs = dst_ofs;
+			mm.w = w;
+			mm.h = h;
+
 			dst_ofs += (MAX(4, bw) * MAX(4, bh)) >> shift;
 			w >>= 1;
 			h >>= 1;
 		}
 
+		SquishCompressData cd;
+		cd.src = rb.ptr();
+		cd.dst = wb.ptr();
+		cd.mipmaps = mipmaps.ptr();
+		cd.mipmap_count = mipmaps.size();
+		cd.flags = squish_comp;
+		cd.block_bytes = (squish_comp & (squish::kDxt1 | squish::kBc4)) ? 8 : 16;
+		cd.splits = MIN(Image::get_compress_thread_count(), MAX(1, (p_image->get_height() + 3) / 4 / 16)); //at least 16 block rows each
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+		if (pool && pool->get_thread_count() > 0 && cd.splits > 1) {
+			WorkerThreadPool::GroupID group = pool->add_group_task(_compress_squish_split, &cd, cd.splits, WorkerThreadPool::PRIORITY_HIGH);
+			pool->wait_for_group_task_completion(group);
+		} else {
+			cd.splits = 1;
+			_compress_squish_split(&cd, 0);
+		}
+
 		rb = PoolVector<uint8_t>::Read();
 		wb = PoolVector<uint8_t>::Write();
 
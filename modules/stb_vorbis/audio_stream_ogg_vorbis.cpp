@@ -37,45 +37,187 @@
 #include "thirdparty/misc/stb_vorbis.c"
 #pragma GCC diagnostic pop
 
-void AudioStreamPlaybackOGGVorbis::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+Thread *AudioStreamPlaybackOGGVorbis::decode_thread = NULL;
+Semaphore *AudioStreamPlaybackOGGVorbis::decode_semaphore = NULL;
+Mutex *AudioStreamPlaybackOGGVorbis::decode_mutex = NULL;
+volatile bool AudioStreamPlaybackOGGVorbis::decode_exit = false;
+SelfList<AudioStreamPlaybackOGGVorbis>::List AudioStreamPlaybackOGGVorbis::decode_list;
 
-	ERR_FAIL_COND(!active);
+int AudioStreamPlaybackOGGVorbis::_decode(AudioFrame *p_buffer, int p_frames) {
 
 	int todo = p_frames;
 
-	int start_buffer = 0;
-
-	while (todo && active) {
-		float *buffer = (float *)p_buffer;
-		if (start_buffer > 0) {
-			buffer = (buffer + start_buffer * 2);
-		}
-		int mixed = stb_vorbis_get_samples_float_interleaved(ogg_stream, 2, buffer, todo * 2);
+	while (todo && !decode_end) {
+		AudioFrame *buffer = p_buffer + (p_frames - todo);
+		int mixed = stb_vorbis_get_samples_float_interleaved(ogg_stream, 2, (float *)buffer, todo * 2);
 		if (vorbis_stream->channels == 1 && mixed > 0) {
 			//mix mono to stereo
-			for (int i = start_buffer; i < mixed; i++) {
-				p_buffer[i].r = p_buffer[i].l;
+			for (int i = 0; i < mixed; i++) {
+				buffer[i].r = buffer[i].l;
 			}
 		}
 		todo -= mixed;
-		frames_mixed += mixed;
 
 		if (todo) {
 			//end of file!
 			if (vorbis_stream->loop) {
-				//loop
-				seek(vorbis_stream->loop_offset);
-				loops++;
-				// we still have buffer to fill, start from this element in the next iteration.
-				start_buffer = p_frames - todo;
+				stb_vorbis_seek(ogg_stream, uint32_t(vorbis_stream->sample_rate * vorbis_stream->loop_offset));
 			} else {
-				for (int i = p_frames - todo; i < p_frames; i++) {
-					p_buffer[i] = AudioFrame(0, 0);
+				decode_end = true;
+			}
+		}
+	}
+
+	return p_frames - todo;
+}
+
+void AudioStreamPlaybackOGGVorbis::_decode_ahead(int p_frames) {
+
+	AudioFrame buffer[DECODE_CHUNK_FRAMES];
+
+	while (p_frames > 0 && !decode_end) {
+		int decoded = _decode(buffer, MIN(p_frames, (int)DECODE_CHUNK_FRAMES));
+		decode_ahead.write(buffer, decoded);
+		p_frames -= decoded;
+	}
+}
+
+void AudioStreamPlaybackOGGVorbis::_seek_decoder(uint32_t p_frame) {
+
+	if (decode_mutex)
+		decode_mutex->lock();
+
+	stb_vorbis_seek(ogg_stream, p_frame);
+	decode_ahead.clear();
+	decode_end = false;
+
+	if (decode_mutex)
+		decode_mutex->unlock();
+}
+
+void AudioStreamPlaybackOGGVorbis::_decode_thread_func(void *p_ud) {
+
+	while (!decode_exit) {
+
+		decode_semaphore->wait();
+
+		if (decode_exit)
+			break;
+
+		decode_mutex->lock();
+
+		bool pending = true;
+		while (pending) {
+			pending = false;
+
+			for (SelfList<AudioStreamPlaybackOGGVorbis> *E = decode_list.first(); E; E = E->next()) {
+
+				AudioStreamPlaybackOGGVorbis *playback = E->self();
+				playback->decode_requested = false;
+
+				if (!playback->active || playback->decode_end)
+					continue;
+
+				int space = playback->decode_ahead.space_left();
+				if (space > DECODE_CHUNK_FRAMES) {
+					pending = true;
 				}
-				active = false;
-				todo = 0;
+				playback->_decode_ahead(MIN(space, (int)DECODE_CHUNK_FRAMES));
 			}
+
+			//decode one chunk per stream at a time, so the mix thread never waits long on seeks or underruns
+			decode_mutex->unlock();
+			decode_mutex->lock();
+		}
+
+		decode_mutex->unlock();
+	}
+}
+
+void AudioStreamPlaybackOGGVorbis::initialize_decoder() {
+
+#ifndef NO_THREADS
+	decode_mutex = Mutex::create();
+	decode_semaphore = Semaphore::create();
+	if (decode_semaphore) {
+		decode_exit = false;
+
+		Thread::Settings settings;
+		settings.name = "Vorbis Decode";
+		settings.priority = Thread::PRIORITY_LOW;
+		decode_thread = Thread::create(_decode_thread_func, NULL, settings);
+
+		if (!decode_thread) {
+			memdelete(decode_semaphore);
+			decode_semaphore = NULL;
+		}
+	}
+#endif
+}
+
+void AudioStreamPlaybackOGGVorbis::finish_decoder() {
+
+	if (decode_thread) {
+		decode_exit = true;
+		decode_semaphore->post();
+		Thread::wait_to_finish(decode_thread);
+		memdelete(decode_thread);
+		decode_thread = NULL;
+		memdelete(decode_semaphore);
+		decode_semaphore = NULL;
+	}
+
+	if (decode_mutex) {
+		memdelete(decode_mutex);
+		decode_mutex = NULL;
+	}
+}
+
+void AudioStreamPlaybackOGGVorbis::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+
+	ERR_FAIL_COND(!active);
+
+	if (seek_pending) {
+		//position was moved while virtual, catch up the decoder now
+		_seek_decoder(frames_mixed);
+		seek_pending = false;
+	}
+
+	//the real-time thread only copies what was decoded ahead
+	int mixed = decode_ahead.read(p_buffer, p_frames);
+
+	if (mixed < p_frames && !decode_end) {
+		//underrun (or no decoder thread), decode the rest right here
+		if (decode_mutex)
+			decode_mutex->lock();
+
+		mixed += decode_ahead.read(p_buffer + mixed, p_frames - mixed);
+		mixed += _decode(p_buffer + mixed, p_frames - mixed);
+
+		if (decode_mutex)
+			decode_mutex->unlock();
+	}
+
+	frames_mixed += mixed;
+
+	if (vorbis_stream->loop && vorbis_stream->length_frames && frames_mixed >= vorbis_stream->length_frames) {
+		uint32_t loop_frame = uint32_t(vorbis_stream->sample_rate * vorbis_stream->loop_offset);
+		frames_mixed = loop_frame + (frames_mixed - vorbis_stream->length_frames);
+		loops++;
+	}
+
+	if (mixed < p_frames) {
+		//end of file!
+		for (int i = mixed; i < p_frames; i++) {
+			p_buffer[i] = AudioFrame(0, 0);
 		}
+		active = false;
+		return;
+	}
+
+	if (decode_thread && !decode_end && !decode_requested && decode_ahead.space_left() >= decode_ahead.size() / 2) {
+		decode_requested = true;
+		decode_semaphore->post();
 	}
 }
 
@@ -120,10 +262,59 @@ void AudioStreamPlaybackOGGVorbis::seek(float p_time) {
 	}
 	frames_mixed = uint32_t(vorbis_stream->sample_rate * p_time);
 
-	stb_vorbis_seek(ogg_stream, frames_mixed);
+	_seek_decoder(frames_mixed);
+	seek_pending = false;
+}
+
+void AudioStreamPlaybackOGGVorbis::advance(float p_time) {
+
+	if (!active)
+		return;
+
+	//only do the bookkeeping here, the decoder seeks once mixing resumes
+	float length = vorbis_stream->get_length();
+	float pos = get_playback_position() + p_time;
+
+	if (pos >= length) {
+		if (!vorbis_stream->loop) {
+			active = false;
+			return;
+		}
+
+		float loop_offset = vorbis_stream->loop_offset;
+		float loop_length = length - loop_offset;
+		pos = loop_length > 0 ? loop_offset + Math::fmod(pos - loop_offset, loop_length) : loop_offset;
+		loops++;
+	}
+
+	frames_mixed = uint32_t(vorbis_stream->sample_rate * pos);
+	seek_pending = true;
+}
+
+AudioStreamPlaybackOGGVorbis::AudioStreamPlaybackOGGVorbis() :
+		decode_item(this) {
+
+	ogg_stream = NULL;
+	ogg_alloc.alloc_buffer = NULL;
+	frames_mixed = 0;
+	active = false;
+	seek_pending = false;
+	loops = 0;
+	decode_end = false;
+	decode_requested = false;
+	decode_ahead.resize(DECODE_AHEAD_BITS);
 }
 
 AudioStreamPlaybackOGGVorbis::~AudioStreamPlaybackOGGVorbis() {
+
+	if (decode_item.in_list()) {
+		if (decode_mutex)
+			decode_mutex->lock();
+		decode_list.remove(&decode_item);
+		if (decode_mutex)
+			decode_mutex->unlock();
+	}
+
 	if (ogg_alloc.alloc_buffer) {
 		stb_vorbis_close(ogg_stream);
 		AudioServer::get_singleton()->audio_data_free(ogg_alloc.alloc_buffer);
@@ -152,6 +343,12 @@ Ref<AudioStreamPlayback> AudioStreamOGGVorbis::instance_playback() {
 		ERR_FAIL_COND_V(!ovs->ogg_stream, Ref<AudioStreamPlaybackOGGVorbis>());
 	}
 
+	if (AudioStreamPlaybackOGGVorbis::decode_mutex)
+		AudioStreamPlaybackOGGVorbis::decode_mutex->lock();
+	AudioStreamPlaybackOGGVorbis::decode_list.add_last(&ovs->decode_item);
+	if (AudioStreamPlaybackOGGVorbis::decode_mutex)
+		AudioStreamPlaybackOGGVorbis::decode_mutex->unlock();
+
 	return ovs;
 }
 
@@ -211,6 +408,7 @@ void AudioStreamOGGVorbis::set_data(const PoolVector<uint8_t> &p_data) {
 			//print_line("succeeded "+itos(ogg_alloc.alloc_buffer_length_in_bytes)+" setup "+itos(info.setup_memory_required)+" setup temp "+itos(info.setup_temp_memory_required)+" temp "+itos(info.temp_memory_required)+" maxframe"+itos(info.max_frame_size));
 
 			length = stb_vorbis_stream_length_in_seconds(ogg_stream);
+			length_frames = stb_vorbis_stream_length_in_samples(ogg_stream);
 			stb_vorbis_close(ogg_stream);
 
 			// free any existing data
@@ -281,6 +479,7 @@ AudioStreamOGGVorbis::AudioStreamOGGVorbis() {
 
 	data = NULL;
 	length = 0;
+	length_frames = 0;
 	sample_rate = 1;
 	channels = 1;
 	loop_offset = 0;
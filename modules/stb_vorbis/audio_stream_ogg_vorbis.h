@@ -32,6 +32,11 @@
 #define AUDIO_STREAM_STB_VORBIS_H
 
 #include "io/resource_loader.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "ring_buffer.h"
+#include "self_list.h"
 #include "servers/audio/audio_stream.h"
 
 #define STB_VORBIS_HEADER_ONLY
@@ -47,12 +52,36 @@ class AudioStreamPlaybackOGGVorbis : public AudioStreamPlaybackResampled {
 
 	GDCLASS(AudioStreamPlaybackOGGVorbis, AudioStreamPlaybackResampled)
 
+	enum {
+		DECODE_AHEAD_BITS = 13, //8192 frames, about 180ms at 44100hz
+		DECODE_CHUNK_FRAMES = 1024
+	};
+
 	stb_vorbis *ogg_stream;
 	stb_vorbis_alloc ogg_alloc;
 	uint32_t frames_mixed;
 	bool active;
+	bool seek_pending;
 	int loops;
 
+	//decoded frames waiting to be mixed, filled by the decoder thread
+	RingBuffer<AudioFrame> decode_ahead;
+	SelfList<AudioStreamPlaybackOGGVorbis> decode_item;
+	volatile bool decode_end;
+	volatile bool decode_requested;
+
+	int _decode(AudioFrame *p_buffer, int p_frames);
+	void _decode_ahead(int p_frames);
+	void _seek_decoder(uint32_t p_frame);
+
+	static Thread *decode_thread;
+	static Semaphore *decode_semaphore;
+	static Mutex *decode_mutex;
+	static volatile bool decode_exit;
+	static SelfList<AudioStreamPlaybackOGGVorbis>::List decode_list;
+
+	static void _decode_thread_func(void *p_ud);
+
 	friend class AudioStreamOGGVorbis;
 
 	Ref<AudioStreamOGGVorbis> vorbis_stream;
@@ -71,7 +100,12 @@ public:
 	virtual float get_playback_position() const;
 	virtual void seek(float p_time);
 
-	AudioStreamPlaybackOGGVorbis() {}
+	virtual void advance(float p_time);
+
+	static void initialize_decoder();
+	static void finish_decoder();
+
+	AudioStreamPlaybackOGGVorbis();
 	~AudioStreamPlaybackOGGVorbis();
 };
 
@@ -90,6 +124,7 @@ class AudioStreamOGGVorbis : public AudioStream {
 	float sample_rate;
 	int channels;
 	float length;
+	uint32_t length_frames;
 	bool loop;
 	float loop_offset;
 	void clear_data();
@@ -112,6 +147,8 @@ public:
 
 	virtual float get_length() const; //if supported, otherwise return 0
 
+	virtual uint64_t get_memory_usage() const { return data_len; }
+
 	AudioStreamOGGVorbis();
 	virtual ~AudioStreamOGGVorbis();
 };
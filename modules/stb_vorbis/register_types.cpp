@@ -40,7 +40,11 @@ void register_stb_vorbis_types() {
 	ResourceFormatImporter::get_singleton()->add_importer(ogg_import);
 #endif
 	ClassDB::register_class<AudioStreamOGGVorbis>();
+
+	AudioStreamPlaybackOGGVorbis::initialize_decoder();
 }
 
 void unregister_stb_vorbis_types() {
+
+	AudioStreamPlaybackOGGVorbis::finish_decoder();
 }
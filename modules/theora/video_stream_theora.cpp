@@ -31,6 +31,7 @@
 #include "video_stream_theora.h"
 
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
 #include "project_settings.h"
 
 #include "thirdparty/misc/yuv2rgb.h"
@@ -80,31 +81,61 @@ int VideoStreamPlaybackTheora::queue_page(ogg_page *page) {
 	return 0;
 }
 
-void VideoStreamPlaybackTheora::video_write(void) {
-	th_ycbcr_buffer yuv;
-	th_decode_ycbcr_out(td, yuv);
+void VideoStreamPlaybackTheora::_convert_rows(int p_from, int p_rows) {
 
-	int pitch = 4;
-	frame_data.resize(size.x * size.y * pitch);
-	{
-		PoolVector<uint8_t>::Write w = frame_data.write();
-		char *dst = (char *)w.ptr();
+	const th_img_plane *yuv = convert_yuv;
 
-		//uv_offset=(ti.pic_x/2)+(yuv[1].stride)*(ti.pic_y/2);
+	uint8_t *dst = convert_dst + p_from * (size.x << 2);
+	uint8_t *y = (uint8_t *)yuv[0].data + p_from * yuv[0].stride;
+	int uv_from = px_fmt == TH_PF_420 ? p_from / 2 : p_from;
+	uint8_t *u = (uint8_t *)yuv[1].data + uv_from * yuv[1].stride;
+	uint8_t *v = (uint8_t *)yuv[2].data + uv_from * yuv[2].stride;
 
-		if (px_fmt == TH_PF_444) {
+	//uv_offset=(ti.pic_x/2)+(yuv[1].stride)*(ti.pic_y/2);
 
-			yuv444_2_rgb8888((uint8_t *)dst, (uint8_t *)yuv[0].data, (uint8_t *)yuv[1].data, (uint8_t *)yuv[2].data, size.x, size.y, yuv[0].stride, yuv[1].stride, size.x << 2, 0);
+	if (px_fmt == TH_PF_444) {
 
-		} else if (px_fmt == TH_PF_422) {
+		yuv444_2_rgb8888(dst, y, u, v, size.x, p_rows, yuv[0].stride, yuv[1].stride, size.x << 2, 0);
 
-			yuv422_2_rgb8888((uint8_t *)dst, (uint8_t *)yuv[0].data, (uint8_t *)yuv[1].data, (uint8_t *)yuv[2].data, size.x, size.y, yuv[0].stride, yuv[1].stride, size.x << 2, 0);
+	} else if (px_fmt == TH_PF_422) {
 
-		} else if (px_fmt == TH_PF_420) {
+		yuv422_2_rgb8888(dst, y, u, v, size.x, p_rows, yuv[0].stride, yuv[1].stride, size.x << 2, 0);
 
-			yuv420_2_rgb8888((uint8_t *)dst, (uint8_t *)yuv[0].data, (uint8_t *)yuv[2].data, (uint8_t *)yuv[1].data, size.x, size.y, yuv[0].stride, yuv[1].stride, size.x << 2, 0);
-		};
+	} else if (px_fmt == TH_PF_420) {
+
+		yuv420_2_rgb8888(dst, y, v, u, size.x, p_rows, yuv[0].stride, yuv[1].stride, size.x << 2, 0);
+	};
+}
+
+void VideoStreamPlaybackTheora::_convert_band(void *p_ud, uint32_t p_band) {
+
+	VideoStreamPlaybackTheora *vs = (VideoStreamPlaybackTheora *)p_ud;
+
+	int from = p_band * CONVERT_BAND_ROWS;
+	vs->_convert_rows(from, MIN((int)CONVERT_BAND_ROWS, vs->size.y - from));
+}
+
+void VideoStreamPlaybackTheora::video_write(void) {
+	th_decode_ycbcr_out(td, convert_yuv);
+
+	int pitch = 4;
+	frame_data.resize(size.x * size.y * pitch);
+	{
+		PoolVector<uint8_t>::Write w = frame_data.write();
+		convert_dst = w.ptr();
+
+		//bands of rows are independent, so large frames are converted in parallel
+		int bands = (size.y + CONVERT_BAND_ROWS - 1) / CONVERT_BAND_ROWS;
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && pool->get_thread_count() > 0 && bands > 1) {
+			WorkerThreadPool::GroupID group = pool->add_group_task(_convert_band, this, bands, WorkerThreadPool::PRIORITY_HIGH);
+			pool->wait_for_group_task_completion(group);
+		} else {
+			_convert_rows(0, size.y);
+		}
 
+		convert_dst = NULL;
 		format = Image::FORMAT_RGBA8;
 	}
 
@@ -683,6 +714,7 @@ void VideoStreamPlaybackTheora::_streaming_thread(void *ud) {
 VideoStreamPlaybackTheora::VideoStreamPlaybackTheora() {
 
 	file = NULL;
+	convert_dst = NULL;
 	theora_p = 0;
 	vorbis_p = 0;
 	videobuf_ready = 0;
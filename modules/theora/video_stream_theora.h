@@ -50,6 +50,7 @@ class VideoStreamPlaybackTheora : public VideoStreamPlayback {
 
 	enum {
 		MAX_FRAMES = 4,
+		CONVERT_BAND_ROWS = 64, //must be even, 4:2:0 chroma rows are shared by two lines
 	};
 
 	//Image frames[MAX_FRAMES];
@@ -66,6 +67,12 @@ class VideoStreamPlaybackTheora : public VideoStreamPlayback {
 	void video_write(void);
 	float get_time() const;
 
+	th_ycbcr_buffer convert_yuv;
+	uint8_t *convert_dst;
+
+	void _convert_rows(int p_from, int p_rows);
+	static void _convert_band(void *p_ud, uint32_t p_band);
+
 	bool theora_eos;
 	bool vorbis_eos;
 
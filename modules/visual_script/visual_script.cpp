@@ -1440,50 +1440,53 @@ bool VisualScriptInstance::has_method(const StringName &p_method) const {
 //#define VSDEBUG(m_text) print_line(m_text)
 #define VSDEBUG(m_text)
 
-void VisualScriptInstance::_dependency_step(VisualScriptNodeInstance *node, int p_pass, int *pass_stack, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str, VisualScriptNodeInstance **r_error_node) {
+void VisualScriptInstance::_compile_dependency_chain(VisualScriptNodeInstance *p_node, VisualScriptNodeInstance *p_root, Set<VisualScriptNodeInstance *> &r_visited) {
 
-	ERR_FAIL_COND(node->pass_idx == -1);
+	for (int i = 0; i < p_node->dependencies.size(); i++) {
 
-	if (pass_stack[node->pass_idx] == p_pass)
-		return;
+		VisualScriptNodeInstance *dep = p_node->dependencies[i];
+		if (r_visited.has(dep))
+			continue;
 
-	pass_stack[node->pass_idx] = p_pass;
+		r_visited.insert(dep);
+		_compile_dependency_chain(dep, p_root, r_visited);
+		p_root->dependency_chain.push_back(dep); //dependencies of dep were added first
+	}
+}
 
-	if (!node->dependencies.empty()) {
+void VisualScriptInstance::_step_dependencies(VisualScriptNodeInstance *p_node, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str, VisualScriptNodeInstance **r_error_node) {
 
-		int dc = node->dependencies.size();
-		VisualScriptNodeInstance **deps = node->dependencies.ptrw();
+	int dc = p_node->dependency_chain.size();
+	VisualScriptNodeInstance *const *deps = p_node->dependency_chain.ptr();
 
-		for (int i = 0; i < dc; i++) {
+	for (int d = 0; d < dc; d++) {
 
-			_dependency_step(deps[i], p_pass, pass_stack, input_args, output_args, variant_stack, r_error, error_str, r_error_node);
-			if (r_error.error != Variant::CallError::CALL_OK)
-				return;
-		}
-	}
+		VisualScriptNodeInstance *node = deps[d];
 
-	for (int i = 0; i < node->input_port_count; i++) {
+		for (int i = 0; i < node->input_port_count; i++) {
 
-		int index = node->input_ports[i] & VisualScriptNodeInstance::INPUT_MASK;
+			int index = node->input_ports[i] & VisualScriptNodeInstance::INPUT_MASK;
 
-		if (node->input_ports[i] & VisualScriptNodeInstance::INPUT_DEFAULT_VALUE_BIT) {
-			//is a default value (unassigned input port)
-			input_args[i] = &default_values[index];
-		} else {
-			//regular temporary in stack
-			input_args[i] = &variant_stack[index];
+			if (node->input_ports[i] & VisualScriptNodeInstance::INPUT_DEFAULT_VALUE_BIT) {
+				//is a default value (unassigned input port)
+				input_args[i] = &default_values[index];
+			} else {
+				//regular temporary in stack
+				input_args[i] = &variant_stack[index];
+			}
+		}
+		for (int i = 0; i < node->output_port_count; i++) {
+			output_args[i] = &variant_stack[node->output_ports[i]];
 		}
-	}
-	for (int i = 0; i < node->output_port_count; i++) {
-		output_args[i] = &variant_stack[node->output_ports[i]];
-	}
 
-	Variant *working_mem = node->working_mem_idx >= 0 ? &variant_stack[node->working_mem_idx] : (Variant *)NULL;
+		Variant *working_mem = node->working_mem_idx >= 0 ? &variant_stack[node->working_mem_idx] : (Variant *)NULL;
 
-	node->step(input_args, output_args, VisualScriptNodeInstance::START_MODE_BEGIN_SEQUENCE, working_mem, r_error, error_str);
-	//ignore return
-	if (r_error.error != Variant::CallError::CALL_OK) {
-		*r_error_node = node;
+		node->step(input_args, output_args, VisualScriptNodeInstance::START_MODE_BEGIN_SEQUENCE, working_mem, r_error, error_str);
+		//ignore return
+		if (r_error.error != Variant::CallError::CALL_OK) {
+			*r_error_node = node;
+			return;
+		}
 	}
 }
 
@@ -1500,7 +1503,6 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 	Variant **output_args = (Variant **)(input_args + max_input_args);
 	int flow_max = f->flow_stack_size;
 	int *flow_stack = flow_max ? (int *)(output_args + max_output_args) : (int *)NULL;
-	int *pass_stack = flow_stack + flow_max;
 
 	String error_str;
 
@@ -1539,21 +1541,14 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 			}
 		} else {
 
-			//run dependencies first
+			//run dependencies first, in the order compiled at load
 
-			if (!node->dependencies.empty()) {
+			if (!node->dependency_chain.empty()) {
 
-				int dc = node->dependencies.size();
-				VisualScriptNodeInstance **deps = node->dependencies.ptrw();
-
-				for (int i = 0; i < dc; i++) {
-
-					_dependency_step(deps[i], p_pass, pass_stack, input_args, output_args, variant_stack, r_error, error_str, &node);
-					if (r_error.error != Variant::CallError::CALL_OK) {
-						error = true;
-						current_node_id = node->id;
-						break;
-					}
+				_step_dependencies(node, input_args, output_args, variant_stack, r_error, error_str, &node);
+				if (r_error.error != Variant::CallError::CALL_OK) {
+					error = true;
+					current_node_id = node->id;
 				}
 			}
 
@@ -1900,7 +1895,6 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	total_stack_size += f->node_count * sizeof(bool);
 	total_stack_size += (max_input_args + max_output_args) * sizeof(Variant *); //arguments
 	total_stack_size += f->flow_stack_size * sizeof(int); //flow
-	total_stack_size += f->pass_stack_size * sizeof(int);
 
 	VSDEBUG("STACK SIZE: " + itos(total_stack_size));
 	VSDEBUG("STACK VARIANTS: : " + itos(f->max_stack));
@@ -1908,7 +1902,6 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	VSDEBUG("MAX INPUT: " + itos(max_input_args));
 	VSDEBUG("MAX OUTPUT: " + itos(max_output_args));
 	VSDEBUG("FLOW STACK SIZE: " + itos(f->flow_stack_size));
-	VSDEBUG("PASS STACK SIZE: " + itos(f->pass_stack_size));
 
 	void *stack = alloca(total_stack_size);
 
@@ -1918,14 +1911,11 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	Variant **output_args = (Variant **)(input_args + max_input_args);
 	int flow_max = f->flow_stack_size;
 	int *flow_stack = flow_max ? (int *)(output_args + max_output_args) : (int *)NULL;
-	int *pass_stack = flow_stack + flow_max;
 
 	for (int i = 0; i < f->node_count; i++) {
 		sequence_bits[i] = false; //all starts as false
 	}
 
-	zeromem(pass_stack, f->pass_stack_size * sizeof(int));
-
 	Map<int, VisualScriptNodeInstance *>::Element *E = instances.find(f->node);
 	if (!E) {
 		r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
@@ -2043,7 +2033,6 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 		function.node = E->get().function_id;
 		function.max_stack = 0;
 		function.flow_stack_size = 0;
-		function.pass_stack_size = 0;
 		function.node_count = 0;
 
 		Map<StringName, int> local_var_indices;
@@ -2088,7 +2077,6 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 			instance->sequence_output_count = node->get_output_sequence_port_count();
 			instance->sequence_index = function.node_count++;
 			instance->sequence_outputs = NULL;
-			instance->pass_idx = -1;
 
 			if (instance->input_port_count) {
 				instance->input_ports = memnew_arr(int, instance->input_port_count);
@@ -2165,10 +2153,6 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 
 			if (from->get_sequence_output_count() == 0 && to->dependencies.find(from) == -1) {
 				//if the node we are reading from has no output sequence, we must call step() before reading from it.
-				if (from->pass_idx == -1) {
-					from->pass_idx = function.pass_stack_size;
-					function.pass_stack_size++;
-				}
 				to->dependencies.push_back(from);
 			}
 
@@ -2192,6 +2176,7 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 		//fourth pass:
 		// 1) unassigned input ports to default values
 		// 2) connect unassigned output ports to trash
+		// 3) flatten data dependencies, so each step runs them linearly instead of walking the graph
 
 		for (const Map<int, VisualScript::Function::NodeData>::Element *F = E->get().nodes.front(); F; F = F->next()) {
 
@@ -2216,6 +2201,10 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 					instance->output_ports[i] = function.trash_pos; //trash is same for all
 				}
 			}
+
+			Set<VisualScriptNodeInstance *> visited;
+			visited.insert(instance);
+			_compile_dependency_chain(instance, instance, visited);
 		}
 
 		functions[E->key()] = function;
@@ -118,12 +118,12 @@ class VisualScriptNodeInstance {
 	VisualScriptNodeInstance **sequence_outputs;
 	int sequence_output_count;
 	Vector<VisualScriptNodeInstance *> dependencies;
+	Vector<VisualScriptNodeInstance *> dependency_chain; //all dependencies, flattened in evaluation order
 	int *input_ports;
 	int input_port_count;
 	int *output_ports;
 	int output_port_count;
 	int working_mem_idx;
-	int pass_idx;
 
 	VisualScriptNode *base;
 
@@ -376,7 +376,6 @@ class VisualScriptInstance : public ScriptInstance {
 		int max_stack;
 		int trash_pos;
 		int flow_stack_size;
-		int pass_stack_size;
 		int node_count;
 		int argument_count;
 	};
@@ -388,7 +387,8 @@ class VisualScriptInstance : public ScriptInstance {
 
 	StringName source;
 
-	void _dependency_step(VisualScriptNodeInstance *node, int p_pass, int *pass_stack, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str, VisualScriptNodeInstance **r_error_node);
+	void _compile_dependency_chain(VisualScriptNodeInstance *p_node, VisualScriptNodeInstance *p_root, Set<VisualScriptNodeInstance *> &r_visited);
+	void _step_dependencies(VisualScriptNodeInstance *p_node, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str, VisualScriptNodeInstance **r_error_node);
 	Variant _call_internal(const StringName &p_method, void *p_stack, int p_stack_size, VisualScriptNodeInstance *p_node, int p_flow_stack_pos, int p_pass, bool p_resuming_yield, Variant::CallError &r_error);
 
 	//Map<StringName,Function> functions;
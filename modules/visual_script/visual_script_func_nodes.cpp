@@ -756,6 +756,8 @@ public:
 	VisualScriptFunctionCall::RPCCallMode rpc_mode;
 	StringName function;
 	StringName singleton;
+	Variant::Type basic_type;
+	Variant::BuiltinMethod builtin_method;
 
 	VisualScriptFunctionCall *node;
 	VisualScriptInstance *instance;
@@ -854,9 +856,13 @@ public:
 							r_error_str = "Invalid returns count for call_mode == CALL_MODE_INSTANCE";
 							return 0;
 						}
+					} else if (builtin_method && v.get_type() == basic_type) {
+						v.call_builtin(builtin_method, p_inputs + 1, input_args, p_outputs[0], r_error);
 					} else {
 						*p_outputs[0] = v.call(function, p_inputs + 1, input_args, r_error);
 					}
+				} else if (builtin_method && v.get_type() == basic_type) {
+					v.call_builtin(builtin_method, p_inputs + 1, input_args, NULL, r_error);
 				} else {
 					v.call(function, p_inputs + 1, input_args, r_error);
 				}
@@ -904,6 +910,8 @@ VisualScriptNodeInstance *VisualScriptFunctionCall::instance(VisualScriptInstanc
 	instance->singleton = singleton;
 	instance->function = function;
 	instance->call_mode = call_mode;
+	instance->basic_type = basic_type;
+	instance->builtin_method = call_mode == CALL_MODE_BASIC_TYPE ? Variant::get_builtin_method(basic_type, function) : NULL;
 	instance->returns = get_output_value_port_count();
 	instance->node_path = base_path;
 	instance->input_args = get_input_value_port_count() - ((call_mode == CALL_MODE_BASIC_TYPE || call_mode == CALL_MODE_INSTANCE) ? 1 : 0);
@@ -37,6 +37,7 @@ void EMWSPeer::set_sock(int p_sock) {
 	peer_sock = p_sock;
 	in_buffer.clear();
 	queue_count = 0;
+	_borrowed_bytes = 0;
 }
 
 void EMWSPeer::set_write_mode(WriteMode p_mode) {
@@ -84,11 +85,18 @@ Error EMWSPeer::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
 	}, peer_sock, p_buffer, p_buffer_size, is_bin);
 	/* clang-format on */
 
+	_sent_packets++;
+	_sent_bytes += p_buffer_size;
+
 	return OK;
 };
 
 Error EMWSPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
+	// release the packet lent by the previous call
+	in_buffer.advance_read(_borrowed_bytes);
+	_borrowed_bytes = 0;
+
 	if (queue_count == 0)
 		return ERR_UNAVAILABLE;
 
@@ -108,8 +116,16 @@ Error EMWSPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
 	in_buffer.read(&is_string, 1);
 	_was_string = is_string == 1;
-	in_buffer.read(packet_buffer, to_read);
-	*r_buffer = packet_buffer;
+
+	const uint8_t *packet;
+	if (to_read && in_buffer.get_read_ptr(&packet) >= (int)to_read) {
+		// contiguous, lend it from the ring buffer and keep it reserved until the next get_packet
+		_borrowed_bytes = to_read;
+		*r_buffer = packet;
+	} else {
+		in_buffer.read(packet_buffer, to_read);
+		*r_buffer = packet_buffer;
+	}
 	r_buffer_size = to_read;
 
 	return OK;
@@ -120,6 +136,34 @@ int EMWSPeer::get_available_packet_count() const {
 	return queue_count;
 };
 
+int EMWSPeer::get_queued_packet_count() const {
+
+	return 0; // the browser queues messages, but only reports bytes
+}
+
+int EMWSPeer::get_queued_bytes() const {
+
+	if (peer_sock == -1)
+		return 0;
+
+	/* clang-format off */
+	return EM_ASM_INT({
+		var sock = Module.IDHandler.get($0);
+		return sock ? sock.bufferedAmount : 0;
+	}, peer_sock);
+	/* clang-format on */
+}
+
+uint64_t EMWSPeer::get_sent_packet_count() const {
+
+	return _sent_packets;
+}
+
+uint64_t EMWSPeer::get_sent_bytes() const {
+
+	return _sent_bytes;
+}
+
 bool EMWSPeer::was_string_packet() const {
 
 	return _was_string;
@@ -143,6 +187,7 @@ void EMWSPeer::close() {
 	}
 	peer_sock = -1;
 	queue_count = 0;
+	_borrowed_bytes = 0;
 	in_buffer.clear();
 };
 
@@ -161,6 +206,9 @@ uint16_t EMWSPeer::get_connected_port() const {
 EMWSPeer::EMWSPeer() {
 	peer_sock = -1;
 	queue_count = 0;
+	_borrowed_bytes = 0;
+	_sent_packets = 0;
+	_sent_bytes = 0;
 	_was_string = false;
 	in_buffer.resize(16);
 	write_mode = WRITE_MODE_BINARY;
@@ -53,6 +53,9 @@ private:
 	uint8_t packet_buffer[PACKET_BUFFER_SIZE];
 	RingBuffer<uint8_t> in_buffer;
 	int queue_count;
+	int _borrowed_bytes; // packet lent from in_buffer by get_packet
+	uint64_t _sent_packets;
+	uint64_t _sent_bytes;
 	bool _was_string;
 
 public:
@@ -72,6 +75,11 @@ public:
 	virtual void set_write_mode(WriteMode p_mode);
 	virtual bool was_string_packet() const;
 
+	virtual int get_queued_packet_count() const;
+	virtual int get_queued_bytes() const;
+	virtual uint64_t get_sent_packet_count() const;
+	virtual uint64_t get_sent_bytes() const;
+
 	void set_wsi(struct lws *wsi);
 	Error read_wsi(void *in, size_t len);
 	Error write_wsi();
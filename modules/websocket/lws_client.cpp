@@ -130,7 +130,7 @@ int LWSClient::_handle_cb(struct lws *wsi, enum lws_callback_reasons reason, voi
 			peer_data->in_size = 0;
 			peer_data->in_count = 0;
 			peer_data->out_count = 0;
-			peer_data->rbw.resize(16);
+			peer_data->out_bytes = 0;
 			peer_data->rbr.resize(16);
 			peer_data->force_close = false;
 			_on_connect(lws_get_protocol(wsi)->name);
@@ -144,7 +144,8 @@ int LWSClient::_handle_cb(struct lws *wsi, enum lws_callback_reasons reason, voi
 		case LWS_CALLBACK_CLIENT_CLOSED:
 			peer_data->in_count = 0;
 			peer_data->out_count = 0;
-			peer_data->rbw.resize(0);
+			peer_data->out_bytes = 0;
+			peer_data->out_queue.clear();
 			peer_data->rbr.resize(0);
 			peer->close();
 			destroy_context();
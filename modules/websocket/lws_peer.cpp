@@ -42,6 +42,7 @@
 
 void LWSPeer::set_wsi(struct lws *p_wsi) {
 	wsi = p_wsi;
+	_borrowed_bytes = 0;
 };
 
 void LWSPeer::set_write_mode(WriteMode p_mode) {
@@ -85,25 +86,30 @@ Error LWSPeer::write_wsi() {
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
 	PeerData *peer_data = (PeerData *)(lws_wsi_user(wsi));
-	PoolVector<uint8_t> tmp;
-	int left = peer_data->rbw.data_left();
-	uint32_t to_write = 0;
 
-	if (left == 0 || peer_data->out_count == 0)
-		return OK;
+	// write as much as the socket takes in this callback, instead of one packet per cycle
+	while (peer_data->out_count > 0) {
 
-	peer_data->rbw.read((uint8_t *)&to_write, 4);
-	peer_data->out_count--;
+		PoolVector<uint8_t> packet = peer_data->out_queue.front()->get();
+		peer_data->out_queue.pop_front();
+		peer_data->out_count--;
 
-	if (left < to_write) {
-		peer_data->rbw.advance_read(left);
-		return FAILED;
-	}
+		int size = packet.size() - LWS_PRE;
+		peer_data->out_bytes -= size;
+
+		// lws only fills the frame header in the headroom, which is the same for every peer a
+		// broadcast buffer is shared with (servers don't mask frames), so write it in place
+		PoolVector<uint8_t>::Read r = packet.read();
+		uint8_t *data = const_cast<uint8_t *>(&r[LWS_PRE]);
+		if (lws_write(wsi, data, size, (enum lws_write_protocol)write_mode) < 0)
+			return FAILED;
 
-	tmp.resize(LWS_PRE + to_write);
-	peer_data->rbw.read(&(tmp.write()[LWS_PRE]), to_write);
-	lws_write(wsi, &(tmp.write()[LWS_PRE]), to_write, (enum lws_write_protocol)write_mode);
-	tmp.resize(0);
+		_sent_packets++;
+		_sent_bytes += size;
+
+		if (lws_send_pipe_choked(wsi))
+			break;
+	}
 
 	if (peer_data->out_count > 0)
 		lws_callback_on_writable(wsi); // we want to write more!
@@ -111,17 +117,43 @@ Error LWSPeer::write_wsi() {
 	return OK;
 }
 
-Error LWSPeer::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
+PoolVector<uint8_t> LWSPeer::make_out_packet(const uint8_t *p_buffer, int p_buffer_size) {
+
+	PoolVector<uint8_t> packet;
+	packet.resize(LWS_PRE + p_buffer_size);
+	if (p_buffer_size > 0) {
+		PoolVector<uint8_t>::Write w = packet.write();
+		copymem(&w[LWS_PRE], p_buffer, p_buffer_size);
+	}
+	return packet;
+}
+
+Error LWSPeer::put_out_packet(const PoolVector<uint8_t> &p_packet) {
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
 	PeerData *peer_data = (PeerData *)lws_wsi_user(wsi);
-	peer_data->rbw.write((uint8_t *)&p_buffer_size, 4);
-	peer_data->rbw.write(p_buffer, MIN(p_buffer_size, peer_data->rbw.space_left()));
+	int size = p_packet.size() - LWS_PRE;
+
+	if (peer_data->out_bytes + size > MAX_OUT_QUEUE_SIZE) {
+		ERR_EXPLAIN("Output queue full! Dropping packet");
+		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	}
+
+	peer_data->out_queue.push_back(p_packet);
 	peer_data->out_count++;
+	peer_data->out_bytes += size;
 
-	lws_callback_on_writable(wsi); // notify that we want to write
+	if (peer_data->out_count == 1)
+		lws_callback_on_writable(wsi); // notify that we want to write, already requested otherwise
 	return OK;
+}
+
+Error LWSPeer::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
+
+	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
+
+	return put_out_packet(make_out_packet(p_buffer, p_buffer_size));
 };
 
 Error LWSPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
@@ -130,6 +162,10 @@ Error LWSPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
 	PeerData *peer_data = (PeerData *)lws_wsi_user(wsi);
 
+	// release the packet lent by the previous call
+	peer_data->rbr.advance_read(_borrowed_bytes);
+	_borrowed_bytes = 0;
+
 	if (peer_data->in_count == 0)
 		return ERR_UNAVAILABLE;
 
@@ -148,8 +184,16 @@ Error LWSPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 	}
 
 	peer_data->rbr.read(&is_string, 1);
-	peer_data->rbr.read(packet_buffer, to_read);
-	*r_buffer = packet_buffer;
+
+	const uint8_t *packet;
+	if (to_read && peer_data->rbr.get_read_ptr(&packet) >= (int)to_read) {
+		// contiguous, lend it from the ring buffer and keep it reserved until the next get_packet
+		_borrowed_bytes = to_read;
+		*r_buffer = packet;
+	} else {
+		peer_data->rbr.read(packet_buffer, to_read);
+		*r_buffer = packet_buffer;
+	}
 	r_buffer_size = to_read;
 	_was_string = is_string;
 
@@ -169,6 +213,32 @@ bool LWSPeer::was_string_packet() const {
 	return _was_string;
 };
 
+int LWSPeer::get_queued_packet_count() const {
+
+	if (!is_connected_to_host())
+		return 0;
+
+	return ((PeerData *)lws_wsi_user(wsi))->out_count;
+}
+
+int LWSPeer::get_queued_bytes() const {
+
+	if (!is_connected_to_host())
+		return 0;
+
+	return ((PeerData *)lws_wsi_user(wsi))->out_bytes;
+}
+
+uint64_t LWSPeer::get_sent_packet_count() const {
+
+	return _sent_packets;
+}
+
+uint64_t LWSPeer::get_sent_bytes() const {
+
+	return _sent_bytes;
+}
+
 bool LWSPeer::is_connected_to_host() const {
 
 	return wsi != NULL;
@@ -229,6 +299,9 @@ uint16_t LWSPeer::get_connected_port() const {
 LWSPeer::LWSPeer() {
 	wsi = NULL;
 	_was_string = false;
+	_borrowed_bytes = 0;
+	_sent_packets = 0;
+	_sent_bytes = 0;
 	write_mode = WRITE_MODE_BINARY;
 };
 
@@ -34,6 +34,7 @@
 
 #include "core/error_list.h"
 #include "core/io/packet_peer.h"
+#include "core/list.h"
 #include "core/ring_buffer.h"
 #include "libwebsockets.h"
 #include "lws_config.h"
@@ -45,26 +46,34 @@ class LWSPeer : public WebSocketPeer {
 
 private:
 	enum {
-		PACKET_BUFFER_SIZE = 65536 - 5 // 4 bytes for the size, 1 for the type
+		PACKET_BUFFER_SIZE = 65536 - 5, // 4 bytes for the size, 1 for the type
+		MAX_OUT_QUEUE_SIZE = 16 * 1024 * 1024 // outgoing bytes queued per peer before dropping packets
 	};
 
 	uint8_t packet_buffer[PACKET_BUFFER_SIZE];
 	struct lws *wsi;
 	WriteMode write_mode;
 	bool _was_string;
+	int _borrowed_bytes; // packet lent from rbr by get_packet
+	uint64_t _sent_packets;
+	uint64_t _sent_bytes;
 
 public:
 	struct PeerData {
 		uint32_t peer_id;
 		bool force_close;
-		RingBuffer<uint8_t> rbw;
+		List<PoolVector<uint8_t> > out_queue; // packets with LWS_PRE bytes of headroom, possibly shared with other peers
 		RingBuffer<uint8_t> rbr;
 		mutable uint8_t input_buffer[PACKET_BUFFER_SIZE];
 		uint32_t in_size;
 		int in_count;
 		int out_count;
+		int out_bytes;
 	};
 
+	static PoolVector<uint8_t> make_out_packet(const uint8_t *p_buffer, int p_buffer_size);
+	Error put_out_packet(const PoolVector<uint8_t> &p_packet);
+
 	virtual int get_available_packet_count() const;
 	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size);
 	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size);
@@ -79,6 +88,11 @@ public:
 	virtual void set_write_mode(WriteMode p_mode);
 	virtual bool was_string_packet() const;
 
+	virtual int get_queued_packet_count() const;
+	virtual int get_queued_bytes() const;
+	virtual uint64_t get_sent_packet_count() const;
+	virtual uint64_t get_sent_bytes() const;
+
 	void set_wsi(struct lws *wsi);
 	Error read_wsi(void *in, size_t len);
 	Error write_wsi();
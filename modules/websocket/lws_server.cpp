@@ -95,7 +95,7 @@ int LWSServer::_handle_cb(struct lws *wsi, enum lws_callback_reasons reason, voi
 			peer_data->in_size = 0;
 			peer_data->in_count = 0;
 			peer_data->out_count = 0;
-			peer_data->rbw.resize(16);
+			peer_data->out_bytes = 0;
 			peer_data->rbr.resize(16);
 			peer_data->force_close = false;
 
@@ -114,7 +114,8 @@ int LWSServer::_handle_cb(struct lws *wsi, enum lws_callback_reasons reason, voi
 			peer_data->in_count = 0;
 			peer_data->out_count = 0;
 			peer_data->rbr.resize(0);
-			peer_data->rbw.resize(0);
+			peer_data->out_bytes = 0;
+			peer_data->out_queue.clear();
 			_on_disconnect(id);
 			return 0; // we can end here
 		}
@@ -176,6 +177,17 @@ int LWSServer::get_peer_port(int p_peer_id) const {
 	return _peer_map[p_peer_id]->get_connected_port();
 }
 
+void LWSServer::_broadcast(const uint8_t *p_buffer, int p_buffer_size, int32_t p_exclude, int32_t p_exclude2) {
+
+	// encode once, every peer queues the same buffer
+	PoolVector<uint8_t> packet = LWSPeer::make_out_packet(p_buffer, p_buffer_size);
+
+	for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
+		if (E->key() != p_exclude && E->key() != p_exclude2)
+			static_cast<Ref<LWSPeer> >(E->get())->put_out_packet(packet);
+	}
+}
+
 void LWSServer::disconnect_peer(int p_peer_id) {
 	ERR_FAIL_COND(!has_peer(p_peer_id));
 
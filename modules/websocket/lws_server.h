@@ -46,6 +46,9 @@ class LWSServer : public WebSocketServer {
 private:
 	Map<int, Ref<LWSPeer> > peer_map;
 
+protected:
+	virtual void _broadcast(const uint8_t *p_buffer, int p_buffer_size, int32_t p_exclude, int32_t p_exclude2);
+
 public:
 	Error listen(int p_port, PoolVector<String> p_protocols = PoolVector<String>(), bool gd_mp_api = false);
 	void stop();
@@ -232,6 +232,14 @@ void WebSocketMultiplayerPeer::_send_del(int32_t p_peer_id) {
 	}
 }
 
+void WebSocketMultiplayerPeer::_broadcast(const uint8_t *p_buffer, int p_buffer_size, int32_t p_exclude, int32_t p_exclude2) {
+
+	for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
+		if (E->key() != p_exclude && E->key() != p_exclude2)
+			E->get()->put_packet(p_buffer, p_buffer_size);
+	}
+}
+
 void WebSocketMultiplayerPeer::_store_pkt(int32_t p_source, int32_t p_dest, const uint8_t *p_data, uint32_t p_data_size) {
 	Packet packet;
 	packet.data = (uint8_t *)memalloc(p_data_size);
@@ -250,18 +258,12 @@ Error WebSocketMultiplayerPeer::_server_relay(int32_t p_from, int32_t p_to, cons
 
 	} else if (p_to == 0) {
 
-		for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
-			if (E->key() != p_from)
-				E->get()->put_packet(p_buffer, p_buffer_size);
-		}
+		_broadcast(p_buffer, p_buffer_size, p_from, p_from);
 		return OK; // Sent to all but sender
 
 	} else if (p_to < 0) {
 
-		for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
-			if (E->key() != p_from && E->key() != -p_to)
-				E->get()->put_packet(p_buffer, p_buffer_size);
-		}
+		_broadcast(p_buffer, p_buffer_size, p_from, -p_to);
 		return OK; // Sent to all but sender and excluded
 
 	} else {
@@ -79,6 +79,9 @@ protected:
 	void _send_del(int32_t p_peer_id);
 	int _gen_unique_id() const;
 
+	// send the same packet to every peer but the excluded ones, implementations can encode it once for all
+	virtual void _broadcast(const uint8_t *p_buffer, int p_buffer_size, int32_t p_exclude, int32_t p_exclude2);
+
 public:
 	/* NetworkedMultiplayerPeer */
 	void set_transfer_mode(TransferMode p_mode);
@@ -45,6 +45,10 @@ void WebSocketPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("close"), &WebSocketPeer::close);
 	ClassDB::bind_method(D_METHOD("get_connected_host"), &WebSocketPeer::get_connected_host);
 	ClassDB::bind_method(D_METHOD("get_connected_port"), &WebSocketPeer::get_connected_port);
+	ClassDB::bind_method(D_METHOD("get_queued_packet_count"), &WebSocketPeer::get_queued_packet_count);
+	ClassDB::bind_method(D_METHOD("get_queued_bytes"), &WebSocketPeer::get_queued_bytes);
+	ClassDB::bind_method(D_METHOD("get_sent_packet_count"), &WebSocketPeer::get_sent_packet_count);
+	ClassDB::bind_method(D_METHOD("get_sent_bytes"), &WebSocketPeer::get_sent_bytes);
 
 	BIND_ENUM_CONSTANT(WRITE_MODE_TEXT);
 	BIND_ENUM_CONSTANT(WRITE_MODE_BINARY);
@@ -65,6 +65,11 @@ public:
 	virtual uint16_t get_connected_port() const = 0;
 	virtual bool was_string_packet() const = 0;
 
+	virtual int get_queued_packet_count() const = 0;
+	virtual int get_queued_bytes() const = 0;
+	virtual uint64_t get_sent_packet_count() const = 0;
+	virtual uint64_t get_sent_bytes() const = 0;
+
 	WebSocketPeer();
 	~WebSocketPeer();
 };
@@ -123,7 +123,7 @@ Error AudioDriverOpenSL::init() {
 
 void AudioDriverOpenSL::start() {
 
-	mutex = Mutex::create();
+	mutex = Mutex::create(true, "AudioServer::lock");
 	active = false;
 
 	SLint32 numOutputs = 0;
@@ -264,7 +264,7 @@ void AudioDriverOpenSL::set_pause(bool p_pause) {
 
 AudioDriverOpenSL::AudioDriverOpenSL() {
 	s_ad = this;
-	mutex = Mutex::create(); //NULL;
+	mutex = Mutex::create(true, "AudioServer::lock");
 	pause = false;
 	active = false;
 }
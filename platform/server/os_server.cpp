@@ -29,6 +29,8 @@
 /*************************************************************************/
 #include "os_server.h"
 
+#include "core/engine.h"
+#include "core/project_settings.h"
 #include "drivers/dummy/audio_driver_dummy.h"
 #include "drivers/dummy/rasterizer_dummy.h"
 #include "drivers/dummy/texture_loader_dummy.h"
@@ -76,6 +78,9 @@ Error OS_Server::initialize(const VideoMode &p_desired, int p_video_driver, int
 	current_videomode = p_desired;
 	main_loop = NULL;
 
+	// nothing is ever displayed or heard, so drop GPU payloads and visual-only work (the editor still needs them to export)
+	Engine::get_singleton()->set_headless(!Engine::get_singleton()->is_editor_hint() && GLOBAL_GET("application/run/headless_strip_resources"));
+
 	RasterizerDummy::make_current();
 
 	video_driver_index = p_video_driver; // unused in server platform, but should still be initialized
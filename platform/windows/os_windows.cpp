@@ -2777,6 +2777,11 @@ int OS_Windows::get_power_percent_left() {
 
 bool OS_Windows::_check_internal_feature_support(const String &p_feature) {
 
+	if (p_feature == "bptc") {
+		//only when the renderer can upload it, otherwise the s3tc variant is picked
+		return VisualServer::get_singleton() && VisualServer::get_singleton()->has_os_feature(p_feature);
+	}
+
 	return p_feature == "pc" || p_feature == "s3tc";
 }
 
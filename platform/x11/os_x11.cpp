@@ -2343,6 +2343,11 @@ Error OS_X11::shell_open(String p_uri) {
 
 bool OS_X11::_check_internal_feature_support(const String &p_feature) {
 
+	if (p_feature == "bptc") {
+		//only when the renderer can upload it, otherwise the s3tc variant is picked
+		return VisualServer::get_singleton() && VisualServer::get_singleton()->has_os_feature(p_feature);
+	}
+
 	return p_feature == "pc" || p_feature == "s3tc";
 }
 
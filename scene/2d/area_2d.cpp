@@ -148,7 +148,7 @@ void Area2D::_body_exit_tree(ObjectID p_id) {
 	}
 }
 
-void Area2D::_body_inout(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+void Area2D::_body_inout_event(int p_status, ObjectID p_instance, int p_body_shape, int p_area_shape) {
 
 	bool body_in = p_status == Physics2DServer::AREA_BODY_ADDED;
 	ObjectID objid = p_instance;
@@ -160,8 +160,6 @@ void Area2D::_body_inout(int p_status, const RID &p_body, int p_instance, int p_
 
 	ERR_FAIL_COND(!body_in && !E);
 
-	locked = true;
-
 	if (body_in) {
 		if (!E) {
 
@@ -211,6 +209,27 @@ void Area2D::_body_inout(int p_status, const RID &p_body, int p_instance, int p_
 		if (eraseit)
 			body_map.erase(E);
 	}
+}
+
+void Area2D::_body_inout(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+
+	locked = true;
+	_body_inout_event(p_status, p_instance, p_body_shape, p_area_shape);
+	locked = false;
+}
+
+void Area2D::_body_inout_batch(const PoolIntArray &p_events) {
+
+	int count = p_events.size() / Physics2DServer::AREA_MONITOR_EVENT_SIZE;
+	PoolIntArray::Read r = p_events.read();
+
+	locked = true;
+
+	for (int i = 0; i < count; i++) {
+
+		const int *event = &r[i * Physics2DServer::AREA_MONITOR_EVENT_SIZE];
+		_body_inout_event(event[Physics2DServer::AREA_MONITOR_EVENT_STATUS], event[Physics2DServer::AREA_MONITOR_EVENT_INSTANCE_ID], event[Physics2DServer::AREA_MONITOR_EVENT_BODY_SHAPE], event[Physics2DServer::AREA_MONITOR_EVENT_AREA_SHAPE]);
+	}
 
 	locked = false;
 }
@@ -249,7 +268,7 @@ void Area2D::_area_exit_tree(ObjectID p_id) {
 	}
 }
 
-void Area2D::_area_inout(int p_status, const RID &p_area, int p_instance, int p_area_shape, int p_self_shape) {
+void Area2D::_area_inout_event(int p_status, ObjectID p_instance, int p_area_shape, int p_self_shape) {
 
 	bool area_in = p_status == Physics2DServer::AREA_BODY_ADDED;
 	ObjectID objid = p_instance;
@@ -261,8 +280,6 @@ void Area2D::_area_inout(int p_status, const RID &p_area, int p_instance, int p_
 
 	ERR_FAIL_COND(!area_in && !E);
 
-	locked = true;
-
 	if (area_in) {
 		if (!E) {
 
@@ -312,6 +329,27 @@ void Area2D::_area_inout(int p_status, const RID &p_area, int p_instance, int p_
 		if (eraseit)
 			area_map.erase(E);
 	}
+}
+
+void Area2D::_area_inout(int p_status, const RID &p_area, int p_instance, int p_area_shape, int p_self_shape) {
+
+	locked = true;
+	_area_inout_event(p_status, p_instance, p_area_shape, p_self_shape);
+	locked = false;
+}
+
+void Area2D::_area_inout_batch(const PoolIntArray &p_events) {
+
+	int count = p_events.size() / Physics2DServer::AREA_MONITOR_EVENT_SIZE;
+	PoolIntArray::Read r = p_events.read();
+
+	locked = true;
+
+	for (int i = 0; i < count; i++) {
+
+		const int *event = &r[i * Physics2DServer::AREA_MONITOR_EVENT_SIZE];
+		_area_inout_event(event[Physics2DServer::AREA_MONITOR_EVENT_STATUS], event[Physics2DServer::AREA_MONITOR_EVENT_INSTANCE_ID], event[Physics2DServer::AREA_MONITOR_EVENT_BODY_SHAPE], event[Physics2DServer::AREA_MONITOR_EVENT_AREA_SHAPE]);
+	}
 
 	locked = false;
 }
@@ -407,8 +445,9 @@ void Area2D::set_monitoring(bool p_enable) {
 
 	if (monitoring) {
 
-		Physics2DServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout);
-		Physics2DServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout);
+		Physics2DServer::get_singleton()->area_set_monitor_batching(get_rid(), true);
+		Physics2DServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout_batch);
+		Physics2DServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout_batch);
 
 	} else {
 		Physics2DServer::get_singleton()->area_set_monitor_callback(get_rid(), NULL, StringName());
@@ -653,6 +692,8 @@ void Area2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_body_inout"), &Area2D::_body_inout);
 	ClassDB::bind_method(D_METHOD("_area_inout"), &Area2D::_area_inout);
+	ClassDB::bind_method(D_METHOD("_body_inout_batch"), &Area2D::_body_inout_batch);
+	ClassDB::bind_method(D_METHOD("_area_inout_batch"), &Area2D::_area_inout_batch);
 
 	ADD_SIGNAL(MethodInfo("body_shape_entered", PropertyInfo(Variant::INT, "body_id"), PropertyInfo(Variant::OBJECT, "body", PROPERTY_HINT_RESOURCE_TYPE, "PhysicsBody2D"), PropertyInfo(Variant::INT, "body_shape"), PropertyInfo(Variant::INT, "area_shape")));
 	ADD_SIGNAL(MethodInfo("body_shape_exited", PropertyInfo(Variant::INT, "body_id"), PropertyInfo(Variant::OBJECT, "body", PROPERTY_HINT_RESOURCE_TYPE, "PhysicsBody2D"), PropertyInfo(Variant::INT, "body_shape"), PropertyInfo(Variant::INT, "area_shape")));
@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "canvas_item.h"
+#include "core/engine.h"
 #include "core/method_bind_ext.gen.inc"
 #include "message_queue.h"
 #include "os/input.h"
@@ -528,6 +529,8 @@ void CanvasItem::update() {
 		return;
 	if (pending_update)
 		return;
+	if (Engine::get_singleton()->is_headless())
+		return; //nothing is ever displayed, don't spend time building draw commands
 
 	pending_update = true;
 
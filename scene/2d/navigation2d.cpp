@@ -35,6 +35,9 @@
 void Navigation2D::_navpoly_link(int p_id) {
 
 	ERR_FAIL_COND(!navpoly_map.has(p_id));
+
+	MutexLock lock(navigation_mutex);
+
 	NavMesh &nm = navpoly_map[p_id];
 	ERR_FAIL_COND(nm.linked);
 
@@ -208,6 +211,8 @@ void Navigation2D::_navpoly_unlink(int p_id) {
 
 int Navigation2D::navpoly_add(const Ref<NavigationPolygon> &p_mesh, const Transform2D &p_xform, Object *p_owner) {
 
+	MutexLock lock(navigation_mutex);
+
 	int id = last_id++;
 	NavMesh nm;
 	nm.linked = false;
@@ -234,11 +239,14 @@ void Navigation2D::navpoly_set_transform(int p_id, const Transform2D &p_xform) {
 void Navigation2D::navpoly_remove(int p_id) {
 
 	ERR_FAIL_COND(!navpoly_map.has(p_id));
+
+	MutexLock lock(navigation_mutex);
+
 	_navpoly_unlink(p_id);
 	navpoly_map.erase(p_id);
 }
 
-Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
+Vector<Vector2> Navigation2D::_get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
 
 	Polygon *begin_poly = NULL;
 	Polygon *end_poly = NULL;
@@ -603,6 +611,89 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 	return Vector<Vector2>();
 }
 
+Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
+
+	MutexLock lock(navigation_mutex);
+
+	return _get_simple_path(p_start, p_end, p_optimize);
+}
+
+void Navigation2D::_solve_queries(void *p_userdata, uint32_t p_index) {
+
+	Navigation2D *nav = (Navigation2D *)p_userdata;
+
+	PathQuery *queries = nav->running_queries.ptrw();
+	for (int i = 0; i < nav->running_queries.size(); i++) {
+		queries[i].path = nav->get_simple_path(queries[i].from, queries[i].to, queries[i].optimize);
+	}
+}
+
+void Navigation2D::_start_queries() {
+
+	running_queries = pending_queries;
+	pending_queries.clear();
+
+	// Searches write to the polygons, so a batch is solved in order on a single
+	// worker. Batches of different Navigation2D nodes run in parallel.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		query_task = pool->add_task(_solve_queries, this, WorkerThreadPool::PRIORITY_LOW);
+	} else {
+		_solve_queries(this, 0);
+		_finish_queries();
+	}
+}
+
+void Navigation2D::_finish_queries() {
+
+	if (query_task != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(query_task);
+		query_task = WorkerThreadPool::INVALID_GROUP_ID;
+	}
+
+	Vector<PathQuery> finished = running_queries;
+	running_queries.clear();
+
+	// Results nobody claimed are only kept until the next batch completes.
+	query_results.clear();
+	for (int i = 0; i < finished.size(); i++) {
+		query_results[finished[i].id] = finished[i].path;
+	}
+
+	for (int i = 0; i < finished.size(); i++) {
+		emit_signal("path_query_completed", finished[i].id, finished[i].path);
+	}
+}
+
+int Navigation2D::queue_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
+
+	PathQuery query;
+	query.id = last_query_id++;
+	query.from = p_start;
+	query.to = p_end;
+	query.optimize = p_optimize;
+	pending_queries.push_back(query);
+
+	set_process_internal(true);
+
+	return query.id;
+}
+
+bool Navigation2D::is_path_query_completed(int p_id) const {
+
+	return query_results.has(p_id);
+}
+
+Vector<Vector2> Navigation2D::get_path_query_result(int p_id) {
+
+	Map<int, Vector<Vector2> >::Element *E = query_results.find(p_id);
+	ERR_FAIL_COND_V(!E, Vector<Vector2>());
+
+	Vector<Vector2> path = E->get();
+	query_results.erase(E);
+	return path;
+}
+
 Vector2 Navigation2D::get_closest_point(const Vector2 &p_point) {
 
 	Vector2 closest_point = Vector2();
@@ -707,6 +798,27 @@ Object *Navigation2D::get_closest_point_owner(const Vector2 &p_point) {
 	return owner;
 }
 
+void Navigation2D::_notification(int p_what) {
+
+	switch (p_what) {
+
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			if (query_task != WorkerThreadPool::INVALID_GROUP_ID && WorkerThreadPool::get_singleton()->is_group_task_completed(query_task)) {
+				_finish_queries();
+			}
+
+			if (query_task == WorkerThreadPool::INVALID_GROUP_ID) {
+				if (pending_queries.size()) {
+					_start_queries();
+				} else {
+					set_process_internal(false);
+				}
+			}
+		} break;
+	}
+}
+
 void Navigation2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("navpoly_add", "mesh", "xform", "owner"), &Navigation2D::navpoly_add, DEFVAL(Variant()));
@@ -714,8 +826,13 @@ void Navigation2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navpoly_remove", "id"), &Navigation2D::navpoly_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation2D::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("queue_simple_path", "start", "end", "optimize"), &Navigation2D::queue_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_path_query_completed", "id"), &Navigation2D::is_path_query_completed);
+	ClassDB::bind_method(D_METHOD("get_path_query_result", "id"), &Navigation2D::get_path_query_result);
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation2D::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_owner", "to_point"), &Navigation2D::get_closest_point_owner);
+
+	ADD_SIGNAL(MethodInfo("path_query_completed", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::POOL_VECTOR2_ARRAY, "path")));
 }
 
 Navigation2D::Navigation2D() {
@@ -723,4 +840,17 @@ Navigation2D::Navigation2D() {
 	ERR_FAIL_COND(sizeof(Point) != 8);
 	cell_size = 1; // one pixel
 	last_id = 1;
+	navigation_mutex = Mutex::create();
+	query_task = WorkerThreadPool::INVALID_GROUP_ID;
+	last_query_id = 1;
+}
+
+Navigation2D::~Navigation2D() {
+
+	if (query_task != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(query_task);
+	}
+
+	if (navigation_mutex)
+		memdelete(navigation_mutex);
 }
@@ -31,6 +31,8 @@
 #ifndef NAVIGATION_2D_H
 #define NAVIGATION_2D_H
 
+#include "os/mutex.h"
+#include "os/worker_thread_pool.h"
 #include "scene/2d/navigation_polygon.h"
 #include "scene/2d/node_2d.h"
 
@@ -155,7 +157,32 @@ class Navigation2D : public Node2D {
 	Map<int, NavMesh> navpoly_map;
 	int last_id;
 
+	struct PathQuery {
+
+		int id;
+		Vector2 from;
+		Vector2 to;
+		bool optimize;
+		Vector<Vector2> path;
+	};
+
+	// Held while searching, queued queries are solved on a worker thread.
+	Mutex *navigation_mutex;
+
+	Vector<PathQuery> pending_queries;
+	Vector<PathQuery> running_queries;
+	WorkerThreadPool::GroupID query_task;
+	Map<int, Vector<Vector2> > query_results;
+	int last_query_id;
+
+	static void _solve_queries(void *p_userdata, uint32_t p_index);
+	void _start_queries();
+	void _finish_queries();
+
+	Vector<Vector2> _get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize);
+
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
@@ -165,10 +192,16 @@ public:
 	void navpoly_remove(int p_id);
 
 	Vector<Vector2> get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize = true);
+
+	int queue_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize = true);
+	bool is_path_query_completed(int p_id) const;
+	Vector<Vector2> get_path_query_result(int p_id);
+
 	Vector2 get_closest_point(const Vector2 &p_point);
 	Object *get_closest_point_owner(const Vector2 &p_point);
 
 	Navigation2D();
+	~Navigation2D();
 };
 
 #endif // Navigation2D2D_H
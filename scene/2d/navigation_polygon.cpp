@@ -255,16 +255,22 @@ void NavigationPolygon::make_polygons_from_outlines() {
 		in_poly.push_back(tp);
 	}
 
+	//monotone triangulation is O(n log n), triangles are then merged back into convex polygons
 	TriangulatorPartition tpart;
-	if (tpart.ConvexPartition_HM(&in_poly, &out_poly) == 0) { //failed!
-		print_line("convex partition failed!");
-		return;
+	bool triangulated = tpart.Triangulate_MONO(&in_poly, &out_poly) != 0;
+	if (!triangulated) {
+		out_poly.clear();
+		if (tpart.ConvexPartition_HM(&in_poly, &out_poly) == 0) { //failed!
+			print_line("convex partition failed!");
+			return;
+		}
 	}
 
 	polygons.clear();
 	vertices.resize(0);
 
 	Map<Vector2, int> points;
+	Vector<int> triangles;
 	for (List<TriangulatorPoly>::Element *I = out_poly.front(); I; I = I->next()) {
 
 		TriangulatorPoly &tp = I->get();
@@ -281,7 +287,23 @@ void NavigationPolygon::make_polygons_from_outlines() {
 			p.indices.push_back(E->get());
 		}
 
-		polygons.push_back(p);
+		if (triangulated) {
+			triangles.append_array(p.indices);
+		} else {
+			polygons.push_back(p);
+		}
+	}
+
+	if (triangulated) {
+
+		Vector<Vector<int> > convex;
+		Triangulate::merge_convex(Variant(vertices), triangles, convex);
+
+		for (int i = 0; i < convex.size(); i++) {
+			struct Polygon p;
+			p.indices = convex[i];
+			polygons.push_back(p);
+		}
 	}
 
 	emit_signal(CoreStringNames::get_singleton()->changed);
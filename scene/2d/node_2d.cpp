@@ -30,6 +30,7 @@
 
 #include "node_2d.h"
 
+#include "engine.h"
 #include "message_queue.h"
 #include "scene/gui/control.h"
 #include "scene/main/viewport.h"
@@ -207,6 +208,11 @@ Size2 Node2D::get_scale() const {
 void Node2D::_notification(int p_what) {
 
 	switch (p_what) {
+
+		case NOTIFICATION_ENTER_TREE: {
+
+			_update_physics_interpolation();
+		} break;
 	}
 }
 
@@ -356,6 +362,39 @@ bool Node2D::is_z_relative() const {
 	return z_relative;
 }
 
+void Node2D::_update_physics_interpolation() {
+
+	//children transforms are relative to this item, so only this item is blended
+	bool interpolated = physics_interpolated && Engine::get_singleton()->is_physics_interpolation_enabled() && !Engine::get_singleton()->is_editor_hint();
+	VS::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
+	VS::get_singleton()->canvas_item_set_interpolated(get_canvas_item(), interpolated);
+	VS::get_singleton()->canvas_item_reset_physics_interpolation(get_canvas_item());
+}
+
+void Node2D::set_physics_interpolated(bool p_interpolated) {
+
+	if (physics_interpolated == p_interpolated)
+		return;
+
+	physics_interpolated = p_interpolated;
+
+	if (is_inside_tree()) {
+		_update_physics_interpolation();
+	}
+}
+
+bool Node2D::is_physics_interpolated() const {
+
+	return physics_interpolated;
+}
+
+void Node2D::reset_physics_interpolation() {
+
+	if (is_inside_tree()) {
+		VS::get_singleton()->canvas_item_reset_physics_interpolation(get_canvas_item());
+	}
+}
+
 int Node2D::get_z_index() const {
 
 	return z_index;
@@ -438,6 +477,10 @@ void Node2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_z_as_relative", "enable"), &Node2D::set_z_as_relative);
 	ClassDB::bind_method(D_METHOD("is_z_relative"), &Node2D::is_z_relative);
 
+	ClassDB::bind_method(D_METHOD("set_physics_interpolated", "enable"), &Node2D::set_physics_interpolated);
+	ClassDB::bind_method(D_METHOD("is_physics_interpolated"), &Node2D::is_physics_interpolated);
+	ClassDB::bind_method(D_METHOD("reset_physics_interpolation"), &Node2D::reset_physics_interpolation);
+
 	ClassDB::bind_method(D_METHOD("get_relative_transform_to_parent", "parent"), &Node2D::get_relative_transform_to_parent);
 
 	ADD_GROUP("Transform", "");
@@ -456,6 +499,9 @@ void Node2D::_bind_methods() {
 	ADD_GROUP("Z Index", "");
 	ADD_PROPERTYNZ(PropertyInfo(Variant::INT, "z_index", PROPERTY_HINT_RANGE, itos(VS::CANVAS_ITEM_Z_MIN) + "," + itos(VS::CANVAS_ITEM_Z_MAX) + ",1"), "set_z_index", "get_z_index");
 	ADD_PROPERTYNO(PropertyInfo(Variant::BOOL, "z_as_relative"), "set_z_as_relative", "is_z_relative");
+
+	ADD_GROUP("Physics Interpolation", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "physics_interpolated"), "set_physics_interpolated", "is_physics_interpolated");
 }
 
 Node2D::Node2D() {
@@ -465,4 +511,5 @@ Node2D::Node2D() {
 	_xform_dirty = false;
 	z_index = 0;
 	z_relative = true;
+	physics_interpolated = true;
 }
@@ -42,6 +42,7 @@ class Node2D : public CanvasItem {
 	Size2 _scale;
 	int z_index;
 	bool z_relative;
+	bool physics_interpolated;
 
 	Transform2D _mat;
 
@@ -50,6 +51,7 @@ class Node2D : public CanvasItem {
 	void _update_transform();
 
 	void _update_xform_values();
+	void _update_physics_interpolation();
 
 protected:
 	void _notification(int p_what);
@@ -113,6 +115,10 @@ public:
 	void set_z_as_relative(bool p_enabled);
 	bool is_z_relative() const;
 
+	void set_physics_interpolated(bool p_interpolated);
+	bool is_physics_interpolated() const;
+	void reset_physics_interpolation();
+
 	Transform2D get_relative_transform_to_parent(const Node *p_parent) const;
 
 	Transform2D get_transform() const;
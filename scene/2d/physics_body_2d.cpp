@@ -1177,34 +1177,40 @@ bool KinematicBody2D::separate_raycast_shapes(bool p_infinite_inertia, Collision
 	}
 }
 
+void KinematicBody2D::_apply_motion_result(const Transform2D &p_from, const Physics2DServer::MotionResult &p_result, bool p_colliding, Collision &r_collision, bool p_test_only) {
+
+	if (p_colliding) {
+		r_collision.collider_metadata = p_result.collider_metadata;
+		r_collision.collider_shape = p_result.collider_shape;
+		r_collision.collider_vel = p_result.collider_velocity;
+		r_collision.collision = p_result.collision_point;
+		r_collision.normal = p_result.collision_normal;
+		r_collision.collider = p_result.collider_id;
+		r_collision.collider_rid = p_result.collider;
+		r_collision.travel = p_result.motion;
+		r_collision.remainder = p_result.remainder;
+		r_collision.local_shape = p_result.collision_local_shape;
+	}
+
+	if (!p_test_only) {
+		Transform2D gt = p_from;
+		gt.elements[2] += p_result.motion;
+		set_global_transform(gt);
+	}
+}
+
 bool KinematicBody2D::move_and_collide(const Vector2 &p_motion, bool p_infinite_inertia, Collision &r_collision, bool p_exclude_raycast_shapes, bool p_test_only) {
 
 	Transform2D gt = get_global_transform();
 	Physics2DServer::MotionResult result;
 	bool colliding = Physics2DServer::get_singleton()->body_test_motion(get_rid(), gt, p_motion, p_infinite_inertia, margin, &result, p_exclude_raycast_shapes);
 
-	if (colliding) {
-		r_collision.collider_metadata = result.collider_metadata;
-		r_collision.collider_shape = result.collider_shape;
-		r_collision.collider_vel = result.collider_velocity;
-		r_collision.collision = result.collision_point;
-		r_collision.normal = result.collision_normal;
-		r_collision.collider = result.collider_id;
-		r_collision.collider_rid = result.collider;
-		r_collision.travel = result.motion;
-		r_collision.remainder = result.remainder;
-		r_collision.local_shape = result.collision_local_shape;
-	}
-
-	if (!p_test_only) {
-		gt.elements[2] += result.motion;
-		set_global_transform(gt);
-	}
+	_apply_motion_result(gt, result, colliding, r_collision, p_test_only);
 
 	return colliding;
 }
 
-Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const Vector2 &p_floor_direction, bool p_infinite_inertia, float p_slope_stop_min_velocity, int p_max_slides, float p_floor_max_angle) {
+Vector2 KinematicBody2D::_slide_begin(const Vector2 &p_linear_velocity) {
 
 	Vector2 floor_motion = floor_velocity;
 	if (on_floor && on_floor_body.is_valid()) {
@@ -1216,7 +1222,6 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 	}
 
 	Vector2 motion = (floor_motion + p_linear_velocity) * get_physics_process_delta_time();
-	Vector2 lv = p_linear_velocity;
 
 	on_floor = false;
 	on_floor_body = RID();
@@ -1225,6 +1230,53 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 	colliders.clear();
 	floor_velocity = Vector2();
 
+	return motion;
+}
+
+bool KinematicBody2D::_slide_collision(const Collision &p_collision, Vector2 &r_motion, Vector2 &r_linear_velocity, const Vector2 &p_floor_direction, float p_slope_stop_min_velocity, float p_floor_max_angle) {
+
+	r_motion = p_collision.remainder;
+
+	if (p_floor_direction == Vector2()) {
+		//all is a wall
+		on_wall = true;
+	} else {
+		if (p_collision.normal.dot(p_floor_direction) >= Math::cos(p_floor_max_angle)) { //floor
+
+			on_floor = true;
+			on_floor_body = p_collision.collider_rid;
+			floor_velocity = p_collision.collider_vel;
+
+			Vector2 rel_v = r_linear_velocity - floor_velocity;
+			Vector2 hv = rel_v - p_floor_direction * p_floor_direction.dot(rel_v);
+
+			if (p_collision.travel.length() < 1 && hv.length() < p_slope_stop_min_velocity) {
+				Transform2D gt = get_global_transform();
+				gt.elements[2] -= p_collision.travel;
+				set_global_transform(gt);
+				return true;
+			}
+		} else if (p_collision.normal.dot(-p_floor_direction) >= Math::cos(p_floor_max_angle)) { //ceiling
+			on_ceiling = true;
+		} else {
+			on_wall = true;
+		}
+	}
+
+	Vector2 n = p_collision.normal;
+	r_motion = r_motion.slide(n);
+	r_linear_velocity = r_linear_velocity.slide(n);
+
+	colliders.push_back(p_collision);
+
+	return false;
+}
+
+Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const Vector2 &p_floor_direction, bool p_infinite_inertia, float p_slope_stop_min_velocity, int p_max_slides, float p_floor_max_angle) {
+
+	Vector2 motion = _slide_begin(p_linear_velocity);
+	Vector2 lv = p_linear_velocity;
+
 	while (p_max_slides) {
 
 		Collision collision;
@@ -1246,44 +1298,12 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 			}
 
 			if (collided) {
-				found_collision = true;
-			}
 
-			if (collided) {
+				found_collision = true;
 
-				motion = collision.remainder;
-
-				if (p_floor_direction == Vector2()) {
-					//all is a wall
-					on_wall = true;
-				} else {
-					if (collision.normal.dot(p_floor_direction) >= Math::cos(p_floor_max_angle)) { //floor
-
-						on_floor = true;
-						on_floor_body = collision.collider_rid;
-						floor_velocity = collision.collider_vel;
-
-						Vector2 rel_v = lv - floor_velocity;
-						Vector2 hv = rel_v - p_floor_direction * p_floor_direction.dot(rel_v);
-
-						if (collision.travel.length() < 1 && hv.length() < p_slope_stop_min_velocity) {
-							Transform2D gt = get_global_transform();
-							gt.elements[2] -= collision.travel;
-							set_global_transform(gt);
-							return Vector2();
-						}
-					} else if (collision.normal.dot(-p_floor_direction) >= Math::cos(p_floor_max_angle)) { //ceiling
-						on_ceiling = true;
-					} else {
-						on_wall = true;
-					}
+				if (_slide_collision(collision, motion, lv, p_floor_direction, p_slope_stop_min_velocity, p_floor_max_angle)) {
+					return Vector2();
 				}
-
-				Vector2 n = collision.normal;
-				motion = motion.slide(n);
-				lv = lv.slide(n);
-
-				colliders.push_back(collision);
 			}
 		}
 
@@ -1298,6 +1318,113 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 	return lv;
 }
 
+void KinematicBody2D::move_and_slide_batch(KinematicBody2D *const *p_bodies, const Vector2 *p_linear_velocities, Vector2 *r_linear_velocities, int p_count, const Vector2 &p_floor_direction, bool p_infinite_inertia, float p_slope_stop_min_velocity, int p_max_slides, float p_floor_max_angle) {
+
+	// the bodies slide in lockstep, each slide iteration is one batched motion test
+
+	Vector<Vector2> motions;
+	motions.resize(p_count);
+	Vector<int> active;
+	active.resize(p_count);
+
+	int active_count = 0;
+
+	for (int i = 0; i < p_count; i++) {
+
+		ERR_CONTINUE(!p_bodies[i]);
+
+		motions.write[i] = p_bodies[i]->_slide_begin(p_linear_velocities[i]);
+		r_linear_velocities[i] = p_linear_velocities[i];
+		active.write[active_count++] = i;
+	}
+
+	if (!active_count)
+		return;
+
+	Vector<RID> rids;
+	Vector<Transform2D> from;
+	Vector<Vector2> test_motions;
+	Vector<Physics2DServer::MotionResult> results;
+	Vector<bool> collided;
+
+	// the server takes a single margin, bodies with a different one are moved on their own
+	float margin = p_bodies[active[0]]->margin;
+
+	while (p_max_slides && active_count) {
+
+		rids.resize(active_count);
+		from.resize(active_count);
+		test_motions.resize(active_count);
+		results.resize(active_count);
+		collided.resize(active_count);
+
+		for (int k = 0; k < active_count; k++) {
+
+			KinematicBody2D *body = p_bodies[active[k]];
+			rids.write[k] = body->margin == margin ? body->get_rid() : RID();
+			from.write[k] = body->get_global_transform();
+			test_motions.write[k] = motions[active[k]];
+		}
+
+		Physics2DServer::get_singleton()->body_test_motion_batch(rids.ptr(), from.ptr(), test_motions.ptr(), active_count, p_infinite_inertia, margin, results.ptrw(), collided.ptrw());
+
+		int still_active = 0;
+
+		for (int k = 0; k < active_count; k++) {
+
+			int idx = active[k];
+			KinematicBody2D *body = p_bodies[idx];
+			Vector2 &motion = motions.write[idx];
+			Vector2 &lv = r_linear_velocities[idx];
+
+			bool found_collision = false;
+			bool stopped = false;
+
+			for (int i = 0; i < 2 && !stopped; i++) {
+
+				Collision collision;
+				bool body_collided;
+
+				if (i == 0) { //collide
+					if (rids[k].is_valid()) {
+						body_collided = collided[k];
+						body->_apply_motion_result(from[k], results[k], body_collided, collision, false);
+					} else {
+						body_collided = body->move_and_collide(motion, p_infinite_inertia, collision);
+					}
+					if (!body_collided) {
+						motion = Vector2(); //clear because no collision happened and motion completed
+					}
+				} else { //separate raycasts (if any)
+					body_collided = body->separate_raycast_shapes(p_infinite_inertia, collision);
+					if (body_collided) {
+						collision.remainder = motion; //keep
+						collision.travel = Vector2();
+					}
+				}
+
+				if (body_collided) {
+
+					found_collision = true;
+
+					if (body->_slide_collision(collision, motion, lv, p_floor_direction, p_slope_stop_min_velocity, p_floor_max_angle)) {
+						lv = Vector2();
+						stopped = true;
+					}
+				}
+			}
+
+			if (stopped || !found_collision || motion == Vector2())
+				continue;
+
+			active.write[still_active++] = idx;
+		}
+
+		active_count = still_active;
+		p_max_slides--;
+	}
+}
+
 Vector2 KinematicBody2D::move_and_slide_with_snap(const Vector2 &p_linear_velocity, const Vector2 &p_snap, const Vector2 &p_floor_direction, bool p_infinite_inertia, float p_slope_stop_min_velocity, int p_max_slides, float p_floor_max_angle) {
 
 	bool was_on_floor = on_floor;
@@ -324,6 +324,10 @@ private:
 	Transform2D last_valid_transform;
 	void _direct_state_changed(Object *p_state);
 
+	void _apply_motion_result(const Transform2D &p_from, const Physics2DServer::MotionResult &p_result, bool p_colliding, Collision &r_collision, bool p_test_only);
+	Vector2 _slide_begin(const Vector2 &p_linear_velocity);
+	bool _slide_collision(const Collision &p_collision, Vector2 &r_motion, Vector2 &r_linear_velocity, const Vector2 &p_floor_direction, float p_slope_stop_min_velocity, float p_floor_max_angle);
+
 protected:
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -340,6 +344,8 @@ public:
 
 	Vector2 move_and_slide(const Vector2 &p_linear_velocity, const Vector2 &p_floor_direction = Vector2(0, 0), bool p_infinite_inertia = true, float p_slope_stop_min_velocity = 5, int p_max_slides = 4, float p_floor_max_angle = Math::deg2rad((float)45));
 	Vector2 move_and_slide_with_snap(const Vector2 &p_linear_velocity, const Vector2 &p_snap, const Vector2 &p_floor_direction = Vector2(0, 0), bool p_infinite_inertia = true, float p_slope_stop_min_velocity = 5, int p_max_slides = 4, float p_floor_max_angle = Math::deg2rad((float)45));
+	// same as calling move_and_slide on each body, but the motion tests of all bodies go to the server together
+	static void move_and_slide_batch(KinematicBody2D *const *p_bodies, const Vector2 *p_linear_velocities, Vector2 *r_linear_velocities, int p_count, const Vector2 &p_floor_direction = Vector2(0, 0), bool p_infinite_inertia = true, float p_slope_stop_min_velocity = 5, int p_max_slides = 4, float p_floor_max_angle = Math::deg2rad((float)45));
 	bool is_on_floor() const;
 	bool is_on_wall() const;
 	bool is_on_ceiling() const;
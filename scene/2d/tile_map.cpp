@@ -33,6 +33,7 @@
 #include "io/marshalls.h"
 #include "method_bind_ext.gen.inc"
 #include "os/os.h"
+#include "scene/resources/rectangle_shape_2d.h"
 #include "servers/physics_2d_server.h"
 
 int TileMap::_get_quadrant_size() const {
@@ -71,9 +72,10 @@ void TileMap::_notification(int p_what) {
 		case NOTIFICATION_EXIT_TREE: {
 
 			_update_quadrant_space(RID());
-			for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+			const PosKey *K = NULL;
+			while ((K = quadrant_map.next(K))) {
 
-				Quadrant &q = E->get();
+				Quadrant &q = quadrant_map[*K];
 				if (navigation) {
 					for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
 
@@ -82,10 +84,7 @@ void TileMap::_notification(int p_what) {
 					q.navpoly_ids.clear();
 				}
 
-				for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
-					VS::get_singleton()->free(E->get().id);
-				}
-				q.occluder_instances.clear();
+				_free_quadrant_occluders(q);
 			}
 
 			navigation = NULL;
@@ -102,9 +101,10 @@ void TileMap::_notification(int p_what) {
 
 void TileMap::_update_quadrant_space(const RID &p_space) {
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		Physics2DServer::get_singleton()->body_set_space(q.body, p_space);
 	}
 }
@@ -120,9 +120,10 @@ void TileMap::_update_quadrant_transform() {
 	if (navigation)
 		nav_rel = get_relative_transform_to_parent(navigation);
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		Transform2D xform;
 		xform.set_origin(q.pos);
 		xform = global_transform * xform;
@@ -135,8 +136,8 @@ void TileMap::_update_quadrant_transform() {
 			}
 		}
 
-		for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
-			VS::get_singleton()->canvas_light_occluder_set_transform(E->get().id, global_transform * E->get().xform);
+		for (int i = 0; i < q.occluders.size(); i++) {
+			VS::get_singleton()->canvas_light_occluder_set_transform(q.occluders[i].id, global_transform);
 		}
 	}
 }
@@ -263,6 +264,7 @@ void TileMap::update_dirty_quadrants() {
 		nav_rel = get_relative_transform_to_parent(navigation);
 
 	Vector2 qofs;
+	Vector<MergeCell> merge_cells;
 
 	SceneTree *st = SceneTree::get_singleton();
 	Color debug_collision_color;
@@ -292,18 +294,27 @@ void TileMap::update_dirty_quadrants() {
 		ps->body_clear_shapes(q.body);
 		int shape_idx = 0;
 
+		for (int i = 0; i < q.merged_shapes.size(); i++) {
+			ps->free(q.merged_shapes[i]);
+		}
+		q.merged_shapes.clear();
+		merge_cells.clear();
+
+		//only navpolys of changed cells are recreated, the rest stay registered
 		if (navigation) {
-			for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
+			for (int i = 0; i < q.dirty_cells.size(); i++) {
 
-				navigation->navpoly_remove(E->get().id);
+				Map<PosKey, Quadrant::NavPoly>::Element *N = q.navpoly_ids.find(q.dirty_cells[i]);
+				if (N) {
+					navigation->navpoly_remove(N->get().id);
+					q.navpoly_ids.erase(N);
+				}
 			}
-			q.navpoly_ids.clear();
 		}
 
-		for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
-			VS::get_singleton()->free(E->get().id);
-		}
-		q.occluder_instances.clear();
+		//occluders of all cells are merged into a single polygon per cull mode, rebuilt with the quadrant
+		Vector<Vector2> occluder_lines[3];
+
 		Ref<ShaderMaterial> prev_material;
 		int prev_z_index;
 		RID prev_canvas_item;
@@ -311,20 +322,22 @@ void TileMap::update_dirty_quadrants() {
 
 		for (int i = 0; i < q.cells.size(); i++) {
 
-			Map<PosKey, Cell>::Element *E = tile_map.find(q.cells[i]);
-			Cell &c = E->get();
+			const PosKey &pk = q.cells[i];
+			Cell &c = *_get_cell(pk);
 			//moment of truth
 			if (!tile_set->has_tile(c.id))
 				continue;
 			Ref<Texture> tex = tile_set->tile_get_texture(c.id);
 			Vector2 tile_ofs = tile_set->tile_get_texture_offset(c.id);
 
-			Vector2 wofs = _map_to_world(E->key().x, E->key().y);
+			Vector2 wofs = _map_to_world(pk.x, pk.y);
 			Vector2 offset = wofs - q.pos + tofs;
 
 			if (!tex.is_valid())
 				continue;
 
+			bool cell_dirty = q.dirty_cells.has(pk);
+
 			Ref<ShaderMaterial> mat = tile_set->tile_get_material(c.id);
 			int z_index = tile_set->tile_get_z_index(c.id);
 
@@ -472,12 +485,25 @@ void TileMap::update_dirty_quadrants() {
 
 						xform *= shapes[i].shape_transform.untranslated();
 
+						if (use_rect_merging && shapes.size() == 1 && !shapes[i].one_way_collision && !c.flip_h && !c.flip_v && !c.transpose && shapes[i].shape_transform.untranslated() == Transform2D()) {
+
+							//rectangles exactly covering their cell are merged with their neighbours later on
+							Ref<RectangleShape2D> rect_shape = shape;
+							if (rect_shape.is_valid() && (rect_shape->get_extents() * 2.0 - Vector2(cell_size)).length_squared() < CMP_EPSILON2) {
+								MergeCell mc;
+								mc.pos = pk;
+								mc.origin = xform.get_origin();
+								merge_cells.push_back(mc);
+								continue;
+							}
+						}
+
 						if (debug_canvas_item.is_valid()) {
 							vs->canvas_item_add_set_transform(debug_canvas_item, xform);
 							shape->draw(debug_canvas_item, debug_collision_color);
 						}
 						ps->body_add_shape(q.body, shape->get_rid(), xform);
-						ps->body_set_shape_metadata(q.body, shape_idx, Vector2(E->key().x, E->key().y));
+						ps->body_set_shape_metadata(q.body, shape_idx, Vector2(pk.x, pk.y));
 						ps->body_set_shape_as_one_way_collision(q.body, shape_idx, shapes[i].one_way_collision);
 						shape_idx++;
 					}
@@ -500,16 +526,18 @@ void TileMap::update_dirty_quadrants() {
 				}
 
 				if (navpoly.is_valid()) {
-					Transform2D xform;
-					xform.set_origin(offset.floor() + q.pos);
-					_fix_cell_transform(xform, c, npoly_ofs + center_ofs, s);
+					if (cell_dirty) {
+						Transform2D xform;
+						xform.set_origin(offset.floor() + q.pos);
+						_fix_cell_transform(xform, c, npoly_ofs + center_ofs, s);
 
-					int pid = navigation->navpoly_add(navpoly, nav_rel * xform);
+						int pid = navigation->navpoly_add(navpoly, nav_rel * xform);
 
-					Quadrant::NavPoly np;
-					np.id = pid;
-					np.xform = xform;
-					q.navpoly_ids[E->key()] = np;
+						Quadrant::NavPoly np;
+						np.id = pid;
+						np.xform = xform;
+						q.navpoly_ids[pk] = np;
+					}
 
 					if (debug_navigation) {
 						RID debug_navigation_item = vs->canvas_item_create();
@@ -574,18 +602,17 @@ void TileMap::update_dirty_quadrants() {
 				xform.set_origin(offset.floor() + q.pos);
 				_fix_cell_transform(xform, c, occluder_ofs + center_ofs, s);
 
-				RID orid = VS::get_singleton()->canvas_light_occluder_create();
-				VS::get_singleton()->canvas_light_occluder_set_transform(orid, get_global_transform() * xform);
-				VS::get_singleton()->canvas_light_occluder_set_polygon(orid, occluder->get_rid());
-				VS::get_singleton()->canvas_light_occluder_attach_to_canvas(orid, get_canvas());
-				VS::get_singleton()->canvas_light_occluder_set_light_mask(orid, occluder_light_mask);
-				Quadrant::Occluder oc;
-				oc.xform = xform;
-				oc.id = orid;
-				q.occluder_instances[E->key()] = oc;
+				_add_occluder_lines(occluder_lines[occluder->get_cull_mode()], occluder, xform);
 			}
 		}
 
+		if (merge_cells.size()) {
+			_add_merged_shapes(q, merge_cells, prev_debug_canvas_item, debug_collision_color);
+		}
+
+		_update_quadrant_occluders(q, occluder_lines);
+
+		q.dirty_cells = VSet<PosKey>();
 		dirty_quadrant_list.remove(dirty_quadrant_list.first());
 		quadrant_order_dirty = true;
 	}
@@ -594,10 +621,20 @@ void TileMap::update_dirty_quadrants() {
 
 	if (quadrant_order_dirty) {
 
+		//quadrants are hashed, so sort them to keep the draw order stable
+		Vector<PosKey> quadrant_keys;
+		quadrant_keys.resize(quadrant_map.size());
+		int key_count = 0;
+		const PosKey *K = NULL;
+		while ((K = quadrant_map.next(K))) {
+			quadrant_keys.write[key_count++] = *K;
+		}
+		quadrant_keys.sort();
+
 		int index = -0x80000000; //always must be drawn below children
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+		for (int i = 0; i < quadrant_keys.size(); i++) {
 
-			Quadrant &q = E->get();
+			Quadrant &q = quadrant_map[quadrant_keys[i]];
 			for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
 				VS::get_singleton()->canvas_item_set_draw_index(E->get(), index++);
@@ -610,6 +647,170 @@ void TileMap::update_dirty_quadrants() {
 	_recompute_rect_cache();
 }
 
+void TileMap::_add_merged_shapes(Quadrant &p_quadrant, const Vector<MergeCell> &p_cells, const RID &p_debug_canvas_item, const Color &p_debug_color) {
+
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	Vector2 cs = cell_size;
+
+	//lay the cells out in a grid covering the quadrant, cells can span negative coords so use their bounds
+	int min_x = p_cells[0].pos.x, max_x = min_x;
+	int min_y = p_cells[0].pos.y, max_y = min_y;
+	for (int i = 1; i < p_cells.size(); i++) {
+		min_x = MIN(min_x, p_cells[i].pos.x);
+		max_x = MAX(max_x, p_cells[i].pos.x);
+		min_y = MIN(min_y, p_cells[i].pos.y);
+		max_y = MAX(max_y, p_cells[i].pos.y);
+	}
+
+	int w = max_x - min_x + 1;
+	int h = max_y - min_y + 1;
+	Vector<int> grid;
+	grid.resize(w * h);
+	for (int i = 0; i < grid.size(); i++) {
+		grid.write[i] = -1;
+	}
+	for (int i = 0; i < p_cells.size(); i++) {
+		grid.write[(p_cells[i].pos.y - min_y) * w + (p_cells[i].pos.x - min_x)] = i;
+	}
+
+	int *g = grid.ptrw();
+
+	//greedy merging: grow each rectangle along x first, then along y while whole rows fit
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++) {
+
+			int base = g[y * w + x];
+			if (base < 0)
+				continue;
+
+			Vector2 origin = p_cells[base].origin;
+
+			int rw = 1;
+			while (x + rw < w) {
+				int idx = g[y * w + x + rw];
+				if (idx < 0 || (p_cells[idx].origin - (origin + Vector2(rw * cs.x, 0))).length_squared() > CMP_EPSILON2)
+					break;
+				rw++;
+			}
+
+			int rh = 1;
+			while (y + rh < h) {
+				bool row_fits = true;
+				for (int i = 0; i < rw; i++) {
+					int idx = g[(y + rh) * w + x + i];
+					if (idx < 0 || (p_cells[idx].origin - (origin + Vector2(i * cs.x, rh * cs.y))).length_squared() > CMP_EPSILON2) {
+						row_fits = false;
+						break;
+					}
+				}
+				if (!row_fits)
+					break;
+				rh++;
+			}
+
+			for (int j = 0; j < rh; j++) {
+				for (int i = 0; i < rw; i++) {
+					g[(y + j) * w + x + i] = -1;
+				}
+			}
+
+			Vector2 extents = Vector2(rw * cs.x, rh * cs.y) * 0.5;
+			Transform2D xform;
+			xform.set_origin(origin + Vector2((rw - 1) * cs.x, (rh - 1) * cs.y) * 0.5);
+
+			RID shape = ps->rectangle_shape_create();
+			ps->shape_set_data(shape, extents);
+			p_quadrant.merged_shapes.push_back(shape);
+
+			int shape_idx = ps->body_get_shape_count(p_quadrant.body);
+			ps->body_add_shape(p_quadrant.body, shape, xform);
+			ps->body_set_shape_metadata(p_quadrant.body, shape_idx, Vector2(p_cells[base].pos.x, p_cells[base].pos.y));
+
+			if (p_debug_canvas_item.is_valid()) {
+				VisualServer::get_singleton()->canvas_item_add_rect(p_debug_canvas_item, Rect2(xform.get_origin() - extents, extents * 2.0), p_debug_color);
+			}
+		}
+	}
+}
+
+void TileMap::_add_occluder_lines(Vector<Vector2> &r_lines, const Ref<OccluderPolygon2D> &p_occluder, const Transform2D &p_xform) {
+
+	PoolVector<Vector2> polygon = p_occluder->get_polygon();
+	int point_count = polygon.size();
+	if (point_count < 2)
+		return;
+
+	//same segments the visual server builds for a single polygon, but already in tilemap space
+	int line_count = (p_occluder->is_closed() && point_count >= 3) ? point_count : point_count - 1;
+
+	PoolVector<Vector2>::Read r = polygon.read();
+	for (int i = 0; i < line_count; i++) {
+		r_lines.push_back(p_xform.xform(r[i]));
+		r_lines.push_back(p_xform.xform(r[(i + 1) % point_count]));
+	}
+}
+
+void TileMap::_update_quadrant_occluders(Quadrant &p_quadrant, const Vector<Vector2> *p_lines) {
+
+	VisualServer *vs = VisualServer::get_singleton();
+
+	//occluder buffers use 16 bits indices and two vertices per line point, split larger quadrants
+	const int max_points = 32768;
+
+	Vector<Quadrant::Occluder> occluders;
+	int reused = 0;
+
+	for (int i = 0; i < 3; i++) {
+
+		for (int from = 0; from < p_lines[i].size(); from += max_points) {
+
+			int count = MIN(max_points, p_lines[i].size() - from);
+
+			PoolVector<Vector2> lines;
+			lines.resize(count);
+			{
+				PoolVector<Vector2>::Write w = lines.write();
+				const Vector2 *r = p_lines[i].ptr();
+				for (int j = 0; j < count; j++) {
+					w[j] = r[from + j];
+				}
+			}
+
+			Quadrant::Occluder oc;
+			if (reused < p_quadrant.occluders.size()) {
+				oc = p_quadrant.occluders[reused++];
+			} else {
+				oc.polygon = vs->canvas_occluder_polygon_create();
+				oc.id = vs->canvas_light_occluder_create();
+				vs->canvas_light_occluder_set_polygon(oc.id, oc.polygon);
+				vs->canvas_light_occluder_set_transform(oc.id, get_global_transform());
+				vs->canvas_light_occluder_attach_to_canvas(oc.id, get_canvas());
+				vs->canvas_light_occluder_set_light_mask(oc.id, occluder_light_mask);
+			}
+
+			vs->canvas_occluder_polygon_set_cull_mode(oc.polygon, VS::CanvasOccluderPolygonCullMode(i));
+			vs->canvas_occluder_polygon_set_shape_as_lines(oc.polygon, lines);
+			occluders.push_back(oc);
+		}
+	}
+
+	for (int i = reused; i < p_quadrant.occluders.size(); i++) {
+		vs->free(p_quadrant.occluders[i].id);
+		vs->free(p_quadrant.occluders[i].polygon);
+	}
+
+	p_quadrant.occluders = occluders;
+}
+
+void TileMap::_free_quadrant_occluders(Quadrant &p_quadrant) {
+
+	for (int i = 0; i < p_quadrant.occluders.size(); i++) {
+		VS::get_singleton()->free(p_quadrant.occluders[i].id);
+		VS::get_singleton()->free(p_quadrant.occluders[i].polygon);
+	}
+	p_quadrant.occluders.clear();
+}
+
 void TileMap::_recompute_rect_cache() {
 
 #ifdef DEBUG_ENABLED
@@ -618,14 +819,15 @@ void TileMap::_recompute_rect_cache() {
 		return;
 
 	Rect2 r_total;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
 		Rect2 r;
-		r.position = _map_to_world(E->key().x * _get_quadrant_size(), E->key().y * _get_quadrant_size());
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size() + _get_quadrant_size(), E->key().y * _get_quadrant_size()));
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size() + _get_quadrant_size(), E->key().y * _get_quadrant_size() + _get_quadrant_size()));
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size(), E->key().y * _get_quadrant_size() + _get_quadrant_size()));
-		if (E == quadrant_map.front())
+		r.position = _map_to_world(K->x * _get_quadrant_size(), K->y * _get_quadrant_size());
+		r.expand_to(_map_to_world(K->x * _get_quadrant_size() + _get_quadrant_size(), K->y * _get_quadrant_size()));
+		r.expand_to(_map_to_world(K->x * _get_quadrant_size() + _get_quadrant_size(), K->y * _get_quadrant_size() + _get_quadrant_size()));
+		r.expand_to(_map_to_world(K->x * _get_quadrant_size(), K->y * _get_quadrant_size() + _get_quadrant_size()));
+		if (r_total == Rect2())
 			r_total = r;
 		else
 			r_total = r_total.merge(r);
@@ -643,7 +845,7 @@ void TileMap::_recompute_rect_cache() {
 #endif
 }
 
-Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(const PosKey &p_qk) {
+TileMap::Quadrant *TileMap::_create_quadrant(const PosKey &p_qk) {
 
 	Transform2D xform;
 	//xform.set_origin(Point2(p_qk.x,p_qk.y)*cell_size*quadrant_size);
@@ -676,13 +878,18 @@ Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(cons
 
 	rect_cache_dirty = true;
 	quadrant_order_dirty = true;
-	return quadrant_map.insert(p_qk, q);
+	quadrant_map.set(p_qk, q);
+	return quadrant_map.getptr(p_qk);
 }
 
-void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
+void TileMap::_erase_quadrant(const PosKey &p_qk) {
 
-	Quadrant &q = Q->get();
+	Quadrant &q = quadrant_map[p_qk];
 	Physics2DServer::get_singleton()->free(q.body);
+	for (int i = 0; i < q.merged_shapes.size(); i++) {
+		Physics2DServer::get_singleton()->free(q.merged_shapes[i]);
+	}
+	q.merged_shapes.clear();
 	for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
 		VisualServer::get_singleton()->free(E->get());
@@ -699,18 +906,16 @@ void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
 		q.navpoly_ids.clear();
 	}
 
-	for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
-		VS::get_singleton()->free(E->get().id);
-	}
-	q.occluder_instances.clear();
+	_free_quadrant_occluders(q);
 
-	quadrant_map.erase(Q);
+	quadrant_map.erase(p_qk);
 	rect_cache_dirty = true;
 }
 
-void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update) {
+void TileMap::_make_quadrant_dirty(Quadrant *p_quadrant, const PosKey &p_cell, bool update) {
 
-	Quadrant &q = Q->get();
+	Quadrant &q = *p_quadrant;
+	q.dirty_cells.insert(p_cell);
 	if (!q.dirty_list.in_list())
 		dirty_quadrant_list.add(&q.dirty_list);
 
@@ -725,6 +930,92 @@ void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool updat
 	}
 }
 
+TileMap::CellChunk *TileMap::_get_chunk(const PosKey &p_chunk_key, bool p_create) {
+
+	CellChunk **chunk = cell_chunks.getptr(p_chunk_key);
+	if (chunk)
+		return *chunk;
+
+	if (!p_create)
+		return NULL;
+
+	CellChunk *new_chunk = memnew(CellChunk);
+	cell_chunks.set(p_chunk_key, new_chunk);
+	return new_chunk;
+}
+
+TileMap::Cell *TileMap::_insert_cell(CellChunk *p_chunk, const PosKey &p_pos) {
+
+	Cell &c = p_chunk->cells[_get_chunk_index(p_pos)];
+	if (c.id == INVALID_CELL) {
+		c = Cell();
+		p_chunk->used++;
+		cell_count++;
+	}
+
+	return &c;
+}
+
+void TileMap::_erase_cell(const PosKey &p_pos) {
+
+	PosKey ck = _get_chunk_key(p_pos);
+	CellChunk *chunk = _get_chunk(ck, false);
+	if (!chunk)
+		return;
+
+	Cell &c = chunk->cells[_get_chunk_index(p_pos)];
+	if (c.id == INVALID_CELL)
+		return;
+
+	c.id = INVALID_CELL;
+	cell_count--;
+	chunk->used--;
+	if (chunk->used == 0) {
+		memdelete(chunk);
+		cell_chunks.erase(ck);
+	}
+}
+
+void TileMap::_clear_cells() {
+
+	const PosKey *K = NULL;
+	while ((K = cell_chunks.next(K))) {
+		memdelete(cell_chunks[*K]);
+	}
+	cell_chunks.clear();
+	cell_count = 0;
+}
+
+void TileMap::_get_used_cell_keys(Vector<PosKey> *r_keys) const {
+
+	//chunks are hashed, sort them so the order (and saved tile data) is deterministic
+	Vector<PosKey> chunk_keys;
+	chunk_keys.resize(cell_chunks.size());
+	int chunk_count = 0;
+	const PosKey *K = NULL;
+	while ((K = cell_chunks.next(K))) {
+		chunk_keys.write[chunk_count++] = *K;
+	}
+	chunk_keys.sort();
+
+	r_keys->resize(cell_count);
+	PosKey *w = r_keys->ptrw();
+	int idx = 0;
+
+	for (int i = 0; i < chunk_keys.size(); i++) {
+
+		const CellChunk *chunk = cell_chunks[chunk_keys[i]];
+		for (int j = 0; j < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; j++) {
+
+			if (chunk->cells[j].id == INVALID_CELL)
+				continue;
+
+			ERR_FAIL_COND(idx >= cell_count);
+			w[idx++] = PosKey(chunk_keys[i].x * CELL_CHUNK_SIZE + (j & CELL_CHUNK_MASK), chunk_keys[i].y * CELL_CHUNK_SIZE + (j >> CELL_CHUNK_SHIFT));
+		}
+	}
+}
+
 void TileMap::set_cellv(const Vector2 &p_pos, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose) {
 
 	set_cell(p_pos.x, p_pos.y, p_tile, p_flip_x, p_flip_y, p_transpose);
@@ -739,43 +1030,43 @@ void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_
 
 	PosKey pk(p_x, p_y);
 
-	Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	Cell *E = _get_cell(pk);
 	if (!E && p_tile == INVALID_CELL)
 		return; //nothing to do
 
 	PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
 	if (p_tile == INVALID_CELL) {
 		//erase existing
-		tile_map.erase(pk);
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+		_erase_cell(pk);
+		Quadrant *Q = quadrant_map.getptr(qk);
 		ERR_FAIL_COND(!Q);
-		Quadrant &q = Q->get();
+		Quadrant &q = *Q;
 		q.cells.erase(pk);
 		if (q.cells.size() == 0)
-			_erase_quadrant(Q);
+			_erase_quadrant(qk);
 		else
-			_make_quadrant_dirty(Q);
+			_make_quadrant_dirty(Q, pk);
 
 		return;
 	}
 
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	Quadrant *Q = quadrant_map.getptr(qk);
 
 	if (!E) {
-		E = tile_map.insert(pk, Cell());
+		E = _insert_cell(_get_chunk(_get_chunk_key(pk), true), pk);
 		if (!Q) {
 			Q = _create_quadrant(qk);
 		}
-		Quadrant &q = Q->get();
+		Quadrant &q = *Q;
 		q.cells.insert(pk);
 	} else {
 		ERR_FAIL_COND(!Q); // quadrant should exist...
 
-		if (E->get().id == p_tile && E->get().flip_h == p_flip_x && E->get().flip_v == p_flip_y && E->get().transpose == p_transpose && E->get().autotile_coord_x == (uint16_t)p_autotile_coord.x && E->get().autotile_coord_y == (uint16_t)p_autotile_coord.y)
+		if (E->id == p_tile && E->flip_h == p_flip_x && E->flip_v == p_flip_y && E->transpose == p_transpose && E->autotile_coord_x == (uint16_t)p_autotile_coord.x && E->autotile_coord_y == (uint16_t)p_autotile_coord.y)
 			return; //nothing changed
 	}
 
-	Cell &c = E->get();
+	Cell &c = *E;
 
 	c.id = p_tile;
 	c.flip_h = p_flip_x;
@@ -784,7 +1075,7 @@ void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_
 	c.autotile_coord_x = (uint16_t)p_autotile_coord.x;
 	c.autotile_coord_y = (uint16_t)p_autotile_coord.y;
 
-	_make_quadrant_dirty(Q);
+	_make_quadrant_dirty(Q, pk);
 	used_size_cache_dirty = true;
 }
 
@@ -793,6 +1084,103 @@ int TileMap::get_cellv(const Vector2 &p_pos) const {
 	return get_cell(p_pos.x, p_pos.y);
 }
 
+void TileMap::_set_cells(int p_x, int p_y, int p_width, int p_height, const int *p_tiles, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, const Vector2 &p_autotile_coord) {
+
+	Quadrant *q = NULL;
+	PosKey q_key;
+	int qs = _get_quadrant_size();
+
+	//walk the area chunk by chunk, so each chunk is looked up (or allocated) once
+	for (int cy = p_y >> CELL_CHUNK_SHIFT; cy <= (p_y + p_height - 1) >> CELL_CHUNK_SHIFT; cy++) {
+		for (int cx = p_x >> CELL_CHUNK_SHIFT; cx <= (p_x + p_width - 1) >> CELL_CHUNK_SHIFT; cx++) {
+
+			PosKey ck(cx, cy);
+			CellChunk *chunk = _get_chunk(ck, false);
+
+			int from_x = MAX(p_x, cx * CELL_CHUNK_SIZE);
+			int to_x = MIN(p_x + p_width, (cx + 1) * CELL_CHUNK_SIZE);
+			int from_y = MAX(p_y, cy * CELL_CHUNK_SIZE);
+			int to_y = MIN(p_y + p_height, (cy + 1) * CELL_CHUNK_SIZE);
+
+			for (int y = from_y; y < to_y; y++) {
+				for (int x = from_x; x < to_x; x++) {
+
+					int tile = p_tiles ? p_tiles[(y - p_y) * p_width + (x - p_x)] : p_tile;
+					PosKey pk(x, y);
+
+					if (tile == INVALID_CELL) {
+						if (chunk && chunk->cells[_get_chunk_index(pk)].id != INVALID_CELL) {
+							set_cell(x, y, INVALID_CELL);
+							//erasing may free both the chunk and the quadrant
+							chunk = _get_chunk(ck, false);
+							q = NULL;
+						}
+						continue;
+					}
+
+					if (!chunk) {
+						chunk = _get_chunk(ck, true);
+					}
+
+					Cell *c = &chunk->cells[_get_chunk_index(pk)];
+					bool inserted = c->id == INVALID_CELL;
+					if (inserted) {
+						c = _insert_cell(chunk, pk);
+					} else if (c->id == tile && c->flip_h == p_flip_x && c->flip_v == p_flip_y && c->transpose == p_transpose && c->autotile_coord_x == (uint16_t)p_autotile_coord.x && c->autotile_coord_y == (uint16_t)p_autotile_coord.y) {
+						continue; //nothing changed
+					}
+
+					c->id = tile;
+					c->flip_h = p_flip_x;
+					c->flip_v = p_flip_y;
+					c->transpose = p_transpose;
+					c->autotile_coord_x = (uint16_t)p_autotile_coord.x;
+					c->autotile_coord_y = (uint16_t)p_autotile_coord.y;
+
+					PosKey qk(x / qs, y / qs);
+					if (!q || !(qk == q_key)) {
+						q = quadrant_map.getptr(qk);
+						if (!q) {
+							q = _create_quadrant(qk);
+						}
+						q_key = qk;
+					}
+
+					if (inserted) {
+						q->cells.insert(pk);
+					}
+					_make_quadrant_dirty(q, pk);
+					used_size_cache_dirty = true;
+				}
+			}
+		}
+	}
+}
+
+void TileMap::set_cells_rect(const Rect2 &p_rect, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, Vector2 p_autotile_coord) {
+
+	int w = p_rect.size.x;
+	int h = p_rect.size.y;
+	ERR_FAIL_COND(w < 0 || h < 0);
+
+	if (w == 0 || h == 0)
+		return;
+
+	_set_cells(p_rect.position.x, p_rect.position.y, w, h, NULL, p_tile, p_flip_x, p_flip_y, p_transpose, p_autotile_coord);
+}
+
+void TileMap::set_cells_from_array(const Vector2 &p_origin, int p_width, const PoolVector<int> &p_tiles) {
+
+	ERR_FAIL_COND(p_width <= 0);
+	ERR_FAIL_COND(p_tiles.size() % p_width != 0);
+
+	if (p_tiles.size() == 0)
+		return;
+
+	PoolVector<int>::Read r = p_tiles.read();
+	_set_cells(p_origin.x, p_origin.y, p_width, p_tiles.size() / p_width, r.ptr(), INVALID_CELL, false, false, false, Vector2());
+}
+
 void TileMap::make_bitmask_area_dirty(const Vector2 &p_pos) {
 
 	for (int x = p_pos.x - 1; x <= p_pos.x + 1; x++) {
@@ -837,7 +1225,7 @@ void TileMap::update_bitmask_region(const Vector2 &p_start, const Vector2 &p_end
 void TileMap::update_cell_bitmask(int p_x, int p_y) {
 
 	PosKey p(p_x, p_y);
-	Map<PosKey, Cell>::Element *E = tile_map.find(p);
+	Cell *E = _get_cell(p);
 	if (E != NULL) {
 		int id = get_cell(p_x, p_y);
 		if (tile_set->tile_get_tile_mode(id) == TileSet::AUTO_TILE) {
@@ -898,15 +1286,15 @@ void TileMap::update_cell_bitmask(int p_x, int p_y) {
 				}
 			}
 			Vector2 coord = tile_set->autotile_get_subtile_for_bitmask(id, mask, this, Vector2(p_x, p_y));
-			E->get().autotile_coord_x = (int)coord.x;
-			E->get().autotile_coord_y = (int)coord.y;
+			E->autotile_coord_x = (int)coord.x;
+			E->autotile_coord_y = (int)coord.y;
 
 			PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
-			Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
-			_make_quadrant_dirty(Q);
+			Quadrant *Q = quadrant_map.getptr(qk);
+			_make_quadrant_dirty(Q, PosKey(p_x, p_y));
 		} else {
-			E->get().autotile_coord_x = 0;
-			E->get().autotile_coord_y = 0;
+			E->autotile_coord_x = 0;
+			E->autotile_coord_y = 0;
 		}
 	}
 }
@@ -921,10 +1309,13 @@ void TileMap::update_dirty_bitmask() {
 
 void TileMap::fix_invalid_tiles() {
 
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	Vector<PosKey> keys;
+	_get_used_cell_keys(&keys);
+
+	for (int i = 0; i < keys.size(); i++) {
 
-		if (!tile_set->has_tile(get_cell(E->key().x, E->key().y))) {
-			set_cell(E->key().x, E->key().y, INVALID_CELL);
+		if (!tile_set->has_tile(get_cell(keys[i].x, keys[i].y))) {
+			set_cell(keys[i].x, keys[i].y, INVALID_CELL);
 		}
 	}
 }
@@ -933,98 +1324,99 @@ int TileMap::get_cell(int p_x, int p_y) const {
 
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = _get_cell(pk);
 
 	if (!E)
 		return INVALID_CELL;
 
-	return E->get().id;
+	return E->id;
 }
 bool TileMap::is_cell_x_flipped(int p_x, int p_y) const {
 
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = _get_cell(pk);
 
 	if (!E)
 		return false;
 
-	return E->get().flip_h;
+	return E->flip_h;
 }
 bool TileMap::is_cell_y_flipped(int p_x, int p_y) const {
 
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = _get_cell(pk);
 
 	if (!E)
 		return false;
 
-	return E->get().flip_v;
+	return E->flip_v;
 }
 bool TileMap::is_cell_transposed(int p_x, int p_y) const {
 
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = _get_cell(pk);
 
 	if (!E)
 		return false;
 
-	return E->get().transpose;
+	return E->transpose;
 }
 
 void TileMap::set_cell_autotile_coord(int p_x, int p_y, const Vector2 &p_coord) {
 
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	Cell *E = _get_cell(pk);
 
 	if (!E)
 		return;
 
-	Cell c = E->get();
-	c.autotile_coord_x = p_coord.x;
-	c.autotile_coord_y = p_coord.y;
-	tile_map[pk] = c;
+	E->autotile_coord_x = p_coord.x;
+	E->autotile_coord_y = p_coord.y;
 
 	PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	Quadrant *Q = quadrant_map.getptr(qk);
 
 	if (!Q)
 		return;
 
-	_make_quadrant_dirty(Q);
+	_make_quadrant_dirty(Q, pk);
 }
 
 Vector2 TileMap::get_cell_autotile_coord(int p_x, int p_y) const {
 
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = _get_cell(pk);
 
 	if (!E)
 		return Vector2();
 
-	return Vector2(E->get().autotile_coord_x, E->get().autotile_coord_y);
+	return Vector2(E->autotile_coord_x, E->autotile_coord_y);
 }
 
 void TileMap::_recreate_quadrants() {
 
 	_clear_quadrants();
 
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	Vector<PosKey> keys;
+	_get_used_cell_keys(&keys);
+
+	for (int i = 0; i < keys.size(); i++) {
 
-		PosKey qk(E->key().x / _get_quadrant_size(), E->key().y / _get_quadrant_size());
+		PosKey qk(keys[i].x / _get_quadrant_size(), keys[i].y / _get_quadrant_size());
 
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+		Quadrant *Q = quadrant_map.getptr(qk);
 		if (!Q) {
 			Q = _create_quadrant(qk);
-			dirty_quadrant_list.add(&Q->get().dirty_list);
+			dirty_quadrant_list.add(&Q->dirty_list);
 		}
 
-		Q->get().cells.insert(E->key());
-		_make_quadrant_dirty(Q, false);
+		Q->cells.insert(keys[i]);
+		_make_quadrant_dirty(Q, keys[i], false);
 	}
 	update_dirty_quadrants();
 }
@@ -1032,7 +1424,8 @@ void TileMap::_recreate_quadrants() {
 void TileMap::_clear_quadrants() {
 
 	while (quadrant_map.size()) {
-		_erase_quadrant(quadrant_map.front());
+		PosKey qk = *quadrant_map.next(NULL);
+		_erase_quadrant(qk);
 	}
 }
 
@@ -1050,9 +1443,10 @@ void TileMap::set_use_parent_material(bool p_use_parent_material) {
 
 void TileMap::_update_all_items_material_state() {
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
 			_update_item_material_state(E->get());
@@ -1068,7 +1462,7 @@ void TileMap::_update_item_material_state(const RID &p_canvas_item) {
 void TileMap::clear() {
 
 	_clear_quadrants();
-	tile_map.clear();
+	_clear_cells();
 	used_size_cache_dirty = true;
 }
 
@@ -1123,27 +1517,31 @@ void TileMap::_set_tile_data(const PoolVector<int> &p_data) {
 
 PoolVector<int> TileMap::_get_tile_data() const {
 
+	Vector<PosKey> keys;
+	_get_used_cell_keys(&keys);
+
 	PoolVector<int> data;
-	data.resize(tile_map.size() * 3);
+	data.resize(keys.size() * 3);
 	PoolVector<int>::Write w = data.write();
 
 	format = FORMAT_2;
 
 	int idx = 0;
-	for (const Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (int i = 0; i < keys.size(); i++) {
+		const Cell &c = *_get_cell(keys[i]);
 		uint8_t *ptr = (uint8_t *)&w[idx];
-		encode_uint16(E->key().x, &ptr[0]);
-		encode_uint16(E->key().y, &ptr[2]);
-		uint32_t val = E->get().id;
-		if (E->get().flip_h)
+		encode_uint16(keys[i].x, &ptr[0]);
+		encode_uint16(keys[i].y, &ptr[2]);
+		uint32_t val = c.id;
+		if (c.flip_h)
 			val |= (1 << 29);
-		if (E->get().flip_v)
+		if (c.flip_v)
 			val |= (1 << 30);
-		if (E->get().transpose)
+		if (c.transpose)
 			val |= (1 << 31);
 		encode_uint32(val, &ptr[4]);
-		encode_uint16(E->get().autotile_coord_x, &ptr[8]);
-		encode_uint16(E->get().autotile_coord_y, &ptr[10]);
+		encode_uint16(c.autotile_coord_x, &ptr[8]);
+		encode_uint16(c.autotile_coord_y, &ptr[10]);
 		idx += 3;
 	}
 
@@ -1155,9 +1553,10 @@ PoolVector<int> TileMap::_get_tile_data() const {
 void TileMap::set_collision_layer(uint32_t p_layer) {
 
 	collision_layer = p_layer;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		Physics2DServer::get_singleton()->body_set_collision_layer(q.body, collision_layer);
 	}
 }
@@ -1165,9 +1564,10 @@ void TileMap::set_collision_layer(uint32_t p_layer) {
 void TileMap::set_collision_mask(uint32_t p_mask) {
 
 	collision_mask = p_mask;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		Physics2DServer::get_singleton()->body_set_collision_mask(q.body, collision_mask);
 	}
 }
@@ -1204,12 +1604,28 @@ void TileMap::set_collision_use_kinematic(bool p_use_kinematic) {
 	_recreate_quadrants();
 }
 
+bool TileMap::get_collision_use_rect_merging() const {
+
+	return use_rect_merging;
+}
+
+void TileMap::set_collision_use_rect_merging(bool p_enable) {
+
+	if (use_rect_merging == p_enable)
+		return;
+
+	_clear_quadrants();
+	use_rect_merging = p_enable;
+	_recreate_quadrants();
+}
+
 void TileMap::set_collision_friction(float p_friction) {
 
 	friction = p_friction;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		Physics2DServer::get_singleton()->body_set_param(q.body, Physics2DServer::BODY_PARAM_FRICTION, p_friction);
 	}
 }
@@ -1222,9 +1638,10 @@ float TileMap::get_collision_friction() const {
 void TileMap::set_collision_bounce(float p_bounce) {
 
 	bounce = p_bounce;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map[*K];
 		Physics2DServer::get_singleton()->body_set_param(q.body, Physics2DServer::BODY_PARAM_BOUNCE, p_bounce);
 	}
 }
@@ -1464,13 +1881,15 @@ bool TileMap::is_y_sort_mode_enabled() const {
 
 Array TileMap::get_used_cells() const {
 
+	Vector<PosKey> keys;
+	_get_used_cell_keys(&keys);
+
 	Array a;
-	a.resize(tile_map.size());
-	int i = 0;
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	a.resize(keys.size());
+	for (int i = 0; i < keys.size(); i++) {
 
-		Vector2 p(E->key().x, E->key().y);
-		a[i++] = p;
+		Vector2 p(keys[i].x, keys[i].y);
+		a[i] = p;
 	}
 
 	return a;
@@ -1478,11 +1897,14 @@ Array TileMap::get_used_cells() const {
 
 Array TileMap::get_used_cells_by_id(int p_id) const {
 
+	Vector<PosKey> keys;
+	_get_used_cell_keys(&keys);
+
 	Array a;
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (int i = 0; i < keys.size(); i++) {
 
-		if (E->value().id == p_id) {
-			Vector2 p(E->key().x, E->key().y);
+		if (_get_cell(keys[i])->id == p_id) {
+			Vector2 p(keys[i].x, keys[i].y);
 			a.push_back(p);
 		}
 	}
@@ -1493,11 +1915,14 @@ Array TileMap::get_used_cells_by_id(int p_id) const {
 Rect2 TileMap::get_used_rect() { // Not const because of cache
 
 	if (used_size_cache_dirty) {
-		if (tile_map.size() > 0) {
-			used_size_cache = Rect2(tile_map.front()->key().x, tile_map.front()->key().y, 0, 0);
+		if (cell_count > 0) {
+			Vector<PosKey> keys;
+			_get_used_cell_keys(&keys);
 
-			for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-				used_size_cache.expand_to(Vector2(E->key().x, E->key().y));
+			used_size_cache = Rect2(keys[0].x, keys[0].y, 0, 0);
+
+			for (int i = 1; i < keys.size(); i++) {
+				used_size_cache.expand_to(Vector2(keys[i].x, keys[i].y));
 			}
 
 			used_size_cache.size += Vector2(1, 1);
@@ -1514,10 +1939,12 @@ Rect2 TileMap::get_used_rect() { // Not const because of cache
 void TileMap::set_occluder_light_mask(int p_mask) {
 
 	occluder_light_mask = p_mask;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		for (Map<PosKey, Quadrant::Occluder>::Element *F = E->get().occluder_instances.front(); F; F = F->next()) {
-			VisualServer::get_singleton()->canvas_light_occluder_set_light_mask(F->get().id, occluder_light_mask);
+		const Quadrant &q = quadrant_map[*K];
+		for (int i = 0; i < q.occluders.size(); i++) {
+			VisualServer::get_singleton()->canvas_light_occluder_set_light_mask(q.occluders[i].id, occluder_light_mask);
 		}
 	}
 }
@@ -1530,9 +1957,10 @@ int TileMap::get_occluder_light_mask() const {
 void TileMap::set_light_mask(int p_light_mask) {
 
 	CanvasItem::set_light_mask(p_light_mask);
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	const PosKey *K = NULL;
+	while ((K = quadrant_map.next(K))) {
 
-		for (List<RID>::Element *F = E->get().canvas_items.front(); F; F = F->next()) {
+		for (List<RID>::Element *F = quadrant_map[*K].canvas_items.front(); F; F = F->next()) {
 			VisualServer::get_singleton()->canvas_item_set_light_mask(F->get(), get_light_mask());
 		}
 	}
@@ -1588,6 +2016,9 @@ void TileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_collision_use_kinematic", "use_kinematic"), &TileMap::set_collision_use_kinematic);
 	ClassDB::bind_method(D_METHOD("get_collision_use_kinematic"), &TileMap::get_collision_use_kinematic);
 
+	ClassDB::bind_method(D_METHOD("set_collision_use_rect_merging", "enable"), &TileMap::set_collision_use_rect_merging);
+	ClassDB::bind_method(D_METHOD("get_collision_use_rect_merging"), &TileMap::get_collision_use_rect_merging);
+
 	ClassDB::bind_method(D_METHOD("set_collision_layer", "layer"), &TileMap::set_collision_layer);
 	ClassDB::bind_method(D_METHOD("get_collision_layer"), &TileMap::get_collision_layer);
 
@@ -1612,6 +2043,8 @@ void TileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_cell", "x", "y", "tile", "flip_x", "flip_y", "transpose", "autotile_coord"), &TileMap::set_cell, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(Vector2()));
 	ClassDB::bind_method(D_METHOD("set_cellv", "position", "tile", "flip_x", "flip_y", "transpose"), &TileMap::set_cellv, DEFVAL(false), DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("set_celld", "position", "data"), &TileMap::set_celld);
+	ClassDB::bind_method(D_METHOD("set_cells_rect", "rect", "tile", "flip_x", "flip_y", "transpose", "autotile_coord"), &TileMap::set_cells_rect, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(Vector2()));
+	ClassDB::bind_method(D_METHOD("set_cells_from_array", "origin", "width", "tiles"), &TileMap::set_cells_from_array);
 	ClassDB::bind_method(D_METHOD("get_cell", "x", "y"), &TileMap::get_cell);
 	ClassDB::bind_method(D_METHOD("get_cellv", "position"), &TileMap::get_cellv);
 	ClassDB::bind_method(D_METHOD("is_cell_x_flipped", "x", "y"), &TileMap::is_cell_x_flipped);
@@ -1652,6 +2085,7 @@ void TileMap::_bind_methods() {
 
 	ADD_GROUP("Collision", "collision_");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_use_kinematic", PROPERTY_HINT_NONE, ""), "set_collision_use_kinematic", "get_collision_use_kinematic");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_use_rect_merging", PROPERTY_HINT_NONE, ""), "set_collision_use_rect_merging", "get_collision_use_rect_merging");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "collision_friction", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_collision_friction", "get_collision_friction");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "collision_bounce", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_collision_bounce", "get_collision_bounce");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_layer", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_collision_layer", "get_collision_layer");
@@ -1698,6 +2132,8 @@ TileMap::TileMap() {
 	mode = MODE_SQUARE;
 	half_offset = HALF_OFFSET_DISABLED;
 	use_kinematic = false;
+	use_rect_merging = false;
+	cell_count = 0;
 	navigation = NULL;
 	y_sort_mode = false;
 	occluder_light_mask = 1;
@@ -33,6 +33,7 @@
 
 #include "scene/2d/navigation2d.h"
 #include "scene/2d/node_2d.h"
+#include "hash_map.h"
 #include "scene/resources/tile_set.h"
 #include "self_list.h"
 #include "vset.h"
@@ -73,6 +74,7 @@ private:
 	Transform2D custom_transform;
 	HalfOffset half_offset;
 	bool use_kinematic;
+	bool use_rect_merging;
 	Navigation2D *navigation;
 
 	union PosKey {
@@ -98,6 +100,10 @@ private:
 		}
 	};
 
+	struct PosKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const PosKey &p_key) { return hash_djb2_one_32(p_key.key); }
+	};
+
 	union Cell {
 
 		struct {
@@ -113,14 +119,58 @@ private:
 		Cell() { _u64t = 0; }
 	};
 
-	Map<PosKey, Cell> tile_map;
+	enum {
+		CELL_CHUNK_SHIFT = 4,
+		CELL_CHUNK_SIZE = 1 << CELL_CHUNK_SHIFT,
+		CELL_CHUNK_MASK = CELL_CHUNK_SIZE - 1
+	};
+
+	//cells are stored in dense square chunks, empty cells have an INVALID_CELL id
+	struct CellChunk {
+
+		Cell cells[CELL_CHUNK_SIZE * CELL_CHUNK_SIZE];
+		int used;
+
+		CellChunk() {
+			for (int i = 0; i < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; i++) {
+				cells[i].id = INVALID_CELL;
+			}
+			used = 0;
+		}
+	};
+
+	HashMap<PosKey, CellChunk *, PosKeyHasher> cell_chunks;
+	int cell_count;
 	List<PosKey> dirty_bitmask;
 
+	_FORCE_INLINE_ static PosKey _get_chunk_key(const PosKey &p_pos) { return PosKey(p_pos.x >> CELL_CHUNK_SHIFT, p_pos.y >> CELL_CHUNK_SHIFT); }
+	_FORCE_INLINE_ static int _get_chunk_index(const PosKey &p_pos) { return ((p_pos.y & CELL_CHUNK_MASK) << CELL_CHUNK_SHIFT) | (p_pos.x & CELL_CHUNK_MASK); }
+
+	_FORCE_INLINE_ const Cell *_get_cell(const PosKey &p_pos) const {
+
+		CellChunk *const *chunk = cell_chunks.getptr(_get_chunk_key(p_pos));
+		if (!chunk)
+			return NULL;
+		const Cell *c = &(*chunk)->cells[_get_chunk_index(p_pos)];
+		return c->id == INVALID_CELL ? NULL : c;
+	}
+	_FORCE_INLINE_ Cell *_get_cell(const PosKey &p_pos) {
+
+		return const_cast<Cell *>(static_cast<const TileMap *>(this)->_get_cell(p_pos));
+	}
+
+	CellChunk *_get_chunk(const PosKey &p_chunk_key, bool p_create);
+	Cell *_insert_cell(CellChunk *p_chunk, const PosKey &p_pos);
+	void _erase_cell(const PosKey &p_pos);
+	void _clear_cells();
+	void _get_used_cell_keys(Vector<PosKey> *r_keys) const;
+
 	struct Quadrant {
 
 		Vector2 pos;
 		List<RID> canvas_items;
 		RID body;
+		Vector<RID> merged_shapes; //rectangle shapes owned by this quadrant, see collision_use_rect_merging
 
 		SelfList<Quadrant> dirty_list;
 
@@ -131,36 +181,46 @@ private:
 
 		struct Occluder {
 			RID id;
-			Transform2D xform;
+			RID polygon;
 		};
 
 		Map<PosKey, NavPoly> navpoly_ids;
-		Map<PosKey, Occluder> occluder_instances;
+		Vector<Occluder> occluders; //occluder polygons of all cells, merged per cull mode
 
 		VSet<PosKey> cells;
+		VSet<PosKey> dirty_cells; //cells whose navpolys and occluders must be recreated
 
 		void operator=(const Quadrant &q) {
 			pos = q.pos;
 			canvas_items = q.canvas_items;
 			body = q.body;
+			merged_shapes = q.merged_shapes;
 			cells = q.cells;
+			dirty_cells = q.dirty_cells;
 			navpoly_ids = q.navpoly_ids;
-			occluder_instances = q.occluder_instances;
+			occluders = q.occluders;
 		}
 		Quadrant(const Quadrant &q) :
 				dirty_list(this) {
 			pos = q.pos;
 			canvas_items = q.canvas_items;
 			body = q.body;
+			merged_shapes = q.merged_shapes;
 			cells = q.cells;
-			occluder_instances = q.occluder_instances;
+			dirty_cells = q.dirty_cells;
+			occluders = q.occluders;
 			navpoly_ids = q.navpoly_ids;
 		}
 		Quadrant() :
 				dirty_list(this) {}
 	};
 
-	Map<PosKey, Quadrant> quadrant_map;
+	HashMap<PosKey, Quadrant, PosKeyHasher> quadrant_map;
+
+	struct MergeCell {
+		PosKey pos;
+		Vector2 origin; //center of the cell rectangle, in quadrant space
+	};
 
 	SelfList<Quadrant>::List dirty_quadrant_list;
 
@@ -186,9 +246,15 @@ private:
 
 	void _fix_cell_transform(Transform2D &xform, const Cell &p_cell, const Vector2 &p_offset, const Size2 &p_sc);
 
-	Map<PosKey, Quadrant>::Element *_create_quadrant(const PosKey &p_qk);
-	void _erase_quadrant(Map<PosKey, Quadrant>::Element *Q);
-	void _make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update = true);
+	Quadrant *_create_quadrant(const PosKey &p_qk);
+	void _erase_quadrant(const PosKey &p_qk);
+	void _make_quadrant_dirty(Quadrant *p_quadrant, const PosKey &p_cell, bool update = true);
+	void _set_cells(int p_x, int p_y, int p_width, int p_height, const int *p_tiles, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, const Vector2 &p_autotile_coord);
+	void _add_merged_shapes(Quadrant &p_quadrant, const Vector<MergeCell> &p_cells, const RID &p_debug_canvas_item, const Color &p_debug_color);
+
+	void _add_occluder_lines(Vector<Vector2> &r_lines, const Ref<OccluderPolygon2D> &p_occluder, const Transform2D &p_xform);
+	void _update_quadrant_occluders(Quadrant &p_quadrant, const Vector<Vector2> *p_lines);
+	void _free_quadrant_occluders(Quadrant &p_quadrant);
 	void _recreate_quadrants();
 	void _clear_quadrants();
 	void _update_quadrant_space(const RID &p_space);
@@ -244,6 +310,9 @@ public:
 	void set_cellv(const Vector2 &p_pos, int p_tile, bool p_flip_x = false, bool p_flip_y = false, bool p_transpose = false);
 	int get_cellv(const Vector2 &p_pos) const;
 
+	void set_cells_rect(const Rect2 &p_rect, int p_tile, bool p_flip_x = false, bool p_flip_y = false, bool p_transpose = false, Vector2 p_autotile_coord = Vector2());
+	void set_cells_from_array(const Vector2 &p_origin, int p_width, const PoolVector<int> &p_tiles);
+
 	void make_bitmask_area_dirty(const Vector2 &p_pos);
 	void update_bitmask_area(const Vector2 &p_pos);
 	void update_bitmask_region(const Vector2 &p_start = Vector2(), const Vector2 &p_end = Vector2());
@@ -267,6 +336,9 @@ public:
 	void set_collision_use_kinematic(bool p_use_kinematic);
 	bool get_collision_use_kinematic() const;
 
+	void set_collision_use_rect_merging(bool p_enable);
+	bool get_collision_use_rect_merging() const;
+
 	void set_collision_friction(float p_friction);
 	float get_collision_friction() const;
 
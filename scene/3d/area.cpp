@@ -147,7 +147,7 @@ void Area::_body_exit_tree(ObjectID p_id) {
 	}
 }
 
-void Area::_body_inout(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+void Area::_body_inout_event(int p_status, ObjectID p_instance, int p_body_shape, int p_area_shape) {
 
 	bool body_in = p_status == PhysicsServer::AREA_BODY_ADDED;
 	ObjectID objid = p_instance;
@@ -159,8 +159,6 @@ void Area::_body_inout(int p_status, const RID &p_body, int p_instance, int p_bo
 
 	ERR_FAIL_COND(!body_in && !E);
 
-	locked = true;
-
 	if (body_in) {
 		if (!E) {
 
@@ -210,6 +208,27 @@ void Area::_body_inout(int p_status, const RID &p_body, int p_instance, int p_bo
 		if (eraseit)
 			body_map.erase(E);
 	}
+}
+
+void Area::_body_inout(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+
+	locked = true;
+	_body_inout_event(p_status, p_instance, p_body_shape, p_area_shape);
+	locked = false;
+}
+
+void Area::_body_inout_batch(const PoolIntArray &p_events) {
+
+	int count = p_events.size() / PhysicsServer::AREA_MONITOR_EVENT_SIZE;
+	PoolIntArray::Read r = p_events.read();
+
+	locked = true;
+
+	for (int i = 0; i < count; i++) {
+
+		const int *event = &r[i * PhysicsServer::AREA_MONITOR_EVENT_SIZE];
+		_body_inout_event(event[PhysicsServer::AREA_MONITOR_EVENT_STATUS], event[PhysicsServer::AREA_MONITOR_EVENT_INSTANCE_ID], event[PhysicsServer::AREA_MONITOR_EVENT_BODY_SHAPE], event[PhysicsServer::AREA_MONITOR_EVENT_AREA_SHAPE]);
+	}
 
 	locked = false;
 }
@@ -301,8 +320,9 @@ void Area::set_monitoring(bool p_enable) {
 
 	if (monitoring) {
 
-		PhysicsServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout);
-		PhysicsServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout);
+		PhysicsServer::get_singleton()->area_set_monitor_batching(get_rid(), true);
+		PhysicsServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout_batch);
+		PhysicsServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout_batch);
 	} else {
 		PhysicsServer::get_singleton()->area_set_monitor_callback(get_rid(), NULL, StringName());
 		PhysicsServer::get_singleton()->area_set_area_monitor_callback(get_rid(), NULL, StringName());
@@ -344,7 +364,7 @@ void Area::_area_exit_tree(ObjectID p_id) {
 	}
 }
 
-void Area::_area_inout(int p_status, const RID &p_area, int p_instance, int p_area_shape, int p_self_shape) {
+void Area::_area_inout_event(int p_status, ObjectID p_instance, int p_area_shape, int p_self_shape) {
 
 	bool area_in = p_status == PhysicsServer::AREA_BODY_ADDED;
 	ObjectID objid = p_instance;
@@ -356,8 +376,6 @@ void Area::_area_inout(int p_status, const RID &p_area, int p_instance, int p_ar
 
 	ERR_FAIL_COND(!area_in && !E);
 
-	locked = true;
-
 	if (area_in) {
 		if (!E) {
 
@@ -408,6 +426,27 @@ void Area::_area_inout(int p_status, const RID &p_area, int p_instance, int p_ar
 		if (eraseit)
 			area_map.erase(E);
 	}
+}
+
+void Area::_area_inout(int p_status, const RID &p_area, int p_instance, int p_area_shape, int p_self_shape) {
+
+	locked = true;
+	_area_inout_event(p_status, p_instance, p_area_shape, p_self_shape);
+	locked = false;
+}
+
+void Area::_area_inout_batch(const PoolIntArray &p_events) {
+
+	int count = p_events.size() / PhysicsServer::AREA_MONITOR_EVENT_SIZE;
+	PoolIntArray::Read r = p_events.read();
+
+	locked = true;
+
+	for (int i = 0; i < count; i++) {
+
+		const int *event = &r[i * PhysicsServer::AREA_MONITOR_EVENT_SIZE];
+		_area_inout_event(event[PhysicsServer::AREA_MONITOR_EVENT_STATUS], event[PhysicsServer::AREA_MONITOR_EVENT_INSTANCE_ID], event[PhysicsServer::AREA_MONITOR_EVENT_BODY_SHAPE], event[PhysicsServer::AREA_MONITOR_EVENT_AREA_SHAPE]);
+	}
 
 	locked = false;
 }
@@ -680,6 +719,8 @@ void Area::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_body_inout"), &Area::_body_inout);
 	ClassDB::bind_method(D_METHOD("_area_inout"), &Area::_area_inout);
+	ClassDB::bind_method(D_METHOD("_body_inout_batch"), &Area::_body_inout_batch);
+	ClassDB::bind_method(D_METHOD("_area_inout_batch"), &Area::_area_inout_batch);
 
 	ClassDB::bind_method(D_METHOD("set_audio_bus_override", "enable"), &Area::set_audio_bus_override);
 	ClassDB::bind_method(D_METHOD("is_overriding_audio_bus"), &Area::is_overriding_audio_bus);
@@ -62,7 +62,9 @@ private:
 	bool monitorable;
 	bool locked;
 
+	void _body_inout_event(int p_status, ObjectID p_instance, int p_body_shape, int p_area_shape);
 	void _body_inout(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape);
+	void _body_inout_batch(const PoolIntArray &p_events);
 
 	void _body_enter_tree(ObjectID p_id);
 	void _body_exit_tree(ObjectID p_id);
@@ -94,7 +96,9 @@ private:
 
 	Map<ObjectID, BodyState> body_map;
 
+	void _area_inout_event(int p_status, ObjectID p_instance, int p_area_shape, int p_self_shape);
 	void _area_inout(int p_status, const RID &p_area, int p_instance, int p_area_shape, int p_self_shape);
+	void _area_inout_batch(const PoolIntArray &p_events);
 
 	void _area_enter_tree(ObjectID p_id);
 	void _area_exit_tree(ObjectID p_id);
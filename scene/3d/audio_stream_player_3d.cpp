@@ -30,9 +30,11 @@
 
 #include "audio_stream_player_3d.h"
 #include "engine.h"
+#include "project_settings.h"
 #include "scene/3d/area.h"
 #include "scene/3d/camera.h"
 #include "scene/main/viewport.h"
+#include "servers/audio/audio_mix.h"
 void AudioStreamPlayer3D::_mix_audio() {
 
 	if (!stream_playback.is_valid() || !active ||
@@ -56,21 +58,46 @@ void AudioStreamPlayer3D::_mix_audio() {
 		buffer_size = MIN(buffer_size, 128);
 	}
 
-	// Mix if we're not paused or we're fading out
-	if ((output_count > 0 || out_of_range_mode == OUT_OF_RANGE_MIX)) {
+	bool can_mix = output_count > 0 || out_of_range_mode == OUT_OF_RANGE_MIX;
 
-		float output_pitch_scale = 0.0;
-		if (output_count) {
-			//used for doppler, not realistic but good enough
-			for (int i = 0; i < output_count; i++) {
-				output_pitch_scale += outputs[i].pitch_scale;
-			}
-			output_pitch_scale /= float(output_count);
-		} else {
-			output_pitch_scale = 1.0;
+	if (voice_virtual && voice_virtualized) {
+		//over the voice budget, keep the position moving without producing any audio
+		if (can_mix) {
+			float mix_time = mix_buffer.size() / AudioServer::get_singleton()->get_mix_rate();
+			stream_playback->advance(mix_time * pitch_scale * _get_output_pitch_scale());
 		}
 
+		if (!stream_playback->is_playing()) {
+			active = false;
+		}
+
+		output_ready = false;
+		return;
+	}
+
+	if (voice_virtual) {
+		//going virtual, fade out like when pausing
+		voice_virtualized = true;
+		stream_paused_fade_out = true;
+		buffer_size = MIN(buffer_size, 128);
+	} else if (voice_virtualized) {
+		//back from virtual, fade in
+		voice_virtualized = false;
+		stream_paused_fade_in = true;
+	}
+
+	// Mix if we're not paused or we're fading out
+	if (can_mix) {
+
+		float output_pitch_scale = _get_output_pitch_scale();
+
 		stream_playback->mix(buffer, pitch_scale * output_pitch_scale, buffer_size);
+
+		if (voice_virtualized && buffer_size < mix_buffer.size()) {
+			//keep the rest of this step in time, so resuming continues from the right position
+			float rest_time = (mix_buffer.size() - buffer_size) / AudioServer::get_singleton()->get_mix_rate();
+			stream_playback->advance(rest_time * pitch_scale * output_pitch_scale);
+		}
 	}
 
 	//write all outputs
@@ -165,18 +192,11 @@ void AudioStreamPlayer3D::_mix_audio() {
 					AudioFrame rvol_inc = (current.reverb_vol[k] - prev_outputs[i].reverb_vol[k]) / float(buffer_size);
 					AudioFrame rvol = prev_outputs[i].reverb_vol[k];
 
-					for (int j = 0; j < buffer_size; j++) {
-
-						rtarget[j] += buffer[j] * rvol;
-						rvol += rvol_inc;
-					}
+					audio_mix_add_ramp(rtarget, buffer, buffer_size, rvol, rvol_inc);
 				} else {
 
 					AudioFrame rvol = current.reverb_vol[k];
-					for (int j = 0; j < buffer_size; j++) {
-
-						rtarget[j] += buffer[j] * rvol;
-					}
+					audio_mix_add_ramp(rtarget, buffer, buffer_size, rvol, AudioFrame(0, 0));
 				}
 			}
 		}
@@ -196,6 +216,21 @@ void AudioStreamPlayer3D::_mix_audio() {
 	stream_paused_fade_out = false;
 }
 
+float AudioStreamPlayer3D::_get_output_pitch_scale() const {
+
+	if (!output_count) {
+		return 1.0;
+	}
+
+	//used for doppler, not realistic but good enough
+	float output_pitch_scale = 0.0;
+	for (int i = 0; i < output_count; i++) {
+		output_pitch_scale += outputs[i].pitch_scale;
+	}
+
+	return output_pitch_scale / float(output_count);
+}
+
 float AudioStreamPlayer3D::_get_attenuation_db(float p_distance) const {
 
 	float att = 0;
@@ -234,6 +269,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 
 		velocity_tracker->reset(get_global_transform().origin);
 		AudioServer::get_singleton()->add_callback(_mix_audios, this);
+		voice_players.add(&voice_list);
 		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
 			play();
 		}
@@ -242,6 +278,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 
 		AudioServer::get_singleton()->remove_callback(_mix_audios, this);
+		voice_players.remove(&voice_list);
 	}
 
 	if (p_what == NOTIFICATION_PAUSED) {
@@ -279,6 +316,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 			ERR_FAIL_COND(world.is_null());
 
 			int new_output_count = 0;
+			float audibility = 0;
 
 			Vector3 global_pos = get_global_transform().origin;
 
@@ -419,6 +457,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 
 				for (int k = 0; k < cc; k++) {
 					output.vol[k] *= multiplier;
+					audibility = MAX(audibility, MAX(output.vol[k].l, output.vol[k].r));
 				}
 
 				bool filled_reverb = false;
@@ -547,6 +586,9 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 
 			output_count = new_output_count;
 			output_ready = true;
+
+			//voices that are already mixing get a bias, so voices close to the budget limit don't keep swapping
+			voice_score = voice_virtual ? audibility : audibility * 1.25;
 		}
 
 		//start playing if requested
@@ -923,6 +965,10 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_stream_paused", "pause"), &AudioStreamPlayer3D::set_stream_paused);
 	ClassDB::bind_method(D_METHOD("get_stream_paused"), &AudioStreamPlayer3D::get_stream_paused);
 
+	ClassDB::bind_method(D_METHOD("set_voice_priority", "priority"), &AudioStreamPlayer3D::set_voice_priority);
+	ClassDB::bind_method(D_METHOD("get_voice_priority"), &AudioStreamPlayer3D::get_voice_priority);
+	ClassDB::bind_method(D_METHOD("is_voice_virtual"), &AudioStreamPlayer3D::is_voice_virtual);
+
 	ClassDB::bind_method(D_METHOD("_bus_layout_changed"), &AudioStreamPlayer3D::_bus_layout_changed);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "stream", PROPERTY_HINT_RESOURCE_TYPE, "AudioStream"), "set_stream", "get_stream");
@@ -938,6 +984,7 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "out_of_range_mode", PROPERTY_HINT_ENUM, "Mix,Pause"), "set_out_of_range_mode", "get_out_of_range_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "bus", PROPERTY_HINT_ENUM, ""), "set_bus", "get_bus");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "area_mask", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_area_mask", "get_area_mask");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "voice_priority", PROPERTY_HINT_RANGE, "-128,128,1"), "set_voice_priority", "get_voice_priority");
 	ADD_GROUP("Emission Angle", "emission_angle");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "emission_angle_enabled"), "set_emission_angle_enabled", "is_emission_angle_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "emission_angle_degrees", PROPERTY_HINT_RANGE, "0.1,90,0.1"), "set_emission_angle", "get_emission_angle");
@@ -962,7 +1009,53 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("finished"));
 }
 
-AudioStreamPlayer3D::AudioStreamPlayer3D() {
+void AudioStreamPlayer3D::set_voice_priority(int p_priority) {
+
+	voice_priority = p_priority;
+}
+
+int AudioStreamPlayer3D::get_voice_priority() const {
+
+	return voice_priority;
+}
+
+bool AudioStreamPlayer3D::is_voice_virtual() const {
+
+	return voice_virtual;
+}
+
+void AudioStreamPlayer3D::update_voices() {
+
+	static Vector<AudioStreamPlayer3D *> playing;
+
+	int max_voices = GLOBAL_GET("audio/3d/max_voices");
+
+	playing.clear();
+
+	for (SelfList<AudioStreamPlayer3D> *E = voice_players.first(); E; E = E->next()) {
+
+		AudioStreamPlayer3D *player = E->self();
+		if (max_voices > 0 && (player->active || player->setplay >= 0)) {
+			playing.push_back(player);
+		} else {
+			player->voice_virtual = false;
+		}
+	}
+
+	if (playing.size() > max_voices) {
+		playing.sort_custom<VoiceSort>();
+	}
+
+	// everything beyond the budget stops mixing, but keeps its playback position moving
+	for (int i = 0; i < playing.size(); i++) {
+		playing[i]->voice_virtual = i >= max_voices;
+	}
+}
+
+SelfList<AudioStreamPlayer3D>::List AudioStreamPlayer3D::voice_players;
+
+AudioStreamPlayer3D::AudioStreamPlayer3D() :
+		voice_list(this) {
 
 	unit_db = 0;
 	unit_size = 1;
@@ -988,6 +1081,10 @@ AudioStreamPlayer3D::AudioStreamPlayer3D() {
 	stream_paused = false;
 	stream_paused_fade_in = false;
 	stream_paused_fade_out = false;
+	voice_priority = 0;
+	voice_score = 0;
+	voice_virtual = false;
+	voice_virtualized = false;
 
 	velocity_tracker.instance();
 	AudioServer::get_singleton()->connect("bus_layout_changed", this, "_bus_layout_changed");
@@ -139,6 +139,23 @@ private:
 
 	float _get_attenuation_db(float p_distance) const;
 
+	int voice_priority;
+	float voice_score; //audibility weighted for ranking, main thread only
+	volatile bool voice_virtual; //set by the voice manager, read by the audio thread
+	bool voice_virtualized; //audio thread only
+	SelfList<AudioStreamPlayer3D> voice_list;
+	static SelfList<AudioStreamPlayer3D>::List voice_players;
+
+	struct VoiceSort {
+		bool operator()(const AudioStreamPlayer3D *p_a, const AudioStreamPlayer3D *p_b) const {
+			if (p_a->voice_priority != p_b->voice_priority)
+				return p_a->voice_priority > p_b->voice_priority;
+			return p_a->voice_score > p_b->voice_score;
+		}
+	};
+
+	float _get_output_pitch_scale() const;
+
 protected:
 	void _validate_property(PropertyInfo &property) const;
 	void _notification(int p_what);
@@ -205,6 +222,13 @@ public:
 	void set_stream_paused(bool p_pause);
 	bool get_stream_paused() const;
 
+	void set_voice_priority(int p_priority);
+	int get_voice_priority() const;
+
+	bool is_voice_virtual() const;
+
+	static void update_voices();
+
 	AudioStreamPlayer3D();
 	~AudioStreamPlayer3D();
 };
@@ -1,5 +1,6 @@
 #include "cpu_particles.h"
 
+#include "core/engine.h"
 #include "particles.h"
 #include "scene/3d/camera.h"
 #include "scene/main/viewport.h"
@@ -18,6 +19,10 @@ PoolVector<Face3> CPUParticles::get_faces(uint32_t p_usage_flags) const {
 void CPUParticles::set_emitting(bool p_emitting) {
 
 	emitting = p_emitting;
+	if (Engine::get_singleton()->is_headless()) {
+		return; //purely visual, a headless server never simulates
+	}
+
 	if (!is_processing_internal()) {
 		set_process_internal(true);
 		if (is_inside_tree()) {
@@ -38,6 +43,8 @@ void CPUParticles::set_amount(int p_amount) {
 
 	ERR_FAIL_COND(p_amount < 1);
 
+	_wait_for_particle_data_buffer();
+
 	particles.resize(p_amount);
 	{
 		PoolVector<Particle>::Write w = particles.write();
@@ -174,6 +181,8 @@ String CPUParticles::get_configuration_warning() const {
 
 void CPUParticles::restart() {
 
+	_wait_for_particle_data_buffer();
+
 	time = 0;
 	inactive_time = 0;
 	frame_remainder = 0;
@@ -446,16 +455,27 @@ float rand_from_seed_m1_p1(uint32_t &seed) {
 	return rand_from_seed(seed) * 2.0 - 1.0;
 }
 
+static _FORCE_INLINE_ float _randf_from_seed(uint64_t *seed) {
+	return float(Math::rand_from_seed(seed)) / float(Math::RANDOM_MAX);
+}
+
 void CPUParticles::_particles_process(float p_delta) {
 
+	_wait_for_particle_data_buffer();
+
 	p_delta *= speed_scale;
 
 	int pcount = particles.size();
 	PoolVector<Particle>::Write w = particles.write();
 
-	Particle *parray = w.ptr();
+	ProcessBatch batch;
+	batch.particles = this;
+	batch.parray = w.ptr();
+	batch.count = pcount;
+	batch.delta = p_delta;
+	batch.prev_time = time;
+	batch.seed = Math::rand();
 
-	float prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
 		time = Math::fmod(time, lifetime);
@@ -465,14 +485,50 @@ void CPUParticles::_particles_process(float p_delta) {
 		}
 	}
 
-	Transform emission_xform;
-	Basis velocity_xform;
 	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform.basis.inverse().transposed();
+		batch.emission_xform = get_global_transform();
+		batch.velocity_xform = batch.emission_xform.basis.inverse().transposed();
+	}
+
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0); //sorts the points if needed, so batches only read them
+	}
+
+	int batch_count = (pcount + PROCESS_BATCH_SIZE - 1) / PROCESS_BATCH_SIZE;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && batch_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_particles_process_task, &batch, batch_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < batch_count; i++) {
+			_particles_process_batch(batch, i);
+		}
 	}
+}
+
+void CPUParticles::_particles_process_task(void *p_userdata, uint32_t p_index) {
+
+	ProcessBatch *batch = (ProcessBatch *)p_userdata;
+	batch->particles->_particles_process_batch(*batch, p_index);
+}
+
+void CPUParticles::_particles_process_batch(const ProcessBatch &p_batch, int p_index) {
+
+	Particle *parray = p_batch.parray;
+	int pcount = p_batch.count;
+	float delta = p_batch.delta;
+	float prev_time = p_batch.prev_time;
+	const Transform &emission_xform = p_batch.emission_xform;
+	const Basis &velocity_xform = p_batch.velocity_xform;
 
-	for (int i = 0; i < pcount; i++) {
+	int from = p_index * PROCESS_BATCH_SIZE;
+	int to = MIN(from + PROCESS_BATCH_SIZE, pcount);
+
+	//every batch draws from its own random sequence, so results don't depend on how batches are scheduled
+	uint64_t random_seed = p_batch.seed + uint64_t(p_index) * 0x9E3779B97F4A7C15ULL;
+
+	for (int i = from; i < to; i++) {
 
 		Particle &p = parray[i];
 
@@ -480,7 +536,7 @@ void CPUParticles::_particles_process(float p_delta) {
 			continue;
 
 		float restart_time = (float(i) / float(pcount)) * lifetime;
-		float local_delta = p_delta;
+		float local_delta = delta;
 
 		if (randomness_ratio > 0.0) {
 			uint32_t seed = cycle;
@@ -544,33 +600,33 @@ void CPUParticles::_particles_process(float p_delta) {
 				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(0);
 			}
 
-			p.seed = Math::rand();
+			p.seed = Math::rand_from_seed(&random_seed);
 
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
+			p.angle_rand = _randf_from_seed(&random_seed);
+			p.scale_rand = _randf_from_seed(&random_seed);
+			p.hue_rot_rand = _randf_from_seed(&random_seed);
+			p.anim_offset_rand = _randf_from_seed(&random_seed);
 
 			float angle1_rad;
 			float angle2_rad;
 
 			if (flags[FLAG_DISABLE_Z]) {
 
-				angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
+				angle1_rad = (_randf_from_seed(&random_seed) * 2.0 - 1.0) * Math_PI * spread / 180.0;
 				Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
-				p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+				p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(_randf_from_seed(&random_seed)), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 
 			} else {
 				//initiate velocity spread in 3D
-				angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
-				angle2_rad = (Math::randf() * 2.0 - 1.0) * (1.0 - flatness) * Math_PI * spread / 180.0;
+				angle1_rad = (_randf_from_seed(&random_seed) * 2.0 - 1.0) * Math_PI * spread / 180.0;
+				angle2_rad = (_randf_from_seed(&random_seed) * 2.0 - 1.0) * (1.0 - flatness) * Math_PI * spread / 180.0;
 
 				Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
 				Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
 				direction_yz.z = direction_yz.z / Math::sqrt(direction_yz.z); //better uniform distribution
 				Vector3 direction = Vector3(direction_xz.x * direction_yz.z, direction_yz.y, direction_xz.z * direction_yz.z);
 				direction.normalize();
-				p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+				p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(_randf_from_seed(&random_seed)), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 			}
 
 			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
@@ -586,10 +642,10 @@ void CPUParticles::_particles_process(float p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * emission_sphere_radius;
+					p.transform.origin = Vector3(_randf_from_seed(&random_seed) * 2.0 - 1.0, _randf_from_seed(&random_seed) * 2.0 - 1.0, _randf_from_seed(&random_seed) * 2.0 - 1.0).normalized() * emission_sphere_radius;
 				} break;
 				case EMISSION_SHAPE_BOX: {
-					p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_box_extents;
+					p.transform.origin = Vector3(_randf_from_seed(&random_seed) * 2.0 - 1.0, _randf_from_seed(&random_seed) * 2.0 - 1.0, _randf_from_seed(&random_seed) * 2.0 - 1.0) * emission_box_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -598,7 +654,7 @@ void CPUParticles::_particles_process(float p_delta) {
 					if (pc == 0)
 						break;
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = Math::rand_from_seed(&random_seed) % pc;
 
 					p.transform.origin = emission_points.get(random_idx);
 
@@ -863,6 +919,52 @@ void CPUParticles::_particles_process(float p_delta) {
 }
 
 void CPUParticles::_update_particle_data_buffer() {
+
+	_wait_for_particle_data_buffer();
+
+	// anything that needs the scene is resolved here, sorting and filling the buffer
+	// then happen in the thread pool until the buffer is sent before drawing
+	buffer_un_transform = Transform();
+	if (!local_coords) {
+		buffer_un_transform = get_global_transform().affine_inverse();
+	}
+
+	buffer_sort_by_axis = false;
+	if (draw_order == DRAW_ORDER_VIEW_DEPTH) {
+		Camera *c = get_viewport()->get_camera();
+		if (c) {
+			buffer_sort_axis = c->get_global_transform().basis.get_axis(2); //far away to close
+
+			if (local_coords) {
+				buffer_sort_axis = buffer_un_transform.basis.xform(buffer_sort_axis).normalized();
+			}
+			buffer_sort_by_axis = true;
+		}
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		buffer_update_task = pool->add_task(_update_particle_data_buffer_task, this, WorkerThreadPool::PRIORITY_HIGH);
+	} else {
+		_fill_particle_data_buffer();
+	}
+}
+
+void CPUParticles::_update_particle_data_buffer_task(void *p_userdata, uint32_t p_index) {
+
+	CPUParticles *self = (CPUParticles *)p_userdata;
+	self->_fill_particle_data_buffer();
+}
+
+void CPUParticles::_wait_for_particle_data_buffer() {
+
+	if (buffer_update_task != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(buffer_update_task);
+		buffer_update_task = WorkerThreadPool::INVALID_GROUP_ID;
+	}
+}
+
+void CPUParticles::_fill_particle_data_buffer() {
 #ifndef NO_THREADS
 	update_mutex->lock();
 #endif
@@ -878,10 +980,7 @@ void CPUParticles::_update_particle_data_buffer() {
 		PoolVector<Particle>::Read r = particles.read();
 		float *ptr = w.ptr();
 
-		Transform un_transform;
-		if (!local_coords) {
-			un_transform = get_global_transform().affine_inverse();
-		}
+		const Transform &un_transform = buffer_un_transform;
 
 		if (draw_order != DRAW_ORDER_INDEX) {
 			ow = particle_order.write();
@@ -894,20 +993,11 @@ void CPUParticles::_update_particle_data_buffer() {
 				SortArray<int, SortLifetime> sorter;
 				sorter.compare.particles = r.ptr();
 				sorter.sort(order, pc);
-			} else if (draw_order == DRAW_ORDER_VIEW_DEPTH) {
-				Camera *c = get_viewport()->get_camera();
-				if (c) {
-					Vector3 dir = c->get_global_transform().basis.get_axis(2); //far away to close
-
-					if (local_coords) {
-						dir = un_transform.basis.xform(dir).normalized();
-					}
-
-					SortArray<int, SortAxis> sorter;
-					sorter.compare.particles = r.ptr();
-					sorter.compare.axis = dir;
-					sorter.sort(order, pc);
-				}
+			} else if (buffer_sort_by_axis) {
+				SortArray<int, SortAxis> sorter;
+				sorter.compare.particles = r.ptr();
+				sorter.compare.axis = buffer_sort_axis;
+				sorter.sort(order, pc);
 			}
 		}
 
@@ -963,6 +1053,8 @@ void CPUParticles::_update_particle_data_buffer() {
 
 void CPUParticles::_update_render_thread() {
 
+	_wait_for_particle_data_buffer();
+
 #ifndef NO_THREADS
 	update_mutex->lock();
 #endif
@@ -1352,6 +1444,9 @@ void CPUParticles::_bind_methods() {
 
 CPUParticles::CPUParticles() {
 
+	buffer_update_task = WorkerThreadPool::INVALID_GROUP_ID;
+	buffer_sort_by_axis = false;
+
 	time = 0;
 	inactive_time = 0;
 	frame_remainder = 0;
@@ -1409,6 +1504,7 @@ CPUParticles::CPUParticles() {
 }
 
 CPUParticles::~CPUParticles() {
+	_wait_for_particle_data_buffer();
 	VS::get_singleton()->free(multimesh);
 
 #ifndef NO_THREADS
@@ -1,5 +1,6 @@
 #ifndef CPU_PARTICLES_H
 #define CPU_PARTICLES_H
+#include "os/worker_thread_pool.h"
 #include "rid.h"
 #include "scene/3d/visual_instance.h"
 #include "scene/main/timer.h"
@@ -142,8 +143,40 @@ private:
 	bool anim_loop;
 	Vector3 gravity;
 
+	// Particles are simulated in batches on the thread pool. Each batch
+	// uses its own random sequence, seeded from the main thread.
+
+	enum {
+		PROCESS_BATCH_SIZE = 256
+	};
+
+	struct ProcessBatch {
+		CPUParticles *particles;
+		Particle *parray;
+		int count;
+		float delta;
+		float prev_time;
+		uint64_t seed;
+		Transform emission_xform;
+		Basis velocity_xform;
+	};
+
+	// Sorting and filling the buffer run as a pool task in the background,
+	// it must be waited for before touching the particles again.
+
+	WorkerThreadPool::GroupID buffer_update_task;
+	Transform buffer_un_transform;
+	Vector3 buffer_sort_axis;
+	bool buffer_sort_by_axis;
+
 	void _particles_process(float p_delta);
+	static void _particles_process_task(void *p_userdata, uint32_t p_index);
+	void _particles_process_batch(const ProcessBatch &p_batch, int p_index);
+
 	void _update_particle_data_buffer();
+	static void _update_particle_data_buffer_task(void *p_userdata, uint32_t p_index);
+	void _wait_for_particle_data_buffer();
+	void _fill_particle_data_buffer();
 
 	Mutex *update_mutex;
 
@@ -138,6 +138,10 @@ void MeshInstance::set_mesh(const Ref<Mesh> &p_mesh) {
 		set_base(RID());
 	}
 
+	if (is_used_as_occluder()) {
+		_update_occluder();
+	}
+
 	_change_notify();
 }
 Ref<Mesh> MeshInstance::get_mesh() const {
@@ -275,6 +279,10 @@ Ref<Material> MeshInstance::get_surface_material(int p_surface) const {
 void MeshInstance::_mesh_changed() {
 
 	materials.resize(mesh->get_surface_count());
+
+	if (is_used_as_occluder()) {
+		_update_occluder();
+	}
 }
 
 void MeshInstance::create_debug_tangents() {
@@ -30,9 +30,14 @@
 
 #include "navigation.h"
 
+#include "sort.h"
+
 void Navigation::_navmesh_link(int p_id) {
 
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
+
+	MutexLock lock(navigation_mutex);
+
 	NavMesh &nm = navmesh_map[p_id];
 	ERR_FAIL_COND(nm.linked);
 	ERR_FAIL_COND(nm.navmesh.is_null());
@@ -96,6 +101,13 @@ void Navigation::_navmesh_link(int p_id) {
 			p.center /= plen;
 		}
 
+		if (free_polygon_slots.size()) {
+			p.slot = free_polygon_slots[free_polygon_slots.size() - 1];
+			free_polygon_slots.resize(free_polygon_slots.size() - 1);
+		} else {
+			p.slot = polygon_slot_count++;
+		}
+
 		//connect
 
 		for (int j = 0; j < plen; j++) {
@@ -136,6 +148,19 @@ void Navigation::_navmesh_link(int p_id) {
 	}
 
 	nm.linked = true;
+
+	if (path_caches.size()) {
+		// Only paths through the navmeshes this one got connected to can change.
+		Set<const NavMesh *> affected;
+		for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
+			const Polygon &p = E->get();
+			for (int i = 0; i < p.edges.size(); i++) {
+				if (p.edges[i].C)
+					affected.insert(p.edges[i].C->owner);
+			}
+		}
+		_path_cache_invalidate(affected);
+	}
 }
 
 void Navigation::_navmesh_unlink(int p_id) {
@@ -144,9 +169,16 @@ void Navigation::_navmesh_unlink(int p_id) {
 	NavMesh &nm = navmesh_map[p_id];
 	ERR_FAIL_COND(!nm.linked);
 
+	if (path_caches.size()) {
+		Set<const NavMesh *> affected;
+		affected.insert(&nm);
+		_path_cache_invalidate(affected);
+	}
+
 	for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
 
 		Polygon &p = E->get();
+		free_polygon_slots.push_back(p.slot);
 
 		int ec = p.edges.size();
 		Polygon::Edge *edges = p.edges.ptrw();
@@ -206,6 +238,8 @@ void Navigation::_navmesh_unlink(int p_id) {
 
 int Navigation::navmesh_add(const Ref<NavigationMesh> &p_mesh, const Transform &p_xform, Object *p_owner) {
 
+	MutexLock lock(navigation_mutex);
+
 	int id = last_id++;
 	NavMesh nm;
 	nm.linked = false;
@@ -232,6 +266,9 @@ void Navigation::navmesh_set_transform(int p_id, const Transform &p_xform) {
 void Navigation::navmesh_remove(int p_id) {
 
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
+
+	MutexLock lock(navigation_mutex);
+
 	_navmesh_unlink(p_id);
 	navmesh_map.erase(p_id);
 }
@@ -270,61 +307,7 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 	}
 }
 
-Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
-
-	Polygon *begin_poly = NULL;
-	Polygon *end_poly = NULL;
-	Vector3 begin_point;
-	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 spoint = f.get_closest_point_to(p_start);
-				float dpoint = spoint.distance_to(p_start);
-				if (dpoint < begin_d) {
-					begin_d = dpoint;
-					begin_poly = &p;
-					begin_point = spoint;
-				}
-
-				spoint = f.get_closest_point_to(p_end);
-				dpoint = spoint.distance_to(p_end);
-				if (dpoint < end_d) {
-					end_d = dpoint;
-					end_poly = &p;
-					end_point = spoint;
-				}
-			}
-
-			p.prev_edge = -1;
-		}
-	}
-
-	if (!begin_poly || !end_poly) {
-
-		//print_line("No Path Path");
-		return Vector<Vector3>(); //no path
-	}
-
-	if (begin_poly == end_poly) {
-
-		Vector<Vector3> path;
-		path.resize(2);
-		path.write[0] = begin_point;
-		path.write[1] = end_point;
-		//print_line("Direct Path");
-		return path;
-	}
+bool Navigation::_search_path(Polygon *begin_poly, Polygon *end_poly, const Vector3 &end_point) {
 
 	bool found_route = false;
 
@@ -411,6 +394,208 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		open_list.erase(least_cost_poly);
 	}
 
+	return found_route;
+}
+
+Navigation::PathCache *Navigation::_get_path_cache(Polygon *p_goal) {
+
+	path_cache_tick++;
+
+	Map<Polygon *, PathCache>::Element *E = path_caches.find(p_goal);
+	if (E) {
+		E->get().last_used = path_cache_tick;
+		return &E->get();
+	}
+
+	while (path_caches.size() >= path_cache_size) {
+		//evict the least recently used
+		Map<Polygon *, PathCache>::Element *oldest = path_caches.front();
+		for (Map<Polygon *, PathCache>::Element *F = oldest->next(); F; F = F->next()) {
+			if (F->get().last_used < oldest->get().last_used)
+				oldest = F;
+		}
+		path_caches.erase(oldest);
+	}
+
+	PathCache &cache = path_caches[p_goal];
+	cache.last_used = path_cache_tick;
+
+	// Search the whole region around the goal at once, so every polygon in it
+	// knows which of its edges leads towards the goal.
+
+	struct OpenPoly {
+		float distance;
+		Polygon *poly;
+	};
+
+	struct OpenPolyComparator {
+		_FORCE_INLINE_ bool operator()(const OpenPoly &A, const OpenPoly &B) const { return A.distance > B.distance; }
+	};
+
+	SortArray<OpenPoly, OpenPolyComparator> sorter;
+	Vector<OpenPoly> open_list;
+	int open_count = 0;
+
+	Vector<float> distance;
+	distance.resize(polygon_slot_count);
+	cache.next_edge.resize(polygon_slot_count);
+	for (int i = 0; i < polygon_slot_count; i++) {
+		distance.write[i] = 1e30;
+		cache.next_edge.write[i] = -1;
+	}
+
+	float *dist_w = distance.ptrw();
+	int *next_w = cache.next_edge.ptrw();
+
+	dist_w[p_goal->slot] = 0;
+	next_w[p_goal->slot] = -2; //goal
+
+	OpenPoly op;
+	op.distance = 0;
+	op.poly = p_goal;
+	open_list.push_back(op);
+	open_count = 1;
+
+	while (open_count) {
+
+		OpenPoly current = open_list[0];
+		sorter.pop_heap(0, open_count, open_list.ptrw());
+		open_count--;
+
+		Polygon *p = current.poly;
+		if (current.distance > dist_w[p->slot])
+			continue; //stale entry
+
+		cache.navmeshes.insert(p->owner);
+
+		for (int i = 0; i < p->edges.size(); i++) {
+
+			const Polygon::Edge &e = p->edges[i];
+			if (!e.C)
+				continue;
+
+			float d = current.distance + p->center.distance_to(e.C->center);
+			if (d >= dist_w[e.C->slot])
+				continue;
+
+			dist_w[e.C->slot] = d;
+			next_w[e.C->slot] = e.C_edge;
+
+			op.distance = d;
+			op.poly = e.C;
+			if (open_count == open_list.size())
+				open_list.push_back(op);
+			sorter.push_heap(0, open_count, 0, op, open_list.ptrw());
+			open_count++;
+		}
+	}
+
+	return &cache;
+}
+
+bool Navigation::_search_path_cached(Polygon *begin_poly, Polygon *end_poly) {
+
+	PathCache *cache = _get_path_cache(end_poly);
+
+	// Walk towards the goal, leaving prev_edge set like the regular search does.
+	Polygon *p = begin_poly;
+	int steps = 0;
+	while (p != end_poly) {
+
+		if (p->slot >= cache->next_edge.size())
+			return false; //linked after the cache was built, can't reach the goal
+
+		int edge = cache->next_edge[p->slot];
+		if (edge < 0)
+			return false;
+
+		Polygon *next = p->edges[edge].C;
+		ERR_FAIL_COND_V(!next, false);
+		ERR_FAIL_COND_V(++steps > polygon_slot_count, false);
+
+		next->prev_edge = p->edges[edge].C_edge;
+		p = next;
+	}
+
+	return true;
+}
+
+void Navigation::_path_cache_invalidate(const Set<const NavMesh *> &p_navmeshes) {
+
+	Map<Polygon *, PathCache>::Element *E = path_caches.front();
+	while (E) {
+
+		Map<Polygon *, PathCache>::Element *N = E->next();
+
+		for (Set<const NavMesh *>::Element *F = p_navmeshes.front(); F; F = F->next()) {
+			if (E->get().navmeshes.has(F->get())) {
+				path_caches.erase(E);
+				break;
+			}
+		}
+
+		E = N;
+	}
+}
+
+Vector<Vector3> Navigation::_get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	Polygon *begin_poly = NULL;
+	Polygon *end_poly = NULL;
+	Vector3 begin_point;
+	Vector3 end_point;
+	float begin_d = 1e20;
+	float end_d = 1e20;
+
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+
+		if (!E->get().linked)
+			continue;
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+
+			Polygon &p = F->get();
+			for (int i = 2; i < p.edges.size(); i++) {
+
+				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
+				Vector3 spoint = f.get_closest_point_to(p_start);
+				float dpoint = spoint.distance_to(p_start);
+				if (dpoint < begin_d) {
+					begin_d = dpoint;
+					begin_poly = &p;
+					begin_point = spoint;
+				}
+
+				spoint = f.get_closest_point_to(p_end);
+				dpoint = spoint.distance_to(p_end);
+				if (dpoint < end_d) {
+					end_d = dpoint;
+					end_poly = &p;
+					end_point = spoint;
+				}
+			}
+
+			p.prev_edge = -1;
+		}
+	}
+
+	if (!begin_poly || !end_poly) {
+
+		//print_line("No Path Path");
+		return Vector<Vector3>(); //no path
+	}
+
+	if (begin_poly == end_poly) {
+
+		Vector<Vector3> path;
+		path.resize(2);
+		path.write[0] = begin_point;
+		path.write[1] = end_point;
+		//print_line("Direct Path");
+		return path;
+	}
+
+	bool found_route = path_cache_size > 0 ? _search_path_cached(begin_poly, end_poly) : _search_path(begin_poly, end_poly, end_point);
+
 	if (found_route) {
 
 		Vector<Vector3> path;
@@ -527,6 +712,89 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 	return Vector<Vector3>();
 }
 
+Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	MutexLock lock(navigation_mutex);
+
+	return _get_simple_path(p_start, p_end, p_optimize);
+}
+
+void Navigation::_solve_queries(void *p_userdata, uint32_t p_index) {
+
+	Navigation *nav = (Navigation *)p_userdata;
+
+	PathQuery *queries = nav->running_queries.ptrw();
+	for (int i = 0; i < nav->running_queries.size(); i++) {
+		queries[i].path = nav->get_simple_path(queries[i].from, queries[i].to, queries[i].optimize);
+	}
+}
+
+void Navigation::_start_queries() {
+
+	running_queries = pending_queries;
+	pending_queries.clear();
+
+	// Searches write to the polygons, so a batch is solved in order on a single
+	// worker. Batches of different Navigation nodes run in parallel.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		query_task = pool->add_task(_solve_queries, this, WorkerThreadPool::PRIORITY_LOW);
+	} else {
+		_solve_queries(this, 0);
+		_finish_queries();
+	}
+}
+
+void Navigation::_finish_queries() {
+
+	if (query_task != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(query_task);
+		query_task = WorkerThreadPool::INVALID_GROUP_ID;
+	}
+
+	Vector<PathQuery> finished = running_queries;
+	running_queries.clear();
+
+	// Results nobody claimed are only kept until the next batch completes.
+	query_results.clear();
+	for (int i = 0; i < finished.size(); i++) {
+		query_results[finished[i].id] = finished[i].path;
+	}
+
+	for (int i = 0; i < finished.size(); i++) {
+		emit_signal("path_query_completed", finished[i].id, finished[i].path);
+	}
+}
+
+int Navigation::queue_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	PathQuery query;
+	query.id = last_query_id++;
+	query.from = p_start;
+	query.to = p_end;
+	query.optimize = p_optimize;
+	pending_queries.push_back(query);
+
+	set_process_internal(true);
+
+	return query.id;
+}
+
+bool Navigation::is_path_query_completed(int p_id) const {
+
+	return query_results.has(p_id);
+}
+
+Vector<Vector3> Navigation::get_path_query_result(int p_id) {
+
+	Map<int, Vector<Vector3> >::Element *E = query_results.find(p_id);
+	ERR_FAIL_COND_V(!E, Vector<Vector3>());
+
+	Vector<Vector3> path = E->get();
+	query_results.erase(E);
+	return path;
+}
+
 Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision) {
 
 	bool use_collision = p_use_collision;
@@ -676,8 +944,33 @@ Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
 	return owner;
 }
 
+void Navigation::set_path_cache_size(int p_size) {
+
+	ERR_FAIL_COND(p_size < 0);
+
+	MutexLock lock(navigation_mutex);
+
+	path_cache_size = p_size;
+
+	while (path_caches.size() > path_cache_size) {
+		Map<Polygon *, PathCache>::Element *oldest = path_caches.front();
+		for (Map<Polygon *, PathCache>::Element *F = oldest->next(); F; F = F->next()) {
+			if (F->get().last_used < oldest->get().last_used)
+				oldest = F;
+		}
+		path_caches.erase(oldest);
+	}
+}
+
+int Navigation::get_path_cache_size() const {
+
+	return path_cache_size;
+}
+
 void Navigation::set_up_vector(const Vector3 &p_up) {
 
+	MutexLock lock(navigation_mutex);
+
 	up = p_up;
 }
 
@@ -686,6 +979,27 @@ Vector3 Navigation::get_up_vector() const {
 	return up;
 }
 
+void Navigation::_notification(int p_what) {
+
+	switch (p_what) {
+
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			if (query_task != WorkerThreadPool::INVALID_GROUP_ID && WorkerThreadPool::get_singleton()->is_group_task_completed(query_task)) {
+				_finish_queries();
+			}
+
+			if (query_task == WorkerThreadPool::INVALID_GROUP_ID) {
+				if (pending_queries.size()) {
+					_start_queries();
+				} else {
+					set_process_internal(false);
+				}
+			}
+		} break;
+	}
+}
+
 void Navigation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("navmesh_add", "mesh", "xform", "owner"), &Navigation::navmesh_add, DEFVAL(Variant()));
@@ -693,6 +1007,9 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navmesh_remove", "id"), &Navigation::navmesh_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("queue_simple_path", "start", "end", "optimize"), &Navigation::queue_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_path_query_completed", "id"), &Navigation::is_path_query_completed);
+	ClassDB::bind_method(D_METHOD("get_path_query_result", "id"), &Navigation::get_path_query_result);
 	ClassDB::bind_method(D_METHOD("get_closest_point_to_segment", "start", "end", "use_collision"), &Navigation::get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_normal", "to_point"), &Navigation::get_closest_point_normal);
@@ -701,7 +1018,13 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_up_vector", "up"), &Navigation::set_up_vector);
 	ClassDB::bind_method(D_METHOD("get_up_vector"), &Navigation::get_up_vector);
 
+	ClassDB::bind_method(D_METHOD("set_path_cache_size", "size"), &Navigation::set_path_cache_size);
+	ClassDB::bind_method(D_METHOD("get_path_cache_size"), &Navigation::get_path_cache_size);
+
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "up_vector"), "set_up_vector", "get_up_vector");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "path_cache_size", PROPERTY_HINT_RANGE, "0,256,1"), "set_path_cache_size", "get_path_cache_size");
+
+	ADD_SIGNAL(MethodInfo("path_query_completed", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::POOL_VECTOR3_ARRAY, "path")));
 }
 
 Navigation::Navigation() {
@@ -710,4 +1033,20 @@ Navigation::Navigation() {
 	cell_size = 0.01; //one centimeter
 	last_id = 1;
 	up = Vector3(0, 1, 0);
+	polygon_slot_count = 0;
+	path_cache_size = 0;
+	path_cache_tick = 0;
+	navigation_mutex = Mutex::create();
+	query_task = WorkerThreadPool::INVALID_GROUP_ID;
+	last_query_id = 1;
+}
+
+Navigation::~Navigation() {
+
+	if (query_task != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(query_task);
+	}
+
+	if (navigation_mutex)
+		memdelete(navigation_mutex);
 }
@@ -31,6 +31,8 @@
 #ifndef NAVIGATION_H
 #define NAVIGATION_H
 
+#include "os/mutex.h"
+#include "os/worker_thread_pool.h"
 #include "scene/3d/navigation_mesh.h"
 #include "scene/3d/spatial.h"
 
@@ -100,6 +102,7 @@ class Navigation : public Spatial {
 		bool clockwise;
 
 		NavMesh *owner;
+		int slot; // index in PathCache::next_edge
 	};
 
 	struct Connection {
@@ -149,9 +152,29 @@ class Navigation : public Spatial {
 		return Vector3(p_point.x, p_point.y, p_point.z) * cell_size;
 	}
 
+	// Per goal polygon, the edge every reachable polygon should leave through to get there.
+	struct PathCache {
+
+		Vector<int> next_edge; // by polygon slot, -1 if unreachable
+		Set<const NavMesh *> navmeshes; // navmeshes the search went through
+		uint64_t last_used;
+	};
+
+	Map<Polygon *, PathCache> path_caches;
+	int path_cache_size;
+	uint64_t path_cache_tick;
+
+	int polygon_slot_count;
+	Vector<int> free_polygon_slots;
+
 	void _navmesh_link(int p_id);
 	void _navmesh_unlink(int p_id);
 
+	PathCache *_get_path_cache(Polygon *p_goal);
+	void _path_cache_invalidate(const Set<const NavMesh *> &p_navmeshes);
+	bool _search_path(Polygon *begin_poly, Polygon *end_poly, const Vector3 &end_point);
+	bool _search_path_cached(Polygon *begin_poly, Polygon *end_poly);
+
 	float cell_size;
 	Map<int, NavMesh> navmesh_map;
 	int last_id;
@@ -159,25 +182,59 @@ class Navigation : public Spatial {
 	Vector3 up;
 	void _clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly);
 
+	struct PathQuery {
+
+		int id;
+		Vector3 from;
+		Vector3 to;
+		bool optimize;
+		Vector<Vector3> path;
+	};
+
+	// Held while searching, queued queries are solved on a worker thread.
+	Mutex *navigation_mutex;
+
+	Vector<PathQuery> pending_queries;
+	Vector<PathQuery> running_queries;
+	WorkerThreadPool::GroupID query_task;
+	Map<int, Vector<Vector3> > query_results;
+	int last_query_id;
+
+	static void _solve_queries(void *p_userdata, uint32_t p_index);
+	void _start_queries();
+	void _finish_queries();
+
+	Vector<Vector3> _get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize);
+
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
 	void set_up_vector(const Vector3 &p_up);
 	Vector3 get_up_vector() const;
 
+	void set_path_cache_size(int p_size);
+	int get_path_cache_size() const;
+
 	//API should be as dynamic as possible
 	int navmesh_add(const Ref<NavigationMesh> &p_mesh, const Transform &p_xform, Object *p_owner = NULL);
 	void navmesh_set_transform(int p_id, const Transform &p_xform);
 	void navmesh_remove(int p_id);
 
 	Vector<Vector3> get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize = true);
+
+	int queue_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize = true);
+	bool is_path_query_completed(int p_id) const;
+	Vector<Vector3> get_path_query_result(int p_id);
+
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision = false);
 	Vector3 get_closest_point(const Vector3 &p_point);
 	Vector3 get_closest_point_normal(const Vector3 &p_point);
 	Object *get_closest_point_owner(const Vector3 &p_point);
 
 	Navigation();
+	~Navigation();
 };
 
 #endif // NAVIGATION_H
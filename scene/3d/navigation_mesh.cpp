@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "navigation_mesh.h"
+#include "core_string_names.h"
 #include "mesh_instance.h"
 #include "navigation.h"
 
@@ -177,6 +178,14 @@ float NavigationMesh::get_detail_sample_max_error() const {
 	return detail_sample_max_error;
 }
 
+void NavigationMesh::set_tile_size(int p_value) {
+	tile_size = MAX(p_value, 0);
+}
+
+int NavigationMesh::get_tile_size() const {
+	return tile_size;
+}
+
 void NavigationMesh::set_filter_low_hanging_obstacles(bool p_value) {
 	filter_low_hanging_obstacles = p_value;
 }
@@ -204,6 +213,7 @@ bool NavigationMesh::get_filter_walkable_low_height_spans() const {
 void NavigationMesh::set_vertices(const PoolVector<Vector3> &p_vertices) {
 
 	vertices = p_vertices;
+	debug_mesh = Ref<ArrayMesh>();
 }
 
 PoolVector<Vector3> NavigationMesh::get_vertices() const {
@@ -248,6 +258,7 @@ Vector<int> NavigationMesh::get_polygon(int p_idx) {
 void NavigationMesh::clear_polygons() {
 
 	polygons.clear();
+	debug_mesh = Ref<ArrayMesh>();
 }
 
 Ref<Mesh> NavigationMesh::get_debug_mesh() {
@@ -379,6 +390,9 @@ void NavigationMesh::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_detail_sample_max_error", "detail_sample_max_error"), &NavigationMesh::set_detail_sample_max_error);
 	ClassDB::bind_method(D_METHOD("get_detail_sample_max_error"), &NavigationMesh::get_detail_sample_max_error);
 
+	ClassDB::bind_method(D_METHOD("set_tile_size", "tile_size"), &NavigationMesh::set_tile_size);
+	ClassDB::bind_method(D_METHOD("get_tile_size"), &NavigationMesh::get_tile_size);
+
 	ClassDB::bind_method(D_METHOD("set_filter_low_hanging_obstacles", "filter_low_hanging_obstacles"), &NavigationMesh::set_filter_low_hanging_obstacles);
 	ClassDB::bind_method(D_METHOD("get_filter_low_hanging_obstacles"), &NavigationMesh::get_filter_low_hanging_obstacles);
 
@@ -423,6 +437,7 @@ void NavigationMesh::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "polygon/verts_per_poly", PROPERTY_HINT_RANGE, "3.0,12.0,1.0"), "set_verts_per_poly", "get_verts_per_poly");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "detail/sample_distance", PROPERTY_HINT_RANGE, "0.0,16.0,0.01"), "set_detail_sample_distance", "get_detail_sample_distance");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "detail/sample_max_error", PROPERTY_HINT_RANGE, "0.0,16.0,0.01"), "set_detail_sample_max_error", "get_detail_sample_max_error");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tile/size", PROPERTY_HINT_RANGE, "0,1024,1"), "set_tile_size", "get_tile_size");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "filter/low_hanging_obstacles"), "set_filter_low_hanging_obstacles", "get_filter_low_hanging_obstacles");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "filter/ledge_spans"), "set_filter_ledge_spans", "get_filter_ledge_spans");
@@ -443,6 +458,7 @@ NavigationMesh::NavigationMesh() {
 	verts_per_poly = 6.0f;
 	detail_sample_distance = 6.0f;
 	detail_sample_max_error = 1.0f;
+	tile_size = 0;
 
 	partition_type = SAMPLE_PARTITION_WATERSHED;
 
@@ -557,6 +573,21 @@ void NavigationMeshInstance::_notification(int p_what) {
 	}
 }
 
+void NavigationMeshInstance::_navmesh_changed() {
+
+	// the polygons were rebaked in place, Navigation keeps its own copy of them
+	if (navigation && nav_id != -1) {
+		navigation->navmesh_remove(nav_id);
+		nav_id = navigation->navmesh_add(navmesh, get_relative_transform(navigation), this);
+	}
+
+	if (debug_view) {
+		Object::cast_to<MeshInstance>(debug_view)->set_mesh(navmesh->get_debug_mesh());
+	}
+
+	update_gizmo();
+}
+
 void NavigationMeshInstance::set_navigation_mesh(const Ref<NavigationMesh> &p_navmesh) {
 
 	if (p_navmesh == navmesh)
@@ -566,7 +597,13 @@ void NavigationMeshInstance::set_navigation_mesh(const Ref<NavigationMesh> &p_na
 		navigation->navmesh_remove(nav_id);
 		nav_id = -1;
 	}
+	if (navmesh.is_valid()) {
+		navmesh->disconnect(CoreStringNames::get_singleton()->changed, this, "_navmesh_changed");
+	}
 	navmesh = p_navmesh;
+	if (navmesh.is_valid()) {
+		navmesh->connect(CoreStringNames::get_singleton()->changed, this, "_navmesh_changed");
+	}
 
 	if (navigation && navmesh.is_valid() && enabled) {
 		nav_id = navigation->navmesh_add(navmesh, get_relative_transform(navigation), this);
@@ -613,6 +650,8 @@ void NavigationMeshInstance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_enabled", "enabled"), &NavigationMeshInstance::set_enabled);
 	ClassDB::bind_method(D_METHOD("is_enabled"), &NavigationMeshInstance::is_enabled);
 
+	ClassDB::bind_method(D_METHOD("_navmesh_changed"), &NavigationMeshInstance::_navmesh_changed);
+
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "navmesh", PROPERTY_HINT_RESOURCE_TYPE, "NavigationMesh"), "set_navigation_mesh", "get_navigation_mesh");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "enabled"), "set_enabled", "is_enabled");
 }
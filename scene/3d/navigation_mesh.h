@@ -83,6 +83,7 @@ protected:
 	float verts_per_poly;
 	float detail_sample_distance;
 	float detail_sample_max_error;
+	int tile_size;
 
 	SamplePartitionType partition_type;
 
@@ -134,6 +135,9 @@ public:
 	void set_detail_sample_max_error(float p_value);
 	float get_detail_sample_max_error() const;
 
+	void set_tile_size(int p_value);
+	int get_tile_size() const;
+
 	void set_filter_low_hanging_obstacles(bool p_value);
 	bool get_filter_low_hanging_obstacles() const;
 
@@ -171,6 +175,8 @@ class NavigationMeshInstance : public Spatial {
 
 	Node *debug_view;
 
+	void _navmesh_changed();
+
 protected:
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -32,6 +32,7 @@
 
 #include "message_queue.h"
 
+#include "core/os/worker_thread_pool.h"
 #include "core/project_settings.h"
 #include "scene/3d/physics_body.h"
 #include "scene/resources/surface_tool.h"
@@ -214,126 +215,231 @@ void Skeleton::_notification(int p_what) {
 				break; //will be eventually updated
 
 			//if moved, just update transforms
-			VisualServer *vs = VisualServer::get_singleton();
-			const Bone *bonesptr = bones.ptr();
-			int len = bones.size();
-			Transform global_transform = get_global_transform();
-			Transform global_transform_inverse = global_transform.affine_inverse();
+			_pack_bone_transforms(get_global_transform());
+			VisualServer::get_singleton()->skeleton_set_bone_transforms(skeleton, bone_transforms);
+		} break;
+		case NOTIFICATION_UPDATE_SKELETON: {
 
-			for (int i = 0; i < len; i++) {
+			if (!dirty)
+				break; //already updated along with other queued skeletons
 
-				const Bone &b = bonesptr[i];
-				vs->skeleton_bone_set_transform(skeleton, i, global_transform * (b.transform_final * global_transform_inverse));
+			if (update_list.in_list()) {
+				_update_queued_skeletons();
+			} else {
+				_update_begin();
+				_update_poses();
+				_update_end();
 			}
 		} break;
-		case NOTIFICATION_UPDATE_SKELETON: {
+	}
+}
 
-			VisualServer *vs = VisualServer::get_singleton();
-			Bone *bonesptr = bones.ptrw();
-			int len = bones.size();
+void Skeleton::_pack_bone_transforms(const Transform &p_global_transform) {
 
-			vs->skeleton_allocate(skeleton, len); // if same size, nothin really happens
+	const Bone *bonesptr = bones.ptr();
+	int len = bones.size();
+	Transform global_transform_inverse = p_global_transform.affine_inverse();
 
-			_update_process_order();
+	if (bone_transforms.size() != len * 12) {
+		bone_transforms.resize(len * 12);
+	}
 
-			const int *order = process_order.ptr();
+	PoolVector<float>::Write w = bone_transforms.write();
+	float *dst = w.ptr();
 
-			// pose changed, rebuild cache of inverses
-			if (rest_global_inverse_dirty) {
+	for (int i = 0; i < len; i++) {
 
-				// calculate global rests and invert them
-				for (int i = 0; i < len; i++) {
-					Bone &b = bonesptr[order[i]];
-					if (b.parent >= 0)
-						b.rest_global_inverse = bonesptr[b.parent].rest_global_inverse * b.rest;
-					else
-						b.rest_global_inverse = b.rest;
-				}
-				for (int i = 0; i < len; i++) {
-					Bone &b = bonesptr[order[i]];
-					b.rest_global_inverse.affine_invert();
-				}
+		Transform t = p_global_transform * (bonesptr[i].transform_final * global_transform_inverse);
+		float *d = &dst[i * 12];
+
+		d[0] = t.basis[0].x;
+		d[1] = t.basis[0].y;
+		d[2] = t.basis[0].z;
+		d[3] = t.origin.x;
+		d[4] = t.basis[1].x;
+		d[5] = t.basis[1].y;
+		d[6] = t.basis[1].z;
+		d[7] = t.origin.y;
+		d[8] = t.basis[2].x;
+		d[9] = t.basis[2].y;
+		d[10] = t.basis[2].z;
+		d[11] = t.origin.z;
+	}
 
-				rest_global_inverse_dirty = false;
-			}
+	bone_transforms_global = p_global_transform;
+}
 
-			Transform global_transform = get_global_transform();
-			Transform global_transform_inverse = global_transform.affine_inverse();
+void Skeleton::_update_begin() {
 
-			for (int i = 0; i < len; i++) {
+	VisualServer::get_singleton()->skeleton_allocate(skeleton, bones.size()); // if same size, nothin really happens
 
-				Bone &b = bonesptr[order[i]];
+	_update_process_order();
 
-				if (b.disable_rest) {
-					if (b.enabled) {
+	if (bone_transforms.size() != bones.size() * 12) {
+		bone_transforms.resize(bones.size() * 12);
+	}
 
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
+	bone_transforms_global = get_global_transform();
+}
 
-							pose = b.custom_pose * pose;
-						}
+void Skeleton::_update_poses() {
 
-						if (b.parent >= 0) {
+	// only touches this skeleton, so it can run on any thread
+	Bone *bonesptr = bones.ptrw();
+	int len = bones.size();
 
-							b.pose_global = bonesptr[b.parent].pose_global * pose;
-						} else {
+	const int *order = process_order.ptr();
 
-							b.pose_global = pose;
-						}
-					} else {
+	// pose changed, rebuild cache of inverses
+	if (rest_global_inverse_dirty) {
 
-						if (b.parent >= 0) {
+		// calculate global rests and invert them
+		for (int i = 0; i < len; i++) {
+			Bone &b = bonesptr[order[i]];
+			if (b.parent >= 0)
+				b.rest_global_inverse = bonesptr[b.parent].rest_global_inverse * b.rest;
+			else
+				b.rest_global_inverse = b.rest;
+		}
+		for (int i = 0; i < len; i++) {
+			Bone &b = bonesptr[order[i]];
+			b.rest_global_inverse.affine_invert();
+		}
+
+		rest_global_inverse_dirty = false;
+	}
+
+	for (int i = 0; i < len; i++) {
 
-							b.pose_global = bonesptr[b.parent].pose_global;
-						} else {
+		Bone &b = bonesptr[order[i]];
 
-							b.pose_global = Transform();
-						}
-					}
+		if (b.disable_rest) {
+			if (b.enabled) {
 
+				Transform pose = b.pose;
+				if (b.custom_pose_enable) {
+
+					pose = b.custom_pose * pose;
+				}
+
+				if (b.parent >= 0) {
+
+					b.pose_global = bonesptr[b.parent].pose_global * pose;
 				} else {
-					if (b.enabled) {
 
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
+					b.pose_global = pose;
+				}
+			} else {
+
+				if (b.parent >= 0) {
+
+					b.pose_global = bonesptr[b.parent].pose_global;
+				} else {
 
-							pose = b.custom_pose * pose;
-						}
+					b.pose_global = Transform();
+				}
+			}
 
-						if (b.parent >= 0) {
+		} else {
+			if (b.enabled) {
 
-							b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-						} else {
+				Transform pose = b.pose;
+				if (b.custom_pose_enable) {
 
-							b.pose_global = b.rest * pose;
-						}
-					} else {
+					pose = b.custom_pose * pose;
+				}
 
-						if (b.parent >= 0) {
+				if (b.parent >= 0) {
 
-							b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-						} else {
+					b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
+				} else {
 
-							b.pose_global = b.rest;
-						}
-					}
+					b.pose_global = b.rest * pose;
 				}
+			} else {
 
-				b.transform_final = b.pose_global * b.rest_global_inverse;
-				vs->skeleton_bone_set_transform(skeleton, i, global_transform * (b.transform_final * global_transform_inverse));
+				if (b.parent >= 0) {
 
-				for (List<uint32_t>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+					b.pose_global = bonesptr[b.parent].pose_global * b.rest;
+				} else {
 
-					Object *obj = ObjectDB::get_instance(E->get());
-					ERR_CONTINUE(!obj);
-					Spatial *sp = Object::cast_to<Spatial>(obj);
-					ERR_CONTINUE(!sp);
-					sp->set_transform(b.pose_global);
+					b.pose_global = b.rest;
 				}
 			}
+		}
 
-			dirty = false;
-		} break;
+		b.transform_final = b.pose_global * b.rest_global_inverse;
+	}
+
+	_pack_bone_transforms(bone_transforms_global);
+}
+
+void Skeleton::_update_end() {
+
+	// bound nodes of other skeletons may have moved this one since _update_begin()
+	Transform global_transform = get_global_transform();
+	if (global_transform != bone_transforms_global) {
+		_pack_bone_transforms(global_transform);
+	}
+
+	VisualServer::get_singleton()->skeleton_set_bone_transforms(skeleton, bone_transforms);
+
+	Bone *bonesptr = bones.ptrw();
+	int len = bones.size();
+
+	for (int i = 0; i < len; i++) {
+
+		Bone &b = bonesptr[i];
+
+		for (List<uint32_t>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+
+			Object *obj = ObjectDB::get_instance(E->get());
+			ERR_CONTINUE(!obj);
+			Spatial *sp = Object::cast_to<Spatial>(obj);
+			ERR_CONTINUE(!sp);
+			sp->set_transform(b.pose_global);
+		}
+	}
+
+	dirty = false;
+}
+
+void Skeleton::_update_skeleton_task(void *p_userdata, uint32_t p_index) {
+
+	Skeleton **batch = (Skeleton **)p_userdata;
+	batch[p_index]->_update_poses();
+}
+
+void Skeleton::_update_queued_skeletons() {
+
+	Vector<Skeleton *> batch;
+
+	while (update_queue.first()) {
+
+		Skeleton *s = update_queue.first()->self();
+		update_queue.remove(update_queue.first());
+
+		if (s->dirty) {
+			s->_update_begin();
+			batch.push_back(s);
+		}
+	}
+
+	int count = batch.size();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_update_skeleton_task, batch.ptrw(), count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < count; i++) {
+			batch[i]->_update_poses();
+		}
+	}
+
+	// visual server calls and bound nodes have to be updated from this thread
+	for (int i = 0; i < count; i++) {
+		batch[i]->_update_end();
 	}
 }
 
@@ -598,6 +704,9 @@ void Skeleton::_make_dirty() {
 		dirty = true;
 		return;
 	}
+	if (!update_list.in_list()) {
+		update_queue.add(&update_list);
+	}
 	MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
 	dirty = true;
 }
@@ -821,7 +930,10 @@ void Skeleton::_bind_methods() {
 	BIND_CONSTANT(NOTIFICATION_UPDATE_SKELETON);
 }
 
-Skeleton::Skeleton() {
+SelfList<Skeleton>::List Skeleton::update_queue;
+
+Skeleton::Skeleton() :
+		update_list(this) {
 
 	rest_global_inverse_dirty = true;
 	dirty = false;
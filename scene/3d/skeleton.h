@@ -32,6 +32,7 @@
 #define SKELETON_H
 
 #include "rid.h"
+#include "self_list.h"
 #include "scene/3d/spatial.h"
 
 /**
@@ -101,6 +102,21 @@ class Skeleton : public Spatial {
 	void _make_dirty();
 	bool dirty;
 
+	// Skeletons dirtied during a frame are updated together: poses are computed
+	// in parallel, then the bone transforms are sent in one call per skeleton.
+	static SelfList<Skeleton>::List update_queue;
+	SelfList<Skeleton> update_list;
+
+	PoolVector<float> bone_transforms;
+	Transform bone_transforms_global;
+
+	void _pack_bone_transforms(const Transform &p_global_transform);
+	void _update_begin();
+	void _update_poses();
+	void _update_end();
+	static void _update_skeleton_task(void *p_userdata, uint32_t p_index);
+	static void _update_queued_skeletons();
+
 	// bind helpers
 	Array _get_bound_child_nodes_to_bone(int p_bone) const {
 
@@ -95,29 +95,26 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 		return;
 	}
 
-	/*
-	if (data.dirty&DIRTY_GLOBAL)
-		return; //already dirty
-	*/
+	// If the change was already propagated since the last flush and nothing read the global
+	// transform since, the whole subtree is still dirty and queued for notification, so only
+	// this node needs to be queued again (it may have been moved with notifications ignored).
+	if (!_is_transform_change_pending()) {
 
-	data.children_lock++;
+		data.children_lock++;
 
-	for (List<Spatial *>::Element *E = data.children.front(); E; E = E->next()) {
+		for (List<Spatial *>::Element *E = data.children.front(); E; E = E->next()) {
 
-		if (E->get()->data.toplevel_active)
-			continue; //don't propagate to a toplevel
-		E->get()->_propagate_transform_changed(p_origin);
-	}
-#ifdef TOOLS_ENABLED
-	if ((data.gizmo.is_valid() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
-#else
-	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
-#endif
-		get_tree()->xform_change_list.add(&xform_change);
+			if (E->get()->data.toplevel_active)
+				continue; //don't propagate to a toplevel
+			E->get()->_propagate_transform_changed(p_origin);
+		}
+
+		data.children_lock--;
 	}
-	data.dirty |= DIRTY_GLOBAL;
 
-	data.children_lock--;
+	_notify_dirty();
+	data.dirty |= DIRTY_GLOBAL;
+	data.xform_propagated_flush = get_tree()->xform_flush_count;
 }
 
 void Spatial::_notification(int p_what) {
@@ -504,6 +501,44 @@ bool Spatial::is_set_as_toplevel() const {
 	return data.toplevel;
 }
 
+void Spatial::set_physics_interpolated(bool p_interpolated) {
+
+	if (data.physics_interpolated == p_interpolated)
+		return;
+
+	data.physics_interpolated = p_interpolated;
+
+	if (is_inside_tree()) {
+		propagate_notification(NOTIFICATION_RESET_PHYSICS_INTERPOLATION);
+	}
+}
+
+bool Spatial::is_physics_interpolated() const {
+
+	return data.physics_interpolated;
+}
+
+bool Spatial::is_physics_interpolated_in_tree() const {
+
+	const Spatial *s = this;
+
+	while (s) {
+		if (!s->data.physics_interpolated)
+			return false;
+		s = s->data.parent;
+	}
+
+	return true;
+}
+
+void Spatial::reset_physics_interpolation() {
+
+	//teleported, render the current transform right away instead of blending to it
+	if (is_inside_tree()) {
+		propagate_notification(NOTIFICATION_RESET_PHYSICS_INTERPOLATION);
+	}
+}
+
 Ref<World> Spatial::get_world() const {
 
 	ERR_FAIL_COND_V(!is_inside_world(), Ref<World>());
@@ -712,6 +747,10 @@ Vector3 Spatial::to_global(Vector3 p_local) const {
 
 void Spatial::set_notify_transform(bool p_enable) {
 	data.notify_transform = p_enable;
+
+	if (p_enable && is_inside_tree() && _is_transform_change_pending()) {
+		_notify_dirty(); //changed since the last flush, but no longer propagated here until then
+	}
 }
 
 bool Spatial::is_transform_notification_enabled() const {
@@ -746,6 +785,10 @@ void Spatial::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_set_as_toplevel"), &Spatial::is_set_as_toplevel);
 	ClassDB::bind_method(D_METHOD("set_disable_scale", "disable"), &Spatial::set_disable_scale);
 	ClassDB::bind_method(D_METHOD("is_scale_disabled"), &Spatial::is_scale_disabled);
+	ClassDB::bind_method(D_METHOD("set_physics_interpolated", "enable"), &Spatial::set_physics_interpolated);
+	ClassDB::bind_method(D_METHOD("is_physics_interpolated"), &Spatial::is_physics_interpolated);
+	ClassDB::bind_method(D_METHOD("is_physics_interpolated_in_tree"), &Spatial::is_physics_interpolated_in_tree);
+	ClassDB::bind_method(D_METHOD("reset_physics_interpolation"), &Spatial::reset_physics_interpolation);
 	ClassDB::bind_method(D_METHOD("get_world"), &Spatial::get_world);
 
 	ClassDB::bind_method(D_METHOD("_update_gizmo"), &Spatial::_update_gizmo);
@@ -790,6 +833,7 @@ void Spatial::_bind_methods() {
 	BIND_CONSTANT(NOTIFICATION_ENTER_WORLD);
 	BIND_CONSTANT(NOTIFICATION_EXIT_WORLD);
 	BIND_CONSTANT(NOTIFICATION_VISIBILITY_CHANGED);
+	BIND_CONSTANT(NOTIFICATION_RESET_PHYSICS_INTERPOLATION);
 
 	//ADD_PROPERTY( PropertyInfo(Variant::TRANSFORM,"transform/global",PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR ), "set_global_transform", "get_global_transform") ;
 	ADD_GROUP("Transform", "");
@@ -803,6 +847,8 @@ void Spatial::_bind_methods() {
 	ADD_GROUP("Visibility", "");
 	ADD_PROPERTYNO(PropertyInfo(Variant::BOOL, "visible"), "set_visible", "is_visible");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "gizmo", PROPERTY_HINT_RESOURCE_TYPE, "SpatialGizmo", 0), "set_gizmo", "get_gizmo");
+	ADD_GROUP("Physics Interpolation", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "physics_interpolated"), "set_physics_interpolated", "is_physics_interpolated");
 
 	ADD_SIGNAL(MethodInfo("visibility_changed"));
 }
@@ -811,6 +857,7 @@ Spatial::Spatial() :
 		xform_change(this) {
 
 	data.dirty = DIRTY_NONE;
+	data.xform_propagated_flush = 0;
 	data.children_lock = 0;
 
 	data.ignore_notification = false;
@@ -821,6 +868,7 @@ Spatial::Spatial() :
 	data.inside_world = false;
 	data.visible = true;
 	data.disable_scale = false;
+	data.physics_interpolated = true;
 
 #ifdef TOOLS_ENABLED
 	data.gizmo_disabled = false;
@@ -75,6 +75,7 @@ class Spatial : public Node {
 		mutable Vector3 scale;
 
 		mutable int dirty;
+		uint32_t xform_propagated_flush; // SceneTree::xform_flush_count when the transform change was last propagated to the children
 
 		Viewport *viewport;
 
@@ -93,6 +94,7 @@ class Spatial : public Node {
 
 		bool visible;
 		bool disable_scale;
+		bool physics_interpolated;
 
 #ifdef TOOLS_ENABLED
 		Ref<SpatialGizmo> gizmo;
@@ -110,6 +112,7 @@ class Spatial : public Node {
 
 protected:
 	_FORCE_INLINE_ void set_ignore_transform_notification(bool p_ignore) { data.ignore_notification = p_ignore; }
+	_FORCE_INLINE_ bool _is_transform_change_pending() const { return (data.dirty & DIRTY_GLOBAL) && data.xform_propagated_flush == get_tree()->xform_flush_count; }
 
 	_FORCE_INLINE_ void _update_local_transform() const;
 
@@ -124,6 +127,7 @@ public:
 		NOTIFICATION_EXIT_WORLD = 42,
 		NOTIFICATION_VISIBILITY_CHANGED = 43,
 		NOTIFICATION_LOCAL_TRANSFORM_CHANGED = 44,
+		NOTIFICATION_RESET_PHYSICS_INTERPOLATION = 45,
 	};
 
 	Spatial *get_parent_spatial() const;
@@ -157,6 +161,11 @@ public:
 	void set_disable_scale(bool p_enabled);
 	bool is_scale_disabled() const;
 
+	void set_physics_interpolated(bool p_interpolated);
+	bool is_physics_interpolated() const;
+	bool is_physics_interpolated_in_tree() const;
+	void reset_physics_interpolation();
+
 	void set_disable_gizmo(bool p_enabled);
 	void update_gizmo();
 	void set_gizmo(const Ref<SpatialGizmo> &p_gizmo);
@@ -30,6 +30,7 @@
 
 #include "visual_instance.h"
 
+#include "core/engine.h"
 #include "scene/scene_string_names.h"
 #include "servers/visual_server.h"
 #include "skeleton.h"
@@ -48,6 +49,20 @@ void VisualInstance::_update_visibility() {
 	VS::get_singleton()->instance_set_visible(get_instance(), is_visible_in_tree());
 }
 
+void VisualInstance::_update_physics_interpolation() {
+
+	if (transform_batch_index >= 0) {
+		// a batched transform arriving after the reset would be blended to
+		get_tree()->cancel_instance_transform(transform_batch_index, instance);
+		transform_batch_index = -1;
+	}
+
+	VisualServer::get_singleton()->instance_set_transform(instance, get_global_transform());
+	bool interpolated = Engine::get_singleton()->is_physics_interpolation_enabled() && !Engine::get_singleton()->is_editor_hint() && is_physics_interpolated_in_tree();
+	VisualServer::get_singleton()->instance_set_interpolated(instance, interpolated);
+	VisualServer::get_singleton()->instance_reset_physics_interpolation(instance);
+}
+
 void VisualInstance::_notification(int p_what) {
 
 	switch (p_what) {
@@ -63,15 +78,26 @@ void VisualInstance::_notification(int p_what) {
 
 			VisualServer::get_singleton()->instance_set_scenario(instance, get_world()->get_scenario());
 			_update_visibility();
+			_update_physics_interpolation();
 
 		} break;
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 
 			Transform gt = get_global_transform();
-			VisualServer::get_singleton()->instance_set_transform(instance, gt);
+			if (get_tree()->is_batching_instance_transforms()) {
+				transform_batch_index = get_tree()->batch_instance_transform(instance, gt);
+			} else {
+				VisualServer::get_singleton()->instance_set_transform(instance, gt);
+			}
 		} break;
 		case NOTIFICATION_EXIT_WORLD: {
 
+			if (transform_batch_index >= 0) {
+				// the instance may be freed before the batch is sent
+				get_tree()->cancel_instance_transform(transform_batch_index, instance);
+				transform_batch_index = -1;
+			}
+
 			VisualServer::get_singleton()->instance_set_scenario(instance, RID());
 			VisualServer::get_singleton()->instance_attach_skeleton(instance, RID());
 			//VS::get_singleton()->instance_geometry_set_baked_light_sampler(instance, RID() );
@@ -81,6 +107,12 @@ void VisualInstance::_notification(int p_what) {
 
 			_update_visibility();
 		} break;
+		case NOTIFICATION_RESET_PHYSICS_INTERPOLATION: {
+
+			if (is_inside_world()) {
+				_update_physics_interpolation();
+			}
+		} break;
 	}
 }
 
@@ -143,6 +175,7 @@ VisualInstance::VisualInstance() {
 	instance = VisualServer::get_singleton()->instance_create();
 	VisualServer::get_singleton()->instance_attach_object_instance_id(instance, get_instance_id());
 	layers = 1;
+	transform_batch_index = -1;
 	set_notify_transform(true);
 }
 
@@ -263,6 +296,40 @@ float GeometryInstance::get_extra_cull_margin() const {
 	return extra_cull_margin;
 }
 
+void GeometryInstance::_update_occluder() {
+
+	PoolVector<Vector3> faces;
+
+	if (use_as_occluder) {
+		PoolVector<Face3> geometry = get_faces(FACES_SOLID);
+		faces.resize(geometry.size() * 3);
+
+		PoolVector<Face3>::Read r = geometry.read();
+		PoolVector<Vector3>::Write w = faces.write();
+		for (int i = 0; i < geometry.size(); i++) {
+			for (int j = 0; j < 3; j++) {
+				w[i * 3 + j] = r[i].vertex[j];
+			}
+		}
+	}
+
+	VS::get_singleton()->instance_geometry_set_occluder_faces(get_instance(), faces);
+}
+
+void GeometryInstance::set_use_as_occluder(bool p_enable) {
+
+	if (use_as_occluder == p_enable)
+		return;
+
+	use_as_occluder = p_enable;
+	_update_occluder();
+}
+
+bool GeometryInstance::is_used_as_occluder() const {
+
+	return use_as_occluder;
+}
+
 void GeometryInstance::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_material_override", "material"), &GeometryInstance::set_material_override);
@@ -289,6 +356,9 @@ void GeometryInstance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_extra_cull_margin", "margin"), &GeometryInstance::set_extra_cull_margin);
 	ClassDB::bind_method(D_METHOD("get_extra_cull_margin"), &GeometryInstance::get_extra_cull_margin);
 
+	ClassDB::bind_method(D_METHOD("set_use_as_occluder", "enable"), &GeometryInstance::set_use_as_occluder);
+	ClassDB::bind_method(D_METHOD("is_used_as_occluder"), &GeometryInstance::is_used_as_occluder);
+
 	ClassDB::bind_method(D_METHOD("get_aabb"), &GeometryInstance::get_aabb);
 
 	ADD_GROUP("Geometry", "");
@@ -296,6 +366,7 @@ void GeometryInstance::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cast_shadow", PROPERTY_HINT_ENUM, "Off,On,Double-Sided,Shadows Only"), "set_cast_shadows_setting", "get_cast_shadows_setting");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "extra_cull_margin", PROPERTY_HINT_RANGE, "0,16384,0"), "set_extra_cull_margin", "get_extra_cull_margin");
 	ADD_PROPERTYI(PropertyInfo(Variant::BOOL, "use_in_baked_light"), "set_flag", "get_flag", FLAG_USE_BAKED_LIGHT);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_as_occluder"), "set_use_as_occluder", "is_used_as_occluder");
 
 	ADD_GROUP("LOD", "lod_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_min_distance", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_min_distance", "get_lod_min_distance");
@@ -326,5 +397,6 @@ GeometryInstance::GeometryInstance() {
 
 	shadow_casting_setting = SHADOW_CASTING_SETTING_ON;
 	extra_cull_margin = 0;
+	use_as_occluder = false;
 	//VS::get_singleton()->instance_geometry_set_baked_light_texture_index(get_instance(),0);
 }
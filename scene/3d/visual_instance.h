@@ -44,12 +44,14 @@ class VisualInstance : public Spatial {
 	OBJ_CATEGORY("3D Visual Nodes");
 
 	RID instance;
+	int transform_batch_index; // position in the SceneTree transform batch, -1 if never batched
 	uint32_t layers;
 
 	RID _get_visual_instance_rid() const;
 
 protected:
 	void _update_visibility();
+	void _update_physics_interpolation();
 
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -107,8 +109,11 @@ private:
 	float lod_max_hysteresis;
 
 	float extra_cull_margin;
+	bool use_as_occluder;
 
 protected:
+	void _update_occluder();
+
 	void _notification(int p_what);
 	static void _bind_methods();
 
@@ -137,6 +142,9 @@ public:
 	void set_extra_cull_margin(float p_margin);
 	float get_extra_cull_margin() const;
 
+	void set_use_as_occluder(bool p_enable);
+	bool is_used_as_occluder() const;
+
 	GeometryInstance();
 };
 
@@ -258,7 +258,7 @@ static _FORCE_INLINE_ void get_uv_and_normal(const Vector3 &p_pos, const Vector3
 	r_normal = (p_normal[0] * u + p_normal[1] * v + p_normal[2] * w).normalized();
 }
 
-void VoxelLightBaker::_plot_face(int p_idx, int p_level, int p_x, int p_y, int p_z, const Vector3 *p_vtx, const Vector3 *p_normal, const Vector2 *p_uv, const MaterialCache &p_material, const AABB &p_aabb) {
+void VoxelLightBaker::_plot_face(int p_idx, int p_level, int p_x, int p_y, int p_z, const Vector3 *p_vtx, const Vector3 *p_normal, const Vector2 *p_uv, const MaterialCache &p_material, const AABB &p_aabb, Vector<Cell> &r_cells) {
 
 	if (p_level == cell_subdiv - 1) {
 		//plot the face by guessing it's albedo and emission value
@@ -409,16 +409,16 @@ void VoxelLightBaker::_plot_face(int p_idx, int p_level, int p_x, int p_y, int p
 		}
 
 		//put this temporarily here, corrected in a later step
-		bake_cells.write[p_idx].albedo[0] += albedo_accum.r;
-		bake_cells.write[p_idx].albedo[1] += albedo_accum.g;
-		bake_cells.write[p_idx].albedo[2] += albedo_accum.b;
-		bake_cells.write[p_idx].emission[0] += emission_accum.r;
-		bake_cells.write[p_idx].emission[1] += emission_accum.g;
-		bake_cells.write[p_idx].emission[2] += emission_accum.b;
-		bake_cells.write[p_idx].normal[0] += normal_accum.x;
-		bake_cells.write[p_idx].normal[1] += normal_accum.y;
-		bake_cells.write[p_idx].normal[2] += normal_accum.z;
-		bake_cells.write[p_idx].alpha += alpha;
+		r_cells.write[p_idx].albedo[0] += albedo_accum.r;
+		r_cells.write[p_idx].albedo[1] += albedo_accum.g;
+		r_cells.write[p_idx].albedo[2] += albedo_accum.b;
+		r_cells.write[p_idx].emission[0] += emission_accum.r;
+		r_cells.write[p_idx].emission[1] += emission_accum.g;
+		r_cells.write[p_idx].emission[2] += emission_accum.b;
+		r_cells.write[p_idx].normal[0] += normal_accum.x;
+		r_cells.write[p_idx].normal[1] += normal_accum.y;
+		r_cells.write[p_idx].normal[2] += normal_accum.z;
+		r_cells.write[p_idx].alpha += alpha;
 
 	} else {
 		//go down
@@ -461,16 +461,16 @@ void VoxelLightBaker::_plot_face(int p_idx, int p_level, int p_x, int p_y, int p
 				}
 			}
 
-			if (bake_cells[p_idx].children[i] == CHILD_EMPTY) {
+			if (r_cells[p_idx].children[i] == CHILD_EMPTY) {
 				//sub cell must be created
 
-				uint32_t child_idx = bake_cells.size();
-				bake_cells.write[p_idx].children[i] = child_idx;
-				bake_cells.resize(bake_cells.size() + 1);
-				bake_cells.write[child_idx].level = p_level + 1;
+				uint32_t child_idx = r_cells.size();
+				r_cells.write[p_idx].children[i] = child_idx;
+				r_cells.resize(r_cells.size() + 1);
+				r_cells.write[child_idx].level = p_level + 1;
 			}
 
-			_plot_face(bake_cells[p_idx].children[i], p_level + 1, nx, ny, nz, p_vtx, p_normal, p_uv, p_material, aabb);
+			_plot_face(r_cells[p_idx].children[i], p_level + 1, nx, ny, nz, p_vtx, p_normal, p_uv, p_material, aabb, r_cells);
 		}
 	}
 }
@@ -570,8 +570,57 @@ VoxelLightBaker::MaterialCache VoxelLightBaker::_get_material_cache(Ref<Material
 	return mc;
 }
 
+void VoxelLightBaker::_plot_mesh_thread(uint32_t p_thread, PlotMeshData *p_data) {
+
+	int from = p_data->face_count * p_thread / p_data->thread_count;
+	int to = p_data->face_count * (p_thread + 1) / p_data->thread_count;
+
+	Vector<Cell> &cells = p_data->thread_cells[p_thread];
+	cells.resize(1);
+
+	for (int i = from; i < to; i++) {
+
+		const PlotFace &f = p_data->faces[i];
+		_plot_face(0, 0, 0, 0, 0, f.vtx, f.normal, f.uv, p_data->materials[f.material], po2_bounds, cells);
+	}
+}
+
+void VoxelLightBaker::_merge_plot_cells(uint32_t p_idx, const Cell *p_cells, uint32_t p_from_idx) {
+
+	const Cell &from = p_cells[p_from_idx];
+	Cell &to = bake_cells.write[p_idx];
+
+	//only leaves accumulate anything, upper levels are zero at this point
+	for (int i = 0; i < 3; i++) {
+		to.albedo[i] += from.albedo[i];
+		to.emission[i] += from.emission[i];
+		to.normal[i] += from.normal[i];
+	}
+	to.alpha += from.alpha;
+
+	for (int i = 0; i < 8; i++) {
+
+		if (from.children[i] == CHILD_EMPTY)
+			continue;
+
+		if (bake_cells[p_idx].children[i] == CHILD_EMPTY) {
+			//sub cell must be created
+
+			uint32_t child_idx = bake_cells.size();
+			bake_cells.write[p_idx].children[i] = child_idx;
+			bake_cells.resize(bake_cells.size() + 1);
+			bake_cells.write[child_idx].level = bake_cells[p_idx].level + 1;
+		}
+
+		_merge_plot_cells(bake_cells[p_idx].children[i], p_cells, from.children[i]);
+	}
+}
+
 void VoxelLightBaker::plot_mesh(const Transform &p_xform, Ref<Mesh> &p_mesh, const Vector<Ref<Material> > &p_materials, const Ref<Material> &p_override_material) {
 
+	Vector<MaterialCache> materials;
+	Vector<PlotFace> faces;
+
 	for (int i = 0; i < p_mesh->get_surface_count(); i++) {
 
 		if (p_mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES)
@@ -586,7 +635,8 @@ void VoxelLightBaker::plot_mesh(const Transform &p_xform, Ref<Mesh> &p_mesh, con
 		} else {
 			src_material = p_mesh->surface_get_material(i);
 		}
-		MaterialCache material = _get_material_cache(src_material);
+		int material = materials.size();
+		materials.push_back(_get_material_cache(src_material));
 
 		Array a = p_mesh->surface_get_arrays(i);
 
@@ -612,72 +662,90 @@ void VoxelLightBaker::plot_mesh(const Transform &p_xform, Ref<Mesh> &p_mesh, con
 			nr = normals.read();
 		}
 
+		PoolVector<int>::Read ir;
+		int facecount;
+
 		if (index.size()) {
+			facecount = index.size() / 3;
+			ir = index.read();
+		} else {
+			facecount = vertices.size() / 3;
+		}
 
-			int facecount = index.size() / 3;
-			PoolVector<int>::Read ir = index.read();
+		for (int j = 0; j < facecount; j++) {
 
-			for (int j = 0; j < facecount; j++) {
+			PlotFace face;
+			face.material = material;
 
-				Vector3 vtxs[3];
-				Vector2 uvs[3];
-				Vector3 normal[3];
+			int vidx[3];
+			for (int k = 0; k < 3; k++) {
+				vidx[k] = index.size() ? ir[j * 3 + k] : j * 3 + k;
+			}
+
+			for (int k = 0; k < 3; k++) {
+				face.vtx[k] = p_xform.xform(vr[vidx[k]]);
+			}
 
+			if (read_uv) {
 				for (int k = 0; k < 3; k++) {
-					vtxs[k] = p_xform.xform(vr[ir[j * 3 + k]]);
+					face.uv[k] = uvr[vidx[k]];
 				}
+			}
 
-				if (read_uv) {
-					for (int k = 0; k < 3; k++) {
-						uvs[k] = uvr[ir[j * 3 + k]];
-					}
+			if (read_normals) {
+				for (int k = 0; k < 3; k++) {
+					face.normal[k] = nr[vidx[k]];
 				}
+			}
 
-				if (read_normals) {
-					for (int k = 0; k < 3; k++) {
-						normal[k] = nr[ir[j * 3 + k]];
-					}
-				}
+			//test against original bounds
+			if (!fast_tri_box_overlap(original_bounds.position + original_bounds.size * 0.5, original_bounds.size * 0.5, face.vtx))
+				continue;
 
-				//test against original bounds
-				if (!fast_tri_box_overlap(original_bounds.position + original_bounds.size * 0.5, original_bounds.size * 0.5, vtxs))
-					continue;
-				//plot
-				_plot_face(0, 0, 0, 0, 0, vtxs, normal, uvs, material, po2_bounds);
+			faces.push_back(face);
+		}
+	}
+
+	{
+		int from = ray_faces.size();
+		ray_faces.resize(from + faces.size() * 3);
+		PoolVector<Vector3>::Write w = ray_faces.write();
+		for (int i = 0; i < faces.size(); i++) {
+			for (int j = 0; j < 3; j++) {
+				w[from + i * 3 + j] = to_cell_space.xform(faces[i].vtx[j]);
 			}
+		}
+	}
+	ray_mesh.unref();
 
-		} else {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int thread_count = pool ? MIN(pool->get_thread_count(), faces.size() / PLOT_MIN_FACES_PER_THREAD) : 0;
 
-			int facecount = vertices.size() / 3;
+	if (thread_count > 1) {
 
-			for (int j = 0; j < facecount; j++) {
+		//plot into one octree per thread, then merge them in a fixed order so results don't depend on scheduling
+		Vector<Vector<Cell> > thread_cells;
+		thread_cells.resize(thread_count);
 
-				Vector3 vtxs[3];
-				Vector2 uvs[3];
-				Vector3 normal[3];
+		PlotMeshData data;
+		data.faces = faces.ptr();
+		data.face_count = faces.size();
+		data.thread_count = thread_count;
+		data.materials = materials.ptr();
+		data.thread_cells = thread_cells.ptrw();
 
-				for (int k = 0; k < 3; k++) {
-					vtxs[k] = p_xform.xform(vr[j * 3 + k]);
-				}
+		thread_process_array(thread_count, this, &VoxelLightBaker::_plot_mesh_thread, &data);
 
-				if (read_uv) {
-					for (int k = 0; k < 3; k++) {
-						uvs[k] = uvr[j * 3 + k];
-					}
-				}
+		for (int i = 0; i < thread_count; i++) {
+			_merge_plot_cells(0, thread_cells[i].ptr(), 0);
+		}
 
-				if (read_normals) {
-					for (int k = 0; k < 3; k++) {
-						normal[k] = nr[j * 3 + k];
-					}
-				}
+	} else {
 
-				//test against original bounds
-				if (!fast_tri_box_overlap(original_bounds.position + original_bounds.size * 0.5, original_bounds.size * 0.5, vtxs))
-					continue;
-				//plot face
-				_plot_face(0, 0, 0, 0, 0, vtxs, normal, uvs, material, po2_bounds);
-			}
+		for (int i = 0; i < faces.size(); i++) {
+
+			const PlotFace &f = faces[i];
+			_plot_face(0, 0, 0, 0, 0, f.vtx, f.normal, f.uv, materials[f.material], po2_bounds, bake_cells);
 		}
 	}
 
@@ -692,8 +760,7 @@ void VoxelLightBaker::_init_light_plot(int p_idx, int p_level, int p_x, int p_y,
 
 	if (p_level == cell_subdiv - 1) {
 
-		bake_light.write[p_idx].next_leaf = first_leaf;
-		first_leaf = p_idx;
+		leaf_cells.push_back(p_idx);
 	} else {
 
 		//go down
@@ -733,11 +800,10 @@ void VoxelLightBaker::_check_init_light() {
 	if (bake_light.size() == 0) {
 
 		direct_lights_baked = false;
-		leaf_voxel_count = 0;
-		_fixup_plot(0, 0); //pre fixup, so normal, albedo, emission, etc. work for lighting.
+		leaf_voxel_count = _fixup_plot_threaded(); //pre fixup, so normal, albedo, emission, etc. work for lighting.
 		bake_light.resize(bake_cells.size());
 		zeromem(bake_light.ptrw(), bake_light.size() * sizeof(Light));
-		first_leaf = -1;
+		leaf_cells.clear();
 		_init_light_plot(0, 0, 0, 0, 0, CHILD_EMPTY);
 	}
 }
@@ -818,383 +884,376 @@ uint32_t VoxelLightBaker::_find_cell_at_pos(const Cell *cells, int x, int y, int
 
 	return cell;
 }
-void VoxelLightBaker::plot_light_directional(const Vector3 &p_direction, const Color &p_color, float p_energy, float p_indirect_energy, bool p_direct) {
-
-	_check_init_light();
-
-	float max_len = Vector3(axis_cell_size[0], axis_cell_size[1], axis_cell_size[2]).length() * 1.1;
-
-	if (p_direct)
-		direct_lights_baked = true;
-
-	Vector3 light_axis = p_direction;
-	Plane clip[3];
-	int clip_planes = 0;
-
-	Light *light_data = bake_light.ptrw();
-	const Cell *cells = bake_cells.ptr();
+void VoxelLightBaker::_plot_light_directional_leaf(uint32_t p_leaf, const PlotLight *p_light) {
 
-	for (int i = 0; i < 3; i++) {
+	uint32_t idx = leaf_cells[p_leaf];
+	const Cell *cells = p_light->cells;
+	Light *light = &p_light->light_data[idx];
+	const Vector3 &light_axis = p_light->axis;
+	const Vector3 &light_energy = p_light->energy;
+	float distance_adv = p_light->distance_adv;
 
-		if (ABS(light_axis[i]) < CMP_EPSILON)
-			continue;
-		clip[clip_planes].normal[i] = 1.0;
+	Vector3 to(light->x + 0.5, light->y + 0.5, light->z + 0.5);
+	to += -light_axis.sign() * 0.47; //make it more likely to receive a ray
 
-		if (light_axis[i] < 0) {
+	Vector3 from = to - p_light->max_len * light_axis;
 
-			clip[clip_planes].d = axis_cell_size[i] + 1;
-		} else {
-			clip[clip_planes].d -= 1.0;
-		}
+	for (int j = 0; j < p_light->clip_planes; j++) {
 
-		clip_planes++;
+		p_light->clip[j].intersects_segment(from, to, &from);
 	}
 
-	float distance_adv = _get_normal_advance(light_axis);
-
-	int success_count = 0;
-
-	Vector3 light_energy = Vector3(p_color.r, p_color.g, p_color.b) * p_energy * p_indirect_energy;
+	float distance = (to - from).length();
+	distance += distance_adv - Math::fmod(distance, distance_adv); //make it reach the center of the box always
+	from = to - light_axis * distance;
 
-	int idx = first_leaf;
-	while (idx >= 0) {
+	uint32_t result = 0xFFFFFFFF;
 
-		//print_line("plot idx " + itos(idx));
-		Light *light = &light_data[idx];
+	while (distance > -distance_adv) { //use this to avoid precision errors
 
-		Vector3 to(light->x + 0.5, light->y + 0.5, light->z + 0.5);
-		to += -light_axis.sign() * 0.47; //make it more likely to receive a ray
-
-		Vector3 from = to - max_len * light_axis;
-
-		for (int j = 0; j < clip_planes; j++) {
-
-			clip[j].intersects_segment(from, to, &from);
+		result = _find_cell_at_pos(cells, int(floor(from.x)), int(floor(from.y)), int(floor(from.z)));
+		if (result != 0xFFFFFFFF) {
+			break;
 		}
 
-		float distance = (to - from).length();
-		distance += distance_adv - Math::fmod(distance, distance_adv); //make it reach the center of the box always
-		from = to - light_axis * distance;
-
-		uint32_t result = 0xFFFFFFFF;
+		from += light_axis * distance_adv;
+		distance -= distance_adv;
+	}
 
-		while (distance > -distance_adv) { //use this to avoid precision errors
+	if (result == idx) {
+		//cell hit itself! hooray!
 
-			result = _find_cell_at_pos(cells, int(floor(from.x)), int(floor(from.y)), int(floor(from.z)));
-			if (result != 0xFFFFFFFF) {
-				break;
+		Vector3 normal(cells[idx].normal[0], cells[idx].normal[1], cells[idx].normal[2]);
+		if (normal == Vector3()) {
+			for (int i = 0; i < 6; i++) {
+				light->accum[i][0] += light_energy.x * cells[idx].albedo[0];
+				light->accum[i][1] += light_energy.y * cells[idx].albedo[1];
+				light->accum[i][2] += light_energy.z * cells[idx].albedo[2];
 			}
 
-			from += light_axis * distance_adv;
-			distance -= distance_adv;
-		}
-
-		if (result == idx) {
-			//cell hit itself! hooray!
-
-			Vector3 normal(cells[idx].normal[0], cells[idx].normal[1], cells[idx].normal[2]);
-			if (normal == Vector3()) {
-				for (int i = 0; i < 6; i++) {
-					light->accum[i][0] += light_energy.x * cells[idx].albedo[0];
-					light->accum[i][1] += light_energy.y * cells[idx].albedo[1];
-					light->accum[i][2] += light_energy.z * cells[idx].albedo[2];
-				}
-
-			} else {
+		} else {
 
-				for (int i = 0; i < 6; i++) {
-					float s = MAX(0.0, aniso_normal[i].dot(-normal));
-					light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * s;
-					light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * s;
-					light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * s;
-				}
+			for (int i = 0; i < 6; i++) {
+				float s = MAX(0.0, aniso_normal[i].dot(-normal));
+				light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * s;
+				light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * s;
+				light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * s;
 			}
+		}
 
-			if (p_direct) {
-				for (int i = 0; i < 6; i++) {
-					float s = MAX(0.0, aniso_normal[i].dot(-light_axis)); //light depending on normal for direct
-					light->direct_accum[i][0] += light_energy.x * s;
-					light->direct_accum[i][1] += light_energy.y * s;
-					light->direct_accum[i][2] += light_energy.z * s;
-				}
+		if (p_light->direct) {
+			for (int i = 0; i < 6; i++) {
+				float s = MAX(0.0, aniso_normal[i].dot(-light_axis)); //light depending on normal for direct
+				light->direct_accum[i][0] += light_energy.x * s;
+				light->direct_accum[i][1] += light_energy.y * s;
+				light->direct_accum[i][2] += light_energy.z * s;
 			}
-			success_count++;
 		}
-
-		idx = light_data[idx].next_leaf;
 	}
 }
 
-void VoxelLightBaker::plot_light_omni(const Vector3 &p_pos, const Color &p_color, float p_energy, float p_indirect_energy, float p_radius, float p_attenutation, bool p_direct) {
+void VoxelLightBaker::plot_light_directional(const Vector3 &p_direction, const Color &p_color, float p_energy, float p_indirect_energy, bool p_direct) {
 
 	_check_init_light();
 
 	if (p_direct)
 		direct_lights_baked = true;
 
-	Plane clip[3];
-	int clip_planes = 0;
+	PlotLight plot;
+	plot.light_data = bake_light.ptrw();
+	plot.cells = bake_cells.ptr();
+	plot.axis = p_direction;
+	plot.max_len = Vector3(axis_cell_size[0], axis_cell_size[1], axis_cell_size[2]).length() * 1.1;
+	plot.clip_planes = 0;
+	plot.direct = p_direct;
 
-	// uint64_t us = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < 3; i++) {
 
-	Vector3 light_pos = to_cell_space.xform(p_pos) + Vector3(0.5, 0.5, 0.5);
-	//Vector3 spot_axis = -light_cache.transform.basis.get_axis(2).normalized();
+		if (ABS(plot.axis[i]) < CMP_EPSILON)
+			continue;
+		plot.clip[plot.clip_planes].normal[i] = 1.0;
 
-	float local_radius = to_cell_space.basis.xform(Vector3(0, 0, 1)).length() * p_radius;
+		if (plot.axis[i] < 0) {
 
-	Light *light_data = bake_light.ptrw();
-	const Cell *cells = bake_cells.ptr();
-	Vector3 light_energy = Vector3(p_color.r, p_color.g, p_color.b) * p_energy * p_indirect_energy;
+			plot.clip[plot.clip_planes].d = axis_cell_size[i] + 1;
+		} else {
+			plot.clip[plot.clip_planes].d -= 1.0;
+		}
 
-	int idx = first_leaf;
-	while (idx >= 0) {
+		plot.clip_planes++;
+	}
 
-		//print_line("plot idx " + itos(idx));
-		Light *light = &light_data[idx];
+	plot.distance_adv = _get_normal_advance(plot.axis);
+	plot.energy = Vector3(p_color.r, p_color.g, p_color.b) * p_energy * p_indirect_energy;
 
-		Vector3 to(light->x + 0.5, light->y + 0.5, light->z + 0.5);
-		to += (light_pos - to).sign() * 0.47; //make it more likely to receive a ray
+	//every leaf only writes to its own light, so they can be plotted in parallel
+	thread_process_array(leaf_cells.size(), this, &VoxelLightBaker::_plot_light_directional_leaf, (const PlotLight *)&plot);
+}
 
-		Vector3 light_axis = (to - light_pos).normalized();
-		float distance_adv = _get_normal_advance(light_axis);
+void VoxelLightBaker::_plot_light_omni_leaf(uint32_t p_leaf, const PlotLight *p_light) {
 
-		Vector3 normal(cells[idx].normal[0], cells[idx].normal[1], cells[idx].normal[2]);
+	uint32_t idx = leaf_cells[p_leaf];
+	const Cell *cells = p_light->cells;
+	Light *light = &p_light->light_data[idx];
+	const Vector3 &light_pos = p_light->pos;
+	const Vector3 &light_energy = p_light->energy;
 
-		if (normal != Vector3() && normal.dot(-light_axis) < 0.001) {
-			idx = light_data[idx].next_leaf;
-			continue;
-		}
+	Plane clip[3];
+	int clip_planes = 0;
 
-		float att = 1.0;
-		{
-			float d = light_pos.distance_to(to);
-			if (d + distance_adv > local_radius) {
-				idx = light_data[idx].next_leaf;
-				continue; // too far away
-			}
+	Vector3 to(light->x + 0.5, light->y + 0.5, light->z + 0.5);
+	to += (light_pos - to).sign() * 0.47; //make it more likely to receive a ray
 
-			float dt = CLAMP((d + distance_adv) / local_radius, 0, 1);
-			att *= powf(1.0 - dt, p_attenutation);
-		}
+	Vector3 light_axis = (to - light_pos).normalized();
+	float distance_adv = _get_normal_advance(light_axis);
 
-		clip_planes = 0;
+	Vector3 normal(cells[idx].normal[0], cells[idx].normal[1], cells[idx].normal[2]);
 
-		for (int c = 0; c < 3; c++) {
+	if (normal != Vector3() && normal.dot(-light_axis) < 0.001) {
+		return;
+	}
 
-			if (ABS(light_axis[c]) < CMP_EPSILON)
-				continue;
-			clip[clip_planes].normal[c] = 1.0;
+	float att = 1.0;
+	{
+		float d = light_pos.distance_to(to);
+		if (d + distance_adv > p_light->radius) {
+			return; // too far away
+		}
 
-			if (light_axis[c] < 0) {
+		float dt = CLAMP((d + distance_adv) / p_light->radius, 0, 1);
+		att *= powf(1.0 - dt, p_light->attenuation);
+	}
 
-				clip[clip_planes].d = (1 << (cell_subdiv - 1)) + 1;
-			} else {
-				clip[clip_planes].d -= 1.0;
-			}
+	for (int c = 0; c < 3; c++) {
 
-			clip_planes++;
+		if (ABS(light_axis[c]) < CMP_EPSILON)
+			continue;
+		clip[clip_planes].normal[c] = 1.0;
+
+		if (light_axis[c] < 0) {
+
+			clip[clip_planes].d = (1 << (cell_subdiv - 1)) + 1;
+		} else {
+			clip[clip_planes].d -= 1.0;
 		}
 
-		Vector3 from = light_pos;
+		clip_planes++;
+	}
 
-		for (int j = 0; j < clip_planes; j++) {
+	Vector3 from = light_pos;
 
-			clip[j].intersects_segment(from, to, &from);
-		}
+	for (int j = 0; j < clip_planes; j++) {
 
-		float distance = (to - from).length();
+		clip[j].intersects_segment(from, to, &from);
+	}
 
-		distance -= Math::fmod(distance, distance_adv); //make it reach the center of the box always, but this tame make it closer
-		from = to - light_axis * distance;
-		to += (light_pos - to).sign() * 0.47; //make it more likely to receive a ray
+	float distance = (to - from).length();
 
-		uint32_t result = 0xFFFFFFFF;
+	distance -= Math::fmod(distance, distance_adv); //make it reach the center of the box always, but this tame make it closer
+	from = to - light_axis * distance;
+	to += (light_pos - to).sign() * 0.47; //make it more likely to receive a ray
 
-		while (distance > -distance_adv) { //use this to avoid precision errors
+	uint32_t result = 0xFFFFFFFF;
 
-			result = _find_cell_at_pos(cells, int(floor(from.x)), int(floor(from.y)), int(floor(from.z)));
-			if (result != 0xFFFFFFFF) {
-				break;
-			}
+	while (distance > -distance_adv) { //use this to avoid precision errors
 
-			from += light_axis * distance_adv;
-			distance -= distance_adv;
+		result = _find_cell_at_pos(cells, int(floor(from.x)), int(floor(from.y)), int(floor(from.z)));
+		if (result != 0xFFFFFFFF) {
+			break;
 		}
 
-		if (result == idx) {
-			//cell hit itself! hooray!
-
-			if (normal == Vector3()) {
-				for (int i = 0; i < 6; i++) {
-					light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * att;
-					light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * att;
-					light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * att;
-				}
+		from += light_axis * distance_adv;
+		distance -= distance_adv;
+	}
 
-			} else {
+	if (result == idx) {
+		//cell hit itself! hooray!
 
-				for (int i = 0; i < 6; i++) {
-					float s = MAX(0.0, aniso_normal[i].dot(-normal));
-					light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * s * att;
-					light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * s * att;
-					light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * s * att;
-				}
+		if (normal == Vector3()) {
+			for (int i = 0; i < 6; i++) {
+				light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * att;
+				light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * att;
+				light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * att;
 			}
 
-			if (p_direct) {
-				for (int i = 0; i < 6; i++) {
-					float s = MAX(0.0, aniso_normal[i].dot(-light_axis)); //light depending on normal for direct
-					light->direct_accum[i][0] += light_energy.x * s * att;
-					light->direct_accum[i][1] += light_energy.y * s * att;
-					light->direct_accum[i][2] += light_energy.z * s * att;
-				}
+		} else {
+
+			for (int i = 0; i < 6; i++) {
+				float s = MAX(0.0, aniso_normal[i].dot(-normal));
+				light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * s * att;
+				light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * s * att;
+				light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * s * att;
 			}
 		}
 
-		idx = light_data[idx].next_leaf;
+		if (p_light->direct) {
+			for (int i = 0; i < 6; i++) {
+				float s = MAX(0.0, aniso_normal[i].dot(-light_axis)); //light depending on normal for direct
+				light->direct_accum[i][0] += light_energy.x * s * att;
+				light->direct_accum[i][1] += light_energy.y * s * att;
+				light->direct_accum[i][2] += light_energy.z * s * att;
+			}
+		}
 	}
 }
 
-void VoxelLightBaker::plot_light_spot(const Vector3 &p_pos, const Vector3 &p_axis, const Color &p_color, float p_energy, float p_indirect_energy, float p_radius, float p_attenutation, float p_spot_angle, float p_spot_attenuation, bool p_direct) {
+void VoxelLightBaker::plot_light_omni(const Vector3 &p_pos, const Color &p_color, float p_energy, float p_indirect_energy, float p_radius, float p_attenutation, bool p_direct) {
 
 	_check_init_light();
 
 	if (p_direct)
 		direct_lights_baked = true;
 
-	Plane clip[3];
-	int clip_planes = 0;
+	PlotLight plot;
+	plot.light_data = bake_light.ptrw();
+	plot.cells = bake_cells.ptr();
+	plot.pos = to_cell_space.xform(p_pos) + Vector3(0.5, 0.5, 0.5);
+	plot.radius = to_cell_space.basis.xform(Vector3(0, 0, 1)).length() * p_radius;
+	plot.attenuation = p_attenutation;
+	plot.energy = Vector3(p_color.r, p_color.g, p_color.b) * p_energy * p_indirect_energy;
+	plot.direct = p_direct;
 
-	// uint64_t us = OS::get_singleton()->get_ticks_usec();
+	thread_process_array(leaf_cells.size(), this, &VoxelLightBaker::_plot_light_omni_leaf, (const PlotLight *)&plot);
+}
 
-	Vector3 light_pos = to_cell_space.xform(p_pos) + Vector3(0.5, 0.5, 0.5);
-	Vector3 spot_axis = to_cell_space.basis.xform(p_axis).normalized();
+void VoxelLightBaker::_plot_light_spot_leaf(uint32_t p_leaf, const PlotLight *p_light) {
 
-	float local_radius = to_cell_space.basis.xform(Vector3(0, 0, 1)).length() * p_radius;
+	uint32_t idx = leaf_cells[p_leaf];
+	const Cell *cells = p_light->cells;
+	Light *light = &p_light->light_data[idx];
+	const Vector3 &light_pos = p_light->pos;
+	const Vector3 &spot_axis = p_light->axis;
+	const Vector3 &light_energy = p_light->energy;
 
-	Light *light_data = bake_light.ptrw();
-	const Cell *cells = bake_cells.ptr();
-	Vector3 light_energy = Vector3(p_color.r, p_color.g, p_color.b) * p_energy * p_indirect_energy;
+	Plane clip[3];
+	int clip_planes = 0;
 
-	int idx = first_leaf;
-	while (idx >= 0) {
+	Vector3 to(light->x + 0.5, light->y + 0.5, light->z + 0.5);
 
-		//print_line("plot idx " + itos(idx));
-		Light *light = &light_data[idx];
+	Vector3 light_axis = (to - light_pos).normalized();
+	float distance_adv = _get_normal_advance(light_axis);
 
-		Vector3 to(light->x + 0.5, light->y + 0.5, light->z + 0.5);
+	Vector3 normal(cells[idx].normal[0], cells[idx].normal[1], cells[idx].normal[2]);
 
-		Vector3 light_axis = (to - light_pos).normalized();
-		float distance_adv = _get_normal_advance(light_axis);
+	if (normal != Vector3() && normal.dot(-light_axis) < 0.001) {
+		return;
+	}
 
-		Vector3 normal(cells[idx].normal[0], cells[idx].normal[1], cells[idx].normal[2]);
+	float angle = Math::rad2deg(Math::acos(light_axis.dot(-spot_axis)));
+	if (angle > p_light->spot_angle) {
+		return; // too far away
+	}
 
-		if (normal != Vector3() && normal.dot(-light_axis) < 0.001) {
-			idx = light_data[idx].next_leaf;
-			continue;
-		}
+	float att = Math::pow(1.0f - angle / p_light->spot_angle, p_light->spot_attenuation);
 
-		float angle = Math::rad2deg(Math::acos(light_axis.dot(-spot_axis)));
-		if (angle > p_spot_angle) {
-			idx = light_data[idx].next_leaf;
-			continue; // too far away
+	{
+		float d = light_pos.distance_to(to);
+		if (d + distance_adv > p_light->radius) {
+			return; // too far away
 		}
 
-		float att = Math::pow(1.0f - angle / p_spot_angle, p_spot_attenuation);
+		float dt = CLAMP((d + distance_adv) / p_light->radius, 0, 1);
+		att *= powf(1.0 - dt, p_light->attenuation);
+	}
+
+	for (int c = 0; c < 3; c++) {
 
-		{
-			float d = light_pos.distance_to(to);
-			if (d + distance_adv > local_radius) {
-				idx = light_data[idx].next_leaf;
-				continue; // too far away
-			}
+		if (ABS(light_axis[c]) < CMP_EPSILON)
+			continue;
+		clip[clip_planes].normal[c] = 1.0;
+
+		if (light_axis[c] < 0) {
 
-			float dt = CLAMP((d + distance_adv) / local_radius, 0, 1);
-			att *= powf(1.0 - dt, p_attenutation);
+			clip[clip_planes].d = (1 << (cell_subdiv - 1)) + 1;
+		} else {
+			clip[clip_planes].d -= 1.0;
 		}
 
-		clip_planes = 0;
+		clip_planes++;
+	}
 
-		for (int c = 0; c < 3; c++) {
+	Vector3 from = light_pos;
 
-			if (ABS(light_axis[c]) < CMP_EPSILON)
-				continue;
-			clip[clip_planes].normal[c] = 1.0;
+	for (int j = 0; j < clip_planes; j++) {
 
-			if (light_axis[c] < 0) {
+		clip[j].intersects_segment(from, to, &from);
+	}
 
-				clip[clip_planes].d = (1 << (cell_subdiv - 1)) + 1;
-			} else {
-				clip[clip_planes].d -= 1.0;
-			}
+	float distance = (to - from).length();
 
-			clip_planes++;
-		}
+	distance -= Math::fmod(distance, distance_adv); //make it reach the center of the box always, but this tame make it closer
+	from = to - light_axis * distance;
 
-		Vector3 from = light_pos;
+	uint32_t result = 0xFFFFFFFF;
 
-		for (int j = 0; j < clip_planes; j++) {
+	while (distance > -distance_adv) { //use this to avoid precision errors
 
-			clip[j].intersects_segment(from, to, &from);
+		result = _find_cell_at_pos(cells, int(floor(from.x)), int(floor(from.y)), int(floor(from.z)));
+		if (result != 0xFFFFFFFF) {
+			break;
 		}
 
-		float distance = (to - from).length();
+		from += light_axis * distance_adv;
+		distance -= distance_adv;
+	}
 
-		distance -= Math::fmod(distance, distance_adv); //make it reach the center of the box always, but this tame make it closer
-		from = to - light_axis * distance;
+	if (result == idx) {
+		//cell hit itself! hooray!
 
-		uint32_t result = 0xFFFFFFFF;
+		if (normal == Vector3()) {
+			for (int i = 0; i < 6; i++) {
+				light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * att;
+				light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * att;
+				light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * att;
+			}
 
-		while (distance > -distance_adv) { //use this to avoid precision errors
+		} else {
 
-			result = _find_cell_at_pos(cells, int(floor(from.x)), int(floor(from.y)), int(floor(from.z)));
-			if (result != 0xFFFFFFFF) {
-				break;
+			for (int i = 0; i < 6; i++) {
+				float s = MAX(0.0, aniso_normal[i].dot(-normal));
+				light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * s * att;
+				light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * s * att;
+				light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * s * att;
 			}
-
-			from += light_axis * distance_adv;
-			distance -= distance_adv;
 		}
 
-		if (result == idx) {
-			//cell hit itself! hooray!
-
-			if (normal == Vector3()) {
-				for (int i = 0; i < 6; i++) {
-					light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * att;
-					light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * att;
-					light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * att;
-				}
+		if (p_light->direct) {
+			for (int i = 0; i < 6; i++) {
+				float s = MAX(0.0, aniso_normal[i].dot(-light_axis)); //light depending on normal for direct
+				light->direct_accum[i][0] += light_energy.x * s * att;
+				light->direct_accum[i][1] += light_energy.y * s * att;
+				light->direct_accum[i][2] += light_energy.z * s * att;
+			}
+		}
+	}
+}
 
-			} else {
+void VoxelLightBaker::plot_light_spot(const Vector3 &p_pos, const Vector3 &p_axis, const Color &p_color, float p_energy, float p_indirect_energy, float p_radius, float p_attenutation, float p_spot_angle, float p_spot_attenuation, bool p_direct) {
 
-				for (int i = 0; i < 6; i++) {
-					float s = MAX(0.0, aniso_normal[i].dot(-normal));
-					light->accum[i][0] += light_energy.x * cells[idx].albedo[0] * s * att;
-					light->accum[i][1] += light_energy.y * cells[idx].albedo[1] * s * att;
-					light->accum[i][2] += light_energy.z * cells[idx].albedo[2] * s * att;
-				}
-			}
+	_check_init_light();
 
-			if (p_direct) {
-				for (int i = 0; i < 6; i++) {
-					float s = MAX(0.0, aniso_normal[i].dot(-light_axis)); //light depending on normal for direct
-					light->direct_accum[i][0] += light_energy.x * s * att;
-					light->direct_accum[i][1] += light_energy.y * s * att;
-					light->direct_accum[i][2] += light_energy.z * s * att;
-				}
-			}
-		}
+	if (p_direct)
+		direct_lights_baked = true;
 
-		idx = light_data[idx].next_leaf;
-	}
+	PlotLight plot;
+	plot.light_data = bake_light.ptrw();
+	plot.cells = bake_cells.ptr();
+	plot.pos = to_cell_space.xform(p_pos) + Vector3(0.5, 0.5, 0.5);
+	plot.axis = to_cell_space.basis.xform(p_axis).normalized();
+	plot.radius = to_cell_space.basis.xform(Vector3(0, 0, 1)).length() * p_radius;
+	plot.attenuation = p_attenutation;
+	plot.spot_angle = p_spot_angle;
+	plot.spot_attenuation = p_spot_attenuation;
+	plot.energy = Vector3(p_color.r, p_color.g, p_color.b) * p_energy * p_indirect_energy;
+	plot.direct = p_direct;
+
+	thread_process_array(leaf_cells.size(), this, &VoxelLightBaker::_plot_light_spot_leaf, (const PlotLight *)&plot);
 }
 
-void VoxelLightBaker::_fixup_plot(int p_idx, int p_level) {
+int VoxelLightBaker::_fixup_plot(int p_idx, int p_level, int p_threaded_level) {
 
 	if (p_level == cell_subdiv - 1) {
 
-		leaf_voxel_count++;
 		float alpha = bake_cells[p_idx].alpha;
 
 		bake_cells.write[p_idx].albedo[0] /= alpha;
@@ -1231,6 +1290,8 @@ void VoxelLightBaker::_fixup_plot(int p_idx, int p_level) {
 			}
 		}*/
 
+		return 1;
+
 	} else {
 
 		//go down
@@ -1254,6 +1315,7 @@ void VoxelLightBaker::_fixup_plot(int p_idx, int p_level) {
 
 		float alpha_average = 0;
 		int children_found = 0;
+		int leaf_count = 0;
 
 		for (int i = 0; i < 8; i++) {
 
@@ -1262,7 +1324,9 @@ void VoxelLightBaker::_fixup_plot(int p_idx, int p_level) {
 			if (child == CHILD_EMPTY)
 				continue;
 
-			_fixup_plot(child, p_level + 1);
+			if (p_level + 1 != p_threaded_level) { //otherwise already fixed up
+				leaf_count += _fixup_plot(child, p_level + 1, p_threaded_level);
+			}
 			alpha_average += bake_cells[child].alpha;
 
 			if (bake_light.size() > 0) {
@@ -1291,9 +1355,62 @@ void VoxelLightBaker::_fixup_plot(int p_idx, int p_level) {
 			bake_cells.write[p_idx].emission[1] /= divisor;
 			bake_cells.write[p_idx].emission[2] /= divisor;
 		}
+
+		return leaf_count;
 	}
 }
 
+void VoxelLightBaker::_fixup_plot_subtree(uint32_t p_index, FixupPlotData *p_data) {
+
+	p_data->leaf_counts[p_index] = _fixup_plot(p_data->subtrees[p_index], FIXUP_THREAD_LEVEL);
+}
+
+void VoxelLightBaker::_get_cells_at_level(uint32_t p_idx, int p_level, int p_target_level, Vector<uint32_t> &r_cells) {
+
+	if (p_level == p_target_level) {
+		r_cells.push_back(p_idx);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++) {
+
+		uint32_t child = bake_cells[p_idx].children[i];
+		if (child != CHILD_EMPTY) {
+			_get_cells_at_level(child, p_level + 1, p_target_level, r_cells);
+		}
+	}
+}
+
+int VoxelLightBaker::_fixup_plot_threaded() {
+
+	if (FIXUP_THREAD_LEVEL >= cell_subdiv - 1) {
+		return _fixup_plot(0, 0);
+	}
+
+	//subtrees don't share any cells, so they can be fixed up in parallel, then the levels above them
+	Vector<uint32_t> subtrees;
+	_get_cells_at_level(0, 0, FIXUP_THREAD_LEVEL, subtrees);
+
+	Vector<int> leaf_counts;
+	leaf_counts.resize(subtrees.size());
+
+	bake_cells.ptrw(); //make sure it's not shared before writing from threads
+	bake_light.ptrw();
+
+	FixupPlotData data;
+	data.subtrees = subtrees.ptr();
+	data.leaf_counts = leaf_counts.ptrw();
+
+	thread_process_array(subtrees.size(), this, &VoxelLightBaker::_fixup_plot_subtree, &data);
+
+	int leaf_count = _fixup_plot(0, 0, FIXUP_THREAD_LEVEL);
+	for (int i = 0; i < leaf_counts.size(); i++) {
+		leaf_count += leaf_counts[i];
+	}
+
+	return leaf_count;
+}
+
 //make sure any cell (save for the root) has an empty cell previous to it, so it can be interpolated into
 
 void VoxelLightBaker::_plot_triangle(Vector2 *vertices, Vector3 *positions, Vector3 *normals, LightMap *pixels, int width, int height) {
@@ -1687,6 +1804,17 @@ _ALWAYS_INLINE_ uint32_t xorshift32(uint32_t *state) {
 	return x;
 }
 
+static _ALWAYS_INLINE_ Vector3 _get_ray_trace_direction(uint32_t *p_rng_state, const Basis &p_normal_xform, float p_spread) {
+
+	float random_angle1 = (((xorshift32(p_rng_state) % 65535) / 65535.0) * 2.0 - 1.0) * p_spread;
+	Vector3 axis(0, sin(random_angle1), cos(random_angle1));
+	float random_angle2 = ((xorshift32(p_rng_state) % 65535) / 65535.0) * Math_PI * 2.0;
+	Basis rot(Vector3(0, 0, 1), random_angle2);
+	axis = rot.xform(axis);
+
+	return p_normal_xform.xform(axis).normalized();
+}
+
 Vector3 VoxelLightBaker::_compute_ray_trace_at_pos(const Vector3 &p_pos, const Vector3 &p_normal) {
 
 	int samples_per_quality[3] = { 48, 128, 512 };
@@ -1708,18 +1836,57 @@ Vector3 VoxelLightBaker::_compute_ray_trace_at_pos(const Vector3 &p_pos, const V
 
 	const Light *light = bake_light.ptr();
 	const Cell *cells = bake_cells.ptr();
+	const TriangleMesh *mesh = ray_mesh.is_valid() ? ray_mesh.ptr() : NULL;
 
 	uint32_t local_rng_state = rand(); //needs to be fixed again
 
-	for (int i = 0; i < samples; i++) {
+	if (mesh) {
+		//trace against the actual faces in one batch, then read the light stored in the voxels that were hit
+		Vector3 *origins = (Vector3 *)alloca(sizeof(Vector3) * samples);
+		Vector3 *directions = (Vector3 *)alloca(sizeof(Vector3) * samples);
+		TriangleMesh::RayResult *hits = (TriangleMesh::RayResult *)alloca(sizeof(TriangleMesh::RayResult) * samples);
 
-		float random_angle1 = (((xorshift32(&local_rng_state) % 65535) / 65535.0) * 2.0 - 1.0) * spread;
-		Vector3 axis(0, sin(random_angle1), cos(random_angle1));
-		float random_angle2 = ((xorshift32(&local_rng_state) % 65535) / 65535.0) * Math_PI * 2.0;
-		Basis rot(Vector3(0, 0, 1), random_angle2);
-		axis = rot.xform(axis);
+		for (int i = 0; i < samples; i++) {
+			origins[i] = p_pos + p_normal * 0.01;
+			directions[i] = _get_ray_trace_direction(&local_rng_state, normal_xform, spread);
+		}
+
+		mesh->intersect_rays(origins, directions, hits, samples);
+
+		for (int i = 0; i < samples; i++) {
+
+			if (!hits[i].hit)
+				continue;
 
-		Vector3 direction = normal_xform.xform(axis).normalized();
+			const Vector3 &direction = directions[i];
+			Vector3 hit = hits[i].point - direction * 0.01; //stay on this side of the face
+			uint32_t cell = _find_cell_at_pos(cells, int(floor(hit.x)), int(floor(hit.y)), int(floor(hit.z)));
+			if (cell == CHILD_EMPTY) {
+				hit -= direction * 0.5;
+				cell = _find_cell_at_pos(cells, int(floor(hit.x)), int(floor(hit.y)), int(floor(hit.z)));
+				if (cell == CHILD_EMPTY)
+					continue;
+			}
+
+			for (int j = 0; j < 6; j++) {
+				float amount = direction.dot(aniso_normal[j]);
+				if (amount <= 0)
+					continue;
+				accum.x += light[cell].accum[j][0] * amount;
+				accum.y += light[cell].accum[j][1] * amount;
+				accum.z += light[cell].accum[j][2] * amount;
+			}
+			accum.x += cells[cell].emission[0];
+			accum.y += cells[cell].emission[1];
+			accum.z += cells[cell].emission[2];
+		}
+
+		return accum / samples;
+	}
+
+	for (int i = 0; i < samples; i++) {
+
+		Vector3 direction = _get_ray_trace_direction(&local_rng_state, normal_xform, spread);
 
 		Vector3 advance = direction * _get_normal_advance(direction);
 
@@ -1797,6 +1964,19 @@ Vector3 VoxelLightBaker::_compute_ray_trace_at_pos(const Vector3 &p_pos, const V
 	return accum / samples;
 }
 
+void VoxelLightBaker::_check_init_ray_mesh() {
+
+	if (ray_mesh.is_valid() || ray_faces.size() == 0)
+		return;
+
+	//bvh over every plotted face, so rays don't leak through or get blocked by coarse voxels
+	ray_mesh.instance();
+	ray_mesh->create(ray_faces);
+	if (!ray_mesh->is_valid()) {
+		ray_mesh.unref();
+	}
+}
+
 void VoxelLightBaker::_lightmap_bake_point(uint32_t p_x, LightMap *p_line) {
 
 	LightMap *pixel = &p_line[p_x];
@@ -1870,6 +2050,10 @@ Error VoxelLightBaker::make_lightmap(const Transform &p_xform, Ref<Mesh> &p_mesh
 		}
 	}
 
+	if (bake_mode == BAKE_MODE_RAY_TRACE) {
+		_check_init_ray_mesh();
+	}
+
 	//step 3 perform voxel cone trace on lightmap pixels
 	{
 		LightMap *lightmap_ptr = lightmap.ptrw();
@@ -2125,6 +2309,8 @@ void VoxelLightBaker::begin_bake(int p_subdiv, const AABB &p_bounds) {
 	cell_subdiv = p_subdiv;
 	bake_cells.resize(1);
 	material_cache.clear();
+	ray_faces.resize(0);
+	ray_mesh.unref();
 
 	//find out the actual real bounds, power of 2, which gets the highest subdivision
 	po2_bounds = p_bounds;
@@ -2162,7 +2348,7 @@ void VoxelLightBaker::begin_bake(int p_subdiv, const AABB &p_bounds) {
 }
 
 void VoxelLightBaker::end_bake() {
-	_fixup_plot(0, 0);
+	leaf_voxel_count += _fixup_plot_threaded();
 }
 
 //create the data for visual server
@@ -58,6 +58,11 @@ private:
 
 	};
 
+	enum {
+		PLOT_MIN_FACES_PER_THREAD = 64, //each face is costly to plot, so small batches already pay off
+		FIXUP_THREAD_LEVEL = 2 //subtrees below this level are fixed up in parallel
+	};
+
 	struct Cell {
 
 		uint32_t children[8];
@@ -91,10 +96,9 @@ private:
 		int x, y, z;
 		float accum[6][3]; //rgb anisotropic
 		float direct_accum[6][3]; //for direct bake
-		int next_leaf;
 	};
 
-	int first_leaf;
+	Vector<uint32_t> leaf_cells;
 
 	Vector<Light> bake_light;
 
@@ -104,6 +108,43 @@ private:
 		Vector<Color> emission;
 	};
 
+	struct PlotFace {
+		Vector3 vtx[3];
+		Vector3 normal[3];
+		Vector2 uv[3];
+		int material;
+	};
+
+	struct PlotMeshData {
+		const PlotFace *faces;
+		int face_count;
+		int thread_count;
+		const MaterialCache *materials;
+		Vector<Cell> *thread_cells; //each thread plots into its own octree, merged afterwards
+	};
+
+	struct PlotLight {
+		Light *light_data;
+		const Cell *cells;
+		Vector3 energy;
+		Vector3 pos; //omni and spot, in cell space
+		Vector3 axis; //light direction or spot axis
+		float radius;
+		float attenuation;
+		float spot_angle;
+		float spot_attenuation;
+		float max_len; //directional only
+		float distance_adv; //directional only
+		Plane clip[3]; //directional only
+		int clip_planes;
+		bool direct;
+	};
+
+	struct FixupPlotData {
+		const uint32_t *subtrees;
+		int *leaf_counts;
+	};
+
 	Map<Ref<Material>, MaterialCache> material_cache;
 	int leaf_voxel_count;
 	bool direct_lights_baked;
@@ -125,13 +166,24 @@ private:
 
 	int max_original_cells;
 
+	PoolVector<Vector3> ray_faces; //plotted faces in cell space, for ray tracing against real geometry
+	Ref<TriangleMesh> ray_mesh;
+
 	void _init_light_plot(int p_idx, int p_level, int p_x, int p_y, int p_z, uint32_t p_parent);
 
 	Vector<Color> _get_bake_texture(Ref<Image> p_image, const Color &p_color_mul, const Color &p_color_add);
 	MaterialCache _get_material_cache(Ref<Material> p_material);
 
-	void _plot_face(int p_idx, int p_level, int p_x, int p_y, int p_z, const Vector3 *p_vtx, const Vector3 *p_normal, const Vector2 *p_uv, const MaterialCache &p_material, const AABB &p_aabb);
-	void _fixup_plot(int p_idx, int p_level);
+	void _plot_face(int p_idx, int p_level, int p_x, int p_y, int p_z, const Vector3 *p_vtx, const Vector3 *p_normal, const Vector2 *p_uv, const MaterialCache &p_material, const AABB &p_aabb, Vector<Cell> &r_cells);
+	void _plot_mesh_thread(uint32_t p_thread, PlotMeshData *p_data);
+	void _merge_plot_cells(uint32_t p_idx, const Cell *p_cells, uint32_t p_from_idx);
+	int _fixup_plot(int p_idx, int p_level, int p_threaded_level = -1);
+	void _fixup_plot_subtree(uint32_t p_index, FixupPlotData *p_data);
+	void _get_cells_at_level(uint32_t p_idx, int p_level, int p_target_level, Vector<uint32_t> &r_cells);
+	int _fixup_plot_threaded();
+	void _plot_light_directional_leaf(uint32_t p_leaf, const PlotLight *p_light);
+	void _plot_light_omni_leaf(uint32_t p_leaf, const PlotLight *p_light);
+	void _plot_light_spot_leaf(uint32_t p_leaf, const PlotLight *p_light);
 	void _debug_mesh(int p_idx, int p_level, const AABB &p_aabb, Ref<MultiMesh> &p_multimesh, int &idx, DebugMode p_mode);
 	void _check_init_light();
 
@@ -151,6 +203,7 @@ private:
 	_FORCE_INLINE_ Vector3 _compute_ray_trace_at_pos(const Vector3 &p_pos, const Vector3 &p_normal);
 
 	void _lightmap_bake_point(uint32_t p_x, LightMap *p_line);
+	void _check_init_ray_mesh();
 
 public:
 	void begin_bake(int p_subdiv, const AABB &p_bounds);
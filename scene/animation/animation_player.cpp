@@ -32,6 +32,9 @@
 
 #include "engine.h"
 #include "message_queue.h"
+#include "scene/2d/visibility_notifier_2d.h"
+#include "scene/3d/camera.h"
+#include "scene/3d/visibility_notifier.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
 #ifdef TOOLS_ENABLED
@@ -200,7 +203,7 @@ void AnimationPlayer::_notification(int p_what) {
 				break;
 
 			if (processing)
-				_animation_process(get_process_delta_time());
+				_culling_process(get_process_delta_time());
 		} break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
 
@@ -208,15 +211,87 @@ void AnimationPlayer::_notification(int p_what) {
 				break;
 
 			if (processing)
-				_animation_process(get_physics_process_delta_time());
+				_culling_process(get_physics_process_delta_time());
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
 
 			clear_caches();
+			culling_notifier_id = 0;
 		} break;
 	}
 }
 
+Node *AnimationPlayer::_get_culling_notifier() {
+
+	if (culling_notifier.is_empty()) {
+		return NULL;
+	}
+
+	Node *notifier = Object::cast_to<Node>(ObjectDB::get_instance(culling_notifier_id));
+	if (!notifier && has_node(culling_notifier)) {
+		notifier = get_node(culling_notifier);
+		culling_notifier_id = notifier->get_instance_id();
+	}
+
+	return notifier;
+}
+
+void AnimationPlayer::_culling_process(float p_delta) {
+
+	Node *notifier = Engine::get_singleton()->is_editor_hint() ? NULL : _get_culling_notifier();
+
+	if (!notifier) {
+		_animation_process(p_delta);
+		return;
+	}
+
+	culling_delta += p_delta;
+
+	// seeks and newly started animations are always applied right away
+	if (!playback.seeked && !playback.started) {
+
+		bool on_screen = true;
+		bool distant = false;
+
+		VisibilityNotifier *notifier_3d = Object::cast_to<VisibilityNotifier>(notifier);
+		VisibilityNotifier2D *notifier_2d = Object::cast_to<VisibilityNotifier2D>(notifier);
+
+		if (notifier_3d) {
+
+			on_screen = notifier_3d->is_on_screen();
+
+			if (on_screen && culling_distance > 0) {
+				Camera *camera = notifier_3d->get_viewport()->get_camera();
+				if (camera) {
+					AABB aabb = notifier_3d->get_aabb();
+					Vector3 center = notifier_3d->get_global_transform().xform(aabb.position + aabb.size * 0.5);
+					distant = camera->get_global_transform().origin.distance_to(center) > culling_distance;
+				}
+			}
+		} else if (notifier_2d) {
+
+			on_screen = notifier_2d->is_on_screen();
+		}
+
+		if (!on_screen) {
+			return; //paused, the time is caught up when visible again
+		}
+
+		if (distant) {
+			culling_frame++;
+			if (culling_frame < culling_distant_interval) {
+				return;
+			}
+		}
+	}
+
+	float delta = culling_delta;
+	culling_frame = 0;
+	culling_delta = 0;
+
+	_animation_process(delta);
+}
+
 void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 
 	// Already cached?
@@ -313,6 +388,11 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 				pa.object = resource.is_valid() ? (Object *)resource.ptr() : (Object *)child;
 				pa.special = SP_NONE;
 				pa.owner = p_anim->node_cache[i];
+				if (leftover_path.size() == 1 && pa.object->get_script_instance()) {
+					pa.script_instance = pa.object->get_script_instance();
+					pa.member_handle = pa.script_instance->get_member_handle(leftover_path[0]);
+					pa.member_handle_version = pa.script_instance->get_member_handle_version();
+				}
 				if (false && p_anim->node_cache[i]->node_2d) {
 
 					if (leftover_path.size() == 1 && leftover_path[0] == SceneStringNames::get_singleton()->transform_pos)
@@ -341,6 +421,21 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 	}
 }
 
+bool AnimationPlayer::_set_property_anim_value(TrackNodeCache::PropertyAnim *p_pa, const Variant &p_value) {
+
+	if (p_pa->member_handle >= 0) {
+		ScriptInstance *si = p_pa->object->get_script_instance();
+		if (si && si == p_pa->script_instance && si->get_member_handle_version() == p_pa->member_handle_version) {
+			return si->set_member(p_pa->member_handle, p_value);
+		}
+		p_pa->member_handle = -1; //script changed or was reloaded, use the regular path from now on
+	}
+
+	bool valid;
+	p_pa->object->set_indexed(p_pa->subpath, p_value, &valid);
+	return valid;
+}
+
 void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started) {
 
 	_ensure_node_caches(p_anim);
@@ -349,6 +444,14 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 	Animation *a = p_anim->animation.operator->();
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
+	if (p_anim->key_cursors.size() != a->get_track_count()) {
+		p_anim->key_cursors.resize(a->get_track_count());
+		for (int i = 0; i < p_anim->key_cursors.size(); i++) {
+			p_anim->key_cursors.write[i] = -1;
+		}
+	}
+	int *key_cursors = p_anim->key_cursors.ptrw();
+
 	for (int i = 0; i < a->get_track_count(); i++) {
 
 		TrackNodeCache *nc = p_anim->node_cache[i];
@@ -373,7 +476,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				Quat rot;
 				Vector3 scale;
 
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
+				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale, &key_cursors[i]);
 				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
 
 				if (err != OK)
@@ -483,8 +586,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 						switch (pa->special) {
 
 							case SP_NONE: {
-								bool valid;
-								pa->object->set_indexed(pa->subpath, value, &valid); //you are not speshul
+								bool valid = _set_property_anim_value(pa, value); //you are not speshul
 #ifdef DEBUG_ENABLED
 								if (!valid) {
 									ERR_PRINTS("Failed setting track value '" + String(pa->owner->path) + "'. Check if property exists or the type of key is valid. Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
@@ -864,8 +966,7 @@ void AnimationPlayer::_animation_update_transforms() {
 		switch (pa->special) {
 
 			case SP_NONE: {
-				bool valid;
-				pa->object->set_indexed(pa->subpath, pa->value_accum, &valid); //you are not speshul
+				bool valid = _set_property_anim_value(pa, pa->value_accum); //you are not speshul
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					ERR_PRINTS("Failed setting key at time " + rtos(playback.current.pos) + " in Animation '" + get_current_animation() + "' at Node '" + get_path() + "', Track '" + String(pa->owner->path) + "'. Check if property exists or the type of key is right for the property");
@@ -1284,6 +1385,8 @@ void AnimationPlayer::stop(bool p_reset) {
 	_set_process(false);
 	queued.clear();
 	playing = false;
+	culling_frame = 0;
+	culling_delta = 0;
 }
 
 void AnimationPlayer::set_speed_scale(float p_speed) {
@@ -1314,6 +1417,7 @@ void AnimationPlayer::seek(float p_time, bool p_update) {
 
 	playback.current.pos = p_time;
 	playback.seeked = true;
+	culling_delta = 0;
 	if (p_update) {
 		_animation_process(0);
 	}
@@ -1451,6 +1555,38 @@ AnimationPlayer::AnimationProcessMode AnimationPlayer::get_animation_process_mod
 	return animation_process_mode;
 }
 
+void AnimationPlayer::set_culling_notifier(const NodePath &p_notifier) {
+
+	culling_notifier = p_notifier;
+	culling_notifier_id = 0;
+}
+
+NodePath AnimationPlayer::get_culling_notifier() const {
+
+	return culling_notifier;
+}
+
+void AnimationPlayer::set_culling_distance(float p_distance) {
+
+	culling_distance = p_distance;
+}
+
+float AnimationPlayer::get_culling_distance() const {
+
+	return culling_distance;
+}
+
+void AnimationPlayer::set_culling_distant_interval(int p_frames) {
+
+	ERR_FAIL_COND(p_frames < 1);
+	culling_distant_interval = p_frames;
+}
+
+int AnimationPlayer::get_culling_distant_interval() const {
+
+	return culling_distant_interval;
+}
+
 void AnimationPlayer::_set_process(bool p_process, bool p_force) {
 
 	if (processing == p_process && !p_force)
@@ -1630,6 +1766,15 @@ void AnimationPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_animation_process_mode", "mode"), &AnimationPlayer::set_animation_process_mode);
 	ClassDB::bind_method(D_METHOD("get_animation_process_mode"), &AnimationPlayer::get_animation_process_mode);
 
+	ClassDB::bind_method(D_METHOD("set_culling_notifier", "path"), &AnimationPlayer::set_culling_notifier);
+	ClassDB::bind_method(D_METHOD("get_culling_notifier"), &AnimationPlayer::get_culling_notifier);
+
+	ClassDB::bind_method(D_METHOD("set_culling_distance", "distance"), &AnimationPlayer::set_culling_distance);
+	ClassDB::bind_method(D_METHOD("get_culling_distance"), &AnimationPlayer::get_culling_distance);
+
+	ClassDB::bind_method(D_METHOD("set_culling_distant_interval", "frames"), &AnimationPlayer::set_culling_distant_interval);
+	ClassDB::bind_method(D_METHOD("get_culling_distant_interval"), &AnimationPlayer::get_culling_distant_interval);
+
 	ClassDB::bind_method(D_METHOD("get_current_animation_position"), &AnimationPlayer::get_current_animation_position);
 	ClassDB::bind_method(D_METHOD("get_current_animation_length"), &AnimationPlayer::get_current_animation_length);
 
@@ -1649,6 +1794,11 @@ void AnimationPlayer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_active", PROPERTY_HINT_NONE, "", 0), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "playback_speed", PROPERTY_HINT_RANGE, "-64,64,0.01"), "set_speed_scale", "get_speed_scale");
 
+	ADD_GROUP("Culling", "culling_");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "culling_notifier", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "VisibilityNotifier,VisibilityNotifier2D"), "set_culling_notifier", "get_culling_notifier");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "culling_distance", PROPERTY_HINT_RANGE, "0,4096,0.1,or_greater"), "set_culling_distance", "get_culling_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "culling_distant_interval", PROPERTY_HINT_RANGE, "1,60,1"), "set_culling_distant_interval", "get_culling_distant_interval");
+
 	ADD_SIGNAL(MethodInfo("animation_finished", PropertyInfo(Variant::STRING, "anim_name")));
 	ADD_SIGNAL(MethodInfo("animation_changed", PropertyInfo(Variant::STRING, "old_name"), PropertyInfo(Variant::STRING, "new_name")));
 	ADD_SIGNAL(MethodInfo("animation_started", PropertyInfo(Variant::STRING, "anim_name")));
@@ -1675,6 +1825,11 @@ AnimationPlayer::AnimationPlayer() {
 	active = true;
 	playback.seeked = false;
 	playback.started = false;
+	culling_notifier_id = 0;
+	culling_distance = 0;
+	culling_distant_interval = 4;
+	culling_frame = 0;
+	culling_delta = 0;
 }
 
 AnimationPlayer::~AnimationPlayer() {
@@ -113,9 +113,16 @@ private:
 			Variant value_accum;
 			uint64_t accum_pass;
 			Variant capture;
+			// script members are written through a handle, resolved when the cache is built
+			ScriptInstance *script_instance;
+			int member_handle;
+			uint64_t member_handle_version;
 			PropertyAnim() {
 				accum_pass = 0;
 				object = NULL;
+				script_instance = NULL;
+				member_handle = -1;
+				member_handle_version = 0;
 			}
 		};
 
@@ -185,6 +192,7 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache *> node_cache;
+		Vector<int> key_cursors; // last key found per track, speeds up forward playback
 		Ref<Animation> animation;
 	};
 
@@ -247,9 +255,20 @@ private:
 
 	NodePath root;
 
+	NodePath culling_notifier;
+	ObjectID culling_notifier_id;
+	float culling_distance;
+	int culling_distant_interval;
+	int culling_frame;
+	float culling_delta;
+
+	Node *_get_culling_notifier();
+	void _culling_process(float p_delta);
+
 	void _animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false);
 
 	void _ensure_node_caches(AnimationData *p_anim);
+	bool _set_property_anim_value(TrackNodeCache::PropertyAnim *p_pa, const Variant &p_value);
 	void _animation_process_data(PlaybackData &cd, float p_delta, float p_blend, bool p_seeked, bool p_started);
 	void _animation_process2(float p_delta, bool p_started);
 	void _animation_update_transforms();
@@ -343,6 +362,15 @@ public:
 	void set_root(const NodePath &p_root);
 	NodePath get_root() const;
 
+	void set_culling_notifier(const NodePath &p_notifier);
+	NodePath get_culling_notifier() const;
+
+	void set_culling_distance(float p_distance);
+	float get_culling_distance() const;
+
+	void set_culling_distant_interval(int p_frames);
+	int get_culling_distant_interval() const;
+
 	void clear_caches(); ///< must be called by hand if an animation was modified after added
 
 	void get_argument_options(const StringName &p_function, int p_idx, List<String> *r_options) const;
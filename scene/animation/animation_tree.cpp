@@ -1,7 +1,9 @@
 #include "animation_tree.h"
 #include "animation_blend_tree.h"
 #include "core/method_bind_ext.gen.inc"
+#include "core/os/worker_thread_pool.h"
 #include "engine.h"
+#include "message_queue.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
 
@@ -447,6 +449,10 @@ void AnimationTree::set_active(bool p_active) {
 	active = p_active;
 	started = active;
 
+	if (!active) {
+		_dequeue_process_graph();
+	}
+
 	if (process_mode == ANIMATION_PROCESS_IDLE) {
 		set_process_internal(active);
 	} else {
@@ -512,6 +518,11 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 
 	for (List<StringName>::Element *E = sname.front(); E; E = E->next()) {
 		Ref<Animation> anim = player->get_animation(E->get());
+
+		if (!anim->is_connected("changed", this, "_animation_changed")) {
+			anim->connect("changed", this, "_animation_changed");
+		}
+
 		for (int i = 0; i < anim->get_track_count(); i++) {
 			NodePath path = anim->track_get_path(i);
 			Animation::TrackType track_type = anim->track_get_type(i);
@@ -670,11 +681,16 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 	}
 
 	state.track_map.clear();
+	track_cache_list.clear();
+	animation_track_maps.clear();
 
 	K = NULL;
 	int idx = 0;
 	while ((K = track_cache.next(K))) {
+		TrackCache *tc = track_cache[*K];
+		tc->root_motion = root_motion_track == *K;
 		state.track_map[*K] = idx;
+		track_cache_list.push_back(tc);
 		idx++;
 	}
 
@@ -694,10 +710,45 @@ void AnimationTree::_clear_caches() {
 	playing_caches.clear();
 
 	track_cache.clear();
+	track_cache_list.clear();
+	animation_track_maps.clear();
 	cache_valid = false;
 }
 
-void AnimationTree::_process_graph(float p_delta) {
+AnimationTree::AnimationTrackMap *AnimationTree::_get_animation_track_map(Animation *p_animation) {
+
+	AnimationTrackMap &track_map = animation_track_maps[p_animation->get_instance_id()];
+
+	int track_count = p_animation->get_track_count();
+	if (track_map.blend_indices.size() == track_count) {
+		return &track_map;
+	}
+
+	// resolve track paths once, so processing only deals with indices
+	track_map.blend_indices.resize(track_count);
+	track_map.key_cursors.resize(track_count);
+
+	for (int i = 0; i < track_count; i++) {
+
+		int blend_idx = -1;
+		const int *idx = state.track_map.getptr(p_animation->track_get_path(i));
+		if (idx && track_cache_list[*idx]->type == p_animation->track_get_type(i)) {
+			blend_idx = *idx;
+		}
+
+		track_map.blend_indices.write[i] = blend_idx;
+		track_map.key_cursors.write[i] = -1;
+	}
+
+	return &track_map;
+}
+
+void AnimationTree::_animation_changed() {
+
+	cache_valid = false;
+}
+
+bool AnimationTree::_process_graph_begin() {
 
 	//check all tracks, see if they need modification
 	root_motion_transform = Transform();
@@ -706,14 +757,14 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: root AnimationNode is not set, disabling playback.");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!has_node(animation_player)) {
 		ERR_PRINT("AnimationTree: no valid AnimationPlayer path set, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(get_node(animation_player));
@@ -722,15 +773,22 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: path points to a node not an AnimationPlayer, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!cache_valid) {
 		if (!_update_caches(player)) {
-			return;
+			return false;
 		}
 	}
 
+	state.player = player;
+
+	return true;
+}
+
+void AnimationTree::_process_graph_evaluate(float p_delta) {
+
 	{ //setup
 
 		process_pass++;
@@ -739,7 +797,6 @@ void AnimationTree::_process_graph(float p_delta) {
 		state.invalid_reasons = "";
 		state.animation_states.clear(); //will need to be re-created
 		state.valid = true;
-		state.player = player;
 		state.last_pass = process_pass;
 
 		// root source blends
@@ -767,94 +824,70 @@ void AnimationTree::_process_graph(float p_delta) {
 	if (!state.valid) {
 		return; //state is not valid. do nothing.
 	}
-	//apply value/transform/bezier blends to track caches and execute method/audio/animation tracks
 
-	{
-
-		bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
-
-		for (List<AnimationNode::AnimationState>::Element *E = state.animation_states.front(); E; E = E->next()) {
+	//blend value/transform/bezier tracks into the track caches, this only touches this tree
 
-			const AnimationNode::AnimationState &as = E->get();
+	for (List<AnimationNode::AnimationState>::Element *E = state.animation_states.front(); E; E = E->next()) {
 
-			Ref<Animation> a = as.animation;
-			float time = as.time;
-			float delta = as.delta;
-			bool seeked = as.seeked;
+		const AnimationNode::AnimationState &as = E->get();
 
-			for (int i = 0; i < a->get_track_count(); i++) {
-
-				NodePath path = a->track_get_path(i);
-				TrackCache *track = track_cache[path];
-				if (track->type != a->track_get_type(i)) {
-					continue; //may happen should not
-				}
+		Ref<Animation> a = as.animation;
+		float time = as.time;
+		float delta = as.delta;
 
-				track->root_motion = root_motion_track == path;
+		AnimationTrackMap *track_map = _get_animation_track_map(a.ptr());
+		const int *blend_indices = track_map->blend_indices.ptr();
+		int *key_cursors = track_map->key_cursors.ptrw();
 
-				ERR_CONTINUE(!state.track_map.has(path));
-				int blend_idx = state.track_map[path];
+		for (int i = 0; i < track_map->blend_indices.size(); i++) {
 
-				ERR_CONTINUE(blend_idx < 0 || blend_idx >= state.track_count);
+			int blend_idx = blend_indices[i];
+			if (blend_idx < 0) {
+				continue; //path not cached or track type mismatch, may happen should not
+			}
 
-				float blend = (*as.track_blends)[blend_idx];
+			TrackCache *track = track_cache_list[blend_idx];
 
-				if (blend < CMP_EPSILON)
-					continue; //nothing to blend
+			float blend = (*as.track_blends)[blend_idx];
 
-				switch (track->type) {
+			switch (track->type) {
 
-					case Animation::TYPE_TRANSFORM: {
+				case Animation::TYPE_TRANSFORM: {
 
-						TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
+					TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
 
-						if (t->process_pass != process_pass) {
+					if (t->process_pass != process_pass) {
 
-							t->process_pass = process_pass;
-							t->loc = Vector3();
-							t->rot = Quat();
-							t->rot_blend_accum = 0;
-							t->scale = Vector3();
-						}
+						t->process_pass = process_pass;
+						t->loc = Vector3();
+						t->rot = Quat();
+						t->rot_blend_accum = 0;
+						t->scale = Vector3();
+					}
 
-						if (track->root_motion) {
+					if (track->root_motion) {
 
-							float prev_time = time - delta;
-							if (prev_time < 0) {
-								if (!a->has_loop()) {
-									prev_time = 0;
-								} else {
-									prev_time = a->get_length() + prev_time;
-								}
+						float prev_time = time - delta;
+						if (prev_time < 0) {
+							if (!a->has_loop()) {
+								prev_time = 0;
+							} else {
+								prev_time = a->get_length() + prev_time;
 							}
+						}
 
-							Vector3 loc[2];
-							Quat rot[2];
-							Vector3 scale[2];
-
-							if (prev_time > time) {
-
-								Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
-								if (err != OK) {
-									continue;
-								}
-
-								a->transform_track_interpolate(i, a->get_length(), &loc[1], &rot[1], &scale[1]);
-
-								t->loc += (loc[1] - loc[0]) * blend;
-								t->scale += (scale[1] - scale[0]) * blend;
-								Quat q = Quat().slerp(rot[0].normalized().inverse() * rot[1].normalized(), blend).normalized();
-								t->rot = (t->rot * q).normalized();
+						Vector3 loc[2];
+						Quat rot[2];
+						Vector3 scale[2];
 
-								prev_time = 0;
-							}
+						if (prev_time > time) {
 
 							Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
 							if (err != OK) {
 								continue;
 							}
 
-							a->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
+							a->transform_track_interpolate(i, a->get_length(), &loc[1], &rot[1], &scale[1]);
 
 							t->loc += (loc[1] - loc[0]) * blend;
 							t->scale += (scale[1] - scale[0]) * blend;
@@ -862,121 +895,228 @@ void AnimationTree::_process_graph(float p_delta) {
 							t->rot = (t->rot * q).normalized();
 
 							prev_time = 0;
+						}
+
+						Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
+						if (err != OK) {
+							continue;
+						}
+
+						a->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
+
+						t->loc += (loc[1] - loc[0]) * blend;
+						t->scale += (scale[1] - scale[0]) * blend;
+						Quat q = Quat().slerp(rot[0].normalized().inverse() * rot[1].normalized(), blend).normalized();
+						t->rot = (t->rot * q).normalized();
+
+						prev_time = 0;
 
+					} else {
+						Vector3 loc;
+						Quat rot;
+						Vector3 scale;
+
+						Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale, &key_cursors[i]);
+						//ERR_CONTINUE(err!=OK); //used for testing, should be removed
+
+						scale -= Vector3(1.0, 1.0, 1.0); //helps make it work properly with Add nodes
+
+						if (err != OK)
+							continue;
+
+						t->loc = t->loc.linear_interpolate(loc, blend);
+						if (t->rot_blend_accum == 0) {
+							t->rot = rot;
+							t->rot_blend_accum = blend;
 						} else {
-							Vector3 loc;
-							Quat rot;
-							Vector3 scale;
+							float rot_total = t->rot_blend_accum + blend;
+							t->rot = rot.slerp(t->rot, t->rot_blend_accum / rot_total).normalized();
+							t->rot_blend_accum = rot_total;
+						}
+						t->scale = t->scale.linear_interpolate(scale, blend);
+					}
 
-							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale);
-							//ERR_CONTINUE(err!=OK); //used for testing, should be removed
+				} break;
+				case Animation::TYPE_VALUE: {
 
-							scale -= Vector3(1.0, 1.0, 1.0); //helps make it work properly with Add nodes
+					TrackCacheValue *t = static_cast<TrackCacheValue *>(track);
 
-							if (err != OK)
-								continue;
+					Animation::UpdateMode update_mode = a->value_track_get_update_mode(i);
 
-							t->loc = t->loc.linear_interpolate(loc, blend);
-							if (t->rot_blend_accum == 0) {
-								t->rot = rot;
-								t->rot_blend_accum = blend;
-							} else {
-								float rot_total = t->rot_blend_accum + blend;
-								t->rot = rot.slerp(t->rot, t->rot_blend_accum / rot_total).normalized();
-								t->rot_blend_accum = rot_total;
-							}
-							t->scale = t->scale.linear_interpolate(scale, blend);
+					if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE) { //delta == 0 means seek
+
+						Variant value = a->value_track_interpolate(i, time);
+
+						if (value == Variant())
+							continue;
+
+						if (t->process_pass != process_pass) {
+							Variant::CallError ce;
+							t->value = Variant::construct(value.get_type(), NULL, 0, ce); //reset
+							t->process_pass = process_pass;
 						}
 
-					} break;
-					case Animation::TYPE_VALUE: {
+						Variant::interpolate(t->value, value, blend, t->value);
+					}
 
-						TrackCacheValue *t = static_cast<TrackCacheValue *>(track);
+				} break;
+				case Animation::TYPE_BEZIER: {
 
-						Animation::UpdateMode update_mode = a->value_track_get_update_mode(i);
+					TrackCacheBezier *t = static_cast<TrackCacheBezier *>(track);
 
-						if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE) { //delta == 0 means seek
+					float bezier = a->bezier_track_interpolate(i, time);
 
-							Variant value = a->value_track_interpolate(i, time);
+					if (t->process_pass != process_pass) {
+						t->value = 0;
+						t->process_pass = process_pass;
+					}
 
-							if (value == Variant())
-								continue;
+					t->value = Math::lerp(t->value, bezier, blend);
 
-							if (t->process_pass != process_pass) {
-								Variant::CallError ce;
-								t->value = Variant::construct(value.get_type(), NULL, 0, ce); //reset
-								t->process_pass = process_pass;
-							}
+				} break;
+				default: {} //handled in the other pass
+			}
+		}
+	}
+}
 
-							Variant::interpolate(t->value, value, blend, t->value);
+void AnimationTree::_process_graph_end() {
 
-						} else if (delta != 0) {
+	if (!state.valid) {
+		return; //state is not valid. do nothing.
+	}
 
-							List<int> indices;
-							a->value_track_get_key_indices(i, time, delta, &indices);
+	//execute discrete value/method/audio/animation tracks, then apply the blended tracks
 
-							for (List<int>::Element *F = indices.front(); F; F = F->next()) {
+	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
-								Variant value = a->track_get_key_value(i, F->get());
-								t->object->set_indexed(t->subpath, value);
-							}
-						}
+	for (List<AnimationNode::AnimationState>::Element *E = state.animation_states.front(); E; E = E->next()) {
 
-					} break;
-					case Animation::TYPE_METHOD: {
+		const AnimationNode::AnimationState &as = E->get();
 
-						if (delta == 0) {
-							continue;
-						}
-						TrackCacheMethod *t = static_cast<TrackCacheMethod *>(track);
+		Ref<Animation> a = as.animation;
+		float time = as.time;
+		float delta = as.delta;
+		bool seeked = as.seeked;
 
-						List<int> indices;
+		AnimationTrackMap *track_map = _get_animation_track_map(a.ptr());
+		const int *blend_indices = track_map->blend_indices.ptr();
 
-						a->method_track_get_key_indices(i, time, delta, &indices);
+		for (int i = 0; i < track_map->blend_indices.size(); i++) {
 
-						for (List<int>::Element *E = indices.front(); E; E = E->next()) {
+			int blend_idx = blend_indices[i];
+			if (blend_idx < 0) {
+				continue; //path not cached or track type mismatch, may happen should not
+			}
 
-							StringName method = a->method_track_get_name(i, E->get());
-							Vector<Variant> params = a->method_track_get_params(i, E->get());
+			TrackCache *track = track_cache_list[blend_idx];
 
-							int s = params.size();
+			float blend = (*as.track_blends)[blend_idx];
 
-							ERR_CONTINUE(s > VARIANT_ARG_MAX);
-							if (can_call) {
-								t->object->call_deferred(
-										method,
-										s >= 1 ? params[0] : Variant(),
-										s >= 2 ? params[1] : Variant(),
-										s >= 3 ? params[2] : Variant(),
-										s >= 4 ? params[3] : Variant(),
-										s >= 5 ? params[4] : Variant());
-							}
+			switch (track->type) {
+
+				case Animation::TYPE_VALUE: {
+
+					TrackCacheValue *t = static_cast<TrackCacheValue *>(track);
+
+					Animation::UpdateMode update_mode = a->value_track_get_update_mode(i);
+
+					if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE) {
+						continue; //already blended
+					}
+
+					if (delta != 0) {
+
+						List<int> indices;
+						a->value_track_get_key_indices(i, time, delta, &indices);
+
+						for (List<int>::Element *F = indices.front(); F; F = F->next()) {
+
+							Variant value = a->track_get_key_value(i, F->get());
+							t->object->set_indexed(t->subpath, value);
 						}
+					}
 
-					} break;
-					case Animation::TYPE_BEZIER: {
+				} break;
+				case Animation::TYPE_METHOD: {
 
-						TrackCacheBezier *t = static_cast<TrackCacheBezier *>(track);
+					if (delta == 0) {
+						continue;
+					}
+					TrackCacheMethod *t = static_cast<TrackCacheMethod *>(track);
 
-						float bezier = a->bezier_track_interpolate(i, time);
+					List<int> indices;
 
-						if (t->process_pass != process_pass) {
-							t->value = 0;
-							t->process_pass = process_pass;
+					a->method_track_get_key_indices(i, time, delta, &indices);
+
+					for (List<int>::Element *E = indices.front(); E; E = E->next()) {
+
+						StringName method = a->method_track_get_name(i, E->get());
+						Vector<Variant> params = a->method_track_get_params(i, E->get());
+
+						int s = params.size();
+
+						ERR_CONTINUE(s > VARIANT_ARG_MAX);
+						if (can_call) {
+							t->object->call_deferred(
+									method,
+									s >= 1 ? params[0] : Variant(),
+									s >= 2 ? params[1] : Variant(),
+									s >= 3 ? params[2] : Variant(),
+									s >= 4 ? params[3] : Variant(),
+									s >= 5 ? params[4] : Variant());
 						}
+					}
 
-						t->value = Math::lerp(t->value, bezier, blend);
+				} break;
+				case Animation::TYPE_AUDIO: {
 
-					} break;
-					case Animation::TYPE_AUDIO: {
+					TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
 
-						TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
+					if (seeked) {
+						//find whathever should be playing
+						int idx = a->track_find_key(i, time);
+						if (idx < 0)
+							continue;
+
+						Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
+						if (!stream.is_valid()) {
+							t->object->call("stop");
+							t->playing = false;
+							playing_caches.erase(t);
+						} else {
+							float start_ofs = a->audio_track_get_key_start_offset(i, idx);
+							start_ofs += time - a->track_get_key_time(i, idx);
+							float end_ofs = a->audio_track_get_key_end_offset(i, idx);
+							float len = stream->get_length();
 
-						if (seeked) {
-							//find whathever should be playing
-							int idx = a->track_find_key(i, time);
-							if (idx < 0)
+							if (start_ofs > len - end_ofs) {
+								t->object->call("stop");
+								t->playing = false;
+								playing_caches.erase(t);
 								continue;
+							}
+
+							t->object->call("set_stream", stream);
+							t->object->call("play", start_ofs);
+
+							t->playing = true;
+							playing_caches.insert(t);
+							if (len && end_ofs > 0) { //force a end at a time
+								t->len = len - start_ofs - end_ofs;
+							} else {
+								t->len = 0;
+							}
+
+							t->start = time;
+						}
+
+					} else {
+						//find stuff to play
+						List<int> to_play;
+						a->track_get_key_indices_in_range(i, time, delta, &to_play);
+						if (to_play.size()) {
+							int idx = to_play.back()->get();
 
 							Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
 							if (!stream.is_valid()) {
@@ -985,17 +1125,9 @@ void AnimationTree::_process_graph(float p_delta) {
 								playing_caches.erase(t);
 							} else {
 								float start_ofs = a->audio_track_get_key_start_offset(i, idx);
-								start_ofs += time - a->track_get_key_time(i, idx);
 								float end_ofs = a->audio_track_get_key_end_offset(i, idx);
 								float len = stream->get_length();
 
-								if (start_ofs > len - end_ofs) {
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-									continue;
-								}
-
 								t->object->call("set_stream", stream);
 								t->object->call("play", start_ofs);
 
@@ -1009,143 +1141,111 @@ void AnimationTree::_process_graph(float p_delta) {
 
 								t->start = time;
 							}
+						} else if (t->playing) {
 
-						} else {
-							//find stuff to play
-							List<int> to_play;
-							a->track_get_key_indices_in_range(i, time, delta, &to_play);
-							if (to_play.size()) {
-								int idx = to_play.back()->get();
-
-								Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
-								if (!stream.is_valid()) {
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-								} else {
-									float start_ofs = a->audio_track_get_key_start_offset(i, idx);
-									float end_ofs = a->audio_track_get_key_end_offset(i, idx);
-									float len = stream->get_length();
-
-									t->object->call("set_stream", stream);
-									t->object->call("play", start_ofs);
-
-									t->playing = true;
-									playing_caches.insert(t);
-									if (len && end_ofs > 0) { //force a end at a time
-										t->len = len - start_ofs - end_ofs;
-									} else {
-										t->len = 0;
-									}
-
-									t->start = time;
-								}
-							} else if (t->playing) {
+							bool loop = a->has_loop();
 
-								bool loop = a->has_loop();
+							bool stop = false;
 
-								bool stop = false;
+							if (!loop && time < t->start) {
+								stop = true;
+							} else if (t->len > 0) {
+								float len = t->start > time ? (a->get_length() - t->start) + time : time - t->start;
 
-								if (!loop && time < t->start) {
+								if (len > t->len) {
 									stop = true;
-								} else if (t->len > 0) {
-									float len = t->start > time ? (a->get_length() - t->start) + time : time - t->start;
-
-									if (len > t->len) {
-										stop = true;
-									}
 								}
+							}
 
-								if (stop) {
-									//time to stop
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-								}
+							if (stop) {
+								//time to stop
+								t->object->call("stop");
+								t->playing = false;
+								playing_caches.erase(t);
 							}
 						}
+					}
 
-						float db = Math::linear2db(MAX(blend, 0.00001));
-						if (t->object->has_method("set_unit_db")) {
-							t->object->call("set_unit_db", db);
-						} else {
-							t->object->call("set_volume_db", db);
-						}
-					} break;
-					case Animation::TYPE_ANIMATION: {
+					float db = Math::linear2db(MAX(blend, 0.00001));
+					if (t->object->has_method("set_unit_db")) {
+						t->object->call("set_unit_db", db);
+					} else {
+						t->object->call("set_volume_db", db);
+					}
+				} break;
+				case Animation::TYPE_ANIMATION: {
 
-						TrackCacheAnimation *t = static_cast<TrackCacheAnimation *>(track);
+					TrackCacheAnimation *t = static_cast<TrackCacheAnimation *>(track);
 
-						AnimationPlayer *player = Object::cast_to<AnimationPlayer>(t->object);
+					AnimationPlayer *player = Object::cast_to<AnimationPlayer>(t->object);
 
-						if (!player)
+					if (!player)
+						continue;
+
+					if (delta == 0 || seeked) {
+						//seek
+						int idx = a->track_find_key(i, time);
+						if (idx < 0)
 							continue;
 
-						if (delta == 0 || seeked) {
-							//seek
-							int idx = a->track_find_key(i, time);
-							if (idx < 0)
-								continue;
+						float pos = a->track_get_key_time(i, idx);
 
-							float pos = a->track_get_key_time(i, idx);
+						StringName anim_name = a->animation_track_get_key_animation(i, idx);
+						if (String(anim_name) == "[stop]" || !player->has_animation(anim_name))
+							continue;
 
-							StringName anim_name = a->animation_track_get_key_animation(i, idx);
-							if (String(anim_name) == "[stop]" || !player->has_animation(anim_name))
-								continue;
+						Ref<Animation> anim = player->get_animation(anim_name);
 
-							Ref<Animation> anim = player->get_animation(anim_name);
+						float at_anim_pos;
 
-							float at_anim_pos;
+						if (anim->has_loop()) {
+							at_anim_pos = Math::fposmod(time - pos, anim->get_length()); //seek to loop
+						} else {
+							at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
+						}
 
-							if (anim->has_loop()) {
-								at_anim_pos = Math::fposmod(time - pos, anim->get_length()); //seek to loop
-							} else {
-								at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
-							}
+						if (player->is_playing() || seeked) {
+							player->play(anim_name);
+							player->seek(at_anim_pos);
+							t->playing = true;
+							playing_caches.insert(t);
+						} else {
+							player->set_assigned_animation(anim_name);
+							player->seek(at_anim_pos, true);
+						}
+					} else {
+						//find stuff to play
+						List<int> to_play;
+						a->track_get_key_indices_in_range(i, time, delta, &to_play);
+						if (to_play.size()) {
+							int idx = to_play.back()->get();
 
-							if (player->is_playing() || seeked) {
+							StringName anim_name = a->animation_track_get_key_animation(i, idx);
+							if (String(anim_name) == "[stop]" || !player->has_animation(anim_name)) {
+
+								if (playing_caches.has(t)) {
+									playing_caches.erase(t);
+									player->stop();
+									t->playing = false;
+								}
+							} else {
 								player->play(anim_name);
-								player->seek(at_anim_pos);
 								t->playing = true;
 								playing_caches.insert(t);
-							} else {
-								player->set_assigned_animation(anim_name);
-								player->seek(at_anim_pos, true);
-							}
-						} else {
-							//find stuff to play
-							List<int> to_play;
-							a->track_get_key_indices_in_range(i, time, delta, &to_play);
-							if (to_play.size()) {
-								int idx = to_play.back()->get();
-
-								StringName anim_name = a->animation_track_get_key_animation(i, idx);
-								if (String(anim_name) == "[stop]" || !player->has_animation(anim_name)) {
-
-									if (playing_caches.has(t)) {
-										playing_caches.erase(t);
-										player->stop();
-										t->playing = false;
-									}
-								} else {
-									player->play(anim_name);
-									t->playing = true;
-									playing_caches.insert(t);
-								}
 							}
 						}
+					}
 
-					} break;
-				}
+				} break;
+				default: {} //handled in the other pass
 			}
 		}
 	}
 
 	{
 		// finally, set the tracks
-		const NodePath *K = NULL;
-		while ((K = track_cache.next(K))) {
-			TrackCache *track = track_cache[*K];
+		for (int i = 0; i < track_cache_list.size(); i++) {
+			TrackCache *track = track_cache_list[i];
 			if (track->process_pass != process_pass)
 				continue; //not processed, ignore
 
@@ -1199,17 +1299,105 @@ void AnimationTree::_process_graph(float p_delta) {
 	}
 }
 
+void AnimationTree::_process_graph(float p_delta) {
+
+	if (!_process_graph_begin()) {
+		return;
+	}
+
+	_process_graph_evaluate(p_delta);
+	_process_graph_end();
+}
+
+void AnimationTree::_queue_process_graph(float p_delta) {
+
+	if (!parallel_process || Engine::get_singleton()->is_editor_hint()) {
+		_process_graph(p_delta);
+		return;
+	}
+
+	parallel_delta = p_delta;
+
+	if (parallel_list.in_list()) {
+		return; //already queued
+	}
+
+	// the first tree queued this frame schedules processing of all of them,
+	// which happens when the message queue is flushed after the process notifications
+	bool schedule = parallel_queue.first() == NULL;
+	parallel_queue.add_last(&parallel_list);
+
+	if (schedule) {
+		MessageQueue::get_singleton()->push_call(this, "_process_parallel_queue");
+	}
+}
+
+void AnimationTree::_dequeue_process_graph() {
+
+	if (!parallel_list.in_list()) {
+		return;
+	}
+
+	bool was_first = parallel_queue.first() == &parallel_list;
+	parallel_queue.remove(&parallel_list);
+
+	if (was_first && parallel_queue.first()) {
+		//this tree may be going away along with its pending call, so let the next one schedule
+		MessageQueue::get_singleton()->push_call(parallel_queue.first()->self(), "_process_parallel_queue");
+	}
+}
+
+void AnimationTree::_process_parallel_task(void *p_userdata, uint32_t p_index) {
+
+	AnimationTree **batch = (AnimationTree **)p_userdata;
+	batch[p_index]->_process_graph_evaluate(batch[p_index]->parallel_delta);
+}
+
+void AnimationTree::_process_parallel_queue() {
+
+	Vector<AnimationTree *> batch;
+
+	while (parallel_queue.first()) {
+
+		AnimationTree *at = parallel_queue.first()->self();
+		parallel_queue.remove(parallel_queue.first());
+
+		if (at->active && at->_process_graph_begin()) {
+			batch.push_back(at);
+		}
+	}
+
+	int count = batch.size();
+
+	// evaluating the graph only touches each tree's own state and track caches
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_process_parallel_task, batch.ptrw(), count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < count; i++) {
+			batch[i]->_process_graph_evaluate(batch[i]->parallel_delta);
+		}
+	}
+
+	// applying results touches the scene, so it happens from this thread
+	for (int i = 0; i < count; i++) {
+		batch[i]->_process_graph_end();
+	}
+}
+
 void AnimationTree::_notification(int p_what) {
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_mode == ANIMATION_PROCESS_PHYSICS) {
-		_process_graph(get_physics_process_delta_time());
+		_queue_process_graph(get_physics_process_delta_time());
 	}
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_mode == ANIMATION_PROCESS_IDLE) {
-		_process_graph(get_process_delta_time());
+		_queue_process_graph(get_process_delta_time());
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		_dequeue_process_graph();
 		_clear_caches();
 	}
 }
@@ -1282,6 +1470,7 @@ String AnimationTree::get_configuration_warning() const {
 
 void AnimationTree::set_root_motion_track(const NodePath &p_track) {
 	root_motion_track = p_track;
+	cache_valid = false;
 }
 
 NodePath AnimationTree::get_root_motion_track() const {
@@ -1292,6 +1481,19 @@ Transform AnimationTree::get_root_motion_transform() const {
 	return root_motion_transform;
 }
 
+void AnimationTree::set_parallel_process_enabled(bool p_enabled) {
+
+	parallel_process = p_enabled;
+
+	if (!parallel_process) {
+		_dequeue_process_graph();
+	}
+}
+
+bool AnimationTree::is_parallel_process_enabled() const {
+	return parallel_process;
+}
+
 void AnimationTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_active", "active"), &AnimationTree::set_active);
 	ClassDB::bind_method(D_METHOD("is_active"), &AnimationTree::is_active);
@@ -1310,12 +1512,18 @@ void AnimationTree::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_root_motion_transform"), &AnimationTree::get_root_motion_transform);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_process_enabled", "enabled"), &AnimationTree::set_parallel_process_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_process_enabled"), &AnimationTree::is_parallel_process_enabled);
+
 	ClassDB::bind_method(D_METHOD("_node_removed"), &AnimationTree::_node_removed);
+	ClassDB::bind_method(D_METHOD("_animation_changed"), &AnimationTree::_animation_changed);
+	ClassDB::bind_method(D_METHOD("_process_parallel_queue"), &AnimationTree::_process_parallel_queue);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "tree_root", PROPERTY_HINT_RESOURCE_TYPE, "AnimationRootNode", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_DO_NOT_SHARE_ON_DUPLICATE), "set_tree_root", "get_tree_root");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "anim_player", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "AnimationPlayer"), "set_animation_player", "get_animation_player");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Physics,Idle"), "set_process_mode", "get_process_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_process_enabled"), "set_parallel_process_enabled", "is_parallel_process_enabled");
 	ADD_GROUP("Root Motion", "root_motion_");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_motion_track"), "set_root_motion_track", "get_root_motion_track");
 
@@ -1323,13 +1531,18 @@ void AnimationTree::_bind_methods() {
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_IDLE);
 }
 
-AnimationTree::AnimationTree() {
+SelfList<AnimationTree>::List AnimationTree::parallel_queue;
+
+AnimationTree::AnimationTree() :
+		parallel_list(this) {
 
 	process_mode = ANIMATION_PROCESS_IDLE;
 	active = false;
 	cache_valid = false;
 	setup_pass = 1;
 	started = true;
+	parallel_process = false;
+	parallel_delta = 0;
 }
 
 AnimationTree::~AnimationTree() {
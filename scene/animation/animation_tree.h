@@ -219,8 +219,16 @@ private:
 	};
 
 	HashMap<NodePath, TrackCache *> track_cache;
+	Vector<TrackCache *> track_cache_list; //same order as state.track_map
 	Set<TrackCache *> playing_caches;
 
+	struct AnimationTrackMap {
+		Vector<int> blend_indices; //animation track index -> blend index, -1 if unused
+		Vector<int> key_cursors;
+	};
+
+	HashMap<ObjectID, AnimationTrackMap> animation_track_maps;
+
 	Ref<AnimationNode> root;
 
 	AnimationProcessMode process_mode;
@@ -234,8 +242,24 @@ private:
 
 	void _clear_caches();
 	bool _update_caches(AnimationPlayer *player);
+	AnimationTrackMap *_get_animation_track_map(Animation *p_animation);
+	void _animation_changed();
+
+	bool _process_graph_begin();
+	void _process_graph_evaluate(float p_delta);
+	void _process_graph_end();
 	void _process_graph(float p_delta);
 
+	bool parallel_process;
+	float parallel_delta;
+	SelfList<AnimationTree> parallel_list;
+	static SelfList<AnimationTree>::List parallel_queue;
+
+	void _queue_process_graph(float p_delta);
+	void _dequeue_process_graph();
+	void _process_parallel_queue();
+	static void _process_parallel_task(void *p_userdata, uint32_t p_index);
+
 	uint64_t setup_pass;
 	uint64_t process_pass;
 
@@ -271,6 +295,9 @@ public:
 
 	Transform get_root_motion_transform() const;
 
+	void set_parallel_process_enabled(bool p_enabled);
+	bool is_parallel_process_enabled() const;
+
 	uint64_t get_last_process_pass() const;
 	AnimationTree();
 	~AnimationTree();
@@ -479,13 +479,44 @@ bool Tween::_apply_tween_value(InterpolateData &p_data, Variant &value) {
 	Object *object = ObjectDB::get_instance(p_data.id);
 	ERR_FAIL_COND_V(object == NULL, false);
 
+	return _apply_tween_value(object, p_data, value);
+}
+
+bool Tween::_apply_tween_value(Object *p_object, InterpolateData &p_data, Variant &value) {
+
 	switch (p_data.type) {
 
 		case INTER_PROPERTY:
 		case FOLLOW_PROPERTY:
 		case TARGETING_PROPERTY: {
+
+			if (!p_data.setter_resolved) {
+				p_data.setter_resolved = true;
+				// scripts may override properties, and subnames need the getter too
+				if (p_data.key.size() == 1 && !p_object->get_script_instance()) {
+					StringName setter = ClassDB::get_property_setter(p_object->get_class_name(), p_data.key[0]);
+					if (setter != StringName()) {
+						p_data.setter = ClassDB::get_method(p_object->get_class_name(), setter);
+						p_data.setter_index = ClassDB::get_property_index(p_object->get_class_name(), p_data.key[0]);
+					}
+				}
+			}
+
+			if (p_data.setter && !p_object->get_script_instance()) {
+				Variant::CallError ce;
+				if (p_data.setter_index >= 0) {
+					Variant index = p_data.setter_index;
+					const Variant *args[2] = { &index, &value };
+					p_data.setter->call(p_object, args, 2, ce);
+				} else {
+					const Variant *args[1] = { &value };
+					p_data.setter->call(p_object, args, 1, ce);
+				}
+				return ce.error == Variant::CallError::CALL_OK;
+			}
+
 			bool valid = false;
-			object->set_indexed(p_data.key, value, &valid);
+			p_object->set_indexed(p_data.key, value, &valid);
 			return valid;
 		}
 
@@ -495,9 +526,9 @@ bool Tween::_apply_tween_value(InterpolateData &p_data, Variant &value) {
 			Variant::CallError error;
 			if (value.get_type() != Variant::NIL) {
 				Variant *arg[1] = { &value };
-				object->call(p_data.key[0], (const Variant **)arg, 1, error);
+				p_object->call(p_data.key[0], (const Variant **)arg, 1, error);
 			} else {
-				object->call(p_data.key[0], NULL, 0, error);
+				p_object->call(p_data.key[0], NULL, 0, error);
 			}
 
 			if (error.error == Variant::CallError::CALL_OK)
@@ -511,6 +542,14 @@ bool Tween::_apply_tween_value(InterpolateData &p_data, Variant &value) {
 	return true;
 }
 
+const NodePath &Tween::_get_key_path(InterpolateData &p_data) {
+
+	if (p_data.key_path.is_empty()) {
+		p_data.key_path = NodePath(Vector<StringName>(), p_data.key, false);
+	}
+	return p_data.key_path;
+}
+
 void Tween::_tween_process(float p_delta) {
 
 	_process_pending_commands();
@@ -557,8 +596,8 @@ void Tween::_tween_process(float p_delta) {
 			continue;
 		else if (prev_delaying) {
 
-			_apply_tween_value(data, data.initial_val);
-			emit_signal("tween_started", object, NodePath(Vector<StringName>(), data.key, false));
+			_apply_tween_value(object, data, data.initial_val);
+			emit_signal("tween_started", object, _get_key_path(data));
 		}
 
 		if (data.elapsed > (data.delay + data.duration)) {
@@ -605,17 +644,17 @@ void Tween::_tween_process(float p_delta) {
 			}
 		} else {
 			Variant result = _run_equation(data);
-			_apply_tween_value(data, result);
-			emit_signal("tween_step", object, NodePath(Vector<StringName>(), data.key, false), data.elapsed, result);
+			_apply_tween_value(object, data, result);
+			emit_signal("tween_step", object, _get_key_path(data), data.elapsed, result);
 		}
 
 		if (data.finish) {
-			_apply_tween_value(data, data.final_val);
+			_apply_tween_value(object, data, data.final_val);
 			data.elapsed = 0;
-			emit_signal("tween_completed", object, NodePath(Vector<StringName>(), data.key, false));
+			emit_signal("tween_completed", object, _get_key_path(data));
 			// not repeat mode, remove completed action
 			if (!repeat)
-				call_deferred("_remove", object, NodePath(Vector<StringName>(), data.key, false), true);
+				call_deferred("_remove", object, _get_key_path(data), true);
 		} else if (!repeat)
 			all_finished = all_finished && data.finish;
 	}
@@ -100,6 +100,18 @@ private:
 		real_t delay;
 		int args;
 		Variant arg[5];
+
+		// resolved once, so stepping a property tween skips the lookups done by Object::set()
+		bool setter_resolved;
+		MethodBind *setter;
+		int setter_index;
+		NodePath key_path;
+
+		InterpolateData() {
+			setter_resolved = false;
+			setter = NULL;
+			setter_index = -1;
+		}
 	};
 
 	String autoplay;
@@ -129,6 +141,8 @@ private:
 	Variant _run_equation(InterpolateData &p_data);
 	bool _calc_delta_val(const Variant &p_initial_val, const Variant &p_final_val, Variant &p_delta_val);
 	bool _apply_tween_value(InterpolateData &p_data, Variant &value);
+	bool _apply_tween_value(Object *p_object, InterpolateData &p_data, Variant &value);
+	const NodePath &_get_key_path(InterpolateData &p_data);
 
 	void _tween_process(float p_delta);
 	void _remove(Object *p_object, StringName p_key, bool first_only);
@@ -31,6 +31,7 @@
 #include "audio_player.h"
 
 #include "engine.h"
+#include "servers/audio/audio_mix.h"
 
 void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
 
@@ -52,10 +53,7 @@ void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
 	float vol = Math::db2linear(mix_volume_db);
 	float vol_inc = (Math::db2linear(target_volume) - vol) / float(buffer_size);
 
-	for (int i = 0; i < buffer_size; i++) {
-		buffer[i] *= vol;
-		vol += vol_inc;
-	}
+	audio_mix_gain_ramp(buffer, buffer_size, vol, vol_inc);
 
 	//set volume for next mix
 	mix_volume_db = target_volume;
@@ -83,9 +81,7 @@ void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
 	for (int c = 0; c < 4; c++) {
 		if (!targets[c])
 			break;
-		for (int i = 0; i < buffer_size; i++) {
-			targets[c][i] += buffer[i];
-		}
+		audio_mix_add(targets[c], buffer, buffer_size);
 	}
 }
 
@@ -32,6 +32,9 @@
 #include "message_queue.h"
 #include "scene/scene_string_names.h"
 
+SelfList<Container>::List Container::sort_queue;
+ObjectID Container::sort_queue_flusher = 0;
+
 void Container::_child_minsize_changed() {
 
 	//Size2 ms = get_combined_minimum_size();
@@ -85,6 +88,8 @@ void Container::remove_child_notify(Node *p_child) {
 
 void Container::_sort_children() {
 
+	pending_sort = false;
+
 	if (!is_inside_tree())
 		return;
 
@@ -131,6 +136,39 @@ void Container::fit_child_in_rect(Control *p_child, const Rect2 &p_rect) {
 	p_child->set_scale(Vector2(1, 1));
 }
 
+void Container::_flush_sort_queue() {
+
+	sort_queue_flusher = 0;
+
+	// sorting a container resizes its children, which queues them again, so parents go first
+	// and every container is sorted once per flush, after its parents settled
+	while (sort_queue.first()) {
+
+		Vector<Container *> containers;
+		while (sort_queue.first()) {
+			Container *c = sort_queue.first()->self();
+			sort_queue.remove(&c->sort_item); // still pending, so queueing it again is ignored
+			containers.push_back(c);
+		}
+
+		containers.sort_custom<Node::Comparator>();
+
+		Vector<ObjectID> ids;
+		ids.resize(containers.size());
+		for (int i = 0; i < containers.size(); i++) {
+			ids.write[i] = containers[i]->get_instance_id();
+		}
+
+		for (int i = 0; i < ids.size(); i++) {
+			// a sort callback may free containers further down the list
+			Container *c = Object::cast_to<Container>(ObjectDB::get_instance(ids[i]));
+			if (c) {
+				c->_sort_children();
+			}
+		}
+	}
+}
+
 void Container::queue_sort() {
 
 	if (!is_inside_tree())
@@ -139,8 +177,13 @@ void Container::queue_sort() {
 	if (pending_sort)
 		return;
 
-	MessageQueue::get_singleton()->push_call(this, "_sort_children");
+	sort_queue.add_last(&sort_item);
 	pending_sort = true;
+
+	if (!sort_queue_flusher) {
+		MessageQueue::get_singleton()->push_call(this, "_flush_sort_queue");
+		sort_queue_flusher = get_instance_id();
+	}
 }
 
 void Container::_notification(int p_what) {
@@ -151,6 +194,23 @@ void Container::_notification(int p_what) {
 			pending_sort = false;
 			queue_sort();
 		} break;
+		case NOTIFICATION_EXIT_TREE: {
+
+			if (sort_item.in_list()) {
+				sort_queue.remove(&sort_item);
+			}
+			pending_sort = false;
+
+			if (sort_queue_flusher == get_instance_id()) {
+				// this container may be freed before the flush runs, hand it over
+				sort_queue_flusher = 0;
+				if (sort_queue.first()) {
+					Container *c = sort_queue.first()->self();
+					MessageQueue::get_singleton()->push_call(c, "_flush_sort_queue");
+					sort_queue_flusher = c->get_instance_id();
+				}
+			}
+		} break;
 		case NOTIFICATION_RESIZED: {
 
 			queue_sort();
@@ -171,6 +231,7 @@ void Container::_notification(int p_what) {
 void Container::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_sort_children"), &Container::_sort_children);
+	ClassDB::bind_method(D_METHOD("_flush_sort_queue"), &Container::_flush_sort_queue);
 	ClassDB::bind_method(D_METHOD("_child_minsize_changed"), &Container::_child_minsize_changed);
 
 	ClassDB::bind_method(D_METHOD("queue_sort"), &Container::queue_sort);
@@ -180,7 +241,8 @@ void Container::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("sort_children"));
 }
 
-Container::Container() {
+Container::Container() :
+		sort_item(this) {
 
 	pending_sort = false;
 }
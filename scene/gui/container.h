@@ -31,6 +31,7 @@
 #ifndef CONTAINER_H
 #define CONTAINER_H
 
+#include "core/self_list.h"
 #include "scene/gui/control.h"
 
 class Container : public Control {
@@ -38,7 +39,13 @@ class Container : public Control {
 	GDCLASS(Container, Control);
 
 	bool pending_sort;
+	SelfList<Container> sort_item;
+
+	static SelfList<Container>::List sort_queue;
+	static ObjectID sort_queue_flusher;
+
 	void _sort_children();
+	void _flush_sort_queue();
 	void _child_minsize_changed();
 
 protected:
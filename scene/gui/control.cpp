@@ -46,6 +46,8 @@
 #endif
 #include <stdio.h>
 
+uint64_t Control::theme_cache_version = 1;
+
 Dictionary Control::_edit_get_state() const {
 
 	Dictionary s;
@@ -473,6 +475,10 @@ void Control::_notification(int p_notification) {
 
 			data.parent = Object::cast_to<Control>(get_parent());
 
+			if (data.theme.is_valid()) {
+				_invalidate_theme_caches(); // controls below this theme now look up through new parents
+			}
+
 			if (is_set_as_toplevel()) {
 				data.SI = get_viewport()->_gui_add_subwindow_control(this);
 
@@ -546,6 +552,10 @@ void Control::_notification(int p_notification) {
 		} break;
 		case NOTIFICATION_EXIT_CANVAS: {
 
+			if (data.theme.is_valid()) {
+				_invalidate_theme_caches();
+			}
+
 			if (data.parent_canvas_item) {
 
 				data.parent_canvas_item->disconnect("item_rect_changed", this, "_size_changed");
@@ -628,6 +638,7 @@ void Control::_notification(int p_notification) {
 		} break;
 		case NOTIFICATION_THEME_CHANGED: {
 
+			data.theme_cache_version = 0;
 			update();
 		} break;
 		case NOTIFICATION_MODAL_CLOSE: {
@@ -805,16 +816,28 @@ Ref<Texture> Control::get_icon(const StringName &p_name, const StringName &p_typ
 		const Ref<Texture> *tex = data.icon_override.getptr(p_name);
 		if (tex)
 			return *tex;
+
+		_validate_theme_cache();
+		tex = data.icon_cache.getptr(p_name);
+		if (tex)
+			return *tex;
+
+		Ref<Texture> item = _get_theme_icon(p_name, get_class_name());
+		data.icon_cache[p_name] = item;
+		return item;
 	}
 
-	StringName type = p_type ? p_type : get_class_name();
+	return _get_theme_icon(p_name, p_type);
+}
+
+Ref<Texture> Control::_get_theme_icon(const StringName &p_name, const StringName &p_type) const {
 
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while (theme_owner) {
 
-		StringName class_name = type;
+		StringName class_name = p_type;
 
 		while (class_name != StringName()) {
 			if (theme_owner->data.theme->has_icon(p_name, class_name)) {
@@ -832,7 +855,7 @@ Ref<Texture> Control::get_icon(const StringName &p_name, const StringName &p_typ
 			theme_owner = NULL;
 	}
 
-	return Theme::get_default()->get_icon(p_name, type);
+	return Theme::get_default()->get_icon(p_name, p_type);
 }
 
 Ref<Shader> Control::get_shader(const StringName &p_name, const StringName &p_type) const {
@@ -877,14 +900,26 @@ Ref<StyleBox> Control::get_stylebox(const StringName &p_name, const StringName &
 		const Ref<StyleBox> *style = data.style_override.getptr(p_name);
 		if (style)
 			return *style;
+
+		_validate_theme_cache();
+		style = data.style_cache.getptr(p_name);
+		if (style)
+			return *style;
+
+		Ref<StyleBox> item = _get_theme_stylebox(p_name, get_class_name());
+		data.style_cache[p_name] = item;
+		return item;
 	}
 
-	StringName type = p_type ? p_type : get_class_name();
+	return _get_theme_stylebox(p_name, p_type);
+}
+
+Ref<StyleBox> Control::_get_theme_stylebox(const StringName &p_name, const StringName &p_type) const {
 
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
-	StringName class_name = type;
+	StringName class_name = p_type;
 
 	while (theme_owner) {
 
@@ -896,7 +931,7 @@ Ref<StyleBox> Control::get_stylebox(const StringName &p_name, const StringName &
 			class_name = ClassDB::get_parent_class_nocheck(class_name);
 		}
 
-		class_name = type;
+		class_name = p_type;
 
 		Control *parent = Object::cast_to<Control>(theme_owner->get_parent());
 
@@ -912,24 +947,37 @@ Ref<StyleBox> Control::get_stylebox(const StringName &p_name, const StringName &
 
 		class_name = ClassDB::get_parent_class_nocheck(class_name);
 	}
-	return Theme::get_default()->get_stylebox(p_name, type);
+	return Theme::get_default()->get_stylebox(p_name, p_type);
 }
+
 Ref<Font> Control::get_font(const StringName &p_name, const StringName &p_type) const {
 
 	if (p_type == StringName() || p_type == "") {
 		const Ref<Font> *font = data.font_override.getptr(p_name);
 		if (font)
 			return *font;
+
+		_validate_theme_cache();
+		font = data.font_cache.getptr(p_name);
+		if (font)
+			return *font;
+
+		Ref<Font> item = _get_theme_font(p_name, get_class_name());
+		data.font_cache[p_name] = item;
+		return item;
 	}
 
-	StringName type = p_type ? p_type : get_class_name();
+	return _get_theme_font(p_name, p_type);
+}
+
+Ref<Font> Control::_get_theme_font(const StringName &p_name, const StringName &p_type) const {
 
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while (theme_owner) {
 
-		StringName class_name = type;
+		StringName class_name = p_type;
 
 		while (class_name != StringName()) {
 			if (theme_owner->data.theme->has_font(p_name, class_name)) {
@@ -949,23 +997,37 @@ Ref<Font> Control::get_font(const StringName &p_name, const StringName &p_type)
 			theme_owner = NULL;
 	}
 
-	return Theme::get_default()->get_font(p_name, type);
+	return Theme::get_default()->get_font(p_name, p_type);
 }
+
 Color Control::get_color(const StringName &p_name, const StringName &p_type) const {
 
 	if (p_type == StringName() || p_type == "") {
 		const Color *color = data.color_override.getptr(p_name);
 		if (color)
 			return *color;
+
+		_validate_theme_cache();
+		color = data.color_cache.getptr(p_name);
+		if (color)
+			return *color;
+
+		Color item = _get_theme_color(p_name, get_class_name());
+		data.color_cache[p_name] = item;
+		return item;
 	}
 
-	StringName type = p_type ? p_type : get_class_name();
+	return _get_theme_color(p_name, p_type);
+}
+
+Color Control::_get_theme_color(const StringName &p_name, const StringName &p_type) const {
+
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while (theme_owner) {
 
-		StringName class_name = type;
+		StringName class_name = p_type;
 
 		while (class_name != StringName()) {
 			if (theme_owner->data.theme->has_color(p_name, class_name)) {
@@ -983,7 +1045,7 @@ Color Control::get_color(const StringName &p_name, const StringName &p_type) con
 			theme_owner = NULL;
 	}
 
-	return Theme::get_default()->get_color(p_name, type);
+	return Theme::get_default()->get_color(p_name, p_type);
 }
 
 int Control::get_constant(const StringName &p_name, const StringName &p_type) const {
@@ -992,15 +1054,28 @@ int Control::get_constant(const StringName &p_name, const StringName &p_type) co
 		const int *constant = data.constant_override.getptr(p_name);
 		if (constant)
 			return *constant;
+
+		_validate_theme_cache();
+		constant = data.constant_cache.getptr(p_name);
+		if (constant)
+			return *constant;
+
+		int item = _get_theme_constant(p_name, get_class_name());
+		data.constant_cache[p_name] = item;
+		return item;
 	}
 
-	StringName type = p_type ? p_type : get_class_name();
+	return _get_theme_constant(p_name, p_type);
+}
+
+int Control::_get_theme_constant(const StringName &p_name, const StringName &p_type) const {
+
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while (theme_owner) {
 
-		StringName class_name = type;
+		StringName class_name = p_type;
 
 		while (class_name != StringName()) {
 			if (theme_owner->data.theme->has_constant(p_name, class_name)) {
@@ -1018,7 +1093,7 @@ int Control::get_constant(const StringName &p_name, const StringName &p_type) co
 			theme_owner = NULL;
 	}
 
-	return Theme::get_default()->get_constant(p_name, type);
+	return Theme::get_default()->get_constant(p_name, p_type);
 }
 
 bool Control::has_icon_override(const StringName &p_name) const {
@@ -2116,6 +2191,26 @@ void Control::_modal_stack_remove() {
 	data.modal_prev_focus_owner = 0;
 }
 
+void Control::_invalidate_theme_caches() {
+
+	theme_cache_version++;
+}
+
+void Control::_validate_theme_cache() const {
+
+	// the owner is not enough, nested themes or a reparented owner change lookups without notifying this control
+	if (data.theme_cache_version == theme_cache_version && data.theme_cache_owner == data.theme_owner)
+		return;
+
+	data.icon_cache.clear();
+	data.style_cache.clear();
+	data.font_cache.clear();
+	data.color_cache.clear();
+	data.constant_cache.clear();
+	data.theme_cache_version = theme_cache_version;
+	data.theme_cache_owner = data.theme_owner;
+}
+
 void Control::_propagate_theme_changed(CanvasItem *p_at, Control *p_owner, bool p_assign) {
 
 	Control *c = Object::cast_to<Control>(p_at);
@@ -2143,6 +2238,7 @@ void Control::_propagate_theme_changed(CanvasItem *p_at, Control *p_owner, bool
 
 void Control::_theme_changed() {
 
+	_invalidate_theme_caches();
 	_propagate_theme_changed(this, this, false);
 }
 
@@ -2156,6 +2252,7 @@ void Control::set_theme(const Ref<Theme> &p_theme) {
 	}
 
 	data.theme = p_theme;
+	_invalidate_theme_caches();
 	if (!p_theme.is_null()) {
 
 		data.theme_owner = this;
@@ -2977,6 +3074,8 @@ Control::Control() {
 	data.MI = NULL;
 	data.RI = NULL;
 	data.theme_owner = NULL;
+	data.theme_cache_owner = NULL;
+	data.theme_cache_version = 0;
 	data.modal_exclusive = false;
 	data.default_cursor = CURSOR_ARROW;
 	data.h_size_flags = SIZE_FILL;
@@ -209,8 +209,19 @@ private:
 		HashMap<StringName, int> constant_override;
 		Map<Ref<Font>, int> font_refcount;
 
+		// theme items resolved for the default type, overrides are always checked first
+		mutable HashMap<StringName, Ref<Texture> > icon_cache;
+		mutable HashMap<StringName, Ref<StyleBox> > style_cache;
+		mutable HashMap<StringName, Ref<Font> > font_cache;
+		mutable HashMap<StringName, Color> color_cache;
+		mutable HashMap<StringName, int> constant_cache;
+		mutable Control *theme_cache_owner;
+		mutable uint64_t theme_cache_version;
+
 	} data;
 
+	static uint64_t theme_cache_version;
+
 	// used internally
 	Control *_find_control_at_pos(CanvasItem *p_node, const Point2 &p_pos, const Transform2D &p_xform, Transform2D &r_inv_xform);
 
@@ -222,6 +233,14 @@ private:
 	void _propagate_theme_changed(CanvasItem *p_at, Control *p_owner, bool p_assign = true);
 	void _theme_changed();
 
+	static void _invalidate_theme_caches();
+	void _validate_theme_cache() const;
+	Ref<Texture> _get_theme_icon(const StringName &p_name, const StringName &p_type) const;
+	Ref<StyleBox> _get_theme_stylebox(const StringName &p_name, const StringName &p_type) const;
+	Ref<Font> _get_theme_font(const StringName &p_name, const StringName &p_type) const;
+	Color _get_theme_color(const StringName &p_name, const StringName &p_type) const;
+	int _get_theme_constant(const StringName &p_name, const StringName &p_type) const;
+
 	void _change_notify_margins();
 	void _update_minimum_size();
 
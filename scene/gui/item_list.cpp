@@ -44,6 +44,7 @@ void ItemList::add_item(const String &p_item, const Ref<Texture> &p_texture, boo
 	item.disabled = false;
 	item.tooltip_enabled = true;
 	item.custom_bg = Color(0, 0, 0, 0);
+	item.min_rect_dirty = true;
 	items.push_back(item);
 
 	update();
@@ -62,6 +63,7 @@ void ItemList::add_icon_item(const Ref<Texture> &p_item, bool p_selectable) {
 	item.disabled = false;
 	item.tooltip_enabled = true;
 	item.custom_bg = Color(0, 0, 0, 0);
+	item.min_rect_dirty = true;
 	items.push_back(item);
 
 	update();
@@ -73,6 +75,7 @@ void ItemList::set_item_text(int p_idx, const String &p_text) {
 	ERR_FAIL_INDEX(p_idx, items.size());
 
 	items.write[p_idx].text = p_text;
+	items.write[p_idx].min_rect_dirty = true;
 	update();
 	shape_changed = true;
 }
@@ -99,7 +102,6 @@ void ItemList::set_item_tooltip(int p_idx, const String &p_tooltip) {
 
 	items.write[p_idx].tooltip = p_tooltip;
 	update();
-	shape_changed = true;
 }
 
 String ItemList::get_item_tooltip(int p_idx) const {
@@ -113,6 +115,7 @@ void ItemList::set_item_icon(int p_idx, const Ref<Texture> &p_icon) {
 	ERR_FAIL_INDEX(p_idx, items.size());
 
 	items.write[p_idx].icon = p_icon;
+	items.write[p_idx].min_rect_dirty = true;
 	update();
 	shape_changed = true;
 }
@@ -129,6 +132,7 @@ void ItemList::set_item_icon_region(int p_idx, const Rect2 &p_region) {
 	ERR_FAIL_INDEX(p_idx, items.size());
 
 	items.write[p_idx].icon_region = p_region;
+	items.write[p_idx].min_rect_dirty = true;
 	update();
 	shape_changed = true;
 }
@@ -231,7 +235,6 @@ void ItemList::set_item_metadata(int p_idx, const Variant &p_metadata) {
 
 	items.write[p_idx].metadata = p_metadata;
 	update();
-	shape_changed = true;
 }
 
 Variant ItemList::get_item_metadata(int p_idx) const {
@@ -359,6 +362,7 @@ void ItemList::set_fixed_column_width(int p_size) {
 	fixed_column_width = p_size;
 	update();
 	shape_changed = true;
+	item_sizes_changed = true;
 }
 int ItemList::get_fixed_column_width() const {
 
@@ -382,6 +386,7 @@ void ItemList::set_max_text_lines(int p_lines) {
 	max_text_lines = p_lines;
 	update();
 	shape_changed = true;
+	item_sizes_changed = true;
 }
 int ItemList::get_max_text_lines() const {
 
@@ -415,6 +420,7 @@ void ItemList::set_icon_mode(IconMode p_mode) {
 	icon_mode = p_mode;
 	update();
 	shape_changed = true;
+	item_sizes_changed = true;
 }
 ItemList::IconMode ItemList::get_icon_mode() const {
 
@@ -425,6 +431,8 @@ void ItemList::set_fixed_icon_size(const Size2 &p_size) {
 
 	fixed_icon_size = p_size;
 	update();
+	shape_changed = true;
+	item_sizes_changed = true;
 }
 
 Size2 ItemList::get_fixed_icon_size() const {
@@ -772,6 +780,12 @@ void ItemList::_notification(int p_what) {
 		update();
 	}
 
+	if (p_what == NOTIFICATION_THEME_CHANGED) {
+		shape_changed = true;
+		item_sizes_changed = true;
+		update();
+	}
+
 	if (p_what == NOTIFICATION_DRAW) {
 
 		Ref<StyleBox> bg = get_stylebox("bg");
@@ -822,9 +836,15 @@ void ItemList::_notification(int p_what) {
 
 			float max_column_width = 0;
 
-			//1- compute item minimum sizes
+			//1- compute item minimum sizes, only measuring the items that changed
 			for (int i = 0; i < items.size(); i++) {
 
+				if (!item_sizes_changed && !items[i].min_rect_dirty) {
+					max_column_width = MAX(max_column_width, items[i].min_rect_cache.size.x - hseparation);
+					items.write[i].rect_cache.size = items[i].min_rect_cache.size;
+					continue;
+				}
+
 				Size2 minsize;
 				if (items[i].icon.is_valid()) {
 
@@ -871,8 +891,11 @@ void ItemList::_notification(int p_what) {
 				minsize.x += hseparation;
 				items.write[i].rect_cache.size = minsize;
 				items.write[i].min_rect_cache.size = minsize;
+				items.write[i].min_rect_dirty = false;
 			}
 
+			item_sizes_changed = false;
+
 			int fit_size = size.x - bg->get_minimum_size().width - mw;
 
 			//2-attempt best fit
@@ -1207,7 +1230,40 @@ int ItemList::get_item_at_position(const Point2 &p_pos, bool p_exact) const {
 	int closest = -1;
 	int closest_dist = 0x7FFFFFFF;
 
-	for (int i = 0; i < items.size(); i++) {
+	// rows are sorted vertically, so only the row at the position and its neighbors can hold the closest item
+	int from = 0;
+	int to = items.size();
+	{
+		int lo = 0;
+		int hi = items.size();
+		while (lo < hi) {
+			const int mid = (lo + hi) / 2;
+			const Rect2 &rcache = items[mid].rect_cache;
+			if (rcache.position.y + rcache.size.y < pos.y) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+
+		from = MAX(lo - 1, 0);
+		to = MIN(lo + 1, items.size());
+		// extend to the whole previous and next rows
+		while (from > 0 && items[from - 1].rect_cache.position.y == items[from].rect_cache.position.y) {
+			from--;
+		}
+		while (to < items.size() && items[to].rect_cache.position.y == items[to - 1].rect_cache.position.y) {
+			to++;
+		}
+		if (to < items.size()) {
+			to++;
+			while (to < items.size() && items[to].rect_cache.position.y == items[to - 1].rect_cache.position.y) {
+				to++;
+			}
+		}
+	}
+
+	for (int i = from; i < to; i++) {
 
 		Rect2 rc = items[i].rect_cache;
 		if (i % current_columns == current_columns - 1) {
@@ -1311,6 +1367,9 @@ bool ItemList::get_allow_reselect() const {
 
 void ItemList::set_icon_scale(real_t p_scale) {
 	icon_scale = p_scale;
+	update();
+	shape_changed = true;
+	item_sizes_changed = true;
 }
 
 real_t ItemList::get_icon_scale() const {
@@ -1519,8 +1578,6 @@ void ItemList::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("item_activated", PropertyInfo(Variant::INT, "index")));
 	ADD_SIGNAL(MethodInfo("rmb_clicked", PropertyInfo(Variant::VECTOR2, "at_position")));
 	ADD_SIGNAL(MethodInfo("nothing_selected"));
-
-	GLOBAL_DEF("gui/timers/incremental_search_max_interval_msec", 2000);
 }
 
 ItemList::ItemList() {
@@ -1541,6 +1598,7 @@ ItemList::ItemList() {
 	add_child(scroll_bar);
 
 	shape_changed = true;
+	item_sizes_changed = true;
 	scroll_bar->connect("value_changed", this, "_scroll_changed");
 
 	set_focus_mode(FOCUS_ALL);
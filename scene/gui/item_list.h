@@ -68,6 +68,7 @@ private:
 
 		Rect2 rect_cache;
 		Rect2 min_rect_cache;
+		bool min_rect_dirty; // min_rect_cache needs to be measured again
 
 		Size2 get_icon_size() const;
 
@@ -77,6 +78,7 @@ private:
 	int current;
 
 	bool shape_changed;
+	bool item_sizes_changed; // all items need to be measured again
 
 	bool ensure_selected_visible;
 	bool same_column_width;
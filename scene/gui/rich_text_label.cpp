@@ -749,7 +749,6 @@ void RichTextLabel::_update_scroll() {
 
 		if (exceeds) {
 			scroll_visible = true;
-			main->first_invalid_line = 0;
 			scroll_w = vscroll->get_combined_minimum_size().width;
 			vscroll->show();
 			vscroll->set_anchor_and_margin(MARGIN_LEFT, ANCHOR_END, -scroll_w);
@@ -771,7 +770,7 @@ void RichTextLabel::_notification(int p_what) {
 
 		case NOTIFICATION_RESIZED: {
 
-			main->first_invalid_line = 0; //invalidate ALL
+			//lines are laid out again only if the width changed, see _validate_line_caches()
 			update();
 
 		} break;
@@ -813,20 +812,12 @@ void RichTextLabel::_notification(int p_what) {
 
 			int ofs = vscroll->get_value();
 
-			//todo, change to binary search
-
-			int from_line = 0;
-			int total_chars = 0;
-			while (from_line < main->lines.size()) {
-
-				if (main->lines[from_line].height_accum_cache + _get_text_rect().get_position().y >= ofs)
-					break;
-				total_chars += main->lines[from_line].char_count;
-				from_line++;
-			}
+			//only the lines intersecting the visible area are processed
+			int from_line = _find_first_visible_line(main, ofs - text_rect.get_position().y);
 
 			if (from_line >= main->lines.size())
 				break; //nothing to draw
+			int total_chars = main->lines[from_line].char_accum_cache - main->lines[from_line].char_count;
 			int y = (main->lines[from_line].height_accum_cache - main->lines[from_line].height_cache) - ofs;
 			Ref<Font> base_font = get_font("normal_font");
 			Color base_color = get_color("default_color");
@@ -860,15 +851,7 @@ void RichTextLabel::_find_click(ItemFrame *p_frame, const Point2i &p_click, Item
 	bool use_outline = get_constant("shadow_as_outline");
 	Point2 shadow_ofs(get_constant("shadow_offset_x"), get_constant("shadow_offset_y"));
 
-	//todo, change to binary search
-	int from_line = 0;
-
-	while (from_line < p_frame->lines.size()) {
-
-		if (p_frame->lines[from_line].height_accum_cache >= ofs)
-			break;
-		from_line++;
-	}
+	int from_line = _find_first_visible_line(p_frame, ofs);
 
 	if (from_line >= p_frame->lines.size())
 		return;
@@ -1246,10 +1229,26 @@ bool RichTextLabel::_find_meta(Item *p_item, Variant *r_meta) {
 	return false;
 }
 
-void RichTextLabel::_validate_line_caches(ItemFrame *p_frame) {
+int RichTextLabel::_find_first_visible_line(ItemFrame *p_frame, int p_ofs) const {
 
-	if (p_frame->first_invalid_line == p_frame->lines.size())
-		return;
+	//accumulated heights are sorted, so bisect for the first line ending below the offset
+	int low = 0;
+	int high = p_frame->lines.size();
+
+	while (low < high) {
+
+		int middle = (low + high) / 2;
+		if (p_frame->lines[middle].height_accum_cache >= p_ofs) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+void RichTextLabel::_validate_line_caches(ItemFrame *p_frame) {
 
 	//validate invalid lines
 	Size2 size = get_size();
@@ -1257,28 +1256,51 @@ void RichTextLabel::_validate_line_caches(ItemFrame *p_frame) {
 		size.width = fixed_width;
 	}
 	Rect2 text_rect = _get_text_rect();
+
+	int width = text_rect.get_size().width - scroll_w;
+	if (p_frame->layout_width != width) {
+		//wrapping depends on the width, so every line must be laid out again
+		p_frame->layout_width = width;
+		p_frame->first_invalid_line = 0;
+	}
+
+	int from_line = MIN(p_frame->first_invalid_line, p_frame->first_unplaced_line);
+	if (from_line >= p_frame->lines.size() && vscroll->get_page() == size.height)
+		return;
+
 	Color font_color_shadow = get_color("font_color_shadow");
 	bool use_outline = get_constant("shadow_as_outline");
 	Point2 shadow_ofs(get_constant("shadow_offset_x"), get_constant("shadow_offset_y"));
 
 	Ref<Font> base_font = get_font("normal_font");
 
-	for (int i = p_frame->first_invalid_line; i < p_frame->lines.size(); i++) {
+	for (int i = from_line; i < p_frame->lines.size(); i++) {
+
+		Line &l = p_frame->lines.write[i];
+
+		//lines laid out for the current width are kept, only their position is updated
+		if (i >= p_frame->first_invalid_line || l.dirty) {
+			int y = 0;
+			_process_line(p_frame, text_rect.get_position(), y, width, i, PROCESS_CACHE, base_font, Color(), font_color_shadow, use_outline, shadow_ofs);
+			l.height_cache = y;
+			l.dirty = false;
+		}
 
-		int y = 0;
-		_process_line(p_frame, text_rect.get_position(), y, text_rect.get_size().width - scroll_w, i, PROCESS_CACHE, base_font, Color(), font_color_shadow, use_outline, shadow_ofs);
-		p_frame->lines.write[i].height_cache = y;
-		p_frame->lines.write[i].height_accum_cache = y;
+		l.height_accum_cache = l.height_cache;
+		l.char_accum_cache = l.char_count;
 
-		if (i > 0)
-			p_frame->lines.write[i].height_accum_cache += p_frame->lines[i - 1].height_accum_cache;
+		if (i > 0) {
+			l.height_accum_cache += p_frame->lines[i - 1].height_accum_cache;
+			l.char_accum_cache += p_frame->lines[i - 1].char_accum_cache;
+		}
 	}
 
 	int total_height = 0;
 	if (p_frame->lines.size())
 		total_height = p_frame->lines[p_frame->lines.size() - 1].height_accum_cache + get_stylebox("normal")->get_minimum_size().height;
 
-	main->first_invalid_line = p_frame->lines.size();
+	p_frame->first_invalid_line = p_frame->lines.size();
+	p_frame->first_unplaced_line = p_frame->lines.size();
 
 	updating_scroll = true;
 	vscroll->set_max(total_height);
@@ -1434,7 +1456,12 @@ bool RichTextLabel::remove_line(const int p_line) {
 		main->lines.write[0].from = main;
 	}
 
-	main->first_invalid_line = 0;
+	//the lines after the removed one keep their layout, they only move up
+	if (p_line < main->lines.size()) {
+		main->lines.write[p_line].dirty = true;
+	}
+	main->first_unplaced_line = MIN(main->first_unplaced_line, p_line);
+	update();
 	return true;
 }
 
@@ -86,12 +86,20 @@ private:
 		int height_cache;
 		int height_accum_cache;
 		int char_count;
+		int char_accum_cache;
 		int minimum_width;
 		int maximum_width;
+		bool dirty;
 
 		Line() {
 			from = NULL;
+			height_cache = 0;
+			height_accum_cache = 0;
 			char_count = 0;
+			char_accum_cache = 0;
+			minimum_width = 0;
+			maximum_width = 0;
+			dirty = true;
 		}
 	};
 
@@ -124,7 +132,9 @@ private:
 		int parent_line;
 		bool cell;
 		Vector<Line> lines;
-		int first_invalid_line;
+		int first_invalid_line; //lines from here on need to be laid out again
+		int first_unplaced_line; //lines from here on only need their accumulated height updated
+		int layout_width; //width the cached lines were laid out for
 		ItemFrame *parent_frame;
 
 		ItemFrame() {
@@ -132,6 +142,9 @@ private:
 			parent_frame = NULL;
 			cell = false;
 			parent_line = 0;
+			first_invalid_line = 0;
+			first_unplaced_line = 0;
+			layout_width = -1;
 		}
 	};
 
@@ -234,6 +247,7 @@ private:
 
 	void _invalidate_current_line(ItemFrame *p_frame);
 	void _validate_line_caches(ItemFrame *p_frame);
+	int _find_first_visible_line(ItemFrame *p_frame, int p_ofs) const;
 
 	void _add_item(Item *p_item, bool p_enter = false, bool p_ensure_newline = false);
 	void _remove_item(Item *p_item, const int p_line, const int p_subitem_line);
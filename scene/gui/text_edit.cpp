@@ -253,6 +253,24 @@ void TextEdit::Text::clear_width_cache() {
 	}
 }
 
+void TextEdit::Text::set_syntax_highlighting_cache(int p_line, const Map<int, HighlighterInfo> &p_color_map, uint32_t p_version) {
+
+	ERR_FAIL_INDEX(p_line, text.size());
+
+	text.write[p_line].syntax_highlighting_cache = p_color_map;
+	text.write[p_line].syntax_highlighting_version = p_version;
+}
+
+const Map<int, TextEdit::HighlighterInfo> *TextEdit::Text::get_syntax_highlighting_cache(int p_line, uint32_t p_version) const {
+
+	ERR_FAIL_INDEX_V(p_line, text.size(), NULL);
+
+	if (text[p_line].syntax_highlighting_version != p_version)
+		return NULL;
+
+	return &text[p_line].syntax_highlighting_cache;
+}
+
 void TextEdit::Text::clear_wrap_cache() {
 
 	for (int i = 0; i < text.size(); i++) {
@@ -283,6 +301,7 @@ void TextEdit::Text::set(int p_line, const String &p_text) {
 
 	text.write[p_line].width_cache = -1;
 	text.write[p_line].wrap_amount_cache = -1;
+	text.write[p_line].syntax_highlighting_version = 0;
 	text.write[p_line].data = p_text;
 }
 
@@ -295,6 +314,8 @@ void TextEdit::Text::insert(int p_at, const String &p_text) {
 	line.hidden = false;
 	line.width_cache = -1;
 	line.wrap_amount_cache = -1;
+	line.region_cache = -1;
+	line.syntax_highlighting_version = 0;
 	line.data = p_text;
 	text.insert(p_at, line);
 }
@@ -3393,7 +3414,7 @@ void TextEdit::_base_insert_text(int p_line, int p_char, const String &p_text, i
 			MessageQueue::get_singleton()->push_call(this, "_text_changed_emit");
 		text_changed_dirty = true;
 	}
-	_line_edited_from(p_line);
+	_line_edited_from(p_line, r_end_line, substrings.size() - 1);
 }
 
 String TextEdit::_base_get_text(int p_from_line, int p_from_column, int p_to_line, int p_to_column) const {
@@ -3455,7 +3476,7 @@ void TextEdit::_base_remove_text(int p_from_line, int p_from_column, int p_to_li
 			MessageQueue::get_singleton()->push_call(this, "_text_changed_emit");
 		text_changed_dirty = true;
 	}
-	_line_edited_from(p_from_line);
+	_line_edited_from(p_from_line, p_from_line, -lines);
 }
 
 void TextEdit::_insert_text(int p_line, int p_char, const String &p_text, int *r_end_line, int *r_end_char) {
@@ -3578,10 +3599,25 @@ void TextEdit::_insert_text_at_cursor(const String &p_text) {
 	update();
 }
 
-void TextEdit::_line_edited_from(int p_line) {
-	int cache_size = color_region_cache.size();
-	for (int i = p_line; i < cache_size; i++) {
-		color_region_cache.erase(i);
+void TextEdit::_line_edited_from(int p_line, int p_to_line, int p_lines_added) {
+
+	// the states are stored with the lines, so only the indices tracking them move
+	if (color_region_cache_to > p_line + 1) {
+		color_region_cache_to = MAX(color_region_cache_to + p_lines_added, p_line + 1);
+	}
+
+	if (color_region_changed_from == -1) {
+		color_region_changed_from = p_line;
+		color_region_changed_to = p_to_line;
+	} else {
+		if (color_region_changed_from > p_line) {
+			color_region_changed_from = MAX(color_region_changed_from + p_lines_added, p_line);
+		}
+		if (color_region_changed_to > p_line) {
+			color_region_changed_to = MAX(color_region_changed_to + p_lines_added, p_line);
+		}
+		color_region_changed_from = MIN(color_region_changed_from, p_line);
+		color_region_changed_to = MAX(color_region_changed_to, p_to_line);
 	}
 }
 
@@ -4250,6 +4286,7 @@ void TextEdit::_clear() {
 
 	clear_undo_history();
 	text.clear();
+	_clear_color_region_cache();
 	cursor.column = 0;
 	cursor.line = 0;
 	cursor.x_ofs = 0;
@@ -4359,6 +4396,7 @@ void TextEdit::_update_caches() {
 	if (syntax_highlighter) {
 		syntax_highlighter->_update_cache();
 	}
+	_clear_syntax_highlighting_cache();
 }
 
 SyntaxHighlighter *TextEdit::_get_syntax_highlighting() {
@@ -4371,53 +4409,109 @@ void TextEdit::_set_syntax_highlighting(SyntaxHighlighter *p_syntax_highlighter)
 		syntax_highlighter->set_text_editor(this);
 		syntax_highlighter->_update_cache();
 	}
+	_clear_syntax_highlighting_cache();
 	update();
 }
 
-int TextEdit::_is_line_in_region(int p_line) {
+int TextEdit::_get_line_region_end(int p_line, int p_in_region) {
 
-	// do we have in cache?
-	if (color_region_cache.has(p_line)) {
-		return color_region_cache[p_line];
-	}
+	int in_region = p_in_region;
 
-	// if not find the closest line we have
-	int previous_line = p_line - 1;
-	for (previous_line; previous_line > -1; previous_line--) {
-		if (color_region_cache.has(p_line)) {
-			break;
+	const Map<int, Text::ColorRegionInfo> &cri_map = _get_line_color_region_info(p_line);
+	for (const Map<int, Text::ColorRegionInfo>::Element *E = cri_map.front(); E; E = E->next()) {
+		const Text::ColorRegionInfo &cri = E->get();
+		if (in_region == -1) {
+			if (!cri.end) {
+				in_region = cri.region;
+			}
+		} else if (in_region == cri.region && !_get_color_region(cri.region).line_only) {
+			if (cri.end || _get_color_region(cri.region).eq) {
+				in_region = -1;
+			}
 		}
 	}
 
-	// calculate up to line we need and update the cache along the way.
-	int in_region = color_region_cache[previous_line];
-	if (previous_line == -1) {
+	if (in_region >= 0 && _get_color_region(in_region).line_only) {
 		in_region = -1;
 	}
-	for (int i = previous_line; i < p_line; i++) {
-		const Map<int, Text::ColorRegionInfo> &cri_map = _get_line_color_region_info(i);
-		for (const Map<int, Text::ColorRegionInfo>::Element *E = cri_map.front(); E; E = E->next()) {
-			const Text::ColorRegionInfo &cri = E->get();
-			if (in_region == -1) {
-				if (!cri.end) {
-					in_region = cri.region;
-				}
-			} else if (in_region == cri.region && !_get_color_region(cri.region).line_only) {
-				if (cri.end || _get_color_region(cri.region).eq) {
-					in_region = -1;
+
+	return in_region;
+}
+
+int TextEdit::_is_line_in_region(int p_line) {
+
+	if (p_line <= 0 || p_line >= text.size())
+		return -1;
+
+	// states before this line are up to date
+	int from = color_region_cache_to;
+	if (color_region_changed_from != -1) {
+		from = MIN(from, color_region_changed_from + 1);
+	}
+
+	if (p_line < from) {
+		return text.get_region_cache(p_line);
+	}
+
+	if (from == 0) {
+		text.set_region_cache(0, -1);
+		from = 1;
+	}
+
+	// propagate from the first outdated line, stopping early once the states match the previous ones again
+	int in_region = text.get_region_cache(from - 1);
+	for (int i = from; i <= p_line; i++) {
+
+		in_region = _get_line_region_end(i - 1, in_region);
+
+		if (i < color_region_cache_to && text.get_region_cache(i) == in_region) {
+			if (color_region_changed_from == -1 || i > color_region_changed_to) {
+				// past the edited lines, so everything below is still valid
+				color_region_changed_from = -1;
+				if (p_line < color_region_cache_to) {
+					return text.get_region_cache(p_line);
 				}
+				i = color_region_cache_to - 1;
+				in_region = text.get_region_cache(i);
 			}
+			continue;
 		}
 
-		if (in_region >= 0 && _get_color_region(in_region).line_only) {
-			in_region = -1;
+		if (i >= color_region_cache_to) {
+			color_region_cache_to = i + 1;
+		} else {
+			// lines entering or leaving a region have to be colored again
+			text.invalidate_syntax_highlighting_cache(i);
 		}
+		text.set_region_cache(i, in_region);
+	}
 
-		color_region_cache[i + 1] = in_region;
+	if (color_region_changed_from != -1) {
+		if (p_line + 1 >= color_region_cache_to) {
+			color_region_changed_from = -1;
+		} else {
+			color_region_changed_from = p_line;
+		}
 	}
+
 	return in_region;
 }
 
+void TextEdit::_clear_color_region_cache() {
+
+	color_region_cache_to = 0;
+	color_region_changed_from = -1;
+	color_region_changed_to = -1;
+	_clear_syntax_highlighting_cache();
+}
+
+void TextEdit::_clear_syntax_highlighting_cache() {
+
+	syntax_highlighting_version++;
+	if (syntax_highlighting_version == 0)
+		syntax_highlighting_version = 1; // 0 marks a single outdated line
+}
+
 TextEdit::ColorRegion TextEdit::_get_color_region(int p_region) const {
 	if (p_region < 0 || p_region >= color_regions.size()) {
 		return ColorRegion();
@@ -4436,13 +4530,14 @@ void TextEdit::clear_colors() {
 
 	keywords.clear();
 	color_regions.clear();
-	color_region_cache.clear();
+	_clear_color_region_cache();
 	text.clear_width_cache();
 }
 
 void TextEdit::add_keyword_color(const String &p_keyword, const Color &p_color) {
 
 	keywords[p_keyword] = p_color;
+	_clear_syntax_highlighting_cache();
 	update();
 }
 
@@ -4457,12 +4552,14 @@ Color TextEdit::get_keyword_color(String p_keyword) const {
 void TextEdit::add_color_region(const String &p_begin_key, const String &p_end_key, const Color &p_color, bool p_line_only) {
 
 	color_regions.push_back(ColorRegion(p_begin_key, p_end_key, p_color, p_line_only));
+	_clear_color_region_cache();
 	text.clear_width_cache();
 	update();
 }
 
 void TextEdit::add_member_keyword(const String &p_keyword, const Color &p_color) {
 	member_keywords[p_keyword] = p_color;
+	_clear_syntax_highlighting_cache();
 	update();
 }
 
@@ -4476,6 +4573,7 @@ Color TextEdit::get_member_color(String p_member) const {
 
 void TextEdit::clear_member_keywords() {
 	member_keywords.clear();
+	_clear_syntax_highlighting_cache();
 	update();
 }
 
@@ -6218,8 +6316,6 @@ void TextEdit::_bind_methods() {
 	BIND_ENUM_CONSTANT(MENU_SELECT_ALL);
 	BIND_ENUM_CONSTANT(MENU_UNDO);
 	BIND_ENUM_CONSTANT(MENU_MAX);
-
-	GLOBAL_DEF("gui/timers/text_edit_idle_detect_sec", 3);
 }
 
 TextEdit::TextEdit() {
@@ -6248,6 +6344,10 @@ TextEdit::TextEdit() {
 	indent_size = 4;
 	text.set_indent_size(indent_size);
 	text.clear();
+	color_region_cache_to = 0;
+	color_region_changed_from = -1;
+	color_region_changed_to = -1;
+	syntax_highlighting_version = 1;
 	//text.insert(1,"Mongolia...");
 	//text.insert(2,"PAIS GENEROSO!!");
 	text.set_color_regions(&color_regions);
@@ -6355,10 +6455,28 @@ TextEdit::~TextEdit() {
 ///////////////////////////////////////////////////////////////////////////////
 
 Map<int, TextEdit::HighlighterInfo> TextEdit::_get_line_syntax_highlighting(int p_line) {
+
+	// bring the region state up to date first, it invalidates the lines whose region changed
+	_is_line_in_region(p_line);
+
+	const Map<int, HighlighterInfo> *cached = text.get_syntax_highlighting_cache(p_line, syntax_highlighting_version);
+	if (cached) {
+		return *cached;
+	}
+
+	Map<int, HighlighterInfo> color_map;
 	if (syntax_highlighter != NULL) {
-		return syntax_highlighter->_get_line_syntax_highlighting(p_line);
+		color_map = syntax_highlighter->_get_line_syntax_highlighting(p_line);
+	} else {
+		color_map = _compute_line_syntax_highlighting(p_line);
 	}
 
+	text.set_syntax_highlighting_cache(p_line, color_map, syntax_highlighting_version);
+	return color_map;
+}
+
+Map<int, TextEdit::HighlighterInfo> TextEdit::_compute_line_syntax_highlighting(int p_line) {
+
 	Map<int, HighlighterInfo> color_map;
 
 	bool prev_is_char = false;
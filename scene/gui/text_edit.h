@@ -78,7 +78,10 @@ public:
 			bool hidden : 1;
 			bool safe : 1;
 			int wrap_amount_cache : 24;
+			int region_cache; // color region open at the start of the line
+			uint32_t syntax_highlighting_version; // syntax_highlighting_cache is valid while this matches TextEdit's
 			Map<int, ColorRegionInfo> region_info;
+			Map<int, HighlighterInfo> syntax_highlighting_cache;
 			String data;
 		};
 
@@ -109,6 +112,11 @@ public:
 		bool is_hidden(int p_line) const { return text[p_line].hidden; }
 		void set_safe(int p_line, bool p_safe) { text.write[p_line].safe = p_safe; }
 		bool is_safe(int p_line) const { return text[p_line].safe; }
+		void set_region_cache(int p_line, int p_region) { text.write[p_line].region_cache = p_region; }
+		int get_region_cache(int p_line) const { return text[p_line].region_cache; }
+		void set_syntax_highlighting_cache(int p_line, const Map<int, HighlighterInfo> &p_color_map, uint32_t p_version);
+		const Map<int, HighlighterInfo> *get_syntax_highlighting_cache(int p_line, uint32_t p_version) const;
+		void invalidate_syntax_highlighting_cache(int p_line) { text.write[p_line].syntax_highlighting_version = 0; }
 		void insert(int p_at, const String &p_text);
 		void remove(int p_at);
 		int size() const { return text.size(); }
@@ -196,7 +204,11 @@ private:
 		Size2 size;
 	} cache;
 
-	Map<int, int> color_region_cache;
+	// start of line color region states, see _is_line_in_region()
+	int color_region_cache_to; // lines before this one have a computed state
+	int color_region_changed_from; // first and last edited lines whose effect was not propagated yet, -1 if none
+	int color_region_changed_to;
+	uint32_t syntax_highlighting_version;
 
 	struct TextOperation {
 
@@ -233,6 +245,10 @@ private:
 	HashMap<String, Color> member_keywords;
 
 	Map<int, HighlighterInfo> _get_line_syntax_highlighting(int p_line);
+	Map<int, HighlighterInfo> _compute_line_syntax_highlighting(int p_line);
+	int _get_line_region_end(int p_line, int p_in_region);
+	void _clear_color_region_cache();
+	void _clear_syntax_highlighting_cache();
 
 	Vector<ColorRegion> color_regions;
 
@@ -395,7 +411,7 @@ private:
 	void _update_caches();
 	void _cursor_changed_emit();
 	void _text_changed_emit();
-	void _line_edited_from(int p_line);
+	void _line_edited_from(int p_line, int p_to_line, int p_lines_added);
 
 	void _push_current_op();
 
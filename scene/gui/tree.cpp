@@ -99,14 +99,27 @@ void TreeItem::Cell::draw_icon(const RID &p_where, const Point2 &p_pos, const Si
 
 void TreeItem::_changed_notify(int p_cell) {
 
+	_height_changed();
 	tree->item_changed(p_cell, this);
 }
 
 void TreeItem::_changed_notify() {
 
+	_height_changed();
 	tree->item_changed(-1, this);
 }
 
+void TreeItem::_height_changed() {
+
+	// parents include this item in their heights, stop at the first one that is already outdated
+	TreeItem *it = this;
+	while (it && it->height_version == tree->height_version) {
+
+		it->height_version = 0;
+		it = it->parent;
+	}
+}
+
 void TreeItem::_cell_selected(int p_cell) {
 
 	tree->item_selected(p_cell, this);
@@ -455,6 +468,7 @@ void TreeItem::remove_child(TreeItem *p_item) {
 			*c = (*c)->next;
 
 			aux->parent = NULL;
+			_height_changed();
 			return;
 		}
 
@@ -812,6 +826,7 @@ void TreeItem::clear_children() {
 	}
 
 	children = 0;
+	_height_changed();
 };
 
 TreeItem::TreeItem(Tree *p_tree) {
@@ -824,6 +839,10 @@ TreeItem::TreeItem(Tree *p_tree) {
 	parent = 0; // parent item
 	next = 0; // next in list
 	children = 0; //child items
+
+	height_cache = 0;
+	subtree_height_cache = 0;
+	height_version = 0;
 }
 
 TreeItem::~TreeItem() {
@@ -913,9 +932,22 @@ void Tree::update_cache() {
 	cache.title_button_color = get_color("title_button_color");
 
 	v_scroll->set_custom_step(cache.font->get_height());
+
+	// item heights are cached, measure them again only if the theme items they depend on changed
+	int font_height = cache.font->get_height();
+	int check_height = cache.checked->get_height();
+	int custom_button_height = cache.custom_button->get_minimum_size().height;
+	if (font_height != cache.item_font_height || check_height != cache.item_check_height || custom_button_height != cache.item_custom_button_height || cache.vseparation != cache.item_vseparation) {
+
+		cache.item_font_height = font_height;
+		cache.item_check_height = check_height;
+		cache.item_custom_button_height = custom_button_height;
+		cache.item_vseparation = cache.vseparation;
+		_invalidate_item_heights();
+	}
 }
 
-int Tree::compute_item_height(TreeItem *p_item) const {
+int Tree::_compute_item_height(TreeItem *p_item) const {
 
 	if (p_item == root && hide_root)
 		return 0;
@@ -972,10 +1004,13 @@ int Tree::compute_item_height(TreeItem *p_item) const {
 	return height;
 }
 
-int Tree::get_item_height(TreeItem *p_item) const {
+void Tree::_update_item_height(TreeItem *p_item) const {
 
-	int height = compute_item_height(p_item);
-	height += cache.vseparation;
+	if (p_item->height_version == height_version)
+		return;
+
+	p_item->height_cache = _compute_item_height(p_item);
+	p_item->subtree_height_cache = p_item->height_cache + cache.vseparation;
 
 	if (!p_item->collapsed) { /* if not collapsed, check the children */
 
@@ -983,13 +1018,34 @@ int Tree::get_item_height(TreeItem *p_item) const {
 
 		while (c) {
 
-			height += get_item_height(c);
+			_update_item_height(c);
+			p_item->subtree_height_cache += c->subtree_height_cache;
 
 			c = c->next;
 		}
 	}
 
-	return height;
+	p_item->height_version = height_version;
+}
+
+void Tree::_invalidate_item_heights() {
+
+	height_version++;
+	if (height_version == 0)
+		height_version = 1; // 0 marks a single outdated item
+	update();
+}
+
+int Tree::compute_item_height(TreeItem *p_item) const {
+
+	_update_item_height(p_item);
+	return p_item->height_cache;
+}
+
+int Tree::get_item_height(TreeItem *p_item) const {
+
+	_update_item_height(p_item);
+	return p_item->subtree_height_cache;
 }
 
 void Tree::draw_item_rect(const TreeItem::Cell &p_cell, const Rect2i &p_rect, const Color &p_color, const Color &p_icon_color) {
@@ -1047,6 +1103,9 @@ int Tree::draw_item(const Point2i &p_pos, const Point2 &p_draw_ofs, const Size2
 	if (p_pos.y - cache.offset.y > (p_draw_size.height))
 		return -1; //draw no more!
 
+	if (p_item != root && p_pos.y + get_item_height(p_item) - cache.offset.y <= 0)
+		return get_item_height(p_item); //whole subtree is above the visible area, nothing to draw
+
 	RID ci = get_canvas_item();
 
 	int htotal = 0;
@@ -1622,6 +1681,9 @@ void Tree::_range_click_timeout() {
 
 int Tree::propagate_mouse_event(const Point2i &p_pos, int x_ofs, int y_ofs, bool p_doubleclick, TreeItem *p_item, int p_button, const Ref<InputEventWithModifiers> &p_mod) {
 
+	if (p_item != root && p_pos.y >= get_item_height(p_item))
+		return get_item_height(p_item); //not in this subtree, skip it entirely
+
 	int item_h = compute_item_height(p_item) + cache.vseparation;
 
 	bool skip = (p_item == root && hide_root);
@@ -3010,6 +3072,7 @@ TreeItem *Tree::create_item(TreeItem *p_parent, int p_idx) {
 		else
 			p_parent->children = ti;
 		ti->parent = p_parent;
+		p_parent->_height_changed();
 
 	} else {
 
@@ -3153,7 +3216,7 @@ void Tree::clear() {
 void Tree::set_hide_root(bool p_enabled) {
 
 	hide_root = p_enabled;
-	update();
+	_invalidate_item_heights();
 }
 
 bool Tree::is_root_hidden() const {
@@ -3298,7 +3361,7 @@ void Tree::set_columns(int p_columns) {
 		propagate_set_columns(root);
 	if (selected_col >= p_columns)
 		selected_col = p_columns - 1;
-	update();
+	_invalidate_item_heights();
 }
 
 int Tree::get_columns() const {
@@ -3318,39 +3381,25 @@ Rect2 Tree::get_custom_popup_rect() const {
 
 int Tree::get_item_offset(TreeItem *p_item) const {
 
-	TreeItem *it = root;
-	int ofs = _get_title_button_height();
-	if (!it)
+	if (!root)
 		return 0;
 
-	while (true) {
-
-		if (it == p_item)
-			return ofs;
-
-		ofs += compute_item_height(it) + cache.vseparation;
-
-		if (it->children && !it->collapsed) {
-
-			it = it->children;
-
-		} else if (it->next) {
-
-			it = it->next;
-		} else {
+	int ofs = _get_title_button_height();
 
-			while (!it->next) {
+	// walk up to the root, adding the parents and the subtrees of the previous siblings
+	for (TreeItem *it = p_item; it != root; it = it->parent) {
 
-				it = it->parent;
-				if (it == NULL)
-					return 0;
-			}
+		if (!it || !it->parent || it->parent->collapsed)
+			return 0; // not visible in this tree
 
-			it = it->next;
+		for (TreeItem *c = it->parent->children; c != it; c = c->next) {
+			ofs += get_item_height(c);
 		}
+
+		ofs += compute_item_height(it->parent) + cache.vseparation;
 	}
 
-	return -1; //not found
+	return ofs;
 }
 
 void Tree::ensure_cursor_is_visible() {
@@ -3514,6 +3563,12 @@ TreeItem *Tree::_find_item_at_pos(TreeItem *p_item, const Point2 &p_pos, int &r_
 
 	Point2 pos = p_pos;
 
+	if (root != p_item && pos.y >= get_item_height(p_item)) {
+
+		h = get_item_height(p_item); // not in this subtree, skip it entirely
+		return NULL;
+	}
+
 	if (root != p_item || !hide_root) {
 
 		h = compute_item_height(p_item) + cache.vseparation;
@@ -3911,6 +3966,11 @@ Tree::Tree() {
 
 	cache.click_type = Cache::CLICK_NONE;
 	cache.hover_type = Cache::CLICK_NONE;
+	cache.item_font_height = -1;
+	cache.item_check_height = -1;
+	cache.item_custom_button_height = -1;
+	cache.item_vseparation = -1;
+	height_version = 1;
 	cache.hover_index = -1;
 	cache.click_index = -1;
 	cache.click_id = -1;
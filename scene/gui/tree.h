@@ -153,10 +153,15 @@ private:
 	TreeItem *children; //child items
 	Tree *tree; //tree (for reference)
 
+	int height_cache; // height of the item itself
+	int subtree_height_cache; // height of the item and its visible children
+	uint32_t height_version; // caches are valid while this matches Tree::height_version
+
 	TreeItem(Tree *p_tree);
 
 	void _changed_notify(int p_cell);
 	void _changed_notify();
+	void _height_changed();
 	void _cell_selected(int p_cell);
 	void _cell_deselected(int p_cell);
 
@@ -342,6 +347,7 @@ private:
 	SelectMode select_mode;
 
 	int blocked;
+	uint32_t height_version;
 
 	int drop_mode_flags;
 
@@ -370,6 +376,9 @@ private:
 	bool range_up_last;
 	void _range_click_timeout();
 
+	int _compute_item_height(TreeItem *p_item) const;
+	void _update_item_height(TreeItem *p_item) const;
+	void _invalidate_item_heights();
 	int compute_item_height(TreeItem *p_item) const;
 	int get_item_height(TreeItem *p_item) const;
 	//void draw_item_text(String p_text,const Ref<Texture>& p_icon,int p_icon_max_w,bool p_tool,Rect2i p_rect,const Color& p_color);
@@ -439,6 +448,11 @@ private:
 		int scroll_border;
 		int scroll_speed;
 
+		int item_font_height;
+		int item_check_height;
+		int item_custom_button_height;
+		int item_vseparation;
+
 		enum ClickType {
 			CLICK_NONE,
 			CLICK_TITLE,
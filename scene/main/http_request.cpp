@@ -30,14 +30,94 @@
 
 #include "http_request.h"
 
+Mutex *HTTPRequest::connection_pool_mutex = NULL;
+Map<String, List<HTTPRequest::PooledConnection> > *HTTPRequest::connection_pool = NULL;
+
 void HTTPRequest::_redirect_request(const String &p_new_url) {
 }
 
 Error HTTPRequest::_request() {
 
+	if (reused_connection)
+		return OK; // pooled connection, already connected
+
 	return client->connect_to_host(url, port, use_ssl, validate_ssl);
 }
 
+String HTTPRequest::_get_connection_key() const {
+
+	return String(use_ssl ? "https://" : "http://") + url + ":" + itos(port) + (use_ssl && !validate_ssl ? "?novalidate" : "");
+}
+
+bool HTTPRequest::_acquire_connection() {
+
+	if (!connection_pool)
+		return false;
+
+	MutexLock lock(connection_pool_mutex);
+
+	Map<String, List<PooledConnection> >::Element *E = connection_pool->find(_get_connection_key());
+	if (!E)
+		return false;
+
+	uint64_t now = OS::get_singleton()->get_ticks_msec();
+	bool found = false;
+
+	while (!found && E->get().size()) {
+
+		PooledConnection pc = E->get().back()->get();
+		E->get().pop_back();
+
+		if (now - pc.last_used > POOLED_CONNECTION_TIMEOUT_MSEC || pc.client->get_status() != HTTPClient::STATUS_CONNECTED) {
+			pc.client->close(); // idle for too long, the server has likely closed it
+			continue;
+		}
+
+		client = pc.client;
+		found = true;
+	}
+
+	if (E->get().empty())
+		connection_pool->erase(E);
+
+	return found;
+}
+
+void HTTPRequest::_release_connection() {
+
+	if (!connection_pool) {
+		client->close();
+		return;
+	}
+
+	MutexLock lock(connection_pool_mutex);
+
+	List<PooledConnection> &connections = (*connection_pool)[_get_connection_key()];
+	if (connections.size() >= MAX_POOLED_CONNECTIONS_PER_HOST) {
+		connections.front()->get().client->close();
+		connections.pop_front();
+	}
+
+	PooledConnection pc;
+	pc.client = client;
+	pc.last_used = OS::get_singleton()->get_ticks_msec();
+	connections.push_back(pc);
+
+	// the pooled client now belongs to the pool, use a new one for the next request
+	client.instance();
+}
+
+bool HTTPRequest::_retry_connection() {
+
+	// a pooled connection may have been closed by the server while idle, try once more with a new one
+	if (!reused_connection || got_response)
+		return false;
+
+	reused_connection = false;
+	request_sent = false;
+	return _request() == OK;
+}
+
 Error HTTPRequest::_parse_url(const String &p_url) {
 
 	url = p_url;
@@ -106,6 +186,20 @@ Error HTTPRequest::request(const String &p_url, const Vector<String> &p_custom_h
 
 	headers = p_custom_headers;
 
+	if (accept_gzip) {
+		bool has_accept_encoding = false;
+		for (int i = 0; i < headers.size(); i++) {
+			if (headers[i].findn("Accept-Encoding:") == 0) {
+				has_accept_encoding = true;
+				break;
+			}
+		}
+		if (!has_accept_encoding)
+			headers.push_back("Accept-Encoding: gzip, deflate");
+	}
+
+	reused_connection = use_keep_alive && _acquire_connection();
+
 	request_data = p_request_data;
 
 	requesting = true;
@@ -169,7 +263,17 @@ void HTTPRequest::cancel_request() {
 		memdelete(file);
 		file = NULL;
 	}
-	client->close();
+	if (decompressor) {
+		memdelete(decompressor);
+		decompressor = NULL;
+	}
+	if (keep_connection && client->get_status() == HTTPClient::STATUS_CONNECTED) {
+		_release_connection();
+	} else {
+		client->close();
+	}
+	keep_connection = false;
+	reused_connection = false;
 	body.resize(0);
 	got_response = false;
 	response_code = -1;
@@ -216,6 +320,7 @@ bool HTTPRequest::_handle_response(bool *ret_value) {
 		if (new_request != "") {
 			// Process redirect
 			client->close();
+			reused_connection = false;
 			int new_redirs = redirections + 1; // Because _request() will clear it
 			Error err;
 			if (new_request.begins_with("http")) {
@@ -247,6 +352,8 @@ bool HTTPRequest::_update_connection() {
 
 	switch (client->get_status()) {
 		case HTTPClient::STATUS_DISCONNECTED: {
+			if (_retry_connection())
+				return false;
 			call_deferred("_request_done", RESULT_CANT_CONNECT, 0, PoolStringArray(), PoolByteArray());
 			return true; // End it, since it's doing something
 		} break;
@@ -349,6 +456,26 @@ bool HTTPRequest::_update_connection() {
 						return true;
 					}
 				}
+
+				if (accept_gzip) {
+					for (int i = 0; i < response_headers.size(); i++) {
+						if (response_headers[i].findn("Content-Encoding:") != 0)
+							continue;
+
+						String encoding = response_headers[i].substr(17, response_headers[i].length()).strip_edges().to_lower();
+						if (encoding == "gzip" || encoding == "deflate") {
+							decompressor = memnew(StreamDecompressor);
+							decompressor->start(encoding == "gzip" ? Compression::MODE_GZIP : Compression::MODE_DEFLATE);
+						}
+						break;
+					}
+				}
+
+				// with a known length, fill the body in place instead of growing it chunk by chunk
+				body_preallocated = body_len > 0 && !file && !decompressor;
+				if (body_preallocated) {
+					body.resize(body_len);
+				}
 			}
 
 			client->poll();
@@ -356,6 +483,20 @@ bool HTTPRequest::_update_connection() {
 			PoolByteArray chunk = client->read_response_body_chunk();
 			downloaded += chunk.size();
 
+			if (decompressor && chunk.size()) {
+				PoolByteArray inflated;
+				Error err;
+				{
+					PoolByteArray::Read r = chunk.read();
+					err = decompressor->decompress(r.ptr(), chunk.size(), inflated);
+				}
+				if (err != OK) {
+					call_deferred("_request_done", RESULT_BODY_DECOMPRESS_FAILED, response_code, response_headers, PoolByteArray());
+					return true;
+				}
+				chunk = inflated;
+			}
+
 			if (file) {
 				PoolByteArray::Read r = chunk.read();
 				file->store_buffer(r.ptr(), chunk.size());
@@ -363,11 +504,17 @@ bool HTTPRequest::_update_connection() {
 					call_deferred("_request_done", RESULT_DOWNLOAD_FILE_WRITE_ERROR, response_code, response_headers, PoolByteArray());
 					return true;
 				}
+			} else if (body_preallocated) {
+				if (chunk.size()) {
+					PoolByteArray::Write w = body.write();
+					PoolByteArray::Read r = chunk.read();
+					copymem(&w[downloaded - chunk.size()], r.ptr(), chunk.size());
+				}
 			} else {
 				body.append_array(chunk);
 			}
 
-			if (body_size_limit >= 0 && downloaded > body_size_limit) {
+			if (body_size_limit >= 0 && (downloaded > body_size_limit || (decompressor && decompressor->get_total_out() > (uint64_t)body_size_limit))) {
 				call_deferred("_request_done", RESULT_BODY_SIZE_LIMIT_EXCEEDED, response_code, response_headers, PoolByteArray());
 				return true;
 			}
@@ -384,6 +531,8 @@ bool HTTPRequest::_update_connection() {
 
 		} break; // Request resulted in body: break which must be read
 		case HTTPClient::STATUS_CONNECTION_ERROR: {
+			if (_retry_connection())
+				return false;
 			call_deferred("_request_done", RESULT_CONNECTION_ERROR, 0, PoolStringArray(), PoolByteArray());
 			return true;
 		} break;
@@ -398,6 +547,16 @@ bool HTTPRequest::_update_connection() {
 
 void HTTPRequest::_request_done(int p_status, int p_code, const PoolStringArray &headers, const PoolByteArray &p_data) {
 
+	if (use_keep_alive && p_status == RESULT_SUCCESS) {
+		keep_connection = true;
+		for (int i = 0; i < headers.size(); i++) {
+			if (headers[i].findn("Connection:") == 0 && headers[i].findn("close") != -1) {
+				keep_connection = false; // server will close it
+				break;
+			}
+		}
+	}
+
 	cancel_request();
 	emit_signal("request_completed", p_status, p_code, headers, p_data);
 }
@@ -434,6 +593,26 @@ bool HTTPRequest::is_using_threads() const {
 	return use_threads;
 }
 
+void HTTPRequest::set_use_keep_alive(bool p_use) {
+
+	use_keep_alive = p_use;
+}
+
+bool HTTPRequest::is_using_keep_alive() const {
+
+	return use_keep_alive;
+}
+
+void HTTPRequest::set_accept_gzip(bool p_accept) {
+
+	accept_gzip = p_accept;
+}
+
+bool HTTPRequest::is_accepting_gzip() const {
+
+	return accept_gzip;
+}
+
 void HTTPRequest::set_body_size_limit(int p_bytes) {
 
 	ERR_FAIL_COND(status != HTTPClient::STATUS_DISCONNECTED);
@@ -479,6 +658,30 @@ int HTTPRequest::get_body_size() const {
 	return body_len;
 }
 
+void HTTPRequest::init_connection_pool() {
+
+	connection_pool_mutex = Mutex::create();
+	connection_pool = memnew((Map<String, List<PooledConnection> >));
+}
+
+void HTTPRequest::finish_connection_pool() {
+
+	if (connection_pool) {
+		for (Map<String, List<PooledConnection> >::Element *E = connection_pool->front(); E; E = E->next()) {
+			for (List<PooledConnection>::Element *F = E->get().front(); F; F = F->next()) {
+				F->get().client->close();
+			}
+		}
+		memdelete(connection_pool);
+		connection_pool = NULL;
+	}
+
+	if (connection_pool_mutex) {
+		memdelete(connection_pool_mutex);
+		connection_pool_mutex = NULL;
+	}
+}
+
 void HTTPRequest::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("request", "url", "custom_headers", "ssl_validate_domain", "method", "request_data"), &HTTPRequest::request, DEFVAL(PoolStringArray()), DEFVAL(true), DEFVAL(HTTPClient::METHOD_GET), DEFVAL(String()));
@@ -489,6 +692,12 @@ void HTTPRequest::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_use_threads", "enable"), &HTTPRequest::set_use_threads);
 	ClassDB::bind_method(D_METHOD("is_using_threads"), &HTTPRequest::is_using_threads);
 
+	ClassDB::bind_method(D_METHOD("set_use_keep_alive", "enable"), &HTTPRequest::set_use_keep_alive);
+	ClassDB::bind_method(D_METHOD("is_using_keep_alive"), &HTTPRequest::is_using_keep_alive);
+
+	ClassDB::bind_method(D_METHOD("set_accept_gzip", "enable"), &HTTPRequest::set_accept_gzip);
+	ClassDB::bind_method(D_METHOD("is_accepting_gzip"), &HTTPRequest::is_accepting_gzip);
+
 	ClassDB::bind_method(D_METHOD("set_body_size_limit", "bytes"), &HTTPRequest::set_body_size_limit);
 	ClassDB::bind_method(D_METHOD("get_body_size_limit"), &HTTPRequest::get_body_size_limit);
 
@@ -506,6 +715,8 @@ void HTTPRequest::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "download_file", PROPERTY_HINT_FILE), "set_download_file", "get_download_file");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_threads"), "set_use_threads", "is_using_threads");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_keep_alive"), "set_use_keep_alive", "is_using_keep_alive");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "accept_gzip"), "set_accept_gzip", "is_accepting_gzip");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "body_size_limit", PROPERTY_HINT_RANGE, "-1,2000000000"), "set_body_size_limit", "get_body_size_limit");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_redirects", PROPERTY_HINT_RANGE, "-1,64"), "set_max_redirects", "get_max_redirects");
 
@@ -524,6 +735,7 @@ void HTTPRequest::_bind_methods() {
 	BIND_ENUM_CONSTANT(RESULT_DOWNLOAD_FILE_CANT_OPEN);
 	BIND_ENUM_CONSTANT(RESULT_DOWNLOAD_FILE_WRITE_ERROR);
 	BIND_ENUM_CONSTANT(RESULT_REDIRECT_LIMIT_REACHED);
+	BIND_ENUM_CONSTANT(RESULT_BODY_DECOMPRESS_FAILED);
 }
 
 HTTPRequest::HTTPRequest() {
@@ -542,6 +754,12 @@ HTTPRequest::HTTPRequest() {
 	requesting = false;
 	client.instance();
 	use_threads = false;
+	use_keep_alive = false;
+	reused_connection = false;
+	keep_connection = false;
+	accept_gzip = false;
+	decompressor = NULL;
+	body_preallocated = false;
 	thread_done = false;
 	downloaded = 0;
 	body_size_limit = -1;
@@ -552,4 +770,6 @@ HTTPRequest::HTTPRequest() {
 HTTPRequest::~HTTPRequest() {
 	if (file)
 		memdelete(file);
+	if (decompressor)
+		memdelete(decompressor);
 }
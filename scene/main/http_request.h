@@ -31,9 +31,11 @@
 #ifndef HTTPREQUEST_H
 #define HTTPREQUEST_H
 
+#include "io/compression.h"
 #include "io/http_client.h"
 #include "node.h"
 #include "os/file_access.h"
+#include "os/mutex.h"
 #include "os/thread.h"
 
 class HTTPRequest : public Node {
@@ -53,11 +55,26 @@ public:
 		RESULT_REQUEST_FAILED,
 		RESULT_DOWNLOAD_FILE_CANT_OPEN,
 		RESULT_DOWNLOAD_FILE_WRITE_ERROR,
-		RESULT_REDIRECT_LIMIT_REACHED
+		RESULT_REDIRECT_LIMIT_REACHED,
+		RESULT_BODY_DECOMPRESS_FAILED
 
 	};
 
 private:
+	enum {
+		MAX_POOLED_CONNECTIONS_PER_HOST = 4,
+		POOLED_CONNECTION_TIMEOUT_MSEC = 15000
+	};
+
+	struct PooledConnection {
+
+		Ref<HTTPClient> client;
+		uint64_t last_used;
+	};
+
+	static Mutex *connection_pool_mutex;
+	static Map<String, List<PooledConnection> > *connection_pool; // by scheme, host and port
+
 	bool requesting;
 
 	String request_string;
@@ -72,8 +89,16 @@ private:
 	bool request_sent;
 	Ref<HTTPClient> client;
 	PoolByteArray body;
+	bool body_preallocated;
 	volatile bool use_threads;
 
+	bool use_keep_alive;
+	bool reused_connection;
+	bool keep_connection;
+
+	bool accept_gzip;
+	StreamDecompressor *decompressor;
+
 	bool got_response;
 	int response_code;
 	PoolVector<String> response_headers;
@@ -101,6 +126,11 @@ private:
 	Error _parse_url(const String &p_url);
 	Error _request();
 
+	String _get_connection_key() const;
+	bool _acquire_connection();
+	void _release_connection();
+	bool _retry_connection();
+
 	volatile bool thread_done;
 	volatile bool thread_request_quit;
 
@@ -121,6 +151,12 @@ public:
 	void set_use_threads(bool p_use);
 	bool is_using_threads() const;
 
+	void set_use_keep_alive(bool p_use);
+	bool is_using_keep_alive() const;
+
+	void set_accept_gzip(bool p_accept);
+	bool is_accepting_gzip() const;
+
 	void set_download_file(const String &p_file);
 	String get_download_file() const;
 
@@ -133,6 +169,9 @@ public:
 	int get_downloaded_bytes() const;
 	int get_body_size() const;
 
+	static void init_connection_pool();
+	static void finish_connection_pool();
+
 	HTTPRequest();
 	~HTTPRequest();
 };
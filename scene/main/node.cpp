@@ -31,6 +31,7 @@
 #include "node.h"
 
 #include "core/core_string_names.h"
+#include "engine.h"
 #include "instance_placeholder.h"
 #include "io/resource_loader.h"
 #include "message_queue.h"
@@ -49,6 +50,10 @@ void Node::_notification(int p_notification) {
 
 			if (get_script_instance()) {
 
+				_update_process_script_cache();
+				if (!data.script_has_process)
+					break;
+
 				Variant time = get_process_delta_time();
 				const Variant *ptr[1] = { &time };
 				get_script_instance()->call_multilevel(SceneStringNames::get_singleton()->_process, ptr, 1);
@@ -58,6 +63,10 @@ void Node::_notification(int p_notification) {
 
 			if (get_script_instance()) {
 
+				_update_process_script_cache();
+				if (!data.script_has_physics_process)
+					break;
+
 				Variant time = get_physics_process_delta_time();
 				const Variant *ptr[1] = { &time };
 				get_script_instance()->call_multilevel(SceneStringNames::get_singleton()->_physics_process, ptr, 1);
@@ -76,6 +85,8 @@ void Node::_notification(int p_notification) {
 				data.pause_owner = this;
 			}
 
+			data.process_script_instance = NULL; //the instance may have been replaced while outside
+
 			if (data.input)
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
 			if (data.unhandled_input)
@@ -154,10 +165,10 @@ void Node::_notification(int p_notification) {
 				data.parent->remove_child(this);
 			}
 
-			// kill children as cleanly as possible
+			// kill children as cleanly as possible, from the back so no siblings need to be shifted
 			while (data.children.size()) {
 
-				Node *child = data.children[0];
+				Node *child = data.children[data.children.size() - 1];
 				remove_child(child);
 				memdelete(child);
 			}
@@ -762,8 +773,41 @@ bool Node::can_process() const {
 	return true;
 }
 
+bool Node::_process_interval_step(int p_notification, float p_delta) {
+
+	ProcessIntervalState &state = p_notification == NOTIFICATION_PROCESS ? data.idle_interval : data.physics_interval;
+
+	state.accumulated_delta += p_delta;
+	state.frames++;
+
+	if (state.frames < data.process_interval)
+		return false;
+
+	state.delta = state.accumulated_delta;
+	state.accumulated_delta = 0;
+	state.frames = 0;
+	return true;
+}
+
+void Node::_update_process_script_cache() {
+
+	ScriptInstance *si = get_script_instance();
+
+	// scripts can be edited and reloaded at any time in the editor, so only trust the cache when running
+	if (si == data.process_script_instance && data.process_script_reload_version == ScriptServer::get_reload_version() && !Engine::get_singleton()->is_editor_hint())
+		return;
+
+	data.process_script_instance = si;
+	data.process_script_reload_version = ScriptServer::get_reload_version();
+	data.script_has_process = si && si->has_method(SceneStringNames::get_singleton()->_process);
+	data.script_has_physics_process = si && si->has_method(SceneStringNames::get_singleton()->_physics_process);
+}
+
 float Node::get_physics_process_delta_time() const {
 
+	if (data.process_interval > 1)
+		return data.physics_interval.delta;
+
 	if (data.tree)
 		return data.tree->get_physics_process_time();
 	else
@@ -772,6 +816,9 @@ float Node::get_physics_process_delta_time() const {
 
 float Node::get_process_delta_time() const {
 
+	if (data.process_interval > 1)
+		return data.idle_interval.delta;
+
 	if (data.tree)
 		return data.tree->get_idle_process_time();
 	else
@@ -836,6 +883,27 @@ void Node::set_process_priority(int p_priority) {
 		data.tree->make_group_changed("physics_process_internal");
 }
 
+void Node::set_process_interval(int p_interval) {
+
+	ERR_FAIL_COND(p_interval < 1);
+
+	data.process_interval = p_interval;
+
+	// start nodes at different points of the interval, so those sharing it
+	// don't all run their callbacks on the same frame
+	int offset = get_instance_id() % p_interval;
+
+	data.idle_interval = ProcessIntervalState();
+	data.idle_interval.frames = offset;
+	data.physics_interval = ProcessIntervalState();
+	data.physics_interval.frames = offset;
+}
+
+int Node::get_process_interval() const {
+
+	return data.process_interval;
+}
+
 void Node::set_process_input(bool p_enable) {
 
 	if (p_enable == data.input)
@@ -899,6 +967,8 @@ StringName Node::get_name() const {
 void Node::_set_name_nocheck(const StringName &p_name) {
 
 	data.name = p_name;
+	if (data.parent)
+		data.parent->_child_index_invalidate();
 }
 
 String Node::invalid_character = ". : @ / \"";
@@ -924,6 +994,7 @@ void Node::set_name(const String &p_name) {
 
 	if (data.parent) {
 
+		data.parent->_child_index_invalidate();
 		data.parent->_validate_child_name(this);
 	}
 
@@ -943,6 +1014,14 @@ void Node::init_node_hrcr() {
 	node_hrcr_count.init(1);
 }
 
+void Node::init_project_settings() {
+
+	GLOBAL_DEF("node/name_num_separator", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("node/name_num_separator", PropertyInfo(Variant::INT, "node/name_num_separator", PROPERTY_HINT_ENUM, "None,Space,Underscore,Dash"));
+	GLOBAL_DEF("node/name_casing", NAME_CASING_PASCAL_CASE);
+	ProjectSettings::get_singleton()->set_custom_property_info("node/name_casing", PropertyInfo(Variant::INT, "node/name_casing", PROPERTY_HINT_ENUM, "PascalCase,camelCase,snake_case"));
+}
+
 void Node::set_human_readable_collision_renaming(bool p_enabled) {
 
 	node_hrcr = p_enabled;
@@ -1079,6 +1158,7 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	p_child->data.name = p_name;
 	p_child->data.pos = data.children.size();
 	data.children.push_back(p_child);
+	_child_index_add(p_child);
 	p_child->data.parent = this;
 	p_child->notification(NOTIFICATION_PARENTED);
 
@@ -1175,12 +1255,17 @@ void Node::remove_child(Node *p_child) {
 	}
 
 	int idx = -1;
-	for (int i = 0; i < data.children.size(); i++) {
+	int child_pos = p_child->data.pos;
+	if (child_pos >= 0 && child_pos < data.children.size() && data.children[child_pos] == p_child) {
+		idx = child_pos;
+	} else {
+		for (int i = 0; i < data.children.size(); i++) {
 
-		if (data.children[i] == p_child) {
+			if (data.children[i] == p_child) {
 
-			idx = i;
-			break;
+				idx = i;
+				break;
+			}
 		}
 	}
 
@@ -1195,6 +1280,7 @@ void Node::remove_child(Node *p_child) {
 	remove_child_notify(p_child);
 	p_child->notification(NOTIFICATION_UNPARENTED);
 
+	_child_index_remove(p_child);
 	data.children.remove(idx);
 
 	for (int i = idx; i < data.children.size(); i++) {
@@ -1220,17 +1306,73 @@ Node *Node::get_child(int p_index) const {
 	return data.children[p_index];
 }
 
+#define CHILD_INDEX_MIN_CHILDREN 16
+#define GET_NODE_CACHE_MAX_PATHS 64
+
 Node *Node::_get_child_by_name(const StringName &p_name) const {
 
 	int cc = data.children.size();
 	Node *const *cd = data.children.ptr();
 
-	for (int i = 0; i < cc; i++) {
-		if (cd[i]->data.name == p_name)
-			return cd[i];
+	if (cc < CHILD_INDEX_MIN_CHILDREN) {
+
+		for (int i = 0; i < cc; i++) {
+			if (cd[i]->data.name == p_name)
+				return cd[i];
+		}
+
+		return NULL;
+	}
+
+	if (!data.child_index) {
+		data.child_index = memnew((HashMap<StringName, Node *>));
+		data.child_index_dirty = true;
 	}
 
-	return NULL;
+	if (data.child_index_dirty) {
+
+		data.child_index->clear();
+		data.child_index_duplicates = false;
+		for (int i = 0; i < cc; i++) {
+			if (data.child_index->has(cd[i]->data.name)) {
+				data.child_index_duplicates = true; //first one wins, like the linear search
+			} else {
+				data.child_index->set(cd[i]->data.name, cd[i]);
+			}
+		}
+		data.child_index_dirty = false;
+	}
+
+	Node **child = data.child_index->getptr(p_name);
+	return child ? *child : NULL;
+}
+
+void Node::_child_index_add(Node *p_child) {
+
+	if (!data.child_index || data.child_index_dirty)
+		return;
+
+	if (data.child_index->has(p_child->data.name)) {
+		data.child_index_duplicates = true;
+	} else {
+		data.child_index->set(p_child->data.name, p_child);
+	}
+}
+
+void Node::_child_index_remove(Node *p_child) {
+
+	if (!data.child_index || data.child_index_dirty)
+		return;
+
+	if (data.child_index_duplicates) {
+		_child_index_invalidate(); //a sibling with the same name may have to take its place
+		return;
+	}
+
+	Node **child = data.child_index->getptr(p_child->data.name);
+	if (child && *child == p_child) {
+		data.child_index->erase(p_child->data.name);
+	}
 }
 
 Node *Node::_get_node(const NodePath &p_path) const {
@@ -1240,6 +1382,31 @@ Node *Node::_get_node(const NodePath &p_path) const {
 		ERR_FAIL_V(NULL);
 	}
 
+	if (data.inside_tree && p_path.get_name_count() > 1) {
+
+		// any change that could affect the result (adding, removing, moving or renaming nodes) bumps the tree version
+		if (!data.get_node_cache) {
+			data.get_node_cache = memnew((HashMap<NodePath, Node *>));
+		} else if (data.get_node_cache_version != data.tree->tree_version || data.get_node_cache->size() >= GET_NODE_CACHE_MAX_PATHS) {
+			data.get_node_cache->clear();
+		}
+		data.get_node_cache_version = data.tree->tree_version;
+
+		Node **cached = data.get_node_cache->getptr(p_path);
+		if (cached) {
+			return *cached;
+		}
+
+		Node *node = _resolve_node_path(p_path);
+		data.get_node_cache->set(p_path, node);
+		return node;
+	}
+
+	return _resolve_node_path(p_path);
+}
+
+Node *Node::_resolve_node_path(const NodePath &p_path) const {
+
 	Node *current = NULL;
 	Node *root = NULL;
 
@@ -1274,18 +1441,7 @@ Node *Node::_get_node(const NodePath &p_path) const {
 
 		} else {
 
-			next = NULL;
-
-			for (int j = 0; j < current->data.children.size(); j++) {
-
-				Node *child = current->data.children[j];
-
-				if (child->data.name == name) {
-
-					next = child;
-					break;
-				}
-			}
+			next = current->_get_child_by_name(name);
 			if (next == NULL) {
 				return NULL;
 			};
@@ -2588,11 +2744,6 @@ void Node::request_ready() {
 
 void Node::_bind_methods() {
 
-	GLOBAL_DEF("node/name_num_separator", 0);
-	ProjectSettings::get_singleton()->set_custom_property_info("node/name_num_separator", PropertyInfo(Variant::INT, "node/name_num_separator", PROPERTY_HINT_ENUM, "None,Space,Underscore,Dash"));
-	GLOBAL_DEF("node/name_casing", NAME_CASING_PASCAL_CASE);
-	ProjectSettings::get_singleton()->set_custom_property_info("node/name_casing", PropertyInfo(Variant::INT, "node/name_casing", PROPERTY_HINT_ENUM, "PascalCase,camelCase,snake_case"));
-
 	ClassDB::bind_method(D_METHOD("add_child_below_node", "node", "child_node", "legible_unique_name"), &Node::add_child_below_node, DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("set_name", "name"), &Node::set_name);
@@ -2636,6 +2787,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_process_delta_time"), &Node::get_process_delta_time);
 	ClassDB::bind_method(D_METHOD("set_process", "enable"), &Node::set_process);
 	ClassDB::bind_method(D_METHOD("set_process_priority", "priority"), &Node::set_process_priority);
+	ClassDB::bind_method(D_METHOD("set_process_interval", "interval"), &Node::set_process_interval);
+	ClassDB::bind_method(D_METHOD("get_process_interval"), &Node::get_process_interval);
 	ClassDB::bind_method(D_METHOD("is_processing"), &Node::is_processing);
 	ClassDB::bind_method(D_METHOD("set_process_input", "enable"), &Node::set_process_input);
 	ClassDB::bind_method(D_METHOD("is_processing_input"), &Node::is_processing_input);
@@ -2746,6 +2899,8 @@ void Node::_bind_methods() {
 	//ADD_PROPERTYNZ( PropertyInfo( Variant::BOOL, "process/physics_process" ), "set_physics_process","is_physics_processing") ;
 	//ADD_PROPERTYNZ( PropertyInfo( Variant::BOOL, "process/input" ), "set_process_input","is_processing_input" ) ;
 	//ADD_PROPERTYNZ( PropertyInfo( Variant::BOOL, "process/unhandled_input" ), "set_process_unhandled_input","is_processing_unhandled_input" ) ;
+	ADD_GROUP("Process", "process_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_interval", PROPERTY_HINT_RANGE, "1,60,1,or_greater"), "set_process_interval", "get_process_interval");
 	ADD_GROUP("Pause", "pause_");
 	ADD_PROPERTYNZ(PropertyInfo(Variant::INT, "pause_mode", PROPERTY_HINT_ENUM, "Inherit,Stop,Process"), "set_pause_mode", "get_pause_mode");
 	ADD_PROPERTYNZ(PropertyInfo(Variant::BOOL, "editor/display_folded", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL), "set_display_folded", "is_displayed_folded");
@@ -2788,6 +2943,11 @@ Node::Node() {
 	data.physics_process = false;
 	data.idle_process = false;
 	data.process_priority = 0;
+	data.process_interval = 1;
+	data.process_script_instance = NULL;
+	data.process_script_reload_version = 0;
+	data.script_has_process = false;
+	data.script_has_physics_process = false;
 	data.physics_process_internal = false;
 	data.idle_process_internal = false;
 	data.inside_tree = false;
@@ -2802,6 +2962,11 @@ Node::Node() {
 	data.pause_owner = NULL;
 	data.network_master = 1; //server by default
 	data.path_cache = NULL;
+	data.child_index = NULL;
+	data.child_index_dirty = true;
+	data.child_index_duplicates = false;
+	data.get_node_cache = NULL;
+	data.get_node_cache_version = 0;
 	data.parent_owned = false;
 	data.in_constructor = true;
 	data.viewport = NULL;
@@ -2816,6 +2981,11 @@ Node::~Node() {
 	data.owned.clear();
 	data.children.clear();
 
+	if (data.child_index)
+		memdelete(data.child_index);
+	if (data.get_node_cache)
+		memdelete(data.get_node_cache);
+
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
 }
@@ -83,6 +83,19 @@ private:
 		GroupData() { persistent = false; }
 	};
 
+	struct ProcessIntervalState {
+
+		int frames; // frames since the callback last ran
+		float accumulated_delta;
+		float delta; // time passed to the last callback
+
+		ProcessIntervalState() {
+			frames = 0;
+			accumulated_delta = 0;
+			delta = 0;
+		}
+	};
+
 	struct Data {
 
 		String filename;
@@ -125,6 +138,17 @@ private:
 		bool idle_process;
 		int process_priority;
 
+		// frame skipping of the process callbacks, see set_process_interval()
+		int process_interval;
+		ProcessIntervalState idle_interval;
+		ProcessIntervalState physics_interval;
+
+		// whether the script implements the process callbacks, saves calling into it for nothing
+		ScriptInstance *process_script_instance;
+		uint32_t process_script_reload_version;
+		bool script_has_process;
+		bool script_has_physics_process;
+
 		bool physics_process_internal;
 		bool idle_process_internal;
 
@@ -140,6 +164,15 @@ private:
 
 		mutable NodePath *path_cache;
 
+		// name lookup for nodes with many children, built on demand
+		mutable HashMap<StringName, Node *> *child_index;
+		mutable bool child_index_dirty;
+		mutable bool child_index_duplicates; // names are normally unique among siblings, but not enforced when instancing
+
+		// nodes resolved by get_node() for paths of more than one name, valid while the tree version doesn't change
+		mutable HashMap<NodePath, Node *> *get_node_cache;
+		mutable uint64_t get_node_cache_version;
+
 	} data;
 
 	enum NameCasing {
@@ -154,13 +187,20 @@ private:
 	void _print_tree(const Node *p_node);
 
 	Node *_get_node(const NodePath &p_path) const;
+	Node *_resolve_node_path(const NodePath &p_path) const;
 	Node *_get_child_by_name(const StringName &p_name) const;
+	void _child_index_add(Node *p_child);
+	void _child_index_remove(Node *p_child);
+	_FORCE_INLINE_ void _child_index_invalidate() { data.child_index_dirty = true; }
 
 	void _replace_connections_target(Node *p_new_target);
 
 	void _validate_child_name(Node *p_child, bool p_force_human_readable = false);
 	String _generate_serial_child_name(Node *p_child);
 
+	bool _process_interval_step(int p_notification, float p_delta);
+	void _update_process_script_cache();
+
 	void _propagate_reverse_notification(int p_notification);
 	void _propagate_deferred_notification(int p_notification, bool p_reverse);
 	void _propagate_enter_tree();
@@ -327,6 +367,9 @@ public:
 
 	void set_process_priority(int p_priority);
 
+	void set_process_interval(int p_interval);
+	int get_process_interval() const;
+
 	void set_process_input(bool p_enable);
 	bool is_processing_input() const;
 
@@ -378,6 +421,7 @@ public:
 	//hacks for speed
 	static void set_human_readable_collision_renaming(bool p_enabled);
 	static void init_node_hrcr();
+	static void init_project_settings();
 
 	void force_parent_owned() { data.parent_owned = true; } //hack to avoid duplicate nodes
 
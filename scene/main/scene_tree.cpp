@@ -38,6 +38,7 @@
 #include "node.h"
 #include "os/keyboard.h"
 #include "os/os.h"
+#include "os/trace.h"
 #include "print_string.h"
 #include "project_settings.h"
 #include "scene/resources/dynamic_font.h"
@@ -62,16 +63,33 @@ void SceneTreeTimer::_bind_methods() {
 }
 
 void SceneTreeTimer::set_time_left(float p_time) {
-	time_left = p_time;
+	if (tree) {
+		tree->_timer_schedule(this, p_time);
+	} else {
+		time_left = p_time;
+	}
 }
 
 float SceneTreeTimer::get_time_left() const {
+	if (tree) {
+		return tree->_timer_get_time_left(this);
+	}
 	return time_left;
 }
 
 void SceneTreeTimer::set_pause_mode_process(bool p_pause_mode_process) {
 	if (process_pause != p_pause_mode_process) {
-		process_pause = p_pause_mode_process;
+		if (tree) {
+			// move it to the other clock, keeping the time left
+			float left = tree->_timer_get_time_left(this);
+			SceneTree *timer_tree = tree;
+			Ref<SceneTreeTimer> keep = this;
+			timer_tree->_timer_unschedule(this);
+			process_pause = p_pause_mode_process;
+			timer_tree->_timer_schedule(this, left);
+		} else {
+			process_pause = p_pause_mode_process;
+		}
 	}
 }
 
@@ -82,6 +100,68 @@ bool SceneTreeTimer::is_pause_mode_process() {
 SceneTreeTimer::SceneTreeTimer() {
 	time_left = 0;
 	process_pause = true;
+	tree = NULL;
+	timeout_time = 0;
+	timeout_order = 0;
+}
+
+void SceneTree::_timer_schedule(SceneTreeTimer *p_timer, float p_time_left) {
+
+	Ref<SceneTreeTimer> timer = p_timer; // don't let unscheduling free it
+	if (p_timer->tree) {
+		_timer_unschedule(p_timer);
+	}
+
+	TimerTimeout timeout;
+	timeout.time = (p_timer->process_pause ? timer_clock : pausable_timer_clock) + p_time_left;
+	timeout.order = timer_order++;
+
+	p_timer->tree = this;
+	p_timer->timeout_time = timeout.time;
+	p_timer->timeout_order = timeout.order;
+
+	if (p_timer->process_pause) {
+		timers[timeout] = timer;
+	} else {
+		pausable_timers[timeout] = timer;
+	}
+}
+
+void SceneTree::_timer_unschedule(SceneTreeTimer *p_timer) {
+
+	ERR_FAIL_COND(p_timer->tree != this);
+
+	p_timer->time_left = _timer_get_time_left(p_timer);
+	p_timer->tree = NULL;
+
+	TimerTimeout timeout;
+	timeout.time = p_timer->timeout_time;
+	timeout.order = p_timer->timeout_order;
+
+	if (p_timer->process_pause) {
+		timers.erase(timeout);
+	} else {
+		pausable_timers.erase(timeout);
+	}
+}
+
+float SceneTree::_timer_get_time_left(const SceneTreeTimer *p_timer) const {
+
+	return p_timer->timeout_time - (p_timer->process_pause ? timer_clock : pausable_timer_clock);
+}
+
+void SceneTree::_process_timers(Map<TimerTimeout, Ref<SceneTreeTimer> > &p_timers, double p_clock) {
+
+	while (p_timers.front() && p_timers.front()->key().time < p_clock) {
+
+		Map<TimerTimeout, Ref<SceneTreeTimer> >::Element *E = p_timers.front();
+		Ref<SceneTreeTimer> timer = E->get();
+		p_timers.erase(E);
+
+		timer->time_left = timer->timeout_time - p_clock;
+		timer->tree = NULL;
+		timer->emit_signal("timeout");
+	}
 }
 
 void SceneTree::tree_changed() {
@@ -107,39 +187,127 @@ void SceneTree::node_removed(Node *p_node) {
 
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
-		E = group_map.insert(p_group, Group());
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
+		group_map.set(p_group, Group());
+		group = group_map.getptr(p_group);
+	}
+
+	if (group->removed.size()) {
+		_flush_group_removals(*group);
 	}
 
-	if (E->get().nodes.find(p_node) != -1) {
+	if (group->nodes.find(p_node) != -1) {
 		ERR_EXPLAIN("Already in group: " + p_group);
-		ERR_FAIL_V(&E->get());
+		ERR_FAIL_V(group);
 	}
-	E->get().nodes.push_back(p_node);
-	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+	group->nodes.push_back(p_node);
+	//group->last_tree_version=0;
+	group->changed = true;
+	return group;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	ERR_FAIL_COND(!E);
+	Group *group = group_map.getptr(p_group);
+	ERR_FAIL_COND(!group);
+
+	if (group_removal_batch > 0) {
+		// erasing one by one is linear per node, compact the group once the batch ends
+		if (group->removed.empty()) {
+			groups_with_removals.push_back(p_group);
+		}
+		group->removed.push_back(p_node);
+		return;
+	}
+
+	group->nodes.erase(p_node);
+	if (group->nodes.empty())
+		group_map.erase(p_group);
+}
+
+void SceneTree::_flush_group_removals(Group &p_group) {
+
+	p_group.removed.sort();
+
+	const Node *const *removed = p_group.removed.ptr();
+	int removed_count = p_group.removed.size();
+
+	Node **nodes = p_group.nodes.ptrw();
+	int node_count = p_group.nodes.size();
+	int kept = 0;
+
+	for (int i = 0; i < node_count; i++) {
+
+		//binary search in the sorted removals
+		int low = 0;
+		int high = removed_count;
+		while (low < high) {
+			int middle = (low + high) / 2;
+			if (removed[middle] < nodes[i]) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+
+		if (low < removed_count && removed[low] == nodes[i])
+			continue;
 
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.empty())
-		group_map.erase(E);
+		nodes[kept++] = nodes[i];
+	}
+
+	p_group.nodes.resize(kept);
+	p_group.removed.clear();
 }
 
 void SceneTree::make_group_changed(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (E)
-		E->get().changed = true;
+	Group *group = group_map.getptr(p_group);
+	if (group)
+		group->changed = true;
+}
+
+#define INSTANCE_TRANSFORM_BATCH_MIN 16
+
+int SceneTree::batch_instance_transform(RID p_instance, const Transform &p_transform) {
+
+	xform_batch_instances.push_back(p_instance);
+	xform_batch_transforms.push_back(p_transform);
+	return xform_batch_instances.size() - 1;
+}
+
+void SceneTree::cancel_instance_transform(int p_index, RID p_instance) {
+
+	// the index is only valid until the batch is sent, so check it still refers to the instance
+	if (p_index < xform_batch_instances.size() && xform_batch_instances[p_index] == p_instance) {
+		xform_batch_instances.write[p_index] = RID();
+	}
+}
+
+void SceneTree::_flush_instance_transforms() {
+
+	int count = xform_batch_instances.size();
+	if (count == 0)
+		return;
+
+	if (count >= INSTANCE_TRANSFORM_BATCH_MIN) {
+		VisualServer::get_singleton()->instances_set_transforms(xform_batch_instances, xform_batch_transforms);
+	} else {
+		for (int i = 0; i < count; i++) {
+			if (xform_batch_instances[i].is_valid())
+				VisualServer::get_singleton()->instance_set_transform(xform_batch_instances[i], xform_batch_transforms[i]);
+		}
+	}
+
+	xform_batch_instances.clear();
+	xform_batch_transforms.clear();
 }
 
 void SceneTree::flush_transform_notifications() {
 
+	bool was_batching = xform_batching;
+	xform_batching = true;
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 
@@ -147,8 +315,14 @@ void SceneTree::flush_transform_notifications() {
 		SelfList<Node> *nx = n->next();
 		xform_change_list.remove(n);
 		n = nx;
+		xform_flush_count++; //changes propagated so far may no longer be queued
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+
+	xform_batching = was_batching;
+	if (!xform_batching) {
+		_flush_instance_transforms();
+	}
 }
 
 void SceneTree::_flush_ugc() {
@@ -173,6 +347,11 @@ void SceneTree::_flush_ugc() {
 
 void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
 
+	if (g.removed.size()) {
+		//nodes pending removal are out of the tree and can't be sorted
+		_flush_group_removals(g);
+	}
+
 	if (!g.changed)
 		return;
 	if (g.nodes.empty())
@@ -193,10 +372,10 @@ void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
 
 void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, VARIANT_ARG_DECLARE) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return;
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.empty())
 		return;
 
@@ -226,13 +405,59 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 
 	_update_group_order(g);
 
+	//reference, not copy, the group vector is only duplicated if it's modified during the calls
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
 
-	if (p_call_flags & GROUP_CALL_REVERSE) {
+	if ((p_call_flags & GROUP_CALL_REALTIME) && !(p_call_flags & GROUP_CALL_MULTILEVEL)) {
+
+		VARIANT_ARGPTRS;
+
+		int argc = 0;
+		for (int i = 0; i < VARIANT_ARG_MAX; i++) {
+			if (argptr[i]->get_type() == Variant::NIL)
+				break;
+			argc++;
+		}
+
+		// groups mostly hold nodes of the same few classes, so the method bind of the
+		// last class seen is kept instead of looking it up in ClassDB for every node
+		const StringName *cached_class = NULL;
+		MethodBind *cached_method = NULL;
+
+		bool reverse = p_call_flags & GROUP_CALL_REVERSE;
+
+		for (int j = 0; j < node_count; j++) {
+
+			Node *node = nodes[reverse ? node_count - j - 1 : j];
+
+			if (call_lock && call_skip.has(node))
+				continue;
+
+			Variant::CallError ce;
+
+			if (node->get_script_instance()) {
+				node->call(p_function, argptr, argc, ce);
+				continue;
+			}
+
+			const StringName *class_name = &node->get_class_name();
+			if (class_name != cached_class) {
+				cached_method = ClassDB::get_method(*class_name, p_function);
+				cached_class = class_name;
+			}
+
+			if (cached_method) {
+				node->call_method_bind(cached_method, argptr, argc, ce);
+			} else {
+				node->call(p_function, argptr, argc, ce); //free, or not a bound method
+			}
+		}
+
+	} else if (p_call_flags & GROUP_CALL_REVERSE) {
 
 		for (int i = node_count - 1; i >= 0; i--) {
 
@@ -272,17 +497,18 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return;
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.empty())
 		return;
 
 	_update_group_order(g);
 
+	//reference, not copy, the group vector is only duplicated if it's modified during the calls
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -321,17 +547,18 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 
 void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group, const String &p_name, const Variant &p_value) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return;
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.empty())
 		return;
 
 	_update_group_order(g);
 
+	//reference, not copy, the group vector is only duplicated if it's modified during the calls
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -459,6 +686,8 @@ void SceneTree::init() {
 
 bool SceneTree::iteration(float p_time) {
 
+	TRACE_SCOPE("SceneTree::iteration");
+
 	root_lock++;
 
 	current_frame++;
@@ -486,6 +715,8 @@ bool SceneTree::iteration(float p_time) {
 
 bool SceneTree::idle(float p_time) {
 
+	TRACE_SCOPE("SceneTree::idle");
+
 	//print_line("ram: "+itos(OS::get_singleton()->get_static_memory_usage())+" sram: "+itos(OS::get_singleton()->get_dynamic_memory_usage()));
 	//print_line("node count: "+itos(get_node_count()));
 	//print_line("TEXTURE RAM: "+itos(VS::get_singleton()->get_render_info(VS::INFO_TEXTURE_MEM_USED)));
@@ -535,24 +766,14 @@ bool SceneTree::idle(float p_time) {
 
 	//go through timers
 
-	for (List<Ref<SceneTreeTimer> >::Element *E = timers.front(); E;) {
-
-		List<Ref<SceneTreeTimer> >::Element *N = E->next();
-		if (pause && !E->get()->is_pause_mode_process()) {
-			E = N;
-			continue;
-		}
-		float time_left = E->get()->get_time_left();
-		time_left -= p_time;
-		E->get()->set_time_left(time_left);
-
-		if (time_left < 0) {
-			E->get()->emit_signal("timeout");
-			timers.erase(E);
-		}
-		E = N;
+	timer_clock += p_time;
+	if (!pause) {
+		pausable_timer_clock += p_time;
 	}
 
+	_process_timers(timers, timer_clock);
+	_process_timers(pausable_timers, pausable_timer_clock);
+
 	_call_idle_callbacks();
 
 #ifdef TOOLS_ENABLED
@@ -589,6 +810,7 @@ bool SceneTree::idle(float p_time) {
 void SceneTree::finish() {
 
 	_flush_delete_queue();
+	_flush_teardown_queue(0);
 
 	_flush_ugc();
 
@@ -881,10 +1103,10 @@ bool SceneTree::is_paused() const {
 
 void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p_method, const Ref<InputEvent> &p_input) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return;
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.empty())
 		return;
 
@@ -895,7 +1117,7 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr(); //ptrw() would copy right away, as the vector is shared
 
 	Variant arg = p_input;
 	const Variant *v[1] = { &arg };
@@ -925,10 +1147,10 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 
 void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return;
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.empty())
 		return;
 
@@ -939,7 +1161,7 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr(); //ptrw() would copy right away, as the vector is shared
 
 	call_lock++;
 
@@ -953,6 +1175,10 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 			continue;
 		if (!n->can_process_notification(p_notification))
 			continue;
+		if (n->data.process_interval > 1 && (p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS)) {
+			if (!n->_process_interval_step(p_notification, p_notification == Node::NOTIFICATION_PROCESS ? idle_process_time : physics_process_time))
+				continue;
+		}
 
 		n->notification(p_notification);
 		//ERR_FAIL_COND(node_count != g.nodes.size());
@@ -1030,18 +1256,18 @@ int64_t SceneTree::get_event_count() const {
 Array SceneTree::_get_nodes_in_group(const StringName &p_group) {
 
 	Array ret;
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return ret;
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*group); //update order just in case
+	int nc = group->nodes.size();
 	if (nc == 0)
 		return ret;
 
 	ret.resize(nc);
 
-	Node **ptr = E->get().nodes.ptrw();
+	Node *const *ptr = group->nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 
 		ret[i] = ptr[i];
@@ -1056,15 +1282,15 @@ bool SceneTree::has_group(const StringName &p_identifier) const {
 }
 void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_list) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *group = group_map.getptr(p_group);
+	if (!group)
 		return;
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*group); //update order just in case
+	int nc = group->nodes.size();
 	if (nc == 0)
 		return;
-	Node **ptr = E->get().nodes.ptrw();
+	Node *const *ptr = group->nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 
 		p_list->push_back(ptr[i]);
@@ -1096,14 +1322,79 @@ void SceneTree::_flush_delete_queue() {
 
 	_THREAD_SAFE_METHOD_
 
-	while (delete_queue.size()) {
+	if (delete_queue.empty() && teardown_queue.empty())
+		return;
+
+	// detach every queued subtree before releasing anything, so the groups
+	// they leave are compacted once instead of erasing node by node
+	group_removal_batch++;
 
-		Object *obj = ObjectDB::get_instance(delete_queue.front()->get());
-		if (obj) {
-			memdelete(obj);
+	for (List<ObjectID>::Element *E = delete_queue.front(); E; E = E->next()) {
+
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->get()));
+		if (node && node->get_parent()) {
+			node->get_parent()->remove_child(node);
 		}
+	}
+
+	group_removal_batch--;
+
+	if (group_removal_batch == 0) {
+
+		for (int i = 0; i < groups_with_removals.size(); i++) {
+
+			Group *group = group_map.getptr(groups_with_removals[i]);
+			if (!group || group->removed.empty())
+				continue;
+
+			_flush_group_removals(*group);
+			if (group->nodes.empty()) {
+				group_map.erase(groups_with_removals[i]);
+			}
+		}
+
+		groups_with_removals.clear();
+	}
+
+	while (delete_queue.size()) {
+		teardown_queue.push_back(delete_queue.front()->get());
 		delete_queue.pop_front();
 	}
+
+	_flush_teardown_queue(max_deletions_per_flush);
+}
+
+void SceneTree::_flush_teardown_queue(int p_max_deletions) {
+
+	int deleted = 0;
+
+	while (teardown_queue.size()) {
+
+		if (p_max_deletions > 0 && deleted >= p_max_deletions)
+			break; //continue on the next flush
+
+		Object *obj = ObjectDB::get_instance(teardown_queue.front()->get());
+		teardown_queue.pop_front();
+
+		if (!obj)
+			continue; //released along with its parent
+
+		if (p_max_deletions > 0) {
+			// split detached subtrees, so large ones are released over several flushes
+			Node *node = Object::cast_to<Node>(obj);
+			if (node) {
+				while (node->get_child_count()) {
+					Node *child = node->get_child(node->get_child_count() - 1);
+					node->remove_child(child);
+					child->_is_queued_for_deletion = true;
+					teardown_queue.push_back(child->get_instance_id());
+				}
+			}
+		}
+
+		memdelete(obj);
+		deleted++;
+	}
 }
 
 void SceneTree::queue_delete(Object *p_object) {
@@ -1659,8 +1950,7 @@ Ref<SceneTreeTimer> SceneTree::create_timer(float p_delay_sec, bool p_process_pa
 	Ref<SceneTreeTimer> stt;
 	stt.instance();
 	stt->set_pause_mode_process(p_process_pause);
-	stt->set_time_left(p_delay_sec);
-	timers.push_back(stt);
+	_timer_schedule(stt.ptr(), p_delay_sec);
 	return stt;
 }
 
@@ -1715,6 +2005,10 @@ void SceneTree::set_multiplayer(Ref<MultiplayerAPI> p_multiplayer) {
 	multiplayer = p_multiplayer;
 	multiplayer->set_root_node(root);
 
+	if (ScriptDebugger::get_singleton()) {
+		ScriptDebugger::get_singleton()->set_multiplayer(multiplayer);
+	}
+
 	multiplayer->connect("network_peer_connected", this, "_network_peer_connected");
 	multiplayer->connect("network_peer_disconnected", this, "_network_peer_disconnected");
 	multiplayer->connect("connected_to_server", this, "_connected_to_server");
@@ -1943,7 +2237,16 @@ SceneTree::SceneTree() {
 	debug_navigation_disabled_color = GLOBAL_DEF("debug/shapes/navigation/disabled_geometry_color", Color(1.0, 0.7, 0.1, 0.4));
 	collision_debug_contacts = GLOBAL_DEF("debug/shapes/collision/max_contacts_displayed", 10000);
 
+	max_deletions_per_flush = GLOBAL_DEF("memory/limits/scene_tree/max_deletions_per_flush", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/scene_tree/max_deletions_per_flush", PropertyInfo(Variant::INT, "memory/limits/scene_tree/max_deletions_per_flush", PROPERTY_HINT_RANGE, "0,65536,1"));
+	group_removal_batch = 0;
+
 	tree_version = 1;
+	timer_clock = 0;
+	pausable_timer_clock = 0;
+	timer_order = 0;
+	xform_flush_count = 1;
+	xform_batching = false;
 	physics_process_time = 1;
 	idle_process_time = 1;
 
@@ -2069,4 +2372,12 @@ SceneTree::SceneTree() {
 }
 
 SceneTree::~SceneTree() {
+
+	// timers may outlive the tree
+	while (timers.front()) {
+		_timer_unschedule(timers.front()->get().ptr());
+	}
+	while (pausable_timers.front()) {
+		_timer_unschedule(pausable_timers.front()->get().ptr());
+	}
 }
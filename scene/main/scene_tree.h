@@ -31,6 +31,7 @@
 #ifndef SCENE_MAIN_LOOP_H
 #define SCENE_MAIN_LOOP_H
 
+#include "hash_map.h"
 #include "io/multiplayer_api.h"
 #include "os/main_loop.h"
 #include "os/thread_safe.h"
@@ -53,9 +54,15 @@ class Mesh;
 class SceneTreeTimer : public Reference {
 	GDCLASS(SceneTreeTimer, Reference);
 
-	float time_left;
+	friend class SceneTree;
+
+	float time_left; // only valid while not scheduled
 	bool process_pause;
 
+	SceneTree *tree; // tree this timer is scheduled in, if any
+	double timeout_time;
+	uint64_t timeout_order;
+
 protected:
 	static void _bind_methods();
 
@@ -98,6 +105,7 @@ private:
 	struct Group {
 
 		Vector<Node *> nodes;
+		Vector<Node *> removed; // removals deferred while a subtree is being detached
 		//uint64_t last_tree_version;
 		bool changed;
 		Group() { changed = false; };
@@ -118,7 +126,7 @@ private:
 	bool pause;
 	int root_lock;
 
-	Map<StringName, Group> group_map;
+	HashMap<StringName, Group> group_map; // elements are never moved, nodes keep pointers to their groups
 	bool _quit;
 	bool initialized;
 	bool input_handled;
@@ -156,6 +164,12 @@ private:
 	void _update_root_rect();
 
 	List<ObjectID> delete_queue;
+	List<ObjectID> teardown_queue; // already detached from the tree, waiting to be released
+	int max_deletions_per_flush;
+
+	int group_removal_batch;
+	Vector<StringName> groups_with_removals;
+	void _flush_group_removals(Group &p_group);
 
 	Map<UGCall, Vector<Variant> > unique_group_calls;
 	bool ugc_locked;
@@ -181,7 +195,26 @@ private:
 	void _change_scene(Node *p_to);
 	//void _call_group(uint32_t p_call_flags,const StringName& p_group,const StringName& p_function,const Variant& p_arg1,const Variant& p_arg2);
 
-	List<Ref<SceneTreeTimer> > timers;
+	struct TimerTimeout {
+		double time;
+		uint64_t order;
+
+		bool operator<(const TimerTimeout &p_timeout) const {
+			return time == p_timeout.time ? order < p_timeout.order : time < p_timeout.time;
+		}
+	};
+
+	// timers sorted by timeout, so only the ones expiring are touched every frame
+	Map<TimerTimeout, Ref<SceneTreeTimer> > timers;
+	Map<TimerTimeout, Ref<SceneTreeTimer> > pausable_timers;
+	double timer_clock;
+	double pausable_timer_clock; // does not advance while paused
+	uint64_t timer_order;
+
+	void _timer_schedule(SceneTreeTimer *p_timer, float p_time_left);
+	void _timer_unschedule(SceneTreeTimer *p_timer);
+	float _timer_get_time_left(const SceneTreeTimer *p_timer) const;
+	void _process_timers(Map<TimerTimeout, Ref<SceneTreeTimer> > &p_timers, double p_clock);
 
 	///network///
 
@@ -213,12 +246,21 @@ private:
 
 	static void _debugger_request_tree(void *self);
 	void _flush_delete_queue();
+	void _flush_teardown_queue(int p_max_deletions);
 	//optimization
 	friend class CanvasItem;
 	friend class Spatial;
 	friend class Viewport;
+	friend class SceneTreeTimer;
 
 	SelfList<Node>::List xform_change_list;
+	uint32_t xform_flush_count; // incremented whenever a node is taken out of xform_change_list
+
+	// visual instance transforms changed while flushing, sent to the VisualServer in one call
+	bool xform_batching;
+	Vector<RID> xform_batch_instances;
+	Vector<Transform> xform_batch_transforms;
+	void _flush_instance_transforms();
 
 #ifdef DEBUG_ENABLED
 
@@ -310,6 +352,10 @@ public:
 
 	void flush_transform_notifications();
 
+	_FORCE_INLINE_ bool is_batching_instance_transforms() const { return xform_batching; }
+	int batch_instance_transform(RID p_instance, const Transform &p_transform);
+	void cancel_instance_transform(int p_index, RID p_instance);
+
 	virtual void input_text(const String &p_text);
 	virtual void input_event(const Ref<InputEvent> &p_event);
 	virtual void init();
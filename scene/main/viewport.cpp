@@ -1524,7 +1524,12 @@ Control *Viewport::_gui_find_control_at_pos(CanvasItem *p_node, const Point2 &p_
 	if (matrix.basis_determinant() == 0.0f)
 		return NULL;
 
-	if (!c || !c->clips_input() || c->has_point(matrix.affine_inverse().xform(p_global))) {
+	Transform2D inv_matrix;
+	if (c) {
+		inv_matrix = matrix.affine_inverse();
+	}
+
+	if (!c || !c->clips_input() || c->has_point(inv_matrix.xform(p_global))) {
 
 		for (int i = p_node->get_child_count() - 1; i >= 0; i--) {
 
@@ -1544,11 +1549,9 @@ Control *Viewport::_gui_find_control_at_pos(CanvasItem *p_node, const Point2 &p_
 	if (!c)
 		return NULL;
 
-	matrix.affine_invert();
-
 	//conditions for considering this as a valid control for return
-	if (c->data.mouse_filter != Control::MOUSE_FILTER_IGNORE && c->has_point(matrix.xform(p_global)) && (!gui.drag_preview || (c != gui.drag_preview && !gui.drag_preview->is_a_parent_of(c)))) {
-		r_inv_xform = matrix;
+	if (c->data.mouse_filter != Control::MOUSE_FILTER_IGNORE && c->has_point(inv_matrix.xform(p_global)) && (!gui.drag_preview || (c != gui.drag_preview && !gui.drag_preview->is_a_parent_of(c)))) {
+		r_inv_xform = inv_matrix;
 		return c;
 	} else
 		return NULL;
@@ -2869,6 +2872,7 @@ void Viewport::_bind_methods() {
 	BIND_ENUM_CONSTANT(RENDER_INFO_SHADER_CHANGES_IN_FRAME);
 	BIND_ENUM_CONSTANT(RENDER_INFO_SURFACE_CHANGES_IN_FRAME);
 	BIND_ENUM_CONSTANT(RENDER_INFO_DRAW_CALLS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME);
 	BIND_ENUM_CONSTANT(RENDER_INFO_MAX);
 
 	BIND_ENUM_CONSTANT(DEBUG_DRAW_DISABLED);
@@ -139,6 +139,7 @@
 #include "scene/resources/default_theme/default_theme.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/dynamic_font_stb.h"
+#include "scene/resources/height_map_shape.h"
 #include "scene/resources/material.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/mesh_data_tool.h"
@@ -231,6 +232,7 @@ void register_scene_types() {
 	OS::get_singleton()->yield(); //may take time to init
 
 	Node::init_node_hrcr();
+	Node::init_project_settings();
 
 	resource_loader_dynamic_font = memnew(ResourceFormatLoaderDynamicFont);
 	ResourceLoader::add_resource_format_loader(resource_loader_dynamic_font);
@@ -269,6 +271,7 @@ void register_scene_types() {
 	ClassDB::register_class<Viewport>();
 	ClassDB::register_class<ViewportTexture>();
 	ClassDB::register_class<HTTPRequest>();
+	HTTPRequest::init_connection_pool();
 	ClassDB::register_class<Timer>();
 	ClassDB::register_class<CanvasLayer>();
 	ClassDB::register_class<CanvasModulate>();
@@ -591,6 +594,7 @@ void register_scene_types() {
 	ClassDB::register_class<CapsuleShape>();
 	ClassDB::register_class<CylinderShape>();
 	ClassDB::register_class<PlaneShape>();
+	ClassDB::register_class<HeightMapShape>();
 	ClassDB::register_class<ConvexPolygonShape>();
 	ClassDB::register_class<ConcavePolygonShape>();
 
@@ -611,6 +615,8 @@ void register_scene_types() {
 	ClassDB::register_class<PanoramaSky>();
 	ClassDB::register_class<ProceduralSky>();
 	ClassDB::register_class<StreamTexture>();
+	SceneTree::add_idle_callback(StreamTexture::update_streaming);
+	StreamTexture::init_streaming();
 	ClassDB::register_class<ImageTexture>();
 	ClassDB::register_class<AtlasTexture>();
 	ClassDB::register_class<LargeTexture>();
@@ -651,6 +657,7 @@ void register_scene_types() {
 	ClassDB::register_class<AudioStreamPlayer2D>();
 #ifndef _3D_DISABLED
 	ClassDB::register_class<AudioStreamPlayer3D>();
+	SceneTree::add_idle_callback(AudioStreamPlayer3D::update_voices);
 #endif
 	ClassDB::register_virtual_class<VideoStream>();
 	ClassDB::register_class<AudioStreamSample>();
@@ -691,6 +698,11 @@ void register_scene_types() {
 
 	OS::get_singleton()->yield(); //may take time to init
 
+	//defined here rather than in _bind_methods, which may run late when binding lazily
+	GLOBAL_DEF("gui/common/default_scroll_deadzone", 0);
+	GLOBAL_DEF("gui/timers/incremental_search_max_interval_msec", 2000);
+	GLOBAL_DEF("gui/timers/text_edit_idle_detect_sec", 3);
+
 	for (int i = 0; i < 20; i++) {
 		GLOBAL_DEF("layer_names/2d_render/layer_" + itos(i + 1), "");
 		GLOBAL_DEF("layer_names/2d_physics/layer_" + itos(i + 1), "");
@@ -760,5 +772,7 @@ void unregister_scene_types() {
 	SpatialMaterial::finish_shaders();
 	ParticlesMaterial::finish_shaders();
 	CanvasItemMaterial::finish_shaders();
+	StreamTexture::finish_streaming();
+	HTTPRequest::finish_connection_pool();
 	SceneStringNames::free();
 }
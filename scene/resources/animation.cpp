@@ -31,6 +31,7 @@
 #include "animation.h"
 
 #include "geometry.h"
+#include "io/marshalls.h"
 
 #define ANIM_MIN_LENGTH 0.001
 
@@ -90,12 +91,58 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 			if (track_get_type(track) == TYPE_TRANSFORM) {
 
 				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+
+				if (p_value.get_type() == Variant::DICTIONARY) {
+					// compressed track
+					Dictionary d = p_value;
+					ERR_FAIL_COND_V(!d.has("ranges") || !d.has("times") || !d.has("data"), false);
+
+					PoolVector<float> ranges = d["ranges"];
+					PoolVector<float> times = d["times"];
+					PoolVector<uint8_t> data = d["data"];
+					ERR_FAIL_COND_V(ranges.size() != 12, false);
+					ERR_FAIL_COND_V(times.size() % 2, false);
+					int kcount = times.size() / 2;
+					ERR_FAIL_COND_V(data.size() != kcount * 18, false);
+
+					PoolVector<float>::Read rr = ranges.read();
+					tt->loc_min = Vector3(rr[0], rr[1], rr[2]);
+					tt->loc_step = Vector3(rr[3], rr[4], rr[5]);
+					tt->scale_min = Vector3(rr[6], rr[7], rr[8]);
+					tt->scale_step = Vector3(rr[9], rr[10], rr[11]);
+
+					PoolVector<float>::Read rt = times.read();
+					PoolVector<uint8_t>::Read rd = data.read();
+
+					tt->transforms.clear();
+					tt->compressed_transforms.resize(kcount);
+					tt->compressed = true;
+
+					for (int i = 0; i < kcount; i++) {
+
+						CompressedTransformKey &ck = tt->compressed_transforms.write[i];
+						ck.time = rt[i * 2 + 0];
+						ck.transition = rt[i * 2 + 1];
+
+						const uint8_t *ofs = &rd[i * 18];
+						for (int j = 0; j < 3; j++) {
+							ck.loc[j] = decode_uint16(&ofs[j * 2]);
+							ck.rot[j] = decode_uint16(&ofs[6 + j * 2]);
+							ck.scale[j] = decode_uint16(&ofs[12 + j * 2]);
+						}
+					}
+
+					return true;
+				}
+
 				PoolVector<float> values = p_value;
 				int vcount = values.size();
 				ERR_FAIL_COND_V(vcount % 12, false); // shuld be multiple of 11
 
 				PoolVector<float>::Read r = values.read();
 
+				tt->compressed = false;
+				tt->compressed_transforms.clear();
 				tt->transforms.resize(vcount / 12);
 
 				for (int i = 0; i < (vcount / 12); i++) {
@@ -370,7 +417,54 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = track_is_enabled(track);
 		else if (what == "keys") {
 
-			if (track_get_type(track) == TYPE_TRANSFORM) {
+			if (track_get_type(track) == TYPE_TRANSFORM && track_is_compressed(track)) {
+
+				const TransformTrack *tt = static_cast<const TransformTrack *>(tracks[track]);
+				int kcount = tt->compressed_transforms.size();
+
+				PoolVector<float> ranges;
+				ranges.resize(12);
+				{
+					PoolVector<float>::Write w = ranges.write();
+					for (int i = 0; i < 3; i++) {
+						w[i + 0] = tt->loc_min[i];
+						w[i + 3] = tt->loc_step[i];
+						w[i + 6] = tt->scale_min[i];
+						w[i + 9] = tt->scale_step[i];
+					}
+				}
+
+				PoolVector<float> times;
+				times.resize(kcount * 2);
+				PoolVector<uint8_t> data;
+				data.resize(kcount * 18);
+				{
+					PoolVector<float>::Write wt = times.write();
+					PoolVector<uint8_t>::Write wd = data.write();
+
+					for (int i = 0; i < kcount; i++) {
+
+						const CompressedTransformKey &ck = tt->compressed_transforms[i];
+						wt[i * 2 + 0] = ck.time;
+						wt[i * 2 + 1] = ck.transition;
+
+						uint8_t *ofs = &wd[i * 18];
+						for (int j = 0; j < 3; j++) {
+							encode_uint16(ck.loc[j], &ofs[j * 2]);
+							encode_uint16(ck.rot[j], &ofs[6 + j * 2]);
+							encode_uint16(ck.scale[j], &ofs[12 + j * 2]);
+						}
+					}
+				}
+
+				Dictionary d;
+				d["ranges"] = ranges;
+				d["times"] = times;
+				d["data"] = data;
+				r_ret = d;
+				return true;
+
+			} else if (track_get_type(track) == TYPE_TRANSFORM) {
 
 				PoolVector<real_t> keys;
 				int kk = track_get_key_count(track);
@@ -845,6 +939,22 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
+
+	if (tt->compressed) {
+
+		ERR_FAIL_INDEX_V(p_key, tt->compressed_transforms.size(), ERR_INVALID_PARAMETER);
+		TransformKey tk = _decompress_transform_key(tt, p_key);
+
+		if (r_loc)
+			*r_loc = tk.loc;
+		if (r_rot)
+			*r_rot = tk.rot;
+		if (r_scale)
+			*r_scale = tk.scale;
+
+		return OK;
+	}
+
 	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
 
 	if (r_loc)
@@ -864,6 +974,9 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	if (tt->compressed) {
+		_decompress_transform_track(tt); // compressed tracks are not edited in place
+	}
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -892,6 +1005,11 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX(p_idx, tt->compressed_transforms.size());
+				tt->compressed_transforms.remove(p_idx);
+				break;
+			}
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -945,6 +1063,14 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				int k = _find(tt->compressed_transforms, p_time);
+				if (k < 0 || k >= tt->compressed_transforms.size())
+					return -1;
+				if (tt->compressed_transforms[k].time != p_time && p_exact)
+					return -1;
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size())
 				return -1;
@@ -1130,7 +1256,7 @@ int Animation::track_get_key_count(int p_track) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			return tt->transforms.size();
+			return tt->compressed ? tt->compressed_transforms.size() : tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
 
@@ -1173,6 +1299,19 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.size(), Variant());
+				TransformKey tk = _decompress_transform_key(tt, p_key_idx);
+
+				Dictionary d;
+				d["location"] = tk.loc;
+				d["rotation"] = tk.rot;
+				d["scale"] = tk.scale;
+
+				return d;
+			}
+
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
 
 			Dictionary d;
@@ -1249,6 +1388,10 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.size(), -1);
+				return tt->compressed_transforms[p_key_idx].time;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1302,6 +1445,10 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.size(), -1);
+				return tt->compressed_transforms[p_key_idx].transition;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1346,6 +1493,9 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				_decompress_transform_track(tt);
+			}
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			Dictionary d = p_value;
 			if (d.has("location"))
@@ -1422,6 +1572,11 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX(p_key_idx, tt->compressed_transforms.size());
+				tt->compressed_transforms.write[p_key_idx].transition = p_transition;
+				break;
+			}
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1483,6 +1638,36 @@ int Animation::_find(const Vector<K> &p_keys, float p_time) const {
 	return middle;
 }
 
+template <class K>
+int Animation::_find_cached(const Vector<K> &p_keys, float p_time, int *p_cursor) const {
+
+	// playback mostly moves forward by less than a key per frame, so check the
+	// last found key and the one after it before doing a binary search
+	int len = p_keys.size();
+	if (len == 0)
+		return -2;
+
+	const K *keys = &p_keys[0];
+	int cursor = *p_cursor;
+
+	if (cursor >= 0 && cursor < len && keys[cursor].time <= p_time) {
+
+		if (cursor + 1 == len || p_time < keys[cursor + 1].time)
+			return cursor;
+
+		if (cursor + 2 == len || p_time < keys[cursor + 2].time) {
+			*p_cursor = cursor + 1;
+			return cursor + 1;
+		}
+	} else if (cursor == -1 && p_time < keys[0].time) {
+		return -1;
+	}
+
+	cursor = _find(p_keys, p_time);
+	*p_cursor = cursor;
+	return cursor;
+}
+
 Animation::TransformKey Animation::_interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const {
 
 	TransformKey ret;
@@ -1635,27 +1820,30 @@ float Animation::_cubic_interpolate(const float &p_pre_a, const float &p_a, cons
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+template <class K>
+bool Animation::_find_interpolation_keys(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, int *p_cursor, int &r_idx, int &r_next, int &r_len, float &r_c) const {
 
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	int len = p_keys.size();
+	if (len > 0 && p_keys[len - 1].time > length) {
+		len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	}
+
+	r_len = len;
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
 		// meaning no keys, or only key time is larger than length
-		if (p_ok)
-			*p_ok = false;
-		return T();
+		return false;
 	} else if (len == 1) { // one key found (0+1), return it
 
-		if (p_ok)
-			*p_ok = true;
-		return p_keys[0].value;
+		r_idx = r_next = 0;
+		r_c = 0;
+		return true;
 	}
 
-	int idx = _find(p_keys, p_time);
+	int idx = p_cursor ? _find_cached(p_keys, p_time, p_cursor) : _find(p_keys, p_time);
 
-	ERR_FAIL_COND_V(idx == -2, T());
+	ERR_FAIL_COND_V(idx == -2, false);
 
 	bool result = true;
 	int next = 0;
@@ -1735,21 +1923,38 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 		}
 	}
 
-	if (p_ok)
-		*p_ok = result;
 	if (!result)
-		return T();
+		return false;
 
 	float tr = p_keys[idx].transition;
 
-	if (tr == 0 || idx == next) {
-		// don't interpolate if not needed
-		return p_keys[idx].value;
+	if (tr != 0 && idx != next && tr != 1.0) {
+
+		c = Math::ease(c, tr);
 	}
 
-	if (tr != 1.0) {
+	r_idx = idx;
+	r_next = next;
+	r_c = c;
+	return true;
+}
+
+template <class T>
+T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *p_cursor) const {
 
-		c = Math::ease(c, tr);
+	int idx, next, len;
+	float c;
+
+	bool result = _find_interpolation_keys(p_keys, p_time, p_loop_wrap, p_cursor, idx, next, len, c);
+
+	if (p_ok)
+		*p_ok = result;
+	if (!result)
+		return T();
+
+	if (p_keys[idx].transition == 0 || idx == next) {
+		// don't interpolate if not needed
+		return p_keys[idx].value;
 	}
 
 	switch (p_interp) {
@@ -1779,7 +1984,154 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
+Animation::TransformKey Animation::_interpolate_compressed(const TransformTrack *p_track, float p_time, bool *p_ok, int *p_cursor) const {
+
+	const Vector<CompressedTransformKey> &keys = p_track->compressed_transforms;
+
+	int idx, next, len;
+	float c;
+
+	bool result = _find_interpolation_keys(keys, p_time, p_track->loop_wrap, p_cursor, idx, next, len, c);
+
+	if (p_ok)
+		*p_ok = result;
+	if (!result)
+		return TransformKey();
+
+	if (keys[idx].transition == 0 || idx == next || p_track->interpolation == INTERPOLATION_NEAREST) {
+		return _decompress_transform_key(p_track, idx);
+	}
+
+	if (p_track->interpolation == INTERPOLATION_CUBIC) {
+
+		int pre = idx - 1;
+		if (pre < 0)
+			pre = 0;
+		int post = next + 1;
+		if (post >= len)
+			post = next;
+
+		return _cubic_interpolate(_decompress_transform_key(p_track, pre), _decompress_transform_key(p_track, idx), _decompress_transform_key(p_track, next), _decompress_transform_key(p_track, post), c);
+	}
+
+	return _interpolate(_decompress_transform_key(p_track, idx), _decompress_transform_key(p_track, next), c);
+}
+
+#define COMPRESSED_ROT_SCALE 23169.0f // 32767 / sqrt(2)
+
+Animation::TransformKey Animation::_decompress_transform_key(const TransformTrack *p_track, int p_key) {
+
+	const CompressedTransformKey &ck = p_track->compressed_transforms[p_key];
+
+	TransformKey tk;
+
+	tk.loc = p_track->loc_min + Vector3(ck.loc[0], ck.loc[1], ck.loc[2]) * p_track->loc_step;
+	tk.scale = p_track->scale_min + Vector3(ck.scale[0], ck.scale[1], ck.scale[2]) * p_track->scale_step;
+
+	int largest = (ck.rot[0] & 1) | ((ck.rot[1] & 1) << 1);
+	real_t q[4];
+	real_t sum = 0;
+	for (int i = 0, j = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		q[i] = (real_t(ck.rot[j] >> 1) - 16384.0f) / COMPRESSED_ROT_SCALE;
+		sum += q[i] * q[i];
+		j++;
+	}
+	q[largest] = Math::sqrt(MAX(0, 1.0 - sum));
+
+	tk.rot = Quat(q[0], q[1], q[2], q[3]);
+
+	return tk;
+}
+
+void Animation::_compress_transform_track(TransformTrack *p_track) {
+
+	if (p_track->compressed)
+		return;
+
+	const Vector<TKey<TransformKey> > &keys = p_track->transforms;
+	int len = keys.size();
+
+	AABB loc_range;
+	AABB scale_range;
+	for (int i = 0; i < len; i++) {
+		if (i == 0) {
+			loc_range.position = keys[i].value.loc;
+			scale_range.position = keys[i].value.scale;
+		} else {
+			loc_range.expand_to(keys[i].value.loc);
+			scale_range.expand_to(keys[i].value.scale);
+		}
+	}
+
+	p_track->loc_min = loc_range.position;
+	p_track->loc_step = loc_range.size / 65535.0;
+	p_track->scale_min = scale_range.position;
+	p_track->scale_step = scale_range.size / 65535.0;
+
+	p_track->compressed_transforms.resize(len);
+
+	for (int i = 0; i < len; i++) {
+
+		const TKey<TransformKey> &k = keys[i];
+		CompressedTransformKey &ck = p_track->compressed_transforms.write[i];
+
+		ck.time = k.time;
+		ck.transition = k.transition;
+
+		for (int j = 0; j < 3; j++) {
+			ck.loc[j] = p_track->loc_step[j] > 0 ? uint16_t(CLAMP(Math::round((k.value.loc[j] - p_track->loc_min[j]) / p_track->loc_step[j]), 0, 65535)) : 0;
+			ck.scale[j] = p_track->scale_step[j] > 0 ? uint16_t(CLAMP(Math::round((k.value.scale[j] - p_track->scale_min[j]) / p_track->scale_step[j]), 0, 65535)) : 0;
+		}
+
+		// drop the largest component, its sign is made positive so it can be
+		// rebuilt from the other three
+		Quat rot = k.value.rot.length_squared() > CMP_EPSILON ? k.value.rot.normalized() : Quat();
+		real_t q[4] = { rot.x, rot.y, rot.z, rot.w };
+		int largest = 0;
+		for (int j = 1; j < 4; j++) {
+			if (Math::abs(q[j]) > Math::abs(q[largest]))
+				largest = j;
+		}
+		real_t sign = q[largest] < 0 ? -1.0 : 1.0;
+
+		for (int j = 0, l = 0; j < 4; j++) {
+			if (j == largest)
+				continue;
+			int v = CLAMP(int(Math::round(q[j] * sign * COMPRESSED_ROT_SCALE)) + 16384, 0, 32767);
+			ck.rot[l] = uint16_t(v << 1);
+			l++;
+		}
+		ck.rot[0] |= largest & 1;
+		ck.rot[1] |= (largest >> 1) & 1;
+	}
+
+	p_track->transforms.clear();
+	p_track->compressed = true;
+}
+
+void Animation::_decompress_transform_track(TransformTrack *p_track) {
+
+	if (!p_track->compressed)
+		return;
+
+	int len = p_track->compressed_transforms.size();
+	p_track->transforms.resize(len);
+
+	for (int i = 0; i < len; i++) {
+
+		TKey<TransformKey> &k = p_track->transforms.write[i];
+		k.time = p_track->compressed_transforms[i].time;
+		k.transition = p_track->compressed_transforms[i].transition;
+		k.value = _decompress_transform_key(p_track, i);
+	}
+
+	p_track->compressed_transforms.clear();
+	p_track->compressed = false;
+}
+
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_key_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
@@ -1789,7 +2141,7 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk = tt->compressed ? _interpolate_compressed(tt, p_time, &ok, r_key_cursor) : _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok, r_key_cursor);
 
 	if (!ok)
 		return ERR_UNAVAILABLE;
@@ -1976,8 +2328,13 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 				case TYPE_TRANSFORM: {
 
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->compressed) {
+						_track_get_key_indices_in_range(tt->compressed_transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->compressed_transforms, 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -2036,7 +2393,10 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 		case TYPE_TRANSFORM: {
 
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->compressed)
+				_track_get_key_indices_in_range(tt->compressed_transforms, from_time, to_time, p_indices);
+			else
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
 
 		} break;
 		case TYPE_VALUE: {
@@ -2643,6 +3003,7 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("track_set_imported", "idx", "imported"), &Animation::track_set_imported);
 	ClassDB::bind_method(D_METHOD("track_is_imported", "idx"), &Animation::track_is_imported);
+	ClassDB::bind_method(D_METHOD("track_is_compressed", "idx"), &Animation::track_is_compressed);
 
 	ClassDB::bind_method(D_METHOD("track_set_enabled", "idx", "enabled"), &Animation::track_set_enabled);
 	ClassDB::bind_method(D_METHOD("track_is_enabled", "idx"), &Animation::track_is_enabled);
@@ -2711,6 +3072,7 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track", "to_animation"), &Animation::copy_track);
+	ClassDB::bind_method(D_METHOD("compress"), &Animation::compress);
 
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
@@ -2920,6 +3282,9 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	if (tt->compressed) {
+		_decompress_transform_track(tt);
+	}
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2967,6 +3332,24 @@ void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err
 	}
 }
 
+void Animation::compress() {
+
+	for (int i = 0; i < tracks.size(); i++) {
+
+		if (tracks[i]->type == TYPE_TRANSFORM)
+			_compress_transform_track(static_cast<TransformTrack *>(tracks[i]));
+	}
+	emit_changed();
+}
+
+bool Animation::track_is_compressed(int p_track) const {
+
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	if (tracks[p_track]->type != TYPE_TRANSFORM)
+		return false;
+	return static_cast<const TransformTrack *>(tracks[p_track])->compressed;
+}
+
 Animation::Animation() {
 
 	step = 0.1;
@@ -106,11 +106,35 @@ private:
 
 	/* TRANSFORM TRACK */
 
+	// Compressed keys quantize location and scale to 16 bits inside the range
+	// of the track, and store rotations as the three smallest quaternion
+	// components (15 bits each, the index of the dropped one in the low bits).
+
+	struct CompressedTransformKey {
+
+		float time;
+		float transition;
+		uint16_t loc[3];
+		uint16_t rot[3];
+		uint16_t scale[3];
+	};
+
 	struct TransformTrack : public Track {
 
 		Vector<TKey<TransformKey> > transforms;
 
-		TransformTrack() { type = TYPE_TRANSFORM; }
+		// when compressed, keys are stored in compressed_transforms instead
+		bool compressed;
+		Vector<CompressedTransformKey> compressed_transforms;
+		Vector3 loc_min;
+		Vector3 loc_step;
+		Vector3 scale_min;
+		Vector3 scale_step;
+
+		TransformTrack() {
+			type = TYPE_TRANSFORM;
+			compressed = false;
+		}
 	};
 
 	/* PROPERTY VALUE TRACK */
@@ -205,6 +229,9 @@ private:
 	template <class K>
 	inline int _find(const Vector<K> &p_keys, float p_time) const;
 
+	template <class K>
+	_FORCE_INLINE_ int _find_cached(const Vector<K> &p_keys, float p_time, int *p_cursor) const;
+
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const;
 
 	_FORCE_INLINE_ Vector3 _interpolate(const Vector3 &p_a, const Vector3 &p_b, float p_c) const;
@@ -218,8 +245,17 @@ private:
 	_FORCE_INLINE_ Variant _cubic_interpolate(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, float p_c) const;
 	_FORCE_INLINE_ float _cubic_interpolate(const float &p_pre_a, const float &p_a, const float &p_b, const float &p_post_b, float p_c) const;
 
+	template <class K>
+	_FORCE_INLINE_ bool _find_interpolation_keys(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, int *p_cursor, int &r_idx, int &r_next, int &r_len, float &r_c) const;
+
 	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *p_cursor = NULL) const;
+
+	_FORCE_INLINE_ TransformKey _interpolate_compressed(const TransformTrack *p_track, float p_time, bool *p_ok, int *p_cursor) const;
+
+	static TransformKey _decompress_transform_key(const TransformTrack *p_track, int p_key);
+	static void _compress_transform_track(TransformTrack *p_track);
+	static void _decompress_transform_track(TransformTrack *p_track);
 
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
@@ -343,7 +379,7 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_key_cursor = NULL) const;
 
 	Variant value_track_interpolate(int p_track, float p_time) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
@@ -371,6 +407,9 @@ public:
 
 	void optimize(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
 
+	void compress();
+	bool track_is_compressed(int p_track) const;
+
 	Animation();
 	~Animation();
 };
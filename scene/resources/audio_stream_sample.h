@@ -145,6 +145,8 @@ public:
 	virtual Ref<AudioStreamPlayback> instance_playback();
 	virtual String get_stream_name() const;
 
+	virtual uint64_t get_memory_usage() const { return data_bytes; }
+
 	AudioStreamSample();
 	~AudioStreamSample();
 };
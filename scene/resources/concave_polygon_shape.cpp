@@ -69,19 +69,52 @@ void ConcavePolygonShape::_update_shape() {
 
 void ConcavePolygonShape::set_faces(const PoolVector<Vector3> &p_faces) {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(), p_faces);
+	if (bvh.size()) {
+		//a tree saved along with the faces, the physics server can use it instead of building one
+		Dictionary d;
+		d["faces"] = p_faces;
+		d["bvh"] = bvh;
+		PhysicsServer::get_singleton()->shape_set_data(get_shape(), d);
+		bvh = PoolVector<uint8_t>();
+	} else {
+		PhysicsServer::get_singleton()->shape_set_data(get_shape(), p_faces);
+	}
 	notify_change_to_owners();
 }
 
 PoolVector<Vector3> ConcavePolygonShape::get_faces() const {
 
-	return PhysicsServer::get_singleton()->shape_get_data(get_shape());
+	Variant data = PhysicsServer::get_singleton()->shape_get_data(get_shape());
+	if (data.get_type() == Variant::DICTIONARY) {
+		return Dictionary(data)["faces"];
+	}
+	return data;
+}
+
+void ConcavePolygonShape::_set_bvh(const PoolVector<uint8_t> &p_bvh) {
+
+	//stored before the faces, kept until they arrive
+	bvh = p_bvh;
+}
+
+PoolVector<uint8_t> ConcavePolygonShape::_get_bvh() const {
+
+	Variant data = PhysicsServer::get_singleton()->shape_get_data(get_shape());
+	if (data.get_type() == Variant::DICTIONARY) {
+		return Dictionary(data)["bvh"];
+	}
+	return PoolVector<uint8_t>();
 }
 
 void ConcavePolygonShape::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_faces", "faces"), &ConcavePolygonShape::set_faces);
 	ClassDB::bind_method(D_METHOD("get_faces"), &ConcavePolygonShape::get_faces);
+
+	ClassDB::bind_method(D_METHOD("_set_bvh", "bvh"), &ConcavePolygonShape::_set_bvh);
+	ClassDB::bind_method(D_METHOD("_get_bvh"), &ConcavePolygonShape::_get_bvh);
+
+	ADD_PROPERTY(PropertyInfo(Variant::POOL_BYTE_ARRAY, "bvh", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL), "_set_bvh", "_get_bvh");
 	ADD_PROPERTY(PropertyInfo(Variant::POOL_VECTOR3_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL), "set_faces", "get_faces");
 }
 
@@ -57,6 +57,11 @@ class ConcavePolygonShape : public Shape {
 		}
 	};
 
+	PoolVector<uint8_t> bvh;
+
+	void _set_bvh(const PoolVector<uint8_t> &p_bvh);
+	PoolVector<uint8_t> _get_bvh() const;
+
 protected:
 	static void _bind_methods();
 
@@ -767,9 +767,16 @@ Vector2 Curve2D::interpolate_baked(float p_offset, bool p_cubic) const {
 	if (pc == 1)
 		return baked_point_cache.get(0);
 
-	int bpc = baked_point_cache.size();
 	PoolVector2Array::Read r = baked_point_cache.read();
 
+	return _interpolate_baked(r.ptr(), pc, p_offset, p_cubic);
+}
+
+Vector2 Curve2D::_interpolate_baked(const Vector2 *p_points, int p_count, float p_offset, bool p_cubic) const {
+
+	const Vector2 *r = p_points;
+	int bpc = p_count;
+
 	if (p_offset < 0)
 		return r[0];
 	if (p_offset >= baked_max_ofs)
@@ -796,6 +803,33 @@ Vector2 Curve2D::interpolate_baked(float p_offset, bool p_cubic) const {
 	}
 }
 
+PoolVector2Array Curve2D::interpolate_baked_array(const PoolRealArray &p_offsets, bool p_cubic) const {
+
+	if (baked_cache_dirty)
+		_bake();
+
+	PoolVector2Array positions;
+
+	int pc = baked_point_cache.size();
+	if (pc == 0) {
+		ERR_EXPLAIN("No points in Curve2D");
+		ERR_FAIL_COND_V(pc == 0, positions);
+	}
+
+	int count = p_offsets.size();
+	positions.resize(count);
+
+	PoolRealArray::Read ro = p_offsets.read();
+	PoolVector2Array::Read r = baked_point_cache.read();
+	PoolVector2Array::Write w = positions.write();
+
+	for (int i = 0; i < count; i++) {
+		w[i] = pc == 1 ? r[0] : _interpolate_baked(r.ptr(), pc, ro[i], p_cubic);
+	}
+
+	return positions;
+}
+
 PoolVector2Array Curve2D::get_baked_points() const {
 
 	if (baked_cache_dirty)
@@ -999,6 +1033,7 @@ void Curve2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_baked_length"), &Curve2D::get_baked_length);
 	ClassDB::bind_method(D_METHOD("interpolate_baked", "offset", "cubic"), &Curve2D::interpolate_baked, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("interpolate_baked_array", "offsets", "cubic"), &Curve2D::interpolate_baked_array, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_baked_points"), &Curve2D::get_baked_points);
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Curve2D::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_offset", "to_point"), &Curve2D::get_closest_offset);
@@ -1337,9 +1372,16 @@ Vector3 Curve3D::interpolate_baked(float p_offset, bool p_cubic) const {
 	if (pc == 1)
 		return baked_point_cache.get(0);
 
-	int bpc = baked_point_cache.size();
 	PoolVector3Array::Read r = baked_point_cache.read();
 
+	return _interpolate_baked(r.ptr(), pc, p_offset, p_cubic);
+}
+
+Vector3 Curve3D::_interpolate_baked(const Vector3 *p_points, int p_count, float p_offset, bool p_cubic) const {
+
+	const Vector3 *r = p_points;
+	int bpc = p_count;
+
 	if (p_offset < 0)
 		return r[0];
 	if (p_offset >= baked_max_ofs)
@@ -1423,6 +1465,16 @@ Vector3 Curve3D::interpolate_baked_up_vector(float p_offset, bool p_apply_tilt)
 	PoolVector3Array::Read rp = baked_point_cache.read();
 	PoolRealArray::Read rt = baked_tilt_cache.read();
 
+	return _interpolate_baked_up_vector(r.ptr(), rp.ptr(), rt.ptr(), count, p_offset, p_apply_tilt);
+}
+
+Vector3 Curve3D::_interpolate_baked_up_vector(const Vector3 *p_up_vectors, const Vector3 *p_points, const real_t *p_tilts, int p_count, float p_offset, bool p_apply_tilt) const {
+
+	const Vector3 *r = p_up_vectors;
+	const Vector3 *rp = p_points;
+	const real_t *rt = p_tilts;
+	int count = p_count;
+
 	float offset = CLAMP(p_offset, 0.0f, baked_max_ofs);
 
 	int idx = Math::floor((double)offset / (double)bake_interval);
@@ -1450,6 +1502,63 @@ Vector3 Curve3D::interpolate_baked_up_vector(float p_offset, bool p_apply_tilt)
 	return up.rotated(axis, up.angle_to(up1) * frac);
 }
 
+PoolVector3Array Curve3D::interpolate_baked_array(const PoolRealArray &p_offsets, bool p_cubic) const {
+
+	if (baked_cache_dirty)
+		_bake();
+
+	PoolVector3Array positions;
+
+	int pc = baked_point_cache.size();
+	if (pc == 0) {
+		ERR_EXPLAIN("No points in Curve3D");
+		ERR_FAIL_COND_V(pc == 0, positions);
+	}
+
+	int count = p_offsets.size();
+	positions.resize(count);
+
+	PoolRealArray::Read ro = p_offsets.read();
+	PoolVector3Array::Read r = baked_point_cache.read();
+	PoolVector3Array::Write w = positions.write();
+
+	for (int i = 0; i < count; i++) {
+		w[i] = pc == 1 ? r[0] : _interpolate_baked(r.ptr(), pc, ro[i], p_cubic);
+	}
+
+	return positions;
+}
+
+PoolVector3Array Curve3D::interpolate_baked_up_vector_array(const PoolRealArray &p_offsets, bool p_apply_tilt) const {
+
+	if (baked_cache_dirty)
+		_bake();
+
+	PoolVector3Array up_vectors;
+
+	// curve may not have baked up vectors
+	int uc = baked_up_vector_cache.size();
+	if (uc == 0) {
+		ERR_EXPLAIN("No up vectors in Curve3D");
+		ERR_FAIL_COND_V(uc == 0, up_vectors);
+	}
+
+	int count = p_offsets.size();
+	up_vectors.resize(count);
+
+	PoolRealArray::Read ro = p_offsets.read();
+	PoolVector3Array::Read r = baked_up_vector_cache.read();
+	PoolVector3Array::Read rp = baked_point_cache.read();
+	PoolRealArray::Read rt = baked_tilt_cache.read();
+	PoolVector3Array::Write w = up_vectors.write();
+
+	for (int i = 0; i < count; i++) {
+		w[i] = uc == 1 ? r[0] : _interpolate_baked_up_vector(r.ptr(), rp.ptr(), rt.ptr(), uc, ro[i], p_apply_tilt);
+	}
+
+	return up_vectors;
+}
+
 PoolVector3Array Curve3D::get_baked_points() const {
 
 	if (baked_cache_dirty)
@@ -1696,6 +1805,8 @@ void Curve3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_baked_length"), &Curve3D::get_baked_length);
 	ClassDB::bind_method(D_METHOD("interpolate_baked", "offset", "cubic"), &Curve3D::interpolate_baked, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("interpolate_baked_up_vector", "offset", "apply_tilt"), &Curve3D::interpolate_baked_up_vector, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("interpolate_baked_array", "offsets", "cubic"), &Curve3D::interpolate_baked_array, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("interpolate_baked_up_vector_array", "offsets", "apply_tilt"), &Curve3D::interpolate_baked_up_vector_array, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_baked_points"), &Curve3D::get_baked_points);
 	ClassDB::bind_method(D_METHOD("get_baked_tilts"), &Curve3D::get_baked_tilts);
 	ClassDB::bind_method(D_METHOD("get_baked_up_vectors"), &Curve3D::get_baked_up_vectors);
@@ -174,6 +174,7 @@ class Curve2D : public Resource {
 	float bake_interval;
 
 	void _bake_segment2d(Map<float, Vector2> &r_bake, float p_begin, float p_end, const Vector2 &p_a, const Vector2 &p_out, const Vector2 &p_b, const Vector2 &p_in, int p_depth, int p_max_depth, float p_tol) const;
+	Vector2 _interpolate_baked(const Vector2 *p_points, int p_count, float p_offset, bool p_cubic) const;
 	Dictionary _get_data() const;
 	void _set_data(const Dictionary &p_data);
 
@@ -200,6 +201,7 @@ public:
 
 	float get_baked_length() const;
 	Vector2 interpolate_baked(float p_offset, bool p_cubic = false) const;
+	PoolVector2Array interpolate_baked_array(const PoolRealArray &p_offsets, bool p_cubic = false) const;
 	PoolVector2Array get_baked_points() const; //useful for going through
 	Vector2 get_closest_point(const Vector2 &p_to_point) const;
 	float get_closest_offset(const Vector2 &p_to_point) const;
@@ -243,6 +245,8 @@ class Curve3D : public Resource {
 	bool up_vector_enabled;
 
 	void _bake_segment3d(Map<float, Vector3> &r_bake, float p_begin, float p_end, const Vector3 &p_a, const Vector3 &p_out, const Vector3 &p_b, const Vector3 &p_in, int p_depth, int p_max_depth, float p_tol) const;
+	Vector3 _interpolate_baked(const Vector3 *p_points, int p_count, float p_offset, bool p_cubic) const;
+	Vector3 _interpolate_baked_up_vector(const Vector3 *p_up_vectors, const Vector3 *p_points, const real_t *p_tilts, int p_count, float p_offset, bool p_apply_tilt) const;
 	Dictionary _get_data() const;
 	void _set_data(const Dictionary &p_data);
 
@@ -275,6 +279,8 @@ public:
 	Vector3 interpolate_baked(float p_offset, bool p_cubic = false) const;
 	float interpolate_baked_tilt(float p_offset) const;
 	Vector3 interpolate_baked_up_vector(float p_offset, bool p_apply_tilt = false) const;
+	PoolVector3Array interpolate_baked_array(const PoolRealArray &p_offsets, bool p_cubic = false) const;
+	PoolVector3Array interpolate_baked_up_vector_array(const PoolRealArray &p_offsets, bool p_apply_tilt = false) const;
 	PoolVector3Array get_baked_points() const; //useful for going through
 	PoolRealArray get_baked_tilts() const; //useful for going through
 	PoolVector3Array get_baked_up_vectors() const;
@@ -44,6 +44,12 @@ bool DynamicFontData::CacheID::operator<(CacheID right) const {
 
 Ref<DynamicFontAtSize> DynamicFontData::_get_dynamic_font_at_size(CacheID p_cache_id) {
 
+	if (p_cache_id.distance_field) {
+		//one set of glyphs serves all sizes
+		p_cache_id.size = DynamicFontAtSize::DISTANCE_FIELD_SIZE;
+		p_cache_id.outline_size = 0;
+	}
+
 	if (size_cache.has(p_cache_id)) {
 		return Ref<DynamicFontAtSize>(size_cache[p_cache_id]);
 	}
@@ -110,67 +116,42 @@ DynamicFontData::~DynamicFontData() {
 ////////////////////
 HashMap<String, Vector<uint8_t> > DynamicFontAtSize::_fontdata;
 
-Error DynamicFontAtSize::_load() {
-
-	int error = FT_Init_FreeType(&library);
-
-	ERR_EXPLAIN(TTR("Error initializing FreeType."));
-	ERR_FAIL_COND_V(error != 0, ERR_CANT_CREATE);
-
-	// FT_OPEN_STREAM is extremely slow only on Android.
-	if (OS::get_singleton()->get_name() == "Android" && font->font_mem == NULL && font->font_path != String()) {
-		// cache font only once for each font->font_path
-		if (_fontdata.has(font->font_path)) {
-
-			font->set_font_ptr(_fontdata[font->font_path].ptr(), _fontdata[font->font_path].size());
-
-		} else {
-
-			FileAccess *f = FileAccess::open(font->font_path, FileAccess::READ);
-			ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
+Error DynamicFontAtSize::_open_face(FT_Library p_library, FT_StreamRec *r_stream, FT_Face *r_face, float *r_scale_color_font) const {
 
-			size_t len = f->get_len();
-			_fontdata[font->font_path] = Vector<uint8_t>();
-			Vector<uint8_t> &fontdata = _fontdata[font->font_path];
-			fontdata.resize(len);
-			f->get_buffer(fontdata.ptrw(), len);
-			font->set_font_ptr(fontdata.ptr(), len);
-			f->close();
-		}
-	}
+	int error;
 
 	if (font->font_mem == NULL && font->font_path != String()) {
 
 		FileAccess *f = FileAccess::open(font->font_path, FileAccess::READ);
 		ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
 
-		memset(&stream, 0, sizeof(FT_StreamRec));
-		stream.base = NULL;
-		stream.size = f->get_len();
-		stream.pos = 0;
-		stream.descriptor.pointer = f;
-		stream.read = _ft_stream_io;
-		stream.close = _ft_stream_close;
+		memset(r_stream, 0, sizeof(FT_StreamRec));
+		r_stream->base = NULL;
+		r_stream->size = f->get_len();
+		r_stream->pos = 0;
+		r_stream->descriptor.pointer = f;
+		r_stream->read = _ft_stream_io;
+		r_stream->close = _ft_stream_close;
 
 		FT_Open_Args fargs;
 		memset(&fargs, 0, sizeof(FT_Open_Args));
 		fargs.flags = FT_OPEN_STREAM;
-		fargs.stream = &stream;
-		error = FT_Open_Face(library, &fargs, 0, &face);
+		fargs.stream = r_stream;
+		error = FT_Open_Face(p_library, &fargs, 0, r_face);
 	} else if (font->font_mem) {
 
-		memset(&stream, 0, sizeof(FT_StreamRec));
-		stream.base = (unsigned char *)font->font_mem;
-		stream.size = font->font_mem_size;
-		stream.pos = 0;
+		memset(r_stream, 0, sizeof(FT_StreamRec));
+		r_stream->base = (unsigned char *)font->font_mem;
+		r_stream->size = font->font_mem_size;
+		r_stream->pos = 0;
 
 		FT_Open_Args fargs;
 		memset(&fargs, 0, sizeof(FT_Open_Args));
 		fargs.memory_base = (unsigned char *)font->font_mem;
 		fargs.memory_size = font->font_mem_size;
 		fargs.flags = FT_OPEN_MEMORY;
-		fargs.stream = &stream;
-		error = FT_Open_Face(library, &fargs, 0, &face);
+		fargs.stream = r_stream;
+		error = FT_Open_Face(p_library, &fargs, 0, r_face);
 
 	} else {
 		ERR_EXPLAIN("DynamicFont uninitialized");
@@ -181,12 +162,10 @@ Error DynamicFontAtSize::_load() {
 
 	if (error == FT_Err_Unknown_File_Format) {
 		ERR_EXPLAIN(TTR("Unknown font format."));
-		FT_Done_FreeType(library);
 
 	} else if (error) {
 
 		ERR_EXPLAIN(TTR("Error loading font."));
-		FT_Done_FreeType(library);
 	}
 
 	ERR_FAIL_COND_V(error, ERR_FILE_CANT_OPEN);
@@ -199,10 +178,12 @@ Error DynamicFontAtSize::_load() {
 		ERR_FAIL_COND_V( error, ERR_INVALID_PARAMETER );
 	}*/
 
+	FT_Face face = *r_face;
+
 	if (FT_HAS_COLOR(face)) {
 		int best_match = 0;
 		int diff = ABS(id.size - face->available_sizes[0].width);
-		scale_color_font = float(id.size) / face->available_sizes[0].width;
+		float scale_color_font = float(id.size) / face->available_sizes[0].width;
 		for (int i = 1; i < face->num_fixed_sizes; i++) {
 			int ndiff = ABS(id.size - face->available_sizes[i].width);
 			if (ndiff < diff) {
@@ -212,17 +193,61 @@ Error DynamicFontAtSize::_load() {
 			}
 		}
 		FT_Select_Size(face, best_match);
+		if (r_scale_color_font) {
+			*r_scale_color_font = scale_color_font;
+		}
 	} else {
 		FT_Set_Pixel_Sizes(face, 0, id.size * oversampling);
 	}
 
+	return OK;
+}
+
+Error DynamicFontAtSize::_load() {
+
+	int error = FT_Init_FreeType(&library);
+
+	ERR_EXPLAIN(TTR("Error initializing FreeType."));
+	ERR_FAIL_COND_V(error != 0, ERR_CANT_CREATE);
+
+	// FT_OPEN_STREAM is extremely slow only on Android.
+	if (OS::get_singleton()->get_name() == "Android" && font->font_mem == NULL && font->font_path != String()) {
+		// cache font only once for each font->font_path
+		if (_fontdata.has(font->font_path)) {
+
+			font->set_font_ptr(_fontdata[font->font_path].ptr(), _fontdata[font->font_path].size());
+
+		} else {
+
+			FileAccess *f = FileAccess::open(font->font_path, FileAccess::READ);
+			ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
+
+			size_t len = f->get_len();
+			_fontdata[font->font_path] = Vector<uint8_t>();
+			Vector<uint8_t> &fontdata = _fontdata[font->font_path];
+			fontdata.resize(len);
+			f->get_buffer(fontdata.ptrw(), len);
+			font->set_font_ptr(fontdata.ptr(), len);
+			f->close();
+		}
+	}
+
+	if (id.distance_field) {
+		oversampling = 1.0; //scaled when drawing instead
+	}
+
+	if (_open_face(library, &stream, &face, &scale_color_font) != OK) {
+		FT_Done_FreeType(library);
+		return ERR_FILE_CANT_OPEN;
+	}
+
 	ascent = (face->size->metrics.ascender / 64.0) / oversampling * scale_color_font;
 	descent = (-face->size->metrics.descender / 64.0) / oversampling * scale_color_font;
 	linegap = 0;
 	texture_flags = 0;
 	if (id.mipmaps)
 		texture_flags |= Texture::FLAG_MIPMAPS;
-	if (id.filter)
+	if (id.filter || id.distance_field)
 		texture_flags |= Texture::FLAG_FILTER;
 
 	valid = true;
@@ -320,7 +345,7 @@ void DynamicFontAtSize::set_texture_flags(uint32_t p_flags) {
 	}
 }
 
-float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharType p_char, CharType p_next, const Color &p_modulate, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks, bool p_advance_only) const {
+float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharType p_char, CharType p_next, const Color &p_modulate, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks, bool p_advance_only, float p_scale) const {
 
 	if (!valid)
 		return 0;
@@ -340,15 +365,15 @@ float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharT
 
 		if (!p_advance_only && ch->texture_idx != -1) {
 			Point2 cpos = p_pos;
-			cpos.x += ch->h_align;
-			cpos.y -= font->get_ascent();
-			cpos.y += ch->v_align;
+			cpos.x += ch->h_align * p_scale;
+			cpos.y -= font->get_ascent() * p_scale;
+			cpos.y += ch->v_align * p_scale;
 			Color modulate = p_modulate;
 			if (FT_HAS_COLOR(face)) {
 				modulate.r = modulate.g = modulate.b = 1.0;
 			}
 			RID texture = font->textures[ch->texture_idx].texture->get_rid();
-			VisualServer::get_singleton()->canvas_item_add_texture_rect_region(p_canvas_item, Rect2(cpos, ch->rect.size * Vector2(font->scale_color_font, font->scale_color_font)), texture, ch->rect_uv, modulate, false, RID(), false);
+			VisualServer::get_singleton()->canvas_item_add_texture_rect_region(p_canvas_item, Rect2(cpos, ch->rect.size * Vector2(font->scale_color_font, font->scale_color_font) * p_scale), texture, ch->rect_uv, modulate, false, RID(), false);
 		}
 
 		advance = ch->advance;
@@ -356,7 +381,7 @@ float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharT
 
 	advance += _get_kerning_advance(font, p_char, p_next);
 
-	return advance;
+	return advance * p_scale;
 }
 
 unsigned long DynamicFontAtSize::_ft_stream_io(FT_Stream stream, unsigned long offset, unsigned char *buffer, unsigned long count) {
@@ -402,7 +427,7 @@ DynamicFontAtSize::TexturePosition DynamicFontAtSize::_find_texture_pos_for_glyp
 
 		const CharTexture &ct = textures[i];
 
-		if (ct.texture->get_format() != p_image_format)
+		if (ct.format != p_image_format)
 			continue;
 
 		if (mw > ct.texture_size || mh > ct.texture_size) //too big for this texture
@@ -454,6 +479,8 @@ DynamicFontAtSize::TexturePosition DynamicFontAtSize::_find_texture_pos_for_glyp
 
 		CharTexture tex;
 		tex.texture_size = texsize;
+		tex.format = p_image_format;
+		tex.dirty = true;
 		tex.imgdata.resize(texsize * texsize * p_color_size); //grayscale alpha
 
 		{
@@ -475,9 +502,175 @@ DynamicFontAtSize::TexturePosition DynamicFontAtSize::_find_texture_pos_for_glyp
 	return ret;
 }
 
-DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap bitmap, int yofs, int xofs, float advance) {
-	int w = bitmap.width;
-	int h = bitmap.rows;
+bool DynamicFontAtSize::_copy_bitmap(const FT_Bitmap &p_bitmap, int p_yofs, int p_xofs, float p_advance, GlyphBitmap &r_glyph) const {
+
+	int w = p_bitmap.width;
+	int h = p_bitmap.rows;
+
+	r_glyph.width = w;
+	r_glyph.height = h;
+	r_glyph.xofs = p_xofs;
+	r_glyph.yofs = p_yofs;
+	r_glyph.advance = p_advance;
+	r_glyph.color_size = p_bitmap.pixel_mode == FT_PIXEL_MODE_BGRA ? 4 : 2;
+	r_glyph.data.resize(w * h * r_glyph.color_size);
+
+	uint8_t *wr = r_glyph.data.ptrw();
+
+	for (int i = 0; i < h; i++) {
+		for (int j = 0; j < w; j++) {
+
+			int ofs = (i * w + j) * r_glyph.color_size;
+			switch (p_bitmap.pixel_mode) {
+				case FT_PIXEL_MODE_MONO: {
+					int byte = i * p_bitmap.pitch + (j >> 3);
+					int bit = 1 << (7 - (j % 8));
+					wr[ofs + 0] = 255; //grayscale as 1
+					wr[ofs + 1] = p_bitmap.buffer[byte] & bit ? 255 : 0;
+				} break;
+				case FT_PIXEL_MODE_GRAY:
+					wr[ofs + 0] = 255; //grayscale as 1
+					wr[ofs + 1] = p_bitmap.buffer[i * p_bitmap.pitch + j];
+					break;
+				case FT_PIXEL_MODE_BGRA: {
+					int ofs_color = i * p_bitmap.pitch + (j << 2);
+					wr[ofs + 2] = p_bitmap.buffer[ofs_color + 0];
+					wr[ofs + 1] = p_bitmap.buffer[ofs_color + 1];
+					wr[ofs + 0] = p_bitmap.buffer[ofs_color + 2];
+					wr[ofs + 3] = p_bitmap.buffer[ofs_color + 3];
+				} break;
+				// TODO: FT_PIXEL_MODE_LCD
+				default:
+					ERR_EXPLAIN("Font uses unsupported pixel format: " + itos(p_bitmap.pixel_mode));
+					ERR_FAIL_V(false);
+					break;
+			}
+		}
+	}
+
+	r_glyph.found = true;
+
+	if (id.distance_field) {
+		_make_distance_field(r_glyph);
+	}
+
+	return true;
+}
+
+//replaces the coverage of a glyph by its signed distance to the outline, padded by the spread so it can grow
+void DynamicFontAtSize::_make_distance_field(GlyphBitmap &r_glyph) const {
+
+	const int spread = DISTANCE_FIELD_SPREAD;
+	const int inf = 0x3FFF;
+
+	int w = r_glyph.width + spread * 2;
+	int h = r_glyph.height + spread * 2;
+
+	Vector<bool> inside;
+	inside.resize(w * h);
+
+	for (int i = 0; i < h; i++) {
+		for (int j = 0; j < w; j++) {
+
+			int x = j - spread;
+			int y = i - spread;
+			bool in = false;
+			if (x >= 0 && y >= 0 && x < r_glyph.width && y < r_glyph.height) {
+				in = r_glyph.data[(y * r_glyph.width + x) * r_glyph.color_size + r_glyph.color_size - 1] >= 128; //alpha
+			}
+			inside.write[i * w + j] = in;
+		}
+	}
+
+	//two pass 8 neighbour sweep: offsets to the closest seed, once with the inside as seeds and once with the outside
+	Vector<int16_t> offsets[2];
+
+	for (int k = 0; k < 2; k++) {
+
+		offsets[k].resize(w * h * 2);
+		int16_t *o = offsets[k].ptrw();
+
+		for (int i = 0; i < w * h; i++) {
+			bool seed = inside[i] == (k == 0);
+			o[i * 2 + 0] = seed ? 0 : inf;
+			o[i * 2 + 1] = seed ? 0 : inf;
+		}
+
+#define SDF_COMPARE(m_x, m_y, m_ox, m_oy)                                                       \
+	{                                                                                           \
+		int nx = m_x + m_ox;                                                                    \
+		int ny = m_y + m_oy;                                                                    \
+		if (nx >= 0 && ny >= 0 && nx < w && ny < h) {                                           \
+			int16_t *c = &o[(m_y * w + m_x) * 2];                                               \
+			const int16_t *n = &o[(ny * w + nx) * 2];                                           \
+			int dx = n[0] + m_ox;                                                               \
+			int dy = n[1] + m_oy;                                                               \
+			if (n[0] != inf && dx * dx + dy * dy < int(c[0]) * c[0] + int(c[1]) * c[1]) {       \
+				c[0] = dx;                                                                      \
+				c[1] = dy;                                                                      \
+			}                                                                                   \
+		}                                                                                       \
+	}
+
+		for (int y = 0; y < h; y++) {
+			for (int x = 0; x < w; x++) {
+				SDF_COMPARE(x, y, -1, 0);
+				SDF_COMPARE(x, y, 0, -1);
+				SDF_COMPARE(x, y, -1, -1);
+				SDF_COMPARE(x, y, 1, -1);
+			}
+			for (int x = w - 1; x >= 0; x--) {
+				SDF_COMPARE(x, y, 1, 0);
+			}
+		}
+
+		for (int y = h - 1; y >= 0; y--) {
+			for (int x = w - 1; x >= 0; x--) {
+				SDF_COMPARE(x, y, 1, 0);
+				SDF_COMPARE(x, y, 0, 1);
+				SDF_COMPARE(x, y, -1, 1);
+				SDF_COMPARE(x, y, 1, 1);
+			}
+			for (int x = 0; x < w; x++) {
+				SDF_COMPARE(x, y, -1, 0);
+			}
+		}
+
+#undef SDF_COMPARE
+	}
+
+	Vector<uint8_t> data;
+	data.resize(w * h * 2);
+	uint8_t *wr = data.ptrw();
+
+	for (int i = 0; i < w * h; i++) {
+
+		//distance to the closest pixel of the other kind, the outline is half way there
+		const int16_t *o = &offsets[inside[i] ? 1 : 0][i * 2];
+		float dist = o[0] == inf ? spread : Math::sqrt(float(o[0] * o[0] + o[1] * o[1])) - 0.5;
+		if (!inside[i]) {
+			dist = -dist;
+		}
+
+		wr[i * 2 + 0] = 255;
+		wr[i * 2 + 1] = CLAMP(int(Math::round((0.5 + dist / (spread * 2)) * 255.0)), 0, 255);
+	}
+
+	r_glyph.width = w;
+	r_glyph.height = h;
+	r_glyph.xofs -= spread;
+	r_glyph.yofs += spread;
+	r_glyph.color_size = 2;
+	r_glyph.data = data;
+}
+
+DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(const GlyphBitmap &p_glyph) {
+
+	if (!p_glyph.found)
+		return Character::not_found();
+
+	int w = p_glyph.width;
+	int h = p_glyph.height;
 
 	int mw = w + rect_margin * 2;
 	int mh = h + rect_margin * 2;
@@ -485,7 +678,7 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 	ERR_FAIL_COND_V(mw > 4096, Character::not_found());
 	ERR_FAIL_COND_V(mh > 4096, Character::not_found());
 
-	int color_size = bitmap.pixel_mode == FT_PIXEL_MODE_BGRA ? 4 : 2;
+	int color_size = p_glyph.color_size;
 	Image::Format require_format = color_size == 4 ? Image::FORMAT_RGBA8 : Image::FORMAT_LA8;
 
 	TexturePosition tex_pos = _find_texture_pos_for_glyph(color_size, require_format, mw, mh);
@@ -497,53 +690,19 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 
 	{
 		PoolVector<uint8_t>::Write wr = tex.imgdata.write();
+		const uint8_t *rd = p_glyph.data.ptr();
 
 		for (int i = 0; i < h; i++) {
-			for (int j = 0; j < w; j++) {
-
-				int ofs = ((i + tex_pos.y + rect_margin) * tex.texture_size + j + tex_pos.x + rect_margin) * color_size;
-				ERR_FAIL_COND_V(ofs >= tex.imgdata.size(), Character::not_found());
-				switch (bitmap.pixel_mode) {
-					case FT_PIXEL_MODE_MONO: {
-						int byte = i * bitmap.pitch + (j >> 3);
-						int bit = 1 << (7 - (j % 8));
-						wr[ofs + 0] = 255; //grayscale as 1
-						wr[ofs + 1] = bitmap.buffer[byte] & bit ? 255 : 0;
-					} break;
-					case FT_PIXEL_MODE_GRAY:
-						wr[ofs + 0] = 255; //grayscale as 1
-						wr[ofs + 1] = bitmap.buffer[i * bitmap.pitch + j];
-						break;
-					case FT_PIXEL_MODE_BGRA: {
-						int ofs_color = i * bitmap.pitch + (j << 2);
-						wr[ofs + 2] = bitmap.buffer[ofs_color + 0];
-						wr[ofs + 1] = bitmap.buffer[ofs_color + 1];
-						wr[ofs + 0] = bitmap.buffer[ofs_color + 2];
-						wr[ofs + 3] = bitmap.buffer[ofs_color + 3];
-					} break;
-					// TODO: FT_PIXEL_MODE_LCD
-					default:
-						ERR_EXPLAIN("Font uses unsupported pixel format: " + itos(bitmap.pixel_mode));
-						ERR_FAIL_V(Character::not_found());
-						break;
-				}
-			}
-		}
-	}
-
-	//blit to image and texture
-	{
 
-		Ref<Image> img = memnew(Image(tex.texture_size, tex.texture_size, 0, require_format, tex.imgdata));
-
-		if (tex.texture.is_null()) {
-			tex.texture.instance();
-			tex.texture->create_from_image(img, Texture::FLAG_VIDEO_SURFACE | texture_flags);
-		} else {
-			tex.texture->set_data(img); //update
+			int ofs = ((i + tex_pos.y + rect_margin) * tex.texture_size + tex_pos.x + rect_margin) * color_size;
+			ERR_FAIL_COND_V(ofs + w * color_size > tex.imgdata.size(), Character::not_found());
+			copymem(&wr[ofs], &rd[i * w * color_size], w * color_size);
 		}
 	}
 
+	//uploaded by _update_textures(), once for all the glyphs added together
+	tex.dirty = true;
+
 	// update height array
 
 	for (int k = tex_pos.x; k < tex_pos.x + mw; k++) {
@@ -551,9 +710,9 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 	}
 
 	Character chr;
-	chr.h_align = xofs * scale_color_font / oversampling;
-	chr.v_align = ascent - (yofs * scale_color_font / oversampling); // + ascent - descent;
-	chr.advance = advance * scale_color_font / oversampling;
+	chr.h_align = p_glyph.xofs * scale_color_font / oversampling;
+	chr.v_align = ascent - (p_glyph.yofs * scale_color_font / oversampling); // + ascent - descent;
+	chr.advance = p_glyph.advance * scale_color_font / oversampling;
 	chr.texture_idx = tex_pos.index;
 	chr.found = true;
 
@@ -564,21 +723,44 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 	return chr;
 }
 
-DynamicFontAtSize::Character DynamicFontAtSize::_make_outline_char(CharType p_char) {
-	Character ret = Character::not_found();
+void DynamicFontAtSize::_update_textures() {
+
+	//blit to image and texture
+	for (int i = 0; i < textures.size(); i++) {
+
+		CharTexture &tex = textures.write[i];
+		if (!tex.dirty)
+			continue;
+
+		Ref<Image> img = memnew(Image(tex.texture_size, tex.texture_size, 0, tex.format, tex.imgdata));
+
+		if (tex.texture.is_null()) {
+			tex.texture.instance();
+			tex.texture->create_from_image(img, Texture::FLAG_VIDEO_SURFACE | texture_flags);
+		} else {
+			tex.texture->set_data(img); //update
+		}
+
+		tex.dirty = false;
+	}
+}
+
+bool DynamicFontAtSize::_make_outline_bitmap(FT_Library p_library, FT_Face p_face, CharType p_char, GlyphBitmap &r_glyph) const {
+
+	bool ret = false;
 
-	if (FT_Load_Char(face, p_char, FT_LOAD_NO_BITMAP | (font->force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0)) != 0)
+	if (FT_Load_Char(p_face, p_char, FT_LOAD_NO_BITMAP | (font->force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0)) != 0)
 		return ret;
 
 	FT_Stroker stroker;
-	if (FT_Stroker_New(library, &stroker) != 0)
+	if (FT_Stroker_New(p_library, &stroker) != 0)
 		return ret;
 
 	FT_Stroker_Set(stroker, (int)(id.outline_size * oversampling * 64.0), FT_STROKER_LINECAP_BUTT, FT_STROKER_LINEJOIN_ROUND, 0);
 	FT_Glyph glyph;
 	FT_BitmapGlyph glyph_bitmap;
 
-	if (FT_Get_Glyph(face->glyph, &glyph) != 0)
+	if (FT_Get_Glyph(p_face->glyph, &glyph) != 0)
 		goto cleanup_stroker;
 	if (FT_Glyph_Stroke(&glyph, stroker, 1) != 0)
 		goto cleanup_glyph;
@@ -586,7 +768,7 @@ DynamicFontAtSize::Character DynamicFontAtSize::_make_outline_char(CharType p_ch
 		goto cleanup_glyph;
 
 	glyph_bitmap = (FT_BitmapGlyph)glyph;
-	ret = _bitmap_to_character(glyph_bitmap->bitmap, glyph_bitmap->top, glyph_bitmap->left, glyph->advance.x / 65536.0);
+	ret = _copy_bitmap(glyph_bitmap->bitmap, glyph_bitmap->top, glyph_bitmap->left, glyph->advance.x / 65536.0, r_glyph);
 
 cleanup_glyph:
 	FT_Done_Glyph(glyph);
@@ -595,20 +777,15 @@ cleanup_stroker:
 	return ret;
 }
 
-void DynamicFontAtSize::_update_char(CharType p_char) {
-
-	if (char_map.has(p_char))
-		return;
-
-	_THREAD_SAFE_METHOD_
+//only touches the given face and read only settings, so prewarming can run it on a worker with its own face
+DynamicFontAtSize::GlyphBitmap DynamicFontAtSize::_rasterize_glyph(FT_Library p_library, FT_Face p_face, CharType p_char) const {
 
-	Character character = Character::not_found();
+	GlyphBitmap glyph;
 
-	FT_GlyphSlot slot = face->glyph;
+	FT_GlyphSlot slot = p_face->glyph;
 
-	if (FT_Get_Char_Index(face, p_char) == 0) {
-		char_map[p_char] = character;
-		return;
+	if (FT_Get_Char_Index(p_face, p_char) == 0) {
+		return glyph;
 	}
 
 	int ft_hinting;
@@ -625,27 +802,145 @@ void DynamicFontAtSize::_update_char(CharType p_char) {
 			break;
 	}
 
-	int error = FT_Load_Char(face, p_char, FT_HAS_COLOR(face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (font->force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting);
+	int error = FT_Load_Char(p_face, p_char, FT_HAS_COLOR(p_face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (font->force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting);
 	if (error) {
-		char_map[p_char] = character;
-		return;
+		return glyph;
 	}
 
 	if (id.outline_size > 0) {
-		character = _make_outline_char(p_char);
+		if (!_make_outline_bitmap(p_library, p_face, p_char, glyph)) {
+			glyph.found = false;
+		}
 	} else {
-		error = FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
-		if (!error)
-			character = _bitmap_to_character(slot->bitmap, slot->bitmap_top, slot->bitmap_left, slot->advance.x / 64.0);
+		error = FT_Render_Glyph(p_face->glyph, FT_RENDER_MODE_NORMAL);
+		if (!error && !_copy_bitmap(slot->bitmap, slot->bitmap_top, slot->bitmap_left, slot->advance.x / 64.0, glyph)) {
+			glyph.found = false;
+		}
 	}
 
-	char_map[p_char] = character;
+	return glyph;
+}
+
+void DynamicFontAtSize::_update_char(CharType p_char) {
+
+	if (prewarm_task && (!WorkerThreadPool::get_singleton() || WorkerThreadPool::get_singleton()->is_group_task_completed(prewarm_task->group))) {
+		_finish_prewarm();
+	}
+
+	if (char_map.has(p_char))
+		return;
+
+	_THREAD_SAFE_METHOD_
+
+	char_map[p_char] = _bitmap_to_character(_rasterize_glyph(library, face, p_char));
+	_update_textures();
+}
+
+void DynamicFontAtSize::_prewarm_thread(void *p_userdata, uint32_t p_index) {
+
+	PrewarmTask *task = (PrewarmTask *)p_userdata;
+	const DynamicFontAtSize *font_at_size = task->font_at_size;
+
+	//Freetype faces can't be shared between threads, so this one gets its own
+	FT_Library library;
+	if (FT_Init_FreeType(&library) != 0)
+		return;
+
+	FT_StreamRec stream;
+	FT_Face face;
+	if (font_at_size->_open_face(library, &stream, &face) != OK) {
+		FT_Done_FreeType(library);
+		return;
+	}
+
+	task->glyphs.resize(task->chars.size());
+	for (int i = 0; i < task->chars.size(); i++) {
+		task->glyphs.write[i] = font_at_size->_rasterize_glyph(library, face, task->chars[i]);
+	}
+
+	FT_Done_Face(face);
+	FT_Done_FreeType(library);
+
+	task->ok = true;
+}
+
+void DynamicFontAtSize::_finish_prewarm(bool p_discard) {
+
+	if (!prewarm_task)
+		return;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool) {
+		pool->wait_for_group_task_completion(prewarm_task->group);
+	}
+
+	if (prewarm_task->ok && !p_discard) {
+
+		for (int i = 0; i < prewarm_task->chars.size(); i++) {
+
+			CharType c = prewarm_task->chars[i];
+			if (char_map.has(c))
+				continue; //drawn before the task was done
+
+			char_map[c] = _bitmap_to_character(prewarm_task->glyphs[i]);
+		}
+
+		_update_textures();
+	}
+
+	memdelete(prewarm_task);
+	prewarm_task = NULL;
+}
+
+bool DynamicFontAtSize::has_char(CharType p_char) const {
+
+	return valid && FT_Get_Char_Index(face, p_char) != 0;
+}
+
+void DynamicFontAtSize::prewarm(const Vector<CharType> &p_chars, bool p_threaded) {
+
+	if (!valid)
+		return;
+
+	_finish_prewarm(); //one at a time
+
+	Vector<CharType> chars;
+	for (int i = 0; i < p_chars.size(); i++) {
+		if (!char_map.has(p_chars[i])) {
+			chars.push_back(p_chars[i]);
+		}
+	}
+
+	if (chars.empty())
+		return;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	if (p_threaded && pool && pool->get_thread_count() > 0) {
+
+		prewarm_task = memnew(PrewarmTask);
+		prewarm_task->font_at_size = this;
+		prewarm_task->chars = chars;
+		prewarm_task->ok = false;
+		prewarm_task->group = pool->add_task(_prewarm_thread, prewarm_task, WorkerThreadPool::PRIORITY_LOW);
+		return;
+	}
+
+	_THREAD_SAFE_METHOD_
+
+	for (int i = 0; i < chars.size(); i++) {
+		char_map[chars[i]] = _bitmap_to_character(_rasterize_glyph(library, face, chars[i]));
+	}
+
+	_update_textures();
 }
 
 void DynamicFontAtSize::update_oversampling() {
-	if (oversampling == font_oversampling || !valid)
+	if (oversampling == font_oversampling || !valid || id.distance_field)
 		return;
 
+	_finish_prewarm(true); //rasterized with the old oversampling
+
 	FT_Done_FreeType(library);
 	textures.clear();
 	char_map.clear();
@@ -664,10 +959,13 @@ DynamicFontAtSize::DynamicFontAtSize() {
 	texture_flags = 0;
 	oversampling = font_oversampling;
 	scale_color_font = 1;
+	prewarm_task = NULL;
 }
 
 DynamicFontAtSize::~DynamicFontAtSize() {
 
+	_finish_prewarm(true);
+
 	if (valid) {
 		FT_Done_FreeType(library);
 	}
@@ -689,7 +987,7 @@ void DynamicFont::_reload_cache() {
 	}
 
 	data_at_size = data->_get_dynamic_font_at_size(cache_id);
-	if (outline_cache_id.outline_size > 0) {
+	if (has_outline()) {
 		outline_data_at_size = data->_get_dynamic_font_at_size(outline_cache_id);
 		fallback_outline_data_at_size.resize(fallback_data_at_size.size());
 	} else {
@@ -699,7 +997,7 @@ void DynamicFont::_reload_cache() {
 
 	for (int i = 0; i < fallbacks.size(); i++) {
 		fallback_data_at_size.write[i] = fallbacks.write[i]->_get_dynamic_font_at_size(cache_id);
-		if (outline_cache_id.outline_size > 0)
+		if (has_outline())
 			fallback_outline_data_at_size.write[i] = fallbacks.write[i]->_get_dynamic_font_at_size(outline_cache_id);
 	}
 
@@ -787,6 +1085,20 @@ void DynamicFont::set_use_filter(bool p_enable) {
 	_reload_cache();
 }
 
+bool DynamicFont::get_use_distance_field() const {
+
+	return cache_id.distance_field;
+}
+
+void DynamicFont::set_use_distance_field(bool p_enable) {
+
+	if (cache_id.distance_field == p_enable)
+		return;
+	cache_id.distance_field = p_enable;
+	outline_cache_id.distance_field = p_enable;
+	_reload_cache();
+}
+
 DynamicFontData::Hinting DynamicFontData::get_hinting() const {
 
 	return hinting;
@@ -835,7 +1147,7 @@ float DynamicFont::get_height() const {
 	if (!data_at_size.is_valid())
 		return 1;
 
-	return data_at_size->get_height() + spacing_top + spacing_bottom;
+	return data_at_size->get_height() * _get_scale() + spacing_top + spacing_bottom;
 }
 
 float DynamicFont::get_ascent() const {
@@ -843,7 +1155,7 @@ float DynamicFont::get_ascent() const {
 	if (!data_at_size.is_valid())
 		return 1;
 
-	return data_at_size->get_ascent() + spacing_top;
+	return data_at_size->get_ascent() * _get_scale() + spacing_top;
 }
 
 float DynamicFont::get_descent() const {
@@ -851,7 +1163,7 @@ float DynamicFont::get_descent() const {
 	if (!data_at_size.is_valid())
 		return 1;
 
-	return data_at_size->get_descent() + spacing_bottom;
+	return data_at_size->get_descent() * _get_scale() + spacing_bottom;
 }
 
 Size2 DynamicFont::get_char_size(CharType p_char, CharType p_next) const {
@@ -859,7 +1171,7 @@ Size2 DynamicFont::get_char_size(CharType p_char, CharType p_next) const {
 	if (!data_at_size.is_valid())
 		return Size2(1, 1);
 
-	Size2 ret = data_at_size->get_char_size(p_char, p_next, fallback_data_at_size);
+	Size2 ret = data_at_size->get_char_size(p_char, p_next, fallback_data_at_size) * _get_scale();
 	if (p_char == ' ')
 		ret.width += spacing_space + spacing_char;
 	else if (p_next)
@@ -870,25 +1182,27 @@ Size2 DynamicFont::get_char_size(CharType p_char, CharType p_next) const {
 
 bool DynamicFont::is_distance_field_hint() const {
 
-	return false;
+	return cache_id.distance_field;
 }
 
 bool DynamicFont::has_outline() const {
-	return outline_cache_id.outline_size > 0;
+	//distance field glyphs are shared by all sizes, they have no outline of their own
+	return outline_cache_id.outline_size > 0 && !outline_cache_id.distance_field;
 }
 
 float DynamicFont::draw_char(RID p_canvas_item, const Point2 &p_pos, CharType p_char, CharType p_next, const Color &p_modulate, bool p_outline) const {
-	const Ref<DynamicFontAtSize> &font_at_size = p_outline && outline_cache_id.outline_size > 0 ? outline_data_at_size : data_at_size;
+	bool outline = p_outline && has_outline();
+	const Ref<DynamicFontAtSize> &font_at_size = outline ? outline_data_at_size : data_at_size;
 
 	if (!font_at_size.is_valid())
 		return 0;
 
-	const Vector<Ref<DynamicFontAtSize> > &fallbacks = p_outline && outline_cache_id.outline_size > 0 ? fallback_outline_data_at_size : fallback_data_at_size;
-	Color color = p_outline && outline_cache_id.outline_size > 0 ? p_modulate * outline_color : p_modulate;
+	const Vector<Ref<DynamicFontAtSize> > &fallbacks = outline ? fallback_outline_data_at_size : fallback_data_at_size;
+	Color color = outline ? p_modulate * outline_color : p_modulate;
 
 	// If requested outline draw, but no outline is present, simply return advance without drawing anything
-	bool advance_only = p_outline && outline_cache_id.outline_size == 0;
-	return font_at_size->draw_char(p_canvas_item, p_pos, p_char, p_next, color, fallbacks, advance_only) + spacing_char;
+	bool advance_only = p_outline && !outline;
+	return font_at_size->draw_char(p_canvas_item, p_pos, p_char, p_next, color, fallbacks, advance_only, _get_scale()) + spacing_char;
 }
 
 void DynamicFont::set_fallback(int p_idx, const Ref<DynamicFontData> &p_data) {
@@ -904,7 +1218,7 @@ void DynamicFont::add_fallback(const Ref<DynamicFontData> &p_data) {
 	ERR_FAIL_COND(p_data.is_null());
 	fallbacks.push_back(p_data);
 	fallback_data_at_size.push_back(fallbacks.write[fallbacks.size() - 1]->_get_dynamic_font_at_size(cache_id)); //const..
-	if (outline_cache_id.outline_size > 0)
+	if (has_outline())
 		fallback_outline_data_at_size.push_back(fallbacks.write[fallbacks.size() - 1]->_get_dynamic_font_at_size(outline_cache_id));
 
 	_change_notify();
@@ -930,6 +1244,43 @@ void DynamicFont::remove_fallback(int p_idx) {
 	_change_notify();
 }
 
+void DynamicFont::prewarm_characters(const String &p_characters, bool p_threaded) {
+
+	if (!data_at_size.is_valid())
+		return;
+
+	//each glyph is rasterized by the first font that has it, like when drawing
+	Vector<CharType> remaining;
+	for (int i = 0; i < p_characters.length(); i++) {
+		if (remaining.find(p_characters[i]) == -1) {
+			remaining.push_back(p_characters[i]);
+		}
+	}
+
+	for (int i = -1; i < fallback_data_at_size.size() && remaining.size(); i++) {
+
+		Ref<DynamicFontAtSize> font_at_size = i == -1 ? data_at_size : fallback_data_at_size[i];
+		Ref<DynamicFontAtSize> outline_at_size = i == -1 ? outline_data_at_size : (i < fallback_outline_data_at_size.size() ? fallback_outline_data_at_size[i] : Ref<DynamicFontAtSize>());
+
+		if (font_at_size.is_null())
+			continue;
+
+		Vector<CharType> chars;
+		for (int j = 0; j < remaining.size(); j++) {
+			if (font_at_size->has_char(remaining[j])) {
+				chars.push_back(remaining[j]);
+				remaining.remove(j);
+				j--;
+			}
+		}
+
+		font_at_size->prewarm(chars, p_threaded);
+		if (has_outline() && outline_at_size.is_valid()) {
+			outline_at_size->prewarm(chars, p_threaded);
+		}
+	}
+}
+
 bool DynamicFont::_set(const StringName &p_name, const Variant &p_value) {
 
 	String str = p_name;
@@ -1000,6 +1351,8 @@ void DynamicFont::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_use_mipmaps"), &DynamicFont::get_use_mipmaps);
 	ClassDB::bind_method(D_METHOD("set_use_filter", "enable"), &DynamicFont::set_use_filter);
 	ClassDB::bind_method(D_METHOD("get_use_filter"), &DynamicFont::get_use_filter);
+	ClassDB::bind_method(D_METHOD("set_use_distance_field", "enable"), &DynamicFont::set_use_distance_field);
+	ClassDB::bind_method(D_METHOD("get_use_distance_field"), &DynamicFont::get_use_distance_field);
 	ClassDB::bind_method(D_METHOD("set_spacing", "type", "value"), &DynamicFont::set_spacing);
 	ClassDB::bind_method(D_METHOD("get_spacing", "type"), &DynamicFont::get_spacing);
 
@@ -1009,12 +1362,15 @@ void DynamicFont::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("remove_fallback", "idx"), &DynamicFont::remove_fallback);
 	ClassDB::bind_method(D_METHOD("get_fallback_count"), &DynamicFont::get_fallback_count);
 
+	ClassDB::bind_method(D_METHOD("prewarm_characters", "characters", "threaded"), &DynamicFont::prewarm_characters, DEFVAL(true));
+
 	ADD_GROUP("Settings", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "size"), "set_size", "get_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "outline_size"), "set_outline_size", "get_outline_size");
 	ADD_PROPERTY(PropertyInfo(Variant::COLOR, "outline_color"), "set_outline_color", "get_outline_color");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_mipmaps"), "set_use_mipmaps", "get_use_mipmaps");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_filter"), "set_use_filter", "get_use_filter");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_distance_field"), "set_use_distance_field", "get_use_distance_field");
 	ADD_GROUP("Extra Spacing", "extra_spacing");
 	ADD_PROPERTYINZ(PropertyInfo(Variant::INT, "extra_spacing_top"), "set_spacing", "get_spacing", SPACING_TOP);
 	ADD_PROPERTYINZ(PropertyInfo(Variant::INT, "extra_spacing_bottom"), "set_spacing", "get_spacing", SPACING_BOTTOM);
@@ -35,6 +35,7 @@
 #include "io/resource_loader.h"
 #include "os/mutex.h"
 #include "os/thread_safe.h"
+#include "os/worker_thread_pool.h"
 #include "pair.h"
 #include "scene/resources/font.h"
 
@@ -56,6 +57,7 @@ public:
 				uint32_t outline_size : 8;
 				bool mipmaps : 1;
 				bool filter : 1;
+				bool distance_field : 1;
 			};
 			uint32_t key;
 		};
@@ -129,8 +131,10 @@ class DynamicFontAtSize : public Reference {
 
 		PoolVector<uint8_t> imgdata;
 		int texture_size;
+		Image::Format format;
 		Vector<int> offsets;
 		Ref<ImageTexture> texture;
+		bool dirty; //imgdata changed since the last upload
 	};
 
 	Vector<CharTexture> textures;
@@ -159,11 +163,52 @@ class DynamicFontAtSize : public Reference {
 		int y;
 	};
 
+	//a rasterized glyph that is not in any texture yet, so it can be made on any thread
+	struct GlyphBitmap {
+
+		bool found;
+		int width;
+		int height;
+		int color_size;
+		int xofs;
+		int yofs;
+		float advance;
+		Vector<uint8_t> data;
+
+		GlyphBitmap() {
+			found = false;
+			width = 0;
+			height = 0;
+			color_size = 2;
+			xofs = 0;
+			yofs = 0;
+			advance = 0;
+		}
+	};
+
+	struct PrewarmTask {
+
+		const DynamicFontAtSize *font_at_size; //not a reference, the font waits for the task before going away
+		Vector<CharType> chars;
+		Vector<GlyphBitmap> glyphs;
+		bool ok;
+		WorkerThreadPool::GroupID group;
+	};
+
+	PrewarmTask *prewarm_task;
+
 	const Pair<const Character *, DynamicFontAtSize *> _find_char_with_font(CharType p_char, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks) const;
-	Character _make_outline_char(CharType p_char);
+	bool _make_outline_bitmap(FT_Library p_library, FT_Face p_face, CharType p_char, GlyphBitmap &r_glyph) const;
 	float _get_kerning_advance(const DynamicFontAtSize *font, CharType p_char, CharType p_next) const;
 	TexturePosition _find_texture_pos_for_glyph(int p_color_size, Image::Format p_image_format, int p_width, int p_height);
-	Character _bitmap_to_character(FT_Bitmap bitmap, int yofs, int xofs, float advance);
+	bool _copy_bitmap(const FT_Bitmap &p_bitmap, int p_yofs, int p_xofs, float p_advance, GlyphBitmap &r_glyph) const;
+	void _make_distance_field(GlyphBitmap &r_glyph) const;
+	GlyphBitmap _rasterize_glyph(FT_Library p_library, FT_Face p_face, CharType p_char) const;
+	Character _bitmap_to_character(const GlyphBitmap &p_glyph);
+	void _update_textures();
+
+	static void _prewarm_thread(void *p_userdata, uint32_t p_index);
+	void _finish_prewarm(bool p_discard = false);
 
 	static unsigned long _ft_stream_io(FT_Stream stream, unsigned long offset, unsigned char *buffer, unsigned long count);
 	static void _ft_stream_close(FT_Stream stream);
@@ -177,9 +222,15 @@ class DynamicFontAtSize : public Reference {
 	DynamicFontData::CacheID id;
 
 	static HashMap<String, Vector<uint8_t> > _fontdata;
+	Error _open_face(FT_Library p_library, FT_StreamRec *r_stream, FT_Face *r_face, float *r_scale_color_font = NULL) const;
 	Error _load();
 
 public:
+	enum {
+		DISTANCE_FIELD_SIZE = 48, //every size of a distance field font is drawn from glyphs rasterized at this size
+		DISTANCE_FIELD_SPREAD = 8
+	};
+
 	static float font_oversampling;
 
 	float get_height() const;
@@ -189,7 +240,10 @@ public:
 
 	Size2 get_char_size(CharType p_char, CharType p_next, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks) const;
 
-	float draw_char(RID p_canvas_item, const Point2 &p_pos, CharType p_char, CharType p_next, const Color &p_modulate, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks, bool p_advance_only = false) const;
+	float draw_char(RID p_canvas_item, const Point2 &p_pos, CharType p_char, CharType p_next, const Color &p_modulate, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks, bool p_advance_only = false, float p_scale = 1.0) const;
+
+	bool has_char(CharType p_char) const;
+	void prewarm(const Vector<CharType> &p_chars, bool p_threaded);
 
 	void set_texture_flags(uint32_t p_flags);
 	void update_oversampling();
@@ -232,6 +286,8 @@ private:
 
 	Color outline_color;
 
+	_FORCE_INLINE_ float _get_scale() const { return cache_id.distance_field ? float(cache_id.size) / DynamicFontAtSize::DISTANCE_FIELD_SIZE : 1.0; }
+
 protected:
 	void _reload_cache();
 
@@ -260,6 +316,9 @@ public:
 	bool get_use_filter() const;
 	void set_use_filter(bool p_enable);
 
+	bool get_use_distance_field() const;
+	void set_use_distance_field(bool p_enable);
+
 	int get_spacing(int p_type) const;
 	void set_spacing(int p_type, int p_value);
 
@@ -269,6 +328,8 @@ public:
 	Ref<DynamicFontData> get_fallback(int p_idx) const;
 	void remove_fallback(int p_idx);
 
+	void prewarm_characters(const String &p_characters, bool p_threaded = true);
+
 	virtual float get_height() const;
 
 	virtual float get_ascent() const;
@@ -490,6 +490,17 @@ Environment::SSAOQuality Environment::get_ssao_quality() const {
 	return ssao_quality;
 }
 
+void Environment::set_ssao_resolution(SSAOResolution p_resolution) {
+
+	ssao_resolution = p_resolution;
+	VS::get_singleton()->environment_set_ssao_resolution(environment, VS::EnvironmentSSAOResolution(ssao_resolution));
+}
+
+Environment::SSAOResolution Environment::get_ssao_resolution() const {
+
+	return ssao_resolution;
+}
+
 void Environment::set_ssao_edge_sharpness(float p_edge_sharpness) {
 
 	ssao_edge_sharpness = p_edge_sharpness;
@@ -1030,6 +1041,9 @@ void Environment::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_ssao_quality", "quality"), &Environment::set_ssao_quality);
 	ClassDB::bind_method(D_METHOD("get_ssao_quality"), &Environment::get_ssao_quality);
 
+	ClassDB::bind_method(D_METHOD("set_ssao_resolution", "resolution"), &Environment::set_ssao_resolution);
+	ClassDB::bind_method(D_METHOD("get_ssao_resolution"), &Environment::get_ssao_resolution);
+
 	ClassDB::bind_method(D_METHOD("set_ssao_edge_sharpness", "edge_sharpness"), &Environment::set_ssao_edge_sharpness);
 	ClassDB::bind_method(D_METHOD("get_ssao_edge_sharpness"), &Environment::get_ssao_edge_sharpness);
 
@@ -1044,6 +1058,7 @@ void Environment::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "ssao_ao_channel_affect", PROPERTY_HINT_RANGE, "0.00,1,0.01"), "set_ssao_ao_channel_affect", "get_ssao_ao_channel_affect");
 	ADD_PROPERTY(PropertyInfo(Variant::COLOR, "ssao_color", PROPERTY_HINT_COLOR_NO_ALPHA), "set_ssao_color", "get_ssao_color");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "ssao_quality", PROPERTY_HINT_ENUM, "Low,Medium,High"), "set_ssao_quality", "get_ssao_quality");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "ssao_resolution", PROPERTY_HINT_ENUM, "Full,Half,Quarter"), "set_ssao_resolution", "get_ssao_resolution");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "ssao_blur", PROPERTY_HINT_ENUM, "Disabled,1x1,2x2,3x3"), "set_ssao_blur", "get_ssao_blur");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "ssao_edge_sharpness", PROPERTY_HINT_RANGE, "0,32,0.01"), "set_ssao_edge_sharpness", "get_ssao_edge_sharpness");
 
@@ -1188,6 +1203,10 @@ void Environment::_bind_methods() {
 	BIND_ENUM_CONSTANT(SSAO_QUALITY_LOW);
 	BIND_ENUM_CONSTANT(SSAO_QUALITY_MEDIUM);
 	BIND_ENUM_CONSTANT(SSAO_QUALITY_HIGH);
+
+	BIND_ENUM_CONSTANT(SSAO_RESOLUTION_FULL);
+	BIND_ENUM_CONSTANT(SSAO_RESOLUTION_HALF);
+	BIND_ENUM_CONSTANT(SSAO_RESOLUTION_QUARTER);
 }
 
 Environment::Environment() {
@@ -1238,6 +1257,7 @@ Environment::Environment() {
 	ssao_blur = SSAO_BLUR_3x3;
 	set_ssao_edge_sharpness(4);
 	set_ssao_quality(SSAO_QUALITY_LOW);
+	set_ssao_resolution(SSAO_RESOLUTION_FULL);
 
 	glow_enabled = false;
 	glow_levels = (1 << 2) | (1 << 4);
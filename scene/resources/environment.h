@@ -85,6 +85,12 @@ public:
 		SSAO_QUALITY_HIGH
 	};
 
+	enum SSAOResolution {
+		SSAO_RESOLUTION_FULL,
+		SSAO_RESOLUTION_HALF,
+		SSAO_RESOLUTION_QUARTER
+	};
+
 private:
 	RID environment;
 
@@ -132,6 +138,7 @@ private:
 	SSAOBlur ssao_blur;
 	float ssao_edge_sharpness;
 	SSAOQuality ssao_quality;
+	SSAOResolution ssao_resolution;
 
 	bool glow_enabled;
 	int glow_levels;
@@ -287,6 +294,9 @@ public:
 	void set_ssao_quality(SSAOQuality p_quality);
 	SSAOQuality get_ssao_quality() const;
 
+	void set_ssao_resolution(SSAOResolution p_resolution);
+	SSAOResolution get_ssao_resolution() const;
+
 	void set_ssao_edge_sharpness(float p_edge_sharpness);
 	float get_ssao_edge_sharpness() const;
 
@@ -398,5 +408,6 @@ VARIANT_ENUM_CAST(Environment::GlowBlendMode)
 VARIANT_ENUM_CAST(Environment::DOFBlurQuality)
 VARIANT_ENUM_CAST(Environment::SSAOQuality)
 VARIANT_ENUM_CAST(Environment::SSAOBlur)
+VARIANT_ENUM_CAST(Environment::SSAOResolution)
 
 #endif // ENVIRONMENT_H
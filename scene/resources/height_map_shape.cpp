@@ -0,0 +1,242 @@
+/*************************************************************************/
+/*  height_map_shape.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "height_map_shape.h"
+
+#include "servers/physics_server.h"
+
+Vector<Vector3> HeightMapShape::_gen_debug_mesh_lines() {
+
+	Vector<Vector3> points;
+
+	if ((map_width != 0) && (map_depth != 0)) {
+
+		// one line per cell edge, centered like the physics shape
+		Vector2 size(map_width - 1, map_depth - 1);
+		Vector2 start = size * -0.5;
+
+		PoolRealArray::Read r = map_data.read();
+
+		// reserve some memory for our points..
+		points.resize(((map_width - 1) * map_depth * 2) + (map_width * (map_depth - 1) * 2));
+
+		// now set our points
+		int r_offset = 0;
+		int w_offset = 0;
+		for (int d = 0; d < map_depth; d++) {
+			Vector3 height(start.x, 0.0, start.y);
+
+			for (int w = 0; w < map_width; w++) {
+				height.y = r[r_offset++];
+
+				if (w != map_width - 1) {
+					points.write[w_offset++] = height;
+					points.write[w_offset++] = Vector3(height.x + 1.0, r[r_offset], height.z);
+				}
+
+				if (d != map_depth - 1) {
+					points.write[w_offset++] = height;
+					points.write[w_offset++] = Vector3(height.x, r[r_offset + map_width - 1], height.z + 1.0);
+				}
+
+				height.x += 1.0;
+			}
+
+			start.y += 1.0;
+		}
+	}
+
+	return points;
+}
+
+void HeightMapShape::_update_shape() {
+
+	Dictionary d;
+	d["width"] = map_width;
+	d["depth"] = map_depth;
+	d["cell_size"] = 1.0;
+	d["heights"] = map_data;
+
+	real_t min_height = 0.0;
+	real_t max_height = 0.0;
+	{
+		PoolRealArray::Read r = map_data.read();
+		for (int i = 0; i < map_data.size(); i++) {
+			if (i == 0 || r[i] < min_height)
+				min_height = r[i];
+			if (i == 0 || r[i] > max_height)
+				max_height = r[i];
+		}
+	}
+	d["min_height"] = min_height;
+	d["max_height"] = max_height;
+
+	PhysicsServer::get_singleton()->shape_set_data(get_shape(), d);
+	emit_changed();
+}
+
+void HeightMapShape::set_map_width(int p_new) {
+
+	if (p_new < 2) {
+		// ignore
+	} else if (map_width != p_new) {
+		int was_size = map_width * map_depth;
+		map_width = p_new;
+
+		int new_size = map_width * map_depth;
+		map_data.resize(map_width * map_depth);
+
+		PoolRealArray::Write w = map_data.write();
+		while (was_size < new_size) {
+			w[was_size++] = 0.0;
+		}
+
+		w = PoolRealArray::Write();
+		_update_shape();
+		notify_change_to_owners();
+		_change_notify("map_width");
+		_change_notify("map_data");
+	}
+}
+
+int HeightMapShape::get_map_width() const {
+
+	return map_width;
+}
+
+void HeightMapShape::set_map_depth(int p_new) {
+
+	if (p_new < 2) {
+		// ignore
+	} else if (map_depth != p_new) {
+		int was_size = map_width * map_depth;
+		map_depth = p_new;
+
+		int new_size = map_width * map_depth;
+		map_data.resize(new_size);
+
+		PoolRealArray::Write w = map_data.write();
+		while (was_size < new_size) {
+			w[was_size++] = 0.0;
+		}
+
+		w = PoolRealArray::Write();
+		_update_shape();
+		notify_change_to_owners();
+		_change_notify("map_depth");
+		_change_notify("map_data");
+	}
+}
+
+int HeightMapShape::get_map_depth() const {
+
+	return map_depth;
+}
+
+void HeightMapShape::set_map_data(PoolRealArray p_new) {
+
+	int size = (map_width * map_depth);
+	if (p_new.size() != size) {
+		// fail
+		return;
+	}
+
+	map_data = p_new;
+
+	_update_shape();
+	notify_change_to_owners();
+	_change_notify("map_data");
+}
+
+PoolRealArray HeightMapShape::get_map_data() const {
+
+	return map_data;
+}
+
+void HeightMapShape::update_map_data_region(int p_x, int p_z, int p_width, int p_depth, const PoolRealArray &p_data) {
+
+	ERR_FAIL_COND(p_x < 0 || p_z < 0 || p_width <= 0 || p_depth <= 0);
+	ERR_FAIL_COND(p_x + p_width > map_width || p_z + p_depth > map_depth);
+	ERR_FAIL_COND(p_data.size() != p_width * p_depth);
+
+	{
+		PoolRealArray::Read r = p_data.read();
+		PoolRealArray::Write w = map_data.write();
+		for (int z = 0; z < p_depth; z++) {
+			for (int x = 0; x < p_width; x++) {
+				w[(p_z + z) * map_width + p_x + x] = r[z * p_width + x];
+			}
+		}
+	}
+
+	//only send the changed block, so streaming terrain in does not resend the whole map
+	Dictionary d;
+	d["region_x"] = p_x;
+	d["region_z"] = p_z;
+	d["region_width"] = p_width;
+	d["region_depth"] = p_depth;
+	d["heights"] = p_data;
+	PhysicsServer::get_singleton()->shape_set_data(get_shape(), d);
+
+	emit_changed();
+	notify_change_to_owners();
+	_change_notify("map_data");
+}
+
+void HeightMapShape::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("set_map_width", "width"), &HeightMapShape::set_map_width);
+	ClassDB::bind_method(D_METHOD("get_map_width"), &HeightMapShape::get_map_width);
+	ClassDB::bind_method(D_METHOD("set_map_depth", "height"), &HeightMapShape::set_map_depth);
+	ClassDB::bind_method(D_METHOD("get_map_depth"), &HeightMapShape::get_map_depth);
+	ClassDB::bind_method(D_METHOD("set_map_data", "data"), &HeightMapShape::set_map_data);
+	ClassDB::bind_method(D_METHOD("get_map_data"), &HeightMapShape::get_map_data);
+	ClassDB::bind_method(D_METHOD("update_map_data_region", "x", "z", "width", "depth", "data"), &HeightMapShape::update_map_data_region);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "map_width", PROPERTY_HINT_RANGE, "2,4096,1"), "set_map_width", "get_map_width");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "map_depth", PROPERTY_HINT_RANGE, "2,4096,1"), "set_map_depth", "get_map_depth");
+	ADD_PROPERTY(PropertyInfo(Variant::POOL_REAL_ARRAY, "map_data"), "set_map_data", "get_map_data");
+}
+
+HeightMapShape::HeightMapShape() :
+		Shape(PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_HEIGHTMAP)) {
+
+	map_width = 2;
+	map_depth = 2;
+	map_data.resize(map_width * map_depth);
+	PoolRealArray::Write w = map_data.write();
+	w[0] = 0.0;
+	w[1] = 0.0;
+	w[2] = 0.0;
+	w[3] = 0.0;
+	w = PoolRealArray::Write();
+
+	_update_shape();
+}
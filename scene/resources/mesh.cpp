@@ -516,6 +516,9 @@ void Mesh::_bind_methods() {
 
 	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_2D_VERTICES);
 	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_16_BIT_BONES);
+	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION);
+	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_QUANTIZED_VERTICES);
+	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_16_BIT_TEX_UV2);
 
 	BIND_ENUM_CONSTANT(ARRAY_COMPRESS_DEFAULT);
 
@@ -535,6 +538,22 @@ void Mesh::clear_cache() {
 	_clear_triangle_mesh();
 }
 
+uint64_t Mesh::get_memory_usage() const {
+
+	uint64_t usage = 0;
+	for (int i = 0; i < get_surface_count(); i++) {
+
+		int len = surface_get_array_len(i);
+		int index_len = surface_get_array_index_len(i);
+		usage += uint64_t(VS::get_singleton()->mesh_surface_get_format_stride(surface_get_format(i), len, index_len)) * len;
+		if (index_len > 0) {
+			usage += uint64_t(index_len) * (len > (1 << 16) ? 4 : 2);
+		}
+	}
+
+	return usage;
+}
+
 Mesh::Mesh() {
 }
 
@@ -1090,11 +1109,13 @@ void ArrayMesh::center_geometry() {
 void ArrayMesh::regen_normalmaps() {
 
 	Vector<Ref<SurfaceTool> > surfs;
+	Vector<uint32_t> formats;
 	for (int i = 0; i < get_surface_count(); i++) {
 
 		Ref<SurfaceTool> st = memnew(SurfaceTool);
 		st->create_from(Ref<ArrayMesh>(this), i);
 		surfs.push_back(st);
+		formats.push_back(surface_get_format(i)); //keep the compression
 	}
 
 	while (get_surface_count()) {
@@ -1104,52 +1125,40 @@ void ArrayMesh::regen_normalmaps() {
 	for (int i = 0; i < surfs.size(); i++) {
 
 		surfs.write[i]->generate_tangents();
-		surfs.write[i]->commit(Ref<ArrayMesh>(this));
+		surfs.write[i]->commit(Ref<ArrayMesh>(this), formats[i]);
 	}
 }
 
 //dirty hack
 bool (*array_mesh_lightmap_unwrap_callback)(float p_texel_size, const float *p_vertices, const float *p_normals, int p_vertex_count, const int *p_indices, const int *p_face_materials, int p_index_count, float **r_uv, int **r_vertex, int *r_vertex_count, int **r_index, int *r_index_count, int *r_size_hint_x, int *r_size_hint_y) = NULL;
 
-struct ArrayMeshLightmapSurface {
-
-	Ref<Material> material;
-	Vector<SurfaceTool::Vertex> vertices;
-	Mesh::PrimitiveType primitive;
-	uint32_t format;
-};
-
-Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texel_size) {
+Error ArrayMesh::lightmap_unwrap_prepare(const Transform &p_base_transform, float p_texel_size, LightmapUnwrap &r_unwrap) const {
 
 	ERR_FAIL_COND_V(!array_mesh_lightmap_unwrap_callback, ERR_UNCONFIGURED);
 	ERR_EXPLAIN("Can't unwrap mesh with blend shapes");
 	ERR_FAIL_COND_V(blend_shapes.size() != 0, ERR_UNAVAILABLE);
 
-	Vector<float> vertices;
-	Vector<float> normals;
-	Vector<int> indices;
-	Vector<int> face_materials;
-	Vector<float> uv;
-	Vector<Pair<int, int> > uv_index;
+	r_unwrap.texel_size = p_texel_size;
+
+	Vector<float> &vertices = r_unwrap.vertices;
+	Vector<float> &normals = r_unwrap.normals;
+	Vector<int> &indices = r_unwrap.indices;
+	Vector<int> &face_materials = r_unwrap.face_materials;
+	Vector<Pair<int, int> > &uv_index = r_unwrap.uv_index;
 
-	Vector<ArrayMeshLightmapSurface> surfaces;
 	for (int i = 0; i < get_surface_count(); i++) {
-		ArrayMeshLightmapSurface s;
-		s.primitive = surface_get_primitive_type(i);
 
-		if (s.primitive != Mesh::PRIMITIVE_TRIANGLES) {
+		if (surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
 			ERR_EXPLAIN("Only triangles are supported for lightmap unwrap");
 			ERR_FAIL_V(ERR_UNAVAILABLE);
 		}
-		s.format = surface_get_format(i);
-		if (!(s.format & ARRAY_FORMAT_NORMAL)) {
+		uint32_t format = surface_get_format(i);
+		if (!(format & ARRAY_FORMAT_NORMAL)) {
 			ERR_EXPLAIN("Normals are required for lightmap unwrap");
 			ERR_FAIL_V(ERR_UNAVAILABLE);
 		}
 
 		Array arrays = surface_get_arrays(i);
-		s.material = surface_get_material(i);
-		s.vertices = SurfaceTool::create_vertex_array_from_triangle_arrays(arrays);
 
 		PoolVector<Vector3> rvertices = arrays[Mesh::ARRAY_VERTEX];
 		int vc = rvertices.size();
@@ -1206,10 +1215,17 @@ Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texe
 			}
 		}
 
-		surfaces.push_back(s);
+		r_unwrap.surface_arrays.push_back(arrays);
+		r_unwrap.surface_materials.push_back(surface_get_material(i));
+		r_unwrap.surface_formats.push_back(format);
 	}
 
-	//unwrap
+	return OK;
+}
+
+Error ArrayMesh::lightmap_unwrap_generate(LightmapUnwrap &p_unwrap) {
+
+	ERR_FAIL_COND_V(!array_mesh_lightmap_unwrap_callback, ERR_UNCONFIGURED);
 
 	float *gen_uvs;
 	int *gen_vertices;
@@ -1219,12 +1235,62 @@ Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texe
 	int size_x;
 	int size_y;
 
-	bool ok = array_mesh_lightmap_unwrap_callback(p_texel_size, vertices.ptr(), normals.ptr(), vertices.size() / 3, indices.ptr(), face_materials.ptr(), indices.size(), &gen_uvs, &gen_vertices, &gen_vertex_count, &gen_indices, &gen_index_count, &size_x, &size_y);
+	bool ok = array_mesh_lightmap_unwrap_callback(p_unwrap.texel_size, p_unwrap.vertices.ptr(), p_unwrap.normals.ptr(), p_unwrap.vertices.size() / 3, p_unwrap.indices.ptr(), p_unwrap.face_materials.ptr(), p_unwrap.indices.size(), &gen_uvs, &gen_vertices, &gen_vertex_count, &gen_indices, &gen_index_count, &size_x, &size_y);
 
 	if (!ok) {
 		return ERR_CANT_CREATE;
 	}
 
+	p_unwrap.uvs.resize(gen_vertex_count * 2);
+	copymem(p_unwrap.uvs.ptrw(), gen_uvs, sizeof(float) * gen_vertex_count * 2);
+	p_unwrap.gen_vertices.resize(gen_vertex_count);
+	copymem(p_unwrap.gen_vertices.ptrw(), gen_vertices, sizeof(int) * gen_vertex_count);
+	p_unwrap.gen_indices.resize(gen_index_count);
+	copymem(p_unwrap.gen_indices.ptrw(), gen_indices, sizeof(int) * gen_index_count);
+	p_unwrap.size_hint = Size2(size_x, size_y);
+
+	//free stuff
+	::free(gen_vertices);
+	::free(gen_indices);
+	::free(gen_uvs);
+
+	return OK;
+}
+
+Error ArrayMesh::lightmap_unwrap_apply(const LightmapUnwrap &p_unwrap) {
+
+	const int surface_count = p_unwrap.surface_arrays.size();
+	ERR_FAIL_COND_V(get_surface_count() != surface_count, ERR_INVALID_PARAMETER);
+
+	const int *gen_vertices = p_unwrap.gen_vertices.ptr();
+	const int *gen_indices = p_unwrap.gen_indices.ptr();
+	const float *gen_uvs = p_unwrap.uvs.ptr();
+	const int gen_vertex_count = p_unwrap.gen_vertices.size();
+	const int gen_index_count = p_unwrap.gen_indices.size();
+	const Vector<Pair<int, int> > &uv_index = p_unwrap.uv_index;
+
+	ERR_FAIL_COND_V(p_unwrap.uvs.size() != gen_vertex_count * 2, ERR_INVALID_DATA);
+
+	//validate everything before the mesh is modified, cached results may be stale
+	for (int i = 0; i < gen_index_count; i += 3) {
+
+		ERR_FAIL_INDEX_V(gen_indices[i + 0], gen_vertex_count, ERR_BUG);
+		ERR_FAIL_INDEX_V(gen_indices[i + 1], gen_vertex_count, ERR_BUG);
+		ERR_FAIL_INDEX_V(gen_indices[i + 2], gen_vertex_count, ERR_BUG);
+
+		ERR_FAIL_INDEX_V(gen_vertices[gen_indices[i + 0]], uv_index.size(), ERR_BUG);
+		ERR_FAIL_INDEX_V(gen_vertices[gen_indices[i + 1]], uv_index.size(), ERR_BUG);
+		ERR_FAIL_INDEX_V(gen_vertices[gen_indices[i + 2]], uv_index.size(), ERR_BUG);
+
+		ERR_FAIL_COND_V(uv_index[gen_vertices[gen_indices[i + 0]]].first != uv_index[gen_vertices[gen_indices[i + 1]]].first || uv_index[gen_vertices[gen_indices[i + 0]]].first != uv_index[gen_vertices[gen_indices[i + 2]]].first, ERR_BUG);
+	}
+
+	Vector<Vector<SurfaceTool::Vertex> > surface_vertices;
+	surface_vertices.resize(surface_count);
+	for (int i = 0; i < surface_count; i++) {
+		surface_vertices.write[i] = SurfaceTool::create_vertex_array_from_triangle_arrays(p_unwrap.surface_arrays[i]);
+	}
+
 	//remove surfaces
 	while (get_surface_count()) {
 		surface_remove(0);
@@ -1233,11 +1299,11 @@ Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texe
 	//create surfacetools for each surface..
 	Vector<Ref<SurfaceTool> > surfaces_tools;
 
-	for (int i = 0; i < surfaces.size(); i++) {
+	for (int i = 0; i < surface_count; i++) {
 		Ref<SurfaceTool> st;
 		st.instance();
 		st->begin(Mesh::PRIMITIVE_TRIANGLES);
-		st->set_material(surfaces[i].material);
+		st->set_material(p_unwrap.surface_materials[i]);
 		surfaces_tools.push_back(st); //stay there
 	}
 
@@ -1245,37 +1311,32 @@ Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texe
 	//go through all indices
 	for (int i = 0; i < gen_index_count; i += 3) {
 
-		ERR_FAIL_INDEX_V(gen_vertices[gen_indices[i + 0]], uv_index.size(), ERR_BUG);
-		ERR_FAIL_INDEX_V(gen_vertices[gen_indices[i + 1]], uv_index.size(), ERR_BUG);
-		ERR_FAIL_INDEX_V(gen_vertices[gen_indices[i + 2]], uv_index.size(), ERR_BUG);
-
-		ERR_FAIL_COND_V(uv_index[gen_vertices[gen_indices[i + 0]]].first != uv_index[gen_vertices[gen_indices[i + 1]]].first || uv_index[gen_vertices[gen_indices[i + 0]]].first != uv_index[gen_vertices[gen_indices[i + 2]]].first, ERR_BUG);
-
 		int surface = uv_index[gen_vertices[gen_indices[i + 0]]].first;
+		uint32_t format = p_unwrap.surface_formats[surface];
 
 		for (int j = 0; j < 3; j++) {
 
-			SurfaceTool::Vertex v = surfaces[surface].vertices[uv_index[gen_vertices[gen_indices[i + j]]].second];
+			SurfaceTool::Vertex v = surface_vertices[surface][uv_index[gen_vertices[gen_indices[i + j]]].second];
 
-			if (surfaces[surface].format & ARRAY_FORMAT_COLOR) {
+			if (format & ARRAY_FORMAT_COLOR) {
 				surfaces_tools.write[surface]->add_color(v.color);
 			}
-			if (surfaces[surface].format & ARRAY_FORMAT_TEX_UV) {
+			if (format & ARRAY_FORMAT_TEX_UV) {
 				surfaces_tools.write[surface]->add_uv(v.uv);
 			}
-			if (surfaces[surface].format & ARRAY_FORMAT_NORMAL) {
+			if (format & ARRAY_FORMAT_NORMAL) {
 				surfaces_tools.write[surface]->add_normal(v.normal);
 			}
-			if (surfaces[surface].format & ARRAY_FORMAT_TANGENT) {
+			if (format & ARRAY_FORMAT_TANGENT) {
 				Plane t;
 				t.normal = v.tangent;
 				t.d = v.binormal.dot(v.normal.cross(v.tangent)) < 0 ? -1 : 1;
 				surfaces_tools.write[surface]->add_tangent(t);
 			}
-			if (surfaces[surface].format & ARRAY_FORMAT_BONES) {
+			if (format & ARRAY_FORMAT_BONES) {
 				surfaces_tools.write[surface]->add_bones(v.bones);
 			}
-			if (surfaces[surface].format & ARRAY_FORMAT_WEIGHTS) {
+			if (format & ARRAY_FORMAT_WEIGHTS) {
 				surfaces_tools.write[surface]->add_weights(v.weights);
 			}
 
@@ -1286,23 +1347,35 @@ Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texe
 		}
 	}
 
-	//free stuff
-	::free(gen_vertices);
-	::free(gen_indices);
-	::free(gen_uvs);
-
 	//generate surfaces
 
 	for (int i = 0; i < surfaces_tools.size(); i++) {
 		surfaces_tools.write[i]->index();
-		surfaces_tools.write[i]->commit(Ref<ArrayMesh>((ArrayMesh *)this), surfaces[i].format);
+		surfaces_tools.write[i]->commit(Ref<ArrayMesh>((ArrayMesh *)this), p_unwrap.surface_formats[i]);
 	}
 
-	set_lightmap_size_hint(Size2(size_x, size_y));
+	set_lightmap_size_hint(p_unwrap.size_hint);
 
 	return OK;
 }
 
+Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texel_size) {
+
+	LightmapUnwrap unwrap;
+
+	Error err = lightmap_unwrap_prepare(p_base_transform, p_texel_size, unwrap);
+	if (err != OK) {
+		return err;
+	}
+
+	err = lightmap_unwrap_generate(unwrap);
+	if (err != OK) {
+		return err;
+	}
+
+	return lightmap_unwrap_apply(unwrap);
+}
+
 void ArrayMesh::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("add_blend_shape", "name"), &ArrayMesh::add_blend_shape);
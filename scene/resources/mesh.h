@@ -31,6 +31,7 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include "pair.h"
 #include "resource.h"
 #include "scene/resources/material.h"
 #include "scene/resources/shape.h"
@@ -99,8 +100,11 @@ public:
 		ARRAY_FLAG_USE_2D_VERTICES = ARRAY_COMPRESS_INDEX << 1,
 		ARRAY_FLAG_USE_16_BIT_BONES = ARRAY_COMPRESS_INDEX << 2,
 		ARRAY_FLAG_USE_DYNAMIC_UPDATE = ARRAY_COMPRESS_INDEX << 3,
+		ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION = ARRAY_COMPRESS_INDEX << 4, // compressed normals and tangents are octahedral
+		ARRAY_FLAG_USE_QUANTIZED_VERTICES = ARRAY_COMPRESS_INDEX << 5, // compressed vertices are 16 bits relative to the surface AABB
+		ARRAY_FLAG_USE_16_BIT_TEX_UV2 = ARRAY_COMPRESS_INDEX << 6, // compressed UV2 is 16 bits in the 0-1 range
 
-		ARRAY_COMPRESS_DEFAULT = ARRAY_COMPRESS_NORMAL | ARRAY_COMPRESS_TANGENT | ARRAY_COMPRESS_COLOR | ARRAY_COMPRESS_TEX_UV | ARRAY_COMPRESS_TEX_UV2 | ARRAY_COMPRESS_WEIGHTS
+		ARRAY_COMPRESS_DEFAULT = ARRAY_COMPRESS_NORMAL | ARRAY_COMPRESS_TANGENT | ARRAY_COMPRESS_COLOR | ARRAY_COMPRESS_TEX_UV | ARRAY_COMPRESS_TEX_UV2 | ARRAY_COMPRESS_WEIGHTS | ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION
 
 	};
 
@@ -148,6 +152,9 @@ public:
 	Size2 get_lightmap_size_hint() const;
 	void clear_cache();
 
+	virtual MemoryCategory get_memory_category() const { return MEMORY_CATEGORY_MESH; }
+	virtual uint64_t get_memory_usage() const;
+
 	Mesh();
 };
 
@@ -227,6 +234,31 @@ public:
 	void center_geometry();
 	void regen_normalmaps();
 
+	struct LightmapUnwrap {
+
+		//gathered from the surfaces by lightmap_unwrap_prepare()
+		float texel_size;
+		Vector<float> vertices;
+		Vector<float> normals;
+		Vector<int> indices;
+		Vector<int> face_materials;
+		Vector<Pair<int, int> > uv_index;
+		Vector<Array> surface_arrays;
+		Vector<Ref<Material> > surface_materials;
+		Vector<uint32_t> surface_formats;
+
+		//filled by lightmap_unwrap_generate(), or restored from a cache
+		Vector<float> uvs;
+		Vector<int> gen_vertices;
+		Vector<int> gen_indices;
+		Size2 size_hint;
+	};
+
+	//unwrapping is split so the expensive part can run on any thread, generate() does not touch the mesh or any server
+	Error lightmap_unwrap_prepare(const Transform &p_base_transform, float p_texel_size, LightmapUnwrap &r_unwrap) const;
+	static Error lightmap_unwrap_generate(LightmapUnwrap &p_unwrap);
+	Error lightmap_unwrap_apply(const LightmapUnwrap &p_unwrap);
+
 	Error lightmap_unwrap(const Transform &p_base_transform = Transform(), float p_texel_size = 0.05);
 
 	virtual void reload_from_file();
@@ -1663,6 +1663,7 @@ SceneState::SceneState() {
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
 
+	clear_pool();
 	state->set_bundled_scene(p_scene);
 }
 
@@ -1673,11 +1674,13 @@ Dictionary PackedScene::_get_bundled_scene() const {
 
 Error PackedScene::pack(Node *p_scene) {
 
+	clear_pool();
 	return state->pack(p_scene);
 }
 
 void PackedScene::clear() {
 
+	clear_pool();
 	state->clear();
 }
 
@@ -1711,8 +1714,167 @@ Node *PackedScene::instance(GenEditState p_edit_state) const {
 	return s;
 }
 
+static void _pool_collect_nodes(Node *p_node, Vector<Node *> &r_nodes) {
+
+	r_nodes.push_back(p_node);
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_pool_collect_nodes(p_node->get_child(i), r_nodes);
+	}
+}
+
+PackedScene::PooledInstance *PackedScene::_pool_create_instance() {
+
+	Node *root = instance();
+	ERR_FAIL_COND_V(!root, NULL);
+
+	Vector<Node *> nodes;
+	_pool_collect_nodes(root, nodes);
+
+	PooledInstance *instance = memnew(PooledInstance);
+	instance->nodes.resize(nodes.size());
+
+	for (int i = 0; i < nodes.size(); i++) {
+
+		PooledNode &pn = instance->nodes.write[i];
+		pn.node = nodes[i];
+		pn.id = nodes[i]->get_instance_id();
+
+		List<PropertyInfo> plist;
+		nodes[i]->get_property_list(&plist);
+		for (List<PropertyInfo>::Element *E = plist.front(); E; E = E->next()) {
+
+			if (!(E->get().usage & PROPERTY_USAGE_STORAGE) || E->get().name == "script")
+				continue;
+
+			pn.names.push_back(E->get().name);
+			// containers are compared and restored by content, so keep a copy of their own
+			pn.values.push_back(nodes[i]->get(E->get().name).duplicate(true));
+		}
+	}
+
+	return instance;
+}
+
+bool PackedScene::_pool_restore_instance(PooledInstance *p_instance) {
+
+	// the tree must still be the one that was instanced, otherwise it's not reused
+	Vector<Node *> nodes;
+	_pool_collect_nodes(p_instance->nodes[0].node, nodes);
+	if (nodes.size() != p_instance->nodes.size())
+		return false;
+
+	for (int i = 0; i < nodes.size(); i++) {
+		if (nodes[i]->get_instance_id() != p_instance->nodes[i].id)
+			return false;
+	}
+
+	for (int i = 0; i < p_instance->nodes.size(); i++) {
+
+		const PooledNode &pn = p_instance->nodes[i];
+		for (int j = 0; j < pn.names.size(); j++) {
+
+			bool valid;
+			Variant value = pn.node->get(pn.names[j], &valid);
+			if (valid && value != pn.values[j])
+				pn.node->set(pn.names[j], pn.values[j].duplicate(true));
+		}
+
+		pn.node->request_ready();
+	}
+
+	return true;
+}
+
+void PackedScene::_pool_prune_active() {
+
+	// instances freed instead of released would otherwise stay here forever
+	Vector<ObjectID> freed;
+	for (Map<ObjectID, PooledInstance *>::Element *E = pool_active.front(); E; E = E->next()) {
+		if (!ObjectDB::get_instance(E->key()))
+			freed.push_back(E->key());
+	}
+
+	for (int i = 0; i < freed.size(); i++) {
+		memdelete(pool_active[freed[i]]);
+		pool_active.erase(freed[i]);
+	}
+
+	pool_prune_size = MAX(64, pool_active.size() * 2);
+}
+
+Node *PackedScene::acquire_instance() {
+
+	PooledInstance *instance;
+
+	if (pool.size()) {
+		instance = pool[pool.size() - 1];
+		pool.resize(pool.size() - 1);
+	} else {
+		instance = _pool_create_instance();
+		if (!instance)
+			return NULL;
+	}
+
+	if (pool_active.size() >= pool_prune_size)
+		_pool_prune_active();
+
+	Node *root = instance->nodes[0].node;
+	pool_active[root->get_instance_id()] = instance;
+	return root;
+}
+
+void PackedScene::release_instance(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+
+	Map<ObjectID, PooledInstance *>::Element *E = pool_active.find(p_node->get_instance_id());
+	if (!E) {
+		ERR_EXPLAIN("Node was not acquired from the pool of this scene.");
+		ERR_FAIL();
+	}
+
+	PooledInstance *instance = E->get();
+	pool_active.erase(E);
+
+	if (p_node->get_parent())
+		p_node->get_parent()->remove_child(p_node);
+
+	if (!_pool_restore_instance(instance)) {
+		memdelete(p_node);
+		memdelete(instance);
+		return;
+	}
+
+	pool.push_back(instance);
+}
+
+void PackedScene::prewarm_pool(int p_count) {
+
+	while (pool.size() < p_count) {
+
+		PooledInstance *instance = _pool_create_instance();
+		ERR_FAIL_COND(!instance);
+		pool.push_back(instance);
+	}
+}
+
+void PackedScene::clear_pool() {
+
+	for (int i = 0; i < pool.size(); i++) {
+		memdelete(pool[i]->nodes[0].node);
+		memdelete(pool[i]);
+	}
+	pool.clear();
+}
+
+int PackedScene::get_pool_size() const {
+
+	return pool.size();
+}
+
 void PackedScene::replace_state(Ref<SceneState> p_by) {
 
+	clear_pool();
 	state = p_by;
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1722,6 +1884,7 @@ void PackedScene::replace_state(Ref<SceneState> p_by) {
 
 void PackedScene::recreate_state() {
 
+	clear_pool();
 	state = Ref<SceneState>(memnew(SceneState));
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1748,6 +1911,11 @@ void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
 	ClassDB::bind_method(D_METHOD("get_state"), &PackedScene::get_state);
+	ClassDB::bind_method(D_METHOD("acquire_instance"), &PackedScene::acquire_instance);
+	ClassDB::bind_method(D_METHOD("release_instance", "node"), &PackedScene::release_instance);
+	ClassDB::bind_method(D_METHOD("prewarm_pool", "count"), &PackedScene::prewarm_pool);
+	ClassDB::bind_method(D_METHOD("clear_pool"), &PackedScene::clear_pool);
+	ClassDB::bind_method(D_METHOD("get_pool_size"), &PackedScene::get_pool_size);
 
 	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "_bundled"), "_set_bundled_scene", "_get_bundled_scene");
 
@@ -1759,4 +1927,15 @@ void PackedScene::_bind_methods() {
 PackedScene::PackedScene() {
 
 	state = Ref<SceneState>(memnew(SceneState));
+	pool_prune_size = 64;
+}
+
+PackedScene::~PackedScene() {
+
+	clear_pool();
+
+	// instances still in use belong to the game now
+	for (Map<ObjectID, PooledInstance *>::Element *E = pool_active.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
 }
@@ -201,6 +201,28 @@ class PackedScene : public Resource {
 
 	Ref<SceneState> state;
 
+	// Instance pool. Each pooled instance remembers its nodes (in tree order) and their
+	// stored properties as they were right after instancing, so a released instance can
+	// be reused after setting back only the properties that changed.
+	struct PooledNode {
+		Node *node;
+		ObjectID id;
+		Vector<StringName> names;
+		Vector<Variant> values;
+	};
+
+	struct PooledInstance {
+		Vector<PooledNode> nodes;
+	};
+
+	Vector<PooledInstance *> pool;
+	Map<ObjectID, PooledInstance *> pool_active;
+	int pool_prune_size;
+
+	PooledInstance *_pool_create_instance();
+	bool _pool_restore_instance(PooledInstance *p_instance);
+	void _pool_prune_active();
+
 	void _set_bundled_scene(const Dictionary &p_scene);
 	Dictionary _get_bundled_scene() const;
 
@@ -222,6 +244,12 @@ public:
 	bool can_instance() const;
 	Node *instance(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
 
+	Node *acquire_instance();
+	void release_instance(Node *p_node);
+	void prewarm_pool(int p_count);
+	void clear_pool();
+	int get_pool_size() const;
+
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
 
@@ -233,6 +261,7 @@ public:
 	Ref<SceneState> get_state();
 
 	PackedScene();
+	~PackedScene();
 };
 
 VARIANT_ENUM_CAST(PackedScene::GenEditState)
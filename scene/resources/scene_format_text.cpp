@@ -388,11 +388,51 @@ Ref<PackedScene> ResourceInteractiveLoaderText::_parse_node_tag(VariantParser::R
 	return packed_scene;
 }
 
+void ResourceInteractiveLoaderText::_start_prefetch(const String &p_file) {
+
+	// ext_resource tags are parsed one at a time while loading, so read them all up front with a second loader
+	FileAccess *df = FileAccess::open(p_file, FileAccess::READ);
+	if (!df)
+		return;
+
+	Ref<ResourceInteractiveLoaderText> ria = memnew(ResourceInteractiveLoaderText);
+	ria->local_path = local_path;
+	ria->res_path = res_path;
+
+	List<String> dependencies;
+	ria->get_dependencies(df, &dependencies, true);
+
+	Vector<String> paths;
+	Vector<String> types;
+	for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+
+		String path = E->get();
+		String type;
+		int sep = path.find("::");
+		if (sep != -1) {
+			type = path.substr(sep + 2, path.length());
+			path = path.substr(0, sep);
+		}
+		if (remaps.has(path)) {
+			path = remaps[path];
+		}
+		paths.push_back(path);
+		types.push_back(type);
+	}
+
+	prefetch = ResourceLoader::prefetch_dependencies(local_path, paths, types);
+}
+
 Error ResourceInteractiveLoaderText::poll() {
 
 	if (error != OK)
 		return error;
 
+	if (prefetch && next_tag.name != "ext_resource") {
+		ResourceLoader::finish_prefetch(prefetch);
+		prefetch = NULL;
+	}
+
 	if (next_tag.name == "ext_resource") {
 
 		if (!next_tag.fields.has("path")) {
@@ -661,10 +701,14 @@ void ResourceInteractiveLoaderText::set_translation_remapped(bool p_remapped) {
 
 ResourceInteractiveLoaderText::ResourceInteractiveLoaderText() {
 	translation_remapped = false;
+	prefetch = NULL;
 }
 
 ResourceInteractiveLoaderText::~ResourceInteractiveLoaderText() {
 
+	if (prefetch)
+		ResourceLoader::finish_prefetch(prefetch);
+
 	memdelete(f);
 }
 
@@ -717,6 +761,8 @@ void ResourceInteractiveLoaderText::get_dependencies(FileAccess *p_f, List<Strin
 
 Error ResourceInteractiveLoaderText::rename_dependencies(FileAccess *p_f, const String &p_path, const Map<String, String> &p_map) {
 
+	// the rest of the file is copied from the position the parser stopped at
+	stream.readahead_enabled = false;
 	open(p_f, true);
 	ERR_FAIL_COND_V(error != OK, error);
 	ignore_resource_parsing = true;
@@ -1231,6 +1277,8 @@ Ref<ResourceInteractiveLoader> ResourceFormatLoaderText::load_interactive(const
 	ria->res_path = ria->local_path;
 	//ria->set_local_path( ProjectSettings::get_singleton()->localize_path(p_path) );
 	ria->open(f);
+	if (ria->error == OK && ria->next_tag.name == "ext_resource")
+		ria->_start_prefetch(p_path);
 
 	return ria;
 }
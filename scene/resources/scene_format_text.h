@@ -107,7 +107,10 @@ class ResourceInteractiveLoaderText : public ResourceInteractiveLoader {
 
 	RES resource;
 
+	ResourceLoader::DependencyPrefetch *prefetch;
+
 	Ref<PackedScene> _parse_node_tag(VariantParser::ResourceParser &parser);
+	void _start_prefetch(const String &p_file);
 
 public:
 	virtual void set_local_path(const String &p_local_path);
@@ -947,6 +947,751 @@ void SurfaceTool::generate_normals(bool p_flip) {
 	}
 }
 
+static _FORCE_INLINE_ float _vertex_cache_score(int p_cache_pos, int p_valence) {
+
+	enum {
+		CACHE_SIZE = 32
+	};
+
+	if (p_valence == 0) {
+		return -1.0; //no triangles left to draw with this vertex
+	}
+
+	float score = 0.0;
+	if (p_cache_pos >= 0) {
+		if (p_cache_pos < 3) {
+			score = 0.75; //used by the last triangle, don't favor it too much either
+		} else {
+			score = Math::pow(1.0f - (p_cache_pos - 3) * (1.0f / (CACHE_SIZE - 3)), 1.5f);
+		}
+	}
+
+	//vertices with few triangles left are finished first, so they don't linger
+	return score + 2.0 * Math::pow((float)p_valence, -0.5f);
+}
+
+void SurfaceTool::optimize_vertex_cache(int *r_indices, int p_index_count, int p_vertex_count) {
+
+	// Tom Forsyth's linear speed vertex cache optimization
+
+	enum {
+		CACHE_SIZE = 32
+	};
+
+	int triangle_count = p_index_count / 3;
+	if (triangle_count < 2) {
+		return;
+	}
+
+	Vector<int> valence;
+	Vector<int> offsets;
+	Vector<int> adjacency;
+	Vector<int> cache_pos;
+	Vector<float> vertex_score;
+	Vector<float> triangle_score;
+	Vector<bool> emitted;
+	Vector<int> result;
+
+	valence.resize(p_vertex_count);
+	offsets.resize(p_vertex_count + 1);
+	adjacency.resize(triangle_count * 3);
+	cache_pos.resize(p_vertex_count);
+	vertex_score.resize(p_vertex_count);
+	triangle_score.resize(triangle_count);
+	emitted.resize(triangle_count);
+	result.resize(triangle_count * 3);
+
+	for (int i = 0; i < p_vertex_count; i++) {
+		valence.write[i] = 0;
+		cache_pos.write[i] = -1;
+	}
+	for (int i = 0; i < triangle_count * 3; i++) {
+		ERR_FAIL_INDEX(r_indices[i], p_vertex_count);
+		valence.write[r_indices[i]]++;
+	}
+
+	offsets.write[0] = 0;
+	for (int i = 0; i < p_vertex_count; i++) {
+		offsets.write[i + 1] = offsets[i] + valence[i];
+	}
+
+	{
+		Vector<int> fill = offsets;
+		for (int i = 0; i < triangle_count * 3; i++) {
+			adjacency.write[fill.write[r_indices[i]]++] = i / 3;
+		}
+	}
+
+	for (int i = 0; i < p_vertex_count; i++) {
+		vertex_score.write[i] = _vertex_cache_score(-1, valence[i]);
+	}
+
+	int best = -1;
+	float best_score = -1.0;
+	for (int i = 0; i < triangle_count; i++) {
+		emitted.write[i] = false;
+		triangle_score.write[i] = vertex_score[r_indices[i * 3 + 0]] + vertex_score[r_indices[i * 3 + 1]] + vertex_score[r_indices[i * 3 + 2]];
+		if (triangle_score[i] > best_score) {
+			best_score = triangle_score[i];
+			best = i;
+		}
+	}
+
+	int cache[CACHE_SIZE + 3];
+	int cache_count = 0;
+	int next_unemitted = 0;
+
+	for (int n = 0; n < triangle_count; n++) {
+
+		if (best == -1) {
+			//nothing in the cache is connected to what is left, continue anywhere
+			while (emitted[next_unemitted]) {
+				next_unemitted++;
+			}
+			best = next_unemitted;
+		}
+
+		const int *tri = &r_indices[best * 3];
+		result.write[n * 3 + 0] = tri[0];
+		result.write[n * 3 + 1] = tri[1];
+		result.write[n * 3 + 2] = tri[2];
+		emitted.write[best] = true;
+
+		//the vertices of this triangle go to the front of the cache
+		int new_cache[CACHE_SIZE + 3];
+		int new_count = 0;
+
+		for (int i = 0; i < 3; i++) {
+
+			int v = tri[i];
+			new_cache[new_count++] = v;
+
+			//this triangle no longer counts for the vertex
+			int *adj = &adjacency.write[offsets[v]];
+			int count = valence[v];
+			for (int j = 0; j < count; j++) {
+				if (adj[j] == best) {
+					adj[j] = adj[count - 1];
+					break;
+				}
+			}
+			valence.write[v]--;
+		}
+
+		for (int i = 0; i < cache_count; i++) {
+			int v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2]) {
+				new_cache[new_count++] = v;
+			}
+		}
+
+		for (int i = 0; i < new_count; i++) {
+			int v = new_cache[i];
+			cache_pos.write[v] = i < CACHE_SIZE ? i : -1;
+			vertex_score.write[v] = _vertex_cache_score(cache_pos[v], valence[v]);
+		}
+
+		//only triangles around vertices whose score changed need updating
+		best = -1;
+		best_score = -1.0;
+		for (int i = 0; i < new_count; i++) {
+
+			int v = new_cache[i];
+			const int *adj = &adjacency[offsets[v]];
+			for (int j = 0; j < valence[v]; j++) {
+
+				int t = adj[j];
+				const int *ttri = &r_indices[t * 3];
+				float score = vertex_score[ttri[0]] + vertex_score[ttri[1]] + vertex_score[ttri[2]];
+				triangle_score.write[t] = score;
+				if (score > best_score) {
+					best_score = score;
+					best = t;
+				}
+			}
+		}
+
+		cache_count = MIN(new_count, (int)CACHE_SIZE);
+		for (int i = 0; i < cache_count; i++) {
+			cache[i] = new_cache[i];
+		}
+	}
+
+	for (int i = 0; i < triangle_count * 3; i++) {
+		r_indices[i] = result[i];
+	}
+}
+
+struct _OverdrawCluster {
+
+	int from;
+	int count;
+	float sort_key;
+
+	bool operator<(const _OverdrawCluster &p_cluster) const {
+		return sort_key > p_cluster.sort_key;
+	}
+};
+
+void SurfaceTool::optimize_overdraw(int *r_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count) {
+
+	enum {
+		CACHE_SIZE = 16
+	};
+
+	int triangle_count = p_index_count / 3;
+	if (triangle_count < 2) {
+		return;
+	}
+
+	//split where the cache optimized order restarts (all three vertices missing from a simulated FIFO cache),
+	//which keeps almost all of the cache efficiency when reordering the pieces
+	Vector<int> cache_time;
+	cache_time.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		cache_time.write[i] = -CACHE_SIZE - 1;
+	}
+
+	Vector<_OverdrawCluster> clusters;
+	int time = 0;
+
+	for (int i = 0; i < triangle_count; i++) {
+
+		int misses = 0;
+		for (int j = 0; j < 3; j++) {
+			int v = r_indices[i * 3 + j];
+			ERR_FAIL_INDEX(v, p_vertex_count);
+			if (time - cache_time[v] > CACHE_SIZE) {
+				cache_time.write[v] = time++;
+				misses++;
+			}
+		}
+
+		if (i == 0 || misses == 3) {
+			_OverdrawCluster c;
+			c.from = i;
+			c.count = 0;
+			c.sort_key = 0;
+			clusters.push_back(c);
+		}
+		clusters.write[clusters.size() - 1].count++;
+	}
+
+	if (clusters.size() < 2) {
+		return;
+	}
+
+	Vector3 mesh_center;
+	float mesh_area = 0;
+	for (int i = 0; i < triangle_count; i++) {
+		const Vector3 &a = p_vertices[r_indices[i * 3 + 0]];
+		const Vector3 &b = p_vertices[r_indices[i * 3 + 1]];
+		const Vector3 &c = p_vertices[r_indices[i * 3 + 2]];
+		float area = (b - a).cross(c - a).length();
+		mesh_center += (a + b + c) * (area / 3.0);
+		mesh_area += area;
+	}
+	if (mesh_area > CMP_EPSILON) {
+		mesh_center /= mesh_area;
+	}
+
+	//clusters facing away from the center are drawn first, they are the likeliest to occlude the rest
+	for (int i = 0; i < clusters.size(); i++) {
+
+		_OverdrawCluster &cluster = clusters.write[i];
+
+		Vector3 center;
+		Vector3 normal;
+		float area = 0;
+		for (int j = cluster.from; j < cluster.from + cluster.count; j++) {
+			const Vector3 &a = p_vertices[r_indices[j * 3 + 0]];
+			const Vector3 &b = p_vertices[r_indices[j * 3 + 1]];
+			const Vector3 &c = p_vertices[r_indices[j * 3 + 2]];
+			Vector3 n = (a - c).cross(a - b); //same winding as Plane
+			float tri_area = n.length();
+			center += (a + b + c) * (tri_area / 3.0);
+			normal += n;
+			area += tri_area;
+		}
+
+		if (area > CMP_EPSILON) {
+			center /= area;
+		}
+		cluster.sort_key = (center - mesh_center).dot(normal.normalized());
+	}
+
+	clusters.sort();
+
+	Vector<int> result;
+	result.resize(triangle_count * 3);
+	int ofs = 0;
+	for (int i = 0; i < clusters.size(); i++) {
+		for (int j = clusters[i].from * 3; j < (clusters[i].from + clusters[i].count) * 3; j++) {
+			result.write[ofs++] = r_indices[j];
+		}
+	}
+
+	for (int i = 0; i < triangle_count * 3; i++) {
+		r_indices[i] = result[i];
+	}
+}
+
+int SurfaceTool::optimize_vertex_fetch(int *r_indices, int p_index_count, int p_vertex_count, Vector<int> &r_remap) {
+
+	//number vertices in the order they are first used, so they are fetched linearly
+	r_remap.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		r_remap.write[i] = -1;
+	}
+
+	int next = 0;
+	for (int i = 0; i < p_index_count; i++) {
+		int v = r_indices[i];
+		ERR_FAIL_INDEX_V(v, p_vertex_count, 0);
+		if (r_remap[v] == -1) {
+			r_remap.write[v] = next++;
+		}
+		r_indices[i] = r_remap[v];
+	}
+
+	return next;
+}
+
+template <class T>
+static PoolVector<T> _remap_vertex_array(const PoolVector<T> &p_array, const Vector<int> &p_remap, int p_new_count) {
+
+	int vertex_count = p_remap.size();
+	int stride = p_array.size() / vertex_count;
+
+	PoolVector<T> result;
+	result.resize(p_new_count * stride);
+
+	typename PoolVector<T>::Read r = p_array.read();
+	typename PoolVector<T>::Write w = result.write();
+
+	for (int i = 0; i < vertex_count; i++) {
+		int to = p_remap[i];
+		if (to < 0)
+			continue;
+		for (int j = 0; j < stride; j++) {
+			w[to * stride + j] = r[i * stride + j];
+		}
+	}
+
+	return result;
+}
+
+static Variant _remap_vertex_variant(const Variant &p_array, const Vector<int> &p_remap, int p_new_count) {
+
+	switch (p_array.get_type()) {
+		case Variant::POOL_VECTOR3_ARRAY: return _remap_vertex_array<Vector3>(p_array, p_remap, p_new_count);
+		case Variant::POOL_VECTOR2_ARRAY: return _remap_vertex_array<Vector2>(p_array, p_remap, p_new_count);
+		case Variant::POOL_COLOR_ARRAY: return _remap_vertex_array<Color>(p_array, p_remap, p_new_count);
+		case Variant::POOL_REAL_ARRAY: return _remap_vertex_array<real_t>(p_array, p_remap, p_new_count);
+		case Variant::POOL_INT_ARRAY: return _remap_vertex_array<int>(p_array, p_remap, p_new_count);
+		default: return p_array;
+	}
+}
+
+Array SurfaceTool::optimize_triangle_arrays(const Array &p_arrays, Array *r_blend_shapes) {
+
+	ERR_FAIL_COND_V(p_arrays.size() != Mesh::ARRAY_MAX, p_arrays);
+
+	PoolVector<Vector3> vertices = p_arrays[Mesh::ARRAY_VERTEX];
+	PoolVector<int> indices = p_arrays[Mesh::ARRAY_INDEX];
+
+	int vertex_count = vertices.size();
+	int index_count = indices.size();
+	if (vertex_count == 0 || index_count < 6 || index_count % 3) {
+		return p_arrays;
+	}
+
+	Vector<int> remap;
+	int new_vertex_count;
+	{
+		PoolVector<Vector3>::Read vr = vertices.read();
+		PoolVector<int>::Write iw = indices.write();
+
+		optimize_vertex_cache(iw.ptr(), index_count, vertex_count);
+		optimize_overdraw(iw.ptr(), index_count, vr.ptr(), vertex_count);
+		new_vertex_count = optimize_vertex_fetch(iw.ptr(), index_count, vertex_count, remap);
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+		if (i == Mesh::ARRAY_INDEX) {
+			arrays[i] = indices;
+		} else {
+			arrays[i] = _remap_vertex_variant(p_arrays[i], remap, new_vertex_count);
+		}
+	}
+
+	if (r_blend_shapes) {
+		//blend shapes have the same vertices as the surface
+		Array blend_shapes;
+		for (int i = 0; i < r_blend_shapes->size(); i++) {
+			Array src = (*r_blend_shapes)[i];
+			Array bs;
+			bs.resize(src.size());
+			for (int j = 0; j < src.size(); j++) {
+				bs[j] = j == Mesh::ARRAY_INDEX ? Variant() : _remap_vertex_variant(src[j], remap, new_vertex_count);
+			}
+			blend_shapes.push_back(bs);
+		}
+		*r_blend_shapes = blend_shapes;
+	}
+
+	return arrays;
+}
+
+struct _SimplifyQuadric {
+
+	real_t a00, a11, a22, a10, a20, a21;
+	real_t b0, b1, b2;
+	real_t c;
+	real_t w;
+
+	_FORCE_INLINE_ void add_plane(const Plane &p_plane, real_t p_weight) {
+
+		const Vector3 &n = p_plane.normal;
+		real_t d = -p_plane.d;
+
+		a00 += n.x * n.x * p_weight;
+		a11 += n.y * n.y * p_weight;
+		a22 += n.z * n.z * p_weight;
+		a10 += n.y * n.x * p_weight;
+		a20 += n.z * n.x * p_weight;
+		a21 += n.z * n.y * p_weight;
+		b0 += n.x * d * p_weight;
+		b1 += n.y * d * p_weight;
+		b2 += n.z * d * p_weight;
+		c += d * d * p_weight;
+		w += p_weight;
+	}
+
+	_FORCE_INLINE_ void operator+=(const _SimplifyQuadric &p_q) {
+
+		a00 += p_q.a00;
+		a11 += p_q.a11;
+		a22 += p_q.a22;
+		a10 += p_q.a10;
+		a20 += p_q.a20;
+		a21 += p_q.a21;
+		b0 += p_q.b0;
+		b1 += p_q.b1;
+		b2 += p_q.b2;
+		c += p_q.c;
+		w += p_q.w;
+	}
+
+	//squared distance to the planes, averaged by their weight
+	_FORCE_INLINE_ real_t error(const Vector3 &p_v) const {
+
+		real_t rx = a00 * p_v.x + a10 * p_v.y + a20 * p_v.z;
+		real_t ry = a10 * p_v.x + a11 * p_v.y + a21 * p_v.z;
+		real_t rz = a20 * p_v.x + a21 * p_v.y + a22 * p_v.z;
+		real_t e = p_v.x * rx + p_v.y * ry + p_v.z * rz + 2.0 * (b0 * p_v.x + b1 * p_v.y + b2 * p_v.z) + c;
+		return w > CMP_EPSILON ? ABS(e) / w : ABS(e);
+	}
+
+	_SimplifyQuadric() {
+		a00 = a11 = a22 = a10 = a20 = a21 = b0 = b1 = b2 = c = w = 0;
+	}
+};
+
+struct _SimplifyCollapse {
+
+	int from;
+	int to;
+	real_t error;
+
+	bool operator<(const _SimplifyCollapse &p_collapse) const {
+		return error < p_collapse.error;
+	}
+};
+
+PoolVector<int> SurfaceTool::simplify_indices(const PoolVector<int> &p_indices, const PoolVector<Vector3> &p_vertices, int p_target_index_count, float p_target_error, float *r_error) {
+
+	// quadric error metric edge collapse, vertices only ever move to one of their neighbours,
+	// so the attributes (normals, uvs..) of the remaining vertices stay exact
+
+	int vertex_count = p_vertices.size();
+	int index_count = p_indices.size();
+
+	if (r_error) {
+		*r_error = 0;
+	}
+
+	ERR_FAIL_COND_V(index_count % 3, p_indices);
+	if (index_count <= p_target_index_count || vertex_count == 0) {
+		return p_indices;
+	}
+
+	PoolVector<Vector3>::Read vr = p_vertices.read();
+	const Vector3 *vertices = vr.ptr();
+
+	Vector<int> indices;
+	indices.resize(index_count);
+	{
+		PoolVector<int>::Read ir = p_indices.read();
+		for (int i = 0; i < index_count; i++) {
+			ERR_FAIL_INDEX_V(ir[i], vertex_count, p_indices);
+			indices.write[i] = ir[i];
+		}
+	}
+
+	//vertices split by a seam (same position, different attributes) and vertices on open borders can't move,
+	//otherwise the uv mapping and the silhouette would tear
+	Vector<bool> locked;
+	locked.resize(vertex_count);
+	{
+		Map<Vector3, int> positions;
+		Vector<int> first;
+		first.resize(vertex_count);
+		for (int i = 0; i < vertex_count; i++) {
+			locked.write[i] = false;
+			Map<Vector3, int>::Element *E = positions.find(vertices[i]);
+			if (E) {
+				locked.write[i] = true;
+				locked.write[E->get()] = true;
+			} else {
+				positions.insert(vertices[i], i);
+			}
+		}
+
+		Map<uint64_t, int> edges;
+		for (int i = 0; i < index_count; i += 3) {
+			for (int j = 0; j < 3; j++) {
+				int a = indices[i + j];
+				int b = indices[i + (j + 1) % 3];
+				uint64_t key = (uint64_t(MIN(a, b)) << 32) | uint64_t(MAX(a, b));
+				Map<uint64_t, int>::Element *E = edges.find(key);
+				if (E) {
+					E->get()++;
+				} else {
+					edges.insert(key, 1);
+				}
+			}
+		}
+
+		for (Map<uint64_t, int>::Element *E = edges.front(); E; E = E->next()) {
+			if (E->get() == 1) {
+				locked.write[E->key() >> 32] = true;
+				locked.write[E->key() & 0xFFFFFFFF] = true;
+			}
+		}
+	}
+
+	AABB aabb;
+	Vector<_SimplifyQuadric> quadrics;
+	quadrics.resize(vertex_count);
+
+	for (int i = 0; i < vertex_count; i++) {
+		if (i == 0) {
+			aabb.position = vertices[i];
+		} else {
+			aabb.expand_to(vertices[i]);
+		}
+	}
+
+	for (int i = 0; i < index_count; i += 3) {
+
+		const Vector3 &a = vertices[indices[i + 0]];
+		const Vector3 &b = vertices[indices[i + 1]];
+		const Vector3 &c = vertices[indices[i + 2]];
+
+		Vector3 n = (a - c).cross(a - b);
+		real_t area = n.length();
+		if (area < CMP_EPSILON) {
+			continue;
+		}
+
+		Plane p(a, n / area);
+		for (int j = 0; j < 3; j++) {
+			quadrics.write[indices[i + j]].add_plane(p, area);
+		}
+	}
+
+	real_t extent = MAX(aabb.get_longest_axis_size(), CMP_EPSILON);
+	real_t error_limit = p_target_error * extent;
+	error_limit *= error_limit;
+	real_t result_error = 0;
+
+	Vector<int> remap;
+	Vector<int> tri_offsets;
+	Vector<int> tri_list;
+	Vector<bool> touched;
+	Vector<_SimplifyCollapse> collapses;
+
+	remap.resize(vertex_count);
+	tri_offsets.resize(vertex_count + 1);
+	touched.resize(vertex_count);
+
+	for (int pass = 0; pass < 64 && indices.size() > p_target_index_count; pass++) {
+
+		int tri_count = indices.size() / 3;
+
+		//triangles around each vertex
+		for (int i = 0; i <= vertex_count; i++) {
+			tri_offsets.write[i] = 0;
+		}
+		for (int i = 0; i < indices.size(); i++) {
+			tri_offsets.write[indices[i] + 1]++;
+		}
+		for (int i = 0; i < vertex_count; i++) {
+			tri_offsets.write[i + 1] += tri_offsets[i];
+		}
+		tri_list.resize(indices.size());
+		{
+			Vector<int> fill = tri_offsets;
+			for (int i = 0; i < indices.size(); i++) {
+				tri_list.write[fill.write[indices[i]]++] = i / 3;
+			}
+		}
+
+		collapses.clear();
+		for (int i = 0; i < indices.size(); i += 3) {
+			for (int j = 0; j < 3; j++) {
+
+				int a = indices[i + j];
+				int b = indices[i + (j + 1) % 3];
+
+				//each edge is seen from both triangles, only test it once unless it's on a border
+				if (a > b) {
+					continue;
+				}
+
+				_SimplifyQuadric q = quadrics[a];
+				q += quadrics[b];
+
+				_SimplifyCollapse collapse;
+				collapse.error = 1e20;
+				if (!locked[a]) {
+					collapse.from = a;
+					collapse.to = b;
+					collapse.error = q.error(vertices[b]);
+				}
+				if (!locked[b]) {
+					real_t e = q.error(vertices[a]);
+					if (e < collapse.error) {
+						collapse.from = b;
+						collapse.to = a;
+						collapse.error = e;
+					}
+				}
+
+				if (collapse.error <= error_limit) {
+					collapses.push_back(collapse);
+				}
+			}
+		}
+
+		if (collapses.empty()) {
+			break;
+		}
+
+		collapses.sort();
+
+		for (int i = 0; i < vertex_count; i++) {
+			remap.write[i] = i;
+			touched.write[i] = false;
+		}
+
+		//every collapse removes roughly two triangles
+		int collapse_goal = MAX((tri_count - p_target_index_count / 3) / 2, 1);
+		int collapsed = 0;
+
+		for (int i = 0; i < collapses.size() && collapsed < collapse_goal; i++) {
+
+			const _SimplifyCollapse &collapse = collapses[i];
+			int from = collapse.from;
+			int to = collapse.to;
+
+			if (touched[from] || touched[to]) {
+				continue;
+			}
+
+			//reject collapses that flip any of the remaining triangles
+			bool flips = false;
+			for (int j = tri_offsets[from]; j < tri_offsets[from + 1] && !flips; j++) {
+
+				const int *tri = &indices[tri_list[j] * 3];
+				if (tri[0] == to || tri[1] == to || tri[2] == to) {
+					continue; //will be removed
+				}
+
+				Vector3 p[3] = { vertices[tri[0]], vertices[tri[1]], vertices[tri[2]] };
+				Vector3 n_before = (p[0] - p[2]).cross(p[0] - p[1]);
+				for (int k = 0; k < 3; k++) {
+					if (tri[k] == from) {
+						p[k] = vertices[to];
+					}
+				}
+				Vector3 n_after = (p[0] - p[2]).cross(p[0] - p[1]);
+
+				real_t lb = n_before.length();
+				real_t la = n_after.length();
+				flips = la < CMP_EPSILON || n_before.dot(n_after) < 0.25 * lb * la;
+			}
+
+			if (flips) {
+				continue;
+			}
+
+			remap.write[from] = to;
+			quadrics.write[to] += quadrics[from];
+			result_error = MAX(result_error, collapse.error);
+			collapsed++;
+
+			//the neighbourhood changed, leave it for the next pass
+			for (int j = tri_offsets[from]; j < tri_offsets[from + 1]; j++) {
+				const int *tri = &indices[tri_list[j] * 3];
+				touched.write[tri[0]] = true;
+				touched.write[tri[1]] = true;
+				touched.write[tri[2]] = true;
+			}
+		}
+
+		if (collapsed == 0) {
+			break;
+		}
+
+		//apply the collapses and drop the triangles that became degenerate
+		int write = 0;
+		for (int i = 0; i < indices.size(); i += 3) {
+
+			int a = remap[indices[i + 0]];
+			int b = remap[indices[i + 1]];
+			int c = remap[indices[i + 2]];
+
+			if (a == b || b == c || c == a) {
+				continue;
+			}
+
+			indices.write[write++] = a;
+			indices.write[write++] = b;
+			indices.write[write++] = c;
+		}
+		indices.resize(write);
+	}
+
+	if (r_error) {
+		*r_error = Math::sqrt(result_error) / extent;
+	}
+
+	PoolVector<int> result;
+	result.resize(indices.size());
+	{
+		PoolVector<int>::Write w = result.write();
+		for (int i = 0; i < indices.size(); i++) {
+			w[i] = indices[i];
+		}
+	}
+
+	return result;
+}
+
 void SurfaceTool::set_material(const Ref<Material> &p_material) {
 
 	material = p_material;
@@ -119,6 +119,12 @@ public:
 	void generate_normals(bool p_flip = false);
 	void generate_tangents();
 
+	static void optimize_vertex_cache(int *r_indices, int p_index_count, int p_vertex_count);
+	static void optimize_overdraw(int *r_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count);
+	static int optimize_vertex_fetch(int *r_indices, int p_index_count, int p_vertex_count, Vector<int> &r_remap);
+	static Array optimize_triangle_arrays(const Array &p_arrays, Array *r_blend_shapes = NULL);
+	static PoolVector<int> simplify_indices(const PoolVector<int> &p_indices, const PoolVector<Vector3> &p_vertices, int p_target_index_count, float p_target_error, float *r_error = NULL);
+
 	void add_to_format(int p_flags) { format |= p_flags; }
 
 	void set_material(const Ref<Material> &p_material);
@@ -29,10 +29,14 @@
 /*************************************************************************/
 
 #include "texture.h"
+#include "core/engine.h"
 #include "core/method_bind_ext.gen.inc"
 #include "core/os/os.h"
 #include "core_string_names.h"
 #include "io/image_loader.h"
+#include "project_settings.h"
+#include "safe_refcount.h"
+#include "sort.h"
 
 Size2 Texture::get_size() const {
 
@@ -255,6 +259,13 @@ int ImageTexture::get_height() const {
 	return h;
 }
 
+uint64_t ImageTexture::get_memory_usage() const {
+
+	if (w == 0 || h == 0)
+		return 0;
+	return Image::get_image_data_size(w, h, format, flags & FLAG_MIPMAPS);
+}
+
 RID ImageTexture::get_rid() const {
 
 	return texture;
@@ -407,6 +418,202 @@ StreamTexture::TextureFormatRequestCallback StreamTexture::request_3d_callback =
 StreamTexture::TextureFormatRequestCallback StreamTexture::request_srgb_callback = NULL;
 StreamTexture::TextureFormatRequestCallback StreamTexture::request_normal_callback = NULL;
 
+Mutex *StreamTexture::stream_mutex = NULL;
+SelfList<StreamTexture>::List StreamTexture::streamed_textures;
+bool StreamTexture::streaming_enabled = false;
+int StreamTexture::streaming_initial_size = 256;
+uint64_t StreamTexture::streaming_budget = 0;
+uint64_t StreamTexture::streaming_memory = 0;
+uint64_t StreamTexture::streaming_frame = 0;
+
+void StreamTexture::_stream_requested(void *p_ud, int p_size) {
+
+	//called from the render thread, only keep the largest request until the next update
+	StreamTexture *st = (StreamTexture *)p_ud;
+	atomic_exchange_if_greater(&st->stream_request, (uint32_t)p_size);
+}
+
+void StreamTexture::_stream_load_task(void *p_userdata, uint32_t p_index) {
+
+	StreamLoad *load = (StreamLoad *)p_userdata;
+	int lw, lh, lflags;
+	uint32_t df;
+	load->image.instance();
+	load->error = _load_data(load->path, lw, lh, lflags, df, load->image, load->size_limit);
+}
+
+int StreamTexture::_get_stream_memory(int p_size) const {
+
+	int sw = w;
+	int sh = h;
+	while (sw > p_size || sh > p_size) {
+		sw = MAX(sw >> 1, 1);
+		sh = MAX(sh >> 1, 1);
+	}
+
+	return Image::get_image_data_size(sw, sh, format, true);
+}
+
+void StreamTexture::_stream_begin_load(int p_size) {
+
+	stream_load = memnew(StreamLoad);
+	stream_load->path = path_to_file;
+	stream_load->size_limit = p_size;
+	stream_load->memory = _get_stream_memory(p_size);
+	stream_load->error = OK;
+	stream_load->group = WorkerThreadPool::get_singleton()->add_task(_stream_load_task, stream_load, WorkerThreadPool::PRIORITY_LOW);
+}
+
+void StreamTexture::_stream_apply_load() {
+
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(stream_load->group);
+
+	Ref<Image> image = stream_load->image;
+	Error err = stream_load->error;
+	memdelete(stream_load);
+	stream_load = NULL;
+
+	if (err != OK || image.is_null() || image->empty() || image->get_format() != format) {
+		ERR_PRINTS("Failed streaming texture: " + path_to_file);
+		stream_wanted = stream_size;
+		return;
+	}
+
+	VS::get_singleton()->texture_allocate(texture, image->get_width(), image->get_height(), 0, format, VS::TEXTURE_TYPE_2D, flags | VS::TEXTURE_FLAG_USED_FOR_STREAMING);
+	VS::get_singleton()->texture_set_data(texture, image);
+	VS::get_singleton()->texture_set_size_override(texture, w, h, 0);
+
+	streaming_memory -= stream_memory;
+	stream_memory = image->get_data().size();
+	streaming_memory += stream_memory;
+	stream_size = MAX(image->get_width(), image->get_height());
+}
+
+void StreamTexture::_stream_stop() {
+
+	if (stream_mutex)
+		stream_mutex->lock();
+
+	StreamLoad *load = stream_load;
+	stream_load = NULL;
+
+	if (stream_list.in_list()) {
+		streamed_textures.remove(&stream_list);
+		streaming_memory -= stream_memory;
+		VS::get_singleton()->texture_set_stream_request_callback(texture, NULL, NULL);
+	}
+
+	stream_memory = 0;
+	stream_size = 0;
+	stream_wanted = 0;
+
+	if (stream_mutex)
+		stream_mutex->unlock();
+
+	if (load) {
+		//wait outside the lock, the waiting thread may pick up other loading tasks meanwhile
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(load->group);
+		memdelete(load);
+	}
+}
+
+void StreamTexture::init_streaming() {
+
+#ifndef NO_THREADS
+	stream_mutex = Mutex::create();
+#endif
+
+	streaming_enabled = GLOBAL_GET("rendering/texture_streaming/enabled");
+	streaming_initial_size = MAX(1, int(GLOBAL_GET("rendering/texture_streaming/initial_max_size")));
+	streaming_budget = uint64_t(int(GLOBAL_GET("rendering/texture_streaming/memory_budget_mb"))) * 1024 * 1024;
+}
+
+void StreamTexture::finish_streaming() {
+
+	if (stream_mutex) {
+		memdelete(stream_mutex);
+		stream_mutex = NULL;
+	}
+}
+
+void StreamTexture::update_streaming() {
+
+	if (!streaming_enabled)
+		return;
+
+	if (stream_mutex)
+		stream_mutex->lock();
+
+	streaming_frame++;
+
+	int loading = 0;
+	int64_t pending = 0; //memory that in-flight loads will add (or release)
+	Vector<StreamTexture *> evictable;
+
+	for (SelfList<StreamTexture> *E = streamed_textures.first(); E; E = E->next()) {
+
+		StreamTexture *st = E->self();
+
+		if (st->stream_load) {
+			if (WorkerThreadPool::get_singleton()->is_group_task_completed(st->stream_load->group)) {
+				st->_stream_apply_load();
+			} else {
+				loading++;
+				pending += st->stream_load->memory - st->stream_memory;
+			}
+		}
+
+		uint32_t request = st->stream_request;
+		if (request) {
+			st->stream_request = 0;
+			st->stream_last_used = streaming_frame;
+			int max_size = MAX(st->w, st->h);
+			st->stream_wanted = CLAMP(int(next_power_of_2(request)), MIN(streaming_initial_size, max_size), max_size);
+		}
+
+		if (!st->stream_load && st->stream_size > streaming_initial_size && streaming_frame - st->stream_last_used > STREAM_EVICT_FRAMES) {
+			evictable.push_back(st);
+		}
+	}
+
+	int64_t used = int64_t(streaming_memory) + pending;
+
+	if (used > int64_t(streaming_budget) && evictable.size()) {
+		//over budget, drop the least recently used textures back to their initial size
+		SortArray<StreamTexture *, StreamLRUSort> sorter;
+		sorter.sort(evictable.ptrw(), evictable.size());
+
+		for (int i = 0; i < evictable.size() && used > int64_t(streaming_budget); i++) {
+
+			StreamTexture *st = evictable[i];
+			st->stream_wanted = streaming_initial_size;
+			st->_stream_begin_load(streaming_initial_size);
+			used += st->stream_load->memory - st->stream_memory;
+		}
+	}
+
+	for (SelfList<StreamTexture> *E = streamed_textures.first(); E && loading < MAX_STREAM_LOADS; E = E->next()) {
+
+		StreamTexture *st = E->self();
+
+		if (st->stream_load || st->stream_wanted <= st->stream_size) {
+			continue;
+		}
+
+		int64_t extra = st->_get_stream_memory(st->stream_wanted) - st->stream_memory;
+		if (used + extra > int64_t(streaming_budget)) {
+			continue;
+		}
+
+		st->_stream_begin_load(st->stream_wanted);
+		used += extra;
+		loading++;
+	}
+
+	if (stream_mutex)
+		stream_mutex->unlock();
+}
+
 uint32_t StreamTexture::get_flags() const {
 
 	return flags;
@@ -416,7 +623,7 @@ Image::Format StreamTexture::get_format() const {
 	return format;
 }
 
-Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &flags, Ref<Image> &image, int p_size_limit) {
+Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &flags, uint32_t &r_data_format, Ref<Image> &image, int p_size_limit) {
 
 	ERR_FAIL_COND_V(image.is_null(), ERR_INVALID_PARAMETER);
 
@@ -434,6 +641,7 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &fla
 	th = f->get_32();
 	flags = f->get_32(); //texture flags!
 	uint32_t df = f->get_32(); //data format
+	r_data_format = df;
 
 /*
 	print_line("width: " + itos(tw));
@@ -441,32 +649,6 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &fla
 	print_line("flags: " + itos(flags));
 	print_line("df: " + itos(df));
 	*/
-#ifdef TOOLS_ENABLED
-
-	if (request_3d_callback && df & FORMAT_BIT_DETECT_3D) {
-		//print_line("request detect 3D at " + p_path);
-		VS::get_singleton()->texture_set_detect_3d_callback(texture, _requested_3d, this);
-	} else {
-		//print_line("not requesting detect 3D at " + p_path);
-		VS::get_singleton()->texture_set_detect_3d_callback(texture, NULL, NULL);
-	}
-
-	if (request_srgb_callback && df & FORMAT_BIT_DETECT_SRGB) {
-		//print_line("request detect srgb at " + p_path);
-		VS::get_singleton()->texture_set_detect_srgb_callback(texture, _requested_srgb, this);
-	} else {
-		//print_line("not requesting detect srgb at " + p_path);
-		VS::get_singleton()->texture_set_detect_srgb_callback(texture, NULL, NULL);
-	}
-
-	if (request_srgb_callback && df & FORMAT_BIT_DETECT_NORMAL) {
-		//print_line("request detect srgb at " + p_path);
-		VS::get_singleton()->texture_set_detect_normal_callback(texture, _requested_normal, this);
-	} else {
-		//print_line("not requesting detect normal at " + p_path);
-		VS::get_singleton()->texture_set_detect_normal_callback(texture, NULL, NULL);
-	}
-#endif
 	if (!(df & FORMAT_BIT_STREAM)) {
 		p_size_limit = 0;
 	}
@@ -632,17 +814,99 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &fla
 	return ERR_BUG; //unreachable
 }
 
+Error StreamTexture::_load_header(const String &p_path, int &tw, int &th, int &flags, Image::Format &r_format) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
+
+	uint8_t header[4];
+	f->get_buffer(header, 4);
+	if (header[0] != 'G' || header[1] != 'D' || header[2] != 'S' || header[3] != 'T') {
+		memdelete(f);
+		ERR_FAIL_COND_V(header[0] != 'G' || header[1] != 'D' || header[2] != 'S' || header[3] != 'T', ERR_FILE_CORRUPT);
+	}
+
+	tw = f->get_32();
+	th = f->get_32();
+	flags = f->get_32();
+	uint32_t df = f->get_32();
+
+	memdelete(f);
+
+	if (df & FORMAT_BIT_LOSSLESS || df & FORMAT_BIT_LOSSY) {
+		r_format = Image::FORMAT_RGBA8; //what the embedded PNG/WEBP would decode to
+	} else {
+		r_format = Image::Format(df & FORMAT_MASK_IMAGE_FORMAT);
+	}
+
+	return OK;
+}
+
 Error StreamTexture::load(const String &p_path) {
 
+	_stream_stop();
+
 	int lw, lh, lflags;
+
+	if (Engine::get_singleton()->is_headless()) {
+		//nothing will sample it, keep a size-only stub so layout and scripts still see the right size
+		Image::Format lformat;
+		Error err = _load_header(p_path, lw, lh, lflags, lformat);
+		if (err)
+			return err;
+
+		VS::get_singleton()->texture_allocate(texture, lw, lh, 0, lformat, VS::TEXTURE_TYPE_2D, lflags);
+
+		w = lw;
+		h = lh;
+		flags = lflags;
+		path_to_file = p_path;
+		format = lformat;
+		return OK;
+	}
+
+	uint32_t df;
 	Ref<Image> image;
 	image.instance();
-	Error err = _load_data(p_path, lw, lh, lflags, image);
+	Error err = _load_data(p_path, lw, lh, lflags, df, image, streaming_enabled ? streaming_initial_size : 0);
 	if (err)
 		return err;
 
-	VS::get_singleton()->texture_allocate(texture, image->get_width(), image->get_height(), 0, image->get_format(), VS::TEXTURE_TYPE_2D, lflags);
+#ifdef TOOLS_ENABLED
+
+	if (request_3d_callback && df & FORMAT_BIT_DETECT_3D) {
+		//print_line("request detect 3D at " + p_path);
+		VS::get_singleton()->texture_set_detect_3d_callback(texture, _requested_3d, this);
+	} else {
+		//print_line("not requesting detect 3D at " + p_path);
+		VS::get_singleton()->texture_set_detect_3d_callback(texture, NULL, NULL);
+	}
+
+	if (request_srgb_callback && df & FORMAT_BIT_DETECT_SRGB) {
+		//print_line("request detect srgb at " + p_path);
+		VS::get_singleton()->texture_set_detect_srgb_callback(texture, _requested_srgb, this);
+	} else {
+		//print_line("not requesting detect srgb at " + p_path);
+		VS::get_singleton()->texture_set_detect_srgb_callback(texture, NULL, NULL);
+	}
+
+	if (request_srgb_callback && df & FORMAT_BIT_DETECT_NORMAL) {
+		//print_line("request detect srgb at " + p_path);
+		VS::get_singleton()->texture_set_detect_normal_callback(texture, _requested_normal, this);
+	} else {
+		//print_line("not requesting detect normal at " + p_path);
+		VS::get_singleton()->texture_set_detect_normal_callback(texture, NULL, NULL);
+	}
+#endif
+
+	bool streamed = streaming_enabled && (df & FORMAT_BIT_STREAM) && image->has_mipmaps() && MAX(lw, lh) > streaming_initial_size;
+
+	VS::get_singleton()->texture_allocate(texture, image->get_width(), image->get_height(), 0, image->get_format(), VS::TEXTURE_TYPE_2D, streamed ? lflags | VS::TEXTURE_FLAG_USED_FOR_STREAMING : lflags);
 	VS::get_singleton()->texture_set_data(texture, image);
+	if (image->get_width() != lw || image->get_height() != lh) {
+		//only a smaller mip was loaded, keep reporting the full size
+		VS::get_singleton()->texture_set_size_override(texture, lw, lh, 0);
+	}
 
 	w = lw;
 	h = lh;
@@ -650,6 +914,24 @@ Error StreamTexture::load(const String &p_path) {
 	path_to_file = p_path;
 	format = image->get_format();
 
+	if (streamed) {
+
+		if (stream_mutex)
+			stream_mutex->lock();
+
+		stream_size = MAX(image->get_width(), image->get_height());
+		stream_wanted = stream_size;
+		stream_memory = image->get_data().size();
+		stream_last_used = streaming_frame;
+		streaming_memory += stream_memory;
+		streamed_textures.add(&stream_list);
+
+		if (stream_mutex)
+			stream_mutex->unlock();
+
+		VS::get_singleton()->texture_set_stream_request_callback(texture, _stream_requested, this);
+	}
+
 	return OK;
 }
 String StreamTexture::get_load_path() const {
@@ -665,6 +947,15 @@ int StreamTexture::get_height() const {
 
 	return h;
 }
+
+uint64_t StreamTexture::get_memory_usage() const {
+
+	if (stream_size > 0)
+		return stream_memory; //only what is currently uploaded
+	if (w == 0 || h == 0)
+		return 0;
+	return Image::get_image_data_size(w, h, format, flags & FLAG_MIPMAPS);
+}
 RID StreamTexture::get_rid() const {
 
 	return texture;
@@ -704,7 +995,7 @@ Ref<Image> StreamTexture::get_data() const {
 
 void StreamTexture::set_flags(uint32_t p_flags) {
 	flags = p_flags;
-	VS::get_singleton()->texture_set_flags(texture, flags);
+	VS::get_singleton()->texture_set_flags(texture, stream_list.in_list() ? flags | VS::TEXTURE_FLAG_USED_FOR_STREAMING : flags);
 }
 
 void StreamTexture::reload_from_file() {
@@ -729,18 +1020,27 @@ void StreamTexture::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "load_path", PROPERTY_HINT_FILE, "*.stex"), "load", "get_load_path");
 }
 
-StreamTexture::StreamTexture() {
+StreamTexture::StreamTexture() :
+		stream_list(this) {
 
 	format = Image::FORMAT_MAX;
 	flags = 0;
 	w = 0;
 	h = 0;
 
+	stream_request = 0;
+	stream_last_used = 0;
+	stream_size = 0;
+	stream_wanted = 0;
+	stream_memory = 0;
+	stream_load = NULL;
+
 	texture = VS::get_singleton()->texture_create();
 }
 
 StreamTexture::~StreamTexture() {
 
+	_stream_stop();
 	VS::get_singleton()->free(texture);
 }
 
@@ -36,8 +36,10 @@
 #include "math_2d.h"
 #include "os/mutex.h"
 #include "os/thread_safe.h"
+#include "os/worker_thread_pool.h"
 #include "resource.h"
 #include "scene/resources/color_ramp.h"
+#include "self_list.h"
 #include "servers/visual_server.h"
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
@@ -79,6 +81,8 @@ public:
 
 	virtual Ref<Image> get_data() const { return Ref<Image>(); }
 
+	virtual MemoryCategory get_memory_category() const { return MEMORY_CATEGORY_TEXTURE; }
+
 	Texture();
 };
 
@@ -148,6 +152,8 @@ public:
 
 	virtual void set_path(const String &p_path, bool p_take_over = false);
 
+	virtual uint64_t get_memory_usage() const;
+
 	ImageTexture();
 	~ImageTexture();
 };
@@ -175,7 +181,8 @@ public:
 	};
 
 private:
-	Error _load_data(const String &p_path, int &tw, int &th, int &flags, Ref<Image> &image, int p_size_limit = 0);
+	static Error _load_data(const String &p_path, int &tw, int &th, int &flags, uint32_t &r_data_format, Ref<Image> &image, int p_size_limit = 0);
+	static Error _load_header(const String &p_path, int &tw, int &th, int &flags, Image::Format &r_format);
 	String path_to_file;
 	RID texture;
 	Image::Format format;
@@ -188,6 +195,47 @@ private:
 	static void _requested_srgb(void *p_ud);
 	static void _requested_normal(void *p_ud);
 
+	enum {
+		MAX_STREAM_LOADS = 4,
+		STREAM_EVICT_FRAMES = 60
+	};
+
+	struct StreamLoad {
+		String path;
+		int size_limit;
+		int memory;
+		Ref<Image> image;
+		Error error;
+		WorkerThreadPool::GroupID group;
+	};
+
+	struct StreamLRUSort {
+		_FORCE_INLINE_ bool operator()(const StreamTexture *p_a, const StreamTexture *p_b) const { return p_a->stream_last_used < p_b->stream_last_used; }
+	};
+
+	SelfList<StreamTexture> stream_list;
+	volatile uint32_t stream_request;
+	uint64_t stream_last_used;
+	int stream_size; //largest side currently uploaded
+	int stream_wanted;
+	int stream_memory;
+	StreamLoad *stream_load;
+
+	static Mutex *stream_mutex;
+	static SelfList<StreamTexture>::List streamed_textures;
+	static bool streaming_enabled;
+	static int streaming_initial_size;
+	static uint64_t streaming_budget;
+	static uint64_t streaming_memory;
+	static uint64_t streaming_frame;
+
+	static void _stream_requested(void *p_ud, int p_size);
+	static void _stream_load_task(void *p_userdata, uint32_t p_index);
+	int _get_stream_memory(int p_size) const;
+	void _stream_begin_load(int p_size);
+	void _stream_apply_load();
+	void _stream_stop();
+
 protected:
 	static void _bind_methods();
 
@@ -198,6 +246,10 @@ public:
 	static TextureFormatRequestCallback request_srgb_callback;
 	static TextureFormatRequestCallback request_normal_callback;
 
+	static void init_streaming();
+	static void finish_streaming();
+	static void update_streaming();
+
 	uint32_t get_flags() const;
 	Image::Format get_format() const;
 	Error load(const String &p_path);
@@ -216,6 +268,8 @@ public:
 
 	virtual Ref<Image> get_data() const;
 
+	virtual uint64_t get_memory_usage() const;
+
 	StreamTexture();
 	~StreamTexture();
 };
@@ -30,26 +30,27 @@
 
 #include "world.h"
 
+#include "bvh.h"
 #include "camera_matrix.h"
-#include "octree.h"
 #include "scene/3d/camera.h"
 #include "scene/3d/visibility_notifier.h"
 #include "scene/scene_string_names.h"
 
 struct SpatialIndexer {
 
-	Octree<VisibilityNotifier> octree;
+	BVH<VisibilityNotifier> bvh;
 
 	struct NotifierData {
 
 		AABB aabb;
-		OctreeElementID id;
+		BVHElementID id;
 	};
 
 	Map<VisibilityNotifier *, NotifierData> notifiers;
 	struct CameraData {
 
-		Map<VisibilityNotifier *, uint64_t> notifiers;
+		// notifiers inside the camera frustum, sorted by pointer so each pass is compared with a single merge
+		Vector<VisibilityNotifier *> visible;
 	};
 
 	Map<Camera *, CameraData> cameras;
@@ -59,16 +60,34 @@ struct SpatialIndexer {
 	};
 
 	Vector<VisibilityNotifier *> cull;
+	Vector<VisibilityNotifier *> entered;
+	Vector<VisibilityNotifier *> exited;
 
 	bool changed;
-	uint64_t pass;
 	uint64_t last_frame;
 
+	static int _find_sorted(const Vector<VisibilityNotifier *> &p_vector, VisibilityNotifier *p_notifier) {
+
+		int low = 0;
+		int high = p_vector.size() - 1;
+		while (low <= high) {
+			int middle = (low + high) / 2;
+			if (p_vector[middle] == p_notifier) {
+				return middle;
+			} else if (p_vector[middle] < p_notifier) {
+				low = middle + 1;
+			} else {
+				high = middle - 1;
+			}
+		}
+		return -1;
+	}
+
 	void _notifier_add(VisibilityNotifier *p_notifier, const AABB &p_rect) {
 
 		ERR_FAIL_COND(notifiers.has(p_notifier));
 		notifiers[p_notifier].aabb = p_rect;
-		notifiers[p_notifier].id = octree.create(p_notifier, p_rect);
+		notifiers[p_notifier].id = bvh.create(p_notifier, p_rect, 0, false, 1, 0);
 		changed = true;
 	}
 
@@ -80,7 +99,7 @@ struct SpatialIndexer {
 			return;
 
 		E->get().aabb = p_rect;
-		octree.move(E->get().id, E->get().aabb);
+		bvh.move(E->get().id, E->get().aabb);
 		changed = true;
 	}
 
@@ -89,16 +108,15 @@ struct SpatialIndexer {
 		Map<VisibilityNotifier *, NotifierData>::Element *E = notifiers.find(p_notifier);
 		ERR_FAIL_COND(!E);
 
-		octree.erase(E->get().id);
+		bvh.erase(E->get().id);
 		notifiers.erase(p_notifier);
 
 		List<Camera *> removed;
 		for (Map<Camera *, CameraData>::Element *F = cameras.front(); F; F = F->next()) {
 
-			Map<VisibilityNotifier *, uint64_t>::Element *G = F->get().notifiers.find(p_notifier);
-
-			if (G) {
-				F->get().notifiers.erase(G);
+			int idx = _find_sorted(F->get().visible, p_notifier);
+			if (idx >= 0) {
+				F->get().visible.remove(idx);
 				removed.push_back(F->key());
 			}
 		}
@@ -129,18 +147,12 @@ struct SpatialIndexer {
 
 	void _remove_camera(Camera *p_camera) {
 		ERR_FAIL_COND(!cameras.has(p_camera));
-		List<VisibilityNotifier *> removed;
-		for (Map<VisibilityNotifier *, uint64_t>::Element *E = cameras[p_camera].notifiers.front(); E; E = E->next()) {
+		Vector<VisibilityNotifier *> removed = cameras[p_camera].visible;
+		cameras.erase(p_camera);
 
-			removed.push_back(E->key());
+		for (int i = 0; i < removed.size(); i++) {
+			removed[i]->_exit_camera(p_camera);
 		}
-
-		while (!removed.empty()) {
-			removed.front()->get()->_exit_camera(p_camera);
-			removed.pop_front();
-		}
-
-		cameras.erase(p_camera);
 	}
 
 	void _update(uint64_t p_frame) {
@@ -154,48 +166,50 @@ struct SpatialIndexer {
 
 		for (Map<Camera *, CameraData>::Element *E = cameras.front(); E; E = E->next()) {
 
-			pass++;
-
 			Camera *c = E->key();
 
 			Vector<Plane> planes = c->get_frustum();
 
-			int culled = octree.cull_convex(planes, cull.ptrw(), cull.size());
+			int culled = bvh.cull_convex(planes, cull.ptrw(), cull.size());
 
 			VisibilityNotifier **ptr = cull.ptrw();
+			SortArray<VisibilityNotifier *> sorter;
+			sorter.sort(ptr, culled);
 
-			List<VisibilityNotifier *> added;
-			List<VisibilityNotifier *> removed;
-
-			for (int i = 0; i < culled; i++) {
+			// both lists are sorted, walk them together to find which notifiers entered and exited
+			Vector<VisibilityNotifier *> &visible = E->get().visible;
+			int visible_count = visible.size();
+			const VisibilityNotifier *const *prev = visible.ptr();
 
-				//notifiers in frustum
+			entered.clear();
+			exited.clear();
 
-				Map<VisibilityNotifier *, uint64_t>::Element *H = E->get().notifiers.find(ptr[i]);
-				if (!H) {
+			int i = 0;
+			int j = 0;
+			while (i < culled || j < visible_count) {
 
-					E->get().notifiers.insert(ptr[i], pass);
-					added.push_back(ptr[i]);
+				if (j == visible_count || (i < culled && ptr[i] < prev[j])) {
+					entered.push_back(ptr[i++]);
+				} else if (i == culled || prev[j] < ptr[i]) {
+					exited.push_back(visible[j++]);
 				} else {
-					H->get() = pass;
+					i++;
+					j++;
 				}
 			}
 
-			for (Map<VisibilityNotifier *, uint64_t>::Element *F = E->get().notifiers.front(); F; F = F->next()) {
+			if (entered.empty() && exited.empty())
+				continue;
 
-				if (F->get() != pass)
-					removed.push_back(F->key());
-			}
+			visible.resize(culled);
+			copymem(visible.ptrw(), ptr, culled * sizeof(VisibilityNotifier *));
 
-			while (!added.empty()) {
-				added.front()->get()->_enter_camera(E->key());
-				added.pop_front();
+			for (int k = 0; k < entered.size(); k++) {
+				entered[k]->_enter_camera(c);
 			}
 
-			while (!removed.empty()) {
-				E->get().notifiers.erase(removed.front()->get());
-				removed.front()->get()->_exit_camera(E->key());
-				removed.pop_front();
+			for (int k = 0; k < exited.size(); k++) {
+				exited[k]->_exit_camera(c);
 			}
 		}
 		changed = false;
@@ -203,7 +217,6 @@ struct SpatialIndexer {
 
 	SpatialIndexer() {
 
-		pass = 0;
 		last_frame = 0;
 		changed = false;
 		cull.resize(VISIBILITY_CULL_MAX);
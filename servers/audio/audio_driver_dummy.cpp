@@ -30,6 +30,7 @@
 
 #include "audio_driver_dummy.h"
 
+#include "core/engine.h"
 #include "os/os.h"
 #include "project_settings.h"
 
@@ -49,8 +50,10 @@ Error AudioDriverDummy::init() {
 
 	samples_in = memnew_arr(int32_t, buffer_frames * channels);
 
-	mutex = Mutex::create();
-	thread = Thread::create(AudioDriverDummy::thread_func, this);
+	mutex = Mutex::create(true, "AudioServer::lock");
+	Thread::Settings settings;
+	settings.name = "Audio Mix";
+	thread = Thread::create(AudioDriverDummy::thread_func, this, settings);
 
 	return OK;
 };
@@ -60,6 +63,8 @@ void AudioDriverDummy::thread_func(void *p_udata) {
 	AudioDriverDummy *ad = (AudioDriverDummy *)p_udata;
 
 	uint64_t usdelay = (ad->buffer_frames / float(ad->mix_rate)) * 1000000;
+	// a headless server has nobody listening, only keep the mix clock running
+	bool headless = Engine::get_singleton()->is_headless();
 
 	while (!ad->exit_thread) {
 
@@ -67,7 +72,11 @@ void AudioDriverDummy::thread_func(void *p_udata) {
 
 			ad->lock();
 
-			ad->audio_server_process(ad->buffer_frames, ad->samples_in);
+			if (headless) {
+				ad->update_mix_time(ad->buffer_frames);
+			} else {
+				ad->audio_server_process(ad->buffer_frames, ad->samples_in);
+			}
 
 			ad->unlock();
 		};
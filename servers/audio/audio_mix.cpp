@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  audio_mix.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "audio_mix.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AUDIO_MIX_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_MIX_NEON
+#endif
+
+void audio_mix_add(AudioFrame *p_dst, const AudioFrame *p_src, int p_frames) {
+
+	int i = 0;
+
+#if defined(AUDIO_MIX_SSE)
+	float *dst = (float *)p_dst;
+	const float *src = (const float *)p_src;
+	for (; i + 2 <= p_frames; i += 2) {
+		_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_loadu_ps(dst + i * 2), _mm_loadu_ps(src + i * 2)));
+	}
+#elif defined(AUDIO_MIX_NEON)
+	float *dst = (float *)p_dst;
+	const float *src = (const float *)p_src;
+	for (; i + 2 <= p_frames; i += 2) {
+		vst1q_f32(dst + i * 2, vaddq_f32(vld1q_f32(dst + i * 2), vld1q_f32(src + i * 2)));
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		p_dst[i] += p_src[i];
+	}
+}
+
+void audio_mix_add_ramp(AudioFrame *p_dst, const AudioFrame *p_src, int p_frames, const AudioFrame &p_vol, const AudioFrame &p_vol_inc) {
+
+	int i = 0;
+
+#if defined(AUDIO_MIX_SSE)
+	float *dst = (float *)p_dst;
+	const float *src = (const float *)p_src;
+	__m128 v_vol = _mm_setr_ps(p_vol.l, p_vol.r, p_vol.l + p_vol_inc.l, p_vol.r + p_vol_inc.r);
+	__m128 v_inc = _mm_setr_ps(p_vol_inc.l * 2.0, p_vol_inc.r * 2.0, p_vol_inc.l * 2.0, p_vol_inc.r * 2.0);
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(src + i * 2), v_vol);
+		_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_loadu_ps(dst + i * 2), s));
+		v_vol = _mm_add_ps(v_vol, v_inc);
+	}
+#elif defined(AUDIO_MIX_NEON)
+	float *dst = (float *)p_dst;
+	const float *src = (const float *)p_src;
+	float vol_init[4] = { p_vol.l, p_vol.r, p_vol.l + p_vol_inc.l, p_vol.r + p_vol_inc.r };
+	float inc_init[4] = { p_vol_inc.l * 2.0f, p_vol_inc.r * 2.0f, p_vol_inc.l * 2.0f, p_vol_inc.r * 2.0f };
+	float32x4_t v_vol = vld1q_f32(vol_init);
+	float32x4_t v_inc = vld1q_f32(inc_init);
+	for (; i + 2 <= p_frames; i += 2) {
+		vst1q_f32(dst + i * 2, vmlaq_f32(vld1q_f32(dst + i * 2), vld1q_f32(src + i * 2), v_vol));
+		v_vol = vaddq_f32(v_vol, v_inc);
+	}
+#endif
+
+	AudioFrame vol = p_vol + p_vol_inc * float(i);
+	for (; i < p_frames; i++) {
+		p_dst[i] += p_src[i] * vol;
+		vol += p_vol_inc;
+	}
+}
+
+void audio_mix_gain_ramp(AudioFrame *p_buffer, int p_frames, float p_vol, float p_vol_inc) {
+
+	int i = 0;
+
+#if defined(AUDIO_MIX_SSE)
+	float *buf = (float *)p_buffer;
+	__m128 v_vol = _mm_setr_ps(p_vol, p_vol, p_vol + p_vol_inc, p_vol + p_vol_inc);
+	__m128 v_inc = _mm_set1_ps(p_vol_inc * 2.0);
+	for (; i + 2 <= p_frames; i += 2) {
+		_mm_storeu_ps(buf + i * 2, _mm_mul_ps(_mm_loadu_ps(buf + i * 2), v_vol));
+		v_vol = _mm_add_ps(v_vol, v_inc);
+	}
+#elif defined(AUDIO_MIX_NEON)
+	float *buf = (float *)p_buffer;
+	float vol_init[4] = { p_vol, p_vol, p_vol + p_vol_inc, p_vol + p_vol_inc };
+	float32x4_t v_vol = vld1q_f32(vol_init);
+	float32x4_t v_inc = vdupq_n_f32(p_vol_inc * 2.0f);
+	for (; i + 2 <= p_frames; i += 2) {
+		vst1q_f32(buf + i * 2, vmulq_f32(vld1q_f32(buf + i * 2), v_vol));
+		v_vol = vaddq_f32(v_vol, v_inc);
+	}
+#endif
+
+	float vol = p_vol + p_vol_inc * float(i);
+	for (; i < p_frames; i++) {
+		p_buffer[i] *= vol;
+		vol += p_vol_inc;
+	}
+}
+
+AudioFrame audio_mix_gain_peak(AudioFrame *p_buffer, int p_frames, float p_gain) {
+
+	AudioFrame peak = AudioFrame(0, 0);
+	int i = 0;
+
+#if defined(AUDIO_MIX_SSE)
+	float *buf = (float *)p_buffer;
+	__m128 gain = _mm_set1_ps(p_gain);
+	__m128 sign_mask = _mm_set1_ps(-0.0f);
+	__m128 vpeak = _mm_setzero_ps();
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(buf + i * 2), gain);
+		_mm_storeu_ps(buf + i * 2, s);
+		vpeak = _mm_max_ps(vpeak, _mm_andnot_ps(sign_mask, s));
+	}
+	float peaks[4];
+	_mm_storeu_ps(peaks, vpeak);
+	peak.l = MAX(peaks[0], peaks[2]);
+	peak.r = MAX(peaks[1], peaks[3]);
+#elif defined(AUDIO_MIX_NEON)
+	float *buf = (float *)p_buffer;
+	float32x4_t vpeak = vdupq_n_f32(0);
+	for (; i + 2 <= p_frames; i += 2) {
+		float32x4_t s = vmulq_n_f32(vld1q_f32(buf + i * 2), p_gain);
+		vst1q_f32(buf + i * 2, s);
+		vpeak = vmaxq_f32(vpeak, vabsq_f32(s));
+	}
+	float peaks[4];
+	vst1q_f32(peaks, vpeak);
+	peak.l = MAX(peaks[0], peaks[2]);
+	peak.r = MAX(peaks[1], peaks[3]);
+#endif
+
+	for (; i < p_frames; i++) {
+
+		p_buffer[i] *= p_gain;
+
+		float l = ABS(p_buffer[i].l);
+		if (l > peak.l) {
+			peak.l = l;
+		}
+		float r = ABS(p_buffer[i].r);
+		if (r > peak.r) {
+			peak.r = r;
+		}
+	}
+
+	return peak;
+}
@@ -0,0 +1,52 @@
+/*************************************************************************/
+/*  audio_mix.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef AUDIO_MIX_H
+#define AUDIO_MIX_H
+
+#include "core/math/audio_frame.h"
+
+// Buffer operations used by the mixer and the stream players. AudioFrame
+// buffers are interleaved float pairs, so these work on two frames per
+// SSE or NEON register when available, and fall back to plain loops.
+
+// p_dst[i] += p_src[i]
+void audio_mix_add(AudioFrame *p_dst, const AudioFrame *p_src, int p_frames);
+
+// p_dst[i] += p_src[i] * (p_vol + p_vol_inc * i)
+void audio_mix_add_ramp(AudioFrame *p_dst, const AudioFrame *p_src, int p_frames, const AudioFrame &p_vol, const AudioFrame &p_vol_inc);
+
+// p_buffer[i] *= p_vol + p_vol_inc * i
+void audio_mix_gain_ramp(AudioFrame *p_buffer, int p_frames, float p_vol, float p_vol_inc);
+
+// p_buffer[i] *= p_gain, returns the absolute peak of the result
+AudioFrame audio_mix_gain_peak(AudioFrame *p_buffer, int p_frames, float p_gain);
+
+#endif // AUDIO_MIX_H
@@ -32,6 +32,21 @@
 
 //////////////////////////////
 
+void AudioStreamPlayback::advance(float p_time) {
+
+	//generic fallback, mixes and discards the audio. streams that can move
+	//their position without decoding should override this.
+	AudioFrame buffer[256];
+
+	int todo = int(p_time * AudioServer::get_singleton()->get_mix_rate());
+
+	while (todo > 0 && is_playing()) {
+		int to_mix = MIN(todo, 256);
+		mix(buffer, 1.0, to_mix);
+		todo -= to_mix;
+	}
+}
+
 void AudioStreamPlaybackResampled::_begin_resample() {
 
 	//clear cubic interpolation history
@@ -50,26 +65,46 @@ void AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 
 	uint64_t mix_increment = uint64_t(((get_stream_sampling_rate() * p_rate_scale) / double(target_rate)) * double(FP_LEN));
 
-	for (int i = 0; i < p_frames; i++) {
+	const uint64_t mix_limit = uint64_t(INTERNAL_BUFFER_LEN) << FP_BITS;
+
+	int i = 0;
+	while (i < p_frames) {
+
+		//amount of frames that can be interpolated before the internal buffer needs to be refilled,
+		//so the inner loop does not have to check for it
+		int todo = p_frames - i;
+		if (mix_increment > 0) {
+			uint64_t avail = (mix_limit - mix_offset + mix_increment - 1) / mix_increment;
+			if (avail < uint64_t(todo)) {
+				todo = int(avail);
+			}
+		}
+
+		AudioFrame *dst = p_buffer + i;
+
+		for (int j = 0; j < todo; j++) {
 
-		uint32_t idx = CUBIC_INTERP_HISTORY + uint32_t(mix_offset >> FP_BITS);
-		//standard cubic interpolation (great quality/performance ratio)
-		//this used to be moved to a LUT for greater performance, but nowadays CPU speed is generally faster than memory.
-		float mu = (mix_offset & FP_MASK) / float(FP_LEN);
-		AudioFrame y0 = internal_buffer[idx - 3];
-		AudioFrame y1 = internal_buffer[idx - 2];
-		AudioFrame y2 = internal_buffer[idx - 1];
-		AudioFrame y3 = internal_buffer[idx - 0];
+			uint32_t idx = CUBIC_INTERP_HISTORY + uint32_t(mix_offset >> FP_BITS);
+			//standard cubic interpolation (great quality/performance ratio)
+			//this used to be moved to a LUT for greater performance, but nowadays CPU speed is generally faster than memory.
+			float mu = (mix_offset & FP_MASK) / float(FP_LEN);
+			AudioFrame y0 = internal_buffer[idx - 3];
+			AudioFrame y1 = internal_buffer[idx - 2];
+			AudioFrame y2 = internal_buffer[idx - 1];
+			AudioFrame y3 = internal_buffer[idx - 0];
 
-		float mu2 = mu * mu;
-		AudioFrame a0 = y3 - y2 - y0 + y1;
-		AudioFrame a1 = y0 - y1 - a0;
-		AudioFrame a2 = y2 - y0;
-		AudioFrame a3 = y1;
+			float mu2 = mu * mu;
+			AudioFrame a0 = y3 - y2 - y0 + y1;
+			AudioFrame a1 = y0 - y1 - a0;
+			AudioFrame a2 = y2 - y0;
+			AudioFrame a3 = y1;
 
-		p_buffer[i] = (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3);
+			dst[j] = (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3);
+
+			mix_offset += mix_increment;
+		}
 
-		mix_offset += mix_increment;
+		i += todo;
 
 		while ((mix_offset >> FP_BITS) >= INTERNAL_BUFFER_LEN) {
 
@@ -81,9 +116,7 @@ void AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 				_mix_internal(internal_buffer + 4, INTERNAL_BUFFER_LEN);
 			} else {
 				//fill with silence, not playing
-				for (int i = 0; i < INTERNAL_BUFFER_LEN; ++i) {
-					internal_buffer[i + 4] = AudioFrame(0, 0);
-				}
+				zeromem(internal_buffer + 4, INTERNAL_BUFFER_LEN * sizeof(AudioFrame));
 			}
 			mix_offset -= (INTERNAL_BUFFER_LEN << FP_BITS);
 		}
@@ -225,6 +258,12 @@ void AudioStreamPlaybackRandomPitch::mix(AudioFrame *p_buffer, float p_rate_scal
 	}
 }
 
+void AudioStreamPlaybackRandomPitch::advance(float p_time) {
+	if (playing.is_valid()) {
+		playing->advance(p_time * pitch_scale);
+	}
+}
+
 AudioStreamPlaybackRandomPitch::~AudioStreamPlaybackRandomPitch() {
 	random_pitch->playbacks.erase(this);
 }
@@ -51,6 +51,8 @@ public:
 	virtual void seek(float p_time) = 0;
 
 	virtual void mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) = 0;
+
+	virtual void advance(float p_time); //move the position forward as if mixed, used by virtual voices
 };
 
 class AudioStreamPlaybackResampled : public AudioStreamPlayback {
@@ -92,6 +94,8 @@ public:
 	virtual String get_stream_name() const = 0;
 
 	virtual float get_length() const = 0; //if supported, otherwise return 0
+
+	virtual MemoryCategory get_memory_category() const { return MEMORY_CATEGORY_AUDIO; }
 };
 
 class AudioStreamPlaybackRandomPitch;
@@ -144,6 +148,7 @@ public:
 	virtual void seek(float p_time);
 
 	virtual void mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames);
+	virtual void advance(float p_time);
 
 	~AudioStreamPlaybackRandomPitch();
 };
@@ -32,8 +32,11 @@
 #include "io/resource_loader.h"
 #include "os/file_access.h"
 #include "os/os.h"
+#include "os/trace.h"
+#include "os/worker_thread_pool.h"
 #include "project_settings.h"
 #include "servers/audio/audio_driver_dummy.h"
+#include "servers/audio/audio_mix.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
 #ifdef TOOLS_ENABLED
 
@@ -186,6 +189,9 @@ AudioDriver *AudioDriverManager::get_driver(int p_driver) {
 
 void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 
+	MemoryTagScope tag(Memory::TAG_AUDIO);
+	TRACE_SCOPE("AudioServer::mix");
+
 	int todo = p_frames;
 
 #ifdef DEBUG_ENABLED
@@ -255,6 +261,129 @@ void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 #endif
 }
 
+bool AudioServer::_bus_uses_other_buses(const Bus *p_bus) const {
+
+	if (p_bus->bypass)
+		return false;
+
+	for (int i = 0; i < p_bus->effects.size(); i++) {
+
+		if (!p_bus->effects[i].enabled)
+			continue;
+
+		// sidechains read (and may clear) the buffers of another bus
+		const AudioEffectCompressor *compressor = Object::cast_to<AudioEffectCompressor>(p_bus->effects[i].effect.ptr());
+		if (compressor && compressor->get_sidechain() != StringName()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void AudioServer::_mix_step_bus(Bus *p_bus) {
+
+	Bus *bus = p_bus;
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+
+		if (bus->channels[k].active && !bus->channels[k].used) {
+			//buffer was not used, but it's still active, so it must be cleaned
+			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+			zeromem(buf, buffer_size * sizeof(AudioFrame));
+		}
+	}
+
+	//process effects
+	if (!bus->bypass) {
+		for (int j = 0; j < bus->effects.size(); j++) {
+
+			if (!bus->effects[j].enabled)
+				continue;
+
+#ifdef DEBUG_ENABLED
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
+
+			for (int k = 0; k < bus->channels.size(); k++) {
+
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
+					continue;
+				bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), bus->channels.write[k].temp_buffer.ptrw(), buffer_size);
+			}
+
+			//swap buffers, so internal buffer always has the right data
+			for (int k = 0; k < bus->channels.size(); k++) {
+
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
+					continue;
+				SWAP(bus->channels.write[k].buffer, bus->channels.write[k].temp_buffer);
+			}
+
+#ifdef DEBUG_ENABLED
+			bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+#endif
+		}
+	}
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+
+		if (!bus->channels[k].active)
+			continue;
+
+		AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+
+		float volume = Math::db2linear(bus->volume_db);
+
+		if (mix_solo_mode) {
+			if (!bus->soloed) {
+				volume = 0.0;
+			}
+		} else {
+			if (bus->mute) {
+				volume = 0.0;
+			}
+		}
+
+		//apply volume and compute peak
+		AudioFrame peak = audio_mix_gain_peak(buf, buffer_size, volume);
+
+		bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + 0.0000000001), Math::linear2db(peak.r + 0.0000000001));
+
+		if (!bus->channels[k].used) {
+			//see if any audio is contained, because channel was not used
+
+			if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
+				bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				bus->channels.write[k].active = false; //went inactive, don't mix.
+			}
+		}
+	}
+}
+
+void AudioServer::_mix_step_send(Bus *p_bus) {
+
+	if (p_bus->send_index_cache < 0)
+		return; //master
+
+	for (int k = 0; k < p_bus->channels.size(); k++) {
+
+		if (!p_bus->channels[k].active)
+			continue;
+
+		//if not master bus, send
+		AudioFrame *target_buf = thread_get_channel_mix_buffer(p_bus->send_index_cache, k);
+		audio_mix_add(target_buf, p_bus->channels[k].buffer.ptr(), buffer_size);
+	}
+}
+
+void AudioServer::_mix_step_bus_task(void *p_userdata, uint32_t p_index) {
+
+	AudioServer *self = (AudioServer *)p_userdata;
+	self->_mix_step_bus(self->mix_wave_parallel[p_index]);
+}
+
 void AudioServer::_mix_step() {
 
 	bool solo_mode = false;
@@ -302,127 +431,73 @@ void AudioServer::_mix_step() {
 		E->get().callback(E->get().userdata);
 	}
 
-	for (int i = buses.size() - 1; i >= 0; i--) {
-		//go bus by bus
-		Bus *bus = buses[i];
-
-		for (int k = 0; k < bus->channels.size(); k++) {
-
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				//buffer was not used, but it's still active, so it must be cleaned
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
-
-				for (uint32_t j = 0; j < buffer_size; j++) {
-
-					buf[j] = AudioFrame(0, 0);
-				}
-			}
-		}
-
-		//process effects
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
-
-				if (!bus->effects[j].enabled)
-					continue;
-
-#ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
-#endif
-
-				for (int k = 0; k < bus->channels.size(); k++) {
-
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
-						continue;
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
-				}
-
-				//swap buffers, so internal buffer always has the right data
-				for (int k = 0; k < bus->channels.size(); k++) {
-
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
-						continue;
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
-				}
-
-#ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
-#endif
-			}
-		}
+	// a bus only sends to a bus with a lower index (anything else goes to master), so it can be
+	// processed as soon as every bus sending to it is done. buses at the same distance from master
+	// don't depend on each other, which allows processing their effects in parallel.
+	int max_depth = 0;
 
-		//process send
+	for (int i = 0; i < buses.size(); i++) {
+		Bus *bus = buses[i];
 
-		Bus *send = NULL;
+		bus->send_index_cache = -1;
+		bus->depth_cache = 0;
 
 		if (i > 0) {
 			//everything has a send save for master bus
-			if (!bus_map.has(bus->send)) {
-				send = buses[0];
-			} else {
-				send = bus_map[bus->send];
-				if (send->index_cache >= bus->index_cache) { //invalid, send to master
-					send = buses[0];
+			bus->send_index_cache = 0;
+			if (bus_map.has(bus->send)) {
+				Bus *send = bus_map[bus->send];
+				if (send->index_cache < bus->index_cache) { //otherwise invalid, send to master
+					bus->send_index_cache = send->index_cache;
 				}
 			}
+
+			bus->depth_cache = buses[bus->send_index_cache]->depth_cache + 1;
+			max_depth = MAX(max_depth, bus->depth_cache);
 		}
+	}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
+	mix_solo_mode = solo_mode;
 
-			if (!bus->channels[k].active)
-				continue;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
 
-			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+	for (int depth = max_depth; depth >= 0; depth--) {
 
-			AudioFrame peak = AudioFrame(0, 0);
+		mix_wave_parallel.clear();
+		mix_wave_serial.clear();
 
-			float volume = Math::db2linear(bus->volume_db);
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			Bus *bus = buses[i];
+			if (bus->depth_cache != depth)
+				continue;
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
+			if (_bus_uses_other_buses(bus)) {
+				mix_wave_serial.push_back(bus);
 			} else {
-				if (bus->mute) {
-					volume = 0.0;
-				}
+				mix_wave_parallel.push_back(bus);
 			}
+		}
 
-			//apply volume and compute peak
-			for (uint32_t j = 0; j < buffer_size; j++) {
-
-				buf[j] *= volume;
-
-				float l = ABS(buf[j].l);
-				if (l > peak.l) {
-					peak.l = l;
-				}
-				float r = ABS(buf[j].r);
-				if (r > peak.r) {
-					peak.r = r;
-				}
-			}
-
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + 0.0000000001), Math::linear2db(peak.r + 0.0000000001));
-
-			if (!bus->channels[k].used) {
-				//see if any audio is contained, because channel was not used
+		int parallel_count = mix_wave_parallel.size();
 
-				if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
-				}
+		// the mix thread helps processing while it waits, so this never takes longer than doing it serially
+		if (pool && pool->get_thread_count() > 0 && parallel_count > 1) {
+			WorkerThreadPool::GroupID group = pool->add_group_task(_mix_step_bus_task, this, parallel_count, WorkerThreadPool::PRIORITY_HIGH);
+			pool->wait_for_group_task_completion(group);
+		} else {
+			for (int i = 0; i < parallel_count; i++) {
+				_mix_step_bus(mix_wave_parallel[i]);
 			}
+		}
 
-			if (send) {
-				//if not master bus, send
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+		for (int i = 0; i < mix_wave_serial.size(); i++) {
+			_mix_step_bus(mix_wave_serial[i]);
+		}
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
-				}
+		//sends write to shared buffers of the next wave, do them from this thread in bus order
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			if (buses[i]->depth_cache == depth) {
+				_mix_step_send(buses[i]);
 			}
 		}
 	}
@@ -510,6 +585,7 @@ void AudioServer::set_bus_count(int p_count) {
 		buses.write[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		buses[i]->name = attempt;
 		buses[i]->solo = false;
@@ -582,6 +658,7 @@ void AudioServer::add_bus(int p_at_pos) {
 	bus->channels.resize(channel_count);
 	for (int j = 0; j < channel_count; j++) {
 		bus->channels.write[j].buffer.resize(buffer_size);
+		bus->channels.write[j].temp_buffer.resize(buffer_size);
 	}
 	bus->name = attempt;
 	bus->solo = false;
@@ -887,16 +964,12 @@ bool AudioServer::is_bus_channel_active(int p_bus, int p_channel) const {
 
 void AudioServer::init_channels_and_buffers() {
 	channel_count = get_channel_count();
-	temp_buffer.resize(channel_count);
-
-	for (int i = 0; i < temp_buffer.size(); i++) {
-		temp_buffer.write[i].resize(buffer_size);
-	}
 
 	for (int i = 0; i < buses.size(); i++) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 	}
 }
@@ -905,6 +978,8 @@ void AudioServer::init() {
 
 	channel_disable_threshold_db = GLOBAL_DEF_RST("audio/channel_disable_threshold_db", -60.0);
 	channel_disable_frames = float(GLOBAL_DEF_RST("audio/channel_disable_time", 2.0)) * get_mix_rate();
+	GLOBAL_DEF("audio/3d/max_voices", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/3d/max_voices", PropertyInfo(Variant::INT, "audio/3d/max_voices", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"));
 	buffer_size = 1024; //hardcoded for now
 
 	init_channels_and_buffers();
@@ -1151,6 +1226,7 @@ void AudioServer::set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		_update_bus_effects(i);
 	}
@@ -1266,7 +1342,7 @@ AudioServer::AudioServer() {
 	singleton = this;
 	audio_data_total_mem = 0;
 	audio_data_max_mem = 0;
-	audio_data_lock = Mutex::create();
+	audio_data_lock = Mutex::create(true, "AudioServer::audio_data");
 	mix_frames = 0;
 	channel_count = 0;
 	to_mix = 0;
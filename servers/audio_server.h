@@ -173,6 +173,7 @@ private:
 			bool active;
 			AudioFrame peak_volume;
 			Vector<AudioFrame> buffer;
+			Vector<AudioFrame> temp_buffer; //effects write here, then it's swapped with buffer
 			Vector<Ref<AudioEffectInstance> > effect_instances;
 			uint64_t last_mix_with_audio;
 			Channel() {
@@ -197,9 +198,10 @@ private:
 		float volume_db;
 		StringName send;
 		int index_cache;
+		int send_index_cache; //-1 for master
+		int depth_cache; //sends needed to reach master
 	};
 
-	Vector<Vector<AudioFrame> > temp_buffer; //temp_buffer for each level
 	Vector<Bus *> buses;
 	Map<StringName, Bus *> bus_map;
 
@@ -222,6 +224,15 @@ private:
 
 	void _mix_step();
 
+	bool mix_solo_mode;
+	Vector<Bus *> mix_wave_parallel;
+	Vector<Bus *> mix_wave_serial;
+
+	bool _bus_uses_other_buses(const Bus *p_bus) const;
+	void _mix_step_bus(Bus *p_bus);
+	void _mix_step_send(Bus *p_bus);
+	static void _mix_step_bus_task(void *p_userdata, uint32_t p_index);
+
 	struct CallbackItem {
 
 		AudioCallback callback;
@@ -59,6 +59,8 @@ class AreaSW : public CollisionObjectSW {
 	ObjectID area_monitor_callback_id;
 	StringName area_monitor_callback_method;
 
+	bool monitor_batching;
+
 	SelfList<AreaSW> monitor_query_list;
 	SelfList<AreaSW> moved_list;
 
@@ -105,6 +107,7 @@ class AreaSW : public CollisionObjectSW {
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
+	void _call_monitor_batch(Object *p_receiver, const StringName &p_method, const Map<BodyKey, BodyState> &p_monitored);
 
 public:
 	//_FORCE_INLINE_ const Transform& get_inverse_transform() const { return inverse_transform; }
@@ -116,6 +119,9 @@ public:
 	void set_area_monitor_callback(ObjectID p_id, const StringName &p_method);
 	_FORCE_INLINE_ bool has_area_monitor_callback() const { return area_monitor_callback_id; }
 
+	_FORCE_INLINE_ void set_monitor_batching(bool p_enable) { monitor_batching = p_enable; }
+	_FORCE_INLINE_ bool is_monitor_batching() const { return monitor_batching; }
+
 	_FORCE_INLINE_ void add_body_to_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 	_FORCE_INLINE_ void remove_body_from_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 
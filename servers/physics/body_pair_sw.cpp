@@ -48,6 +48,8 @@
 #define RELAXATION_TIMESTEPS 3
 #define MIN_VELOCITY 0.0001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
+#define MANIFOLD_MAX_DRIFT 0.0005
+#define MANIFOLD_MAX_ROTATION 0.0005
 
 void BodyPairSW::_contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata) {
 
@@ -211,6 +213,89 @@ bool BodyPairSW::_test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Tran
 	return true;
 }
 
+bool BodyPairSW::_setup_speculative(real_t p_step, const ShapeSW *p_shape_A, const Transform &p_xform_A, const ShapeSW *p_shape_B, const Transform &p_xform_B) {
+
+	bool complex_A = p_shape_A->is_concave() || p_shape_A->get_type() == PhysicsServer::SHAPE_PLANE;
+	bool complex_B = p_shape_B->is_concave() || p_shape_B->get_type() == PhysicsServer::SHAPE_PLANE;
+	if (complex_A && complex_B)
+		return false; //no distance query between these
+
+	Vector3 offset_A = A->get_transform().get_origin();
+	Vector3 point_A, point_B;
+
+	//the convex shape goes first, concave ones are culled with its motion-expanded bounds
+	if (complex_A) {
+		AABB hint = B->get_shape_aabb(shape_B);
+		hint.position -= offset_A;
+		if (!CollisionSolverSW::solve_distance(p_shape_B, p_xform_B, p_shape_A, p_xform_A, point_B, point_A, hint))
+			return false;
+	} else {
+		AABB hint = A->get_shape_aabb(shape_A);
+		hint.position -= offset_A;
+		if (!CollisionSolverSW::solve_distance(p_shape_A, p_xform_A, p_shape_B, p_xform_B, point_A, point_B, hint))
+			return false;
+	}
+
+	Vector3 gap = point_B - point_A;
+	real_t distance = gap.length();
+	if (distance < CMP_EPSILON)
+		return true; //touching, regular contacts take over next step
+
+	Vector3 normal = gap / distance;
+	Vector3 rA = point_A - A->get_center_of_mass();
+	Vector3 rB = point_B - B->get_center_of_mass() - offset_B;
+
+	Vector3 crA = A->get_angular_velocity().cross(rA);
+	Vector3 crB = B->get_angular_velocity().cross(rB);
+	Vector3 dv = B->get_linear_velocity() + crB - A->get_linear_velocity() - crA;
+
+	//rotation is only linearized at the closest points, leave room for the arc the shapes can sweep
+	real_t rotation_slack = (A->get_angular_velocity().length() * A->get_shape_aabb(shape_A).size.length() + B->get_angular_velocity().length() * B->get_shape_aabb(shape_B).size.length()) * 0.5;
+
+	if ((rotation_slack - dv.dot(normal)) * p_step < distance)
+		return true; //can't meet during this step
+
+	Vector3 inertia_A = A->get_inv_inertia_tensor().xform(rA.cross(normal));
+	Vector3 inertia_B = B->get_inv_inertia_tensor().xform(rB.cross(normal));
+	real_t kNormal = A->get_inv_mass() + B->get_inv_mass();
+	kNormal += normal.dot(inertia_A.cross(rA)) + normal.dot(inertia_B.cross(rB));
+
+	speculative.active = true;
+	speculative.normal = normal;
+	speculative.rA = rA;
+	speculative.rB = rB;
+	speculative.mass_normal = 1.0f / kNormal;
+	speculative.gap_velocity = distance / p_step;
+	speculative.acc_normal_impulse = 0;
+
+#ifdef DEBUG_ENABLED
+	if (space->is_debugging_contacts()) {
+		space->add_debug_contact(point_A + offset_A);
+		space->add_debug_contact(point_B + offset_A);
+	}
+#endif
+
+	return true;
+}
+
+void BodyPairSW::_solve_speculative() {
+
+	SpeculativeContact &s = speculative;
+
+	Vector3 crA = A->get_angular_velocity().cross(s.rA);
+	Vector3 crB = B->get_angular_velocity().cross(s.rB);
+	Vector3 dv = B->get_linear_velocity() + crB - A->get_linear_velocity() - crA;
+
+	real_t jn = -(dv.dot(s.normal) + s.gap_velocity) * s.mass_normal;
+	real_t jnOld = s.acc_normal_impulse;
+	s.acc_normal_impulse = MAX(jnOld + jn, 0.0f);
+
+	Vector3 j = s.normal * (s.acc_normal_impulse - jnOld);
+
+	A->apply_impulse(s.rA + A->get_center_of_mass(), -j);
+	B->apply_impulse(s.rB + B->get_center_of_mass(), j);
+}
+
 real_t combine_bounce(BodySW *A, BodySW *B) {
 	return CLAMP(A->get_bounce() + B->get_bounce(), 0, 1);
 }
@@ -219,16 +304,39 @@ real_t combine_friction(BodySW *A, BodySW *B) {
 	return ABS(MIN(A->get_friction(), B->get_friction()));
 }
 
+bool BodyPairSW::_is_manifold_reusable(const ShapeSW *p_shape_A, const ShapeSW *p_shape_B, const Transform &p_relative_xform) const {
+
+	if (!manifold.valid || !collided || contact_count == 0 || contact_count != manifold.contact_count)
+		return false; // contacts were dropped since, generate them again
+
+	if (manifold.shape_A != p_shape_A || manifold.shape_B != p_shape_B || manifold.shapes_version_A != A->get_shapes_version() || manifold.shapes_version_B != B->get_shapes_version())
+		return false;
+
+	if (p_relative_xform.origin.distance_squared_to(manifold.relative_xform.origin) > MANIFOLD_MAX_DRIFT * MANIFOLD_MAX_DRIFT)
+		return false;
+
+	for (int i = 0; i < 3; i++) {
+		if (p_relative_xform.basis[i].distance_squared_to(manifold.relative_xform.basis[i]) > MANIFOLD_MAX_ROTATION * MANIFOLD_MAX_ROTATION)
+			return false;
+	}
+
+	return true;
+}
+
 bool BodyPairSW::setup(real_t p_step) {
 
+	speculative.active = false;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
+		manifold.valid = false;
 		return false;
 	}
 
 	if (A->is_shape_set_as_disabled(shape_A) || B->is_shape_set_as_disabled(shape_B)) {
 		collided = false;
+		manifold.valid = false;
 		return false;
 	}
 
@@ -247,22 +355,45 @@ bool BodyPairSW::setup(real_t p_step) {
 	ShapeSW *shape_A_ptr = A->get_shape(shape_A);
 	ShapeSW *shape_B_ptr = B->get_shape(shape_B);
 
-	bool collided = CollisionSolverSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+	Transform relative_xform = xform_A.affine_inverse() * xform_B;
+
+	bool collided;
+
+	if (_is_manifold_reusable(shape_A_ptr, shape_B_ptr, relative_xform)) {
+		// barely moved against each other since the contacts were found, keep them
+		collided = true;
+	} else {
+		collided = CollisionSolverSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+
+		manifold.valid = collided;
+		manifold.relative_xform = relative_xform;
+		manifold.shape_A = shape_A_ptr;
+		manifold.shape_B = shape_B_ptr;
+		manifold.shapes_version_A = A->get_shapes_version();
+		manifold.shapes_version_B = B->get_shapes_version();
+		manifold.contact_count = contact_count;
+	}
 	this->collided = collided;
 
 	if (!collided) {
 
-		//test ccd (currently just a raycast)
+		bool ccd_A = A->is_continuous_collision_detection_enabled() && A->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC;
+		bool ccd_B = B->is_continuous_collision_detection_enabled() && B->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC;
 
-		if (A->is_continuous_collision_detection_enabled() && A->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC) {
-			_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
-		}
+		if ((ccd_A || ccd_B) && !_setup_speculative(p_step, shape_A_ptr, xform_A, shape_B_ptr, xform_B)) {
 
-		if (B->is_continuous_collision_detection_enabled() && B->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC && A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC) {
-			_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
+			//no distance query for these shapes, clamp the motion with a raycast instead
+
+			if (ccd_A && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC) {
+				_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
+			}
+
+			if (ccd_B && A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC) {
+				_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
+			}
 		}
 
-		return false;
+		return speculative.active;
 	}
 
 	real_t max_penetration = space->get_contact_max_allowed_penetration();
@@ -355,6 +486,9 @@ bool BodyPairSW::setup(real_t p_step) {
 
 void BodyPairSW::solve(real_t p_step) {
 
+	if (speculative.active)
+		_solve_speculative();
+
 	if (!collided)
 		return;
 
@@ -486,6 +620,13 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	manifold.valid = false;
+	manifold.shape_A = NULL;
+	manifold.shape_B = NULL;
+	manifold.shapes_version_A = 0;
+	manifold.shapes_version_B = 0;
+	manifold.contact_count = 0;
+	speculative.active = false;
 }
 
 BodyPairSW::~BodyPairSW() {
@@ -78,6 +78,35 @@ class BodyPairSW : public ConstraintSW {
 	bool collided;
 	int cc;
 
+	// narrowphase input the current contacts were generated from, used to skip it while the pair rests
+	struct Manifold {
+
+		bool valid;
+		Transform relative_xform;
+		ShapeSW *shape_A;
+		ShapeSW *shape_B;
+		uint32_t shapes_version_A;
+		uint32_t shapes_version_B;
+		int contact_count;
+	} manifold;
+
+	bool _is_manifold_reusable(const ShapeSW *p_shape_A, const ShapeSW *p_shape_B, const Transform &p_relative_xform) const;
+
+	// contact between shapes that are still apart but can meet during the step,
+	// it only takes away the part of the approach that would close the gap
+	struct SpeculativeContact {
+
+		bool active;
+		Vector3 normal;
+		Vector3 rA, rB;
+		real_t mass_normal;
+		real_t gap_velocity; // approach velocity that exactly closes the gap in one step
+		real_t acc_normal_impulse;
+	} speculative;
+
+	bool _setup_speculative(real_t p_step, const ShapeSW *p_shape_A, const Transform &p_xform_A, const ShapeSW *p_shape_B, const Transform &p_xform_B);
+	void _solve_speculative();
+
 	static void _contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B);
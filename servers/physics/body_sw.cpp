@@ -556,8 +556,8 @@ void BodySW::integrate_forces(real_t p_step) {
 	biased_angular_velocity = Vector3();
 	biased_linear_velocity = Vector3();
 
-	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+	if (do_motion) { //shapes temporarily extend for speculative contacts
+		_update_shapes_with_motion(motion, continuous_cd ? angular_velocity.length() * p_step : 0);
 	}
 
 	def_area = NULL; // clear the area, so it is set in the next frame
@@ -0,0 +1,664 @@
+/*************************************************************************/
+/*  broad_phase_bvh.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "broad_phase_bvh.h"
+#include "collision_object_sw.h"
+
+// half the surface area, which is what the tree tries to minimize
+static _FORCE_INLINE_ real_t _aabb_cost(const AABB &p_aabb) {
+
+	return p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x;
+}
+
+static _FORCE_INLINE_ AABB _aabb_merge(const AABB &p_a, const AABB &p_b) {
+
+	Vector3 min = p_a.position;
+	Vector3 max = p_a.position + p_a.size;
+	Vector3 b_min = p_b.position;
+	Vector3 b_max = p_b.position + p_b.size;
+
+	min.x = MIN(min.x, b_min.x);
+	min.y = MIN(min.y, b_min.y);
+	min.z = MIN(min.z, b_min.z);
+	max.x = MAX(max.x, b_max.x);
+	max.y = MAX(max.y, b_max.y);
+	max.z = MAX(max.z, b_max.z);
+
+	return AABB(min, max - min);
+}
+
+static _FORCE_INLINE_ bool _aabb_encloses(const AABB &p_a, const AABB &p_b) {
+
+	Vector3 a_max = p_a.position + p_a.size;
+	Vector3 b_max = p_b.position + p_b.size;
+
+	return p_a.position.x <= p_b.position.x && p_a.position.y <= p_b.position.y && p_a.position.z <= p_b.position.z &&
+		   a_max.x >= b_max.x && a_max.y >= b_max.y && a_max.z >= b_max.z;
+}
+
+int BroadPhaseBVH::Tree::_alloc_node() {
+
+	if (free_list == -1) {
+
+		int new_capacity = node_capacity ? node_capacity * 2 : 16;
+		nodes = (Node *)memrealloc(nodes, sizeof(Node) * new_capacity);
+
+		for (int i = node_capacity; i < new_capacity; i++) {
+			nodes[i].parent = i + 1 < new_capacity ? i + 1 : -1;
+			nodes[i].height = -1;
+		}
+
+		free_list = node_capacity;
+		node_capacity = new_capacity;
+	}
+
+	int idx = free_list;
+	Node &node = nodes[idx];
+	free_list = node.parent;
+
+	node.parent = -1;
+	node.children[0] = -1;
+	node.children[1] = -1;
+	node.height = 0;
+	node.element = 0;
+	node_count++;
+
+	return idx;
+}
+
+void BroadPhaseBVH::Tree::_free_node(int p_node) {
+
+	nodes[p_node].parent = free_list;
+	nodes[p_node].height = -1;
+	free_list = p_node;
+	node_count--;
+}
+
+int BroadPhaseBVH::Tree::_balance(int p_node) {
+
+	int ia = p_node;
+	Node &a = nodes[ia];
+
+	if (a.is_leaf() || a.height < 2)
+		return ia;
+
+	int ib = a.children[0];
+	int ic = a.children[1];
+	Node &b = nodes[ib];
+	Node &c = nodes[ic];
+
+	int balance = c.height - b.height;
+
+	if (balance > 1) {
+
+		// rotate c up
+		int i_f = c.children[0];
+		int ig = c.children[1];
+		Node &f = nodes[i_f];
+		Node &g = nodes[ig];
+
+		c.children[0] = ia;
+		c.parent = a.parent;
+		a.parent = ic;
+
+		if (c.parent != -1) {
+			Node &parent = nodes[c.parent];
+			parent.children[parent.children[0] == ia ? 0 : 1] = ic;
+		} else {
+			root = ic;
+		}
+
+		if (f.height > g.height) {
+			c.children[1] = i_f;
+			a.children[1] = ig;
+			g.parent = ia;
+			a.aabb = _aabb_merge(b.aabb, g.aabb);
+			c.aabb = _aabb_merge(a.aabb, f.aabb);
+			a.height = 1 + MAX(b.height, g.height);
+			c.height = 1 + MAX(a.height, f.height);
+		} else {
+			c.children[1] = ig;
+			a.children[1] = i_f;
+			f.parent = ia;
+			a.aabb = _aabb_merge(b.aabb, f.aabb);
+			c.aabb = _aabb_merge(a.aabb, g.aabb);
+			a.height = 1 + MAX(b.height, f.height);
+			c.height = 1 + MAX(a.height, g.height);
+		}
+
+		return ic;
+	}
+
+	if (balance < -1) {
+
+		// rotate b up
+		int id = b.children[0];
+		int ie = b.children[1];
+		Node &d = nodes[id];
+		Node &e = nodes[ie];
+
+		b.children[0] = ia;
+		b.parent = a.parent;
+		a.parent = ib;
+
+		if (b.parent != -1) {
+			Node &parent = nodes[b.parent];
+			parent.children[parent.children[0] == ia ? 0 : 1] = ib;
+		} else {
+			root = ib;
+		}
+
+		if (d.height > e.height) {
+			b.children[1] = id;
+			a.children[0] = ie;
+			e.parent = ia;
+			a.aabb = _aabb_merge(c.aabb, e.aabb);
+			b.aabb = _aabb_merge(a.aabb, d.aabb);
+			a.height = 1 + MAX(c.height, e.height);
+			b.height = 1 + MAX(a.height, d.height);
+		} else {
+			b.children[1] = ie;
+			a.children[0] = id;
+			d.parent = ia;
+			a.aabb = _aabb_merge(c.aabb, d.aabb);
+			b.aabb = _aabb_merge(a.aabb, e.aabb);
+			a.height = 1 + MAX(c.height, d.height);
+			b.height = 1 + MAX(a.height, e.height);
+		}
+
+		return ib;
+	}
+
+	return ia;
+}
+
+int BroadPhaseBVH::Tree::insert(const AABB &p_aabb, ID p_element) {
+
+	int leaf = _alloc_node();
+	nodes[leaf].aabb = p_aabb;
+	nodes[leaf].element = p_element;
+
+	if (root == -1) {
+		root = leaf;
+		return leaf;
+	}
+
+	// find the best sibling, descending to the child that grows the least
+	int index = root;
+	while (!nodes[index].is_leaf()) {
+
+		const Node &node = nodes[index];
+		int child0 = node.children[0];
+		int child1 = node.children[1];
+
+		real_t cost_here = _aabb_cost(node.aabb);
+		real_t combined_cost = _aabb_cost(_aabb_merge(node.aabb, p_aabb));
+
+		real_t cost = 2.0 * combined_cost;
+		real_t inheritance_cost = 2.0 * (combined_cost - cost_here);
+
+		real_t cost0 = _aabb_cost(_aabb_merge(nodes[child0].aabb, p_aabb)) + inheritance_cost;
+		if (!nodes[child0].is_leaf()) {
+			cost0 -= _aabb_cost(nodes[child0].aabb);
+		}
+
+		real_t cost1 = _aabb_cost(_aabb_merge(nodes[child1].aabb, p_aabb)) + inheritance_cost;
+		if (!nodes[child1].is_leaf()) {
+			cost1 -= _aabb_cost(nodes[child1].aabb);
+		}
+
+		if (cost < cost0 && cost < cost1)
+			break;
+
+		index = cost0 < cost1 ? child0 : child1;
+	}
+
+	int sibling = index;
+	int old_parent = nodes[sibling].parent;
+	int new_parent = _alloc_node();
+
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].aabb = _aabb_merge(nodes[sibling].aabb, p_aabb);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].children[0] = sibling;
+	nodes[new_parent].children[1] = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent != -1) {
+		Node &parent = nodes[old_parent];
+		parent.children[parent.children[0] == sibling ? 0 : 1] = new_parent;
+	} else {
+		root = new_parent;
+	}
+
+	// refit and rebalance the ancestors
+	index = nodes[leaf].parent;
+	while (index != -1) {
+
+		index = _balance(index);
+
+		Node &node = nodes[index];
+		const Node &child0 = nodes[node.children[0]];
+		const Node &child1 = nodes[node.children[1]];
+
+		node.height = 1 + MAX(child0.height, child1.height);
+		node.aabb = _aabb_merge(child0.aabb, child1.aabb);
+
+		index = node.parent;
+	}
+
+	return leaf;
+}
+
+void BroadPhaseBVH::Tree::remove(int p_leaf) {
+
+	if (p_leaf == root) {
+		root = -1;
+		_free_node(p_leaf);
+		return;
+	}
+
+	int parent = nodes[p_leaf].parent;
+	int grand_parent = nodes[parent].parent;
+	int sibling = nodes[parent].children[nodes[parent].children[0] == p_leaf ? 1 : 0];
+
+	if (grand_parent != -1) {
+
+		Node &grand = nodes[grand_parent];
+		grand.children[grand.children[0] == parent ? 0 : 1] = sibling;
+		nodes[sibling].parent = grand_parent;
+
+		// refit and rebalance the ancestors
+		int index = grand_parent;
+		while (index != -1) {
+
+			index = _balance(index);
+
+			Node &node = nodes[index];
+			const Node &child0 = nodes[node.children[0]];
+			const Node &child1 = nodes[node.children[1]];
+
+			node.height = 1 + MAX(child0.height, child1.height);
+			node.aabb = _aabb_merge(child0.aabb, child1.aabb);
+
+			index = node.parent;
+		}
+	} else {
+		root = sibling;
+		nodes[sibling].parent = -1;
+	}
+
+	_free_node(parent);
+	_free_node(p_leaf);
+}
+
+BroadPhaseBVH::Tree::Tree() {
+
+	nodes = NULL;
+	node_count = 0;
+	node_capacity = 0;
+	root = -1;
+	free_list = -1;
+}
+
+BroadPhaseBVH::Tree::~Tree() {
+
+	if (nodes) {
+		memfree(nodes);
+	}
+}
+
+BroadPhaseSW::ID BroadPhaseBVH::create(CollisionObjectSW *p_object, int p_subindex) {
+
+	ID id;
+	if (free_elements.size()) {
+		id = free_elements[free_elements.size() - 1];
+		free_elements.resize(free_elements.size() - 1);
+	} else {
+		elements.resize(elements.size() + 1);
+		id = elements.size();
+	}
+
+	Element &e = elements.write[id - 1];
+	e.owner = p_object;
+	e._static = true; // not pairable until set_static() says otherwise, like the octree
+	e.moved = false;
+	e.aabb = AABB();
+	e.subindex = p_subindex;
+	e.leaf = static_tree.insert(e.aabb, id);
+
+	return id;
+}
+
+void BroadPhaseBVH::_mark_moved(ID p_id) {
+
+	Element &e = elements.write[p_id - 1];
+	if (!e.moved) {
+		e.moved = true;
+		moved.push_back(p_id);
+	}
+}
+
+void BroadPhaseBVH::move(ID p_id, const AABB &p_aabb) {
+
+	ERR_FAIL_COND(p_id == 0 || p_id > (ID)elements.size());
+	Element &e = elements.write[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	e.aabb = p_aabb;
+
+	Tree &tree = _get_tree(e);
+	if (!_aabb_encloses(tree.nodes[e.leaf].aabb, p_aabb)) {
+		// left its fat aabb, reinsert it
+		tree.remove(e.leaf);
+		e.leaf = tree.insert(e._static ? p_aabb : p_aabb.grow(fat_margin), p_id);
+	}
+
+	_mark_moved(p_id);
+}
+
+void BroadPhaseBVH::set_static(ID p_id, bool p_static) {
+
+	ERR_FAIL_COND(p_id == 0 || p_id > (ID)elements.size());
+	Element &e = elements.write[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e._static == p_static)
+		return;
+
+	_get_tree(e).remove(e.leaf);
+	e._static = p_static;
+	e.leaf = _get_tree(e).insert(e._static ? e.aabb : e.aabb.grow(fat_margin), p_id);
+
+	_mark_moved(p_id);
+}
+
+void BroadPhaseBVH::remove(ID p_id) {
+
+	ERR_FAIL_COND(p_id == 0 || p_id > (ID)elements.size());
+	ERR_FAIL_COND(!elements[p_id - 1].owner);
+
+	while (elements[p_id - 1].pairs.size()) {
+		const Vector<ID> &pairs = elements[p_id - 1].pairs;
+		_unpair(p_id, pairs[pairs.size() - 1]);
+	}
+
+	Element &e = elements.write[p_id - 1];
+	_get_tree(e).remove(e.leaf);
+	e.owner = NULL;
+	e.moved = false;
+	e.leaf = -1;
+
+	free_elements.push_back(p_id);
+}
+
+CollisionObjectSW *BroadPhaseBVH::get_object(ID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == 0 || p_id > (ID)elements.size(), NULL);
+	const Element &e = elements[p_id - 1];
+	ERR_FAIL_COND_V(!e.owner, NULL);
+	return e.owner;
+}
+
+bool BroadPhaseBVH::is_static(ID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == 0 || p_id > (ID)elements.size(), false);
+	return elements[p_id - 1]._static;
+}
+
+int BroadPhaseBVH::get_subindex(ID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == 0 || p_id > (ID)elements.size(), -1);
+	return elements[p_id - 1].subindex;
+}
+
+struct _BVHCullPoint {
+
+	Vector3 point;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.has_point(point); }
+};
+
+struct _BVHCullSegment {
+
+	Vector3 from;
+	Vector3 to;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_segment(from, to); }
+};
+
+struct _BVHCullAABB {
+
+	AABB aabb;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return aabb.intersects_inclusive(p_aabb); }
+};
+
+template <class T>
+int BroadPhaseBVH::_cull(const T &p_test, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	struct Query {
+
+		const BroadPhaseBVH *self;
+		const T *cull_test;
+		CollisionObjectSW **results;
+		int *result_indices;
+		int max_results;
+		int count;
+
+		_FORCE_INLINE_ bool test(const AABB &p_aabb) const { return (*cull_test)(p_aabb); }
+
+		_FORCE_INLINE_ bool leaf(ID p_id) {
+
+			const Element &e = self->elements[p_id - 1];
+			if (!(*cull_test)(e.aabb))
+				return true;
+
+			if (count >= max_results)
+				return false;
+
+			results[count] = e.owner;
+			if (result_indices) {
+				result_indices[count] = e.subindex;
+			}
+			count++;
+			return true;
+		}
+	};
+
+	Query query;
+	query.self = this;
+	query.cull_test = &p_test;
+	query.results = p_results;
+	query.result_indices = p_result_indices;
+	query.max_results = p_max_results;
+	query.count = 0;
+
+	dynamic_tree.query(query);
+	static_tree.query(query);
+
+	return query.count;
+}
+
+int BroadPhaseBVH::cull_point(const Vector3 &p_point, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BVHCullPoint test;
+	test.point = p_point;
+	return _cull(test, p_results, p_max_results, p_result_indices);
+}
+
+int BroadPhaseBVH::cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BVHCullSegment test;
+	test.from = p_from;
+	test.to = p_to;
+	return _cull(test, p_results, p_max_results, p_result_indices);
+}
+
+int BroadPhaseBVH::cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BVHCullAABB test;
+	test.aabb = p_aabb;
+	return _cull(test, p_results, p_max_results, p_result_indices);
+}
+
+void BroadPhaseBVH::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+void BroadPhaseBVH::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhaseBVH::_pair(ID p_a, ID p_b) {
+
+	uint64_t key = _pair_key(p_a, p_b);
+	if (pair_map.has(key))
+		return; // both moved and found each other
+
+	Element &a = elements.write[p_a - 1];
+	Element &b = elements.write[p_b - 1];
+
+	Pair pair;
+	pair.a = p_a;
+	pair.b = p_b;
+	pair.ud = pair_callback ? pair_callback(a.owner, a.subindex, b.owner, b.subindex, pair_userdata) : NULL;
+
+	pair_map[key] = pair;
+	a.pairs.push_back(p_b);
+	b.pairs.push_back(p_a);
+}
+
+void BroadPhaseBVH::_unpair(ID p_a, ID p_b) {
+
+	uint64_t key = _pair_key(p_a, p_b);
+	Pair *E = pair_map.getptr(key);
+	ERR_FAIL_COND(!E);
+
+	Pair pair = *E;
+	pair_map.erase(key);
+
+	elements.write[p_a - 1].pairs.erase(p_b);
+	elements.write[p_b - 1].pairs.erase(p_a);
+
+	if (unpair_callback) {
+		const Element &a = elements[pair.a - 1];
+		const Element &b = elements[pair.b - 1];
+		unpair_callback(a.owner, a.subindex, b.owner, b.subindex, pair.ud, unpair_userdata);
+	}
+}
+
+void BroadPhaseBVH::update() {
+
+	if (moved.empty())
+		return;
+
+	struct PairQuery {
+
+		const BroadPhaseBVH *self;
+		ID id;
+		const Element *element;
+		Vector<ID> *new_pairs;
+
+		_FORCE_INLINE_ bool test(const AABB &p_aabb) const { return element->aabb.intersects_inclusive(p_aabb); }
+
+		_FORCE_INLINE_ bool leaf(ID p_other) {
+
+			if (p_other == id)
+				return true;
+
+			const Element &other = self->elements[p_other - 1];
+			if (self->_can_pair(*element, other) && element->aabb.intersects_inclusive(other.aabb) && !self->pair_map.has(_pair_key(id, p_other))) {
+				new_pairs->push_back(id);
+				new_pairs->push_back(p_other);
+			}
+			return true;
+		}
+	};
+
+	for (int i = 0; i < moved.size(); i++) {
+
+		ID id = moved[i];
+		if (!elements[id - 1].owner || !elements[id - 1].moved)
+			continue; // removed, or listed twice
+
+		elements.write[id - 1].moved = false;
+
+		// drop the pairs that no longer overlap
+		for (int j = elements[id - 1].pairs.size() - 1; j >= 0; j--) {
+
+			const Element &e = elements[id - 1];
+			ID other_id = e.pairs[j];
+			const Element &other = elements[other_id - 1];
+
+			if (!_can_pair(e, other) || !e.aabb.intersects_inclusive(other.aabb)) {
+				_unpair(id, other_id);
+			}
+		}
+
+		// collect the new pairs, static objects only pair against dynamic ones
+		PairQuery query;
+		query.self = this;
+		query.id = id;
+		query.element = &elements[id - 1];
+		query.new_pairs = &new_pairs;
+
+		dynamic_tree.query(query);
+		if (!query.element->_static) {
+			static_tree.query(query);
+		}
+	}
+
+	moved.clear();
+
+	for (int i = 0; i < new_pairs.size(); i += 2) {
+		_pair(new_pairs[i], new_pairs[i + 1]);
+	}
+
+	new_pairs.clear();
+}
+
+BroadPhaseSW *BroadPhaseBVH::_create() {
+
+	return memnew(BroadPhaseBVH);
+}
+
+BroadPhaseBVH::BroadPhaseBVH() {
+
+	fat_margin = 0.1;
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
+}
+
+BroadPhaseBVH::~BroadPhaseBVH() {
+}
@@ -0,0 +1,186 @@
+/*************************************************************************/
+/*  broad_phase_bvh.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BROAD_PHASE_BVH_H
+#define BROAD_PHASE_BVH_H
+
+#include "broad_phase_sw.h"
+#include "hash_map.h"
+#include "vector.h"
+
+/**
+ * Dynamic AABB tree broadphase. Static and dynamic objects are kept in separate
+ * trees, leaves in the dynamic tree use fattened AABBs so small movements don't
+ * touch the tree, and pairs are generated in a batch for the moved objects on update().
+ */
+class BroadPhaseBVH : public BroadPhaseSW {
+
+	enum {
+		STACK_MAX = 256
+	};
+
+	struct Node {
+
+		AABB aabb;
+		int parent; // next free node, when not in use
+		int children[2];
+		int height; // -1 when not in use, 0 for leaves
+		ID element;
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == -1; }
+	};
+
+	struct Tree {
+
+		Node *nodes;
+		int node_count;
+		int node_capacity;
+		int root;
+		int free_list;
+
+		int _alloc_node();
+		void _free_node(int p_node);
+		int _balance(int p_node);
+
+		int insert(const AABB &p_aabb, ID p_element);
+		void remove(int p_leaf);
+
+		template <class Q>
+		_FORCE_INLINE_ void query(Q &p_query) const {
+
+			if (root == -1)
+				return;
+
+			int stack[STACK_MAX];
+			int stack_size = 0;
+			stack[stack_size++] = root;
+
+			while (stack_size) {
+
+				const Node &node = nodes[stack[--stack_size]];
+
+				if (!p_query.test(node.aabb))
+					continue;
+
+				if (node.is_leaf()) {
+					if (!p_query.leaf(node.element))
+						return;
+				} else {
+					ERR_FAIL_COND(stack_size + 2 > STACK_MAX);
+					stack[stack_size++] = node.children[0];
+					stack[stack_size++] = node.children[1];
+				}
+			}
+		}
+
+		Tree();
+		~Tree();
+	};
+
+	struct Element {
+
+		CollisionObjectSW *owner;
+		bool _static;
+		bool moved;
+		AABB aabb;
+		int subindex;
+		int leaf;
+		Vector<ID> pairs;
+	};
+
+	struct Pair {
+
+		ID a;
+		ID b;
+		void *ud;
+	};
+
+	_FORCE_INLINE_ static uint64_t _pair_key(ID p_a, ID p_b) {
+
+		return p_a < p_b ? (uint64_t(p_a) << 32) | p_b : (uint64_t(p_b) << 32) | p_a;
+	}
+
+	_FORCE_INLINE_ bool _can_pair(const Element &p_a, const Element &p_b) const {
+
+		return p_a.owner != p_b.owner && (!p_a._static || !p_b._static);
+	}
+
+	Vector<Element> elements;
+	Vector<ID> free_elements;
+	Vector<ID> moved;
+	Vector<ID> new_pairs;
+
+	Tree static_tree;
+	Tree dynamic_tree;
+
+	real_t fat_margin;
+
+	HashMap<uint64_t, Pair> pair_map;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	_FORCE_INLINE_ Tree &_get_tree(const Element &p_element) { return p_element._static ? static_tree : dynamic_tree; }
+
+	void _pair(ID p_a, ID p_b);
+	void _unpair(ID p_a, ID p_b);
+	void _mark_moved(ID p_id);
+
+	template <class T>
+	int _cull(const T &p_test, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices);
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(CollisionObjectSW *p_object, int p_subindex = 0);
+	virtual void move(ID p_id, const AABB &p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObjectSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_point(const Vector3 &p_point, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhaseSW *_create();
+	BroadPhaseBVH();
+	~BroadPhaseBVH();
+};
+
+#endif // BROAD_PHASE_BVH_H
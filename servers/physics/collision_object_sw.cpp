@@ -163,7 +163,7 @@ void CollisionObjectSW::_update_shapes() {
 	}
 }
 
-void CollisionObjectSW::_update_shapes_with_motion(const Vector3 &p_motion) {
+void CollisionObjectSW::_update_shapes_with_motion(const Vector3 &p_motion, real_t p_rotation) {
 
 	if (!space)
 		return;
@@ -180,6 +180,11 @@ void CollisionObjectSW::_update_shapes_with_motion(const Vector3 &p_motion) {
 		AABB shape_aabb = s.shape->get_aabb();
 		Transform xform = transform * s.xform;
 		shape_aabb = xform.xform(shape_aabb);
+		if (p_rotation > 0) {
+			//a rotating shape sweeps at most an arc of its distance to the origin
+			real_t radius = (shape_aabb.position + shape_aabb.size * 0.5 - transform.origin).length() + shape_aabb.size.length() * 0.5;
+			shape_aabb.grow_by(radius * MIN(p_rotation, (real_t)2.0));
+		}
 		shape_aabb = shape_aabb.merge(AABB(shape_aabb.position + p_motion, shape_aabb.size)); //use motion
 		s.aabb_cache = shape_aabb;
 
@@ -214,6 +219,7 @@ void CollisionObjectSW::_set_space(SpaceSW *p_space) {
 
 void CollisionObjectSW::_shape_changed() {
 
+	shapes_version++;
 	_update_shapes();
 	_shapes_changed();
 }
@@ -228,4 +234,5 @@ CollisionObjectSW::CollisionObjectSW(Type p_type) :
 	collision_layer = 1;
 	collision_mask = 1;
 	ray_pickable = true;
+	shapes_version = 0;
 }
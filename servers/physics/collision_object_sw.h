@@ -76,13 +76,14 @@ private:
 	Transform transform;
 	Transform inv_transform;
 	bool _static;
+	uint32_t shapes_version;
 
 	SelfList<CollisionObjectSW> pending_shape_update_list;
 
 	void _update_shapes();
 
 protected:
-	void _update_shapes_with_motion(const Vector3 &p_motion);
+	void _update_shapes_with_motion(const Vector3 &p_motion, real_t p_rotation = 0);
 	void _unregister_shapes();
 
 	_FORCE_INLINE_ void _set_transform(const Transform &p_transform, bool p_update_shapes = true) {
@@ -116,6 +117,7 @@ public:
 	_FORCE_INLINE_ ObjectID get_instance_id() const { return instance_id; }
 
 	void _shape_changed();
+	_FORCE_INLINE_ uint32_t get_shapes_version() const { return shapes_version; }
 
 	_FORCE_INLINE_ Type get_type() const { return type; }
 	void add_shape(ShapeSW *p_shape, const Transform &p_transform = Transform());
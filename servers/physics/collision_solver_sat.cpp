@@ -367,6 +367,39 @@ public:
 		return true;
 	}
 
+	// same as test_axis, but with the projection already done by the caller:
+	// p_distance is the distance between both centers along the axis, p_radius the sum of both half lengths
+	_FORCE_INLINE_ bool test_projected_axis(const Vector3 &p_axis, real_t p_distance, real_t p_radius) {
+
+		if (Math::abs(p_axis.x) < CMP_EPSILON &&
+				Math::abs(p_axis.y) < CMP_EPSILON &&
+				Math::abs(p_axis.z) < CMP_EPSILON) {
+			return test_axis(p_axis);
+		}
+
+		if (withMargin) {
+			p_radius += margin_A + margin_B;
+		}
+
+		real_t distance = Math::abs(p_distance);
+
+		if (distance > p_radius) {
+			separator_axis = p_axis;
+			return false; // doesn't contain 0
+		}
+
+		//use the smallest depth
+
+		real_t depth = p_radius - distance;
+
+		if (depth < best_depth) {
+			best_depth = depth;
+			best_axis = p_distance < 0.0 ? p_axis : -p_axis; // keep it as A axis
+		}
+
+		return true;
+	}
+
 	_FORCE_INLINE_ void generate_contacts() {
 
 		// nothing to do, don't generate
@@ -674,40 +707,76 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 	if (!separator.test_previous_axis())
 		return;
 
-	// test faces of A
+	// gather the candidate axes (faces of A, faces of B, combined edges) as separate component
+	// arrays, so the projections below are plain loops the compiler can vectorize
 
-	for (int i = 0; i < 3; i++) {
+	Vector3 basis_a[3] = { p_transform_a.basis.get_axis(0), p_transform_a.basis.get_axis(1), p_transform_a.basis.get_axis(2) };
+	Vector3 basis_b[3] = { p_transform_b.basis.get_axis(0), p_transform_b.basis.get_axis(1), p_transform_b.basis.get_axis(2) };
 
-		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
+	real_t axis_x[15], axis_y[15], axis_z[15];
+	int axis_count = 0;
 
-		if (!separator.test_axis(axis))
-			return;
-	}
+	for (int i = 0; i < 3; i++) {
 
-	// test faces of B
+		Vector3 axis = basis_a[i].normalized();
+		axis_x[axis_count] = axis.x;
+		axis_y[axis_count] = axis.y;
+		axis_z[axis_count] = axis.z;
+		axis_count++;
+	}
 
 	for (int i = 0; i < 3; i++) {
 
-		Vector3 axis = p_transform_b.basis.get_axis(i).normalized();
-
-		if (!separator.test_axis(axis))
-			return;
+		Vector3 axis = basis_b[i].normalized();
+		axis_x[axis_count] = axis.x;
+		axis_y[axis_count] = axis.y;
+		axis_z[axis_count] = axis.z;
+		axis_count++;
 	}
 
-	// test combined edges
 	for (int i = 0; i < 3; i++) {
 
 		for (int j = 0; j < 3; j++) {
 
-			Vector3 axis = p_transform_a.basis.get_axis(i).cross(p_transform_b.basis.get_axis(j));
+			Vector3 axis = basis_a[i].cross(basis_b[j]);
 
 			if (axis.length_squared() < CMP_EPSILON)
 				continue;
 			axis.normalize();
 
-			if (!separator.test_axis(axis)) {
-				return;
-			}
+			axis_x[axis_count] = axis.x;
+			axis_y[axis_count] = axis.y;
+			axis_z[axis_count] = axis.z;
+			axis_count++;
+		}
+	}
+
+	const Vector3 &half_a = box_A->get_half_extents();
+	const Vector3 &half_b = box_B->get_half_extents();
+	Vector3 offset = p_transform_b.origin - p_transform_a.origin;
+
+	real_t distance[15], radius[15];
+
+	for (int i = 0; i < axis_count; i++) {
+
+		real_t ra = 0;
+		real_t rb = 0;
+
+		for (int k = 0; k < 3; k++) {
+			ra += Math::abs(basis_a[k].x * axis_x[i] + basis_a[k].y * axis_y[i] + basis_a[k].z * axis_z[i]) * half_a[k];
+			rb += Math::abs(basis_b[k].x * axis_x[i] + basis_b[k].y * axis_y[i] + basis_b[k].z * axis_z[i]) * half_b[k];
+		}
+
+		radius[i] = ra + rb;
+		distance[i] = offset.x * axis_x[i] + offset.y * axis_y[i] + offset.z * axis_z[i];
+	}
+
+	// test in the same order as before, so the chosen axis does not change
+
+	for (int i = 0; i < axis_count; i++) {
+
+		if (!separator.test_projected_axis(Vector3(axis_x[i], axis_y[i], axis_z[i]), distance[i], radius[i])) {
+			return;
 		}
 	}
 
@@ -31,6 +31,7 @@
 #include "physics_server_sw.h"
 
 #include "broad_phase_basic.h"
+#include "broad_phase_bvh.h"
 #include "broad_phase_octree.h"
 #include "joints/cone_twist_joint_sw.h"
 #include "joints/generic_6dof_joint_sw.h"
@@ -38,6 +39,8 @@
 #include "joints/pin_joint_sw.h"
 #include "joints/slider_joint_sw.h"
 #include "os/os.h"
+#include "os/trace.h"
+#include "project_settings.h"
 #include "script_language.h"
 
 RID PhysicsServerSW::shape_create(ShapeType p_shape) {
@@ -465,6 +468,14 @@ void PhysicsServerSW::area_set_area_monitor_callback(RID p_area, Object *p_recei
 	area->set_area_monitor_callback(p_receiver ? p_receiver->get_instance_id() : 0, p_method);
 }
 
+void PhysicsServerSW::area_set_monitor_batching(RID p_area, bool p_enable) {
+
+	AreaSW *area = area_owner.get(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 /* BODY API */
 
 RID PhysicsServerSW::body_create(BodyMode p_mode, bool p_init_sleeping) {
@@ -1396,11 +1407,14 @@ void PhysicsServerSW::init() {
 	last_step = 0.001;
 	iterations = 8; // 8?
 	stepper = memnew(StepSW);
+	stepper->set_threaded_islands(GLOBAL_DEF("physics/3d/threaded_islands", false));
 	direct_state = memnew(PhysicsDirectBodyStateSW);
 };
 
 void PhysicsServerSW::step(real_t p_step) {
 
+	TRACE_SCOPE("PhysicsServerSW::step");
+
 #ifndef _3D_DISABLED
 
 	if (!active)
@@ -1554,7 +1568,10 @@ void PhysicsServerSW::_shape_col_cbk(const Vector3 &p_point_A, const Vector3 &p_
 PhysicsServerSW *PhysicsServerSW::singleton = NULL;
 PhysicsServerSW::PhysicsServerSW() {
 	singleton = this;
-	BroadPhaseSW::create_func = BroadPhaseOctree::_create;
+
+	int broadphase = GLOBAL_DEF("physics/3d/broadphase", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/broadphase", PropertyInfo(Variant::INT, "physics/3d/broadphase", PROPERTY_HINT_ENUM, "Octree,BVH"));
+	BroadPhaseSW::create_func = broadphase == 1 ? BroadPhaseBVH::_create : BroadPhaseOctree::_create;
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
@@ -30,6 +30,7 @@
 
 #include "shape_sw.h"
 
+#include "core/io/marshalls.h"
 #include "geometry.h"
 #include "quick_hull.h"
 #include "sort.h"
@@ -1183,55 +1184,30 @@ Vector3 ConcavePolygonShapeSW::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void ConcavePolygonShapeSW::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
+static _FORCE_INLINE_ bool _concave_segment_hits_aabb(const Vector3 &p_min, const Vector3 &p_max, const Vector3 &p_from, const Vector3 &p_inv_rel, real_t p_max_t) {
 
-	const BVH *bvh = &p_params->bvh[p_idx];
+	real_t tx0 = (p_min.x - p_from.x) * p_inv_rel.x;
+	real_t tx1 = (p_max.x - p_from.x) * p_inv_rel.x;
+	real_t ty0 = (p_min.y - p_from.y) * p_inv_rel.y;
+	real_t ty1 = (p_max.y - p_from.y) * p_inv_rel.y;
+	real_t tz0 = (p_min.z - p_from.z) * p_inv_rel.z;
+	real_t tz1 = (p_max.z - p_from.z) * p_inv_rel.z;
 
-	/*
-	if (p_params->dir.dot(bvh->aabb.get_support(-p_params->dir))>p_params->min_d)
-		return; //test against whole AABB, which isn't very costly
-	*/
+	real_t tmin = MAX(MAX(MIN(tx0, tx1), MIN(ty0, ty1)), MAX(MIN(tz0, tz1), (real_t)0));
+	real_t tmax = MIN(MIN(MAX(tx0, tx1), MAX(ty0, ty1)), MIN(MAX(tz0, tz1), p_max_t));
 
-	//printf("addr: %p\n",bvh);
-	if (!bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-
-		return;
-	}
-
-	if (bvh->face_index >= 0) {
-
-		Vector3 res;
-		Vector3 vertices[3] = {
-			p_params->vertices[p_params->faces[bvh->face_index].indices[0]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[1]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[2]]
-		};
-
-		if (Geometry::segment_intersects_triangle(
-					p_params->from,
-					p_params->to,
-					vertices[0],
-					vertices[1],
-					vertices[2],
-					&res)) {
+	return tmin <= tmax;
+}
 
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			//TODO, seems segmen/triangle intersection is broken :(
-			if (d > 0 && d < p_params->min_d) {
+void ConcavePolygonShapeSW::_quantize(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max) const {
 
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = Plane(vertices[0], vertices[1], vertices[2]).normal;
-				p_params->collisions++;
-			}
-		}
+	//round outwards, so the quantized box always contains the real one
+	Vector3 from = (p_aabb.position - bvh_origin) * bvh_scale;
+	Vector3 to = (p_aabb.position + p_aabb.size - bvh_origin) * bvh_scale;
 
-	} else {
-
-		if (bvh->left >= 0)
-			_cull_segment(bvh->left, p_params);
-		if (bvh->right >= 0)
-			_cull_segment(bvh->right, p_params);
+	for (int i = 0; i < 3; i++) {
+		r_min[i] = (uint16_t)CLAMP(Math::floor(from[i]), 0, 65535);
+		r_max[i] = (uint16_t)CLAMP(Math::ceil(to[i]), 0, 65535);
 	}
 }
 
@@ -1245,70 +1221,78 @@ bool ConcavePolygonShapeSW::intersect_segment(const Vector3 &p_begin, const Vect
 	PoolVector<Vector3>::Read vr = vertices.read();
 	PoolVector<BVH>::Read br = bvh.read();
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.collisions = 0;
-	params.dir = (p_end - p_begin).normalized();
+	const Face *facesptr = fr.ptr();
+	const Vector3 *verticesptr = vr.ptr();
+	const BVH *bvhptr = br.ptr();
+	int node_count = bvh.size();
 
-	params.faces = fr.ptr();
-	params.vertices = vr.ptr();
-	params.bvh = br.ptr();
-
-	params.min_d = 1e20;
-	// cull
-	_cull_segment(0, &params);
+	Vector3 rel = p_end - p_begin;
+	Vector3 dir = rel.normalized();
+	real_t rel_len = rel.length();
+	if (rel_len < CMP_EPSILON)
+		return false;
 
-	if (params.collisions > 0) {
+	Vector3 inv_rel;
+	for (int i = 0; i < 3; i++) {
+		inv_rel[i] = rel[i] != 0 ? 1.0 / rel[i] : 1e32;
+	}
 
-		r_result = params.result;
-		r_normal = params.normal;
-		return true;
-	} else {
+	real_t min_d = 1e20;
+	real_t max_t = 1.0; //nodes past the closest hit so far can be skipped
+	int collisions = 0;
 
-		return false;
-	}
-}
+	//stackless walk: nodes are stored depth first, branches know where their subtree ends
+	int i = 0;
+	while (i < node_count) {
 
-bool ConcavePolygonShapeSW::intersect_point(const Vector3 &p_point) const {
+		const BVH &b = bvhptr[i];
 
-	return false; //face is flat
-}
+		Vector3 bmin(b.min[0], b.min[1], b.min[2]);
+		Vector3 bmax(b.max[0], b.max[1], b.max[2]);
+		bool hit = _concave_segment_hits_aabb(bvh_origin + bmin * bvh_inv_scale, bvh_origin + bmax * bvh_inv_scale, p_begin, inv_rel, max_t);
 
-Vector3 ConcavePolygonShapeSW::get_closest_point_to(const Vector3 &p_point) const {
+		if (b.data < 0) {
+			i = hit ? i + 1 : -b.data;
+			continue;
+		}
 
-	return Vector3();
-}
+		i++;
 
-void ConcavePolygonShapeSW::_cull(int p_idx, _CullParams *p_params) const {
+		if (!hit)
+			continue;
 
-	const BVH *bvh = &p_params->bvh[p_idx];
+		const Face &f = facesptr[b.data];
+		const Vector3 &v0 = verticesptr[f.indices[0]];
+		const Vector3 &v1 = verticesptr[f.indices[1]];
+		const Vector3 &v2 = verticesptr[f.indices[2]];
 
-	if (!p_params->aabb.intersects(bvh->aabb))
-		return;
+		Vector3 res;
+		if (Geometry::segment_intersects_triangle(p_begin, p_end, v0, v1, v2, &res)) {
 
-	if (bvh->face_index >= 0) {
+			real_t d = dir.dot(res) - dir.dot(p_begin);
+			//TODO, seems segmen/triangle intersection is broken :(
+			if (d > 0 && d < min_d) {
 
-		const Face *f = &p_params->faces[bvh->face_index];
-		FaceShapeSW *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		p_params->callback(p_params->userdata, face);
+				min_d = d;
+				max_t = d / rel_len;
+				r_result = res;
+				r_normal = Plane(v0, v1, v2).normal;
+				collisions++;
+			}
+		}
+	}
 
-	} else {
+	return collisions > 0;
+}
 
-		if (bvh->left >= 0) {
+bool ConcavePolygonShapeSW::intersect_point(const Vector3 &p_point) const {
 
-			_cull(bvh->left, p_params);
-		}
+	return false; //face is flat
+}
 
-		if (bvh->right >= 0) {
+Vector3 ConcavePolygonShapeSW::get_closest_point_to(const Vector3 &p_point) const {
 
-			_cull(bvh->right, p_params);
-		}
-	}
+	return Vector3();
 }
 
 void ConcavePolygonShapeSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
@@ -1317,26 +1301,51 @@ void ConcavePolygonShapeSW::cull(const AABB &p_local_aabb, Callback p_callback,
 	if (faces.size() == 0)
 		return;
 
-	AABB local_aabb = p_local_aabb;
+	if (!p_local_aabb.intersects_inclusive(get_aabb()))
+		return;
 
 	// unlock data
 	PoolVector<Face>::Read fr = faces.read();
 	PoolVector<Vector3>::Read vr = vertices.read();
 	PoolVector<BVH>::Read br = bvh.read();
 
+	const Face *facesptr = fr.ptr();
+	const Vector3 *verticesptr = vr.ptr();
+	const BVH *bvhptr = br.ptr();
+	int node_count = bvh.size();
+
+	uint16_t qmin[3], qmax[3];
+	_quantize(p_local_aabb, qmin, qmax);
+
 	FaceShapeSW face; // use this to send in the callback
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr.ptr();
-	params.vertices = vr.ptr();
-	params.bvh = br.ptr();
-	params.callback = p_callback;
-	params.userdata = p_userdata;
+	//stackless walk: nodes are stored depth first, branches know where their subtree ends
+	int i = 0;
+	while (i < node_count) {
+
+		const BVH &b = bvhptr[i];
+
+		bool overlap = b.min[0] <= qmax[0] && b.max[0] >= qmin[0] &&
+					   b.min[1] <= qmax[1] && b.max[1] >= qmin[1] &&
+					   b.min[2] <= qmax[2] && b.max[2] >= qmin[2];
+
+		if (b.data < 0) {
+			i = overlap ? i + 1 : -b.data;
+			continue;
+		}
+
+		i++;
 
-	// cull
-	_cull(0, &params);
+		if (!overlap)
+			continue;
+
+		const Face &f = facesptr[b.data];
+		face.normal = f.normal;
+		face.vertex[0] = verticesptr[f.indices[0]];
+		face.vertex[1] = verticesptr[f.indices[1]];
+		face.vertex[2] = verticesptr[f.indices[2]];
+		p_callback(p_userdata, &face);
+	}
 }
 
 Vector3 ConcavePolygonShapeSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1381,100 +1390,158 @@ struct _VolumeSW_BVH_CompareZ {
 	}
 };
 
-struct _VolumeSW_BVH {
-
-	AABB aabb;
-	_VolumeSW_BVH *left;
-	_VolumeSW_BVH *right;
-
-	int face_index;
-};
+void ConcavePolygonShapeSW::_build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, BVH *p_bvh_array, int &r_count) {
 
-_VolumeSW_BVH *_volume_sw_build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, int &count) {
-
-	_VolumeSW_BVH *bvh = memnew(_VolumeSW_BVH);
+	BVH &node = p_bvh_array[r_count++];
 
 	if (p_size == 1) {
 		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = NULL;
-		bvh->right = NULL;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-
-		bvh->face_index = -1;
+		_quantize(p_elements[0].aabb, node.min, node.max);
+		node.data = p_elements[0].face_index;
+		return;
 	}
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
+	AABB aabb = p_elements[0].aabb;
+	AABB centers(p_elements[0].center, Vector3());
+	for (int i = 1; i < p_size; i++) {
 
-		if (i == 0)
-			aabb = p_elements[i].aabb;
-		else
-			aabb.merge_with(p_elements[i].aabb);
+		aabb.merge_with(p_elements[i].aabb);
+		centers.expand_to(p_elements[i].center);
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
+	_quantize(aabb, node.min, node.max);
+
+	//only the median needs to be in place, no need to fully sort every level
+	int split = p_size / 2;
+
+	switch (centers.get_longest_axis_index()) {
 
 		case 0: {
 
 			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
+			sort_x.nth_element(0, p_size, split, p_elements);
 
 		} break;
 		case 1: {
 
 			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
+			sort_y.nth_element(0, p_size, split, p_elements);
 		} break;
 		case 2: {
 
 			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
+			sort_z.nth_element(0, p_size, split, p_elements);
 		} break;
 	}
 
-	int split = p_size / 2;
-	bvh->left = _volume_sw_build_bvh(p_elements, split, count);
-	bvh->right = _volume_sw_build_bvh(&p_elements[split], p_size - split, count);
+	_build_bvh(p_elements, split, p_bvh_array, r_count);
+	_build_bvh(&p_elements[split], p_size - split, p_bvh_array, r_count);
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
+	node.data = -r_count; //where to continue when skipping this subtree
 }
 
-void ConcavePolygonShapeSW::_fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
+void ConcavePolygonShapeSW::_set_bvh_bounds(const AABB &p_aabb) {
+
+	bvh_origin = p_aabb.position;
+	for (int i = 0; i < 3; i++) {
+		bvh_scale[i] = p_aabb.size[i] > CMP_EPSILON ? 65535.0 / p_aabb.size[i] : 0;
+		bvh_inv_scale[i] = p_aabb.size[i] > CMP_EPSILON ? p_aabb.size[i] / 65535.0 : 0;
+	}
+}
 
-	int idx = p_idx;
+PoolVector<uint8_t> ConcavePolygonShapeSW::_encode_bvh() const {
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	PoolVector<uint8_t> data;
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	int node_count = bvh.size();
+	data.resize(BVH_HEADER_SIZE + node_count * BVH_NODE_SIZE);
 
-	} else {
+	PoolVector<uint8_t>::Write w = data.write();
+	uint8_t *ptr = w.ptr();
 
-		p_bvh_array[p_idx].left = -1;
+	ptr += encode_uint32(BVH_FORMAT_MAGIC, ptr);
+	ptr += encode_uint32(BVH_FORMAT_VERSION, ptr);
+	ptr += encode_uint32(faces.size(), ptr);
+	ptr += encode_uint32(node_count, ptr);
+	for (int i = 0; i < 3; i++) {
+		ptr += encode_float(bvh_origin[i], ptr);
+	}
+	for (int i = 0; i < 3; i++) {
+		ptr += encode_float(bvh_inv_scale[i], ptr);
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	PoolVector<BVH>::Read r = bvh.read();
+	for (int i = 0; i < node_count; i++) {
 
-	} else {
+		const BVH &b = r[i];
+		for (int j = 0; j < 3; j++) {
+			ptr += encode_uint16(b.min[j], ptr);
+		}
+		for (int j = 0; j < 3; j++) {
+			ptr += encode_uint16(b.max[j], ptr);
+		}
+		ptr += encode_uint32(b.data, ptr);
+	}
+
+	return data;
+}
+
+bool ConcavePolygonShapeSW::_decode_bvh(const PoolVector<uint8_t> &p_data) {
+
+	int face_count = faces.size();
+	int node_count = face_count * 2 - 1;
+
+	if (p_data.size() != BVH_HEADER_SIZE + node_count * BVH_NODE_SIZE)
+		return false;
+
+	PoolVector<uint8_t>::Read r = p_data.read();
+	const uint8_t *ptr = r.ptr();
+
+	if (decode_uint32(&ptr[0]) != BVH_FORMAT_MAGIC || decode_uint32(&ptr[4]) != BVH_FORMAT_VERSION)
+		return false;
+	if ((int)decode_uint32(&ptr[8]) != face_count || (int)decode_uint32(&ptr[12]) != node_count)
+		return false;
 
-		p_bvh_array[p_idx].right = -1;
+	Vector3 inv_scale;
+	for (int i = 0; i < 3; i++) {
+		bvh_origin[i] = decode_float(&ptr[16 + i * 4]);
+		inv_scale[i] = decode_float(&ptr[28 + i * 4]);
+	}
+	ptr += BVH_HEADER_SIZE;
+
+	bvh.resize(node_count);
+	PoolVector<BVH>::Write w = bvh.write();
+
+	for (int i = 0; i < node_count; i++) {
+
+		BVH &b = w[i];
+		for (int j = 0; j < 3; j++) {
+			b.min[j] = decode_uint16(&ptr[j * 2]);
+			b.max[j] = decode_uint16(&ptr[6 + j * 2]);
+		}
+		b.data = (int32_t)decode_uint32(&ptr[12]);
+		ptr += BVH_NODE_SIZE;
+
+		//a broken tree must not make traversal read out of bounds, or loop
+		if (b.data >= face_count || (b.data < 0 && (-b.data <= i || -b.data > node_count))) {
+			w = PoolVector<BVH>::Write();
+			bvh.resize(0);
+			return false;
+		}
 	}
 
-	memdelete(p_bvh_tree);
+	for (int i = 0; i < 3; i++) {
+		bvh_inv_scale[i] = inv_scale[i];
+		bvh_scale[i] = inv_scale[i] > 0 ? 1.0 / inv_scale[i] : 0;
+	}
+
+	return true;
 }
 
-void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces) {
+void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces, const PoolVector<uint8_t> &p_bvh) {
+
+	faces.resize(0);
+	vertices.resize(0);
+	bvh.resize(0);
 
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
@@ -1487,12 +1554,6 @@ void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces) {
 	PoolVector<Vector3>::Read r = p_faces.read();
 	const Vector3 *facesr = r.ptr();
 
-	PoolVector<_VolumeSW_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	PoolVector<_VolumeSW_BVH_Element>::Write bvhw = bvh_array.write();
-	_VolumeSW_BVH_Element *bvh_arrayw = bvhw.ptr();
-
 	faces.resize(src_face_count);
 	PoolVector<Face>::Write w = faces.write();
 	Face *facesw = w.ptr();
@@ -1508,9 +1569,6 @@ void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces) {
 
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.position + bvh_arrayw[i].aabb.size * 0.5;
-		bvh_arrayw[i].face_index = i;
 		facesw[i].indices[0] = i * 3 + 0;
 		facesw[i].indices[1] = i * 3 + 1;
 		facesw[i].indices[2] = i * 3 + 2;
@@ -1519,36 +1577,65 @@ void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces) {
 		verticesw[i * 3 + 1] = face.vertex[1];
 		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0)
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = face.get_aabb();
 		else
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(face.get_aabb());
 	}
 
 	w = PoolVector<Face>::Write();
 	vw = PoolVector<Vector3>::Write();
 
-	int count = 0;
-	_VolumeSW_BVH *bvh_tree = _volume_sw_build_bvh(bvh_arrayw, src_face_count, count);
+	if (p_bvh.size() == 0 || !_decode_bvh(p_bvh)) {
+
+		if (p_bvh.size()) {
+			WARN_PRINT("Stored ConcavePolygonShape BVH does not match its faces, rebuilding it.");
+		}
+
+		PoolVector<_VolumeSW_BVH_Element> bvh_elements;
+		bvh_elements.resize(src_face_count);
 
-	bvh.resize(count + 1);
+		PoolVector<_VolumeSW_BVH_Element>::Write bvhw = bvh_elements.write();
+		_VolumeSW_BVH_Element *bvh_elementsw = bvhw.ptr();
 
-	PoolVector<BVH>::Write bvhw2 = bvh.write();
-	BVH *bvh_arrayw2 = bvhw2.ptr();
+		for (int i = 0; i < src_face_count; i++) {
+
+			bvh_elementsw[i].aabb = Face3(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]).get_aabb();
+			bvh_elementsw[i].center = bvh_elementsw[i].aabb.position + bvh_elementsw[i].aabb.size * 0.5;
+			bvh_elementsw[i].face_index = i;
+		}
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+		_set_bvh_bounds(_aabb);
+
+		bvh.resize(src_face_count * 2 - 1);
+
+		PoolVector<BVH>::Write bvhw2 = bvh.write();
+		int count = 0;
+		_build_bvh(bvh_elementsw, src_face_count, bvhw2.ptr(), count);
+	}
 
 	configure(_aabb); // this type of shape has no margin
 }
 
 void ConcavePolygonShapeSW::set_data(const Variant &p_data) {
 
-	_setup(p_data);
+	if (p_data.get_type() == Variant::DICTIONARY) {
+
+		//faces along with a tree built earlier by get_data(), loaded as is
+		Dictionary d = p_data;
+		ERR_FAIL_COND(!d.has("faces"));
+		_setup(d["faces"], d.has("bvh") ? PoolVector<uint8_t>(d["bvh"]) : PoolVector<uint8_t>());
+	} else {
+
+		_setup(p_data, PoolVector<uint8_t>());
+	}
 }
 
 Variant ConcavePolygonShapeSW::get_data() const {
 
-	return get_faces();
+	Dictionary d;
+	d["faces"] = get_faces();
+	d["bvh"] = _encode_bvh();
+	return d;
 }
 
 ConcavePolygonShapeSW::ConcavePolygonShapeSW() {
@@ -1585,8 +1672,110 @@ Vector3 HeightMapShapeSW::get_support(const Vector3 &p_normal) const {
 	return get_aabb().get_support(p_normal);
 }
 
+void HeightMapShapeSW::_get_cell(const real_t *p_heights, int p_x, int p_z, Vector3 *r_points) const {
+
+	Vector3 pos = origin + Vector3(p_x * cell_size, 0, p_z * cell_size);
+
+	r_points[0] = pos + Vector3(0, p_heights[p_z * width + p_x], 0);
+	r_points[1] = pos + Vector3(cell_size, p_heights[p_z * width + p_x + 1], 0);
+	r_points[2] = pos + Vector3(0, p_heights[(p_z + 1) * width + p_x], cell_size);
+	r_points[3] = pos + Vector3(cell_size, p_heights[(p_z + 1) * width + p_x + 1], cell_size);
+}
+
 bool HeightMapShapeSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
 
+	if (heights.size() == 0)
+		return false;
+
+	//clip the segment against the shape, so the walk below only covers cells it goes through
+	Vector3 rel = p_end - p_begin;
+	real_t t_from = 0;
+	real_t t_to = 1;
+
+	AABB aabb = get_aabb();
+	for (int i = 0; i < 3; i++) {
+
+		real_t from = aabb.position[i];
+		real_t to = aabb.position[i] + aabb.size[i];
+
+		if (Math::abs(rel[i]) < CMP_EPSILON) {
+			if (p_begin[i] < from || p_begin[i] > to)
+				return false;
+			continue;
+		}
+
+		real_t t0 = (from - p_begin[i]) / rel[i];
+		real_t t1 = (to - p_begin[i]) / rel[i];
+		if (t0 > t1)
+			SWAP(t0, t1);
+		t_from = MAX(t_from, t0);
+		t_to = MIN(t_to, t1);
+		if (t_from > t_to)
+			return false;
+	}
+
+	PoolVector<real_t>::Read r = heights.read();
+	const real_t *heightsptr = r.ptr();
+
+	//walk the cells under the segment in order, the first one with a hit has the closest hit
+	Vector3 start = (p_begin + rel * t_from - origin) / cell_size;
+	Vector3 cell_rel = rel / cell_size;
+
+	int x = CLAMP(int(Math::floor(start.x)), 0, width - 2);
+	int z = CLAMP(int(Math::floor(start.z)), 0, depth - 2);
+
+	int step_x = cell_rel.x > 0 ? 1 : -1;
+	int step_z = cell_rel.z > 0 ? 1 : -1;
+
+	real_t delta_x = Math::abs(cell_rel.x) > CMP_EPSILON ? 1.0 / Math::abs(cell_rel.x) : 1e20;
+	real_t delta_z = Math::abs(cell_rel.z) > CMP_EPSILON ? 1.0 / Math::abs(cell_rel.z) : 1e20;
+
+	real_t next_x = Math::abs(cell_rel.x) > CMP_EPSILON ? t_from + ((step_x > 0 ? x + 1 : x) - start.x) / cell_rel.x : 1e20;
+	real_t next_z = Math::abs(cell_rel.z) > CMP_EPSILON ? t_from + ((step_z > 0 ? z + 1 : z) - start.z) / cell_rel.z : 1e20;
+
+	while (true) {
+
+		Vector3 points[4];
+		_get_cell(heightsptr, x, z, points);
+
+		Vector3 res;
+		real_t closest = 1e20;
+		bool found = false;
+
+		if (Geometry::segment_intersects_triangle(p_begin, p_end, points[0], points[1], points[2], &res)) {
+
+			closest = rel.dot(res - p_begin);
+			r_point = res;
+			r_normal = Plane(points[0], points[1], points[2]).normal;
+			found = true;
+		}
+
+		if (Geometry::segment_intersects_triangle(p_begin, p_end, points[1], points[3], points[2], &res) && rel.dot(res - p_begin) < closest) {
+
+			r_point = res;
+			r_normal = Plane(points[1], points[3], points[2]).normal;
+			found = true;
+		}
+
+		if (found)
+			return true;
+
+		if (next_x < next_z) {
+			if (next_x > t_to)
+				break;
+			x += step_x;
+			next_x += delta_x;
+		} else {
+			if (next_z > t_to)
+				break;
+			z += step_z;
+			next_z += delta_z;
+		}
+
+		if (x < 0 || z < 0 || x >= width - 1 || z >= depth - 1)
+			break;
+	}
+
 	return false;
 }
 
@@ -1600,6 +1789,70 @@ Vector3 HeightMapShapeSW::get_closest_point_to(const Vector3 &p_point) const {
 }
 
 void HeightMapShapeSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
+
+	if (heights.size() == 0)
+		return;
+
+	if (!p_local_aabb.intersects_inclusive(get_aabb()))
+		return;
+
+	//cells under the box are found directly from its position, no tree needed
+	Vector3 from = (p_local_aabb.position - origin) / cell_size;
+	Vector3 to = (p_local_aabb.position + p_local_aabb.size - origin) / cell_size;
+
+	int from_x = CLAMP(int(Math::floor(from.x)), 0, width - 2);
+	int from_z = CLAMP(int(Math::floor(from.z)), 0, depth - 2);
+	int to_x = CLAMP(int(Math::floor(to.x)), 0, width - 2);
+	int to_z = CLAMP(int(Math::floor(to.z)), 0, depth - 2);
+
+	real_t min_y = p_local_aabb.position.y;
+	real_t max_y = p_local_aabb.position.y + p_local_aabb.size.y;
+
+	PoolVector<real_t>::Read r = heights.read();
+	const real_t *heightsptr = r.ptr();
+
+	FaceShapeSW face; // use this to send in the callback
+
+	for (int cz = from_z / CHUNK_SIZE; cz <= to_z / CHUNK_SIZE; cz++) {
+
+		for (int cx = from_x / CHUNK_SIZE; cx <= to_x / CHUNK_SIZE; cx++) {
+
+			const Chunk &chunk = chunks[cz * chunks_x + cx];
+			if (chunk.min_height > max_y || chunk.max_height < min_y)
+				continue; //box is fully above or below this chunk
+
+			int chunk_from_x = MAX(from_x, cx * CHUNK_SIZE);
+			int chunk_to_x = MIN(to_x, cx * CHUNK_SIZE + CHUNK_SIZE - 1);
+			int chunk_from_z = MAX(from_z, cz * CHUNK_SIZE);
+			int chunk_to_z = MIN(to_z, cz * CHUNK_SIZE + CHUNK_SIZE - 1);
+
+			for (int z = chunk_from_z; z <= chunk_to_z; z++) {
+
+				for (int x = chunk_from_x; x <= chunk_to_x; x++) {
+
+					Vector3 points[4];
+					_get_cell(heightsptr, x, z, points);
+
+					real_t cell_min = MIN(MIN(points[0].y, points[1].y), MIN(points[2].y, points[3].y));
+					real_t cell_max = MAX(MAX(points[0].y, points[1].y), MAX(points[2].y, points[3].y));
+					if (cell_min > max_y || cell_max < min_y)
+						continue;
+
+					face.vertex[0] = points[0];
+					face.vertex[1] = points[1];
+					face.vertex[2] = points[2];
+					face.normal = Plane(points[0], points[1], points[2]).normal;
+					p_callback(p_userdata, &face);
+
+					face.vertex[0] = points[1];
+					face.vertex[1] = points[3];
+					face.vertex[2] = points[2];
+					face.normal = Plane(points[1], points[3], points[2]).normal;
+					p_callback(p_userdata, &face);
+				}
+			}
+		}
+	}
 }
 
 Vector3 HeightMapShapeSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1613,6 +1866,49 @@ Vector3 HeightMapShapeSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.y * extents.y + extents.y * extents.y));
 }
 
+void HeightMapShapeSW::_update_chunks(int p_from_x, int p_from_z, int p_to_x, int p_to_z) {
+
+	PoolVector<real_t>::Read r = heights.read();
+
+	//a chunk covers CHUNK_SIZE cells, so it also reads the first row and column of the next one
+	for (int cz = p_from_z / CHUNK_SIZE; cz <= p_to_z / CHUNK_SIZE && cz < chunks_z; cz++) {
+
+		for (int cx = p_from_x / CHUNK_SIZE; cx <= p_to_x / CHUNK_SIZE && cx < chunks_x; cx++) {
+
+			Chunk &chunk = chunks.write[cz * chunks_x + cx];
+			chunk.min_height = 1e20;
+			chunk.max_height = -1e20;
+
+			int end_z = MIN(cz * CHUNK_SIZE + CHUNK_SIZE, depth - 1);
+			int end_x = MIN(cx * CHUNK_SIZE + CHUNK_SIZE, width - 1);
+
+			for (int z = cz * CHUNK_SIZE; z <= end_z; z++) {
+				for (int x = cx * CHUNK_SIZE; x <= end_x; x++) {
+					real_t h = r[z * width + x];
+					chunk.min_height = MIN(chunk.min_height, h);
+					chunk.max_height = MAX(chunk.max_height, h);
+				}
+			}
+		}
+	}
+}
+
+void HeightMapShapeSW::_configure_from_chunks() {
+
+	real_t min_height = 1e20;
+	real_t max_height = -1e20;
+	for (int i = 0; i < chunks.size(); i++) {
+		min_height = MIN(min_height, chunks[i].min_height);
+		max_height = MAX(max_height, chunks[i].max_height);
+	}
+
+	AABB aabb;
+	aabb.position = Vector3(origin.x, min_height, origin.z);
+	aabb.size = Vector3((width - 1) * cell_size, max_height - min_height, (depth - 1) * cell_size);
+
+	configure(aabb);
+}
+
 void HeightMapShapeSW::_setup(PoolVector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size) {
 
 	heights = p_heights;
@@ -1620,31 +1916,62 @@ void HeightMapShapeSW::_setup(PoolVector<real_t> p_heights, int p_width, int p_d
 	depth = p_depth;
 	cell_size = p_cell_size;
 
-	PoolVector<real_t>::Read r = heights.read();
+	//centered on the XZ plane, like with other backends
+	origin = Vector3((width - 1) * cell_size * -0.5, 0, (depth - 1) * cell_size * -0.5);
 
-	AABB aabb;
+	chunks_x = (width - 2) / CHUNK_SIZE + 1;
+	chunks_z = (depth - 2) / CHUNK_SIZE + 1;
+	chunks.resize(chunks_x * chunks_z);
 
-	for (int i = 0; i < depth; i++) {
+	_update_chunks(0, 0, width - 2, depth - 2);
+	_configure_from_chunks();
+}
 
-		for (int j = 0; j < width; j++) {
+void HeightMapShapeSW::_update_region(int p_x, int p_z, int p_width, int p_depth, const PoolVector<real_t> &p_heights) {
 
-			real_t h = r[i * width + j];
+	{
+		PoolVector<real_t>::Read r = p_heights.read();
+		PoolVector<real_t>::Write w = heights.write();
 
-			Vector3 pos(j * cell_size, h, i * cell_size);
-			if (i == 0 || j == 0)
-				aabb.position = pos;
-			else
-				aabb.expand_to(pos);
+		for (int z = 0; z < p_depth; z++) {
+			for (int x = 0; x < p_width; x++) {
+				w[(p_z + z) * width + p_x + x] = r[z * p_width + x];
+			}
 		}
 	}
 
-	configure(aabb);
+	//chunks sharing the edited vertices on their far edge need updating too
+	_update_chunks(MAX(p_x - 1, 0), MAX(p_z - 1, 0), MIN(p_x + p_width - 1, width - 2), MIN(p_z + p_depth - 1, depth - 2));
+	_configure_from_chunks();
 }
 
 void HeightMapShapeSW::set_data(const Variant &p_data) {
 
 	ERR_FAIL_COND(p_data.get_type() != Variant::DICTIONARY);
 	Dictionary d = p_data;
+
+	if (d.has("region_x")) {
+
+		//only part of the heights changed, common when streaming terrain in
+		ERR_FAIL_COND(!d.has("region_z"));
+		ERR_FAIL_COND(!d.has("region_width"));
+		ERR_FAIL_COND(!d.has("region_depth"));
+		ERR_FAIL_COND(!d.has("heights"));
+
+		int region_x = d["region_x"];
+		int region_z = d["region_z"];
+		int region_width = d["region_width"];
+		int region_depth = d["region_depth"];
+		PoolVector<real_t> region_heights = d["heights"];
+
+		ERR_FAIL_COND(heights.size() == 0);
+		ERR_FAIL_COND(region_x < 0 || region_z < 0 || region_width <= 0 || region_depth <= 0);
+		ERR_FAIL_COND(region_x + region_width > width || region_z + region_depth > depth);
+		ERR_FAIL_COND(region_heights.size() != (region_width * region_depth));
+		_update_region(region_x, region_z, region_width, region_depth, region_heights);
+		return;
+	}
+
 	ERR_FAIL_COND(!d.has("width"));
 	ERR_FAIL_COND(!d.has("depth"));
 	ERR_FAIL_COND(!d.has("cell_size"));
@@ -1655,8 +1982,8 @@ void HeightMapShapeSW::set_data(const Variant &p_data) {
 	real_t cell_size = d["cell_size"];
 	PoolVector<real_t> heights = d["heights"];
 
-	ERR_FAIL_COND(width <= 0);
-	ERR_FAIL_COND(depth <= 0);
+	ERR_FAIL_COND(width < 2);
+	ERR_FAIL_COND(depth < 2);
 	ERR_FAIL_COND(cell_size <= CMP_EPSILON);
 	ERR_FAIL_COND(heights.size() != (width * depth));
 	_setup(heights, width, depth, cell_size);
@@ -1664,7 +1991,12 @@ void HeightMapShapeSW::set_data(const Variant &p_data) {
 
 Variant HeightMapShapeSW::get_data() const {
 
-	ERR_FAIL_V(Variant());
+	Dictionary d;
+	d["width"] = width;
+	d["depth"] = depth;
+	d["cell_size"] = cell_size;
+	d["heights"] = heights;
+	return d;
 }
 
 HeightMapShapeSW::HeightMapShapeSW() {
@@ -1672,4 +2004,6 @@ HeightMapShapeSW::HeightMapShapeSW() {
 	width = 0;
 	depth = 0;
 	cell_size = 0;
+	chunks_x = 0;
+	chunks_z = 0;
 }
@@ -285,7 +285,7 @@ public:
 	ConvexPolygonShapeSW();
 };
 
-struct _VolumeSW_BVH;
+struct _VolumeSW_BVH_Element;
 struct FaceShapeSW;
 
 struct ConcavePolygonShapeSW : public ConcaveShapeSW {
@@ -300,49 +300,34 @@ struct ConcavePolygonShapeSW : public ConcaveShapeSW {
 	PoolVector<Face> faces;
 	PoolVector<Vector3> vertices;
 
-	struct BVH {
-
-		AABB aabb;
-		int left;
-		int right;
-
-		int face_index;
+	enum {
+		BVH_FORMAT_MAGIC = 0x48564251, // "QBVH"
+		BVH_FORMAT_VERSION = 1,
+		BVH_HEADER_SIZE = 40,
+		BVH_NODE_SIZE = 16,
 	};
 
-	PoolVector<BVH> bvh;
-
-	struct _CullParams {
+	// bounds are quantized to 16 bits inside the shape AABB, nodes are stored depth first
+	struct BVH {
 
-		AABB aabb;
-		Callback callback;
-		void *userdata;
-		const Face *faces;
-		const Vector3 *vertices;
-		const BVH *bvh;
-		FaceShapeSW *face;
+		uint16_t min[3];
+		uint16_t max[3];
+		int32_t data; // leaf: face index, branch: minus the index of the node after its subtree
 	};
 
-	struct _SegmentCullParams {
-
-		Vector3 from;
-		Vector3 to;
-		const Face *faces;
-		const Vector3 *vertices;
-		const BVH *bvh;
-		Vector3 dir;
-
-		Vector3 result;
-		Vector3 normal;
-		real_t min_d;
-		int collisions;
-	};
+	PoolVector<BVH> bvh;
+	Vector3 bvh_origin;
+	Vector3 bvh_scale;
+	Vector3 bvh_inv_scale;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	void _cull(int p_idx, _CullParams *p_params) const;
+	void _quantize(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max) const;
+	void _set_bvh_bounds(const AABB &p_aabb);
+	void _build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, BVH *p_bvh_array, int &r_count);
 
-	void _fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	PoolVector<uint8_t> _encode_bvh() const;
+	bool _decode_bvh(const PoolVector<uint8_t> &p_data);
 
-	void _setup(PoolVector<Vector3> p_faces);
+	void _setup(PoolVector<Vector3> p_faces, const PoolVector<uint8_t> &p_bvh);
 
 public:
 	PoolVector<Vector3> get_faces() const;
@@ -368,15 +353,34 @@ public:
 
 struct HeightMapShapeSW : public ConcaveShapeSW {
 
+	enum {
+		CHUNK_SIZE = 16, // cells per side of a chunk
+	};
+
+	// height range of a block of cells, lets queries skip it without reading its heights
+	struct Chunk {
+
+		real_t min_height;
+		real_t max_height;
+	};
+
 	PoolVector<real_t> heights;
 	int width;
 	int depth;
 	real_t cell_size;
+	Vector3 origin;
+
+	Vector<Chunk> chunks;
+	int chunks_x;
+	int chunks_z;
+
+	_FORCE_INLINE_ void _get_cell(const real_t *p_heights, int p_x, int p_z, Vector3 *r_points) const;
 
-	//void _cull_segment(int p_idx,_SegmentCullParams *p_params) const;
-	//void _cull(int p_idx,_CullParams *p_params) const;
+	void _update_chunks(int p_from_x, int p_from_z, int p_to_x, int p_to_z);
+	void _configure_from_chunks();
 
 	void _setup(PoolVector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size);
+	void _update_region(int p_x, int p_z, int p_width, int p_depth, const PoolVector<real_t> &p_heights);
 
 public:
 	PoolVector<real_t> get_heights() const;
@@ -31,6 +31,7 @@
 #include "space_sw.h"
 
 #include "collision_solver_sw.h"
+#include "os/worker_thread_pool.h"
 #include "physics_server_sw.h"
 #include "project_settings.h"
 
@@ -39,6 +40,40 @@ _FORCE_INLINE_ static bool _can_collide_with(CollisionObjectSW *p_object, uint32
 	return p_object->get_collision_layer() & p_collision_mask;
 }
 
+_FORCE_INLINE_ static bool _intersect_ray_shape(const CollisionObjectSW *p_col_obj, int p_shape_idx, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) {
+
+	Transform inv_xform = p_col_obj->get_shape_inv_transform(p_shape_idx) * p_col_obj->get_inv_transform();
+
+	Vector3 local_from = inv_xform.xform(p_begin);
+	Vector3 local_to = inv_xform.xform(p_end);
+
+	const ShapeSW *shape = p_col_obj->get_shape(p_shape_idx);
+
+	Vector3 shape_point, shape_normal;
+
+	if (!shape->intersect_segment(local_from, local_to, shape_point, shape_normal))
+		return false;
+
+	Transform xform = p_col_obj->get_transform() * p_col_obj->get_shape_transform(p_shape_idx);
+	r_point = xform.xform(shape_point);
+	r_normal = inv_xform.basis.xform_inv(shape_normal).normalized();
+
+	return true;
+}
+
+_FORCE_INLINE_ static void _fill_ray_result(const CollisionObjectSW *p_col_obj, int p_shape_idx, const Vector3 &p_point, const Vector3 &p_normal, PhysicsDirectSpaceState::RayResult &r_result) {
+
+	r_result.collider_id = p_col_obj->get_instance_id();
+	if (r_result.collider_id != 0)
+		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
+	else
+		r_result.collider = NULL;
+	r_result.normal = p_normal;
+	r_result.position = p_point;
+	r_result.rid = p_col_obj->get_self();
+	r_result.shape = p_shape_idx;
+}
+
 int PhysicsDirectSpaceStateSW::intersect_point(const Vector3 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
 
 	ERR_FAIL_COND_V(space->locked, false);
@@ -117,19 +152,10 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 		const CollisionObjectSW *col_obj = space->intersection_query_results[i];
 
 		int shape_idx = space->intersection_query_subindex_results[i];
-		Transform inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
-
-		Vector3 local_from = inv_xform.xform(begin);
-		Vector3 local_to = inv_xform.xform(end);
-
-		const ShapeSW *shape = col_obj->get_shape(shape_idx);
 
 		Vector3 shape_point, shape_normal;
 
-		if (shape->intersect_segment(local_from, local_to, shape_point, shape_normal)) {
-
-			Transform xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-			shape_point = xform.xform(shape_point);
+		if (_intersect_ray_shape(col_obj, shape_idx, begin, end, shape_point, shape_normal)) {
 
 			real_t ld = normal.dot(shape_point);
 
@@ -137,7 +163,7 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 
 				min_d = ld;
 				res_point = shape_point;
-				res_normal = inv_xform.basis.xform_inv(shape_normal).normalized();
+				res_normal = shape_normal;
 				res_shape = shape_idx;
 				res_obj = col_obj;
 				collided = true;
@@ -148,19 +174,154 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 	if (!collided)
 		return false;
 
-	r_result.collider_id = res_obj->get_instance_id();
-	if (r_result.collider_id != 0)
-		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
-	else
-		r_result.collider = NULL;
-	r_result.normal = res_normal;
-	r_result.position = res_point;
-	r_result.rid = res_obj->get_self();
-	r_result.shape = res_shape;
+	_fill_ray_result(res_obj, res_shape, res_point, res_normal, r_result);
 
 	return true;
 }
 
+void PhysicsDirectSpaceStateSW::_ray_batch_chunk(void *p_userdata, uint32_t p_index) {
+
+	const RayBatch *batch = (const RayBatch *)p_userdata;
+	const RayBatchChunk &chunk = batch->chunks[p_index];
+
+	if (chunk.candidate_count < 0)
+		return; // cast one by one afterwards
+
+	const CollisionObjectSW *const *candidates = &batch->candidates[chunk.candidate_from];
+	const int *candidate_shapes = &batch->candidate_shapes[chunk.candidate_from];
+
+	for (int i = chunk.from_ray; i < chunk.from_ray + chunk.ray_count; i++) {
+
+		Vector3 begin = batch->from[i];
+		Vector3 end = begin + batch->dir[i];
+		Vector3 normal = batch->dir[i].normalized();
+
+		bool collided = false;
+		Vector3 res_point, res_normal;
+		int res_shape;
+		const CollisionObjectSW *res_obj;
+		real_t min_d = 1e10;
+
+		for (int j = 0; j < chunk.candidate_count; j++) {
+
+			const CollisionObjectSW *col_obj = candidates[j];
+			int shape_idx = candidate_shapes[j];
+
+			if (!col_obj->get_shape_aabb(shape_idx).intersects_segment(begin, end))
+				continue;
+
+			Vector3 shape_point, shape_normal;
+
+			if (_intersect_ray_shape(col_obj, shape_idx, begin, end, shape_point, shape_normal)) {
+
+				real_t ld = normal.dot(shape_point);
+
+				if (ld < min_d) {
+
+					min_d = ld;
+					res_point = shape_point;
+					res_normal = shape_normal;
+					res_shape = shape_idx;
+					res_obj = col_obj;
+					collided = true;
+				}
+			}
+		}
+
+		batch->hits[i] = collided;
+		if (collided) {
+			_fill_ray_result(res_obj, res_shape, res_point, res_normal, batch->results[i]);
+		}
+	}
+}
+
+int PhysicsDirectSpaceStateSW::intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	if (p_ray_count <= 0)
+		return 0;
+
+	int chunk_count = (p_ray_count + RAY_BATCH_CHUNK - 1) / RAY_BATCH_CHUNK;
+	ray_batch_chunks.resize(chunk_count);
+	ray_batch_candidates.clear();
+	ray_batch_candidate_shapes.clear();
+
+	// the broadphase is not safe to query from several threads, so gather the candidates of every chunk first
+	for (int i = 0; i < chunk_count; i++) {
+
+		RayBatchChunk &chunk = ray_batch_chunks.write[i];
+		chunk.from_ray = i * RAY_BATCH_CHUNK;
+		chunk.ray_count = MIN(RAY_BATCH_CHUNK, p_ray_count - chunk.from_ray);
+		chunk.candidate_from = ray_batch_candidates.size();
+		chunk.candidate_count = 0;
+
+		AABB aabb(p_from[chunk.from_ray], Vector3());
+		for (int j = chunk.from_ray; j < chunk.from_ray + chunk.ray_count; j++) {
+			aabb.expand_to(p_from[j]);
+			aabb.expand_to(p_from[j] + p_dir[j]);
+		}
+
+		int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+		if (amount == SpaceSW::INTERSECTION_QUERY_MAX) {
+			chunk.candidate_count = -1; // may have missed objects
+			continue;
+		}
+
+		for (int j = 0; j < amount; j++) {
+
+			if (!_can_collide_with(space->intersection_query_results[j], p_collision_mask))
+				continue;
+
+			if (p_exclude.has(space->intersection_query_results[j]->get_self()))
+				continue;
+
+			ray_batch_candidates.push_back(space->intersection_query_results[j]);
+			ray_batch_candidate_shapes.push_back(space->intersection_query_subindex_results[j]);
+			chunk.candidate_count++;
+		}
+	}
+
+	RayBatch batch;
+	batch.from = p_from;
+	batch.dir = p_dir;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.chunks = ray_batch_chunks.ptr();
+	batch.candidates = ray_batch_candidates.ptr();
+	batch.candidate_shapes = ray_batch_candidate_shapes.ptr();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && chunk_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_ray_batch_chunk, &batch, chunk_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < chunk_count; i++) {
+			_ray_batch_chunk(&batch, i);
+		}
+	}
+
+	int hit_count = 0;
+
+	for (int i = 0; i < chunk_count; i++) {
+
+		const RayBatchChunk &chunk = ray_batch_chunks[i];
+
+		for (int j = chunk.from_ray; j < chunk.from_ray + chunk.ray_count; j++) {
+
+			if (chunk.candidate_count < 0) {
+				r_hits[j] = intersect_ray(p_from[j], p_from[j] + p_dir[j], r_results[j], p_exclude, p_collision_mask);
+			}
+
+			if (r_hits[j])
+				hit_count++;
+		}
+	}
+
+	return hit_count;
+}
+
 int PhysicsDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
 
 	if (p_result_max <= 0)
@@ -968,6 +1129,9 @@ void SpaceSW::setup() {
 		inertia_update_list.first()->self()->update_inertias();
 		inertia_update_list.remove(inertia_update_list.first());
 	}
+
+	//broadphases that pair in batches need objects moved since the last step paired before solving
+	broadphase->update();
 }
 
 void SpaceSW::update() {
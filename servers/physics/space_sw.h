@@ -48,8 +48,39 @@ class PhysicsDirectSpaceStateSW : public PhysicsDirectSpaceState {
 public:
 	SpaceSW *space;
 
+private:
+	enum {
+		RAY_BATCH_CHUNK = 64
+	};
+
+	// consecutive rays of a batch share one broadphase query
+	struct RayBatchChunk {
+		int from_ray;
+		int ray_count;
+		int candidate_from;
+		int candidate_count; // -1 if the broadphase query overflowed
+	};
+
+	struct RayBatch {
+		const Vector3 *from;
+		const Vector3 *dir;
+		RayResult *results;
+		bool *hits;
+		const RayBatchChunk *chunks;
+		const CollisionObjectSW *const *candidates;
+		const int *candidate_shapes;
+	};
+
+	Vector<RayBatchChunk> ray_batch_chunks;
+	Vector<const CollisionObjectSW *> ray_batch_candidates;
+	Vector<int> ray_batch_candidate_shapes;
+
+	static void _ray_batch_chunk(void *p_userdata, uint32_t p_index);
+
+public:
 	virtual int intersect_point(const Vector3 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual bool intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_pick_ray = false);
+	virtual int intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual int intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual bool cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, ShapeRestInfo *r_info = NULL);
 	virtual bool collide_shape(RID p_shape, const Transform &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
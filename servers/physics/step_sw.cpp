@@ -32,6 +32,23 @@
 #include "joints_sw.h"
 
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
+
+// Constraints that touch state shared between islands (areas, or static and
+// kinematic bodies that record contacts) can't be set up from several threads.
+static _FORCE_INLINE_ bool _is_island_local(const ConstraintSW *p_constraint) {
+
+	if (p_constraint->get_body_count() < 2)
+		return false;
+
+	for (int i = 0; i < p_constraint->get_body_count(); i++) {
+		const BodySW *b = p_constraint->get_body_ptr()[i];
+		if (b->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && b->can_report_contacts())
+			return false;
+	}
+
+	return true;
+}
 
 void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
 
@@ -69,6 +86,38 @@ void StepSW::_setup_island(ConstraintSW *p_island, real_t p_delta) {
 	}
 }
 
+void StepSW::_setup_island_local(ConstraintSW *p_island, real_t p_delta) {
+
+	ConstraintSW *ci = p_island;
+	while (ci) {
+		if (_is_island_local(ci))
+			ci->setup(p_delta);
+		ci = ci->get_island_next();
+	}
+}
+
+void StepSW::_setup_island_shared(ConstraintSW *p_island, real_t p_delta) {
+
+	ConstraintSW *ci = p_island;
+	while (ci) {
+		if (!_is_island_local(ci))
+			ci->setup(p_delta);
+		ci = ci->get_island_next();
+	}
+}
+
+void StepSW::_setup_island_threaded(void *p_userdata, uint32_t p_index) {
+
+	StepSW *self = (StepSW *)p_userdata;
+	self->_setup_island_local(self->constraint_islands[p_index], self->threaded_delta);
+}
+
+void StepSW::_solve_island_threaded(void *p_userdata, uint32_t p_index) {
+
+	StepSW *self = (StepSW *)p_userdata;
+	self->_solve_island(self->constraint_islands[p_index], self->threaded_iterations, self->threaded_delta);
+}
+
 void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta) {
 
 	int at_priority = 1;
@@ -231,7 +280,37 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	//print_line("island count: "+itos(island_count)+" active count: "+itos(active_count));
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	// Islands share no dynamic bodies, so they can be set up and solved in any
+	// order (and on any thread) with the same result.
+	bool threaded = threaded_islands && pool && pool->get_thread_count() > 0 && !p_space->is_debugging_contacts();
+
+	if (threaded) {
+
+		constraint_islands.clear();
+		ConstraintSW *ci = constraint_island_list;
+		while (ci) {
+			constraint_islands.push_back(ci);
+			ci = ci->get_island_list_next();
+		}
+
+		threaded = constraint_islands.size() > 1;
+	}
+
+	if (threaded) {
+
+		threaded_delta = p_delta;
+		threaded_iterations = p_iterations;
+
+		WorkerThreadPool::GroupID group = pool->add_group_task(_setup_island_threaded, this, constraint_islands.size(), WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+
+		for (int i = 0; i < constraint_islands.size(); i++) {
+			_setup_island_shared(constraint_islands[i], p_delta);
+		}
+
+	} else {
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
 
@@ -248,7 +327,12 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
+	if (threaded) {
+
+		WorkerThreadPool::GroupID group = pool->add_group_task(_solve_island_threaded, this, constraint_islands.size(), WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+
+	} else {
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
 			//iterating each island separatedly improves cache efficiency
@@ -297,4 +381,7 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 StepSW::StepSW() {
 
 	_step = 1;
+	threaded_islands = false;
+	threaded_delta = 0;
+	threaded_iterations = 0;
 }
@@ -37,12 +37,25 @@ class StepSW {
 
 	uint64_t _step;
 
+	bool threaded_islands;
+	Vector<ConstraintSW *> constraint_islands;
+	real_t threaded_delta;
+	int threaded_iterations;
+
 	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
 	void _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(BodySW *p_island, real_t p_delta);
 
+	void _setup_island_local(ConstraintSW *p_island, real_t p_delta);
+	void _setup_island_shared(ConstraintSW *p_island, real_t p_delta);
+	static void _setup_island_threaded(void *p_userdata, uint32_t p_index);
+	static void _solve_island_threaded(void *p_userdata, uint32_t p_index);
+
 public:
+	void set_threaded_islands(bool p_enable) { threaded_islands = p_enable; }
+	bool is_threaded_islands() const { return threaded_islands; }
+
 	void step(SpaceSW *p_space, real_t p_delta, int p_iterations);
 	StepSW();
 };
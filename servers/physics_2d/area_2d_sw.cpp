@@ -170,6 +170,42 @@ void Area2DSW::set_monitorable(bool p_monitorable) {
 	_set_static(!monitorable);
 }
 
+void Area2DSW::_call_monitor_batch(Object *p_receiver, const StringName &p_method, const Map<BodyKey, BodyState> &p_monitored) {
+
+	// all the events of this step go in a single call, packed as
+	// (status, instance_id, body_shape, area_shape) groups of ints
+	PoolIntArray events;
+	events.resize(p_monitored.size() * Physics2DServer::AREA_MONITOR_EVENT_SIZE);
+
+	int count = 0;
+	{
+		PoolIntArray::Write w = events.write();
+
+		for (const Map<BodyKey, BodyState>::Element *E = p_monitored.front(); E; E = E->next()) {
+
+			if (E->get().state == 0)
+				continue; //nothing happened
+
+			int *event = &w[count * Physics2DServer::AREA_MONITOR_EVENT_SIZE];
+			event[Physics2DServer::AREA_MONITOR_EVENT_STATUS] = E->get().state > 0 ? Physics2DServer::AREA_BODY_ADDED : Physics2DServer::AREA_BODY_REMOVED;
+			event[Physics2DServer::AREA_MONITOR_EVENT_INSTANCE_ID] = E->key().instance_id;
+			event[Physics2DServer::AREA_MONITOR_EVENT_BODY_SHAPE] = E->key().body_shape;
+			event[Physics2DServer::AREA_MONITOR_EVENT_AREA_SHAPE] = E->key().area_shape;
+			count++;
+		}
+	}
+
+	if (count == 0)
+		return;
+
+	events.resize(count * Physics2DServer::AREA_MONITOR_EVENT_SIZE);
+
+	Variant arg = events;
+	const Variant *argptr = &arg;
+	Variant::CallError ce;
+	p_receiver->call(p_method, &argptr, 1, ce);
+}
+
 void Area2DSW::call_queries() {
 
 	if (monitor_callback_id && !monitored_bodies.empty()) {
@@ -186,19 +222,25 @@ void Area2DSW::call_queries() {
 			return;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_bodies.front(); E; E = E->next()) {
+		if (monitor_batching) {
 
-			if (E->get().state == 0)
-				continue; //nothing happened
+			_call_monitor_batch(obj, monitor_callback_method, monitored_bodies);
+		} else {
+
+			for (Map<BodyKey, BodyState>::Element *E = monitored_bodies.front(); E; E = E->next()) {
 
-			res[0] = E->get().state > 0 ? Physics2DServer::AREA_BODY_ADDED : Physics2DServer::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+				if (E->get().state == 0)
+					continue; //nothing happened
 
-			Variant::CallError ce;
-			obj->call(monitor_callback_method, (const Variant **)resptr, 5, ce);
+				res[0] = E->get().state > 0 ? Physics2DServer::AREA_BODY_ADDED : Physics2DServer::AREA_BODY_REMOVED;
+				res[1] = E->key().rid;
+				res[2] = E->key().instance_id;
+				res[3] = E->key().body_shape;
+				res[4] = E->key().area_shape;
+
+				Variant::CallError ce;
+				obj->call(monitor_callback_method, (const Variant **)resptr, 5, ce);
+			}
 		}
 	}
 
@@ -218,19 +260,25 @@ void Area2DSW::call_queries() {
 			return;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_areas.front(); E; E = E->next()) {
+		if (monitor_batching) {
 
-			if (E->get().state == 0)
-				continue; //nothing happened
+			_call_monitor_batch(obj, area_monitor_callback_method, monitored_areas);
+		} else {
+
+			for (Map<BodyKey, BodyState>::Element *E = monitored_areas.front(); E; E = E->next()) {
+
+				if (E->get().state == 0)
+					continue; //nothing happened
 
-			res[0] = E->get().state > 0 ? Physics2DServer::AREA_BODY_ADDED : Physics2DServer::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+				res[0] = E->get().state > 0 ? Physics2DServer::AREA_BODY_ADDED : Physics2DServer::AREA_BODY_REMOVED;
+				res[1] = E->key().rid;
+				res[2] = E->key().instance_id;
+				res[3] = E->key().body_shape;
+				res[4] = E->key().area_shape;
 
-			Variant::CallError ce;
-			obj->call(area_monitor_callback_method, (const Variant **)resptr, 5, ce);
+				Variant::CallError ce;
+				obj->call(area_monitor_callback_method, (const Variant **)resptr, 5, ce);
+			}
 		}
 	}
 
@@ -257,6 +305,7 @@ Area2DSW::Area2DSW() :
 	priority = 0;
 	monitor_callback_id = 0;
 	area_monitor_callback_id = 0;
+	monitor_batching = false;
 	monitorable = false;
 }
 
@@ -405,7 +405,7 @@ void Body2DSW::_compute_area_gravity_and_dampenings(const Area2DSW *p_area) {
 	area_angular_damp += p_area->get_angular_damp();
 }
 
-void Body2DSW::integrate_forces(real_t p_step) {
+void Body2DSW::integrate_forces(real_t p_step, bool p_defer_motion) {
 
 	if (mode == Physics2DServer::BODY_MODE_STATIC)
 		return;
@@ -523,8 +523,16 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	biased_angular_velocity = 0;
 	biased_linear_velocity = Vector2();
 
-	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+	if (do_motion) { //shapes temporarily extend for speculative contacts
+		real_t rotation = continuous_cd_mode != Physics2DServer::CCD_MODE_DISABLED ? Math::abs(angular_velocity) * p_step : 0;
+		if (p_defer_motion) {
+			//touches the broadphase, must be done by the caller from a single thread
+			deferred_motion = motion;
+			deferred_rotation = rotation;
+			has_deferred_motion = true;
+		} else {
+			_update_shapes_with_motion(motion, rotation);
+		}
 	}
 
 	// damp_area=NULL; // clear the area, so it is set in the next frame
@@ -532,6 +540,13 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	contact_count = 0;
 }
 
+void Body2DSW::apply_deferred_motion() {
+
+	ERR_FAIL_COND(!has_deferred_motion);
+	_update_shapes_with_motion(deferred_motion, deferred_rotation);
+	has_deferred_motion = false;
+}
+
 void Body2DSW::integrate_velocities(real_t p_step) {
 
 	if (mode == Physics2DServer::BODY_MODE_STATIC)
@@ -681,6 +696,8 @@ Body2DSW::Body2DSW() :
 	contact_count = 0;
 	gravity_scale = 1.0;
 	first_integration = false;
+	has_deferred_motion = false;
+	deferred_rotation = 0;
 
 	still_time = 0;
 	continuous_cd_mode = Physics2DServer::CCD_MODE_DISABLED;
@@ -79,6 +79,9 @@ class Body2DSW : public CollisionObject2DSW {
 	bool can_sleep;
 	bool first_time_kinematic;
 	bool first_integration;
+	bool has_deferred_motion;
+	Vector2 deferred_motion;
+	real_t deferred_rotation;
 	void _update_inertia();
 	virtual void _shapes_changed();
 	Transform2D new_transform;
@@ -272,9 +275,12 @@ public:
 	_FORCE_INLINE_ real_t get_linear_damp() const { return linear_damp; }
 	_FORCE_INLINE_ real_t get_angular_damp() const { return angular_damp; }
 
-	void integrate_forces(real_t p_step);
+	void integrate_forces(real_t p_step, bool p_defer_motion = false);
 	void integrate_velocities(real_t p_step);
 
+	_FORCE_INLINE_ bool is_motion_deferred() const { return has_deferred_motion; }
+	void apply_deferred_motion();
+
 	_FORCE_INLINE_ Vector2 get_motion() const {
 
 		if (mode > Physics2DServer::BODY_MODE_KINEMATIC) {
@@ -35,14 +35,14 @@
 #define POSITION_CORRECTION
 #define ACCUMULATE_IMPULSES
 
-void BodyPair2DSW::_add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self) {
+void BodyPair2DSW::_add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_self) {
 
 	BodyPair2DSW *self = (BodyPair2DSW *)p_self;
 
-	self->_contact_added_callback(p_point_A, p_point_B);
+	self->_contact_added_callback(p_point_A, p_point_B, p_feature);
 }
 
-void BodyPair2DSW::_contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B) {
+void BodyPair2DSW::_contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature) {
 
 	// check if we already have the contact
 
@@ -63,26 +63,51 @@ void BodyPair2DSW::_contact_added_callback(const Vector2 &p_point_A, const Vecto
 	contact.reused = true;
 	contact.normal = (p_point_A - p_point_B).normalized();
 	contact.mass_normal = 0; // will be computed in setup()
+	contact.feature = p_feature;
 
 	// attempt to determine if the contact will be reused
 
 	real_t recycle_radius_2 = space->get_contact_recycle_radius() * space->get_contact_recycle_radius();
 
+	int reuse_index = -1;
+
+	// a support point stays put in the shape that owns it, even while the other one slides over it,
+	// so a contact from the same feature only needs to match on that side
+	bool owned_by_B = p_feature & CollisionSolver2DSW::FEATURE_SHAPE_B;
+
 	for (int i = 0; i < contact_count; i++) {
 
-		Contact &c = contacts[i];
+		const Contact &c = contacts[i];
+		if (c.reused || c.feature != p_feature)
+			continue; // already replaced by a contact of this step, or another feature
+
+		real_t dist_2 = owned_by_B ? c.local_B.distance_squared_to(local_B) : c.local_A.distance_squared_to(local_A);
+		if (dist_2 < recycle_radius_2) {
+			reuse_index = i;
+			break;
+		}
+	}
+
+	for (int i = 0; reuse_index == -1 && i < contact_count; i++) {
+
+		const Contact &c = contacts[i];
 		if (
 				c.local_A.distance_squared_to(local_A) < (recycle_radius_2) &&
 				c.local_B.distance_squared_to(local_B) < (recycle_radius_2)) {
 
-			contact.acc_normal_impulse = c.acc_normal_impulse;
-			contact.acc_tangent_impulse = c.acc_tangent_impulse;
-			contact.acc_bias_impulse = c.acc_bias_impulse;
-			new_index = i;
-			break;
+			reuse_index = i;
 		}
 	}
 
+	if (reuse_index != -1) {
+
+		const Contact &c = contacts[reuse_index];
+		contact.acc_normal_impulse = c.acc_normal_impulse;
+		contact.acc_tangent_impulse = c.acc_tangent_impulse;
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		new_index = reuse_index;
+	}
+
 	// figure out if the contact amount must be reduced to fit the new contact
 
 	if (new_index == MAX_CONTACTS) {
@@ -212,13 +237,103 @@ bool BodyPair2DSW::_test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const
 	//create a contact
 
 	if (p_swap_result)
-		_contact_added_callback(contact_B, contact_A);
+		_contact_added_callback(contact_B, contact_A, CollisionSolver2DSW::FEATURE_SHAPE_B);
 	else
-		_contact_added_callback(contact_A, contact_B);
+		_contact_added_callback(contact_A, contact_B, 0);
 
 	return true;
 }
 
+void BodyPair2DSW::_add_speculative_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_userdata) {
+
+	SpeculativeResult *result = (SpeculativeResult *)p_userdata;
+
+	//keep the deepest pair, it is the closest one once the margin is taken away
+	real_t depth = p_point_A.distance_to(p_point_B);
+	if (!result->found || depth > result->depth) {
+		result->point_A = p_point_A;
+		result->point_B = p_point_B;
+		result->depth = depth;
+		result->found = true;
+	}
+}
+
+bool BodyPair2DSW::_setup_speculative(real_t p_step, const Shape2DSW *p_shape_A, const Transform2D &p_xform_A, const Shape2DSW *p_shape_B, const Transform2D &p_xform_B) {
+
+	//how much closer the shapes can get during this step, rotation only bounded by the arc they sweep
+	real_t rotation_slack = (Math::abs(A->get_angular_velocity()) * A->get_shape_aabb(shape_A).size.length() + Math::abs(B->get_angular_velocity()) * B->get_shape_aabb(shape_B).size.length()) * 0.5;
+	real_t margin = ((B->get_linear_velocity() - A->get_linear_velocity()).length() + rotation_slack) * p_step;
+
+	if (margin < CMP_EPSILON)
+		return false;
+
+	//separating axis test with A grown by the margin, contacts come out on the grown shape
+	SpeculativeResult result;
+	result.depth = 0;
+	result.found = false;
+
+	if (!CollisionSolver2DSW::solve(p_shape_A, p_xform_A, Vector2(), p_shape_B, p_xform_B, Vector2(), _add_speculative_contact, &result, NULL, margin, 0) || !result.found)
+		return false;
+
+	real_t distance = margin - result.depth;
+	if (distance < CMP_EPSILON || result.depth < CMP_EPSILON)
+		return false; //touching, regular contacts take over next step
+
+	Vector2 normal = (result.point_A - result.point_B) / result.depth;
+	Vector2 point_A = result.point_A - normal * margin;
+
+	Vector2 rA = point_A;
+	Vector2 rB = result.point_B - offset_B;
+
+	Vector2 crA(-A->get_angular_velocity() * rA.y, A->get_angular_velocity() * rA.x);
+	Vector2 crB(-B->get_angular_velocity() * rB.y, B->get_angular_velocity() * rB.x);
+	Vector2 dv = B->get_linear_velocity() + crB - A->get_linear_velocity() - crA;
+
+	if ((rotation_slack - dv.dot(normal)) * p_step < distance)
+		return false; //can't meet during this step
+
+	real_t rnA = rA.dot(normal);
+	real_t rnB = rB.dot(normal);
+	real_t kNormal = A->get_inv_mass() + B->get_inv_mass();
+	kNormal += A->get_inv_inertia() * (rA.dot(rA) - rnA * rnA) + B->get_inv_inertia() * (rB.dot(rB) - rnB * rnB);
+
+	speculative.active = true;
+	speculative.normal = normal;
+	speculative.rA = rA;
+	speculative.rB = rB;
+	speculative.mass_normal = 1.0f / kNormal;
+	speculative.gap_velocity = distance / p_step;
+	speculative.acc_normal_impulse = 0;
+
+#ifdef DEBUG_ENABLED
+	if (space->is_debugging_contacts()) {
+		Vector2 offset_A = A->get_transform().get_origin();
+		space->add_debug_contact(point_A + offset_A);
+		space->add_debug_contact(result.point_B + offset_A);
+	}
+#endif
+
+	return true;
+}
+
+void BodyPair2DSW::_solve_speculative() {
+
+	SpeculativeContact &s = speculative;
+
+	Vector2 crA(-A->get_angular_velocity() * s.rA.y, A->get_angular_velocity() * s.rA.x);
+	Vector2 crB(-B->get_angular_velocity() * s.rB.y, B->get_angular_velocity() * s.rB.x);
+	Vector2 dv = B->get_linear_velocity() + crB - A->get_linear_velocity() - crA;
+
+	real_t jn = -(dv.dot(s.normal) + s.gap_velocity) * s.mass_normal;
+	real_t jnOld = s.acc_normal_impulse;
+	s.acc_normal_impulse = MAX(jnOld + jn, 0.0f);
+
+	Vector2 j = s.normal * (s.acc_normal_impulse - jnOld);
+
+	A->apply_impulse(s.rA, -j);
+	B->apply_impulse(s.rB, j);
+}
+
 real_t combine_bounce(Body2DSW *A, Body2DSW *B) {
 	return CLAMP(A->get_bounce() + B->get_bounce(), 0, 1);
 }
@@ -229,6 +344,8 @@ real_t combine_friction(Body2DSW *A, Body2DSW *B) {
 
 bool BodyPair2DSW::setup(real_t p_step) {
 
+	speculative.active = false;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
@@ -271,16 +388,26 @@ bool BodyPair2DSW::setup(real_t p_step) {
 	collided = CollisionSolver2DSW::solve(shape_A_ptr, xform_A, motion_A, shape_B_ptr, xform_B, motion_B, _add_contact, this, &sep_axis);
 	if (!collided) {
 
-		//test ccd (currently just a raycast)
+		bool ccd_A = A->get_continuous_collision_detection_mode() == Physics2DServer::CCD_MODE_CAST_RAY && A->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC;
+		bool ccd_B = B->get_continuous_collision_detection_mode() == Physics2DServer::CCD_MODE_CAST_RAY && B->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC;
 
-		if (A->get_continuous_collision_detection_mode() == Physics2DServer::CCD_MODE_CAST_RAY && A->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC) {
-			if (_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B))
-				collided = true;
-		}
+		if (ccd_A || ccd_B) {
+
+			if (A->is_shape_set_as_one_way_collision(shape_A) || B->is_shape_set_as_one_way_collision(shape_B)) {
 
-		if (B->get_continuous_collision_detection_mode() == Physics2DServer::CCD_MODE_CAST_RAY && B->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC) {
-			if (_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A, true))
-				collided = true;
+				//one way shapes must be able to tell the side the contact comes from, raycast instead
+
+				if (ccd_A && _test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B))
+					collided = true;
+
+				if (ccd_B && _test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A, true))
+					collided = true;
+
+			} else if (_setup_speculative(p_step, shape_A_ptr, xform_A, shape_B_ptr, xform_B)) {
+
+				oneway_disabled = false;
+				return true;
+			}
 		}
 
 		if (!collided) {
@@ -457,6 +584,9 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 void BodyPair2DSW::solve(real_t p_step) {
 
+	if (speculative.active)
+		_solve_speculative();
+
 	if (!collided)
 		return;
 
@@ -523,6 +653,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	contact_count = 0;
 	collided = false;
 	oneway_disabled = false;
+	speculative.active = false;
 }
 
 BodyPair2DSW::~BodyPair2DSW() {
@@ -69,6 +69,7 @@ class BodyPair2DSW : public Constraint2DSW {
 		Vector2 rA, rB;
 		bool reused;
 		real_t bounce;
+		int feature; // CollisionSolver2DSW feature id of the support point this contact comes from
 	};
 
 	Vector2 offset_B; //use local A coordinates to avoid numerical issues on collision detection
@@ -80,10 +81,33 @@ class BodyPair2DSW : public Constraint2DSW {
 	bool oneway_disabled;
 	int cc;
 
+	// contact between shapes that are still apart but can meet during the step,
+	// it only takes away the part of the approach that would close the gap
+	struct SpeculativeContact {
+
+		bool active;
+		Vector2 normal;
+		Vector2 rA, rB;
+		real_t mass_normal;
+		real_t gap_velocity; // approach velocity that exactly closes the gap in one step
+		real_t acc_normal_impulse;
+	} speculative;
+
+	struct SpeculativeResult {
+
+		Vector2 point_A, point_B;
+		real_t depth;
+		bool found;
+	};
+
+	static void _add_speculative_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_userdata);
+	bool _setup_speculative(real_t p_step, const Shape2DSW *p_shape_A, const Transform2D &p_xform_A, const Shape2DSW *p_shape_B, const Transform2D &p_xform_B);
+	void _solve_speculative();
+
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
 	void _validate_contacts();
-	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
-	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
+	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_self);
+	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature);
 
 public:
 	bool setup(real_t p_step);
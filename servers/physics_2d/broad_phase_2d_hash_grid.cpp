@@ -33,66 +33,119 @@
 
 #define LARGE_ELEMENT_FI 1.01239812
 
+BroadPhase2DHashGrid::PairData *BroadPhase2DHashGrid::_alloc_pair() {
+
+	PairData *pd;
+	if (pair_pool.size()) {
+		pd = pair_pool[pair_pool.size() - 1];
+		pair_pool.resize(pair_pool.size() - 1);
+	} else {
+		pd = memnew(PairData);
+	}
+
+	pd->colliding = false;
+	pd->rc = 1;
+	pd->ud = NULL;
+	return pd;
+}
+
+void BroadPhase2DHashGrid::_free_pair(PairData *p_pair) {
+
+	pair_pool.push_back(p_pair);
+}
+
+void BroadPhase2DHashGrid::_remove_paired(Element *p_elem, int p_index) {
+
+	int last = p_elem->paired.size() - 1;
+	if (p_index != last) {
+		PairData *moved = p_elem->paired[last];
+		p_elem->paired.write[p_index] = moved;
+		if (moved->a == p_elem) {
+			moved->index_a = p_index;
+		} else {
+			moved->index_b = p_index;
+		}
+	}
+
+	p_elem->paired.resize(last);
+}
+
 void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
 
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	PairKey key(p_elem->self, p_with->self);
+	PairData *pd;
+
+	if (pair_map.lookup(key.key, pd)) {
+		pd->rc++;
+		return;
+	}
 
 	ERR_FAIL_COND(p_elem->_static && p_with->_static);
 
-	if (!E) {
+	pd = _alloc_pair();
+	pd->a = p_elem;
+	pd->b = p_with;
+	pd->index_a = p_elem->paired.size();
+	pd->index_b = p_with->paired.size();
+	p_elem->paired.push_back(pd);
+	p_with->paired.push_back(pd);
 
-		PairData *pd = memnew(PairData);
-		p_elem->paired[p_with] = pd;
-		p_with->paired[p_elem] = pd;
-	} else {
-		E->get()->rc++;
-	}
+	pair_map.set(key.key, pd);
 }
 
 void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element *p_with) {
 
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	PairKey key(p_elem->self, p_with->self);
+	PairData *pd;
 
-	ERR_FAIL_COND(!E); //this should really be paired..
+	bool found = pair_map.lookup(key.key, pd);
+	ERR_FAIL_COND(!found); //this should really be paired..
 
-	E->get()->rc--;
+	pd->rc--;
 
-	if (E->get()->rc == 0) {
+	if (pd->rc == 0) {
 
-		if (E->get()->colliding) {
+		if (pd->colliding) {
 			//uncollide
 			if (unpair_callback) {
-				unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, E->get()->ud, unpair_userdata);
+				unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, pd->ud, unpair_userdata);
 			}
 		}
 
-		memdelete(E->get());
-		p_elem->paired.erase(E);
-		p_with->paired.erase(p_elem);
+		_remove_paired(pd->a, pd->index_a);
+		_remove_paired(pd->b, pd->index_b);
+		pair_map.remove(key.key);
+		_free_pair(pd);
 	}
 }
 
 void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
 
-	for (Map<Element *, PairData *>::Element *E = p_elem->paired.front(); E; E = E->next()) {
+	PairData **paired = p_elem->paired.ptrw();
+	int paired_count = p_elem->paired.size();
+
+	for (int i = 0; i < paired_count; i++) {
+
+		PairData *pd = paired[i];
+		Element *other = pd->a == p_elem ? pd->b : pd->a;
 
-		bool pairing = p_elem->aabb.intersects(E->key()->aabb);
+		bool pairing = p_elem->aabb.intersects(other->aabb);
 
-		if (pairing != E->get()->colliding) {
+		if (pairing != pd->colliding) {
 
 			if (pairing) {
 
 				if (pair_callback) {
-					E->get()->ud = pair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, pair_userdata);
+					pd->ud = pair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pair_userdata);
 				}
 			} else {
 
 				if (unpair_callback) {
-					unpair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, E->get()->ud, unpair_userdata);
+					unpair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pd->ud, unpair_userdata);
 				}
 			}
 
-			E->get()->colliding = pairing;
+			pd->colliding = pairing;
 		}
 	}
 }
@@ -102,18 +155,19 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI); //use magic number to avoid floating point issues
 	if (sz.width * sz.height > large_object_min_surface) {
 		//large object, do not use grid, must check against all elements
-		for (Map<ID, Element>::Element *E = element_map.front(); E; E = E->next()) {
-			if (E->key() == p_elem->self)
+		for (OAHashMap<ID, Element *>::Iterator it = element_map.iter(); it.valid; it = element_map.next_iter(it)) {
+			Element *elem = *it.value;
+			if (elem == p_elem)
 				continue; // do not pair against itself
-			if (E->get().owner == p_elem->owner)
+			if (elem->owner == p_elem->owner)
 				continue;
-			if (E->get()._static && p_static)
+			if (elem->_static && p_static)
 				continue;
 
-			_pair_attempt(p_elem, &E->get());
+			_pair_attempt(p_elem, elem);
 		}
 
-		large_elements[p_elem].inc();
+		_set_inc(large_elements, p_elem);
 		return;
 	}
 
@@ -144,18 +198,23 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 
 			if (!pb) {
 				//does not exist, create!
-				pb = memnew(PosBin);
+				if (bin_pool) {
+					pb = bin_pool;
+					bin_pool = pb->next;
+				} else {
+					pb = memnew(PosBin);
+				}
 				pb->key = pk;
 				pb->next = hash_table[idx];
 				hash_table[idx] = pb;
 			}
 
 			if (p_static) {
-				if (pb->static_object_set[p_elem].inc() == 1) {
+				if (_set_inc(pb->static_object_set, p_elem) == 1) {
 					entered = true;
 				}
 			} else {
-				if (pb->object_set[p_elem].inc() == 1) {
+				if (_set_inc(pb->object_set, p_elem) == 1) {
 
 					entered = true;
 				}
@@ -163,20 +222,22 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 
 			if (entered) {
 
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+				const ElementRC *objects = pb->object_set.ptr();
+				for (int k = 0; k < pb->object_set.size(); k++) {
 
-					if (E->key()->owner == p_elem->owner)
+					if (objects[k].element->owner == p_elem->owner)
 						continue;
-					_pair_attempt(p_elem, E->key());
+					_pair_attempt(p_elem, objects[k].element);
 				}
 
 				if (!p_static) {
 
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+					const ElementRC *static_objects = pb->static_object_set.ptr();
+					for (int k = 0; k < pb->static_object_set.size(); k++) {
 
-						if (E->key()->owner == p_elem->owner)
+						if (static_objects[k].element->owner == p_elem->owner)
 							continue;
-						_pair_attempt(p_elem, E->key());
+						_pair_attempt(p_elem, static_objects[k].element);
 					}
 				}
 			}
@@ -185,16 +246,17 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 
 	//pair separatedly with large elements
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (int i = 0; i < large_elements.size(); i++) {
 
-		if (E->key() == p_elem)
+		Element *large = large_elements[i].element;
+		if (large == p_elem)
 			continue; // do not pair against itself
-		if (E->key()->owner == p_elem->owner)
+		if (large->owner == p_elem->owner)
 			continue;
-		if (E->key()->_static && p_static)
+		if (large->_static && p_static)
 			continue;
 
-		_pair_attempt(E->key(), p_elem);
+		_pair_attempt(large, p_elem);
 	}
 }
 
@@ -204,16 +266,13 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 	if (sz.width * sz.height > large_object_min_surface) {
 
 		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
-		Map<Element *, PairData *>::Element *E = p_elem->paired.front();
-		while (E) {
-			Map<Element *, PairData *>::Element *next = E->next();
-			_unpair_attempt(p_elem, E->key());
-			E = next;
+		//go backwards, a removed pair is replaced by the last one, which was already visited
+		for (int i = p_elem->paired.size() - 1; i >= 0; i--) {
+			PairData *pd = p_elem->paired[i];
+			_unpair_attempt(p_elem, pd->a == p_elem ? pd->b : pd->a);
 		}
 
-		if (large_elements[p_elem].dec() == 0) {
-			large_elements.erase(p_elem);
-		}
+		_set_dec(large_elements, p_elem);
 		return;
 	}
 
@@ -245,35 +304,35 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 			bool exited = false;
 
 			if (p_static) {
-				if (pb->static_object_set[p_elem].dec() == 0) {
+				if (_set_dec(pb->static_object_set, p_elem) == 0) {
 
-					pb->static_object_set.erase(p_elem);
 					exited = true;
 				}
 			} else {
-				if (pb->object_set[p_elem].dec() == 0) {
+				if (_set_dec(pb->object_set, p_elem) == 0) {
 
-					pb->object_set.erase(p_elem);
 					exited = true;
 				}
 			}
 
 			if (exited) {
 
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+				const ElementRC *objects = pb->object_set.ptr();
+				for (int k = 0; k < pb->object_set.size(); k++) {
 
-					if (E->key()->owner == p_elem->owner)
+					if (objects[k].element->owner == p_elem->owner)
 						continue;
-					_unpair_attempt(p_elem, E->key());
+					_unpair_attempt(p_elem, objects[k].element);
 				}
 
 				if (!p_static) {
 
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+					const ElementRC *static_objects = pb->static_object_set.ptr();
+					for (int k = 0; k < pb->static_object_set.size(); k++) {
 
-						if (E->key()->owner == p_elem->owner)
+						if (static_objects[k].element->owner == p_elem->owner)
 							continue;
-						_unpair_attempt(p_elem, E->key());
+						_unpair_attempt(p_elem, static_objects[k].element);
 					}
 				}
 			}
@@ -299,21 +358,24 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 					ERR_CONTINUE(!px);
 				}
 
-				memdelete(pb);
+				pb->next = bin_pool;
+				bin_pool = pb;
 			}
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
-		if (E->key() == p_elem)
+	for (int i = 0; i < large_elements.size(); i++) {
+
+		Element *large = large_elements[i].element;
+		if (large == p_elem)
 			continue; // do not pair against itself
-		if (E->key()->owner == p_elem->owner)
+		if (large->owner == p_elem->owner)
 			continue;
-		if (E->key()->_static && p_static)
+		if (large->_static && p_static)
 			continue;
 
 		//unpair from large elements
-		_unpair_attempt(p_elem, E->key());
+		_unpair_attempt(p_elem, large);
 	}
 }
 
@@ -321,23 +383,24 @@ BroadPhase2DHashGrid::ID BroadPhase2DHashGrid::create(CollisionObject2DSW *p_obj
 
 	current++;
 
-	Element e;
-	e.owner = p_object;
-	e._static = false;
-	e.subindex = p_subindex;
-	e.self = current;
-	e.pass = 0;
+	Element *e = memnew(Element);
+	e->owner = p_object;
+	e->_static = false;
+	e->subindex = p_subindex;
+	e->self = current;
+	e->pass = 0;
 
-	element_map[current] = e;
+	element_map.insert(current, e);
 	return current;
 }
 
 void BroadPhase2DHashGrid::move(ID p_id, const Rect2 &p_aabb) {
 
-	Map<ID, Element>::Element *E = element_map.find(p_id);
+	Element *E = NULL;
+	element_map.lookup(p_id, E);
 	ERR_FAIL_COND(!E);
 
-	Element &e = E->get();
+	Element &e = *E;
 
 	if (p_aabb == e.aabb)
 		return;
@@ -360,10 +423,11 @@ void BroadPhase2DHashGrid::move(ID p_id, const Rect2 &p_aabb) {
 }
 void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
 
-	Map<ID, Element>::Element *E = element_map.find(p_id);
+	Element *E = NULL;
+	element_map.lookup(p_id, E);
 	ERR_FAIL_COND(!E);
 
-	Element &e = E->get();
+	Element &e = *E;
 
 	if (e._static == p_static)
 		return;
@@ -380,34 +444,39 @@ void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
 }
 void BroadPhase2DHashGrid::remove(ID p_id) {
 
-	Map<ID, Element>::Element *E = element_map.find(p_id);
+	Element *E = NULL;
+	element_map.lookup(p_id, E);
 	ERR_FAIL_COND(!E);
 
-	Element &e = E->get();
+	Element &e = *E;
 
 	if (e.aabb != Rect2())
 		_exit_grid(&e, e.aabb, e._static);
 
-	element_map.erase(p_id);
+	element_map.remove(p_id);
+	memdelete(E);
 }
 
 CollisionObject2DSW *BroadPhase2DHashGrid::get_object(ID p_id) const {
 
-	const Map<ID, Element>::Element *E = element_map.find(p_id);
+	Element *E = NULL;
+	element_map.lookup(p_id, E);
 	ERR_FAIL_COND_V(!E, NULL);
-	return E->get().owner;
+	return E->owner;
 }
 bool BroadPhase2DHashGrid::is_static(ID p_id) const {
 
-	const Map<ID, Element>::Element *E = element_map.find(p_id);
+	Element *E = NULL;
+	element_map.lookup(p_id, E);
 	ERR_FAIL_COND_V(!E, false);
-	return E->get()._static;
+	return E->_static;
 }
 int BroadPhase2DHashGrid::get_subindex(ID p_id) const {
 
-	const Map<ID, Element>::Element *E = element_map.find(p_id);
+	Element *E = NULL;
+	element_map.lookup(p_id, E);
 	ERR_FAIL_COND_V(!E, -1);
-	return E->get().subindex;
+	return E->subindex;
 }
 
 template <bool use_aabb, bool use_segment>
@@ -432,43 +501,49 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, cons
 	if (!pb)
 		return;
 
-	for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+	const ElementRC *objects = pb->object_set.ptr();
+	for (int i = 0; i < pb->object_set.size(); i++) {
 
 		if (index >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *elem = objects[i].element;
+		if (elem->pass == pass)
 			continue;
 
-		E->key()->pass = pass;
+		elem->pass = pass;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
+		if (use_aabb && !p_aabb.intersects(elem->aabb))
 			continue;
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from, p_to))
+		if (use_segment && !elem->aabb.intersects_segment(p_from, p_to))
 			continue;
 
-		p_results[index] = E->key()->owner;
-		p_result_indices[index] = E->key()->subindex;
+		p_results[index] = elem->owner;
+		p_result_indices[index] = elem->subindex;
 		index++;
 	}
 
-	for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+	const ElementRC *static_objects = pb->static_object_set.ptr();
+	for (int i = 0; i < pb->static_object_set.size(); i++) {
 
 		if (index >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *elem = static_objects[i].element;
+		if (elem->pass == pass)
 			continue;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb)) {
+		if (use_aabb && !p_aabb.intersects(elem->aabb)) {
 			continue;
 		}
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from, p_to))
+		if (use_segment && !elem->aabb.intersects_segment(p_from, p_to))
 			continue;
 
-		E->key()->pass = pass;
-		p_results[index] = E->key()->owner;
-		p_result_indices[index] = E->key()->subindex;
+		elem->pass = pass;
+		p_results[index] = elem->owner;
+		p_result_indices[index] = elem->subindex;
 		index++;
 	}
 }
@@ -548,25 +623,27 @@ int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 			break;
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (int i = 0; i < large_elements.size(); i++) {
 
 		if (cullcount >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *elem = large_elements[i].element;
+		if (elem->pass == pass)
 			continue;
 
-		E->key()->pass = pass;
+		elem->pass = pass;
 
 		/*
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
+		if (use_aabb && !p_aabb.intersects(elem->aabb))
 			continue;
 		*/
 
-		if (!E->key()->aabb.intersects_segment(p_from, p_to))
+		if (!elem->aabb.intersects_segment(p_from, p_to))
 			continue;
 
-		p_results[cullcount] = E->key()->owner;
-		p_result_indices[cullcount] = E->key()->subindex;
+		p_results[cullcount] = elem->owner;
+		p_result_indices[cullcount] = elem->subindex;
 		cullcount++;
 	}
 
@@ -589,25 +666,27 @@ int BroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (int i = 0; i < large_elements.size(); i++) {
 
 		if (cullcount >= p_max_results)
 			break;
-		if (E->key()->pass == pass)
+
+		Element *elem = large_elements[i].element;
+		if (elem->pass == pass)
 			continue;
 
-		E->key()->pass = pass;
+		elem->pass = pass;
 
-		if (!p_aabb.intersects(E->key()->aabb))
+		if (!p_aabb.intersects(elem->aabb))
 			continue;
 
 		/*
-		if (!E->key()->aabb.intersects_segment(p_from,p_to))
+		if (!elem->aabb.intersects_segment(p_from,p_to))
 			continue;
 		*/
 
-		p_results[cullcount] = E->key()->owner;
-		p_result_indices[cullcount] = E->key()->subindex;
+		p_results[cullcount] = elem->owner;
+		p_result_indices[cullcount] = elem->subindex;
 		cullcount++;
 	}
 	return cullcount;
@@ -643,6 +722,7 @@ BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
 
 	for (uint32_t i = 0; i < hash_table_size; i++)
 		hash_table[i] = NULL;
+	bin_pool = NULL;
 	pass = 1;
 
 	current = 0;
@@ -658,7 +738,25 @@ BroadPhase2DHashGrid::~BroadPhase2DHashGrid() {
 		}
 	}
 
+	while (bin_pool) {
+		PosBin *pb = bin_pool;
+		bin_pool = pb->next;
+		memdelete(pb);
+	}
+
 	memdelete_arr(hash_table);
+
+	for (OAHashMap<uint64_t, PairData *>::Iterator it = pair_map.iter(); it.valid; it = pair_map.next_iter(it)) {
+		memdelete(*it.value);
+	}
+
+	for (int i = 0; i < pair_pool.size(); i++) {
+		memdelete(pair_pool[i]);
+	}
+
+	for (OAHashMap<ID, Element *>::Iterator it = element_map.iter(); it.valid; it = element_map.next_iter(it)) {
+		memdelete(*it.value);
+	}
 }
 
 /* 3D version of voxel traversal:
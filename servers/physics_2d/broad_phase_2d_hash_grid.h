@@ -32,20 +32,22 @@
 #define BROAD_PHASE_2D_HASH_GRID_H
 
 #include "broad_phase_2d_sw.h"
-#include "map.h"
+#include "oa_hash_map.h"
+#include "vector.h"
 
 class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
+	struct Element;
+
 	struct PairData {
 
+		Element *a;
+		Element *b;
+		int index_a; // position in a->paired
+		int index_b; // position in b->paired
 		bool colliding;
 		int rc;
 		void *ud;
-		PairData() {
-			colliding = false;
-			rc = 1;
-			ud = NULL;
-		}
 	};
 
 	struct Element {
@@ -56,29 +58,54 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		Rect2 aabb;
 		int subindex;
 		uint64_t pass;
-		Map<Element *, PairData *> paired;
+		Vector<PairData *> paired;
 	};
 
-	struct RC {
+	// elements are few per cell, so a flat array beats a tree for both lookup and iteration
+	struct ElementRC {
 
+		Element *element;
 		int ref;
+	};
 
-		_FORCE_INLINE_ int inc() {
-			ref++;
-			return ref;
-		}
-		_FORCE_INLINE_ int dec() {
-			ref--;
-			return ref;
+	typedef Vector<ElementRC> ElementSet;
+
+	_FORCE_INLINE_ static int _set_inc(ElementSet &p_set, Element *p_elem) {
+
+		ElementRC *w = p_set.ptrw();
+		for (int i = 0; i < p_set.size(); i++) {
+			if (w[i].element == p_elem) {
+				return ++w[i].ref;
+			}
 		}
 
-		_FORCE_INLINE_ RC() {
-			ref = 0;
+		ElementRC erc;
+		erc.element = p_elem;
+		erc.ref = 1;
+		p_set.push_back(erc);
+		return 1;
+	}
+
+	_FORCE_INLINE_ static int _set_dec(ElementSet &p_set, Element *p_elem) {
+
+		ElementRC *w = p_set.ptrw();
+		int count = p_set.size();
+		for (int i = 0; i < count; i++) {
+			if (w[i].element == p_elem) {
+				int ref = --w[i].ref;
+				if (ref == 0) {
+					w[i] = w[count - 1];
+					p_set.resize(count - 1);
+				}
+				return ref;
+			}
 		}
-	};
 
-	Map<ID, Element> element_map;
-	Map<Element *, RC> large_elements;
+		ERR_FAIL_V(-1); //should really be in the set..
+	}
+
+	OAHashMap<ID, Element *> element_map;
+	ElementSet large_elements;
 
 	ID current;
 
@@ -110,7 +137,12 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		}
 	};
 
-	Map<PairKey, PairData> pair_map;
+	OAHashMap<uint64_t, PairData *> pair_map;
+	Vector<PairData *> pair_pool;
+
+	PairData *_alloc_pair();
+	void _free_pair(PairData *p_pair);
+	void _remove_paired(Element *p_elem, int p_index);
 
 	int cell_size;
 	int large_object_min_surface;
@@ -155,13 +187,14 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 	struct PosBin {
 
 		PosKey key;
-		Map<Element *, RC> object_set;
-		Map<Element *, RC> static_object_set;
+		ElementSet object_set;
+		ElementSet static_object_set;
 		PosBin *next;
 	};
 
 	uint32_t hash_table_size;
 	PosBin **hash_table;
+	PosBin *bin_pool; // emptied bins, reused before allocating new ones
 
 	void _pair_attempt(Element *p_elem, Element *p_with);
 	void _unpair_attempt(Element *p_elem, Element *p_with);
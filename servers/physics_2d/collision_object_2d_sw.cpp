@@ -180,7 +180,7 @@ void CollisionObject2DSW::_update_shapes() {
 	}
 }
 
-void CollisionObject2DSW::_update_shapes_with_motion(const Vector2 &p_motion) {
+void CollisionObject2DSW::_update_shapes_with_motion(const Vector2 &p_motion, real_t p_rotation) {
 
 	if (!space)
 		return;
@@ -200,6 +200,11 @@ void CollisionObject2DSW::_update_shapes_with_motion(const Vector2 &p_motion) {
 		Rect2 shape_aabb = s.shape->get_aabb();
 		Transform2D xform = transform * s.xform;
 		shape_aabb = xform.xform(shape_aabb);
+		if (p_rotation > 0) {
+			//a rotating shape sweeps at most an arc of its distance to the origin
+			real_t radius = (shape_aabb.position + shape_aabb.size * 0.5 - transform.get_origin()).length() + shape_aabb.size.length() * 0.5;
+			shape_aabb = shape_aabb.grow(radius * MIN(p_rotation, (real_t)2.0));
+		}
 		shape_aabb = shape_aabb.merge(Rect2(shape_aabb.position + p_motion, shape_aabb.size)); //use motion
 		s.aabb_cache = shape_aabb;
 
@@ -78,7 +78,7 @@ private:
 	void _update_shapes();
 
 protected:
-	void _update_shapes_with_motion(const Vector2 &p_motion);
+	void _update_shapes_with_motion(const Vector2 &p_motion, real_t p_rotation = 0);
 	void _unregister_shapes();
 
 	_FORCE_INLINE_ void _set_transform(const Transform2D &p_transform, bool p_update_shapes = true) {
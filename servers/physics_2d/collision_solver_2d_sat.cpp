@@ -41,16 +41,16 @@ struct _CollectorCallback2D {
 	Vector2 normal;
 	Vector2 *sep_axis;
 
-	_FORCE_INLINE_ void call(const Vector2 &p_point_A, const Vector2 &p_point_B) {
+	_FORCE_INLINE_ void call(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature) {
 
 		/*
 		if (normal.dot(p_point_A) >= normal.dot(p_point_B))
 			return;
 		*/
 		if (swap)
-			callback(p_point_B, p_point_A, userdata);
+			callback(p_point_B, p_point_A, p_feature ^ CollisionSolver2DSW::FEATURE_SHAPE_B, userdata);
 		else
-			callback(p_point_A, p_point_B, userdata);
+			callback(p_point_A, p_point_B, p_feature, userdata);
 	}
 };
 
@@ -63,7 +63,7 @@ _FORCE_INLINE_ static void _generate_contacts_point_point(const Vector2 *p_point
 	ERR_FAIL_COND(p_point_count_B != 1);
 #endif
 
-	p_collector->call(*p_points_A, *p_points_B);
+	p_collector->call(*p_points_A, *p_points_B, 0);
 }
 
 _FORCE_INLINE_ static void _generate_contacts_point_edge(const Vector2 *p_points_A, int p_point_count_A, const Vector2 *p_points_B, int p_point_count_B, _CollectorCallback2D *p_collector) {
@@ -74,7 +74,7 @@ _FORCE_INLINE_ static void _generate_contacts_point_edge(const Vector2 *p_points
 #endif
 
 	Vector2 closest_B = Geometry::get_closest_point_to_segment_uncapped_2d(*p_points_A, p_points_B);
-	p_collector->call(*p_points_A, closest_B);
+	p_collector->call(*p_points_A, closest_B, 0);
 }
 
 struct _generate_contacts_Pair {
@@ -121,13 +121,13 @@ _FORCE_INLINE_ static void _generate_contacts_edge_edge(const Vector2 *p_points_
 			Vector2 b = n.plane_project(dB, a);
 			if (n.dot(a) > n.dot(b) - CMP_EPSILON)
 				continue;
-			p_collector->call(a, b);
+			p_collector->call(a, b, dvec[i].idx);
 		} else {
 			Vector2 b = p_points_B[dvec[i].idx];
 			Vector2 a = n.plane_project(dA, b);
 			if (n.dot(a) > n.dot(b) - CMP_EPSILON)
 				continue;
-			p_collector->call(a, b);
+			p_collector->call(a, b, dvec[i].idx | CollisionSolver2DSW::FEATURE_SHAPE_B);
 		}
 	}
 }
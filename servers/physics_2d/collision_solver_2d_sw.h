@@ -35,7 +35,13 @@
 
 class CollisionSolver2DSW {
 public:
-	typedef void (*CallbackResult)(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_userdata);
+	enum {
+		// contacts report the support point they come from as a feature id, an index into the supports
+		// of the shape which owns the point, ORed with this when that shape is B
+		FEATURE_SHAPE_B = 4
+	};
+
+	typedef void (*CallbackResult)(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_userdata);
 
 private:
 	static bool solve_static_line(const Shape2DSW *p_shape_A, const Transform2D &p_transform_A, const Shape2DSW *p_shape_B, const Transform2D &p_transform_B, CallbackResult p_result_callback, void *p_userdata, bool p_swap_result);
@@ -33,6 +33,7 @@
 #include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "os/os.h"
+#include "os/trace.h"
 #include "project_settings.h"
 #include "script_language.h"
 
@@ -157,7 +158,7 @@ real_t Physics2DServerSW::shape_get_custom_solver_bias(RID p_shape) const {
 	return shape->get_custom_bias();
 }
 
-void Physics2DServerSW::_shape_col_cbk(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_userdata) {
+void Physics2DServerSW::_shape_col_cbk(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_userdata) {
 
 	CollCbkData *cbk = (CollCbkData *)p_userdata;
 
@@ -553,6 +554,14 @@ void Physics2DServerSW::area_set_area_monitor_callback(RID p_area, Object *p_rec
 	area->set_area_monitor_callback(p_receiver ? p_receiver->get_instance_id() : 0, p_method);
 }
 
+void Physics2DServerSW::area_set_monitor_batching(RID p_area, bool p_enable) {
+
+	Area2DSW *area = area_owner.get(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 /* BODY API */
 
 RID Physics2DServerSW::body_create() {
@@ -1003,6 +1012,44 @@ bool Physics2DServerSW::body_test_motion(RID p_body, const Transform2D &p_from,
 	return body->get_space()->test_body_motion(body, p_from, p_motion, p_infinite_inertia, p_margin, r_result, p_exclude_raycast_shapes);
 }
 
+int Physics2DServerSW::body_test_motion_batch(const RID *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, real_t p_margin, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes) {
+
+	// bodies in the space of the first one are tested together, the rest one by one
+	Space2DSW *space = NULL;
+	int collided_count = 0;
+
+	motion_batch_bodies.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+
+		Body2DSW *body = body_owner.get(p_bodies[i]);
+		motion_batch_bodies.write[i] = NULL;
+		r_collided[i] = false;
+
+		ERR_CONTINUE(!body);
+		ERR_CONTINUE(!body->get_space());
+		ERR_CONTINUE(body->get_space()->is_locked());
+
+		if (!space) {
+			space = body->get_space();
+		}
+
+		if (body->get_space() == space) {
+			motion_batch_bodies.write[i] = body;
+		} else {
+			r_collided[i] = body->get_space()->test_body_motion(body, p_from[i], p_motions[i], p_infinite_inertia, p_margin, r_results ? &r_results[i] : NULL, p_exclude_raycast_shapes);
+			if (r_collided[i])
+				collided_count++;
+		}
+	}
+
+	if (space) {
+		collided_count += space->test_body_motion_batch(motion_batch_bodies.ptr(), p_from, p_motions, p_count, p_infinite_inertia, p_margin, r_results, r_collided, p_exclude_raycast_shapes);
+	}
+
+	return collided_count;
+}
+
 int Physics2DServerSW::body_test_ray_separation(RID p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin) {
 
 	Body2DSW *body = body_owner.get(p_body);
@@ -1272,13 +1319,17 @@ void Physics2DServerSW::init() {
 
 	doing_sync = false;
 	last_step = 0.001;
-	iterations = 8; // 8?
+	iterations = GLOBAL_DEF("physics/2d/solver_iterations", 8);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/solver_iterations", PropertyInfo(Variant::INT, "physics/2d/solver_iterations", PROPERTY_HINT_RANGE, "1,128,1"));
 	stepper = memnew(Step2DSW);
+	stepper->set_threaded_islands(GLOBAL_DEF("physics/2d/threaded_islands", false));
 	direct_state = memnew(Physics2DDirectBodyStateSW);
 };
 
 void Physics2DServerSW::step(real_t p_step) {
 
+	TRACE_SCOPE("Physics2DServerSW::step");
+
 	if (!active)
 		return;
 
@@ -1289,12 +1340,14 @@ void Physics2DServerSW::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	solve_time = 0;
 	for (Set<const Space2DSW *>::Element *E = active_spaces.front(); E; E = E->next()) {
 
 		stepper->step((Space2DSW *)E->get(), p_step, iterations);
 		island_count += E->get()->get_island_count();
 		active_objects += E->get()->get_active_objects();
 		collision_pairs += E->get()->get_collision_pairs();
+		solve_time += E->get()->get_elapsed_time(Space2DSW::ELAPSED_TIME_SOLVE_CONSTRAINTS);
 	}
 };
 
@@ -1376,6 +1429,14 @@ int Physics2DServerSW::get_process_info(ProcessInfo p_info) {
 
 			return island_count;
 		} break;
+		case INFO_SOLVER_ITERATIONS: {
+
+			return iterations;
+		} break;
+		case INFO_SOLVE_TIME: {
+
+			return solve_time;
+		} break;
 	}
 
 	return 0;
@@ -1393,6 +1454,7 @@ Physics2DServerSW::Physics2DServerSW() {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	solve_time = 0;
 	using_threads = int(ProjectSettings::get_singleton()->get("physics/2d/thread_model")) == 2;
 };
 
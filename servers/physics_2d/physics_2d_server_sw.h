@@ -51,6 +51,7 @@ class Physics2DServerSW : public Physics2DServer {
 	int island_count;
 	int active_objects;
 	int collision_pairs;
+	uint64_t solve_time;
 
 	bool using_threads;
 
@@ -67,6 +68,8 @@ class Physics2DServerSW : public Physics2DServer {
 
 	static Physics2DServerSW *singletonsw;
 
+	Vector<Body2DSW *> motion_batch_bodies;
+
 	//void _clear_query(Query2DSW *p_query);
 
 	RID _shape_create(ShapeType p_shape);
@@ -91,7 +94,7 @@ public:
 	virtual RID convex_polygon_shape_create();
 	virtual RID concave_polygon_shape_create();
 
-	static void _shape_col_cbk(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_userdata);
+	static void _shape_col_cbk(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_userdata);
 
 	virtual void shape_set_data(RID p_shape, const Variant &p_data);
 	virtual void shape_set_custom_solver_bias(RID p_shape, real_t p_bias);
@@ -155,6 +158,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable);
 
 	virtual void area_set_pickable(RID p_area, bool p_pickable);
 
@@ -237,6 +241,7 @@ public:
 	virtual void body_set_pickable(RID p_body, bool p_pickable);
 
 	virtual bool body_test_motion(RID p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin = 0.001, MotionResult *r_result = NULL, bool p_exclude_raycast_shapes = true);
+	virtual int body_test_motion_batch(const RID *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, real_t p_margin, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes = true);
 	virtual int body_test_ray_separation(RID p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001);
 
 	// this function only works on physics process, errors and returns null otherwise
@@ -112,7 +112,10 @@ void Physics2DServerWrapMT::init() {
 		step_sem = Semaphore::create();
 		//OS::get_singleton()->release_rendering_thread();
 		if (create_thread) {
-			thread = Thread::create(_thread_callback, this);
+			Thread::Settings settings;
+			settings.name = "Physics 2D";
+			settings.priority = Thread::PRIORITY_HIGH;
+			thread = Thread::create(_thread_callback, this, settings);
 		}
 		while (!step_thread_up) {
 			OS::get_singleton()->delay_usec(1000);
@@ -168,6 +168,7 @@ public:
 
 	FUNC3(area_set_monitor_callback, RID, Object *, const StringName &);
 	FUNC3(area_set_area_monitor_callback, RID, Object *, const StringName &);
+	FUNC2(area_set_monitor_batching, RID, bool);
 
 	/* BODY API */
 
@@ -255,6 +256,12 @@ public:
 		return physics_2d_server->body_test_motion(p_body, p_from, p_motion, p_infinite_inertia, p_margin, r_result, p_exclude_raycast_shapes);
 	}
 
+	int body_test_motion_batch(const RID *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, real_t p_margin, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes = true) {
+
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), 0);
+		return physics_2d_server->body_test_motion_batch(p_bodies, p_from, p_motions, p_count, p_infinite_inertia, p_margin, r_results, r_collided, p_exclude_raycast_shapes);
+	}
+
 	int body_test_ray_separation(RID p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001) {
 
 		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), false);
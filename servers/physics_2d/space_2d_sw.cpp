@@ -31,6 +31,7 @@
 #include "space_2d_sw.h"
 
 #include "collision_solver_2d_sw.h"
+#include "os/worker_thread_pool.h"
 #include "pair.h"
 #include "physics_2d_server_sw.h"
 
@@ -39,6 +40,41 @@ _FORCE_INLINE_ static bool _can_collide_with(CollisionObject2DSW *p_object, uint
 	return p_object->get_collision_layer() & p_collision_mask;
 }
 
+_FORCE_INLINE_ static bool _intersect_ray_shape(const CollisionObject2DSW *p_col_obj, int p_shape_idx, const Vector2 &p_begin, const Vector2 &p_end, Vector2 &r_point, Vector2 &r_normal) {
+
+	Transform2D inv_xform = p_col_obj->get_shape_inv_transform(p_shape_idx) * p_col_obj->get_inv_transform();
+
+	Vector2 local_from = inv_xform.xform(p_begin);
+	Vector2 local_to = inv_xform.xform(p_end);
+
+	const Shape2DSW *shape = p_col_obj->get_shape(p_shape_idx);
+
+	Vector2 shape_point, shape_normal;
+
+	if (!shape->intersect_segment(local_from, local_to, shape_point, shape_normal))
+		return false;
+
+	Transform2D xform = p_col_obj->get_transform() * p_col_obj->get_shape_transform(p_shape_idx);
+	r_point = xform.xform(shape_point);
+	r_normal = inv_xform.basis_xform_inv(shape_normal).normalized();
+
+	return true;
+}
+
+_FORCE_INLINE_ static void _fill_ray_result(const CollisionObject2DSW *p_col_obj, int p_shape_idx, const Vector2 &p_point, const Vector2 &p_normal, Physics2DDirectSpaceState::RayResult &r_result) {
+
+	r_result.collider_id = p_col_obj->get_instance_id();
+	if (r_result.collider_id != 0)
+		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
+	else
+		r_result.collider = NULL;
+	r_result.normal = p_normal;
+	r_result.metadata = p_col_obj->get_shape_metadata(p_shape_idx);
+	r_result.position = p_point;
+	r_result.rid = p_col_obj->get_self();
+	r_result.shape = p_shape_idx;
+}
+
 int Physics2DDirectSpaceStateSW::intersect_point(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_pick_point) {
 
 	if (p_result_max <= 0)
@@ -121,25 +157,10 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
 
 		int shape_idx = space->intersection_query_subindex_results[i];
-		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
-
-		Vector2 local_from = inv_xform.xform(begin);
-		Vector2 local_to = inv_xform.xform(end);
-
-		/*local_from = col_obj->get_inv_transform().xform(begin);
-		local_from = col_obj->get_shape_inv_transform(shape_idx).xform(local_from);
-
-		local_to = col_obj->get_inv_transform().xform(end);
-		local_to = col_obj->get_shape_inv_transform(shape_idx).xform(local_to);*/
-
-		const Shape2DSW *shape = col_obj->get_shape(shape_idx);
 
 		Vector2 shape_point, shape_normal;
 
-		if (shape->intersect_segment(local_from, local_to, shape_point, shape_normal)) {
-
-			Transform2D xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-			shape_point = xform.xform(shape_point);
+		if (_intersect_ray_shape(col_obj, shape_idx, begin, end, shape_point, shape_normal)) {
 
 			real_t ld = normal.dot(shape_point);
 
@@ -147,7 +168,7 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 
 				min_d = ld;
 				res_point = shape_point;
-				res_normal = inv_xform.basis_xform_inv(shape_normal).normalized();
+				res_normal = shape_normal;
 				res_shape = shape_idx;
 				res_obj = col_obj;
 				collided = true;
@@ -158,18 +179,154 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 	if (!collided)
 		return false;
 
-	r_result.collider_id = res_obj->get_instance_id();
-	if (r_result.collider_id != 0)
-		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
-	r_result.normal = res_normal;
-	r_result.metadata = res_obj->get_shape_metadata(res_shape);
-	r_result.position = res_point;
-	r_result.rid = res_obj->get_self();
-	r_result.shape = res_shape;
+	_fill_ray_result(res_obj, res_shape, res_point, res_normal, r_result);
 
 	return true;
 }
 
+void Physics2DDirectSpaceStateSW::_ray_batch_chunk(void *p_userdata, uint32_t p_index) {
+
+	const RayBatch *batch = (const RayBatch *)p_userdata;
+	const RayBatchChunk &chunk = batch->chunks[p_index];
+
+	if (chunk.candidate_count < 0)
+		return; // cast one by one afterwards
+
+	const CollisionObject2DSW *const *candidates = &batch->candidates[chunk.candidate_from];
+	const int *candidate_shapes = &batch->candidate_shapes[chunk.candidate_from];
+
+	for (int i = chunk.from_ray; i < chunk.from_ray + chunk.ray_count; i++) {
+
+		Vector2 begin = batch->from[i];
+		Vector2 end = begin + batch->dir[i];
+		Vector2 normal = batch->dir[i].normalized();
+
+		bool collided = false;
+		Vector2 res_point, res_normal;
+		int res_shape;
+		const CollisionObject2DSW *res_obj;
+		real_t min_d = 1e10;
+
+		for (int j = 0; j < chunk.candidate_count; j++) {
+
+			const CollisionObject2DSW *col_obj = candidates[j];
+			int shape_idx = candidate_shapes[j];
+
+			if (!col_obj->get_shape_aabb(shape_idx).intersects_segment(begin, end))
+				continue;
+
+			Vector2 shape_point, shape_normal;
+
+			if (_intersect_ray_shape(col_obj, shape_idx, begin, end, shape_point, shape_normal)) {
+
+				real_t ld = normal.dot(shape_point);
+
+				if (ld < min_d) {
+
+					min_d = ld;
+					res_point = shape_point;
+					res_normal = shape_normal;
+					res_shape = shape_idx;
+					res_obj = col_obj;
+					collided = true;
+				}
+			}
+		}
+
+		batch->hits[i] = collided;
+		if (collided) {
+			_fill_ray_result(res_obj, res_shape, res_point, res_normal, batch->results[i]);
+		}
+	}
+}
+
+int Physics2DDirectSpaceStateSW::intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	if (p_ray_count <= 0)
+		return 0;
+
+	int chunk_count = (p_ray_count + RAY_BATCH_CHUNK - 1) / RAY_BATCH_CHUNK;
+	ray_batch_chunks.resize(chunk_count);
+	ray_batch_candidates.clear();
+	ray_batch_candidate_shapes.clear();
+
+	// the broadphase is not safe to query from several threads, so gather the candidates of every chunk first
+	for (int i = 0; i < chunk_count; i++) {
+
+		RayBatchChunk &chunk = ray_batch_chunks.write[i];
+		chunk.from_ray = i * RAY_BATCH_CHUNK;
+		chunk.ray_count = MIN(RAY_BATCH_CHUNK, p_ray_count - chunk.from_ray);
+		chunk.candidate_from = ray_batch_candidates.size();
+		chunk.candidate_count = 0;
+
+		Rect2 aabb(p_from[chunk.from_ray], Vector2());
+		for (int j = chunk.from_ray; j < chunk.from_ray + chunk.ray_count; j++) {
+			aabb.expand_to(p_from[j]);
+			aabb.expand_to(p_from[j] + p_dir[j]);
+		}
+
+		int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, Space2DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+		if (amount == Space2DSW::INTERSECTION_QUERY_MAX) {
+			chunk.candidate_count = -1; // may have missed objects
+			continue;
+		}
+
+		for (int j = 0; j < amount; j++) {
+
+			if (!_can_collide_with(space->intersection_query_results[j], p_collision_mask))
+				continue;
+
+			if (p_exclude.has(space->intersection_query_results[j]->get_self()))
+				continue;
+
+			ray_batch_candidates.push_back(space->intersection_query_results[j]);
+			ray_batch_candidate_shapes.push_back(space->intersection_query_subindex_results[j]);
+			chunk.candidate_count++;
+		}
+	}
+
+	RayBatch batch;
+	batch.from = p_from;
+	batch.dir = p_dir;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.chunks = ray_batch_chunks.ptr();
+	batch.candidates = ray_batch_candidates.ptr();
+	batch.candidate_shapes = ray_batch_candidate_shapes.ptr();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && chunk_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_ray_batch_chunk, &batch, chunk_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < chunk_count; i++) {
+			_ray_batch_chunk(&batch, i);
+		}
+	}
+
+	int hit_count = 0;
+
+	for (int i = 0; i < chunk_count; i++) {
+
+		const RayBatchChunk &chunk = ray_batch_chunks[i];
+
+		for (int j = chunk.from_ray; j < chunk.from_ray + chunk.ray_count; j++) {
+
+			if (chunk.candidate_count < 0) {
+				r_hits[j] = intersect_ray(p_from[j], p_from[j] + p_dir[j], r_results[j], p_exclude, p_collision_mask);
+			}
+
+			if (r_hits[j])
+				hit_count++;
+		}
+	}
+
+	return hit_count;
+}
+
 int Physics2DDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
 
 	if (p_result_max <= 0)
@@ -365,7 +522,7 @@ struct _RestCallbackData2D {
 	real_t valid_depth;
 };
 
-static void _rest_cbk_result(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_userdata) {
+static void _rest_cbk_result(const Vector2 &p_point_A, const Vector2 &p_point_B, int p_feature, void *p_userdata) {
 
 	_RestCallbackData2D *rd = (_RestCallbackData2D *)p_userdata;
 
@@ -453,7 +610,29 @@ Physics2DDirectSpaceStateSW::Physics2DDirectSpaceStateSW() {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int Space2DSW::_cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb) {
+int Space2DSW::_cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb, MotionCandidates *p_candidates) {
+
+	if (p_candidates) {
+
+		if (!p_candidates->aabb.encloses(p_aabb)) {
+			p_candidates->outside = true;
+			return 0;
+		}
+
+		// already filtered when gathered, only keep what this query overlaps
+		int amount = 0;
+		for (int i = 0; i < p_candidates->count; i++) {
+
+			if (!p_candidates->objects[i]->get_shape_aabb(p_candidates->shapes[i]).intersects(p_aabb))
+				continue;
+
+			p_candidates->results[amount] = p_candidates->objects[i];
+			p_candidates->subindex_results[amount] = p_candidates->shapes[i];
+			amount++;
+		}
+
+		return amount;
+	}
 
 	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
 
@@ -636,8 +815,30 @@ int Space2DSW::test_body_ray_separation(Body2DSW *p_body, const Transform2D &p_t
 	return rays_found;
 }
 
+Rect2 Space2DSW::_get_body_motion_aabb(Body2DSW *p_body, const Transform2D &p_from, real_t p_margin) const {
+
+	Rect2 body_aabb;
+
+	for (int i = 0; i < p_body->get_shape_count(); i++) {
+
+		if (i == 0)
+			body_aabb = p_body->get_shape_aabb(i);
+		else
+			body_aabb = body_aabb.merge(p_body->get_shape_aabb(i));
+	}
+
+	// Undo the currently transform the physics server is aware of and apply the provided one
+	body_aabb = p_from.xform(p_body->get_inv_transform().xform(body_aabb));
+	return body_aabb.grow(p_margin);
+}
+
 bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_result, bool p_exclude_raycast_shapes) {
 
+	return _test_body_motion(p_body, p_from, p_motion, p_infinite_inertia, p_margin, r_result, p_exclude_raycast_shapes, NULL);
+}
+
+bool Space2DSW::_test_body_motion(Body2DSW *p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_result, bool p_exclude_raycast_shapes, MotionCandidates *p_candidates) {
+
 	//give me back regular physics engine logic
 	//this is madness
 	//and most people using this function will think
@@ -649,19 +850,10 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 		r_result->collider_id = 0;
 		r_result->collider_shape = 0;
 	}
-	Rect2 body_aabb;
-
-	for (int i = 0; i < p_body->get_shape_count(); i++) {
-
-		if (i == 0)
-			body_aabb = p_body->get_shape_aabb(i);
-		else
-			body_aabb = body_aabb.merge(p_body->get_shape_aabb(i));
-	}
+	Rect2 body_aabb = _get_body_motion_aabb(p_body, p_from, p_margin);
 
-	// Undo the currently transform the physics server is aware of and apply the provided one
-	body_aabb = p_from.xform(p_body->get_inv_transform().xform(body_aabb));
-	body_aabb = body_aabb.grow(p_margin);
+	CollisionObject2DSW **query_results = p_candidates ? p_candidates->results : intersection_query_results;
+	int *query_subindex_results = p_candidates ? p_candidates->subindex_results : intersection_query_subindex_results;
 
 	static const int max_excluded_shape_pairs = 32;
 	ExcludedShapeSW excluded_shape_pairs[max_excluded_shape_pairs];
@@ -690,7 +882,7 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 
 			bool collided = false;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			int amount = _cull_aabb_for_body(p_body, body_aabb, p_candidates);
 
 			for (int j = 0; j < p_body->get_shape_count(); j++) {
 				if (p_body->is_shape_set_as_disabled(j))
@@ -704,8 +896,8 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 				Transform2D body_shape_xform = body_transform * p_body->get_shape_transform(j);
 				for (int i = 0; i < amount; i++) {
 
-					const CollisionObject2DSW *col_obj = intersection_query_results[i];
-					int shape_idx = intersection_query_subindex_results[i];
+					const CollisionObject2DSW *col_obj = query_results[i];
+					int shape_idx = query_subindex_results[i];
 
 					if (CollisionObject2DSW::TYPE_BODY == col_obj->get_type()) {
 						const Body2DSW *b = static_cast<const Body2DSW *>(col_obj);
@@ -781,7 +973,7 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 		motion_aabb.position += p_motion;
 		motion_aabb = motion_aabb.merge(body_aabb);
 
-		int amount = _cull_aabb_for_body(p_body, motion_aabb);
+		int amount = _cull_aabb_for_body(p_body, motion_aabb, p_candidates);
 
 		for (int body_shape_idx = 0; body_shape_idx < p_body->get_shape_count(); body_shape_idx++) {
 
@@ -802,8 +994,8 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 
 			for (int i = 0; i < amount; i++) {
 
-				const CollisionObject2DSW *col_obj = intersection_query_results[i];
-				int col_shape_idx = intersection_query_subindex_results[i];
+				const CollisionObject2DSW *col_obj = query_results[i];
+				int col_shape_idx = query_subindex_results[i];
 				Shape2DSW *against_shape = col_obj->get_shape(col_shape_idx);
 
 				if (CollisionObject2DSW::TYPE_BODY == col_obj->get_type()) {
@@ -936,12 +1128,12 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 
 		body_aabb.position += p_motion * unsafe;
 
-		int amount = _cull_aabb_for_body(p_body, body_aabb);
+		int amount = _cull_aabb_for_body(p_body, body_aabb, p_candidates);
 
 		for (int i = 0; i < amount; i++) {
 
-			const CollisionObject2DSW *col_obj = intersection_query_results[i];
-			int shape_idx = intersection_query_subindex_results[i];
+			const CollisionObject2DSW *col_obj = query_results[i];
+			int shape_idx = query_subindex_results[i];
 
 			if (CollisionObject2DSW::TYPE_BODY == col_obj->get_type()) {
 				const Body2DSW *b = static_cast<const Body2DSW *>(col_obj);
@@ -1015,6 +1207,108 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 	return collided;
 }
 
+void Space2DSW::_motion_batch_body(void *p_userdata, uint32_t p_index) {
+
+	const MotionBatch *batch = (const MotionBatch *)p_userdata;
+	MotionCandidates &candidates = batch->candidates[p_index];
+
+	if (!batch->bodies[p_index] || candidates.count < 0)
+		return; // skipped, or tested on the broadphase afterwards
+
+	Physics2DServer::MotionResult *result = batch->results ? &batch->results[p_index] : NULL;
+	batch->collided[p_index] = batch->space->_test_body_motion(batch->bodies[p_index], batch->from[p_index], batch->motions[p_index], batch->infinite_inertia, batch->margin, result, batch->exclude_raycast_shapes, &candidates);
+}
+
+int Space2DSW::test_body_motion_batch(Body2DSW *const *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes) {
+
+	motion_batch_candidates.resize(p_count);
+	motion_batch_objects.clear();
+	motion_batch_shapes.clear();
+
+	// the broadphase is not thread safe, so gather everything each body may touch first: the motion
+	// swept box, with some room for the recovery step to push the body around
+
+	for (int i = 0; i < p_count; i++) {
+
+		MotionCandidates &candidates = motion_batch_candidates.write[i];
+		candidates.from = motion_batch_objects.size();
+		candidates.count = -1;
+		candidates.outside = false;
+
+		if (!p_bodies[i])
+			continue;
+
+		Rect2 body_aabb = _get_body_motion_aabb(p_bodies[i], p_from[i], p_margin);
+		Rect2 motion_aabb = body_aabb;
+		motion_aabb.position += p_motions[i];
+		motion_aabb = motion_aabb.merge(body_aabb);
+		candidates.aabb = motion_aabb.grow(MAX(body_aabb.size.x, body_aabb.size.y) * 0.25);
+
+		int amount = _cull_aabb_for_body(p_bodies[i], candidates.aabb);
+		if (amount >= INTERSECTION_QUERY_MAX)
+			continue;
+
+		for (int j = 0; j < amount; j++) {
+			motion_batch_objects.push_back(intersection_query_results[j]);
+			motion_batch_shapes.push_back(intersection_query_subindex_results[j]);
+		}
+		candidates.count = amount;
+	}
+
+	motion_batch_results.resize(motion_batch_objects.size());
+	motion_batch_subindex_results.resize(motion_batch_objects.size());
+
+	for (int i = 0; i < p_count; i++) {
+
+		MotionCandidates &candidates = motion_batch_candidates.write[i];
+		candidates.objects = motion_batch_objects.ptrw() + candidates.from;
+		candidates.shapes = motion_batch_shapes.ptrw() + candidates.from;
+		candidates.results = motion_batch_results.ptrw() + candidates.from;
+		candidates.subindex_results = motion_batch_subindex_results.ptrw() + candidates.from;
+	}
+
+	MotionBatch batch;
+	batch.space = this;
+	batch.bodies = p_bodies;
+	batch.from = p_from;
+	batch.motions = p_motions;
+	batch.infinite_inertia = p_infinite_inertia;
+	batch.margin = p_margin;
+	batch.exclude_raycast_shapes = p_exclude_raycast_shapes;
+	batch.results = r_results;
+	batch.collided = r_collided;
+	batch.candidates = motion_batch_candidates.ptrw();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && p_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_motion_batch_body, &batch, p_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < p_count; i++) {
+			_motion_batch_body(&batch, i);
+		}
+	}
+
+	int collided_count = 0;
+
+	for (int i = 0; i < p_count; i++) {
+
+		if (!p_bodies[i])
+			continue;
+
+		const MotionCandidates &candidates = motion_batch_candidates[i];
+		if (candidates.count < 0 || candidates.outside) {
+			Physics2DServer::MotionResult *result = r_results ? &r_results[i] : NULL;
+			r_collided[i] = _test_body_motion(p_bodies[i], p_from[i], p_motions[i], p_infinite_inertia, p_margin, result, p_exclude_raycast_shapes, NULL);
+		}
+
+		if (r_collided[i])
+			collided_count++;
+	}
+
+	return collided_count;
+}
+
 void *Space2DSW::_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_self) {
 
 	CollisionObject2DSW::Type type_A = A->get_type();
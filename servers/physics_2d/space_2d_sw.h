@@ -48,8 +48,39 @@ class Physics2DDirectSpaceStateSW : public Physics2DDirectSpaceState {
 public:
 	Space2DSW *space;
 
+private:
+	enum {
+		RAY_BATCH_CHUNK = 64
+	};
+
+	// consecutive rays of a batch share one broadphase query
+	struct RayBatchChunk {
+		int from_ray;
+		int ray_count;
+		int candidate_from;
+		int candidate_count; // -1 if the broadphase query overflowed
+	};
+
+	struct RayBatch {
+		const Vector2 *from;
+		const Vector2 *dir;
+		RayResult *results;
+		bool *hits;
+		const RayBatchChunk *chunks;
+		const CollisionObject2DSW *const *candidates;
+		const int *candidate_shapes;
+	};
+
+	Vector<RayBatchChunk> ray_batch_chunks;
+	Vector<const CollisionObject2DSW *> ray_batch_candidates;
+	Vector<int> ray_batch_candidate_shapes;
+
+	static void _ray_batch_chunk(void *p_userdata, uint32_t p_index);
+
+public:
 	virtual int intersect_point(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_pick_point = false);
 	virtual bool intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+	virtual int intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual int intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual bool cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual bool collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
@@ -120,7 +151,43 @@ private:
 	int active_objects;
 	int collision_pairs;
 
-	int _cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb);
+	// broadphase results gathered up front for one body of a motion batch, so its motion test
+	// can run on a worker thread without touching the broadphase or the shared query buffers
+	struct MotionCandidates {
+		Rect2 aabb;
+		int from;
+		int count; // -1 if the broadphase query overflowed
+		bool outside; // the test needed more than aabb, it must be redone on the broadphase
+		CollisionObject2DSW **objects;
+		int *shapes;
+		CollisionObject2DSW **results;
+		int *subindex_results;
+	};
+
+	struct MotionBatch {
+		Space2DSW *space;
+		Body2DSW *const *bodies;
+		const Transform2D *from;
+		const Vector2 *motions;
+		bool infinite_inertia;
+		real_t margin;
+		bool exclude_raycast_shapes;
+		Physics2DServer::MotionResult *results;
+		bool *collided;
+		MotionCandidates *candidates;
+	};
+
+	Vector<MotionCandidates> motion_batch_candidates;
+	Vector<CollisionObject2DSW *> motion_batch_objects;
+	Vector<int> motion_batch_shapes;
+	Vector<CollisionObject2DSW *> motion_batch_results;
+	Vector<int> motion_batch_subindex_results;
+
+	static void _motion_batch_body(void *p_userdata, uint32_t p_index);
+
+	int _cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb, MotionCandidates *p_candidates = NULL);
+	Rect2 _get_body_motion_aabb(Body2DSW *p_body, const Transform2D &p_from, real_t p_margin) const;
+	bool _test_body_motion(Body2DSW *p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_result, bool p_exclude_raycast_shapes, MotionCandidates *p_candidates);
 
 	Vector<Vector2> contact_debug;
 	int contact_debug_count;
@@ -183,6 +250,7 @@ public:
 	int get_collision_pairs() const { return collision_pairs; }
 
 	bool test_body_motion(Body2DSW *p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_result, bool p_exclude_raycast_shapes = true);
+	int test_body_motion_batch(Body2DSW *const *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes = true);
 	int test_body_ray_separation(Body2DSW *p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, Physics2DServer::SeparationResult *r_results, int p_result_max, real_t p_margin);
 
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
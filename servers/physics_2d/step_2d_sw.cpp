@@ -30,6 +30,23 @@
 
 #include "step_2d_sw.h"
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
+
+// Constraints that touch state shared between islands (areas, or static and
+// kinematic bodies that record contacts) can't be set up from several threads.
+static _FORCE_INLINE_ bool _is_island_local(const Constraint2DSW *p_constraint) {
+
+	if (p_constraint->get_body_count() < 2)
+		return false;
+
+	for (int i = 0; i < p_constraint->get_body_count(); i++) {
+		const Body2DSW *b = p_constraint->get_body_ptr()[i];
+		if (b->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && b->can_report_contacts())
+			return false;
+	}
+
+	return true;
+}
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
 
@@ -57,12 +74,19 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	}
 }
 
-bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
+bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta, SetupPass p_pass) {
 
 	Constraint2DSW *ci = p_island;
 	Constraint2DSW *prev_ci = NULL;
 	bool removed_root = false;
 	while (ci) {
+		if (p_pass != SETUP_ALL && _is_island_local(ci) != (p_pass == SETUP_LOCAL)) {
+			//handled by the other pass
+			prev_ci = ci;
+			ci = ci->get_island_next();
+			continue;
+		}
+
 		bool process = ci->setup(p_delta);
 
 		if (!process) {
@@ -94,6 +118,24 @@ void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t
 	}
 }
 
+void Step2DSW::_integrate_forces_threaded(void *p_userdata, uint32_t p_index) {
+
+	Step2DSW *self = (Step2DSW *)p_userdata;
+	self->active_bodies[p_index]->integrate_forces(self->threaded_delta, true);
+}
+
+void Step2DSW::_setup_island_threaded(void *p_userdata, uint32_t p_index) {
+
+	Step2DSW *self = (Step2DSW *)p_userdata;
+	self->island_removed_root.ptrw()[p_index] = self->_setup_island(self->constraint_islands[p_index], self->threaded_delta, SETUP_LOCAL);
+}
+
+void Step2DSW::_solve_island_threaded(void *p_userdata, uint32_t p_index) {
+
+	Step2DSW *self = (Step2DSW *)p_userdata;
+	self->_solve_island(self->constraint_islands[p_index], self->threaded_iterations, self->threaded_delta);
+}
+
 void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
@@ -146,12 +188,42 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	int active_count = 0;
 
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	// Islands share no dynamic bodies, so they can be set up and solved in any
+	// order (and on any thread) with the same result.
+	bool threaded = threaded_islands && pool && pool->get_thread_count() > 0;
+
+	threaded_delta = p_delta;
+	threaded_iterations = p_iterations;
+
 	const SelfList<Body2DSW> *b = body_list->first();
-	while (b) {
 
-		b->self()->integrate_forces(p_delta);
-		b = b->next();
-		active_count++;
+	if (threaded) {
+
+		active_bodies.clear();
+		while (b) {
+			active_bodies.push_back(b->self());
+			b = b->next();
+		}
+
+		active_count = active_bodies.size();
+
+		WorkerThreadPool::GroupID group = pool->add_group_task(_integrate_forces_threaded, this, active_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+
+		for (int i = 0; i < active_count; i++) {
+			if (active_bodies[i]->is_motion_deferred())
+				active_bodies[i]->apply_deferred_motion();
+		}
+
+	} else {
+		while (b) {
+
+			b->self()->integrate_forces(p_delta);
+			b = b->next();
+			active_count++;
+		}
 	}
 
 	p_space->set_active_objects(active_count);
@@ -219,12 +291,37 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
+	bool threaded_setup = threaded && !p_space->is_debugging_contacts();
+
+	if (threaded_setup) {
+
+		constraint_islands.clear();
+		Constraint2DSW *ci = constraint_island_list;
+		while (ci) {
+			constraint_islands.push_back(ci);
+			ci = ci->get_island_list_next();
+		}
+
+		island_removed_root.resize(constraint_islands.size());
+
+		WorkerThreadPool::GroupID group = pool->add_group_task(_setup_island_threaded, this, constraint_islands.size(), WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+
+		for (int i = 0; i < constraint_islands.size(); i++) {
+			if (_setup_island(constraint_islands[i], p_delta, SETUP_SHARED))
+				island_removed_root.write[i] = true;
+		}
+	}
+
 	{
 		Constraint2DSW *ci = constraint_island_list;
 		Constraint2DSW *prev_ci = NULL;
+		int island_index = 0;
 		while (ci) {
 
-			if (_setup_island(ci, p_delta) == true) {
+			bool removed_root = threaded_setup ? island_removed_root[island_index++] : _setup_island(ci, p_delta);
+
+			if (removed_root) {
 
 				//removed the root from the island graph because it is not to be processed
 
@@ -265,7 +362,20 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
+	if (threaded) {
+
+		//roots may have changed during setup
+		constraint_islands.clear();
+		Constraint2DSW *ci = constraint_island_list;
+		while (ci) {
+			constraint_islands.push_back(ci);
+			ci = ci->get_island_list_next();
+		}
+
+		WorkerThreadPool::GroupID group = pool->add_group_task(_solve_island_threaded, this, constraint_islands.size(), WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+
+	} else {
 		Constraint2DSW *ci = constraint_island_list;
 		while (ci) {
 			//iterating each island separatedly improves cache efficiency
@@ -315,4 +425,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 Step2DSW::Step2DSW() {
 
 	_step = 1;
+	threaded_islands = false;
+	threaded_delta = 0;
+	threaded_iterations = 0;
 }
@@ -37,12 +37,32 @@ class Step2DSW {
 
 	uint64_t _step;
 
+	enum SetupPass {
+		SETUP_ALL,
+		SETUP_LOCAL, // only constraints that stay within the island, safe to run in threads
+		SETUP_SHARED // the rest, run serially after SETUP_LOCAL
+	};
+
+	bool threaded_islands;
+	Vector<Body2DSW *> active_bodies;
+	Vector<Constraint2DSW *> constraint_islands;
+	Vector<bool> island_removed_root;
+	real_t threaded_delta;
+	int threaded_iterations;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
-	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
+	bool _setup_island(Constraint2DSW *p_island, real_t p_delta, SetupPass p_pass = SETUP_ALL);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
 
+	static void _integrate_forces_threaded(void *p_userdata, uint32_t p_index);
+	static void _setup_island_threaded(void *p_userdata, uint32_t p_index);
+	static void _solve_island_threaded(void *p_userdata, uint32_t p_index);
+
 public:
+	void set_threaded_islands(bool p_enable) { threaded_islands = p_enable; }
+	bool is_threaded_islands() const { return threaded_islands; }
+
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
 	Step2DSW();
 };
@@ -263,6 +263,67 @@ Dictionary Physics2DDirectSpaceState::_intersect_ray(const Vector2 &p_from, cons
 	return d;
 }
 
+Dictionary Physics2DDirectSpaceState::_intersect_ray_batch(const PoolVector<Vector2> &p_origins, const PoolVector<Vector2> &p_directions, const Vector<RID> &p_exclude, uint32_t p_layers) {
+
+	ERR_FAIL_COND_V(p_origins.size() != p_directions.size(), Dictionary());
+
+	int ray_count = p_origins.size();
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	Vector<RayResult> results;
+	results.resize(ray_count);
+	Vector<bool> hits;
+	hits.resize(ray_count);
+
+	{
+		PoolVector<Vector2>::Read fr = p_origins.read();
+		PoolVector<Vector2>::Read dr = p_directions.read();
+		intersect_ray_batch(fr.ptr(), dr.ptr(), ray_count, results.ptrw(), hits.ptrw(), exclude, p_layers);
+	}
+
+	PoolVector<Vector2> positions;
+	positions.resize(ray_count);
+	PoolVector<Vector2> normals;
+	normals.resize(ray_count);
+	PoolVector<int> shapes;
+	shapes.resize(ray_count);
+	Array colliders;
+	colliders.resize(ray_count);
+
+	{
+		PoolVector<Vector2>::Write pw = positions.write();
+		PoolVector<Vector2>::Write nw = normals.write();
+		PoolVector<int>::Write sw = shapes.write();
+
+		for (int i = 0; i < ray_count; i++) {
+
+			if (!hits[i]) {
+				pw[i] = Vector2();
+				nw[i] = Vector2();
+				sw[i] = -1;
+				continue;
+			}
+
+			const RayResult &r = results[i];
+			pw[i] = r.position;
+			nw[i] = r.normal;
+			sw[i] = r.shape;
+			colliders[i] = r.collider;
+		}
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["shape"] = shapes;
+	d["collider"] = colliders;
+
+	return d;
+}
+
 Array Physics2DDirectSpaceState::_intersect_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results) {
 
 	Vector<ShapeResult> sr;
@@ -359,6 +420,20 @@ Dictionary Physics2DDirectSpaceState::_get_rest_info(const Ref<Physics2DShapeQue
 	return r;
 }
 
+int Physics2DDirectSpaceState::intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude, uint32_t p_collision_layer) {
+
+	int hit_count = 0;
+
+	for (int i = 0; i < p_ray_count; i++) {
+
+		r_hits[i] = intersect_ray(p_from[i], p_from[i] + p_dir[i], r_results[i], p_exclude, p_collision_layer);
+		if (r_hits[i])
+			hit_count++;
+	}
+
+	return hit_count;
+}
+
 Physics2DDirectSpaceState::Physics2DDirectSpaceState() {
 }
 
@@ -366,6 +441,7 @@ void Physics2DDirectSpaceState::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("intersect_point", "point", "max_results", "exclude", "collision_layer"), &Physics2DDirectSpaceState::_intersect_point, DEFVAL(32), DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "from", "to", "exclude", "collision_layer"), &Physics2DDirectSpaceState::_intersect_ray, DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "origins", "directions", "exclude", "collision_layer"), &Physics2DDirectSpaceState::_intersect_ray_batch, DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
 	ClassDB::bind_method(D_METHOD("intersect_shape", "shape", "max_results"), &Physics2DDirectSpaceState::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape"), &Physics2DDirectSpaceState::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &Physics2DDirectSpaceState::_collide_shape, DEFVAL(32));
@@ -492,6 +568,96 @@ bool Physics2DServer::_body_test_motion(RID p_body, const Transform2D &p_from, c
 	return body_test_motion(p_body, p_from, p_motion, p_infinite_inertia, p_margin, r);
 }
 
+Dictionary Physics2DServer::_body_test_motion_batch(const Array &p_bodies, const Array &p_from, const PoolVector<Vector2> &p_motions, bool p_infinite_inertia, float p_margin) {
+
+	ERR_FAIL_COND_V(p_bodies.size() != p_from.size() || p_bodies.size() != p_motions.size(), Dictionary());
+
+	int count = p_bodies.size();
+
+	Vector<RID> bodies;
+	bodies.resize(count);
+	Vector<Transform2D> from;
+	from.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		bodies.write[i] = p_bodies[i];
+		from.write[i] = p_from[i];
+	}
+
+	Vector<MotionResult> results;
+	results.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+
+	{
+		PoolVector<Vector2>::Read mr = p_motions.read();
+		body_test_motion_batch(bodies.ptr(), from.ptr(), mr.ptr(), count, p_infinite_inertia, p_margin, results.ptrw(), collided.ptrw());
+	}
+
+	PoolVector<Vector2> motions;
+	motions.resize(count);
+	PoolVector<Vector2> remainders;
+	remainders.resize(count);
+	PoolVector<Vector2> positions;
+	positions.resize(count);
+	PoolVector<Vector2> normals;
+	normals.resize(count);
+	PoolVector<int> shapes;
+	shapes.resize(count);
+	Array colliders;
+	colliders.resize(count);
+
+	{
+		PoolVector<Vector2>::Write mw = motions.write();
+		PoolVector<Vector2>::Write rw = remainders.write();
+		PoolVector<Vector2>::Write pw = positions.write();
+		PoolVector<Vector2>::Write nw = normals.write();
+		PoolVector<int>::Write sw = shapes.write();
+
+		for (int i = 0; i < count; i++) {
+
+			const MotionResult &r = results[i];
+			mw[i] = r.motion;
+			rw[i] = r.remainder;
+
+			if (collided[i]) {
+				pw[i] = r.collision_point;
+				nw[i] = r.collision_normal;
+				sw[i] = r.collider_shape;
+				colliders[i] = r.collider;
+			} else {
+				pw[i] = Vector2();
+				nw[i] = Vector2();
+				sw[i] = -1;
+			}
+		}
+	}
+
+	Dictionary d;
+	d["motion"] = motions;
+	d["remainder"] = remainders;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["shape"] = shapes;
+	d["collider"] = colliders;
+
+	return d;
+}
+
+int Physics2DServer::body_test_motion_batch(const RID *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, float p_margin, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes) {
+
+	int collided_count = 0;
+
+	for (int i = 0; i < p_count; i++) {
+
+		r_collided[i] = body_test_motion(p_bodies[i], p_from[i], p_motions[i], p_infinite_inertia, p_margin, r_results ? &r_results[i] : NULL, p_exclude_raycast_shapes);
+		if (r_collided[i])
+			collided_count++;
+	}
+
+	return collided_count;
+}
+
 void Physics2DServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("line_shape_create"), &Physics2DServer::line_shape_create);
@@ -548,6 +714,7 @@ void Physics2DServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("area_set_monitor_callback", "area", "receiver", "method"), &Physics2DServer::area_set_monitor_callback);
 	ClassDB::bind_method(D_METHOD("area_set_area_monitor_callback", "area", "receiver", "method"), &Physics2DServer::area_set_area_monitor_callback);
+	ClassDB::bind_method(D_METHOD("area_set_monitor_batching", "area", "enable"), &Physics2DServer::area_set_monitor_batching);
 	ClassDB::bind_method(D_METHOD("area_set_monitorable", "area", "monitorable"), &Physics2DServer::area_set_monitorable);
 
 	ClassDB::bind_method(D_METHOD("body_create"), &Physics2DServer::body_create);
@@ -613,6 +780,7 @@ void Physics2DServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("body_set_force_integration_callback", "body", "receiver", "method", "userdata"), &Physics2DServer::body_set_force_integration_callback, DEFVAL(Variant()));
 
 	ClassDB::bind_method(D_METHOD("body_test_motion", "body", "from", "motion", "infinite_inertia", "margin", "result"), &Physics2DServer::_body_test_motion, DEFVAL(0.08), DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("body_test_motion_batch", "bodies", "from", "motions", "infinite_inertia", "margin"), &Physics2DServer::_body_test_motion_batch, DEFVAL(0.08));
 
 	ClassDB::bind_method(D_METHOD("body_get_direct_state", "body"), &Physics2DServer::body_get_direct_state);
 
@@ -716,9 +884,17 @@ void Physics2DServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(AREA_BODY_ADDED);
 	BIND_ENUM_CONSTANT(AREA_BODY_REMOVED);
 
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_STATUS);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_INSTANCE_ID);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_BODY_SHAPE);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_AREA_SHAPE);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_SIZE);
+
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_SOLVER_ITERATIONS);
+	BIND_ENUM_CONSTANT(INFO_SOLVE_TIME);
 }
 
 Physics2DServer::Physics2DServer() {
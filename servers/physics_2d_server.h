@@ -138,6 +138,7 @@ class Physics2DDirectSpaceState : public Object {
 	GDCLASS(Physics2DDirectSpaceState, Object);
 
 	Dictionary _intersect_ray(const Vector2 &p_from, const Vector2 &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_layers = 0);
+	Dictionary _intersect_ray_batch(const PoolVector<Vector2> &p_origins, const PoolVector<Vector2> &p_directions, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_layers = 0);
 
 	Array _intersect_point(const Vector2 &p_point, int p_max_results = 32, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_layers = 0);
 	Array _intersect_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results = 32);
@@ -162,6 +163,9 @@ public:
 
 	virtual bool intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF) = 0;
 
+	// casts p_ray_count rays, ray i goes from p_from[i] to p_from[i] + p_dir[i]. r_hits[i] tells if r_results[i] is valid, returns the amount of hits
+	virtual int intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF);
+
 	struct ShapeResult {
 
 		RID rid;
@@ -225,6 +229,7 @@ class Physics2DServer : public Object {
 	static Physics2DServer *singleton;
 
 	virtual bool _body_test_motion(RID p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, float p_margin = 0.08, const Ref<Physics2DTestMotionResult> &p_result = Ref<Physics2DTestMotionResult>());
+	Dictionary _body_test_motion_batch(const Array &p_bodies, const Array &p_from, const PoolVector<Vector2> &p_motions, bool p_infinite_inertia, float p_margin = 0.08);
 
 protected:
 	static void _bind_methods();
@@ -353,6 +358,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable) = 0;
 
 	/* BODY API */
 
@@ -491,6 +497,8 @@ public:
 	};
 
 	virtual bool body_test_motion(RID p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, float p_margin = 0.001, MotionResult *r_result = NULL, bool p_exclude_raycast_shapes = true) = 0;
+	// tests many bodies at once, returns how many collided; servers may run the tests in parallel
+	virtual int body_test_motion_batch(const RID *p_bodies, const Transform2D *p_from, const Vector2 *p_motions, int p_count, bool p_infinite_inertia, float p_margin, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes = true);
 
 	struct SeparationResult {
 
@@ -556,6 +564,14 @@ public:
 		AREA_BODY_REMOVED
 	};
 
+	enum AreaMonitorEvent {
+		AREA_MONITOR_EVENT_STATUS,
+		AREA_MONITOR_EVENT_INSTANCE_ID,
+		AREA_MONITOR_EVENT_BODY_SHAPE,
+		AREA_MONITOR_EVENT_AREA_SHAPE,
+		AREA_MONITOR_EVENT_SIZE
+	};
+
 	/* MISC */
 
 	virtual void free(RID p_rid) = 0;
@@ -574,7 +590,9 @@ public:
 		INFO_COLLISION_PAIRS,
 		INFO_ISLAND_COUNT,
 		INFO_STEP_TIME,
-		INFO_BROAD_PHASE_TIME
+		INFO_BROAD_PHASE_TIME,
+		INFO_SOLVER_ITERATIONS,
+		INFO_SOLVE_TIME
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) = 0;
@@ -665,6 +683,7 @@ VARIANT_ENUM_CAST(Physics2DServer::JointType);
 VARIANT_ENUM_CAST(Physics2DServer::DampedStringParam);
 //VARIANT_ENUM_CAST( Physics2DServer::ObjectType );
 VARIANT_ENUM_CAST(Physics2DServer::AreaBodyStatus);
+VARIANT_ENUM_CAST(Physics2DServer::AreaMonitorEvent);
 VARIANT_ENUM_CAST(Physics2DServer::ProcessInfo);
 
 #endif
@@ -285,6 +285,67 @@ Dictionary PhysicsDirectSpaceState::_intersect_ray(const Vector3 &p_from, const
 	return d;
 }
 
+Dictionary PhysicsDirectSpaceState::_intersect_ray_batch(const PoolVector<Vector3> &p_origins, const PoolVector<Vector3> &p_directions, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ERR_FAIL_COND_V(p_origins.size() != p_directions.size(), Dictionary());
+
+	int ray_count = p_origins.size();
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	Vector<RayResult> results;
+	results.resize(ray_count);
+	Vector<bool> hits;
+	hits.resize(ray_count);
+
+	{
+		PoolVector<Vector3>::Read fr = p_origins.read();
+		PoolVector<Vector3>::Read dr = p_directions.read();
+		intersect_ray_batch(fr.ptr(), dr.ptr(), ray_count, results.ptrw(), hits.ptrw(), exclude, p_collision_mask);
+	}
+
+	PoolVector<Vector3> positions;
+	positions.resize(ray_count);
+	PoolVector<Vector3> normals;
+	normals.resize(ray_count);
+	PoolVector<int> shapes;
+	shapes.resize(ray_count);
+	Array colliders;
+	colliders.resize(ray_count);
+
+	{
+		PoolVector<Vector3>::Write pw = positions.write();
+		PoolVector<Vector3>::Write nw = normals.write();
+		PoolVector<int>::Write sw = shapes.write();
+
+		for (int i = 0; i < ray_count; i++) {
+
+			if (!hits[i]) {
+				pw[i] = Vector3();
+				nw[i] = Vector3();
+				sw[i] = -1;
+				continue;
+			}
+
+			const RayResult &r = results[i];
+			pw[i] = r.position;
+			nw[i] = r.normal;
+			sw[i] = r.shape;
+			colliders[i] = r.collider;
+		}
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["shape"] = shapes;
+	d["collider"] = colliders;
+
+	return d;
+}
+
 Array PhysicsDirectSpaceState::_intersect_shape(const Ref<PhysicsShapeQueryParameters> &p_shape_query, int p_max_results) {
 
 	Vector<ShapeResult> sr;
@@ -350,6 +411,20 @@ Dictionary PhysicsDirectSpaceState::_get_rest_info(const Ref<PhysicsShapeQueryPa
 	return r;
 }
 
+int PhysicsDirectSpaceState::intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	int hit_count = 0;
+
+	for (int i = 0; i < p_ray_count; i++) {
+
+		r_hits[i] = intersect_ray(p_from[i], p_from[i] + p_dir[i], r_results[i], p_exclude, p_collision_mask);
+		if (r_hits[i])
+			hit_count++;
+	}
+
+	return hit_count;
+}
+
 PhysicsDirectSpaceState::PhysicsDirectSpaceState() {
 }
 
@@ -359,6 +434,7 @@ void PhysicsDirectSpaceState::_bind_methods() {
 	//ClassDB::bind_method(D_METHOD("intersect_shape","shape","xform","result_max","exclude","umask"),&PhysicsDirectSpaceState::_intersect_shape,DEFVAL(Array()),DEFVAL(0));
 
 	ClassDB::bind_method(D_METHOD("intersect_ray", "from", "to", "exclude", "collision_layer"), &PhysicsDirectSpaceState::_intersect_ray, DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "origins", "directions", "exclude", "collision_layer"), &PhysicsDirectSpaceState::_intersect_ray_batch, DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
 	ClassDB::bind_method(D_METHOD("intersect_shape", "shape", "max_results"), &PhysicsDirectSpaceState::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape", "motion"), &PhysicsDirectSpaceState::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &PhysicsDirectSpaceState::_collide_shape, DEFVAL(32));
@@ -449,6 +525,7 @@ void PhysicsServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("area_set_monitor_callback", "area", "receiver", "method"), &PhysicsServer::area_set_monitor_callback);
 	ClassDB::bind_method(D_METHOD("area_set_area_monitor_callback", "area", "receiver", "method"), &PhysicsServer::area_set_area_monitor_callback);
+	ClassDB::bind_method(D_METHOD("area_set_monitor_batching", "area", "enable"), &PhysicsServer::area_set_monitor_batching);
 	ClassDB::bind_method(D_METHOD("area_set_monitorable", "area", "monitorable"), &PhysicsServer::area_set_monitorable);
 
 	ClassDB::bind_method(D_METHOD("area_set_ray_pickable", "area", "enable"), &PhysicsServer::area_set_ray_pickable);
@@ -728,6 +805,12 @@ void PhysicsServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(AREA_BODY_ADDED);
 	BIND_ENUM_CONSTANT(AREA_BODY_REMOVED);
 
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_STATUS);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_INSTANCE_ID);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_BODY_SHAPE);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_AREA_SHAPE);
+	BIND_ENUM_CONSTANT(AREA_MONITOR_EVENT_SIZE);
+
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
@@ -137,6 +137,7 @@ class PhysicsDirectSpaceState : public Object {
 
 private:
 	Dictionary _intersect_ray(const Vector3 &p_from, const Vector3 &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0);
+	Dictionary _intersect_ray_batch(const PoolVector<Vector3> &p_origins, const PoolVector<Vector3> &p_directions, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0);
 	Array _intersect_shape(const Ref<PhysicsShapeQueryParameters> &p_shape_query, int p_max_results = 32);
 	Array _cast_motion(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const Vector3 &p_motion);
 	Array _collide_shape(const Ref<PhysicsShapeQueryParameters> &p_shape_query, int p_max_results = 32);
@@ -168,6 +169,9 @@ public:
 
 	virtual bool intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_pick_ray = false) = 0;
 
+	// casts p_ray_count rays, ray i goes from p_from[i] to p_from[i] + p_dir[i]. r_hits[i] tells if r_results[i] is valid, returns the amount of hits
+	virtual int intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_dir, int p_ray_count, RayResult *r_results, bool *r_hits, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+
 	virtual int intersect_shape(const RID &p_shape, const Transform &p_xform, float p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF) = 0;
 
 	struct ShapeRestInfo {
@@ -335,6 +339,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable) = 0;
 
 	virtual void area_set_ray_pickable(RID p_area, bool p_enable) = 0;
 	virtual bool area_is_ray_pickable(RID p_area) const = 0;
@@ -706,6 +711,14 @@ public:
 		AREA_BODY_REMOVED
 	};
 
+	enum AreaMonitorEvent {
+		AREA_MONITOR_EVENT_STATUS,
+		AREA_MONITOR_EVENT_INSTANCE_ID,
+		AREA_MONITOR_EVENT_BODY_SHAPE,
+		AREA_MONITOR_EVENT_AREA_SHAPE,
+		AREA_MONITOR_EVENT_SIZE
+	};
+
 	/* MISC */
 
 	virtual void free(RID p_rid) = 0;
@@ -787,6 +800,7 @@ VARIANT_ENUM_CAST(PhysicsServer::ConeTwistJointParam);
 VARIANT_ENUM_CAST(PhysicsServer::G6DOFJointAxisParam);
 VARIANT_ENUM_CAST(PhysicsServer::G6DOFJointAxisFlag);
 VARIANT_ENUM_CAST(PhysicsServer::AreaBodyStatus);
+VARIANT_ENUM_CAST(PhysicsServer::AreaMonitorEvent);
 VARIANT_ENUM_CAST(PhysicsServer::ProcessInfo);
 
 #endif
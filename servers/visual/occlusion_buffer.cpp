@@ -0,0 +1,175 @@
+/*************************************************************************/
+/*  occlusion_buffer.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "occlusion_buffer.h"
+
+void OcclusionBuffer::_raster_triangle(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) {
+
+	float area = (p_b.x - p_a.x) * (p_c.y - p_a.y) - (p_b.y - p_a.y) * (p_c.x - p_a.x);
+	if (Math::abs(area) < CMP_EPSILON)
+		return; //degenerate, or seen edge on
+
+	float sign = area > 0 ? 1.0 : -1.0;
+	float tri_depth = MAX(p_a.z, MAX(p_b.z, p_c.z));
+
+	int x_from = MAX(0, int(Math::floor(MIN(p_a.x, MIN(p_b.x, p_c.x)))));
+	int x_to = MIN(width - 1, int(Math::ceil(MAX(p_a.x, MAX(p_b.x, p_c.x)))));
+	int y_from = MAX(0, int(Math::floor(MIN(p_a.y, MIN(p_b.y, p_c.y)))));
+	int y_to = MIN(height - 1, int(Math::ceil(MAX(p_a.y, MAX(p_b.y, p_c.y)))));
+
+	float *depth_w = depth.ptrw();
+
+	for (int y = y_from; y <= y_to; y++) {
+
+		float py = y + 0.5;
+
+		for (int x = x_from; x <= x_to; x++) {
+
+			float px = x + 0.5;
+
+			// only pixels whose center is inside are covered
+			float e0 = ((p_b.x - p_a.x) * (py - p_a.y) - (p_b.y - p_a.y) * (px - p_a.x)) * sign;
+			float e1 = ((p_c.x - p_b.x) * (py - p_b.y) - (p_c.y - p_b.y) * (px - p_b.x)) * sign;
+			float e2 = ((p_a.x - p_c.x) * (py - p_c.y) - (p_a.y - p_c.y) * (px - p_c.x)) * sign;
+
+			if (e0 < 0 || e1 < 0 || e2 < 0)
+				continue;
+
+			float &d = depth_w[y * width + x];
+			if (tri_depth < d) {
+				d = tri_depth;
+				empty = false;
+			}
+		}
+	}
+}
+
+void OcclusionBuffer::set_size(int p_width, int p_height) {
+
+	ERR_FAIL_COND(p_width < 1 || p_height < 1);
+
+	width = p_width;
+	height = p_height;
+	depth.resize(width * height);
+
+	float *depth_w = depth.ptrw();
+	for (int i = 0; i < depth.size(); i++) {
+		depth_w[i] = 1e20;
+	}
+	empty = true;
+}
+
+void OcclusionBuffer::clear(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection) {
+
+	view_xform = p_cam_transform.affine_inverse();
+	projection = p_cam_projection;
+	z_near = p_cam_projection.get_z_near();
+
+	if (!empty) {
+		float *depth_w = depth.ptrw();
+		for (int i = 0; i < depth.size(); i++) {
+			depth_w[i] = 1e20;
+		}
+		empty = true;
+	}
+}
+
+void OcclusionBuffer::add_occluder(const Vector3 *p_vertices, int p_vertex_count, const Transform &p_xform) {
+
+	for (int i = 0; i + 2 < p_vertex_count; i += 3) {
+
+		Vector3 screen[3];
+		bool visible = true;
+		for (int j = 0; j < 3; j++) {
+			if (!_project(p_xform.xform(p_vertices[i + j]), screen[j])) {
+				visible = false; //crossing the near plane, skipping it only means occluding less
+				break;
+			}
+		}
+
+		if (visible) {
+			_raster_triangle(screen[0], screen[1], screen[2]);
+		}
+	}
+}
+
+bool OcclusionBuffer::is_occluded(const AABB &p_aabb) const {
+
+	if (empty)
+		return false;
+
+	Vector3 min_screen;
+	Vector3 max_screen;
+
+	for (int i = 0; i < 8; i++) {
+
+		Vector3 screen;
+		if (!_project(p_aabb.get_endpoint(i), screen))
+			return false;
+
+		if (i == 0) {
+			min_screen = screen;
+			max_screen = screen;
+		} else {
+			min_screen.x = MIN(min_screen.x, screen.x);
+			min_screen.y = MIN(min_screen.y, screen.y);
+			min_screen.z = MIN(min_screen.z, screen.z);
+			max_screen.x = MAX(max_screen.x, screen.x);
+			max_screen.y = MAX(max_screen.y, screen.y);
+		}
+	}
+
+	int x_from = MAX(0, int(Math::floor(min_screen.x)));
+	int x_to = MIN(width - 1, int(Math::ceil(max_screen.x)));
+	int y_from = MAX(0, int(Math::floor(min_screen.y)));
+	int y_to = MIN(height - 1, int(Math::ceil(max_screen.y)));
+
+	if (x_from > x_to || y_from > y_to)
+		return false; //off screen, leave it to frustum culling
+
+	const float *depth_r = depth.ptr();
+
+	for (int y = y_from; y <= y_to; y++) {
+		for (int x = x_from; x <= x_to; x++) {
+			if (depth_r[y * width + x] >= min_screen.z)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+OcclusionBuffer::OcclusionBuffer() {
+
+	width = 0;
+	height = 0;
+	empty = true;
+	z_near = 0;
+}
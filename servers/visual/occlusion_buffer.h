@@ -0,0 +1,86 @@
+/*************************************************************************/
+/*  occlusion_buffer.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include "camera_matrix.h"
+#include "transform.h"
+#include "vector.h"
+
+/**
+ * Small software depth buffer used to cull instances hidden behind occluders.
+ *
+ * Occluder triangles are rasterized at low resolution, each one at the depth
+ * of its furthest vertex, so the buffer never reports something as closer than
+ * it really is. Bounding boxes are then tested against it conservatively:
+ * anything that crosses the near plane, or whose screen rectangle has a single
+ * pixel not covered by a closer occluder, is visible.
+ */
+
+class OcclusionBuffer {
+
+	int width;
+	int height;
+	Vector<float> depth; // view space distance of the nearest occluder, per pixel
+	bool empty;
+
+	Transform view_xform;
+	CameraMatrix projection;
+	real_t z_near;
+
+	_FORCE_INLINE_ bool _project(const Vector3 &p_point, Vector3 &r_screen) const {
+
+		Vector3 view = view_xform.xform(p_point);
+		if (-view.z < z_near)
+			return false;
+
+		Plane clip = projection.xform4(Plane(view.x, view.y, view.z, 1.0));
+		r_screen.x = (clip.normal.x / clip.d * 0.5 + 0.5) * width;
+		r_screen.y = (0.5 - clip.normal.y / clip.d * 0.5) * height;
+		r_screen.z = -view.z;
+		return true;
+	}
+
+	void _raster_triangle(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c);
+
+public:
+	void set_size(int p_width, int p_height);
+
+	void clear(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection);
+	void add_occluder(const Vector3 *p_vertices, int p_vertex_count, const Transform &p_xform);
+
+	bool is_empty() const { return empty; }
+	bool is_occluded(const AABB &p_aabb) const;
+
+	OcclusionBuffer();
+};
+
+#endif // OCCLUSION_BUFFER_H
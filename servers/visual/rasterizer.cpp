@@ -42,6 +42,20 @@ Rasterizer *Rasterizer::create() {
 
 RasterizerStorage *RasterizerStorage::base_singleton = NULL;
 
+RasterizerCanvas *RasterizerCanvas::base_singleton = NULL;
+
+RasterizerCanvas::RasterizerCanvas() {
+
+	base_singleton = this;
+}
+
+RasterizerCanvas::~RasterizerCanvas() {
+
+	if (base_singleton == this) {
+		base_singleton = NULL;
+	}
+}
+
 RasterizerStorage::RasterizerStorage() {
 
 	base_singleton = this;
@@ -67,6 +67,7 @@ public:
 
 	virtual void environment_set_ssr(RID p_env, bool p_enable, int p_max_steps, float p_fade_int, float p_fade_out, float p_depth_tolerance, bool p_roughness) = 0;
 	virtual void environment_set_ssao(RID p_env, bool p_enable, float p_radius, float p_intensity, float p_radius2, float p_intensity2, float p_bias, float p_light_affect, float p_ao_channel_affect, const Color &p_color, VS::EnvironmentSSAOQuality p_quality, VS::EnvironmentSSAOBlur p_blur, float p_bilateral_sharpness) = 0;
+	virtual void environment_set_ssao_resolution(RID p_env, VS::EnvironmentSSAOResolution p_resolution) = 0;
 
 	virtual void environment_set_tonemap(RID p_env, VS::EnvironmentToneMapper p_tone_mapper, float p_exposure, float p_white, bool p_auto_exposure, float p_min_luminance, float p_max_luminance, float p_auto_exp_speed, float p_auto_exp_scale) = 0;
 
@@ -113,6 +114,9 @@ public:
 
 		float depth; //used for sorting
 
+		float lod_begin; //draw range, also applied per chunk to multimeshes by the rasterizer
+		float lod_end;
+
 		SelfList<InstanceBase> dependency_item;
 
 		InstanceBase *lightmap_capture;
@@ -135,6 +139,8 @@ public:
 			baked_light = false;
 			redraw_if_visible = false;
 			lightmap_capture = NULL;
+			lod_begin = 0;
+			lod_end = 0;
 		}
 	};
 
@@ -166,6 +172,15 @@ public:
 	virtual void set_scene_pass(uint64_t p_pass) = 0;
 	virtual void set_debug_draw_mode(VS::ViewportDebugDraw p_debug_draw) = 0;
 
+	// both eyes of a stereo frame render the same cull result, so the second one may reuse what the first one built
+	enum StereoPass {
+		STEREO_PASS_NONE,
+		STEREO_PASS_FIRST_EYE,
+		STEREO_PASS_SECOND_EYE
+	};
+
+	virtual void set_stereo_pass(StereoPass p_pass) {}
+
 	virtual bool free(RID p_rid) = 0;
 
 	virtual ~RasterizerScene() {}
@@ -217,6 +232,7 @@ public:
 	virtual void texture_set_detect_3d_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) = 0;
 	virtual void texture_set_detect_srgb_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) = 0;
 	virtual void texture_set_detect_normal_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) = 0;
+	virtual void texture_set_stream_request_callback(RID p_texture, VisualServer::TextureStreamRequestCallback p_callback, void *p_userdata) = 0;
 
 	virtual void textures_keep_original(bool p_enable) = 0;
 
@@ -256,6 +272,7 @@ public:
 
 	virtual bool material_is_animated(RID p_material) = 0;
 	virtual bool material_casts_shadows(RID p_material) = 0;
+	virtual void material_request_texture_size(RID p_material, int p_size) = 0; ///< forwards to the stream request callbacks of its textures
 
 	virtual void material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) = 0;
 	virtual void material_remove_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) = 0;
@@ -349,6 +366,7 @@ public:
 	virtual void skeleton_allocate(RID p_skeleton, int p_bones, bool p_2d_skeleton = false) = 0;
 	virtual int skeleton_get_bone_count(RID p_skeleton) const = 0;
 	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) = 0;
+	virtual void skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms) = 0;
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const = 0;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) = 0;
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const = 0;
@@ -571,6 +589,10 @@ public:
 
 	virtual void set_debug_generate_wireframes(bool p_generate) = 0;
 
+	virtual void shader_variants_set_recording(bool p_enable) = 0;
+	virtual Vector<String> shader_variants_get_recorded() = 0;
+	virtual void shader_variants_precompile(const Vector<String> &p_variants) = 0;
+
 	virtual void render_info_begin_capture() = 0;
 	virtual void render_info_end_capture() = 0;
 	virtual int get_captured_render_info(VS::RenderInfo p_info) = 0;
@@ -584,6 +606,8 @@ public:
 
 class RasterizerCanvas {
 public:
+	static RasterizerCanvas *base_singleton;
+
 	enum CanvasRectFlags {
 
 		CANVAS_RECT_REGION = 1,
@@ -624,6 +648,8 @@ public:
 		Transform2D xform_cache;
 		float radius_cache; //used for shadow far plane
 		CameraMatrix shadow_matrix_cache;
+		uint32_t shadow_cache_hash; //light and occluder state the shadow buffer was last rendered with
+		bool shadow_cache_valid;
 
 		Transform2D light_shader_xform;
 		Vector2 light_shader_pos;
@@ -657,6 +683,8 @@ public:
 			shadow_gradient_length = 0;
 			shadow_filter = VS::CANVAS_LIGHT_FILTER_NONE;
 			shadow_smooth = 0.0;
+			shadow_cache_hash = 0;
+			shadow_cache_valid = false;
 		}
 	};
 
@@ -664,6 +692,12 @@ public:
 	virtual void light_internal_update(RID p_rid, Light *p_light) = 0;
 	virtual void light_internal_free(RID p_rid) = 0;
 
+	typedef uint64_t PolygonID;
+
+	//retained vertex buffers for 2D meshes, a renderer that does not retain them returns 0 and draws from the command arrays
+	virtual PolygonID request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>()) = 0;
+	virtual void free_polygon(PolygonID p_polygon) = 0;
+
 	struct Item : public RID_Data {
 
 		struct Command {
@@ -770,10 +804,17 @@ public:
 			RID normal_map;
 			int count;
 			bool antialiased;
+			PolygonID polygon_id; //retained by the renderer, 0 if the arrays above are drawn every frame
 
 			CommandPolygon() {
 				type = TYPE_POLYGON;
 				count = 0;
+				polygon_id = 0;
+			}
+			~CommandPolygon() {
+				if (polygon_id && base_singleton) {
+					base_singleton->free_polygon(polygon_id);
+				}
 			}
 		};
 
@@ -865,6 +906,36 @@ public:
 
 		Rect2 global_rect_cache;
 
+		// commands are constructed in pages owned by the item, clearing keeps the pages so items redrawn every frame don't allocate them again
+		enum {
+			COMMAND_PAGE_SIZE = 4096
+		};
+
+		Vector<uint8_t *> command_pages;
+		int command_page;
+		uint32_t command_page_offset;
+
+		template <class T>
+		T *alloc_command() {
+
+			uint32_t size = (sizeof(T) + 15) & ~15; //keep commands aligned
+			ERR_FAIL_COND_V(size > COMMAND_PAGE_SIZE, NULL);
+
+			if (command_page_offset + size > COMMAND_PAGE_SIZE) {
+				command_page++;
+				command_page_offset = 0;
+			}
+
+			if (command_page == command_pages.size()) {
+				command_pages.push_back((uint8_t *)memalloc(COMMAND_PAGE_SIZE));
+			}
+
+			T *command = memnew_placement(command_pages[command_page] + command_page_offset, T);
+			command_page_offset += size;
+			commands.push_back(command);
+			return command;
+		}
+
 		const Rect2 &get_rect() const {
 			if (custom_rect || !rect_dirty)
 				return rect;
@@ -1014,8 +1085,10 @@ public:
 
 		void clear() {
 			for (int i = 0; i < commands.size(); i++)
-				memdelete(commands[i]);
+				commands[i]->~Command();
 			commands.clear();
+			command_page = 0;
+			command_page_offset = 0;
 			clip = false;
 			rect_dirty = true;
 			final_clip_owner = NULL;
@@ -1037,9 +1110,13 @@ public:
 			copy_back_buffer = NULL;
 			distance_field = false;
 			light_masked = false;
+			command_page = 0;
+			command_page_offset = 0;
 		}
 		virtual ~Item() {
 			clear();
+			for (int i = 0; i < command_pages.size(); i++)
+				memfree(command_pages[i]);
 			if (copy_back_buffer) memdelete(copy_back_buffer);
 		}
 	};
@@ -1061,6 +1138,7 @@ public:
 		Transform2D xform_cache;
 		int light_mask;
 		VS::CanvasOccluderPolygonCullMode cull_cache;
+		uint32_t version; //increased when the polygon shape changes, so cached shadows are redrawn
 
 		LightOccluderInstance *next;
 
@@ -1068,6 +1146,7 @@ public:
 			enabled = true;
 			next = NULL;
 			light_mask = 1;
+			version = 0;
 			cull_cache = VS::CANVAS_OCCLUDER_POLYGON_CULL_DISABLED;
 		}
 	};
@@ -1078,7 +1157,8 @@ public:
 
 	virtual void draw_window_margins(int *p_margins, RID *p_margin_textures) = 0;
 
-	virtual ~RasterizerCanvas() {}
+	RasterizerCanvas();
+	virtual ~RasterizerCanvas();
 };
 
 class Rasterizer {
@@ -1099,6 +1179,8 @@ public:
 	virtual void set_current_render_target(RID p_render_target) = 0;
 	virtual void restore_render_target() = 0;
 	virtual void clear_render_target(const Color &p_color) = 0;
+	// clears part of the current render target right away and keeps the rest, returns false when not supported
+	virtual bool clear_render_target_rect(const Rect2 &p_rect, const Color &p_color) { return false; }
 	virtual void blit_render_target_to_screen(RID p_render_target, const Rect2 &p_screen_rect, int p_screen = 0) = 0;
 	virtual void end_frame(bool p_swap_buffers) = 0;
 	virtual void finalize() = 0;
@@ -180,6 +180,8 @@ ShaderTypes::ShaderTypes() {
 
 	shader_modes[VS::SHADER_SPATIAL].modes.push_back("vertex_lighting");
 
+	shader_modes[VS::SHADER_SPATIAL].modes.push_back("lights_single_pass");
+
 	/************ CANVAS ITEM **************************/
 
 	shader_modes[VS::SHADER_CANVAS_ITEM].functions["vertex"].built_ins["VERTEX"] = ShaderLanguage::TYPE_VEC2;
@@ -30,6 +30,7 @@
 
 #include "visual_server_canvas.h"
 #include "visual_server_global.h"
+#include "visual_server_raster.h"
 #include "visual_server_viewport.h"
 
 void VisualServerCanvas::_render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights) {
@@ -50,6 +51,96 @@ void VisualServerCanvas::_render_canvas_item_tree(Item *p_canvas_item, const Tra
 	}
 }
 
+void VisualServerCanvas::_item_bounds_changed(Item *p_canvas_item) {
+
+	p_canvas_item->damage_version++;
+
+	// all parents of a dirty item are dirty too, so stop as soon as one is found
+	Item *ci = p_canvas_item;
+	while (ci && !ci->subtree_dirty) {
+
+		ci->subtree_dirty = true;
+		ci = canvas_item_owner.owns(ci->parent) ? canvas_item_owner.get(ci->parent) : NULL;
+	}
+}
+
+void VisualServerCanvas::_update_item_bounds(Item *p_canvas_item) {
+
+	Item *ci = p_canvas_item;
+
+	if (!ci->subtree_dirty)
+		return;
+
+	ci->subtree_has_rect = !ci->commands.empty();
+	ci->subtree_rect = ci->subtree_has_rect ? ci->get_rect() : Rect2();
+	ci->subtree_always_visible = ci->vp_render || ci->copy_back_buffer;
+
+	int child_item_count = ci->child_items.size();
+	for (int i = 0; i < child_item_count; i++) {
+
+		Item *child = ci->child_items[i];
+		if (!child->visible)
+			continue;
+
+		_update_item_bounds(child);
+
+		if (child->subtree_always_visible) {
+			ci->subtree_always_visible = true;
+		}
+
+		if (!child->subtree_has_rect)
+			continue;
+
+		Rect2 child_rect = child->xform.xform(child->subtree_rect);
+		if (ci->subtree_has_rect) {
+			ci->subtree_rect = ci->subtree_rect.merge(child_rect);
+		} else {
+			ci->subtree_rect = child_rect;
+			ci->subtree_has_rect = true;
+		}
+	}
+
+	ci->subtree_dirty = false;
+}
+
+void VisualServerCanvas::_update_ysort_children(Item *p_canvas_item) {
+
+	Item *ci = p_canvas_item;
+	int count = ci->child_items.size();
+
+	if (!ci->ysort_children_dirty && ci->ysort_children.size() == count) {
+
+		// the order from the last frame is usually almost right, fix it up with an insertion sort
+		// and give up on it if too many items moved, so the cost stays bounded
+		ItemPtrSort compare;
+		Item **items = ci->ysort_children.ptrw();
+		int moves = 0;
+		int max_moves = count * 4;
+
+		for (int i = 1; i < count && moves <= max_moves; i++) {
+
+			Item *item = items[i];
+			int j = i;
+			while (j > 0 && compare(item, items[j - 1])) {
+				items[j] = items[j - 1];
+				j--;
+			}
+			items[j] = item;
+			moves += i - j;
+		}
+
+		if (moves <= max_moves)
+			return;
+	} else {
+
+		ci->ysort_children = ci->child_items;
+		ci->ysort_children_dirty = false;
+	}
+
+	SortArray<Item *, ItemPtrSort> sorter;
+	sorter.sort(ci->ysort_children.ptrw(), count);
+}
+
 void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
 
 	Item *ci = p_canvas_item;
@@ -57,14 +148,31 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 	if (!ci->visible)
 		return;
 
+	_update_item_bounds(ci);
+
+	Transform2D xform = p_transform * ci->xform;
+
+	if (!ci->subtree_always_visible) {
+
+		// nothing in this subtree can reach the screen, skip it without visiting the children
+		if (!ci->subtree_has_rect)
+			return;
+
+		Rect2 subtree_global_rect = xform.xform(ci->subtree_rect);
+		subtree_global_rect.position += p_clip_rect.position;
+
+		if (!p_clip_rect.intersects(subtree_global_rect))
+			return;
+	}
+
 	if (p_canvas_item->children_order_dirty) {
 
 		p_canvas_item->child_items.sort_custom<ItemIndexSort>();
 		p_canvas_item->children_order_dirty = false;
+		p_canvas_item->ysort_children_dirty = true;
 	}
 
 	Rect2 rect = ci->get_rect();
-	Transform2D xform = p_transform * ci->xform;
 	Rect2 global_rect = xform.xform(rect);
 	global_rect.position += p_clip_rect.position;
 
@@ -80,9 +188,13 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 	if (modulate.a < 0.007)
 		return;
 
+	if (ci->sort_y) {
+		_update_ysort_children(ci);
+	}
+
 	int child_item_count = ci->child_items.size();
 	Item **child_items = (Item **)alloca(child_item_count * sizeof(Item *));
-	copymem(child_items, ci->child_items.ptr(), child_item_count * sizeof(Item *));
+	copymem(child_items, ci->sort_y ? ci->ysort_children.ptr() : ci->child_items.ptr(), child_item_count * sizeof(Item *));
 
 	if (ci->clip) {
 		if (p_canvas_clip != NULL) {
@@ -96,12 +208,6 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 		ci->final_clip_owner = p_canvas_clip;
 	}
 
-	if (ci->sort_y) {
-
-		SortArray<Item *, ItemPtrSort> sorter;
-		sorter.sort(child_items, child_item_count);
-	}
-
 	if (ci->z_relative)
 		p_z = CLAMP(p_z + ci->z_index, VS::CANVAS_ITEM_Z_MIN, VS::CANVAS_ITEM_Z_MAX);
 	else
@@ -119,7 +225,9 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 		ci->copy_back_buffer->screen_rect = xform.xform(ci->copy_back_buffer->rect).clip(p_clip_rect);
 	}
 
-	if ((!ci->commands.empty() && p_clip_rect.intersects(global_rect)) || ci->vp_render || ci->copy_back_buffer) {
+	bool damaged = !damage_clip_active || damage_clip.final_clip_rect.intersects(Rect2(global_rect.position - p_clip_rect.position, global_rect.size));
+
+	if ((!ci->commands.empty() && p_clip_rect.intersects(global_rect) && damaged) || ci->vp_render || ci->copy_back_buffer) {
 		//something to draw?
 		ci->final_transform = xform;
 		ci->final_modulate = Color(modulate.r * ci->self_modulate.r, modulate.g * ci->self_modulate.g, modulate.b * ci->self_modulate.b, modulate.a * ci->self_modulate.a);
@@ -202,8 +310,11 @@ void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_tr
 		memset(z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
 		memset(z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
 
+		// when only part of the viewport is redrawn, everything is clipped to it
+		Item *canvas_clip = damage_clip_active ? &damage_clip : NULL;
+
 		for (int i = 0; i < l; i++) {
-			_render_canvas_item(ci[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
+			_render_canvas_item(ci[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, canvas_clip, NULL);
 		}
 
 		for (int i = 0; i < z_range; i++) {
@@ -245,6 +356,138 @@ void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_tr
 	VSG::canvas_render->canvas_end();
 }
 
+static _FORCE_INLINE_ uint32_t _hash_transform(const Transform2D &p_xform, uint32_t p_hash) {
+
+	for (int i = 0; i < 3; i++) {
+		p_hash = hash_djb2_one_float(p_xform.elements[i].x, p_hash);
+		p_hash = hash_djb2_one_float(p_xform.elements[i].y, p_hash);
+	}
+	return p_hash;
+}
+
+void VisualServerCanvas::_damage_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Color &p_modulate, int p_z, Item *p_material_owner) {
+
+	Item *ci = p_canvas_item;
+
+	if (!ci->visible)
+		return;
+
+	if (ci->vp_render || ci->copy_back_buffer) {
+		// these read or show other render targets, the whole viewport has to be drawn
+		damage_full = true;
+		return;
+	}
+
+	Transform2D xform = p_transform * ci->xform;
+
+	if (!ci->use_parent_material || !p_material_owner) {
+		p_material_owner = ci;
+	}
+
+	Color modulate(ci->modulate.r * p_modulate.r, ci->modulate.g * p_modulate.g, ci->modulate.b * p_modulate.b, ci->modulate.a * p_modulate.a);
+
+	if (modulate.a < 0.007)
+		return;
+
+	if (ci->z_relative)
+		p_z = CLAMP(p_z + ci->z_index, VS::CANVAS_ITEM_Z_MIN, VS::CANVAS_ITEM_Z_MAX);
+	else
+		p_z = ci->z_index;
+
+	if (!ci->commands.empty()) {
+
+		Rect2 rect = xform.xform(ci->get_rect());
+
+		uint32_t hash = _hash_transform(xform, ci->damage_version);
+		hash = hash_djb2_one_float(modulate.r * ci->self_modulate.r, hash);
+		hash = hash_djb2_one_float(modulate.g * ci->self_modulate.g, hash);
+		hash = hash_djb2_one_float(modulate.b * ci->self_modulate.b, hash);
+		hash = hash_djb2_one_float(modulate.a * ci->self_modulate.a, hash);
+		hash = hash_djb2_one_32(p_z, hash);
+		hash = hash_djb2_one_32(ci->index, hash);
+		hash = hash_djb2_one_32(ci->behind | (ci->clip << 1) | (ci->distance_field << 2), hash);
+
+		bool drawn = ci->damage_item.in_list();
+
+		// material parameters and shader time are not tracked, so items with materials are drawn every frame
+		if (!drawn || hash != ci->damage_hash || rect != ci->damage_rect || ci->damage_always || ci->skeleton.is_valid() || p_material_owner->material.is_valid()) {
+
+			if (drawn) {
+				_damage_add(ci->damage_rect);
+			}
+			_damage_add(rect);
+		}
+
+		ci->damage_rect = rect;
+		ci->damage_hash = hash;
+		ci->damage_pass = damage_pass;
+		if (!drawn) {
+			damage_items.add(&ci->damage_item);
+		}
+	}
+
+	int child_item_count = ci->child_items.size();
+	Item **child_items = ci->child_items.ptrw();
+	for (int i = 0; i < child_item_count; i++) {
+		_damage_canvas_item(child_items[i], xform, modulate, p_z, p_material_owner);
+	}
+}
+
+void VisualServerCanvas::damage_begin() {
+
+	damage_pass++;
+}
+
+void VisualServerCanvas::damage_canvas(Canvas *p_canvas, const Transform2D &p_transform) {
+
+	int l = p_canvas->child_items.size();
+	const Canvas::ChildItem *ci = p_canvas->child_items.ptr();
+
+	for (int i = 0; i < l; i++) {
+
+		if (ci[i].mirror.x || ci[i].mirror.y) {
+			damage_full = true;
+		}
+		_damage_canvas_item(ci[i].item, p_transform, Color(1, 1, 1, 1), 0, NULL);
+	}
+}
+
+VisualServerViewport::Damage VisualServerCanvas::damage_end(Rect2 &r_rect) {
+
+	// items that were drawn last time and were not reached now (hidden, moved away, removed), leave a hole
+	SelfList<Item> *E = damage_items.first();
+	while (E) {
+
+		SelfList<Item> *N = E->next();
+		if (E->self()->damage_pass != damage_pass) {
+			_damage_add(E->self()->damage_rect);
+			damage_items.remove(E);
+		}
+		E = N;
+	}
+
+	VisualServerViewport::Damage damage = damage_full ? VisualServerViewport::DAMAGE_FULL : (damage_has_rect ? VisualServerViewport::DAMAGE_PARTIAL : VisualServerViewport::DAMAGE_NONE);
+	r_rect = damage_rect;
+
+	damage_rect = Rect2();
+	damage_has_rect = false;
+	damage_full = false;
+
+	return damage;
+}
+
+void VisualServerCanvas::damage_clip_begin(const Rect2 &p_rect) {
+
+	damage_clip.final_clip_rect = p_rect;
+	damage_clip.final_clip_owner = &damage_clip;
+	damage_clip_active = true;
+}
+
+void VisualServerCanvas::damage_clip_end() {
+
+	damage_clip_active = false;
+}
+
 RID VisualServerCanvas::canvas_create() {
 
 	Canvas *canvas = memnew(Canvas);
@@ -295,6 +538,8 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 
 			Item *item_owner = canvas_item_owner.get(canvas_item->parent);
 			item_owner->child_items.erase(canvas_item);
+			item_owner->ysort_children_dirty = true;
+			_item_bounds_changed(item_owner);
 		}
 
 		canvas_item->parent = RID();
@@ -322,6 +567,10 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 	}
 
 	canvas_item->parent = p_parent;
+
+	// force the new parents to pick up the bounds of this item
+	canvas_item->subtree_dirty = false;
+	_item_bounds_changed(canvas_item);
 }
 void VisualServerCanvas::canvas_item_set_visible(RID p_item, bool p_visible) {
 
@@ -329,6 +578,7 @@ void VisualServerCanvas::canvas_item_set_visible(RID p_item, bool p_visible) {
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->visible = p_visible;
+	_item_bounds_changed(canvas_item);
 }
 void VisualServerCanvas::canvas_item_set_light_mask(RID p_item, int p_mask) {
 
@@ -343,13 +593,96 @@ void VisualServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
+	if (canvas_item->interpolated) {
+		//will be blended towards this one as the frames of the current physics tick are drawn
+		canvas_item->xform_curr = p_transform;
+		if (!canvas_item->interpolation_item.in_list()) {
+			item_interpolation_list.add(&canvas_item->interpolation_item);
+		}
+		return;
+	}
+
 	canvas_item->xform = p_transform;
+	_item_bounds_changed(canvas_item);
+}
+
+void VisualServerCanvas::canvas_item_set_interpolated(RID p_item, bool p_interpolated) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	if (canvas_item->interpolated == p_interpolated)
+		return;
+
+	if (p_interpolated) {
+		canvas_item->xform_prev = canvas_item->xform;
+		canvas_item->xform_curr = canvas_item->xform;
+		canvas_item->interpolated = true;
+	} else {
+		//jump to the latest transform
+		canvas_item->interpolated = false;
+		if (canvas_item->interpolation_item.in_list()) {
+			item_interpolation_list.remove(&canvas_item->interpolation_item);
+		}
+		canvas_item->xform = canvas_item->xform_curr;
+		_item_bounds_changed(canvas_item);
+	}
+}
+
+void VisualServerCanvas::canvas_item_reset_physics_interpolation(RID p_item) {
+
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	if (!canvas_item->interpolated)
+		return;
+
+	//teleport, don't blend from where it was
+	canvas_item->xform_prev = canvas_item->xform_curr;
+	canvas_item->xform = canvas_item->xform_curr;
+	_item_bounds_changed(canvas_item);
+}
+
+void VisualServerCanvas::tick() {
+
+	//the transforms of the tick that just ended are where the next blends start from
+	for (SelfList<Item> *E = item_interpolation_list.first(); E; E = E->next()) {
+
+		Item *canvas_item = E->self();
+		canvas_item->xform_prev = canvas_item->xform_curr;
+	}
+}
+
+void VisualServerCanvas::update_interpolation_frame(float p_fraction) {
+
+	SelfList<Item> *E = item_interpolation_list.first();
+	while (E) {
+
+		SelfList<Item> *N = E->next();
+		Item *canvas_item = E->self();
+
+		if (canvas_item->xform_prev == canvas_item->xform_curr) {
+			//stopped moving, no need to keep blending it
+			canvas_item->xform = canvas_item->xform_curr;
+			item_interpolation_list.remove(E);
+		} else {
+			canvas_item->xform = canvas_item->xform_prev.interpolate_with(canvas_item->xform_curr, p_fraction);
+			VisualServerRaster::redraw_request(); //keep drawing until the blend is done
+		}
+
+		_item_bounds_changed(canvas_item);
+
+		E = N;
+	}
 }
 void VisualServerCanvas::canvas_item_set_clip(RID p_item, bool p_clip) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
+	if (canvas_item->clip != p_clip) {
+		damage_full = true; // children may now draw outside of the area that was redrawn for this item
+	}
 	canvas_item->clip = p_clip;
 }
 void VisualServerCanvas::canvas_item_set_distance_field_mode(RID p_item, bool p_enable) {
@@ -366,6 +699,7 @@ void VisualServerCanvas::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+	_item_bounds_changed(canvas_item);
 }
 void VisualServerCanvas::canvas_item_set_modulate(RID p_item, const Color &p_color) {
 
@@ -395,7 +729,7 @@ void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from,
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandLine *line = memnew(Item::CommandLine);
+	Item::CommandLine *line = canvas_item->alloc_command<Item::CommandLine>();
 	ERR_FAIL_COND(!line);
 	line->color = p_color;
 	line->from = p_from;
@@ -403,8 +737,7 @@ void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from,
 	line->width = p_width;
 	line->antialiased = p_antialiased;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(line);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, float p_width, bool p_antialiased) {
@@ -413,7 +746,7 @@ void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandPolyLine *pline = memnew(Item::CommandPolyLine);
+	Item::CommandPolyLine *pline = canvas_item->alloc_command<Item::CommandPolyLine>();
 	ERR_FAIL_COND(!pline);
 
 	pline->antialiased = p_antialiased;
@@ -489,7 +822,7 @@ void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point
 		}
 	}
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(pline);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, float p_width, bool p_antialiased) {
@@ -498,7 +831,7 @@ void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandPolyLine *pline = memnew(Item::CommandPolyLine);
+	Item::CommandPolyLine *pline = canvas_item->alloc_command<Item::CommandPolyLine>();
 	ERR_FAIL_COND(!pline);
 
 	pline->antialiased = false; //todo
@@ -513,7 +846,7 @@ void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	}
 
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(pline);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color) {
@@ -521,13 +854,12 @@ void VisualServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandRect *rect = memnew(Item::CommandRect);
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate = p_color;
 	rect->rect = p_rect;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(rect);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color) {
@@ -535,13 +867,14 @@ void VisualServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandCircle *circle = memnew(Item::CommandCircle);
+	Item::CommandCircle *circle = canvas_item->alloc_command<Item::CommandCircle>();
 	ERR_FAIL_COND(!circle);
 	circle->color = p_color;
 	circle->pos = p_pos;
 	circle->radius = p_radius;
 
-	canvas_item->commands.push_back(circle);
+	canvas_item->rect_dirty = true;
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose, RID p_normal_map) {
@@ -549,7 +882,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandRect *rect = memnew(Item::CommandRect);
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate = p_modulate;
 	rect->rect = p_rect;
@@ -577,7 +910,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 	rect->texture = p_texture;
 	rect->normal_map = p_normal_map;
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(rect);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, RID p_normal_map, bool p_clip_uv) {
@@ -585,7 +918,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandRect *rect = memnew(Item::CommandRect);
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate = p_modulate;
 	rect->rect = p_rect;
@@ -614,8 +947,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 	}
 
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(rect);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, VS::NinePatchAxisMode p_x_axis_mode, VS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate, RID p_normal_map) {
@@ -623,7 +955,7 @@ void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_r
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandNinePatch *style = memnew(Item::CommandNinePatch);
+	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_COND(!style);
 	style->texture = p_texture;
 	style->normal_map = p_normal_map;
@@ -638,15 +970,14 @@ void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_r
 	style->axis_x = p_x_axis_mode;
 	style->axis_y = p_y_axis_mode;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(style);
+	_item_bounds_changed(canvas_item);
 }
 void VisualServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, float p_width, RID p_normal_map) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandPrimitive *prim = memnew(Item::CommandPrimitive);
+	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
 	prim->texture = p_texture;
 	prim->normal_map = p_normal_map;
@@ -655,8 +986,7 @@ void VisualServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<Poin
 	prim->colors = p_colors;
 	prim->width = p_width;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(prim);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, RID p_normal_map, bool p_antialiased) {
@@ -679,7 +1009,7 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 		ERR_FAIL_V();
 	}
 
-	Item::CommandPolygon *polygon = memnew(Item::CommandPolygon);
+	Item::CommandPolygon *polygon = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture = p_texture;
 	polygon->normal_map = p_normal_map;
@@ -690,8 +1020,7 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 	polygon->count = indices.size();
 	polygon->antialiased = p_antialiased;
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(polygon);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count, RID p_normal_map) {
@@ -721,7 +1050,7 @@ void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector
 			count = indices.size();
 	}
 
-	Item::CommandPolygon *polygon = memnew(Item::CommandPolygon);
+	Item::CommandPolygon *polygon = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture = p_texture;
 	polygon->normal_map = p_normal_map;
@@ -733,9 +1062,10 @@ void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector
 	polygon->indices = indices;
 	polygon->count = count;
 	polygon->antialiased = false;
+	//2D meshes are usually static, keep their vertices on the GPU so only the skeleton changes per frame
+	polygon->polygon_id = VSG::canvas_render->request_polygon(indices, p_points, p_colors, p_uvs, p_bones, p_weights);
 	canvas_item->rect_dirty = true;
-
-	canvas_item->commands.push_back(polygon);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
@@ -743,11 +1073,12 @@ void VisualServerCanvas::canvas_item_add_set_transform(RID p_item, const Transfo
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandTransform *tr = memnew(Item::CommandTransform);
+	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_COND(!tr);
 	tr->xform = p_transform;
 
-	canvas_item->commands.push_back(tr);
+	canvas_item->rect_dirty = true;
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, RID p_texture, RID p_normal_map) {
@@ -755,20 +1086,22 @@ void VisualServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, RID
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandMesh *m = memnew(Item::CommandMesh);
+	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
 	ERR_FAIL_COND(!m);
 	m->mesh = p_mesh;
 	m->texture = p_texture;
 	m->normal_map = p_normal_map;
 
-	canvas_item->commands.push_back(m);
+	canvas_item->damage_always = true;
+	canvas_item->rect_dirty = true;
+	_item_bounds_changed(canvas_item);
 }
 void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture, RID p_normal, int p_h_frames, int p_v_frames) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandParticles *part = memnew(Item::CommandParticles);
+	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_COND(!part);
 	part->particles = p_particles;
 	part->texture = p_texture;
@@ -779,8 +1112,9 @@ void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles,
 	//take the chance and request processing for them, at least once until they become visible again
 	VSG::storage->particles_request_process(p_particles);
 
+	canvas_item->damage_always = true;
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(part);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture, RID p_normal_map) {
@@ -788,14 +1122,15 @@ void VisualServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandMultiMesh *mm = memnew(Item::CommandMultiMesh);
+	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_COND(!mm);
 	mm->multimesh = p_mesh;
 	mm->texture = p_texture;
 	mm->normal_map = p_normal_map;
 
+	canvas_item->damage_always = true;
 	canvas_item->rect_dirty = true;
-	canvas_item->commands.push_back(mm);
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
@@ -803,11 +1138,9 @@ void VisualServerCanvas::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
-	Item::CommandClipIgnore *ci = memnew(Item::CommandClipIgnore);
+	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
 	ci->ignore = p_ignore;
-
-	canvas_item->commands.push_back(ci);
 }
 void VisualServerCanvas::canvas_item_set_sort_children_by_y(RID p_item, bool p_enable) {
 
@@ -815,6 +1148,7 @@ void VisualServerCanvas::canvas_item_set_sort_children_by_y(RID p_item, bool p_e
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->sort_y = p_enable;
+	canvas_item->ysort_children_dirty = true;
 }
 void VisualServerCanvas::canvas_item_set_z_index(RID p_item, int p_z) {
 
@@ -858,6 +1192,8 @@ void VisualServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 		canvas_item->copy_back_buffer->rect = p_rect;
 		canvas_item->copy_back_buffer->full = p_rect == Rect2();
 	}
+
+	_item_bounds_changed(canvas_item);
 }
 
 void VisualServerCanvas::canvas_item_clear(RID p_item) {
@@ -866,6 +1202,8 @@ void VisualServerCanvas::canvas_item_clear(RID p_item) {
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->clear();
+	canvas_item->damage_always = false;
+	_item_bounds_changed(canvas_item);
 }
 void VisualServerCanvas::canvas_item_set_draw_index(RID p_item, int p_index) {
 
@@ -1225,6 +1563,7 @@ void VisualServerCanvas::canvas_occluder_polygon_set_shape_as_lines(RID p_occlud
 	VSG::storage->canvas_light_occluder_set_polylines(occluder_poly->occluder, p_shape);
 	for (Set<RasterizerCanvas::LightOccluderInstance *>::Element *E = occluder_poly->owners.front(); E; E = E->next()) {
 		E->get()->aabb_cache = occluder_poly->aabb;
+		E->get()->version++;
 	}
 }
 
@@ -1291,9 +1630,16 @@ bool VisualServerCanvas::free(RID p_rid) {
 
 				Item *item_owner = canvas_item_owner.get(canvas_item->parent);
 				item_owner->child_items.erase(canvas_item);
+				item_owner->ysort_children_dirty = true;
+				_item_bounds_changed(item_owner);
 			}
 		}
 
+		if (canvas_item->damage_item.in_list()) {
+			_damage_add(canvas_item->damage_rect);
+			damage_items.remove(&canvas_item->damage_item);
+		}
+
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 
 			canvas_item->child_items[i]->parent = RID();
@@ -1372,4 +1718,9 @@ bool VisualServerCanvas::free(RID p_rid) {
 }
 
 VisualServerCanvas::VisualServerCanvas() {
+
+	damage_pass = 0;
+	damage_has_rect = false;
+	damage_full = false;
+	damage_clip_active = false;
 }
@@ -51,8 +51,43 @@ public:
 
 		Vector<Item *> child_items;
 
-		Item() {
+		// children in y order from the last frame, when sorting by y, so only the ones that moved need reordering
+		Vector<Item *> ysort_children;
+		bool ysort_children_dirty;
+
+		// bounds of this item and all its visible children, in local space, used to skip whole subtrees when culling
+		Rect2 subtree_rect;
+		bool subtree_has_rect;
+		bool subtree_always_visible;
+		bool subtree_dirty;
+
+		// physics interpolation, the drawn transform is blended between the ones set in the last two physics ticks
+		bool interpolated;
+		Transform2D xform_prev;
+		Transform2D xform_curr;
+		SelfList<Item> interpolation_item;
+
+		// partial redraws, where and how the item was drawn in the last tracked frame
+		Rect2 damage_rect;
+		uint32_t damage_hash;
+		uint32_t damage_version;
+		uint64_t damage_pass;
+		bool damage_always; // content can change without the item knowing (meshes, particles)
+		SelfList<Item> damage_item;
+
+		Item() :
+				interpolation_item(this),
+				damage_item(this) {
+			damage_hash = 0;
+			damage_version = 0;
+			damage_pass = 0;
+			damage_always = false;
+			interpolated = false;
 			children_order_dirty = true;
+			ysort_children_dirty = true;
+			subtree_has_rect = false;
+			subtree_always_visible = false;
+			subtree_dirty = true;
 			E = NULL;
 			z_index = 0;
 			modulate = Color(1, 1, 1, 1);
@@ -144,14 +179,43 @@ public:
 	RID_Owner<Item> canvas_item_owner;
 	RID_Owner<RasterizerCanvas::Light> canvas_light_owner;
 
+	SelfList<Item>::List item_interpolation_list;
+
 private:
+	// items drawn in the last frame of the viewport using partial redraws
+	SelfList<Item>::List damage_items;
+	uint64_t damage_pass;
+	Rect2 damage_rect;
+	bool damage_has_rect;
+	bool damage_full;
+
+	Item damage_clip;
+	bool damage_clip_active;
+
+	_FORCE_INLINE_ void _damage_add(const Rect2 &p_rect) {
+
+		damage_rect = damage_has_rect ? damage_rect.merge(p_rect) : p_rect;
+		damage_has_rect = true;
+	}
+	void _damage_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Color &p_modulate, int p_z, Item *p_material_owner);
+
 	void _render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
+	void _update_ysort_children(Item *p_canvas_item);
 	void _render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
 
+	void _item_bounds_changed(Item *p_canvas_item);
+	void _update_item_bounds(Item *p_canvas_item);
+
 public:
 	void render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect);
 
+	void damage_begin();
+	void damage_canvas(Canvas *p_canvas, const Transform2D &p_transform);
+	VisualServerViewport::Damage damage_end(Rect2 &r_rect);
+	void damage_clip_begin(const Rect2 &p_rect);
+	void damage_clip_end();
+
 	RID canvas_create();
 	void canvas_set_item_mirroring(RID p_canvas, RID p_item, const Point2 &p_mirroring);
 	void canvas_set_modulate(RID p_canvas, const Color &p_color);
@@ -163,6 +227,11 @@ public:
 	void canvas_item_set_light_mask(RID p_item, int p_mask);
 
 	void canvas_item_set_transform(RID p_item, const Transform2D &p_transform);
+	void canvas_item_set_interpolated(RID p_item, bool p_interpolated);
+	void canvas_item_reset_physics_interpolation(RID p_item);
+
+	void tick();
+	void update_interpolation_frame(float p_fraction);
 	void canvas_item_set_clip(RID p_item, bool p_clip);
 	void canvas_item_set_distance_field_mode(RID p_item, bool p_enable);
 	void canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect = Rect2());
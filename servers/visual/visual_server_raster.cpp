@@ -33,6 +33,7 @@
 #include "default_mouse_cursor.xpm"
 #include "io/marshalls.h"
 #include "os/os.h"
+#include "os/trace.h"
 #include "project_settings.h"
 #include "sort.h"
 #include "visual_server_canvas.h"
@@ -93,8 +94,21 @@ void VisualServerRaster::request_frame_drawn_callback(Object *p_where, const Str
 	frame_drawn_callbacks.push_back(fdc);
 }
 
+void VisualServerRaster::tick() {
+
+	VSG::canvas->tick();
+	VSG::scene->tick();
+}
+
+void VisualServerRaster::set_physics_interpolation_fraction(float p_fraction) {
+
+	physics_interpolation_fraction = p_fraction;
+}
+
 void VisualServerRaster::draw(bool p_swap_buffers, double frame_step) {
 
+	TRACE_SCOPE("VisualServerRaster::draw");
+
 	//needs to be done before changes is reset to 0, to not force the editor to redraw
 	VS::get_singleton()->emit_signal("frame_pre_draw");
 
@@ -102,6 +116,8 @@ void VisualServerRaster::draw(bool p_swap_buffers, double frame_step) {
 
 	VSG::rasterizer->begin_frame(frame_step);
 
+	VSG::canvas->update_interpolation_frame(physics_interpolation_fraction);
+	VSG::scene->update_interpolation_frame(physics_interpolation_fraction);
 	VSG::scene->update_dirty_instances(); //update scene stuff
 
 	VSG::viewport->draw_viewports();
@@ -186,6 +202,38 @@ void VisualServerRaster::set_debug_generate_wireframes(bool p_generate) {
 	VSG::storage->set_debug_generate_wireframes(p_generate);
 }
 
+void VisualServerRaster::shader_variants_set_recording(bool p_enable) {
+
+	VSG::storage->shader_variants_set_recording(p_enable);
+}
+
+PoolVector<String> VisualServerRaster::shader_variants_get_recorded() {
+
+	Vector<String> variants = VSG::storage->shader_variants_get_recorded();
+	PoolVector<String> ret;
+	ret.resize(variants.size());
+	{
+		PoolVector<String>::Write w = ret.write();
+		for (int i = 0; i < variants.size(); i++) {
+			w[i] = variants[i];
+		}
+	}
+	return ret;
+}
+
+void VisualServerRaster::shader_variants_precompile(const PoolVector<String> &p_variants) {
+
+	Vector<String> variants;
+	variants.resize(p_variants.size());
+	{
+		PoolVector<String>::Read r = p_variants.read();
+		for (int i = 0; i < p_variants.size(); i++) {
+			variants.write[i] = r[i];
+		}
+	}
+	VSG::storage->shader_variants_precompile(variants);
+}
+
 void VisualServerRaster::call_set_use_vsync(bool p_enable) {
 	OS::get_singleton()->_set_use_vsync(p_enable);
 }
@@ -202,6 +250,8 @@ VisualServerRaster::VisualServerRaster() {
 
 	for (int i = 0; i < 4; i++)
 		black_margin[i] = 0;
+
+	physics_interpolation_fraction = 0;
 }
 
 VisualServerRaster::~VisualServerRaster() {
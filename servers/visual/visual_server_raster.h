@@ -65,6 +65,8 @@ class VisualServerRaster : public VisualServer {
 	int black_margin[4];
 	RID black_image[4];
 
+	float physics_interpolation_fraction;
+
 	struct FrameDrawnCallbacks {
 
 		ObjectID object;
@@ -165,6 +167,7 @@ public:
 	BIND3(texture_set_detect_3d_callback, RID, TextureDetectCallback, void *)
 	BIND3(texture_set_detect_srgb_callback, RID, TextureDetectCallback, void *)
 	BIND3(texture_set_detect_normal_callback, RID, TextureDetectCallback, void *)
+	BIND3(texture_set_stream_request_callback, RID, TextureStreamRequestCallback, void *)
 
 	BIND2(texture_set_path, RID, const String &)
 	BIND1RC(String, texture_get_path, RID)
@@ -293,6 +296,7 @@ public:
 	BIND3(skeleton_allocate, RID, int, bool)
 	BIND1RC(int, skeleton_get_bone_count, RID)
 	BIND3(skeleton_bone_set_transform, RID, int, const Transform &)
+	BIND2(skeleton_set_bone_transforms, RID, const PoolVector<float> &)
 	BIND2RC(Transform, skeleton_bone_get_transform, RID, int)
 	BIND3(skeleton_bone_set_transform_2d, RID, int, const Transform2D &)
 	BIND2RC(Transform2D, skeleton_bone_get_transform_2d, RID, int)
@@ -500,6 +504,7 @@ public:
 	BIND4(environment_set_ambient_light, RID, const Color &, float, float)
 	BIND7(environment_set_ssr, RID, bool, int, float, float, float, bool)
 	BIND13(environment_set_ssao, RID, bool, float, float, float, float, float, float, float, const Color &, EnvironmentSSAOQuality, EnvironmentSSAOBlur, float)
+	BIND2(environment_set_ssao_resolution, RID, EnvironmentSSAOResolution)
 
 	BIND6(environment_set_dof_blur_near, RID, bool, float, float, float, EnvironmentDOFBlurQuality)
 	BIND6(environment_set_dof_blur_far, RID, bool, float, float, float, EnvironmentDOFBlurQuality)
@@ -533,6 +538,9 @@ public:
 	BIND2(instance_set_scenario, RID, RID) // from can be mesh, light, poly, area and portal so far.
 	BIND2(instance_set_layer_mask, RID, uint32_t)
 	BIND2(instance_set_transform, RID, const Transform &)
+	BIND2(instances_set_transforms, const Vector<RID> &, const Vector<Transform> &)
+	BIND2(instance_set_interpolated, RID, bool)
+	BIND1(instance_reset_physics_interpolation, RID)
 	BIND2(instance_attach_object_instance_id, RID, ObjectID)
 	BIND3(instance_set_blend_shape_weight, RID, int, float)
 	BIND3(instance_set_surface_material, RID, int, RID)
@@ -557,6 +565,7 @@ public:
 
 	BIND5(instance_geometry_set_draw_range, RID, float, float, float, float)
 	BIND2(instance_geometry_set_as_instance_lod, RID, RID)
+	BIND2(instance_geometry_set_occluder_faces, RID, const PoolVector<Vector3> &)
 
 #undef BINDBASE
 //from now on, calls forwarded to this singleton
@@ -575,6 +584,8 @@ public:
 	BIND2(canvas_item_set_light_mask, RID, int)
 
 	BIND2(canvas_item_set_transform, RID, const Transform2D &)
+	BIND2(canvas_item_set_interpolated, RID, bool)
+	BIND1(canvas_item_reset_physics_interpolation, RID)
 	BIND2(canvas_item_set_clip, RID, bool)
 	BIND2(canvas_item_set_distance_field_mode, RID, bool)
 	BIND3(canvas_item_set_custom_rect, RID, bool, const Rect2 &)
@@ -664,6 +675,8 @@ public:
 
 	virtual void draw(bool p_swap_buffers, double frame_step);
 	virtual void sync();
+	virtual void tick();
+	virtual void set_physics_interpolation_fraction(float p_fraction);
 	virtual bool has_changed() const;
 	virtual void init();
 	virtual void finish();
@@ -684,6 +697,10 @@ public:
 	virtual bool has_os_feature(const String &p_feature) const;
 	virtual void set_debug_generate_wireframes(bool p_generate);
 
+	virtual void shader_variants_set_recording(bool p_enable);
+	virtual PoolVector<String> shader_variants_get_recorded();
+	virtual void shader_variants_precompile(const PoolVector<String> &p_variants);
+
 	virtual void call_set_use_vsync(bool p_enable);
 
 	VisualServerRaster();
@@ -29,7 +29,10 @@
 /*************************************************************************/
 
 #include "visual_server_scene.h"
+#include "engine.h"
 #include "os/os.h"
+#include "os/worker_thread_pool.h"
+#include "project_settings.h"
 #include "visual_server_global.h"
 #include "visual_server_raster.h"
 /* CAMERA API */
@@ -91,7 +94,7 @@ void VisualServerScene::camera_set_use_vertical_aspect(RID p_camera, bool p_enab
 
 /* SCENARIO API */
 
-void *VisualServerScene::_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int) {
+void *VisualServerScene::_instance_pair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int) {
 
 	//VisualServerScene *self = (VisualServerScene*)p_self;
 	Instance *A = p_A;
@@ -170,7 +173,7 @@ void *VisualServerScene::_instance_pair(void *p_self, OctreeElementID, Instance
 
 	return NULL;
 }
-void VisualServerScene::_instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *udata) {
+void VisualServerScene::_instance_unpair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int, void *udata) {
 
 	//VisualServerScene *self = (VisualServerScene*)p_self;
 	Instance *A = p_A;
@@ -246,8 +249,8 @@ RID VisualServerScene::scenario_create() {
 	RID scenario_rid = scenario_owner.make_rid(scenario);
 	scenario->self = scenario_rid;
 
-	scenario->octree.set_pair_callback(_instance_pair, this);
-	scenario->octree.set_unpair_callback(_instance_unpair, this);
+	scenario->bvh.set_pair_callback(_instance_pair, this);
+	scenario->bvh.set_unpair_callback(_instance_unpair, this);
 	scenario->reflection_probe_shadow_atlas = VSG::scene_render->shadow_atlas_create();
 	VSG::scene_render->shadow_atlas_set_size(scenario->reflection_probe_shadow_atlas, 1024); //make enough shadows for close distance, don't bother with rest
 	VSG::scene_render->shadow_atlas_set_quadrant_subdivision(scenario->reflection_probe_shadow_atlas, 0, 4);
@@ -306,10 +309,8 @@ void VisualServerScene::_instance_queue_update(Instance *p_instance, bool p_upda
 // from can be mesh, light,  area and portal so far.
 RID VisualServerScene::instance_create() {
 
-	Instance *instance = memnew(Instance);
-	ERR_FAIL_COND_V(!instance, RID());
-
-	RID instance_rid = instance_owner.make_rid(instance);
+	RID instance_rid = instance_owner.make_rid();
+	Instance *instance = instance_owner.getptr(instance_rid);
 	instance->self = instance_rid;
 
 	return instance_rid;
@@ -329,7 +330,7 @@ void VisualServerScene::instance_set_base(RID p_instance, RID p_base) {
 
 		if (instance->base_type == VS::INSTANCE_GI_PROBE) {
 			//if gi probe is baking, wait until done baking, else race condition may happen when removing it
-			//from octree
+			//from bvh
 			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(instance->base_data);
 
 			//make sure probes are done baking
@@ -344,9 +345,9 @@ void VisualServerScene::instance_set_base(RID p_instance, RID p_base) {
 			}
 		}
 
-		if (scenario && instance->octree_id) {
-			scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (scenario && instance->bvh_id) {
+			scenario->bvh.erase(instance->bvh_id); //make dependencies generated by the bvh go away
+			instance->bvh_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -490,9 +491,9 @@ void VisualServerScene::instance_set_scenario(RID p_instance, RID p_scenario) {
 
 		instance->scenario->instances.remove(&instance->scenario_item);
 
-		if (instance->octree_id) {
-			instance->scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (instance->bvh_id) {
+			instance->scenario->bvh.erase(instance->bvh_id); //make dependencies generated by the bvh go away
+			instance->bvh_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -561,17 +562,89 @@ void VisualServerScene::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 
 	instance->layer_mask = p_mask;
 }
+void VisualServerScene::_instance_set_transform(Instance *p_instance, const Transform &p_transform) {
+
+	if (p_instance->interpolated) {
+		//will be blended towards this one as the frames of the current physics tick are drawn
+		p_instance->transform_curr = p_transform;
+		if (!p_instance->interpolation_item.in_list()) {
+			_instance_interpolation_list.add(&p_instance->interpolation_item);
+		}
+		return;
+	}
+
+	if (p_instance->transform == p_transform)
+		return; //must be checked to avoid worst evil
+
+	p_instance->transform = p_transform;
+	_instance_queue_update(p_instance, true);
+}
+
 void VisualServerScene::instance_set_transform(RID p_instance, const Transform &p_transform) {
 
 	Instance *instance = instance_owner.get(p_instance);
 	ERR_FAIL_COND(!instance);
 
-	if (instance->transform == p_transform)
-		return; //must be checked to avoid worst evil
+	_instance_set_transform(instance, p_transform);
+}
 
-	instance->transform = p_transform;
-	_instance_queue_update(instance, true);
+void VisualServerScene::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) {
+
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	int count = p_instances.size();
+	const RID *instances = p_instances.ptr();
+	const Transform *transforms = p_transforms.ptr();
+
+	for (int i = 0; i < count; i++) {
+
+		// batches are built over a frame, an instance may have been freed meanwhile
+		Instance *instance = instance_owner.getornull(instances[i]);
+		if (!instance)
+			continue;
+
+		_instance_set_transform(instance, transforms[i]);
+	}
+}
+
+void VisualServerScene::instance_set_interpolated(RID p_instance, bool p_interpolated) {
+
+	Instance *instance = instance_owner.get(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	if (instance->interpolated == p_interpolated)
+		return;
+
+	if (p_interpolated) {
+		instance->transform_prev = instance->transform;
+		instance->transform_curr = instance->transform;
+		instance->interpolated = true;
+	} else {
+		//jump to the latest transform
+		instance->interpolated = false;
+		if (instance->interpolation_item.in_list()) {
+			_instance_interpolation_list.remove(&instance->interpolation_item);
+		}
+		_instance_set_transform(instance, instance->transform_curr);
+	}
 }
+
+void VisualServerScene::instance_reset_physics_interpolation(RID p_instance) {
+
+	Instance *instance = instance_owner.get(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	if (!instance->interpolated)
+		return;
+
+	//teleport, don't blend from where it was
+	instance->transform_prev = instance->transform_curr;
+	if (instance->transform != instance->transform_curr) {
+		instance->transform = instance->transform_curr;
+		_instance_queue_update(instance, true);
+	}
+}
+
 void VisualServerScene::instance_attach_object_instance_id(RID p_instance, ObjectID p_ID) {
 
 	Instance *instance = instance_owner.get(p_instance);
@@ -589,7 +662,25 @@ void VisualServerScene::instance_set_blend_shape_weight(RID p_instance, int p_sh
 	}
 
 	ERR_FAIL_INDEX(p_shape, instance->blend_values.size());
+
+	if (instance->blend_values[p_shape] == p_weight) {
+		return;
+	}
+
 	instance->blend_values.write[p_shape] = p_weight;
+
+	if ((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) {
+
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+		//the shape changed without a transform change, cached shadows must be redrawn
+
+		if (geom->can_cast_shadows) {
+			for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+				light->shadow_dirty = true;
+			}
+		}
+	}
 }
 
 void VisualServerScene::instance_set_surface_material(RID p_instance, int p_surface, RID p_material) {
@@ -626,26 +717,26 @@ void VisualServerScene::instance_set_visible(RID p_instance, bool p_visible) {
 
 	switch (instance->base_type) {
 		case VS::INSTANCE_LIGHT: {
-			if (VSG::storage->light_get_type(instance->base) != VS::LIGHT_DIRECTIONAL && instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHT, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+			if (VSG::storage->light_get_type(instance->base) != VS::LIGHT_DIRECTIONAL && instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << VS::INSTANCE_LIGHT, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case VS::INSTANCE_REFLECTION_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_REFLECTION_PROBE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << VS::INSTANCE_REFLECTION_PROBE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case VS::INSTANCE_LIGHTMAP_CAPTURE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHTMAP_CAPTURE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << VS::INSTANCE_LIGHTMAP_CAPTURE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case VS::INSTANCE_GI_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_GI_PROBE, p_visible ? (VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT)) : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << VS::INSTANCE_GI_PROBE, p_visible ? (VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT)) : 0);
 			}
 
 		} break;
@@ -747,7 +838,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_aabb(const AABB &p_aabb, RID
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_aabb(p_aabb, cull, 1024);
+	culled = scenario->bvh.cull_aabb(p_aabb, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 
@@ -770,7 +861,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_ray(const Vector3 &p_from, co
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
+	culled = scenario->bvh.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -793,7 +884,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_convex(const Vector<Plane> &p
 	int culled = 0;
 	Instance *cull[1024];
 
-	culled = scenario->octree.cull_convex(p_convex, cull, 1024);
+	culled = scenario->bvh.cull_convex(p_convex, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 
@@ -852,8 +943,36 @@ void VisualServerScene::instance_geometry_set_material_override(RID p_instance,
 }
 
 void VisualServerScene::instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin) {
+
+	Instance *instance = instance_owner.get(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	instance->lod_begin = p_min;
+	instance->lod_end = p_max;
+	instance->lod_begin_hysteresis = p_min_margin;
+	instance->lod_end_hysteresis = p_max_margin;
+	instance->lod_visible = true;
 }
 void VisualServerScene::instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance) {
+
+	Instance *instance = instance_owner.get(p_instance);
+	ERR_FAIL_COND(!instance);
+	ERR_FAIL_COND(p_as_lod_of_instance.is_valid() && !instance_owner.owns(p_as_lod_of_instance));
+
+	instance->lod_instance = p_as_lod_of_instance;
+}
+void VisualServerScene::instance_geometry_set_occluder_faces(RID p_instance, const PoolVector<Vector3> &p_faces) {
+
+	Instance *instance = instance_owner.get(p_instance);
+	ERR_FAIL_COND(!instance);
+	ERR_FAIL_COND(p_faces.size() % 3);
+
+	instance->occluder_faces.resize(p_faces.size());
+
+	PoolVector<Vector3>::Read r = p_faces.read();
+	for (int i = 0; i < p_faces.size(); i++) {
+		instance->occluder_faces.write[i] = r[i];
+	}
 }
 
 void VisualServerScene::_update_instance(Instance *p_instance) {
@@ -920,7 +1039,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	if (p_instance->octree_id == 0) {
+	if (p_instance->bvh_id == 0) {
 
 		uint32_t base_type = 1 << p_instance->base_type;
 		uint32_t pairable_mask = 0;
@@ -938,8 +1057,8 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 			pairable = true;
 		}
 
-		// not inside octree
-		p_instance->octree_id = p_instance->scenario->octree.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		// not inside bvh
+		p_instance->bvh_id = p_instance->scenario->bvh.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
 
 	} else {
 
@@ -948,7 +1067,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 			return;
 		*/
 
-		p_instance->scenario->octree.move(p_instance->octree_id, new_aabb);
+		p_instance->scenario->bvh.move(p_instance->bvh_id, new_aabb);
 	}
 }
 
@@ -1258,7 +1377,7 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	}
 }
 
-void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+void VisualServerScene::_light_instance_setup_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
 
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
@@ -1282,7 +1401,7 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			if (depth_range_mode == VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
 				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = p_scenario->bvh.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1473,46 +1592,24 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
-				// a pre pass will need to be needed to determine the actual z-near to be used
-
-				Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
-
-				for (int j = 0; j < cull_count; j++) {
-
-					float min, max;
-					Instance *instance = instance_shadow_cull_result[j];
-					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-						cull_count--;
-						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-						j--;
-						continue;
-					}
-
-					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-					if (max > z_max)
-						z_max = max;
-				}
-
-				{
-
-					CameraMatrix ortho_camera;
-					real_t half_x = (x_max_cam - x_min_cam) * 0.5;
-					real_t half_y = (y_max_cam - y_min_cam) * 0.5;
-
-					ortho_camera.set_orthogonal(-half_x, half_x, -half_y, half_y, 0, (z_max - z_min_cam));
-
-					Transform ortho_transform;
-					ortho_transform.basis = transform.basis;
-					ortho_transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
-
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
-				}
-
-				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+				// the depth range is fit to the casters found once culled, in _render_shadows()
+
+				ShadowCullJob job;
+				job.light = p_instance;
+				job.pass = i;
+				job.planes = light_frustum_planes;
+				job.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
+				job.fit_depth = true;
+				job.depth_axis = z_vec;
+				job.z_min = z_min_cam;
+				job.z_max = z_max;
+				job.half_x = (x_max_cam - x_min_cam) * 0.5;
+				job.half_y = (y_max_cam - y_min_cam) * 0.5;
+				job.transform.basis = transform.basis;
+				job.transform.origin = x_vec * (x_min_cam + job.half_x) + y_vec * (y_min_cam + job.half_y);
+				job.split = distances[i + 1];
+				job.bias_scale = bias_scale;
+				shadow_cull_jobs.push_back(job);
 			}
 
 		} break;
@@ -1538,24 +1635,15 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 						planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
 						planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-						Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
-
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
-
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						ShadowCullJob job;
+						job.light = p_instance;
+						job.pass = i;
+						job.planes = planes;
+						job.near_plane = Plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
+						job.transform = light_transform;
+						job.far = radius;
+						job.camera_independent = true;
+						shadow_cull_jobs.push_back(job);
 					}
 				} break;
 				case VS::LIGHT_OMNI_SHADOW_CUBE: {
@@ -1589,29 +1677,19 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 						Vector<Plane> planes = cm.get_projection_planes(xform);
 
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
-						Plane near_plane(xform.origin, -xform.basis.get_axis(2));
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
-
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						ShadowCullJob job;
+						job.light = p_instance;
+						job.pass = i;
+						job.planes = planes;
+						job.near_plane = Plane(xform.origin, -xform.basis.get_axis(2));
+						job.projection = cm;
+						job.transform = xform;
+						job.far = radius;
+						job.restore_paraboloid = i == 5; //restore the regular DP matrix once all faces are drawn
+						job.camera_independent = true;
+						shadow_cull_jobs.push_back(job);
 					}
 
-					//restore the regular DP matrix
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0);
-
 				} break;
 			}
 
@@ -1624,28 +1702,136 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			CameraMatrix cm;
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
-			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+			ShadowCullJob job;
+			job.light = p_instance;
+			job.pass = 0;
+			job.planes = cm.get_projection_planes(light_transform);
+			job.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
+			job.projection = cm;
+			job.transform = light_transform;
+			job.far = radius;
+			job.camera_independent = true;
+			shadow_cull_jobs.push_back(job);
 
-			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
-			for (int j = 0; j < cull_count; j++) {
+		} break;
+	}
+}
 
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
+void VisualServerScene::_cull_shadow_job(void *p_userdata, uint32_t p_index) {
+
+	VisualServerScene *vss = (VisualServerScene *)p_userdata;
+	ShadowCullJob &job = vss->shadow_cull_jobs.write[p_index];
+	Vector<Instance *> &result = vss->shadow_cull_results.write[p_index];
+
+	if (result.size() == 0) {
+		result.resize(MIN(1024, MAX_INSTANCE_CULL));
+	}
+
+	InstanceLightData *light = static_cast<InstanceLightData *>(job.light->base_data);
+	bool use_cache = job.camera_independent && job.pass < 6;
+
+	int cull_count;
+	if (use_cache && light->shadow_cull_cache_version[job.pass] == vss->scene_version) {
+		//another viewport already culled this pass, with the scene unchanged since
+		const Vector<Instance *> &cache = light->shadow_cull_cache[job.pass];
+		cull_count = cache.size();
+		if (result.size() < cull_count) {
+			result.resize(cull_count);
+		}
+		copymem(result.ptrw(), cache.ptr(), cull_count * sizeof(Instance *));
+	} else {
+		while (true) {
+			bool truncated;
+			cull_count = vss->shadow_cull_scenario->bvh.cull_convex_shared(job.planes, result.ptrw(), result.size(), VS::INSTANCE_GEOMETRY_MASK, &truncated);
+			if (!truncated || result.size() >= MAX_INSTANCE_CULL)
+				break;
+			result.resize(MIN(result.size() * 2, MAX_INSTANCE_CULL));
+		}
+
+		if (use_cache) {
+			//keep the unfiltered result, the filter below depends on the camera
+			Vector<Instance *> &cache = light->shadow_cull_cache[job.pass];
+			cache.resize(cull_count);
+			copymem(cache.ptrw(), result.ptr(), cull_count * sizeof(Instance *));
+			light->shadow_cull_cache_version[job.pass] = vss->scene_version;
+		}
+	}
+
+	Instance **cull_result = result.ptrw();
+	for (int j = 0; j < cull_count; j++) {
+
+		Instance *instance = cull_result[j];
+		if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !_instance_in_lod_range(instance, vss->shadow_cull_camera_origin)) {
+			cull_count--;
+			SWAP(cull_result[j], cull_result[cull_count]);
+			j--;
+		}
+	}
+
+	job.cull_count = cull_count;
+}
+
+void VisualServerScene::_render_shadows(const Transform &p_cam_transform, RID p_shadow_atlas, Scenario *p_scenario) {
+
+	int job_count = shadow_cull_jobs.size();
+	if (job_count == 0)
+		return;
+
+	if (shadow_cull_results.size() < job_count) {
+		shadow_cull_results.resize(job_count);
+	}
+
+	// Every split and cubemap face has its own result buffer, so all of them can be
+	// culled at once. Rendering needs the instances' depth, so it stays serial.
+	shadow_cull_scenario = p_scenario;
+	shadow_cull_camera_origin = p_cam_transform.origin;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0 && job_count > 1) {
+		WorkerThreadPool::GroupID group = pool->add_group_task(_cull_shadow_job, this, job_count, WorkerThreadPool::PRIORITY_HIGH);
+		pool->wait_for_group_task_completion(group);
+	} else {
+		for (int i = 0; i < job_count; i++) {
+			_cull_shadow_job(this, i);
+		}
+	}
+	shadow_cull_scenario = NULL;
+
+	for (int i = 0; i < job_count; i++) {
+
+		ShadowCullJob &job = shadow_cull_jobs.write[i];
+		InstanceLightData *light = static_cast<InstanceLightData *>(job.light->base_data);
+		Instance **cull_result = shadow_cull_results.write[i].ptrw();
+
+		for (int j = 0; j < job.cull_count; j++) {
+
+			Instance *instance = cull_result[j];
+			instance->depth = job.near_plane.distance_to(instance->transform.origin);
+			instance->depth_layer = 0;
+
+			if (job.fit_depth) {
+				float min, max;
+				instance->transformed_aabb.project_range_in_plane(Plane(job.depth_axis, 0), min, max);
+				if (max > job.z_max)
+					job.z_max = max;
 			}
+		}
+
+		if (job.fit_depth) {
+			job.projection.set_orthogonal(-job.half_x, job.half_x, -job.half_y, job.half_y, 0, (job.z_max - job.z_min));
+			job.transform.origin += job.depth_axis * job.z_max;
+		}
 
-			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0);
-			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, job.projection, job.transform, job.far, job.split, job.pass, job.bias_scale);
+		VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, job.pass, (RasterizerScene::InstanceBase **)cull_result, job.cull_count);
 
-		} break;
+		if (job.restore_paraboloid) {
+			Transform light_transform = job.light->transform;
+			light_transform.orthonormalize(); //scale does not count on lights
+			VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, job.far, 0, 0);
+		}
 	}
+
+	shadow_cull_jobs.clear();
 }
 
 void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
@@ -1684,6 +1870,9 @@ void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_view
 	}
 
 	_prepare_scene(camera->transform, camera_matrix, ortho, camera->env, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+	if (texture_streaming) {
+		_request_texture_streaming(camera->transform, camera_matrix, ortho, p_viewport_size);
+	}
 	_render_scene(camera->transform, camera_matrix, ortho, camera->env, p_scenario, p_shadow_atlas, RID(), -1);
 #endif
 }
@@ -1769,7 +1958,20 @@ void VisualServerScene::render_camera(Ref<ARVRInterface> &p_interface, ARVRInter
 	}
 
 	// And render our scene...
+	if (texture_streaming) {
+		_request_texture_streaming(cam_transform, camera_matrix, false, p_viewport_size);
+	}
+
+	// the right eye renders what was culled for the left one, let the rasterizer reuse its render lists
+	if (p_eye == ARVRInterface::EYE_LEFT) {
+		VSG::scene_render->set_stereo_pass(RasterizerScene::STEREO_PASS_FIRST_EYE);
+	} else if (p_eye == ARVRInterface::EYE_RIGHT) {
+		VSG::scene_render->set_stereo_pass(RasterizerScene::STEREO_PASS_SECOND_EYE);
+	}
+
 	_render_scene(cam_transform, camera_matrix, false, camera->env, p_scenario, p_shadow_atlas, RID(), -1);
+
+	VSG::scene_render->set_stereo_pass(RasterizerScene::STEREO_PASS_NONE);
 };
 
 void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe) {
@@ -1792,7 +1994,7 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	float z_far = p_cam_projection.get_z_far();
 
 	/* STEP 2 - CULL */
-	instance_cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
+	instance_cull_count = scenario->bvh.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
 	light_cull_count = 0;
 
 	reflection_probe_cull_count = 0;
@@ -1800,9 +2002,9 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	//light_samplers_culled=0;
 
 	/*	print_line("OT: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
-	print_line("OTO: "+itos(p_scenario->octree.get_octant_count()));
-	//print_line("OTE: "+itos(p_scenario->octree.get_elem_count()));
-	print_line("OTP: "+itos(p_scenario->octree.get_pair_count()));
+	print_line("OTO: "+itos(p_scenario->bvh.get_octant_count()));
+	//print_line("OTE: "+itos(p_scenario->bvh.get_elem_count()));
+	print_line("OTP: "+itos(p_scenario->bvh.get_pair_count()));
 */
 
 	/* STEP 3 - PROCESS PORTALS, VALIDATE ROOMS */
@@ -1848,6 +2050,10 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 					if (!reflection_probe->geometries.empty()) {
 						//do not add this light if no geometry is affected by it..
 
+						if (!p_reflection_probe.is_valid()) {
+							reflection_probe->camera_distance = (ins->transformed_aabb.position + ins->transformed_aabb.size * 0.5).distance_to(p_cam_transform.origin);
+						}
+
 						if (reflection_probe->reflection_dirty || VSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
 							if (!reflection_probe->update_list.in_list()) {
 								reflection_probe->render_step = 0;
@@ -1874,68 +2080,77 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 		} else if (((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
 
-			keep = true;
+			bool in_lod_range = _instance_in_lod_range(ins, p_cam_transform.origin);
+			if (!p_reflection_probe.is_valid()) {
+				//probes see the scene from elsewhere, only the cameras drive the hysteresis
+				ins->lod_visible = in_lod_range;
+			}
+
+			if (in_lod_range) {
 
-			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
+				keep = true;
 
-			if (ins->redraw_if_visible) {
-				VisualServerRaster::redraw_request();
-			}
+				InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
 
-			if (ins->base_type == VS::INSTANCE_PARTICLES) {
-				//particles visible? process them
-				VSG::storage->particles_request_process(ins->base);
-				//particles visible? request redraw
-				VisualServerRaster::redraw_request();
-			}
+				if (ins->redraw_if_visible) {
+					VisualServerRaster::redraw_request();
+				}
 
-			if (geom->lighting_dirty) {
-				int l = 0;
-				//only called when lights AABB enter/exit this geometry
-				ins->light_instances.resize(geom->lighting.size());
+				if (ins->base_type == VS::INSTANCE_PARTICLES) {
+					//particles visible? process them
+					VSG::storage->particles_request_process(ins->base);
+					//particles visible? request redraw
+					VisualServerRaster::redraw_request();
+				}
 
-				for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+				if (geom->lighting_dirty) {
+					int l = 0;
+					//only called when lights AABB enter/exit this geometry
+					ins->light_instances.resize(geom->lighting.size());
 
-					InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+					for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+
+						InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 
-					ins->light_instances.write[l++] = light->instance;
+						ins->light_instances.write[l++] = light->instance;
+					}
+
+					geom->lighting_dirty = false;
 				}
 
-				geom->lighting_dirty = false;
-			}
+				if (geom->reflection_dirty) {
+					int l = 0;
+					//only called when reflection probe AABB enter/exit this geometry
+					ins->reflection_probe_instances.resize(geom->reflection_probes.size());
 
-			if (geom->reflection_dirty) {
-				int l = 0;
-				//only called when reflection probe AABB enter/exit this geometry
-				ins->reflection_probe_instances.resize(geom->reflection_probes.size());
+					for (List<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
 
-				for (List<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
+						InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
 
-					InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
+						ins->reflection_probe_instances.write[l++] = reflection_probe->instance;
+					}
 
-					ins->reflection_probe_instances.write[l++] = reflection_probe->instance;
+					geom->reflection_dirty = false;
 				}
 
-				geom->reflection_dirty = false;
-			}
+				if (geom->gi_probes_dirty) {
+					int l = 0;
+					//only called when reflection probe AABB enter/exit this geometry
+					ins->gi_probe_instances.resize(geom->gi_probes.size());
 
-			if (geom->gi_probes_dirty) {
-				int l = 0;
-				//only called when reflection probe AABB enter/exit this geometry
-				ins->gi_probe_instances.resize(geom->gi_probes.size());
+					for (List<Instance *>::Element *E = geom->gi_probes.front(); E; E = E->next()) {
 
-				for (List<Instance *>::Element *E = geom->gi_probes.front(); E; E = E->next()) {
+						InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(E->get()->base_data);
 
-					InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(E->get()->base_data);
+						ins->gi_probe_instances.write[l++] = gi_probe->probe_instance;
+					}
 
-					ins->gi_probe_instances.write[l++] = gi_probe->probe_instance;
+					geom->gi_probes_dirty = false;
 				}
 
-				geom->gi_probes_dirty = false;
+				ins->depth = near_plane.distance_to(ins->transform.origin);
+				ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
 			}
-
-			ins->depth = near_plane.distance_to(ins->transform.origin);
-			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
 		}
 
 		if (!keep) {
@@ -1950,6 +2165,33 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 		}
 	}
 
+	/* STEP 4.5 - OCCLUSION CULLING */
+
+	occlusion_buffer.clear(p_cam_transform, p_cam_projection);
+
+	for (int i = 0; i < instance_cull_count; i++) {
+
+		Instance *ins = instance_cull_result[i];
+		if (ins->occluder_faces.size()) {
+			occlusion_buffer.add_occluder(ins->occluder_faces.ptr(), ins->occluder_faces.size(), ins->transform);
+		}
+	}
+
+	if (!occlusion_buffer.is_empty()) {
+
+		for (int i = 0; i < instance_cull_count; i++) {
+
+			Instance *ins = instance_cull_result[i];
+
+			if (ins->occluder_faces.empty() && occlusion_buffer.is_occluded(ins->transformed_aabb)) {
+				instance_cull_count--;
+				SWAP(instance_cull_result[i], instance_cull_result[instance_cull_count]);
+				i--;
+				ins->last_render_pass = 0; // make invalid
+			}
+		}
+	}
+
 	/* STEP 5 - PROCESS LIGHTS */
 
 	RID *directional_light_ptr = &light_instance_cull_result[light_cull_count];
@@ -1987,8 +2229,10 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 		for (int i = 0; i < directional_shadow_count; i++) {
 
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+			_light_instance_setup_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
 		}
+
+		_render_shadows(p_cam_transform, p_shadow_atlas, scenario);
 	}
 
 	{ //setup shadow maps
@@ -2078,15 +2322,83 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 			}
 
 			if (light->shadow_dirty) {
-				light->last_version++;
-				light->shadow_dirty = false;
+
+				uint64_t frame = Engine::get_singleton()->get_frames_drawn();
+
+				if (shadow_distant_light_update_interval > 1 && coverage < shadow_distant_light_coverage && frame - light->shadow_update_frame < (uint64_t)shadow_distant_light_update_interval) {
+					//distant light, keep showing the cached shadow and redraw it in a later frame
+					VisualServerRaster::redraw_request();
+				} else {
+					light->last_version++;
+					light->shadow_dirty = false;
+					light->shadow_update_frame = frame;
+				}
 			}
 
 			bool redraw = VSG::scene_render->shadow_atlas_update_light(p_shadow_atlas, light->instance, coverage, light->last_version);
 
 			if (redraw) {
 				//must redraw!
-				_light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				_light_instance_setup_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+			}
+		}
+
+		_render_shadows(p_cam_transform, p_shadow_atlas, scenario);
+	}
+}
+
+void VisualServerScene::_request_texture_streaming(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, const Size2 &p_viewport_size) {
+
+	// Estimate how many pixels each visible geometry covers on screen and let the
+	// streaming textures used by its materials know which mip they need at most.
+
+	Transform cam_inverse = p_cam_transform.affine_inverse();
+	float pixel_scale = p_cam_projection.matrix[1][1] * 0.5 * p_viewport_size.height;
+	float z_near = p_cam_projection.get_z_near();
+
+	for (int i = 0; i < instance_cull_count; i++) {
+
+		Instance *ins = instance_cull_result[i];
+
+		RID mesh;
+		AABB aabb;
+
+		if (ins->base_type == VS::INSTANCE_MESH) {
+			mesh = ins->base;
+			aabb = ins->transformed_aabb;
+		} else if (ins->base_type == VS::INSTANCE_MULTIMESH) {
+			mesh = VSG::storage->multimesh_get_mesh(ins->base);
+			if (!mesh.is_valid()) {
+				continue;
+			}
+			//the multimesh AABB covers all instances, only a single one is relevant here
+			aabb = ins->transform.xform(VSG::storage->mesh_get_aabb(mesh, RID()));
+		} else {
+			continue;
+		}
+
+		float size = aabb.get_longest_axis_size() * pixel_scale;
+		if (!p_cam_orthogonal) {
+			float depth = -cam_inverse.xform(aabb.position + aabb.size * 0.5).z - aabb.size.length() * 0.5;
+			size /= MAX(depth, z_near);
+		}
+
+		int pixels = CLAMP(Math::fast_ftoi(size), 1, 16384);
+
+		if (ins->material_override.is_valid()) {
+			VSG::storage->material_request_texture_size(ins->material_override, pixels);
+			continue;
+		}
+
+		int surface_count = VSG::storage->mesh_get_surface_count(mesh);
+		for (int j = 0; j < surface_count; j++) {
+
+			RID material = j < ins->materials.size() ? ins->materials[j] : RID();
+			if (!material.is_valid()) {
+				material = VSG::storage->mesh_surface_get_material(mesh, j);
+			}
+			if (material.is_valid()) {
+				VSG::storage->material_request_texture_size(material, pixels);
 			}
 		}
 	}
@@ -3082,11 +3394,57 @@ bool VisualServerScene::_check_gi_probe(Instance *p_gi_probe) {
 	return !all_equal || probe_data->dynamic.light_cache_changes.size() != probe_data->dynamic.light_cache.size();
 }
 
+VisualServerScene::InstanceReflectionProbeData *VisualServerScene::_get_next_reflection_probe_to_render() {
+
+	InstanceReflectionProbeData *best = NULL;
+
+	for (SelfList<InstanceReflectionProbeData> *E = reflection_probe_render_list.first(); E; E = E->next()) {
+
+		InstanceReflectionProbeData *probe = E->self();
+
+		if (probe->render_step > 0) {
+			//cubemap faces are shared between probes, so finish the one being rendered first
+			return probe;
+		}
+
+		if (!best || probe->camera_distance < best->camera_distance) {
+			best = probe;
+		}
+	}
+
+	return best;
+}
+
 void VisualServerScene::render_probes() {
 
 	/* REFLECTION PROBES */
 
-	SelfList<InstanceReflectionProbeData> *ref_probe = reflection_probe_render_list.first();
+	if (reflection_probe_update_steps_per_frame > 0) {
+
+		//time-sliced: a fixed amount of steps (cubemap faces or filtered mips) per frame, closest probes first.
+		//the previously filtered radiance stays in use until the new one replaces it.
+
+		int steps = reflection_probe_update_steps_per_frame;
+
+		while (steps > 0) {
+
+			InstanceReflectionProbeData *probe = _get_next_reflection_probe_to_render();
+			if (!probe)
+				break;
+
+			bool done = _render_reflection_probe_step(probe->owner, probe->render_step);
+			if (done) {
+				reflection_probe_render_list.remove(&probe->update_list);
+				probe->render_step = -1;
+			} else {
+				probe->render_step++;
+			}
+
+			steps--;
+		}
+	}
+
+	SelfList<InstanceReflectionProbeData> *ref_probe = reflection_probe_update_steps_per_frame > 0 ? NULL : reflection_probe_render_list.first();
 
 	bool busy = false;
 
@@ -3356,8 +3714,47 @@ void VisualServerScene::_update_dirty_instance(Instance *p_instance) {
 	p_instance->update_materials = false;
 }
 
+void VisualServerScene::tick() {
+
+	//the transforms of the tick that just ended are where the next blends start from
+	for (SelfList<Instance> *E = _instance_interpolation_list.first(); E; E = E->next()) {
+
+		Instance *instance = E->self();
+		instance->transform_prev = instance->transform_curr;
+	}
+}
+
+void VisualServerScene::update_interpolation_frame(float p_fraction) {
+
+	SelfList<Instance> *E = _instance_interpolation_list.first();
+	while (E) {
+
+		SelfList<Instance> *N = E->next();
+		Instance *instance = E->self();
+
+		Transform xform;
+		if (instance->transform_prev == instance->transform_curr) {
+			//stopped moving, no need to keep blending it
+			xform = instance->transform_curr;
+			_instance_interpolation_list.remove(E);
+		} else {
+			xform = instance->transform_prev.interpolate_with(instance->transform_curr, p_fraction);
+			VisualServerRaster::redraw_request(); //keep drawing until the blend is done
+		}
+
+		if (instance->transform != xform) {
+			instance->transform = xform;
+			_instance_queue_update(instance, true);
+		}
+
+		E = N;
+	}
+}
+
 void VisualServerScene::update_dirty_instances() {
 
+	scene_version++; //invalidates the culling shared between viewports
+
 	VSG::storage->update_dirty_resources();
 
 	while (_instance_update_list.first()) {
@@ -3392,8 +3789,6 @@ bool VisualServerScene::free(RID p_rid) {
 
 		update_dirty_instances();
 
-		Instance *instance = instance_owner.get(p_rid);
-
 		instance_set_use_lightmap(p_rid, RID(), RID());
 		instance_set_scenario(p_rid, RID());
 		instance_set_base(p_rid, RID());
@@ -3403,7 +3798,6 @@ bool VisualServerScene::free(RID p_rid) {
 		update_dirty_instances(); //in case something changed this
 
 		instance_owner.free(p_rid);
-		memdelete(instance);
 	} else {
 		return false;
 	}
@@ -3423,6 +3817,13 @@ VisualServerScene::VisualServerScene() {
 #endif
 
 	render_pass = 1;
+	texture_streaming = GLOBAL_GET("rendering/texture_streaming/enabled");
+	shadow_distant_light_coverage = GLOBAL_GET("rendering/quality/shadow_atlas/distant_light_coverage");
+	shadow_distant_light_update_interval = GLOBAL_GET("rendering/quality/shadow_atlas/distant_light_update_interval");
+	reflection_probe_update_steps_per_frame = GLOBAL_GET("rendering/quality/reflections/update_steps_per_frame");
+	shadow_cull_scenario = NULL;
+	scene_version = 1;
+	occlusion_buffer.set_size(256, 128);
 	singleton = this;
 }
 
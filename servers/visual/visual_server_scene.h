@@ -35,7 +35,8 @@
 
 #include "allocators.h"
 #include "geometry.h"
-#include "octree.h"
+#include "bvh.h"
+#include "occlusion_buffer.h"
 #include "os/semaphore.h"
 #include "os/thread.h"
 #include "self_list.h"
@@ -53,6 +54,10 @@ public:
 	};
 
 	uint64_t render_pass;
+	bool texture_streaming;
+	float shadow_distant_light_coverage;
+	int shadow_distant_light_update_interval;
+	int reflection_probe_update_steps_per_frame;
 
 	static VisualServerScene *singleton;
 
@@ -122,7 +127,7 @@ public:
 		RID self;
 		// well wtf, balloon allocator is slower?
 
-		Octree<Instance, true> octree;
+		BVH<Instance> bvh;
 
 		List<Instance *> directional_lights;
 		RID environment;
@@ -137,8 +142,8 @@ public:
 
 	mutable RID_Owner<Scenario> scenario_owner;
 
-	static void *_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int);
-	static void _instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *);
+	static void *_instance_pair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int);
+	static void _instance_unpair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int, void *);
 
 	virtual RID scenario_create();
 
@@ -158,7 +163,7 @@ public:
 
 		RID self;
 		//scenario stuff
-		OctreeElementID octree_id;
+		BVHElementID bvh_id;
 		Scenario *scenario;
 		SelfList<Instance> scenario_item;
 
@@ -168,18 +173,25 @@ public:
 
 		SelfList<Instance> update_item;
 
+		// physics interpolation, the drawn transform is blended between the ones set in the last two physics ticks
+		bool interpolated;
+		Transform transform_prev;
+		Transform transform_curr;
+		SelfList<Instance> interpolation_item;
+
 		AABB aabb;
 		AABB transformed_aabb;
 		AABB *custom_aabb; // <Zylann> would using aabb directly with a bool be better?
 		float extra_margin;
 		uint32_t object_ID;
 
-		float lod_begin;
-		float lod_end;
 		float lod_begin_hysteresis;
 		float lod_end_hysteresis;
+		bool lod_visible; // whether it was in range for the last camera, to apply the hysteresis
 		RID lod_instance;
 
+		Vector<Vector3> occluder_faces; // local space triangles, drawn to the occlusion buffer when in view
+
 		uint64_t last_render_pass;
 		uint64_t last_frame_pass;
 
@@ -204,23 +216,25 @@ public:
 
 		Instance() :
 				scenario_item(this),
-				update_item(this) {
+				update_item(this),
+				interpolation_item(this) {
 
-			octree_id = 0;
+			bvh_id = 0;
 			scenario = NULL;
 
 			update_aabb = false;
 			update_materials = false;
 
+			interpolated = false;
+
 			extra_margin = 0;
 
 			object_ID = 0;
 			visible = true;
 
-			lod_begin = 0;
-			lod_end = 0;
 			lod_begin_hysteresis = 0;
 			lod_end_hysteresis = 0;
+			lod_visible = true;
 
 			last_render_pass = 0;
 			last_frame_pass = 0;
@@ -239,9 +253,41 @@ public:
 		}
 	};
 
+	_FORCE_INLINE_ static bool _instance_in_lod_range(const Instance *p_instance, const Vector3 &p_cam_origin) {
+
+		if (p_instance->lod_begin <= 0 && p_instance->lod_end <= 0)
+			return true; //no draw range
+
+		float begin = p_instance->lod_begin;
+		float end = p_instance->lod_end;
+		if (p_instance->lod_visible) {
+			//once visible, stay until past the margins, so it does not pop around the limits
+			begin -= p_instance->lod_begin_hysteresis;
+			end += p_instance->lod_end_hysteresis;
+		}
+
+		if (p_instance->base_type == VS::INSTANCE_MULTIMESH) {
+			//the rasterizer checks the range per chunk, only reject when the whole bounds are out of range
+			const AABB &aabb = p_instance->transformed_aabb;
+			Vector3 nearest = p_cam_origin;
+			Vector3 farthest;
+			for (int i = 0; i < 3; i++) {
+				nearest[i] = CLAMP(nearest[i], aabb.position[i], aabb.position[i] + aabb.size[i]);
+				farthest[i] = (p_cam_origin[i] < aabb.position[i] + aabb.size[i] * 0.5) ? aabb.position[i] + aabb.size[i] : aabb.position[i];
+			}
+			return p_cam_origin.distance_to(farthest) >= begin && (p_instance->lod_end <= 0 || p_cam_origin.distance_to(nearest) <= end);
+		}
+
+		float d = p_cam_origin.distance_to(p_instance->transformed_aabb.position + p_instance->transformed_aabb.size * 0.5);
+		return d >= begin && (p_instance->lod_end <= 0 || d <= end);
+	}
+
 	SelfList<Instance>::List _instance_update_list;
 	void _instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_materials = false);
 
+	SelfList<Instance>::List _instance_interpolation_list;
+	void _instance_set_transform(Instance *p_instance, const Transform &p_transform);
+
 	struct InstanceGeometryData : public InstanceBaseData {
 
 		List<Instance *> lighting;
@@ -280,12 +326,14 @@ public:
 		SelfList<InstanceReflectionProbeData> update_list;
 
 		int render_step;
+		float camera_distance; //distance to the last camera that saw it, used to prioritize updates
 
 		InstanceReflectionProbeData() :
 				update_list(this) {
 
 			reflection_dirty = true;
 			render_step = -1;
+			camera_distance = 0;
 		}
 	};
 
@@ -303,6 +351,12 @@ public:
 		List<Instance *>::Element *D; // directional light in scenario
 
 		bool shadow_dirty;
+		uint64_t shadow_update_frame;
+
+		// bvh cull of each omni/spot shadow pass, these don't depend on the camera,
+		// so all viewports drawing the same scene state can share them
+		Vector<Instance *> shadow_cull_cache[6];
+		uint64_t shadow_cull_cache_version[6];
 
 		List<PairInfo> geometries;
 
@@ -311,6 +365,10 @@ public:
 		InstanceLightData() {
 
 			shadow_dirty = true;
+			shadow_update_frame = 0;
+			for (int i = 0; i < 6; i++) {
+				shadow_cull_cache_version[i] = 0;
+			}
 			D = NULL;
 			last_version = 0;
 			baked_light = NULL;
@@ -434,6 +492,8 @@ public:
 		}
 	};
 
+	OcclusionBuffer occlusion_buffer;
+
 	int instance_cull_count;
 	Instance *instance_cull_result[MAX_INSTANCE_CULL];
 	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
@@ -444,7 +504,7 @@ public:
 	RID reflection_probe_instance_cull_result[MAX_REFLECTION_PROBES_CULLED];
 	int reflection_probe_cull_count;
 
-	RID_Owner<Instance> instance_owner;
+	RID_Alloc<Instance> instance_owner;
 
 	// from can be mesh, light,  area and portal so far.
 	virtual RID instance_create(); // from can be mesh, light, poly, area and portal so far.
@@ -453,6 +513,9 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario); // from can be mesh, light, poly, area and portal so far.
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform);
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms);
+	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated);
+	virtual void instance_reset_physics_interpolation(RID p_instance);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_ID);
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight);
 	virtual void instance_set_surface_material(RID p_instance, int p_surface, RID p_material);
@@ -477,22 +540,78 @@ public:
 
 	virtual void instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin);
 	virtual void instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance);
+	virtual void instance_geometry_set_occluder_faces(RID p_instance, const PoolVector<Vector3> &p_faces);
 
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ void _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
+	// One shadow map pass (directional split, paraboloid half or cubemap face) to cull and render.
+	struct ShadowCullJob {
+
+		Instance *light;
+		int pass;
+		Vector<Plane> planes;
+		Plane near_plane;
+
+		CameraMatrix projection;
+		Transform transform;
+		float far;
+		float split;
+		float bias_scale;
+		bool restore_paraboloid;
+		bool camera_independent; //omni and spot passes, culling can be shared between viewports
+
+		// directional splits fit their depth range to the casters found
+		bool fit_depth;
+		Vector3 depth_axis;
+		float z_min;
+		float z_max;
+		real_t half_x;
+		real_t half_y;
+
+		int cull_count;
+
+		ShadowCullJob() {
+			light = NULL;
+			pass = 0;
+			far = 0;
+			split = 0;
+			bias_scale = 1.0;
+			restore_paraboloid = false;
+			camera_independent = false;
+			fit_depth = false;
+			z_min = 0;
+			z_max = 0;
+			half_x = 0;
+			half_y = 0;
+			cull_count = 0;
+		}
+	};
+
+	Vector<ShadowCullJob> shadow_cull_jobs;
+	Vector<Vector<Instance *> > shadow_cull_results;
+	Scenario *shadow_cull_scenario;
+	Vector3 shadow_cull_camera_origin;
+	uint64_t scene_version; //changes every time instances may have been updated
+
+	_FORCE_INLINE_ void _light_instance_setup_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
+	static void _cull_shadow_job(void *p_userdata, uint32_t p_index);
+	void _render_shadows(const Transform &p_cam_transform, RID p_shadow_atlas, Scenario *p_scenario);
 
 	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe);
 	void _render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
+	void _request_texture_streaming(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, const Size2 &p_viewport_size);
 	void render_empty_scene(RID p_scenario, RID p_shadow_atlas);
 
 	void render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas);
 	void render_camera(Ref<ARVRInterface> &p_interface, ARVRInterface::Eyes p_eye, RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas);
 	void update_dirty_instances();
 
+	void tick();
+	void update_interpolation_frame(float p_fraction);
+
 	//probes
 	struct GIProbeDataHeader {
 
@@ -539,6 +658,7 @@ public:
 	bool _check_gi_probe(Instance *p_gi_probe);
 	void _setup_gi_probe(Instance *p_instance);
 
+	InstanceReflectionProbeData *_get_next_reflection_probe_to_render();
 	void render_probes();
 
 	bool free(RID p_rid);
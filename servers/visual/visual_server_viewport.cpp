@@ -35,7 +35,92 @@
 #include "visual_server_global.h"
 #include "visual_server_scene.h"
 
-void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::Eyes p_eye) {
+static _FORCE_INLINE_ uint32_t _hash_transform(const Transform2D &p_xform, uint32_t p_hash) {
+
+	for (int i = 0; i < 3; i++) {
+		p_hash = hash_djb2_one_float(p_xform.elements[i].x, p_hash);
+		p_hash = hash_djb2_one_float(p_xform.elements[i].y, p_hash);
+	}
+	return p_hash;
+}
+
+bool VisualServerViewport::_is_viewport_visible(Viewport *p_viewport) const {
+
+	Viewport *vp = p_viewport;
+
+	if (vp->update_mode == VS::VIEWPORT_UPDATE_DISABLED || !vp->render_target.is_valid())
+		return false;
+
+	bool visible = vp->viewport_to_screen_rect != Rect2() || vp->update_mode == VS::VIEWPORT_UPDATE_ALWAYS || vp->update_mode == VS::VIEWPORT_UPDATE_ONCE || (vp->update_mode == VS::VIEWPORT_UPDATE_WHEN_VISIBLE && VSG::storage->render_target_was_used(vp->render_target));
+	return visible && vp->size.x > 1 && vp->size.y > 1;
+}
+
+VisualServerViewport::Damage VisualServerViewport::_get_viewport_damage(Viewport *p_viewport, bool p_force_full, Rect2 &r_rect) {
+
+	// the item damage is always updated, so it stays in sync with what was drawn even when drawing everything
+	VSG::canvas->damage_begin();
+
+	uint32_t hash = hash_djb2_one_32(p_viewport->size.x);
+	hash = hash_djb2_one_32(p_viewport->size.y, hash);
+	hash = hash_djb2_one_float(clear_color.r, hash);
+	hash = hash_djb2_one_float(clear_color.g, hash);
+	hash = hash_djb2_one_float(clear_color.b, hash);
+	hash = _hash_transform(p_viewport->global_transform, hash);
+
+	bool force_full = p_force_full;
+
+	if (!p_viewport->hide_canvas) {
+
+		for (Map<RID, Viewport::CanvasData>::Element *E = p_viewport->canvas_map.front(); E; E = E->next()) {
+
+			VisualServerCanvas::Canvas *canvas = static_cast<VisualServerCanvas::Canvas *>(E->get().canvas);
+
+			if (canvas->lights.size()) {
+				force_full = true; // lights and shadows can change anywhere on screen
+			}
+
+			hash = hash_djb2_one_32(E->key().get_id(), hash);
+			hash = hash_djb2_one_32(E->get().layer, hash);
+			hash = hash_djb2_one_float(canvas->modulate.r, hash);
+			hash = hash_djb2_one_float(canvas->modulate.g, hash);
+			hash = hash_djb2_one_float(canvas->modulate.b, hash);
+			hash = hash_djb2_one_float(canvas->modulate.a, hash);
+			hash = _hash_transform(E->get().transform, hash);
+
+			VSG::canvas->damage_canvas(canvas, p_viewport->global_transform * E->get().transform);
+		}
+	}
+
+	Rect2 damage;
+	Damage result = VSG::canvas->damage_end(damage);
+
+	if (damage_viewport != p_viewport || damage_state_hash != hash) {
+		force_full = true;
+	}
+	damage_viewport = p_viewport;
+	damage_state_hash = hash;
+
+	if (force_full || p_viewport->transparent_bg || p_viewport->clear_mode != VS::VIEWPORT_CLEAR_ALWAYS || p_viewport->scenario.is_valid() || VSG::scene->camera_owner.owns(p_viewport->camera)) {
+		return DAMAGE_FULL;
+	}
+
+	if (result != DAMAGE_PARTIAL)
+		return result;
+
+	// antialiasing and filtering can reach a bit outside of the item rects, then snap to whole pixels
+	damage = damage.grow(2);
+	Point2 from = damage.position.floor();
+	Point2 to = (damage.position + damage.size).ceil();
+	damage = Rect2(from, to - from).clip(Rect2(0, 0, p_viewport->size.x, p_viewport->size.y));
+
+	if (damage.size.x <= 0 || damage.size.y <= 0)
+		return DAMAGE_NONE;
+
+	r_rect = damage;
+	return DAMAGE_PARTIAL;
+}
+
+void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::Eyes p_eye, const Rect2 *p_damage) {
 
 	/* Camera should always be BEFORE any other 3D */
 
@@ -54,7 +139,12 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 
 	bool can_draw_3d = !p_viewport->disable_3d && !p_viewport->disable_3d_by_usage && VSG::scene->camera_owner.owns(p_viewport->camera);
 
-	if (p_viewport->clear_mode != VS::VIEWPORT_CLEAR_NEVER) {
+	if (p_damage && !VSG::rasterizer->clear_render_target_rect(*p_damage, clear_color)) {
+		p_damage = NULL;
+		damage_viewport = NULL; // not supported, draw everything from now on
+	}
+
+	if (p_viewport->clear_mode != VS::VIEWPORT_CLEAR_NEVER && !p_damage) {
 		VSG::rasterizer->clear_render_target(p_viewport->transparent_bg ? Color(0, 0, 0, 0) : clear_color);
 		if (p_viewport->clear_mode == VS::VIEWPORT_CLEAR_ONLY_NEXT_FRAME) {
 			p_viewport->clear_mode = VS::VIEWPORT_CLEAR_NEVER;
@@ -144,7 +234,7 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 		if (lights_with_shadow) {
 			//update shadows if any
 
-			RasterizerCanvas::LightOccluderInstance *occluders = NULL;
+			Vector<RasterizerCanvas::LightOccluderInstance *> occluders;
 
 			//make list of occluders
 			for (Map<RID, Viewport::CanvasData>::Element *E = p_viewport->canvas_map.front(); E; E = E->next()) {
@@ -159,16 +249,47 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 					F->get()->xform_cache = xf * F->get()->xform;
 					if (shadow_rect.intersects_transformed(F->get()->xform_cache, F->get()->aabb_cache)) {
 
-						F->get()->next = occluders;
-						occluders = F->get();
+						occluders.push_back(F->get());
 					}
 				}
 			}
-			//update the light shadowmaps with them
+			//update the light shadowmaps with them, only redrawing the ones whose light or occluders changed
 			RasterizerCanvas::Light *light = lights_with_shadow;
 			while (light) {
 
-				VSG::canvas_render->canvas_light_shadow_buffer_update(light->shadow_buffer, light->xform_cache.affine_inverse(), light->item_mask, light->radius_cache / 1000.0, light->radius_cache * 1.1, occluders, &light->shadow_matrix_cache);
+				Rect2 light_rect = light->xform_cache.xform(light->rect_cache);
+
+				uint32_t hash = hash_djb2_one_32(light->shadow_buffer.get_id());
+				hash = hash_djb2_one_32(light->shadow_buffer_size, hash);
+				hash = hash_djb2_one_32(light->item_mask, hash);
+				hash = hash_djb2_one_float(light->radius_cache, hash);
+				hash = _hash_transform(light->xform_cache, hash);
+
+				RasterizerCanvas::LightOccluderInstance *light_occluders = NULL;
+
+				for (int i = occluders.size() - 1; i >= 0; i--) {
+
+					RasterizerCanvas::LightOccluderInstance *occluder = occluders[i];
+					if (!(light->item_mask & occluder->light_mask) || !light_rect.intersects_transformed(occluder->xform_cache, occluder->aabb_cache)) {
+						continue;
+					}
+
+					hash = hash_djb2_one_32(occluder->polygon_buffer.get_id(), hash);
+					hash = hash_djb2_one_32(occluder->version, hash);
+					hash = hash_djb2_one_32(occluder->cull_cache, hash);
+					hash = _hash_transform(occluder->xform_cache, hash);
+
+					occluder->next = light_occluders;
+					light_occluders = occluder;
+				}
+
+				if (!light->shadow_cache_valid || light->shadow_cache_hash != hash) {
+
+					VSG::canvas_render->canvas_light_shadow_buffer_update(light->shadow_buffer, light->xform_cache.affine_inverse(), light->item_mask, light->radius_cache / 1000.0, light->radius_cache * 1.1, light_occluders, &light->shadow_matrix_cache);
+					light->shadow_cache_hash = hash;
+					light->shadow_cache_valid = true;
+				}
+
 				light = light->shadows_next_ptr;
 			}
 
@@ -190,6 +311,10 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 			scenario_draw_canvas_bg = false;
 		}
 
+		if (p_damage) {
+			VSG::canvas->damage_clip_begin(*p_damage);
+		}
+
 		for (Map<Viewport::CanvasKey, Viewport::CanvasData *>::Element *E = canvas_map.front(); E; E = E->next()) {
 
 			VisualServerCanvas::Canvas *canvas = static_cast<VisualServerCanvas::Canvas *>(E->get()->canvas);
@@ -241,6 +366,10 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 			scenario_draw_canvas_bg = false;
 		}
 
+		if (p_damage) {
+			VSG::canvas->damage_clip_end();
+		}
+
 		//VSG::canvas_render->canvas_debug_viewport_shadows(lights_with_shadow);
 	}
 }
@@ -259,6 +388,16 @@ void VisualServerViewport::draw_viewports() {
 	//sort viewports
 	active_viewports.sort_custom<ViewportSort>();
 
+	// other viewports may be shown through textures anywhere on screen, so partial redraws need the screen one to be alone
+	int visible_viewports = 0;
+	if (use_partial_redraw) {
+		for (int i = 0; i < active_viewports.size(); i++) {
+			if (_is_viewport_visible(active_viewports[i])) {
+				visible_viewports++;
+			}
+		}
+	}
+
 	//draw viewports
 	for (int i = 0; i < active_viewports.size(); i++) {
 
@@ -269,10 +408,7 @@ void VisualServerViewport::draw_viewports() {
 
 		ERR_CONTINUE(!vp->render_target.is_valid());
 
-		bool visible = vp->viewport_to_screen_rect != Rect2() || vp->update_mode == VS::VIEWPORT_UPDATE_ALWAYS || vp->update_mode == VS::VIEWPORT_UPDATE_ONCE || (vp->update_mode == VS::VIEWPORT_UPDATE_WHEN_VISIBLE && VSG::storage->render_target_was_used(vp->render_target));
-		visible = visible && vp->size.x > 1 && vp->size.y > 1;
-
-		if (!visible)
+		if (!_is_viewport_visible(vp))
 			continue;
 
 		VSG::storage->render_target_clear_used(vp->render_target);
@@ -302,11 +438,21 @@ void VisualServerViewport::draw_viewports() {
 		} else {
 			VSG::rasterizer->set_current_render_target(vp->render_target);
 
+			Rect2 damage;
+			Damage damage_mode = DAMAGE_FULL;
+			if (use_partial_redraw && vp->viewport_to_screen_rect != Rect2()) {
+				damage_mode = _get_viewport_damage(vp, visible_viewports > 1 || vp->debug_draw != VS::VIEWPORT_DEBUG_DRAW_DISABLED, damage);
+			} else if (vp == damage_viewport) {
+				damage_viewport = NULL;
+			}
+
 			VSG::scene_render->set_debug_draw_mode(vp->debug_draw);
 			VSG::storage->render_info_begin_capture();
 
-			// render standard mono camera
-			_draw_viewport(vp);
+			// render standard mono camera, unless nothing changed since the last partial redraw
+			if (damage_mode != DAMAGE_NONE) {
+				_draw_viewport(vp, ARVRInterface::EYE_MONO, damage_mode == DAMAGE_PARTIAL ? &damage : NULL);
+			}
 
 			VSG::storage->render_info_end_capture();
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_OBJECTS_IN_FRAME);
@@ -315,6 +461,7 @@ void VisualServerViewport::draw_viewports() {
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_SHADER_CHANGES_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_SHADER_CHANGES_IN_FRAME);
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_SURFACE_CHANGES_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_SURFACE_CHANGES_IN_FRAME);
 			vp->render_info[VS::VIEWPORT_RENDER_INFO_DRAW_CALLS_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_DRAW_CALLS_IN_FRAME);
+			vp->render_info[VS::VIEWPORT_RENDER_INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME] = VSG::storage->get_captured_render_info(VS::INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME);
 
 			if (vp->viewport_to_screen_rect != Rect2()) {
 				//copy to screen if set as such
@@ -653,6 +800,10 @@ bool VisualServerViewport::free(RID p_rid) {
 		viewport_set_scenario(p_rid, RID());
 		active_viewports.erase(viewport);
 
+		if (damage_viewport == viewport) {
+			damage_viewport = NULL;
+		}
+
 		viewport_owner.free(p_rid);
 		memdelete(viewport);
 
@@ -667,4 +818,8 @@ void VisualServerViewport::set_default_clear_color(const Color &p_color) {
 }
 
 VisualServerViewport::VisualServerViewport() {
+
+	use_partial_redraw = GLOBAL_DEF("rendering/quality/2d/use_partial_redraw", false);
+	damage_viewport = NULL;
+	damage_state_hash = 0;
 }
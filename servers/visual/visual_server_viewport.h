@@ -139,9 +139,23 @@ public:
 
 	Vector<Viewport *> active_viewports;
 
+	enum Damage {
+		DAMAGE_NONE,
+		DAMAGE_PARTIAL,
+		DAMAGE_FULL
+	};
+
 private:
 	Color clear_color;
-	void _draw_viewport(Viewport *p_viewport, ARVRInterface::Eyes p_eye = ARVRInterface::EYE_MONO);
+
+	// partial redraws, only the parts of the screen viewport that changed are drawn again
+	bool use_partial_redraw;
+	Viewport *damage_viewport;
+	uint32_t damage_state_hash;
+
+	bool _is_viewport_visible(Viewport *p_viewport) const;
+	Damage _get_viewport_damage(Viewport *p_viewport, bool p_force_full, Rect2 &r_rect);
+	void _draw_viewport(Viewport *p_viewport, ARVRInterface::Eyes p_eye = ARVRInterface::EYE_MONO, const Rect2 *p_damage = NULL);
 
 public:
 	RID viewport_create();
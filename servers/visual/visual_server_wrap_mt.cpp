@@ -39,6 +39,15 @@ void VisualServerWrapMT::thread_exit() {
 
 void VisualServerWrapMT::thread_draw(bool p_swap_buffers, double frame_step) {
 
+	if (max_queued_frames > 1) {
+
+		// frames are already throttled by sync(), so draw every one of them
+		visual_server->draw(p_swap_buffers, frame_step);
+		atomic_decrement(&queued_frames);
+		frame_drawn->post();
+		return;
+	}
+
 	if (!atomic_decrement(&draw_pending)) {
 
 		visual_server->draw(p_swap_buffers, frame_step);
@@ -83,6 +92,14 @@ void VisualServerWrapMT::sync() {
 
 	if (create_thread) {
 
+		if (max_queued_frames > 1) {
+
+			while (queued_frames >= (uint32_t)max_queued_frames) {
+				frame_drawn->wait();
+			}
+			return;
+		}
+
 		atomic_increment(&draw_pending);
 		command_queue.push_and_sync(this, &VisualServerWrapMT::thread_flush);
 	} else {
@@ -95,7 +112,11 @@ void VisualServerWrapMT::draw(bool p_swap_buffers, double frame_step) {
 
 	if (create_thread) {
 
-		atomic_increment(&draw_pending);
+		if (max_queued_frames > 1) {
+			atomic_increment(&queued_frames);
+		} else {
+			atomic_increment(&draw_pending);
+		}
 		command_queue.push(this, &VisualServerWrapMT::thread_draw, p_swap_buffers, frame_step);
 	} else {
 
@@ -110,7 +131,11 @@ void VisualServerWrapMT::init() {
 		print_line("CREATING RENDER THREAD");
 		OS::get_singleton()->release_rendering_thread();
 		if (create_thread) {
-			thread = Thread::create(_thread_callback, this);
+			Thread::Settings settings;
+			settings.name = "Render";
+			settings.priority = Thread::PRIORITY_HIGH;
+			settings.core_type = Thread::CORE_TYPE_PERFORMANCE;
+			thread = Thread::create(_thread_callback, this, settings);
 			print_line("STARTING RENDER THREAD");
 		}
 		while (!draw_thread_up) {
@@ -179,6 +204,13 @@ VisualServerWrapMT::VisualServerWrapMT(VisualServer *p_contained, bool p_create_
 	draw_pending = 0;
 	draw_thread_up = false;
 	alloc_mutex = Mutex::create();
+	queued_frames = 0;
+	frame_drawn = NULL;
+	max_queued_frames = 1;
+	if (p_create_thread) {
+		max_queued_frames = CLAMP(int(GLOBAL_GET("rendering/threads/max_queued_frames")), 1, 3);
+		frame_drawn = Semaphore::create();
+	}
 	pool_max_size = GLOBAL_GET("memory/limits/multithreaded_server/rid_pool_prealloc");
 
 	if (!p_create_thread) {
@@ -192,5 +224,7 @@ VisualServerWrapMT::~VisualServerWrapMT() {
 
 	memdelete(visual_server);
 	memdelete(alloc_mutex);
+	if (frame_drawn)
+		memdelete(frame_drawn);
 	//finish();
 }
@@ -32,6 +32,7 @@
 #define VISUAL_SERVER_WRAP_MT_H
 
 #include "command_queue_mt.h"
+#include "os/semaphore.h"
 #include "os/thread.h"
 #include "servers/visual_server.h"
 
@@ -56,6 +57,12 @@ class VisualServerWrapMT : public VisualServer {
 
 	uint64_t draw_pending;
 	void thread_draw(bool p_swap_buffers, double frame_step);
+
+	// when more than one frame may be queued, the main thread only waits once that many draws are pending,
+	// so it can work on the next frame while the previous one is being drawn
+	int max_queued_frames;
+	uint32_t queued_frames;
+	Semaphore *frame_drawn;
 	void thread_flush();
 
 	void thread_exit();
@@ -99,6 +106,7 @@ public:
 	FUNC3(texture_set_detect_3d_callback, RID, TextureDetectCallback, void *)
 	FUNC3(texture_set_detect_srgb_callback, RID, TextureDetectCallback, void *)
 	FUNC3(texture_set_detect_normal_callback, RID, TextureDetectCallback, void *)
+	FUNC3(texture_set_stream_request_callback, RID, TextureStreamRequestCallback, void *)
 
 	FUNC2(texture_set_path, RID, const String &)
 	FUNC1RC(String, texture_get_path, RID)
@@ -227,6 +235,7 @@ public:
 	FUNC3(skeleton_allocate, RID, int, bool)
 	FUNC1RC(int, skeleton_get_bone_count, RID)
 	FUNC3(skeleton_bone_set_transform, RID, int, const Transform &)
+	FUNC2(skeleton_set_bone_transforms, RID, const PoolVector<float> &)
 	FUNC2RC(Transform, skeleton_bone_get_transform, RID, int)
 	FUNC3(skeleton_bone_set_transform_2d, RID, int, const Transform2D &)
 	FUNC2RC(Transform2D, skeleton_bone_get_transform_2d, RID, int)
@@ -425,6 +434,7 @@ public:
 	FUNC4(environment_set_ambient_light, RID, const Color &, float, float)
 	FUNC7(environment_set_ssr, RID, bool, int, float, float, float, bool)
 	FUNC13(environment_set_ssao, RID, bool, float, float, float, float, float, float, float, const Color &, EnvironmentSSAOQuality, EnvironmentSSAOBlur, float)
+	FUNC2(environment_set_ssao_resolution, RID, EnvironmentSSAOResolution)
 
 	FUNC6(environment_set_dof_blur_near, RID, bool, float, float, float, EnvironmentDOFBlurQuality)
 	FUNC6(environment_set_dof_blur_far, RID, bool, float, float, float, EnvironmentDOFBlurQuality)
@@ -453,6 +463,9 @@ public:
 	FUNC2(instance_set_scenario, RID, RID) // from can be mesh, light, poly, area and portal so far.
 	FUNC2(instance_set_layer_mask, RID, uint32_t)
 	FUNC2(instance_set_transform, RID, const Transform &)
+	FUNC2(instances_set_transforms, const Vector<RID> &, const Vector<Transform> &)
+	FUNC2(instance_set_interpolated, RID, bool)
+	FUNC1(instance_reset_physics_interpolation, RID)
 	FUNC2(instance_attach_object_instance_id, RID, ObjectID)
 	FUNC3(instance_set_blend_shape_weight, RID, int, float)
 	FUNC3(instance_set_surface_material, RID, int, RID)
@@ -477,6 +490,7 @@ public:
 
 	FUNC5(instance_geometry_set_draw_range, RID, float, float, float, float)
 	FUNC2(instance_geometry_set_as_instance_lod, RID, RID)
+	FUNC2(instance_geometry_set_occluder_faces, RID, const PoolVector<Vector3> &)
 
 	/* CANVAS (2D) */
 
@@ -491,6 +505,8 @@ public:
 	FUNC2(canvas_item_set_light_mask, RID, int)
 
 	FUNC2(canvas_item_set_transform, RID, const Transform2D &)
+	FUNC2(canvas_item_set_interpolated, RID, bool)
+	FUNC1(canvas_item_reset_physics_interpolation, RID)
 	FUNC2(canvas_item_set_clip, RID, bool)
 	FUNC2(canvas_item_set_distance_field_mode, RID, bool)
 	FUNC3(canvas_item_set_custom_rect, RID, bool, const Rect2 &)
@@ -582,6 +598,8 @@ public:
 	virtual void finish();
 	virtual void draw(bool p_swap_buffers, double frame_step);
 	virtual void sync();
+	FUNC0(tick)
+	FUNC1(set_physics_interpolation_fraction, float)
 	FUNC0RC(bool, has_changed)
 
 	/* RENDER INFO */
@@ -598,6 +616,10 @@ public:
 
 	FUNC1(set_debug_generate_wireframes, bool)
 
+	FUNC1(shader_variants_set_recording, bool)
+	FUNC0R(PoolVector<String>, shader_variants_get_recorded)
+	FUNC1(shader_variants_precompile, const PoolVector<String> &)
+
 	virtual bool has_feature(Features p_feature) const { return visual_server->has_feature(p_feature); }
 	virtual bool has_os_feature(const String &p_feature) const { return visual_server->has_os_feature(p_feature); }
 
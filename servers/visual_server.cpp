@@ -31,6 +31,7 @@
 #include "visual_server.h"
 
 #include "method_bind_ext.gen.inc"
+#include "os/file_access.h"
 #include "project_settings.h"
 
 VisualServer *VisualServer::singleton = NULL;
@@ -343,6 +344,46 @@ RID VisualServer::get_white_texture() {
 #define SMALL_VEC2 Vector2(0.00001, 0.00001)
 #define SMALL_VEC3 Vector3(0.00001, 0.00001, 0.00001)
 
+static Vector2 _octahedron_encode(const Vector3 &p_vector) {
+
+	real_t l1 = ABS(p_vector.x) + ABS(p_vector.y) + ABS(p_vector.z);
+	if (l1 < CMP_EPSILON) {
+		return Vector2(0, 0); //points up, better than garbage
+	}
+
+	Vector3 n = p_vector / l1;
+	if (n.z >= 0) {
+		return Vector2(n.x, n.y);
+	}
+
+	//fold the lower hemisphere over the diagonals
+	return Vector2((1.0 - ABS(n.y)) * (n.x >= 0 ? 1.0 : -1.0), (1.0 - ABS(n.x)) * (n.y >= 0 ? 1.0 : -1.0));
+}
+
+static Vector3 _octahedron_decode(const Vector2 &p_oct) {
+
+	Vector3 n(p_oct.x, p_oct.y, 1.0 - ABS(p_oct.x) - ABS(p_oct.y));
+	real_t t = MAX(-n.z, 0);
+	n.x += n.x >= 0 ? -t : t;
+	n.y += n.y >= 0 ? -t : t;
+	return n.normalized();
+}
+
+static _FORCE_INLINE_ int16_t _snorm16(real_t p_value) {
+
+	return (int16_t)CLAMP(Math::round(p_value * 32767.0), -32767, 32767);
+}
+
+static _FORCE_INLINE_ real_t _snorm16_to_float(int16_t p_value) {
+
+	return MAX(p_value / 32767.0, -1.0);
+}
+
+static _FORCE_INLINE_ uint16_t _unorm16(real_t p_value) {
+
+	return (uint16_t)CLAMP(Math::round(p_value * 65535.0), 0, 65535);
+}
+
 Error VisualServer::_surface_set_data(Array p_arrays, uint32_t p_format, uint32_t *p_offsets, uint32_t p_stride, PoolVector<uint8_t> &r_vertex_array, int p_vertex_array_len, PoolVector<uint8_t> &r_index_array, int p_index_array_len, AABB &r_aabb, Vector<AABB> r_bone_aabb) {
 
 	PoolVector<uint8_t>::Write vw = r_vertex_array.write();
@@ -420,7 +461,31 @@ Error VisualServer::_surface_set_data(Array p_arrays, uint32_t p_format, uint32_
 					// setting vertices means regenerating the AABB
 					AABB aabb;
 
-					if (p_format & ARRAY_COMPRESS_VERTEX) {
+					if ((p_format & ARRAY_COMPRESS_VERTEX) && (p_format & ARRAY_FLAG_USE_QUANTIZED_VERTICES)) {
+
+						//the AABB is needed before encoding, the renderer uses it to decode
+						for (int i = 0; i < p_vertex_array_len; i++) {
+
+							if (i == 0) {
+
+								aabb = AABB(src[i], SMALL_VEC3);
+							} else {
+
+								aabb.expand_to(src[i]);
+							}
+						}
+
+						Vector3 inv_size(1.0 / aabb.size.x, 1.0 / aabb.size.y, 1.0 / aabb.size.z);
+
+						for (int i = 0; i < p_vertex_array_len; i++) {
+
+							Vector3 pos = (src[i] - aabb.position) * inv_size;
+							uint16_t vector[4] = { _unorm16(pos.x), _unorm16(pos.y), _unorm16(pos.z), 65535 };
+
+							copymem(&vw[p_offsets[ai] + i * p_stride], vector, sizeof(uint16_t) * 4);
+						}
+
+					} else if (p_format & ARRAY_COMPRESS_VERTEX) {
 
 						for (int i = 0; i < p_vertex_array_len; i++) {
 
@@ -470,7 +535,17 @@ Error VisualServer::_surface_set_data(Array p_arrays, uint32_t p_format, uint32_
 
 				// setting vertices means regenerating the AABB
 
-				if (p_format & ARRAY_COMPRESS_NORMAL) {
+				if ((p_format & ARRAY_COMPRESS_NORMAL) && (p_format & ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+
+					for (int i = 0; i < p_vertex_array_len; i++) {
+
+						Vector2 oct = _octahedron_encode(src[i]);
+						int16_t vector[2] = { _snorm16(oct.x), _snorm16(oct.y) };
+
+						copymem(&vw[p_offsets[ai] + i * p_stride], vector, 4);
+					}
+
+				} else if (p_format & ARRAY_COMPRESS_NORMAL) {
 
 					for (int i = 0; i < p_vertex_array_len; i++) {
 
@@ -505,7 +580,19 @@ Error VisualServer::_surface_set_data(Array p_arrays, uint32_t p_format, uint32_
 				PoolVector<real_t>::Read read = array.read();
 				const real_t *src = read.ptr();
 
-				if (p_format & ARRAY_COMPRESS_TANGENT) {
+				if ((p_format & ARRAY_COMPRESS_TANGENT) && (p_format & ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+
+					for (int i = 0; i < p_vertex_array_len; i++) {
+
+						Vector2 oct = _octahedron_encode(Vector3(src[i * 4 + 0], src[i * 4 + 1], src[i * 4 + 2]));
+						//the binormal direction goes in the sign of y, which is moved to the 0-1 range (never 0) to keep it
+						real_t y = MAX(oct.y * 0.5 + 0.5, 1.0 / 32767.0);
+						int16_t vector[2] = { _snorm16(oct.x), _snorm16(src[i * 4 + 3] < 0 ? -y : y) };
+
+						copymem(&vw[p_offsets[ai] + i * p_stride], vector, 4);
+					}
+
+				} else if (p_format & ARRAY_COMPRESS_TANGENT) {
 
 					for (int i = 0; i < p_vertex_array_len; i++) {
 
@@ -610,7 +697,15 @@ Error VisualServer::_surface_set_data(Array p_arrays, uint32_t p_format, uint32_
 
 				const Vector2 *src = read.ptr();
 
-				if (p_format & ARRAY_COMPRESS_TEX_UV2) {
+				if ((p_format & ARRAY_COMPRESS_TEX_UV2) && (p_format & ARRAY_FLAG_USE_16_BIT_TEX_UV2)) {
+
+					for (int i = 0; i < p_vertex_array_len; i++) {
+
+						uint16_t uv[2] = { _unorm16(src[i].x), _unorm16(src[i].y) };
+						copymem(&vw[p_offsets[ai] + i * p_stride], uv, 2 * 2);
+					}
+
+				} else if (p_format & ARRAY_COMPRESS_TEX_UV2) {
 
 					for (int i = 0; i < p_vertex_array_len; i++) {
 
@@ -1131,6 +1226,34 @@ void VisualServer::mesh_add_surface_from_arrays(RID p_mesh, PrimitiveType p_prim
 		total_elem_size += elem_size;
 	}
 
+	//drop the compression flags that can't apply to these arrays, the renderers don't need to check them again
+
+	if (!(p_compress_format & ARRAY_COMPRESS_VERTEX) || (p_compress_format & ARRAY_FLAG_USE_2D_VERTICES) || p_blend_shapes.size()) {
+		//blend shapes are blended from the raw attributes and may grow the AABB
+		p_compress_format &= ~ARRAY_FLAG_USE_QUANTIZED_VERTICES;
+	}
+
+	{
+		//a single flag tells the renderers how to decode both arrays, so every present one must be compressed
+		bool normal_octahedral = !(format & ARRAY_FORMAT_NORMAL) || (p_compress_format & ARRAY_COMPRESS_NORMAL);
+		bool tangent_octahedral = !(format & ARRAY_FORMAT_TANGENT) || (p_compress_format & ARRAY_COMPRESS_TANGENT);
+		if (!(format & (ARRAY_FORMAT_NORMAL | ARRAY_FORMAT_TANGENT)) || !normal_octahedral || !tangent_octahedral || p_blend_shapes.size()) {
+			p_compress_format &= ~ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION;
+		}
+	}
+
+	if ((p_compress_format & ARRAY_FLAG_USE_16_BIT_TEX_UV2) && (format & ARRAY_FORMAT_TEX_UV2) && (p_compress_format & ARRAY_COMPRESS_TEX_UV2)) {
+
+		PoolVector<Vector2> uv2 = p_arrays[VS::ARRAY_TEX_UV2];
+		PoolVector<Vector2>::Read r = uv2.read();
+		for (int i = 0; i < uv2.size(); i++) {
+			if (r[i].x < 0 || r[i].x > 1 || r[i].y < 0 || r[i].y > 1) {
+				p_compress_format &= ~ARRAY_FLAG_USE_16_BIT_TEX_UV2; //does not fit, keep half floats
+				break;
+			}
+		}
+	}
+
 	uint32_t mask = (1 << ARRAY_MAX) - 1;
 	format |= (~mask) & p_compress_format; //make the full format
 
@@ -1176,7 +1299,7 @@ void VisualServer::mesh_add_surface_from_arrays(RID p_mesh, PrimitiveType p_prim
 	mesh_add_surface(p_mesh, format, p_primitive, vertex_array, array_len, index_array, index_array_len, aabb, blend_shape_data, bone_aabb);
 }
 
-Array VisualServer::_get_array_from_surface(uint32_t p_format, PoolVector<uint8_t> p_vertex_data, int p_vertex_len, PoolVector<uint8_t> p_index_data, int p_index_len) const {
+Array VisualServer::_get_array_from_surface(uint32_t p_format, PoolVector<uint8_t> p_vertex_data, int p_vertex_len, PoolVector<uint8_t> p_index_data, int p_index_len, const AABB &p_aabb) const {
 
 	uint32_t offsets[ARRAY_MAX];
 
@@ -1344,7 +1467,17 @@ Array VisualServer::_get_array_from_surface(uint32_t p_format, PoolVector<uint8_
 					PoolVector<Vector3> arr_3d;
 					arr_3d.resize(p_vertex_len);
 
-					if (p_format & ARRAY_COMPRESS_VERTEX) {
+					if ((p_format & ARRAY_COMPRESS_VERTEX) && (p_format & ARRAY_FLAG_USE_QUANTIZED_VERTICES)) {
+
+						PoolVector<Vector3>::Write w = arr_3d.write();
+						Vector3 scale = p_aabb.size / 65535.0;
+
+						for (int j = 0; j < p_vertex_len; j++) {
+
+							const uint16_t *v = (const uint16_t *)&r[j * total_elem_size + offsets[i]];
+							w[j] = p_aabb.position + Vector3(v[0], v[1], v[2]) * scale;
+						}
+					} else if (p_format & ARRAY_COMPRESS_VERTEX) {
 
 						PoolVector<Vector3>::Write w = arr_3d.write();
 
@@ -1372,7 +1505,16 @@ Array VisualServer::_get_array_from_surface(uint32_t p_format, PoolVector<uint8_
 				PoolVector<Vector3> arr;
 				arr.resize(p_vertex_len);
 
-				if (p_format & ARRAY_COMPRESS_NORMAL) {
+				if ((p_format & ARRAY_COMPRESS_NORMAL) && (p_format & ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+
+					PoolVector<Vector3>::Write w = arr.write();
+
+					for (int j = 0; j < p_vertex_len; j++) {
+
+						const int16_t *v = (const int16_t *)&r[j * total_elem_size + offsets[i]];
+						w[j] = _octahedron_decode(Vector2(_snorm16_to_float(v[0]), _snorm16_to_float(v[1])));
+					}
+				} else if (p_format & ARRAY_COMPRESS_NORMAL) {
 
 					PoolVector<Vector3>::Write w = arr.write();
 					const float multiplier = 1.f / 127.f;
@@ -1399,7 +1541,20 @@ Array VisualServer::_get_array_from_surface(uint32_t p_format, PoolVector<uint8_
 			case VS::ARRAY_TANGENT: {
 				PoolVector<float> arr;
 				arr.resize(p_vertex_len * 4);
-				if (p_format & ARRAY_COMPRESS_TANGENT) {
+				if ((p_format & ARRAY_COMPRESS_TANGENT) && (p_format & ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION)) {
+					PoolVector<float>::Write w = arr.write();
+
+					for (int j = 0; j < p_vertex_len; j++) {
+
+						const int16_t *v = (const int16_t *)&r[j * total_elem_size + offsets[i]];
+						real_t y = _snorm16_to_float(v[1]);
+						Vector3 tangent = _octahedron_decode(Vector2(_snorm16_to_float(v[0]), ABS(y) * 2.0 - 1.0));
+						w[j * 4 + 0] = tangent.x;
+						w[j * 4 + 1] = tangent.y;
+						w[j * 4 + 2] = tangent.z;
+						w[j * 4 + 3] = y < 0 ? -1.0 : 1.0;
+					}
+				} else if (p_format & ARRAY_COMPRESS_TANGENT) {
 					PoolVector<float>::Write w = arr.write();
 
 					for (int j = 0; j < p_vertex_len; j++) {
@@ -1482,7 +1637,16 @@ Array VisualServer::_get_array_from_surface(uint32_t p_format, PoolVector<uint8_
 				PoolVector<Vector2> arr;
 				arr.resize(p_vertex_len);
 
-				if (p_format & ARRAY_COMPRESS_TEX_UV2) {
+				if ((p_format & ARRAY_COMPRESS_TEX_UV2) && (p_format & ARRAY_FLAG_USE_16_BIT_TEX_UV2)) {
+
+					PoolVector<Vector2>::Write w = arr.write();
+
+					for (int j = 0; j < p_vertex_len; j++) {
+
+						const uint16_t *v = (const uint16_t *)&r[j * total_elem_size + offsets[i]];
+						w[j] = Vector2(v[0] / 65535.0, v[1] / 65535.0);
+					}
+				} else if (p_format & ARRAY_COMPRESS_TEX_UV2) {
 
 					PoolVector<Vector2>::Write w = arr.write();
 
@@ -1611,7 +1775,7 @@ Array VisualServer::mesh_surface_get_arrays(RID p_mesh, int p_surface) const {
 
 	uint32_t format = mesh_surface_get_format(p_mesh, p_surface);
 
-	return _get_array_from_surface(format, vertex_data, vertex_len, index_data, index_len);
+	return _get_array_from_surface(format, vertex_data, vertex_len, index_data, index_len, mesh_surface_get_aabb(p_mesh, p_surface));
 }
 
 Array VisualServer::mesh_surface_get_blend_shape_arrays(RID p_mesh, int p_surface) const {
@@ -1628,7 +1792,7 @@ Array VisualServer::mesh_surface_get_blend_shape_arrays(RID p_mesh, int p_surfac
 		Array blend_shape_array;
 		blend_shape_array.resize(blend_shape_data.size());
 		for (int i = 0; i < blend_shape_data.size(); i++) {
-			blend_shape_array.set(i, _get_array_from_surface(format, blend_shape_data[i], vertex_len, index_data, index_len));
+			blend_shape_array.set(i, _get_array_from_surface(format, blend_shape_data[i], vertex_len, index_data, index_len, AABB())); //blend shapes are never quantized
 		}
 
 		return blend_shape_array;
@@ -1647,6 +1811,41 @@ Array VisualServer::_mesh_surface_get_skeleton_aabb_bind(RID p_mesh, int p_surfa
 	return arr;
 }
 
+Error VisualServer::shader_variants_save(const String &p_path) {
+
+	PoolVector<String> variants = shader_variants_get_recorded();
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, ERR_CANT_CREATE);
+
+	PoolVector<String>::Read r = variants.read();
+	for (int i = 0; i < variants.size(); i++) {
+		f->store_line(r[i]);
+	}
+
+	memdelete(f);
+	return OK;
+}
+
+Error VisualServer::shader_variants_load(const String &p_path) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
+
+	PoolVector<String> variants;
+	while (!f->eof_reached()) {
+		String line = f->get_line().strip_edges();
+		if (line != String()) {
+			variants.push_back(line);
+		}
+	}
+
+	memdelete(f);
+
+	shader_variants_precompile(variants);
+	return OK;
+}
+
 void VisualServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("force_sync"), &VisualServer::sync);
@@ -1762,6 +1961,7 @@ void VisualServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("skeleton_allocate", "skeleton", "bones", "is_2d_skeleton"), &VisualServer::skeleton_allocate, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("skeleton_get_bone_count", "skeleton"), &VisualServer::skeleton_get_bone_count);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_set_transform", "skeleton", "bone", "transform"), &VisualServer::skeleton_bone_set_transform);
+	ClassDB::bind_method(D_METHOD("skeleton_set_bone_transforms", "skeleton", "transforms"), &VisualServer::skeleton_set_bone_transforms);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_get_transform", "skeleton", "bone"), &VisualServer::skeleton_bone_get_transform);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_set_transform_2d", "skeleton", "bone", "transform"), &VisualServer::skeleton_bone_set_transform_2d);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_get_transform_2d", "skeleton", "bone"), &VisualServer::skeleton_bone_get_transform_2d);
@@ -1913,6 +2113,7 @@ void VisualServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("environment_set_adjustment", "env", "enable", "brightness", "contrast", "saturation", "ramp"), &VisualServer::environment_set_adjustment);
 	ClassDB::bind_method(D_METHOD("environment_set_ssr", "env", "enable", "max_steps", "fade_in", "fade_out", "depth_tolerance", "roughness"), &VisualServer::environment_set_ssr);
 	ClassDB::bind_method(D_METHOD("environment_set_ssao", "env", "enable", "radius", "intensity", "radius2", "intensity2", "bias", "light_affect", "ao_channel_affect", "color", "quality", "blur", "bilateral_sharpness"), &VisualServer::environment_set_ssao);
+	ClassDB::bind_method(D_METHOD("environment_set_ssao_resolution", "env", "resolution"), &VisualServer::environment_set_ssao_resolution);
 	ClassDB::bind_method(D_METHOD("environment_set_fog", "env", "enable", "color", "sun_color", "sun_amount"), &VisualServer::environment_set_fog);
 	ClassDB::bind_method(D_METHOD("environment_set_fog_depth", "env", "enable", "depth_begin", "depth_curve", "transmit", "transmit_curve"), &VisualServer::environment_set_fog_depth);
 	ClassDB::bind_method(D_METHOD("environment_set_fog_height", "env", "enable", "min_height", "max_height", "height_curve"), &VisualServer::environment_set_fog_height);
@@ -1945,6 +2146,7 @@ void VisualServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_material_override", "instance", "material"), &VisualServer::instance_geometry_set_material_override);
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_draw_range", "instance", "min", "max", "min_margin", "max_margin"), &VisualServer::instance_geometry_set_draw_range);
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_as_instance_lod", "instance", "as_lod_of_instance"), &VisualServer::instance_geometry_set_as_instance_lod);
+	ClassDB::bind_method(D_METHOD("instance_geometry_set_occluder_faces", "instance", "faces"), &VisualServer::instance_geometry_set_occluder_faces);
 
 	ClassDB::bind_method(D_METHOD("instances_cull_aabb", "aabb", "scenario"), &VisualServer::_instances_cull_aabb_bind, DEFVAL(RID()));
 	ClassDB::bind_method(D_METHOD("instances_cull_ray", "from", "to", "scenario"), &VisualServer::_instances_cull_ray_bind, DEFVAL(RID()));
@@ -2047,6 +2249,12 @@ void VisualServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("has_os_feature", "feature"), &VisualServer::has_os_feature);
 	ClassDB::bind_method(D_METHOD("set_debug_generate_wireframes", "generate"), &VisualServer::set_debug_generate_wireframes);
 
+	ClassDB::bind_method(D_METHOD("shader_variants_set_recording", "enable"), &VisualServer::shader_variants_set_recording);
+	ClassDB::bind_method(D_METHOD("shader_variants_get_recorded"), &VisualServer::shader_variants_get_recorded);
+	ClassDB::bind_method(D_METHOD("shader_variants_precompile", "variants"), &VisualServer::shader_variants_precompile);
+	ClassDB::bind_method(D_METHOD("shader_variants_save", "path"), &VisualServer::shader_variants_save);
+	ClassDB::bind_method(D_METHOD("shader_variants_load", "path"), &VisualServer::shader_variants_load);
+
 	BIND_CONSTANT(NO_INDEX_ARRAY);
 	BIND_CONSTANT(ARRAY_WEIGHTS_SIZE);
 	BIND_CONSTANT(CANVAS_ITEM_Z_MIN);
@@ -2113,6 +2321,9 @@ void VisualServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(ARRAY_COMPRESS_INDEX);
 	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_2D_VERTICES);
 	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_16_BIT_BONES);
+	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION);
+	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_QUANTIZED_VERTICES);
+	BIND_ENUM_CONSTANT(ARRAY_FLAG_USE_16_BIT_TEX_UV2);
 	BIND_ENUM_CONSTANT(ARRAY_COMPRESS_DEFAULT);
 
 	BIND_ENUM_CONSTANT(PRIMITIVE_POINTS);
@@ -2184,6 +2395,7 @@ void VisualServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(VIEWPORT_RENDER_INFO_SHADER_CHANGES_IN_FRAME);
 	BIND_ENUM_CONSTANT(VIEWPORT_RENDER_INFO_SURFACE_CHANGES_IN_FRAME);
 	BIND_ENUM_CONSTANT(VIEWPORT_RENDER_INFO_DRAW_CALLS_IN_FRAME);
+	BIND_ENUM_CONSTANT(VIEWPORT_RENDER_INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME);
 	BIND_ENUM_CONSTANT(VIEWPORT_RENDER_INFO_MAX);
 
 	BIND_ENUM_CONSTANT(VIEWPORT_DEBUG_DRAW_DISABLED);
@@ -2247,6 +2459,15 @@ void VisualServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_VIDEO_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_VERTEX_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_SHADER_COMPILES_PENDING);
+	BIND_ENUM_CONSTANT(INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_SHADOWS_USEC);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_OPAQUE_USEC);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_TRANSPARENT_USEC);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_SSAO_USEC);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_GLOW_USEC);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_TONEMAP_USEC);
+	BIND_ENUM_CONSTANT(INFO_GPU_TIME_CANVAS_USEC);
 
 	BIND_ENUM_CONSTANT(FEATURE_SHADERS);
 	BIND_ENUM_CONSTANT(FEATURE_MULTITHREADED);
@@ -2295,6 +2516,10 @@ void VisualServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(ENV_SSAO_BLUR_2x2);
 	BIND_ENUM_CONSTANT(ENV_SSAO_BLUR_3x3);
 
+	BIND_ENUM_CONSTANT(ENV_SSAO_RESOLUTION_FULL);
+	BIND_ENUM_CONSTANT(ENV_SSAO_RESOLUTION_HALF);
+	BIND_ENUM_CONSTANT(ENV_SSAO_RESOLUTION_QUARTER);
+
 	ADD_SIGNAL(MethodInfo("frame_pre_draw"));
 	ADD_SIGNAL(MethodInfo("frame_post_draw"));
 }
@@ -2361,16 +2586,23 @@ VisualServer::VisualServer() {
 	//ERR_FAIL_COND(singleton);
 	singleton = this;
 
+	GLOBAL_DEF("rendering/vram_compression/import_bptc", false);
 	GLOBAL_DEF("rendering/vram_compression/import_s3tc", true);
 	GLOBAL_DEF("rendering/vram_compression/import_etc", false);
 	GLOBAL_DEF("rendering/vram_compression/import_etc2", true);
 	GLOBAL_DEF("rendering/vram_compression/import_pvrtc", false);
+	GLOBAL_DEF("rendering/vram_compression/compress_threads", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/vram_compression/compress_threads", PropertyInfo(Variant::INT, "rendering/vram_compression/compress_threads", PROPERTY_HINT_RANGE, "0,256,1"));
 
 	GLOBAL_DEF("rendering/quality/directional_shadow/size", 4096);
 	GLOBAL_DEF("rendering/quality/directional_shadow/size.mobile", 2048);
 	GLOBAL_DEF("rendering/quality/shadow_atlas/size", 4096);
 	GLOBAL_DEF("rendering/quality/shadow_atlas/size.mobile", 2048);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/shadow_atlas/size", PropertyInfo(Variant::INT, "rendering/quality/shadow_atlas/size", PROPERTY_HINT_RANGE, "256,16384"));
+	GLOBAL_DEF("rendering/quality/shadow_atlas/distant_light_coverage", 0.1);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/shadow_atlas/distant_light_coverage", PropertyInfo(Variant::REAL, "rendering/quality/shadow_atlas/distant_light_coverage", PROPERTY_HINT_RANGE, "0,1,0.01"));
+	GLOBAL_DEF("rendering/quality/shadow_atlas/distant_light_update_interval", 1);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/shadow_atlas/distant_light_update_interval", PropertyInfo(Variant::INT, "rendering/quality/shadow_atlas/distant_light_update_interval", PROPERTY_HINT_RANGE, "1,60,1"));
 	GLOBAL_DEF("rendering/quality/shadow_atlas/quadrant_0_subdiv", 1);
 	GLOBAL_DEF("rendering/quality/shadow_atlas/quadrant_1_subdiv", 2);
 	GLOBAL_DEF("rendering/quality/shadow_atlas/quadrant_2_subdiv", 3);
@@ -2388,12 +2620,26 @@ VisualServer::VisualServer() {
 	GLOBAL_DEF("rendering/quality/reflections/texture_array_reflections.mobile", false);
 	GLOBAL_DEF("rendering/quality/reflections/high_quality_ggx", true);
 	GLOBAL_DEF("rendering/quality/reflections/high_quality_ggx.mobile", false);
+	GLOBAL_DEF("rendering/quality/reflections/update_steps_per_frame", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/reflections/update_steps_per_frame", PropertyInfo(Variant::INT, "rendering/quality/reflections/update_steps_per_frame", PROPERTY_HINT_RANGE, "0,64,1"));
 
 	GLOBAL_DEF("rendering/quality/shading/force_vertex_shading", false);
 	GLOBAL_DEF("rendering/quality/shading/force_vertex_shading.mobile", true);
+	GLOBAL_DEF("rendering/quality/shading/use_light_clusters", true);
+	GLOBAL_DEF("rendering/quality/shading/use_light_clusters.mobile", false);
 
 	GLOBAL_DEF("rendering/quality/depth_prepass/enable", true);
 	GLOBAL_DEF("rendering/quality/depth_prepass/disable_for_vendors", "PowerVR,Mali,Adreno");
+
+	GLOBAL_DEF("rendering/quality/shaders/async_compile", true);
+	GLOBAL_DEF("rendering/quality/shaders/cache_program_binaries", true);
+
+	GLOBAL_DEF("debug/settings/profiler/gpu_pass_timers", true);
+
+	GLOBAL_DEF("rendering/texture_streaming/enabled", false);
+	GLOBAL_DEF("rendering/texture_streaming/initial_max_size", 256);
+	GLOBAL_DEF("rendering/texture_streaming/memory_budget_mb", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/texture_streaming/memory_budget_mb", PropertyInfo(Variant::INT, "rendering/texture_streaming/memory_budget_mb", PROPERTY_HINT_RANGE, "16,4096,1"));
 }
 
 VisualServer::~VisualServer() {
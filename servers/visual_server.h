@@ -52,7 +52,7 @@ class VisualServer : public Object {
 
 	void _camera_set_orthogonal(RID p_camera, float p_size, float p_z_near, float p_z_far);
 	void _canvas_item_add_style_box(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector<float> &p_margins, const Color &p_modulate = Color(1, 1, 1));
-	Array _get_array_from_surface(uint32_t p_format, PoolVector<uint8_t> p_vertex_data, int p_vertex_len, PoolVector<uint8_t> p_index_data, int p_index_len) const;
+	Array _get_array_from_surface(uint32_t p_format, PoolVector<uint8_t> p_vertex_data, int p_vertex_len, PoolVector<uint8_t> p_index_data, int p_index_len, const AABB &p_aabb) const;
 
 protected:
 	RID _make_test_cube();
@@ -152,6 +152,10 @@ public:
 	virtual void texture_set_detect_srgb_callback(RID p_texture, TextureDetectCallback p_callback, void *p_userdata) = 0;
 	virtual void texture_set_detect_normal_callback(RID p_texture, TextureDetectCallback p_callback, void *p_userdata) = 0;
 
+	typedef void (*TextureStreamRequestCallback)(void *, int p_size);
+
+	virtual void texture_set_stream_request_callback(RID p_texture, TextureStreamRequestCallback p_callback, void *p_userdata) = 0; ///< called while drawing with the size in pixels the texture covers
+
 	struct TextureInfo {
 		RID texture;
 		uint32_t width;
@@ -257,8 +261,11 @@ public:
 		ARRAY_FLAG_USE_2D_VERTICES = ARRAY_COMPRESS_INDEX << 1,
 		ARRAY_FLAG_USE_16_BIT_BONES = ARRAY_COMPRESS_INDEX << 2,
 		ARRAY_FLAG_USE_DYNAMIC_UPDATE = ARRAY_COMPRESS_INDEX << 3,
+		ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION = ARRAY_COMPRESS_INDEX << 4, // compressed normals and tangents are octahedral
+		ARRAY_FLAG_USE_QUANTIZED_VERTICES = ARRAY_COMPRESS_INDEX << 5, // compressed vertices are 16 bits relative to the surface AABB
+		ARRAY_FLAG_USE_16_BIT_TEX_UV2 = ARRAY_COMPRESS_INDEX << 6, // compressed UV2 is 16 bits in the 0-1 range
 
-		ARRAY_COMPRESS_DEFAULT = ARRAY_COMPRESS_NORMAL | ARRAY_COMPRESS_TANGENT | ARRAY_COMPRESS_COLOR | ARRAY_COMPRESS_TEX_UV | ARRAY_COMPRESS_TEX_UV2 | ARRAY_COMPRESS_WEIGHTS
+		ARRAY_COMPRESS_DEFAULT = ARRAY_COMPRESS_NORMAL | ARRAY_COMPRESS_TANGENT | ARRAY_COMPRESS_COLOR | ARRAY_COMPRESS_TEX_UV | ARRAY_COMPRESS_TEX_UV2 | ARRAY_COMPRESS_WEIGHTS | ARRAY_FLAG_USE_OCTAHEDRAL_COMPRESSION
 
 	};
 
@@ -388,6 +395,7 @@ public:
 	virtual void skeleton_allocate(RID p_skeleton, int p_bones, bool p_2d_skeleton = false) = 0;
 	virtual int skeleton_get_bone_count(RID p_skeleton) const = 0;
 	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) = 0;
+	virtual void skeleton_set_bone_transforms(RID p_skeleton, const PoolVector<float> &p_transforms) = 0;
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const = 0;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) = 0;
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const = 0;
@@ -675,6 +683,7 @@ public:
 		VIEWPORT_RENDER_INFO_SHADER_CHANGES_IN_FRAME,
 		VIEWPORT_RENDER_INFO_SURFACE_CHANGES_IN_FRAME,
 		VIEWPORT_RENDER_INFO_DRAW_CALLS_IN_FRAME,
+		VIEWPORT_RENDER_INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME,
 		VIEWPORT_RENDER_INFO_MAX
 	};
 
@@ -758,7 +767,14 @@ public:
 		ENV_SSAO_BLUR_3x3,
 	};
 
+	enum EnvironmentSSAOResolution {
+		ENV_SSAO_RESOLUTION_FULL,
+		ENV_SSAO_RESOLUTION_HALF,
+		ENV_SSAO_RESOLUTION_QUARTER,
+	};
+
 	virtual void environment_set_ssao(RID p_env, bool p_enable, float p_radius, float p_intensity, float p_radius2, float p_intensity2, float p_bias, float p_light_affect, float p_ao_channel_affect, const Color &p_color, EnvironmentSSAOQuality p_quality, EnvironmentSSAOBlur p_blur, float p_bilateral_sharpness) = 0;
+	virtual void environment_set_ssao_resolution(RID p_env, EnvironmentSSAOResolution p_resolution) = 0;
 
 	virtual void environment_set_fog(RID p_env, bool p_enable, const Color &p_color, const Color &p_sun_color, float p_sun_amount) = 0;
 	virtual void environment_set_fog_depth(RID p_env, bool p_enable, float p_depth_begin, float p_depth_curve, bool p_transmit, float p_transmit_curve) = 0;
@@ -808,6 +824,9 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario) = 0; // from can be mesh, light, poly, area and portal so far.
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask) = 0;
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform) = 0;
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) = 0; // bulk version of the above, both arrays must be the same size
+	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated) = 0;
+	virtual void instance_reset_physics_interpolation(RID p_instance) = 0;
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_ID) = 0;
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight) = 0;
 	virtual void instance_set_surface_material(RID p_instance, int p_surface, RID p_material) = 0;
@@ -850,6 +869,7 @@ public:
 
 	virtual void instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin) = 0;
 	virtual void instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance) = 0;
+	virtual void instance_geometry_set_occluder_faces(RID p_instance, const PoolVector<Vector3> &p_faces) = 0;
 
 	/* CANVAS (2D) */
 
@@ -864,6 +884,8 @@ public:
 	virtual void canvas_item_set_light_mask(RID p_item, int p_mask) = 0;
 
 	virtual void canvas_item_set_transform(RID p_item, const Transform2D &p_transform) = 0;
+	virtual void canvas_item_set_interpolated(RID p_item, bool p_interpolated) = 0;
+	virtual void canvas_item_reset_physics_interpolation(RID p_item) = 0;
 	virtual void canvas_item_set_clip(RID p_item, bool p_clip) = 0;
 	virtual void canvas_item_set_distance_field_mode(RID p_item, bool p_enable) = 0;
 	virtual void canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect = Rect2()) = 0;
@@ -981,6 +1003,8 @@ public:
 
 	virtual void draw(bool p_swap_buffers = true, double frame_step = 0.0) = 0;
 	virtual void sync() = 0;
+	virtual void tick() = 0; // a physics tick ended, interpolated transforms will blend from the ones set before it
+	virtual void set_physics_interpolation_fraction(float p_fraction) = 0;
 	virtual bool has_changed() const = 0;
 	virtual void init() = 0;
 	virtual void finish() = 0;
@@ -999,6 +1023,15 @@ public:
 		INFO_VIDEO_MEM_USED,
 		INFO_TEXTURE_MEM_USED,
 		INFO_VERTEX_MEM_USED,
+		INFO_SHADER_COMPILES_PENDING,
+		INFO_INSTANCED_DRAW_CALLS_SAVED_IN_FRAME,
+		INFO_GPU_TIME_SHADOWS_USEC,
+		INFO_GPU_TIME_OPAQUE_USEC,
+		INFO_GPU_TIME_TRANSPARENT_USEC,
+		INFO_GPU_TIME_SSAO_USEC,
+		INFO_GPU_TIME_GLOW_USEC,
+		INFO_GPU_TIME_TONEMAP_USEC,
+		INFO_GPU_TIME_CANVAS_USEC,
 	};
 
 	virtual int get_render_info(RenderInfo p_info) = 0;
@@ -1031,6 +1064,13 @@ public:
 
 	virtual void set_debug_generate_wireframes(bool p_generate) = 0;
 
+	virtual void shader_variants_set_recording(bool p_enable) = 0;
+	virtual PoolVector<String> shader_variants_get_recorded() = 0;
+	virtual void shader_variants_precompile(const PoolVector<String> &p_variants) = 0;
+
+	Error shader_variants_save(const String &p_path);
+	Error shader_variants_load(const String &p_path);
+
 	virtual void call_set_use_vsync(bool p_enable) = 0;
 
 	VisualServer();
@@ -1076,6 +1116,7 @@ VARIANT_ENUM_CAST(VisualServer::EnvironmentGlowBlendMode);
 VARIANT_ENUM_CAST(VisualServer::EnvironmentToneMapper);
 VARIANT_ENUM_CAST(VisualServer::EnvironmentSSAOQuality);
 VARIANT_ENUM_CAST(VisualServer::EnvironmentSSAOBlur);
+VARIANT_ENUM_CAST(VisualServer::EnvironmentSSAOResolution);
 VARIANT_ENUM_CAST(VisualServer::InstanceFlags);
 VARIANT_ENUM_CAST(VisualServer::ShadowCastingSetting);
 VARIANT_ENUM_CAST(VisualServer::TextureType);